@@ -0,0 +1,27 @@
+# - Try to find the Brotli encoder library
+#   https://github.com/google/brotli
+#
+# Exports:
+#  Brotli_FOUND
+#  BROTLI_INCLUDE_DIR
+#  BROTLI_LIBRARIES
+# Hints:
+#  BROTLI_LIBRARY_DIR
+
+find_path(BROTLI_INCLUDE_DIR
+          brotli/encode.h)
+
+find_library(BROTLI_ENCODER_LIBRARY
+             NAMES brotlienc
+             HINTS "${BROTLI_LIBRARY_DIR}")
+
+find_library(BROTLI_COMMON_LIBRARY
+             NAMES brotlicommon
+             HINTS "${BROTLI_LIBRARY_DIR}")
+
+set(BROTLI_LIBRARIES ${BROTLI_ENCODER_LIBRARY} ${BROTLI_COMMON_LIBRARY})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Brotli DEFAULT_MSG
+                                  BROTLI_ENCODER_LIBRARY BROTLI_COMMON_LIBRARY BROTLI_INCLUDE_DIR)
+mark_as_advanced(BROTLI_INCLUDE_DIR BROTLI_ENCODER_LIBRARY BROTLI_COMMON_LIBRARY)
@@ -0,0 +1,21 @@
+# - Try to find the Zstandard library
+#   https://github.com/facebook/zstd
+#
+# Exports:
+#  Zstd_FOUND
+#  ZSTD_INCLUDE_DIR
+#  ZSTD_LIBRARY
+# Hints:
+#  ZSTD_LIBRARY_DIR
+
+find_path(ZSTD_INCLUDE_DIR
+          zstd.h)
+
+find_library(ZSTD_LIBRARY
+             NAMES zstd
+             HINTS "${ZSTD_LIBRARY_DIR}")
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd DEFAULT_MSG
+                                  ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
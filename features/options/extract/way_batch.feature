@@ -0,0 +1,51 @@
+@extract
+Feature: osrm-extract lua process_ways(batch)
+
+    Background:
+        Given the node map
+            """
+            a b c d
+            """
+        And the ways
+            | nodes | highway | name  |
+            | ab    | primary | road  |
+            | bc    | primary | road  |
+            | cd    | (nil)   | track |
+
+    Scenario: osrm-extract - Passing the ways of a buffer in one batch
+        Given the profile file "testbot" extended with
+        """
+        function process_ways(batch)
+          print('batch of ' .. batch.size .. ' ways')
+          for index = 0, batch.size - 1 do
+            local tags = batch:get_tags(index)
+            print('way ' .. batch:way(index):id() .. ' highway ' .. tostring(tags.highway) ..
+                  ' name ' .. tostring(batch:get_value_by_key(index, 'name')))
+            way_function(batch:way(index), batch:result(index))
+          end
+        end
+        """
+        And the data has been saved to disk
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit successfully
+        And stdout should contain "batch of 3 ways"
+        And stdout should contain "highway primary name road"
+        And stdout should contain "highway nil name track"
+
+    @routing
+    Scenario: osrm-extract - Running a way function over a batch
+        Given the profile file "testbot" extended with
+        """
+        local WayBatch = require('lib/way_batch')
+
+        function process_ways(batch)
+          WayBatch.run(batch, way_function, { 'highway' })
+        end
+        """
+
+        # the way without a highway tag is skipped and d snaps to the end of the road
+        When I route I should get
+            | from | to | route     |
+            | a    | c  | road,road |
+            | c    | a  | road,road |
+            | a    | d  | road,road |
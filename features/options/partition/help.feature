@@ -14,6 +14,8 @@ Feature: osrm-partition command line options: help
         And stdout should contain "--boundary"
         And stdout should contain "--optimizing-cuts"
         And stdout should contain "--small-component-size"
+        And stdout should contain "--coarsening-threshold"
+        And stdout should contain "--max-memory"
         And stdout should contain "--max-cell-sizes"
         And it should exit with an error
 
@@ -30,6 +32,8 @@ Feature: osrm-partition command line options: help
         And stdout should contain "--boundary"
         And stdout should contain "--optimizing-cuts"
         And stdout should contain "--small-component-size"
+        And stdout should contain "--coarsening-threshold"
+        And stdout should contain "--max-memory"
         And stdout should contain "--max-cell-sizes"
         And it should exit successfully
 
@@ -46,5 +50,7 @@ Feature: osrm-partition command line options: help
         And stdout should contain "--boundary"
         And stdout should contain "--optimizing-cuts"
         And stdout should contain "--small-component-size"
+        And stdout should contain "--coarsening-threshold"
+        And stdout should contain "--max-memory"
         And stdout should contain "--max-cell-sizes"
         And it should exit successfully
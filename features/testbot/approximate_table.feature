@@ -0,0 +1,30 @@
+@matrix @testbot @mld
+Feature: Approximate distance matrix
+# note that results are travel time, specified in 1/10th of seconds
+# since testbot uses a default speed of 100m/10s, the result matches
+# the number of meters as long as the way type is the default 'primary'
+
+    Background:
+        Given the profile "testbot"
+        And the partition extra arguments "--small-component-size 1 --max-cell-sizes 4,16,64"
+        And the customize extra arguments "--distance-oracle-level 1"
+
+    Scenario: Testbot - Approximate travel time matrix estimates distant and searches nearby entries
+        Given the node map
+            """
+            a b c d                                                                         w x y z
+            """
+
+        And the ways
+            | nodes    |
+            | abcdwxyz |
+
+        And the query options
+            | approximate | true |
+
+        When I request a travel time matrix I should get
+            |   | a       | d       | w       | z       |
+            | a | 0       | 30      | 400 ~3% | 430 ~3% |
+            | d | 30      | 0       | 370 ~3% | 400 ~3% |
+            | w | 400 ~3% | 370 ~3% | 0       | 30      |
+            | z | 430 ~3% | 400 ~3% | 30      | 0       |
@@ -187,3 +187,47 @@ Feature: Multi level routing
             |   |   h |   i |
             | h |   0 | 134 |
             | i | 134 |   0 |
+
+    Scenario: Testbot - Multi level travel time matrix of phantoms in the same cells
+        Given the node map
+            """
+            a─1─2─3─4─b───c───d
+            │         │   │   │
+            e─────────f───g───h
+            """
+
+        And the ways
+            | nodes | highway |
+            | ab    | primary |
+            | bcd   | primary |
+            | efgh  | primary |
+            | ae    | primary |
+            | bf    | primary |
+            | cg    | primary |
+            | dh    | primary |
+
+        # the four targets on ab share their cells and are searched as one group
+        When I request a travel time matrix I should get
+            |   | 1       | 2      | 3      | 4      | e      | g      | h       |
+            | 1 | 0       | 10 +-1 | 20 +-1 | 30 +-1 | 30 +-1 | 80 +-1 | 100 +-1 |
+            | 2 | 10 +-1  | 0      | 10 +-1 | 20 +-1 | 40 +-1 | 70 +-1 | 90 +-1  |
+            | 3 | 20 +-1  | 10 +-1 | 0      | 10 +-1 | 50 +-1 | 60 +-1 | 80 +-1  |
+            | 4 | 30 +-1  | 20 +-1 | 10 +-1 | 0      | 60 +-1 | 50 +-1 | 70 +-1  |
+            | e | 30 +-1  | 40 +-1 | 50 +-1 | 60 +-1 | 0      | 70     | 90      |
+            | g | 80 +-1  | 70 +-1 | 60 +-1 | 50 +-1 | 70     | 0      | 20      |
+            | h | 100 +-1 | 90 +-1 | 80 +-1 | 70 +-1 | 90     | 20     | 0       |
+
+        # fewer targets of a cell are searched one by one
+        When I request a travel time matrix I should get
+            |   | 1       | 2      | 3      |
+            | e | 30 +-1  | 40 +-1 | 50 +-1 |
+            | g | 80 +-1  | 70 +-1 | 60 +-1 |
+            | h | 100 +-1 | 90 +-1 | 80 +-1 |
+
+        # the smaller side is collected, here the four sources on ab as one group
+        When I request a travel time matrix I should get
+            |   | e      | g      | h       | d      | f      |
+            | 1 | 30 +-1 | 80 +-1 | 100 +-1 | 80 +-1 | 60 +-1 |
+            | 2 | 40 +-1 | 70 +-1 | 90 +-1  | 70 +-1 | 50 +-1 |
+            | 3 | 50 +-1 | 60 +-1 | 80 +-1  | 60 +-1 | 40 +-1 |
+            | 4 | 60 +-1 | 50 +-1 | 70 +-1  | 50 +-1 | 30 +-1 |
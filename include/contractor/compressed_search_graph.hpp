@@ -0,0 +1,200 @@
+#ifndef OSRM_CONTRACTOR_COMPRESSED_SEARCH_GRAPH_HPP
+#define OSRM_CONTRACTOR_COMPRESSED_SEARCH_GRAPH_HPP
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <cstdint>
+#include <utility>
+
+namespace osrm
+{
+namespace contractor
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class CompressedSearchGraphImpl;
+}
+using CompressedSearchGraph = detail::CompressedSearchGraphImpl<storage::Ownership::Container>;
+using CompressedSearchGraphView = detail::CompressedSearchGraphImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::CompressedSearchGraphImpl<Ownership> &graph);
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::CompressedSearchGraphImpl<Ownership> &graph);
+}
+
+namespace detail
+{
+/**
+ * Byte encoded copy of the parts of the query graph the CH searches read: the target, weight
+ * and direction flags of every edge, in the order of the query graph.
+ *
+ * The edges of a node are stored back to back as two LEB128 varints each. The first holds the
+ * zig-zag encoded difference of the target to the target of the previous edge, or to the node
+ * itself for the first edge, shifted left by two with the forward and backward flag below it.
+ * The second holds the weight. With renumbered nodes most edges take three to five bytes
+ * instead of the twenty of a query graph edge, so a search touches far fewer cache lines.
+ * Edge ids are not stored, everything that needs them still uses the query graph.
+ */
+template <storage::Ownership Ownership> class CompressedSearchGraphImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    struct Edge
+    {
+        NodeID target;
+        EdgeWeight weight;
+        bool forward;
+        bool backward;
+    };
+
+    // Decodes the edges of a node while iterating them
+    class EdgeIterator : public boost::iterator_facade<EdgeIterator,
+                                                       Edge,
+                                                       boost::forward_traversal_tag,
+                                                       const Edge &>
+    {
+      public:
+        EdgeIterator() : position(nullptr), next(nullptr), end(nullptr) {}
+
+        EdgeIterator(const std::uint8_t *position, const std::uint8_t *end, const NodeID node)
+            : position(position), next(position), end(end)
+        {
+            edge.target = node;
+            Decode();
+        }
+
+      private:
+        friend class boost::iterator_core_access;
+
+        void Decode()
+        {
+            if (position == end)
+                return;
+
+            const auto head = ReadVarint(next);
+            const auto delta = head >> 2;
+            // zig-zag: even deltas are positive, odd ones negative
+            const auto offset =
+                static_cast<std::int64_t>(delta >> 1) ^ -static_cast<std::int64_t>(delta & 1);
+            edge.target = static_cast<NodeID>(static_cast<std::int64_t>(edge.target) + offset);
+            edge.forward = (head & 2) != 0;
+            edge.backward = (head & 1) != 0;
+            edge.weight = static_cast<EdgeWeight>(ReadVarint(next));
+            BOOST_ASSERT(next <= end);
+        }
+
+        void increment()
+        {
+            BOOST_ASSERT(position != end);
+            position = next;
+            Decode();
+        }
+
+        bool equal(const EdgeIterator &other) const { return position == other.position; }
+
+        const Edge &dereference() const { return edge; }
+
+        const std::uint8_t *position;
+        const std::uint8_t *next;
+        const std::uint8_t *end;
+        Edge edge;
+    };
+    using EdgeRange = boost::iterator_range<EdgeIterator>;
+
+    CompressedSearchGraphImpl() = default;
+
+    CompressedSearchGraphImpl(Vector<std::uint64_t> node_offsets_, Vector<std::uint8_t> edges_)
+        : node_offsets(std::move(node_offsets_)), edges(std::move(edges_))
+    {
+        BOOST_ASSERT(node_offsets.empty() || node_offsets.back() == edges.size());
+    }
+
+    template <typename GraphT> explicit CompressedSearchGraphImpl(const GraphT &graph)
+    {
+        node_offsets.reserve(graph.GetNumberOfNodes() + 1);
+        for (const auto node : util::irange<NodeID>(0, graph.GetNumberOfNodes()))
+        {
+            node_offsets.push_back(edges.size());
+            auto previous = static_cast<std::int64_t>(node);
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                const auto &data = graph.GetEdgeData(edge);
+                const auto target = static_cast<std::int64_t>(graph.GetTarget(edge));
+                const auto offset = target - previous;
+                const auto delta = (static_cast<std::uint64_t>(offset) << 1) ^
+                                   static_cast<std::uint64_t>(offset >> 63);
+                WriteVarint((delta << 2) | (data.forward ? 2 : 0) | (data.backward ? 1 : 0));
+                BOOST_ASSERT(data.weight >= 0);
+                WriteVarint(static_cast<std::uint32_t>(data.weight));
+                previous = target;
+            }
+        }
+        node_offsets.push_back(edges.size());
+    }
+
+    std::size_t GetNumberOfNodes() const
+    {
+        return node_offsets.empty() ? 0 : node_offsets.size() - 1;
+    }
+
+    // Size of the encoded edges in bytes
+    std::size_t GetEncodedSize() const { return edges.size(); }
+
+    EdgeRange GetAdjacentEdges(const NodeID node) const
+    {
+        BOOST_ASSERT(node < GetNumberOfNodes());
+        const auto *begin = edges.data() + node_offsets[node];
+        const auto *end = edges.data() + node_offsets[node + 1];
+        return EdgeRange(EdgeIterator(begin, end, node), EdgeIterator(end, end, node));
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               CompressedSearchGraphImpl &graph);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const CompressedSearchGraphImpl &graph);
+
+  private:
+    static std::uint64_t ReadVarint(const std::uint8_t *&position)
+    {
+        std::uint64_t value = *position & 0x7f;
+        for (unsigned shift = 7; *position++ & 0x80; shift += 7)
+        {
+            value |= static_cast<std::uint64_t>(*position & 0x7f) << shift;
+        }
+        return value;
+    }
+
+    void WriteVarint(std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            edges.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        edges.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    // byte offset of the first edge of every node and of the end of the last one
+    Vector<std::uint64_t> node_offsets;
+    Vector<std::uint8_t> edges;
+};
+}
+}
+}
+
+#endif
@@ -28,6 +28,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef CONTRACTOR_OPTIONS_HPP
 #define CONTRACTOR_OPTIONS_HPP
 
+#include "contractor/contractor_heap.hpp"
+
 #include "updater/updater_config.hpp"
 
 #include <boost/filesystem/path.hpp>
@@ -49,7 +51,12 @@ struct ContractorConfig
         level_output_path = osrm_input_path.string() + ".level";
         core_output_path = osrm_input_path.string() + ".core";
         graph_output_path = osrm_input_path.string() + ".hsgr";
+        compressed_graph_output_path = osrm_input_path.string() + ".hsgr.compressed";
+        hub_labels_output_path = osrm_input_path.string() + ".hsgr.labels";
         node_file_path = osrm_input_path.string() + ".enw";
+        partition_path = osrm_input_path.string() + ".partition";
+        cnbg_ebg_mapping_path = osrm_input_path.string() + ".cnbg_to_ebg";
+        landmarks_path = osrm_input_path.string() + ".landmarks";
         updater_config.osrm_input_path = osrm_input_path;
         updater_config.UseDefaultOutputNames();
     }
@@ -61,11 +68,20 @@ struct ContractorConfig
     std::string level_output_path;
     std::string core_output_path;
     std::string graph_output_path;
+    std::string compressed_graph_output_path;
+    std::string hub_labels_output_path;
 
     std::string node_file_path;
+    std::string partition_path;
+    std::string cnbg_ebg_mapping_path;
+    std::string landmarks_path;
 
     bool use_cached_priority;
 
+    // Contract in the order of the .level file and insert the shortcuts of the existing .hsgr
+    // again without witness searches, only the weights of the graph changed since
+    bool metric_update = false;
+
     unsigned requested_num_threads;
 
     // A percentage of vertices that will be contracted for the hierarchy.
@@ -73,6 +89,33 @@ struct ContractorConfig
     // The remaining vertices form the core of the hierarchy
     //(e.g. 0.8 contracts 80 percent of the hierarchy, leaving a core of 20%)
     double core_factor;
+
+    // Contract the cells of a level of the .partition file one at a time and the nodes on their
+    // boundaries afterwards, the edges of contracted nodes are kept on disk
+    bool partitioned = false;
+
+    // Level of the partition whose cells are contracted one at a time, 0 for the highest level
+    unsigned partition_level = 0;
+
+    // Renumber the nodes of the dataset for locality of the searches in the hierarchy
+    bool renumber_nodes = false;
+
+    // Number of landmarks that direct the searches in the core towards their target, 0 for none
+    unsigned landmarks = 0;
+
+    // Store a byte encoded copy of the targets, weights and directions of the hierarchy that the
+    // CH searches read instead of the full edges
+    bool compress_search_graph = false;
+
+    // Store the hub labels of the hierarchy that durations-only tables are looked up in without
+    // any search, they take a lot more memory than the hierarchy itself
+    bool hub_labels = false;
+
+    // Log the time spent in the phases of every contraction round
+    bool debug_timings = false;
+
+    // Heap storage and limits of the witness searches run while contracting a node
+    WitnessSearchParameters witness_search;
 };
 }
 }
@@ -16,7 +16,9 @@ namespace contractor
 class ContractorDijkstra
 {
   public:
-    ContractorDijkstra(std::size_t heap_size);
+    ContractorDijkstra(std::size_t heap_size,
+                       WitnessHeapStorage storage = WitnessHeapStorage::Hash,
+                       unsigned hop_limit = 0);
 
     // search the graph up
     void Run(const unsigned number_of_targets,
@@ -42,6 +44,8 @@ class ContractorDijkstra
                    const ContractorGraph &graph);
 
     ContractorHeap heap;
+    // nodes reached over this many edges are not relaxed, 0 for no limit
+    unsigned hop_limit;
 };
 
 } // namespace contractor
@@ -1,7 +1,8 @@
 #ifndef OSRM_CONTRACTOR_CONTRACTOR_GRAPH_HPP_
 #define OSRM_CONTRACTOR_CONTRACTOR_GRAPH_HPP_
 
-#include "util/dynamic_graph.hpp"
+#include "util/slab_graph.hpp"
+
 #include <algorithm>
 
 namespace osrm
@@ -38,7 +39,10 @@ struct ContractorEdgeData
     bool is_original_via_node_ID : 1;
 };
 
-using ContractorGraph = util::DynamicGraph<ContractorEdgeData>;
+// flags and the number of original edges share a single 32 bit word
+static_assert(sizeof(ContractorEdgeData) == 16, "ContractorEdgeData should be four words");
+
+using ContractorGraph = util::SlabGraph<ContractorEdgeData>;
 using ContractorEdge = ContractorGraph::InputEdge;
 
 } // namespace contractor
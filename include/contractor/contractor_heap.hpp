@@ -5,6 +5,8 @@
 #include "util/typedefs.hpp"
 #include "util/xor_fast_hash_storage.hpp"
 
+#include <memory>
+
 namespace osrm
 {
 namespace contractor
@@ -18,11 +20,99 @@ struct ContractorHeapData
     bool target = false;
 };
 
+/**
+ * Node index of the witness search heaps, every contraction thread has its own heap:
+ *  - WitnessHeapStorage::Hash
+ *    Hash table of a fixed size, independent of the graph size.
+ *  - WitnessHeapStorage::Array
+ *    Flat array over all nodes of the graph, fastest lookups but memory proportional to the
+ *    graph size per thread.
+ *  - WitnessHeapStorage::Paged
+ *    Paged flat array that only allocates the pages touched by the searches of a thread.
+ */
+enum class WitnessHeapStorage
+{
+    Hash,
+    Array,
+    Paged
+};
+
+struct WitnessSearchParameters
+{
+    WitnessHeapStorage storage = WitnessHeapStorage::Hash;
+    // Nodes a witness search settles at most while simulating a contraction for the node
+    // priorities and while contracting a node
+    int simulation_node_limit = 1000;
+    int contraction_node_limit = 2000;
+    // Edges of a witness path at most, 0 for no limit
+    unsigned hop_limit = 0;
+};
+
+// Picks one of the node index storages of WitnessHeapStorage at runtime
+template <typename NodeID, typename Key> class WitnessHeapIndexStorage
+{
+  public:
+    WitnessHeapIndexStorage(std::size_t size, WitnessHeapStorage type)
+        : type(type), generation_array(type == WitnessHeapStorage::Array ? size : 0),
+          two_level_array(type == WitnessHeapStorage::Paged ? size : 0)
+    {
+        if (type == WitnessHeapStorage::Hash)
+            hash_table = std::make_unique<util::XORFastHashStorage<NodeID, Key>>(size);
+    }
+
+    Key &operator[](NodeID node)
+    {
+        switch (type)
+        {
+        case WitnessHeapStorage::Array:
+            return generation_array[node];
+        case WitnessHeapStorage::Paged:
+            return two_level_array[node];
+        default:
+            return (*hash_table)[node].key;
+        }
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        switch (type)
+        {
+        case WitnessHeapStorage::Array:
+            return generation_array.peek_index(node);
+        case WitnessHeapStorage::Paged:
+            return two_level_array.peek_index(node);
+        default:
+            return hash_table->peek_index(node);
+        }
+    }
+
+    void Clear()
+    {
+        switch (type)
+        {
+        case WitnessHeapStorage::Array:
+            generation_array.Clear();
+            break;
+        case WitnessHeapStorage::Paged:
+            two_level_array.Clear();
+            break;
+        default:
+            hash_table->Clear();
+        }
+    }
+
+  private:
+    WitnessHeapStorage type;
+    std::unique_ptr<util::XORFastHashStorage<NodeID, Key>> hash_table;
+    util::GenerationArrayStorage<NodeID, Key> generation_array;
+    util::TwoLevelStorage<NodeID, Key> two_level_array;
+};
+
 using ContractorHeap = util::QueryHeap<NodeID,
                                        NodeID,
                                        EdgeWeight,
                                        ContractorHeapData,
-                                       util::XORFastHashStorage<NodeID, NodeID>>;
+                                       WitnessHeapIndexStorage<NodeID, NodeID>>;
 
 } // namespace contractor
 } // namespace osrm
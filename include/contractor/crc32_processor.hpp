@@ -1,128 +1,278 @@
 #ifndef ITERATOR_BASED_CRC32_H
 #define ITERATOR_BASED_CRC32_H
 
-#if defined(__x86_64__) && !defined(__MINGW64__)
-#include <cpuid.h>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define OSRM_CRC32_SSE42
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define OSRM_CRC32_ARMV8
 #endif
 
-#include <boost/crc.hpp> // for boost::crc_32_type
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
 namespace contractor
 {
 
-class IteratorbasedCRC32
+// The checksums are CRC32C (Castagnoli polynomial, reflected) without initial and final xor,
+// which is what the crc32 instructions of SSE 4.2 and ARMv8 compute.
+namespace detail
 {
-  public:
-    bool UsingHardware() const { return use_hardware_implementation; }
+const constexpr std::uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
 
-    IteratorbasedCRC32() : crc(0) { use_hardware_implementation = DetectHardwareSupport(); }
+inline bool HasHardwareCRC32()
+{
+#if defined(OSRM_CRC32_SSE42)
+    static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+    return has_sse42;
+#elif defined(OSRM_CRC32_ARMV8)
+    return true;
+#else
+    return false;
+#endif
+}
 
-    template <class Iterator> unsigned operator()(Iterator iter, const Iterator end)
+#if defined(OSRM_CRC32_SSE42)
+__attribute__((target("sse4.2"))) inline std::uint32_t
+ComputeInHardware(std::uint32_t crc, const char *data, std::size_t size)
+{
+    std::uint64_t crc64 = crc;
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t))
     {
-        unsigned crc = 0;
-        while (iter != end)
-        {
-            using value_type = typename std::iterator_traits<Iterator>::value_type;
-            const char *data = reinterpret_cast<const char *>(&(*iter));
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += sizeof(word);
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+    for (; size > 0; --size)
+    {
+        crc = _mm_crc32_u8(crc, static_cast<std::uint8_t>(*data++));
+    }
+    return crc;
+}
+#elif defined(OSRM_CRC32_ARMV8)
+inline std::uint32_t ComputeInHardware(std::uint32_t crc, const char *data, std::size_t size)
+{
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += sizeof(word);
+    }
+    for (; size > 0; --size)
+    {
+        crc = __crc32cb(crc, static_cast<std::uint8_t>(*data++));
+    }
+    return crc;
+}
+#else
+inline std::uint32_t ComputeInHardware(std::uint32_t crc, const char *, std::size_t)
+{
+    return crc;
+}
+#endif
 
-            if (use_hardware_implementation)
-            {
-                crc = ComputeInHardware(data, sizeof(value_type));
-            }
-            else
+inline std::uint32_t ComputeInSoftware(std::uint32_t crc, const char *data, std::size_t size)
+{
+    static const auto table = [] {
+        std::array<std::uint32_t, 256> table;
+        for (std::uint32_t byte = 0; byte < table.size(); ++byte)
+        {
+            std::uint32_t remainder = byte;
+            for (int bit = 0; bit < 8; ++bit)
             {
-                crc = ComputeInSoftware(data, sizeof(value_type));
+                remainder = (remainder >> 1) ^ ((remainder & 1) ? CRC32C_POLYNOMIAL : 0);
             }
-            ++iter;
+            table[byte] = remainder;
         }
-        return crc;
+        return table;
+    }();
+
+    for (; size > 0; --size)
+    {
+        crc = table[(crc ^ static_cast<std::uint8_t>(*data++)) & 0xff] ^ (crc >> 8);
     }
+    return crc;
+}
 
-  private:
-    bool DetectHardwareSupport() const
+inline std::uint32_t GF2MatrixTimes(const std::array<std::uint32_t, 32> &matrix,
+                                    std::uint32_t vector)
+{
+    std::uint32_t sum = 0;
+    for (std::size_t row = 0; vector != 0; vector >>= 1, ++row)
     {
-        static const int sse42_bit = 0x00100000;
-        const unsigned ecx = cpuid();
-        const bool sse42_found = (ecx & sse42_bit) != 0;
-        return sse42_found;
+        if (vector & 1)
+            sum ^= matrix[row];
     }
+    return sum;
+}
 
-    unsigned ComputeInSoftware(const char *str, unsigned len)
+inline void GF2MatrixSquare(std::array<std::uint32_t, 32> &square,
+                            const std::array<std::uint32_t, 32> &matrix)
+{
+    for (std::size_t row = 0; row < matrix.size(); ++row)
     {
-        crc_processor.process_bytes(str, len);
-        return crc_processor.checksum();
+        square[row] = GF2MatrixTimes(matrix, matrix[row]);
     }
+}
+
+// Checksum of the concatenation of two blocks from their checksums, as in zlib's crc32_combine
+inline std::uint32_t
+CombineCRC32(std::uint32_t first_crc, const std::uint32_t second_crc, std::uint64_t second_size)
+{
+    if (second_size == 0)
+        return first_crc;
 
-    // adapted from http://byteworm.com/2010/10/13/crc32/
-    unsigned ComputeInHardware(const char *str, unsigned len)
+    // the operator that appends a zero bit, then the ones for two and four zero bits
+    std::array<std::uint32_t, 32> odd;
+    std::array<std::uint32_t, 32> even;
+    odd[0] = CRC32C_POLYNOMIAL;
+    for (std::size_t row = 1; row < odd.size(); ++row)
     {
-#if defined(__x86_64__)
-        unsigned q = len / sizeof(unsigned);
-        unsigned r = len % sizeof(unsigned);
-        unsigned *p = (unsigned *)str;
+        odd[row] = 1u << (row - 1);
+    }
+    GF2MatrixSquare(even, odd);
+    GF2MatrixSquare(odd, even);
 
-        // crc=0;
-        while (q--)
-        {
-            __asm__ __volatile__(".byte 0xf2, 0xf, 0x38, 0xf1, 0xf1;"
-                                 : "=S"(crc)
-                                 : "0"(crc), "c"(*p));
-            ++p;
-        }
+    // appends the zero bytes of the second block by squaring up to its size
+    do
+    {
+        GF2MatrixSquare(even, odd);
+        if (second_size & 1)
+            first_crc = GF2MatrixTimes(even, first_crc);
+        second_size >>= 1;
+        if (second_size == 0)
+            break;
+
+        GF2MatrixSquare(odd, even);
+        if (second_size & 1)
+            first_crc = GF2MatrixTimes(odd, first_crc);
+        second_size >>= 1;
+    } while (second_size != 0);
 
-        str = reinterpret_cast<char *>(p);
-        while (r--)
+    return first_crc ^ second_crc;
+}
+
+template <typename T, typename = void> struct IsContiguous : std::false_type
+{
+};
+
+template <typename T>
+struct IsContiguous<T, decltype(static_cast<void>(std::declval<const T &>().data()))>
+    : std::true_type
+{
+};
+}
+
+// Checksum of the elements of a range, read one after the other
+class IteratorbasedCRC32
+{
+  public:
+    bool UsingHardware() const { return use_hardware_implementation; }
+
+    IteratorbasedCRC32() : use_hardware_implementation(detail::HasHardwareCRC32()) {}
+
+    template <class Iterator> unsigned operator()(Iterator iter, const Iterator end) const
+    {
+        using value_type = typename std::iterator_traits<Iterator>::value_type;
+
+        std::uint32_t crc = 0;
+        while (iter != end)
         {
-            __asm__ __volatile__(".byte 0xf2, 0xf, 0x38, 0xf1, 0xf1;"
-                                 : "=S"(crc)
-                                 : "0"(crc), "c"(*str));
-            ++str;
+            crc = Compute(crc, reinterpret_cast<const char *>(&(*iter)), sizeof(value_type));
+            ++iter;
         }
-#else
-        (void)str;
-        (void)len;
-#endif
         return crc;
     }
 
-    inline unsigned cpuid() const
+    std::uint32_t Compute(const std::uint32_t crc, const char *data, const std::size_t size) const
     {
-        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
-        // on X64 this calls hardware cpuid(.) instr. otherwise a dummy impl.
-        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
-        return ecx;
+        return use_hardware_implementation ? detail::ComputeInHardware(crc, data, size)
+                                           : detail::ComputeInSoftware(crc, data, size);
     }
 
-#if defined(__MINGW64__) || defined(_MSC_VER) || !defined(__x86_64__)
-    inline void __get_cpuid(int /*param*/,
-                            unsigned * /*eax*/,
-                            unsigned * /*ebx*/,
-                            unsigned *ecx,
-                            unsigned * /*edx*/) const
-    {
-        *ecx = 0;
-    }
-#endif
-
-    boost::crc_optimal<32, 0x1EDC6F41, 0x0, 0x0, true, true> crc_processor;
-    unsigned crc;
+  private:
     bool use_hardware_implementation;
 };
 
+// Checksum of the elements of a random access range. The range is split into slices of
+// SLICE_SIZE bytes whose checksums are computed in parallel and then combined, so the range
+// has to be safe to read from several threads. Contiguous ranges are read as one block of bytes.
+// The checksum is the same as the one of IteratorbasedCRC32.
 struct RangebasedCRC32
 {
-    template <typename Iteratable> unsigned operator()(const Iteratable &iterable)
+    static constexpr std::size_t SLICE_SIZE = 1 << 20;
+
+    template <typename Iteratable> unsigned operator()(const Iteratable &iterable) const
     {
-        return crc32(std::begin(iterable), std::end(iterable));
+        using value_type = typename std::decay<decltype(*std::begin(iterable))>::type;
+
+        const auto begin = std::begin(iterable);
+        const std::size_t size = std::distance(begin, std::end(iterable));
+        const std::size_t slice_size = std::max<std::size_t>(1, SLICE_SIZE / sizeof(value_type));
+        const std::size_t number_of_slices = (size + slice_size - 1) / slice_size;
+
+        std::vector<std::uint32_t> slice_crcs(number_of_slices);
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_slices),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto slice = range.begin(); slice < range.end(); ++slice)
+                              {
+                                  const auto first = slice * slice_size;
+                                  const auto last = std::min(size, first + slice_size);
+                                  slice_crcs[slice] = ComputeSlice(
+                                      iterable, first, last, detail::IsContiguous<Iteratable>());
+                              }
+                          });
+
+        std::uint32_t crc = 0;
+        for (auto slice = 0u; slice < number_of_slices; ++slice)
+        {
+            const auto first = slice * slice_size;
+            const auto last = std::min(size, first + slice_size);
+            crc = detail::CombineCRC32(crc, slice_crcs[slice], (last - first) * sizeof(value_type));
+        }
+        return crc;
     }
 
     bool UsingHardware() const { return crc32.UsingHardware(); }
 
   private:
+    template <typename Iteratable>
+    std::uint32_t ComputeSlice(const Iteratable &iterable,
+                               const std::size_t first,
+                               const std::size_t last,
+                               std::true_type) const
+    {
+        using value_type = typename std::decay<decltype(*iterable.data())>::type;
+        return crc32.Compute(0,
+                             reinterpret_cast<const char *>(iterable.data() + first),
+                             (last - first) * sizeof(value_type));
+    }
+
+    template <typename Iteratable>
+    std::uint32_t ComputeSlice(const Iteratable &iterable,
+                               const std::size_t first,
+                               const std::size_t last,
+                               std::false_type) const
+    {
+        const auto begin = std::begin(iterable);
+        return crc32(begin + first, begin + last);
+    }
+
     IteratorbasedCRC32 crc32;
 };
 }
@@ -0,0 +1,169 @@
+#ifndef OSRM_CONTRACTOR_DOWNWARD_SWEEP_GRAPH_HPP
+#define OSRM_CONTRACTOR_DOWNWARD_SWEEP_GRAPH_HPP
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+/**
+ * Copy of the downward edges of a contracted graph for a linear top-down sweep (PHAST).
+ *
+ * The query graph stores every edge at its lower node pointing upwards, so all edges with
+ * the backward flag set are downward edges into the node they are stored at. Contraction
+ * levels are not part of the dataset, so nodes are layered by their depth below the top of the
+ * upward graph instead: nodes without upward edges have depth 0 and every other node is one
+ * deeper than its deepest upward neighbour. Ranking nodes by depth gives a topological order of
+ * the downward graph, and edges are grouped by the rank of their target. Sweeping the ranks in
+ * order only ever reads entries of lower ranks that are already final, and accesses memory
+ * mostly sequentially.
+ */
+class DownwardSweepGraph
+{
+  public:
+    using Rank = std::uint32_t;
+
+    struct Edge
+    {
+        Rank source;
+        EdgeWeight weight;
+        EdgeWeight duration;
+    };
+
+    DownwardSweepGraph() = default;
+
+    template <typename GraphT> explicit DownwardSweepGraph(const GraphT &graph)
+    {
+        const auto number_of_nodes = graph.GetNumberOfNodes();
+
+        const auto depths = ComputeDepths(graph);
+
+        node_of_rank.resize(number_of_nodes);
+        std::iota(node_of_rank.begin(), node_of_rank.end(), NodeID{0});
+        std::stable_sort(node_of_rank.begin(), node_of_rank.end(), [&](NodeID lhs, NodeID rhs) {
+            return depths[lhs] < depths[rhs];
+        });
+
+        rank_of_node.resize(number_of_nodes);
+        for (const auto rank : util::irange<Rank>(0, number_of_nodes))
+        {
+            rank_of_node[node_of_rank[rank]] = rank;
+        }
+
+        first_edge.reserve(number_of_nodes + 1);
+        for (const auto rank : util::irange<Rank>(0, number_of_nodes))
+        {
+            first_edge.push_back(edges.size());
+            const auto node = node_of_rank[rank];
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                const auto &data = graph.GetEdgeData(edge);
+                const auto target = graph.GetTarget(edge);
+                // loops are handled by the queries, they can't improve a sweep
+                if (data.backward && target != node)
+                {
+                    BOOST_ASSERT(rank_of_node[target] < rank);
+                    edges.push_back({rank_of_node[target], data.weight, data.duration});
+                }
+            }
+        }
+        first_edge.push_back(edges.size());
+    }
+
+    std::size_t GetNumberOfNodes() const { return node_of_rank.size(); }
+
+    NodeID GetNode(const Rank rank) const { return node_of_rank[rank]; }
+
+    Rank GetRank(const NodeID node) const { return rank_of_node[node]; }
+
+    // downward edges into the node of the given rank
+    util::range<std::size_t> GetIncomingEdgeRange(const Rank rank) const
+    {
+        return util::irange(first_edge[rank], first_edge[rank + 1]);
+    }
+
+    const Edge &GetEdge(const std::size_t edge) const { return edges[edge]; }
+
+    // Depth of each node below the top of the upward graph, computed in depth-first post-order.
+    // A fully contracted graph is acyclic, edges closing a cycle are asserted against. Nodes of
+    // the same depth are never connected by an edge.
+    template <typename GraphT> static std::vector<Rank> ComputeDepths(const GraphT &graph)
+    {
+        const auto number_of_nodes = graph.GetNumberOfNodes();
+
+        enum : std::uint8_t
+        {
+            NotVisited,
+            OnStack,
+            Done
+        };
+        std::vector<std::uint8_t> state(number_of_nodes, NotVisited);
+        std::vector<Rank> depths(number_of_nodes, 0);
+
+        std::vector<std::pair<NodeID, EdgeID>> stack;
+        for (const auto root : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (state[root] != NotVisited)
+                continue;
+
+            state[root] = OnStack;
+            stack.emplace_back(root, graph.BeginEdges(root));
+            while (!stack.empty())
+            {
+                const auto node = stack.back().first;
+                auto &edge = stack.back().second;
+
+                if (edge == graph.EndEdges(node))
+                {
+                    state[node] = Done;
+                    stack.pop_back();
+                    if (!stack.empty())
+                    {
+                        const auto parent = stack.back().first;
+                        depths[parent] = std::max<Rank>(depths[parent], depths[node] + 1);
+                    }
+                    continue;
+                }
+
+                const auto target = graph.GetTarget(edge);
+                ++edge;
+                if (target == node)
+                    continue;
+
+                BOOST_ASSERT_MSG(state[target] != OnStack, "upward graph is not acyclic");
+                if (state[target] == NotVisited)
+                {
+                    state[target] = OnStack;
+                    stack.emplace_back(target, graph.BeginEdges(target));
+                }
+                else
+                {
+                    depths[node] = std::max<Rank>(depths[node], depths[target] + 1);
+                }
+            }
+        }
+
+        return depths;
+    }
+
+  private:
+    std::vector<NodeID> node_of_rank;
+    std::vector<Rank> rank_of_node;
+    std::vector<std::size_t> first_edge;
+    std::vector<Edge> edges;
+};
+}
+}
+
+#endif // OSRM_CONTRACTOR_DOWNWARD_SWEEP_GRAPH_HPP
@@ -1,8 +1,12 @@
 #ifndef OSRM_CONTRACTOR_FILES_HPP
 #define OSRM_CONTRACTOR_FILES_HPP
 
+#include "contractor/compressed_search_graph.hpp"
+#include "contractor/hub_labels.hpp"
 #include "contractor/query_graph.hpp"
+#include "contractor/serialization.hpp"
 
+#include "util/landmarks.hpp"
 #include "util/serialization.hpp"
 
 #include "storage/io.hpp"
@@ -66,6 +70,68 @@ writeGraph(const boost::filesystem::path &path, unsigned checksum, const QueryGr
     util::serialization::write(writer, graph);
 }
 
+// reads .osrm.hsgr.compressed file, the checksum is the one of the .hsgr it was encoded from
+template <typename CompressedSearchGraphT>
+inline void readCompressedSearchGraph(const boost::filesystem::path &path,
+                                      unsigned &checksum,
+                                      CompressedSearchGraphT &graph)
+{
+    static_assert(std::is_same<CompressedSearchGraphView, CompressedSearchGraphT>::value ||
+                      std::is_same<CompressedSearchGraph, CompressedSearchGraphT>::value,
+                  "graph must be of type CompressedSearchGraph");
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    reader.ReadInto(checksum);
+    serialization::read(reader, graph);
+}
+
+// writes .osrm.hsgr.compressed file
+template <typename CompressedSearchGraphT>
+inline void writeCompressedSearchGraph(const boost::filesystem::path &path,
+                                       unsigned checksum,
+                                       const CompressedSearchGraphT &graph)
+{
+    static_assert(std::is_same<CompressedSearchGraphView, CompressedSearchGraphT>::value ||
+                      std::is_same<CompressedSearchGraph, CompressedSearchGraphT>::value,
+                  "graph must be of type CompressedSearchGraph");
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    writer.WriteOne(checksum);
+    serialization::write(writer, graph);
+}
+
+// reads .osrm.hsgr.labels file, the checksum is the one of the .hsgr the labels were built from
+template <typename HubLabelsT>
+inline void
+readHubLabels(const boost::filesystem::path &path, unsigned &checksum, HubLabelsT &labels)
+{
+    static_assert(std::is_same<HubLabelsView, HubLabelsT>::value ||
+                      std::is_same<HubLabels, HubLabelsT>::value,
+                  "labels must be of type HubLabels");
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    reader.ReadInto(checksum);
+    serialization::read(reader, labels);
+}
+
+// writes .osrm.hsgr.labels file
+template <typename HubLabelsT>
+inline void
+writeHubLabels(const boost::filesystem::path &path, unsigned checksum, const HubLabelsT &labels)
+{
+    static_assert(std::is_same<HubLabelsView, HubLabelsT>::value ||
+                      std::is_same<HubLabels, HubLabelsT>::value,
+                  "labels must be of type HubLabels");
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    writer.WriteOne(checksum);
+    serialization::write(writer, labels);
+}
+
 // reads .levels file
 inline void readLevels(const boost::filesystem::path &path, std::vector<float> &node_levels)
 {
@@ -83,6 +149,32 @@ inline void writeLevels(const boost::filesystem::path &path, const std::vector<f
 
     storage::serialization::write(writer, node_levels);
 }
+
+// reads .osrm.landmarks file
+template <typename LandmarksT>
+inline void readLandmarks(const boost::filesystem::path &path, LandmarksT &landmarks)
+{
+    static_assert(std::is_same<util::LandmarksView, LandmarksT>::value ||
+                      std::is_same<util::Landmarks, LandmarksT>::value,
+                  "landmarks must be of type Landmarks");
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    util::serialization::read(reader, landmarks);
+}
+
+// writes .osrm.landmarks file
+template <typename LandmarksT>
+inline void writeLandmarks(const boost::filesystem::path &path, const LandmarksT &landmarks)
+{
+    static_assert(std::is_same<util::LandmarksView, LandmarksT>::value ||
+                      std::is_same<util::Landmarks, LandmarksT>::value,
+                  "landmarks must be of type Landmarks");
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    util::serialization::write(writer, landmarks);
+}
 }
 }
 }
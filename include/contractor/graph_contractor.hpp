@@ -4,6 +4,7 @@
 #include "contractor/contractor_dijkstra.hpp"
 #include "contractor/contractor_graph.hpp"
 #include "contractor/query_edge.hpp"
+#include "contractor/query_graph.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
@@ -38,7 +39,10 @@ class GraphContractor
         ContractorDijkstra dijkstra;
         std::vector<ContractorEdge> inserted_edges;
         std::vector<NodeID> neighbours;
-        explicit ContractorThreadData(NodeID nodes) : dijkstra(nodes) {}
+        ContractorThreadData(NodeID nodes, const WitnessSearchParameters &witness_search)
+            : dijkstra(nodes, witness_search.storage, witness_search.hop_limit)
+        {
+        }
     };
 
     using NodeDepth = int;
@@ -63,9 +67,24 @@ class GraphContractor
         bool is_independent : 1;
     };
 
+    // Time spent in the phases of a contraction round in milliseconds
+    struct RoundTimings
+    {
+        std::size_t contracted_nodes;
+        double independent_set;
+        double contraction;
+        double deletion;
+        double insertion;
+        double priorities;
+        double release;
+    };
+
     struct ThreadDataContainer
     {
-        explicit ThreadDataContainer(int number_of_nodes) : number_of_nodes(number_of_nodes) {}
+        ThreadDataContainer(int number_of_nodes, const WitnessSearchParameters &witness_search)
+            : number_of_nodes(number_of_nodes), witness_search(witness_search)
+        {
+        }
 
         inline ContractorThreadData *GetThreadData()
         {
@@ -73,14 +92,14 @@ class GraphContractor
             auto &ref = data.local(exists);
             if (!exists)
             {
-                // ref = std::make_shared<ContractorThreadData>(number_of_nodes);
-                ref = std::make_shared<ContractorThreadData>(4000);
+                ref = std::make_shared<ContractorThreadData>(number_of_nodes, witness_search);
             }
 
             return ref.get();
         }
 
         int number_of_nodes;
+        const WitnessSearchParameters witness_search;
         using EnumerableThreadData =
             tbb::enumerable_thread_specific<std::shared_ptr<ContractorThreadData>>;
         EnumerableThreadData data;
@@ -92,14 +111,29 @@ class GraphContractor
     GraphContractor(int nodes,
                     std::vector<ContractorEdge> edges,
                     std::vector<float> node_levels_,
-                    std::vector<EdgeWeight> node_weights_);
+                    std::vector<EdgeWeight> node_weights_,
+                    WitnessSearchParameters witness_search = {});
 
     /* Flush all data from the contraction to disc and reorder stuff for better locality */
     void FlushDataAndRebuildContractorGraph(ThreadDataContainer &thread_data_list,
                                             std::vector<RemainingNodeData> &remaining_nodes,
                                             std::vector<float> &node_priorities);
 
-    void Run(double core_factor = 1.0);
+    // Shortcuts of a previous hierarchy are inserted again by Run without a witness search if
+    // their nodes are contracted in the same order. All weights are computed from the new edges.
+    void UsePreviousShortcuts(const QueryGraph &hierarchy);
+
+    // Nodes marked here are never contracted by Run, they stay in the graph together with the
+    // edges between them. Ids are the ones passed to the constructor.
+    void KeepNodes(std::vector<bool> is_kept_node);
+
+    // Moves the edges between the kept nodes out of the graph after Run, with the data needed to
+    // continue their contraction in another GraphContractor. Node ids and the middle nodes of
+    // shortcuts are the ids passed to the constructor. GetEdges returns the other edges.
+    std::vector<ContractorEdge> GetKeptEdges();
+
+    // Logs the time spent in every contraction round if `debug_timings` is set
+    void Run(double core_factor = 1.0, bool debug_timings = false);
 
     std::vector<bool> GetCoreMarker();
 
@@ -115,43 +149,14 @@ class GraphContractor
         const NodeID number_of_nodes = contractor_graph->GetNumberOfNodes();
         if (contractor_graph->GetNumberOfNodes())
         {
-            Edge new_edge;
             for (const auto node : util::irange(0u, number_of_nodes))
             {
                 p.PrintStatus(node);
                 for (auto edge : contractor_graph->GetAdjacentEdgeRange(node))
                 {
-                    const NodeID target = contractor_graph->GetTarget(edge);
-                    const ContractorGraph::EdgeData &data = contractor_graph->GetEdgeData(edge);
-                    if (!orig_node_id_from_new_node_id_map.empty())
-                    {
-                        new_edge.source = orig_node_id_from_new_node_id_map[node];
-                        new_edge.target = orig_node_id_from_new_node_id_map[target];
-                    }
-                    else
-                    {
-                        new_edge.source = node;
-                        new_edge.target = target;
-                    }
-                    BOOST_ASSERT_MSG(SPECIAL_NODEID != new_edge.source, "Source id invalid");
-                    BOOST_ASSERT_MSG(SPECIAL_NODEID != new_edge.target, "Target id invalid");
-                    new_edge.data.weight = data.weight;
-                    new_edge.data.duration = data.duration;
-                    new_edge.data.shortcut = data.shortcut;
-                    if (!data.is_original_via_node_ID && !orig_node_id_from_new_node_id_map.empty())
-                    {
-                        // tranlate the _node id_ of the shortcutted node
-                        new_edge.data.turn_id = orig_node_id_from_new_node_id_map[data.id];
-                    }
-                    else
-                    {
-                        new_edge.data.turn_id = data.id;
-                    }
-                    BOOST_ASSERT_MSG(new_edge.data.turn_id != INT_MAX, // 2^31
-                                     "edge id invalid");
-                    new_edge.data.forward = data.forward;
-                    new_edge.data.backward = data.backward;
-                    edges.push_back(new_edge);
+                    edges.push_back(MakeHierarchyEdge<Edge>(node,
+                                                            contractor_graph->GetTarget(edge),
+                                                            contractor_graph->GetEdgeData(edge)));
                 }
             }
         }
@@ -173,6 +178,44 @@ class GraphContractor
     }
 
   private:
+    // Edge of the hierarchy with the node ids passed to the constructor
+    template <class Edge>
+    Edge MakeHierarchyEdge(const NodeID source,
+                           const NodeID target,
+                           const ContractorEdgeData &data) const
+    {
+        Edge new_edge;
+        if (!orig_node_id_from_new_node_id_map.empty())
+        {
+            new_edge.source = orig_node_id_from_new_node_id_map[source];
+            new_edge.target = orig_node_id_from_new_node_id_map[target];
+        }
+        else
+        {
+            new_edge.source = source;
+            new_edge.target = target;
+        }
+        BOOST_ASSERT_MSG(SPECIAL_NODEID != new_edge.source, "Source id invalid");
+        BOOST_ASSERT_MSG(SPECIAL_NODEID != new_edge.target, "Target id invalid");
+        new_edge.data.weight = data.weight;
+        new_edge.data.duration = data.duration;
+        new_edge.data.shortcut = data.shortcut;
+        if (!data.is_original_via_node_ID && !orig_node_id_from_new_node_id_map.empty())
+        {
+            // tranlate the _node id_ of the shortcutted node
+            new_edge.data.turn_id = orig_node_id_from_new_node_id_map[data.id];
+        }
+        else
+        {
+            new_edge.data.turn_id = data.id;
+        }
+        BOOST_ASSERT_MSG(new_edge.data.turn_id != INT_MAX, // 2^31
+                         "edge id invalid");
+        new_edge.data.forward = data.forward;
+        new_edge.data.backward = data.backward;
+        return new_edge;
+    }
+
     float EvaluateNodePriority(ContractorThreadData *const data,
                                const NodeDepth node_depth,
                                const NodeID node);
@@ -208,6 +251,10 @@ class GraphContractor
                 continue;
             }
 
+            // all shortcuts of the source are inserted again without looking for witnesses
+            const bool use_previous_shortcuts =
+                !RUNSIMULATION && HasPreviousShortcuts(node, source);
+
             dijkstra.Clear();
             dijkstra.Insert(source, 0, ContractorHeapData{});
             EdgeWeight max_weight = 0;
@@ -275,6 +322,10 @@ class GraphContractor
                     }
                     continue;
                 }
+                if (use_previous_shortcuts)
+                {
+                    continue;
+                }
                 max_weight = std::max(max_weight, path_weight);
                 if (!dijkstra.WasInserted(target))
                 {
@@ -285,18 +336,19 @@ class GraphContractor
 
             if (RUNSIMULATION)
             {
-                const int constexpr SIMULATION_SEARCH_SPACE_SIZE = 1000;
                 dijkstra.Run(number_of_targets,
-                             SIMULATION_SEARCH_SPACE_SIZE,
+                             witness_search.simulation_node_limit,
                              max_weight,
                              node,
                              *contractor_graph);
             }
-            else
+            else if (number_of_targets > 0)
             {
-                const int constexpr FULL_SEARCH_SPACE_SIZE = 2000;
-                dijkstra.Run(
-                    number_of_targets, FULL_SEARCH_SPACE_SIZE, max_weight, node, *contractor_graph);
+                dijkstra.Run(number_of_targets,
+                             witness_search.contraction_node_limit,
+                             max_weight,
+                             node,
+                             *contractor_graph);
             }
             for (auto out_edge : contractor_graph->GetAdjacentEdgeRange(node))
             {
@@ -310,7 +362,9 @@ class GraphContractor
                     continue;
 
                 const EdgeWeight path_weight = in_data.weight + out_data.weight;
-                const EdgeWeight weight = dijkstra.GetKey(target);
+                const EdgeWeight weight = use_previous_shortcuts && target != source
+                                              ? INVALID_EDGE_WEIGHT
+                                              : dijkstra.GetKey(target);
                 if (path_weight < weight)
                 {
                     if (RUNSIMULATION)
@@ -388,6 +442,25 @@ class GraphContractor
 
     void DeleteIncomingEdges(ContractorThreadData *data, const NodeID node);
 
+    // Moves the edges of the nodes contracted in a round into the external edge list of the
+    // hierarchy and returns their blocks to the graph for the shortcuts of later rounds
+    void ReleaseContractedNodes(const std::vector<RemainingNodeData> &remaining_nodes,
+                                const std::size_t begin,
+                                const std::size_t end);
+
+    bool IsKept(const NodeID node) const;
+
+    // Are the paths from source over node to all of its other neighbours shortcuts of the
+    // previous hierarchy
+    bool HasPreviousShortcuts(const NodeID node, const NodeID source) const;
+
+    // Moves the shortcuts of all threads into the graph, in parallel for distinct sources
+    void InsertShortcuts(ThreadDataContainer &thread_data_list);
+
+    void LogRoundTimings(const std::vector<RoundTimings> &round_timings,
+                         const double flush_msec,
+                         const bool debug_timings) const;
+
     bool UpdateNodeNeighbours(std::vector<float> &priorities,
                               std::vector<NodeDepth> &node_depth,
                               ContractorThreadData *const data,
@@ -412,7 +485,14 @@ class GraphContractor
     // self-loops are added.
     std::vector<EdgeWeight> node_weights;
     std::vector<bool> is_core_node;
+    std::vector<bool> is_kept_node;
     util::XORFastHash<> fast_hash;
+    WitnessSearchParameters witness_search;
+
+    // (source, target) pairs of the previous shortcuts sorted by middle node, the pairs of a
+    // middle node are sorted as well. All ids are node ids before the flush renumbering.
+    std::vector<std::size_t> previous_shortcut_offsets;
+    std::vector<std::pair<NodeID, NodeID>> previous_shortcuts;
 };
 
 } // namespace contractor
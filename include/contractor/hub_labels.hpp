@@ -0,0 +1,434 @@
+#ifndef OSRM_CONTRACTOR_HUB_LABELS_HPP
+#define OSRM_CONTRACTOR_HUB_LABELS_HPP
+
+#include "contractor/downward_sweep_graph.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace osrm
+{
+namespace contractor
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class HubLabelsImpl;
+}
+using HubLabels = detail::HubLabelsImpl<storage::Ownership::Container>;
+using HubLabelsView = detail::HubLabelsImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::HubLabelsImpl<Ownership> &labels);
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer, const detail::HubLabelsImpl<Ownership> &labels);
+}
+
+namespace detail
+{
+// Calls callback(first_index, second_index) for every hub that both sorted ranges contain,
+// starting at the given indices
+template <typename CallbackT>
+inline void intersectHubsScalar(const NodeID *first,
+                                std::size_t first_index,
+                                const std::size_t first_size,
+                                const NodeID *second,
+                                std::size_t second_index,
+                                const std::size_t second_size,
+                                CallbackT &&callback)
+{
+    while (first_index < first_size && second_index < second_size)
+    {
+        if (first[first_index] < second[second_index])
+        {
+            ++first_index;
+        }
+        else if (second[second_index] < first[first_index])
+        {
+            ++second_index;
+        }
+        else
+        {
+            callback(first_index++, second_index++);
+        }
+    }
+}
+
+#if defined(__AVX2__)
+// Compares blocks of eight hubs of both ranges all against all by rotating the second block
+// through the lanes. Common hubs are rare, so the blocks are mostly just skipped: the one with
+// the smaller last hub can't match any later hub of the other range.
+template <typename CallbackT>
+inline void intersectHubs(const NodeID *first,
+                          const std::size_t first_size,
+                          const NodeID *second,
+                          const std::size_t second_size,
+                          CallbackT &&callback)
+{
+    const auto rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+
+    std::size_t first_index = 0, second_index = 0;
+    while (first_index + 8 <= first_size && second_index + 8 <= second_size)
+    {
+        const auto first_block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + first_index));
+        auto second_block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(second + second_index));
+        auto matches = _mm256_cmpeq_epi32(first_block, second_block);
+        for (int rotation = 1; rotation < 8; ++rotation)
+        {
+            second_block = _mm256_permutevar8x32_epi32(second_block, rotate);
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(first_block, second_block));
+        }
+
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(matches)));
+        while (mask != 0)
+        {
+            const auto lane = static_cast<std::size_t>(__builtin_ctz(mask));
+            mask &= mask - 1;
+            const auto *match = std::lower_bound(
+                second + second_index, second + second_index + 8, first[first_index + lane]);
+            callback(first_index + lane, static_cast<std::size_t>(match - second));
+        }
+
+        const auto first_last = first[first_index + 7];
+        const auto second_last = second[second_index + 7];
+        if (first_last <= second_last)
+            first_index += 8;
+        if (second_last <= first_last)
+            second_index += 8;
+    }
+
+    intersectHubsScalar(
+        first, first_index, first_size, second, second_index, second_size, callback);
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+template <typename CallbackT>
+inline void intersectHubs(const NodeID *first,
+                          const std::size_t first_size,
+                          const NodeID *second,
+                          const std::size_t second_size,
+                          CallbackT &&callback)
+{
+    std::size_t first_index = 0, second_index = 0;
+    while (first_index + 4 <= first_size && second_index + 4 <= second_size)
+    {
+        const auto first_block = vld1q_u32(first + first_index);
+        const auto second_block = vld1q_u32(second + second_index);
+        const auto matches = vorrq_u32(
+            vorrq_u32(vceqq_u32(first_block, second_block),
+                      vceqq_u32(first_block, vextq_u32(second_block, second_block, 1))),
+            vorrq_u32(vceqq_u32(first_block, vextq_u32(second_block, second_block, 2)),
+                      vceqq_u32(first_block, vextq_u32(second_block, second_block, 3))));
+
+        std::uint32_t lanes[4];
+        vst1q_u32(lanes, matches);
+        for (const auto lane : util::irange<std::size_t>(0, 4))
+        {
+            if (lanes[lane] == 0)
+                continue;
+            const auto *match = std::lower_bound(
+                second + second_index, second + second_index + 4, first[first_index + lane]);
+            callback(first_index + lane, static_cast<std::size_t>(match - second));
+        }
+
+        const auto first_last = first[first_index + 3];
+        const auto second_last = second[second_index + 3];
+        if (first_last <= second_last)
+            first_index += 4;
+        if (second_last <= first_last)
+            second_index += 4;
+    }
+
+    intersectHubsScalar(
+        first, first_index, first_size, second, second_index, second_size, callback);
+}
+#else
+template <typename CallbackT>
+inline void intersectHubs(const NodeID *first,
+                          const std::size_t first_size,
+                          const NodeID *second,
+                          const std::size_t second_size,
+                          CallbackT &&callback)
+{
+    intersectHubsScalar(first, 0, first_size, second, 0, second_size, callback);
+}
+#endif
+
+/**
+ * Hub labels of a contraction hierarchy for point-to-point queries without any search.
+ *
+ * The forward label of a node holds the nodes its upward searches settle together with the
+ * weight and duration of the upward path to them, the backward label the same for the paths
+ * from them. Every shortest path contains a node of the forward label of its source and of the
+ * backward label of its target, so the weight between two nodes is the smallest sum of both
+ * labels over their common hubs. The labels are computed top-down in the order of the hierarchy,
+ * every label is the union of the labels of the upward neighbours of the node. Entries whose
+ * weight the labels of the node and of the hub already undercut are not on shortest paths and
+ * are dropped.
+ *
+ * The hubs of a label are sorted by id in one array with the weights and durations in arrays of
+ * their own, so the merge of two labels compares plain runs of hub ids with vector instructions
+ * and only reads the weights of the few hubs they share. Label 2 * node is the forward label of
+ * the node and 2 * node + 1 its backward label.
+ */
+template <storage::Ownership Ownership> class HubLabelsImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    struct Path
+    {
+        EdgeWeight weight;
+        EdgeDuration duration;
+    };
+
+    HubLabelsImpl() = default;
+
+    HubLabelsImpl(Vector<std::uint64_t> offsets_,
+                  Vector<NodeID> hubs_,
+                  Vector<EdgeWeight> weights_,
+                  Vector<EdgeDuration> durations_)
+        : offsets(std::move(offsets_)), hubs(std::move(hubs_)), weights(std::move(weights_)),
+          durations(std::move(durations_))
+    {
+        BOOST_ASSERT(offsets.empty() || offsets.back() == hubs.size());
+        BOOST_ASSERT(hubs.size() == weights.size() && hubs.size() == durations.size());
+    }
+
+    template <typename GraphT> explicit HubLabelsImpl(const GraphT &graph)
+    {
+        Build(graph);
+    }
+
+    std::size_t GetNumberOfNodes() const { return offsets.empty() ? 0 : (offsets.size() - 1) / 2; }
+
+    // Number of hubs of all labels
+    std::size_t GetNumberOfEntries() const { return hubs.size(); }
+
+    // Calls callback(hub, weight, duration) for every common hub of the forward label of from and
+    // the backward label of to with the sums of both labels
+    template <typename CallbackT>
+    void ForEachCommonHub(const NodeID from, const NodeID to, CallbackT &&callback) const
+    {
+        BOOST_ASSERT(from < GetNumberOfNodes() && to < GetNumberOfNodes());
+        const auto forward_begin = offsets[2 * from];
+        const auto backward_begin = offsets[2 * to + 1];
+        intersectHubs(hubs.data() + forward_begin,
+                      offsets[2 * from + 1] - forward_begin,
+                      hubs.data() + backward_begin,
+                      offsets[2 * to + 2] - backward_begin,
+                      [&](const std::size_t forward_index, const std::size_t backward_index) {
+                          const auto forward = forward_begin + forward_index;
+                          const auto backward = backward_begin + backward_index;
+                          callback(hubs[forward],
+                                   weights[forward] + weights[backward],
+                                   durations[forward] + durations[backward]);
+                      });
+    }
+
+    // Shortest path from -> to, INVALID_EDGE_WEIGHT and MAXIMAL_EDGE_DURATION if there is none
+    Path GetShortestPath(const NodeID from, const NodeID to) const
+    {
+        Path path{INVALID_EDGE_WEIGHT, MAXIMAL_EDGE_DURATION};
+        ForEachCommonHub(
+            from, to, [&](const NodeID, const EdgeWeight weight, const EdgeDuration duration) {
+                if (std::tie(weight, duration) < std::tie(path.weight, path.duration))
+                    path = {weight, duration};
+            });
+        return path;
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               HubLabelsImpl &labels);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const HubLabelsImpl &labels);
+
+  private:
+    struct Label
+    {
+        std::vector<NodeID> hubs;
+        std::vector<EdgeWeight> weights;
+        std::vector<EdgeDuration> durations;
+    };
+
+    struct Entry
+    {
+        NodeID hub;
+        EdgeWeight weight;
+        EdgeDuration duration;
+
+        bool operator<(const Entry &other) const
+        {
+            return std::tie(hub, weight, duration) <
+                   std::tie(other.hub, other.weight, other.duration);
+        }
+    };
+
+    // Smallest weight over the common hubs of both labels except the excluded one
+    static EdgeWeight
+    GetWeight(const Label &forward, const Label &backward, const NodeID excluded_hub)
+    {
+        EdgeWeight weight = INVALID_EDGE_WEIGHT;
+        intersectHubs(forward.hubs.data(),
+                      forward.hubs.size(),
+                      backward.hubs.data(),
+                      backward.hubs.size(),
+                      [&](const std::size_t forward_index, const std::size_t backward_index) {
+                          if (forward.hubs[forward_index] != excluded_hub)
+                              weight = std::min(weight,
+                                                forward.weights[forward_index] +
+                                                    backward.weights[backward_index]);
+                      });
+        return weight;
+    }
+
+    // Label of the node in the direction out of the labels of its upward neighbours, which are
+    // final. A hub is dropped if another hub gives a smaller weight to it, with the labels of
+    // the opposite direction of the hubs, which are final as well.
+    template <bool FORWARD, typename GraphT>
+    static Label BuildLabel(const GraphT &graph,
+                            const NodeID node,
+                            const std::vector<Label> &labels,
+                            const std::vector<Label> &opposite_labels,
+                            std::vector<Entry> &entries)
+    {
+        entries.clear();
+        entries.push_back({node, 0, 0});
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            const auto target = graph.GetTarget(edge);
+            if (target == node || !(FORWARD ? data.forward : data.backward))
+                continue;
+
+            const auto &label = labels[target];
+            for (const auto index : util::irange<std::size_t>(0, label.hubs.size()))
+            {
+                entries.push_back({label.hubs[index],
+                                   label.weights[index] + data.weight,
+                                   label.durations[index] + data.duration});
+            }
+        }
+
+        // the best entry of every hub
+        std::sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(),
+                                  entries.end(),
+                                  [](const Entry &lhs, const Entry &rhs) {
+                                      return lhs.hub == rhs.hub;
+                                  }),
+                      entries.end());
+
+        Label candidates;
+        candidates.hubs.reserve(entries.size());
+        candidates.weights.reserve(entries.size());
+        for (const auto &entry : entries)
+        {
+            candidates.hubs.push_back(entry.hub);
+            candidates.weights.push_back(entry.weight);
+        }
+
+        Label label;
+        for (const auto &entry : entries)
+        {
+            if (entry.hub != node)
+            {
+                const auto &opposite = opposite_labels[entry.hub];
+                const auto weight = FORWARD ? GetWeight(candidates, opposite, entry.hub)
+                                            : GetWeight(opposite, candidates, entry.hub);
+                if (weight < entry.weight)
+                    continue;
+            }
+            label.hubs.push_back(entry.hub);
+            label.weights.push_back(entry.weight);
+            label.durations.push_back(entry.duration);
+        }
+        return label;
+    }
+
+    // Labels the nodes layer by layer from the top of the hierarchy down. The nodes of a layer
+    // are not connected, their labels only depend on the layers above and are built in parallel.
+    template <typename GraphT> void Build(const GraphT &graph)
+    {
+        const auto number_of_nodes = graph.GetNumberOfNodes();
+        const auto depths = DownwardSweepGraph::ComputeDepths(graph);
+
+        std::vector<NodeID> nodes(number_of_nodes);
+        std::iota(nodes.begin(), nodes.end(), NodeID{0});
+        std::stable_sort(nodes.begin(), nodes.end(), [&](const NodeID lhs, const NodeID rhs) {
+            return depths[lhs] < depths[rhs];
+        });
+
+        std::vector<Label> forward_labels(number_of_nodes);
+        std::vector<Label> backward_labels(number_of_nodes);
+        for (std::size_t layer_begin = 0, layer_end = 0; layer_begin < number_of_nodes;
+             layer_begin = layer_end)
+        {
+            const auto depth = depths[nodes[layer_begin]];
+            while (layer_end < number_of_nodes && depths[nodes[layer_end]] == depth)
+                ++layer_end;
+
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(layer_begin, layer_end),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  std::vector<Entry> entries;
+                                  for (auto index = range.begin(); index != range.end(); ++index)
+                                  {
+                                      const auto node = nodes[index];
+                                      forward_labels[node] = BuildLabel<true>(
+                                          graph, node, forward_labels, backward_labels, entries);
+                                      backward_labels[node] = BuildLabel<false>(
+                                          graph, node, backward_labels, forward_labels, entries);
+                                  }
+                              });
+        }
+
+        offsets.reserve(2 * number_of_nodes + 1);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            for (const auto *label : {&forward_labels[node], &backward_labels[node]})
+            {
+                offsets.push_back(hubs.size());
+                hubs.insert(hubs.end(), label->hubs.begin(), label->hubs.end());
+                weights.insert(weights.end(), label->weights.begin(), label->weights.end());
+                durations.insert(durations.end(), label->durations.begin(), label->durations.end());
+            }
+        }
+        offsets.push_back(hubs.size());
+    }
+
+    // first entry of every label and the end of the last one
+    Vector<std::uint64_t> offsets;
+    Vector<NodeID> hubs;
+    Vector<EdgeWeight> weights;
+    Vector<EdgeDuration> durations;
+};
+}
+}
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef OSRM_CONTRACTOR_PARTITIONED_CONTRACTION_HPP
+#define OSRM_CONTRACTOR_PARTITIONED_CONTRACTION_HPP
+
+#include "contractor/contractor_config.hpp"
+
+#include "extractor/edge_based_edge.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Contracts the graph one cell of a level of the partition at a time, so only the edges of a
+// single cell are held in a contractor graph. Nodes with edges to other cells are kept and
+// contracted together with the shortcuts between them once all cells are done. The edges of
+// contracted nodes are spilled to disk, sorted externally and streamed into the .hsgr file.
+// Returns the contraction level of every node, the nodes of the cells are contracted below all
+// of the boundary nodes.
+std::vector<float> contractPartitioned(const ContractorConfig &config,
+                                       const partition::MultiLevelPartition &partition,
+                                       const NodeID number_of_nodes,
+                                       std::vector<extractor::EdgeBasedEdge> edge_based_edge_list,
+                                       std::vector<EdgeWeight> node_weights);
+}
+}
+
+#endif
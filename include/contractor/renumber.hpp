@@ -0,0 +1,37 @@
+#ifndef OSRM_CONTRACTOR_RENUMBER_HPP
+#define OSRM_CONTRACTOR_RENUMBER_HPP
+
+#include "contractor/contractor_config.hpp"
+#include "contractor/query_edge.hpp"
+
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+// Orders the nodes of a contracted graph for locality of the upward searches. The nodes are
+// ranked by their level, highest first, and grouped into bands of doubling size by rank. Within
+// a band the nodes are ordered by a depth-first search along the downward edges that starts at
+// the highest nodes, so the nodes below a node are close to it. Returns the new id of every node.
+std::vector<std::uint32_t> makePermutation(const std::vector<float> &node_levels,
+                                           const util::DeallocatingVector<QueryEdge> &edges);
+
+// Renumbers the nodes and the middle nodes of the shortcuts, and sorts the edges again.
+void renumber(util::DeallocatingVector<QueryEdge> &edges,
+              const std::vector<std::uint32_t> &permutation);
+
+// Renumbers the edge-based nodes in all files of the dataset that refer to them: the
+// edge-expanded graph, its node weights and node data, the leaves of the spatial index and the
+// mapping from the compressed node-based graph. A multi-level partition is removed.
+void renumberDataset(const ContractorConfig &config,
+                     const std::vector<std::uint32_t> &permutation);
+}
+}
+
+#endif
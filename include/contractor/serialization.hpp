@@ -0,0 +1,55 @@
+#ifndef OSRM_CONTRACTOR_SERIALIZATION_HPP
+#define OSRM_CONTRACTOR_SERIALIZATION_HPP
+
+#include "contractor/compressed_search_graph.hpp"
+#include "contractor/hub_labels.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+namespace osrm
+{
+namespace contractor
+{
+namespace serialization
+{
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::CompressedSearchGraphImpl<Ownership> &graph)
+{
+    storage::serialization::read(reader, graph.node_offsets);
+    storage::serialization::read(reader, graph.edges);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::CompressedSearchGraphImpl<Ownership> &graph)
+{
+    storage::serialization::write(writer, graph.node_offsets);
+    storage::serialization::write(writer, graph.edges);
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::HubLabelsImpl<Ownership> &labels)
+{
+    storage::serialization::read(reader, labels.offsets);
+    storage::serialization::read(reader, labels.hubs);
+    storage::serialization::read(reader, labels.weights);
+    storage::serialization::read(reader, labels.durations);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer, const detail::HubLabelsImpl<Ownership> &labels)
+{
+    storage::serialization::write(writer, labels.offsets);
+    storage::serialization::write(writer, labels.hubs);
+    storage::serialization::write(writer, labels.weights);
+    storage::serialization::write(writer, labels.durations);
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef OSRM_CUSTOMIZER_CCH_HPP
+#define OSRM_CUSTOMIZER_CCH_HPP
+
+#include "customizer/edge_based_graph.hpp"
+
+#include "contractor/query_graph.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+/**
+ * Metric independent part of a customizable contraction hierarchy (CCH).
+ *
+ * Nodes are ranked by the highest level of the partition they are a boundary node of, so the
+ * boundary nodes of a cell are contracted after the nodes inside of it, like the separators of
+ * a nested dissection. Of the two ends of an edge between cells only the one in the cell with
+ * the higher id is a boundary node. Nodes of the same level are ranked by minimum degree.
+ * Contracting the nodes in rank order without witness searches gives a chordal supergraph of
+ * the edge based graph, whose arcs are stored at their lower ranked node.
+ *
+ * The weights of any metric are customized into the arcs in one pass over the ranks grouped by
+ * their elimination level: an arc only depends on the arcs into its lower node, so all ranks of
+ * a level are independent of each other.
+ */
+class CCHTopology
+{
+  public:
+    CCHTopology() = default;
+    CCHTopology(const partition::MultiLevelPartition &partition,
+                const MultiLevelEdgeBasedGraph &graph);
+    CCHTopology(std::vector<NodeID> order,
+                std::vector<EdgeID> up_offsets,
+                std::vector<NodeID> up_targets);
+
+    std::size_t GetNumberOfNodes() const { return order.size(); }
+    std::size_t GetNumberOfArcs() const { return up_targets.size(); }
+
+    // True if every edge of the graph is an arc of the chordal supergraph
+    bool Covers(const MultiLevelEdgeBasedGraph &graph) const;
+
+    // Customizes the weights and durations of the graph into a hierarchy that is stored and
+    // searched like the contracted graph of the CH
+    contractor::QueryGraph Customize(const MultiLevelEdgeBasedGraph &graph) const;
+
+    const std::vector<NodeID> &GetOrder() const { return order; }
+    const std::vector<EdgeID> &GetUpOffsets() const { return up_offsets; }
+    const std::vector<NodeID> &GetUpTargets() const { return up_targets; }
+
+  private:
+    // Derives the ranks, elimination levels and the arcs into every rank from the upward arcs
+    void Initialize();
+
+    EdgeID FindArc(const NodeID from_rank, const NodeID to_rank) const
+    {
+        const auto begin = up_targets.begin() + up_offsets[from_rank];
+        const auto end = up_targets.begin() + up_offsets[from_rank + 1];
+        const auto iter = std::lower_bound(begin, end, to_rank);
+        if (iter == end || *iter != to_rank)
+            return SPECIAL_EDGEID;
+        return static_cast<EdgeID>(iter - up_targets.begin());
+    }
+
+    // node of every rank and rank of every node
+    std::vector<NodeID> order;
+    std::vector<NodeID> ranks;
+
+    // arcs to higher ranks, sorted by their target rank
+    std::vector<EdgeID> up_offsets;
+    std::vector<NodeID> up_targets;
+
+    // arcs from lower ranks, sorted by their source rank
+    std::vector<EdgeID> down_offsets;
+    std::vector<NodeID> down_sources;
+    std::vector<EdgeID> down_arcs;
+
+    // ranks grouped by elimination level, every rank is above all its lower neighbours
+    std::vector<std::size_t> level_offsets;
+    std::vector<NodeID> level_ranks;
+};
+}
+}
+
+#endif
@@ -3,16 +3,35 @@
 
 #include "partition/cell_storage.hpp"
 #include "partition/multi_level_partition.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
 #include "util/query_heap.hpp"
+#include "util/timing_util.hpp"
 
+#include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
 namespace customizer
 {
+namespace detail
+{
+// unreachable in the matrices of CustomizeMinPlus, small enough that two of them don't overflow
+// when summed up
+const constexpr EdgeWeight MIN_PLUS_INVALID_WEIGHT = std::numeric_limits<EdgeWeight>::max() / 2;
+}
 
 class CellCustomizer
 {
@@ -24,84 +43,458 @@ class CellCustomizer
     };
 
   public:
-    using Heap =
-        util::QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::ArrayStorage<NodeID, int>>;
+    using Heap = util::QueryHeap<NodeID,
+                                 NodeID,
+                                 EdgeWeight,
+                                 HeapData,
+                                 util::ArrayStorage<NodeID, int>,
+                                 util::RadixHeap<EdgeWeight, NodeID>>;
     using HeapPtr = tbb::enumerable_thread_specific<Heap>;
 
+    // Matrices of the boundary node graph of a cell, kept to be reused for the next cell
+    struct MinPlusData
+    {
+        std::vector<NodeID> nodes;
+        std::vector<EdgeWeight> weights;
+        std::vector<EdgeDuration> durations;
+    };
+    using MinPlusDataPtr = tbb::enumerable_thread_specific<MinPlusData>;
+
     CellCustomizer(const partition::MultiLevelPartition &partition) : partition(partition) {}
 
-    template <typename GraphT>
-    void Customize(
-        const GraphT &graph, Heap &heap, partition::CellStorage &cells, LevelID level, CellID id)
+    template <typename GraphT, typename CellStorageT>
+    void Customize(const GraphT &graph,
+                   Heap &heap,
+                   CellStorageT &cells,
+                   LevelID level,
+                   CellID id,
+                   std::size_t metric = 0)
     {
-        auto cell = cells.GetCell(level, id);
-        auto destinations = cell.GetDestinationNodes();
-
-        // for each source do forward search
+        auto cell = cells.GetCell(level, id, metric);
+        MinPlusData min_plus_data;
+        if (CustomizeMinPlus(graph, min_plus_data, cells, cell, level, id, metric))
+        {
+            return;
+        }
         for (auto source : cell.GetSourceNodes())
         {
-            std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
-            heap.Clear();
-            heap.Insert(source, 0, {false, 0});
+            CustomizeSource(graph, heap, cells, cell, level, source, metric);
+        }
+    }
+
+    // Computes the cell values of `metric` from the edge data of `graph`
+    //
+    // The cost of the cells of a level differs by orders of magnitude, so they are handed out
+    // to the threads largest first and the sources of large cells are split into tasks of
+    // their own that idle threads can steal. Otherwise a level waits for the thread that
+    // happened to get the largest cells last.
+    //
+    // Small cells of the higher levels are customized all at once on the matrix of their
+    // boundary nodes, see CustomizeMinPlus.
+    //
+    // If `changed_cells` is given only the cells it marks per level are customized, the others
+    // keep their values.
+    template <typename GraphT, typename CellStorageT>
+    void Customize(const GraphT &graph,
+                   CellStorageT &cells,
+                   std::size_t metric = 0,
+                   const std::vector<std::vector<bool>> &changed_cells = {})
+    {
+        Heap heap_exemplar(graph.GetNumberOfNodes());
+        HeapPtr heaps(heap_exemplar);
+        MinPlusDataPtr min_plus_data;
+
+        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+        {
+            TIMER_START(level_customize);
+            const auto cells_by_cost = SortCellsByCost(
+                cells, level, metric, changed_cells.empty() ? nullptr : &changed_cells[level]);
+
+            std::atomic<std::size_t> next_cell{0};
+            const auto customize_cells = [&] {
+                for (auto index = next_cell++; index < cells_by_cost.size(); index = next_cell++)
+                {
+                    const auto id = cells_by_cost[index];
+                    auto cell = cells.GetCell(level, id, metric);
+                    if (CustomizeMinPlus(
+                            graph, min_plus_data.local(), cells, cell, level, id, metric))
+                    {
+                        continue;
+                    }
+
+                    const auto sources = cell.GetSourceNodes();
+                    if (sources.size() < 2 * SOURCES_PER_TASK)
+                    {
+                        auto &heap = heaps.local();
+                        for (auto source : sources)
+                        {
+                            CustomizeSource(graph, heap, cells, cell, level, source, metric);
+                        }
+                        continue;
+                    }
+
+                    // no heap is held while waiting for the source tasks, a stolen task of
+                    // this thread can use it
+                    tbb::parallel_for(
+                        tbb::blocked_range<std::size_t>(0, sources.size(), SOURCES_PER_TASK),
+                        [&](const tbb::blocked_range<std::size_t> &range) {
+                            auto &heap = heaps.local();
+                            for (auto source = range.begin(); source != range.end(); ++source)
+                            {
+                                CustomizeSource(
+                                    graph, heap, cells, cell, level, sources[source], metric);
+                            }
+                        });
+                }
+            };
 
-            // explore search space
-            while (!heap.Empty() && !destinations_set.empty())
+            tbb::task_group workers;
+            for (auto worker = 0; worker < tbb::this_task_arena::max_concurrency(); ++worker)
             {
-                const NodeID node = heap.DeleteMin();
-                const EdgeWeight weight = heap.GetKey(node);
-                const EdgeDuration duration = heap.GetData(node).duration;
+                workers.run(customize_cells);
+            }
+            workers.wait();
+
+            TIMER_STOP(level_customize);
+            util::Log() << "Level " << level << ": customized " << cells_by_cost.size()
+                        << " cells in " << TIMER_SEC(level_customize) << " seconds";
+        }
+    }
+
+    // Marks the cells of every level that contain an edge whose data differs from `metric` of
+    // the previous graph, the cells to customize again for `graph`. An edge inside a cell is
+    // inside all of its parent cells, so each change marks the cells of the levels above too.
+    // Returns no cells if the topology changed.
+    template <typename GraphT, typename PreviousGraphT>
+    std::vector<std::vector<bool>> GetChangedCells(const GraphT &graph,
+                                                   const PreviousGraphT &previous_graph,
+                                                   const std::size_t metric = 0) const
+    {
+        const auto num_edges = graph.GetNumberOfEdges();
+        if (previous_graph.GetNumberOfNodes() != graph.GetNumberOfNodes() ||
+            previous_graph.GetNumberOfEdges() != num_edges ||
+            previous_graph.GetNumberOfMetrics() <= metric)
+        {
+            return {};
+        }
 
-                if (level == 1)
-                    RelaxNode<true>(graph, cells, heap, level, node, weight, duration);
-                else
-                    RelaxNode<false>(graph, cells, heap, level, node, weight, duration);
+        std::vector<std::vector<bool>> changed_cells(partition.GetNumberOfLevels());
+        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+        {
+            changed_cells[level].resize(partition.GetNumberOfCells(level), false);
+        }
 
-                destinations_set.erase(node);
+        std::size_t num_changed_edges = 0;
+        for (const auto node : util::irange(0u, graph.GetNumberOfNodes()))
+        {
+            if (graph.BeginEdges(node) != previous_graph.BeginEdges(node))
+            {
+                return {};
             }
 
-            // fill a map of destination nodes to placeholder pointers
-            auto weights = cell.GetOutWeight(source);
-            auto durations = cell.GetOutDuration(source);
-            for (auto &destination : destinations)
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
             {
-                BOOST_ASSERT(!weights.empty());
-                BOOST_ASSERT(!durations.empty());
+                const auto previous_edge = metric * num_edges + edge;
+                const auto target = graph.GetTarget(edge);
+                if (target != previous_graph.GetTarget(previous_edge))
+                {
+                    return {};
+                }
 
-                const bool inserted = heap.WasInserted(destination);
-                weights.front() = inserted ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
-                durations.front() =
-                    inserted ? heap.GetData(destination).duration : MAXIMAL_EDGE_DURATION;
+                const auto &data = graph.GetEdgeData(edge);
+                const auto &previous_data = previous_graph.GetEdgeData(previous_edge);
+                if (data.turn_id == previous_data.turn_id &&
+                    data.weight == previous_data.weight &&
+                    data.duration == previous_data.duration &&
+                    data.forward == previous_data.forward &&
+                    data.backward == previous_data.backward)
+                {
+                    continue;
+                }
 
-                weights.advance_begin(1);
-                durations.advance_begin(1);
+                ++num_changed_edges;
+                const auto num_levels = partition.GetNumberOfLevels();
+                const auto border_level = partition.GetHighestDifferentLevel(node, target);
+                for (auto level = border_level + 1u; level < num_levels; ++level)
+                {
+                    changed_cells[level][partition.GetCell(level, node)] = true;
+                }
             }
-            BOOST_ASSERT(weights.empty());
-            BOOST_ASSERT(durations.empty());
         }
+
+        util::Log() << num_changed_edges << " of " << num_edges << " edges changed";
+
+        return changed_cells;
     }
 
-    template <typename GraphT> void Customize(const GraphT &graph, partition::CellStorage &cells)
+  private:
+    // sources of a cell that are searched from by the same task
+    static constexpr std::size_t SOURCES_PER_TASK = 16;
+    // boundary nodes of the largest cell customized with CustomizeMinPlus, its two matrices
+    // take 512 KiB and stay in the cache
+    static constexpr std::size_t MIN_PLUS_MAX_NODES = 256;
+    // the min-plus steps are vectorized, so they are cheaper than the arc relaxations of the
+    // searches by about this factor
+    static constexpr std::size_t MIN_PLUS_SPEEDUP = 32;
+
+    // Relaxes the paths of `row` with the paths through the node of `via_row`, which the row
+    // reaches with `weight` and `duration`. Written without branches so the compiler can use
+    // vector compare and blend instructions.
+    static void MinPlusRow(EdgeWeight *const row_weights,
+                           EdgeDuration *const row_durations,
+                           const EdgeWeight *const via_weights,
+                           const EdgeDuration *const via_durations,
+                           const EdgeWeight weight,
+                           const EdgeDuration duration,
+                           const std::size_t size)
     {
-        Heap heap_exemplar(graph.GetNumberOfNodes());
-        HeapPtr heaps(heap_exemplar);
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            const EdgeWeight to_weight = weight + via_weights[index];
+            const EdgeDuration to_duration = duration + via_durations[index];
+            const bool shorter = to_weight < row_weights[index];
+            row_weights[index] = shorter ? to_weight : row_weights[index];
+            row_durations[index] = shorter ? to_duration : row_durations[index];
+        }
+    }
 
-        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+    // Customizes a cell of a higher level with Floyd-Warshall on the graph of the boundary nodes
+    // of its subcells, whose arcs are the clique arcs of the subcells and the base graph edges
+    // between them. This takes O(n^3) min-plus steps for the n nodes instead of a search with a
+    // heap per source, which pays off for small cells with many sources. Returns false for the
+    // cells that are left to the searches, nothing is written then.
+    //
+    // Weights equal the ones of the searches, durations may differ between paths of equal weight.
+    template <typename GraphT, typename CellStorageT>
+    bool CustomizeMinPlus(const GraphT &graph,
+                          MinPlusData &data,
+                          const CellStorageT &cells,
+                          typename CellStorageT::Cell &cell,
+                          LevelID level,
+                          CellID id,
+                          std::size_t metric) const
+    {
+        using detail::MIN_PLUS_INVALID_WEIGHT;
+
+        if (level == 1)
+            return false;
+
+        // every node with an arc leaving it is a boundary node of its subcell, so it's a source
+        // or destination of the subcell
+        auto &nodes = data.nodes;
+        nodes.clear();
+        std::size_t num_arcs = 0;
+        const auto subcells_end = partition.EndChildren(level, id);
+        for (auto subcell_id = partition.BeginChildren(level, id); subcell_id < subcells_end;
+             ++subcell_id)
+        {
+            const auto subcell = cells.GetCell(level - 1, subcell_id, metric);
+            const auto sources = subcell.GetSourceNodes();
+            const auto destinations = subcell.GetDestinationNodes();
+            nodes.insert(nodes.end(), sources.begin(), sources.end());
+            nodes.insert(nodes.end(), destinations.begin(), destinations.end());
+            num_arcs += sources.size() * destinations.size();
+        }
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+        const auto size = nodes.size();
+        const auto num_sources = cell.GetSourceNodes().size();
+        if (size > MIN_PLUS_MAX_NODES ||
+            size * size * size >
+                MIN_PLUS_SPEEDUP * num_sources * std::max<std::size_t>(num_arcs, 1))
+            return false;
+
+        const auto index_of = [&nodes](const NodeID node) {
+            const auto iter = std::lower_bound(nodes.begin(), nodes.end(), node);
+            return iter == nodes.end() || *iter != node
+                       ? SPECIAL_NODEID
+                       : static_cast<NodeID>(iter - nodes.begin());
+        };
+
+        auto &weights = data.weights;
+        auto &durations = data.durations;
+        weights.assign(size * size, MIN_PLUS_INVALID_WEIGHT);
+        durations.assign(size * size, 0);
+        const auto add_arc = [&](const NodeID from, const NodeID to, EdgeWeight weight,
+                                 const EdgeDuration duration) {
+            weight = std::min(weight, MIN_PLUS_INVALID_WEIGHT);
+            if (weight < weights[from * size + to])
+            {
+                weights[from * size + to] = weight;
+                durations[from * size + to] = duration;
+            }
+        };
+        for (const auto from : util::irange<std::size_t>(0, size))
         {
-            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, partition.GetNumberOfCells(level)),
-                              [&](const tbb::blocked_range<std::size_t> &range) {
-                                  auto &heap = heaps.local();
-                                  for (auto id = range.begin(), end = range.end(); id != end; ++id)
-                                  {
-                                      Customize(graph, heap, cells, level, id);
-                                  }
-                              });
+            add_arc(from, from, 0, 0);
         }
+
+        for (const auto from : util::irange<std::size_t>(0, size))
+        {
+            const auto node = nodes[from];
+            const auto subcell_id = partition.GetCell(level - 1, node);
+            const auto subcell = cells.GetCell(level - 1, subcell_id, metric);
+            auto subcell_destination = subcell.GetDestinationNodes().begin();
+            auto subcell_duration = subcell.GetOutDuration(node).begin();
+            for (auto subcell_weight : subcell.GetOutWeight(node))
+            {
+                if (subcell_weight != INVALID_EDGE_WEIGHT)
+                {
+                    add_arc(from,
+                            index_of(*subcell_destination),
+                            subcell_weight,
+                            *subcell_duration);
+                }
+
+                ++subcell_destination;
+                ++subcell_duration;
+            }
+
+            for (auto edge : graph.GetInternalEdgeRange(level, node))
+            {
+                const NodeID to = graph.GetTarget(edge);
+                const auto &edge_data = graph.GetEdgeData(edge);
+                if (edge_data.forward &&
+                    partition.GetCell(level - 1, node) != partition.GetCell(level - 1, to))
+                {
+                    // targets without a subcell are dead ends that aren't destinations
+                    const auto to_index = index_of(to);
+                    if (to_index != SPECIAL_NODEID)
+                    {
+                        add_arc(from, to_index, edge_data.weight, edge_data.duration);
+                    }
+                }
+            }
+        }
+
+        for (const auto via : util::irange<std::size_t>(0, size))
+        {
+            const auto via_weights = &weights[via * size];
+            const auto via_durations = &durations[via * size];
+            for (const auto from : util::irange<std::size_t>(0, size))
+            {
+                const auto weight = weights[from * size + via];
+                if (weight < MIN_PLUS_INVALID_WEIGHT)
+                {
+                    MinPlusRow(&weights[from * size],
+                               &durations[from * size],
+                               via_weights,
+                               via_durations,
+                               weight,
+                               durations[from * size + via],
+                               size);
+                }
+            }
+        }
+
+        for (auto source : cell.GetSourceNodes())
+        {
+            const auto from = index_of(source);
+            BOOST_ASSERT(from != SPECIAL_NODEID);
+            auto out_weights = cell.GetOutWeight(source);
+            auto out_durations = cell.GetOutDuration(source);
+            for (auto destination : cell.GetDestinationNodes())
+            {
+                const auto to = index_of(destination);
+                BOOST_ASSERT(to != SPECIAL_NODEID);
+                const auto weight = weights[from * size + to];
+                const bool reachable = weight < MIN_PLUS_INVALID_WEIGHT;
+                out_weights.front() = reachable ? weight : INVALID_EDGE_WEIGHT;
+                out_durations.front() =
+                    reachable ? durations[from * size + to] : MAXIMAL_EDGE_DURATION;
+
+                out_weights.advance_begin(1);
+                out_durations.advance_begin(1);
+            }
+        }
+
+        return true;
     }
 
-  private:
-    template <bool first_level, typename GraphT>
+    // Cells of the level ordered by decreasing number of searches times their targets,
+    // restricted to the `selected` ones if given
+    template <typename CellStorageT>
+    std::vector<CellID> SortCellsByCost(const CellStorageT &cells,
+                                        const LevelID level,
+                                        const std::size_t metric,
+                                        const std::vector<bool> *selected) const
+    {
+        std::vector<std::pair<std::size_t, CellID>> costs;
+        costs.reserve(partition.GetNumberOfCells(level));
+        for (const auto id : util::irange<CellID>(0, partition.GetNumberOfCells(level)))
+        {
+            if (selected && !(*selected)[id])
+                continue;
+
+            const auto cell = cells.GetCell(level, id, metric);
+            costs.emplace_back(cell.GetSourceNodes().size() * cell.GetDestinationNodes().size(),
+                               id);
+        }
+        std::sort(costs.begin(), costs.end(), std::greater<std::pair<std::size_t, CellID>>{});
+
+        std::vector<CellID> ids(costs.size());
+        std::transform(costs.begin(), costs.end(), ids.begin(), [](const auto &cost_and_id) {
+            return cost_and_id.second;
+        });
+        return ids;
+    }
+
+    // Runs the search from a single source of the cell and fills its row of values
+    template <typename GraphT, typename CellStorageT>
+    void CustomizeSource(const GraphT &graph,
+                         Heap &heap,
+                         const CellStorageT &cells,
+                         typename CellStorageT::Cell &cell,
+                         LevelID level,
+                         NodeID source,
+                         std::size_t metric) const
+    {
+        auto destinations = cell.GetDestinationNodes();
+
+        std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
+        heap.Clear();
+        heap.Insert(source, 0, {false, 0});
+
+        // explore search space
+        while (!heap.Empty() && !destinations_set.empty())
+        {
+            const NodeID node = heap.DeleteMin();
+            const EdgeWeight weight = heap.GetKey(node);
+            const EdgeDuration duration = heap.GetData(node).duration;
+
+            if (level == 1)
+                RelaxNode<true>(graph, cells, metric, heap, level, node, weight, duration);
+            else
+                RelaxNode<false>(graph, cells, metric, heap, level, node, weight, duration);
+
+            destinations_set.erase(node);
+        }
+
+        // fill a map of destination nodes to placeholder pointers
+        auto weights = cell.GetOutWeight(source);
+        auto durations = cell.GetOutDuration(source);
+        for (auto &destination : destinations)
+        {
+            BOOST_ASSERT(!weights.empty());
+            BOOST_ASSERT(!durations.empty());
+
+            const bool inserted = heap.WasInserted(destination);
+            weights.front() = inserted ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
+            durations.front() =
+                inserted ? heap.GetData(destination).duration : MAXIMAL_EDGE_DURATION;
+
+            weights.advance_begin(1);
+            durations.advance_begin(1);
+        }
+        BOOST_ASSERT(weights.empty());
+        BOOST_ASSERT(durations.empty());
+    }
+
+    template <bool first_level, typename GraphT, typename CellStorageT>
     void RelaxNode(const GraphT &graph,
-                   const partition::CellStorage &cells,
+                   const CellStorageT &cells,
+                   const std::size_t metric,
                    Heap &heap,
                    LevelID level,
                    NodeID node,
@@ -123,7 +516,7 @@ class CellCustomizer
             {
                 // Relax sub-cell nodes
                 auto subcell_id = partition.GetCell(level - 1, node);
-                auto subcell = cells.GetCell(level - 1, subcell_id);
+                auto subcell = cells.GetCell(level - 1, subcell_id, metric);
                 auto subcell_destination = subcell.GetDestinationNodes().begin();
                 auto subcell_duration = subcell.GetOutDuration(node).begin();
                 for (auto subcell_weight : subcell.GetOutWeight(node))
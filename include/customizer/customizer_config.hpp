@@ -6,16 +6,33 @@
 #include <boost/filesystem/path.hpp>
 
 #include <array>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
 namespace customizer
 {
 
+// An additional metric customized from the dataset with its own segment speed files applied
+struct MetricConfig
+{
+    std::string name;
+    std::vector<std::string> segment_speed_lookup_paths;
+
+    // speed profiles evaluated at `profile_minute` after midnight for metrics of time buckets
+    std::vector<std::string> speed_profile_lookup_paths;
+    std::uint32_t profile_minute = 0;
+};
+
 struct CustomizationConfig
 {
-    CustomizationConfig() : requested_num_threads(0) {}
+    CustomizationConfig()
+        : requested_num_threads(0), incremental(false), cch(false), overlay_hierarchy(false),
+          landmarks(0), distance_oracle_level(0)
+    {
+    }
 
     void UseDefaults()
     {
@@ -36,6 +53,11 @@ struct CustomizationConfig
         mld_partition_path = basepath + ".osrm.partition";
         mld_storage_path = basepath + ".osrm.cells";
         mld_graph_path = basepath + ".osrm.mldgr";
+        mld_overlay_hierarchy_path = basepath + ".osrm.mldtop";
+        cch_topology_path = basepath + ".osrm.cch";
+        cch_graph_path = basepath + ".osrm.cchgr";
+        landmarks_path = basepath + ".osrm.landmarks";
+        distance_oracle_path = basepath + ".osrm.distance_oracle";
 
         updater_config.osrm_input_path = basepath + ".osrm";
         updater_config.UseDefaultOutputNames();
@@ -47,10 +69,33 @@ struct CustomizationConfig
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
     boost::filesystem::path mld_graph_path;
+    boost::filesystem::path mld_overlay_hierarchy_path;
+    boost::filesystem::path cch_topology_path;
+    boost::filesystem::path cch_graph_path;
+    boost::filesystem::path landmarks_path;
+    boost::filesystem::path distance_oracle_path;
 
     unsigned requested_num_threads;
 
+    // reuse the values of cells that don't depend on edges changed since the last customization
+    bool incremental;
+
+    // also customize the default metric into the hierarchy of the CCH algorithm
+    bool cch;
+
+    // also contract the top level overlay graph of the default metric for long MLD queries
+    bool overlay_hierarchy;
+
+    // number of landmarks of the default metric for goal directed MLD queries, 0 for none
+    unsigned landmarks;
+
+    // level of the cells of the distance oracle for approximate tables, 0 for none
+    unsigned distance_oracle_level;
+
     updater::UpdaterConfig updater_config;
+
+    // The updates of `updater_config` make up the default metric, these are stored next to it
+    std::vector<MetricConfig> metrics;
 };
 }
 }
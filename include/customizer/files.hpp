@@ -0,0 +1,115 @@
+#ifndef OSRM_CUSTOMIZER_FILES_HPP
+#define OSRM_CUSTOMIZER_FILES_HPP
+
+#include "customizer/cch.hpp"
+#include "customizer/overlay_hierarchy.hpp"
+#include "customizer/serialization.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+#include "util/distance_oracle.hpp"
+#include "util/serialization.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace files
+{
+
+// reads .osrm.cch file
+inline void readCCHTopology(const boost::filesystem::path &path, CCHTopology &topology)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    std::vector<NodeID> order;
+    std::vector<EdgeID> up_offsets;
+    std::vector<NodeID> up_targets;
+    storage::serialization::read(reader, order);
+    storage::serialization::read(reader, up_offsets);
+    storage::serialization::read(reader, up_targets);
+
+    topology = CCHTopology{std::move(order), std::move(up_offsets), std::move(up_targets)};
+}
+
+// writes .osrm.cch file
+inline void writeCCHTopology(const boost::filesystem::path &path, const CCHTopology &topology)
+{
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    storage::serialization::write(writer, topology.GetOrder());
+    storage::serialization::write(writer, topology.GetUpOffsets());
+    storage::serialization::write(writer, topology.GetUpTargets());
+}
+
+// reads .osrm.mldtop file
+template <typename OverlayHierarchyT>
+inline void readOverlayHierarchy(const boost::filesystem::path &path,
+                                 OverlayHierarchyT &hierarchy)
+{
+    static_assert(std::is_same<OverlayHierarchyView, OverlayHierarchyT>::value ||
+                      std::is_same<OverlayHierarchy, OverlayHierarchyT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, hierarchy);
+}
+
+// writes .osrm.mldtop file
+template <typename OverlayHierarchyT>
+inline void writeOverlayHierarchy(const boost::filesystem::path &path,
+                                  const OverlayHierarchyT &hierarchy)
+{
+    static_assert(std::is_same<OverlayHierarchyView, OverlayHierarchyT>::value ||
+                      std::is_same<OverlayHierarchy, OverlayHierarchyT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, hierarchy);
+}
+
+// reads .osrm.distance_oracle file
+template <typename DistanceOracleT>
+inline void readDistanceOracle(const boost::filesystem::path &path, DistanceOracleT &oracle)
+{
+    static_assert(std::is_same<util::DistanceOracleView, DistanceOracleT>::value ||
+                      std::is_same<util::DistanceOracle, DistanceOracleT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    util::serialization::read(reader, oracle);
+}
+
+// writes .osrm.distance_oracle file
+template <typename DistanceOracleT>
+inline void writeDistanceOracle(const boost::filesystem::path &path,
+                                const DistanceOracleT &oracle)
+{
+    static_assert(std::is_same<util::DistanceOracleView, DistanceOracleT>::value ||
+                      std::is_same<util::DistanceOracle, DistanceOracleT>::value,
+                  "");
+
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    util::serialization::write(writer, oracle);
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef OSRM_CUSTOMIZER_OVERLAY_HIERARCHY_HPP
+#define OSRM_CUSTOMIZER_OVERLAY_HIERARCHY_HPP
+
+#include "customizer/edge_based_graph.hpp"
+
+#include "partition/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class OverlayHierarchyImpl;
+}
+using OverlayHierarchy = detail::OverlayHierarchyImpl<storage::Ownership::Container>;
+using OverlayHierarchyView = detail::OverlayHierarchyImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::OverlayHierarchyImpl<Ownership> &hierarchy);
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::OverlayHierarchyImpl<Ownership> &hierarchy);
+}
+
+namespace detail
+{
+/**
+ * Contraction hierarchy of the overlay graph of the top level of a multi-level partition.
+ *
+ * The overlay graph has the boundary nodes of the top level cells as nodes and their clique
+ * arcs and the border edges between the cells as arcs. A query between two top level cells
+ * only needs a search inside the cell of each end, the paths between both cells are found by
+ * a CH search on the overlay graph that is seeded with the boundary nodes the two local
+ * searches reached.
+ *
+ * Overlay nodes are numbered in the order of their node ids. The arcs to higher ranked nodes
+ * are stored at their lower end, sorted by the other end: forward arcs leave the node and
+ * backward arcs enter it. Shortcuts store the overlay node they were contracted over.
+ */
+template <storage::Ownership Ownership> class OverlayHierarchyImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    struct Arc
+    {
+        NodeID target;
+        EdgeWeight weight;
+        // overlay node of the shortcut, SPECIAL_NODEID for arcs of the overlay graph
+        NodeID middle;
+    };
+    using ArcRange = boost::iterator_range<const Arc *>;
+
+    OverlayHierarchyImpl() = default;
+
+    OverlayHierarchyImpl(Vector<NodeID> nodes_,
+                         Vector<std::uint64_t> forward_offsets_,
+                         Vector<Arc> forward_arcs_,
+                         Vector<std::uint64_t> backward_offsets_,
+                         Vector<Arc> backward_arcs_)
+        : nodes(std::move(nodes_)), forward_offsets(std::move(forward_offsets_)),
+          forward_arcs(std::move(forward_arcs_)), backward_offsets(std::move(backward_offsets_)),
+          backward_arcs(std::move(backward_arcs_))
+    {
+        BOOST_ASSERT(std::is_sorted(nodes.begin(), nodes.end()));
+        BOOST_ASSERT(forward_offsets.size() == nodes.size() + 1);
+        BOOST_ASSERT(backward_offsets.size() == nodes.size() + 1);
+    }
+
+    std::size_t GetNumberOfNodes() const { return nodes.size(); }
+    std::size_t GetNumberOfArcs() const { return forward_arcs.size() + backward_arcs.size(); }
+
+    // Overlay node of a node of the edge based graph, SPECIAL_NODEID if it is none
+    NodeID GetOverlayNode(const NodeID node) const
+    {
+        const auto iter = std::lower_bound(nodes.begin(), nodes.end(), node);
+        if (iter == nodes.end() || *iter != node)
+            return SPECIAL_NODEID;
+        return static_cast<NodeID>(std::distance(nodes.begin(), iter));
+    }
+
+    NodeID GetNode(const NodeID overlay_node) const { return nodes[overlay_node]; }
+
+    // Arcs from the overlay node to higher ranked nodes, relaxed by the forward search
+    ArcRange GetForwardArcs(const NodeID overlay_node) const
+    {
+        return GetArcs(forward_offsets, forward_arcs, overlay_node);
+    }
+
+    // Arcs from higher ranked nodes to the overlay node, relaxed by the backward search
+    ArcRange GetBackwardArcs(const NodeID overlay_node) const
+    {
+        return GetArcs(backward_offsets, backward_arcs, overlay_node);
+    }
+
+    // Appends the arcs of the overlay graph the arc from -> to of the hierarchy stands for
+    template <typename OutIter>
+    OutIter UnpackArc(const NodeID from, const NodeID to, OutIter out) const
+    {
+        const auto middle = FindArc(from, to).middle;
+        if (middle == SPECIAL_NODEID)
+        {
+            *out = std::make_pair(from, to);
+            return ++out;
+        }
+        out = UnpackArc(from, middle, out);
+        return UnpackArc(middle, to, out);
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               OverlayHierarchyImpl &hierarchy);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const OverlayHierarchyImpl &hierarchy);
+
+  private:
+    static ArcRange
+    GetArcs(const Vector<std::uint64_t> &offsets, const Vector<Arc> &arcs, const NodeID node)
+    {
+        BOOST_ASSERT(node + 1 < offsets.size());
+        return ArcRange(arcs.data() + offsets[node], arcs.data() + offsets[node + 1]);
+    }
+
+    static const Arc *FindTarget(const ArcRange &arcs, const NodeID target)
+    {
+        const auto iter = std::lower_bound(
+            arcs.begin(), arcs.end(), target, [](const Arc &arc, const NodeID target) {
+                return arc.target < target;
+            });
+        return iter == arcs.end() || iter->target != target ? nullptr : iter;
+    }
+
+    // The arc is stored at whichever of its ends is ranked lower
+    const Arc &FindArc(const NodeID from, const NodeID to) const
+    {
+        if (const auto arc = FindTarget(GetForwardArcs(from), to))
+            return *arc;
+        const auto arc = FindTarget(GetBackwardArcs(to), from);
+        BOOST_ASSERT(arc != nullptr);
+        return *arc;
+    }
+
+    // node ids of the overlay nodes, sorted
+    Vector<NodeID> nodes;
+    Vector<std::uint64_t> forward_offsets;
+    Vector<Arc> forward_arcs;
+    Vector<std::uint64_t> backward_offsets;
+    Vector<Arc> backward_arcs;
+};
+}
+
+// Contracts the overlay graph of the top level of the partition with the default metric of the
+// customized cells. Empty if the partition has no overlay level.
+OverlayHierarchy buildOverlayHierarchy(const partition::MultiLevelPartition &partition,
+                                       const partition::CellStorage &storage,
+                                       const MultiLevelEdgeBasedGraph &graph);
+}
+}
+
+#endif
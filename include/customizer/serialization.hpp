@@ -0,0 +1,42 @@
+#ifndef OSRM_CUSTOMIZER_SERIALIZATION_HPP
+#define OSRM_CUSTOMIZER_SERIALIZATION_HPP
+
+#include "customizer/overlay_hierarchy.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+namespace osrm
+{
+namespace customizer
+{
+namespace serialization
+{
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::OverlayHierarchyImpl<Ownership> &hierarchy)
+{
+    storage::serialization::read(reader, hierarchy.nodes);
+    storage::serialization::read(reader, hierarchy.forward_offsets);
+    storage::serialization::read(reader, hierarchy.forward_arcs);
+    storage::serialization::read(reader, hierarchy.backward_offsets);
+    storage::serialization::read(reader, hierarchy.backward_arcs);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::OverlayHierarchyImpl<Ownership> &hierarchy)
+{
+    storage::serialization::write(writer, hierarchy.nodes);
+    storage::serialization::write(writer, hierarchy.forward_offsets);
+    storage::serialization::write(writer, hierarchy.forward_arcs);
+    storage::serialization::write(writer, hierarchy.backward_offsets);
+    storage::serialization::write(writer, hierarchy.backward_arcs);
+}
+}
+}
+}
+
+#endif
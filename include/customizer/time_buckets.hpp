@@ -0,0 +1,77 @@
+#ifndef OSRM_CUSTOMIZER_TIME_BUCKETS_HPP
+#define OSRM_CUSTOMIZER_TIME_BUCKETS_HPP
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+// The metrics customized from speed profiles cover a day in time buckets. Each one is named
+// after the minute after midnight its bucket starts at, e.g. time_0815.
+
+const constexpr std::uint32_t MINUTES_PER_DAY = 24 * 60;
+
+inline std::string timeBucketMetricName(const std::uint32_t minute)
+{
+    char name[16];
+    std::snprintf(name, sizeof(name), "time_%02u%02u", minute / 60, minute % 60);
+    return name;
+}
+
+inline boost::optional<std::uint32_t> timeBucketMinute(const std::string &name)
+{
+    const std::string prefix = "time_";
+    const auto is_digit = [](const char c) { return c >= '0' && c <= '9'; };
+    if (name.size() != prefix.size() + 4 || name.compare(0, prefix.size(), prefix) != 0 ||
+        !std::all_of(name.begin() + prefix.size(), name.end(), is_digit))
+        return boost::none;
+
+    const auto digits = [&](const std::size_t offset) {
+        const auto first = name.begin() + prefix.size() + offset;
+        return (first[0] - '0') * 10u + (first[1] - '0');
+    };
+    const auto hours = digits(0);
+    const auto minutes = digits(2);
+    if (hours >= 24 || minutes >= 60)
+        return boost::none;
+    return hours * 60 + minutes;
+}
+
+// Name of the metric of the time bucket `minute` after midnight falls into, a minute before
+// the first bucket belongs to the last bucket of the previous day. Empty without time buckets.
+inline std::string timeBucketMetricName(const std::vector<std::string> &metric_names,
+                                        const std::uint32_t minute)
+{
+    std::string latest, earlier;
+    boost::optional<std::uint32_t> latest_minute, earlier_minute;
+    for (const auto &name : metric_names)
+    {
+        const auto start = timeBucketMinute(name);
+        if (!start)
+            continue;
+
+        if (!latest_minute || *start > *latest_minute)
+        {
+            latest = name;
+            latest_minute = start;
+        }
+        if (*start <= minute % MINUTES_PER_DAY && (!earlier_minute || *start > *earlier_minute))
+        {
+            earlier = name;
+            earlier_minute = start;
+        }
+    }
+    return earlier_minute ? earlier : latest;
+}
+}
+}
+
+#endif
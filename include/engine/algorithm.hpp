@@ -24,6 +24,13 @@ struct Algorithm final
 {
 };
 }
+// Customizable Contraction Hierarchy, queried like a CH
+namespace cch
+{
+struct Algorithm final
+{
+};
+}
 // Multi-Level Dijkstra
 namespace mld
 {
@@ -36,6 +43,7 @@ struct Algorithm final
 template <typename AlgorithmT> const char *name();
 template <> inline const char *name<ch::Algorithm>() { return "CH"; }
 template <> inline const char *name<corech::Algorithm>() { return "CoreCH"; }
+template <> inline const char *name<cch::Algorithm>() { return "CCH"; }
 template <> inline const char *name<mld::Algorithm>() { return "MLD"; }
 
 template <typename AlgorithmT> struct HasAlternativePathSearch final : std::false_type
@@ -56,6 +64,9 @@ template <typename AlgorithmT> struct HasManyToManySearch final : std::false_typ
 template <typename AlgorithmT> struct HasGetTileTurns final : std::false_type
 {
 };
+template <typename AlgorithmT> struct HasOneToAllSearch final : std::false_type
+{
+};
 
 // Algorithms supported by Contraction Hierarchies
 template <> struct HasAlternativePathSearch<ch::Algorithm> final : std::true_type
@@ -76,6 +87,9 @@ template <> struct HasManyToManySearch<ch::Algorithm> final : std::true_type
 template <> struct HasGetTileTurns<ch::Algorithm> final : std::true_type
 {
 };
+template <> struct HasOneToAllSearch<ch::Algorithm> final : std::true_type
+{
+};
 
 // Algorithms supported by Contraction Hierarchies with core
 // the rest is disabled because of performance reasons
@@ -92,6 +106,30 @@ template <> struct HasGetTileTurns<corech::Algorithm> final : std::true_type
 {
 };
 
+// Algorithms supported by Customizable Contraction Hierarchies
+// the customized hierarchy is searched by the algorithms of Contraction Hierarchies
+template <> struct HasAlternativePathSearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasShortestPathSearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasDirectShortestPathSearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasMapMatching<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasManyToManySearch<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasGetTileTurns<cch::Algorithm> final : std::true_type
+{
+};
+template <> struct HasOneToAllSearch<cch::Algorithm> final : std::true_type
+{
+};
+
 // Algorithms supported by Multi-Level Dijkstra
 template <> struct HasAlternativePathSearch<mld::Algorithm> final : std::true_type
 {
@@ -111,6 +149,9 @@ template <> struct HasManyToManySearch<mld::Algorithm> final : std::true_type
 template <> struct HasGetTileTurns<mld::Algorithm> final : std::true_type
 {
 };
+template <> struct HasOneToAllSearch<mld::Algorithm> final : std::true_type
+{
+};
 }
 }
 }
@@ -2,7 +2,7 @@
 #define ENGINE_API_BASE_API_HPP
 
 #include "engine/api/base_parameters.hpp"
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/api/json_factory.hpp"
 #include "engine/hint.hpp"
@@ -22,7 +22,8 @@ namespace api
 class BaseAPI
 {
   public:
-    BaseAPI(const datafacade::BaseDataFacade &facade_, const BaseParameters &parameters_)
+    BaseAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+            const BaseParameters &parameters_)
         : facade(facade_), parameters(parameters_)
     {
     }
@@ -66,7 +67,7 @@ class BaseAPI
         }
     }
 
-    const datafacade::BaseDataFacade &facade;
+    const datafacade::ContiguousInternalMemoryDataFacadeBase &facade;
     const BaseParameters &parameters;
 };
 
@@ -31,11 +31,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "engine/approach.hpp"
 #include "engine/bearing.hpp"
 #include "engine/hint.hpp"
+#include "engine/query_deadline.hpp"
 #include "util/coordinate.hpp"
 
 #include <boost/optional.hpp>
 
 #include <algorithm>
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -57,10 +59,19 @@ namespace api
  *  - bearings: limits the search for segments in the road network to given bearing(s) in degree
  *              towards true north in clockwise direction, optional per coordinate
  *  - approaches: force the phantom node to start towards the node with the road country side.
+ *  - format: JSON or binary responses of the HTTP services
+ *  - deadline: the query fails with a Timeout error once it is past it or cancelled
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
  */
+// Format of the responses of the HTTP services, see binary_format.hpp for Binary
+enum class OutputFormatType
+{
+    JSON,
+    Binary
+};
+
 struct BaseParameters
 {
     std::vector<util::Coordinate> coordinates;
@@ -72,6 +83,15 @@ struct BaseParameters
     // Adds hints to response which can be included in subsequent requests, see `hints` above.
     bool generate_hints = true;
 
+    OutputFormatType format = OutputFormatType::JSON;
+
+    // Name of the metric to route on, only MLD datasets can have metrics besides the default one
+    std::string metric;
+
+    // The searches of the query give up after it, the earlier of it and the default timeout of
+    // the engine is used
+    QueryDeadline deadline;
+
     BaseParameters(const std::vector<util::Coordinate> coordinates_ = {},
                    const std::vector<boost::optional<Hint>> hints_ = {},
                    std::vector<boost::optional<double>> radiuses_ = {},
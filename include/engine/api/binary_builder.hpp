@@ -0,0 +1,194 @@
+#ifndef ENGINE_API_BINARY_BUILDER_HPP
+#define ENGINE_API_BINARY_BUILDER_HPP
+
+#include "engine/api/binary_format.hpp"
+
+#include "util/json_container.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+namespace binary
+{
+
+/**
+ * Writes a binary response into a string, see binary_format.hpp for the layout.
+ *
+ * Values are encoded bottom-up: encoding a value appends its data and returns the slot that
+ * references it, which is then stored by the enclosing array or object. Finish() writes the
+ * header with the slot of the root object.
+ */
+class Builder
+{
+  public:
+    explicit Builder(std::string &out_) : out(out_)
+    {
+        out.clear();
+        out.resize(sizeof(Header));
+    }
+
+    Slot EncodeString(const std::string &value)
+    {
+        const auto offset = Allocate(value.size() + 1);
+        std::memcpy(&out[offset], value.data(), value.size());
+        return Slot{ValueType::String, static_cast<std::uint32_t>(value.size()), offset};
+    }
+
+    static Slot EncodeNumber(const double value)
+    {
+        Slot slot{ValueType::Number, 0, 0};
+        std::memcpy(&slot.payload, &value, sizeof(value));
+        return slot;
+    }
+
+    // Numbers of the range as NumberArray, get_number converts each element to a double
+    template <typename Iterator, typename GetNumberT>
+    Slot EncodeNumbers(Iterator first, const Iterator last, GetNumberT get_number)
+    {
+        const auto size = static_cast<std::size_t>(std::distance(first, last));
+        const auto offset = Allocate(size * sizeof(double));
+        for (auto position = offset; first != last; ++first, position += sizeof(double))
+        {
+            const double value = get_number(*first);
+            std::memcpy(&out[position], &value, sizeof(value));
+        }
+        return Slot{ValueType::NumberArray, static_cast<std::uint32_t>(size), offset};
+    }
+
+    Slot EncodeArray(const std::vector<Slot> &elements)
+    {
+        const auto offset = Allocate(elements.size() * sizeof(Slot));
+        if (!elements.empty())
+            std::memcpy(&out[offset], elements.data(), elements.size() * sizeof(Slot));
+        return Slot{ValueType::Array, static_cast<std::uint32_t>(elements.size()), offset};
+    }
+
+    // Members don't need to be sorted
+    Slot EncodeObject(std::vector<std::pair<std::string, Slot>> members)
+    {
+        std::sort(members.begin(), members.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        std::vector<Slot> slots;
+        slots.reserve(2 * members.size());
+        for (const auto &member : members)
+        {
+            slots.push_back(EncodeString(member.first));
+            slots.push_back(member.second);
+        }
+
+        const auto offset = Allocate(slots.size() * sizeof(Slot));
+        if (!slots.empty())
+            std::memcpy(&out[offset], slots.data(), slots.size() * sizeof(Slot));
+        return Slot{ValueType::Object, static_cast<std::uint32_t>(members.size()), offset};
+    }
+
+    Slot Encode(const util::json::Value &value)
+    {
+        return mapbox::util::apply_visitor(ValueEncoder{*this}, value);
+    }
+
+    Slot Encode(const util::json::Object &object)
+    {
+        std::vector<std::pair<std::string, Slot>> members;
+        members.reserve(object.values.size());
+        for (const auto &member : object.values)
+        {
+            members.emplace_back(member.first, Encode(member.second));
+        }
+        return EncodeObject(std::move(members));
+    }
+
+    Slot Encode(const util::json::Array &array)
+    {
+        const auto is_number = [](const util::json::Value &value) {
+            return value.is<util::json::Number>();
+        };
+        const auto is_number_or_null = [](const util::json::Value &value) {
+            return value.is<util::json::Number>() || value.is<util::json::Null>();
+        };
+
+        if (std::any_of(array.values.begin(), array.values.end(), is_number) &&
+            std::all_of(array.values.begin(), array.values.end(), is_number_or_null))
+        {
+            return EncodeNumbers(
+                array.values.begin(), array.values.end(), [](const util::json::Value &value) {
+                    return value.is<util::json::Number>()
+                               ? value.get<util::json::Number>().value
+                               : std::numeric_limits<double>::quiet_NaN();
+                });
+        }
+
+        std::vector<Slot> elements;
+        elements.reserve(array.values.size());
+        for (const auto &element : array.values)
+        {
+            elements.push_back(Encode(element));
+        }
+        return EncodeArray(elements);
+    }
+
+    void Finish(const Slot &root)
+    {
+        BOOST_ASSERT(root.type == ValueType::Object);
+        Header header{{MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3]}, VERSION, root};
+        std::memcpy(&out[0], &header, sizeof(header));
+    }
+
+  private:
+    struct ValueEncoder
+    {
+        Slot operator()(const util::json::String &string) const
+        {
+            return builder.EncodeString(string.value);
+        }
+        Slot operator()(const util::json::Number &number) const
+        {
+            return Builder::EncodeNumber(number.value);
+        }
+        Slot operator()(const util::json::Object &object) const { return builder.Encode(object); }
+        Slot operator()(const util::json::Array &array) const { return builder.Encode(array); }
+        Slot operator()(const util::json::True &) const { return Slot{ValueType::True, 0, 0}; }
+        Slot operator()(const util::json::False &) const { return Slot{ValueType::False, 0, 0}; }
+        Slot operator()(const util::json::Null &) const { return Slot{ValueType::Null, 0, 0}; }
+
+        Builder &builder;
+    };
+
+    // Appends zeroed space padded to 8 bytes and returns its offset
+    std::uint64_t Allocate(const std::size_t size)
+    {
+        const auto offset = out.size();
+        out.resize(offset + (size + 7) / 8 * 8);
+        return offset;
+    }
+
+    std::string &out;
+};
+
+// Binary response of the json object
+inline void encode(const util::json::Object &object, std::string &out)
+{
+    Builder builder(out);
+    builder.Finish(builder.Encode(object));
+}
+}
+}
+}
+}
+
+#endif
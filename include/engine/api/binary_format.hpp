@@ -0,0 +1,174 @@
+#ifndef ENGINE_API_BINARY_FORMAT_HPP
+#define ENGINE_API_BINARY_FORMAT_HPP
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+namespace binary
+{
+
+/**
+ * Binary response format, selected with `format=binary`.
+ *
+ * It holds the same document as the JSON response, laid out so a client can read it in place
+ * without parsing. All integers are little-endian, all offsets are in bytes from the start of
+ * the response and aligned to 8 bytes.
+ *
+ * The response starts with a Header, whose root slot is the response object. Every value is
+ * described by a 16 byte Slot:
+ *
+ * | type        | size                  | payload                                          |
+ * |-------------|-----------------------|--------------------------------------------------|
+ * | String      | length in bytes       | offset of the characters, followed by a 0 byte   |
+ * | Number      | 0                     | the IEEE 754 double itself                       |
+ * | Object      | number of members     | offset of 2 * size slots: key (String), value    |
+ * | Array       | number of elements    | offset of size slots                             |
+ * | NumberArray | number of elements    | offset of size doubles                           |
+ * | True, False, Null | 0               | 0                                                |
+ *
+ * Object members are sorted by key, so members can be looked up with a binary search.
+ * Arrays that only hold numbers are stored as NumberArray, e.g. coordinates and the rows of
+ * table durations. A null in such an array (an unreachable table entry) is stored as NaN.
+ */
+enum class ValueType : std::uint32_t
+{
+    String = 0,
+    Number = 1,
+    Object = 2,
+    Array = 3,
+    NumberArray = 4,
+    True = 5,
+    False = 6,
+    Null = 7
+};
+
+struct Slot
+{
+    ValueType type;
+    std::uint32_t size;
+    std::uint64_t payload;
+};
+static_assert(sizeof(Slot) == 16, "Slot is part of the format and must not be padded");
+
+const constexpr char MAGIC[4] = {'O', 'S', 'R', 'M'};
+const constexpr std::uint32_t VERSION = 1;
+
+struct Header
+{
+    char magic[4];
+    std::uint32_t version;
+    Slot root;
+};
+static_assert(sizeof(Header) == 24, "Header is part of the format and must not be padded");
+
+/**
+ * Read access to a value of a binary response, the response has to outlive it.
+ * Mostly meant as reference implementation for clients and for testing.
+ */
+class Value
+{
+  public:
+    Value(const char *data_, const Slot &slot_) : data(data_), slot(slot_) {}
+
+    ValueType type() const { return slot.type; }
+
+    std::size_t size() const { return slot.size; }
+
+    double GetNumber() const
+    {
+        BOOST_ASSERT(slot.type == ValueType::Number);
+        double value;
+        std::memcpy(&value, &slot.payload, sizeof(value));
+        return value;
+    }
+
+    const char *GetStringData() const
+    {
+        BOOST_ASSERT(slot.type == ValueType::String);
+        return data + slot.payload;
+    }
+
+    std::string GetString() const { return std::string(GetStringData(), slot.size); }
+
+    const double *GetNumbers() const
+    {
+        BOOST_ASSERT(slot.type == ValueType::NumberArray);
+        return reinterpret_cast<const double *>(data + slot.payload);
+    }
+
+    // Element of an Array
+    Value operator[](const std::size_t index) const
+    {
+        BOOST_ASSERT(slot.type == ValueType::Array && index < slot.size);
+        return Value(data, slots()[index]);
+    }
+
+    // Member of an Object, a Null value if there is no such member
+    Value operator[](const std::string &key) const
+    {
+        BOOST_ASSERT(slot.type == ValueType::Object);
+        const auto members = slots();
+        std::size_t first = 0, last = slot.size;
+        while (first < last)
+        {
+            const auto middle = first + (last - first) / 2;
+            const Value member_key(data, members[2 * middle]);
+            const auto compare = key.compare(0,
+                                             key.size(),
+                                             member_key.GetStringData(),
+                                             member_key.size());
+            if (compare == 0)
+                return Value(data, members[2 * middle + 1]);
+            if (compare < 0)
+                last = middle;
+            else
+                first = middle + 1;
+        }
+        return Value(data, Slot{ValueType::Null, 0, 0});
+    }
+
+    // Key of the member of an Object at the index
+    Value GetKey(const std::size_t index) const
+    {
+        BOOST_ASSERT(slot.type == ValueType::Object && index < slot.size);
+        return Value(data, slots()[2 * index]);
+    }
+
+    // Value of the member of an Object at the index
+    Value GetMember(const std::size_t index) const
+    {
+        BOOST_ASSERT(slot.type == ValueType::Object && index < slot.size);
+        return Value(data, slots()[2 * index + 1]);
+    }
+
+  private:
+    const Slot *slots() const { return reinterpret_cast<const Slot *>(data + slot.payload); }
+
+    const char *data;
+    Slot slot;
+};
+
+// Root object of a binary response, the response has to be 8 byte aligned
+inline Value GetRoot(const char *data)
+{
+    const auto header = reinterpret_cast<const Header *>(data);
+    BOOST_ASSERT(std::equal(MAGIC, MAGIC + sizeof(MAGIC), header->magic));
+    BOOST_ASSERT(header->version == VERSION);
+    return Value(data, header->root);
+}
+}
+}
+}
+}
+
+#endif
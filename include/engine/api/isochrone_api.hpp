@@ -0,0 +1,87 @@
+#ifndef ENGINE_API_ISOCHRONE_API_HPP
+#define ENGINE_API_ISOCHRONE_API_HPP
+
+#include "engine/api/base_api.hpp"
+#include "engine/api/isochrone_parameters.hpp"
+
+#include "engine/api/json_factory.hpp"
+#include "engine/phantom_node.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+
+class IsochroneAPI final : public BaseAPI
+{
+  public:
+    IsochroneAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+                 const IsochroneParameters &parameters_)
+        : BaseAPI(facade_, parameters_), parameters(parameters_)
+    {
+    }
+
+    // Polygons are closed rings given in the order of the requested contours
+    void MakeResponse(const PhantomNode &source,
+                      const std::vector<std::vector<util::Coordinate>> &polygons,
+                      util::json::Object &response) const
+    {
+        BOOST_ASSERT(parameters.coordinates.size() == 1);
+        BOOST_ASSERT(parameters.contours.size() == polygons.size());
+
+        util::json::Array isochrones;
+        isochrones.values.reserve(polygons.size());
+        for (const auto index : util::irange<std::size_t>(0, polygons.size()))
+        {
+            util::json::Object isochrone;
+            isochrone.values["duration"] = parameters.contours[index];
+            isochrone.values["geometry"] = MakePolygon(polygons[index]);
+            isochrones.values.push_back(std::move(isochrone));
+        }
+
+        util::json::Array waypoints;
+        waypoints.values.push_back(MakeWaypoint(source));
+
+        response.values["code"] = "Ok";
+        response.values["isochrones"] = std::move(isochrones);
+        response.values["waypoints"] = std::move(waypoints);
+    }
+
+  protected:
+    util::json::Object MakePolygon(const std::vector<util::Coordinate> &ring) const
+    {
+        util::json::Array coordinates;
+        coordinates.values.reserve(ring.size());
+        std::transform(ring.begin(),
+                       ring.end(),
+                       std::back_inserter(coordinates.values),
+                       &json::detail::coordinateToLonLat);
+
+        util::json::Array rings;
+        rings.values.push_back(std::move(coordinates));
+
+        util::json::Object geojson;
+        geojson.values["type"] = "Polygon";
+        geojson.values["coordinates"] = std::move(rings);
+        return geojson;
+    }
+
+    const IsochroneParameters &parameters;
+};
+
+} // ns api
+} // ns engine
+} // ns osrm
+
+#endif
@@ -5,13 +5,16 @@
 #include "engine/api/match_parameters_tidy.hpp"
 #include "engine/api/route_api.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/internal_route_result.hpp"
 #include "engine/map_matching/sub_matching.hpp"
 
 #include "util/integer_range.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace osrm
 {
 namespace engine
@@ -22,29 +25,49 @@ namespace api
 class MatchAPI final : public RouteAPI
 {
   public:
-    MatchAPI(const datafacade::BaseDataFacade &facade_,
+    MatchAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
              const MatchParameters &parameters_,
              const tidy::Result &tidy_result_)
         : RouteAPI(facade_, parameters_), parameters(parameters_), tidy_result(tidy_result_)
     {
     }
 
+    // The routes are assembled in parallel on the current task arena if assemble_in_parallel
+    // is set, they are independent of each other.
     void MakeResponse(const std::vector<map_matching::SubMatching> &sub_matchings,
                       const std::vector<InternalRouteResult> &sub_routes,
-                      util::json::Object &response) const
+                      util::json::Object &response,
+                      const bool assemble_in_parallel = false) const
     {
         auto number_of_routes = sub_matchings.size();
         util::json::Array routes;
-        routes.values.reserve(number_of_routes);
+        routes.values.resize(number_of_routes);
         BOOST_ASSERT(sub_matchings.size() == sub_routes.size());
-        for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
-        {
+        const auto make_route = [&](const std::size_t index) {
             auto route = MakeRoute(sub_routes[index].segment_end_coordinates,
                                    sub_routes[index].unpacked_path_segments,
                                    sub_routes[index].source_traversed_in_reverse,
-                                   sub_routes[index].target_traversed_in_reverse);
+                                   sub_routes[index].target_traversed_in_reverse,
+                                   parameters.steps);
             route.values["confidence"] = sub_matchings[index].confidence;
-            routes.values.push_back(std::move(route));
+            routes.values[index] = std::move(route);
+        };
+        if (assemble_in_parallel)
+        {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_routes),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  for (auto index = range.begin(); index != range.end(); ++index)
+                                  {
+                                      make_route(index);
+                                  }
+                              });
+        }
+        else
+        {
+            for (auto index : util::irange<std::size_t>(0UL, number_of_routes))
+            {
+                make_route(index);
+            }
         }
         response.values["tracepoints"] = MakeTracepoints(sub_matchings);
         response.values["matchings"] = std::move(routes);
@@ -30,6 +30,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/api/route_parameters.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -44,6 +48,8 @@ namespace api
  *
  * Holds member attributes:
  *  - timestamps: timestamp(s) for the corresponding input coordinate(s)
+ *  - session: id of a match session the coordinates are appended to, see MatchSessions
+ *  - traces: number of coordinates of each trace of a batch request, empty for a single trace
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -77,10 +83,23 @@ struct MatchParameters : public RouteParameters
     std::vector<unsigned> timestamps;
     GapsType gaps;
     bool tidy;
+    std::string session;
+    std::vector<unsigned> traces;
 
     bool IsValid() const
     {
-        return RouteParameters::IsValid() &&
+        // the trace of a session continues at the last point of its previous request
+        const auto continues_session =
+            !session.empty() && coordinates.size() == 1 && BaseParameters::IsValid();
+        // the traces of a batch are matched on their own and can not continue a session
+        const auto traces_ok =
+            traces.empty() ||
+            (session.empty() &&
+             std::all_of(traces.begin(),
+                         traces.end(),
+                         [](const unsigned trace_size) { return trace_size >= 2; }) &&
+             std::accumulate(traces.begin(), traces.end(), std::size_t{0}) == coordinates.size());
+        return (RouteParameters::IsValid() || continues_session) && traces_ok &&
                (timestamps.empty() || timestamps.size() == coordinates.size());
     }
 };
@@ -5,7 +5,7 @@
 #include "engine/api/json_factory.hpp"
 #include "engine/api/route_parameters.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/guidance/assemble_geometry.hpp"
 #include "engine/guidance/assemble_leg.hpp"
@@ -23,6 +23,9 @@
 #include "util/integer_range.hpp"
 #include "util/json_util.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <iterator>
 #include <vector>
 
@@ -36,13 +39,17 @@ namespace api
 class RouteAPI : public BaseAPI
 {
   public:
-    RouteAPI(const datafacade::BaseDataFacade &facade_, const RouteParameters &parameters_)
+    RouteAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+             const RouteParameters &parameters_)
         : BaseAPI(facade_, parameters_), parameters(parameters_)
     {
     }
 
+    // The legs of each route are assembled in parallel on the current task arena if
+    // assemble_legs_in_parallel is set, they are independent of each other.
     void MakeResponse(const InternalManyRoutesResult &raw_routes,
-                      util::json::Object &response) const
+                      util::json::Object &response,
+                      const bool assemble_legs_in_parallel = false) const
     {
         BOOST_ASSERT(!raw_routes.routes.empty());
 
@@ -53,10 +60,15 @@ class RouteAPI : public BaseAPI
             if (!route.is_valid())
                 continue;
 
+            // routes are ordered by rank, the first one is the one the client navigates along
+            const auto steps =
+                parameters.steps && (jsRoutes.values.empty() || parameters.alternative_steps);
             jsRoutes.values.push_back(MakeRoute(route.segment_end_coordinates,
                                                 route.unpacked_path_segments,
                                                 route.source_traversed_in_reverse,
-                                                route.target_traversed_in_reverse));
+                                                route.target_traversed_in_reverse,
+                                                steps,
+                                                assemble_legs_in_parallel));
         }
 
         response.values["waypoints"] =
@@ -99,16 +111,15 @@ class RouteAPI : public BaseAPI
     util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
                                  const std::vector<std::vector<PathData>> &unpacked_path_segments,
                                  const std::vector<bool> &source_traversed_in_reverse,
-                                 const std::vector<bool> &target_traversed_in_reverse) const
+                                 const std::vector<bool> &target_traversed_in_reverse,
+                                 const bool steps,
+                                 const bool assemble_legs_in_parallel = false) const
     {
-        std::vector<guidance::RouteLeg> legs;
-        std::vector<guidance::LegGeometry> leg_geometries;
         auto number_of_legs = segment_end_coordinates.size();
-        legs.reserve(number_of_legs);
-        leg_geometries.reserve(number_of_legs);
+        std::vector<guidance::RouteLeg> legs(number_of_legs);
+        std::vector<guidance::LegGeometry> leg_geometries(number_of_legs);
 
-        for (auto idx : util::irange<std::size_t>(0UL, number_of_legs))
-        {
+        const auto assemble_leg = [&](const std::size_t idx) {
             const auto &phantoms = segment_end_coordinates[idx];
             const auto &path_data = unpacked_path_segments[idx];
 
@@ -127,11 +138,11 @@ class RouteAPI : public BaseAPI
                                              phantoms.source_phantom,
                                              phantoms.target_phantom,
                                              reversed_target,
-                                             parameters.steps);
+                                             steps);
 
-            if (parameters.steps)
+            if (steps)
             {
-                auto steps = guidance::assembleSteps(BaseAPI::facade,
+                auto leg_steps = guidance::assembleSteps(BaseAPI::facade,
                                                      path_data,
                                                      leg_geometry,
                                                      phantoms.source_phantom,
@@ -171,8 +182,8 @@ class RouteAPI : public BaseAPI
                  *      post-processed roundabouts without Exit instructions
                  */
 
-                guidance::trimShortSegments(steps, leg_geometry);
-                leg.steps = guidance::postProcess(std::move(steps));
+                guidance::trimShortSegments(leg_steps, leg_geometry);
+                leg.steps = guidance::postProcess(std::move(leg_steps));
                 leg.steps = guidance::collapseTurnInstructions(std::move(leg.steps));
                 leg.steps = guidance::buildIntersections(std::move(leg.steps));
                 leg.steps = guidance::suppressShortNameSegments(std::move(leg.steps));
@@ -183,10 +194,36 @@ class RouteAPI : public BaseAPI
                 leg.steps = guidance::anticipateLaneChange(std::move(leg.steps));
                 leg.steps = guidance::collapseUseLane(std::move(leg.steps));
                 leg_geometry = guidance::resyncGeometry(std::move(leg_geometry), leg.steps);
+
+                // the intersections are still needed to find the steps, only their output is
+                // skipped
+                if (!parameters.intersections)
+                {
+                    for (auto &step : leg.steps)
+                        step.intersections.clear();
+                }
             }
 
-            leg_geometries.push_back(std::move(leg_geometry));
-            legs.push_back(std::move(leg));
+            leg_geometries[idx] = std::move(leg_geometry);
+            legs[idx] = std::move(leg);
+        };
+
+        if (assemble_legs_in_parallel)
+        {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_legs),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  for (auto idx = range.begin(); idx != range.end(); ++idx)
+                                  {
+                                      assemble_leg(idx);
+                                  }
+                              });
+        }
+        else
+        {
+            for (auto idx : util::irange<std::size_t>(0UL, number_of_legs))
+            {
+                assemble_leg(idx);
+            }
         }
 
         auto route = guidance::assembleRoute(legs);
@@ -49,6 +49,17 @@ namespace api
  *  - overview: adds overview geometry either Full, Simplified (according to highest zoom level) or
  *              False (not at all)
  *  - continue_straight: enable or disable continue_straight (disabled by default)
+ *  - depart_at: minute after midnight of the departure, routes on the metric of its time bucket
+ *               if the MLD dataset was customized with speed profiles
+ *  - depart_day: day of the week of depart_at, 0 for Monday (the default) to 6 for Sunday. MLD
+ *                datasets that evaluate conditional turn restrictions at query time restrict
+ *                the turns of that day and time.
+ *  - alternatives_search: Exact verifies every alternative candidate with searches of its own,
+ *                         SinglePass ranks them in the search spaces of the shortest path and
+ *                         only searches to verify the best ones (CH only)
+ *  - alternative_steps: return route steps for the alternatives as well, otherwise only the first
+ *                       route has steps and the alternatives their summary
+ *  - intersections: list the intersections a step passes and the lanes at them
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
@@ -67,6 +78,11 @@ struct RouteParameters : public BaseParameters
         Full,
         False
     };
+    enum class AlternativesSearchType
+    {
+        Exact,
+        SinglePass
+    };
     enum class AnnotationsType
     {
         None = 0,
@@ -138,12 +154,19 @@ struct RouteParameters : public BaseParameters
     GeometriesType geometries = GeometriesType::Polyline;
     OverviewType overview = OverviewType::Simplified;
     boost::optional<bool> continue_straight;
+    boost::optional<unsigned> depart_at;
+    boost::optional<unsigned> depart_day;
+    AlternativesSearchType alternatives_search = AlternativesSearchType::Exact;
+    bool alternative_steps = true;
+    bool intersections = true;
 
     bool IsValid() const
     {
         const auto coordinates_ok = coordinates.size() >= 2;
         const auto base_params_ok = BaseParameters::IsValid();
-        return coordinates_ok && base_params_ok;
+        const auto depart_at_ok = !depart_at || *depart_at < 24 * 60;
+        const auto depart_day_ok = !depart_day || (depart_at && *depart_day < 7);
+        return coordinates_ok && base_params_ok && depart_at_ok && depart_day_ok;
     }
 };
 
@@ -2,10 +2,11 @@
 #define ENGINE_API_TABLE_HPP
 
 #include "engine/api/base_api.hpp"
+#include "engine/api/binary_builder.hpp"
 #include "engine/api/json_factory.hpp"
 #include "engine/api/table_parameters.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/guidance/assemble_geometry.hpp"
 #include "engine/guidance/assemble_leg.hpp"
@@ -16,10 +17,18 @@
 #include "engine/internal_route_result.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/json_renderer.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <iterator>
+#include <limits>
+#include <string>
+#include <utility>
 
 namespace osrm
 {
@@ -31,12 +40,15 @@ namespace api
 class TableAPI final : public BaseAPI
 {
   public:
-    TableAPI(const datafacade::BaseDataFacade &facade_, const TableParameters &parameters_)
+    TableAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+             const TableParameters &parameters_)
         : BaseAPI(facade_, parameters_), parameters(parameters_)
     {
     }
 
+    // The distances are only read if the parameters request them
     virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<double> &distances,
                               const std::vector<PhantomNode> &phantoms,
                               util::json::Object &response) const
     {
@@ -64,11 +76,133 @@ class TableAPI final : public BaseAPI
             response.values["destinations"] = MakeWaypoints(phantoms, parameters.destinations);
         }
 
-        response.values["durations"] =
-            MakeTable(durations, number_of_sources, number_of_destinations);
+        if (parameters.annotations & TableParameters::AnnotationsType::Duration)
+        {
+            response.values["durations"] =
+                MakeTable(durations, number_of_sources, number_of_destinations);
+        }
+        if (parameters.annotations & TableParameters::AnnotationsType::Distance)
+        {
+            response.values["distances"] =
+                MakeTable(ToDecimeters(distances), number_of_sources, number_of_destinations);
+        }
         response.values["code"] = "Ok";
     }
 
+    // Same response rendered to JSON text. Only the waypoints are built as json objects, the
+    // durations and distances are formatted straight from the tables.
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<double> &distances,
+                              const std::vector<PhantomNode> &phantoms,
+                              std::string &response) const
+    {
+        auto number_of_sources = parameters.sources.size();
+        auto number_of_destinations = parameters.destinations.size();
+
+        util::json::Object waypoints;
+        if (parameters.sources.empty())
+        {
+            waypoints.values["sources"] = MakeWaypoints(phantoms);
+            number_of_sources = phantoms.size();
+        }
+        else
+        {
+            waypoints.values["sources"] = MakeWaypoints(phantoms, parameters.sources);
+        }
+
+        if (parameters.destinations.empty())
+        {
+            waypoints.values["destinations"] = MakeWaypoints(phantoms);
+            number_of_destinations = phantoms.size();
+        }
+        else
+        {
+            waypoints.values["destinations"] = MakeWaypoints(phantoms, parameters.destinations);
+        }
+        waypoints.values["code"] = "Ok";
+
+        std::vector<char> rendered_waypoints;
+        util::json::render(rendered_waypoints, waypoints);
+        BOOST_ASSERT(rendered_waypoints.size() >= 2 && rendered_waypoints.back() == '}');
+
+        const auto with_durations =
+            parameters.annotations & TableParameters::AnnotationsType::Duration;
+        const auto with_distances =
+            parameters.annotations & TableParameters::AnnotationsType::Distance;
+
+        // about 8 characters per duration or distance
+        response.clear();
+        response.reserve(rendered_waypoints.size() + 32 +
+                         (with_durations + with_distances) * number_of_sources *
+                             (number_of_destinations * 8 + 3));
+        response.append(rendered_waypoints.begin(), rendered_waypoints.end() - 1);
+        if (with_durations)
+        {
+            response.append(",\"durations\":");
+            MakeTable(durations, number_of_sources, number_of_destinations, response);
+        }
+        if (with_distances)
+        {
+            response.append(",\"distances\":");
+            MakeTable(
+                ToDecimeters(distances), number_of_sources, number_of_destinations, response);
+        }
+        response.push_back('}');
+    }
+
+    // Same response in the binary format, the rows of durations and distances are written as
+    // number arrays straight from the tables
+    virtual void MakeBinaryResponse(const std::vector<EdgeWeight> &durations,
+                                    const std::vector<double> &distances,
+                                    const std::vector<PhantomNode> &phantoms,
+                                    std::string &response) const
+    {
+        auto number_of_sources = parameters.sources.size();
+        auto number_of_destinations = parameters.destinations.size();
+
+        binary::Builder builder(response);
+        std::vector<std::pair<std::string, binary::Slot>> members;
+        if (parameters.sources.empty())
+        {
+            members.emplace_back("sources", builder.Encode(MakeWaypoints(phantoms)));
+            number_of_sources = phantoms.size();
+        }
+        else
+        {
+            members.emplace_back("sources",
+                                 builder.Encode(MakeWaypoints(phantoms, parameters.sources)));
+        }
+
+        if (parameters.destinations.empty())
+        {
+            members.emplace_back("destinations", builder.Encode(MakeWaypoints(phantoms)));
+            number_of_destinations = phantoms.size();
+        }
+        else
+        {
+            members.emplace_back(
+                "destinations", builder.Encode(MakeWaypoints(phantoms, parameters.destinations)));
+        }
+
+        if (parameters.annotations & TableParameters::AnnotationsType::Duration)
+        {
+            members.emplace_back(
+                "durations",
+                EncodeTable(builder, durations, number_of_sources, number_of_destinations));
+        }
+        if (parameters.annotations & TableParameters::AnnotationsType::Distance)
+        {
+            members.emplace_back("distances",
+                                 EncodeTable(builder,
+                                             ToDecimeters(distances),
+                                             number_of_sources,
+                                             number_of_destinations));
+        }
+        members.emplace_back("code", builder.EncodeString("Ok"));
+
+        builder.Finish(builder.EncodeObject(std::move(members)));
+    }
+
   protected:
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
     {
@@ -123,6 +257,100 @@ class TableAPI final : public BaseAPI
         return json_table;
     }
 
+    // Rows of the table as arrays of numbers, NaN for unreachable entries
+    static binary::Slot EncodeTable(binary::Builder &builder,
+                                    const std::vector<EdgeWeight> &values,
+                                    std::size_t number_of_rows,
+                                    std::size_t number_of_columns)
+    {
+        std::vector<binary::Slot> rows;
+        rows.reserve(number_of_rows);
+        for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
+        {
+            const auto row_begin = values.begin() + (row * number_of_columns);
+            rows.push_back(builder.EncodeNumbers(
+                row_begin, row_begin + number_of_columns, [](const EdgeWeight value) {
+                    return value == MAXIMAL_EDGE_DURATION
+                               ? std::numeric_limits<double>::quiet_NaN()
+                               : value / 10.;
+                }));
+        }
+        return builder.EncodeArray(rows);
+    }
+
+    // Distances in meters rounded to tenths like the durations, unreachable entries are marked
+    // like the ones of the durations
+    static std::vector<EdgeWeight> ToDecimeters(const std::vector<double> &distances)
+    {
+        std::vector<EdgeWeight> decimeters(distances.size());
+        std::transform(distances.begin(),
+                       distances.end(),
+                       decimeters.begin(),
+                       [](const double distance) {
+                           if (distance == std::numeric_limits<double>::max())
+                           {
+                               return MAXIMAL_EDGE_DURATION;
+                           }
+                           return static_cast<EdgeWeight>(std::round(distance * 10.));
+                       });
+        return decimeters;
+    }
+
+    // Same output as rendering the json table: values in tenths as decimal numbers without
+    // trailing zeros and null for unreachable entries
+    virtual void MakeTable(const std::vector<EdgeWeight> &values,
+                           std::size_t number_of_rows,
+                           std::size_t number_of_columns,
+                           std::string &out) const
+    {
+        out.push_back('[');
+        for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
+        {
+            if (row > 0)
+                out.push_back(',');
+            out.push_back('[');
+            const auto row_begin = values.begin() + (row * number_of_columns);
+            for (auto iter = row_begin; iter != row_begin + number_of_columns; ++iter)
+            {
+                if (iter != row_begin)
+                    out.push_back(',');
+                if (*iter == MAXIMAL_EDGE_DURATION)
+                    out.append("null", 4);
+                else
+                    appendDeciseconds(*iter, out);
+            }
+            out.push_back(']');
+        }
+        out.push_back(']');
+    }
+
+    // Formats the duration in seconds with at most one decimal digit
+    static void appendDeciseconds(const EdgeWeight duration, std::string &out)
+    {
+        // enough for the digits of any 32 bit value, the decimal point and the sign
+        char buffer[16];
+        char *end = buffer + sizeof(buffer);
+        char *begin = end;
+
+        auto value = static_cast<std::uint64_t>(std::abs(static_cast<std::int64_t>(duration)));
+        const auto decimal = value % 10;
+        value /= 10;
+        if (decimal != 0)
+        {
+            *--begin = static_cast<char>('0' + decimal);
+            *--begin = '.';
+        }
+        do
+        {
+            *--begin = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        if (duration < 0)
+            *--begin = '-';
+
+        out.append(begin, end);
+    }
+
     const TableParameters &parameters;
 };
 
@@ -30,10 +30,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/api/base_parameters.hpp"
 
+#include <boost/optional.hpp>
+
 #include <cstddef>
 
 #include <algorithm>
 #include <iterator>
+#include <type_traits>
 #include <vector>
 
 namespace osrm
@@ -51,14 +54,34 @@ namespace api
  *             use all coordinates as sources
  *  - destinations: indices into coordinates indicating destinations for the Table service, no
  *                  destinations means use all coordinates as destinations
+ *  - annotations: tables to return, durations in seconds and/or distances in meters
+ *  - max_duration: searches stop at routes longer than this many seconds, their entries are null
+ *  - max_weight: searches stop at routes with a larger weight, their entries are null
+ *  - max_results_per_source: only the nearest destinations of each source by duration are kept,
+ *                            the other entries of its row are null
+ *  - approximate: durations are estimated by the distance oracle of the dataset where its bounds
+ *                 are tight enough, see TablePlugin
  *
  * \see OSRM, Coordinate, Hint, Bearing, RouteParame, RouteParameters, TableParameters,
  *      NearestParameters, TripParameters, MatchParameters and TileParameters
  */
 struct TableParameters : public BaseParameters
 {
+    enum class AnnotationsType
+    {
+        None = 0,
+        Duration = 0x01,
+        Distance = 0x02,
+        All = Duration | Distance
+    };
+
     std::vector<std::size_t> sources;
     std::vector<std::size_t> destinations;
+    AnnotationsType annotations = AnnotationsType::Duration;
+    boost::optional<double> max_duration;
+    boost::optional<double> max_weight;
+    boost::optional<std::size_t> max_results_per_source;
+    bool approximate = false;
 
     TableParameters() = default;
     template <typename... Args>
@@ -70,11 +93,31 @@ struct TableParameters : public BaseParameters
     {
     }
 
+    template <typename... Args>
+    TableParameters(std::vector<std::size_t> sources_,
+                    std::vector<std::size_t> destinations_,
+                    const AnnotationsType annotations_,
+                    Args... args_)
+        : BaseParameters{std::forward<Args>(args_)...}, sources{std::move(sources_)},
+          destinations{std::move(destinations_)}, annotations{annotations_}
+    {
+    }
+
     bool IsValid() const
     {
         if (!BaseParameters::IsValid())
             return false;
 
+        // at least one of the tables has to be requested
+        if (annotations == AnnotationsType::None)
+            return false;
+
+        if ((max_duration && *max_duration < 0) || (max_weight && *max_weight < 0))
+            return false;
+
+        if (max_results_per_source && *max_results_per_source == 0)
+            return false;
+
         // Distance Table makes only sense with 2+ coodinates
         if (coordinates.size() < 2)
             return false;
@@ -100,6 +143,21 @@ struct TableParameters : public BaseParameters
         return true;
     }
 };
+
+inline bool operator&(TableParameters::AnnotationsType lhs, TableParameters::AnnotationsType rhs)
+{
+    return static_cast<bool>(
+        static_cast<std::underlying_type_t<TableParameters::AnnotationsType>>(lhs) &
+        static_cast<std::underlying_type_t<TableParameters::AnnotationsType>>(rhs));
+}
+
+inline TableParameters::AnnotationsType operator|(TableParameters::AnnotationsType lhs,
+                                                  TableParameters::AnnotationsType rhs)
+{
+    return (TableParameters::AnnotationsType)(
+        static_cast<std::underlying_type_t<TableParameters::AnnotationsType>>(lhs) |
+        static_cast<std::underlying_type_t<TableParameters::AnnotationsType>>(rhs));
+}
 }
 }
 }
@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ENGINE_API_TILE_PARAMETERS_HPP
 
 #include <cmath>
+#include <type_traits>
 
 namespace osrm
 {
@@ -44,6 +45,7 @@ namespace api
  *  - x: the x location for the tile
  *  - y: the y location for the tile
  *  - z: the zoom level for the tile
+ *  - layers: the layers written to the tile, speeds, turns and osmnodes by default
  *
  * The parameters x,y and z have to conform to the Slippy Map Tilenames specification:
  *  - https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames#Zoom_levels
@@ -54,9 +56,19 @@ namespace api
  */
 struct TileParameters final
 {
+    enum class LayersType
+    {
+        None = 0,
+        Speeds = 0x01,
+        Turns = 0x02,
+        OSMNodes = 0x04,
+        All = Speeds | Turns | OSMNodes
+    };
+
     unsigned x;
     unsigned y;
     unsigned z;
+    LayersType layers = LayersType::All;
 
     bool IsValid() const
     {
@@ -66,10 +78,25 @@ struct TileParameters final
         const auto valid_y = y <= static_cast<unsigned>(std::pow(2., z)) - 1;
         // zoom limits are due to slippy map and server performance limits
         const auto valid_z = z < 20 && z >= 12;
+        const auto valid_layers = layers != LayersType::None;
 
-        return valid_x && valid_y && valid_z;
+        return valid_x && valid_y && valid_z && valid_layers;
     }
 };
+
+inline bool operator&(TileParameters::LayersType lhs, TileParameters::LayersType rhs)
+{
+    return static_cast<bool>(static_cast<std::underlying_type_t<TileParameters::LayersType>>(lhs) &
+                             static_cast<std::underlying_type_t<TileParameters::LayersType>>(rhs));
+}
+
+inline TileParameters::LayersType operator|(TileParameters::LayersType lhs,
+                                            TileParameters::LayersType rhs)
+{
+    return (TileParameters::LayersType)(
+        static_cast<std::underlying_type_t<TileParameters::LayersType>>(lhs) |
+        static_cast<std::underlying_type_t<TileParameters::LayersType>>(rhs));
+}
 }
 }
 }
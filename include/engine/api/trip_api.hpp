@@ -4,7 +4,7 @@
 #include "engine/api/route_api.hpp"
 #include "engine/api/trip_parameters.hpp"
 
-#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 
 #include "engine/internal_route_result.hpp"
 
@@ -20,7 +20,8 @@ namespace api
 class TripAPI final : public RouteAPI
 {
   public:
-    TripAPI(const datafacade::BaseDataFacade &facade_, const TripParameters &parameters_)
+    TripAPI(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade_,
+            const TripParameters &parameters_)
         : RouteAPI(facade_, parameters_), parameters(parameters_)
     {
     }
@@ -39,7 +40,8 @@ class TripAPI final : public RouteAPI
             auto route = MakeRoute(sub_routes[index].segment_end_coordinates,
                                    sub_routes[index].unpacked_path_segments,
                                    sub_routes[index].source_traversed_in_reverse,
-                                   sub_routes[index].target_traversed_in_reverse);
+                                   sub_routes[index].target_traversed_in_reverse,
+                                   parameters.steps);
             routes.values.push_back(std::move(route));
         }
         response.values["waypoints"] = MakeWaypoints(sub_trips, phantoms);
@@ -0,0 +1,48 @@
+#ifndef OSRM_ENGINE_ASYNC_EXECUTOR_HPP
+#define OSRM_ENGINE_ASYNC_EXECUTOR_HPP
+
+#include <tbb/task_arena.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Runs the queries of the asynchronous OSRM API on the TBB worker threads.
+ *
+ * Tasks are queued in a task arena of their own, so at most `concurrency` of them run at the
+ * same time and the callers never block. The destructor waits for all queued tasks.
+ */
+class AsyncExecutor
+{
+  public:
+    // -1 runs as many tasks at once as there are hardware threads
+    explicit AsyncExecutor(const int concurrency);
+    ~AsyncExecutor();
+
+    AsyncExecutor(const AsyncExecutor &) = delete;
+    AsyncExecutor &operator=(const AsyncExecutor &) = delete;
+
+    // Queues the task, it must not throw
+    void Enqueue(std::function<void()> task);
+
+    // Blocks until all queued tasks have finished
+    void Wait();
+
+  private:
+    tbb::task_arena arena;
+
+    std::mutex pending_lock;
+    std::condition_variable all_finished;
+    std::size_t pending = 0;
+};
+}
+}
+
+#endif // OSRM_ENGINE_ASYNC_EXECUTOR_HPP
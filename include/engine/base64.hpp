@@ -1,19 +1,22 @@
 #ifndef OSRM_BASE64_HPP
 #define OSRM_BASE64_HPP
 
+#include <algorithm>
+#include <array>
 #include <iterator>
 #include <string>
 #include <type_traits>
-#include <vector>
 
 #include <climits>
 #include <cstddef>
+#include <cstdint>
 
-#include <boost/algorithm/string/trim.hpp>
-#include <boost/archive/iterators/base64_from_binary.hpp>
-#include <boost/archive/iterators/binary_from_base64.hpp>
-#include <boost/archive/iterators/transform_width.hpp>
-#include <boost/range/algorithm/copy.hpp>
+#include <boost/archive/iterators/dataflow_exception.hpp>
+#include <boost/assert.hpp>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
 
 namespace osrm
 {
@@ -21,50 +24,189 @@ namespace osrm
 // RFC 4648 "The Base16, Base32, and Base64 Data Encodings"
 // See: https://tools.ietf.org/html/rfc4648
 
+namespace engine
+{
+// The standard alphabet or the URL and filename safe one of section 5 with '-' and '_' for the
+// last two characters
+enum class Base64Alphabet
+{
+    Standard,
+    URL
+};
+}
+
 namespace detail
 {
 // The C++ standard guarantees none of this by default, but we need it in the following.
 static_assert(CHAR_BIT == 8u, "we assume a byte holds 8 bits");
 static_assert(sizeof(char) == 1u, "we assume a char is one byte large");
 
-using Base64FromBinary = boost::archive::iterators::base64_from_binary<
-    boost::archive::iterators::transform_width<const char *, // sequence of chars
-                                               6,            // get view of 6 bit
-                                               8             // from sequence of 8 bit
-                                               >>;
-
-using BinaryFromBase64 = boost::archive::iterators::transform_width<
-    boost::archive::iterators::binary_from_base64<std::string::const_iterator>,
-    8, // get a view of 8 bit
-    6  // from a sequence of 6 bit
-    >;
+const constexpr char BASE64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const constexpr char BASE64_URL_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// Values of the base64 characters by character for decoding, the padding reads as zero bits.
+// Both alphabets decode, so URL safe input doesn't have to be translated first.
+class Base64DecodeTable
+{
+  public:
+    static constexpr std::uint8_t INVALID = 0xff;
+
+    static const Base64DecodeTable &GetInstance()
+    {
+        static const Base64DecodeTable table;
+        return table;
+    }
+
+    std::uint8_t operator[](const char character) const
+    {
+        return values[static_cast<unsigned char>(character)];
+    }
+
+  private:
+    Base64DecodeTable()
+    {
+        // a copy, fill takes a reference that would need a definition of INVALID
+        values.fill(std::uint8_t{INVALID});
+        for (std::uint8_t value = 0; value < 64; ++value)
+        {
+            values[static_cast<unsigned char>(BASE64_ALPHABET[value])] = value;
+            values[static_cast<unsigned char>(BASE64_URL_ALPHABET[value])] = value;
+        }
+        values[static_cast<unsigned char>('=')] = 0;
+    }
+
+    std::array<std::uint8_t, 256> values;
+};
+
+#if defined(__SSSE3__)
+// Encodes 12 bytes of the 16 at first into 16 characters. Spreads the four 6 bit values of
+// every 3 bytes over four bytes with a shuffle and two multiplications, then adds the offset of
+// the range of the alphabet each value falls into.
+inline void encodeBase64Block(const unsigned char *first, char *out, const char *alphabet)
+{
+    auto input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    input = _mm_shuffle_epi8(input,
+                             _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+    const auto high = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00)),
+                                      _mm_set1_epi32(0x04000040));
+    const auto low = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003f03f0)),
+                                     _mm_set1_epi32(0x01000010));
+    const auto values = _mm_or_si128(high, low);
+
+    // 'A' for 0-25, 'a' for 26-51, '0' for 52-61
+    auto offsets = _mm_set1_epi8('A');
+    offsets = _mm_add_epi8(
+        offsets, _mm_and_si128(_mm_cmpgt_epi8(values, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+    offsets = _mm_add_epi8(
+        offsets, _mm_and_si128(_mm_cmpgt_epi8(values, _mm_set1_epi8(51)), _mm_set1_epi8(-75)));
+    auto characters = _mm_add_epi8(values, offsets);
+
+    // the last two characters are the only ones that differ between the alphabets
+    const auto is_62 = _mm_cmpeq_epi8(values, _mm_set1_epi8(62));
+    const auto is_63 = _mm_cmpeq_epi8(values, _mm_set1_epi8(63));
+    characters = _mm_andnot_si128(_mm_or_si128(is_62, is_63), characters);
+    characters = _mm_or_si128(characters, _mm_and_si128(is_62, _mm_set1_epi8(alphabet[62])));
+    characters = _mm_or_si128(characters, _mm_and_si128(is_63, _mm_set1_epi8(alphabet[63])));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), characters);
+}
+
+// Decodes the 16 characters at first into the first 12 bytes, false if one of them is not in
+// either alphabet. The values are looked up by comparing with the ranges of the alphabet and
+// packed together by two multiply-adds and a shuffle.
+inline bool decodeBase64Block(const char *first, unsigned char (&bytes)[16])
+{
+    const auto characters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    const auto in_range = [&characters](const char min, const char max) {
+        return _mm_and_si128(_mm_cmpgt_epi8(characters, _mm_set1_epi8(min - 1)),
+                             _mm_cmpgt_epi8(_mm_set1_epi8(max + 1), characters));
+    };
+    const auto is_any = [&characters](const char lhs, const char rhs) {
+        return _mm_or_si128(_mm_cmpeq_epi8(characters, _mm_set1_epi8(lhs)),
+                            _mm_cmpeq_epi8(characters, _mm_set1_epi8(rhs)));
+    };
+
+    const auto upper = in_range('A', 'Z');
+    const auto lower = in_range('a', 'z');
+    const auto digit = in_range('0', '9');
+    const auto is_62 = is_any('+', '-');
+    const auto is_63 = is_any('/', '_');
+    const auto valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                    _mm_or_si128(digit, _mm_or_si128(is_62, is_63)));
+    if (_mm_movemask_epi8(valid) != 0xffff)
+        return false;
+
+    auto values = _mm_and_si128(upper, _mm_sub_epi8(characters, _mm_set1_epi8('A')));
+    values = _mm_or_si128(values,
+                          _mm_and_si128(lower, _mm_sub_epi8(characters, _mm_set1_epi8('a' - 26))));
+    values = _mm_or_si128(values,
+                          _mm_and_si128(digit, _mm_add_epi8(characters, _mm_set1_epi8(52 - '0'))));
+    values = _mm_or_si128(values, _mm_and_si128(is_62, _mm_set1_epi8(62)));
+    values = _mm_or_si128(values, _mm_and_si128(is_63, _mm_set1_epi8(63)));
+
+    // 6 + 6 bits into each 16 bit lane, 12 + 12 bits into each 32 bit lane, then the three
+    // bytes of each lane in big endian order
+    const auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const auto quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    const auto packed = _mm_shuffle_epi8(
+        quads, _mm_set_epi8(-1, -1, -1, -1, 12, 13, 14, 8, 9, 10, 4, 5, 6, 0, 1, 2));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes), packed);
+    return true;
+}
+#endif
+
 } // ns detail
 namespace engine
 {
 
 // Encoding Implementation
 
-// Encodes a chunk of memory to Base64.
-inline std::string encodeBase64(const unsigned char *first, std::size_t size)
+// Encodes a chunk of memory to Base64. Blocks of 12 bytes are encoded with SSSE3 if the build
+// targets it, the rest three bytes at a time through the alphabet.
+inline std::string encodeBase64(const unsigned char *first,
+                                std::size_t size,
+                                const Base64Alphabet alphabet_type = Base64Alphabet::Standard)
 {
-    std::vector<unsigned char> bytes{first, first + size};
-    BOOST_ASSERT(!bytes.empty());
+    BOOST_ASSERT(size > 0);
+    const auto alphabet = alphabet_type == Base64Alphabet::URL ? detail::BASE64_URL_ALPHABET
+                                                              : detail::BASE64_ALPHABET;
 
-    std::size_t bytes_to_pad{0};
+    std::string encoded((size + 2) / 3 * 4, '=');
+    auto out = &encoded[0];
+    const auto last = first + size;
 
-    while (bytes.size() % 3 != 0)
+#if defined(__SSSE3__)
+    // the blocks read 16 bytes
+    for (; last - first >= 16; first += 12, out += 16)
     {
-        bytes_to_pad += 1;
-        bytes.push_back(0);
+        detail::encodeBase64Block(first, out, alphabet);
     }
+#endif
 
-    BOOST_ASSERT(bytes_to_pad == 0 || bytes_to_pad == 1 || bytes_to_pad == 2);
-    BOOST_ASSERT_MSG(0 == bytes.size() % 3, "base64 input data size is not a multiple of 3");
+    for (; last - first >= 3; first += 3)
+    {
+        const auto bits = std::uint32_t{first[0]} << 16 | std::uint32_t{first[1]} << 8 | first[2];
+        *out++ = alphabet[bits >> 18];
+        *out++ = alphabet[(bits >> 12) & 0x3f];
+        *out++ = alphabet[(bits >> 6) & 0x3f];
+        *out++ = alphabet[bits & 0x3f];
+    }
 
-    std::string encoded{detail::Base64FromBinary{bytes.data()},
-                        detail::Base64FromBinary{bytes.data() + (bytes.size() - bytes_to_pad)}};
+    // one or two bytes are left for the last characters, the rest is padding
+    if (first != last)
+    {
+        const auto bits = std::uint32_t{first[0]} << 16 |
+                          (last - first == 2 ? std::uint32_t{first[1]} << 8 : 0);
+        *out++ = alphabet[bits >> 18];
+        *out++ = alphabet[(bits >> 12) & 0x3f];
+        if (last - first == 2)
+            *out++ = alphabet[(bits >> 6) & 0x3f];
+    }
 
-    return encoded.append(bytes_to_pad, '=');
+    return encoded;
 }
 
 // C++11 standard 3.9.1/1: Plain char, signed char, and unsigned char are three distinct types
@@ -85,30 +227,87 @@ inline std::string encodeBase64(const char *first, std::size_t size)
 inline std::string encodeBase64(const std::string &x) { return encodeBase64(x.data(), x.size()); }
 
 // Encode any sufficiently trivial object to Base64.
-template <typename T> std::string encodeBase64Bytewise(const T &x)
+template <typename T>
+std::string encodeBase64Bytewise(const T &x,
+                                 const Base64Alphabet alphabet = Base64Alphabet::Standard)
 {
 #if not defined __GNUC__ or __GNUC__ > 4
     static_assert(std::is_trivially_copyable<T>::value, "requires a trivially copyable type");
 #endif
 
-    return encodeBase64(reinterpret_cast<const unsigned char *>(&x), sizeof(T));
+    return encodeBase64(reinterpret_cast<const unsigned char *>(&x), sizeof(T), alphabet);
 }
 
 // Decoding Implementation
 
-// Decodes into a chunk of memory that is at least as large as the input.
-template <typename OutputIter> void decodeBase64(const std::string &encoded, OutputIter out)
+// Decodes at most max_size bytes of the characters without copying them, returns the number
+// of decoded bytes. Blocks of 16 characters are decoded with SSSE3 if the build targets it, the
+// rest looks up the six bits of each character in a table. Accepts both alphabets.
+template <typename OutputIter>
+std::size_t decodeBase64(const char *first, const char *last, OutputIter out, std::size_t max_size)
 {
-    auto unpadded = encoded;
+    const auto num_padded = static_cast<std::size_t>(std::count(first, last, '='));
+    const auto decoded_size = static_cast<std::size_t>(last - first) * 6 / 8 - num_padded;
+    const auto size = std::min(decoded_size, max_size);
+
+    const auto &table = detail::Base64DecodeTable::GetInstance();
+    const auto throw_invalid = [] {
+        throw boost::archive::iterators::dataflow_exception(
+            boost::archive::iterators::dataflow_exception::invalid_base64_character);
+    };
+
+    std::size_t written = 0;
+#if defined(__SSSE3__)
+    // a block with padding or invalid characters is left to the table below
+    for (unsigned char bytes[16]; last - first >= 16 && written + 12 <= size;
+         first += 16, written += 12)
+    {
+        if (!detail::decodeBase64Block(first, bytes))
+            break;
+        out = std::copy(bytes, bytes + 12, out);
+    }
+#endif
 
-    const auto num_padded = std::count(begin(encoded), end(encoded), '=');
-    std::replace(begin(unpadded), end(unpadded), '=', 'A'); // A_64 == \0
+    // four characters make three bytes
+    for (; last - first >= 4 && written + 3 <= size; first += 4, written += 3)
+    {
+        const std::uint32_t values[] = {
+            table[first[0]], table[first[1]], table[first[2]], table[first[3]]};
+        // valid values fit into six bits
+        if ((values[0] | values[1] | values[2] | values[3]) & 0xc0)
+            throw_invalid();
+
+        const auto bits = values[0] << 18 | values[1] << 12 | values[2] << 6 | values[3];
+        *out++ = static_cast<char>(bits >> 16);
+        *out++ = static_cast<char>((bits >> 8) & 0xff);
+        *out++ = static_cast<char>(bits & 0xff);
+    }
 
-    std::string decoded{detail::BinaryFromBase64{begin(unpadded)},
-                        detail::BinaryFromBase64{begin(unpadded) + unpadded.length()}};
+    // the remaining bytes bit by bit
+    std::uint32_t bits = 0;
+    std::size_t num_bits = 0;
+    for (; first != last && written < size; ++first)
+    {
+        const auto value = table[*first];
+        if (value == detail::Base64DecodeTable::INVALID)
+            throw_invalid();
+
+        bits = (bits << 6) | value;
+        num_bits += 6;
+        if (num_bits >= 8)
+        {
+            num_bits -= 8;
+            *out++ = static_cast<char>((bits >> num_bits) & 0xff);
+            ++written;
+        }
+    }
+    return written;
+}
 
-    decoded.erase(end(decoded) - num_padded, end(decoded));
-    std::copy(begin(decoded), end(decoded), out);
+// Decodes into a chunk of memory that is at least as large as the input.
+template <typename OutputIter> void decodeBase64(const std::string &encoded, OutputIter out)
+{
+    decodeBase64(encoded.data(), encoded.data() + encoded.size(), out, encoded.size());
 }
 
 // Convenience specialization, filling string instead of byte-dumping into it.
@@ -130,7 +329,10 @@ template <typename T> T decodeBase64Bytewise(const std::string &encoded)
 
     T x;
 
-    decodeBase64(encoded, reinterpret_cast<unsigned char *>(&x));
+    decodeBase64(encoded.data(),
+                 encoded.data() + encoded.size(),
+                 reinterpret_cast<unsigned char *>(&x),
+                 sizeof(T));
 
     return x;
 }
@@ -0,0 +1,85 @@
+#ifndef OSRM_ENGINE_CONDITIONAL_TURNS_HPP
+#define OSRM_ENGINE_CONDITIONAL_TURNS_HPP
+
+#include "extractor/conditional_turn_masks.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Conditional turn restrictions of an MLD dataset that apply at the departure time of a query.
+ *
+ * The cells were customized without the restrictions, so the search doesn't take the shortcuts
+ * of a cell that contains a restricted turn and searches the cells of the levels below it
+ * instead, down to the edges of the graph. Restricted turns are skipped when their edge is
+ * relaxed.
+ */
+class ActiveConditionalTurns
+{
+  public:
+    // minute_of_week counts from Monday 00:00 local time
+    ActiveConditionalTurns(const extractor::ConditionalTurnMasksView &masks,
+                           const partition::MultiLevelPartitionView &partition,
+                           const std::uint32_t minute_of_week);
+
+    bool Empty() const { return turns.empty(); }
+
+    bool IsRestricted(const EdgeID turn) const
+    {
+        return std::binary_search(turns.begin(), turns.end(), turn);
+    }
+
+    // Highest level up to the given one whose cell of the node has no restricted turn, the
+    // cells of a level contain the ones of the levels below
+    LevelID GetUnrestrictedLevel(const partition::MultiLevelPartitionView &partition,
+                                 const NodeID node,
+                                 const LevelID level) const
+    {
+        for (LevelID cell_level = 1; cell_level <= level && cell_level < restricted_cells.size();
+             ++cell_level)
+        {
+            const auto &cells = restricted_cells[cell_level];
+            if (std::binary_search(cells.begin(), cells.end(), partition.GetCell(cell_level, node)))
+                return cell_level - 1;
+        }
+        return level;
+    }
+
+  private:
+    std::vector<EdgeID> turns;
+    // sorted cells of each level that contain a restricted turn, level 0 has none
+    std::vector<std::vector<CellID>> restricted_cells;
+};
+
+/**
+ * Makes the restricted turns the ones of the queries run by the calling thread while it is in
+ * scope, see ScopedQueryDeadline. Restrictions without a restricted turn are ignored.
+ */
+class ScopedConditionalTurns
+{
+  public:
+    explicit ScopedConditionalTurns(const ActiveConditionalTurns *conditional_turns);
+    ~ScopedConditionalTurns();
+
+    ScopedConditionalTurns(const ScopedConditionalTurns &) = delete;
+    ScopedConditionalTurns &operator=(const ScopedConditionalTurns &) = delete;
+
+  private:
+    const ActiveConditionalTurns *previous;
+};
+
+// Restricted turns of the query run by the calling thread, nullptr if it has none
+const ActiveConditionalTurns *CurrentConditionalTurns();
+}
+}
+
+#endif // OSRM_ENGINE_CONDITIONAL_TURNS_HPP
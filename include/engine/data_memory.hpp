@@ -0,0 +1,51 @@
+#ifndef OSRM_ENGINE_DATA_MEMORY_HPP
+#define OSRM_ENGINE_DATA_MEMORY_HPP
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Sizes of the blocks of the datasets the engines use and the bytes of them that are in RAM.
+ * The allocators are only referenced weakly, a dataset is reported until its memory is
+ * released. Residency is measured when the metrics are read, so it follows the page cache.
+ */
+class DataMemoryMetrics
+{
+  public:
+    static DataMemoryMetrics &GetInstance();
+
+    // Reports the blocks of the copy of the dataset held by the allocator instead of the ones
+    // of the copy it replaces, and logs them
+    void Register(const std::string &dataset_name,
+                  const unsigned replica,
+                  const std::shared_ptr<datafacade::ContiguousBlockAllocator> &allocator);
+
+    // Bytes and resident bytes by dataset, copy and block in Prometheus text format
+    std::string DumpPrometheus() const;
+
+  private:
+    struct Dataset
+    {
+        std::string name;
+        unsigned replica;
+        std::weak_ptr<datafacade::ContiguousBlockAllocator> allocator;
+    };
+
+    DataMemoryMetrics() = default;
+
+    mutable std::mutex datasets_lock;
+    std::vector<Dataset> datasets;
+};
+}
+}
+
+#endif // OSRM_ENGINE_DATA_MEMORY_HPP
@@ -0,0 +1,94 @@
+#ifndef OSRM_ENGINE_DATA_WARM_UP_HPP
+#define OSRM_ENGINE_DATA_WARM_UP_HPP
+
+#include "engine/approach.hpp"
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include "storage/shared_datatype.hpp"
+
+#include "util/mmap_file.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <random>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Blocks that nearly every query reads from: the search graphs, the branches of the r-tree
+// with the segments it points to, and the cell storage and overlay of MLD
+const constexpr storage::DataLayout::BlockID WARM_UP_BLOCKS[] = {
+    storage::DataLayout::CH_GRAPH_NODE_LIST,
+    storage::DataLayout::CH_GRAPH_EDGE_LIST,
+    storage::DataLayout::CH_COMPRESSED_GRAPH_OFFSETS,
+    storage::DataLayout::CH_COMPRESSED_GRAPH_EDGES,
+    storage::DataLayout::CCH_GRAPH_NODE_LIST,
+    storage::DataLayout::CCH_GRAPH_EDGE_LIST,
+    storage::DataLayout::MLD_PARTITION,
+    storage::DataLayout::MLD_CELL_TO_CHILDREN,
+    storage::DataLayout::MLD_CELL_WEIGHTS,
+    storage::DataLayout::MLD_CELL_DURATIONS,
+    storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+    storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+    storage::DataLayout::MLD_CELLS,
+    storage::DataLayout::MLD_GRAPH_NODE_LIST,
+    storage::DataLayout::MLD_GRAPH_EDGE_LIST,
+    storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET,
+    storage::DataLayout::MLD_OVERLAY_NODES,
+    storage::DataLayout::MLD_OVERLAY_FORWARD_OFFSETS,
+    storage::DataLayout::MLD_OVERLAY_FORWARD_ARCS,
+    storage::DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS,
+    storage::DataLayout::MLD_OVERLAY_BACKWARD_ARCS,
+    storage::DataLayout::R_SEARCH_TREE,
+    storage::DataLayout::R_SEARCH_TREE_LEVELS,
+    storage::DataLayout::COORDINATE_LIST,
+    storage::DataLayout::EDGE_BASED_NODE_LIST,
+    storage::DataLayout::COMPONENT_ID_LIST,
+    storage::DataLayout::GEOMETRIES_INDEX,
+    storage::DataLayout::GEOMETRIES_NODE_LIST};
+
+// Maps every page of the warm-up blocks into the page tables of the process, so the first
+// queries on a new dataset don't each stall on faults for the pages they touch. Returns the
+// number of bytes touched.
+inline std::uint64_t TouchWarmUpBlocks(datafacade::ContiguousBlockAllocator &allocator)
+{
+    const auto &layout = allocator.GetLayout();
+    std::uint64_t size = 0;
+    for (const auto id : WARM_UP_BLOCKS)
+    {
+        const auto block_size = layout.GetBlockSize(id);
+        if (block_size == 0)
+            continue;
+
+        const auto block = layout.GetBlockPtr<char>(allocator.GetMemory(), id);
+        util::adviseMappedFile(block, block_size, util::MappedFileAccess::Prefault);
+        size += block_size;
+    }
+    return size;
+}
+
+// Snaps num_queries coordinates of random nodes, which reads the r-tree and the segments
+// around them like the first requests would. The sequence of nodes is the same for every
+// dataset of the same size.
+template <typename FacadeT>
+void RunWarmUpQueries(const FacadeT &facade,
+                      const std::uint64_t num_coordinates,
+                      const unsigned num_queries)
+{
+    if (num_coordinates == 0)
+        return;
+
+    std::mt19937 generator(num_coordinates);
+    std::uniform_int_distribution<std::uint64_t> nodes(0, num_coordinates - 1);
+    for (unsigned query = 0; query < num_queries; ++query)
+    {
+        const auto coordinate = facade.GetCoordinateOfNode(static_cast<NodeID>(nodes(generator)));
+        facade.NearestPhantomNodes(coordinate, 1, Approach::UNRESTRICTED);
+    }
+}
+}
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef OSRM_ENGINE_DATA_WATCHDOG_HPP
 #define OSRM_ENGINE_DATA_WATCHDOG_HPP
 
+#include "engine/data_memory.hpp"
+#include "engine/data_warm_up.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/datafacade/shared_memory_allocator.hpp"
 
@@ -8,13 +10,25 @@
 #include "storage/shared_memory.hpp"
 #include "storage/shared_monitor.hpp"
 
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/numa.hpp"
+
 #include <boost/interprocess/sync/named_upgradable_mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -24,22 +38,55 @@ namespace engine
 // This class monitors the shared memory region that contains the pointers to
 // the data and layout regions that should be used. This region is updated
 // once a new dataset arrives.
+//
+// If osrm-datastore placed a copy of the data on every NUMA node, there is a facade per copy
+// and each thread gets the one of the node it runs on.
+//
+// Every thread caches the facade it uses with a reference count of its own, so the queries
+// don't all count their references on the same cache line. The caches are checked against the
+// generation of the facades on each Get() and the watchdog clears all of them when the data
+// is swapped, so threads that stay idle don't keep osrm-datastore waiting for the old region.
+//
+// With warm_up_data the hot blocks of a new region are paged in and warm_up_queries snapping
+// queries are run on its facades before they replace the current ones. This happens on the
+// watchdog thread after the region was attached and outside the lock of the monitor, so the
+// current facades keep serving and osrm-datastore isn't blocked meanwhile.
 template <typename AlgorithmT> class DataWatchdog final
 {
     using mutex_type = typename storage::SharedMonitor<storage::SharedDataTimestamp>::mutex_type;
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
+    using Facades = std::vector<std::shared_ptr<const FacadeT>>;
+    using Allocators = std::vector<std::shared_ptr<datafacade::ContiguousBlockAllocator>>;
+
+    // Facade cached by a thread, only contended while the watchdog clears it
+    struct ThreadFacade
+    {
+        std::mutex lock;
+        // 0 if empty, generations start at 1
+        std::uint64_t generation = 0;
+        std::size_t replica = 0;
+        std::shared_ptr<const FacadeT> facade;
+        // keeps the caches of the threads apart
+        char padding[64];
+    };
 
   public:
-    DataWatchdog() : active(true), timestamp(0)
+    DataWatchdog(const std::string &dataset_name = "",
+                 const bool warm_up_data = false,
+                 const unsigned warm_up_queries = 0)
+        : id(NextID()), dataset_name(dataset_name), barrier(dataset_name), active(true),
+          timestamp(0), generation(1), nodes(util::GetNUMANodes()), warm_up_data(warm_up_data),
+          warm_up_queries(warm_up_queries)
     {
         // create the initial facade before launching the watchdog thread
+        Allocators allocators;
         {
             boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-            facade = std::make_shared<const FacadeT>(
-                std::make_unique<datafacade::SharedMemoryAllocator>(barrier.data().region));
+            allocators = AttachRegion(barrier.data().region, barrier.data().num_replicas);
             timestamp = barrier.data().timestamp;
         }
+        facades = MakeFacades(allocators);
 
         watcher = std::thread(&DataWatchdog::Run, this);
     }
@@ -51,39 +98,171 @@ template <typename AlgorithmT> class DataWatchdog final
         watcher.join();
     }
 
-    std::shared_ptr<const FacadeT> Get() const { return facade; }
+    std::shared_ptr<const FacadeT> Get() const
+    {
+        const auto current_generation = generation.load(std::memory_order_acquire);
+        auto &cache = GetThreadFacade();
+        const auto replica = nodes.size() > 1 ? GetReplica() : 0;
+
+        std::lock_guard<std::mutex> guard(cache.lock);
+        if (cache.generation != current_generation || cache.replica != replica)
+        {
+            const auto current_facades = std::atomic_load(&facades);
+            auto shared_facade =
+                (*current_facades)[replica < current_facades->size() ? replica : 0];
+            // the reference count of the thread holds one reference to the shared facade
+            const auto *facade_ptr = shared_facade.get();
+            cache.facade = std::shared_ptr<const FacadeT>(
+                facade_ptr, [shared_facade = std::move(shared_facade)](const FacadeT *) {});
+            cache.generation = current_generation;
+            cache.replica = replica;
+        }
+        return cache.facade;
+    }
 
   private:
-    void Run()
+    static std::uint64_t NextID()
     {
-        while (active)
+        static std::atomic<std::uint64_t> next_id{0};
+        return next_id++;
+    }
+
+    std::size_t GetReplica() const
+    {
+        const auto node = std::find(nodes.begin(), nodes.end(), util::GetCurrentNUMANode());
+        return static_cast<std::size_t>(std::distance(nodes.begin(), node));
+    }
+
+    ThreadFacade &GetThreadFacade() const
+    {
+        // the caches of the thread by the id of their watchdog, ids are never reused
+        thread_local std::vector<std::pair<std::uint64_t, ThreadFacade *>> thread_facades;
+        const auto cached =
+            std::find_if(thread_facades.begin(), thread_facades.end(), [this](const auto &entry) {
+                return entry.first == id;
+            });
+        if (cached != thread_facades.end())
         {
-            boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
+            return *cached->second;
+        }
+
+        std::lock_guard<std::mutex> guard(thread_facades_lock);
+        thread_facades_storage.push_back(std::make_unique<ThreadFacade>());
+        thread_facades.emplace_back(id, thread_facades_storage.back().get());
+        return *thread_facades_storage.back();
+    }
+
+    // Drops the facades cached by the threads, they are recreated on their next Get()
+    void ClearThreadFacades()
+    {
+        std::lock_guard<std::mutex> guard(thread_facades_lock);
+        for (const auto &cache : thread_facades_storage)
+        {
+            // released after unlocking the cache, it might be the last reference
+            std::shared_ptr<const FacadeT> facade;
+            {
+                std::lock_guard<std::mutex> cache_guard(cache->lock);
+                cache->generation = 0;
+                facade = std::move(cache->facade);
+            }
+        }
+    }
+
+    // Maps every copy of the region, has to be called with the lock of the monitor held so
+    // osrm-datastore can't remove the region before it is mapped
+    Allocators AttachRegion(const storage::SharedDataType region,
+                            const unsigned num_replicas) const
+    {
+        Allocators allocators;
+        for (const auto replica : util::irange(0u, std::max(num_replicas, 1u)))
+        {
+            allocators.push_back(
+                std::make_shared<datafacade::SharedMemoryAllocator>(
+                    region, replica, dataset_name));
+        }
+        return allocators;
+    }
+
+    std::shared_ptr<const Facades> MakeFacades(const Allocators &allocators) const
+    {
+        auto new_facades = std::make_shared<Facades>();
+        for (const auto replica : util::irange<std::size_t>(0, allocators.size()))
+        {
+            const auto &allocator = allocators[replica];
+            if (warm_up_data)
+            {
+                const auto size = TouchWarmUpBlocks(*allocator);
+                util::Log(logDEBUG) << "warmed up " << size << " bytes of the data";
+            }
+            DataMemoryMetrics::GetInstance().Register(dataset_name, replica, allocator);
 
-            while (active && timestamp == barrier.data().timestamp)
+            auto facade = std::make_shared<const FacadeT>(allocator);
+            if (warm_up_data)
             {
-                barrier.wait(current_region_lock);
+                RunWarmUpQueries(*facade,
+                                 allocator->GetLayout().GetBlockEntries(
+                                     storage::DataLayout::COORDINATE_LIST),
+                                 warm_up_queries);
             }
+            new_facades->push_back(std::move(facade));
+        }
+        return new_facades;
+    }
 
-            if (timestamp != barrier.data().timestamp)
+    void Run()
+    {
+        while (active)
+        {
+            storage::SharedDataType region;
+            unsigned region_timestamp;
+            Allocators allocators;
             {
-                auto region = barrier.data().region;
-                facade = std::make_shared<const FacadeT>(
-                    std::make_unique<datafacade::SharedMemoryAllocator>(region));
-                timestamp = barrier.data().timestamp;
-                util::Log() << "updated facade to region " << region << " with timestamp "
-                            << timestamp;
+                boost::interprocess::scoped_lock<mutex_type> current_region_lock(
+                    barrier.get_mutex());
+
+                while (active && timestamp == barrier.data().timestamp)
+                {
+                    barrier.wait(current_region_lock);
+                }
+
+                if (timestamp == barrier.data().timestamp)
+                {
+                    continue;
+                }
+
+                region = barrier.data().region;
+                region_timestamp = barrier.data().timestamp;
+                allocators = AttachRegion(region, barrier.data().num_replicas);
             }
+
+            // the current facades are used until the new ones are warmed up
+            std::atomic_store(&facades, MakeFacades(allocators));
+            generation.fetch_add(1, std::memory_order_release);
+            ClearThreadFacades();
+            timestamp = region_timestamp;
+            util::Log() << "updated facade to region " << region << " with timestamp "
+                        << timestamp;
         }
 
         util::Log() << "DataWatchdog thread stopped";
     }
 
+    const std::uint64_t id;
+    const std::string dataset_name;
     storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
     std::thread watcher;
-    bool active;
+    std::atomic<bool> active;
     unsigned timestamp;
-    std::shared_ptr<const FacadeT> facade;
+    // bumped every time the facades are replaced
+    std::atomic<std::uint64_t> generation;
+    // the i-th facade maps the copy of the data on the i-th node
+    const std::vector<unsigned> nodes;
+    std::shared_ptr<const Facades> facades;
+    const bool warm_up_data;
+    const unsigned warm_up_queries;
+
+    mutable std::mutex thread_facades_lock;
+    mutable std::vector<std::unique_ptr<ThreadFacade>> thread_facades_storage;
 };
 }
 }
@@ -1,7 +1,12 @@
 #ifndef OSRM_ENGINE_DATAFACADE_ALGORITHM_DATAFACADE_HPP
 #define OSRM_ENGINE_DATAFACADE_ALGORITHM_DATAFACADE_HPP
 
+#include "contractor/compressed_search_graph.hpp"
+#include "contractor/downward_sweep_graph.hpp"
+#include "contractor/hub_labels.hpp"
 #include "contractor/query_edge.hpp"
+#include "customizer/overlay_hierarchy.hpp"
+#include "extractor/conditional_turn_masks.hpp"
 #include "extractor/edge_based_edge.hpp"
 #include "engine/algorithm.hpp"
 
@@ -9,6 +14,7 @@
 #include "partition/multi_level_partition.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/landmarks.hpp"
 
 namespace osrm
 {
@@ -20,6 +26,7 @@ namespace datafacade
 // Namespace local aliases for algorithms
 using CH = routing_algorithms::ch::Algorithm;
 using CoreCH = routing_algorithms::corech::Algorithm;
+using CCH = routing_algorithms::cch::Algorithm;
 using MLD = routing_algorithms::mld::Algorithm;
 
 using EdgeRange = util::range<EdgeID>;
@@ -59,6 +66,15 @@ template <> class AlgorithmDataFacade<CH>
     virtual EdgeID FindSmallestEdge(const NodeID from,
                                     const NodeID to,
                                     const std::function<bool(EdgeData)> filter) const = 0;
+
+    // downward edges in sweep order, built on first use
+    virtual const contractor::DownwardSweepGraph &GetDownwardSweepGraph() const = 0;
+
+    // encoded copy of the search graph without edge ids, empty if the dataset has none
+    virtual const contractor::CompressedSearchGraphView &GetCompressedSearchGraph() const = 0;
+
+    // hub labels of the search graph, empty if the dataset has none
+    virtual const contractor::HubLabelsView &GetHubLabels() const = 0;
 };
 
 template <> class AlgorithmDataFacade<CoreCH>
@@ -67,6 +83,9 @@ template <> class AlgorithmDataFacade<CoreCH>
     using EdgeData = contractor::QueryEdge::EdgeData;
 
     virtual bool IsCoreNode(const NodeID id) const = 0;
+
+    // Landmarks for goal directed searches in the core, empty if the dataset has none
+    virtual const util::LandmarksView &GetLandmarks() const = 0;
 };
 
 template <> class AlgorithmDataFacade<MLD>
@@ -95,6 +114,16 @@ template <> class AlgorithmDataFacade<MLD>
 
     virtual const partition::CellStorageView &GetCellStorage() const = 0;
 
+    // Hierarchy of the top level overlay graph, empty if the dataset has none for the metric
+    virtual const customizer::OverlayHierarchyView &GetOverlayHierarchy() const = 0;
+
+    // Landmarks for goal directed searches, empty if the dataset has none for the metric
+    virtual const util::LandmarksView &GetLandmarks() const = 0;
+
+    // Conditional turn restrictions evaluated at the departure time of a query, empty if the
+    // dataset applied them to its weights
+    virtual const extractor::ConditionalTurnMasksView &GetConditionalTurnMasks() const = 0;
+
     virtual EdgeRange GetBorderEdgeRange(const LevelID level, const NodeID node) const = 0;
 
     // searches for a specific edge
@@ -10,7 +10,9 @@
 #include "engine/geospatial_query.hpp"
 
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/overlay_hierarchy.hpp"
 
+#include "extractor/conditional_turn_masks.hpp"
 #include "extractor/datasources.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
@@ -21,6 +23,7 @@
 #include "extractor/segment_data_container.hpp"
 #include "extractor/turn_data_container.hpp"
 
+#include "contractor/downward_sweep_graph.hpp"
 #include "contractor/query_graph.hpp"
 
 #include "partition/cell_storage.hpp"
@@ -28,6 +31,8 @@
 
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory_ownership.hpp"
+#include "storage/storage_config.hpp"
+#include "storage/view_factory.hpp"
 
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
@@ -35,6 +40,7 @@
 #include "util/guidance/entry_class.hpp"
 #include "util/guidance/turn_bearing.hpp"
 #include "util/guidance/turn_lanes.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 #include "util/name_table.hpp"
 #include "util/packed_vector.hpp"
@@ -51,6 +57,7 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -73,29 +80,54 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     using GraphEdge = QueryGraph::EdgeArrayEntry;
 
     QueryGraph m_query_graph;
+    // encoded targets, weights and directions of the query graph, empty if the dataset has none
+    contractor::CompressedSearchGraphView m_compressed_graph;
+    // labels of the query graph, empty if the dataset has none
+    contractor::HubLabelsView m_hub_labels;
+
+    // derived from the query graph only when a one-to-all search needs it
+    mutable std::once_flag m_sweep_graph_once;
+    mutable std::unique_ptr<contractor::DownwardSweepGraph> m_sweep_graph;
 
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
+    // blocks the hierarchy is stored in, the CCH keeps its customized hierarchy next to the CH
+    storage::DataLayout::BlockID node_list_id;
+    storage::DataLayout::BlockID edge_list_id;
+
     void InitializeGraphPointer(storage::DataLayout &data_layout, char *memory_block)
     {
-        auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(
-            memory_block, storage::DataLayout::CH_GRAPH_NODE_LIST);
+        auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(memory_block, node_list_id);
 
-        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(
-            memory_block, storage::DataLayout::CH_GRAPH_EDGE_LIST);
+        auto graph_edges_ptr = data_layout.GetBlockPtr<GraphEdge>(memory_block, edge_list_id);
 
-        util::vector_view<GraphNode> node_list(
-            graph_nodes_ptr, data_layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
-        util::vector_view<GraphEdge> edge_list(
-            graph_edges_ptr, data_layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
+        util::vector_view<GraphNode> node_list(graph_nodes_ptr,
+                                               data_layout.num_entries[node_list_id]);
+        util::vector_view<GraphEdge> edge_list(graph_edges_ptr,
+                                               data_layout.num_entries[edge_list_id]);
         m_query_graph = QueryGraph(node_list, edge_list);
+
+        // only encoded and labeled from the .hsgr, not from the customized CCH
+        if (node_list_id == storage::DataLayout::CH_GRAPH_NODE_LIST &&
+            data_layout.GetBlockSize(storage::DataLayout::CH_COMPRESSED_GRAPH_OFFSETS) > 0)
+        {
+            m_compressed_graph =
+                storage::make_compressed_search_graph_view(memory_block, data_layout);
+        }
+        if (node_list_id == storage::DataLayout::CH_GRAPH_NODE_LIST &&
+            data_layout.GetBlockSize(storage::DataLayout::CH_HUB_LABEL_OFFSETS) > 0)
+        {
+            m_hub_labels = storage::make_hub_labels_view(memory_block, data_layout);
+        }
     }
 
   public:
     ContiguousInternalMemoryAlgorithmDataFacade(
-        std::shared_ptr<ContiguousBlockAllocator> allocator_)
-        : allocator(std::move(allocator_))
+        std::shared_ptr<ContiguousBlockAllocator> allocator_,
+        const storage::DataLayout::BlockID node_list_id = storage::DataLayout::CH_GRAPH_NODE_LIST,
+        const storage::DataLayout::BlockID edge_list_id = storage::DataLayout::CH_GRAPH_EDGE_LIST)
+        : allocator(std::move(allocator_)), node_list_id(node_list_id), edge_list_id(edge_list_id)
     {
         InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
     }
@@ -154,6 +186,21 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
     {
         return m_query_graph.FindSmallestEdge(from, to, filter);
     }
+
+    const contractor::DownwardSweepGraph &GetDownwardSweepGraph() const override final
+    {
+        std::call_once(m_sweep_graph_once, [this] {
+            m_sweep_graph = std::make_unique<contractor::DownwardSweepGraph>(m_query_graph);
+        });
+        return *m_sweep_graph;
+    }
+
+    const contractor::CompressedSearchGraphView &GetCompressedSearchGraph() const override final
+    {
+        return m_compressed_graph;
+    }
+
+    const contractor::HubLabelsView &GetHubLabels() const override final { return m_hub_labels; }
 };
 
 template <>
@@ -162,6 +209,7 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CoreCH>
 {
   private:
     util::vector_view<bool> m_is_core_node;
+    util::LandmarksView m_landmarks;
 
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
@@ -186,6 +234,10 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CoreCH>
     void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
     {
         InitializeCoreInformationPointer(data_layout, memory_block);
+        if (data_layout.GetBlockSize(storage::DataLayout::LANDMARK_NODES) > 0)
+        {
+            m_landmarks = storage::make_landmarks_view(memory_block, data_layout);
+        }
     }
 
     bool IsCoreNode(const NodeID id) const override final
@@ -193,6 +245,8 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CoreCH>
         BOOST_ASSERT(id < m_is_core_node.size());
         return m_is_core_node[id];
     }
+
+    const util::LandmarksView &GetLandmarks() const override final { return m_landmarks; }
 };
 
 /**
@@ -243,6 +297,8 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // available turns. Such a class id is stored with every edge.
     util::vector_view<util::guidance::EntryClass> m_entry_class_table;
 
+    util::DistanceOracleView m_distance_oracle;
+
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
@@ -287,13 +343,38 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             data_layout.GetBlockPtr<RTreeNode>(memory_block, storage::DataLayout::R_SEARCH_TREE);
         auto tree_level_sizes_ptr = data_layout.GetBlockPtr<std::uint64_t>(
             memory_block, storage::DataLayout::R_SEARCH_TREE_LEVELS);
-        m_static_rtree.reset(
-            new SharedRTree(tree_nodes_ptr,
-                            data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
-                            tree_level_sizes_ptr,
-                            data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
-                            file_index_path,
-                            m_coordinate_list));
+        const auto leaf_access = *data_layout.GetBlockPtr<storage::RTreeLeafAccess>(
+            memory_block, storage::DataLayout::R_SEARCH_TREE_LEAF_ACCESS);
+        if (data_layout.GetBlockEntries(storage::DataLayout::R_SEARCH_TREE_LEAVES) > 0)
+        {
+            util::vector_view<const RTreeLeaf> leaves(
+                data_layout.GetBlockPtr<RTreeLeaf>(memory_block,
+                                                   storage::DataLayout::R_SEARCH_TREE_LEAVES),
+                data_layout.GetBlockEntries(storage::DataLayout::R_SEARCH_TREE_LEAVES));
+            m_static_rtree.reset(
+                new SharedRTree(tree_nodes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
+                                tree_level_sizes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
+                                leaves,
+                                m_coordinate_list));
+        }
+        else
+        {
+            auto mapped_access = util::MappedFileAccess::Default;
+            if (leaf_access == storage::RTreeLeafAccess::Random)
+                mapped_access = util::MappedFileAccess::Random;
+            else if (leaf_access == storage::RTreeLeafAccess::Prefault)
+                mapped_access = util::MappedFileAccess::Prefault;
+            m_static_rtree.reset(
+                new SharedRTree(tree_nodes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
+                                tree_level_sizes_ptr,
+                                data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
+                                file_index_path,
+                                m_coordinate_list,
+                                mapped_access));
+        }
         m_geospatial_query.reset(
             new SharedGeospatialQuery(*m_static_rtree, m_coordinate_list, *this));
     }
@@ -318,71 +399,33 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     void InitializeEdgeBasedNodeDataInformationPointers(storage::DataLayout &layout,
                                                         char *memory_ptr)
     {
-        const auto via_geometry_list_ptr =
-            layout.GetBlockPtr<GeometryID>(memory_ptr, storage::DataLayout::GEOMETRY_ID_LIST);
-        util::vector_view<GeometryID> geometry_ids(
-            via_geometry_list_ptr, layout.num_entries[storage::DataLayout::GEOMETRY_ID_LIST]);
-
-        const auto name_id_list_ptr =
-            layout.GetBlockPtr<NameID>(memory_ptr, storage::DataLayout::NAME_ID_LIST);
-        util::vector_view<NameID> name_ids(name_id_list_ptr,
-                                           layout.num_entries[storage::DataLayout::NAME_ID_LIST]);
+        const auto nodes_ptr = layout.GetBlockPtr<extractor::EdgeBasedNode>(
+            memory_ptr, storage::DataLayout::EDGE_BASED_NODE_LIST);
+        util::vector_view<extractor::EdgeBasedNode> nodes(
+            nodes_ptr, layout.num_entries[storage::DataLayout::EDGE_BASED_NODE_LIST]);
 
         const auto component_id_list_ptr =
             layout.GetBlockPtr<ComponentID>(memory_ptr, storage::DataLayout::COMPONENT_ID_LIST);
         util::vector_view<ComponentID> component_ids(
             component_id_list_ptr, layout.num_entries[storage::DataLayout::COMPONENT_ID_LIST]);
 
-        const auto travel_mode_list_ptr = layout.GetBlockPtr<extractor::TravelMode>(
-            memory_ptr, storage::DataLayout::TRAVEL_MODE_LIST);
-        util::vector_view<extractor::TravelMode> travel_modes(
-            travel_mode_list_ptr, layout.num_entries[storage::DataLayout::TRAVEL_MODE_LIST]);
-
-        const auto classes_list_ptr =
-            layout.GetBlockPtr<extractor::ClassData>(memory_ptr, storage::DataLayout::CLASSES_LIST);
-        util::vector_view<extractor::ClassData> classes(
-            classes_list_ptr, layout.num_entries[storage::DataLayout::CLASSES_LIST]);
-
-        edge_based_node_data = extractor::EdgeBasedNodeDataView(std::move(geometry_ids),
-                                                                std::move(name_ids),
-                                                                std::move(component_ids),
-                                                                std::move(travel_modes),
-                                                                std::move(classes));
+        edge_based_node_data =
+            extractor::EdgeBasedNodeDataView(std::move(nodes), std::move(component_ids));
     }
 
     void InitializeEdgeInformationPointers(storage::DataLayout &layout, char *memory_ptr)
     {
-        const auto lane_data_id_ptr =
-            layout.GetBlockPtr<LaneDataID>(memory_ptr, storage::DataLayout::LANE_DATA_ID);
-        util::vector_view<LaneDataID> lane_data_ids(
-            lane_data_id_ptr, layout.num_entries[storage::DataLayout::LANE_DATA_ID]);
-
-        const auto turn_instruction_list_ptr =
-            layout.GetBlockPtr<extractor::guidance::TurnInstruction>(
-                memory_ptr, storage::DataLayout::TURN_INSTRUCTION);
-        util::vector_view<extractor::guidance::TurnInstruction> turn_instructions(
-            turn_instruction_list_ptr, layout.num_entries[storage::DataLayout::TURN_INSTRUCTION]);
+        const auto turn_data_id_ptr =
+            layout.GetBlockPtr<std::uint32_t>(memory_ptr, storage::DataLayout::TURN_DATA_ID);
+        util::vector_view<std::uint32_t> turn_data_ids(
+            turn_data_id_ptr, layout.num_entries[storage::DataLayout::TURN_DATA_ID]);
 
-        const auto entry_class_id_list_ptr =
-            layout.GetBlockPtr<EntryClassID>(memory_ptr, storage::DataLayout::ENTRY_CLASSID);
-        util::vector_view<EntryClassID> entry_class_ids(
-            entry_class_id_list_ptr, layout.num_entries[storage::DataLayout::ENTRY_CLASSID]);
+        const auto turn_data_ptr =
+            layout.GetBlockPtr<extractor::TurnData>(memory_ptr, storage::DataLayout::TURN_DATA);
+        util::vector_view<extractor::TurnData> turn_data_list(
+            turn_data_ptr, layout.num_entries[storage::DataLayout::TURN_DATA]);
 
-        const auto pre_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing>(
-            memory_ptr, storage::DataLayout::PRE_TURN_BEARING);
-        util::vector_view<util::guidance::TurnBearing> pre_turn_bearings(
-            pre_turn_bearing_ptr, layout.num_entries[storage::DataLayout::PRE_TURN_BEARING]);
-
-        const auto post_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing>(
-            memory_ptr, storage::DataLayout::POST_TURN_BEARING);
-        util::vector_view<util::guidance::TurnBearing> post_turn_bearings(
-            post_turn_bearing_ptr, layout.num_entries[storage::DataLayout::POST_TURN_BEARING]);
-
-        turn_data = extractor::TurnDataView(std::move(turn_instructions),
-                                            std::move(lane_data_ids),
-                                            std::move(entry_class_ids),
-                                            std::move(pre_turn_bearings),
-                                            std::move(post_turn_bearings));
+        turn_data = extractor::TurnDataView(std::move(turn_data_ids), std::move(turn_data_list));
     }
 
     void InitializeNamePointers(storage::DataLayout &data_layout, char *memory_block)
@@ -499,9 +542,9 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     void InitializeIntersectionClassPointers(storage::DataLayout &data_layout, char *memory_block)
     {
-        auto bearing_class_id_ptr = data_layout.GetBlockPtr<BearingClassID>(
+        auto bearing_class_id_ptr = data_layout.GetBlockPtr<std::uint8_t>(
             memory_block, storage::DataLayout::BEARING_CLASSID);
-        util::vector_view<BearingClassID> bearing_class_id(
+        util::vector_view<std::uint8_t> bearing_class_id(
             bearing_class_id_ptr, data_layout.num_entries[storage::DataLayout::BEARING_CLASSID]);
 
         auto bearing_values_ptr = data_layout.GetBlockPtr<DiscreteBearing>(
@@ -531,6 +574,14 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         m_entry_class_table = std::move(entry_class_table);
     }
 
+    void InitializeDistanceOraclePointers(storage::DataLayout &data_layout, char *memory_block)
+    {
+        if (data_layout.GetBlockSize(storage::DataLayout::DISTANCE_ORACLE_REPRESENTATIVES) > 0)
+        {
+            m_distance_oracle = storage::make_distance_oracle_view(memory_block, data_layout);
+        }
+    }
+
     void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
     {
         InitializeChecksumPointer(data_layout, memory_block);
@@ -545,6 +596,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         InitializeProfilePropertiesPointer(data_layout, memory_block);
         InitializeRTreePointers(data_layout, memory_block);
         InitializeIntersectionClassPointers(data_layout, memory_block);
+        InitializeDistanceOraclePointers(data_layout, memory_block);
     }
 
   public:
@@ -567,63 +619,48 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         return m_osmnodeid_list[id];
     }
 
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const override final
+    NodeForwardRange GetUncompressedForwardGeometry(const EdgeID id) const override final
     {
-
-        auto range = segment_data.GetForwardGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        return segment_data.GetForwardGeometry(id);
     }
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const override final
+    NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        return segment_data.GetReverseGeometry(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedForwardDurations(const EdgeID id) const override final
+    DurationForwardRange GetUncompressedForwardDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetForwardDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedReverseDurations(const EdgeID id) const override final
+    DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetReverseDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedForwardWeights(const EdgeID id) const override final
+    WeightForwardRange GetUncompressedForwardWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetForwardWeights(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedReverseWeights(const EdgeID id) const override final
+    WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetReverseWeights(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
-    GetUncompressedForwardDatasources(const EdgeID id) const override final
+    DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        return segment_data.GetForwardDatasources(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
-    GetUncompressedReverseDatasources(const EdgeID id) const override final
+    DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        return segment_data.GetReverseDatasources(id);
     }
 
     virtual TurnPenalty GetWeightPenaltyForEdgeID(const unsigned id) const override final
@@ -772,6 +809,19 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, bearing, bearing_range, approach);
     }
 
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &max_distances,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const std::vector<boost::optional<Approach>> &approaches) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesWithAlternativeFromBigComponent(
+            input_coordinates, max_distances, bearings, approaches);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
     GeometryID GetGeometryIndex(const NodeID id) const override final
@@ -908,6 +958,13 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     {
         return m_profile_properties->left_hand_driving;
     }
+
+    bool HasGuidanceData() const override final { return !m_profile_properties->routing_only; }
+
+    const util::DistanceOracleView &GetDistanceOracle() const override final
+    {
+        return m_distance_oracle;
+    }
 };
 
 template <typename AlgorithmT> class ContiguousInternalMemoryDataFacade;
@@ -924,6 +981,29 @@ class ContiguousInternalMemoryDataFacade<CH>
 
     {
     }
+
+  protected:
+    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
+                                       const storage::DataLayout::BlockID node_list_id,
+                                       const storage::DataLayout::BlockID edge_list_id)
+        : ContiguousInternalMemoryDataFacadeBase(allocator),
+          ContiguousInternalMemoryAlgorithmDataFacade<CH>(allocator, node_list_id, edge_list_id)
+
+    {
+    }
+};
+
+// The customized CCH is a hierarchy in the format of the CH, only loaded from other blocks
+template <>
+class ContiguousInternalMemoryDataFacade<CCH> final : public ContiguousInternalMemoryDataFacade<CH>
+{
+  public:
+    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator)
+        : ContiguousInternalMemoryDataFacade<CH>(allocator,
+                                                 storage::DataLayout::CCH_GRAPH_NODE_LIST,
+                                                 storage::DataLayout::CCH_GRAPH_EDGE_LIST)
+    {
+    }
 };
 
 template <>
@@ -945,19 +1025,27 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
     // MLD data
     partition::MultiLevelPartitionView mld_partition;
     partition::CellStorageView mld_cell_storage;
+    customizer::OverlayHierarchyView mld_overlay_hierarchy;
+    util::LandmarksView mld_landmarks;
+    extractor::ConditionalTurnMasksView mld_conditional_turn_masks;
     using QueryGraph = customizer::MultiLevelEdgeBasedGraphView;
     using GraphNode = QueryGraph::NodeArrayEntry;
     using GraphEdge = QueryGraph::EdgeArrayEntry;
 
     QueryGraph query_graph;
+    std::vector<std::string> metric_names;
 
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers(storage::DataLayout &data_layout,
+                                    char *memory_block,
+                                    const std::size_t metric)
     {
-        InitializeMLDDataPointers(data_layout, memory_block);
-        InitializeGraphPointer(data_layout, memory_block);
+        InitializeMLDDataPointers(data_layout, memory_block, metric);
+        InitializeGraphPointer(data_layout, memory_block, metric);
     }
 
-    void InitializeMLDDataPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeMLDDataPointers(storage::DataLayout &data_layout,
+                                   char *memory_block,
+                                   const std::size_t metric)
     {
         if (data_layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0)
         {
@@ -1001,6 +1089,8 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
                 memory_block, storage::DataLayout::MLD_CELLS);
             auto mld_cell_level_offsets_ptr = data_layout.GetBlockPtr<std::uint64_t>(
                 memory_block, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
+            auto mld_cell_metric_names_ptr = data_layout.GetBlockPtr<char>(
+                memory_block, storage::DataLayout::MLD_CELL_METRIC_NAMES);
 
             auto weight_entries_count =
                 data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
@@ -1013,6 +1103,8 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
             auto cells_entries_counts = data_layout.GetBlockEntries(storage::DataLayout::MLD_CELLS);
             auto cell_level_offsets_entries_count =
                 data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
+            auto cell_metric_names_entries_count =
+                data_layout.GetBlockEntries(storage::DataLayout::MLD_CELL_METRIC_NAMES);
 
             BOOST_ASSERT(weight_entries_count == duration_entries_count);
 
@@ -1027,16 +1119,42 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
                                                                           cells_entries_counts);
             util::vector_view<std::uint64_t> level_offsets(mld_cell_level_offsets_ptr,
                                                            cell_level_offsets_entries_count);
+            util::vector_view<char> names(mld_cell_metric_names_ptr,
+                                          cell_metric_names_entries_count);
+
+            const partition::CellStorageView all_metrics{std::move(weights),
+                                                         std::move(durations),
+                                                         std::move(source_boundary),
+                                                         std::move(destination_boundary),
+                                                         std::move(cells),
+                                                         std::move(level_offsets),
+                                                         std::move(names)};
+            // the facade only sees the values of its own metric
+            metric_names = all_metrics.GetMetricNames();
+            mld_cell_storage = all_metrics.GetMetricView(metric);
+        }
 
-            mld_cell_storage = partition::CellStorageView{std::move(weights),
-                                                          std::move(durations),
-                                                          std::move(source_boundary),
-                                                          std::move(destination_boundary),
-                                                          std::move(cells),
-                                                          std::move(level_offsets)};
+        // the hierarchy is contracted from the default metric only
+        if (metric == 0 && data_layout.GetBlockSize(storage::DataLayout::MLD_OVERLAY_NODES) > 0)
+        {
+            mld_overlay_hierarchy = storage::make_overlay_hierarchy_view(memory_block, data_layout);
+        }
+
+        // so are the landmarks, their bounds might overestimate the weights of other metrics
+        if (metric == 0 && data_layout.GetBlockSize(storage::DataLayout::LANDMARK_NODES) > 0)
+        {
+            mld_landmarks = storage::make_landmarks_view(memory_block, data_layout);
+        }
+
+        if (data_layout.GetBlockSize(storage::DataLayout::CONDITIONAL_TURN_IDS) > 0)
+        {
+            mld_conditional_turn_masks =
+                storage::make_conditional_turn_masks_view(memory_block, data_layout);
         }
     }
-    void InitializeGraphPointer(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeGraphPointer(storage::DataLayout &data_layout,
+                                char *memory_block,
+                                const std::size_t metric)
     {
         auto graph_nodes_ptr = data_layout.GetBlockPtr<GraphNode>(
             memory_block, storage::DataLayout::MLD_GRAPH_NODE_LIST);
@@ -1049,8 +1167,11 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
         util::vector_view<GraphNode> node_list(
             graph_nodes_ptr, data_layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_LIST]);
-        util::vector_view<GraphEdge> edge_list(
-            graph_edges_ptr, data_layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
+        // the edges of all metrics share the node list, see MultiLevelGraph::AppendMetric
+        const auto num_edges = node_list.empty() ? 0 : node_list.back().first_edge;
+        BOOST_ASSERT((metric + 1) * num_edges <=
+                     data_layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
+        util::vector_view<GraphEdge> edge_list(graph_edges_ptr + metric * num_edges, num_edges);
         util::vector_view<QueryGraph::EdgeOffset> node_to_offset(
             graph_node_to_offset_ptr,
             data_layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
@@ -1064,10 +1185,10 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
   public:
     ContiguousInternalMemoryAlgorithmDataFacade(
-        std::shared_ptr<ContiguousBlockAllocator> allocator_)
+        std::shared_ptr<ContiguousBlockAllocator> allocator_, const std::size_t metric = 0)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory(), metric);
     }
 
     const partition::MultiLevelPartitionView &GetMultiLevelPartition() const override
@@ -1075,8 +1196,23 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
         return mld_partition;
     }
 
+    // Names of the metrics of the dataset, empty if it only has the default one
+    const std::vector<std::string> &GetMetricNames() const { return metric_names; }
+
     const partition::CellStorageView &GetCellStorage() const override { return mld_cell_storage; }
 
+    const customizer::OverlayHierarchyView &GetOverlayHierarchy() const override
+    {
+        return mld_overlay_hierarchy;
+    }
+
+    const util::LandmarksView &GetLandmarks() const override { return mld_landmarks; }
+
+    const extractor::ConditionalTurnMasksView &GetConditionalTurnMasks() const override
+    {
+        return mld_conditional_turn_masks;
+    }
+
     // search graph access
     unsigned GetNumberOfNodes() const override final { return query_graph.GetNumberOfNodes(); }
 
@@ -1121,12 +1257,44 @@ class ContiguousInternalMemoryDataFacade<MLD> final
       public ContiguousInternalMemoryAlgorithmDataFacade<MLD>
 {
   private:
+    // facades of the other metrics, only set on the facade of the default metric
+    std::vector<std::shared_ptr<const ContiguousInternalMemoryDataFacade>> metric_facades;
+
   public:
-    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator)
+    ContiguousInternalMemoryDataFacade(std::shared_ptr<ContiguousBlockAllocator> allocator,
+                                       const std::size_t metric = 0)
         : ContiguousInternalMemoryDataFacadeBase(allocator),
-          ContiguousInternalMemoryAlgorithmDataFacade<MLD>(allocator)
+          ContiguousInternalMemoryAlgorithmDataFacade<MLD>(allocator, metric)
 
     {
+        if (metric == 0)
+        {
+            for (const auto other : util::irange<std::size_t>(1, GetMetricNames().size()))
+            {
+                metric_facades.push_back(
+                    std::make_shared<const ContiguousInternalMemoryDataFacade>(allocator, other));
+            }
+        }
+    }
+
+    // Returns the facade of the named metric, the empty name selects the default metric.
+    // Must be called on the facade of the default metric, nullptr if the metric is unknown.
+    std::shared_ptr<const ContiguousInternalMemoryDataFacade>
+    GetMetricFacade(const std::shared_ptr<const ContiguousInternalMemoryDataFacade> &self,
+                    const std::string &name) const
+    {
+        BOOST_ASSERT(self.get() == this);
+        const auto &names = GetMetricNames();
+        const auto position = std::find(names.begin(), names.end(), name);
+        if (name.empty() || position == names.begin())
+        {
+            return self;
+        }
+        if (position == names.end())
+        {
+            return nullptr;
+        }
+        return metric_facades[std::distance(names.begin(), position) - 1];
     }
 };
 }
@@ -0,0 +1,50 @@
+#ifndef OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+
+#include "storage/storage_config.hpp"
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <map>
+#include <memory>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator maps the data files into the address space of the process and points
+ * the blocks stored verbatim in them directly into the mappings. Only the few blocks
+ * that need to be converted on load are copied into a process-local memory block.
+ * The pages of the mappings are loaded on first access and shared through the page
+ * cache with all other processes that map the same files.
+ * An uncompressed dataset image is mapped as a whole and used as the memory block.
+ */
+class MMapMemoryAllocator : public ContiguousBlockAllocator
+{
+  public:
+    explicit MMapMemoryAllocator(const storage::StorageConfig &config);
+    ~MMapMemoryAllocator() override final;
+
+    // interface to give access to the datafacades
+    storage::DataLayout &GetLayout() override final;
+    char *GetMemory() override final;
+
+  private:
+    std::map<boost::filesystem::path, boost::iostreams::mapped_file_source> mapped_files;
+    std::unique_ptr<char[]> internal_memory;
+    std::unique_ptr<storage::DataLayout> internal_layout;
+    // the memory block, either internal_memory or in the mapping of an image
+    char *memory = nullptr;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
@@ -3,6 +3,7 @@
 
 #include "storage/storage_config.hpp"
 #include "engine/datafacade/contiguous_block_allocator.hpp"
+#include "util/huge_pages.hpp"
 
 #include <memory>
 
@@ -18,12 +19,14 @@ namespace datafacade
  * data into.  The structure and layout is the same as when using
  * shared memory.
  * This class holds a unique_ptr to the memory block, so it
- * is auto-freed upon destruction.
+ * is auto-freed upon destruction. The block can be backed by
+ * huge pages to save TLB misses on the large graph blocks.
  */
 class ProcessMemoryAllocator : public ContiguousBlockAllocator
 {
   public:
-    explicit ProcessMemoryAllocator(const storage::StorageConfig &config);
+    explicit ProcessMemoryAllocator(const storage::StorageConfig &config,
+                                    const bool use_huge_pages = false);
     ~ProcessMemoryAllocator() override final;
 
     // interface to give access to the datafacades
@@ -31,7 +34,7 @@ class ProcessMemoryAllocator : public ContiguousBlockAllocator
     char *GetMemory() override final;
 
   private:
-    std::unique_ptr<char[]> internal_memory;
+    std::unique_ptr<util::HugePageMemory> internal_memory;
     std::unique_ptr<storage::DataLayout> internal_layout;
 };
 
@@ -7,6 +7,7 @@
 #include "storage/shared_memory.hpp"
 
 #include <memory>
+#include <string>
 
 namespace osrm
 {
@@ -23,7 +24,10 @@ namespace datafacade
 class SharedMemoryAllocator : public ContiguousBlockAllocator
 {
   public:
-    explicit SharedMemoryAllocator(storage::SharedDataType data_region);
+    // Maps the given copy of the region of the dataset
+    explicit SharedMemoryAllocator(storage::SharedDataType data_region,
+                                   const unsigned replica = 0,
+                                   const std::string &dataset_name = "");
     ~SharedMemoryAllocator() override final;
 
     // interface to give access to the datafacades
@@ -1,8 +1,10 @@
 #ifndef OSRM_ENGINE_DATAFACADE_PROVIDER_HPP
 #define OSRM_ENGINE_DATAFACADE_PROVIDER_HPP
 
+#include "engine/data_memory.hpp"
 #include "engine/data_watchdog.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/datafacade/mmap_memory_allocator.hpp"
 #include "engine/datafacade/process_memory_allocator.hpp"
 
 namespace osrm
@@ -25,10 +27,18 @@ template <typename AlgorithmT> class ImmutableProvider final : public DataFacade
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    ImmutableProvider(const storage::StorageConfig &config)
-        : immutable_data_facade(std::make_shared<FacadeT>(
-              std::make_shared<datafacade::ProcessMemoryAllocator>(config)))
+    ImmutableProvider(const storage::StorageConfig &config,
+                      const bool use_huge_pages = false,
+                      const bool use_mmap = false)
     {
+        const auto allocator =
+            use_mmap ? std::shared_ptr<datafacade::ContiguousBlockAllocator>(
+                           std::make_shared<datafacade::MMapMemoryAllocator>(config))
+                     : std::make_shared<datafacade::ProcessMemoryAllocator>(config, use_huge_pages);
+        // datasets loaded by the process are told apart by the base name of their files
+        DataMemoryMetrics::GetInstance().Register(
+            config.properties_path.stem().string(), 0, allocator);
+        immutable_data_facade = std::make_shared<FacadeT>(allocator);
     }
 
     std::shared_ptr<const FacadeT> Get() const override final { return immutable_data_facade; }
@@ -43,6 +53,13 @@ template <typename AlgorithmT> class WatchingProvider final : public DataFacadeP
     DataWatchdog<AlgorithmT> watchdog;
 
   public:
+    WatchingProvider(const std::string &dataset_name = "",
+                     const bool warm_up_data = false,
+                     const unsigned warm_up_queries = 0)
+        : watchdog(dataset_name, warm_up_data, warm_up_queries)
+    {
+    }
+
     std::shared_ptr<const FacadeT> Get() const override final
     {
         // We need a singleton here because multiple instances of DataWatchdog
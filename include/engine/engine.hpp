@@ -1,31 +1,46 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include "customizer/time_buckets.hpp"
+#include "engine/api/binary_builder.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
 #include "engine/api/table_parameters.hpp"
 #include "engine/api/tile_parameters.hpp"
 #include "engine/api/trip_parameters.hpp"
+#include "engine/conditional_turns.hpp"
 #include "engine/data_watchdog.hpp"
 #include "engine/datafacade/contiguous_block_allocator.hpp"
 #include "engine/datafacade_provider.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/match_sessions.hpp"
+#include "engine/plugins/isochrone.hpp"
 #include "engine/plugins/match.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/table.hpp"
 #include "engine/plugins/tile.hpp"
 #include "engine/plugins/trip.hpp"
 #include "engine/plugins/viaroute.hpp"
+#include "engine/query_deadline.hpp"
 #include "engine/routing_algorithms.hpp"
+#include "engine/routing_cache.hpp"
+#include "engine/shortcut_cache.hpp"
+#include "engine/snap_cache.hpp"
+#include "engine/tile_cache.hpp"
 #include "engine/status.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+#include "util/request_timing.hpp"
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -40,6 +55,7 @@ class EngineInterface
                          util::json::Object &result) const = 0;
     virtual Status Table(const api::TableParameters &parameters,
                          util::json::Object &result) const = 0;
+    virtual Status Table(const api::TableParameters &parameters, std::string &result) const = 0;
     virtual Status Nearest(const api::NearestParameters &parameters,
                            util::json::Object &result) const = 0;
     virtual Status Trip(const api::TripParameters &parameters,
@@ -47,31 +63,91 @@ class EngineInterface
     virtual Status Match(const api::MatchParameters &parameters,
                          util::json::Object &result) const = 0;
     virtual Status Tile(const api::TileParameters &parameters, std::string &result) const = 0;
+    virtual Status Isochrone(const api::IsochroneParameters &parameters,
+                             util::json::Object &result) const = 0;
+    // Identifies the dataset the queries run on, a new dataset is a new object. Compare them
+    // by owner so released datasets aren't confused with new ones, see FacadeEpoch.
+    virtual std::shared_ptr<const void> GetDataset() const = 0;
 };
 
 template <typename Algorithm> class Engine final : public EngineInterface
 {
   public:
     explicit Engine(const EngineConfig &config)
-        : route_plugin(config.max_locations_viaroute, config.max_alternatives), //
-          table_plugin(config.max_locations_distance_table),                    //
-          nearest_plugin(config.max_results_nearest),                           //
-          trip_plugin(config.max_locations_trip),                               //
-          match_plugin(config.max_locations_map_matching),                      //
-          tile_plugin()                                                         //
+        : heaps(config),                                                             //
+          route_plugin(config.max_locations_viaroute,                                //
+                       config.max_alternatives,                                      //
+                       config.leg_concurrency,                                       //
+                       config.leg_concurrency_min_waypoints),                        //
+          table_plugin(config.max_locations_distance_table),                         //
+          nearest_plugin(config.max_results_nearest),                                //
+          trip_plugin(config.max_locations_trip,                                     //
+                      config.trip_improvement_time,                                  //
+                      config.trip_table_neighbours),                                 //
+          match_plugin(config.max_locations_map_matching, config.match_concurrency), //
+          tile_plugin(),                                                             //
+          isochrone_plugin(config.max_isochrone_duration),                           //
+          max_query_time(config.max_query_time)                                      //
 
     {
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>();
+            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(
+                config.dataset_name,
+                config.warm_up_data,
+                static_cast<unsigned>(config.warm_up_queries));
+        }
+        else if (config.use_mmap)
+        {
+            util::Log(logDEBUG) << "Using memory-mapped files with algorithm "
+                                << routing_algorithms::name<Algorithm>();
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, false, true);
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, config.use_huge_pages);
+        }
+
+        if (config.routing_cache_size > 0)
+        {
+            util::Log(logDEBUG) << "Caching up to " << config.routing_cache_size
+                                << " routing results";
+            cache = std::make_unique<RoutingCache>(config.routing_cache_size);
+        }
+        if (config.snap_cache_size > 0)
+        {
+            util::Log(logDEBUG) << "Caching up to " << config.snap_cache_size
+                                << " snapped coordinates";
+            snap_cache = std::make_unique<SnapCache>(config.snap_cache_size);
+        }
+        if (config.shortcut_cache_size > 0)
+        {
+            util::Log(logDEBUG) << "Caching up to " << config.shortcut_cache_size
+                                << " unpacked shortcuts";
+            shortcut_cache = std::make_unique<ShortcutCache>(config.shortcut_cache_size);
+        }
+        if (config.tile_cache_size > 0 || !config.tile_cache_path.empty())
+        {
+            util::Log(logDEBUG) << "Caching up to " << config.tile_cache_size << " tiles"
+                                << (config.tile_cache_path.empty()
+                                        ? ""
+                                        : " and persisting them to " +
+                                              config.tile_cache_path.string());
+            tile_cache =
+                std::make_unique<TileCache>(config.tile_cache_size, config.tile_cache_path);
+        }
+        if (config.match_session_ttl > 0)
+        {
+            util::Log(logDEBUG) << "Keeping match sessions for " << config.match_session_ttl
+                                << " seconds";
+            match_sessions =
+                std::make_unique<MatchSessions>(std::chrono::seconds(config.match_session_ttl));
         }
     }
 
@@ -80,59 +156,350 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Engine(const Engine &) = delete;
     Engine &operator=(const Engine &) = delete;
-    virtual ~Engine() = default;
+    virtual ~Engine()
+    {
+        if (cache)
+        {
+            util::Log() << "Routing cache hits: " << cache->Hits()
+                        << " misses: " << cache->Misses();
+        }
+        if (snap_cache)
+        {
+            util::Log() << "Snap cache hits: " << snap_cache->Hits()
+                        << " misses: " << snap_cache->Misses();
+        }
+        if (shortcut_cache)
+        {
+            util::Log() << "Shortcut cache hits: " << shortcut_cache->Hits()
+                        << " misses: " << shortcut_cache->Misses();
+        }
+        if (tile_cache)
+        {
+            util::Log() << "Tile cache hits: " << tile_cache->Hits()
+                        << " misses: " << tile_cache->Misses();
+        }
+    }
 
     Status Route(const api::RouteParameters &params,
                  util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
-        return route_plugin.HandleRequest(*facade, algorithms, params, result);
+        return WithDeadline(params, result, [&] {
+            util::ScopedStageTimer route_timer(util::RequestStage::Route);
+            auto facade = facade_provider->Get();
+            auto metric = params.metric;
+            const auto conditional_turns =
+                params.depart_at
+                    ? GetConditionalTurns(*facade,
+                                          params.depart_day.value_or(0) *
+                                                  customizer::MINUTES_PER_DAY +
+                                              *params.depart_at)
+                    : nullptr;
+            if (metric.empty() && params.depart_at)
+            {
+                metric = GetDepartureMetric(*facade, *params.depart_at);
+                if (metric.empty() && !conditional_turns)
+                {
+                    result.values["code"] = "InvalidOptions";
+                    result.values["message"] = "depart_at needs a dataset customized with speed "
+                                               "profiles or conditional turns at query time";
+                    return Status::Error;
+                }
+            }
+            auto metric_facade = GetMetricFacade(facade, metric);
+            if (!metric_facade)
+            {
+                return UnknownMetric(params, result);
+            }
+            // routes with restricted turns are only valid at their departure time
+            const ScopedConditionalTurns conditional_turns_scope(conditional_turns.get());
+            auto algorithms = GetAlgorithms(facade, metric_facade, !CurrentConditionalTurns());
+            return route_plugin.HandleRequest(*metric_facade, algorithms, params, result);
+        });
     }
 
     Status Table(const api::TableParameters &params,
                  util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
-        return table_plugin.HandleRequest(*facade, algorithms, params, result);
+        return WithDeadline(params, result, [&] {
+            util::ScopedStageTimer route_timer(util::RequestStage::Route);
+            auto facade = facade_provider->Get();
+            auto metric_facade = GetMetricFacade(facade, params.metric);
+            if (!metric_facade)
+            {
+                return UnknownMetric(params, result);
+            }
+            auto algorithms = GetAlgorithms(facade, metric_facade);
+            return table_plugin.HandleRequest(*metric_facade, algorithms, params, result);
+        });
+    }
+
+    Status Table(const api::TableParameters &params, std::string &result) const override final
+    {
+        return WithDeadline(params, result, [&] {
+            util::ScopedStageTimer route_timer(util::RequestStage::Route);
+            auto facade = facade_provider->Get();
+            auto metric_facade = GetMetricFacade(facade, params.metric);
+            if (!metric_facade)
+            {
+                return UnknownMetric(params, result);
+            }
+            auto algorithms = GetAlgorithms(facade, metric_facade);
+            return table_plugin.HandleRequest(*metric_facade, algorithms, params, result);
+        });
     }
 
     Status Nearest(const api::NearestParameters &params,
                    util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
-        return nearest_plugin.HandleRequest(*facade, algorithms, params, result);
+        return WithDeadline(params, result, [&] {
+            util::ScopedStageTimer route_timer(util::RequestStage::Route);
+            auto facade = facade_provider->Get();
+            auto metric_facade = GetMetricFacade(facade, params.metric);
+            if (!metric_facade)
+            {
+                return UnknownMetric(params, result);
+            }
+            auto algorithms = GetAlgorithms(facade, metric_facade);
+            return nearest_plugin.HandleRequest(*metric_facade, algorithms, params, result);
+        });
     }
 
     Status Trip(const api::TripParameters &params, util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
-        return trip_plugin.HandleRequest(*facade, algorithms, params, result);
+        return WithDeadline(params, result, [&] {
+            util::ScopedStageTimer route_timer(util::RequestStage::Route);
+            auto facade = facade_provider->Get();
+            auto metric_facade = GetMetricFacade(facade, params.metric);
+            if (!metric_facade)
+            {
+                return UnknownMetric(params, result);
+            }
+            auto algorithms = GetAlgorithms(facade, metric_facade);
+            return trip_plugin.HandleRequest(*metric_facade, algorithms, params, result);
+        });
     }
 
     Status Match(const api::MatchParameters &params,
                  util::json::Object &result) const override final
     {
-        auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
-        return match_plugin.HandleRequest(*facade, algorithms, params, result);
+        return WithDeadline(params, result, [&] {
+            util::ScopedStageTimer route_timer(util::RequestStage::Route);
+            auto facade = facade_provider->Get();
+            auto metric_facade = GetMetricFacade(facade, params.metric);
+            if (!metric_facade)
+            {
+                return UnknownMetric(params, result);
+            }
+            auto algorithms = GetAlgorithms(facade, metric_facade);
+            const auto sessions =
+                match_sessions
+                    ? MatchSessionsView{*match_sessions, match_sessions->GetEpoch(facade)}
+                    : MatchSessionsView{};
+            return match_plugin.HandleRequest(
+                *metric_facade, algorithms, sessions, params, result);
+        });
     }
 
     Status Tile(const api::TileParameters &params, std::string &result) const override final
     {
+        util::ScopedStageTimer route_timer(util::RequestStage::Route);
         auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
-        return tile_plugin.HandleRequest(*facade, algorithms, params, result);
+        auto algorithms = GetAlgorithms(facade, facade);
+        // only tiles with all layers are cached
+        if (!tile_cache || params.layers != api::TileParameters::LayersType::All)
+        {
+            return tile_plugin.HandleRequest(*facade, algorithms, params, result);
+        }
+
+        const auto epoch = tile_cache->GetEpoch(facade);
+        const auto dataset = TileCache::DatasetName(facade->GetCheckSum(), facade->GetTimestamp());
+        if (auto tile = tile_cache->Get(epoch, dataset, params.x, params.y, params.z))
+        {
+            result = std::move(*tile);
+            return Status::Ok;
+        }
+        const auto status = tile_plugin.HandleRequest(*facade, algorithms, params, result);
+        if (status == Status::Ok)
+        {
+            tile_cache->Put(epoch, dataset, params.x, params.y, params.z, result);
+        }
+        return status;
+    }
+
+    std::shared_ptr<const void> GetDataset() const override final
+    {
+        return facade_provider->Get();
+    }
+
+    Status Isochrone(const api::IsochroneParameters &params,
+                     util::json::Object &result) const override final
+    {
+        return WithDeadline(params, result, [&] {
+            util::ScopedStageTimer route_timer(util::RequestStage::Route);
+            auto facade = facade_provider->Get();
+            auto metric_facade = GetMetricFacade(facade, params.metric);
+            if (!metric_facade)
+            {
+                return UnknownMetric(params, result);
+            }
+            auto algorithms = GetAlgorithms(facade, metric_facade);
+            return isochrone_plugin.HandleRequest(*metric_facade, algorithms, params, result);
+        });
     }
 
     static bool CheckCompability(const EngineConfig &config);
 
   private:
+    // Only MLD datasets have metrics besides the default one
+    template <typename FacadeT>
+    static std::shared_ptr<const FacadeT>
+    GetMetricFacade(const std::shared_ptr<const FacadeT> &facade, const std::string &metric)
+    {
+        return metric.empty() ? facade : nullptr;
+    }
+
+    static std::shared_ptr<const datafacade::ContiguousInternalMemoryDataFacade<datafacade::MLD>>
+    GetMetricFacade(
+        const std::shared_ptr<const datafacade::ContiguousInternalMemoryDataFacade<datafacade::MLD>>
+            &facade,
+        const std::string &metric)
+    {
+        return facade->GetMetricFacade(facade, metric);
+    }
+
+    // Only MLD datasets can be customized with the time buckets of speed profiles
+    template <typename FacadeT>
+    static std::string GetDepartureMetric(const FacadeT &, const unsigned /*depart_at*/)
+    {
+        return {};
+    }
+
+    static std::string
+    GetDepartureMetric(const datafacade::ContiguousInternalMemoryDataFacade<datafacade::MLD> &facade,
+                       const unsigned depart_at)
+    {
+        return customizer::timeBucketMetricName(facade.GetMetricNames(), depart_at);
+    }
+
+    // Only MLD datasets can evaluate conditional turn restrictions at the minute of the week of
+    // the departure
+    template <typename FacadeT>
+    static std::unique_ptr<ActiveConditionalTurns> GetConditionalTurns(const FacadeT &,
+                                                                       const unsigned)
+    {
+        return nullptr;
+    }
+
+    static std::unique_ptr<ActiveConditionalTurns> GetConditionalTurns(
+        const datafacade::ContiguousInternalMemoryDataFacade<datafacade::MLD> &facade,
+        const unsigned minute_of_week)
+    {
+        const auto &masks = facade.GetConditionalTurnMasks();
+        if (masks.GetNumberOfTurns() == 0)
+            return nullptr;
+        return std::make_unique<ActiveConditionalTurns>(
+            masks, facade.GetMultiLevelPartition(), minute_of_week);
+    }
+
+    static Status Error(const api::BaseParameters &,
+                        const std::string &code,
+                        const std::string &message,
+                        util::json::Object &result)
+    {
+        result.values.clear();
+        result.values["code"] = code;
+        result.values["message"] = message;
+        return Status::Error;
+    }
+
+    static Status Error(const api::BaseParameters &params,
+                        const std::string &code,
+                        const std::string &message,
+                        std::string &result)
+    {
+        util::json::Object error;
+        const auto status = Error(params, code, message, error);
+        if (params.format == api::OutputFormatType::Binary)
+        {
+            api::binary::encode(error, result);
+        }
+        else
+        {
+            std::vector<char> rendered_error;
+            util::json::render(rendered_error, error);
+            result.assign(rendered_error.begin(), rendered_error.end());
+        }
+        return status;
+    }
+
+    template <typename ResultT>
+    static Status UnknownMetric(const api::BaseParameters &params, ResultT &result)
+    {
+        return Error(params, "InvalidOptions", "Unknown metric " + params.metric, result);
+    }
+
+    // Runs the query until the earlier of the deadline of its parameters and max_query_time,
+    // the searches that are still running then throw a QueryTimeout. Afterwards the nodes the
+    // heaps of the thread settled are counted to the request and the heaps are shrunk if they
+    // grew beyond max_heap_memory.
+    template <typename ResultT, typename QueryT>
+    Status WithDeadline(const api::BaseParameters &params, ResultT &result, QueryT query) const
+    {
+        const auto deadline =
+            max_query_time < 0
+                ? params.deadline
+                : params.deadline.Earliest(
+                      QueryDeadline::In(std::chrono::milliseconds(max_query_time)));
+        const ScopedQueryDeadline deadline_scope(deadline);
+        const auto settled_nodes = heaps.GetSettledNodes();
+        Status status;
+        try
+        {
+            status = query();
+        }
+        catch (const QueryTimeout &timeout)
+        {
+            status = Error(params, "Timeout", timeout.what(), result);
+        }
+        util::RequestTimings::GetCurrent().CountSettledNodes(heaps.GetSettledNodes() -
+                                                             settled_nodes);
+        heaps.ShrinkThreadLocalStorage();
+        return status;
+    }
+
+    // Snapping does not depend on the metric, so the snap cache is shared by all metrics of the
+    // dataset. Routes and unpacked shortcuts are only cached for the default metric, every
+    // metric has a hierarchy of its own.
+    template <typename FacadeT>
+    RoutingAlgorithms<Algorithm> GetAlgorithms(const std::shared_ptr<const FacadeT> &dataset_facade,
+                                               const std::shared_ptr<const FacadeT> &facade,
+                                               const bool cache_routes = true) const
+    {
+        auto *const route_cache = facade == dataset_facade && cache_routes ? cache.get() : nullptr;
+        auto *const unpacking_cache = facade == dataset_facade ? shortcut_cache.get() : nullptr;
+        if (!route_cache && !snap_cache && !unpacking_cache)
+        {
+            return RoutingAlgorithms<Algorithm>{heaps, *facade};
+        }
+        const auto cache_epoch = route_cache ? route_cache->GetEpoch(dataset_facade) : 0;
+        const auto snap_cache_view =
+            snap_cache ? SnapCacheView{*snap_cache, snap_cache->GetEpoch(dataset_facade)}
+                       : SnapCacheView{};
+        const auto shortcut_cache_view =
+            unpacking_cache
+                ? ShortcutCacheView{*unpacking_cache, unpacking_cache->GetEpoch(dataset_facade)}
+                : ShortcutCacheView{};
+        return RoutingAlgorithms<Algorithm>{
+            heaps, *facade, route_cache, cache_epoch, snap_cache_view, shortcut_cache_view};
+    }
+
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
     mutable SearchEngineData<Algorithm> heaps;
+    std::unique_ptr<RoutingCache> cache;
+    std::unique_ptr<SnapCache> snap_cache;
+    std::unique_ptr<ShortcutCache> shortcut_cache;
+    std::unique_ptr<TileCache> tile_cache;
+    std::unique_ptr<MatchSessions> match_sessions;
 
     const plugins::ViaRoutePlugin route_plugin;
     const plugins::TablePlugin table_plugin;
@@ -140,6 +507,9 @@ template <typename Algorithm> class Engine final : public EngineInterface
     const plugins::TripPlugin trip_plugin;
     const plugins::MatchPlugin match_plugin;
     const plugins::TilePlugin tile_plugin;
+    const plugins::IsochronePlugin isochrone_plugin;
+
+    const int max_query_time;
 };
 
 template <>
@@ -147,11 +517,12 @@ bool Engine<routing_algorithms::ch::Algorithm>::CheckCompability(const EngineCon
 {
     if (config.use_shared_memory)
     {
-        storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
+        storage::SharedMonitor<storage::SharedDataTimestamp> barrier(config.dataset_name);
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
+        auto mem =
+            storage::makeSharedMemory(barrier.data().region, 0, false, config.dataset_name);
         auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
         return layout->GetBlockSize(storage::DataLayout::CH_GRAPH_NODE_LIST) > 4 &&
                layout->GetBlockSize(storage::DataLayout::CH_GRAPH_EDGE_LIST) > 4;
@@ -178,11 +549,12 @@ bool Engine<routing_algorithms::corech::Algorithm>::CheckCompability(const Engin
 
     if (config.use_shared_memory)
     {
-        storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
+        storage::SharedMonitor<storage::SharedDataTimestamp> barrier(config.dataset_name);
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
+        auto mem =
+            storage::makeSharedMemory(barrier.data().region, 0, false, config.dataset_name);
         auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
         return layout->GetBlockSize(storage::DataLayout::CH_CORE_MARKER) >
                sizeof(std::uint64_t) + sizeof(util::FingerPrint);
@@ -199,16 +571,44 @@ bool Engine<routing_algorithms::corech::Algorithm>::CheckCompability(const Engin
     }
 }
 
+template <>
+bool Engine<routing_algorithms::cch::Algorithm>::CheckCompability(const EngineConfig &config)
+{
+    if (config.use_shared_memory)
+    {
+        storage::SharedMonitor<storage::SharedDataTimestamp> barrier(config.dataset_name);
+        using mutex_type = typename decltype(barrier)::mutex_type;
+        boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
+
+        auto mem =
+            storage::makeSharedMemory(barrier.data().region, 0, false, config.dataset_name);
+        auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
+        return layout->GetBlockSize(storage::DataLayout::CCH_GRAPH_NODE_LIST) > 4 &&
+               layout->GetBlockSize(storage::DataLayout::CCH_GRAPH_EDGE_LIST) > 4;
+    }
+    else
+    {
+        if (!boost::filesystem::exists(config.storage_config.cch_graph_path))
+            return false;
+        storage::io::FileReader in(config.storage_config.cch_graph_path,
+                                   storage::io::FileReader::VerifyFingerprint);
+
+        auto size = in.GetSize();
+        return size > 0;
+    }
+}
+
 template <>
 bool Engine<routing_algorithms::mld::Algorithm>::CheckCompability(const EngineConfig &config)
 {
     if (config.use_shared_memory)
     {
-        storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
+        storage::SharedMonitor<storage::SharedDataTimestamp> barrier(config.dataset_name);
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
+        auto mem =
+            storage::makeSharedMemory(barrier.data().region, 0, false, config.dataset_name);
         auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
         return layout->GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0;
     }
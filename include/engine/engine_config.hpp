@@ -53,9 +53,51 @@ namespace engine
  *  - Match
  *  - Nearest
  *
- * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * The Isochrone service limits the largest contour duration in seconds instead (-1 for unlimited).
  *
- * You can chose between three algorithms:
+ * In addition, shared memory can be used for datasets loaded with osrm-datastore. A
+ * dataset_name selects the dataset osrm-datastore loaded with --dataset-name, the unnamed
+ * dataset is used by default. With warm_up_data the graphs, the r-tree and the cells of a
+ * dataset are paged in and warm_up_queries snapping queries are run on it before it replaces
+ * the current one.
+ *
+ * Results of route and table searches can be cached across requests by setting the
+ * maximal number of cached results (0 disables the cache). Likewise the phantom nodes input
+ * coordinates snap to are cached for up to snap_cache_size coordinates, so repeated queries
+ * from the same locations skip the r-tree. CH routes look the shortcuts of their packed paths
+ * and MLD routes the clique arcs of their cells up in a cache of up to shortcut_cache_size
+ * unpacked shortcuts instead of unpacking them again, which pays off for long routes sharing
+ * the same highways. Up to tile_cache_size encoded tiles of the tile service are kept in
+ * memory, and if tile_cache_path is set tiles are also persisted to and served from that
+ * directory, e.g. after osrm-tiles pre-rendered them.
+ *
+ * Match requests can continue the trace of a session if match_session_ttl is set, clients then
+ * only send the points that are new since their previous request. Sessions that are not
+ * continued for match_session_ttl seconds are evicted (0 disables sessions).
+ *
+ * A single Table request is computed by one thread unless the many-to-many concurrency is
+ * raised, in which case its searches are distributed over up to that many threads.
+ * Likewise the traces of a batch Match request and the routes of its sub matchings are
+ * matched and assembled by up to match_concurrency threads. The MLD via paths of a Route
+ * request for alternatives are reconstructed and annotated by up to alternatives_concurrency
+ * threads. The legs of a Route request through at least leg_concurrency_min_waypoints waypoints
+ * are unpacked and assembled by up to leg_concurrency threads once the search found the route.
+ *
+ * Trips through more locations than can be brute forced are improved by a local search for up to
+ * trip_improvement_time milliseconds (0 disables it). Trips through more than 100 locations
+ * only compute the durations from each location to its trip_table_neighbours nearest ones if
+ * that is set, instead of the durations between all of them (0 computes all of them).
+ *
+ * Data loaded into the memory of the process is backed by huge pages if use_huge_pages is set
+ * and the system has them reserved, or else by transparent huge pages if they are enabled.
+ *
+ * With use_mmap the data files are mapped instead of loaded, so startup does not read them and
+ * processes mapping the same files share their pages through the page cache.
+ *
+ * Queries of the asynchronous API are run by up to async_concurrency worker threads
+ * (-1 for one per hardware thread).
+ *
+ * You can chose between four algorithms:
  *  - Algorithm::CH
  *    Contraction Hierarchies, extremely fast queries but slow pre-processing. The default right
  * now.
@@ -64,10 +106,42 @@ namespace engine
  *  - Algorithm::MLD
  *    Multi Level Dijkstra which is experimental and moderately fast in both pre-processing and
  * query.
+ *  - Algorithm::CCH
+ *    Customizable Contraction Hierarchies, queried like CH on a hierarchy that osrm-customize
+ * derives from the MLD partition and customizes with the weights of each update.
  *
  * Algorithm::CH is specified we will automatically upgrade to CoreCH if we find the data for it.
  * If Algorithm::CoreCH is specified and we don't find the speedup data, we fail hard.
  *
+ * The node index storage of the search heaps can be chosen separately for point-to-point
+ * queries and for many-to-many (table) queries:
+ *  - HeapStorage::Default
+ *    Let the algorithm pick the storage that suits its queries best.
+ *  - HeapStorage::UnorderedMap
+ *    Hash map, memory proportional to the search space.
+ *  - HeapStorage::GenerationArray
+ *    Flat array over all nodes, fastest lookups but memory proportional to the graph size.
+ *  - HeapStorage::TwoLevelArray
+ *    Paged flat array that only allocates the pages touched by searches.
+ *
+ * The heaps are kept by every thread for its next queries. A thread that holds more than
+ * max_heap_memory MiB in its heaps after a query releases what they allocated beyond the fixed
+ * size of their index (-1 for no limit), so a few large queries don't pin their memory on all
+ * threads.
+ *
+ * Datasets with landmarks (see --landmarks of osrm-customize and osrm-contract) direct the MLD
+ * searches and the core searches of CoreCH towards their target. This is done for the searches
+ * of Route and Trip if use_landmarks_for_route is set and for the searches between the
+ * candidates of Match if use_landmarks_for_match is set, which are short and mostly settled
+ * before the potentials of the landmarks pay off.
+ *
+ * The core searches of CoreCH settle at most max_core_settled_nodes nodes (-1 for no limit),
+ * searches that would need more find no route. This bounds the work of long queries on
+ * datasets with a big core.
+ *
+ * Queries fail with a Timeout error once they ran max_query_time milliseconds (-1 for no
+ * limit), unless the deadline of their parameters is earlier.
+ *
  * \see OSRM, StorageConfig
  */
 struct EngineConfig final
@@ -78,7 +152,16 @@ struct EngineConfig final
     {
         CH,     // will upgrade to CoreCH if it finds core data
         CoreCH, // will fail hard if there is no core data
-        MLD
+        MLD,
+        CCH
+    };
+
+    enum class HeapStorage
+    {
+        Default,
+        UnorderedMap,
+        GenerationArray,
+        TwoLevelArray
     };
 
     storage::StorageConfig storage_config;
@@ -88,8 +171,35 @@ struct EngineConfig final
     int max_locations_map_matching = -1;
     int max_results_nearest = -1;
     int max_alternatives = 3; // set an arbitrary upper bound; can be adjusted by user
+    int max_isochrone_duration = -1;
+    int max_core_settled_nodes = -1;
+    int max_query_time = -1;
+    int max_heap_memory = -1;
+    int many_to_many_concurrency = 1;
+    int match_concurrency = 1;
+    int alternatives_concurrency = 1;
+    int leg_concurrency = 1;
+    int leg_concurrency_min_waypoints = 16;
+    int trip_improvement_time = 0;
+    int trip_table_neighbours = 0;
+    int async_concurrency = -1;
+    int routing_cache_size = 0;
+    int snap_cache_size = 0;
+    int shortcut_cache_size = 0;
+    int tile_cache_size = 0;
+    boost::filesystem::path tile_cache_path;
+    int match_session_ttl = 0;
     bool use_shared_memory = true;
+    std::string dataset_name;
+    bool warm_up_data = false;
+    int warm_up_queries = 0;
+    bool use_huge_pages = false;
+    bool use_mmap = false;
     Algorithm algorithm = Algorithm::CH;
+    HeapStorage query_heap_storage = HeapStorage::Default;
+    HeapStorage many_to_many_heap_storage = HeapStorage::Default;
+    bool use_landmarks_for_route = true;
+    bool use_landmarks_for_match = false;
 };
 }
 }
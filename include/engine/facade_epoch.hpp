@@ -0,0 +1,40 @@
+#ifndef OSRM_ENGINE_FACADE_EPOCH_HPP
+#define OSRM_ENGINE_FACADE_EPOCH_HPP
+
+#include <memory>
+#include <mutex>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Numbers the datasets a cache has seen. Whenever a request uses a different facade than the
+// previous one a new epoch starts, so entries tagged with an older epoch become unreachable.
+class FacadeEpoch
+{
+  public:
+    unsigned Get(const std::shared_ptr<const void> &facade)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // owner based comparison keeps working after the previous facade was released
+        const bool same_facade = !current_facade.owner_before(facade) &&
+                                 !facade.owner_before(current_facade);
+        if (!same_facade)
+        {
+            current_facade = facade;
+            ++epoch;
+        }
+        return epoch;
+    }
+
+  private:
+    std::mutex mutex;
+    std::weak_ptr<const void> current_facade;
+    unsigned epoch = 0;
+};
+}
+}
+
+#endif
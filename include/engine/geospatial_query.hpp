@@ -2,15 +2,19 @@
 #define GEOSPATIAL_QUERY_HPP
 
 #include "engine/approach.hpp"
+#include "engine/bearing.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <algorithm>
 #include <cmath>
 #include <memory>
@@ -79,6 +83,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            util::bearing::BinsInBounds(bearing, bearing_range),
             [this, approach, &input_coordinate, bearing, bearing_range, max_distance](
                 const CandidateSegment &segment) {
                 auto use_direction = boolPairAnd(
@@ -106,6 +111,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            util::bearing::BinsInBounds(bearing, bearing_range),
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
                 auto use_direction = boolPairAnd(
@@ -133,6 +139,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         auto results = rtree.Nearest(
             input_coordinate,
+            util::bearing::BinsInBounds(bearing, bearing_range),
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
                 auto use_direction = boolPairAnd(
@@ -199,42 +206,16 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                       const double max_distance,
                                                       const Approach approach) const
     {
-        bool has_small_component = false;
-        bool has_big_component = false;
-        auto results = rtree.Nearest(
+        return NearestWithAlternativeFromBigComponent(
             input_coordinate,
-            [this, approach, &input_coordinate, &has_big_component, &has_small_component](
-                const CandidateSegment &segment) {
-                auto use_segment =
-                    (!has_small_component || (!has_big_component && !IsTinyComponent(segment)));
-                auto use_directions = std::make_pair(use_segment, use_segment);
-                const auto valid_edges = HasValidEdge(segment);
-                use_directions = boolPairAnd(use_directions, valid_edges);
-                use_directions =
-                    boolPairAnd(use_directions, CheckApproach(input_coordinate, segment, approach));
-
-                if (use_directions.first || use_directions.second)
-                {
-                    has_big_component = has_big_component || !IsTinyComponent(segment);
-                    has_small_component = has_small_component || IsTinyComponent(segment);
-                }
-
-                return use_directions;
+            util::bearing::ALL_BINS,
+            [this, approach, &input_coordinate](const CandidateSegment &segment) {
+                return boolPairAnd(HasValidEdge(segment),
+                                   CheckApproach(input_coordinate, segment, approach));
             },
-            [this, &has_big_component, max_distance, input_coordinate](
-                const std::size_t num_results, const CandidateSegment &segment) {
-                return (num_results > 0 && has_big_component) ||
-                       CheckSegmentDistance(input_coordinate, segment, max_distance);
+            [this, max_distance, input_coordinate](const CandidateSegment &segment) {
+                return CheckSegmentDistance(input_coordinate, segment, max_distance);
             });
-
-        if (results.size() == 0)
-        {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
-        }
-
-        BOOST_ASSERT(results.size() == 1 || results.size() == 2);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -243,41 +224,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     NearestPhantomNodeWithAlternativeFromBigComponent(const util::Coordinate input_coordinate,
                                                       const Approach approach) const
     {
-        bool has_small_component = false;
-        bool has_big_component = false;
-        auto results = rtree.Nearest(
+        return NearestWithAlternativeFromBigComponent(
             input_coordinate,
-            [this, approach, &input_coordinate, &has_big_component, &has_small_component](
-                const CandidateSegment &segment) {
-                auto use_segment =
-                    (!has_small_component || (!has_big_component && !IsTinyComponent(segment)));
-                auto use_directions = std::make_pair(use_segment, use_segment);
-
-                const auto valid_edges = HasValidEdge(segment);
-                use_directions = boolPairAnd(use_directions, valid_edges);
-                use_directions =
-                    boolPairAnd(use_directions, CheckApproach(input_coordinate, segment, approach));
-
-                if (use_directions.first || use_directions.second)
-                {
-                    has_big_component = has_big_component || !IsTinyComponent(segment);
-                    has_small_component = has_small_component || IsTinyComponent(segment);
-                }
-
-                return use_directions;
+            util::bearing::ALL_BINS,
+            [this, approach, &input_coordinate](const CandidateSegment &segment) {
+                return boolPairAnd(HasValidEdge(segment),
+                                   CheckApproach(input_coordinate, segment, approach));
             },
-            [&has_big_component](const std::size_t num_results, const CandidateSegment &) {
-                return num_results > 0 && has_big_component;
-            });
-
-        if (results.size() == 0)
-        {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
-        }
-
-        BOOST_ASSERT(results.size() == 1 || results.size() == 2);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+            [](const CandidateSegment &) { return false; });
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -288,51 +242,17 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                       const int bearing_range,
                                                       const Approach approach) const
     {
-        bool has_small_component = false;
-        bool has_big_component = false;
-        auto results = rtree.Nearest(
+        return NearestWithAlternativeFromBigComponent(
             input_coordinate,
-            [this,
-             approach,
-             &input_coordinate,
-             bearing,
-             bearing_range,
-             &has_big_component,
-             &has_small_component](const CandidateSegment &segment) {
-                auto use_segment =
-                    (!has_small_component || (!has_big_component && !IsTinyComponent(segment)));
-                auto use_directions = std::make_pair(use_segment, use_segment);
-                use_directions = boolPairAnd(use_directions, HasValidEdge(segment));
-
-                if (use_segment)
-                {
-                    use_directions =
-                        boolPairAnd(CheckSegmentBearing(segment, bearing, bearing_range),
-                                    HasValidEdge(segment));
-                    use_directions = boolPairAnd(
-                        use_directions, CheckApproach(input_coordinate, segment, approach));
-
-                    if (use_directions.first || use_directions.second)
-                    {
-                        has_big_component = has_big_component || !IsTinyComponent(segment);
-                        has_small_component = has_small_component || IsTinyComponent(segment);
-                    }
-                }
-
-                return use_directions;
+            util::bearing::BinsInBounds(bearing, bearing_range),
+            [this, approach, &input_coordinate, bearing, bearing_range](
+                const CandidateSegment &segment) {
+                auto use_directions = boolPairAnd(
+                    CheckSegmentBearing(segment, bearing, bearing_range), HasValidEdge(segment));
+                return boolPairAnd(use_directions,
+                                   CheckApproach(input_coordinate, segment, approach));
             },
-            [&has_big_component](const std::size_t num_results, const CandidateSegment &) {
-                return num_results > 0 && has_big_component;
-            });
-
-        if (results.size() == 0)
-        {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
-        }
-
-        BOOST_ASSERT(results.size() > 0);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+            [](const CandidateSegment &) { return false; });
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -344,56 +264,178 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                                       const int bearing_range,
                                                       const Approach approach) const
     {
-        bool has_small_component = false;
-        bool has_big_component = false;
-        auto results = rtree.Nearest(
+        return NearestWithAlternativeFromBigComponent(
             input_coordinate,
-            [this,
-             approach,
-             &input_coordinate,
-             bearing,
-             bearing_range,
-             &has_big_component,
-             &has_small_component](const CandidateSegment &segment) {
-                auto use_segment =
-                    (!has_small_component || (!has_big_component && !IsTinyComponent(segment)));
-                auto use_directions = std::make_pair(use_segment, use_segment);
-                use_directions = boolPairAnd(use_directions, HasValidEdge(segment));
-
-                if (use_segment)
-                {
-                    use_directions =
-                        boolPairAnd(CheckSegmentBearing(segment, bearing, bearing_range),
-                                    HasValidEdge(segment));
-                    use_directions = boolPairAnd(
-                        use_directions, CheckApproach(input_coordinate, segment, approach));
-
-                    if (use_directions.first || use_directions.second)
-                    {
-                        has_big_component = has_big_component || !IsTinyComponent(segment);
-                        has_small_component = has_small_component || IsTinyComponent(segment);
-                    }
-                }
-
-                return use_directions;
+            util::bearing::BinsInBounds(bearing, bearing_range),
+            [this, approach, &input_coordinate, bearing, bearing_range](
+                const CandidateSegment &segment) {
+                auto use_directions = boolPairAnd(
+                    CheckSegmentBearing(segment, bearing, bearing_range), HasValidEdge(segment));
+                return boolPairAnd(use_directions,
+                                   CheckApproach(input_coordinate, segment, approach));
             },
-            [this, &has_big_component, max_distance, input_coordinate](
-                const std::size_t num_results, const CandidateSegment &segment) {
-                return (num_results > 0 && has_big_component) ||
-                       CheckSegmentDistance(input_coordinate, segment, max_distance);
+            [this, max_distance, input_coordinate](const CandidateSegment &segment) {
+                return CheckSegmentDistance(input_coordinate, segment, max_distance);
             });
+    }
 
-        if (results.size() == 0)
+    // Batched version of NearestPhantomNodeWithAlternativeFromBigComponent for many input
+    // coordinates that shares the r-tree traversal between neighbouring coordinates.
+    // The optional arguments are either empty or have one entry per coordinate. Coordinates
+    // without a matching segment get a pair of invalid phantom nodes.
+    std::vector<PhantomNodePair> NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &max_distances,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const std::vector<boost::optional<Approach>> &approaches) const
+    {
+        BOOST_ASSERT(max_distances.empty() || max_distances.size() == input_coordinates.size());
+        BOOST_ASSERT(bearings.empty() || bearings.size() == input_coordinates.size());
+        BOOST_ASSERT(approaches.empty() || approaches.size() == input_coordinates.size());
+
+        const auto get = [](const auto &values, const std::size_t index) {
+            return values.empty() ? boost::none : values[index];
+        };
+
+        std::vector<util::bearing::Bins> bearing_bins;
+        if (!bearings.empty())
         {
-            return std::make_pair(PhantomNode{}, PhantomNode{});
+            bearing_bins.reserve(bearings.size());
+            for (const auto &bearing : bearings)
+            {
+                bearing_bins.push_back(bearing ? util::bearing::BinsInBounds(bearing->bearing,
+                                                                             bearing->range)
+                                               : util::bearing::ALL_BINS);
+            }
+        }
+
+        const auto filter = [&](const std::size_t index, const CandidateSegment &segment) {
+            auto use_directions = HasValidEdge(segment);
+            const auto bearing = get(bearings, index);
+            if (bearing)
+            {
+                use_directions = boolPairAnd(
+                    use_directions, CheckSegmentBearing(segment, bearing->bearing, bearing->range));
+            }
+            return boolPairAnd(
+                use_directions,
+                CheckApproach(input_coordinates[index],
+                              segment,
+                              get(approaches, index).value_or(Approach::UNRESTRICTED)));
+        };
+        const auto out_of_range = [&](const std::size_t index, const CandidateSegment &segment) {
+            const auto max_distance = get(max_distances, index);
+            return max_distance &&
+                   CheckSegmentDistance(input_coordinates[index], segment, *max_distance);
+        };
+
+        const auto nearest = rtree.Nearest(
+            input_coordinates,
+            bearing_bins,
+            filter,
+            [&](const std::size_t index,
+                const std::size_t num_results,
+                const CandidateSegment &segment) {
+                return num_results > 0 || out_of_range(index, segment);
+            });
+
+        std::vector<PhantomNodePair> phantom_node_pairs(input_coordinates.size());
+        std::vector<std::size_t> tiny_indices;
+        for (const auto index : util::irange<std::size_t>(0, input_coordinates.size()))
+        {
+            if (!nearest[index].empty())
+            {
+                const auto phantom_node =
+                    MakePhantomNode(input_coordinates[index], nearest[index].front()).phantom_node;
+                phantom_node_pairs[index] = std::make_pair(phantom_node, phantom_node);
+                if (IsTinyComponent(nearest[index].front()))
+                    tiny_indices.push_back(index);
+            }
         }
 
-        BOOST_ASSERT(results.size() > 0);
-        return std::make_pair(MakePhantomNode(input_coordinate, results.front()).phantom_node,
-                              MakePhantomNode(input_coordinate, results.back()).phantom_node);
+        // the coordinates next to a tiny component search again in the big components only
+        std::vector<util::Coordinate> tiny_coordinates;
+        std::vector<util::bearing::Bins> tiny_bearing_bins;
+        tiny_coordinates.reserve(tiny_indices.size());
+        for (const auto index : tiny_indices)
+        {
+            tiny_coordinates.push_back(input_coordinates[index]);
+            if (!bearing_bins.empty())
+                tiny_bearing_bins.push_back(bearing_bins[index]);
+        }
+        const auto big = rtree.NearestInBigComponents(
+            tiny_coordinates,
+            tiny_bearing_bins,
+            [&](const std::size_t tiny_index, const CandidateSegment &segment) {
+                if (IsTinyComponent(segment))
+                    return std::make_pair(false, false);
+                return filter(tiny_indices[tiny_index], segment);
+            },
+            [&](const std::size_t tiny_index,
+                const std::size_t num_results,
+                const CandidateSegment &segment) {
+                return num_results > 0 || out_of_range(tiny_indices[tiny_index], segment);
+            });
+        for (const auto tiny_index : util::irange<std::size_t>(0, tiny_indices.size()))
+        {
+            if (!big[tiny_index].empty())
+            {
+                const auto index = tiny_indices[tiny_index];
+                phantom_node_pairs[index].second =
+                    MakePhantomNode(input_coordinates[index], big[tiny_index].front())
+                        .phantom_node;
+            }
+        }
+
+        return phantom_node_pairs;
     }
 
   private:
+    // The nearest segment that passes the filter and, if it belongs to a tiny component, the
+    // nearest one of a big component. The second query only explores the subtrees with a
+    // segment of a big component, so tiny components around the coordinate don't make the
+    // first query search on until it reaches a big one.
+    template <typename FilterT, typename OutOfRangeT>
+    std::pair<PhantomNode, PhantomNode>
+    NearestWithAlternativeFromBigComponent(const util::Coordinate input_coordinate,
+                                           const util::bearing::Bins bearing_bins,
+                                           const FilterT filter,
+                                           const OutOfRangeT out_of_range) const
+    {
+        const auto terminate = [&out_of_range](const std::size_t num_results,
+                                               const CandidateSegment &segment) {
+            return num_results > 0 || out_of_range(segment);
+        };
+
+        const auto nearest = rtree.Nearest(input_coordinate, bearing_bins, filter, terminate);
+        if (nearest.empty())
+        {
+            return std::make_pair(PhantomNode{}, PhantomNode{});
+        }
+
+        const auto phantom_node = MakePhantomNode(input_coordinate, nearest.front()).phantom_node;
+        if (!IsTinyComponent(nearest.front()))
+        {
+            return std::make_pair(phantom_node, phantom_node);
+        }
+
+        const auto big = rtree.NearestInBigComponents(
+            input_coordinate,
+            bearing_bins,
+            [this, &filter](const CandidateSegment &segment) {
+                if (IsTinyComponent(segment))
+                    return std::make_pair(false, false);
+                return filter(segment);
+            },
+            terminate);
+        if (big.empty())
+        {
+            return std::make_pair(phantom_node, phantom_node);
+        }
+
+        return std::make_pair(phantom_node,
+                              MakePhantomNode(input_coordinate, big.front()).phantom_node);
+    }
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -435,13 +477,11 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         const auto geometry_id = datafacade.GetGeometryIndex(data.forward_segment_id.id).id;
         const auto component_id = datafacade.GetComponentID(data.forward_segment_id.id);
 
-        const std::vector<EdgeWeight> forward_weight_vector =
-            datafacade.GetUncompressedForwardWeights(geometry_id);
-        const std::vector<EdgeWeight> reverse_weight_vector =
-            datafacade.GetUncompressedReverseWeights(geometry_id);
-        const std::vector<EdgeWeight> forward_duration_vector =
+        const auto forward_weight_vector = datafacade.GetUncompressedForwardWeights(geometry_id);
+        const auto reverse_weight_vector = datafacade.GetUncompressedReverseWeights(geometry_id);
+        const auto forward_duration_vector =
             datafacade.GetUncompressedForwardDurations(geometry_id);
-        const std::vector<EdgeWeight> reverse_duration_vector =
+        const auto reverse_duration_vector =
             datafacade.GetUncompressedReverseDurations(geometry_id);
 
         for (std::size_t i = 0; i < data.fwd_segment_position; i++)
@@ -572,16 +612,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         BOOST_ASSERT(data.forward_segment_id.id != SPECIAL_NODEID);
         const auto geometry_id = datafacade.GetGeometryIndex(data.forward_segment_id.id).id;
 
-        const std::vector<EdgeWeight> forward_weight_vector =
-            datafacade.GetUncompressedForwardWeights(geometry_id);
+        const auto forward_weight_vector = datafacade.GetUncompressedForwardWeights(geometry_id);
 
         if (forward_weight_vector[data.fwd_segment_position] != INVALID_SEGMENT_WEIGHT)
         {
             forward_edge_valid = data.forward_segment_id.enabled;
         }
 
-        const std::vector<EdgeWeight> reverse_weight_vector =
-            datafacade.GetUncompressedReverseWeights(geometry_id);
+        const auto reverse_weight_vector = datafacade.GetUncompressedReverseWeights(geometry_id);
         if (reverse_weight_vector[reverse_weight_vector.size() - data.fwd_segment_position - 1] !=
             INVALID_SEGMENT_WEIGHT)
         {
@@ -593,8 +631,13 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
 
     bool IsTinyComponent(const CandidateSegment &segment) const
     {
-        const auto &data = segment.data;
-        BOOST_ASSERT(data.forward_segment_id.enabled);
+        BOOST_ASSERT(segment.data.forward_segment_id.enabled);
+        return IsTinyComponent(segment.data);
+    }
+
+    // the directions of a result may be disabled by the filter, its ids are still valid
+    bool IsTinyComponent(const EdgeData &data) const
+    {
         BOOST_ASSERT(data.forward_segment_id.id != SPECIAL_NODEID);
         return datafacade.GetComponentID(data.forward_segment_id.id).is_tiny;
     }
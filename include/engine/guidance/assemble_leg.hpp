@@ -38,9 +38,8 @@ struct NamedSegment
     std::uint32_t name_id;
 };
 
-template <std::size_t SegmentNumber>
-
-std::array<std::uint32_t, SegmentNumber> summarizeRoute(const datafacade::BaseDataFacade &facade,
+template <std::size_t SegmentNumber, typename FacadeT>
+std::array<std::uint32_t, SegmentNumber> summarizeRoute(const FacadeT &facade,
                                                         const std::vector<PathData> &route_data,
                                                         const PhantomNode &target_node,
                                                         const bool target_traversed_in_reverse)
@@ -124,7 +123,8 @@ std::array<std::uint32_t, SegmentNumber> summarizeRoute(const datafacade::BaseDa
 }
 }
 
-inline RouteLeg assembleLeg(const datafacade::BaseDataFacade &facade,
+template <typename FacadeT>
+inline RouteLeg assembleLeg(const FacadeT &facade,
                             const std::vector<PathData> &route_data,
                             const LegGeometry &leg_geometry,
                             const PhantomNode &source_node,
@@ -33,7 +33,8 @@ std::pair<short, short> getDepartBearings(const LegGeometry &leg_geometry);
 std::pair<short, short> getArriveBearings(const LegGeometry &leg_geometry);
 } // ns detail
 
-inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &facade,
+template <typename FacadeT>
+inline std::vector<RouteStep> assembleSteps(const FacadeT &facade,
                                             const std::vector<PathData> &leg_data,
                                             const LegGeometry &leg_geometry,
                                             const PhantomNode &source_node,
@@ -121,11 +122,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
                 auto classes = facade.GetClasses(path_point.classes);
 
                 steps.push_back(RouteStep{step_name_id,
-                                          name.to_string(),
-                                          ref.to_string(),
-                                          pronunciation.to_string(),
-                                          destinations.to_string(),
-                                          exits.to_string(),
+                                          name,
+                                          ref,
+                                          pronunciation,
+                                          destinations,
+                                          exits,
                                           NO_ROTARY_NAME,
                                           NO_ROTARY_NAME,
                                           segment_duration / 10.,
@@ -198,11 +199,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
         const EdgeWeight weight = segment_weight + target_weight;
         BOOST_ASSERT(duration >= 0);
         steps.push_back(RouteStep{step_name_id,
-                                  facade.GetNameForID(step_name_id).to_string(),
-                                  facade.GetRefForID(step_name_id).to_string(),
-                                  facade.GetPronunciationForID(step_name_id).to_string(),
-                                  facade.GetDestinationsForID(step_name_id).to_string(),
-                                  facade.GetExitsForID(step_name_id).to_string(),
+                                  facade.GetNameForID(step_name_id),
+                                  facade.GetRefForID(step_name_id),
+                                  facade.GetPronunciationForID(step_name_id),
+                                  facade.GetDestinationsForID(step_name_id),
+                                  facade.GetExitsForID(step_name_id),
                                   NO_ROTARY_NAME,
                                   NO_ROTARY_NAME,
                                   duration / 10.,
@@ -241,11 +242,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
         const EdgeWeight duration = std::max(0, target_duration - source_duration);
 
         steps.push_back(RouteStep{source_name_id,
-                                  facade.GetNameForID(source_name_id).to_string(),
-                                  facade.GetRefForID(source_name_id).to_string(),
-                                  facade.GetPronunciationForID(source_name_id).to_string(),
-                                  facade.GetDestinationsForID(source_name_id).to_string(),
-                                  facade.GetExitsForID(source_name_id).to_string(),
+                                  facade.GetNameForID(source_name_id),
+                                  facade.GetRefForID(source_name_id),
+                                  facade.GetPronunciationForID(source_name_id),
+                                  facade.GetDestinationsForID(source_name_id),
+                                  facade.GetExitsForID(source_name_id),
                                   NO_ROTARY_NAME,
                                   NO_ROTARY_NAME,
                                   duration / 10.,
@@ -281,11 +282,11 @@ inline std::vector<RouteStep> assembleSteps(const datafacade::BaseDataFacade &fa
 
     BOOST_ASSERT(!leg_geometry.locations.empty());
     steps.push_back(RouteStep{target_name_id,
-                              facade.GetNameForID(target_name_id).to_string(),
-                              facade.GetRefForID(target_name_id).to_string(),
-                              facade.GetPronunciationForID(target_name_id).to_string(),
-                              facade.GetDestinationsForID(target_name_id).to_string(),
-                              facade.GetExitsForID(target_name_id).to_string(),
+                              facade.GetNameForID(target_name_id),
+                              facade.GetRefForID(target_name_id),
+                              facade.GetPronunciationForID(target_name_id),
+                              facade.GetDestinationsForID(target_name_id),
+                              facade.GetExitsForID(target_name_id),
                               NO_ROTARY_NAME,
                               NO_ROTARY_NAME,
                               ZERO_DURATION,
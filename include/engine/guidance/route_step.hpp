@@ -6,6 +6,7 @@
 #include "util/coordinate.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
+#include "util/string_view.hpp"
 
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "util/guidance/turn_lanes.hpp"
@@ -58,13 +59,15 @@ inline IntermediateIntersection getInvalidIntersection()
 struct RouteStep
 {
     unsigned name_id;
-    std::string name;
-    std::string ref;
-    std::string pronunciation;
-    std::string destinations;
-    std::string exits;
-    std::string rotary_name;
-    std::string rotary_pronunciation;
+    // views into the name table of the facade the step was assembled from, copying and collapsing
+    // steps never allocates for them
+    util::StringView name;
+    util::StringView ref;
+    util::StringView pronunciation;
+    util::StringView destinations;
+    util::StringView exits;
+    util::StringView rotary_name;
+    util::StringView rotary_pronunciation;
     double duration; // duration in seconds
     double distance; // distance in meters
     double weight;   // weight value
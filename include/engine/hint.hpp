@@ -55,9 +55,14 @@ struct Hint
 
     bool IsValid(const util::Coordinate new_input_coordinates,
                  const datafacade::BaseDataFacade &facade) const;
+    // Same check against the checksum of the facade, which requests with many hints look up once
+    bool IsValid(const util::Coordinate new_input_coordinates,
+                 const std::uint32_t facade_checksum) const;
 
     std::string ToBase64() const;
     static Hint FromBase64(const std::string &base64Hint);
+    // Decodes the hint in [first, last) without copying it into a string
+    static Hint FromBase64(const char *first, const char *last);
 
     friend bool operator==(const Hint &, const Hint &);
     friend std::ostream &operator<<(std::ostream &, const Hint &);
@@ -28,14 +28,31 @@ struct EmissionLogProbability
 {
     double sigma_z;
     double log_sigma_z;
+    // constant term of the log-likelihood and reciprocal to scale the distances with
+    double log_normalizer;
+    double inverse_sigma_z;
 
-    EmissionLogProbability(const double sigma_z) : sigma_z(sigma_z), log_sigma_z(std::log(sigma_z))
+    EmissionLogProbability(const double sigma_z)
+        : sigma_z(sigma_z), log_sigma_z(std::log(sigma_z)),
+          log_normalizer(-0.5 * log_2_pi - log_sigma_z), inverse_sigma_z(1. / sigma_z)
     {
     }
 
     double operator()(const double distance) const
     {
-        return -0.5 * (log_2_pi + (distance / sigma_z) * (distance / sigma_z)) - log_sigma_z;
+        const auto scaled_distance = distance * inverse_sigma_z;
+        return log_normalizer - 0.5 * scaled_distance * scaled_distance;
+    }
+
+    // Log-likelihoods of all candidates of a point in one loop without branches or divisions
+    template <typename CandidateList>
+    void operator()(const CandidateList &candidates, std::vector<double> &log_probabilities) const
+    {
+        log_probabilities.resize(candidates.size());
+        for (const auto i : util::irange<std::size_t>(0UL, candidates.size()))
+        {
+            log_probabilities[i] = (*this)(candidates[i].distance);
+        }
     }
 };
 
@@ -43,9 +60,13 @@ struct TransitionLogProbability
 {
     double beta;
     double log_beta;
-    TransitionLogProbability(const double beta) : beta(beta), log_beta(std::log(beta)) {}
+    double inverse_beta;
+    TransitionLogProbability(const double beta)
+        : beta(beta), log_beta(std::log(beta)), inverse_beta(1. / beta)
+    {
+    }
 
-    double operator()(const double d_t) const { return -log_beta - d_t / beta; }
+    double operator()(const double d_t) const { return -log_beta - d_t * inverse_beta; }
 };
 
 template <class CandidateLists> struct HiddenMarkovModel
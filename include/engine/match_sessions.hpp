@@ -0,0 +1,117 @@
+#ifndef OSRM_ENGINE_MATCH_SESSIONS_HPP
+#define OSRM_ENGINE_MATCH_SESSIONS_HPP
+
+#include "engine/facade_epoch.hpp"
+#include "engine/phantom_node.hpp"
+
+#include "util/coordinate.hpp"
+
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Keeps the state of the hidden markov model of traces that are matched point by point, so
+// clients of live feeds only send the points that are new since their previous request.
+// Sessions that are not continued within the time to live are evicted. Sessions are tagged
+// with the epoch of the dataset their candidates were snapped on, see FacadeEpoch.
+class MatchSessions
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // The last point of the trace of a session, the next request of the session continues
+    // the trace from its candidates
+    struct Session
+    {
+        std::string metric;
+        std::vector<PhantomNodeWithDistance> candidates;
+        // viterbi column of the candidates, empty if the trace has no other point yet
+        std::vector<double> log_probabilities;
+        util::Coordinate coordinate;
+        boost::optional<unsigned> timestamp;
+        boost::optional<double> radius;
+    };
+
+    explicit MatchSessions(const std::chrono::seconds ttl) : ttl(ttl) {}
+
+    // Returns the epoch of the dataset behind the facade
+    unsigned GetEpoch(const std::shared_ptr<const void> &facade) { return epoch.Get(facade); }
+
+    // Removes the session from the store, so concurrent requests of a session can not continue
+    // it twice. Returns nothing if the session expired or was created on another dataset.
+    boost::optional<Session>
+    Take(const unsigned epoch, const std::string &id, const Clock::time_point now = Clock::now());
+
+    void Put(const unsigned epoch,
+             const std::string &id,
+             Session session,
+             const Clock::time_point now = Clock::now());
+
+    std::size_t Size() const;
+
+  private:
+    struct Entry
+    {
+        unsigned epoch;
+        Clock::time_point expires;
+        std::list<std::string>::iterator position;
+        Session session;
+    };
+
+    // needs the lock to be held
+    void EvictExpired(const Clock::time_point now);
+
+    const std::chrono::seconds ttl;
+    FacadeEpoch epoch;
+    mutable std::mutex mutex;
+    // session ids in the order they expire, all sessions have the same time to live
+    std::list<std::string> expiry_order;
+    std::unordered_map<std::string, Entry> sessions;
+};
+
+// The match sessions as seen by a single request, bound to the epoch of the facade it uses.
+// A default constructed view has no sessions.
+class MatchSessionsView
+{
+  public:
+    MatchSessionsView() : sessions(nullptr), epoch(0) {}
+    MatchSessionsView(MatchSessions &sessions, const unsigned epoch)
+        : sessions(&sessions), epoch(epoch)
+    {
+    }
+
+    explicit operator bool() const { return sessions != nullptr; }
+
+    boost::optional<MatchSessions::Session> Take(const std::string &id) const
+    {
+        if (!sessions)
+            return boost::none;
+        return sessions->Take(epoch, id);
+    }
+
+    void Put(const std::string &id, MatchSessions::Session session) const
+    {
+        if (sessions)
+            sessions->Put(epoch, id, std::move(session));
+    }
+
+  private:
+    MatchSessions *sessions;
+    unsigned epoch;
+};
+}
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef ISOCHRONE_HPP
+#define ISOCHRONE_HPP
+
+#include "engine/plugins/plugin_base.hpp"
+
+#include "engine/api/isochrone_parameters.hpp"
+#include "engine/routing_algorithms.hpp"
+#include "util/coordinate.hpp"
+#include "util/json_container.hpp"
+
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+class IsochronePlugin final : public BasePlugin
+{
+  public:
+    explicit IsochronePlugin(const int max_isochrone_duration);
+
+    Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                         const RoutingAlgorithmsInterface &algorithms,
+                         const api::IsochroneParameters &params,
+                         util::json::Object &result) const;
+
+  private:
+    const int max_isochrone_duration;
+};
+}
+}
+}
+
+#endif // ISOCHRONE_HPP
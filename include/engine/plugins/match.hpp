@@ -2,6 +2,7 @@
 #define MATCH_HPP
 
 #include "engine/api/match_parameters.hpp"
+#include "engine/match_sessions.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "engine/routing_algorithms.hpp"
 
@@ -27,18 +28,33 @@ class MatchPlugin : public BasePlugin
     using CandidateLists = routing_algorithms::CandidateLists;
     static const constexpr double RADIUS_MULTIPLIER = 3;
 
-    MatchPlugin(const int max_locations_map_matching)
-        : max_locations_map_matching(max_locations_map_matching)
+    MatchPlugin(const int max_locations_map_matching, const int match_concurrency)
+        : max_locations_map_matching(max_locations_map_matching),
+          match_concurrency(match_concurrency)
     {
     }
 
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
+                         const MatchSessionsView &sessions,
                          const api::MatchParameters &parameters,
                          util::json::Object &json_result) const;
 
   private:
+    Status MatchTrace(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                      const RoutingAlgorithmsInterface &algorithms,
+                      const MatchSessionsView &sessions,
+                      const api::MatchParameters &parameters,
+                      util::json::Object &json_result) const;
+
+    // Calls the function for the indices up to size, in parallel if the plugin may use more
+    // than one thread. Needs to run in the task arena of the request then.
+    template <typename Function>
+    void ForEach(const std::size_t size, const Function &function) const;
+
     const int max_locations_map_matching;
+    // number of threads a single request may use for its traces and sub matchings
+    const int match_concurrency;
 };
 }
 }
@@ -4,12 +4,14 @@
 #include "engine/api/base_parameters.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/snap_cache.hpp"
 #include "engine/status.hpp"
 
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/request_timing.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -114,11 +116,14 @@ class BasePlugin
                            const api::BaseParameters &parameters,
                            const std::vector<double> radiuses) const
     {
+        util::ScopedStageTimer snap_timer(util::RequestStage::Snap);
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
         BOOST_ASSERT(radiuses.size() == parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
+        // the hints of the request are all checked against this checksum of the dataset
+        const auto checksum = facade.GetCheckSum();
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_approaches = !parameters.approaches.empty();
 
@@ -129,7 +134,7 @@ class BasePlugin
                 approach = parameters.approaches[i].get();
 
             if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+                parameters.hints[i]->IsValid(parameters.coordinates[i], checksum))
             {
                 phantom_nodes[i].push_back(PhantomNodeWithDistance{
                     parameters.hints[i]->phantom,
@@ -162,10 +167,12 @@ class BasePlugin
                     const api::BaseParameters &parameters,
                     unsigned number_of_results) const
     {
+        util::ScopedStageTimer snap_timer(util::RequestStage::Snap);
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
+        const auto checksum = facade.GetCheckSum();
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_radiuses = !parameters.radiuses.empty();
         const bool use_approaches = !parameters.approaches.empty();
@@ -178,7 +185,7 @@ class BasePlugin
                 approach = parameters.approaches[i].get();
 
             if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+                parameters.hints[i]->IsValid(parameters.coordinates[i], checksum))
             {
                 phantom_nodes[i].push_back(PhantomNodeWithDistance{
                     parameters.hints[i]->phantom,
@@ -234,68 +241,73 @@ class BasePlugin
     }
 
     std::vector<PhantomNodePair> GetPhantomNodes(const datafacade::BaseDataFacade &facade,
-                                                 const api::BaseParameters &parameters) const
+                                                 const api::BaseParameters &parameters,
+                                                 const SnapCacheView snap_cache = {}) const
     {
+        util::ScopedStageTimer snap_timer(util::RequestStage::Snap);
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
+        const auto checksum = facade.GetCheckSum();
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_radiuses = !parameters.radiuses.empty();
         const bool use_approaches = !parameters.approaches.empty();
 
         BOOST_ASSERT(parameters.IsValid());
+
+        const auto radius = [&](const std::size_t i) {
+            return use_radiuses ? parameters.radiuses[i] : boost::none;
+        };
+        const auto bearing = [&](const std::size_t i) {
+            return use_bearings ? parameters.bearings[i] : boost::none;
+        };
+        const auto approach = [&](const std::size_t i) {
+            return use_approaches ? parameters.approaches[i] : boost::none;
+        };
+
+        // all coordinates without a valid hint or cached snap are snapped in one batch,
+        // neighbouring coordinates share the r-tree traversal
+        std::vector<std::size_t> snapped_indices;
+        std::vector<util::Coordinate> coordinates;
+        std::vector<boost::optional<double>> radiuses;
+        std::vector<boost::optional<Bearing>> bearings;
+        std::vector<boost::optional<Approach>> approaches;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
-            Approach approach = engine::Approach::UNRESTRICTED;
-            if (use_approaches && parameters.approaches[i])
-                approach = parameters.approaches[i].get();
-
             if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+                parameters.hints[i]->IsValid(parameters.coordinates[i], checksum))
             {
                 phantom_node_pairs[i].first = parameters.hints[i]->phantom;
                 // we don't set the second one - it will be marked as invalid
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            *parameters.radiuses[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range,
-                            approach);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range,
-                            approach);
-                }
-            }
-            else
+            if (auto cached_pair =
+                    snap_cache.Get(parameters.coordinates[i], radius(i), bearing(i), approach(i)))
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], *parameters.radiuses[i], approach);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], approach);
-                }
+                phantom_node_pairs[i] = std::move(*cached_pair);
+                continue;
             }
 
+            snapped_indices.push_back(i);
+            coordinates.push_back(parameters.coordinates[i]);
+            if (use_radiuses)
+                radiuses.push_back(parameters.radiuses[i]);
+            if (use_bearings)
+                bearings.push_back(parameters.bearings[i]);
+            if (use_approaches)
+                approaches.push_back(parameters.approaches[i]);
+        }
+
+        auto snapped_pairs = facade.NearestPhantomNodesWithAlternativeFromBigComponent(
+            coordinates, radiuses, bearings, approaches);
+        BOOST_ASSERT(snapped_pairs.size() == snapped_indices.size());
+
+        for (const auto k : util::irange<std::size_t>(0UL, snapped_indices.size()))
+        {
+            const auto i = snapped_indices[k];
+            phantom_node_pairs[i] = std::move(snapped_pairs[k]);
+
             // we didn't find a fitting node, return error
             if (!phantom_node_pairs[i].first.IsValid())
             {
@@ -306,6 +318,12 @@ class BasePlugin
             }
             BOOST_ASSERT(phantom_node_pairs[i].first.IsValid());
             BOOST_ASSERT(phantom_node_pairs[i].second.IsValid());
+
+            snap_cache.Put(parameters.coordinates[i],
+                           radius(i),
+                           bearing(i),
+                           approach(i),
+                           phantom_node_pairs[i]);
         }
         return phantom_node_pairs;
     }
@@ -9,6 +9,9 @@
 #include "engine/search_engine_data.hpp"
 #include "util/json_container.hpp"
 
+#include <string>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -16,6 +19,13 @@ namespace engine
 namespace plugins
 {
 
+/**
+ * Computes tables with many to many searches. Approximate tables estimate the durations by the
+ * distance oracle of the dataset instead: an entry whose bounds differ by at most 6% of its lower
+ * bound is the midpoint of them and at most 3% off the shortest duration, all other entries,
+ * e.g. between nearby locations, are searched exactly. The oracle bounds the durations of the
+ * fastest paths, which are the paths of the table for profiles that route by duration.
+ */
 class TablePlugin final : public BasePlugin
 {
   public:
@@ -26,7 +36,22 @@ class TablePlugin final : public BasePlugin
                          const api::TableParameters &params,
                          util::json::Object &result) const;
 
+    // Renders the response to JSON text or the binary format of the parameters without building
+    // the durations as json values
+    Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                         const RoutingAlgorithmsInterface &algorithms,
+                         const api::TableParameters &params,
+                         std::string &result) const;
+
   private:
+    Status ComputeTable(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                        const RoutingAlgorithmsInterface &algorithms,
+                        const api::TableParameters &params,
+                        std::vector<EdgeWeight> &result_table,
+                        std::vector<double> &distance_table,
+                        std::vector<PhantomNode> &snapped_phantoms,
+                        util::json::Object &error) const;
+
     const int max_locations_distance_table;
 };
 }
@@ -11,6 +11,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 #include <memory>
@@ -29,14 +30,27 @@ class TripPlugin final : public BasePlugin
 {
   private:
     const int max_locations_trip;
+    const std::chrono::milliseconds improvement_time;
+    const std::size_t table_neighbours;
 
     InternalRouteResult ComputeRoute(const RoutingAlgorithmsInterface &algorithms,
                                      const std::vector<PhantomNode> &phantom_node_list,
                                      const std::vector<NodeID> &trip,
                                      const bool roundtrip) const;
 
+    std::vector<NodeID> ComputeSparseTrip(const RoutingAlgorithmsInterface &algorithms,
+                                          const std::vector<PhantomNode> &snapped_phantoms,
+                                          const std::size_t source_id,
+                                          const std::size_t destination_id) const;
+
   public:
-    explicit TripPlugin(const int max_locations_trip_) : max_locations_trip(max_locations_trip_) {}
+    TripPlugin(const int max_locations_trip_,
+               const int improvement_time_,
+               const int table_neighbours_)
+        : max_locations_trip(max_locations_trip_), improvement_time(improvement_time_),
+          table_neighbours(table_neighbours_)
+    {
+    }
 
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
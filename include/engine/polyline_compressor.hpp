@@ -14,7 +14,19 @@ namespace engine
 {
 namespace detail
 {
-std::string encode(std::vector<int> &numbers);
+// Appends the zig-zag and variable length encoding of a number
+inline void encode(const int number, std::string &output)
+{
+    auto number_to_encode =
+        (static_cast<unsigned>(number) << 1u) ^ static_cast<unsigned>(number < 0 ? ~0u : 0u);
+    while (number_to_encode >= 0x20)
+    {
+        output += static_cast<char>((0x20 | (number_to_encode & 0x1f)) + 63);
+        number_to_encode >>= 5;
+    }
+    output += static_cast<char>(number_to_encode + 63);
+}
+
 std::int32_t decode_polyline_integer(std::string::const_iterator &first,
                                      std::string::const_iterator last);
 }
@@ -32,26 +44,22 @@ std::string encodePolyline(CoordVectorForwardIter begin, CoordVectorForwardIter
         return {};
     }
 
-    std::vector<int> delta_numbers;
-    BOOST_ASSERT(size > 0);
-    delta_numbers.reserve((size - 1) * 2);
+    // encoded in a single pass, most deltas of consecutive coordinates take up to three characters
+    std::string output;
+    output.reserve(size * 2 * 3);
     int current_lat = 0;
     int current_lon = 0;
-    std::for_each(
-        begin,
-        end,
-        [&delta_numbers, &current_lat, &current_lon, coordinate_to_polyline](
-            const util::Coordinate loc) {
-            const int lat_diff =
-                std::round(static_cast<int>(loc.lat) * coordinate_to_polyline) - current_lat;
-            const int lon_diff =
-                std::round(static_cast<int>(loc.lon) * coordinate_to_polyline) - current_lon;
-            delta_numbers.emplace_back(lat_diff);
-            delta_numbers.emplace_back(lon_diff);
-            current_lat += lat_diff;
-            current_lon += lon_diff;
-        });
-    return detail::encode(delta_numbers);
+    std::for_each(begin, end, [&](const util::Coordinate loc) {
+        const int lat_diff =
+            std::round(static_cast<int>(loc.lat) * coordinate_to_polyline) - current_lat;
+        const int lon_diff =
+            std::round(static_cast<int>(loc.lon) * coordinate_to_polyline) - current_lon;
+        detail::encode(lat_diff, output);
+        detail::encode(lon_diff, output);
+        current_lat += lat_diff;
+        current_lon += lon_diff;
+    });
+    return output;
 }
 
 // Decodes geometry from polyline format
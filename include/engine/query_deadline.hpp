@@ -0,0 +1,130 @@
+#ifndef OSRM_ENGINE_QUERY_DEADLINE_HPP
+#define OSRM_ENGINE_QUERY_DEADLINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <memory>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Point in time after which a query gives up, and a flag to cancel it before that.
+ *
+ * The default deadline never expires. The flag is owned by the caller, setting it to true
+ * cancels all queries that were started with the deadline.
+ */
+class QueryDeadline
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using CancellationFlag = std::shared_ptr<const std::atomic<bool>>;
+
+    QueryDeadline() = default;
+
+    explicit QueryDeadline(const Clock::time_point expires_at, CancellationFlag cancelled = {})
+        : expires_at(expires_at), cancelled(std::move(cancelled))
+    {
+    }
+
+    explicit QueryDeadline(CancellationFlag cancelled) : cancelled(std::move(cancelled)) {}
+
+    static QueryDeadline In(const std::chrono::milliseconds timeout)
+    {
+        return QueryDeadline{Clock::now() + timeout};
+    }
+
+    bool IsSet() const { return expires_at != Clock::time_point::max() || cancelled; }
+
+    bool IsExpired() const
+    {
+        return (cancelled && cancelled->load(std::memory_order_relaxed)) ||
+               (expires_at != Clock::time_point::max() && Clock::now() >= expires_at);
+    }
+
+    Clock::time_point ExpiresAt() const { return expires_at; }
+
+    // The earlier of both deadlines, cancelled by the flag of either
+    QueryDeadline Earliest(const QueryDeadline &other) const
+    {
+        QueryDeadline earliest = expires_at <= other.expires_at ? *this : other;
+        if (!earliest.cancelled)
+            earliest.cancelled = expires_at <= other.expires_at ? other.cancelled : cancelled;
+        return earliest;
+    }
+
+  private:
+    Clock::time_point expires_at = Clock::time_point::max();
+    CancellationFlag cancelled;
+};
+
+// Thrown by the searches of a query that is past its deadline, the engine reports it as the
+// Timeout error of the query
+class QueryTimeout final : public std::exception
+{
+  public:
+    const char *what() const noexcept override { return "Query exceeded its deadline"; }
+};
+
+/**
+ * Makes the deadline the one of the queries run by the calling thread while it is in scope.
+ *
+ * The searches don't know the parameters of the query, they check the deadline of their
+ * thread like the request timings are recorded. Tasks that run on other threads have to be
+ * handed the deadline, see CurrentQueryDeadline().
+ */
+class ScopedQueryDeadline
+{
+  public:
+    explicit ScopedQueryDeadline(const QueryDeadline &deadline);
+    // Hands the deadline of a query to the tasks it runs on other threads, nullptr for none
+    explicit ScopedQueryDeadline(const QueryDeadline *deadline);
+    ~ScopedQueryDeadline();
+
+    ScopedQueryDeadline(const ScopedQueryDeadline &) = delete;
+    ScopedQueryDeadline &operator=(const ScopedQueryDeadline &) = delete;
+
+  private:
+    const QueryDeadline *previous;
+};
+
+// Deadline of the query run by the calling thread, nullptr if it has none
+const QueryDeadline *CurrentQueryDeadline();
+
+// Throws QueryTimeout if the query run by the calling thread is past its deadline
+inline void CheckQueryDeadline()
+{
+    const auto *deadline = CurrentQueryDeadline();
+    if (deadline && deadline->IsExpired())
+        throw QueryTimeout();
+}
+
+/**
+ * Checks the deadline of the query every INTERVAL steps of a loop, so the loops that take
+ * microseconds per step don't read the clock for every one.
+ */
+class QueryDeadlineCheck
+{
+  public:
+    static constexpr std::size_t INTERVAL = 1024;
+
+    QueryDeadlineCheck() : deadline(CurrentQueryDeadline()) {}
+
+    void operator()()
+    {
+        if (deadline && ++steps % INTERVAL == 0 && deadline->IsExpired())
+            throw QueryTimeout();
+    }
+
+  private:
+    const QueryDeadline *deadline;
+    std::size_t steps = 0;
+};
+}
+}
+
+#endif // OSRM_ENGINE_QUERY_DEADLINE_HPP
@@ -4,10 +4,14 @@
 #include "engine/algorithm.hpp"
 #include "engine/internal_route_result.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/routing_cache.hpp"
+#include "engine/shortcut_cache.hpp"
+#include "engine/snap_cache.hpp"
 #include "engine/routing_algorithms/alternative_path.hpp"
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/map_matching.hpp"
+#include "engine/routing_algorithms/one_to_all.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/routing_algorithms/tile_turns.hpp"
 
@@ -21,7 +25,8 @@ class RoutingAlgorithmsInterface
   public:
     virtual InternalManyRoutesResult
     AlternativePathSearch(const PhantomNodes &phantom_node_pair,
-                          unsigned number_of_alternatives) const = 0;
+                          unsigned number_of_alternatives,
+                          const bool single_pass) const = 0;
 
     virtual InternalRouteResult
     ShortestPathSearch(const std::vector<PhantomNodes> &phantom_node_pair,
@@ -30,28 +35,44 @@ class RoutingAlgorithmsInterface
     virtual InternalRouteResult
     DirectShortestPathSearch(const PhantomNodes &phantom_node_pair) const = 0;
 
+    // distances_table gets the distances of the paths in meters if it is set, paths beyond the
+    // bounds are not searched
     virtual std::vector<EdgeWeight>
     ManyToManySearch(const std::vector<PhantomNode> &phantom_nodes,
                      const std::vector<std::size_t> &source_indices,
-                     const std::vector<std::size_t> &target_indices) const = 0;
+                     const std::vector<std::size_t> &target_indices,
+                     std::vector<double> *distances_table,
+                     const routing_algorithms::ManyToManyBounds &bounds) const = 0;
+
+    virtual std::vector<std::vector<routing_algorithms::NearestTarget>>
+    NearestTargetsSearch(const std::vector<PhantomNode> &phantom_nodes,
+                         const std::size_t number_of_nearest) const = 0;
+
+    virtual std::vector<EdgeDuration> OneToAllSearch(const PhantomNode &source_phantom,
+                                                     const EdgeDuration max_duration) const = 0;
 
     virtual routing_algorithms::SubMatchingList
     MapMatching(const routing_algorithms::CandidateLists &candidates_list,
                 const std::vector<util::Coordinate> &trace_coordinates,
                 const std::vector<unsigned> &trace_timestamps,
                 const std::vector<boost::optional<double>> &trace_gps_precision,
-                const bool allow_splitting) const = 0;
+                const bool allow_splitting,
+                routing_algorithms::TraceContinuation *continuation) const = 0;
 
     virtual std::vector<routing_algorithms::TurnData>
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
                  const std::vector<std::size_t> &sorted_edge_indexes) const = 0;
 
+    // Snapped phantom nodes cached across requests, caches nothing if it is disabled
+    virtual SnapCacheView GetSnapCache() const = 0;
+
     virtual bool HasAlternativePathSearch() const = 0;
     virtual bool HasShortestPathSearch() const = 0;
     virtual bool HasDirectShortestPathSearch() const = 0;
     virtual bool HasMapMatching() const = 0;
     virtual bool HasManyToManySearch() const = 0;
     virtual bool HasGetTileTurns() const = 0;
+    virtual bool HasOneToAllSearch() const = 0;
 };
 
 // Short-lived object passed to each plugin in request to wrap routing algorithms
@@ -60,15 +81,28 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
   public:
     RoutingAlgorithms(SearchEngineData<Algorithm> &heaps,
                       const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade)
-        : heaps(heaps), facade(facade)
+        : heaps(heaps), facade(facade), cache(nullptr), cache_epoch(0)
+    {
+    }
+
+    RoutingAlgorithms(SearchEngineData<Algorithm> &heaps,
+                      const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                      RoutingCache *cache,
+                      const unsigned cache_epoch,
+                      const SnapCacheView snap_cache = {},
+                      const ShortcutCacheView shortcut_cache = {})
+        : heaps(heaps), facade(facade), cache(cache), cache_epoch(cache_epoch),
+          snap_cache(snap_cache)
     {
+        this->heaps.shortcut_cache = shortcut_cache;
     }
 
     virtual ~RoutingAlgorithms() = default;
 
     InternalManyRoutesResult
     AlternativePathSearch(const PhantomNodes &phantom_node_pair,
-                          unsigned number_of_alternatives) const final override;
+                          unsigned number_of_alternatives,
+                          const bool single_pass) const final override;
 
     InternalRouteResult ShortestPathSearch(
         const std::vector<PhantomNodes> &phantom_node_pair,
@@ -80,19 +114,31 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
     std::vector<EdgeWeight>
     ManyToManySearch(const std::vector<PhantomNode> &phantom_nodes,
                      const std::vector<std::size_t> &source_indices,
-                     const std::vector<std::size_t> &target_indices) const final override;
+                     const std::vector<std::size_t> &target_indices,
+                     std::vector<double> *distances_table,
+                     const routing_algorithms::ManyToManyBounds &bounds) const final override;
+
+    std::vector<std::vector<routing_algorithms::NearestTarget>>
+    NearestTargetsSearch(const std::vector<PhantomNode> &phantom_nodes,
+                         const std::size_t number_of_nearest) const final override;
+
+    std::vector<EdgeDuration> OneToAllSearch(const PhantomNode &source_phantom,
+                                             const EdgeDuration max_duration) const final override;
 
     routing_algorithms::SubMatchingList
     MapMatching(const routing_algorithms::CandidateLists &candidates_list,
                 const std::vector<util::Coordinate> &trace_coordinates,
                 const std::vector<unsigned> &trace_timestamps,
                 const std::vector<boost::optional<double>> &trace_gps_precision,
-                const bool allow_splitting) const final override;
+                const bool allow_splitting,
+                routing_algorithms::TraceContinuation *continuation) const final override;
 
     std::vector<routing_algorithms::TurnData>
     GetTileTurns(const std::vector<datafacade::BaseDataFacade::RTreeLeaf> &edges,
                  const std::vector<std::size_t> &sorted_edge_indexes) const final override;
 
+    SnapCacheView GetSnapCache() const final override { return snap_cache; }
+
     bool HasAlternativePathSearch() const final override
     {
         return routing_algorithms::HasAlternativePathSearch<Algorithm>::value;
@@ -123,20 +169,33 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
         return routing_algorithms::HasGetTileTurns<Algorithm>::value;
     }
 
+    bool HasOneToAllSearch() const final override
+    {
+        return routing_algorithms::HasOneToAllSearch<Algorithm>::value;
+    }
+
   private:
-    SearchEngineData<Algorithm> &heaps;
+    // A copy of the search settings of the engine with the caches of this request, the heaps
+    // themselves are thread local
+    mutable SearchEngineData<Algorithm> heaps;
 
     // Owned by shared-ptr passed to the query
     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade;
+
+    // Optional cache of results across requests, owned by the engine
+    RoutingCache *cache;
+    unsigned cache_epoch;
+    SnapCacheView snap_cache;
 };
 
 template <typename Algorithm>
 InternalManyRoutesResult
 RoutingAlgorithms<Algorithm>::AlternativePathSearch(const PhantomNodes &phantom_node_pair,
-                                                    unsigned number_of_alternatives) const
+                                                    unsigned number_of_alternatives,
+                                                    const bool single_pass) const
 {
     return routing_algorithms::alternativePathSearch(
-        heaps, facade, phantom_node_pair, number_of_alternatives);
+        heaps, facade, phantom_node_pair, number_of_alternatives, single_pass);
 }
 
 template <typename Algorithm>
@@ -144,25 +203,132 @@ InternalRouteResult RoutingAlgorithms<Algorithm>::ShortestPathSearch(
     const std::vector<PhantomNodes> &phantom_node_pair,
     const boost::optional<bool> continue_straight_at_waypoint) const
 {
-    return routing_algorithms::shortestPathSearch(
+    if (!cache)
+    {
+        return routing_algorithms::shortestPathSearch(
+            heaps, facade, phantom_node_pair, continue_straight_at_waypoint);
+    }
+
+    const auto kind = !continue_straight_at_waypoint
+                          ? RoutingCache::RouteKind::Shortest
+                          : *continue_straight_at_waypoint
+                                ? RoutingCache::RouteKind::ShortestContinueStraight
+                                : RoutingCache::RouteKind::ShortestNoContinueStraight;
+    if (auto cached_route = cache->GetRoute(cache_epoch, kind, phantom_node_pair))
+    {
+        return std::move(*cached_route);
+    }
+
+    auto route = routing_algorithms::shortestPathSearch(
         heaps, facade, phantom_node_pair, continue_straight_at_waypoint);
+    cache->PutRoute(cache_epoch, kind, phantom_node_pair, route);
+    return route;
 }
 
 template <typename Algorithm>
 InternalRouteResult
 RoutingAlgorithms<Algorithm>::DirectShortestPathSearch(const PhantomNodes &phantom_nodes) const
 {
-    return routing_algorithms::directShortestPathSearch(heaps, facade, phantom_nodes);
+    if (!cache)
+    {
+        return routing_algorithms::directShortestPathSearch(heaps, facade, phantom_nodes);
+    }
+
+    const std::vector<PhantomNodes> legs{phantom_nodes};
+    if (auto cached_route = cache->GetRoute(cache_epoch, RoutingCache::RouteKind::Direct, legs))
+    {
+        return std::move(*cached_route);
+    }
+
+    auto route = routing_algorithms::directShortestPathSearch(heaps, facade, phantom_nodes);
+    cache->PutRoute(cache_epoch, RoutingCache::RouteKind::Direct, legs, route);
+    return route;
 }
 
 template <typename Algorithm>
 std::vector<EdgeWeight>
 RoutingAlgorithms<Algorithm>::ManyToManySearch(const std::vector<PhantomNode> &phantom_nodes,
                                                const std::vector<std::size_t> &source_indices,
-                                               const std::vector<std::size_t> &target_indices) const
+                                               const std::vector<std::size_t> &target_indices,
+                                               std::vector<double> *distances_table,
+                                               const routing_algorithms::ManyToManyBounds &bounds)
+    const
 {
-    return routing_algorithms::manyToManySearch(
+    // the cache only keeps unbounded durations
+    if (!cache || distances_table || bounds.IsBounded())
+    {
+        return routing_algorithms::manyToManySearch(heaps,
+                                                    facade,
+                                                    phantom_nodes,
+                                                    source_indices,
+                                                    target_indices,
+                                                    distances_table,
+                                                    bounds);
+    }
+
+    const auto number_of_sources =
+        source_indices.empty() ? phantom_nodes.size() : source_indices.size();
+    const auto number_of_targets =
+        target_indices.empty() ? phantom_nodes.size() : target_indices.size();
+    const auto source_phantom = [&](const std::size_t row) -> const PhantomNode & {
+        return source_indices.empty() ? phantom_nodes[row] : phantom_nodes[source_indices[row]];
+    };
+    const auto target_phantom = [&](const std::size_t column) -> const PhantomNode & {
+        return target_indices.empty() ? phantom_nodes[column]
+                                      : phantom_nodes[target_indices[column]];
+    };
+
+    // only skip the search if every entry of the table is known
+    std::vector<EdgeWeight> durations_table(number_of_sources * number_of_targets);
+    bool all_cached = true;
+    for (std::size_t row = 0; all_cached && row < number_of_sources; ++row)
+    {
+        for (std::size_t column = 0; all_cached && column < number_of_targets; ++column)
+        {
+            const auto duration =
+                cache->GetDuration(cache_epoch, source_phantom(row), target_phantom(column));
+            all_cached = static_cast<bool>(duration);
+            if (all_cached)
+            {
+                durations_table[row * number_of_targets + column] = *duration;
+            }
+        }
+    }
+    if (all_cached)
+    {
+        return durations_table;
+    }
+
+    durations_table = routing_algorithms::manyToManySearch(
         heaps, facade, phantom_nodes, source_indices, target_indices);
+    for (std::size_t row = 0; row < number_of_sources; ++row)
+    {
+        for (std::size_t column = 0; column < number_of_targets; ++column)
+        {
+            cache->PutDuration(cache_epoch,
+                               source_phantom(row),
+                               target_phantom(column),
+                               durations_table[row * number_of_targets + column]);
+        }
+    }
+    return durations_table;
+}
+
+template <typename Algorithm>
+std::vector<std::vector<routing_algorithms::NearestTarget>>
+RoutingAlgorithms<Algorithm>::NearestTargetsSearch(const std::vector<PhantomNode> &phantom_nodes,
+                                                   const std::size_t number_of_nearest) const
+{
+    return routing_algorithms::nearestTargetsSearch(
+        heaps, facade, phantom_nodes, number_of_nearest);
+}
+
+template <typename Algorithm>
+std::vector<EdgeDuration>
+RoutingAlgorithms<Algorithm>::OneToAllSearch(const PhantomNode &source_phantom,
+                                             const EdgeDuration max_duration) const
+{
+    return routing_algorithms::oneToAllSearch(heaps, facade, source_phantom, max_duration);
 }
 
 template <typename Algorithm>
@@ -171,7 +337,8 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
     const std::vector<util::Coordinate> &trace_coordinates,
     const std::vector<unsigned> &trace_timestamps,
     const std::vector<boost::optional<double>> &trace_gps_precision,
-    const bool allow_splitting) const
+    const bool allow_splitting,
+    routing_algorithms::TraceContinuation *continuation) const
 {
     return routing_algorithms::mapMatching(heaps,
                                            facade,
@@ -179,7 +346,8 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
                                            trace_coordinates,
                                            trace_timestamps,
                                            trace_gps_precision,
-                                           allow_splitting);
+                                           allow_splitting,
+                                           continuation);
 }
 
 template <typename Algorithm>
@@ -194,7 +362,8 @@ inline std::vector<routing_algorithms::TurnData> RoutingAlgorithms<Algorithm>::G
 template <>
 InternalManyRoutesResult inline RoutingAlgorithms<
     routing_algorithms::corech::Algorithm>::AlternativePathSearch(const PhantomNodes &,
-                                                                  unsigned) const
+                                                                  unsigned,
+                                                                  const bool) const
 {
     throw util::exception("AlternativePathSearch is disabled due to performance reasons");
 }
@@ -204,10 +373,28 @@ inline std::vector<EdgeWeight>
 RoutingAlgorithms<routing_algorithms::corech::Algorithm>::ManyToManySearch(
     const std::vector<PhantomNode> &,
     const std::vector<std::size_t> &,
-    const std::vector<std::size_t> &) const
+    const std::vector<std::size_t> &,
+    std::vector<double> *,
+    const routing_algorithms::ManyToManyBounds &) const
 {
     throw util::exception("ManyToManySearch is disabled due to performance reasons");
 }
+
+template <>
+inline std::vector<std::vector<routing_algorithms::NearestTarget>>
+RoutingAlgorithms<routing_algorithms::corech::Algorithm>::NearestTargetsSearch(
+    const std::vector<PhantomNode> &, const std::size_t) const
+{
+    throw util::exception("NearestTargetsSearch is disabled due to performance reasons");
+}
+
+template <>
+inline std::vector<EdgeDuration>
+RoutingAlgorithms<routing_algorithms::corech::Algorithm>::OneToAllSearch(const PhantomNode &,
+                                                                         const EdgeDuration) const
+{
+    throw util::exception("OneToAllSearch is not supported for a core that is not contracted");
+}
 } // ns engine
 } // ns osrm
 
@@ -16,17 +16,22 @@ namespace engine
 namespace routing_algorithms
 {
 
+// With single_pass the CH search ranks the via node candidates by the weight and sharing of
+// their paths in the search spaces of the shortest path, only the best candidates are verified
+// by searches of their own. MLD always searches like that and ignores it.
 InternalManyRoutesResult
 alternativePathSearch(SearchEngineData<ch::Algorithm> &search_engine_data,
                       const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
                       const PhantomNodes &phantom_node_pair,
-                      unsigned number_of_alternatives);
+                      unsigned number_of_alternatives,
+                      const bool single_pass);
 
 InternalManyRoutesResult
 alternativePathSearch(SearchEngineData<mld::Algorithm> &search_engine_data,
                       const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
                       const PhantomNodes &phantom_node_pair,
-                      unsigned number_of_alternatives);
+                      unsigned number_of_alternatives,
+                      const bool single_pass);
 
 } // namespace routing_algorithms
 } // namespace engine
@@ -0,0 +1,114 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_LANDMARK_POTENTIAL_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_LANDMARK_POTENTIAL_HPP
+
+#include "engine/phantom_node.hpp"
+#include "engine/routing_algorithms/routing_base.hpp"
+
+#include "util/landmarks.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Potential of plain Dijkstra searches
+struct ZeroPotential
+{
+    EdgeWeight operator()(const NodeID) const { return 0; }
+};
+
+// Lower bound of the weight from a node to the phantom node a search is directed to, given by
+// the landmarks and the keys the search from the phantom node started with. A forward search
+// is directed to the target of the query, a reverse search to its source.
+//
+// The keys of a heap of a goal directed search are the weights of its nodes plus their
+// potentials. The rounding of the landmark weights lets the potentials of adjacent nodes differ
+// by up to a unit more than the weight between them, so settled nodes might be reached again
+// with a smaller weight and need to be reinserted.
+template <bool DIRECTION> class LandmarkPotential
+{
+  public:
+    template <typename HeapT>
+    LandmarkPotential(const util::LandmarksView &landmarks_,
+                      const HeapT &opposite_heap,
+                      const PhantomNode &opposite_phantom)
+        : landmarks(landmarks_), number_of_seeds(0)
+    {
+        for (const auto &segment :
+             {opposite_phantom.forward_segment_id, opposite_phantom.reverse_segment_id})
+        {
+            if (segment.enabled && opposite_heap.WasInserted(segment.id))
+            {
+                seeds[number_of_seeds++] = {segment.id, opposite_heap.GetKey(segment.id)};
+            }
+        }
+    }
+
+    EdgeWeight operator()(const NodeID node) const
+    {
+        if (number_of_seeds == 0)
+            return 0;
+
+        EdgeWeight potential = INVALID_EDGE_WEIGHT;
+        for (const auto &seed : boost::make_iterator_range(seeds.begin(),
+                                                           seeds.begin() + number_of_seeds))
+        {
+            const auto bound = DIRECTION == FORWARD_DIRECTION
+                                   ? landmarks.GetLowerBound(node, seed.node)
+                                   : landmarks.GetLowerBound(seed.node, node);
+            potential = std::min(potential, bound + seed.weight);
+        }
+        return potential;
+    }
+
+  private:
+    struct Seed
+    {
+        NodeID node;
+        EdgeWeight weight;
+    };
+
+    const util::LandmarksView &landmarks;
+    std::array<Seed, 2> seeds;
+    std::size_t number_of_seeds;
+};
+
+// Adds the potentials to the keys of the nodes the heap starts with at the phantom node
+template <typename HeapT, typename PotentialT>
+void applyPotential(HeapT &heap, const PhantomNode &phantom, const PotentialT &potential)
+{
+    using Entry = std::tuple<NodeID, EdgeWeight, typename HeapT::DataType>;
+    std::vector<Entry> entries;
+    entries.reserve(2);
+    for (const auto &segment : {phantom.forward_segment_id, phantom.reverse_segment_id})
+    {
+        if (segment.enabled && heap.WasInserted(segment.id))
+        {
+            entries.emplace_back(segment.id, heap.GetKey(segment.id), heap.GetData(segment.id));
+        }
+    }
+
+    heap.Clear();
+    for (const auto &entry : entries)
+    {
+        const auto node = std::get<0>(entry);
+        heap.Insert(node, std::get<1>(entry) + potential(node), std::get<2>(entry));
+    }
+}
+}
+}
+}
+
+#endif
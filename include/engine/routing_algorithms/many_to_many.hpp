@@ -16,13 +16,49 @@ namespace engine
 namespace routing_algorithms
 {
 
+// Bounds of the paths of a table. The searches stop at paths beyond them, so tables that only
+// need nearby entries explore much smaller search spaces. Unbounded by default.
+struct ManyToManyBounds
+{
+    EdgeWeight max_weight = INVALID_EDGE_WEIGHT;
+    EdgeDuration max_duration = MAXIMAL_EDGE_DURATION;
+
+    bool IsBounded() const
+    {
+        return max_weight != INVALID_EDGE_WEIGHT || max_duration != MAXIMAL_EDGE_DURATION;
+    }
+};
+
+// Durations of the shortest paths between the sources and targets by rows, MAXIMAL_EDGE_DURATION
+// where there is none within the bounds. If distances_table is set it gets the distances of these
+// paths in meters, std::numeric_limits<double>::max() where there is none. Only the paths the
+// table found are unpacked for them.
 template <typename Algorithm>
 std::vector<EdgeWeight>
 manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                  const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                  const std::vector<PhantomNode> &phantom_nodes,
                  const std::vector<std::size_t> &source_indices,
-                 const std::vector<std::size_t> &target_indices);
+                 const std::vector<std::size_t> &target_indices,
+                 std::vector<double> *distances_table = nullptr,
+                 const ManyToManyBounds &bounds = {});
+
+// A location nearest to another one by weight and the duration to get there
+struct NearestTarget
+{
+    std::size_t index;
+    EdgeDuration duration;
+};
+
+// For each of the phantom nodes the up to number_of_nearest other phantom nodes with the
+// shortest paths from it, sorted by weight. Each forward search stops as soon as it cannot find
+// shorter paths than to the nearest phantom nodes it has, so far away ones are never probed.
+template <typename Algorithm>
+std::vector<std::vector<NearestTarget>>
+nearestTargetsSearch(SearchEngineData<Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     const std::vector<PhantomNode> &phantom_nodes,
+                     const std::size_t number_of_nearest);
 
 } // namespace routing_algorithms
 } // namespace engine
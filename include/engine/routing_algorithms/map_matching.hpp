@@ -20,6 +20,16 @@ using CandidateLists = std::vector<CandidateList>;
 using SubMatchingList = std::vector<map_matching::SubMatching>;
 static const constexpr double DEFAULT_GPS_PRECISION = 5;
 
+// Connects the parts of a trace that are matched by separate calls. The viterbi column of the
+// first point replaces its emission probabilities unless it is empty, the column of the last
+// point is returned for the next part and left empty if the last point could not be matched.
+// Traces that are matched by a single call pass no continuation.
+struct TraceContinuation
+{
+    std::vector<double> first_log_probabilities;
+    std::vector<double> last_log_probabilities;
+};
+
 //[1] "Hidden Markov Map Matching Through Noise and Sparseness";
 //     P. Newson and J. Krumm; 2009; ACM GIS
 template <typename Algorithm>
@@ -29,7 +39,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const std::vector<util::Coordinate> &trace_coordinates,
                             const std::vector<unsigned> &trace_timestamps,
                             const std::vector<boost::optional<double>> &trace_gps_precision,
-                            const bool allow_splitting);
+                            const bool allow_splitting,
+                            TraceContinuation *continuation);
 
 } // namespace routing_algorithms
 } // namespace engine
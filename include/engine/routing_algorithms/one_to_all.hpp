@@ -0,0 +1,61 @@
+#ifndef OSRM_ENGINE_ROUTING_ALGORITHMS_ONE_TO_ALL_HPP
+#define OSRM_ENGINE_ROUTING_ALGORITHMS_ONE_TO_ALL_HPP
+
+#include "engine/algorithm.hpp"
+#include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/search_engine_data.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+/// Durations of the shortest paths from the source to the start of every node of the graph,
+/// indexed by node id. Nodes further away than max_duration or not reachable at all are set to
+/// MAXIMAL_EDGE_DURATION, the nodes of the source segment have a duration of 0.
+///
+/// CH uses PHAST: an upward search from the source followed by a linear sweep over the
+/// downward edges of all nodes.
+std::vector<EdgeDuration>
+oneToAllSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+               const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+               const PhantomNode &source_phantom,
+               const EdgeDuration max_duration);
+
+/// MLD runs a multi-level Dijkstra bounded by max_duration. Cells are crossed with their overlay
+/// shortcuts and the search only descends into the cells that contain the source or that can't
+/// be crossed within the budget, so inside of cells covered completely only the border nodes
+/// get a duration.
+std::vector<EdgeDuration>
+oneToAllSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+               const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+               const PhantomNode &source_phantom,
+               const EdgeDuration max_duration);
+
+/// Number of sources restrictedManyToManySearch sweeps at the same time
+const constexpr std::size_t RESTRICTED_SWEEP_LANES = 8;
+
+/// Same result as manyToManySearch computed with RPHAST: the sweep is restricted to the nodes
+/// on the upward search spaces of the targets, which is selected once for all sources. The
+/// sources are swept in batches of RESTRICTED_SWEEP_LANES, one sweep costs about the same for
+/// a single source and a full batch.
+std::vector<EdgeWeight> restrictedManyToManySearch(
+    SearchEngineData<ch::Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+    const std::vector<PhantomNode> &phantom_nodes,
+    const std::vector<std::size_t> &source_indices,
+    const std::vector<std::size_t> &target_indices);
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
+
+#endif
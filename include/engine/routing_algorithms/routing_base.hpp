@@ -45,9 +45,8 @@ bool needsLoopForward(const PhantomNodes &phantoms);
 bool needsLoopBackwards(const PhantomNodes &phantoms);
 
 template <typename Heap>
-void insertNodesInHeaps(Heap &forward_heap, Heap &reverse_heap, const PhantomNodes &nodes)
+void insertSourceInForwardHeap(Heap &forward_heap, const PhantomNode &source)
 {
-    const auto &source = nodes.source_phantom;
     if (source.IsValidForwardSource())
     {
         forward_heap.Insert(source.forward_segment_id.id,
@@ -61,8 +60,11 @@ void insertNodesInHeaps(Heap &forward_heap, Heap &reverse_heap, const PhantomNod
                             -source.GetReverseWeightPlusOffset(),
                             source.reverse_segment_id.id);
     }
+}
 
-    const auto &target = nodes.target_phantom;
+template <typename Heap>
+void insertTargetInReverseHeap(Heap &reverse_heap, const PhantomNode &target)
+{
     if (target.IsValidForwardTarget())
     {
         reverse_heap.Insert(target.forward_segment_id.id,
@@ -78,6 +80,13 @@ void insertNodesInHeaps(Heap &forward_heap, Heap &reverse_heap, const PhantomNod
     }
 }
 
+template <typename Heap>
+void insertNodesInHeaps(Heap &forward_heap, Heap &reverse_heap, const PhantomNodes &nodes)
+{
+    insertSourceInForwardHeap(forward_heap, nodes.source_phantom);
+    insertTargetInReverseHeap(reverse_heap, nodes.target_phantom);
+}
+
 template <typename ManyToManyQueryHeap>
 void insertSourceInHeap(ManyToManyQueryHeap &heap, const PhantomNode &phantom_node)
 {
@@ -141,111 +150,86 @@ void annotatePath(const FacadeT &facade,
         const auto turn_id = edge_data.turn_id; // edge-based graph edge index
         const auto node_id = *node_from;        // edge-based graph node index
         const auto name_index = facade.GetNameIndex(node_id);
-        const auto turn_instruction = facade.GetTurnInstructionForEdgeID(turn_id);
         const extractor::TravelMode travel_mode = facade.GetTravelMode(node_id);
         const auto classes = facade.GetClassData(node_id);
 
         const auto geometry_index = facade.GetGeometryIndex(node_id);
-        std::vector<NodeID> id_vector;
+        const bool is_first_segment = unpacked_path.empty();
+
+        // the geometry is read in place, the ranges of both directions only differ in type
+        const auto annotate_geometry = [&](const auto &id_range,
+                                           const auto &weight_range,
+                                           const auto &duration_range,
+                                           const auto &datasource_range) {
+            BOOST_ASSERT(id_range.size() > 0);
+            BOOST_ASSERT(datasource_range.size() > 0);
+            BOOST_ASSERT(weight_range.size() == id_range.size() - 1);
+            BOOST_ASSERT(duration_range.size() == id_range.size() - 1);
+
+            const std::size_t start_index =
+                (is_first_segment
+                     ? ((start_traversed_in_reverse)
+                            ? weight_range.size() -
+                                  phantom_node_pair.source_phantom.fwd_segment_position - 1
+                            : phantom_node_pair.source_phantom.fwd_segment_position)
+                     : 0);
+            const std::size_t end_index = weight_range.size();
+
+            BOOST_ASSERT(start_index >= 0);
+            BOOST_ASSERT(start_index < end_index);
+            for (std::size_t segment_idx = start_index; segment_idx < end_index; ++segment_idx)
+            {
+                unpacked_path.push_back(
+                    PathData{id_range[segment_idx + 1],
+                             name_index,
+                             static_cast<EdgeWeight>(weight_range[segment_idx]),
+                             static_cast<EdgeWeight>(duration_range[segment_idx]),
+                             extractor::guidance::TurnInstruction::NO_TURN(),
+                             {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
+                             travel_mode,
+                             classes,
+                             EMPTY_ENTRY_CLASS,
+                             datasource_range[segment_idx],
+                             util::guidance::TurnBearing(0),
+                             util::guidance::TurnBearing(0)});
+            }
+        };
 
-        std::vector<EdgeWeight> weight_vector;
-        std::vector<EdgeWeight> duration_vector;
-        std::vector<DatasourceID> datasource_vector;
         if (geometry_index.forward)
         {
-            id_vector = facade.GetUncompressedForwardGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedForwardWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedForwardDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedForwardDatasources(geometry_index.id);
+            annotate_geometry(facade.GetUncompressedForwardGeometry(geometry_index.id),
+                              facade.GetUncompressedForwardWeights(geometry_index.id),
+                              facade.GetUncompressedForwardDurations(geometry_index.id),
+                              facade.GetUncompressedForwardDatasources(geometry_index.id));
         }
         else
         {
-            id_vector = facade.GetUncompressedReverseGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedReverseWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedReverseDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedReverseDatasources(geometry_index.id);
-        }
-        BOOST_ASSERT(id_vector.size() > 0);
-        BOOST_ASSERT(datasource_vector.size() > 0);
-        BOOST_ASSERT(weight_vector.size() == id_vector.size() - 1);
-        BOOST_ASSERT(duration_vector.size() == id_vector.size() - 1);
-        const bool is_first_segment = unpacked_path.empty();
-
-        const std::size_t start_index =
-            (is_first_segment ? ((start_traversed_in_reverse)
-                                     ? weight_vector.size() -
-                                           phantom_node_pair.source_phantom.fwd_segment_position - 1
-                                     : phantom_node_pair.source_phantom.fwd_segment_position)
-                              : 0);
-        const std::size_t end_index = weight_vector.size();
-
-        BOOST_ASSERT(start_index >= 0);
-        BOOST_ASSERT(start_index < end_index);
-        for (std::size_t segment_idx = start_index; segment_idx < end_index; ++segment_idx)
-        {
-            unpacked_path.push_back(PathData{id_vector[segment_idx + 1],
-                                             name_index,
-                                             weight_vector[segment_idx],
-                                             duration_vector[segment_idx],
-                                             extractor::guidance::TurnInstruction::NO_TURN(),
-                                             {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
-                                             travel_mode,
-                                             classes,
-                                             EMPTY_ENTRY_CLASS,
-                                             datasource_vector[segment_idx],
-                                             util::guidance::TurnBearing(0),
-                                             util::guidance::TurnBearing(0)});
+            annotate_geometry(facade.GetUncompressedReverseGeometry(geometry_index.id),
+                              facade.GetUncompressedReverseWeights(geometry_index.id),
+                              facade.GetUncompressedReverseDurations(geometry_index.id),
+                              facade.GetUncompressedReverseDatasources(geometry_index.id));
         }
         BOOST_ASSERT(unpacked_path.size() > 0);
+        unpacked_path.back().duration_until_turn += facade.GetDurationPenaltyForEdgeID(turn_id);
+        unpacked_path.back().weight_until_turn += facade.GetWeightPenaltyForEdgeID(turn_id);
+
+        // routing-only datasets have no turn data, the turns stay NO_TURN
+        if (!facade.HasGuidanceData())
+            continue;
+
         if (facade.HasLaneData(turn_id))
             unpacked_path.back().lane_data = facade.GetLaneData(turn_id);
 
         unpacked_path.back().entry_class = facade.GetEntryClass(turn_id);
-        unpacked_path.back().turn_instruction = turn_instruction;
-        unpacked_path.back().duration_until_turn += facade.GetDurationPenaltyForEdgeID(turn_id);
-        unpacked_path.back().weight_until_turn += facade.GetWeightPenaltyForEdgeID(turn_id);
+        unpacked_path.back().turn_instruction = facade.GetTurnInstructionForEdgeID(turn_id);
         unpacked_path.back().pre_turn_bearing = facade.PreTurnBearing(turn_id);
         unpacked_path.back().post_turn_bearing = facade.PostTurnBearing(turn_id);
     }
 
-    std::size_t start_index = 0, end_index = 0;
-    std::vector<unsigned> id_vector;
-    std::vector<EdgeWeight> weight_vector;
-    std::vector<EdgeWeight> duration_vector;
-    std::vector<DatasourceID> datasource_vector;
     const auto source_geometry_id = facade.GetGeometryIndex(source_node_id).id;
     const auto target_geometry_id = facade.GetGeometryIndex(target_node_id).id;
     const auto is_local_path = source_geometry_id == target_geometry_id && unpacked_path.empty();
 
-    if (target_traversed_in_reverse)
-    {
-        id_vector = facade.GetUncompressedReverseGeometry(target_geometry_id);
-        weight_vector = facade.GetUncompressedReverseWeights(target_geometry_id);
-        duration_vector = facade.GetUncompressedReverseDurations(target_geometry_id);
-        datasource_vector = facade.GetUncompressedReverseDatasources(target_geometry_id);
-
-        if (is_local_path)
-        {
-            start_index =
-                weight_vector.size() - phantom_node_pair.source_phantom.fwd_segment_position - 1;
-        }
-        end_index =
-            weight_vector.size() - phantom_node_pair.target_phantom.fwd_segment_position - 1;
-    }
-    else
-    {
-        if (is_local_path)
-        {
-            start_index = phantom_node_pair.source_phantom.fwd_segment_position;
-        }
-        end_index = phantom_node_pair.target_phantom.fwd_segment_position;
-
-        id_vector = facade.GetUncompressedForwardGeometry(target_geometry_id);
-        weight_vector = facade.GetUncompressedForwardWeights(target_geometry_id);
-        duration_vector = facade.GetUncompressedForwardDurations(target_geometry_id);
-        datasource_vector = facade.GetUncompressedForwardDatasources(target_geometry_id);
-    }
-
     // Given the following compressed geometry:
     // U---v---w---x---y---Z
     //    s           t
@@ -253,24 +237,62 @@ void annotatePath(const FacadeT &facade,
     // t: fwd_segment 3
     // -> (U, v), (v, w), (w, x)
     // note that (x, t) is _not_ included but needs to be added later.
-    for (std::size_t segment_idx = start_index; segment_idx != end_index;
-         (start_index < end_index ? ++segment_idx : --segment_idx))
+    const auto annotate_target_geometry = [&](const auto &id_range,
+                                              const auto &weight_range,
+                                              const auto &duration_range,
+                                              const auto &datasource_range,
+                                              const std::size_t start_index,
+                                              const std::size_t end_index) {
+        for (std::size_t segment_idx = start_index; segment_idx != end_index;
+             (start_index < end_index ? ++segment_idx : --segment_idx))
+        {
+            BOOST_ASSERT(segment_idx < id_range.size() - 1);
+            BOOST_ASSERT(facade.GetTravelMode(target_node_id) > 0);
+            unpacked_path.push_back(
+                PathData{id_range[start_index < end_index ? segment_idx + 1 : segment_idx - 1],
+                         facade.GetNameIndex(target_node_id),
+                         static_cast<EdgeWeight>(weight_range[segment_idx]),
+                         static_cast<EdgeWeight>(duration_range[segment_idx]),
+                         extractor::guidance::TurnInstruction::NO_TURN(),
+                         {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
+                         facade.GetTravelMode(target_node_id),
+                         facade.GetClassData(target_node_id),
+                         EMPTY_ENTRY_CLASS,
+                         datasource_range[segment_idx],
+                         util::guidance::TurnBearing(0),
+                         util::guidance::TurnBearing(0)});
+        }
+    };
+
+    if (target_traversed_in_reverse)
     {
-        BOOST_ASSERT(segment_idx < id_vector.size() - 1);
-        BOOST_ASSERT(facade.GetTravelMode(target_node_id) > 0);
-        unpacked_path.push_back(
-            PathData{id_vector[start_index < end_index ? segment_idx + 1 : segment_idx - 1],
-                     facade.GetNameIndex(target_node_id),
-                     weight_vector[segment_idx],
-                     duration_vector[segment_idx],
-                     extractor::guidance::TurnInstruction::NO_TURN(),
-                     {{0, INVALID_LANEID}, INVALID_LANE_DESCRIPTIONID},
-                     facade.GetTravelMode(target_node_id),
-                     facade.GetClassData(target_node_id),
-                     EMPTY_ENTRY_CLASS,
-                     datasource_vector[segment_idx],
-                     util::guidance::TurnBearing(0),
-                     util::guidance::TurnBearing(0)});
+        const auto weight_range = facade.GetUncompressedReverseWeights(target_geometry_id);
+        const std::size_t start_index =
+            is_local_path
+                ? weight_range.size() - phantom_node_pair.source_phantom.fwd_segment_position - 1
+                : 0;
+        const std::size_t end_index =
+            weight_range.size() - phantom_node_pair.target_phantom.fwd_segment_position - 1;
+
+        annotate_target_geometry(facade.GetUncompressedReverseGeometry(target_geometry_id),
+                                 weight_range,
+                                 facade.GetUncompressedReverseDurations(target_geometry_id),
+                                 facade.GetUncompressedReverseDatasources(target_geometry_id),
+                                 start_index,
+                                 end_index);
+    }
+    else
+    {
+        const std::size_t start_index =
+            is_local_path ? phantom_node_pair.source_phantom.fwd_segment_position : 0;
+        const std::size_t end_index = phantom_node_pair.target_phantom.fwd_segment_position;
+
+        annotate_target_geometry(facade.GetUncompressedForwardGeometry(target_geometry_id),
+                                 facade.GetUncompressedForwardWeights(target_geometry_id),
+                                 facade.GetUncompressedForwardDurations(target_geometry_id),
+                                 facade.GetUncompressedForwardDatasources(target_geometry_id),
+                                 start_index,
+                                 end_index);
     }
 
     if (unpacked_path.size() > 0)
@@ -321,55 +343,21 @@ void annotatePath(const FacadeT &facade,
 
 template <typename Algorithm>
 double getPathDistance(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                       const std::vector<PathData> unpacked_path,
+                       const std::vector<PathData> &unpacked_path,
                        const PhantomNode &source_phantom,
                        const PhantomNode &target_phantom)
 {
-    using util::coordinate_calculation::detail::DEGREE_TO_RAD;
-    using util::coordinate_calculation::detail::EARTH_RADIUS;
-
-    double distance = 0;
-    double prev_lat =
-        static_cast<double>(util::toFloating(source_phantom.location.lat)) * DEGREE_TO_RAD;
-    double prev_lon =
-        static_cast<double>(util::toFloating(source_phantom.location.lon)) * DEGREE_TO_RAD;
-    double prev_cos = std::cos(prev_lat);
+    // the distances between consecutive coordinates of the path are computed in batches
+    std::vector<util::Coordinate> coordinates;
+    coordinates.reserve(unpacked_path.size() + 2);
+    coordinates.push_back(source_phantom.location);
     for (const auto &p : unpacked_path)
     {
-        const auto current_coordinate = facade.GetCoordinateOfNode(p.turn_via_node);
-
-        const double current_lat =
-            static_cast<double>(util::toFloating(current_coordinate.lat)) * DEGREE_TO_RAD;
-        const double current_lon =
-            static_cast<double>(util::toFloating(current_coordinate.lon)) * DEGREE_TO_RAD;
-        const double current_cos = std::cos(current_lat);
-
-        const double sin_dlon = std::sin((prev_lon - current_lon) / 2.0);
-        const double sin_dlat = std::sin((prev_lat - current_lat) / 2.0);
-
-        const double aharv = sin_dlat * sin_dlat + prev_cos * current_cos * sin_dlon * sin_dlon;
-        const double charv = 2. * std::atan2(std::sqrt(aharv), std::sqrt(1.0 - aharv));
-        distance += EARTH_RADIUS * charv;
-
-        prev_lat = current_lat;
-        prev_lon = current_lon;
-        prev_cos = current_cos;
+        coordinates.push_back(facade.GetCoordinateOfNode(p.turn_via_node));
     }
+    coordinates.push_back(target_phantom.location);
 
-    const double current_lat =
-        static_cast<double>(util::toFloating(target_phantom.location.lat)) * DEGREE_TO_RAD;
-    const double current_lon =
-        static_cast<double>(util::toFloating(target_phantom.location.lon)) * DEGREE_TO_RAD;
-    const double current_cos = std::cos(current_lat);
-
-    const double sin_dlon = std::sin((prev_lon - current_lon) / 2.0);
-    const double sin_dlat = std::sin((prev_lat - current_lat) / 2.0);
-
-    const double aharv = sin_dlat * sin_dlat + prev_cos * current_cos * sin_dlon * sin_dlon;
-    const double charv = 2. * std::atan2(std::sqrt(aharv), std::sqrt(1.0 - aharv));
-    distance += EARTH_RADIUS * charv;
-
-    return distance;
+    return util::coordinate_calculation::haversineLength(coordinates.data(), coordinates.size());
 }
 
 template <typename AlgorithmT>
@@ -5,11 +5,18 @@
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
+#include "engine/shortcut_cache.hpp"
 
+#include "util/request_timing.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -21,64 +28,79 @@ namespace routing_algorithms
 namespace ch
 {
 
-// Stalling
-template <bool DIRECTION, typename HeapT>
-bool stallAtNode(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                 const NodeID node,
-                 const EdgeWeight weight,
-                 const HeapT &query_heap)
+// Calls the callback with the target and weight of the edges of the node that can be taken in
+// the direction, decoded from the compressed search graph if the dataset has one. Stops at the
+// first edge the callback returns true for and returns whether there was one.
+template <bool DIRECTION, typename CallbackT>
+bool anyAdjacentEdge(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     const NodeID node,
+                     CallbackT &&callback)
 {
-    for (auto edge : facade.GetAdjacentEdgeRange(node))
+    const auto &compressed_graph = facade.GetCompressedSearchGraph();
+    if (compressed_graph.GetNumberOfNodes() > 0)
     {
-        const auto &data = facade.GetEdgeData(edge);
-        if (DIRECTION == REVERSE_DIRECTION ? data.forward : data.backward)
+        for (const auto &edge : compressed_graph.GetAdjacentEdges(node))
         {
-            const NodeID to = facade.GetTarget(edge);
-            const EdgeWeight edge_weight = data.weight;
-            BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
-            if (query_heap.WasInserted(to))
+            if ((DIRECTION == FORWARD_DIRECTION ? edge.forward : edge.backward) &&
+                callback(edge.target, edge.weight))
             {
-                if (query_heap.GetKey(to) + edge_weight < weight)
-                {
-                    return true;
-                }
+                return true;
             }
         }
+        return false;
     }
-    return false;
-}
 
-template <bool DIRECTION>
-void relaxOutgoingEdges(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                        const NodeID node,
-                        const EdgeWeight weight,
-                        SearchEngineData<Algorithm>::QueryHeap &heap)
-{
     for (const auto edge : facade.GetAdjacentEdgeRange(node))
     {
         const auto &data = facade.GetEdgeData(edge);
-        if (DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward)
+        if ((DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward) &&
+            callback(facade.GetTarget(edge), data.weight))
         {
-            const NodeID to = facade.GetTarget(edge);
-            const EdgeWeight edge_weight = data.weight;
+            return true;
+        }
+    }
+    return false;
+}
 
+// Stalling
+template <bool DIRECTION, typename HeapT>
+bool stallAtNode(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                 const NodeID node,
+                 const EdgeWeight weight,
+                 const HeapT &query_heap)
+{
+    // the edges into the node, the search direction is their opposite
+    return anyAdjacentEdge<!DIRECTION>(
+        facade, node, [&](const NodeID to, const EdgeWeight edge_weight) {
             BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
-            const EdgeWeight to_weight = weight + edge_weight;
+            return query_heap.WasInserted(to) && query_heap.GetKey(to) + edge_weight < weight;
+        });
+}
 
-            // New Node discovered -> Add to Heap + Node Info Storage
-            if (!heap.WasInserted(to))
-            {
-                heap.Insert(to, to_weight, node);
-            }
-            // Found a shorter Path -> Update weight
-            else if (to_weight < heap.GetKey(to))
-            {
-                // new parent
-                heap.GetData(to).parent = node;
-                heap.DecreaseKey(to, to_weight);
-            }
+template <bool DIRECTION, typename HeapT>
+void relaxOutgoingEdges(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                        const NodeID node,
+                        const EdgeWeight weight,
+                        HeapT &heap)
+{
+    anyAdjacentEdge<DIRECTION>(facade, node, [&](const NodeID to, const EdgeWeight edge_weight) {
+        BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
+        const EdgeWeight to_weight = weight + edge_weight;
+
+        // New Node discovered -> Add to Heap + Node Info Storage
+        if (!heap.WasInserted(to))
+        {
+            heap.Insert(to, to_weight, node);
         }
-    }
+        // Found a shorter Path -> Update weight
+        else if (to_weight < heap.GetKey(to))
+        {
+            // new parent
+            heap.GetData(to).parent = node;
+            heap.DecreaseKey(to, to_weight);
+        }
+        return false;
+    });
 }
 
 /*
@@ -112,10 +134,11 @@ we need to add an offset to the termination criterion.
 */
 static constexpr bool ENABLE_STALLING = true;
 static constexpr bool DISABLE_STALLING = false;
-template <bool DIRECTION, bool STALLING = ENABLE_STALLING>
+// The heaps are query heaps or their views for one storage type, see util::QueryHeap::StorageView
+template <bool DIRECTION, bool STALLING = ENABLE_STALLING, typename HeapT>
 void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                 SearchEngineData<Algorithm>::QueryHeap &forward_heap,
-                 SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                 HeapT &forward_heap,
+                 HeapT &reverse_heap,
                  NodeID &middle_node_id,
                  EdgeWeight &upper_bound,
                  EdgeWeight min_edge_offset,
@@ -138,15 +161,10 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                 new_weight < 0)
             {
                 // check whether there is a loop present at the node
-                for (const auto edge : facade.GetAdjacentEdgeRange(node))
-                {
-                    const auto &data = facade.GetEdgeData(edge);
-                    if (DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward)
-                    {
-                        const NodeID to = facade.GetTarget(edge);
+                anyAdjacentEdge<DIRECTION>(
+                    facade, node, [&](const NodeID to, const EdgeWeight edge_weight) {
                         if (to == node)
                         {
-                            const EdgeWeight edge_weight = data.weight;
                             const EdgeWeight loop_weight = new_weight + edge_weight;
                             if (loop_weight >= 0 && loop_weight < upper_bound)
                             {
@@ -154,8 +172,8 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                                 upper_bound = loop_weight;
                             }
                         }
-                    }
-                }
+                        return false;
+                    });
             }
             else
             {
@@ -206,6 +224,34 @@ EdgeWeight getLoopWeight(const datafacade::ContiguousInternalMemoryDataFacade<Al
     return loop_weight;
 }
 
+/**
+ * Finds the CH edge a packed path takes from one node to the next one.
+ */
+inline EdgeID
+findPackedEdge(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+               const NodeID from,
+               const NodeID to)
+{
+    // Look for an edge on the forward CH graph (.forward)
+    EdgeID smaller_edge_id =
+        facade.FindSmallestEdge(from, to, [](const auto &data) { return data.forward; });
+    if (SPECIAL_EDGEID != smaller_edge_id)
+    {
+        return smaller_edge_id;
+    }
+
+    // If we didn't find one there, the we might be looking at a part of the path that
+    // was found using the backward search.  Here, we flip the node order (to, from)
+    // and only consider edges with the `.backward` flag.
+    smaller_edge_id =
+        facade.FindSmallestEdge(to, from, [](const auto &data) { return data.backward; });
+
+    // If we didn't find anything *still*, then something is broken and someone has
+    // called this function with bad values.
+    BOOST_ASSERT_MSG(smaller_edge_id != SPECIAL_EDGEID, "Invalid smaller edge ID");
+    return smaller_edge_id;
+}
+
 /**
  * Given a sequence of connected `NodeID`s in the CH graph, performs a depth-first unpacking of
  * the shortcut
@@ -251,22 +297,7 @@ void unpackPath(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
         edge = recursion_stack.top();
         recursion_stack.pop();
 
-        // Look for an edge on the forward CH graph (.forward)
-        EdgeID smaller_edge_id = facade.FindSmallestEdge(
-            edge.first, edge.second, [](const auto &data) { return data.forward; });
-
-        // If we didn't find one there, the we might be looking at a part of the path that
-        // was found using the backward search.  Here, we flip the node order (.second, .first)
-        // and only consider edges with the `.backward` flag.
-        if (SPECIAL_EDGEID == smaller_edge_id)
-        {
-            smaller_edge_id = facade.FindSmallestEdge(
-                edge.second, edge.first, [](const auto &data) { return data.backward; });
-        }
-
-        // If we didn't find anything *still*, then something is broken and someone has
-        // called this function with bad values.
-        BOOST_ASSERT_MSG(smaller_edge_id != SPECIAL_EDGEID, "Invalid smaller edge ID");
+        const EdgeID smaller_edge_id = findPackedEdge(facade, edge.first, edge.second);
 
         const auto &data = facade.GetEdgeData(smaller_edge_id);
         BOOST_ASSERT_MSG(data.weight != std::numeric_limits<EdgeWeight>::max(),
@@ -289,13 +320,77 @@ void unpackPath(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
     }
 }
 
+/**
+ * Unpacks a packed path like the above, but looks up the shortcuts of the path in the shortcut
+ * cache first. Shortcuts that are not cached yet are unpacked and added to it unless they bridge
+ * too few original edges to be worth it.
+ */
+template <typename BidirectionalIterator, typename Callback>
+void unpackPath(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                BidirectionalIterator packed_path_begin,
+                BidirectionalIterator packed_path_end,
+                const ShortcutCacheView &shortcut_cache,
+                Callback &&callback)
+{
+    if (!shortcut_cache)
+    {
+        unpackPath(facade, packed_path_begin, packed_path_end, std::forward<Callback>(callback));
+        return;
+    }
+
+    // make sure we have at least something to unpack
+    if (packed_path_begin == packed_path_end)
+        return;
+
+    for (auto current = packed_path_begin; std::next(current) != packed_path_end; ++current)
+    {
+        std::pair<NodeID, NodeID> edge{*current, *std::next(current)};
+        const auto packed_edge_id = findPackedEdge(facade, edge.first, edge.second);
+
+        if (!facade.GetEdgeData(packed_edge_id).shortcut)
+        {
+            std::forward<Callback>(callback)(edge, packed_edge_id);
+            continue;
+        }
+
+        // the unpacking only depends on the nodes the packed path goes through
+        auto unpacked = shortcut_cache.Get(0, edge.first, edge.second);
+        if (!unpacked)
+        {
+            auto unpacked_edges = std::make_shared<std::vector<ShortcutCache::UnpackedEdge>>();
+            const std::array<NodeID, 2> shortcut{{edge.first, edge.second}};
+            unpackPath(facade,
+                       shortcut.begin(),
+                       shortcut.end(),
+                       [&unpacked_edges](std::pair<NodeID, NodeID> &original_edge,
+                                         const EdgeID original_edge_id) {
+                           unpacked_edges->push_back({original_edge.second, original_edge_id});
+                       });
+            unpacked = ShortcutCache::UnpackedShortcut{std::move(unpacked_edges)};
+            if ((*unpacked)->size() >= ShortcutCache::MIN_UNPACKED_EDGES)
+            {
+                shortcut_cache.Put(0, edge.first, edge.second, *unpacked);
+            }
+        }
+
+        for (const auto &original : **unpacked)
+        {
+            std::pair<NodeID, NodeID> original_edge{edge.first, original.target};
+            std::forward<Callback>(callback)(original_edge, original.edge);
+            edge.first = original.target;
+        }
+    }
+}
+
 template <typename RandomIter, typename FacadeT>
 void unpackPath(const FacadeT &facade,
                 RandomIter packed_path_begin,
                 RandomIter packed_path_end,
                 const PhantomNodes &phantom_nodes,
-                std::vector<PathData> &unpacked_path)
+                std::vector<PathData> &unpacked_path,
+                const ShortcutCacheView &shortcut_cache = {})
 {
+    util::ScopedStageTimer unpack_timer(util::RequestStage::Unpack);
     const auto nodes_number = std::distance(packed_path_begin, packed_path_end);
     BOOST_ASSERT(nodes_number > 0);
 
@@ -310,6 +405,7 @@ void unpackPath(const FacadeT &facade,
         unpackPath(facade,
                    packed_path_begin,
                    packed_path_end,
+                   shortcut_cache,
                    [&](std::pair<NodeID, NodeID> &edge, const auto &edge_id) {
                        BOOST_ASSERT(edge.first == unpacked_nodes.back());
                        unpacked_nodes.push_back(edge.second);
@@ -376,6 +472,18 @@ getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
                    const PhantomNode &target_phantom,
                    int duration_upper_bound = INVALID_EDGE_WEIGHT);
 
+// Network distances from the source to each of the targets, std::numeric_limits<double>::max()
+// for targets without a path below the upper bound. The searches from the targets all meet
+// the same search from the source, which settles its nodes below the bound only once.
+std::vector<double>
+getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                    const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                    SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const PhantomNode &source_phantom,
+                    const std::vector<PhantomNode> &target_phantoms,
+                    int weight_upper_bound = INVALID_EDGE_WEIGHT);
+
 } // namespace ch
 
 namespace corech
@@ -412,14 +520,27 @@ getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
                    const PhantomNode &target_phantom,
                    int duration_upper_bound = INVALID_EDGE_WEIGHT);
 
+// Network distances from the source to each of the targets, the core search depends on both
+// ends so every target is searched on its own
+std::vector<double>
+getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                    const datafacade::ContiguousInternalMemoryDataFacade<corech::Algorithm> &facade,
+                    SearchEngineData<ch::Algorithm>::QueryHeap &forward_heap,
+                    SearchEngineData<ch::Algorithm>::QueryHeap &reverse_heap,
+                    const PhantomNode &source_phantom,
+                    const std::vector<PhantomNode> &target_phantoms,
+                    int weight_upper_bound = INVALID_EDGE_WEIGHT);
+
 template <typename RandomIter, typename FacadeT>
 void unpackPath(const FacadeT &facade,
                 RandomIter packed_path_begin,
                 RandomIter packed_path_end,
                 const PhantomNodes &phantom_nodes,
-                std::vector<PathData> &unpacked_path)
+                std::vector<PathData> &unpacked_path,
+                const ShortcutCacheView &shortcut_cache = {})
 {
-    return ch::unpackPath(facade, packed_path_begin, packed_path_end, phantom_nodes, unpacked_path);
+    return ch::unpackPath(
+        facade, packed_path_begin, packed_path_end, phantom_nodes, unpacked_path, shortcut_cache);
 }
 
 } // namespace corech
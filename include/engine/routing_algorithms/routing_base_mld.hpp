@@ -2,10 +2,15 @@
 #define OSRM_ENGINE_ROUTING_BASE_MLD_HPP
 
 #include "engine/algorithm.hpp"
+#include "engine/conditional_turns.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/routing_algorithms/landmark_potential.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
+#include "engine/shortcut_cache.hpp"
 
+#include "util/integer_range.hpp"
+#include "util/request_timing.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
@@ -13,7 +18,9 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -27,6 +34,18 @@ namespace mld
 
 namespace
 {
+// Keeps the node below the cells with turns restricted at the departure time of the query,
+// their shortcuts might take the turns. The level of the node stays consistent with the ones
+// of its neighbours, as a cell with a restricted turn is inside of one on every higher level.
+inline LevelID getUnrestrictedLevel(const partition::MultiLevelPartitionView &partition,
+                                    const NodeID node,
+                                    const LevelID level)
+{
+    const auto *conditional_turns = CurrentConditionalTurns();
+    return conditional_turns ? conditional_turns->GetUnrestrictedLevel(partition, node, level)
+                             : level;
+}
+
 // Unrestricted search (Args is const PhantomNodes &):
 //   * use partition.GetQueryLevel to find the node query level based on source and target phantoms
 //   * allow to traverse all cells
@@ -39,17 +58,26 @@ inline LevelID getNodeQueryLevel(const partition::MultiLevelPartitionView &parti
             return partition.GetQueryLevel(source.id, target.id, node);
         return INVALID_LEVEL_ID;
     };
-    return std::min(std::min(level(phantom_nodes.source_phantom.forward_segment_id,
-                                   phantom_nodes.target_phantom.forward_segment_id),
-                             level(phantom_nodes.source_phantom.forward_segment_id,
-                                   phantom_nodes.target_phantom.reverse_segment_id)),
-                    std::min(level(phantom_nodes.source_phantom.reverse_segment_id,
-                                   phantom_nodes.target_phantom.forward_segment_id),
-                             level(phantom_nodes.source_phantom.reverse_segment_id,
-                                   phantom_nodes.target_phantom.reverse_segment_id)));
+    return getUnrestrictedLevel(
+        partition,
+        node,
+        std::min(std::min(level(phantom_nodes.source_phantom.forward_segment_id,
+                                phantom_nodes.target_phantom.forward_segment_id),
+                          level(phantom_nodes.source_phantom.forward_segment_id,
+                                phantom_nodes.target_phantom.reverse_segment_id)),
+                 std::min(level(phantom_nodes.source_phantom.reverse_segment_id,
+                                phantom_nodes.target_phantom.forward_segment_id),
+                          level(phantom_nodes.source_phantom.reverse_segment_id,
+                                phantom_nodes.target_phantom.reverse_segment_id))));
 }
 
-inline bool checkParentCellRestriction(CellID, const PhantomNodes &) { return true; }
+inline bool checkParentCellRestriction(const partition::MultiLevelPartitionView &,
+                                       LevelID,
+                                       NodeID,
+                                       const PhantomNodes &)
+{
+    return true;
+}
 
 // Restricted search (Args is LevelID, CellID):
 //   * use the fixed level for queries
@@ -60,9 +88,83 @@ getNodeQueryLevel(const partition::MultiLevelPartitionView &, NodeID, LevelID le
     return level;
 }
 
-inline bool checkParentCellRestriction(CellID cell, LevelID, CellID parent)
+inline bool checkParentCellRestriction(const partition::MultiLevelPartitionView &partition,
+                                       LevelID level,
+                                       NodeID node,
+                                       LevelID,
+                                       CellID parent)
 {
-    return cell == parent;
+    return partition.GetCell(level + 1, node) == parent;
+}
+
+// Local search around one end of a query between top level cells (Args is const PhantomNodes &,
+// LevelID, CellID):
+//   * use partition.GetQueryLevel like the unrestricted search
+//   * only traverse the specified cell of the top level
+inline LevelID getNodeQueryLevel(const partition::MultiLevelPartitionView &partition,
+                                 NodeID node,
+                                 const PhantomNodes &phantom_nodes,
+                                 LevelID,
+                                 CellID)
+{
+    return getNodeQueryLevel(partition, node, phantom_nodes);
+}
+
+inline bool checkParentCellRestriction(const partition::MultiLevelPartitionView &partition,
+                                       LevelID,
+                                       NodeID node,
+                                       const PhantomNodes &,
+                                       LevelID top_level,
+                                       CellID top_cell)
+{
+    return partition.GetCell(top_level, node) == top_cell;
+}
+
+// Search from one end of a query that meets the searches from several other ends (Args is
+// const PhantomNode &):
+//   * use the highest level the node is in a different cell than the phantom node, like the
+//     many-to-many searches, so the level does not depend on the other ends
+//   * allow to traverse all cells
+inline LevelID getNodeQueryLevel(const partition::MultiLevelPartitionView &partition,
+                                 NodeID node,
+                                 const PhantomNode &phantom_node)
+{
+    auto level = [&partition, node](const SegmentID &segment) {
+        if (segment.enabled)
+            return partition.GetHighestDifferentLevel(segment.id, node);
+        return INVALID_LEVEL_ID;
+    };
+    return getUnrestrictedLevel(
+        partition,
+        node,
+        std::min(level(phantom_node.forward_segment_id), level(phantom_node.reverse_segment_id)));
+}
+
+inline bool checkParentCellRestriction(const partition::MultiLevelPartitionView &,
+                                       LevelID,
+                                       NodeID,
+                                       const PhantomNode &)
+{
+    return true;
+}
+
+// Cell on the level of all enabled segments of the phantom node, INVALID_CELL_ID if they are in
+// different cells
+inline CellID getPhantomCell(const partition::MultiLevelPartitionView &partition,
+                             const LevelID level,
+                             const PhantomNode &phantom)
+{
+    CellID cell = INVALID_CELL_ID;
+    for (const auto &segment : {phantom.forward_segment_id, phantom.reverse_segment_id})
+    {
+        if (!segment.enabled)
+            continue;
+        const auto segment_cell = partition.GetCell(level, segment.id);
+        if (cell != INVALID_CELL_ID && cell != segment_cell)
+            return INVALID_CELL_ID;
+        cell = segment_cell;
+    }
+    return cell;
 }
 }
 
@@ -130,10 +232,19 @@ retrievePackedPathFromHeap(const SearchEngineData<Algorithm>::QueryHeap &forward
     return packed_path;
 }
 
-template <bool DIRECTION, typename... Args>
+// Settles the next node of the heap and relaxes its arcs. The keys of the heaps are the weights
+// of their nodes plus the potential of their direction, see LandmarkPotential. The heaps are
+// query heaps or their views for one storage type, see util::QueryHeap::StorageView.
+template <bool DIRECTION,
+          typename PotentialT,
+          typename OppositePotentialT,
+          typename HeapT,
+          typename... Args>
 void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                 SearchEngineData<Algorithm>::QueryHeap &forward_heap,
-                 SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                 HeapT &forward_heap,
+                 HeapT &reverse_heap,
+                 const PotentialT &potential,
+                 const OppositePotentialT &opposite_potential,
                  NodeID &middle_node,
                  EdgeWeight &path_upper_bound,
                  const bool force_loop_forward,
@@ -142,9 +253,10 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
 {
     const auto &partition = facade.GetMultiLevelPartition();
     const auto &cells = facade.GetCellStorage();
+    const auto *conditional_turns = CurrentConditionalTurns();
 
     const auto node = forward_heap.DeleteMin();
-    const auto weight = forward_heap.GetKey(node);
+    const auto weight = forward_heap.GetKey(node) - potential(node);
 
     // Upper bound for the path source -> target with
     // weight(source -> node) = weight weight(to -> target) ≤ reverse_weight
@@ -153,7 +265,7 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
     // with weight(to -> target) = reverse_weight and all weights ≥ 0
     if (reverse_heap.WasInserted(node))
     {
-        auto reverse_weight = reverse_heap.GetKey(node);
+        auto reverse_weight = reverse_heap.GetKey(node) - opposite_potential(node);
         auto path_weight = weight + reverse_weight;
 
         // if loops are forced, they are so at the source
@@ -166,6 +278,27 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
         }
     }
 
+    const auto relax = [&](const NodeID to, const EdgeWeight to_weight, const bool clique_arc) {
+        const auto to_key = to_weight + potential(to);
+        if (!forward_heap.WasInserted(to))
+        {
+            forward_heap.Insert(to, to_key, {node, clique_arc});
+        }
+        else if (to_key < forward_heap.GetKey(to))
+        {
+            // only the rounded potentials of landmarks reach settled nodes again
+            if (forward_heap.WasRemoved(to))
+            {
+                forward_heap.Insert(to, to_key, {node, clique_arc});
+            }
+            else
+            {
+                forward_heap.GetData(to) = {node, clique_arc};
+                forward_heap.DecreaseKey(to, to_key);
+            }
+        }
+    };
+
     const auto level = getNodeQueryLevel(partition, node, args...);
 
     if (level >= 1 && !forward_heap.GetData(node).from_clique_arc)
@@ -183,15 +316,7 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                 {
                     const EdgeWeight to_weight = weight + shortcut_weight;
                     BOOST_ASSERT(to_weight >= weight);
-                    if (!forward_heap.WasInserted(to))
-                    {
-                        forward_heap.Insert(to, to_weight, {node, true});
-                    }
-                    else if (to_weight < forward_heap.GetKey(to))
-                    {
-                        forward_heap.GetData(to) = {node, true};
-                        forward_heap.DecreaseKey(to, to_weight);
-                    }
+                    relax(to, to_weight, true);
                 }
                 ++destination;
             }
@@ -209,15 +334,7 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                 {
                     const EdgeWeight to_weight = weight + shortcut_weight;
                     BOOST_ASSERT(to_weight >= weight);
-                    if (!forward_heap.WasInserted(to))
-                    {
-                        forward_heap.Insert(to, to_weight, {node, true});
-                    }
-                    else if (to_weight < forward_heap.GetKey(to))
-                    {
-                        forward_heap.GetData(to) = {node, true};
-                        forward_heap.DecreaseKey(to, to_weight);
-                    }
+                    relax(to, to_weight, true);
                 }
                 ++source;
             }
@@ -232,25 +349,38 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
         {
             const NodeID to = facade.GetTarget(edge);
 
-            if (checkParentCellRestriction(partition.GetCell(level + 1, to), args...))
+            if (checkParentCellRestriction(partition, level, to, args...) &&
+                !(conditional_turns && conditional_turns->IsRestricted(edge_data.turn_id)))
             {
                 BOOST_ASSERT_MSG(edge_data.weight > 0, "edge_weight invalid");
-                const EdgeWeight to_weight = weight + edge_data.weight;
-
-                if (!forward_heap.WasInserted(to))
-                {
-                    forward_heap.Insert(to, to_weight, {node, false});
-                }
-                else if (to_weight < forward_heap.GetKey(to))
-                {
-                    forward_heap.GetData(to) = {node, false};
-                    forward_heap.DecreaseKey(to, to_weight);
-                }
+                relax(to, weight + edge_data.weight, false);
             }
         }
     }
 }
 
+template <bool DIRECTION, typename HeapT, typename... Args>
+void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                 HeapT &forward_heap,
+                 HeapT &reverse_heap,
+                 NodeID &middle_node,
+                 EdgeWeight &path_upper_bound,
+                 const bool force_loop_forward,
+                 const bool force_loop_reverse,
+                 Args... args)
+{
+    routingStep<DIRECTION>(facade,
+                           forward_heap,
+                           reverse_heap,
+                           ZeroPotential{},
+                           ZeroPotential{},
+                           middle_node,
+                           path_upper_bound,
+                           force_loop_forward,
+                           force_loop_reverse,
+                           args...);
+}
+
 // With (s, middle, t) we trace back the paths middle -> s and middle -> t.
 // This gives us a packed path (node ids) from the base graph around s and t,
 // and overlay node ids otherwise. We then have to unpack the overlay clique
@@ -268,60 +398,347 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
                     const bool force_loop_forward,
                     const bool force_loop_reverse,
                     EdgeWeight weight_upper_bound,
-                    Args... args)
+                    Args... args);
+
+// Appends the base graph path of the clique arc source -> target of their cell on the level,
+// without the source node. The heaps are reused for the search inside of the cell. Arcs of long
+// paths are looked up in and added to the shortcut cache instead of being searched again.
+inline void unpackCliqueArc(SearchEngineData<Algorithm> &engine_working_data,
+                            const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                            SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                            SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                            const bool force_loop_forward,
+                            const bool force_loop_reverse,
+                            const NodeID source,
+                            const NodeID target,
+                            const LevelID level,
+                            UnpackedNodes &unpacked_nodes,
+                            UnpackedEdges &unpacked_edges)
 {
-    if (forward_heap.Empty() || reverse_heap.Empty())
+    const auto &shortcut_cache = engine_working_data.shortcut_cache;
+    if (const auto cached_arc = shortcut_cache.Get(level, source, target))
     {
-        return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
+        for (const auto &unpacked_edge : **cached_arc)
+        {
+            unpacked_nodes.push_back(unpacked_edge.target);
+            unpacked_edges.push_back(unpacked_edge.edge);
+        }
+        return;
     }
 
     const auto &partition = facade.GetMultiLevelPartition();
+    CellID parent_cell_id = partition.GetCell(level, source);
+    BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
 
-    BOOST_ASSERT(!forward_heap.Empty() && forward_heap.MinKey() < INVALID_EDGE_WEIGHT);
-    BOOST_ASSERT(!reverse_heap.Empty() && reverse_heap.MinKey() < INVALID_EDGE_WEIGHT);
+    LevelID sublevel = level - 1;
 
-    // run two-Target Dijkstra routing step.
-    NodeID middle = SPECIAL_NODEID;
-    EdgeWeight weight = weight_upper_bound;
-    EdgeWeight forward_heap_min = forward_heap.MinKey();
-    EdgeWeight reverse_heap_min = reverse_heap.MinKey();
-    while (forward_heap.Size() + reverse_heap.Size() > 0 &&
-           forward_heap_min + reverse_heap_min < weight)
+    // Here heaps can be reused, let's go deeper!
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    forward_heap.Insert(source, 0, {source});
+    reverse_heap.Insert(target, 0, {target});
+
+    // TODO: when structured bindings will be allowed change to
+    // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
+    EdgeWeight subpath_weight;
+    std::vector<NodeID> subpath_nodes;
+    std::vector<EdgeID> subpath_edges;
+    std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
+                                                                    facade,
+                                                                    forward_heap,
+                                                                    reverse_heap,
+                                                                    force_loop_forward,
+                                                                    force_loop_reverse,
+                                                                    INVALID_EDGE_WEIGHT,
+                                                                    sublevel,
+                                                                    parent_cell_id);
+    BOOST_ASSERT(!subpath_edges.empty());
+    BOOST_ASSERT(subpath_nodes.size() > 1);
+    BOOST_ASSERT(subpath_nodes.front() == source);
+    BOOST_ASSERT(subpath_nodes.back() == target);
+    unpacked_nodes.insert(
+        unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+    unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+
+    if (shortcut_cache && subpath_edges.size() >= ShortcutCache::MIN_UNPACKED_EDGES)
     {
-        if (!forward_heap.Empty())
+        auto unpacked_arc = std::make_shared<std::vector<ShortcutCache::UnpackedEdge>>();
+        unpacked_arc->reserve(subpath_edges.size());
+        for (const auto index : util::irange<std::size_t>(0, subpath_edges.size()))
         {
-            routingStep<FORWARD_DIRECTION>(facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           middle,
-                                           weight,
-                                           force_loop_forward,
-                                           force_loop_reverse,
-                                           args...);
-            if (!forward_heap.Empty())
-                forward_heap_min = forward_heap.MinKey();
+            unpacked_arc->push_back({subpath_nodes[index + 1], subpath_edges[index]});
         }
-        if (!reverse_heap.Empty())
+        shortcut_cache.Put(level, source, target, std::move(unpacked_arc));
+    }
+}
+
+// Relaxes the arcs of the next node of the heap to higher ranked nodes of the overlay hierarchy
+template <bool DIRECTION>
+void overlayRoutingStep(const customizer::OverlayHierarchyView &hierarchy,
+                        SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                        SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                        NodeID &middle_node,
+                        EdgeWeight &path_upper_bound)
+{
+    const auto node = forward_heap.DeleteMin();
+    const auto weight = forward_heap.GetKey(node);
+
+    if (reverse_heap.WasInserted(node))
+    {
+        const auto path_weight = weight + reverse_heap.GetKey(node);
+        if (path_weight < path_upper_bound)
         {
-            routingStep<REVERSE_DIRECTION>(facade,
-                                           reverse_heap,
-                                           forward_heap,
-                                           middle,
-                                           weight,
-                                           force_loop_reverse,
-                                           force_loop_forward,
-                                           args...);
-            if (!reverse_heap.Empty())
-                reverse_heap_min = reverse_heap.MinKey();
+            middle_node = node;
+            path_upper_bound = path_weight;
+        }
+    }
+
+    const auto arcs = DIRECTION == FORWARD_DIRECTION ? hierarchy.GetForwardArcs(node)
+                                                     : hierarchy.GetBackwardArcs(node);
+    for (const auto &arc : arcs)
+    {
+        const EdgeWeight to_weight = weight + arc.weight;
+        if (!forward_heap.WasInserted(arc.target))
+        {
+            forward_heap.Insert(arc.target, to_weight, {node});
+        }
+        else if (to_weight < forward_heap.GetKey(arc.target))
+        {
+            forward_heap.GetData(arc.target) = {node};
+            forward_heap.DecreaseKey(arc.target, to_weight);
+        }
+    }
+}
+
+// Only searches between phantom nodes can use the overlay hierarchy
+template <typename... Args>
+bool searchOverlayHierarchy(SearchEngineData<Algorithm> &,
+                            const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &,
+                            SearchEngineData<Algorithm>::QueryHeap &,
+                            SearchEngineData<Algorithm>::QueryHeap &,
+                            const bool,
+                            const bool,
+                            const EdgeWeight,
+                            UnpackedPath &,
+                            Args...)
+{
+    return false;
+}
+
+// Searches between different cells of the top level without its overlay graph: all paths
+// leave the cell of the source and enter the one of the target through their boundary nodes.
+// The distances to them are given by an exhaustive search inside of each cell, the rest of the
+// path by a search on the hierarchy of the overlay graph that starts at all reached boundary
+// nodes. Returns false if the search needs the overlay graph of the top level.
+inline bool
+searchOverlayHierarchy(SearchEngineData<Algorithm> &engine_working_data,
+                       const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                       SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                       SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                       const bool force_loop_forward,
+                       const bool force_loop_reverse,
+                       const EdgeWeight weight_upper_bound,
+                       UnpackedPath &unpacked_path,
+                       const PhantomNodes &phantom_nodes)
+{
+    // the hierarchy is contracted from the shortcuts of the top level cells, which might take
+    // restricted turns
+    const auto &hierarchy = facade.GetOverlayHierarchy();
+    if (hierarchy.GetNumberOfNodes() == 0 || force_loop_forward || force_loop_reverse ||
+        CurrentConditionalTurns())
+        return false;
+
+    const auto &partition = facade.GetMultiLevelPartition();
+    const auto &cells = facade.GetCellStorage();
+    const LevelID top_level = partition.GetNumberOfLevels() - 1;
+    const auto source_cell = getPhantomCell(partition, top_level, phantom_nodes.source_phantom);
+    const auto target_cell = getPhantomCell(partition, top_level, phantom_nodes.target_phantom);
+    if (source_cell == INVALID_CELL_ID || target_cell == INVALID_CELL_ID ||
+        source_cell == target_cell)
+        return false;
+
+    // the local searches are in different cells, so they never meet
+    NodeID middle = SPECIAL_NODEID;
+    EdgeWeight weight = INVALID_EDGE_WEIGHT;
+    while (!forward_heap.Empty())
+    {
+        routingStep<FORWARD_DIRECTION>(facade,
+                                       forward_heap,
+                                       reverse_heap,
+                                       middle,
+                                       weight,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS,
+                                       phantom_nodes,
+                                       top_level,
+                                       source_cell);
+    }
+    while (!reverse_heap.Empty())
+    {
+        routingStep<REVERSE_DIRECTION>(facade,
+                                       reverse_heap,
+                                       forward_heap,
+                                       middle,
+                                       weight,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS,
+                                       phantom_nodes,
+                                       top_level,
+                                       target_cell);
+    }
+    BOOST_ASSERT(middle == SPECIAL_NODEID);
+
+    engine_working_data.InitializeOrClearOverlayThreadLocalStorage(hierarchy.GetNumberOfNodes());
+    auto &overlay_forward_heap = *engine_working_data.overlay_forward_heap;
+    auto &overlay_reverse_heap = *engine_working_data.overlay_reverse_heap;
+
+    const auto seed = [&hierarchy](const SearchEngineData<Algorithm>::QueryHeap &local_heap,
+                                   SearchEngineData<Algorithm>::QueryHeap &overlay_heap,
+                                   const NodeID node) {
+        if (!local_heap.WasInserted(node))
+            return;
+        const auto overlay_node = hierarchy.GetOverlayNode(node);
+        BOOST_ASSERT(overlay_node != SPECIAL_NODEID);
+        if (!overlay_heap.WasInserted(overlay_node))
+            overlay_heap.Insert(overlay_node, local_heap.GetKey(node), {overlay_node});
+    };
+    const auto &source_cell_data = cells.GetCell(top_level, source_cell);
+    for (const auto node : source_cell_data.GetSourceNodes())
+        seed(forward_heap, overlay_forward_heap, node);
+    for (const auto node : source_cell_data.GetDestinationNodes())
+        seed(forward_heap, overlay_forward_heap, node);
+    const auto &target_cell_data = cells.GetCell(top_level, target_cell);
+    for (const auto node : target_cell_data.GetSourceNodes())
+        seed(reverse_heap, overlay_reverse_heap, node);
+    for (const auto node : target_cell_data.GetDestinationNodes())
+        seed(reverse_heap, overlay_reverse_heap, node);
+
+    // a direction is done once its next node is not below the best path of both
+    NodeID overlay_middle = SPECIAL_NODEID;
+    weight = weight_upper_bound;
+    const auto continues = [&weight](const SearchEngineData<Algorithm>::QueryHeap &heap) {
+        return !heap.Empty() && heap.MinKey() < weight;
+    };
+    while (continues(overlay_forward_heap) || continues(overlay_reverse_heap))
+    {
+        if (continues(overlay_forward_heap))
+            overlayRoutingStep<FORWARD_DIRECTION>(
+                hierarchy, overlay_forward_heap, overlay_reverse_heap, overlay_middle, weight);
+        if (continues(overlay_reverse_heap))
+            overlayRoutingStep<REVERSE_DIRECTION>(
+                hierarchy, overlay_reverse_heap, overlay_forward_heap, overlay_middle, weight);
+    }
+
+    if (overlay_middle == SPECIAL_NODEID || weight >= weight_upper_bound)
+    {
+        unpacked_path = std::make_tuple(INVALID_EDGE_WEIGHT, UnpackedNodes(), UnpackedEdges());
+        return true;
+    }
+
+    // arcs of the hierarchy from the forward seed over the middle to the reverse seed
+    std::vector<std::pair<NodeID, NodeID>> hierarchy_arcs;
+    for (auto node = overlay_middle; overlay_forward_heap.GetData(node).parent != node;)
+    {
+        const auto parent = overlay_forward_heap.GetData(node).parent;
+        hierarchy_arcs.emplace_back(parent, node);
+        node = parent;
+    }
+    std::reverse(hierarchy_arcs.begin(), hierarchy_arcs.end());
+    for (auto node = overlay_middle; overlay_reverse_heap.GetData(node).parent != node;)
+    {
+        const auto parent = overlay_reverse_heap.GetData(node).parent;
+        hierarchy_arcs.emplace_back(node, parent);
+        node = parent;
+    }
+
+    std::vector<std::pair<NodeID, NodeID>> overlay_arcs;
+    for (const auto &arc : hierarchy_arcs)
+        hierarchy.UnpackArc(arc.first, arc.second, std::back_inserter(overlay_arcs));
+
+    const auto source_seed = hierarchy.GetNode(
+        hierarchy_arcs.empty() ? overlay_middle : hierarchy_arcs.front().first);
+    const auto target_seed = hierarchy.GetNode(
+        hierarchy_arcs.empty() ? overlay_middle : hierarchy_arcs.back().second);
+
+    // the path as {from node ID, to node ID, level of the clique arc or 0 for base graph edges}
+    // is collected before the heaps of the local searches are reused for unpacking
+    std::vector<std::tuple<NodeID, NodeID, LevelID>> packed_path;
+    const auto append_local = [&](const PackedPath &local_path) {
+        for (const auto &packed_edge : local_path)
+        {
+            const auto source = std::get<0>(packed_edge);
+            const auto level =
+                std::get<2>(packed_edge) ? getNodeQueryLevel(partition, source, phantom_nodes) : 0;
+            packed_path.emplace_back(source, std::get<1>(packed_edge), level);
         }
     };
 
-    // No path found for both target nodes?
-    if (weight >= weight_upper_bound || SPECIAL_NODEID == middle)
+    auto source_path =
+        retrievePackedPathFromSingleHeap<FORWARD_DIRECTION>(forward_heap, source_seed);
+    std::reverse(source_path.begin(), source_path.end());
+    append_local(source_path);
+    for (const auto &arc : overlay_arcs)
     {
-        return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
+        const auto source = hierarchy.GetNode(arc.first);
+        const auto target = hierarchy.GetNode(arc.second);
+        const auto is_clique_arc =
+            partition.GetCell(top_level, source) == partition.GetCell(top_level, target);
+        packed_path.emplace_back(source, target, is_clique_arc ? top_level : 0);
+    }
+    append_local(retrievePackedPathFromSingleHeap<REVERSE_DIRECTION>(reverse_heap, target_seed));
+    BOOST_ASSERT(!packed_path.empty());
+
+    UnpackedNodes unpacked_nodes;
+    UnpackedEdges unpacked_edges;
+    unpacked_nodes.reserve(packed_path.size());
+    unpacked_edges.reserve(packed_path.size());
+
+    unpacked_nodes.push_back(std::get<0>(packed_path.front()));
+    for (const auto &packed_edge : packed_path)
+    {
+        NodeID source, target;
+        LevelID level;
+        std::tie(source, target, level) = packed_edge;
+        if (level == 0)
+        {
+            unpacked_nodes.push_back(target);
+            unpacked_edges.push_back(facade.FindEdge(source, target));
+        }
+        else
+        {
+            unpackCliqueArc(engine_working_data,
+                            facade,
+                            forward_heap,
+                            reverse_heap,
+                            DO_NOT_FORCE_LOOPS,
+                            DO_NOT_FORCE_LOOPS,
+                            source,
+                            target,
+                            level,
+                            unpacked_nodes,
+                            unpacked_edges);
+        }
     }
 
+    unpacked_path = std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
+    return true;
+}
+
+// Unpacks the path over the middle node the searches of the heaps met at
+template <typename... Args>
+UnpackedPath
+unpackSearchPath(SearchEngineData<Algorithm> &engine_working_data,
+                 const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                 SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                 SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                 const bool force_loop_forward,
+                 const bool force_loop_reverse,
+                 const NodeID middle,
+                 const EdgeWeight weight,
+                 Args... args)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+
     // Get packed path as edges {from node ID, to node ID, from_clique_arc}
     auto packed_path = retrievePackedPathFromHeap(forward_heap, reverse_heap, middle);
 
@@ -349,45 +766,215 @@ UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
         }
         else
         { // an overlay graph edge
-            LevelID level = getNodeQueryLevel(partition, source, args...);
-            CellID parent_cell_id = partition.GetCell(level, source);
-            BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-            LevelID sublevel = level - 1;
-
-            // Here heaps can be reused, let's go deeper!
-            forward_heap.Clear();
-            reverse_heap.Clear();
-            forward_heap.Insert(source, 0, {source});
-            reverse_heap.Insert(target, 0, {target});
-
-            // TODO: when structured bindings will be allowed change to
-            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-            EdgeWeight subpath_weight;
-            std::vector<NodeID> subpath_nodes;
-            std::vector<EdgeID> subpath_edges;
-            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
-                                                                            facade,
-                                                                            forward_heap,
-                                                                            reverse_heap,
-                                                                            force_loop_forward,
-                                                                            force_loop_reverse,
-                                                                            INVALID_EDGE_WEIGHT,
-                                                                            sublevel,
-                                                                            parent_cell_id);
-            BOOST_ASSERT(!subpath_edges.empty());
-            BOOST_ASSERT(subpath_nodes.size() > 1);
-            BOOST_ASSERT(subpath_nodes.front() == source);
-            BOOST_ASSERT(subpath_nodes.back() == target);
-            unpacked_nodes.insert(
-                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+            unpackCliqueArc(engine_working_data,
+                            facade,
+                            forward_heap,
+                            reverse_heap,
+                            force_loop_forward,
+                            force_loop_reverse,
+                            source,
+                            target,
+                            getNodeQueryLevel(partition, source, args...),
+                            unpacked_nodes,
+                            unpacked_edges);
         }
     }
 
     return std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
 }
 
+template <typename... Args>
+UnpackedPath search(SearchEngineData<Algorithm> &engine_working_data,
+                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                    SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const bool force_loop_forward,
+                    const bool force_loop_reverse,
+                    EdgeWeight weight_upper_bound,
+                    Args... args)
+{
+    if (forward_heap.Empty() || reverse_heap.Empty())
+    {
+        return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
+    }
+
+    UnpackedPath overlay_hierarchy_path;
+    if (searchOverlayHierarchy(engine_working_data,
+                               facade,
+                               forward_heap,
+                               reverse_heap,
+                               force_loop_forward,
+                               force_loop_reverse,
+                               weight_upper_bound,
+                               overlay_hierarchy_path,
+                               args...))
+    {
+        return overlay_hierarchy_path;
+    }
+
+    BOOST_ASSERT(!forward_heap.Empty() && forward_heap.MinKey() < INVALID_EDGE_WEIGHT);
+    BOOST_ASSERT(!reverse_heap.Empty() && reverse_heap.MinKey() < INVALID_EDGE_WEIGHT);
+
+    // run two-Target Dijkstra routing step.
+    NodeID middle = SPECIAL_NODEID;
+    EdgeWeight weight = weight_upper_bound;
+    BOOST_ASSERT(forward_heap.GetIndexStorage().Type() == reverse_heap.GetIndexStorage().Type());
+    util::dispatchIndexStorage(forward_heap.GetIndexStorage().Type(), [&](const auto type) {
+        auto forward_view = forward_heap.View<decltype(type)::value>();
+        auto reverse_view = reverse_heap.View<decltype(type)::value>();
+
+        EdgeWeight forward_heap_min = forward_view.MinKey();
+        EdgeWeight reverse_heap_min = reverse_view.MinKey();
+        while (forward_view.Size() + reverse_view.Size() > 0 &&
+               forward_heap_min + reverse_heap_min < weight)
+        {
+            if (!forward_view.Empty())
+            {
+                routingStep<FORWARD_DIRECTION>(facade,
+                                               forward_view,
+                                               reverse_view,
+                                               middle,
+                                               weight,
+                                               force_loop_forward,
+                                               force_loop_reverse,
+                                               args...);
+                if (!forward_view.Empty())
+                    forward_heap_min = forward_view.MinKey();
+            }
+            if (!reverse_view.Empty())
+            {
+                routingStep<REVERSE_DIRECTION>(facade,
+                                               reverse_view,
+                                               forward_view,
+                                               middle,
+                                               weight,
+                                               force_loop_reverse,
+                                               force_loop_forward,
+                                               args...);
+                if (!reverse_view.Empty())
+                    reverse_heap_min = reverse_view.MinKey();
+            }
+        }
+    });
+
+    // No path found for both target nodes?
+    if (weight >= weight_upper_bound || SPECIAL_NODEID == middle)
+    {
+        return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
+    }
+
+    return unpackSearchPath(engine_working_data,
+                            facade,
+                            forward_heap,
+                            reverse_heap,
+                            force_loop_forward,
+                            force_loop_reverse,
+                            middle,
+                            weight,
+                            args...);
+}
+
+// Searches between phantom nodes directed towards each other by the landmarks of the dataset,
+// searches without landmarks are the ones of search()
+inline UnpackedPath
+searchWithLandmarks(SearchEngineData<Algorithm> &engine_working_data,
+                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                    SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const bool force_loop_forward,
+                    const bool force_loop_reverse,
+                    const EdgeWeight weight_upper_bound,
+                    const PhantomNodes &phantom_nodes)
+{
+    const auto &landmarks = facade.GetLandmarks();
+    if (landmarks.GetNumberOfLandmarks() == 0 || force_loop_forward || force_loop_reverse ||
+        forward_heap.Empty() || reverse_heap.Empty())
+    {
+        return search(engine_working_data,
+                      facade,
+                      forward_heap,
+                      reverse_heap,
+                      force_loop_forward,
+                      force_loop_reverse,
+                      weight_upper_bound,
+                      phantom_nodes);
+    }
+
+    UnpackedPath overlay_hierarchy_path;
+    if (searchOverlayHierarchy(engine_working_data,
+                               facade,
+                               forward_heap,
+                               reverse_heap,
+                               DO_NOT_FORCE_LOOPS,
+                               DO_NOT_FORCE_LOOPS,
+                               weight_upper_bound,
+                               overlay_hierarchy_path,
+                               phantom_nodes))
+    {
+        return overlay_hierarchy_path;
+    }
+
+    // the potentials start from the keys of the heaps before they are added to them
+    const LandmarkPotential<FORWARD_DIRECTION> forward_potential(
+        landmarks, reverse_heap, phantom_nodes.target_phantom);
+    const LandmarkPotential<REVERSE_DIRECTION> reverse_potential(
+        landmarks, forward_heap, phantom_nodes.source_phantom);
+    applyPotential(forward_heap, phantom_nodes.source_phantom, forward_potential);
+    applyPotential(reverse_heap, phantom_nodes.target_phantom, reverse_potential);
+
+    // Both searches are directed to the other end, so each one on its own finds the shortest
+    // path once its next node is not below the best path found so far
+    NodeID middle = SPECIAL_NODEID;
+    EdgeWeight weight = weight_upper_bound;
+    const auto continues = [&weight](const auto &heap) {
+        return !heap.Empty() && heap.MinKey() < weight;
+    };
+    util::dispatchIndexStorage(forward_heap.GetIndexStorage().Type(), [&](const auto type) {
+        auto forward_view = forward_heap.View<decltype(type)::value>();
+        auto reverse_view = reverse_heap.View<decltype(type)::value>();
+        while (continues(forward_view) && continues(reverse_view))
+        {
+            routingStep<FORWARD_DIRECTION>(facade,
+                                           forward_view,
+                                           reverse_view,
+                                           forward_potential,
+                                           reverse_potential,
+                                           middle,
+                                           weight,
+                                           DO_NOT_FORCE_LOOPS,
+                                           DO_NOT_FORCE_LOOPS,
+                                           phantom_nodes);
+            if (!continues(reverse_view))
+                break;
+            routingStep<REVERSE_DIRECTION>(facade,
+                                           reverse_view,
+                                           forward_view,
+                                           reverse_potential,
+                                           forward_potential,
+                                           middle,
+                                           weight,
+                                           DO_NOT_FORCE_LOOPS,
+                                           DO_NOT_FORCE_LOOPS,
+                                           phantom_nodes);
+        }
+    });
+
+    if (weight >= weight_upper_bound || SPECIAL_NODEID == middle)
+    {
+        return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
+    }
+
+    return unpackSearchPath(engine_working_data,
+                            facade,
+                            forward_heap,
+                            reverse_heap,
+                            DO_NOT_FORCE_LOOPS,
+                            DO_NOT_FORCE_LOOPS,
+                            middle,
+                            weight,
+                            phantom_nodes);
+}
+
 // Alias to be compatible with the CH-based search
 inline void search(SearchEngineData<Algorithm> &engine_working_data,
                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
@@ -401,6 +988,18 @@ inline void search(SearchEngineData<Algorithm> &engine_working_data,
                    const EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT)
 {
     // TODO: change search calling interface to use unpacked_edges result
+    if (engine_working_data.use_landmarks_for_route)
+    {
+        std::tie(weight, unpacked_nodes, std::ignore) = searchWithLandmarks(engine_working_data,
+                                                                            facade,
+                                                                            forward_heap,
+                                                                            reverse_heap,
+                                                                            force_loop_forward,
+                                                                            force_loop_reverse,
+                                                                            weight_upper_bound,
+                                                                            phantom_nodes);
+        return;
+    }
     std::tie(weight, unpacked_nodes, std::ignore) = search(engine_working_data,
                                                            facade,
                                                            forward_heap,
@@ -412,13 +1011,16 @@ inline void search(SearchEngineData<Algorithm> &engine_working_data,
 }
 
 // TODO: refactor CH-related stub to use unpacked_edges
+// MLD paths are unpacked by the search already, its clique arcs are cached by unpackCliqueArc
 template <typename RandomIter, typename FacadeT>
 void unpackPath(const FacadeT &facade,
                 RandomIter packed_path_begin,
                 RandomIter packed_path_end,
                 const PhantomNodes &phantom_nodes,
-                std::vector<PathData> &unpacked_path)
+                std::vector<PathData> &unpacked_path,
+                const ShortcutCacheView & /* shortcut_cache */ = {})
 {
+    util::ScopedStageTimer unpack_timer(util::RequestStage::Unpack);
     const auto nodes_number = std::distance(packed_path_begin, packed_path_end);
     BOOST_ASSERT(nodes_number > 0);
 
@@ -460,14 +1062,24 @@ getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
     EdgeWeight weight = INVALID_EDGE_WEIGHT;
     std::vector<NodeID> unpacked_nodes;
     std::vector<EdgeID> unpacked_edges;
-    std::tie(weight, unpacked_nodes, unpacked_edges) = search(engine_working_data,
-                                                              facade,
-                                                              forward_heap,
-                                                              reverse_heap,
-                                                              DO_NOT_FORCE_LOOPS,
-                                                              DO_NOT_FORCE_LOOPS,
-                                                              weight_upper_bound,
-                                                              phantom_nodes);
+    std::tie(weight, unpacked_nodes, unpacked_edges) =
+        engine_working_data.use_landmarks_for_match
+            ? searchWithLandmarks(engine_working_data,
+                                  facade,
+                                  forward_heap,
+                                  reverse_heap,
+                                  DO_NOT_FORCE_LOOPS,
+                                  DO_NOT_FORCE_LOOPS,
+                                  weight_upper_bound,
+                                  phantom_nodes)
+            : search(engine_working_data,
+                     facade,
+                     forward_heap,
+                     reverse_heap,
+                     DO_NOT_FORCE_LOOPS,
+                     DO_NOT_FORCE_LOOPS,
+                     weight_upper_bound,
+                     phantom_nodes);
 
     if (weight == INVALID_EDGE_WEIGHT)
     {
@@ -481,6 +1093,145 @@ getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
     return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
 }
 
+// Network distances from the source to each of the targets, std::numeric_limits<double>::max()
+// for targets without a path below the upper bound. The search from the source settles its
+// nodes below the bound only once and the searches from the targets all meet it. Its levels
+// only depend on the source, the ones of each target search on the target. Clique arcs are
+// unpacked on the second heaps so the search from the source is kept.
+inline std::vector<double>
+getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                    SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const PhantomNode &source_phantom,
+                    const std::vector<PhantomNode> &target_phantoms,
+                    const EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT)
+{
+    std::vector<double> distances(target_phantoms.size(), std::numeric_limits<double>::max());
+
+    // the landmarks direct the search of each pair to its target
+    if (engine_working_data.use_landmarks_for_match &&
+        facade.GetLandmarks().GetNumberOfLandmarks() > 0)
+    {
+        std::transform(target_phantoms.begin(),
+                       target_phantoms.end(),
+                       distances.begin(),
+                       [&](const PhantomNode &target_phantom) {
+                           return getNetworkDistance(engine_working_data,
+                                                     facade,
+                                                     forward_heap,
+                                                     reverse_heap,
+                                                     source_phantom,
+                                                     target_phantom,
+                                                     weight_upper_bound);
+                       });
+        return distances;
+    }
+
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    insertSourceInForwardHeap(forward_heap, source_phantom);
+    if (forward_heap.Empty())
+    {
+        return distances;
+    }
+
+    // the keys of the reverse heaps are not negative, paths over nodes above the bound are too
+    const auto min_forward_key = forward_heap.MinKey();
+    NodeID middle = SPECIAL_NODEID;
+    EdgeWeight forward_upper_bound = weight_upper_bound;
+    while (!forward_heap.Empty() && forward_heap.MinKey() < weight_upper_bound)
+    {
+        routingStep<FORWARD_DIRECTION>(facade,
+                                       forward_heap,
+                                       reverse_heap,
+                                       middle,
+                                       forward_upper_bound,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS,
+                                       source_phantom);
+    }
+
+    const auto &partition = facade.GetMultiLevelPartition();
+    engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &unpack_forward_heap = *engine_working_data.forward_heap_2;
+    auto &unpack_reverse_heap = *engine_working_data.reverse_heap_2;
+
+    for (const auto index : util::irange<std::size_t>(0UL, target_phantoms.size()))
+    {
+        const auto &target_phantom = target_phantoms[index];
+        reverse_heap.Clear();
+        insertTargetInReverseHeap(reverse_heap, target_phantom);
+
+        middle = SPECIAL_NODEID;
+        EdgeWeight weight = weight_upper_bound;
+        while (!reverse_heap.Empty() && reverse_heap.MinKey() + min_forward_key < weight)
+        {
+            routingStep<REVERSE_DIRECTION>(facade,
+                                           reverse_heap,
+                                           forward_heap,
+                                           middle,
+                                           weight,
+                                           DO_NOT_FORCE_LOOPS,
+                                           DO_NOT_FORCE_LOOPS,
+                                           target_phantom);
+        }
+
+        if (weight >= weight_upper_bound || SPECIAL_NODEID == middle)
+        {
+            continue;
+        }
+
+        // the arcs to the middle are on the levels of the source, the ones after it on the
+        // levels of the target
+        auto packed_path =
+            retrievePackedPathFromSingleHeap<FORWARD_DIRECTION>(forward_heap, middle);
+        std::reverse(packed_path.begin(), packed_path.end());
+        const auto number_of_forward_edges = packed_path.size();
+        retrievePackedPathFromSingleHeap<REVERSE_DIRECTION>(
+            reverse_heap, middle, std::back_inserter(packed_path));
+
+        std::vector<NodeID> unpacked_nodes;
+        std::vector<EdgeID> unpacked_edges;
+        unpacked_nodes.push_back(!packed_path.empty() ? std::get<0>(packed_path.front()) : middle);
+        for (const auto edge_index : util::irange<std::size_t>(0UL, packed_path.size()))
+        {
+            NodeID from, to;
+            bool overlay_edge;
+            std::tie(from, to, overlay_edge) = packed_path[edge_index];
+            if (!overlay_edge)
+            {
+                unpacked_nodes.push_back(to);
+                unpacked_edges.push_back(facade.FindEdge(from, to));
+            }
+            else
+            {
+                const auto level = edge_index < number_of_forward_edges
+                                       ? getNodeQueryLevel(partition, from, source_phantom)
+                                       : getNodeQueryLevel(partition, from, target_phantom);
+                unpackCliqueArc(engine_working_data,
+                                facade,
+                                unpack_forward_heap,
+                                unpack_reverse_heap,
+                                DO_NOT_FORCE_LOOPS,
+                                DO_NOT_FORCE_LOOPS,
+                                from,
+                                to,
+                                level,
+                                unpacked_nodes,
+                                unpacked_edges);
+            }
+        }
+
+        std::vector<PathData> unpacked_path;
+        const PhantomNodes phantom_nodes{source_phantom, target_phantom};
+        annotatePath(facade, phantom_nodes, unpacked_nodes, unpacked_edges, unpacked_path);
+        distances[index] = getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+    }
+
+    return distances;
+}
+
 } // namespace mld
 } // namespace routing_algorithms
 } // namespace engine
@@ -0,0 +1,195 @@
+#ifndef OSRM_ENGINE_ROUTING_CACHE_HPP
+#define OSRM_ENGINE_ROUTING_CACHE_HPP
+
+#include "engine/facade_epoch.hpp"
+#include "engine/internal_route_result.hpp"
+#include "engine/phantom_node.hpp"
+
+#include "util/lru_cache.hpp"
+#include "util/std_hash.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Everything of a snapped phantom node that the result of a search depends on.
+// The snapped and input coordinates are not part of it, they only matter for
+// the geometry assembly which is done for each request.
+struct PhantomNodeKey
+{
+    explicit PhantomNodeKey(const PhantomNode &phantom)
+        : forward_segment_id(phantom.forward_segment_id.id),
+          reverse_segment_id(phantom.reverse_segment_id.id),
+          forward_weight(phantom.forward_weight), reverse_weight(phantom.reverse_weight),
+          forward_weight_offset(phantom.forward_weight_offset),
+          reverse_weight_offset(phantom.reverse_weight_offset),
+          forward_duration(phantom.forward_duration), reverse_duration(phantom.reverse_duration),
+          forward_duration_offset(phantom.forward_duration_offset),
+          reverse_duration_offset(phantom.reverse_duration_offset),
+          flags(phantom.forward_segment_id.enabled | phantom.reverse_segment_id.enabled << 1 |
+                phantom.IsValidForwardSource() << 2 | phantom.IsValidForwardTarget() << 3 |
+                phantom.IsValidReverseSource() << 4 | phantom.IsValidReverseTarget() << 5)
+    {
+    }
+
+    bool operator==(const PhantomNodeKey &other) const
+    {
+        return std::tie(forward_segment_id,
+                        reverse_segment_id,
+                        forward_weight,
+                        reverse_weight,
+                        forward_weight_offset,
+                        reverse_weight_offset,
+                        forward_duration,
+                        reverse_duration,
+                        forward_duration_offset,
+                        reverse_duration_offset,
+                        flags) == std::tie(other.forward_segment_id,
+                                           other.reverse_segment_id,
+                                           other.forward_weight,
+                                           other.reverse_weight,
+                                           other.forward_weight_offset,
+                                           other.reverse_weight_offset,
+                                           other.forward_duration,
+                                           other.reverse_duration,
+                                           other.forward_duration_offset,
+                                           other.reverse_duration_offset,
+                                           other.flags);
+    }
+
+    std::size_t Hash() const
+    {
+        return hash_val(forward_segment_id,
+                        reverse_segment_id,
+                        forward_weight,
+                        reverse_weight,
+                        forward_weight_offset,
+                        reverse_weight_offset,
+                        forward_duration,
+                        reverse_duration,
+                        forward_duration_offset,
+                        reverse_duration_offset,
+                        flags);
+    }
+
+    NodeID forward_segment_id;
+    NodeID reverse_segment_id;
+    EdgeWeight forward_weight;
+    EdgeWeight reverse_weight;
+    EdgeWeight forward_weight_offset;
+    EdgeWeight reverse_weight_offset;
+    EdgeWeight forward_duration;
+    EdgeWeight reverse_duration;
+    EdgeWeight forward_duration_offset;
+    EdgeWeight reverse_duration_offset;
+    std::uint8_t flags;
+};
+
+// Caches results of searches across requests. Entries are tagged with the epoch of the
+// dataset they were computed on, see FacadeEpoch.
+class RoutingCache
+{
+  public:
+    enum class RouteKind : std::uint8_t
+    {
+        Direct,
+        Shortest,
+        ShortestContinueStraight,
+        ShortestNoContinueStraight
+    };
+
+    explicit RoutingCache(const std::size_t capacity)
+        : durations(capacity), routes(capacity)
+    {
+    }
+
+    // Returns the epoch of the dataset behind the facade
+    unsigned GetEpoch(const std::shared_ptr<const void> &facade) { return epoch.Get(facade); }
+
+    boost::optional<EdgeWeight>
+    GetDuration(const unsigned epoch, const PhantomNode &source, const PhantomNode &target);
+
+    void PutDuration(const unsigned epoch,
+                     const PhantomNode &source,
+                     const PhantomNode &target,
+                     const EdgeWeight duration);
+
+    boost::optional<InternalRouteResult> GetRoute(const unsigned epoch,
+                                                  const RouteKind kind,
+                                                  const std::vector<PhantomNodes> &legs);
+
+    void PutRoute(const unsigned epoch,
+                  const RouteKind kind,
+                  const std::vector<PhantomNodes> &legs,
+                  const InternalRouteResult &route);
+
+    std::uint64_t Hits() const;
+    std::uint64_t Misses() const;
+
+  private:
+    struct DurationKey
+    {
+        unsigned epoch;
+        PhantomNodeKey source;
+        PhantomNodeKey target;
+
+        bool operator==(const DurationKey &other) const
+        {
+            return epoch == other.epoch && source == other.source && target == other.target;
+        }
+    };
+
+    struct DurationKeyHash
+    {
+        std::size_t operator()(const DurationKey &key) const
+        {
+            return hash_val(key.epoch, key.source.Hash(), key.target.Hash());
+        }
+    };
+
+    struct RouteKey
+    {
+        unsigned epoch;
+        RouteKind kind;
+        std::vector<PhantomNodeKey> waypoints;
+
+        bool operator==(const RouteKey &other) const
+        {
+            return epoch == other.epoch && kind == other.kind && waypoints == other.waypoints;
+        }
+    };
+
+    struct RouteKeyHash
+    {
+        std::size_t operator()(const RouteKey &key) const
+        {
+            auto seed = hash_val(key.epoch, static_cast<std::uint8_t>(key.kind));
+            for (const auto &waypoint : key.waypoints)
+            {
+                hash_combine(seed, waypoint.Hash());
+            }
+            return seed;
+        }
+    };
+
+    static RouteKey
+    MakeRouteKey(const unsigned epoch, const RouteKind kind, const std::vector<PhantomNodes> &legs);
+
+    FacadeEpoch epoch;
+
+    util::ShardedLRUCache<DurationKey, EdgeWeight, DurationKeyHash> durations;
+    util::ShardedLRUCache<RouteKey, InternalRouteResult, RouteKeyHash> routes;
+};
+}
+}
+
+#endif
@@ -4,9 +4,18 @@
 #include <boost/thread/tss.hpp>
 
 #include "engine/algorithm.hpp"
+#include "engine/engine_config.hpp"
+#include "engine/shortcut_cache.hpp"
 #include "util/query_heap.hpp"
 #include "util/typedefs.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -15,7 +24,12 @@ namespace engine
 // Algorithm-dependent heaps
 // - CH algorithms use CH heaps
 // - CoreCH algorithms use CH
+// - CCH algorithms use CH
 // - MLD algorithms use MLD heaps
+//
+// The node index storage of all heaps is selected at engine startup from the EngineConfig,
+// separately for point-to-point heaps and the many-to-many heap. Algorithms pick a default
+// if the configuration does not request a specific storage.
 
 template <typename Algorithm> struct SearchEngineData
 {
@@ -33,20 +47,66 @@ struct ManyToManyHeapData : HeapData
     ManyToManyHeapData(NodeID p, EdgeWeight duration) : HeapData(p), duration(duration) {}
 };
 
+// Entry of the many-to-many search space: a node settled by the search of a source or target.
+// The parent of the node in that search lets the path through it be retrieved from the buckets.
+struct NodeBucket
+{
+    NodeID middle_node;
+    NodeID parent_node;
+    unsigned index; // a row or column in the weight/duration matrix
+    EdgeWeight weight;
+    EdgeDuration duration;
+    bool from_clique_arc;
+
+    NodeBucket(NodeID middle_node,
+               NodeID parent_node,
+               bool from_clique_arc,
+               unsigned index,
+               EdgeWeight weight,
+               EdgeDuration duration)
+        : middle_node(middle_node), parent_node(parent_node), index(index), weight(weight),
+          duration(duration), from_clique_arc(from_clique_arc)
+    {
+    }
+
+    // partial order comparison
+    bool operator<(const NodeBucket &rhs) const
+    {
+        return std::tie(middle_node, index) < std::tie(rhs.middle_node, rhs.index);
+    }
+
+    // functor for equal_range
+    struct Compare
+    {
+        bool operator()(const NodeBucket &lhs, const NodeID &rhs) const
+        {
+            return lhs.middle_node < rhs;
+        }
+
+        bool operator()(const NodeID &lhs, const NodeBucket &rhs) const
+        {
+            return lhs < rhs.middle_node;
+        }
+    };
+};
+
 template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
 {
     using QueryHeap = util::
-        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::SelectableStorage<NodeID, int>>;
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                util::SelectableStorage<NodeID, int>>;
 
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
 
+    using SearchSpaceWithBuckets = std::vector<NodeBucket>;
+    using SearchSpaceWithBucketsPtr = boost::thread_specific_ptr<SearchSpaceWithBuckets>;
+
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
     static SearchEngineHeapPtr forward_heap_2;
@@ -54,6 +114,11 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     static SearchEngineHeapPtr forward_heap_3;
     static SearchEngineHeapPtr reverse_heap_3;
     static ManyToManyHeapPtr many_to_many_heap;
+    static SearchSpaceWithBucketsPtr many_to_many_buckets;
+
+    SearchEngineData() : SearchEngineData(EngineConfig{}) {}
+
+    explicit SearchEngineData(const EngineConfig &config);
 
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
@@ -62,12 +127,44 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     void InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    // Releases the memory of the heaps of the calling thread if they hold more than
+    // max_heap_memory and reports what they hold, must not be called while they are in use
+    void ShrinkThreadLocalStorage();
+
+    // Nodes settled by the heaps of the calling thread since they were created
+    std::uint64_t GetSettledNodes() const;
+
+    util::IndexStorageType query_heap_storage;
+    util::IndexStorageType many_to_many_heap_storage;
+    // bytes the heaps of a thread may keep between queries
+    std::size_t max_heap_memory;
+    // number of threads a single many-to-many search may use
+    unsigned many_to_many_concurrency;
+    // number of threads the legs of a single route through many waypoints are unpacked on
+    unsigned leg_concurrency;
+    unsigned leg_concurrency_min_waypoints;
+    // direct the searches of these request classes by landmarks if the dataset has them
+    bool use_landmarks_for_route;
+    bool use_landmarks_for_match;
+    // nodes the core search of CoreCH may settle before it gives up
+    std::size_t max_core_settled_nodes;
+    // unpacked shortcuts cached across requests, set for each request by the engine
+    ShortcutCacheView shortcut_cache;
 };
 
 template <>
 struct SearchEngineData<routing_algorithms::corech::Algorithm>
     : public SearchEngineData<routing_algorithms::ch::Algorithm>
 {
+    using SearchEngineData<routing_algorithms::ch::Algorithm>::SearchEngineData;
+};
+
+template <>
+struct SearchEngineData<routing_algorithms::cch::Algorithm>
+    : public SearchEngineData<routing_algorithms::ch::Algorithm>
+{
+    using SearchEngineData<routing_algorithms::ch::Algorithm>::SearchEngineData;
 };
 
 struct MultiLayerDijkstraHeapData
@@ -91,31 +188,110 @@ struct ManyToManyMultiLayerDijkstraHeapData : MultiLayerDijkstraHeapData
     }
 };
 
+// One search for a group of phantoms in the same cells with a label per phantom at each node it
+// reaches, see collectGroupSearch. Kept per thread like the heaps and cleared for every group.
+struct ManyToManyGroupSearch
+{
+    struct Label
+    {
+        EdgeWeight weight;
+        EdgeDuration duration;
+        NodeID parent;
+        bool from_clique_arc;
+        bool changed;
+    };
+    // the weight a slot is queued with, the queue is a min-heap by std::greater
+    using QueueEntry = std::pair<EdgeWeight, std::size_t>;
+
+    // the labels of the nodes by slot, as many labels per slot as phantoms in the group
+    std::unordered_map<NodeID, std::size_t> slots;
+    std::vector<NodeID> nodes;
+    std::vector<Label> labels;
+    std::vector<EdgeWeight> queued_weights;
+    std::vector<QueueEntry> queue;
+    // the changed labels of the node that is relaxed
+    std::vector<std::pair<std::size_t, Label>> relaxed;
+
+    void Clear();
+
+    std::size_t MemoryUsage() const;
+
+    // Releases the memory a large group search left behind
+    void Shrink();
+};
+
 template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
 {
+    // the searches of MLD settle enough nodes for the radix heap to be faster
     using QueryHeap = util::QueryHeap<NodeID,
                                       NodeID,
                                       EdgeWeight,
                                       MultiLayerDijkstraHeapData,
-                                      util::UnorderedMapStorage<NodeID, int>>;
+                                      util::SelectableStorage<NodeID, int>,
+                                      util::RadixHeap<EdgeWeight, NodeID>>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyMultiLayerDijkstraHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                util::SelectableStorage<NodeID, int>,
+                                                util::RadixHeap<EdgeWeight, NodeID>>;
 
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
 
+    using SearchSpaceWithBuckets = std::vector<NodeBucket>;
+    using SearchSpaceWithBucketsPtr = boost::thread_specific_ptr<SearchSpaceWithBuckets>;
+
+    using ManyToManyGroupSearchPtr = boost::thread_specific_ptr<ManyToManyGroupSearch>;
+
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
+    static SearchEngineHeapPtr forward_heap_2;
+    static SearchEngineHeapPtr reverse_heap_2;
+    // searches on the hierarchy of the top level overlay graph, by overlay node
+    static SearchEngineHeapPtr overlay_forward_heap;
+    static SearchEngineHeapPtr overlay_reverse_heap;
     static ManyToManyHeapPtr many_to_many_heap;
+    static SearchSpaceWithBucketsPtr many_to_many_buckets;
+    static ManyToManyGroupSearchPtr many_to_many_group_search;
+
+    SearchEngineData() : SearchEngineData(EngineConfig{}) {}
+
+    explicit SearchEngineData(const EngineConfig &config);
 
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
+    void InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes);
+
+    void InitializeOrClearOverlayThreadLocalStorage(unsigned number_of_nodes);
+
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
+
+    // Releases the memory of the heaps of the calling thread if they hold more than
+    // max_heap_memory and reports what they hold, must not be called while they are in use
+    void ShrinkThreadLocalStorage();
+
+    // Nodes settled by the heaps of the calling thread since they were created
+    std::uint64_t GetSettledNodes() const;
+
+    util::IndexStorageType query_heap_storage;
+    util::IndexStorageType many_to_many_heap_storage;
+    // bytes the heaps of a thread may keep between queries
+    std::size_t max_heap_memory;
+    // number of threads a single many-to-many search may use
+    unsigned many_to_many_concurrency;
+    // number of threads the legs of a single route through many waypoints are unpacked on
+    unsigned leg_concurrency;
+    unsigned leg_concurrency_min_waypoints;
+    // number of threads the via paths of a single alternatives search may use
+    unsigned alternatives_concurrency;
+    // direct the searches of these request classes by landmarks if the dataset has them
+    bool use_landmarks_for_route;
+    bool use_landmarks_for_match;
+    // unpacked shortcuts cached across requests, set for each request by the engine
+    ShortcutCacheView shortcut_cache;
 };
 }
 }
@@ -0,0 +1,128 @@
+#ifndef OSRM_ENGINE_SHORTCUT_CACHE_HPP
+#define OSRM_ENGINE_SHORTCUT_CACHE_HPP
+
+#include "engine/facade_epoch.hpp"
+
+#include "util/lru_cache.hpp"
+#include "util/std_hash.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Caches the original edges shortcuts unpack to, so the highway shortcuts most long routes share
+// are not expanded again for every one of them. Shortcuts are the CH shortcuts of packed paths,
+// which are stored on level 0, and the clique arcs of MLD cells on the level of the cell. CH
+// only caches the shortcuts of packed paths, the shortcuts they bridge are unpacked along with
+// them. Entries are tagged with the epoch of the dataset they were unpacked on, see FacadeEpoch.
+class ShortcutCache
+{
+  public:
+    // An original edge of an unpacked shortcut and the node it leads to, the source of the
+    // shortcut is not part of it
+    struct UnpackedEdge
+    {
+        NodeID target;
+        EdgeID edge;
+    };
+    using UnpackedShortcut = std::shared_ptr<const std::vector<UnpackedEdge>>;
+
+    // Shortcuts bridging fewer original edges are cheaper to unpack than to look up
+    static constexpr std::size_t MIN_UNPACKED_EDGES = 8;
+
+    explicit ShortcutCache(const std::size_t capacity) : shortcuts(capacity) {}
+
+    // Returns the epoch of the dataset behind the facade
+    unsigned GetEpoch(const std::shared_ptr<const void> &facade) { return epoch.Get(facade); }
+
+    boost::optional<UnpackedShortcut>
+    Get(const unsigned epoch, const LevelID level, const NodeID source, const NodeID target)
+    {
+        return shortcuts.Get(ShortcutKey{epoch, level, source, target});
+    }
+
+    void Put(const unsigned epoch,
+             const LevelID level,
+             const NodeID source,
+             const NodeID target,
+             UnpackedShortcut unpacked)
+    {
+        shortcuts.Put(ShortcutKey{epoch, level, source, target}, std::move(unpacked));
+    }
+
+    std::uint64_t Hits() const { return shortcuts.Hits(); }
+    std::uint64_t Misses() const { return shortcuts.Misses(); }
+
+  private:
+    struct ShortcutKey
+    {
+        unsigned epoch;
+        LevelID level;
+        NodeID source;
+        NodeID target;
+
+        bool operator==(const ShortcutKey &other) const
+        {
+            return epoch == other.epoch && level == other.level && source == other.source &&
+                   target == other.target;
+        }
+    };
+
+    struct ShortcutKeyHash
+    {
+        std::size_t operator()(const ShortcutKey &key) const
+        {
+            return hash_val(key.epoch, key.level, key.source, key.target);
+        }
+    };
+
+    FacadeEpoch epoch;
+    util::ShardedLRUCache<ShortcutKey, UnpackedShortcut, ShortcutKeyHash> shortcuts;
+};
+
+// The shortcut cache as seen by a single request, bound to the epoch of the facade it uses.
+// A default constructed view caches nothing.
+class ShortcutCacheView
+{
+  public:
+    ShortcutCacheView() : cache(nullptr), epoch(0) {}
+    ShortcutCacheView(ShortcutCache &cache, const unsigned epoch) : cache(&cache), epoch(epoch)
+    {
+    }
+
+    explicit operator bool() const { return cache != nullptr; }
+
+    boost::optional<ShortcutCache::UnpackedShortcut>
+    Get(const LevelID level, const NodeID source, const NodeID target) const
+    {
+        if (!cache)
+            return boost::none;
+        return cache->Get(epoch, level, source, target);
+    }
+
+    void Put(const LevelID level,
+             const NodeID source,
+             const NodeID target,
+             ShortcutCache::UnpackedShortcut unpacked) const
+    {
+        if (cache)
+            cache->Put(epoch, level, source, target, std::move(unpacked));
+    }
+
+  private:
+    ShortcutCache *cache;
+    unsigned epoch;
+};
+}
+}
+
+#endif
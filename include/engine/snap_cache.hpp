@@ -0,0 +1,137 @@
+#ifndef OSRM_ENGINE_SNAP_CACHE_HPP
+#define OSRM_ENGINE_SNAP_CACHE_HPP
+
+#include "engine/approach.hpp"
+#include "engine/bearing.hpp"
+#include "engine/facade_epoch.hpp"
+#include "engine/phantom_node.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/lru_cache.hpp"
+#include "util/std_hash.hpp"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Caches the phantom nodes input coordinates were snapped to across requests, so clients
+// that keep querying the same locations skip the r-tree. Coordinates are compared at the
+// fixed precision of the engine, the snapping options have to match as well. Entries are
+// tagged with the epoch of the dataset they were snapped on, see FacadeEpoch.
+class SnapCache
+{
+  public:
+    explicit SnapCache(const std::size_t capacity) : snaps(capacity) {}
+
+    // Returns the epoch of the dataset behind the facade
+    unsigned GetEpoch(const std::shared_ptr<const void> &facade) { return epoch.Get(facade); }
+
+    boost::optional<PhantomNodePair> Get(const unsigned epoch,
+                                         const util::Coordinate coordinate,
+                                         const boost::optional<double> &radius,
+                                         const boost::optional<Bearing> &bearing,
+                                         const boost::optional<Approach> &approach);
+
+    void Put(const unsigned epoch,
+             const util::Coordinate coordinate,
+             const boost::optional<double> &radius,
+             const boost::optional<Bearing> &bearing,
+             const boost::optional<Approach> &approach,
+             const PhantomNodePair &phantom_nodes);
+
+    std::uint64_t Hits() const { return snaps.Hits(); }
+    std::uint64_t Misses() const { return snaps.Misses(); }
+
+  private:
+    struct SnapKey
+    {
+        SnapKey(const unsigned epoch,
+                const util::Coordinate coordinate,
+                const boost::optional<double> &radius,
+                const boost::optional<Bearing> &bearing,
+                const boost::optional<Approach> &approach)
+            : epoch(epoch), lon(static_cast<std::int32_t>(coordinate.lon)),
+              lat(static_cast<std::int32_t>(coordinate.lat)), radius(radius ? *radius : -1.),
+              bearing(bearing ? *bearing : Bearing{-1, -1}),
+              approach(approach ? static_cast<std::int8_t>(*approach) : -1)
+        {
+        }
+
+        bool operator==(const SnapKey &other) const
+        {
+            return epoch == other.epoch && lon == other.lon && lat == other.lat &&
+                   radius == other.radius && bearing == other.bearing &&
+                   approach == other.approach;
+        }
+
+        unsigned epoch;
+        std::int32_t lon;
+        std::int32_t lat;
+        // negative values stand for options that are not set
+        double radius;
+        Bearing bearing;
+        std::int8_t approach;
+    };
+
+    struct SnapKeyHash
+    {
+        std::size_t operator()(const SnapKey &key) const
+        {
+            return hash_val(key.epoch,
+                            key.lon,
+                            key.lat,
+                            key.radius,
+                            key.bearing.bearing,
+                            key.bearing.range,
+                            key.approach);
+        }
+    };
+
+    FacadeEpoch epoch;
+    util::ShardedLRUCache<SnapKey, PhantomNodePair, SnapKeyHash> snaps;
+};
+
+// The snap cache as seen by a single request, bound to the epoch of the facade it uses.
+// A default constructed view caches nothing.
+class SnapCacheView
+{
+  public:
+    SnapCacheView() : cache(nullptr), epoch(0) {}
+    SnapCacheView(SnapCache &cache, const unsigned epoch) : cache(&cache), epoch(epoch) {}
+
+    explicit operator bool() const { return cache != nullptr; }
+
+    boost::optional<PhantomNodePair> Get(const util::Coordinate coordinate,
+                                         const boost::optional<double> &radius,
+                                         const boost::optional<Bearing> &bearing,
+                                         const boost::optional<Approach> &approach) const
+    {
+        if (!cache)
+            return boost::none;
+        return cache->Get(epoch, coordinate, radius, bearing, approach);
+    }
+
+    void Put(const util::Coordinate coordinate,
+             const boost::optional<double> &radius,
+             const boost::optional<Bearing> &bearing,
+             const boost::optional<Approach> &approach,
+             const PhantomNodePair &phantom_nodes) const
+    {
+        if (cache)
+            cache->Put(epoch, coordinate, radius, bearing, approach, phantom_nodes);
+    }
+
+  private:
+    SnapCache *cache;
+    unsigned epoch;
+};
+}
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef OSRM_ENGINE_TILE_CACHE_HPP
+#define OSRM_ENGINE_TILE_CACHE_HPP
+
+#include "engine/facade_epoch.hpp"
+
+#include "util/lru_cache.hpp"
+#include "util/std_hash.hpp"
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Caches the encoded vector tiles of the tile service, so clients that keep showing the same
+// area skip the r-tree query, the turn lookups and the encoding. Tiles in memory are tagged
+// with the epoch of the dataset they were rendered from, see FacadeEpoch.
+//
+// Tiles can also be persisted to a directory, laid out as <dataset>/<z>/<x>/<y>.mvt where the
+// dataset is named after the checksum and the timestamp of the data. Persisted tiles survive
+// restarts and are shared by all processes using the directory. Tiles of another dataset are
+// never read, but the directory has to be cleared when the weights of the same data change.
+class TileCache
+{
+  public:
+    // A capacity of 0 keeps no tiles in memory, an empty directory persists none
+    TileCache(const std::size_t capacity, boost::filesystem::path directory);
+
+    // Returns the epoch of the dataset behind the facade
+    unsigned GetEpoch(const std::shared_ptr<const void> &facade) { return epoch.Get(facade); }
+
+    // Names the dataset persisted tiles are stored for
+    static std::string DatasetName(const unsigned checksum, const std::string &timestamp);
+
+    boost::optional<std::string> Get(const unsigned epoch,
+                                     const std::string &dataset,
+                                     const unsigned x,
+                                     const unsigned y,
+                                     const unsigned z);
+
+    void Put(const unsigned epoch,
+             const std::string &dataset,
+             const unsigned x,
+             const unsigned y,
+             const unsigned z,
+             const std::string &tile);
+
+    std::uint64_t Hits() const { return hits; }
+    std::uint64_t Misses() const { return misses; }
+
+  private:
+    struct TileKey
+    {
+        unsigned epoch;
+        unsigned x;
+        unsigned y;
+        unsigned z;
+
+        bool operator==(const TileKey &other) const
+        {
+            return epoch == other.epoch && x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    struct TileKeyHash
+    {
+        std::size_t operator()(const TileKey &key) const
+        {
+            return hash_val(key.epoch, key.x, key.y, key.z);
+        }
+    };
+
+    boost::filesystem::path TilePath(const std::string &dataset,
+                                     const unsigned x,
+                                     const unsigned y,
+                                     const unsigned z) const;
+
+    FacadeEpoch epoch;
+    std::unique_ptr<util::ShardedLRUCache<TileKey, std::string, TileKeyHash>> tiles;
+    const boost::filesystem::path directory;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+};
+}
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef TRIP_BRUTE_FORCE_HPP
 #define TRIP_BRUTE_FORCE_HPP
 
+#include "engine/query_deadline.hpp"
 #include "util/dist_table_wrapper.hpp"
 #include "util/log.hpp"
 #include "util/typedefs.hpp"
@@ -75,8 +76,10 @@ inline std::vector<NodeID> BruteForceTrip(const std::size_t number_of_locations,
                          number_of_locations,
                      "invalid node id");
 
+    QueryDeadlineCheck check_deadline;
     do
     {
+        check_deadline();
         const auto new_distance =
             ReturnDistance(dist_table, node_order, min_route_dist, number_of_locations);
         // we can use `<` instead of `<=` here, since all distances are `!=` INVALID_EDGE_WEIGHT
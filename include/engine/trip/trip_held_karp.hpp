@@ -0,0 +1,202 @@
+#ifndef TRIP_HELD_KARP_HPP
+#define TRIP_HELD_KARP_HPP
+
+#include "engine/query_deadline.hpp"
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+// Held-Karp keeps a weight for every subset of the locations and location it ends at, 2^15 * 15
+// weights for 16 locations
+const constexpr std::size_t HELD_KARP_MAX_LOCATIONS = 16;
+
+namespace detail
+{
+// Unreachable legs and trips, small enough that two of them don't overflow when summed up
+const constexpr EdgeWeight HELD_KARP_INVALID_WEIGHT = std::numeric_limits<EdgeWeight>::max() / 4;
+// layers with fewer subsets are computed by the calling thread
+const constexpr std::size_t HELD_KARP_PARALLEL_MIN_SUBSETS = 1024;
+const constexpr std::size_t HELD_KARP_GRAIN_SIZE = 256;
+
+// smallest weight of a path through the subset that ends with the leg to the last location,
+// written without branches so the compiler can use vector min instructions
+inline EdgeWeight HeldKarpMin(const EdgeWeight *subset_weights,
+                              const EdgeWeight *leg_weights,
+                              const std::size_t size)
+{
+    EdgeWeight min_weight = HELD_KARP_INVALID_WEIGHT;
+    for (std::size_t index = 0; index < size; ++index)
+    {
+        min_weight = std::min(min_weight, subset_weights[index] + leg_weights[index]);
+    }
+    return min_weight;
+}
+}
+
+// Computes the shortest round trip with the dynamic program of Held and Karp, which takes
+// O(2^n * n^2) steps instead of the O(n!) of trying all permutations. The trip starts at location
+// 0, the subsets of the other locations are computed by their size and the subsets of one size
+// in parallel.
+inline std::vector<NodeID> HeldKarpTrip(const std::size_t number_of_locations,
+                                        const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    using detail::HELD_KARP_INVALID_WEIGHT;
+
+    BOOST_ASSERT(number_of_locations > 0);
+    BOOST_ASSERT(number_of_locations <= HELD_KARP_MAX_LOCATIONS);
+    if (number_of_locations == 1)
+    {
+        return {0};
+    }
+
+    // the locations but 0 are numbered from 0 in the subsets
+    const std::size_t size = number_of_locations - 1;
+    const std::uint32_t full_subset = (1u << size) - 1;
+
+    const auto leg = [&](const std::size_t from, const std::size_t to) {
+        const auto weight = dist_table(from, to);
+        return weight == INVALID_EDGE_WEIGHT ? HELD_KARP_INVALID_WEIGHT
+                                             : std::min(weight, HELD_KARP_INVALID_WEIGHT);
+    };
+    // legs_to[to * size + from] is the leg between two of the locations, no location has a leg
+    // to itself
+    std::vector<EdgeWeight> legs_to(size * size, HELD_KARP_INVALID_WEIGHT);
+    for (std::size_t to = 0; to < size; ++to)
+    {
+        for (std::size_t from = 0; from < size; ++from)
+        {
+            if (from != to)
+            {
+                legs_to[to * size + from] = leg(from + 1, to + 1);
+            }
+        }
+    }
+
+    // weights[subset * size + last] is the weight of the shortest path from location 0 through
+    // all locations of the subset that ends at last, the locations not in the subset are invalid
+    std::vector<EdgeWeight> weights((static_cast<std::size_t>(full_subset) + 1) * size,
+                                    HELD_KARP_INVALID_WEIGHT);
+    for (std::size_t last = 0; last < size; ++last)
+    {
+        weights[(std::size_t{1} << last) * size + last] = leg(0, last + 1);
+    }
+
+    // the subsets ordered by their number of locations
+    std::vector<std::size_t> layer_offsets(size + 2, 0);
+    for (std::uint32_t subset = 1; subset <= full_subset; ++subset)
+    {
+        layer_offsets[__builtin_popcount(subset) + 1]++;
+    }
+    std::partial_sum(layer_offsets.begin(), layer_offsets.end(), layer_offsets.begin());
+    std::vector<std::uint32_t> subsets(full_subset);
+    {
+        auto next_offsets = layer_offsets;
+        for (std::uint32_t subset = 1; subset <= full_subset; ++subset)
+        {
+            subsets[next_offsets[__builtin_popcount(subset)]++] = subset;
+        }
+    }
+
+    const auto compute_subsets = [&](const std::size_t begin, const std::size_t end) {
+        for (auto index = begin; index < end; ++index)
+        {
+            const auto subset = subsets[index];
+            for (std::size_t last = 0; last < size; ++last)
+            {
+                if (subset & (1u << last))
+                {
+                    const auto previous_subset = subset ^ (1u << last);
+                    weights[subset * size + last] = detail::HeldKarpMin(
+                        &weights[previous_subset * size], &legs_to[last * size], size);
+                }
+            }
+        }
+    };
+    for (std::size_t layer = 2; layer <= size; ++layer)
+    {
+        CheckQueryDeadline();
+        const auto begin = layer_offsets[layer];
+        const auto end = layer_offsets[layer + 1];
+        if (end - begin < detail::HELD_KARP_PARALLEL_MIN_SUBSETS)
+        {
+            compute_subsets(begin, end);
+            continue;
+        }
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(begin, end, detail::HELD_KARP_GRAIN_SIZE),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                compute_subsets(range.begin(), range.end());
+            });
+    }
+
+    // close the round trip and walk the subsets back to location 0
+    std::vector<EdgeWeight> legs_to_start(size);
+    for (std::size_t from = 0; from < size; ++from)
+    {
+        legs_to_start[from] = leg(from + 1, 0);
+    }
+    std::vector<EdgeWeight> trip_weights(size);
+    for (std::size_t last = 0; last < size; ++last)
+    {
+        trip_weights[last] = weights[full_subset * size + last] + legs_to_start[last];
+    }
+    auto last = static_cast<std::size_t>(
+        std::min_element(trip_weights.begin(), trip_weights.end()) - trip_weights.begin());
+
+    std::vector<NodeID> trip(number_of_locations);
+    trip[0] = 0;
+    std::uint32_t subset = full_subset;
+    for (std::size_t position = size; position > 0; --position)
+    {
+        trip[position] = static_cast<NodeID>(last + 1);
+        const auto previous_subset = subset ^ (1u << last);
+        if (previous_subset == 0)
+        {
+            BOOST_ASSERT(position == 1);
+            break;
+        }
+
+        // the location before last is one whose path led to the weight of the path to last
+        const auto weight = weights[subset * size + last];
+        std::size_t previous = 0;
+        const auto leads_to_last = [&](const std::size_t location) {
+            return (previous_subset & (1u << location)) &&
+                   std::min(weights[previous_subset * size + location] +
+                                legs_to[last * size + location],
+                            HELD_KARP_INVALID_WEIGHT) == weight;
+        };
+        while (previous < size && !leads_to_last(previous))
+        {
+            ++previous;
+        }
+        BOOST_ASSERT(previous < size);
+        last = previous;
+        subset = previous_subset;
+    }
+
+    return trip;
+}
+
+} // namespace trip
+} // namespace engine
+} // namespace osrm
+
+#endif // TRIP_HELD_KARP_HPP
@@ -0,0 +1,273 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+namespace detail
+{
+// moves are only tried towards the nearest locations of a location
+const constexpr std::size_t LOCAL_SEARCH_NEIGHBOURS = 8;
+// Or-opt moves shift paths of up to this many locations
+const constexpr std::size_t OR_OPT_MAX_LENGTH = 3;
+
+// A round trip with the weights of its legs summed up in both directions, so the weight of any
+// path of the trip and of the same path reversed is known in constant time. Unreachable legs have
+// INVALID_EDGE_WEIGHT which is summed up as is, so no improving move can introduce them.
+template <typename Table> class LocalSearchTour
+{
+  public:
+    LocalSearchTour(std::vector<NodeID> trip_, const Table &dist_table_)
+        : trip(std::move(trip_)), dist_table(dist_table_), position(dist_table.GetNumberOfNodes()),
+          forward_prefix(trip.size() + 1), backward_prefix(trip.size() + 1)
+    {
+        Update();
+    }
+
+    std::size_t Size() const { return trip.size(); }
+
+    NodeID At(const std::size_t index) const { return trip[index % trip.size()]; }
+
+    std::size_t Position(const NodeID location) const { return position[location]; }
+
+    std::int64_t Leg(const NodeID from, const NodeID to) const { return dist_table(from, to); }
+
+    // weight of the legs from index first to index last, walking forward or backward
+    std::int64_t PathWeight(const std::size_t first, const std::size_t last) const
+    {
+        return Sum(forward_prefix, first, last);
+    }
+    std::int64_t ReversedPathWeight(const std::size_t first, const std::size_t last) const
+    {
+        return Sum(backward_prefix, first, last);
+    }
+
+    // reverses the path from index first to index last
+    void Reverse(const std::size_t first, const std::size_t last)
+    {
+        const auto size = trip.size();
+        const auto length = (last + size - first) % size + 1;
+        for (std::size_t step = 0; step < length / 2; ++step)
+        {
+            std::swap(trip[(first + step) % size], trip[(last + size - step) % size]);
+        }
+        Update();
+    }
+
+    // moves the path of length locations at index first in front of index target
+    void Move(const std::size_t first, const std::size_t length, const std::size_t target)
+    {
+        const auto shifted_target = (target + trip.size() - first) % trip.size();
+        BOOST_ASSERT(shifted_target >= length);
+        std::rotate(trip.begin(), trip.begin() + first, trip.end());
+        std::rotate(trip.begin(), trip.begin() + length, trip.begin() + shifted_target);
+        Update();
+    }
+
+    std::vector<NodeID> Release() { return std::move(trip); }
+
+  private:
+    std::int64_t
+    Sum(const std::vector<std::int64_t> &prefix, const std::size_t first, const std::size_t last)
+        const
+    {
+        const auto size = trip.size();
+        const auto from = first % size;
+        const auto to = last % size;
+        return from <= to ? prefix[to] - prefix[from] : prefix[size] - prefix[from] + prefix[to];
+    }
+
+    void Update()
+    {
+        const auto size = trip.size();
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            const auto from = trip[index];
+            const auto to = trip[(index + 1) % size];
+            position[from] = index;
+            forward_prefix[index + 1] = forward_prefix[index] + Leg(from, to);
+            backward_prefix[index + 1] = backward_prefix[index] + Leg(to, from);
+        }
+    }
+
+    std::vector<NodeID> trip;
+    const Table &dist_table;
+    std::vector<std::size_t> position;
+    std::vector<std::int64_t> forward_prefix;
+    std::vector<std::int64_t> backward_prefix;
+};
+
+// the nearest locations to go to from each location
+inline std::vector<std::vector<NodeID>>
+NearestNeighbours(const std::vector<NodeID> &trip,
+                  const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    const auto number_of_neighbours = std::min(LOCAL_SEARCH_NEIGHBOURS, trip.size() - 1);
+
+    std::vector<std::vector<NodeID>> neighbours(dist_table.GetNumberOfNodes());
+    for (const auto from : trip)
+    {
+        auto &nearest = neighbours[from];
+        std::copy_if(trip.begin(), trip.end(), std::back_inserter(nearest), [&](const NodeID to) {
+            return to != from;
+        });
+        const auto by_weight = [&](const NodeID lhs, const NodeID rhs) {
+            return dist_table(from, lhs) < dist_table(from, rhs);
+        };
+        std::partial_sort(
+            nearest.begin(), nearest.begin() + number_of_neighbours, nearest.end(), by_weight);
+        nearest.resize(number_of_neighbours);
+    }
+    return neighbours;
+}
+
+// Tries the 2-opt moves that replace the leg a->b after location a by a->c, and reverse the path
+// b..c. Applies the first improving move and returns the locations it changed legs of.
+template <typename Table>
+std::vector<NodeID> TryTwoOpt(LocalSearchTour<Table> &tour,
+                              const NodeID a,
+                              const std::vector<NodeID> &neighbours)
+{
+    const auto i = tour.Position(a);
+    const auto b = tour.At(i + 1);
+    const auto removed_leg = tour.Leg(a, b);
+
+    for (const auto c : neighbours)
+    {
+        const auto added_leg = tour.Leg(a, c);
+        if (added_leg >= removed_leg)
+            break;
+        if (c == b)
+            continue;
+
+        const auto j = tour.Position(c);
+        const auto d = tour.At(j + 1);
+        const auto delta = added_leg + tour.Leg(b, d) + tour.ReversedPathWeight(i + 1, j) -
+                           removed_leg - tour.Leg(c, d) - tour.PathWeight(i + 1, j);
+        if (delta < 0)
+        {
+            tour.Reverse((i + 1) % tour.Size(), j);
+            return {a, b, c, d};
+        }
+    }
+    return {};
+}
+
+// Tries the Or-opt moves that shift the path of up to OR_OPT_MAX_LENGTH locations starting at
+// location a in front of a location its last location is near to. Applies the first improving
+// move and returns the locations it changed legs of.
+template <typename Table>
+std::vector<NodeID> TryOrOpt(LocalSearchTour<Table> &tour,
+                             const NodeID a,
+                             const std::vector<std::vector<NodeID>> &neighbours)
+{
+    const auto size = tour.Size();
+    const auto i = tour.Position(a);
+    const auto p = tour.At(i + size - 1);
+
+    for (std::size_t length = 1; length <= OR_OPT_MAX_LENGTH && length + 3 <= size; ++length)
+    {
+        const auto e = tour.At(i + length - 1);
+        const auto n = tour.At(i + length);
+        const auto removal_gain = tour.Leg(p, a) + tour.Leg(e, n) - tour.Leg(p, n);
+
+        for (const auto c : neighbours[e])
+        {
+            const auto added_leg = tour.Leg(e, c);
+            if (added_leg >= removal_gain)
+                break;
+
+            const auto j = tour.Position(c);
+            if ((j + size - i) % size <= length)
+                continue; // c is on the path or right behind it
+
+            const auto pc = tour.At(j + size - 1);
+            const auto delta = tour.Leg(pc, a) + added_leg - tour.Leg(pc, c) - removal_gain;
+            if (delta < 0)
+            {
+                tour.Move(i, length, j);
+                return {p, a, e, n, pc, c};
+            }
+        }
+    }
+    return {};
+}
+}
+
+// Improves a round trip by local search. 2-opt moves reverse a path of the trip and Or-opt moves
+// shift a short path to another place, both only towards the neighbours of a location, which
+// have to be sorted by the weight of the legs to them. Locations whose legs did not change since
+// no move was found from them are not looked at again. The table can be asymmetric, reversed
+// paths are weighted by their reverse legs.
+// Stops at a local optimum or at the deadline, whichever comes first.
+template <typename Table>
+std::vector<NodeID> LocalSearchTrip(std::vector<NodeID> trip,
+                                    const Table &dist_table,
+                                    const std::vector<std::vector<NodeID>> &neighbours,
+                                    const std::chrono::steady_clock::time_point deadline)
+{
+    if (trip.size() < 5)
+        return trip;
+
+    std::deque<NodeID> queue(trip.begin(), trip.end());
+    std::vector<bool> queued(dist_table.GetNumberOfNodes(), false);
+    for (const auto location : trip)
+        queued[location] = true;
+
+    detail::LocalSearchTour<Table> tour(std::move(trip), dist_table);
+    while (!queue.empty() && std::chrono::steady_clock::now() < deadline)
+    {
+        const auto location = queue.front();
+        queue.pop_front();
+        queued[location] = false;
+
+        auto changed = detail::TryTwoOpt(tour, location, neighbours[location]);
+        if (changed.empty())
+            changed = detail::TryOrOpt(tour, location, neighbours);
+
+        for (const auto changed_location : changed)
+        {
+            if (!queued[changed_location])
+            {
+                queued[changed_location] = true;
+                queue.push_back(changed_location);
+            }
+        }
+    }
+
+    return tour.Release();
+}
+
+// Improves a round trip by local search towards the nearest neighbours of each location.
+inline std::vector<NodeID> LocalSearchTrip(std::vector<NodeID> trip,
+                                           const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                           const std::chrono::steady_clock::time_point deadline)
+{
+    if (trip.size() < 5)
+        return trip;
+
+    const auto neighbours = detail::NearestNeighbours(trip, dist_table);
+    return LocalSearchTrip(std::move(trip), dist_table, neighbours, deadline);
+}
+}
+}
+}
+
+#endif // TRIP_LOCAL_SEARCH_HPP
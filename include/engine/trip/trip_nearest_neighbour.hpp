@@ -8,6 +8,7 @@
 #include "osrm/json_container.hpp"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <limits>
 #include <string>
@@ -92,6 +93,69 @@ std::vector<NodeID> NearestNeighbourTrip(const NodeIDIterator &start,
     }
     return route;
 }
+
+// Builds a trip from start by going to the nearest unvisited of the neighbours of the current
+// location, or to the nearest unvisited location by the table once all of them are visited.
+// Only needs the neighbours lists and some table entries, so it also works on sparse tables. The
+// location last, if not SPECIAL_NODEID, is visited after all others.
+template <typename Table>
+std::vector<NodeID> NeighbourListTrip(const Table &dist_table,
+                                      const std::vector<std::vector<NodeID>> &neighbours,
+                                      const NodeID start,
+                                      const NodeID last)
+{
+    const auto number_of_locations = dist_table.GetNumberOfNodes();
+
+    // unvisited locations and their positions in it for removing them in constant time
+    std::vector<NodeID> unvisited;
+    std::vector<std::size_t> unvisited_position(number_of_locations);
+    for (NodeID location = 0; location < number_of_locations; ++location)
+    {
+        if (location != start && location != last)
+        {
+            unvisited_position[location] = unvisited.size();
+            unvisited.push_back(location);
+        }
+    }
+    const auto visit = [&](const NodeID location) {
+        const auto position = unvisited_position[location];
+        unvisited_position[unvisited.back()] = position;
+        unvisited[position] = unvisited.back();
+        unvisited.pop_back();
+        unvisited_position[location] = number_of_locations;
+    };
+    const auto is_unvisited = [&](const NodeID location) {
+        return location != last && unvisited_position[location] < number_of_locations;
+    };
+
+    std::vector<NodeID> route;
+    route.reserve(number_of_locations);
+    route.push_back(start);
+    unvisited_position[start] = number_of_locations;
+
+    while (!unvisited.empty())
+    {
+        const auto current = route.back();
+        const auto &current_neighbours = neighbours[current];
+        const auto next =
+            std::find_if(current_neighbours.begin(), current_neighbours.end(), is_unvisited);
+        const auto next_location =
+            next != current_neighbours.end()
+                ? *next
+                : *std::min_element(unvisited.begin(),
+                                    unvisited.end(),
+                                    [&](const NodeID lhs, const NodeID rhs) {
+                                        return dist_table(current, lhs) < dist_table(current, rhs);
+                                    });
+        visit(next_location);
+        route.push_back(next_location);
+    }
+
+    if (last != SPECIAL_NODEID && last != start)
+        route.push_back(last);
+
+    return route;
+}
 }
 }
 }
@@ -0,0 +1,138 @@
+#ifndef TRIP_SPARSE_TABLE_HPP
+#define TRIP_SPARSE_TABLE_HPP
+
+#include "engine/routing_algorithms/many_to_many.hpp"
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+// Durations between the locations of a trip that are only computed from each location to its
+// nearest locations. The durations to all other locations are estimated from their great circle
+// distance and the average speed of the computed durations, but are never shorter than the
+// duration to the farthest of the nearest locations. If a location reaches fewer than its
+// number of nearest locations the others are unreachable from it.
+class SparseDistTable
+{
+  public:
+    SparseDistTable(std::vector<std::vector<routing_algorithms::NearestTarget>> nearest_targets_,
+                    std::vector<util::Coordinate> coordinates_,
+                    const std::size_t number_of_nearest_)
+        : nearest_targets(std::move(nearest_targets_)), coordinates(std::move(coordinates_)),
+          number_of_nearest(number_of_nearest_), farthest_durations(nearest_targets.size(), 0)
+    {
+        BOOST_ASSERT(nearest_targets.size() == coordinates.size());
+
+        double durations = 0;
+        double distances = 0;
+        for (std::size_t from = 0; from < nearest_targets.size(); ++from)
+        {
+            for (const auto &target : nearest_targets[from])
+            {
+                farthest_durations[from] = std::max(farthest_durations[from], target.duration);
+                durations += target.duration;
+                distances +=
+                    util::coordinate_calculation::greatCircleDistance(coordinates[from],
+                                                                      coordinates[target.index]);
+            }
+        }
+        if (distances > 0)
+        {
+            duration_per_meter = durations / distances;
+        }
+    }
+
+    std::size_t GetNumberOfNodes() const { return nearest_targets.size(); }
+
+    EdgeWeight operator()(const NodeID from, const NodeID to) const
+    {
+        if (from == to)
+            return 0;
+
+        // the same legs ManipulateTableForFSE removes from a full table
+        if (source != SPECIAL_NODEID)
+        {
+            if (to == source)
+                return from == destination ? 0 : INVALID_EDGE_WEIGHT;
+            if (from == destination || (from == source && to == destination))
+                return INVALID_EDGE_WEIGHT;
+        }
+
+        const auto &targets = nearest_targets[from];
+        const auto target = std::find_if(targets.begin(), targets.end(), [to](const auto &nearest) {
+            return nearest.index == to;
+        });
+        if (target != targets.end())
+            return target->duration;
+
+        if (targets.size() < number_of_nearest)
+            return INVALID_EDGE_WEIGHT;
+
+        const auto estimate =
+            duration_per_meter *
+            util::coordinate_calculation::greatCircleDistance(coordinates[from], coordinates[to]);
+        return std::max(static_cast<EdgeWeight>(std::lround(estimate)), farthest_durations[from]);
+    }
+
+    // Forces trips to start at source and end at destination by treating them as one location.
+    void FixStartAndEnd(const NodeID source_, const NodeID destination_)
+    {
+        source = source_;
+        destination = destination_;
+    }
+
+    // The nearest locations of each location that can be reached from it, nearest first
+    std::vector<std::vector<NodeID>> GetNeighbours() const
+    {
+        std::vector<std::vector<NodeID>> neighbours(nearest_targets.size());
+        for (std::size_t from = 0; from < nearest_targets.size(); ++from)
+        {
+            for (const auto &target : nearest_targets[from])
+            {
+                if ((*this)(from, target.index) != INVALID_EDGE_WEIGHT)
+                    neighbours[from].push_back(target.index);
+            }
+            if (from == destination && std::find(neighbours[from].begin(),
+                                                 neighbours[from].end(),
+                                                 source) == neighbours[from].end())
+            {
+                neighbours[from].push_back(source);
+            }
+
+            std::stable_sort(neighbours[from].begin(),
+                             neighbours[from].end(),
+                             [&](const NodeID lhs, const NodeID rhs) {
+                                 return (*this)(from, lhs) < (*this)(from, rhs);
+                             });
+        }
+        return neighbours;
+    }
+
+  private:
+    std::vector<std::vector<routing_algorithms::NearestTarget>> nearest_targets;
+    std::vector<util::Coordinate> coordinates;
+    std::size_t number_of_nearest;
+    std::vector<EdgeDuration> farthest_durations;
+    // deciseconds per meter, 36 km/h until the computed durations tell better
+    double duration_per_meter = 1.;
+    NodeID source = SPECIAL_NODEID;
+    NodeID destination = SPECIAL_NODEID;
+};
+}
+}
+}
+
+#endif // TRIP_SPARSE_TABLE_HPP
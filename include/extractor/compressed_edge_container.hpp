@@ -4,9 +4,11 @@
 #include "extractor/segment_data_container.hpp"
 
 #include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
 
-#include <unordered_map>
-
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,6 +17,15 @@ namespace osrm
 namespace extractor
 {
 
+/**
+ * Geometries of the compressed edges of the node based graph.
+ *
+ * While the graph is compressed the segments of an edge are a linked list in a pool that is
+ * shared by all edges: compressing two edges links the list of the removed edge to the list of
+ * the surviving one without copying. InitializeBothwayVector compacts the lists into one array
+ * of segments with offsets by edge id before the geometries are zipped, the buckets are views
+ * into it. All lookups by edge id are dense arrays.
+ */
 class CompressedEdgeContainer
 {
   public:
@@ -26,7 +37,7 @@ class CompressedEdgeContainer
         SegmentDuration duration; // the duration of the edge leading to this node
     };
 
-    using OnewayEdgeBucket = std::vector<OnewayCompressedEdge>;
+    using OnewayEdgeBucket = util::vector_view<const OnewayCompressedEdge>;
 
     CompressedEdgeContainer();
     void CompressEdge(const EdgeID surviving_edge_id,
@@ -43,6 +54,10 @@ class CompressedEdgeContainer
                              const SegmentWeight weight,
                              const SegmentWeight duration);
 
+    // Moves the geometries to the edge ids of a renumbered graph, edges without a new id have
+    // to be without geometry. Only valid before InitializeBothwayVector
+    void RenumberEdges(const std::vector<EdgeID> &new_edge_ids);
+
     void InitializeBothwayVector();
     unsigned ZipEdges(const unsigned f_edge_pos, const unsigned r_edge_pos);
 
@@ -53,7 +68,8 @@ class CompressedEdgeContainer
     unsigned GetPositionForID(const EdgeID edge_id) const;
     unsigned GetZippedPositionForForwardID(const EdgeID edge_id) const;
     unsigned GetZippedPositionForReverseID(const EdgeID edge_id) const;
-    const OnewayEdgeBucket &GetBucketReference(const EdgeID edge_id) const;
+    // Only valid after InitializeBothwayVector
+    OnewayEdgeBucket GetBucketReference(const EdgeID edge_id) const;
     bool IsTrivial(const EdgeID edge_id) const;
     NodeID GetFirstEdgeTargetID(const EdgeID edge_id) const;
     NodeID GetLastEdgeTargetID(const EdgeID edge_id) const;
@@ -63,19 +79,39 @@ class CompressedEdgeContainer
     std::unique_ptr<SegmentDataContainer> ToSegmentData();
 
   private:
+    // segments of an edge while compressing, indices into the segment pool
+    struct SegmentList
+    {
+        unsigned head = INVALID_SEGMENT;
+        unsigned second_last = INVALID_SEGMENT;
+        unsigned last = INVALID_SEGMENT;
+        unsigned length = 0;
+    };
+    static constexpr unsigned INVALID_SEGMENT = std::numeric_limits<unsigned>::max();
+
     SegmentWeight ClipWeight(const SegmentWeight weight);
     SegmentDuration ClipDuration(const SegmentDuration duration);
 
-    int free_list_maximum = 0;
+    SegmentList &GetOrCreateList(const EdgeID edge_id);
+    void Append(SegmentList &list, const OnewayCompressedEdge &segment);
+    void Compact();
+    bool IsCompacted() const { return !m_bucket_offsets.empty(); }
+
     std::atomic_size_t clipped_weights{0};
     std::atomic_size_t clipped_durations{0};
 
-    void IncreaseFreeList();
-    std::vector<OnewayEdgeBucket> m_compressed_oneway_geometries;
-    std::vector<unsigned> m_free_list;
-    std::unordered_map<EdgeID, unsigned> m_edge_id_to_list_index_map;
-    std::unordered_map<EdgeID, unsigned> m_forward_edge_id_to_zipped_index_map;
-    std::unordered_map<EdgeID, unsigned> m_reverse_edge_id_to_zipped_index_map;
+    // linked lists of segments by edge id, released by Compact
+    std::vector<SegmentList> m_segment_lists;
+    std::vector<OnewayCompressedEdge> m_segment_pool;
+    std::vector<unsigned> m_next_segment;
+
+    // segments of all edges ordered by edge id, the segments of an edge are in
+    // [m_bucket_offsets[edge_id], m_bucket_offsets[edge_id + 1])
+    std::vector<unsigned> m_bucket_offsets;
+    std::vector<OnewayCompressedEdge> m_segments;
+
+    std::vector<unsigned> m_forward_edge_id_to_zipped_index;
+    std::vector<unsigned> m_reverse_edge_id_to_zipped_index;
     std::unique_ptr<SegmentDataContainer> segment_data;
 };
 }
@@ -0,0 +1,157 @@
+#ifndef OSRM_EXTRACTOR_CONDITIONAL_TURN_MASKS_HPP
+#define OSRM_EXTRACTOR_CONDITIONAL_TURN_MASKS_HPP
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+// A week of local time in slots of 15 minutes, starting Monday 00:00
+const constexpr std::uint32_t MINUTES_PER_WEEK = 7 * 24 * 60;
+const constexpr std::uint32_t MINUTES_PER_TIME_SLOT = 15;
+const constexpr std::uint32_t TIME_SLOTS_PER_WEEK = MINUTES_PER_WEEK / MINUTES_PER_TIME_SLOT;
+const constexpr std::uint32_t TIME_SLOT_MASK_WORDS = (TIME_SLOTS_PER_WEEK + 63) / 64;
+
+// One bit per time slot of the week
+using TimeSlotMask = std::array<std::uint64_t, TIME_SLOT_MASK_WORDS>;
+
+inline void setTimeSlot(TimeSlotMask &mask, const std::uint32_t slot)
+{
+    BOOST_ASSERT(slot < TIME_SLOTS_PER_WEEK);
+    mask[slot / 64] |= std::uint64_t{1} << (slot % 64);
+}
+
+inline bool isTimeSlotEmpty(const TimeSlotMask &mask)
+{
+    return std::all_of(mask.begin(), mask.end(), [](const auto word) { return word == 0; });
+}
+
+// Turn of the edge-based graph that is forbidden in the time slots of its mask
+struct ConditionalTurn
+{
+    EdgeID turn;
+    NodeID source;
+    NodeID target;
+    TimeSlotMask mask;
+};
+
+namespace detail
+{
+template <storage::Ownership Ownership> class ConditionalTurnMasksImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+void read(storage::io::FileReader &reader, detail::ConditionalTurnMasksImpl<Ownership> &masks);
+
+template <storage::Ownership Ownership>
+void write(storage::io::FileWriter &writer,
+           const detail::ConditionalTurnMasksImpl<Ownership> &masks);
+}
+
+namespace detail
+{
+/**
+ * Turns with conditional restrictions and the time slots of the week they are restricted in,
+ * so the restrictions can be evaluated for the departure time of each query instead of once
+ * when the dataset is updated.
+ *
+ * The turns are sorted by their id, the edge-based nodes they connect locate them in the cells
+ * of the partition. A turn with several restrictions is restricted whenever one of them is.
+ */
+template <storage::Ownership Ownership> class ConditionalTurnMasksImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    ConditionalTurnMasksImpl() = default;
+
+    ConditionalTurnMasksImpl(Vector<EdgeID> turns,
+                             Vector<NodeID> sources,
+                             Vector<NodeID> targets,
+                             Vector<std::uint64_t> masks)
+        : turns(std::move(turns)), sources(std::move(sources)), targets(std::move(targets)),
+          masks(std::move(masks))
+    {
+        BOOST_ASSERT(this->masks.size() == this->turns.size() * TIME_SLOT_MASK_WORDS);
+    }
+
+    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    explicit ConditionalTurnMasksImpl(std::vector<ConditionalTurn> conditional_turns)
+    {
+        std::sort(conditional_turns.begin(),
+                  conditional_turns.end(),
+                  [](const auto &lhs, const auto &rhs) { return lhs.turn < rhs.turn; });
+
+        for (const auto &conditional_turn : conditional_turns)
+        {
+            if (turns.empty() || turns.back() != conditional_turn.turn)
+            {
+                turns.push_back(conditional_turn.turn);
+                sources.push_back(conditional_turn.source);
+                targets.push_back(conditional_turn.target);
+                masks.insert(masks.end(), TIME_SLOT_MASK_WORDS, 0);
+            }
+            auto mask = masks.end() - TIME_SLOT_MASK_WORDS;
+            for (const auto word : conditional_turn.mask)
+                *mask++ |= word;
+        }
+    }
+
+    std::size_t GetNumberOfTurns() const { return turns.size(); }
+
+    EdgeID GetTurnID(const std::size_t index) const { return turns[index]; }
+    NodeID GetSource(const std::size_t index) const { return sources[index]; }
+    NodeID GetTarget(const std::size_t index) const { return targets[index]; }
+
+    // minute_of_week counts from Monday 00:00 local time
+    bool IsRestricted(const std::size_t index, const std::uint32_t minute_of_week) const
+    {
+        BOOST_ASSERT(index < turns.size());
+        const auto slot = (minute_of_week % MINUTES_PER_WEEK) / MINUTES_PER_TIME_SLOT;
+        const auto word = masks[index * TIME_SLOT_MASK_WORDS + slot / 64];
+        return (word >> (slot % 64)) & 1;
+    }
+
+    bool IsTurnRestricted(const EdgeID turn, const std::uint32_t minute_of_week) const
+    {
+        const auto iter = std::lower_bound(turns.begin(), turns.end(), turn);
+        return iter != turns.end() && *iter == turn &&
+               IsRestricted(iter - turns.begin(), minute_of_week);
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               ConditionalTurnMasksImpl &masks);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const ConditionalTurnMasksImpl &masks);
+
+  private:
+    Vector<EdgeID> turns;
+    Vector<NodeID> sources;
+    Vector<NodeID> targets;
+    // TIME_SLOT_MASK_WORDS words per turn
+    Vector<std::uint64_t> masks;
+};
+}
+
+using ConditionalTurnMasks = detail::ConditionalTurnMasksImpl<storage::Ownership::Container>;
+using ConditionalTurnMasksView = detail::ConditionalTurnMasksImpl<storage::Ownership::View>;
+}
+}
+
+#endif
@@ -18,13 +18,13 @@
 #include "extractor/query_node.hpp"
 #include "extractor/restriction_map.hpp"
 
-#include "util/concurrent_id_map.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
 #include "util/name_table.hpp"
 #include "util/node_based_graph.hpp"
 #include "util/packed_vector.hpp"
+#include "util/sharded_id_map.hpp"
 #include "util/typedefs.hpp"
 
 #include "storage/io.hpp"
@@ -38,6 +38,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <boost/filesystem/fstream.hpp>
@@ -74,7 +75,7 @@ class EdgeBasedGraphFactory
     EdgeBasedGraphFactory(const EdgeBasedGraphFactory &) = delete;
     EdgeBasedGraphFactory &operator=(const EdgeBasedGraphFactory &) = delete;
 
-    explicit EdgeBasedGraphFactory(std::shared_ptr<util::NodeBasedDynamicGraph> node_based_graph,
+    explicit EdgeBasedGraphFactory(std::shared_ptr<util::NodeBasedStaticGraph> node_based_graph,
                                    CompressedEdgeContainer &compressed_edge_container,
                                    const std::unordered_set<NodeID> &barrier_nodes,
                                    const std::unordered_set<NodeID> &traffic_lights,
@@ -86,6 +87,7 @@ class EdgeBasedGraphFactory
                                    guidance::LaneDescriptionMap &lane_description_map);
 
     void Run(ScriptingEnvironment &scripting_environment,
+             const std::string &edge_based_graph_filename,
              const std::string &turn_data_filename,
              const std::string &turn_lane_data_filename,
              const std::string &turn_weight_penalties_filename,
@@ -94,7 +96,6 @@ class EdgeBasedGraphFactory
              const std::string &cnbg_ebg_mapping_path);
 
     // The following get access functions destroy the content in the factory
-    void GetEdgeBasedEdges(util::DeallocatingVector<EdgeBasedEdge> &edges);
     void GetEdgeBasedNodes(EdgeBasedNodeDataContainer &data_container);
     void GetEdgeBasedNodeSegments(std::vector<EdgeBasedNodeSegment> &nodes);
     void GetStartPointMarkers(std::vector<bool> &node_is_startpoint);
@@ -107,6 +108,7 @@ class EdgeBasedGraphFactory
     std::vector<util::guidance::EntryClass> GetEntryClasses() const;
 
     unsigned GetHighestEdgeID();
+    std::size_t GetNumberOfEdgeBasedEdges() const { return m_number_of_edge_based_edges; }
 
     // Basic analysis of a turn (u --(e1)-- v --(e2)-- w)
     // with known angle.
@@ -120,7 +122,7 @@ class EdgeBasedGraphFactory
                                           const double angle) const;
 
   private:
-    using EdgeData = util::NodeBasedDynamicGraph::EdgeData;
+    using EdgeData = util::NodeBasedStaticGraph::EdgeData;
 
     //! maps index from m_edge_based_node_list to ture/false if the node is an entry point to the
     //! graph
@@ -133,12 +135,13 @@ class EdgeBasedGraphFactory
     //! list of edge based nodes (compressed segments)
     std::vector<EdgeBasedNodeSegment> m_edge_based_node_segments;
     EdgeBasedNodeDataContainer m_edge_based_node_container;
-    util::DeallocatingVector<EdgeBasedEdge> m_edge_based_edge_list;
+    // the edges are written to the .ebg file while they are generated
+    std::size_t m_number_of_edge_based_edges;
     EdgeID m_max_edge_id;
 
     const std::vector<util::Coordinate> &m_coordinates;
     const extractor::PackedOSMIDs &m_osm_node_ids;
-    std::shared_ptr<util::NodeBasedDynamicGraph> m_node_based_graph;
+    std::shared_ptr<util::NodeBasedStaticGraph> m_node_based_graph;
     std::shared_ptr<RestrictionMap const> m_restriction_map;
 
     const std::unordered_set<NodeID> &m_barrier_nodes;
@@ -155,21 +158,38 @@ class EdgeBasedGraphFactory
     std::vector<NBGToEBG> GenerateEdgeExpandedNodes();
 
     void GenerateEdgeExpandedEdges(ScriptingEnvironment &scripting_environment,
+                                   const std::string &edge_based_graph_filename,
                                    const std::string &original_edge_data_filename,
                                    const std::string &turn_lane_data_filename,
                                    const std::string &turn_weight_penalties_filename,
                                    const std::string &turn_duration_penalties_filename,
                                    const std::string &turn_penalties_index_filename);
 
-    NBGToEBG InsertEdgeBasedNode(const NodeID u, const NodeID v);
+    // edge-based nodes generated for a block of node-based nodes
+    struct EdgeBasedNodeBlock
+    {
+        std::vector<NBGToEBG> mapping;
+        // forward and reverse node-based edge of every entry of the mapping
+        std::vector<std::pair<EdgeID, EdgeID>> edges;
+        std::vector<EdgeBasedNodeSegment> segments;
+        std::vector<bool> startpoints;
+    };
+    static constexpr std::size_t RENUMBER_BLOCK_SIZE = 64 * 1024;
+    static constexpr std::size_t GENERATE_NODES_BLOCK_SIZE = 16 * 1024;
+
+    // adds the segments of the node-based edge (u, v), safe to call for different blocks
+    // in parallel
+    void InsertEdgeBasedNode(const NodeID u, const NodeID v, EdgeBasedNodeBlock &block);
+    // zips the geometry of the edge-based nodes and sets their data, has to be called in order
+    void ZipEdgeBasedNode(const EdgeID forward_edge, const EdgeID reverse_edge);
 
     std::size_t restricted_turns_counter;
     std::size_t skipped_uturns_counter;
     std::size_t skipped_barrier_turns_counter;
 
-    util::ConcurrentIDMap<util::guidance::BearingClass, BearingClassID> bearing_class_hash;
+    util::ShardedIDMap<util::guidance::BearingClass, BearingClassID> bearing_class_hash;
     std::vector<BearingClassID> bearing_class_by_node_based_node;
-    util::ConcurrentIDMap<util::guidance::EntryClass, EntryClassID> entry_class_hash;
+    util::ShardedIDMap<util::guidance::EntryClass, EntryClassID> entry_class_hash;
 };
 } // namespace extractor
 } // namespace osrm
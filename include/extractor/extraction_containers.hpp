@@ -1,18 +1,26 @@
 #ifndef EXTRACTION_CONTAINERS_HPP
 #define EXTRACTION_CONTAINERS_HPP
 
+#include "extractor/extractor_config.hpp"
 #include "extractor/first_and_last_segment_of_way.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/internal_extractor_edge.hpp"
 #include "extractor/query_node.hpp"
 #include "extractor/restriction.hpp"
 #include "extractor/scripting_environment.hpp"
+#include "extractor/way_index.hpp"
 
 #include "storage/io.hpp"
 
+#include <osmium/index/map.hpp>
+#include <osmium/osm/location.hpp>
+#include <osmium/osm/types.hpp>
+
 #include <cstdint>
+#include <memory>
 #include <stxxl/vector>
 #include <unordered_map>
+#include <vector>
 
 namespace osrm
 {
@@ -24,6 +32,14 @@ namespace extractor
  * is collected by the extractor callbacks.
  *
  * The data is the filtered, aggregated and finally written to disk.
+ *
+ * The coordinates of the nodes are either kept in all_nodes_list, which is sorted by OSM id and
+ * merged with the used nodes and the edges sorted by their source and target, or in an index by
+ * OSM id, which resolves the coordinates of the edges by lookups without sorting them.
+ *
+ * The internal node ids follow the OSM ids of the nodes, or the Hilbert curve through their
+ * coordinates if the nodes are renumbered spatially. Then neighbouring intersections and their
+ * geometries are close in memory in the node-based graph and all data derived from it.
  */
 class ExtractionContainers
 {
@@ -36,43 +52,73 @@ class ExtractionContainers
 #endif
     void FlushVectors();
     void PrepareNodes();
+    void RenumberNodes();
     void PrepareRestrictions();
     void PrepareEdges(ScriptingEnvironment &scripting_environment);
+    void MergeEdgesWithNodes(ScriptingEnvironment &scripting_environment);
+    void LookupEdgeNodes(ScriptingEnvironment &scripting_environment);
 
     void WriteNodes(storage::io::FileWriter &file_out) const;
     void WriteRestrictions(const std::string &restrictions_file_name);
     void WriteEdges(storage::io::FileWriter &file_out) const;
     void WriteCharData(const std::string &file_name);
 
+    // Calls the callback with the used nodes in the order of their OSM ids
+    template <typename CallbackT> void ForEachUsedNode(const CallbackT &callback) const;
+
   public:
     using STXXLNodeIDVector = stxxl::vector<OSMNodeID>;
     using STXXLNodeVector = stxxl::vector<QueryNode>;
     using STXXLEdgeVector = stxxl::vector<InternalExtractorEdge>;
     using RestrictionsVector = std::vector<InputRestrictionContainer>;
     using STXXLWayIDStartEndVector = stxxl::vector<FirstAndLastSegmentOfWay>;
+    using STXXLWayNodesVector = stxxl::vector<WayNodes>;
     using STXXLNameCharData = stxxl::vector<unsigned char>;
     using STXXLNameOffsets = stxxl::vector<unsigned>;
+    // the fixed point coordinates of OSRM stored as the integer pair of a location
+    using NodeLocationIndex =
+        osmium::index::map::Map<osmium::unsigned_object_id_type, osmium::Location>;
 
     std::vector<OSMNodeID> barrier_nodes;
     std::vector<OSMNodeID> traffic_lights;
     STXXLNodeIDVector used_node_id_list;
     STXXLNodeVector all_nodes_list;
+    // replaces all_nodes_list if set
+    std::unique_ptr<NodeLocationIndex> node_locations;
     STXXLEdgeVector all_edges_list;
     STXXLNameCharData name_char_data;
     STXXLNameOffsets name_offsets;
     // an adjacency array containing all turn lane masks
     RestrictionsVector restrictions_list;
     STXXLWayIDStartEndVector way_start_end_id_list;
+    // the routable ways and their nodes in the order they were parsed in, only collected for
+    // the way index
+    bool way_index;
+    STXXLWayNodesVector way_nodes_list;
+    STXXLNodeIDVector way_node_id_list;
     std::unordered_map<OSMNodeID, NodeID> external_to_internal_node_id_map;
     unsigned max_internal_node_id;
+    // renumber the nodes along the Hilbert curve through their coordinates
+    bool spatial_node_order;
+    // the internal id of each used node in the order of OSM ids, empty if not renumbered
+    std::vector<NodeID> spatial_node_ids;
     std::vector<TurnRestriction> unconditional_turn_restrictions;
+    // repeated strings of the name data are written as references to their first copy
+    bool deduplicate_names;
 
-    ExtractionContainers();
+    explicit ExtractionContainers(
+        ExtractorConfig::NodeLocations locations = ExtractorConfig::NodeLocations::Sorted,
+        bool deduplicate_names = false,
+        bool spatial_node_order = false,
+        bool way_index = false);
 
     void PrepareData(ScriptingEnvironment &scripting_environment,
                      const std::string &output_file_name,
                      const std::string &restrictions_file_name,
                      const std::string &names_file_name);
+
+    // Writes the nodes of the routable ways by their OSM id
+    void WriteWayIndex(const std::string &way_index_file_name);
 };
 }
 }
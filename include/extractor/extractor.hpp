@@ -53,11 +53,35 @@ class Extractor
     Extractor(ExtractorConfig extractor_config) : config(std::move(extractor_config)) {}
     int run(ScriptingEnvironment &scripting_environment);
 
+    // Extracts the datasets of several profiles from a single parse of the input. The configs of
+    // the extractors only differ in the profile and the output files, each extractor runs the
+    // profile of the scripting environment at its index.
+    static int run(const std::vector<Extractor *> &extractors,
+                   const std::vector<ScriptingEnvironment *> &scripting_environments);
+
   private:
+    using ParseResult = std::tuple<guidance::LaneDescriptionMap, std::vector<TurnRestriction>>;
+
     ExtractorConfig config;
 
-    std::tuple<guidance::LaneDescriptionMap, std::vector<TurnRestriction>>
-    ParseOSMData(ScriptingEnvironment &scripting_environment, const unsigned number_of_threads);
+    // Reads the input once and runs the profiles of all extractors on every buffer, the result
+    // of each extractor is at its index
+    static std::vector<ParseResult>
+    ParseOSMData(const std::vector<Extractor *> &extractors,
+                 const std::vector<ScriptingEnvironment *> &scripting_environments,
+                 const unsigned number_of_threads);
+
+    // Expands the parsed graph into the edge based graph and writes the files of the dataset
+    void BuildDataset(ScriptingEnvironment &scripting_environment,
+                      guidance::LaneDescriptionMap &turn_lane_map,
+                      std::vector<TurnRestriction> &turn_restrictions);
+
+    // The checkpoint marks the files of ParseOSMData as complete and keeps the results that are
+    // only held in memory, so that --resume can skip parsing and sorting the input again.
+    void WriteParseCheckpoint(const guidance::LaneDescriptionMap &turn_lane_map,
+                              const std::vector<TurnRestriction> &turn_restrictions) const;
+    bool ReadParseCheckpoint(guidance::LaneDescriptionMap &turn_lane_map,
+                             std::vector<TurnRestriction> &turn_restrictions) const;
 
     std::pair<std::size_t, EdgeID>
     BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
@@ -67,17 +91,17 @@ class Extractor
                            std::vector<EdgeBasedNodeSegment> &edge_based_node_segments,
                            std::vector<bool> &node_is_startpoint,
                            std::vector<EdgeWeight> &edge_based_node_weights,
-                           util::DeallocatingVector<EdgeBasedEdge> &edge_based_edge_list,
                            const std::string &intersection_class_output_file,
                            std::vector<TurnRestriction> &turn_restrictions,
                            guidance::LaneDescriptionMap &turn_lane_map);
     void FindComponents(unsigned max_edge_id,
-                        const util::DeallocatingVector<EdgeBasedEdge> &input_edge_list,
+                        const std::string &edge_based_graph_path,
                         const std::vector<EdgeBasedNodeSegment> &input_node_segments,
                         EdgeBasedNodeDataContainer &nodes_container) const;
     void BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_segments,
                     std::vector<bool> node_is_startpoint,
-                    const std::vector<util::Coordinate> &coordinates);
+                    const std::vector<util::Coordinate> &coordinates,
+                    const EdgeBasedNodeDataContainer &nodes_container);
     std::shared_ptr<RestrictionMap> LoadRestrictionMap();
     std::shared_ptr<util::NodeBasedDynamicGraph>
     LoadNodeBasedGraph(std::unordered_set<NodeID> &barrier_nodes,
@@ -91,9 +115,12 @@ class Extractor
         const std::vector<util::guidance::BearingClass> &bearing_classes,
         const std::vector<util::guidance::EntryClass> &entry_classes) const;
 
+    // Writes the turn penalties of the edge-based graph as matrices per intersection.
+    void WriteTurnCostTable() const;
+
     // Writes compressed node based graph and its embedding into a file for osrm-partition to use.
     static void WriteCompressedNodeBasedGraph(const std::string &path,
-                                              const util::NodeBasedDynamicGraph &graph,
+                                              const util::NodeBasedStaticGraph &graph,
                                               const std::vector<util::Coordinate> &coordiantes);
 };
 }
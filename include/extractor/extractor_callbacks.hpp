@@ -2,14 +2,19 @@
 #define EXTRACTOR_CALLBACKS_HPP
 
 #include "extractor/class_data.hpp"
+#include "extractor/first_and_last_segment_of_way.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
+#include "extractor/internal_extractor_edge.hpp"
+#include "extractor/query_node.hpp"
+#include "extractor/restriction.hpp"
+#include "util/concurrent_string_table.hpp"
 #include "util/typedefs.hpp"
 
-#include <boost/functional/hash.hpp>
 #include <boost/optional/optional_fwd.hpp>
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace osmium
 {
@@ -17,25 +22,6 @@ class Node;
 class Way;
 }
 
-namespace std
-{
-template <> struct hash<std::tuple<std::string, std::string, std::string, std::string, std::string>>
-{
-    std::size_t operator()(
-        const std::tuple<std::string, std::string, std::string, std::string, std::string> &mk) const
-        noexcept
-    {
-        std::size_t seed = 0;
-        boost::hash_combine(seed, std::get<0>(mk));
-        boost::hash_combine(seed, std::get<1>(mk));
-        boost::hash_combine(seed, std::get<2>(mk));
-        boost::hash_combine(seed, std::get<3>(mk));
-        boost::hash_combine(seed, std::get<4>(mk));
-        return seed;
-    }
-};
-}
-
 namespace osrm
 {
 namespace extractor
@@ -52,16 +38,19 @@ struct ProfileProperties;
  * osmium based parsing and the customization through the lua profile.
  *
  * It mediates between the multi-threaded extraction process and the external memory containers.
- * Thus the synchronization is handled inside of the extractor.
+ * The results of a buffer are converted into a Fragment by the threads that parsed them, names
+ * are looked up in the concurrent name table and turn lane descriptions and classes are
+ * numbered per fragment. Store adds the new names and assigns the global ids in the order of
+ * the fragments and appends them to the external memory containers, so the ids do not depend on
+ * the number of threads.
  */
 class ExtractorCallbacks
 {
   private:
     // used to deduplicate street names, refs, destinations, pronunciation, exits:
-    // actually maps to name ids
-    using MapKey = std::tuple<std::string, std::string, std::string, std::string, std::string>;
-    using MapVal = unsigned;
-    std::unordered_map<MapKey, MapVal> string_map;
+    // maps the name, destinations, pronunciation, ref and exits joined by '\0' to name ids
+    using NameTable = util::ConcurrentStringTable<NameID>;
+    NameTable string_map;
     ExtractionContainers &external_memory;
     std::unordered_map<std::string, ClassData> &classes_map;
     guidance::LaneDescriptionMap &lane_description_map;
@@ -71,6 +60,40 @@ class ExtractorCallbacks
   public:
     using ClassesMap = std::unordered_map<std::string, ClassData>;
 
+    // Nodes, edges and restrictions of a buffer. The name ids, lane description ids and class
+    // bits of the edges index into the name ids, lane descriptions and classes of the fragment.
+    class Fragment
+    {
+        friend class ExtractorCallbacks;
+
+      public:
+        Fragment() = default;
+        Fragment(const Fragment &) = delete;
+        Fragment &operator=(const Fragment &) = delete;
+
+      private:
+        std::vector<QueryNode> nodes;
+        std::vector<OSMNodeID> barrier_nodes;
+        std::vector<OSMNodeID> traffic_lights;
+        std::vector<InternalExtractorEdge> edges;
+        std::vector<OSMNodeID> used_node_ids;
+        std::vector<FirstAndLastSegmentOfWay> ways;
+        // number of used node ids of every way, only kept for the way index
+        std::vector<std::uint32_t> way_node_counts;
+        std::vector<InputRestrictionContainer> restrictions;
+
+        // global name ids found while converting, names that were not known yet are kept with
+        // their hash in name_data until Store adds them
+        std::vector<NameID> name_ids;
+        std::vector<std::size_t> name_hashes;
+        std::vector<std::size_t> name_offsets;
+        std::string name_data;
+        std::string name_key;
+        std::unordered_map<std::string, LaneDescriptionID> lane_indices;
+        std::vector<guidance::TurnLaneDescription> lane_descriptions;
+        std::vector<std::string> classes;
+    };
+
     explicit ExtractorCallbacks(ExtractionContainers &extraction_containers,
                                 std::unordered_map<std::string, ClassData> &classes_map,
                                 guidance::LaneDescriptionMap &lane_description_map,
@@ -79,14 +102,22 @@ class ExtractorCallbacks
     ExtractorCallbacks(const ExtractorCallbacks &) = delete;
     ExtractorCallbacks &operator=(const ExtractorCallbacks &) = delete;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessNode(const osmium::Node &current_node, const ExtractionNode &result_node);
+    // thread safe for different fragments
+    void ProcessNode(Fragment &fragment,
+                     const osmium::Node &current_node,
+                     const ExtractionNode &result_node) const;
+
+    // thread safe for different fragments
+    void ProcessRestriction(Fragment &fragment,
+                            const boost::optional<InputRestrictionContainer> &restriction) const;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessRestriction(const boost::optional<InputRestrictionContainer> &restriction);
+    // thread safe for different fragments
+    void ProcessWay(Fragment &fragment,
+                    const osmium::Way &current_way,
+                    const ExtractionWay &result_way) const;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessWay(const osmium::Way &current_way, const ExtractionWay &result_way);
+    // warning: caller needs to take care of synchronization and of the order of the fragments!
+    void Store(Fragment &fragment);
 };
 }
 }
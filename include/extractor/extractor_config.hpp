@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <array>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -40,8 +41,23 @@ namespace extractor
 
 struct ExtractorConfig
 {
-    ExtractorConfig() noexcept : requested_num_threads(0) {}
-    void UseDefaultOutputNames()
+    // Where the coordinates of all nodes are kept until the used nodes are known
+    enum class NodeLocations
+    {
+        Sorted, // external memory list, sorted and merged with the nodes and the edges
+        Dense,  // array indexed by the OSM id, for inputs with most nodes of the planet
+        Sparse  // (id, coordinate) pairs sorted once, for extracts
+    };
+
+    ExtractorConfig() noexcept
+        : requested_num_threads(0), resume(false), routing_only(false), two_pass_parsing(false),
+          deduplicate_names(false), spatial_node_order(false), way_index(false),
+          node_locations(NodeLocations::Sorted), turn_cost_tables(false)
+    {
+    }
+    // With a dataset name the files are named <input>.<dataset>.osrm*, so that the datasets of
+    // several profiles extracted from the same input are kept apart
+    void UseDefaultOutputNames(const std::string &dataset_name = "")
     {
         std::string basepath = input_path.string();
 
@@ -57,6 +73,10 @@ struct ExtractorConfig
                 break;
             }
         }
+        if (!dataset_name.empty())
+        {
+            basepath += "." + dataset_name;
+        }
 
         output_file_name = basepath + ".osrm";
         restriction_file_name = basepath + ".osrm.restrictions";
@@ -74,14 +94,19 @@ struct ExtractorConfig
         turn_duration_penalties_path = basepath + ".osrm.turn_duration_penalties";
         turn_weight_penalties_path = basepath + ".osrm.turn_weight_penalties";
         turn_penalties_index_path = basepath + ".osrm.turn_penalties_index";
+        turn_cost_table_path = basepath + ".osrm.turn_costs";
         edge_based_node_weights_output_path = basepath + ".osrm.enw";
         profile_properties_output_path = basepath + ".osrm.properties";
         intersection_class_data_output_path = basepath + ".osrm.icd";
         compressed_node_based_graph_output_path = basepath + ".osrm.cnbg";
         cnbg_ebg_graph_mapping_output_path = basepath + ".osrm.cnbg_to_ebg";
+        parse_checkpoint_path = basepath + ".osrm.checkpoint";
+        way_index_path = basepath + ".osrm.way_index";
     }
 
     boost::filesystem::path input_path;
+    // change files that are applied to the input in this order
+    std::vector<boost::filesystem::path> change_paths;
     boost::filesystem::path profile_path;
 
     std::string output_file_name;
@@ -104,15 +129,34 @@ struct ExtractorConfig
     std::string turn_duration_penalties_path;
     std::string compressed_node_based_graph_output_path;
     std::string cnbg_ebg_graph_mapping_output_path;
+    std::string parse_checkpoint_path;
+    std::string way_index_path;
 
     unsigned requested_num_threads;
     unsigned small_component_size;
 
     bool generate_edge_lookup;
     std::string turn_penalties_index_path;
+    std::string turn_cost_table_path;
 
     bool use_metadata;
     bool parse_conditionals;
+    // skip parsing if the checkpoint of a previous run matches the input
+    bool resume;
+    // only compute what routing needs, no guidance data for turn-by-turn instructions
+    bool routing_only;
+    // read the ways first and then only the nodes they use
+    bool two_pass_parsing;
+    // store repeated names, refs and destinations once
+    bool deduplicate_names;
+    // number the nodes along a Hilbert curve instead of by their OSM ids
+    bool spatial_node_order;
+    // write the nodes of every routable way by its OSM id for speed updates of whole ways
+    bool way_index;
+    NodeLocations node_locations;
+    // experimental: write the turn penalties of every intersection as a matrix for routing on the
+    // node-based graph
+    bool turn_cost_tables;
 };
 }
 }
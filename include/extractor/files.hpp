@@ -1,11 +1,13 @@
 #ifndef OSRM_EXTRACTOR_FILES_HPP
 #define OSRM_EXTRACTOR_FILES_HPP
 
+#include "extractor/conditional_turn_masks.hpp"
 #include "extractor/edge_based_edge.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/node_data_container.hpp"
 #include "extractor/profile_properties.hpp"
 #include "extractor/serialization.hpp"
+#include "extractor/turn_cost_table.hpp"
 #include "extractor/turn_data_container.hpp"
 
 #include "util/coordinate.hpp"
@@ -211,6 +213,87 @@ inline void readTurnData(const boost::filesystem::path &path, TurnDataT &turn_da
     serialization::read(reader, turn_data);
 }
 
+// reads .osrm.turn_costs
+template <typename TurnCostTableT>
+inline void readTurnCostTable(const boost::filesystem::path &path, TurnCostTableT &turn_costs)
+{
+    static_assert(std::is_same<TurnCostTable, TurnCostTableT>::value ||
+                      std::is_same<TurnCostTableView, TurnCostTableT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, turn_costs);
+}
+
+// writes .osrm.turn_costs
+template <typename TurnCostTableT>
+inline void writeTurnCostTable(const boost::filesystem::path &path,
+                               const TurnCostTableT &turn_costs)
+{
+    static_assert(std::is_same<TurnCostTable, TurnCostTableT>::value ||
+                      std::is_same<TurnCostTableView, TurnCostTableT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, turn_costs);
+}
+
+// reads .osrm.way_index
+template <typename WayIndexT>
+inline void readWayIndex(const boost::filesystem::path &path, WayIndexT &index)
+{
+    static_assert(std::is_same<WayIndex, WayIndexT>::value ||
+                      std::is_same<WayIndexView, WayIndexT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, index);
+}
+
+// writes .osrm.way_index
+template <typename WayIndexT>
+inline void writeWayIndex(const boost::filesystem::path &path, const WayIndexT &index)
+{
+    static_assert(std::is_same<WayIndex, WayIndexT>::value ||
+                      std::is_same<WayIndexView, WayIndexT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, index);
+}
+
+// reads .osrm.conditional_turns
+template <typename ConditionalTurnMasksT>
+inline void readConditionalTurnMasks(const boost::filesystem::path &path,
+                                     ConditionalTurnMasksT &masks)
+{
+    static_assert(std::is_same<ConditionalTurnMasks, ConditionalTurnMasksT>::value ||
+                      std::is_same<ConditionalTurnMasksView, ConditionalTurnMasksT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, masks);
+}
+
+// writes .osrm.conditional_turns
+template <typename ConditionalTurnMasksT>
+inline void writeConditionalTurnMasks(const boost::filesystem::path &path,
+                                      const ConditionalTurnMasksT &masks)
+{
+    static_assert(std::is_same<ConditionalTurnMasks, ConditionalTurnMasksT>::value ||
+                      std::is_same<ConditionalTurnMasksView, ConditionalTurnMasksT>::value,
+                  "");
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, masks);
+}
+
 // writes .osrm.edges
 template <typename TurnDataT>
 inline void writeTurnData(const boost::filesystem::path &path, const TurnDataT &turn_data)
@@ -25,7 +25,7 @@ namespace extractor
 // generate a visualisation of an intersection, printing the coordinates used for angle calculation
 template <typename IntersectionType> struct IntersectionPrinter
 {
-    IntersectionPrinter(const util::NodeBasedDynamicGraph &node_based_graph,
+    IntersectionPrinter(const util::NodeBasedStaticGraph &node_based_graph,
                         const std::vector<extractor::QueryNode> &node_coordinates,
                         const extractor::guidance::CoordinateExtractor &coordinate_extractor);
 
@@ -36,7 +36,7 @@ template <typename IntersectionType> struct IntersectionPrinter
                                  const boost::optional<util::json::Object> &node_style = {},
                                  const boost::optional<util::json::Object> &way_style = {}) const;
 
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const std::vector<extractor::QueryNode> &node_coordinates;
     const extractor::guidance::CoordinateExtractor &coordinate_extractor;
 };
@@ -44,7 +44,7 @@ template <typename IntersectionType> struct IntersectionPrinter
 // IMPLEMENTATION
 template <typename IntersectionType>
 IntersectionPrinter<IntersectionType>::IntersectionPrinter(
-    const util::NodeBasedDynamicGraph &node_based_graph,
+    const util::NodeBasedStaticGraph &node_based_graph,
     const std::vector<extractor::QueryNode> &node_coordinates,
     const extractor::guidance::CoordinateExtractor &coordinate_extractor)
     : node_based_graph(node_based_graph), node_coordinates(node_coordinates),
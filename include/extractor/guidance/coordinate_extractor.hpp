@@ -21,7 +21,7 @@ namespace guidance
 class CoordinateExtractor
 {
   public:
-    CoordinateExtractor(const util::NodeBasedDynamicGraph &node_based_graph,
+    CoordinateExtractor(const util::NodeBasedStaticGraph &node_based_graph,
                         const extractor::CompressedEdgeContainer &compressed_geometries,
                         const std::vector<util::Coordinate> &node_coordinates);
 
@@ -154,7 +154,7 @@ class CoordinateExtractor
                       const double rate) const;
 
   private:
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const extractor::CompressedEdgeContainer &compressed_geometries;
     const std::vector<util::Coordinate> &node_coordinates;
 
@@ -59,7 +59,7 @@ inline auto makeCompareAngularDeviation(const double angle)
     };
 }
 
-inline auto makeExtractLanesForRoad(const util::NodeBasedDynamicGraph &node_based_graph)
+inline auto makeExtractLanesForRoad(const util::NodeBasedStaticGraph &node_based_graph)
 {
     return [&node_based_graph](const auto &road) {
         return node_based_graph.GetEdgeData(road.eid).road_classification.GetNumberOfLanes();
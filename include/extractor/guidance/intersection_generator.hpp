@@ -5,6 +5,7 @@
 #include "extractor/guidance/coordinate_extractor.hpp"
 #include "extractor/guidance/intersection.hpp"
 #include "extractor/guidance/intersection_normalization_operation.hpp"
+#include "extractor/guidance/intersection_shape_cache.hpp"
 #include "extractor/query_node.hpp"
 #include "extractor/restriction_map.hpp"
 #include "util/attributes.hpp"
@@ -17,6 +18,8 @@
 
 #include <boost/optional.hpp>
 
+#include <tbb/enumerable_thread_specific.h>
+
 namespace osrm
 {
 namespace extractor
@@ -37,7 +40,7 @@ struct IntersectionGenerationParameters
 class IntersectionGenerator
 {
   public:
-    IntersectionGenerator(const util::NodeBasedDynamicGraph &node_based_graph,
+    IntersectionGenerator(const util::NodeBasedStaticGraph &node_based_graph,
                           const RestrictionMap &restriction_map,
                           const std::unordered_set<NodeID> &barrier_nodes,
                           const std::vector<util::Coordinate> &coordinates,
@@ -77,6 +80,9 @@ class IntersectionGenerator
     // Allow access to the coordinate extractor for all owners
     const CoordinateExtractor &GetCoordinateExtractor() const;
 
+    // Hits and misses of the intersection shape caches of all threads
+    std::pair<std::size_t, std::size_t> GetShapeCacheStatistics() const;
+
     // Check for restrictions/barriers and generate a list of valid and invalid turns present at
     // the node reached from `from_node` via `via_eid`. The resulting candidates have to be analysed
     // for their actual instructions later on.
@@ -109,7 +115,7 @@ class IntersectionGenerator
         const std::vector<IntersectionNormalizationOperation> &merging_map) const;
 
   private:
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const RestrictionMap &restriction_map;
     const std::unordered_set<NodeID> &barrier_nodes;
     const std::vector<util::Coordinate> &coordinates;
@@ -117,6 +123,13 @@ class IntersectionGenerator
     // own state, used to find the correct coordinates along a road
     const CoordinateExtractor coordinate_extractor;
 
+    // the shapes are shared by all handlers that look at an intersection, one cache per thread
+    mutable tbb::enumerable_thread_specific<IntersectionShapeCache> shape_caches;
+
+    // the shape of an intersection in the order of the adjacent edges
+    IntersectionShape ComputeUnsortedIntersectionShape(const NodeID center_node,
+                                                       const bool use_low_precision_angles) const;
+
     // check turn restrictions to find a node that is the only allowed target when coming from a
     // node to an intersection
     //     d
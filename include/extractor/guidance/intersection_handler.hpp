@@ -32,7 +32,7 @@ namespace guidance
 class IntersectionHandler
 {
   public:
-    IntersectionHandler(const util::NodeBasedDynamicGraph &node_based_graph,
+    IntersectionHandler(const util::NodeBasedStaticGraph &node_based_graph,
                         const std::vector<util::Coordinate> &coordinates,
                         const util::NameTable &name_table,
                         const SuffixTable &street_name_suffix_table,
@@ -49,7 +49,7 @@ class IntersectionHandler
     operator()(const NodeID nid, const EdgeID via_eid, Intersection intersection) const = 0;
 
   protected:
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const std::vector<util::Coordinate> &coordinates;
     const util::NameTable &name_table;
     const SuffixTable &street_name_suffix_table;
@@ -124,7 +124,7 @@ std::size_t IntersectionHandler::findObviousTurn(const EdgeID via_edge,
                                                  const IntersectionType &intersection) const
 {
     using Road = typename IntersectionType::value_type;
-    using EdgeData = osrm::util::NodeBasedDynamicGraph::EdgeData;
+    using EdgeData = osrm::util::NodeBasedStaticGraph::EdgeData;
     using osrm::util::angularDeviation;
 
     // no obvious road
@@ -42,7 +42,7 @@ class IntersectionNormalizer
         IntersectionShape normalized_shape;
         std::vector<IntersectionNormalizationOperation> performed_merges;
     };
-    IntersectionNormalizer(const util::NodeBasedDynamicGraph &node_based_graph,
+    IntersectionNormalizer(const util::NodeBasedStaticGraph &node_based_graph,
                            const std::vector<util::Coordinate> &node_coordinates,
                            const util::NameTable &name_table,
                            const SuffixTable &street_name_suffix_table,
@@ -55,7 +55,7 @@ class IntersectionNormalizer
                                    IntersectionShape intersection) const;
 
   private:
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const IntersectionGenerator &intersection_generator;
     const MergableRoadDetector mergable_road_detector;
 
@@ -0,0 +1,65 @@
+#ifndef OSRM_EXTRACTOR_GUIDANCE_INTERSECTION_SHAPE_CACHE_HPP_
+#define OSRM_EXTRACTOR_GUIDANCE_INTERSECTION_SHAPE_CACHE_HPP_
+
+#include "extractor/guidance/intersection.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+namespace guidance
+{
+
+// Direct mapped cache of the intersection shapes computed by one thread. The handlers look at
+// the same intersections again and again while following roads, and the nodes of a range of
+// intersections are processed by one thread, so most shapes are found in a small cache.
+// Shapes are stored in the order of the adjacent edges, before sorting them by angle.
+class IntersectionShapeCache
+{
+  public:
+    static constexpr std::size_t DEFAULT_SIZE = 4 * 1024;
+
+    explicit IntersectionShapeCache(const std::size_t size = DEFAULT_SIZE) : slots(size) {}
+
+    template <typename ComputeShape>
+    const IntersectionShape &
+    Get(const NodeID node, const bool use_low_precision_angles, const ComputeShape &compute_shape)
+    {
+        auto &slot = slots[(2 * static_cast<std::size_t>(node) + use_low_precision_angles) %
+                           slots.size()];
+        if (slot.node == node && slot.use_low_precision_angles == use_low_precision_angles)
+        {
+            ++hits;
+            return slot.shape;
+        }
+
+        ++misses;
+        slot.node = node;
+        slot.use_low_precision_angles = use_low_precision_angles;
+        slot.shape = compute_shape();
+        return slot.shape;
+    }
+
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+
+  private:
+    struct Slot
+    {
+        NodeID node = SPECIAL_NODEID;
+        bool use_low_precision_angles = false;
+        IntersectionShape shape;
+    };
+
+    std::vector<Slot> slots;
+};
+
+} // namespace guidance
+} // namespace extractor
+} // namespace osrm
+
+#endif /* OSRM_EXTRACTOR_GUIDANCE_INTERSECTION_SHAPE_CACHE_HPP_ */
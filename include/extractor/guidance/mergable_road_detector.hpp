@@ -36,7 +36,7 @@ class MergableRoadDetector
     // in case we have to change the mode we are operating on
     using MergableRoadData = IntersectionShapeData;
 
-    MergableRoadDetector(const util::NodeBasedDynamicGraph &node_based_graph,
+    MergableRoadDetector(const util::NodeBasedStaticGraph &node_based_graph,
                          const std::vector<util::Coordinate> &node_coordinates,
                          const IntersectionGenerator &intersection_generator,
                          const CoordinateExtractor &coordinate_extractor,
@@ -137,7 +137,7 @@ class MergableRoadDetector
     // The detector wants to prevent merges that are connected to `b-e`
     bool IsLinkRoad(const NodeID intersection_node, const MergableRoadData &road) const;
 
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const std::vector<util::Coordinate> &node_coordinates;
     const IntersectionGenerator &intersection_generator;
     const CoordinateExtractor &coordinate_extractor;
@@ -27,7 +27,7 @@ namespace guidance
 class NodeBasedGraphWalker
 {
   public:
-    NodeBasedGraphWalker(const util::NodeBasedDynamicGraph &node_based_graph,
+    NodeBasedGraphWalker(const util::NodeBasedStaticGraph &node_based_graph,
                          const IntersectionGenerator &intersection_generator);
 
     /*
@@ -45,7 +45,7 @@ class NodeBasedGraphWalker
                                                             const selector_type &selector) const;
 
   private:
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const IntersectionGenerator &intersection_generator;
 };
 
@@ -106,7 +106,7 @@ struct SelectRoadByNameOnlyChoiceAndStraightness
     boost::optional<EdgeID> operator()(const NodeID nid,
                                        const EdgeID via_edge_id,
                                        const IntersectionView &intersection,
-                                       const util::NodeBasedDynamicGraph &node_based_graph) const;
+                                       const util::NodeBasedStaticGraph &node_based_graph) const;
 
   private:
     const NameID desired_name_id;
@@ -131,7 +131,7 @@ struct SelectStraightmostRoadByNameAndOnlyChoice
     boost::optional<EdgeID> operator()(const NodeID nid,
                                        const EdgeID via_edge_id,
                                        const IntersectionView &intersection,
-                                       const util::NodeBasedDynamicGraph &node_based_graph) const;
+                                       const util::NodeBasedStaticGraph &node_based_graph) const;
 
   private:
     const NameID desired_name_id;
@@ -224,7 +224,7 @@ struct SkipTrafficSignalBarrierRoadSelector
     boost::optional<EdgeID> operator()(const NodeID,
                                        const EdgeID,
                                        const IntersectionView &intersection,
-                                       const util::NodeBasedDynamicGraph &) const
+                                       const util::NodeBasedStaticGraph &) const
     {
         if (intersection.isTrafficSignalOrBarrier())
         {
@@ -241,7 +241,7 @@ struct DistanceToNextIntersectionAccumulator
 {
     DistanceToNextIntersectionAccumulator(
         const extractor::guidance::CoordinateExtractor &extractor_,
-        const util::NodeBasedDynamicGraph &graph_,
+        const util::NodeBasedStaticGraph &graph_,
         const double threshold)
         : extractor{extractor_}, graph{graph_}, threshold{threshold}
     {
@@ -267,7 +267,7 @@ struct DistanceToNextIntersectionAccumulator
     }
 
     const extractor::guidance::CoordinateExtractor &extractor;
-    const util::NodeBasedDynamicGraph &graph;
+    const util::NodeBasedStaticGraph &graph;
     const double threshold;
     bool too_far_away = false;
     double distance = 0.;
@@ -40,7 +40,7 @@ namespace guidance
 class TurnAnalysis
 {
   public:
-    TurnAnalysis(const util::NodeBasedDynamicGraph &node_based_graph,
+    TurnAnalysis(const util::NodeBasedStaticGraph &node_based_graph,
                  const std::vector<util::Coordinate> &coordinates,
                  const RestrictionMap &restriction_map,
                  const std::unordered_set<NodeID> &barrier_nodes,
@@ -80,7 +80,7 @@ class TurnAnalysis
     const IntersectionGenerator &GetIntersectionGenerator() const;
 
   private:
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     const IntersectionGenerator intersection_generator;
     const IntersectionNormalizer intersection_normalizer;
     const RoundaboutHandler roundabout_handler;
@@ -22,7 +22,7 @@ bool findPreviousIntersection(
     const EdgeID via_edge,
     const Intersection &intersection,
     const IntersectionGenerator &intersection_generator,
-    const util::NodeBasedDynamicGraph &node_based_graph, // query edge data
+    const util::NodeBasedStaticGraph &node_based_graph, // query edge data
     // output parameters, will be in an arbitrary state on failure
     NodeID &result_node,
     EdgeID &result_via_edge,
@@ -27,7 +27,7 @@ namespace guidance
 class TurnHandler : public IntersectionHandler
 {
   public:
-    TurnHandler(const util::NodeBasedDynamicGraph &node_based_graph,
+    TurnHandler(const util::NodeBasedStaticGraph &node_based_graph,
                 const std::vector<util::Coordinate> &coordinates,
                 const util::NameTable &name_table,
                 const SuffixTable &street_name_suffix_table,
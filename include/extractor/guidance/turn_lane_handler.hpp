@@ -72,7 +72,7 @@ class TurnLaneHandler
   public:
     typedef std::vector<TurnLaneData> LaneDataVector;
 
-    TurnLaneHandler(const util::NodeBasedDynamicGraph &node_based_graph,
+    TurnLaneHandler(const util::NodeBasedStaticGraph &node_based_graph,
                     LaneDescriptionMap &lane_description_map,
                     const TurnAnalysis &turn_analysis,
                     util::guidance::LaneDataIdMap &id_map);
@@ -87,7 +87,7 @@ class TurnLaneHandler
     mutable std::atomic<std::size_t> count_called;
     // we need to be able to look at previous intersections to, in some cases, find the correct turn
     // lanes for a turn
-    const util::NodeBasedDynamicGraph &node_based_graph;
+    const util::NodeBasedStaticGraph &node_based_graph;
     std::vector<std::uint32_t> turn_lane_offsets;
     std::vector<TurnLaneType::Mask> turn_lane_masks;
     LaneDescriptionMap &lane_description_map;
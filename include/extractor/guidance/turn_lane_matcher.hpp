@@ -42,7 +42,7 @@ bool canMatchTrivially(const Intersection &intersection, const LaneDataVector &l
 OSRM_ATTR_WARN_UNUSED
 Intersection triviallyMatchLanesToTurns(Intersection intersection,
                                         const LaneDataVector &lane_data,
-                                        const util::NodeBasedDynamicGraph &node_based_graph,
+                                        const util::NodeBasedStaticGraph &node_based_graph,
                                         const LaneDescriptionID lane_string_id,
                                         util::guidance::LaneDataIdMap &lane_data_to_id);
 
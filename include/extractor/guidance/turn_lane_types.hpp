@@ -9,9 +9,11 @@
 #include <unordered_map>
 #include <vector>
 
+#include <boost/assert.hpp>
 #include <boost/functional/hash.hpp>
 
 #include "util/concurrent_id_map.hpp"
+#include "util/integer_range.hpp"
 #include "util/json_container.hpp"
 #include "util/typedefs.hpp"
 
@@ -128,6 +130,23 @@ transformTurnLaneMapIntoArrays(const LaneDescriptionMap &turn_lane_map)
     return std::make_tuple(std::move(turn_lane_offsets), std::move(turn_lane_masks));
 }
 
+// Inverse of transformTurnLaneMapIntoArrays
+inline LaneDescriptionMap
+transformArraysIntoTurnLaneMap(const std::vector<std::uint32_t> &turn_lane_offsets,
+                               const std::vector<guidance::TurnLaneType::Mask> &turn_lane_masks)
+{
+    BOOST_ASSERT(turn_lane_offsets.size() >= 2);
+    LaneDescriptionMap turn_lane_map;
+    for (const auto id : util::irange<std::size_t>(0, turn_lane_offsets.size() - 2))
+    {
+        turn_lane_map.data[TurnLaneDescription(turn_lane_masks.begin() + turn_lane_offsets[id],
+                                               turn_lane_masks.begin() +
+                                                   turn_lane_offsets[id + 1])] =
+            static_cast<LaneDescriptionID>(id);
+    }
+    return turn_lane_map;
+}
+
 } // guidance
 } // extractor
 } // osrm
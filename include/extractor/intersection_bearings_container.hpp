@@ -4,9 +4,14 @@
 #include "storage/shared_memory_ownership.hpp"
 
 #include "util/guidance/bearing_class.hpp"
+#include "util/integer_range.hpp"
 #include "util/range_table.hpp"
 #include "util/vector_view.hpp"
 
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <numeric>
 
 namespace osrm
@@ -31,6 +36,9 @@ void write(storage::io::FileWriter &writer,
 
 namespace detail
 {
+// The bearing class ids of the nodes are stored in as few bytes as hold the ids of all classes
+// and the invalid id, which has all bits set. The ids of regional extracts fit into two or three
+// bytes instead of four. The number of bytes follows from the range table, so it isn't stored.
 template <storage::Ownership Ownership> class IntersectionBearingsContainer
 {
     template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
@@ -43,9 +51,8 @@ template <storage::Ownership Ownership> class IntersectionBearingsContainer
     IntersectionBearingsContainer &operator=(IntersectionBearingsContainer &&) = default;
     IntersectionBearingsContainer &operator=(const IntersectionBearingsContainer &) = default;
 
-    IntersectionBearingsContainer(std::vector<BearingClassID> node_to_class_id_,
+    IntersectionBearingsContainer(const std::vector<BearingClassID> &node_to_class_id_,
                                   const std::vector<util::guidance::BearingClass> &bearing_classes)
-        : node_to_class_id(std::move(node_to_class_id_))
     {
         std::vector<unsigned> bearing_counts(bearing_classes.size());
         std::transform(bearing_classes.begin(),
@@ -61,10 +68,19 @@ template <storage::Ownership Ownership> class IntersectionBearingsContainer
             const auto &bearings = bearing_class.getAvailableBearings();
             values.insert(values.end(), bearings.begin(), bearings.end());
         }
+
+        const auto id_bytes = GetClassIDBytes();
+        node_to_class_id.reserve(node_to_class_id_.size() * id_bytes);
+        for (const auto class_id : node_to_class_id_)
+        {
+            BOOST_ASSERT(class_id == INVALID_BEARING_CLASSID || class_id < bearing_classes.size());
+            for (const auto byte : util::irange<std::size_t>(0, id_bytes))
+                node_to_class_id.push_back(static_cast<std::uint8_t>(class_id >> (8 * byte)));
+        }
     }
 
     IntersectionBearingsContainer(Vector<DiscreteBearing> values_,
-                                  Vector<BearingClassID> node_to_class_id_,
+                                  Vector<std::uint8_t> node_to_class_id_,
                                   RangeTable<16> class_id_to_ranges_table_)
         : values(std::move(values_)), node_to_class_id(std::move(node_to_class_id_)),
           class_id_to_ranges_table(std::move(class_id_to_ranges_table_))
@@ -74,7 +90,7 @@ template <storage::Ownership Ownership> class IntersectionBearingsContainer
     // Returns the bearing class for an intersection node
     util::guidance::BearingClass GetBearingClass(const NodeID node) const
     {
-        auto class_id = node_to_class_id[node];
+        auto class_id = GetClassID(node);
         auto range = class_id_to_ranges_table.GetRange(class_id);
         util::guidance::BearingClass result;
         std::for_each(values.begin() + range.front(),
@@ -90,8 +106,30 @@ template <storage::Ownership Ownership> class IntersectionBearingsContainer
                                     const IntersectionBearingsContainer &turn_data_container);
 
   private:
+    // Bytes per class id for all classes the range table can hold
+    std::size_t GetClassIDBytes() const
+    {
+        const auto max_classes = class_id_to_ranges_table.GetMaxNumberOfRanges();
+        std::size_t bytes = 1;
+        while (bytes < sizeof(BearingClassID) && max_classes >= (std::uint64_t{1} << (8 * bytes)))
+            ++bytes;
+        return bytes;
+    }
+
+    BearingClassID GetClassID(const NodeID node) const
+    {
+        const auto id_bytes = GetClassIDBytes();
+        BearingClassID class_id = 0;
+        for (const auto byte : util::irange<std::size_t>(0, id_bytes))
+            class_id |= BearingClassID{node_to_class_id[node * id_bytes + byte]} << (8 * byte);
+
+        const auto invalid_id =
+            static_cast<BearingClassID>((std::uint64_t{1} << (8 * id_bytes)) - 1);
+        return class_id == invalid_id ? INVALID_BEARING_CLASSID : class_id;
+    }
+
     Vector<DiscreteBearing> values;
-    Vector<BearingClassID> node_to_class_id;
+    Vector<std::uint8_t> node_to_class_id;
     RangeTable<16> class_id_to_ranges_table;
 };
 }
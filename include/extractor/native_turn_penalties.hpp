@@ -0,0 +1,45 @@
+#ifndef NATIVE_TURN_PENALTIES_HPP
+#define NATIVE_TURN_PENALTIES_HPP
+
+#include "extractor/extraction_turn.hpp"
+#include "extractor/profile_properties.hpp"
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * The turn penalties of the turn_function of the car profile, computed without calling into Lua.
+ *
+ * A turn that is not a NoTurn gets a sigmoid penalty of the turn angle that maxes out at the
+ * turn penalty and is biased by the turn bias, u-turns get the u-turn penalty on top. Traffic
+ * lights add their penalty to every turn. The weight is the duration, zero for distance weights
+ * and the maximal turn weight for a turn onto restricted roads for routability weights.
+ *
+ * The parameters are taken from `native_turn_penalties` of the profile.
+ */
+class NativeTurnPenalties
+{
+  public:
+    NativeTurnPenalties(double turn_penalty,
+                        double turn_bias,
+                        double traffic_light_penalty,
+                        double u_turn_penalty,
+                        const ProfileProperties &properties);
+
+    void Apply(ExtractionTurn &turn) const;
+
+  private:
+    double turn_penalty;
+    double turn_bias;
+    double traffic_light_penalty;
+    double u_turn_penalty;
+    double max_turn_weight;
+    bool distance_weight;
+    bool routability_weight;
+};
+}
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef NATIVE_WAY_RULES_HPP
+#define NATIVE_WAY_RULES_HPP
+
+#include <string>
+#include <vector>
+
+namespace osmium
+{
+class TagList;
+}
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Table driven rules of a profile that are evaluated without calling into Lua.
+ *
+ * The rules only decide that a way is not routable, every other way is passed on to the
+ * way function of the profile. A way is rejected if
+ *  - it has no value for any of the required keys,
+ *  - it has one of the blocked tags,
+ *  - the forward and the backward access tags (the first of key:forward or key, and of
+ *    key:backward or key in the order of the access keys) are both blacklisted and not only
+ *    restricted on a restricted highway,
+ *  - it has neither a tag with a speed nor an access tag.
+ *
+ * The tables are filled from `native_way_rules` of the profile, see profiles/lib/native_rules.lua.
+ * Like get_value_by_key of the profiles, empty values are treated as missing.
+ */
+class NativeWayRules
+{
+  public:
+    bool Empty() const { return required_keys.empty(); }
+
+    void AddRequiredKey(std::string key);
+    void AddBlockedTag(std::string key, std::string value);
+    void AddSpeedTag(std::string key, std::string value);
+    void AddAccessKey(std::string key);
+    void AddBlacklistedAccess(std::string value);
+    void AddRestrictedAccess(std::string value);
+    void AddRestrictedHighway(std::string value);
+
+    // True if the way can not be routed on with the profile the rules are taken from
+    bool Rejects(const osmium::TagList &tags) const;
+
+  private:
+    struct KeyValue
+    {
+        std::string key;
+        std::string value;
+    };
+
+    bool IsRestricted(const char *highway, const char *access) const;
+
+    std::vector<std::string> required_keys;
+    std::vector<KeyValue> blocked_tags;
+    std::vector<KeyValue> speed_tags;
+    // access keys followed by their :forward and :backward variants
+    std::vector<std::string> access_keys;
+    // sorted for lookups with the values of the way
+    std::vector<std::string> blacklisted_access;
+    std::vector<std::string> restricted_access;
+    std::vector<std::string> restricted_highways;
+};
+}
+}
+
+#endif
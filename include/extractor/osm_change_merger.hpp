@@ -0,0 +1,58 @@
+#ifndef OSM_CHANGE_MERGER_HPP
+#define OSM_CHANGE_MERGER_HPP
+
+#include <osmium/memory/buffer.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace osmium
+{
+class OSMObject;
+}
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Applies OSM change files (.osc) to the input of the extractor while it is read.
+ *
+ * The changes are kept in memory, sorted and reduced to the newest version of every object. The
+ * buffers of the input, which has to be sorted by type and id like the planet files and extracts
+ * are, are merged with them: changed objects replace the ones of the input, deleted objects are
+ * dropped and created objects are inserted at their position. This applies the minutely or daily
+ * diffs of a planet without writing an updated copy of it first.
+ */
+class OSMChangeMerger
+{
+  public:
+    explicit OSMChangeMerger(osmium::memory::Buffer changes);
+
+    // Reads the change files in the order they have to be applied in
+    static osmium::memory::Buffer ReadChanges(const std::vector<boost::filesystem::path> &paths);
+
+    // Merges the changes up to the last object of the buffer into it, a buffer without changes
+    // in its range is returned as it is
+    osmium::memory::Buffer Merge(osmium::memory::Buffer input);
+
+    // Objects created after the last object of the input
+    osmium::memory::Buffer Finish();
+
+    std::size_t GetNumberOfChanges() const { return changes.size(); }
+
+  private:
+    void CopyChangesBefore(osmium::memory::Buffer &output, const osmium::OSMObject *object);
+
+    osmium::memory::Buffer buffer;
+    // newest version of every changed object in input order
+    std::vector<const osmium::OSMObject *> changes;
+    std::size_t next_change = 0;
+};
+}
+}
+
+#endif
@@ -0,0 +1,577 @@
+#ifndef PARALLEL_SCC_HPP
+#define PARALLEL_SCC_HPP
+
+#include "extractor/tarjan_scc.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Computes the strongly connected components of a graph in parallel, with the interface of
+ * TarjanSCC.
+ *
+ * Follows the multistep approach of Slota et al.: nodes without incoming or outgoing edges are
+ * trimmed as components of their own first, then the giant component is found by a forward and a
+ * backward search from the node with the largest degrees. The remaining nodes are split up by
+ * coloring: the largest node id is propagated along the edges until nothing changes, every node
+ * that kept its own id is the root of a component made of the nodes of its color that reach it. As
+ * soon as coloring stops making progress the rest of the graph is handed to TarjanSCC.
+ *
+ * The components are numbered in the order of their smallest node, so the result does not depend
+ * on the number of threads.
+ */
+template <typename GraphT> class ParallelSCC
+{
+    // A compact adjacency array, used for the reversed graph and the subgraph left to TarjanSCC
+    struct AdjacencyArray
+    {
+        NodeID GetNumberOfNodes() const { return static_cast<NodeID>(offsets.size() - 1); }
+
+        util::range<EdgeID> GetAdjacentEdgeRange(const NodeID node) const
+        {
+            return util::irange(offsets[node], offsets[node + 1]);
+        }
+
+        NodeID GetTarget(const EdgeID edge) const { return targets[edge]; }
+
+        std::vector<EdgeID> offsets;
+        std::vector<NodeID> targets;
+    };
+
+    using NodeBuffer = tbb::enumerable_thread_specific<std::vector<NodeID>>;
+
+    static constexpr std::uint8_t FORWARD_REACHED = 1;
+    static constexpr std::uint8_t BACKWARD_REACHED = 2;
+    // below this number of nodes TarjanSCC is faster than another round of coloring
+    static constexpr std::size_t SERIAL_THRESHOLD = 100000;
+    // coloring stops if a round assigns less than this fraction of the remaining nodes
+    static constexpr std::size_t MIN_COLORING_PROGRESS = 100;
+    // colors that are propagated along long paths update the same nodes over and over again, a
+    // round is given up once it has visited this many times the remaining nodes
+    static constexpr std::size_t MAX_COLORING_VISITS = 16;
+
+    std::vector<unsigned> components_index;
+    std::vector<NodeID> component_size_vector;
+    const GraphT &m_graph;
+    std::size_t size_one_counter;
+
+    // Representative node of the component of every node while the phases run, SPECIAL_NODEID
+    // for the nodes that are not assigned yet. Every phase only writes the nodes it assigns.
+    std::vector<NodeID> labels;
+    AdjacencyArray reverse_graph;
+
+  public:
+    ParallelSCC(const GraphT &graph)
+        : components_index(graph.GetNumberOfNodes(), SPECIAL_NODEID), m_graph(graph),
+          size_one_counter(0)
+    {
+        BOOST_ASSERT(m_graph.GetNumberOfNodes() > 0);
+    }
+
+    void Run()
+    {
+        TIMER_START(SCC_RUN);
+        const NodeID number_of_nodes = m_graph.GetNumberOfNodes();
+
+        labels.assign(number_of_nodes, SPECIAL_NODEID);
+        BuildReverseGraph();
+
+        std::size_t remaining = number_of_nodes;
+        const auto trimmed = Trim();
+        remaining -= trimmed;
+
+        const auto giant_component_size = remaining > 0 ? ForwardBackward() : 0;
+        remaining -= giant_component_size;
+
+        std::size_t coloring_rounds = 0;
+        while (remaining > SERIAL_THRESHOLD)
+        {
+            const auto colored = Color();
+            ++coloring_rounds;
+            const bool enough_progress = colored * MIN_COLORING_PROGRESS >= remaining;
+            remaining -= colored;
+            if (!enough_progress)
+                break;
+        }
+
+        util::Log(logDEBUG) << "SCC: trimmed " << trimmed << " nodes, giant component of "
+                            << giant_component_size << " nodes, " << coloring_rounds
+                            << " coloring rounds, " << remaining << " nodes left to TarjanSCC";
+
+        if (remaining > 0)
+            RunTarjanOnRemainingNodes();
+
+        reverse_graph = AdjacencyArray{};
+        NumberComponents();
+        labels.clear();
+        labels.shrink_to_fit();
+
+        const auto large_component_count =
+            std::count_if(component_size_vector.begin(),
+                          component_size_vector.end(),
+                          [](const NodeID size) { return size > 1000; });
+
+        TIMER_STOP(SCC_RUN);
+        util::Log() << "Found " << component_size_vector.size() << " SCC ("
+                    << large_component_count << " large, "
+                    << (component_size_vector.size() - large_component_count) << " small)";
+        util::Log() << "SCC run took: " << TIMER_MSEC(SCC_RUN) / 1000. << "s";
+
+        size_one_counter = std::count_if(component_size_vector.begin(),
+                                         component_size_vector.end(),
+                                         [](unsigned value) { return 1 == value; });
+    }
+
+    std::size_t GetNumberOfComponents() const { return component_size_vector.size(); }
+
+    std::size_t GetSizeOneCount() const { return size_one_counter; }
+
+    unsigned GetComponentSize(const unsigned component_id) const
+    {
+        return component_size_vector[component_id];
+    }
+
+    unsigned GetComponentID(const NodeID node) const { return components_index[node]; }
+
+  private:
+    static std::vector<NodeID> Flatten(NodeBuffer &buffer)
+    {
+        std::vector<NodeID> nodes;
+        for (auto &local : buffer)
+        {
+            nodes.insert(nodes.end(), local.begin(), local.end());
+        }
+        return nodes;
+    }
+
+    bool IsAssigned(const NodeID node) const { return labels[node] != SPECIAL_NODEID; }
+
+    void BuildReverseGraph()
+    {
+        const NodeID number_of_nodes = m_graph.GetNumberOfNodes();
+
+        std::vector<std::atomic<EdgeID>> in_degrees(number_of_nodes);
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                          [&](const tbb::blocked_range<NodeID> &range) {
+                              for (auto node = range.begin(); node != range.end(); ++node)
+                                  for (const auto edge : m_graph.GetAdjacentEdgeRange(node))
+                                      in_degrees[m_graph.GetTarget(edge)].fetch_add(
+                                          1, std::memory_order_relaxed);
+                          });
+
+        reverse_graph.offsets.resize(number_of_nodes + 1);
+        reverse_graph.offsets[0] = 0;
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            reverse_graph.offsets[node + 1] = reverse_graph.offsets[node] + in_degrees[node];
+        }
+        reverse_graph.targets.resize(reverse_graph.offsets.back());
+
+        // the in degrees are reused as insert positions
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                          [&](const tbb::blocked_range<NodeID> &range) {
+                              for (auto node = range.begin(); node != range.end(); ++node)
+                                  in_degrees[node].store(reverse_graph.offsets[node],
+                                                         std::memory_order_relaxed);
+                          });
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                          [&](const tbb::blocked_range<NodeID> &range) {
+                              for (auto node = range.begin(); node != range.end(); ++node)
+                                  for (const auto edge : m_graph.GetAdjacentEdgeRange(node))
+                                  {
+                                      const auto target = m_graph.GetTarget(edge);
+                                      const auto position = in_degrees[target].fetch_add(
+                                          1, std::memory_order_relaxed);
+                                      reverse_graph.targets[position] = node;
+                                  }
+                          });
+    }
+
+    // Nodes without an incoming or outgoing edge from another node are components of their own.
+    // Removing them can leave their neighbours without edges, so they are trimmed as well.
+    std::size_t Trim()
+    {
+        const NodeID number_of_nodes = m_graph.GetNumberOfNodes();
+
+        std::vector<std::atomic<EdgeID>> in_degrees(number_of_nodes);
+        std::vector<std::atomic<EdgeID>> out_degrees(number_of_nodes);
+        std::vector<std::atomic<bool>> trimmed(number_of_nodes);
+
+        NodeBuffer next_buffer;
+        tbb::parallel_for(
+            tbb::blocked_range<NodeID>(0, number_of_nodes),
+            [&](const tbb::blocked_range<NodeID> &range) {
+                auto &next = next_buffer.local();
+                for (auto node = range.begin(); node != range.end(); ++node)
+                {
+                    EdgeID out_degree = 0;
+                    for (const auto edge : m_graph.GetAdjacentEdgeRange(node))
+                        out_degree += m_graph.GetTarget(edge) != node;
+                    EdgeID in_degree = 0;
+                    for (const auto edge : reverse_graph.GetAdjacentEdgeRange(node))
+                        in_degree += reverse_graph.GetTarget(edge) != node;
+
+                    in_degrees[node].store(in_degree, std::memory_order_relaxed);
+                    out_degrees[node].store(out_degree, std::memory_order_relaxed);
+                    const bool trim = in_degree == 0 || out_degree == 0;
+                    trimmed[node].store(trim, std::memory_order_relaxed);
+                    if (trim)
+                        next.push_back(node);
+                }
+            });
+
+        // a degree can only drop to zero once, the flag stops nodes with both degrees dropping
+        // to zero from being queued twice
+        const auto decrement = [&](std::atomic<EdgeID> &degree,
+                                   const NodeID node,
+                                   std::vector<NodeID> &next) {
+            if (degree.fetch_sub(1, std::memory_order_relaxed) == 1 &&
+                !trimmed[node].exchange(true, std::memory_order_relaxed))
+                next.push_back(node);
+        };
+
+        std::size_t number_of_trimmed = 0;
+        auto frontier = Flatten(next_buffer);
+        while (!frontier.empty())
+        {
+            number_of_trimmed += frontier.size();
+            next_buffer.clear();
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  auto &next = next_buffer.local();
+                                  for (auto index = range.begin(); index != range.end(); ++index)
+                                  {
+                                      const auto node = frontier[index];
+                                      labels[node] = node;
+                                      for (const auto edge : m_graph.GetAdjacentEdgeRange(node))
+                                      {
+                                          const auto target = m_graph.GetTarget(edge);
+                                          if (target != node)
+                                              decrement(in_degrees[target], target, next);
+                                      }
+                                      for (const auto edge :
+                                           reverse_graph.GetAdjacentEdgeRange(node))
+                                      {
+                                          const auto source = reverse_graph.GetTarget(edge);
+                                          if (source != node)
+                                              decrement(out_degrees[source], source, next);
+                                      }
+                                  }
+                              });
+            frontier = Flatten(next_buffer);
+        }
+
+        return number_of_trimmed;
+    }
+
+    // Level synchronous breadth first search that sets the flag on all nodes it reaches
+    template <typename SearchGraphT, typename FilterT>
+    static void Search(const SearchGraphT &graph,
+                       const NodeID source,
+                       const std::uint8_t flag,
+                       std::vector<std::atomic<std::uint8_t>> &reached,
+                       const FilterT &filter)
+    {
+        reached[source].fetch_or(flag, std::memory_order_relaxed);
+        std::vector<NodeID> frontier{source};
+        NodeBuffer next_buffer;
+        while (!frontier.empty())
+        {
+            next_buffer.clear();
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, frontier.size()),
+                [&](const tbb::blocked_range<std::size_t> &range) {
+                    auto &next = next_buffer.local();
+                    for (auto index = range.begin(); index != range.end(); ++index)
+                    {
+                        for (const auto edge : graph.GetAdjacentEdgeRange(frontier[index]))
+                        {
+                            const auto target = graph.GetTarget(edge);
+                            if ((reached[target].load(std::memory_order_relaxed) & flag) == 0 &&
+                                filter(target) &&
+                                (reached[target].fetch_or(flag, std::memory_order_relaxed) &
+                                 flag) == 0)
+                                next.push_back(target);
+                        }
+                    }
+                });
+            frontier = Flatten(next_buffer);
+        }
+    }
+
+    // The component of the node with the largest degrees is the nodes reached by both a forward
+    // and a backward search from it. On road networks this is most of the graph.
+    std::size_t ForwardBackward()
+    {
+        const NodeID number_of_nodes = m_graph.GetNumberOfNodes();
+
+        using Candidate = std::pair<std::uint64_t, NodeID>;
+        const auto pivot = tbb::parallel_reduce(
+            tbb::blocked_range<NodeID>(0, number_of_nodes),
+            Candidate{0, SPECIAL_NODEID},
+            [&](const tbb::blocked_range<NodeID> &range, Candidate best) {
+                for (auto node = range.begin(); node != range.end(); ++node)
+                {
+                    if (IsAssigned(node))
+                        continue;
+                    const std::uint64_t degrees =
+                        static_cast<std::uint64_t>(m_graph.GetAdjacentEdgeRange(node).size()) *
+                        reverse_graph.GetAdjacentEdgeRange(node).size();
+                    // ties go to the smallest node id
+                    if (best.second == SPECIAL_NODEID || degrees > best.first ||
+                        (degrees == best.first && node < best.second))
+                        best = {degrees, node};
+                }
+                return best;
+            },
+            [](const Candidate &lhs, const Candidate &rhs) {
+                if (lhs.second == SPECIAL_NODEID)
+                    return rhs;
+                if (rhs.second == SPECIAL_NODEID)
+                    return lhs;
+                return (lhs.first > rhs.first ||
+                        (lhs.first == rhs.first && lhs.second < rhs.second))
+                           ? lhs
+                           : rhs;
+            }).second;
+        BOOST_ASSERT(pivot != SPECIAL_NODEID);
+
+        std::vector<std::atomic<std::uint8_t>> reached(number_of_nodes);
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                          [&](const tbb::blocked_range<NodeID> &range) {
+                              for (auto node = range.begin(); node != range.end(); ++node)
+                                  reached[node].store(0, std::memory_order_relaxed);
+                          });
+
+        Search(m_graph, pivot, FORWARD_REACHED, reached, [&](const NodeID node) {
+            return !IsAssigned(node);
+        });
+        Search(reverse_graph, pivot, BACKWARD_REACHED, reached, [&](const NodeID node) {
+            return (reached[node].load(std::memory_order_relaxed) & FORWARD_REACHED) != 0;
+        });
+
+        return tbb::parallel_reduce(
+            tbb::blocked_range<NodeID>(0, number_of_nodes),
+            std::size_t{0},
+            [&](const tbb::blocked_range<NodeID> &range, std::size_t count) {
+                for (auto node = range.begin(); node != range.end(); ++node)
+                {
+                    if (reached[node].load(std::memory_order_relaxed) ==
+                        (FORWARD_REACHED | BACKWARD_REACHED))
+                    {
+                        labels[node] = pivot;
+                        ++count;
+                    }
+                }
+                return count;
+            },
+            std::plus<std::size_t>());
+    }
+
+    // One round of coloring: the largest node id that reaches a node becomes its color. The nodes
+    // that keep their own id are roots, the nodes of their color that reach them form their
+    // component. Every finished round assigns at least the component of the largest remaining
+    // node, a round that is given up assigns none.
+    std::size_t Color()
+    {
+        const NodeID number_of_nodes = m_graph.GetNumberOfNodes();
+
+        // assigned nodes keep SPECIAL_NODEID, which no color is larger than
+        std::vector<std::atomic<NodeID>> colors(number_of_nodes);
+        std::vector<std::atomic<bool>> queued(number_of_nodes);
+        NodeBuffer next_buffer;
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                          [&](const tbb::blocked_range<NodeID> &range) {
+                              auto &next = next_buffer.local();
+                              for (auto node = range.begin(); node != range.end(); ++node)
+                              {
+                                  const bool assigned = IsAssigned(node);
+                                  colors[node].store(assigned ? SPECIAL_NODEID : node,
+                                                     std::memory_order_relaxed);
+                                  queued[node].store(false, std::memory_order_relaxed);
+                                  if (!assigned)
+                                      next.push_back(node);
+                              }
+                          });
+
+        auto frontier = Flatten(next_buffer);
+        const auto max_visits = MAX_COLORING_VISITS * frontier.size();
+        std::size_t visits = 0;
+        while (!frontier.empty())
+        {
+            visits += frontier.size();
+            if (visits > max_visits)
+                return 0;
+
+            next_buffer.clear();
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  for (auto index = range.begin(); index != range.end(); ++index)
+                                      queued[frontier[index]].store(false,
+                                                                    std::memory_order_relaxed);
+                              });
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, frontier.size()),
+                [&](const tbb::blocked_range<std::size_t> &range) {
+                    auto &next = next_buffer.local();
+                    for (auto index = range.begin(); index != range.end(); ++index)
+                    {
+                        const auto node = frontier[index];
+                        const auto color = colors[node].load(std::memory_order_relaxed);
+                        for (const auto edge : m_graph.GetAdjacentEdgeRange(node))
+                        {
+                            const auto target = m_graph.GetTarget(edge);
+                            auto target_color = colors[target].load(std::memory_order_relaxed);
+                            while (target_color < color)
+                            {
+                                if (colors[target].compare_exchange_weak(
+                                        target_color, color, std::memory_order_relaxed))
+                                {
+                                    if (!queued[target].exchange(true, std::memory_order_relaxed))
+                                        next.push_back(target);
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                });
+            frontier = Flatten(next_buffer);
+        }
+
+        NodeBuffer roots_buffer;
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                          [&](const tbb::blocked_range<NodeID> &range) {
+                              auto &roots = roots_buffer.local();
+                              for (auto node = range.begin(); node != range.end(); ++node)
+                                  if (colors[node].load(std::memory_order_relaxed) == node)
+                                      roots.push_back(node);
+                          });
+        const auto roots = Flatten(roots_buffer);
+
+        // only the search of a root touches the nodes of its color
+        return tbb::parallel_reduce(
+            tbb::blocked_range<std::size_t>(0, roots.size()),
+            std::size_t{0},
+            [&](const tbb::blocked_range<std::size_t> &range, std::size_t count) {
+                std::vector<NodeID> stack;
+                for (auto index = range.begin(); index != range.end(); ++index)
+                {
+                    const auto root = roots[index];
+                    labels[root] = root;
+                    ++count;
+                    stack.push_back(root);
+                    while (!stack.empty())
+                    {
+                        const auto node = stack.back();
+                        stack.pop_back();
+                        for (const auto edge : reverse_graph.GetAdjacentEdgeRange(node))
+                        {
+                            const auto source = reverse_graph.GetTarget(edge);
+                            if (colors[source].load(std::memory_order_relaxed) == root &&
+                                !IsAssigned(source))
+                            {
+                                labels[source] = root;
+                                ++count;
+                                stack.push_back(source);
+                            }
+                        }
+                    }
+                }
+                return count;
+            },
+            std::plus<std::size_t>());
+    }
+
+    void RunTarjanOnRemainingNodes()
+    {
+        const NodeID number_of_nodes = m_graph.GetNumberOfNodes();
+
+        std::vector<NodeID> original_ids;
+        std::vector<NodeID> subgraph_ids(number_of_nodes, SPECIAL_NODEID);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (!IsAssigned(node))
+            {
+                subgraph_ids[node] = static_cast<NodeID>(original_ids.size());
+                original_ids.push_back(node);
+            }
+        }
+
+        AdjacencyArray subgraph;
+        subgraph.offsets.reserve(original_ids.size() + 1);
+        subgraph.offsets.push_back(0);
+        for (const auto node : original_ids)
+        {
+            for (const auto edge : m_graph.GetAdjacentEdgeRange(node))
+            {
+                const auto target = subgraph_ids[m_graph.GetTarget(edge)];
+                if (target != SPECIAL_NODEID)
+                    subgraph.targets.push_back(target);
+            }
+            subgraph.offsets.push_back(static_cast<EdgeID>(subgraph.targets.size()));
+        }
+
+        TarjanSCC<AdjacencyArray> tarjan(subgraph);
+        tarjan.Run();
+
+        std::vector<NodeID> representatives(tarjan.GetNumberOfComponents(), SPECIAL_NODEID);
+        for (const auto subgraph_id : util::irange<NodeID>(0, subgraph.GetNumberOfNodes()))
+        {
+            auto &representative = representatives[tarjan.GetComponentID(subgraph_id)];
+            if (representative == SPECIAL_NODEID)
+                representative = original_ids[subgraph_id];
+            labels[original_ids[subgraph_id]] = representative;
+        }
+    }
+
+    // Turns the representatives into component ids ordered by the smallest node of a component
+    void NumberComponents()
+    {
+        const NodeID number_of_nodes = m_graph.GetNumberOfNodes();
+
+        std::vector<unsigned> component_by_representative(number_of_nodes, SPECIAL_NODEID);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            BOOST_ASSERT(IsAssigned(node));
+            auto &component = component_by_representative[labels[node]];
+            if (component == SPECIAL_NODEID)
+            {
+                component = static_cast<unsigned>(component_size_vector.size());
+                component_size_vector.push_back(0);
+            }
+            components_index[node] = component;
+            ++component_size_vector[component];
+        }
+    }
+};
+
+template <typename GraphT> constexpr std::uint8_t ParallelSCC<GraphT>::FORWARD_REACHED;
+template <typename GraphT> constexpr std::uint8_t ParallelSCC<GraphT>::BACKWARD_REACHED;
+template <typename GraphT> constexpr std::size_t ParallelSCC<GraphT>::SERIAL_THRESHOLD;
+template <typename GraphT> constexpr std::size_t ParallelSCC<GraphT>::MIN_COLORING_PROGRESS;
+template <typename GraphT> constexpr std::size_t ParallelSCC<GraphT>::MAX_COLORING_VISITS;
+}
+}
+
+#endif /* PARALLEL_SCC_HPP */
@@ -6,6 +6,7 @@
 #include "util/typedefs.hpp"
 
 #include <algorithm>
+#include <array>
 #include <boost/assert.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 #include <cstdint>
@@ -111,6 +112,8 @@ struct ProfileProperties
     unsigned weight_precision = 1;
     bool force_split_edges = false;
     bool call_tagless_node_function = true;
+    //! extracted with osrm-extract --routing-only, the dataset contains no guidance data
+    bool routing_only = false;
 };
 }
 }
@@ -3,6 +3,7 @@
 
 #include "util/coordinate.hpp"
 #include "util/exception.hpp"
+#include "util/lru_cache.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/assert.hpp>
@@ -12,7 +13,10 @@
 #include <boost/spirit/include/qi_int.hpp>
 #include <storage/io.hpp>
 
+#include <cstdint>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace osrm
@@ -38,6 +42,8 @@ struct RasterDatum
 class RasterGrid
 {
   public:
+    RasterGrid() : xdim(0), ydim(0) {}
+
     RasterGrid(const boost::filesystem::path &filepath, std::size_t _xdim, std::size_t _ydim)
     {
         xdim = _xdim;
@@ -86,11 +92,68 @@ class RasterGrid
     std::int32_t operator()(std::size_t x, std::size_t y) { return _data[y * xdim + x]; }
     std::int32_t operator()(std::size_t x, std::size_t y) const { return _data[(y)*xdim + (x)]; }
 
+    std::size_t GetWidth() const { return xdim; }
+    std::size_t GetHeight() const { return ydim; }
+    std::size_t GetSize() const { return _data.size(); }
+
   private:
     std::vector<std::int32_t> _data;
     std::size_t xdim, ydim;
 };
 
+/**
+    \brief Raster grid split into square tiles that are read from disk when they are first queried.
+
+    The file starts with a fingerprint and a TiledRasterGrid::Header, followed by the tiles in row
+    major order, every tile in row major order as well. Tiles at the right and bottom border are
+    padded to the full tile size. The tiles are kept in a least recently used cache, so only the
+    tiles around the queried coordinates are in memory.
+*/
+class TiledRasterGrid
+{
+  public:
+    struct Header
+    {
+        std::uint64_t width;
+        std::uint64_t height;
+        std::uint64_t tile_size;
+    };
+
+    static constexpr std::size_t DEFAULT_TILE_SIZE = 256;
+    // 256 MiB with the default tile size
+    static constexpr std::size_t DEFAULT_CACHE_SIZE = 1024;
+
+    // Writes the grid as tiled raster file
+    static void Write(const boost::filesystem::path &filepath,
+                      const RasterGrid &grid,
+                      std::size_t tile_size = DEFAULT_TILE_SIZE);
+
+    explicit TiledRasterGrid(const boost::filesystem::path &filepath,
+                             std::size_t cache_size = DEFAULT_CACHE_SIZE);
+
+    std::int32_t operator()(std::size_t x, std::size_t y) const;
+
+    std::size_t GetWidth() const { return header.width; }
+    std::size_t GetHeight() const { return header.height; }
+
+    std::uint64_t GetCacheHits() const { return tiles.Hits(); }
+    std::uint64_t GetCacheMisses() const { return tiles.Misses(); }
+
+  private:
+    using Tile = std::vector<std::int32_t>;
+
+    std::shared_ptr<const Tile> GetTile(std::size_t tile_x, std::size_t tile_y) const;
+
+    const boost::filesystem::path filepath;
+    Header header;
+    std::size_t tiles_per_row;
+
+    // reads of tiles that are not cached yet
+    mutable std::mutex file_mutex;
+    mutable boost::filesystem::ifstream file;
+    mutable util::ShardedLRUCache<std::size_t, std::shared_ptr<const Tile>> tiles;
+};
+
 /**
     \brief Stores raster source data in memory and provides lookup functions.
 */
@@ -102,8 +165,15 @@ class RasterSource
 
     float CalcSize(int min, int max, std::size_t count) const;
 
+    std::int32_t GetValue(std::size_t x, std::size_t y) const
+    {
+        return tiled_data ? (*tiled_data)(x, y) : raster_data(x, y);
+    }
+
   public:
     RasterGrid raster_data;
+    // tiled sources are shared by all scripting contexts, raster_data is empty for them
+    std::shared_ptr<const TiledRasterGrid> tiled_data;
 
     const std::size_t width;
     const std::size_t height;
@@ -123,6 +193,12 @@ class RasterSource
                  int _xmax,
                  int _ymin,
                  int _ymax);
+
+    RasterSource(std::shared_ptr<const TiledRasterGrid> _tiled_data,
+                 int _xmin,
+                 int _xmax,
+                 int _ymin,
+                 int _ymax);
 };
 
 class SourceContainer
@@ -138,11 +214,18 @@ class SourceContainer
                          std::size_t nrows,
                          std::size_t ncols);
 
+    // Loads a tiled raster file written by osrm-raster-tiles, its tiles are read on demand
+    int LoadTiledRasterSource(
+        const std::string &path_string, double xmin, double xmax, double ymin, double ymax);
+
     RasterDatum GetRasterDataFromSource(unsigned int source_id, double lon, double lat);
 
     RasterDatum GetRasterInterpolateFromSource(unsigned int source_id, double lon, double lat);
 
   private:
+    // The tiled grid of the file, opened once per process
+    static std::shared_ptr<const TiledRasterGrid> OpenTiledRasterGrid(const std::string &path);
+
     std::vector<RasterSource> LoadedSources;
     std::unordered_map<std::string, int> LoadedSourcePaths;
 };
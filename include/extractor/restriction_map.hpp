@@ -8,7 +8,9 @@
 
 #include <boost/assert.hpp>
 
+#include <cstdint>
 #include <memory>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -29,6 +31,11 @@ struct RestrictionSource
     {
         return (lhs.start_node == rhs.start_node && lhs.via_node == rhs.via_node);
     }
+
+    friend inline bool operator<(const RestrictionSource &lhs, const RestrictionSource &rhs)
+    {
+        return std::tie(lhs.start_node, lhs.via_node) < std::tie(rhs.start_node, rhs.via_node);
+    }
 };
 
 struct RestrictionTarget
@@ -72,11 +79,16 @@ namespace extractor
 /**
     \brief Efficent look up if an edge is the start + via node of a TurnRestriction
     EdgeBasedEdgeFactory decides by it if edges are inserted or geometry is compressed
+
+    While the graph is compressed the restrictions are held in hash tables that allow to move
+    their start and end nodes. Compact() replaces them with bit vectors of the via and start
+    nodes and an array of the restriction targets sorted by (start, via), which are probed for
+    every turn of the edge-expanded graph.
 */
 class RestrictionMap
 {
   public:
-    RestrictionMap() : m_count(0) {}
+    RestrictionMap() : m_count(0), m_compacted(false) {}
     RestrictionMap(const std::vector<TurnRestriction> &restriction_list);
 
     // Replace end v with w in each turn restriction containing u as via node
@@ -89,6 +101,7 @@ class RestrictionMap
         BOOST_ASSERT(node_u != SPECIAL_NODEID);
         BOOST_ASSERT(node_v != SPECIAL_NODEID);
         BOOST_ASSERT(node_w != SPECIAL_NODEID);
+        BOOST_ASSERT(!m_compacted);
 
         if (!IsViaNode(node_u))
         {
@@ -130,6 +143,9 @@ class RestrictionMap
 
     bool IsViaNode(const NodeID node) const;
 
+    // check of node is the start of any restriction
+    bool IsSourceNode(const NodeID node) const;
+
     // Replaces start edge (v, w) with (u, w). Only start node changes.
     void
     FixupStartingTurnRestriction(const NodeID node_u, const NodeID node_v, const NodeID node_w);
@@ -143,13 +159,34 @@ class RestrictionMap
 
     std::size_t size() const { return m_count; }
 
-  private:
-    // check of node is the start of any restriction
-    bool IsSourceNode(const NodeID node) const;
+    // Builds the sorted index and frees the hash tables, the restrictions can not be changed
+    // afterwards
+    void Compact();
 
+  private:
     using EmanatingRestrictionsVector = std::vector<RestrictionTarget>;
 
+    struct TargetRange
+    {
+        const RestrictionTarget *begin() const { return first; }
+        const RestrictionTarget *end() const { return last; }
+
+        const RestrictionTarget *first;
+        const RestrictionTarget *last;
+    };
+
+    // targets of all restrictions starting with the edge (u, v)
+    TargetRange GetTargets(const NodeID node_u, const NodeID node_v) const;
+
     std::size_t m_count;
+    bool m_compacted;
+    //! sorted (start, via) of all restrictions and their targets at the offsets of m_targets
+    std::vector<RestrictionSource> m_sources;
+    std::vector<std::uint32_t> m_target_offsets;
+    std::vector<RestrictionTarget> m_targets;
+    std::vector<bool> m_is_start_node;
+    std::vector<bool> m_is_via_node;
+
     //! index -> list of (target, isOnly)
     std::vector<EmanatingRestrictionsVector> m_restriction_bucket_list;
     //! maps (start, via) -> bucket index
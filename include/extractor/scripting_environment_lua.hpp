@@ -1,14 +1,20 @@
 #ifndef SCRIPTING_ENVIRONMENT_LUA_HPP
 #define SCRIPTING_ENVIRONMENT_LUA_HPP
 
+#include "extractor/extraction_way.hpp"
+#include "extractor/native_turn_penalties.hpp"
+#include "extractor/native_way_rules.hpp"
 #include "extractor/raster_source.hpp"
 #include "extractor/scripting_environment.hpp"
+#include "extractor/way_memo_cache.hpp"
 
 #include <tbb/enumerable_thread_specific.h>
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <sol2/sol.hpp>
 
@@ -17,22 +23,64 @@ namespace osrm
 namespace extractor
 {
 
+/**
+ * The ways of a buffer that are passed to the process_ways function of a profile at once.
+ *
+ * The tags of all ways are stored as contiguous arrays of C strings, the tags of the way with
+ * index i are at tag_offsets[i] to tag_offsets[i + 1] of keys and values. A LuaJIT profile can
+ * read them through the FFI without calling back into C++ for every tag.
+ */
+struct LuaWayBatch
+{
+    void Clear();
+    void Add(const osmium::Way &way);
+    std::size_t Size() const { return ways.size(); }
+
+    std::vector<const osmium::Way *> ways;
+    std::vector<std::uint32_t> tag_offsets;
+    std::vector<const char *> keys;
+    std::vector<const char *> values;
+    std::vector<ExtractionWay> results;
+};
+
+/**
+ * The turns that are passed to the process_turns function of a profile at once, indexed from 0.
+ */
+struct LuaTurnBatch
+{
+    std::size_t Size() const { return turns->size(); }
+    ExtractionTurn &Turn(std::size_t index) { return turns->at(index); }
+
+    std::vector<ExtractionTurn> *turns;
+};
+
 struct LuaScriptingContext final
 {
     void ProcessNode(const osmium::Node &, ExtractionNode &result);
     void ProcessWay(const osmium::Way &, ExtractionWay &result);
+    void ProcessWays(LuaWayBatch &batch);
 
     ProfileProperties properties;
     SourceContainer sources;
+    LuaWayBatch way_batch;
+    NativeWayRules native_way_rules;
+    WayMemoCache way_memo;
+    // fingerprints of the ways of way_batch if way_memo is used
+    std::vector<std::string> way_batch_fingerprints;
+    boost::optional<NativeTurnPenalties> native_turn_penalties;
     sol::state state;
 
     bool has_turn_penalty_function;
+    bool has_turns_function;
     bool has_node_function;
     bool has_way_function;
+    bool has_ways_function;
     bool has_segment_function;
 
     sol::function turn_function;
+    sol::function turns_function;
     sol::function way_function;
+    sol::function ways_function;
     sol::function node_function;
     sol::function segment_function;
 
@@ -63,6 +111,7 @@ class Sol2ScriptingEnvironment final : public ScriptingEnvironment
     std::vector<std::string> GetRestrictions() override;
     void SetupSources() override;
     void ProcessTurn(ExtractionTurn &turn) override;
+    void ProcessTurns(std::vector<ExtractionTurn> &turns) override;
     void ProcessSegment(ExtractionSegment &segment) override;
 
     void ProcessElements(
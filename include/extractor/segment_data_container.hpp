@@ -55,6 +55,8 @@ template <storage::Ownership Ownership> class SegmentDataContainerImpl
     using SegmentOffset = std::uint32_t;
     using SegmentWeightVector = PackedVector<SegmentWeight, SEGMENT_WEIGHT_BITS>;
     using SegmentDurationVector = PackedVector<SegmentDuration, SEGMENT_DURAITON_BITS>;
+    using SegmentNodeVector = Vector<NodeID>;
+    using SegmentDatasourceVector = Vector<DatasourceID>;
 
     SegmentDataContainerImpl() = default;
 
@@ -193,6 +195,35 @@ template <storage::Ownership Ownership> class SegmentDataContainerImpl
         return boost::adaptors::reverse(boost::make_iterator_range(begin, end));
     }
 
+    // Decode the weights and durations of a geometry at once, in the order of the ranges above
+    void DecodeForwardWeights(const DirectionalGeometryID id,
+                              std::vector<SegmentWeight> &weights) const
+    {
+        weights.resize(index[id + 1] - index[id] - 1);
+        fwd_weights.decode_range(index[id] + 1, index[id + 1], weights.begin());
+    }
+
+    void DecodeReverseWeights(const DirectionalGeometryID id,
+                              std::vector<SegmentWeight> &weights) const
+    {
+        weights.resize(index[id + 1] - index[id] - 1);
+        rev_weights.decode_range(index[id], index[id + 1] - 1, weights.rbegin());
+    }
+
+    void DecodeForwardDurations(const DirectionalGeometryID id,
+                                std::vector<SegmentDuration> &durations) const
+    {
+        durations.resize(index[id + 1] - index[id] - 1);
+        fwd_durations.decode_range(index[id] + 1, index[id + 1], durations.begin());
+    }
+
+    void DecodeReverseDurations(const DirectionalGeometryID id,
+                                std::vector<SegmentDuration> &durations) const
+    {
+        durations.resize(index[id + 1] - index[id] - 1);
+        rev_durations.decode_range(index[id], index[id + 1] - 1, durations.rbegin());
+    }
+
     auto GetNumberOfGeometries() const { return index.size() - 1; }
     auto GetNumberOfSegments() const { return fwd_weights.size(); }
 
@@ -205,12 +236,12 @@ template <storage::Ownership Ownership> class SegmentDataContainerImpl
 
   private:
     Vector<std::uint32_t> index;
-    Vector<NodeID> nodes;
+    SegmentNodeVector nodes;
     SegmentWeightVector fwd_weights;
     SegmentWeightVector rev_weights;
     SegmentDurationVector fwd_durations;
     SegmentDurationVector rev_durations;
-    Vector<DatasourceID> datasources;
+    SegmentDatasourceVector datasources;
 };
 }
 
@@ -1,6 +1,7 @@
 #ifndef OSRM_EXTRACTOR_IO_HPP
 #define OSRM_EXTRACTOR_IO_HPP
 
+#include "extractor/conditional_turn_masks.hpp"
 #include "extractor/datasources.hpp"
 #include "extractor/intersection_bearings_container.hpp"
 #include "extractor/nbg_to_ebg.hpp"
@@ -8,7 +9,9 @@
 #include "extractor/profile_properties.hpp"
 #include "extractor/restriction.hpp"
 #include "extractor/segment_data_container.hpp"
+#include "extractor/turn_cost_table.hpp"
 #include "extractor/turn_data_container.hpp"
+#include "extractor/way_index.hpp"
 
 #include "storage/io.hpp"
 #include "storage/serialization.hpp"
@@ -90,49 +93,99 @@ inline void write(storage::io::FileWriter &writer,
     storage::serialization::write(writer, segment_data.datasources);
 }
 
+// read/write for conditional turn masks
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::ConditionalTurnMasksImpl<Ownership> &masks)
+{
+    storage::serialization::read(reader, masks.turns);
+    storage::serialization::read(reader, masks.sources);
+    storage::serialization::read(reader, masks.targets);
+    storage::serialization::read(reader, masks.masks);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::ConditionalTurnMasksImpl<Ownership> &masks)
+{
+    storage::serialization::write(writer, masks.turns);
+    storage::serialization::write(writer, masks.sources);
+    storage::serialization::write(writer, masks.targets);
+    storage::serialization::write(writer, masks.masks);
+}
+
+// read/write for the way index
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::WayIndexImpl<Ownership> &index)
+{
+    storage::serialization::read(reader, index.ways);
+    util::serialization::read(reader, index.nodes);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer, const detail::WayIndexImpl<Ownership> &index)
+{
+    storage::serialization::write(writer, index.ways);
+    util::serialization::write(writer, index.nodes);
+}
+
+// read/write for turn cost tables
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::TurnCostTableImpl<Ownership> &turn_costs)
+{
+    storage::serialization::read(reader, turn_costs.via_nodes);
+    storage::serialization::read(reader, turn_costs.entry_offsets);
+    storage::serialization::read(reader, turn_costs.entry_nodes);
+    storage::serialization::read(reader, turn_costs.exit_offsets);
+    storage::serialization::read(reader, turn_costs.exit_nodes);
+    storage::serialization::read(reader, turn_costs.penalty_offsets);
+    storage::serialization::read(reader, turn_costs.penalties);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::TurnCostTableImpl<Ownership> &turn_costs)
+{
+    storage::serialization::write(writer, turn_costs.via_nodes);
+    storage::serialization::write(writer, turn_costs.entry_offsets);
+    storage::serialization::write(writer, turn_costs.entry_nodes);
+    storage::serialization::write(writer, turn_costs.exit_offsets);
+    storage::serialization::write(writer, turn_costs.exit_nodes);
+    storage::serialization::write(writer, turn_costs.penalty_offsets);
+    storage::serialization::write(writer, turn_costs.penalties);
+}
+
 // read/write for turn data file
 template <storage::Ownership Ownership>
 inline void read(storage::io::FileReader &reader,
                  detail::TurnDataContainerImpl<Ownership> &turn_data_container)
 {
-    storage::serialization::read(reader, turn_data_container.turn_instructions);
-    storage::serialization::read(reader, turn_data_container.lane_data_ids);
-    storage::serialization::read(reader, turn_data_container.entry_class_ids);
-    storage::serialization::read(reader, turn_data_container.pre_turn_bearings);
-    storage::serialization::read(reader, turn_data_container.post_turn_bearings);
+    storage::serialization::read(reader, turn_data_container.turn_data_ids);
+    storage::serialization::read(reader, turn_data_container.turn_data);
 }
 
 template <storage::Ownership Ownership>
 inline void write(storage::io::FileWriter &writer,
                   const detail::TurnDataContainerImpl<Ownership> &turn_data_container)
 {
-    storage::serialization::write(writer, turn_data_container.turn_instructions);
-    storage::serialization::write(writer, turn_data_container.lane_data_ids);
-    storage::serialization::write(writer, turn_data_container.entry_class_ids);
-    storage::serialization::write(writer, turn_data_container.pre_turn_bearings);
-    storage::serialization::write(writer, turn_data_container.post_turn_bearings);
+    storage::serialization::write(writer, turn_data_container.turn_data_ids);
+    storage::serialization::write(writer, turn_data_container.turn_data);
 }
 
 template <storage::Ownership Ownership>
 inline void read(storage::io::FileReader &reader,
                  detail::EdgeBasedNodeDataContainerImpl<Ownership> &node_data_container)
 {
-    storage::serialization::read(reader, node_data_container.geometry_ids);
-    storage::serialization::read(reader, node_data_container.name_ids);
+    storage::serialization::read(reader, node_data_container.nodes);
     storage::serialization::read(reader, node_data_container.component_ids);
-    storage::serialization::read(reader, node_data_container.travel_modes);
-    storage::serialization::read(reader, node_data_container.classes);
 }
 
 template <storage::Ownership Ownership>
 inline void write(storage::io::FileWriter &writer,
                   const detail::EdgeBasedNodeDataContainerImpl<Ownership> &node_data_container)
 {
-    storage::serialization::write(writer, node_data_container.geometry_ids);
-    storage::serialization::write(writer, node_data_container.name_ids);
+    storage::serialization::write(writer, node_data_container.nodes);
     storage::serialization::write(writer, node_data_container.component_ids);
-    storage::serialization::write(writer, node_data_container.travel_modes);
-    storage::serialization::write(writer, node_data_container.classes);
 }
 
 // read/write for conditional turn restrictions file
@@ -0,0 +1,194 @@
+#ifndef OSRM_EXTRACTOR_TURN_COST_TABLE_HPP
+#define OSRM_EXTRACTOR_TURN_COST_TABLE_HPP
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class TurnCostTableImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+void read(storage::io::FileReader &reader, detail::TurnCostTableImpl<Ownership> &turn_costs);
+
+template <storage::Ownership Ownership>
+void write(storage::io::FileWriter &writer, const detail::TurnCostTableImpl<Ownership> &turn_costs);
+}
+
+namespace detail
+{
+/**
+ * Turn penalties of every intersection of the node-based graph as a matrix of its entries and
+ * exits. This is the experimental turn model for routing on the node-based graph: a turn
+ * (from, via, to) costs the penalty in the row of the entry from and the column of the exit to,
+ * turns that are not in the edge-based graph are marked INVALID_TURN_PENALTY.
+ *
+ * Entries and exits are the neighbours of the intersection on the uncompressed geometry, as in
+ * the turn penalty index of the edge-based graph.
+ */
+template <storage::Ownership Ownership> class TurnCostTableImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    TurnCostTableImpl() = default;
+
+    TurnCostTableImpl(Vector<NodeID> via_nodes,
+                      Vector<std::uint32_t> entry_offsets,
+                      Vector<NodeID> entry_nodes,
+                      Vector<std::uint32_t> exit_offsets,
+                      Vector<NodeID> exit_nodes,
+                      Vector<std::uint64_t> penalty_offsets,
+                      Vector<TurnPenalty> penalties)
+        : via_nodes(std::move(via_nodes)), entry_offsets(std::move(entry_offsets)),
+          entry_nodes(std::move(entry_nodes)), exit_offsets(std::move(exit_offsets)),
+          exit_nodes(std::move(exit_nodes)), penalty_offsets(std::move(penalty_offsets)),
+          penalties(std::move(penalties))
+    {
+    }
+
+    // Builds the matrices from the turn penalty index of the edge-based graph, penalties holds
+    // the weight penalty of the turn at the same position
+    template <typename TurnIndexVectorT,
+              typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    TurnCostTableImpl(const TurnIndexVectorT &turns, const std::vector<TurnPenalty> &turn_penalties)
+    {
+        BOOST_ASSERT(turns.size() == turn_penalties.size());
+
+        std::vector<std::uint64_t> order(turns.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](const auto lhs, const auto rhs) {
+            return std::tie(turns[lhs].via_id, turns[lhs].from_id) <
+                   std::tie(turns[rhs].via_id, turns[rhs].from_id);
+        });
+
+        entry_offsets.push_back(0);
+        exit_offsets.push_back(0);
+        penalty_offsets.push_back(0);
+        auto begin = order.begin();
+        while (begin != order.end())
+        {
+            const auto via = turns[*begin].via_id;
+            const auto end = std::find_if(
+                begin, order.end(), [&](const auto turn) { return turns[turn].via_id != via; });
+
+            // the turns are sorted by their entries already
+            const auto first_entry = entry_nodes.size();
+            for (auto turn = begin; turn != end; ++turn)
+            {
+                if (entry_nodes.size() == first_entry || entry_nodes.back() != turns[*turn].from_id)
+                    entry_nodes.push_back(turns[*turn].from_id);
+            }
+
+            const auto first_exit = exit_nodes.size();
+            for (auto turn = begin; turn != end; ++turn)
+                exit_nodes.push_back(turns[*turn].to_id);
+            std::sort(exit_nodes.begin() + first_exit, exit_nodes.end());
+            exit_nodes.erase(std::unique(exit_nodes.begin() + first_exit, exit_nodes.end()),
+                             exit_nodes.end());
+
+            const auto num_entries = entry_nodes.size() - first_entry;
+            const auto num_exits = exit_nodes.size() - first_exit;
+            const auto first_penalty = penalties.size();
+            penalties.resize(first_penalty + num_entries * num_exits, INVALID_TURN_PENALTY);
+            const auto entries_begin = entry_nodes.begin() + first_entry;
+            const auto exits_begin = exit_nodes.begin() + first_exit;
+            for (auto turn = begin; turn != end; ++turn)
+            {
+                const auto entry =
+                    std::lower_bound(entries_begin, entry_nodes.end(), turns[*turn].from_id) -
+                    entries_begin;
+                const auto exit =
+                    std::lower_bound(exits_begin, exit_nodes.end(), turns[*turn].to_id) -
+                    exits_begin;
+                auto &penalty = penalties[first_penalty + entry * num_exits + exit];
+                // parallel edges can share a turn, routing takes the cheapest one
+                if (penalty == INVALID_TURN_PENALTY || turn_penalties[*turn] < penalty)
+                    penalty = turn_penalties[*turn];
+            }
+
+            via_nodes.push_back(via);
+            entry_offsets.push_back(entry_nodes.size());
+            exit_offsets.push_back(exit_nodes.size());
+            penalty_offsets.push_back(penalties.size());
+            begin = end;
+        }
+    }
+
+    // Penalty of the turn, INVALID_TURN_PENALTY if it is not allowed
+    TurnPenalty GetTurnPenalty(const NodeID from, const NodeID via, const NodeID to) const
+    {
+        const auto via_iter = std::lower_bound(via_nodes.begin(), via_nodes.end(), via);
+        if (via_iter == via_nodes.end() || *via_iter != via)
+            return INVALID_TURN_PENALTY;
+        const auto index = via_iter - via_nodes.begin();
+
+        const auto entries_begin = entry_nodes.begin() + entry_offsets[index];
+        const auto entries_end = entry_nodes.begin() + entry_offsets[index + 1];
+        const auto entry = std::lower_bound(entries_begin, entries_end, from);
+        if (entry == entries_end || *entry != from)
+            return INVALID_TURN_PENALTY;
+
+        const auto exits_begin = exit_nodes.begin() + exit_offsets[index];
+        const auto exits_end = exit_nodes.begin() + exit_offsets[index + 1];
+        const auto exit = std::lower_bound(exits_begin, exits_end, to);
+        if (exit == exits_end || *exit != to)
+            return INVALID_TURN_PENALTY;
+
+        const auto num_exits = exits_end - exits_begin;
+        return penalties[penalty_offsets[index] + (entry - entries_begin) * num_exits +
+                         (exit - exits_begin)];
+    }
+
+    std::size_t GetNumberOfIntersections() const { return via_nodes.size(); }
+
+    std::size_t GetSizeInBytes() const
+    {
+        return via_nodes.size() * sizeof(NodeID) +
+               (entry_offsets.size() + exit_offsets.size()) * sizeof(std::uint32_t) +
+               (entry_nodes.size() + exit_nodes.size()) * sizeof(NodeID) +
+               penalty_offsets.size() * sizeof(std::uint64_t) +
+               penalties.size() * sizeof(TurnPenalty);
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               TurnCostTableImpl &turn_costs);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const TurnCostTableImpl &turn_costs);
+
+  private:
+    Vector<NodeID> via_nodes;
+    Vector<std::uint32_t> entry_offsets;
+    Vector<NodeID> entry_nodes;
+    Vector<std::uint32_t> exit_offsets;
+    Vector<NodeID> exit_nodes;
+    Vector<std::uint64_t> penalty_offsets;
+    // row-major matrix of entries by exits per intersection
+    Vector<TurnPenalty> penalties;
+};
+}
+
+using TurnCostTable = detail::TurnCostTableImpl<storage::Ownership::Container>;
+using TurnCostTableView = detail::TurnCostTableImpl<storage::Ownership::View>;
+}
+}
+
+#endif
@@ -12,6 +12,12 @@
 
 #include "util/typedefs.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
 namespace osrm
 {
 namespace extractor
@@ -31,6 +37,9 @@ void write(storage::io::FileWriter &writer,
            const detail::TurnDataContainerImpl<Ownership> &turn_data);
 }
 
+// Turns share these descriptors a lot, so every turn stores the id of its descriptor in a table
+// of unique descriptors instead of the descriptor itself.
+#pragma pack(push, 1)
 struct TurnData
 {
     extractor::guidance::TurnInstruction turn_instruction;
@@ -39,6 +48,8 @@ struct TurnData
     util::guidance::TurnBearing pre_turn_bearing;
     util::guidance::TurnBearing post_turn_bearing;
 };
+#pragma pack(pop)
+static_assert(sizeof(TurnData) == 7, "TurnData is stored without padding");
 
 namespace detail
 {
@@ -49,48 +60,40 @@ template <storage::Ownership Ownership> class TurnDataContainerImpl
   public:
     TurnDataContainerImpl() = default;
 
-    TurnDataContainerImpl(Vector<extractor::guidance::TurnInstruction> turn_instructions,
-                          Vector<LaneDataID> lane_data_ids,
-                          Vector<EntryClassID> entry_class_ids,
-                          Vector<util::guidance::TurnBearing> pre_turn_bearings,
-                          Vector<util::guidance::TurnBearing> post_turn_bearings)
-        : turn_instructions(std::move(turn_instructions)), lane_data_ids(std::move(lane_data_ids)),
-          entry_class_ids(std::move(entry_class_ids)),
-          pre_turn_bearings(std::move(pre_turn_bearings)),
-          post_turn_bearings(std::move(post_turn_bearings))
+    TurnDataContainerImpl(Vector<std::uint32_t> turn_data_ids, Vector<TurnData> turn_data)
+        : turn_data_ids(std::move(turn_data_ids)), turn_data(std::move(turn_data))
     {
     }
 
-    EntryClassID GetEntryClassID(const EdgeID id) const { return entry_class_ids[id]; }
+    EntryClassID GetEntryClassID(const EdgeID id) const { return Get(id).entry_class_id; }
 
     util::guidance::TurnBearing GetPreTurnBearing(const EdgeID id) const
     {
-        return pre_turn_bearings[id];
+        return Get(id).pre_turn_bearing;
     }
 
     util::guidance::TurnBearing GetPostTurnBearing(const EdgeID id) const
     {
-        return post_turn_bearings[id];
+        return Get(id).post_turn_bearing;
     }
 
-    LaneDataID GetLaneDataID(const EdgeID id) const { return lane_data_ids[id]; }
+    LaneDataID GetLaneDataID(const EdgeID id) const { return Get(id).lane_data_id; }
 
-    bool HasLaneData(const EdgeID id) const { return INVALID_LANE_DATAID != lane_data_ids[id]; }
+    bool HasLaneData(const EdgeID id) const { return INVALID_LANE_DATAID != Get(id).lane_data_id; }
 
     extractor::guidance::TurnInstruction GetTurnInstruction(const EdgeID id) const
     {
-        return turn_instructions[id];
+        return Get(id).turn_instruction;
     }
 
     // Used by EdgeBasedGraphFactory to fill data structure
     template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
     void push_back(const TurnData &data)
     {
-        turn_instructions.push_back(data.turn_instruction);
-        lane_data_ids.push_back(data.lane_data_id);
-        entry_class_ids.push_back(data.entry_class_id);
-        pre_turn_bearings.push_back(data.pre_turn_bearing);
-        post_turn_bearings.push_back(data.post_turn_bearing);
+        const auto inserted = turn_data_id_map.emplace(PackTurnData(data), turn_data.size());
+        if (inserted.second)
+            turn_data.push_back(data);
+        turn_data_ids.push_back(inserted.first->second);
     }
 
     template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
@@ -106,11 +109,19 @@ template <storage::Ownership Ownership> class TurnDataContainerImpl
                                                 const TurnDataContainerImpl &turn_data_container);
 
   private:
-    Vector<extractor::guidance::TurnInstruction> turn_instructions;
-    Vector<LaneDataID> lane_data_ids;
-    Vector<EntryClassID> entry_class_ids;
-    Vector<util::guidance::TurnBearing> pre_turn_bearings;
-    Vector<util::guidance::TurnBearing> post_turn_bearings;
+    TurnData Get(const EdgeID id) const { return turn_data[turn_data_ids[id]]; }
+
+    static std::uint64_t PackTurnData(const TurnData &data)
+    {
+        std::uint64_t packed = 0;
+        std::memcpy(&packed, &data, sizeof(data));
+        return packed;
+    }
+
+    Vector<std::uint32_t> turn_data_ids;
+    Vector<TurnData> turn_data;
+    // the ids of the descriptors in turn_data, only used while the container is filled
+    std::unordered_map<std::uint64_t, std::uint32_t> turn_data_id_map;
 };
 }
 
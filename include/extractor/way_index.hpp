@@ -0,0 +1,111 @@
+#ifndef OSRM_EXTRACTOR_WAY_INDEX_HPP
+#define OSRM_EXTRACTOR_WAY_INDEX_HPP
+
+#include "extractor/packed_osm_ids.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+// Nodes of a way in the node list of the way index
+struct WayNodes
+{
+    OSMWayID way_id;
+    std::uint64_t first_node;
+    std::uint64_t num_nodes;
+};
+
+namespace detail
+{
+template <storage::Ownership Ownership> class WayIndexImpl;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+void read(storage::io::FileReader &reader, detail::WayIndexImpl<Ownership> &index);
+
+template <storage::Ownership Ownership>
+void write(storage::io::FileWriter &writer, const detail::WayIndexImpl<Ownership> &index);
+}
+
+namespace detail
+{
+/**
+ * The OSM nodes of the routable ways by the OSM id of the way, written by osrm-extract
+ * --way-index. Speed updates of whole ways are turned into updates of the segments between
+ * their nodes with it, so they reach the same geometries as updates of single segments.
+ *
+ * The nodes are kept in the order the ways were parsed in, the ways are sorted by their id and
+ * point to their nodes.
+ */
+template <storage::Ownership Ownership> class WayIndexImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    WayIndexImpl() = default;
+
+    WayIndexImpl(Vector<WayNodes> ways, PackedOSMIDs<Ownership> nodes)
+        : ways(std::move(ways)), nodes(std::move(nodes))
+    {
+        BOOST_ASSERT(std::is_sorted(this->ways.begin(),
+                                    this->ways.end(),
+                                    [](const auto &lhs, const auto &rhs) {
+                                        return lhs.way_id < rhs.way_id;
+                                    }));
+    }
+
+    std::size_t GetNumberOfWays() const { return ways.size(); }
+
+    // Calls callback(offset, from, to) for the segments of the way in the order of its nodes,
+    // returns false if the way is not in the index
+    template <typename CallbackT>
+    bool ForEachSegment(const OSMWayID way_id, const CallbackT &callback) const
+    {
+        const auto way = std::lower_bound(
+            ways.begin(), ways.end(), way_id, [](const auto &lhs, const auto &rhs) {
+                return lhs.way_id < rhs;
+            });
+        if (way == ways.end() || way->way_id != way_id)
+            return false;
+
+        for (std::uint64_t offset = 0; offset + 1 < way->num_nodes; ++offset)
+        {
+            callback(offset,
+                     nodes[way->first_node + offset],
+                     nodes[way->first_node + offset + 1]);
+        }
+        return true;
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               WayIndexImpl &index);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const WayIndexImpl &index);
+
+  private:
+    Vector<WayNodes> ways;
+    PackedOSMIDs<Ownership> nodes;
+};
+}
+
+using WayIndex = detail::WayIndexImpl<storage::Ownership::Container>;
+using WayIndexView = detail::WayIndexImpl<storage::Ownership::View>;
+}
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef WAY_MEMO_CACHE_HPP
+#define WAY_MEMO_CACHE_HPP
+
+#include "extractor/extraction_way.hpp"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osmium
+{
+class TagList;
+}
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Results of the way function of a profile by the values of the tags the profile reads.
+ *
+ * Ways with the same values for all of the keys get the same result, so the profile is only
+ * called for the first of them. This only holds if the profile reads nothing else: no other
+ * tags, no node locations, no ids. The keys are taken from `way_memo_keys` of the profile.
+ *
+ * Each scripting context keeps a cache of its own. It is cleared once it holds max_entries
+ * results, so it favours the tag sets that are frequent in the current part of the input.
+ */
+class WayMemoCache
+{
+  public:
+    static const constexpr std::size_t DEFAULT_MAX_ENTRIES = 1 << 16;
+
+    bool Empty() const { return keys.empty(); }
+
+    void AddKey(std::string key);
+    void SetMaxEntries(std::size_t max_entries_) { max_entries = max_entries_; }
+
+    // Writes the values of the keys in the tags into fingerprint, missing ones are told apart
+    // from empty ones
+    void Fingerprint(const osmium::TagList &tags, std::string &fingerprint) const;
+
+    // The result of an earlier way with the fingerprint, nullptr if there is none
+    const ExtractionWay *Find(const std::string &fingerprint) const;
+
+    void Insert(const std::string &fingerprint, const ExtractionWay &result);
+
+  private:
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, ExtractionWay> results;
+    std::size_t max_entries = DEFAULT_MAX_ENTRIES;
+};
+}
+}
+
+#endif
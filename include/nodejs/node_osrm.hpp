@@ -10,6 +10,9 @@
 namespace node_osrm
 {
 
+class WorkerPool;
+struct WorkerPoolConfig;
+
 struct Engine final : public Nan::ObjectWrap
 {
     using Base = Nan::ObjectWrap;
@@ -25,13 +28,16 @@ struct Engine final : public Nan::ObjectWrap
     static NAN_METHOD(match);
     static NAN_METHOD(trip);
 
-    Engine(osrm::EngineConfig &config);
+    Engine(osrm::EngineConfig &config, const WorkerPoolConfig &pool_config);
 
     // Thread-safe singleton accessor
     static Nan::Persistent<v8::Function> &constructor();
 
     // Ref-counted OSRM alive even after shutdown until last callback is done
     std::shared_ptr<osrm::OSRM> this_;
+
+    // Threads of this object instead of the libuv threadpool, if configured
+    std::shared_ptr<WorkerPool> pool;
 };
 
 } // ns node_osrm
@@ -2,6 +2,10 @@
 #define OSRM_BINDINGS_NODE_SUPPORT_HPP
 
 #include "nodejs/json_v8_renderer.hpp"
+#include "nodejs/worker_pool.hpp"
+
+#include "engine/api/binary_builder.hpp"
+#include "util/json_renderer.hpp"
 
 #include "osrm/approach.hpp"
 #include "osrm/bearing.hpp"
@@ -78,6 +82,87 @@ inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &r
 
 inline void ParseResult(const osrm::Status & /*result_status*/, const std::string & /*unused*/) {}
 
+// How the results are passed to the callback
+enum class ResultFormat
+{
+    Object,     // JavaScript objects, built on the main thread
+    JSONBuffer, // a Buffer with the JSON text, rendered on the worker thread
+    Binary      // a Buffer in the layout of engine/api/binary_format.hpp
+};
+
+// Serializes the result on the worker thread so the main thread only has to wrap the bytes
+inline void RenderResult(const ResultFormat format,
+                         const osrm::json::Object &result,
+                         std::vector<char> &rendered)
+{
+    if (format == ResultFormat::JSONBuffer)
+    {
+        osrm::util::json::render(rendered, result);
+    }
+    else if (format == ResultFormat::Binary)
+    {
+        std::string encoded;
+        osrm::engine::api::binary::encode(result, encoded);
+        rendered.assign(encoded.begin(), encoded.end());
+    }
+}
+
+// Tiles are always passed as Buffer
+inline void RenderResult(const ResultFormat /*format*/,
+                         const std::string & /*unused*/,
+                         std::vector<char> & /*unused*/)
+{
+}
+
+// Hands the rendered bytes over to a Buffer without copying them
+inline v8::Local<v8::Value> renderBuffer(std::vector<char> &&rendered)
+{
+    auto *const bytes = new std::vector<char>(std::move(rendered));
+    return Nan::NewBuffer(bytes->data(),
+                          bytes->size(),
+                          [](char * /*data*/, void *hint) {
+                              delete static_cast<std::vector<char> *>(hint);
+                          },
+                          bytes)
+        .ToLocalChecked();
+}
+
+// The format option of the services that return objects
+inline boost::optional<ResultFormat>
+argumentsToResultFormat(const Nan::FunctionCallbackInfo<v8::Value> &args)
+{
+    Nan::HandleScope scope;
+    if (args.Length() < 2 || !args[0]->IsObject())
+        return ResultFormat::Object;
+
+    auto obj = Nan::To<v8::Object>(args[0]).ToLocalChecked();
+    if (!obj->Has(Nan::New("format").ToLocalChecked()))
+        return ResultFormat::Object;
+
+    v8::Local<v8::Value> format = obj->Get(Nan::New("format").ToLocalChecked());
+    if (format.IsEmpty())
+        return boost::none;
+
+    if (!format->IsString())
+    {
+        Nan::ThrowError("format must be a string: [object, json_buffer, binary]");
+        return boost::none;
+    }
+
+    const Nan::Utf8String format_utf8str(format);
+    const std::string format_str{*format_utf8str, *format_utf8str + format_utf8str.length()};
+
+    if (format_str == "object")
+        return ResultFormat::Object;
+    else if (format_str == "json_buffer")
+        return ResultFormat::JSONBuffer;
+    else if (format_str == "binary")
+        return ResultFormat::Binary;
+
+    Nan::ThrowError("format must be one of: [object, json_buffer, binary]");
+    return boost::none;
+}
+
 inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo<v8::Value> &args)
 {
     Nan::HandleScope scope;
@@ -138,6 +223,21 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
         }
     }
 
+    auto dataset_name = params->Get(Nan::New("dataset_name").ToLocalChecked());
+    if (dataset_name.IsEmpty())
+        return engine_config_ptr();
+
+    if (dataset_name->IsString())
+    {
+        engine_config->dataset_name =
+            *v8::String::Utf8Value(Nan::To<v8::String>(dataset_name).ToLocalChecked());
+    }
+    else if (!dataset_name->IsUndefined())
+    {
+        Nan::ThrowError("dataset_name option must be a string");
+        return engine_config_ptr();
+    }
+
     if (path->IsUndefined() && !engine_config->use_shared_memory)
     {
         Nan::ThrowError("Shared_memory must be enabled if no path is "
@@ -164,21 +264,75 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
         {
             engine_config->algorithm = osrm::EngineConfig::Algorithm::MLD;
         }
+        else if (*v8::String::Utf8Value(algorithm_str) == std::string("CCH"))
+        {
+            engine_config->algorithm = osrm::EngineConfig::Algorithm::CCH;
+        }
         else
         {
-            Nan::ThrowError("algorithm option must be one of 'CH', 'CoreCH', or 'MLD'.");
+            Nan::ThrowError("algorithm option must be one of 'CH', 'CoreCH', 'MLD', or 'CCH'.");
             return engine_config_ptr();
         }
     }
     else if (!algorithm->IsUndefined())
     {
-        Nan::ThrowError("algorithm option must be a string and one of 'CH', 'CoreCH', or 'MLD'.");
+        Nan::ThrowError("algorithm option must be a string and one of 'CH', 'CoreCH', 'MLD', or 'CCH'.");
         return engine_config_ptr();
     }
 
     return engine_config;
 }
 
+// The worker_threads and max_queued_requests options of the OSRM constructor
+inline boost::optional<WorkerPoolConfig>
+argumentsToWorkerPoolConfig(const Nan::FunctionCallbackInfo<v8::Value> &args)
+{
+    Nan::HandleScope scope;
+    WorkerPoolConfig pool_config;
+
+    if (args.Length() == 0 || !args[0]->IsObject())
+    {
+        return pool_config;
+    }
+    auto params = Nan::To<v8::Object>(args[0]).ToLocalChecked();
+
+    auto worker_threads = params->Get(Nan::New("worker_threads").ToLocalChecked());
+    if (worker_threads.IsEmpty())
+        return boost::none;
+
+    if (worker_threads->IsUint32())
+    {
+        pool_config.threads = static_cast<int>(worker_threads->Uint32Value());
+    }
+    else if (!worker_threads->IsUndefined())
+    {
+        Nan::ThrowError("worker_threads must be an integer >= 0");
+        return boost::none;
+    }
+
+    auto max_queued_requests = params->Get(Nan::New("max_queued_requests").ToLocalChecked());
+    if (max_queued_requests.IsEmpty())
+        return boost::none;
+
+    if (max_queued_requests->IsUint32())
+    {
+        pool_config.max_queued_requests = max_queued_requests->Uint32Value();
+    }
+    else if (!max_queued_requests->IsUndefined())
+    {
+        Nan::ThrowError("max_queued_requests must be an integer >= 0");
+        return boost::none;
+    }
+
+    if (pool_config.max_queued_requests > 0 && pool_config.threads == 0)
+    {
+        Nan::ThrowError("max_queued_requests requires worker_threads");
+        return boost::none;
+    }
+
+    return pool_config;
+}
+
 inline boost::optional<std::vector<osrm::Coordinate>>
 parseCoordinateArray(const v8::Local<v8::Array> &coordinates_array)
 {
@@ -527,6 +681,22 @@ inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &arg
         params->generate_hints = generate_hints->BooleanValue();
     }
 
+    if (obj->Has(Nan::New("metric").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> metric = obj->Get(Nan::New("metric").ToLocalChecked());
+        if (metric.IsEmpty())
+            return false;
+
+        if (!metric->IsString())
+        {
+            Nan::ThrowError("metric must be a string");
+            return false;
+        }
+
+        const Nan::Utf8String metric_utf8str(metric);
+        params->metric = std::string{*metric_utf8str, *metric_utf8str + metric_utf8str.length()};
+    }
+
     return true;
 }
 
@@ -550,6 +720,23 @@ inline bool parseCommonParameters(const v8::Local<v8::Object> &obj, ParamType &p
         }
     }
 
+    if (obj->Has(Nan::New("intersections").ToLocalChecked()))
+    {
+        auto intersections = obj->Get(Nan::New("intersections").ToLocalChecked());
+        if (intersections.IsEmpty())
+            return false;
+
+        if (intersections->IsBoolean())
+        {
+            params->intersections = intersections->BooleanValue();
+        }
+        else
+        {
+            Nan::ThrowError("'intersections' param must be a boolean");
+            return false;
+        }
+    }
+
     if (obj->Has(Nan::New("annotations").ToLocalChecked()))
     {
         auto annotations = obj->Get(Nan::New("annotations").ToLocalChecked());
@@ -712,6 +899,34 @@ argumentsToRouteParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("depart_at").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("depart_at").ToLocalChecked());
+        if (value.IsEmpty())
+            return route_parameters_ptr();
+
+        if (!value->IsNumber())
+        {
+            Nan::ThrowError("'depart_at' param must be a number of minutes after midnight");
+            return route_parameters_ptr();
+        }
+        params->depart_at = static_cast<unsigned>(value->NumberValue());
+    }
+
+    if (obj->Has(Nan::New("depart_day").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("depart_day").ToLocalChecked());
+        if (value.IsEmpty())
+            return route_parameters_ptr();
+
+        if (!value->IsNumber())
+        {
+            Nan::ThrowError("'depart_day' param must be a day of the week from 0 for Monday");
+            return route_parameters_ptr();
+        }
+        params->depart_day = static_cast<unsigned>(value->NumberValue());
+    }
+
     if (obj->Has(Nan::New("alternatives").ToLocalChecked()))
     {
         auto value = obj->Get(Nan::New("alternatives").ToLocalChecked());
@@ -735,6 +950,50 @@ argumentsToRouteParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("alternatives_search").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("alternatives_search").ToLocalChecked());
+        if (value.IsEmpty())
+            return route_parameters_ptr();
+
+        if (!value->IsString())
+        {
+            Nan::ThrowError("'alternatives_search' param must be a string: [exact, single_pass]");
+            return route_parameters_ptr();
+        }
+
+        const Nan::Utf8String search_utf8str(value);
+        const std::string search_str{*search_utf8str, *search_utf8str + search_utf8str.length()};
+        if (search_str == "exact")
+        {
+            params->alternatives_search = osrm::RouteParameters::AlternativesSearchType::Exact;
+        }
+        else if (search_str == "single_pass")
+        {
+            params->alternatives_search =
+                osrm::RouteParameters::AlternativesSearchType::SinglePass;
+        }
+        else
+        {
+            Nan::ThrowError("'alternatives_search' param must be one of [exact, single_pass]");
+            return route_parameters_ptr();
+        }
+    }
+
+    if (obj->Has(Nan::New("alternative_steps").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("alternative_steps").ToLocalChecked());
+        if (value.IsEmpty())
+            return route_parameters_ptr();
+
+        if (!value->IsBoolean())
+        {
+            Nan::ThrowError("'alternative_steps' param must be a boolean");
+            return route_parameters_ptr();
+        }
+        params->alternative_steps = value->BooleanValue();
+    }
+
     bool parsedSuccessfully = parseCommonParameters(obj, params);
     if (!parsedSuccessfully)
     {
@@ -934,6 +1193,102 @@ argumentsToTableParameter(const Nan::FunctionCallbackInfo<v8::Value> &args,
         }
     }
 
+    if (obj->Has(Nan::New("annotations").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> annotations = obj->Get(Nan::New("annotations").ToLocalChecked());
+        if (annotations.IsEmpty())
+            return table_parameters_ptr();
+
+        if (!annotations->IsArray())
+        {
+            Nan::ThrowError("Annotations must be an array containing 'duration', 'distance' "
+                            "or both");
+            return table_parameters_ptr();
+        }
+
+        params->annotations = osrm::TableParameters::AnnotationsType::None;
+
+        v8::Local<v8::Array> annotations_array = v8::Local<v8::Array>::Cast(annotations);
+        for (std::size_t i = 0; i < annotations_array->Length(); ++i)
+        {
+            const Nan::Utf8String annotations_utf8str(annotations_array->Get(i));
+            std::string annotations_str{*annotations_utf8str,
+                                        *annotations_utf8str + annotations_utf8str.length()};
+
+            if (annotations_str == "duration")
+            {
+                params->annotations =
+                    params->annotations | osrm::TableParameters::AnnotationsType::Duration;
+            }
+            else if (annotations_str == "distance")
+            {
+                params->annotations =
+                    params->annotations | osrm::TableParameters::AnnotationsType::Distance;
+            }
+            else
+            {
+                Nan::ThrowError("this 'annotations' param is not supported");
+                return table_parameters_ptr();
+            }
+        }
+    }
+
+    if (obj->Has(Nan::New("max_duration").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("max_duration").ToLocalChecked());
+        if (value.IsEmpty())
+            return table_parameters_ptr();
+
+        if (!value->IsNumber() || value->NumberValue() < 0)
+        {
+            Nan::ThrowError("'max_duration' param must be a number of seconds >= 0");
+            return table_parameters_ptr();
+        }
+        params->max_duration = value->NumberValue();
+    }
+
+    if (obj->Has(Nan::New("max_weight").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("max_weight").ToLocalChecked());
+        if (value.IsEmpty())
+            return table_parameters_ptr();
+
+        if (!value->IsNumber() || value->NumberValue() < 0)
+        {
+            Nan::ThrowError("'max_weight' param must be a number >= 0");
+            return table_parameters_ptr();
+        }
+        params->max_weight = value->NumberValue();
+    }
+
+    if (obj->Has(Nan::New("max_results_per_source").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("max_results_per_source").ToLocalChecked());
+        if (value.IsEmpty())
+            return table_parameters_ptr();
+
+        if (!value->IsUint32() || value->Uint32Value() == 0)
+        {
+            Nan::ThrowError("'max_results_per_source' param must be an integer > 0");
+            return table_parameters_ptr();
+        }
+        params->max_results_per_source = value->Uint32Value();
+    }
+
+    if (obj->Has(Nan::New("approximate").ToLocalChecked()))
+    {
+        auto value = obj->Get(Nan::New("approximate").ToLocalChecked());
+        if (value.IsEmpty())
+            return table_parameters_ptr();
+
+        if (!value->IsBoolean())
+        {
+            Nan::ThrowError("'approximate' param must be a boolean");
+            return table_parameters_ptr();
+        }
+        params->approximate = value->BooleanValue();
+    }
+
     return params;
 }
 
@@ -0,0 +1,133 @@
+#ifndef OSRM_BINDINGS_NODE_WORKER_POOL_HPP
+#define OSRM_BINDINGS_NODE_WORKER_POOL_HPP
+
+#include "engine/async_executor.hpp"
+
+#include <nan.h>
+#include <uv.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace node_osrm
+{
+
+struct WorkerPoolConfig
+{
+    // 0 runs the queries on the libuv threadpool
+    int threads = 0;
+    // 0 queues any number of queries
+    unsigned max_queued_requests = 0;
+};
+
+/**
+ * Runs the queries of an OSRM object on threads of its own instead of the libuv threadpool, so
+ * they neither compete with the file system and DNS work of the process nor depend on
+ * UV_THREADPOOL_SIZE.
+ *
+ * Execute() of a worker runs on the pool, the worker is then handed back to the event loop
+ * through an uv_async_t to call its callback. All other members are only called from the
+ * event loop. Every queued worker holds a reference to the pool, so it outlives the OSRM
+ * object until the last callback is done.
+ */
+class WorkerPool final : public std::enable_shared_from_this<WorkerPool>
+{
+  public:
+    explicit WorkerPool(const WorkerPoolConfig &config)
+        : max_queued_requests(config.max_queued_requests), handle(new uv_async_t),
+          executor(std::make_unique<osrm::engine::AsyncExecutor>(config.threads))
+    {
+        uv_async_init(uv_default_loop(), handle, Drain);
+        handle->data = this;
+        // only keeps the process alive while queries are pending
+        uv_unref(reinterpret_cast<uv_handle_t *>(handle));
+    }
+
+    ~WorkerPool()
+    {
+        // waits for the pool threads that might still be signalling the loop
+        executor.reset();
+        handle->data = nullptr;
+        uv_close(reinterpret_cast<uv_handle_t *>(handle), [](uv_handle_t *closed_handle) {
+            delete reinterpret_cast<uv_async_t *>(closed_handle);
+        });
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    bool IsFull() const { return max_queued_requests > 0 && pending >= max_queued_requests; }
+
+    // Runs the worker on the pool and completes it on the event loop
+    void Queue(Nan::AsyncWorker *worker)
+    {
+        Track();
+        executor->Enqueue([this, worker] {
+            worker->Execute();
+            Complete(worker);
+        });
+    }
+
+    // Completes the worker on the event loop without running it, e.g. with an error
+    void Skip(Nan::AsyncWorker *worker)
+    {
+        Track();
+        Complete(worker);
+    }
+
+  private:
+    void Track()
+    {
+        if (pending++ == 0)
+            uv_ref(reinterpret_cast<uv_handle_t *>(handle));
+    }
+
+    void Complete(Nan::AsyncWorker *worker)
+    {
+        {
+            std::lock_guard<std::mutex> guard(completed_lock);
+            completed.push_back(worker);
+        }
+        uv_async_send(handle);
+    }
+
+    static void Drain(uv_async_t *handle)
+    {
+        auto *pool = static_cast<WorkerPool *>(handle->data);
+        if (!pool)
+            return;
+
+        // destroying the last worker may release the last reference to the pool
+        const auto keep_alive = pool->shared_from_this();
+
+        std::vector<Nan::AsyncWorker *> workers;
+        {
+            std::lock_guard<std::mutex> guard(pool->completed_lock);
+            workers.swap(pool->completed);
+        }
+        for (auto *worker : workers)
+        {
+            worker->WorkComplete();
+            worker->Destroy();
+        }
+
+        pool->pending -= workers.size();
+        if (pool->pending == 0)
+            uv_unref(reinterpret_cast<uv_handle_t *>(handle));
+    }
+
+    const std::size_t max_queued_requests;
+    // queued and not yet completed workers
+    std::size_t pending = 0;
+
+    std::mutex completed_lock;
+    std::vector<Nan::AsyncWorker *> completed;
+
+    uv_async_t *handle;
+    std::unique_ptr<osrm::engine::AsyncExecutor> executor;
+};
+}
+
+#endif
@@ -28,6 +28,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef OSRM_EXTRACTOR_HPP
 #define OSRM_EXTRACTOR_HPP
 
+#include <vector>
+
 namespace osrm
 {
 namespace extractor
@@ -45,6 +47,16 @@ struct ExtractorConfig;
  */
 void extract(const extractor::ExtractorConfig &config);
 
+/**
+ * Runs the extraction process for several profiles, the input is only parsed once.
+ *
+ * \param configs The extraction configurations of the profiles. They only differ in the
+ *                profile and the output files.
+ * \throws osrm::util::exception, osmium::io_error
+ * \see Extractor, ExtractorConfig
+ */
+void extract(const std::vector<extractor::ExtractorConfig> &configs);
+
 } // ns osrm
 
 #endif // OSRM_EXTRACTOR_HPP
@@ -31,6 +31,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm/osrm_fwd.hpp"
 #include "osrm/status.hpp"
 
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -44,6 +46,17 @@ using engine::api::NearestParameters;
 using engine::api::TripParameters;
 using engine::api::MatchParameters;
 using engine::api::TileParameters;
+using engine::api::IsochroneParameters;
+
+// Outcome of an asynchronous query
+template <typename ResultT> struct AsyncResult
+{
+    Status status;
+    ResultT result;
+};
+
+// Completion handler of an asynchronous query, called on one of the worker threads
+template <typename ResultT> using AsyncCallback = std::function<void(Status, ResultT)>;
 
 /**
  * Represents a Open Source Routing Machine with access to its services.
@@ -56,8 +69,16 @@ using engine::api::TileParameters;
  *  - Trip: shortest round trip between coordinates
  *  - Match: snaps noisy coordinate traces to the road network
  *  - Tile: vector tiles with internal graph representation
+ *  - Isochrone: polygons of the area reachable from a coordinate
  *
  *  All services take service-specific parameters, fill a JSON object, and return a status code.
+ *
+ *  The *Async variants of the services queue the query and return right away. Queued queries
+ *  are run by a fixed number of worker threads (see EngineConfig::async_concurrency) and
+ *  complete through a callback or a future. Callbacks must not throw and should hand expensive
+ *  work off to other threads so they don't hold up the queries behind them. If a query throws,
+ *  the callback gets Status::Error with the message in the result while the future rethrows
+ *  the exception. Destroying the OSRM instance waits for all queued queries.
  */
 class OSRM final
 {
@@ -72,7 +93,7 @@ class OSRM final
 
     ~OSRM();
 
-    // Moveable but not copyable
+    // Moveable but not copyable, assigning to an instance waits for its queued queries
     OSRM(OSRM &&) noexcept;
     OSRM &operator=(OSRM &&) noexcept;
 
@@ -94,6 +115,18 @@ class OSRM final
      */
     Status Table(const TableParameters &parameters, json::Object &result) const;
 
+    /**
+     * Distance tables for coordinates, rendered to JSON text or to the binary format if
+     * requested by the parameters.
+     *
+     * Faster for big tables than building the durations as json::Object.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status and TableParameters
+     */
+    Status Table(const TableParameters &parameters, std::string &result) const;
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -130,8 +163,59 @@ class OSRM final
      */
     Status Tile(const TileParameters &parameters, std::string &result) const;
 
+    /**
+     * Isochrone: polygons of the area reachable from a coordinate within durations
+     *
+     * \param parameters isochrone query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, IsochroneParameters and json::Object
+     */
+    Status Isochrone(const IsochroneParameters &parameters, json::Object &result) const;
+
+    /**
+     * Identifies the dataset the queries currently run on, e.g. to drop results that were
+     * cached for another one. Loading a new dataset into shared memory makes it a new object,
+     * compare them with owner_before so a released dataset isn't confused with a new one.
+     *
+     * \return handle of the dataset, it keeps the dataset alive while it is held
+     */
+    std::shared_ptr<const void> GetDataset() const;
+
+    /**
+     * Asynchronous variants of the services above.
+     *
+     * \param parameters query specific parameters, moved to the worker thread
+     * \param callback called with the status and result once the query is done
+     * \return future of the status and result, if no callback is given
+     * \see AsyncResult and AsyncCallback
+     */
+    void RouteAsync(RouteParameters parameters, AsyncCallback<json::Object> callback) const;
+    std::future<AsyncResult<json::Object>> RouteAsync(RouteParameters parameters) const;
+
+    void TableAsync(TableParameters parameters, AsyncCallback<json::Object> callback) const;
+    void TableAsync(TableParameters parameters, AsyncCallback<std::string> callback) const;
+    std::future<AsyncResult<json::Object>> TableAsync(TableParameters parameters) const;
+
+    void NearestAsync(NearestParameters parameters, AsyncCallback<json::Object> callback) const;
+    std::future<AsyncResult<json::Object>> NearestAsync(NearestParameters parameters) const;
+
+    void TripAsync(TripParameters parameters, AsyncCallback<json::Object> callback) const;
+    std::future<AsyncResult<json::Object>> TripAsync(TripParameters parameters) const;
+
+    void MatchAsync(MatchParameters parameters, AsyncCallback<json::Object> callback) const;
+    std::future<AsyncResult<json::Object>> MatchAsync(MatchParameters parameters) const;
+
+    void TileAsync(TileParameters parameters, AsyncCallback<std::string> callback) const;
+    std::future<AsyncResult<std::string>> TileAsync(TileParameters parameters) const;
+
+    void IsochroneAsync(IsochroneParameters parameters,
+                        AsyncCallback<json::Object> callback) const;
+    std::future<AsyncResult<json::Object>> IsochroneAsync(IsochroneParameters parameters) const;
+
   private:
     std::unique_ptr<engine::EngineInterface> engine_;
+    // declared after the engine so it is destroyed first, its queries use the engine
+    std::unique_ptr<engine::AsyncExecutor> executor_;
 };
 }
 
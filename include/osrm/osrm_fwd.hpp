@@ -52,9 +52,11 @@ struct NearestParameters;
 struct TripParameters;
 struct MatchParameters;
 struct TileParameters;
+struct IsochroneParameters;
 } // ns api
 
 class EngineInterface;
+class AsyncExecutor;
 struct EngineConfig;
 } // ns engine
 } // ns osrm
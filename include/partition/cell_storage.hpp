@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -124,10 +125,13 @@ template <storage::Ownership Ownership> class CellStorageImpl
             const std::size_t stride;
         };
 
+        // The boundary nodes of a cell are sorted by id, so the row and the column of a node
+        // are found by a binary search instead of a scan over all boundary nodes of the cell.
         template <typename ValuePtr> auto GetOutRange(const ValuePtr ptr, const NodeID node) const
         {
-            auto iter = std::find(source_boundary, source_boundary + num_source_nodes, node);
-            if (iter == source_boundary + num_source_nodes)
+            const auto sources_end = source_boundary + num_source_nodes;
+            auto iter = std::lower_bound(source_boundary, sources_end, node);
+            if (iter == sources_end || *iter != node)
                 return boost::make_iterator_range(ptr, ptr);
 
             auto row = std::distance(source_boundary, iter);
@@ -138,9 +142,9 @@ template <storage::Ownership Ownership> class CellStorageImpl
 
         template <typename ValuePtr> auto GetInRange(const ValuePtr ptr, const NodeID node) const
         {
-            auto iter =
-                std::find(destination_boundary, destination_boundary + num_destination_nodes, node);
-            if (iter == destination_boundary + num_destination_nodes)
+            const auto destinations_end = destination_boundary + num_destination_nodes;
+            auto iter = std::lower_bound(destination_boundary, destinations_end, node);
+            if (iter == destinations_end || *iter != node)
                 return boost::make_iterator_range(ColumnIterator{}, ColumnIterator{});
 
             auto column = std::distance(destination_boundary, iter);
@@ -260,6 +264,7 @@ template <storage::Ownership Ownership> class CellStorageImpl
                 }
             }
 
+            // sorted by cell and node, the lookups of the rows and columns rely on it
             tbb::parallel_sort(level_source_boundary.begin(), level_source_boundary.end());
             tbb::parallel_sort(level_destination_boundary.begin(),
                                level_destination_boundary.end());
@@ -328,45 +333,109 @@ template <storage::Ownership Ownership> class CellStorageImpl
         durations.resize(value_offset + 1, MAXIMAL_EDGE_DURATION);
     }
 
+    // Replaces the metrics by one metric per name, all values are reset.
+    // Without names the storage holds a single unnamed metric.
+    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    void SetMetrics(const std::vector<std::string> &names)
+    {
+        const auto values_per_metric = ValuesPerMetric();
+
+        metric_names.clear();
+        for (const auto &name : names)
+        {
+            BOOST_ASSERT(!name.empty());
+            BOOST_ASSERT(name.find('\0') == std::string::npos);
+            metric_names.insert(metric_names.end(), name.begin(), name.end());
+            metric_names.push_back('\0');
+        }
+
+        weights.assign(values_per_metric * GetNumberOfMetrics(), INVALID_EDGE_WEIGHT);
+        durations.assign(values_per_metric * GetNumberOfMetrics(), MAXIMAL_EDGE_DURATION);
+    }
+
     template <typename = std::enable_if<Ownership == storage::Ownership::View>>
     CellStorageImpl(Vector<EdgeWeight> weights_,
                     Vector<EdgeDuration> durations_,
                     Vector<NodeID> source_boundary_,
                     Vector<NodeID> destination_boundary_,
                     Vector<CellData> cells_,
-                    Vector<std::uint64_t> level_to_cell_offset_)
+                    Vector<std::uint64_t> level_to_cell_offset_,
+                    Vector<char> metric_names_ = {})
         : weights(std::move(weights_)), durations(std::move(durations_)),
           source_boundary(std::move(source_boundary_)),
           destination_boundary(std::move(destination_boundary_)), cells(std::move(cells_)),
-          level_to_cell_offset(std::move(level_to_cell_offset_))
+          level_to_cell_offset(std::move(level_to_cell_offset_)),
+          metric_names(std::move(metric_names_))
+    {
+    }
+
+    // The values of all metrics are stored back to back in `weights` and `durations`
+    std::size_t GetNumberOfMetrics() const
+    {
+        return std::max<std::size_t>(
+            1, std::count(metric_names.begin(), metric_names.end(), '\0'));
+    }
+
+    std::vector<std::string> GetMetricNames() const
+    {
+        std::vector<std::string> names;
+        auto begin = metric_names.begin();
+        while (begin != metric_names.end())
+        {
+            const auto end = std::find(begin, metric_names.end(), '\0');
+            names.emplace_back(begin, end);
+            begin = end == metric_names.end() ? end : std::next(end);
+        }
+        return names;
+    }
+
+    std::size_t ValuesPerMetric() const { return weights.size() / GetNumberOfMetrics(); }
+
+    // Returns a view with the values of a single metric only
+    template <typename = std::enable_if<Ownership == storage::Ownership::View>>
+    CellStorageImpl GetMetricView(std::size_t metric) const
     {
+        BOOST_ASSERT(metric < GetNumberOfMetrics());
+        const auto values_per_metric = ValuesPerMetric();
+        return CellStorageImpl{
+            Vector<EdgeWeight>(weights.data() + metric * values_per_metric, values_per_metric),
+            Vector<EdgeDuration>(durations.data() + metric * values_per_metric,
+                                 values_per_metric),
+            source_boundary,
+            destination_boundary,
+            cells,
+            level_to_cell_offset};
     }
 
-    ConstCell GetCell(LevelID level, CellID id) const
+    ConstCell GetCell(LevelID level, CellID id, std::size_t metric = 0) const
     {
         const auto level_index = LevelIDToIndex(level);
         BOOST_ASSERT(level_index < level_to_cell_offset.size());
         const auto offset = level_to_cell_offset[level_index];
         const auto cell_index = offset + id;
         BOOST_ASSERT(cell_index < cells.size());
+        BOOST_ASSERT(metric < GetNumberOfMetrics());
+        const auto metric_offset = metric == 0 ? 0 : metric * ValuesPerMetric();
         return ConstCell{cells[cell_index],
-                         weights.data(),
-                         durations.data(),
+                         weights.data() + metric_offset,
+                         durations.data() + metric_offset,
                          source_boundary.empty() ? nullptr : source_boundary.data(),
                          destination_boundary.empty() ? nullptr : destination_boundary.data()};
     }
 
     template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
-    Cell GetCell(LevelID level, CellID id)
+    Cell GetCell(LevelID level, CellID id, std::size_t metric = 0)
     {
         const auto level_index = LevelIDToIndex(level);
         BOOST_ASSERT(level_index < level_to_cell_offset.size());
         const auto offset = level_to_cell_offset[level_index];
         const auto cell_index = offset + id;
         BOOST_ASSERT(cell_index < cells.size());
+        BOOST_ASSERT(metric < GetNumberOfMetrics());
+        const auto metric_offset = metric == 0 ? 0 : metric * ValuesPerMetric();
         return Cell{cells[cell_index],
-                    weights.data(),
-                    durations.data(),
+                    weights.data() + metric_offset,
+                    durations.data() + metric_offset,
                     source_boundary.data(),
                     destination_boundary.data()};
     }
@@ -383,6 +452,8 @@ template <storage::Ownership Ownership> class CellStorageImpl
     Vector<NodeID> destination_boundary;
     Vector<CellData> cells;
     Vector<std::uint64_t> level_to_cell_offset;
+    // zero terminated names of the metrics, empty for a single unnamed metric
+    Vector<char> metric_names;
 };
 }
 }
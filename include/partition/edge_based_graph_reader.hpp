@@ -9,6 +9,9 @@
 #include "util/coordinate.hpp"
 #include "util/dynamic_graph.hpp"
 #include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/iostreams/device/mapped_file.hpp>
 
 #include <tbb/parallel_reduce.h>
 #include <tbb/parallel_sort.h>
@@ -18,6 +21,7 @@
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace osrm
@@ -26,9 +30,13 @@ namespace partition
 {
 
 // Bidirectional (s,t) to (s,t) and (t,s)
-std::vector<extractor::EdgeBasedEdge>
-splitBidirectionalEdges(const std::vector<extractor::EdgeBasedEdge> &edges)
+template <typename EdgeRangeT>
+std::vector<extractor::EdgeBasedEdge> splitBidirectionalEdges(const EdgeRangeT &edges)
 {
+    static_assert(std::is_same<typename std::remove_const<typename EdgeRangeT::value_type>::type,
+                               extractor::EdgeBasedEdge>::value,
+                  "");
+
     std::vector<extractor::EdgeBasedEdge> directed;
     directed.reserve(edges.size() * 2);
 
@@ -136,7 +144,8 @@ std::vector<OutputEdgeT> prepareEdgesForUsageInGraph(std::vector<extractor::Edge
     return output_edges;
 }
 
-std::vector<extractor::EdgeBasedEdge> graphToEdges(const DynamicEdgeBasedGraph &edge_based_graph)
+inline std::vector<extractor::EdgeBasedEdge>
+graphToEdges(const DynamicEdgeBasedGraph &edge_based_graph)
 {
     auto range = tbb::blocked_range<NodeID>(0, edge_based_graph.GetNumberOfNodes());
     auto max_turn_id =
@@ -184,10 +193,46 @@ std::vector<extractor::EdgeBasedEdge> graphToEdges(const DynamicEdgeBasedGraph &
 inline DynamicEdgeBasedGraph LoadEdgeBasedGraph(const boost::filesystem::path &path)
 {
     EdgeID max_node_id;
-    std::vector<extractor::EdgeBasedEdge> edges;
-    extractor::files::readEdgeBasedGraph(path, max_node_id, edges);
+    std::vector<extractor::EdgeBasedEdge> directed;
+    {
+        std::vector<extractor::EdgeBasedEdge> edges;
+        extractor::files::readEdgeBasedGraph(path, max_node_id, edges);
+        directed = splitBidirectionalEdges(edges);
+    }
+
+    auto tidied = prepareEdgesForUsageInGraph<DynamicEdgeBasedGraphEdge>(std::move(directed));
+
+    return DynamicEdgeBasedGraph(max_node_id + 1, std::move(tidied));
+}
+
+// Same as LoadEdgeBasedGraph but reads the edges from a memory mapping of the file instead of a
+// copy on the heap, so the kernel can evict them while the graph is built.
+inline DynamicEdgeBasedGraph LoadMappedEdgeBasedGraph(const boost::filesystem::path &path)
+{
+    std::uint64_t max_node_id;
+    std::uint64_t number_of_edges;
+    std::uint64_t edges_offset;
+    {
+        storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+        max_node_id = reader.ReadElementCount64();
+        number_of_edges = reader.ReadElementCount64();
+        edges_offset = reader.GetPosition();
+    }
+
+    std::vector<extractor::EdgeBasedEdge> directed;
+    {
+        boost::iostreams::mapped_file_source region(path.string());
+        BOOST_ASSERT(edges_offset + number_of_edges * sizeof(extractor::EdgeBasedEdge) <=
+                     region.size());
+        const auto edges_begin =
+            reinterpret_cast<const extractor::EdgeBasedEdge *>(region.data() + edges_offset);
+        BOOST_ASSERT(reinterpret_cast<std::uintptr_t>(edges_begin) %
+                         alignof(extractor::EdgeBasedEdge) ==
+                     0);
+        directed = splitBidirectionalEdges(
+            util::vector_view<const extractor::EdgeBasedEdge>(edges_begin, number_of_edges));
+    }
 
-    auto directed = splitBidirectionalEdges(edges);
     auto tidied = prepareEdgesForUsageInGraph<DynamicEdgeBasedGraphEdge>(std::move(directed));
 
     return DynamicEdgeBasedGraph(max_node_id + 1, std::move(tidied));
@@ -6,6 +6,7 @@
 #include "storage/io_fwd.hpp"
 #include "storage/shared_memory_ownership.hpp"
 
+#include "util/exception.hpp"
 #include "util/static_graph.hpp"
 #include "util/vector_view.hpp"
 
@@ -130,6 +131,64 @@ class MultiLevelGraph : public util::StaticGraph<EdgeDataT, Ownership>
     // We save the level as sentinel at the end
     LevelID GetNumberOfLevels() const { return node_to_edge_offset.back(); }
 
+    // Number of entries of the arrays, the sizes a graph view needs to hold a copy
+    std::size_t GetNodeArraySize() const { return SuperT::node_array.size(); }
+    std::size_t GetEdgeArraySize() const { return SuperT::edge_array.size(); }
+    std::size_t GetNodeToEdgeOffsetSize() const { return node_to_edge_offset.size(); }
+
+    // Copies the arrays into a graph of another ownership with arrays of the same sizes
+    template <storage::Ownership OtherOwnership>
+    void CopyTo(MultiLevelGraph<EdgeDataT, OtherOwnership> &other) const
+    {
+        BOOST_ASSERT(other.GetNodeArraySize() == GetNodeArraySize());
+        BOOST_ASSERT(other.GetEdgeArraySize() == GetEdgeArraySize());
+        BOOST_ASSERT(other.GetNodeToEdgeOffsetSize() == GetNodeToEdgeOffsetSize());
+        std::copy(SuperT::node_array.begin(), SuperT::node_array.end(), other.node_array.begin());
+        std::copy(SuperT::edge_array.begin(), SuperT::edge_array.end(), other.edge_array.begin());
+        std::copy(node_to_edge_offset.begin(),
+                  node_to_edge_offset.end(),
+                  other.node_to_edge_offset.begin());
+        other.number_of_nodes = SuperT::number_of_nodes;
+        other.number_of_edges = SuperT::number_of_edges;
+    }
+
+    // Number of edge data slices stored by `AppendMetric`
+    std::size_t GetNumberOfMetrics() const
+    {
+        const auto num_edges = SuperT::GetNumberOfEdges();
+        return num_edges == 0 ? 1 : SuperT::edge_array.size() / num_edges;
+    }
+
+    // Stores the edge data of a graph with the same topology as an additional metric.
+    // The edges of every metric follow the edges of the previous one, so a metric is selected
+    // by viewing its slice of the edge array.
+    template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
+    void AppendMetric(const MultiLevelGraph &other)
+    {
+        const auto num_edges = SuperT::GetNumberOfEdges();
+        const auto same_topology =
+            other.GetNumberOfNodes() == SuperT::GetNumberOfNodes() &&
+            other.GetNumberOfEdges() == num_edges &&
+            std::equal(SuperT::node_array.begin(),
+                       SuperT::node_array.end(),
+                       other.node_array.begin(),
+                       [](const auto &lhs, const auto &rhs) {
+                           return lhs.first_edge == rhs.first_edge;
+                       }) &&
+            std::equal(SuperT::edge_array.begin(),
+                       SuperT::edge_array.begin() + num_edges,
+                       other.edge_array.begin(),
+                       [](const auto &lhs, const auto &rhs) { return lhs.target == rhs.target; });
+        if (!same_topology)
+        {
+            throw util::exception("Can't add a metric of a graph with a different topology.");
+        }
+
+        SuperT::edge_array.insert(SuperT::edge_array.end(),
+                                  other.edge_array.begin(),
+                                  other.edge_array.begin() + num_edges);
+    }
+
   private:
     template <typename ContainerT>
     auto GetHighestBorderLevel(const MultiLevelPartition &mlp, const ContainerT &edges) const
@@ -193,6 +252,8 @@ class MultiLevelGraph : public util::StaticGraph<EdgeDataT, Ownership>
         node_to_edge_offset.push_back(mlp.GetNumberOfLevels());
     }
 
+    template <typename, storage::Ownership> friend class MultiLevelGraph;
+
     friend void
     serialization::read<EdgeDataT, Ownership>(storage::io::FileReader &reader,
                                               MultiLevelGraph<EdgeDataT, Ownership> &graph);
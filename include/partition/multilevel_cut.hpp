@@ -0,0 +1,26 @@
+#ifndef OSRM_PARTITION_MULTILEVEL_CUT_HPP_
+#define OSRM_PARTITION_MULTILEVEL_CUT_HPP_
+
+#include "partition/dinic_max_flow.hpp"
+#include "partition/graph_view.hpp"
+
+#include <cstddef>
+
+namespace osrm
+{
+namespace partition
+{
+
+// Bisects a large view on a coarsened copy of it: heavy edges are contracted until the graph has
+// at most `coarsest_size` nodes, the inertial flow cut is computed on that graph and projected
+// back level by level, refining it with Fiduccia-Mattheyses moves on every level.
+DinicMaxFlow::MinCut computeMultilevelCut(const GraphView &view,
+                                          const std::size_t coarsest_size,
+                                          const std::size_t num_slopes,
+                                          const double balance,
+                                          const double source_sink_rate);
+
+} // namespace partition
+} // namespace osrm
+
+#endif // OSRM_PARTITION_MULTILEVEL_CUT_HPP_
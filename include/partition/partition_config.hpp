@@ -15,7 +15,7 @@ struct PartitionConfig
 {
     PartitionConfig()
         : requested_num_threads(0), balance(1.2), boundary_factor(0.25), num_optimizing_cuts(10),
-          small_component_size(1000),
+          small_component_size(1000), coarsening_threshold(0), max_memory(0),
           max_cell_sizes{128, 128 * 32, 128 * 32 * 16, 128 * 32 * 16 * 32}
     {
     }
@@ -62,6 +62,9 @@ struct PartitionConfig
     double boundary_factor;
     std::size_t num_optimizing_cuts;
     std::size_t small_component_size;
+    std::size_t coarsening_threshold;
+    // memory budget in GiB for loading the edge based graph, 0 for no limit
+    double max_memory;
     std::vector<std::size_t> max_cell_sizes;
 };
 }
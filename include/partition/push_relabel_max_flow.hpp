@@ -0,0 +1,96 @@
+#ifndef OSRM_PARTITION_PUSH_RELABEL_MAX_FLOW_HPP_
+#define OSRM_PARTITION_PUSH_RELABEL_MAX_FLOW_HPP_
+
+#include "partition/dinic_max_flow.hpp"
+#include "partition/graph_view.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace partition
+{
+
+// Synchronous parallel push-relabel [1] for max-flow/min-cut on a graph view. Produces the same
+// kind of cut as the DinicMaxFlow, but all nodes that are active in a round are discharged in
+// parallel. It only pays off for large views, below that the serial Dinic is faster.
+class PushRelabelMaxFlow
+{
+  public:
+    using Label = std::uint32_t;
+    using MinCut = DinicMaxFlow::MinCut;
+    using SourceSinkNodes = DinicMaxFlow::SourceSinkNodes;
+
+    // below this number of nodes the partitioner uses the serial DinicMaxFlow
+    static constexpr std::size_t MIN_PARALLEL_NODES = 1 << 16;
+
+    // The cut contains the largest source side of all minimum cuts: all nodes that cannot reach
+    // any of the sinks after the flow is saturated. (DinicMaxFlow returns the smallest one.)
+    MinCut operator()(const GraphView &view,
+                      const SourceSinkNodes &source_nodes,
+                      const SourceSinkNodes &sink_nodes) const;
+
+  private:
+    using Capacity = std::int32_t;
+
+    // Residual graph of the view with unit capacities in both directions, parallel edges are
+    // merged into a single one. Every arc knows the index of its reverse arc.
+    struct ResidualGraph
+    {
+        std::vector<EdgeID> first_arcs;
+        std::vector<NodeID> targets;
+        std::vector<EdgeID> reverse_arcs;
+        std::vector<Capacity> residuals;
+    };
+
+    enum class NodeKind : std::uint8_t
+    {
+        Inner,
+        Source,
+        Sink
+    };
+
+    struct State
+    {
+        ResidualGraph graph;
+        std::vector<NodeKind> kinds;
+        std::vector<Label> labels;
+        // excess of a node, only written by the node itself during a round
+        std::vector<Capacity> excess;
+        // excess received during a round
+        std::vector<std::atomic<Capacity>> added_excess;
+        // the last round a node was put onto the next active list / reached by a global relabel
+        std::vector<std::atomic<std::uint32_t>> queued;
+        std::vector<std::atomic<std::uint32_t>> reached;
+        std::uint32_t round = 0;
+        std::uint32_t relabel_round = 0;
+    };
+
+    ResidualGraph MakeResidualGraph(const GraphView &view) const;
+
+    // Pushes all flow out of the sources and returns the nodes that received some.
+    std::vector<NodeID> SaturateSources(State &state) const;
+
+    // Discharges all active nodes in parallel: first every node pushes along its admissible arcs
+    // with the labels of the last round, then all nodes that are left with excess are relabeled at
+    // once. An admissible arc goes down exactly one level, so no two nodes ever push along the same
+    // pair of arcs in a round. Returns the nodes that are active in the next round and adds the
+    // number of scanned arcs to `work`.
+    std::vector<NodeID>
+    Discharge(State &state, const std::vector<NodeID> &active, std::size_t &work) const;
+
+    // Sets the labels to the exact distances to the sinks in the residual graph, by a parallel
+    // breadth-first search. Nodes that cannot reach a sink get the label `number of nodes`.
+    void GlobalRelabel(State &state) const;
+};
+
+} // namespace partition
+} // namespace osrm
+
+// [1] Baumstark, Blelloch, Shun: Efficient Implementation of a Synchronous Parallel Push-Relabel
+// Algorithm, ESA 2015
+
+#endif // OSRM_PARTITION_PUSH_RELABEL_MAX_FLOW_HPP_
@@ -23,6 +23,9 @@ inline void read(storage::io::FileReader &reader, MultiLevelGraph<EdgeDataT, Own
     storage::serialization::read(reader, graph.node_array);
     storage::serialization::read(reader, graph.edge_array);
     storage::serialization::read(reader, graph.node_to_edge_offset);
+
+    graph.number_of_nodes = graph.node_array.size() - 1;
+    graph.number_of_edges = graph.node_array.back().first_edge;
 }
 
 template <typename EdgeDataT, storage::Ownership Ownership>
@@ -60,6 +63,7 @@ inline void read(storage::io::FileReader &reader, detail::CellStorageImpl<Owners
     storage::serialization::read(reader, storage.destination_boundary);
     storage::serialization::read(reader, storage.cells);
     storage::serialization::read(reader, storage.level_to_cell_offset);
+    storage::serialization::read(reader, storage.metric_names);
 }
 
 template <storage::Ownership Ownership>
@@ -72,6 +76,7 @@ inline void write(storage::io::FileWriter &writer,
     storage::serialization::write(writer, storage.destination_boundary);
     storage::serialization::write(writer, storage.cells);
     storage::serialization::write(writer, storage.level_to_cell_offset);
+    storage::serialization::write(writer, storage.metric_names);
 }
 }
 }
@@ -0,0 +1,91 @@
+#ifndef SERVER_ADMISSION_CONTROL_HPP
+#define SERVER_ADMISSION_CONTROL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace server
+{
+
+struct ServiceLimits
+{
+    // requests of the service that are handled at the same time
+    unsigned max_concurrent;
+    // requests that wait for one of them to finish, more are rejected right away
+    unsigned max_queued;
+};
+
+/**
+ * Limits the number of concurrently handled requests per service, so expensive requests
+ * like large tables can't occupy all threads of the server.
+ *
+ * Waiting requests block their thread, so max_concurrent + max_queued of a service has to be
+ * less than the number of server threads for other services to stay responsive.
+ */
+class AdmissionControl
+{
+    struct ServiceState
+    {
+        ServiceLimits limits;
+        std::mutex mutex;
+        std::condition_variable slot_released;
+        unsigned running = 0;
+        unsigned waiting = 0;
+        std::atomic<std::uint64_t> rejected{0};
+    };
+
+  public:
+    // Permission to handle a request, holds a slot of the service until it is destroyed
+    class Ticket
+    {
+      public:
+        // Admits a request without a limit
+        static Ticket Unlimited() { return Ticket(nullptr, true); }
+
+        Ticket(Ticket &&other) noexcept : state(other.state), admitted(other.admitted)
+        {
+            other.state = nullptr;
+        }
+        Ticket &operator=(Ticket &&) = delete;
+        Ticket(const Ticket &) = delete;
+        Ticket &operator=(const Ticket &) = delete;
+
+        ~Ticket();
+
+        explicit operator bool() const { return admitted; }
+
+      private:
+        friend class AdmissionControl;
+        Ticket(ServiceState *state, const bool admitted) : state(state), admitted(admitted) {}
+
+        ServiceState *state;
+        bool admitted;
+    };
+
+    AdmissionControl(const std::unordered_map<std::string, ServiceLimits> &limits,
+                     const std::chrono::milliseconds max_wait);
+
+    // Waits up to max_wait for a slot of the service, the ticket is false if the request is
+    // rejected. Services without limits are always admitted.
+    Ticket Admit(const std::string &service);
+
+    // Number of rejected requests per service in Prometheus text format
+    std::string DumpPrometheus() const;
+
+  private:
+    // only built in the constructor, so it can be read without locking
+    std::unordered_map<std::string, std::unique_ptr<ServiceState>> services;
+    const std::chrono::milliseconds max_wait;
+};
+}
+}
+
+#endif // SERVER_ADMISSION_CONTROL_HPP
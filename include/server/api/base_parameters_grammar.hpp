@@ -8,11 +8,14 @@
 #include "engine/polyline_compressor.hpp"
 
 #include <boost/optional.hpp>
+#include <boost/range/iterator_range.hpp>
 #include <boost/spirit/include/phoenix.hpp>
 #include <boost/spirit/include/qi.hpp>
 
 #include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -75,11 +78,31 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
     BaseParametersGrammar(qi::rule<Iterator, Signature> &root_rule)
         : BaseParametersGrammar::base_type(root_rule)
     {
+        // the per coordinate options are parsed after the coordinates, so their size is known
+        const auto add_coordinate = [](engine::api::BaseParameters &base_parameters,
+                                       const util::Coordinate coordinate) {
+            base_parameters.coordinates.push_back(coordinate);
+        };
+
+        // set if the coordinate list was already parsed by parseCoordinateList
+        const auto has_coordinates = [](const engine::api::BaseParameters &base_parameters) {
+            return !base_parameters.coordinates.empty();
+        };
+
+        const auto set_coordinates = [](engine::api::BaseParameters &base_parameters,
+                                        std::vector<util::Coordinate> &coordinates) {
+            base_parameters.coordinates = std::move(coordinates);
+        };
+
         const auto add_hint = [](engine::api::BaseParameters &base_parameters,
-                                 const boost::optional<std::string> &hint_string) {
-            if (hint_string)
+                                 const boost::optional<boost::iterator_range<Iterator>> &hint) {
+            if (base_parameters.hints.empty())
+                base_parameters.hints.reserve(base_parameters.coordinates.size());
+
+            if (hint)
             {
-                base_parameters.hints.emplace_back(engine::Hint::FromBase64(hint_string.get()));
+                base_parameters.hints.emplace_back(
+                    engine::Hint::FromBase64(&*hint->begin(), &*hint->begin() + hint->size()));
             }
             else
             {
@@ -90,6 +113,9 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
         const auto add_bearing =
             [](engine::api::BaseParameters &base_parameters,
                boost::optional<boost::fusion::vector2<short, short>> bearing_range) {
+                if (base_parameters.bearings.empty())
+                    base_parameters.bearings.reserve(base_parameters.coordinates.size());
+
                 boost::optional<engine::Bearing> bearing;
                 if (bearing_range)
                 {
@@ -99,8 +125,21 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
                 base_parameters.bearings.push_back(std::move(bearing));
             };
 
+        const auto add_radius = [](engine::api::BaseParameters &base_parameters,
+                                   const boost::optional<double> radius) {
+            if (base_parameters.radiuses.empty())
+                base_parameters.radiuses.reserve(base_parameters.coordinates.size());
+            base_parameters.radiuses.push_back(radius);
+        };
+
+        const auto add_approach = [](engine::api::BaseParameters &base_parameters,
+                                     const boost::optional<engine::Approach> approach) {
+            if (base_parameters.approaches.empty())
+                base_parameters.approaches.reserve(base_parameters.coordinates.size());
+            base_parameters.approaches.push_back(approach);
+        };
+
         polyline_chars = qi::char_("a-zA-Z0-9_.--[]{}@?|\\%~`^");
-        base64_char = qi::char_("a-zA-Z0-9--_=");
         unlimited_rule = qi::lit("unlimited")[qi::_val = std::numeric_limits<double>::infinity()];
 
         bearing_rule =
@@ -135,18 +174,22 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
                                            },
                                            qi::_1)];
 
-        query_rule =
-            ((location_rule % ';') | polyline_rule |
-             polyline6_rule)[ph::bind(&engine::api::BaseParameters::coordinates, qi::_r1) = qi::_1];
+        // coordinates are added as they are parsed instead of copying a parsed list
+        query_rule = qi::eps(ph::bind(has_coordinates, qi::_r1)) |
+                     (location_rule[ph::bind(add_coordinate, qi::_r1, qi::_1)] % ';') |
+                     polyline_rule[ph::bind(set_coordinates, qi::_r1, qi::_1)] |
+                     polyline6_rule[ph::bind(set_coordinates, qi::_r1, qi::_1)];
 
-        radiuses_rule = qi::lit("radiuses=") >
-                        (-(qi::double_ | unlimited_rule) %
-                         ';')[ph::bind(&engine::api::BaseParameters::radiuses, qi::_r1) = qi::_1];
+        radiuses_rule =
+            qi::lit("radiuses=") >
+            (-(qi::double_ | unlimited_rule))[ph::bind(add_radius, qi::_r1, qi::_1)] % ';';
 
-        hints_rule = qi::lit("hints=") >
-                     (-qi::as_string[qi::repeat(engine::ENCODED_HINT_SIZE)[base64_char]])[ph::bind(
-                         add_hint, qi::_r1, qi::_1)] %
-                         ';';
+        // the base64 characters are matched inline, a rule call per character is notably slower
+        hints_rule =
+            qi::lit("hints=") >
+            (-qi::raw[qi::repeat(engine::ENCODED_HINT_SIZE)[qi::char_("a-zA-Z0-9--_=")]])
+                [ph::bind(add_hint, qi::_r1, qi::_1)] %
+                ';';
 
         generate_hints_rule =
             qi::lit("generate_hints=") >
@@ -159,13 +202,24 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
         approach_type.add("unrestricted", engine::Approach::UNRESTRICTED)("curb",
                                                                           engine::Approach::CURB);
         approach_rule = qi::lit("approaches=") >
-                        (-approach_type %
-                         ';')[ph::bind(&engine::api::BaseParameters::approaches, qi::_r1) = qi::_1];
+                        (-approach_type)[ph::bind(add_approach, qi::_r1, qi::_1)] % ';';
+
+        format_type.add("json", engine::api::OutputFormatType::JSON)(
+            "binary", engine::api::OutputFormatType::Binary);
+        format_rule =
+            qi::lit("format=") >
+            format_type[ph::bind(&engine::api::BaseParameters::format, qi::_r1) = qi::_1];
+
+        metric_rule = qi::lit("metric=") >
+                      qi::as_string[+qi::char_("a-zA-Z0-9_-")]
+                                   [ph::bind(&engine::api::BaseParameters::metric, qi::_r1) =
+                                        qi::_1];
 
         base_rule = radiuses_rule(qi::_r1)   //
                     | hints_rule(qi::_r1)    //
                     | bearings_rule(qi::_r1) //
-                    | generate_hints_rule(qi::_r1) | approach_rule(qi::_r1);
+                    | generate_hints_rule(qi::_r1) | approach_rule(qi::_r1) |
+                    format_rule(qi::_r1) | metric_rule(qi::_r1);
     }
 
   protected:
@@ -179,18 +233,20 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
 
     qi::rule<Iterator, Signature> generate_hints_rule;
     qi::rule<Iterator, Signature> approach_rule;
+    qi::rule<Iterator, Signature> format_rule;
+    qi::rule<Iterator, Signature> metric_rule;
 
     qi::rule<Iterator, osrm::engine::Bearing()> bearing_rule;
     qi::rule<Iterator, osrm::util::Coordinate()> location_rule;
     qi::rule<Iterator, std::vector<osrm::util::Coordinate>()> polyline_rule;
     qi::rule<Iterator, std::vector<osrm::util::Coordinate>()> polyline6_rule;
 
-    qi::rule<Iterator, unsigned char()> base64_char;
     qi::rule<Iterator, std::string()> polyline_chars;
     qi::rule<Iterator, double()> unlimited_rule;
     qi::real_parser<double, json_policy> double_;
 
     qi::symbols<char, engine::Approach> approach_type;
+    qi::symbols<char, engine::api::OutputFormatType> format_type;
 };
 }
 }
@@ -0,0 +1,53 @@
+#ifndef SERVER_API_BODY_PARSER_HPP
+#define SERVER_API_BODY_PARSER_HPP
+
+#include "engine/api/base_parameters.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace api
+{
+
+// The coordinates and the lists per coordinate of the body of a POST request. They are moved
+// into the parameters of the service before the grammar parses the options of the URL.
+struct BodyParameters
+{
+    // the coordinates and the hints, radiuses, bearings and approaches
+    engine::api::BaseParameters base;
+    // of table requests
+    std::vector<std::size_t> sources;
+    std::vector<std::size_t> destinations;
+    // of match requests
+    std::vector<unsigned> timestamps;
+};
+
+// Content type of a body of packed little-endian pairs of 32 bit integers, the longitude and
+// latitude of each coordinate in millionths of a degree
+const constexpr char BINARY_BODY_CONTENT_TYPE[] = "application/x-osrm-coordinates";
+
+// Parses a JSON object with a coordinates array and the lists per coordinate as members
+//
+//   {"coordinates": [[7.41,43.73],[7.42,43.74]], "sources": [0], "radiuses": [null, 20]}
+//
+// straight into the parameters without building a document. null elements are left empty as
+// in the URL. Returns false for other members and malformed bodies.
+bool parseJSONBody(const std::string &body, BodyParameters &parameters);
+
+// Copies the coordinates of a binary body, returns false if its size is not a multiple of a
+// coordinate or it is empty.
+bool parseBinaryBody(const std::string &body, BodyParameters &parameters);
+
+// Prepends the parsed body to the query of the URL in the syntax of the URL, for handlers that
+// pass the request on as text.
+void prependBodyQuery(const BodyParameters &parameters, std::string &query);
+}
+}
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef SERVER_API_COORDINATE_LIST_PARSER_HPP
+#define SERVER_API_COORDINATE_LIST_PARSER_HPP
+
+#include "util/coordinate.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace api
+{
+
+namespace detail
+{
+// more integer digits could overflow the fixed representation, the grammar reports those
+const constexpr std::size_t MAX_INTEGER_DIGITS = 3;
+const constexpr std::size_t MAX_FRACTION_DIGITS = 6;
+const constexpr std::int32_t FRACTION_SCALE[MAX_FRACTION_DIGITS + 1] = {
+    1000000, 100000, 10000, 1000, 100, 10, 1};
+
+inline bool isDigit(const char character) { return character >= '0' && character <= '9'; }
+
+// Parses [+-]digits[.digits] straight into millionths. A number with more digits is not
+// handled, the double the grammar parses it to is not exactly representable otherwise.
+template <typename Iterator>
+bool parseFixedDecimal(Iterator &iter, const Iterator end, std::int32_t &value)
+{
+    bool negative = false;
+    if (iter != end && (*iter == '-' || *iter == '+'))
+    {
+        negative = *iter == '-';
+        ++iter;
+    }
+
+    std::int32_t integer = 0;
+    std::size_t integer_digits = 0;
+    for (; iter != end && isDigit(*iter); ++iter, ++integer_digits)
+    {
+        integer = integer * 10 + (*iter - '0');
+    }
+    if (integer_digits == 0 || integer_digits > MAX_INTEGER_DIGITS)
+        return false;
+
+    std::int32_t fraction = 0;
+    std::size_t fraction_digits = 0;
+    if (iter != end && *iter == '.' && std::next(iter) != end && isDigit(*std::next(iter)))
+    {
+        for (++iter; iter != end && isDigit(*iter); ++iter, ++fraction_digits)
+        {
+            if (fraction_digits == MAX_FRACTION_DIGITS)
+                return false;
+            fraction = fraction * 10 + (*iter - '0');
+        }
+    }
+
+    value = integer * FRACTION_SCALE[0] + fraction * FRACTION_SCALE[fraction_digits];
+    if (negative)
+        value = -value;
+    return true;
+}
+
+// The coordinate list is followed by the end of the query, the options or the format
+template <typename Iterator> bool isCoordinateListEnd(const Iterator iter, const Iterator end)
+{
+    const constexpr char json_extension[] = ".json";
+    const auto extension_size = sizeof(json_extension) - 1;
+    return iter == end || *iter == '?' ||
+           (static_cast<std::size_t>(std::distance(iter, end)) >= extension_size &&
+            std::equal(json_extension, json_extension + extension_size, iter));
+}
+}
+
+/**
+ * Fast path for the common `lon,lat;lon,lat;...` coordinate list at the start of a query that
+ * appends the coordinates without going through the grammar.
+ *
+ * Only plain decimal numbers with up to six decimals are handled, which is what clients
+ * usually send. For anything else (polylines, more decimals, malformed input) nothing is
+ * consumed or appended and false is returned, the grammar parses those and reports errors.
+ */
+template <typename Iterator>
+bool parseCoordinateList(Iterator &iter,
+                         const Iterator end,
+                         std::vector<util::Coordinate> &coordinates)
+{
+    const auto initial_size = coordinates.size();
+    auto position = iter;
+    while (true)
+    {
+        std::int32_t lon, lat;
+        if (!detail::parseFixedDecimal(position, end, lon) || position == end || *position != ',')
+            break;
+        ++position;
+        if (!detail::parseFixedDecimal(position, end, lat))
+            break;
+        coordinates.emplace_back(util::FixedLongitude{lon}, util::FixedLatitude{lat});
+
+        if (detail::isCoordinateListEnd(position, end))
+        {
+            iter = position;
+            return true;
+        }
+        if (*position != ';')
+            break;
+        ++position;
+    }
+
+    coordinates.resize(initial_size);
+    return false;
+}
+}
+}
+}
+
+#endif // SERVER_API_COORDINATE_LIST_PARSER_HPP
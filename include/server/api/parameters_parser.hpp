@@ -1,6 +1,8 @@
 #ifndef SERVER_API_ROUTE_PARAMETERS_PARSER_HPP
 #define SERVER_API_ROUTE_PARAMETERS_PARSER_HPP
 
+#include "server/api/body_parser.hpp"
+
 #include "engine/api/base_parameters.hpp"
 #include "engine/api/tile_parameters.hpp"
 
@@ -27,11 +29,23 @@ using is_parameter_t =
                                std::is_same<engine::api::TileParameters, T>::value>;
 } // ns detail
 
+// Moves the lists of the body into the parameters, then starts parsing and iter and modifies it
+// until iter == end or parsing failed. The coordinates of the body replace the ones of the query.
+template <typename ParameterT,
+          typename std::enable_if<detail::is_parameter_t<ParameterT>::value, int>::type = 0>
+boost::optional<ParameterT> parseParameters(boost::optional<BodyParameters> &body,
+                                            std::string::iterator &iter,
+                                            const std::string::iterator end);
+
 // Starts parsing and iter and modifies it until iter == end or parsing failed
 template <typename ParameterT,
           typename std::enable_if<detail::is_parameter_t<ParameterT>::value, int>::type = 0>
 boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
-                                            const std::string::iterator end);
+                                            const std::string::iterator end)
+{
+    boost::optional<BodyParameters> body;
+    return parseParameters<ParameterT>(body, iter, end);
+}
 
 // Copy on purpose because we need mutability
 template <typename ParameterT,
@@ -1,8 +1,13 @@
 #ifndef SERVER_API_PARSED_URL_HPP
 #define SERVER_API_PARSED_URL_HPP
 
+#include "server/api/body_parser.hpp"
+
+#include "engine/query_deadline.hpp"
 #include "util/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <string>
 #include <vector>
 
@@ -20,6 +25,10 @@ struct ParsedURL final
     std::string profile;
     std::string query;
     std::size_t prefix_length;
+    // set by the request handler from the timeout of the request
+    engine::QueryDeadline deadline;
+    // set by the request handler from a JSON or binary body
+    boost::optional<BodyParameters> body;
 };
 
 } // api
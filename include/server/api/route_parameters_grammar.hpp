@@ -28,6 +28,12 @@ struct RouteParametersGrammar : public BaseParametersGrammar<Iterator, Signature
 
     RouteParametersGrammar() : RouteParametersGrammar(root_rule)
     {
+        alternatives_search_type.add(
+            "exact", engine::api::RouteParameters::AlternativesSearchType::Exact)(
+            "single_pass", engine::api::RouteParameters::AlternativesSearchType::SinglePass);
+
+        weekday.add("mo", 0)("tu", 1)("we", 2)("th", 3)("fr", 4)("sa", 5)("su", 6);
+
         route_rule =
             (qi::lit("alternatives=") >
              (qi::uint_[ph::bind(&engine::api::RouteParameters::number_of_alternatives, qi::_r1) =
@@ -37,10 +43,22 @@ struct RouteParametersGrammar : public BaseParametersGrammar<Iterator, Signature
               qi::bool_[ph::bind(&engine::api::RouteParameters::number_of_alternatives, qi::_r1) =
                             qi::_1,
                         ph::bind(&engine::api::RouteParameters::alternatives, qi::_r1) = qi::_1])) |
+            (qi::lit("alternatives_search=") >
+             alternatives_search_type[ph::bind(&engine::api::RouteParameters::alternatives_search,
+                                               qi::_r1) = qi::_1]) |
+            (qi::lit("alternative_steps=") >
+             qi::bool_[ph::bind(&engine::api::RouteParameters::alternative_steps, qi::_r1) =
+                           qi::_1]) |
             (qi::lit("continue_straight=") >
              (qi::lit("default") |
               qi::bool_[ph::bind(&engine::api::RouteParameters::continue_straight, qi::_r1) =
-                            qi::_1]));
+                            qi::_1])) |
+            (qi::lit("depart_at=") >
+             (two_digits > ':' > two_digits)[qi::_pass = qi::_2 < 60,
+                                            ph::bind(&engine::api::RouteParameters::depart_at,
+                                                     qi::_r1) = qi::_1 * 60 + qi::_2]) |
+            (qi::lit("depart_day=") >
+             weekday[ph::bind(&engine::api::RouteParameters::depart_day, qi::_r1) = qi::_1]);
 
         root_rule = query_rule(qi::_r1) > -qi::lit(".json") >
                     -('?' > (route_rule(qi::_r1) | base_rule(qi::_r1)) % '&');
@@ -74,6 +92,9 @@ struct RouteParametersGrammar : public BaseParametersGrammar<Iterator, Signature
             BaseGrammar::base_rule(qi::_r1) |
             (qi::lit("steps=") >
              qi::bool_[ph::bind(&engine::api::RouteParameters::steps, qi::_r1) = qi::_1]) |
+            (qi::lit("intersections=") >
+             qi::bool_[ph::bind(&engine::api::RouteParameters::intersections, qi::_r1) =
+                           qi::_1]) |
             (qi::lit("geometries=") >
              geometries_type[ph::bind(&engine::api::RouteParameters::geometries, qi::_r1) =
                                  qi::_1]) |
@@ -95,6 +116,11 @@ struct RouteParametersGrammar : public BaseParametersGrammar<Iterator, Signature
     qi::rule<Iterator, Signature> root_rule;
     qi::rule<Iterator, Signature> route_rule;
 
+    qi::uint_parser<unsigned, 10, 2, 2> two_digits;
+    qi::symbols<char, unsigned> weekday;
+    qi::symbols<char, engine::api::RouteParameters::AlternativesSearchType>
+        alternatives_search_type;
+
     qi::symbols<char, engine::api::RouteParameters::GeometriesType> geometries_type;
     qi::symbols<char, engine::api::RouteParameters::OverviewType> overview_type;
     qi::symbols<char, engine::api::RouteParameters::AnnotationsType> annotations_type;
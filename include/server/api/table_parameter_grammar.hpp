@@ -48,7 +48,41 @@ struct TableParametersGrammar final : public BaseParametersGrammar<Iterator, Sig
             (qi::lit("all") |
              (size_t_ % ';')[ph::bind(&engine::api::TableParameters::sources, qi::_r1) = qi::_1]);
 
-        table_rule = destinations_rule(qi::_r1) | sources_rule(qi::_r1);
+        using AnnotationsType = engine::api::TableParameters::AnnotationsType;
+
+        // the listed tables replace the default durations
+        const auto add_annotation = [](engine::api::TableParameters &table_parameters,
+                                       AnnotationsType table_param,
+                                       const bool first) {
+            table_parameters.annotations =
+                first ? table_param : table_parameters.annotations | table_param;
+        };
+
+        annotations_type.add("duration", AnnotationsType::Duration)("distance",
+                                                                    AnnotationsType::Distance);
+
+        annotations_rule =
+            qi::lit("annotations=") >
+            (annotations_type[ph::bind(add_annotation, qi::_r1, qi::_1, true)] >
+             *(',' > annotations_type[ph::bind(add_annotation, qi::_r1, qi::_1, false)]));
+
+        bounds_rule =
+            (qi::lit("max_duration=") >
+             qi::double_[ph::bind(&engine::api::TableParameters::max_duration, qi::_r1) =
+                             qi::_1]) |
+            (qi::lit("max_weight=") >
+             qi::double_[ph::bind(&engine::api::TableParameters::max_weight, qi::_r1) = qi::_1]) |
+            (qi::lit("max_results_per_source=") >
+             size_t_[ph::bind(&engine::api::TableParameters::max_results_per_source, qi::_r1) =
+                         qi::_1]);
+
+        approximate_rule =
+            qi::lit("approximate=") >
+            qi::bool_[ph::bind(&engine::api::TableParameters::approximate, qi::_r1) = qi::_1];
+
+        table_rule = destinations_rule(qi::_r1) | sources_rule(qi::_r1) |
+                     annotations_rule(qi::_r1) | bounds_rule(qi::_r1) |
+                     approximate_rule(qi::_r1);
 
         root_rule = BaseGrammar::query_rule(qi::_r1) > -qi::lit(".json") >
                     -('?' > (table_rule(qi::_r1) | BaseGrammar::base_rule(qi::_r1)) % '&');
@@ -59,7 +93,11 @@ struct TableParametersGrammar final : public BaseParametersGrammar<Iterator, Sig
     qi::rule<Iterator, Signature> table_rule;
     qi::rule<Iterator, Signature> sources_rule;
     qi::rule<Iterator, Signature> destinations_rule;
+    qi::rule<Iterator, Signature> annotations_rule;
+    qi::rule<Iterator, Signature> bounds_rule;
+    qi::rule<Iterator, Signature> approximate_rule;
     qi::rule<Iterator, std::size_t()> size_t_;
+    qi::symbols<char, engine::api::TableParameters::AnnotationsType> annotations_type;
 };
 }
 }
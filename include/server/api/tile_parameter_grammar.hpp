@@ -30,15 +30,33 @@ struct TileParametersGrammar final : boost::spirit::qi::grammar<Iterator, Signat
 {
     TileParametersGrammar() : TileParametersGrammar::base_type(root_rule)
     {
+        using LayersType = engine::api::TileParameters::LayersType;
+
+        // the listed layers replace the default of all layers
+        const auto add_layer = [](engine::api::TileParameters &tile_parameters,
+                                  LayersType layer,
+                                  const bool first) {
+            tile_parameters.layers = first ? layer : tile_parameters.layers | layer;
+        };
+
+        layers_type.add("speeds", LayersType::Speeds)("turns", LayersType::Turns)(
+            "osmnodes", LayersType::OSMNodes);
+
+        layers_rule = qi::lit("layers=") >
+                      (layers_type[ph::bind(add_layer, qi::_r1, qi::_1, true)] >
+                       *(',' > layers_type[ph::bind(add_layer, qi::_r1, qi::_1, false)]));
+
         root_rule = qi::lit("tile(") >
                     qi::uint_[ph::bind(&engine::api::TileParameters::x, qi::_r1) = qi::_1] > ',' >
                     qi::uint_[ph::bind(&engine::api::TileParameters::y, qi::_r1) = qi::_1] > ',' >
                     qi::uint_[ph::bind(&engine::api::TileParameters::z, qi::_r1) = qi::_1] >
-                    qi::lit(").mvt");
+                    qi::lit(").mvt") > -('?' > layers_rule(qi::_r1));
     }
 
   private:
     qi::rule<Iterator, Signature> root_rule;
+    qi::rule<Iterator, Signature> layers_rule;
+    qi::symbols<char, engine::api::TileParameters::LayersType> layers_type;
 };
 }
 }
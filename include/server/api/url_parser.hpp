@@ -14,8 +14,11 @@ namespace server
 namespace api
 {
 
-// Starts parsing and iter and modifies it until iter == end or parsing failed
-boost::optional<ParsedURL> parseURL(std::string::iterator &iter, const std::string::iterator end);
+// Starts parsing and iter and modifies it until iter == end or parsing failed. The URL of a
+// request with a body may end after the profile.
+boost::optional<ParsedURL> parseURL(std::string::iterator &iter,
+                                    const std::string::iterator end,
+                                    const bool with_body = false);
 
 inline boost::optional<ParsedURL> parseURL(std::string url_string)
 {
@@ -0,0 +1,55 @@
+#ifndef SERVER_BACKEND_CLIENT_HPP
+#define SERVER_BACKEND_CLIENT_HPP
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+// osrm-routed instance that answers the requests passed on to it
+struct Backend
+{
+    std::string host;
+    std::string port;
+
+    // Parses HOST:PORT, throws util::exception if it is malformed
+    static Backend FromString(const std::string &backend);
+};
+
+// HTTP/1.0 request to a backend, a POST request if it has a body
+struct BackendRequest
+{
+    Backend backend;
+    std::string uri;
+    std::string body;
+    // besides Host, Connection and Content-Length, e.g. X-OSRM-Timeout
+    std::vector<std::pair<std::string, std::string>> headers;
+};
+
+struct BackendReply
+{
+    // the three digits of the status line, e.g. 200
+    std::string status;
+    std::string content_type;
+    std::string content;
+};
+
+/**
+ * Sends the requests to their backends at the same time and waits up to the timeout for all
+ * replies, which are returned in the order of the requests. The calling thread runs the
+ * connections.
+ *
+ * Throws util::exception if a backend can't be reached, doesn't reply in time or sends a
+ * malformed reply, the other requests are cancelled then.
+ */
+std::vector<BackendReply> fetchFromBackends(const std::vector<BackendRequest> &requests,
+                                            const std::chrono::milliseconds timeout);
+}
+}
+
+#endif // SERVER_BACKEND_CLIENT_HPP
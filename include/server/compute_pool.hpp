@@ -0,0 +1,75 @@
+#ifndef SERVER_COMPUTE_POOL_HPP
+#define SERVER_COMPUTE_POOL_HPP
+
+#include <tbb/task_arena.h>
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace osrm
+{
+namespace server
+{
+
+enum class ComputePriority
+{
+    // queries that take milliseconds, like routes and snapping
+    High,
+    // queries that can take seconds, like large tables and matches
+    Low,
+    NumPriorities
+};
+
+/**
+ * Handles the requests of the connections on the TBB worker threads, so the threads of the
+ * server only read, parse and write and a long query doesn't hold up the other connections of
+ * its thread.
+ *
+ * At most `concurrency` requests are handled at the same time, the idle workers of TBB steal
+ * the tasks of the busy ones. Waiting requests of high priority are handled before the ones of
+ * low priority. The destructor waits for all queued tasks.
+ */
+class ComputePool
+{
+  public:
+    // -1 handles as many requests at once as there are hardware threads
+    explicit ComputePool(const int concurrency);
+    ~ComputePool();
+
+    ComputePool(const ComputePool &) = delete;
+    ComputePool &operator=(const ComputePool &) = delete;
+
+    // Queues the task, it must not throw
+    void Enqueue(const ComputePriority priority, std::function<void()> task);
+
+    // Blocks until all queued tasks have finished
+    void Wait();
+
+    // Priority of the requests of a service
+    static ComputePriority GetPriority(const std::string &service);
+
+    // Waiting tasks by priority in Prometheus text format
+    std::string DumpPrometheus() const;
+
+  private:
+    // Runs the waiting task of the highest priority
+    void RunNext();
+
+    tbb::task_arena arena;
+
+    mutable std::mutex queue_lock;
+    std::condition_variable all_finished;
+    std::array<std::deque<std::function<void()>>,
+               static_cast<std::size_t>(ComputePriority::NumPriorities)>
+        queues;
+    std::size_t pending = 0;
+};
+}
+}
+
+#endif // SERVER_COMPUTE_POOL_HPP
@@ -11,6 +11,7 @@
 #include <boost/config.hpp>
 #include <boost/version.hpp>
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -34,14 +35,34 @@ namespace server
 class RequestHandler;
 
 /// Represents a single connection from a client.
-class Connection : public std::enable_shared_from_this<Connection>
+///
+/// Connections are persistent if the client asks for it: requests are answered one after the
+/// other in the order they arrive, so pipelined requests that were already read are handled
+/// before reading from the socket again. The connection is closed after keep_alive_timeout
+/// without a request and after keep_alive_max_requests replies. Requests with a body larger than
+/// max_body_size are rejected.
+///
+/// If the request handler has a compute pool, requests are handled on it and the reply is
+/// written on the strand of the connection once it is done.
+///
+/// Connections are accepted on TCP sockets and, where the platform has them, on Unix domain
+/// sockets for clients on the same host. Requests of the latter have the loopback address.
+template <typename Protocol>
+class BasicConnection : public std::enable_shared_from_this<BasicConnection<Protocol>>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
-    Connection(const Connection &) = delete;
-    Connection &operator=(const Connection &) = delete;
+    using socket_type = typename Protocol::socket;
 
-    boost::asio::ip::tcp::socket &socket();
+    explicit BasicConnection(boost::asio::io_service &io_service,
+                             RequestHandler &handler,
+                             const unsigned keep_alive_timeout = 5,
+                             const unsigned keep_alive_max_requests = 512,
+                             const std::size_t max_body_size =
+                                 RequestParser::DEFAULT_MAX_BODY_SIZE);
+    BasicConnection(const BasicConnection &) = delete;
+    BasicConnection &operator=(const BasicConnection &) = delete;
+
+    socket_type &socket();
 
     /// Start the first asynchronous operation for the connection.
     void start();
@@ -49,23 +70,44 @@ class Connection : public std::enable_shared_from_this<Connection>
   private:
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Parses and answers the request in the given data or reads more data.
+    void process_data(char *begin, char *end);
+
+    /// Writes the reply to the handled request.
+    void write_reply();
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
-    std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
-                                       const http::compression_type compression_type);
+    /// Closes an idle connection.
+    void handle_timeout(const boost::system::error_code &e);
+
+    void read_some();
+
+    void shutdown();
 
     boost::asio::io_service::strand strand;
-    boost::asio::ip::tcp::socket TCP_socket;
+    socket_type TCP_socket;
+    boost::asio::deadline_timer timer;
     RequestHandler &request_handler;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
+    // already read data of the next pipelined request
+    char *unprocessed_begin;
+    char *unprocessed_end;
     http::request current_request;
     http::reply current_reply;
-    std::vector<char> compressed_output;
-    // Header compression_header;
     std::vector<boost::asio::const_buffer> output_buffer;
+    const unsigned keep_alive_timeout;
+    const unsigned keep_alive_max_requests;
+    unsigned processed_requests;
+    bool keep_alive;
 };
+
+using Connection = BasicConnection<boost::asio::ip::tcp>;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+using LocalConnection = BasicConnection<boost::asio::local::stream_protocol>;
+#endif
 }
 }
 
@@ -0,0 +1,91 @@
+#ifndef COMPRESSOR_HPP
+#define COMPRESSOR_HPP
+
+#include "server/http/compression_type.hpp"
+
+#include "util/buffer_chain.hpp"
+
+#include <zlib.h>
+
+#ifdef OSRM_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#ifdef OSRM_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <cstddef>
+#include <string>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+struct CompressionConfig
+{
+    // there's a trade-off between speed and size. speed wins
+    int gzip_level = Z_BEST_SPEED; // also used for deflate
+    int brotli_level = 1;
+    int zstd_level = 1;
+    // replies smaller than this are sent uncompressed. The size of a reply is only known if it
+    // fits into the first buffer of the content, so larger values act like one buffer size.
+    std::size_t min_size = 0;
+
+    static constexpr std::size_t MAX_MIN_SIZE = util::BufferChain::BUFFER_SIZE;
+};
+
+/// Picks the best content encoding of an Accept-Encoding header that this build supports,
+/// zstd over brotli over gzip over deflate. Encodings with a quality of zero are skipped.
+compression_type selectCompression(const std::string &accept_encoding);
+
+/// Value of the Content-Encoding header
+const char *toContentEncoding(const compression_type type);
+
+/// Incrementally compresses data with gzip, deflate, brotli or zstd into the buffers of a
+/// BufferChain, so the uncompressed content doesn't need to be kept in memory as a whole.
+class Compressor
+{
+  public:
+    Compressor(const compression_type type,
+               const CompressionConfig &config,
+               util::BufferChain &output);
+    ~Compressor();
+
+    Compressor(const Compressor &) = delete;
+    Compressor &operator=(const Compressor &) = delete;
+
+    void write(const char *data, const std::size_t size);
+
+    /// Writes the remaining compressed data and the trailer
+    void finish();
+
+  private:
+    void deflate(const char *data, const std::size_t size, const int flush);
+#ifdef OSRM_HAVE_BROTLI
+    void compressBrotli(const char *data,
+                        const std::size_t size,
+                        const BrotliEncoderOperation operation);
+#endif
+#ifdef OSRM_HAVE_ZSTD
+    void compressZstd(const char *data, const std::size_t size, const ZSTD_EndDirective mode);
+#endif
+
+    const compression_type type;
+    z_stream stream;
+#ifdef OSRM_HAVE_BROTLI
+    BrotliEncoderState *brotli_state = nullptr;
+#endif
+#ifdef OSRM_HAVE_ZSTD
+    ZSTD_CCtx *zstd_context = nullptr;
+#endif
+    util::BufferChain &output;
+};
+}
+}
+}
+
+#endif // COMPRESSOR_HPP
@@ -0,0 +1,70 @@
+#ifndef OSRM_SERVER_HTTP_HPACK_HPP
+#define OSRM_SERVER_HTTP_HPACK_HPP
+
+#include "server/http/header.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+/**
+ * Decodes the header blocks of HTTP/2 requests (RFC 7541).
+ *
+ * The decoder keeps the dynamic table of a connection, so all header blocks the client sends on
+ * it have to be decoded by the same instance in the order they arrived. The table never grows
+ * beyond the size announced in the SETTINGS of the server.
+ */
+class HPackDecoder
+{
+  public:
+    static const constexpr std::size_t DEFAULT_TABLE_SIZE = 4096;
+
+    explicit HPackDecoder(const std::size_t max_table_size = DEFAULT_TABLE_SIZE);
+
+    // Appends the headers of a complete header block, false if the block is malformed. The
+    // connection has to be closed then, the table is out of sync with the one of the client.
+    bool Decode(const char *begin, const char *end, std::vector<header> &headers);
+
+    std::size_t GetTableSize() const { return table_size; }
+
+  private:
+    // 1-based index into the static table followed by the dynamic table
+    bool Lookup(std::uint64_t index, std::string &name, std::string &value) const;
+    void Insert(const std::string &name, const std::string &value);
+    void Evict(std::size_t max_size);
+
+    // the newest entry comes first
+    std::deque<header> dynamic_table;
+    std::size_t table_size;
+    std::size_t current_max_table_size;
+    const std::size_t max_table_size;
+};
+
+// Appends a header as a literal that is not indexed, so replies don't need a table of their own
+// and the client doesn't keep them. Names are expected in lower case.
+void EncodeHeader(const std::string &name, const std::string &value, std::string &block);
+
+namespace detail
+{
+// Decodes an integer with a prefix of the given number of bits, false if the input ends or the
+// value overflows
+bool DecodeInteger(const char *&begin, const char *end, unsigned prefix_bits, std::uint64_t &value);
+// Appends an integer with a prefix, the bits above the prefix of the first byte are kept
+void EncodeInteger(std::uint64_t value, unsigned prefix_bits, char first_byte, std::string &output);
+// Decodes a Huffman encoded string, false if it is malformed
+bool DecodeHuffman(const char *begin, const char *end, std::string &output);
+}
+}
+}
+}
+
+#endif
@@ -3,8 +3,11 @@
 
 #include "server/http/header.hpp"
 
+#include "util/buffer_chain.hpp"
+
 #include <boost/asio.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace osrm
@@ -21,16 +24,26 @@ class reply
     {
         ok = 200,
         bad_request = 400,
-        internal_server_error = 500
+        internal_server_error = 500,
+        service_unavailable = 503,
+        gateway_timeout = 504
     } status;
 
     std::vector<header> headers;
     std::vector<boost::asio::const_buffer> to_buffers();
     std::vector<boost::asio::const_buffer> headers_to_buffers();
+    // the content, the content chain and the shared content without the status and the headers
+    std::vector<boost::asio::const_buffer> body_to_buffers();
     std::vector<char> content;
+    // large content is rendered into pooled buffers, it is sent after content
+    util::BufferChain content_chain;
+    // content that is shared with the replies of identical requests, it is sent last
+    std::shared_ptr<const util::BufferChain> shared_content;
     static reply stock_reply(const status_type status);
     void set_size(const std::size_t size);
     void set_uncompressed_size();
+    // resets the reply for the next request on the connection, keeps the allocated buffers
+    void clear();
 
     reply();
 
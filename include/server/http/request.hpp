@@ -1,6 +1,8 @@
 #ifndef REQUEST_HPP
 #define REQUEST_HPP
 
+#include "server/http/compression_type.hpp"
+
 #include <boost/asio.hpp>
 
 #include <string>
@@ -14,10 +16,38 @@ namespace http
 
 struct request
 {
+    std::string method;
     std::string uri;
     std::string referrer;
     std::string agent;
     boost::asio::ip::address endpoint;
+    // set from the HTTP version and the Connection header
+    bool keep_alive = false;
+    // selected from the Accept-Encoding header
+    compression_type compression = no_compression;
+    // milliseconds from the X-OSRM-Timeout header, 0 without one
+    unsigned timeout = 0;
+    // set by an X-OSRM-Trace: 1 header, the request is traced regardless of the sample rate
+    bool trace = false;
+    // the body of POST requests, as long as their Content-Length header
+    std::string content_type;
+    std::string body;
+
+    // resets the request for the next one on the connection, keeps the allocated strings
+    void clear()
+    {
+        method.clear();
+        uri.clear();
+        referrer.clear();
+        agent.clear();
+        endpoint = boost::asio::ip::address();
+        keep_alive = false;
+        compression = no_compression;
+        timeout = 0;
+        trace = false;
+        content_type.clear();
+        body.clear();
+    }
 };
 }
 }
@@ -0,0 +1,160 @@
+#ifndef HTTP2_CONNECTION_HPP
+#define HTTP2_CONNECTION_HPP
+
+#include "server/http/hpack.hpp"
+#include "server/http/reply.hpp"
+#include "server/http/request.hpp"
+#include "server/request_parser.hpp"
+
+#include <boost/array.hpp>
+#include <boost/asio.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+class RequestHandler;
+
+/// Represents a single HTTP/2 connection from a client (RFC 7540).
+///
+/// Only cleartext HTTP/2 is spoken and clients have to start with the connection preface right
+/// away ("prior knowledge"), there is no upgrade from HTTP/1.1. Every request is sent in a stream
+/// of its own and is handled on a thread of the io_service, or the compute pool of the request
+/// handler if it has one, as soon as it is complete, so the requests of a connection are handled
+/// concurrently and their replies are sent in the order they are done. Replies are split into
+/// DATA frames within the flow control windows of the client. The connection is closed after
+/// keep_alive_timeout without an open stream, 0 keeps it open. Streams with a body larger than
+/// max_body_size are rejected.
+class Http2Connection : public std::enable_shared_from_this<Http2Connection>
+{
+  public:
+    // streams beyond this are refused, the client learns it from the SETTINGS of the server
+    static const constexpr std::uint32_t MAX_CONCURRENT_STREAMS = 128;
+
+    explicit Http2Connection(boost::asio::io_service &io_service,
+                             RequestHandler &handler,
+                             const unsigned keep_alive_timeout = 5,
+                             const std::size_t max_body_size =
+                                 RequestParser::DEFAULT_MAX_BODY_SIZE);
+    Http2Connection(const Http2Connection &) = delete;
+    Http2Connection &operator=(const Http2Connection &) = delete;
+
+    boost::asio::ip::tcp::socket &socket();
+
+    /// Sends the SETTINGS of the server and starts reading frames.
+    void start();
+
+  private:
+    struct Stream
+    {
+        // set while the request is received
+        std::shared_ptr<http::request> request;
+        // set once the request was handled, the body is sent from it
+        std::shared_ptr<http::reply> reply;
+        std::vector<boost::asio::const_buffer> body;
+        std::size_t body_index = 0;
+        std::int64_t send_window = 0;
+        // waits in sending_streams for its next DATA frame
+        bool queued = false;
+    };
+
+    void read_some();
+    void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
+
+    /// Handles the complete frames of the input, false after a connection error.
+    bool process_input();
+    bool handle_frame(std::uint8_t type,
+                      std::uint8_t flags,
+                      std::uint32_t stream_id,
+                      const char *payload,
+                      std::size_t length);
+    bool handle_data(std::uint8_t flags,
+                     std::uint32_t stream_id,
+                     const char *payload,
+                     std::size_t length);
+    bool handle_headers(std::uint8_t flags,
+                        std::uint32_t stream_id,
+                        const char *payload,
+                        std::size_t length);
+    bool handle_settings(std::uint8_t flags,
+                         std::uint32_t stream_id,
+                         const char *payload,
+                         std::size_t length);
+    bool handle_window_update(std::uint32_t stream_id, const char *payload, std::size_t length);
+    /// Decodes the header block received in HEADERS and CONTINUATION frames.
+    bool end_header_block();
+
+    /// Hands the complete request of the stream to a thread of the io_service.
+    void dispatch(std::uint32_t stream_id);
+    void handle_reply(std::uint32_t stream_id, std::shared_ptr<http::reply> reply);
+
+    void reset_stream(std::uint32_t stream_id, std::uint32_t error_code);
+    /// Sends a GOAWAY and closes the connection once it is written, returns false.
+    bool go_away(std::uint32_t error_code);
+    void queue(std::uint32_t stream_id);
+
+    /// Writes the queued frames and the DATA frames the flow control windows allow.
+    void flush();
+    void handle_write(const boost::system::error_code &e);
+
+    bool is_idle() const;
+    void start_timer();
+    /// Closes an idle connection.
+    void handle_timeout(const boost::system::error_code &e);
+
+    void shutdown();
+
+    boost::asio::io_service &io_service;
+    boost::asio::io_service::strand strand;
+    boost::asio::ip::tcp::socket TCP_socket;
+    boost::asio::deadline_timer timer;
+    RequestHandler &request_handler;
+    http::HPackDecoder decoder;
+    boost::array<char, 8192> incoming_data_buffer;
+    // read data that doesn't hold a complete frame yet
+    std::vector<char> input;
+    bool preface_received;
+
+    // the header block that is continued in CONTINUATION frames
+    std::string header_block;
+    std::uint32_t header_stream_id;
+    bool header_end_stream;
+
+    std::unordered_map<std::uint32_t, Stream> streams;
+    std::uint32_t last_stream_id;
+    // requests that are handled right now, including the ones of reset streams
+    std::size_t handled_requests;
+    // streams with a body to send, DATA frames are sent for them in turn
+    std::deque<std::uint32_t> sending_streams;
+    std::int64_t send_window;
+    std::int64_t initial_window_size;
+    std::size_t max_frame_size;
+
+    // frames other than DATA that wait for the next write
+    std::string pending_frames;
+    // the data of the write in progress
+    std::deque<std::string> write_data;
+    std::vector<boost::asio::const_buffer> write_buffers;
+    std::vector<std::shared_ptr<http::reply>> write_replies;
+    bool writing;
+    // the client sent a GOAWAY, the open streams are finished before closing
+    bool closing;
+    // the server sent a GOAWAY, no more frames are read or sent
+    bool going_away;
+
+    const unsigned keep_alive_timeout;
+    const std::size_t max_body_size;
+};
+}
+}
+
+#endif // HTTP2_CONNECTION_HPP
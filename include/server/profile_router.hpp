@@ -0,0 +1,61 @@
+#ifndef SERVER_PROFILE_ROUTER_HPP
+#define SERVER_PROFILE_ROUTER_HPP
+
+#include "server/service_handler.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace server
+{
+
+// Dataset that answers the requests of a profile
+struct ProfileDataset
+{
+    std::string profile;
+    boost::filesystem::path base_path;
+
+    // Parses PROFILE=PATH, throws util::exception if it is malformed
+    static ProfileDataset FromString(const std::string &dataset);
+};
+
+/**
+ * Answers the requests of each profile of the URL, e.g. car in /route/v1/car/..., with the
+ * handler of its dataset, so a single server serves several datasets. The requests of all
+ * profiles share the threads of the server and its admission control, capacity goes to
+ * whichever profile gets the requests.
+ *
+ * Requests of profiles without a handler of their own go to the default handler if there is
+ * one and fail with InvalidProfile otherwise.
+ */
+class ProfileRouter final : public ServiceHandlerInterface
+{
+  public:
+    using ResultT = service::BaseService::ResultT;
+
+    explicit ProfileRouter(std::unique_ptr<ServiceHandlerInterface> default_handler = nullptr);
+
+    // Throws util::exception if the profile already has a handler
+    void AddProfile(const std::string &profile, std::unique_ptr<ServiceHandlerInterface> handler);
+
+    engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+
+    // Only the default dataset can be swapped in shared memory, the others are loaded once
+    std::shared_ptr<const void> GetDataset() const override
+    {
+        return default_handler ? default_handler->GetDataset() : nullptr;
+    }
+
+  private:
+    std::unordered_map<std::string, std::unique_ptr<ServiceHandlerInterface>> handlers;
+    std::unique_ptr<ServiceHandlerInterface> default_handler;
+};
+}
+}
+
+#endif // SERVER_PROFILE_ROUTER_HPP
@@ -0,0 +1,112 @@
+#ifndef SERVER_REQUEST_COALESCER_HPP
+#define SERVER_REQUEST_COALESCER_HPP
+
+#include "util/buffer_chain.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+// The headers and the rendered, possibly compressed content of a reply
+struct SharedReply
+{
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::shared_ptr<const util::BufferChain> content;
+};
+
+/**
+ * Lets identical requests that arrive while the first of them is handled wait for its reply
+ * instead of computing it again, e.g. the retries of clients during an incident.
+ *
+ * The first request of a key is the leader, it computes the reply and publishes it. The later
+ * ones follow it and send the same content. If the leader fails or doesn't publish, e.g. for
+ * errors that depend on the request like timeouts, the followers compute their replies
+ * themselves. Followers block their thread like requests that wait for admission.
+ */
+class RequestCoalescer
+{
+    struct Flight
+    {
+        std::mutex mutex;
+        std::condition_variable completed;
+        bool done = false;
+        std::shared_ptr<const SharedReply> reply;
+    };
+
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // Participation of a request in the computation of a key, completes it when the leader
+    // destroys its ticket
+    class Ticket
+    {
+      public:
+        Ticket(Ticket &&other) noexcept
+            : coalescer(other.coalescer), key(std::move(other.key)),
+              flight(std::move(other.flight)), leader(other.leader)
+        {
+            other.coalescer = nullptr;
+        }
+        Ticket &operator=(Ticket &&) = delete;
+        Ticket(const Ticket &) = delete;
+        Ticket &operator=(const Ticket &) = delete;
+
+        ~Ticket();
+
+        bool IsLeader() const { return leader; }
+
+        // Hands the reply to the followers, only the leader publishes
+        void Publish(std::shared_ptr<const SharedReply> reply);
+
+        // Waits until the leader is done or the time is over, the reply is empty if the
+        // follower has to compute it itself
+        std::shared_ptr<const SharedReply> Wait(const Clock::time_point until);
+
+      private:
+        friend class RequestCoalescer;
+        Ticket(RequestCoalescer *coalescer,
+               std::string key,
+               std::shared_ptr<Flight> flight,
+               const bool leader)
+            : coalescer(coalescer), key(std::move(key)), flight(std::move(flight)), leader(leader)
+        {
+        }
+
+        RequestCoalescer *coalescer;
+        std::string key;
+        std::shared_ptr<Flight> flight;
+        bool leader;
+    };
+
+    // Joins the computation of the request with the key or starts it
+    Ticket Join(std::string key);
+
+    // Number of requests that waited for the reply of an identical one in Prometheus text format
+    std::string DumpPrometheus() const;
+
+  private:
+    void Complete(const std::string &key,
+                  const std::shared_ptr<Flight> &flight,
+                  std::shared_ptr<const SharedReply> reply);
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights;
+    std::atomic<std::uint64_t> followers{0};
+    std::atomic<std::uint64_t> shared_replies{0};
+};
+}
+}
+
+#endif // SERVER_REQUEST_COALESCER_HPP
@@ -1,9 +1,18 @@
 #ifndef REQUEST_HANDLER_HPP
 #define REQUEST_HANDLER_HPP
 
+#include "engine/query_deadline.hpp"
+#include "server/admission_control.hpp"
+#include "server/compute_pool.hpp"
+#include "server/http/compressor.hpp"
+#include "server/request_coalescer.hpp"
+#include "server/response_cache.hpp"
 #include "server/service_handler.hpp"
+#include "util/request_trace.hpp"
 
+#include <memory>
 #include <string>
+#include <utility>
 
 namespace osrm
 {
@@ -16,6 +25,15 @@ class reply;
 struct request;
 }
 
+// How the access log line of a request is written
+enum class AccessLogFormat
+{
+    // Date, duration, client, referrer, agent, status and request separated by spaces
+    Plain,
+    // key=value pairs that log processors can parse without a custom pattern
+    Logfmt
+};
+
 class RequestHandler
 {
 
@@ -26,10 +44,99 @@ class RequestHandler
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler);
 
+    // Adds a Server-Timing header with the time spent in each stage of the request
+    void EnableServerTiming(const bool enable) { server_timing = enable; }
+
+    // Limits the concurrent requests per service, requests over the limits are rejected
+    void SetAdmissionControl(std::unique_ptr<AdmissionControl> admission_control_)
+    {
+        admission_control = std::move(admission_control_);
+    }
+
+    // Compression levels of the content encodings and the size below which replies are sent
+    // uncompressed
+    void SetCompression(const http::CompressionConfig &compression_)
+    {
+        compression = compression_;
+    }
+
+    // Lets identical requests in flight wait for the reply of the first one
+    void EnableRequestCoalescing(const bool enable)
+    {
+        coalescer = enable ? std::make_unique<RequestCoalescer>() : nullptr;
+    }
+
+    // Keeps the successful replies to answer repeated requests without parsing or running them
+    void SetResponseCache(std::unique_ptr<ResponseCache> response_cache_)
+    {
+        response_cache = std::move(response_cache_);
+    }
+
+    // Milliseconds after which the queries fail with a Timeout error, -1 for no limit. Clients
+    // can lower it with the X-OSRM-Timeout header.
+    void SetMaxQueryTime(const int max_query_time_) { max_query_time = max_query_time_; }
+
+    // Format of the access log and the share of successful requests that are logged, failed
+    // requests are always logged
+    void SetAccessLog(const AccessLogFormat format, const double sample_rate)
+    {
+        access_log_format = format;
+        access_log_sample_rate = sample_rate;
+    }
+
+    // Writes the stages of the sampled requests and those with an X-OSRM-Trace: 1 header to
+    // the trace, nullptr disables tracing
+    void SetTracing(std::shared_ptr<util::RequestTraceWriter> trace_writer_,
+                    const double sample_rate)
+    {
+        trace_writer = std::move(trace_writer_);
+        trace_sample_rate = sample_rate;
+    }
+
+    // Handles the requests on the threads of the pool instead of the threads of the server
+    void SetComputePool(std::unique_ptr<ComputePool> compute_pool_)
+    {
+        compute_pool = std::move(compute_pool_);
+    }
+
+    // nullptr if the requests are handled on the threads of the server
+    ComputePool *GetComputePool() const { return compute_pool.get(); }
+
+    // Priority of the request on the compute pool by its service
+    static ComputePriority GetPriority(const http::request &current_request);
+
     void HandleRequest(const http::request &current_request, http::reply &current_reply);
 
   private:
+    engine::QueryDeadline MakeDeadline(const unsigned timeout) const;
+
+    // Headers and content of the reply, compressed if the request accepts it
+    void RenderReply(const http::request &request,
+                     const ServiceHandler::ResultT &result,
+                     http::reply &reply) const;
+
+    AdmissionControl::Ticket Admit(const std::string &service) const;
+
+    // Durations of the handled requests in Prometheus text format
+    void HandleMetricsRequest(http::reply &current_reply) const;
+
+    bool IsAccessLogged(const http::reply &current_reply) const;
+
+    bool IsTraced(const http::request &current_request) const;
+
     std::unique_ptr<ServiceHandlerInterface> service_handler;
+    std::unique_ptr<AdmissionControl> admission_control;
+    std::unique_ptr<RequestCoalescer> coalescer;
+    std::unique_ptr<ResponseCache> response_cache;
+    http::CompressionConfig compression;
+    bool server_timing = false;
+    int max_query_time = -1;
+    AccessLogFormat access_log_format = AccessLogFormat::Plain;
+    double access_log_sample_rate = 1.0;
+    std::shared_ptr<util::RequestTraceWriter> trace_writer;
+    double trace_sample_rate = 0.0;
+    // destroyed first, it waits for the requests that are still handled
+    std::unique_ptr<ComputePool> compute_pool;
 };
 }
 }
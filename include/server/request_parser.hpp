@@ -4,6 +4,7 @@
 #include "server/http/compression_type.hpp"
 #include "server/http/header.hpp"
 
+#include <cstddef>
 #include <tuple>
 
 namespace osrm
@@ -19,7 +20,10 @@ struct request;
 class RequestParser
 {
   public:
-    RequestParser();
+    // bodies of POST requests above the maximal size make the request invalid
+    static const constexpr std::size_t DEFAULT_MAX_BODY_SIZE = 16 * 1024 * 1024;
+
+    explicit RequestParser(const std::size_t max_body_size = DEFAULT_MAX_BODY_SIZE);
 
     enum class RequestStatus : char
     {
@@ -28,9 +32,16 @@ class RequestParser
         indeterminate
     };
 
-    std::tuple<RequestStatus, http::compression_type>
+    /// Consumes input until a request is complete. The returned pointer is the end of the
+    /// consumed input, the rest belongs to the next request of a pipeline. A body announced by
+    /// the Content-Length header is appended to the body of the request as it arrives, in one
+    /// piece per call.
+    std::tuple<RequestStatus, http::compression_type, char *>
     parse(http::request &current_request, char *begin, char *end);
 
+    /// Prepares the parser for the next request on a persistent connection.
+    void reset();
+
   private:
     RequestStatus consume(http::request &current_request, const char input);
 
@@ -64,11 +75,16 @@ class RequestParser
         space_before_header_value,
         header_value,
         expecting_newline_2,
-        expecting_newline_3
+        expecting_newline_3,
+        body
     } state;
 
     http::header current_header;
     http::compression_type selected_compression;
+    unsigned http_version_major;
+    unsigned http_version_minor;
+    const std::size_t max_body_size;
+    std::size_t content_length;
 };
 }
 }
@@ -0,0 +1,113 @@
+#ifndef SERVER_RESPONSE_CACHE_HPP
+#define SERVER_RESPONSE_CACHE_HPP
+
+#include "engine/facade_epoch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+// A rendered, possibly compressed reply kept by the response cache
+struct CachedReply
+{
+    // of the request, the histograms of the service count the hits too
+    std::string service;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string content;
+};
+
+/**
+ * Keeps the successful replies of the server, so repeated requests skip parsing, the query and
+ * rendering. Replies are looked up by the decoded request and the content encoding.
+ *
+ * The content is copied into a string of its own instead of keeping the pooled buffers it was
+ * rendered into, so what the cache holds is what it counts against its capacity in bytes. Every
+ * shard evicts its least recently used replies once it is full. Replies expire after the time
+ * to live and are tagged with the epoch of the dataset they were computed on, see
+ * engine::FacadeEpoch. The whole cache is flushed once a new dataset is seen.
+ */
+class ResponseCache
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    ResponseCache(const std::size_t capacity,
+                  const std::chrono::seconds ttl,
+                  const std::size_t number_of_shards = 16);
+
+    // Returns the epoch of the dataset, flushes the replies of the older ones
+    unsigned GetEpoch(const std::shared_ptr<const void> &dataset);
+
+    // nullptr if there is no reply of the dataset or it expired
+    std::shared_ptr<const CachedReply>
+    Get(const unsigned epoch, const std::string &key, const Clock::time_point now = Clock::now());
+
+    // Replies larger than a shard are not kept
+    void Put(const unsigned epoch,
+             const std::string &key,
+             std::shared_ptr<const CachedReply> reply,
+             const Clock::time_point now = Clock::now());
+
+    void Clear();
+
+    // Bytes of the kept replies and their keys
+    std::size_t Size() const { return size; }
+
+    std::uint64_t Hits() const { return hits; }
+    std::uint64_t Misses() const { return misses; }
+
+    // Hits, misses and size in Prometheus text format
+    std::string DumpPrometheus() const;
+
+  private:
+    struct Entry
+    {
+        std::string key;
+        unsigned epoch;
+        Clock::time_point expires;
+        std::size_t size;
+        std::shared_ptr<const CachedReply> reply;
+    };
+
+    struct Shard
+    {
+        using EntryList = std::list<Entry>;
+
+        std::mutex mutex;
+        // the most recently used first
+        EntryList entries;
+        std::unordered_map<std::string, EntryList::iterator> index;
+        std::size_t size = 0;
+    };
+
+    Shard &GetShard(const std::string &key);
+
+    // needs the lock of the shard to be held
+    void Erase(Shard &shard, const Shard::EntryList::iterator entry);
+
+    const std::size_t shard_capacity;
+    const std::chrono::seconds ttl;
+    std::vector<std::unique_ptr<Shard>> shards;
+    engine::FacadeEpoch epoch;
+    std::atomic<unsigned> current_epoch{0};
+    std::atomic<std::size_t> size{0};
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+};
+}
+}
+
+#endif // SERVER_RESPONSE_CACHE_HPP
@@ -2,11 +2,13 @@
 #define SERVER_HPP
 
 #include "server/connection.hpp"
+#include "server/http2_connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
 
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/numa.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
@@ -16,8 +18,15 @@
 #ifndef _WIN32
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -33,48 +42,122 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                unsigned keep_alive_timeout = 5,
+                                                unsigned keep_alive_max_requests = 512,
+                                                bool reuse_port = false,
+                                                bool pin_threads = false)
     {
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        return std::make_shared<Server>(ip_address,
+                                        ip_port,
+                                        real_num_threads,
+                                        keep_alive_timeout,
+                                        keep_alive_max_requests,
+                                        reuse_port,
+                                        pin_threads);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    // With reuse_port every thread gets an io_service and an acceptor of its own that are bound
+    // to the same port, the kernel distributes the connections between them. Otherwise all
+    // threads run one io_service with one acceptor. pin_threads binds each thread to a core.
+    // Port 0 doesn't listen on TCP, for servers that only serve a Unix domain socket.
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const unsigned keep_alive_timeout = 5,
+                    const unsigned keep_alive_max_requests = 512,
+                    const bool reuse_port = false,
+                    const bool pin_threads = false)
+        : thread_pool_size(thread_pool_size), keep_alive_timeout(keep_alive_timeout),
+          keep_alive_max_requests(keep_alive_max_requests), pin_threads(pin_threads)
     {
-        const auto port_string = std::to_string(port);
+#ifndef SO_REUSEPORT
+        if (reuse_port)
+        {
+            util::Log(logWARNING) << "SO_REUSEPORT is not supported, all threads share an acceptor";
+        }
+        const unsigned num_listeners = 1;
+#else
+        const unsigned num_listeners = reuse_port ? std::max(1u, thread_pool_size) : 1;
+#endif
 
-        boost::asio::ip::tcp::resolver resolver(io_service);
-        boost::asio::ip::tcp::resolver::query query(address, port_string);
-        boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
+        for (unsigned i = 0; i < num_listeners; ++i)
+        {
+            listeners.push_back(std::make_unique<Listener>());
+        }
+        if (port == 0)
+        {
+            return;
+        }
 
-        acceptor.open(endpoint.protocol());
-#ifdef SO_REUSEPORT
-        const int option = 1;
-        setsockopt(acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
-#endif
-        acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        acceptor.bind(endpoint);
-        acceptor.listen();
+        const auto endpoint = Resolve(address, port);
+        for (auto &listener : listeners)
+        {
+            Listen(listener->acceptor, endpoint);
+            Accept(*listener);
+        }
 
-        util::Log() << "Listening on: " << acceptor.local_endpoint();
+        util::Log() << "Listening on: " << listeners.front()->acceptor.local_endpoint()
+                    << (num_listeners > 1
+                            ? " with " + std::to_string(num_listeners) + " acceptors"
+                            : std::string());
+    }
+
+    // Serves HTTP/2 to clients that know that the port speaks it, every listener gets an
+    // acceptor for the port so the connections are served by the same threads
+    void ListenHttp2(const std::string &address, const int port)
+    {
+        const auto endpoint = Resolve(address, port);
+        for (auto &listener : listeners)
+        {
+            listener->http2_acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(
+                listener->io_service);
+            Listen(*listener->http2_acceptor, endpoint);
+            AcceptHttp2(*listener);
+        }
+        util::Log() << "Listening for HTTP/2 on: "
+                    << listeners.front()->http2_acceptor->local_endpoint();
+    }
 
-        acceptor.async_accept(
-            new_connection->socket(),
-            boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    // Serves HTTP/1.1 on a Unix domain socket at the path, which saves clients on the same host
+    // the TCP handshakes and loopback overhead. A socket file left at the path is replaced. One
+    // acceptor hands the connections to the threads of all listeners in turn.
+    void ListenLocal(const std::string &path)
+    {
+        ::unlink(path.c_str());
+        const boost::asio::local::stream_protocol::endpoint endpoint(path);
+        auto &listener = *listeners.front();
+        local_acceptor =
+            std::make_unique<boost::asio::local::stream_protocol::acceptor>(listener.io_service);
+        local_acceptor->open(endpoint.protocol());
+        local_acceptor->bind(endpoint);
+        local_acceptor->listen();
+        local_path = path;
+        AcceptLocal();
+        util::Log() << "Listening on: " << path;
     }
+#endif
 
     void Run()
     {
         std::vector<std::shared_ptr<std::thread>> threads;
         for (unsigned i = 0; i < thread_pool_size; ++i)
         {
-            std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-                boost::bind(&boost::asio::io_service::run, &io_service));
+            auto &io_service = listeners[i % listeners.size()]->io_service;
+            std::shared_ptr<std::thread> thread =
+                std::make_shared<std::thread>([this, i, &io_service] {
+                    if (pin_threads)
+                    {
+                        PinThread(i);
+                    }
+                    io_service.run();
+                });
             threads.push_back(thread);
         }
         for (auto thread : threads)
@@ -83,30 +166,240 @@ class Server
         }
     }
 
-    void Stop() { io_service.stop(); }
+    void Stop()
+    {
+        for (auto &listener : listeners)
+        {
+            listener->io_service.stop();
+        }
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+        if (!local_path.empty())
+        {
+            ::unlink(local_path.c_str());
+        }
+#endif
+    }
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler_)
     {
         request_handler.RegisterServiceHandler(std::move(service_handler_));
     }
 
+    void EnableServerTiming(const bool enable) { request_handler.EnableServerTiming(enable); }
+
+    void SetAccessLog(const AccessLogFormat format, const double sample_rate)
+    {
+        request_handler.SetAccessLog(format, sample_rate);
+    }
+
+    void SetTracing(std::shared_ptr<util::RequestTraceWriter> trace_writer,
+                    const double sample_rate)
+    {
+        request_handler.SetTracing(std::move(trace_writer), sample_rate);
+    }
+
+    void SetCompression(const http::CompressionConfig &compression)
+    {
+        request_handler.SetCompression(compression);
+    }
+
+    void EnableRequestCoalescing(const bool enable)
+    {
+        request_handler.EnableRequestCoalescing(enable);
+    }
+
+    void SetResponseCache(std::unique_ptr<ResponseCache> response_cache)
+    {
+        request_handler.SetResponseCache(std::move(response_cache));
+    }
+
+    void SetMaxQueryTime(const int max_query_time)
+    {
+        request_handler.SetMaxQueryTime(max_query_time);
+    }
+
+    void SetAdmissionControl(std::unique_ptr<AdmissionControl> admission_control)
+    {
+        request_handler.SetAdmissionControl(std::move(admission_control));
+    }
+
+    void SetComputePool(std::unique_ptr<ComputePool> compute_pool)
+    {
+        request_handler.SetComputePool(std::move(compute_pool));
+    }
+
+    // applies to the connections accepted from now on
+    void SetMaxBodySize(const std::size_t size) { max_body_size = size; }
+
   private:
-    void HandleAccept(const boost::system::error_code &e)
+    struct Listener
+    {
+        Listener() : work(io_service), acceptor(io_service) {}
+
+        boost::asio::io_service io_service;
+        // keeps the threads running while no acceptor of the listener waits for connections
+        boost::asio::io_service::work work;
+        boost::asio::ip::tcp::acceptor acceptor;
+        std::shared_ptr<Connection> new_connection;
+        std::unique_ptr<boost::asio::ip::tcp::acceptor> http2_acceptor;
+        std::shared_ptr<Http2Connection> new_http2_connection;
+    };
+
+    static boost::asio::ip::tcp::endpoint Resolve(const std::string &address, const int port)
+    {
+        boost::asio::io_service resolver_service;
+        boost::asio::ip::tcp::resolver resolver(resolver_service);
+        boost::asio::ip::tcp::resolver::query query(address, std::to_string(port));
+        return *resolver.resolve(query);
+    }
+
+    static void Listen(boost::asio::ip::tcp::acceptor &acceptor,
+                       const boost::asio::ip::tcp::endpoint &endpoint)
+    {
+        acceptor.open(endpoint.protocol());
+#ifdef SO_REUSEPORT
+        const int option = 1;
+        setsockopt(acceptor.native_handle(), SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option));
+#endif
+        acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+        acceptor.bind(endpoint);
+        acceptor.listen();
+    }
+
+    void Accept(Listener &listener)
+    {
+        listener.new_connection = std::make_shared<Connection>(listener.io_service,
+                                                               request_handler,
+                                                               keep_alive_timeout,
+                                                               keep_alive_max_requests,
+                                                               max_body_size);
+        listener.acceptor.async_accept(listener.new_connection->socket(),
+                                       boost::bind(&Server::HandleAccept,
+                                                   this,
+                                                   boost::ref(listener),
+                                                   boost::asio::placeholders::error));
+    }
+
+    void HandleAccept(Listener &listener, const boost::system::error_code &e)
+    {
+        if (!e)
+        {
+            listener.new_connection->start();
+            Accept(listener);
+        }
+    }
+
+    void AcceptHttp2(Listener &listener)
+    {
+        listener.new_http2_connection = std::make_shared<Http2Connection>(
+            listener.io_service, request_handler, keep_alive_timeout, max_body_size);
+        listener.http2_acceptor->async_accept(listener.new_http2_connection->socket(),
+                                              boost::bind(&Server::HandleAcceptHttp2,
+                                                          this,
+                                                          boost::ref(listener),
+                                                          boost::asio::placeholders::error));
+    }
+
+    void HandleAcceptHttp2(Listener &listener, const boost::system::error_code &e)
     {
         if (!e)
         {
-            new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
-            acceptor.async_accept(
-                new_connection->socket(),
-                boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+            listener.new_http2_connection->start();
+            AcceptHttp2(listener);
         }
     }
 
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    void AcceptLocal()
+    {
+        auto &listener = *listeners[next_local_listener];
+        next_local_listener = (next_local_listener + 1) % listeners.size();
+        new_local_connection = std::make_shared<LocalConnection>(listener.io_service,
+                                                                 request_handler,
+                                                                 keep_alive_timeout,
+                                                                 keep_alive_max_requests,
+                                                                 max_body_size);
+        local_acceptor->async_accept(
+            new_local_connection->socket(),
+            boost::bind(&Server::HandleAcceptLocal, this, boost::asio::placeholders::error));
+    }
+
+    void HandleAcceptLocal(const boost::system::error_code &e)
+    {
+        if (!e)
+        {
+            new_local_connection->start();
+            AcceptLocal();
+        }
+    }
+#endif
+
+    // Binds the calling thread to a core it is allowed to run on, so its search heaps are
+    // allocated on the NUMA node of that core and stay there. Consecutive threads go to
+    // different nodes, so every copy of the data that osrm-datastore placed on a node is used.
+    static void PinThread(const unsigned index)
+    {
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+        {
+            util::Log(logWARNING) << "Could not get the cores a thread can run on";
+            return;
+        }
+
+        std::vector<std::vector<int>> node_cpus;
+        for (const auto node : util::GetNUMANodes())
+        {
+            std::vector<int> cpus;
+            for (const auto cpu : util::GetNUMANodeCPUs(node))
+            {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                    cpus.push_back(static_cast<int>(cpu));
+            }
+            if (!cpus.empty())
+                node_cpus.push_back(std::move(cpus));
+        }
+
+        // without a known topology all allowed cores count as one node
+        if (node_cpus.empty())
+        {
+            node_cpus.emplace_back();
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &allowed))
+                    node_cpus.back().push_back(cpu);
+            }
+        }
+
+        const auto &cpus = node_cpus[index % node_cpus.size()];
+        const auto cpu = cpus[(index / node_cpus.size()) % cpus.size()];
+
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        CPU_SET(cpu, &pinned);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned) != 0)
+        {
+            util::Log(logWARNING) << "Could not pin a server thread to core " << cpu;
+        }
+#else
+        (void)index;
+        util::Log(logWARNING) << "Pinning threads to cores is only supported on Linux";
+#endif
+    }
+
     unsigned thread_pool_size;
-    boost::asio::io_service io_service;
-    boost::asio::ip::tcp::acceptor acceptor;
-    std::shared_ptr<Connection> new_connection;
+    unsigned keep_alive_timeout;
+    unsigned keep_alive_max_requests;
+    std::size_t max_body_size = RequestParser::DEFAULT_MAX_BODY_SIZE;
+    bool pin_threads;
+    std::vector<std::unique_ptr<Listener>> listeners;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    std::unique_ptr<boost::asio::local::stream_protocol::acceptor> local_acceptor;
+    std::shared_ptr<LocalConnection> new_local_connection;
+    std::size_t next_local_listener = 0;
+    std::string local_path;
+#endif
     RequestHandler request_handler;
 };
 }
@@ -1,13 +1,20 @@
 #ifndef SERVER_SERVICE_BASE_SERVICE_HPP
 #define SERVER_SERVICE_BASE_SERVICE_HPP
 
+#include "server/api/body_parser.hpp"
+
+#include "engine/api/base_parameters.hpp"
+#include "engine/api/binary_builder.hpp"
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
 #include "util/coordinate.hpp"
+#include "util/request_timing.hpp"
 
+#include <boost/optional.hpp>
 #include <mapbox/variant.hpp>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -17,20 +24,54 @@ namespace server
 namespace service
 {
 
+// Response that was already rendered to JSON text by the engine
+struct RenderedJSON
+{
+    std::string value;
+};
+
+// Response in the binary format of engine/api/binary_format.hpp
+struct RenderedBinary
+{
+    std::string value;
+};
+
 class BaseService
 {
   public:
-    using ResultT = mapbox::util::variant<util::json::Object, std::string>;
+    // json::Object and RenderedJSON are sent as JSON, std::string as protobuf
+    using ResultT =
+        mapbox::util::variant<util::json::Object, std::string, RenderedJSON, RenderedBinary>;
 
     BaseService(OSRM &routing_machine) : routing_machine(routing_machine) {}
     virtual ~BaseService() = default;
 
-    virtual engine::Status
-    RunQuery(std::size_t prefix_length, std::string &query, ResultT &result) = 0;
+    // The body of the request is moved into the parameters of the query, the deadline is handed
+    // to them
+    virtual engine::Status RunQuery(std::size_t prefix_length,
+                                    std::string &query,
+                                    boost::optional<api::BodyParameters> &body,
+                                    const engine::QueryDeadline &deadline,
+                                    ResultT &result) = 0;
 
     virtual unsigned GetVersion() = 0;
 
   protected:
+    // Encodes a json::Object result in the binary format if the parameters ask for it
+    static engine::Status FormatResult(const engine::api::BaseParameters &parameters,
+                                       const engine::Status status,
+                                       ResultT &result)
+    {
+        if (parameters.format == engine::api::OutputFormatType::Binary)
+        {
+            util::ScopedStageTimer render_timer(util::RequestStage::Render);
+            RenderedBinary binary_result;
+            engine::api::binary::encode(result.get<util::json::Object>(), binary_result.value);
+            result = std::move(binary_result);
+        }
+        return status;
+    }
+
     OSRM &routing_machine;
 };
 }
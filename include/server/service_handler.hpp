@@ -5,6 +5,7 @@
 
 #include "osrm/osrm.hpp"
 
+#include <memory>
 #include <unordered_map>
 
 namespace osrm
@@ -29,6 +30,9 @@ class ServiceHandlerInterface
     virtual ~ServiceHandlerInterface() {}
     virtual engine::Status RunQuery(api::ParsedURL parsed_url,
                                     service::BaseService::ResultT &result) = 0;
+    // Dataset the queries run on, see OSRM::GetDataset(). Handlers that don't answer from a
+    // dataset of their own have none.
+    virtual std::shared_ptr<const void> GetDataset() const { return nullptr; }
 };
 
 class ServiceHandler final : public ServiceHandlerInterface
@@ -39,6 +43,11 @@ class ServiceHandler final : public ServiceHandlerInterface
 
     virtual engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
 
+    std::shared_ptr<const void> GetDataset() const override
+    {
+        return routing_machine.GetDataset();
+    }
+
   private:
     std::unordered_map<std::string, std::unique_ptr<service::BaseService>> service_map;
     OSRM routing_machine;
@@ -0,0 +1,83 @@
+#ifndef SERVER_SHARD_ROUTER_HPP
+#define SERVER_SHARD_ROUTER_HPP
+
+#include "server/backend_client.hpp"
+#include "server/service_handler.hpp"
+
+#include "util/coordinate.hpp"
+
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+// Backend with a regional dataset that owns the coordinates within a bounding box
+struct Shard
+{
+    std::string name;
+    util::Coordinate south_west;
+    util::Coordinate north_east;
+    Backend backend;
+
+    // Parses NAME=MIN_LON,MIN_LAT,MAX_LON,MAX_LAT@HOST:PORT, throws util::exception if it is
+    // malformed
+    static Shard FromString(const std::string &shard);
+
+    bool Contains(const util::Coordinate coordinate) const
+    {
+        return coordinate.lon >= south_west.lon && coordinate.lon <= north_east.lon &&
+               coordinate.lat >= south_west.lat && coordinate.lat <= north_east.lat;
+    }
+};
+
+/**
+ * Passes every request on to the backend owning its coordinates instead of answering it from
+ * a dataset, so a large region can be served by several smaller instances.
+ *
+ * A request goes to the smallest shard whose bounding box contains all of its coordinates and
+ * to the fallback backend, e.g. with a coarse dataset of the whole region, if none does. The
+ * datasets of the shards should extend beyond their boxes so routes between coordinates close
+ * to a border don't have to leave the dataset. Requests without coordinates, like tiles, and
+ * requests that can't be parsed go to the fallback as well, or the first shard if there is no
+ * fallback.
+ *
+ * The backend is queried from the server thread of the request, which waits up to the timeout
+ * for its reply. Replies other than 200 and 400 as well as unreachable backends are reported as
+ * server errors.
+ */
+class ShardRouter final : public ServiceHandlerInterface
+{
+  public:
+    using ResultT = service::BaseService::ResultT;
+
+    ShardRouter(std::vector<Shard> shards,
+                boost::optional<Backend> fallback,
+                const std::chrono::milliseconds timeout);
+
+    engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+
+    // Backend that owns all coordinates, nullptr if there is none
+    const Backend *SelectBackend(const std::vector<util::Coordinate> &coordinates) const;
+
+  private:
+    // as a POST request if the body is not empty
+    engine::Status Forward(const Backend &backend,
+                           const std::string &uri,
+                           const std::string &body,
+                           ResultT &result) const;
+
+    // sorted by the area of their bounding boxes, the smallest first
+    std::vector<Shard> shards;
+    boost::optional<Backend> fallback;
+    const std::chrono::milliseconds timeout;
+};
+}
+}
+
+#endif // SERVER_SHARD_ROUTER_HPP
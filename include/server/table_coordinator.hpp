@@ -0,0 +1,63 @@
+#ifndef SERVER_TABLE_COORDINATOR_HPP
+#define SERVER_TABLE_COORDINATOR_HPP
+
+#include "server/backend_client.hpp"
+#include "server/service_handler.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+/**
+ * Splits table requests with more entries than a threshold into blocks of source rows that
+ * peers with the same dataset compute at the same time, so a table can be larger than one
+ * host computes in time. All other requests are answered by the local handler.
+ *
+ * The coordinator snaps all coordinates on its own dataset with a table of a single row whose
+ * searches stop right away, and sends the hints along with every block so the peers skip the
+ * nearest neighbour searches. The peers reply in the binary format and their rows are copied
+ * into the response in the order of the sources. The hints of the replies carry the checksum
+ * of the dataset of each peer, a peer with another dataset fails the request.
+ *
+ * Peers are queried from the server thread of the request like the backends of ShardRouter and
+ * get the remaining time of the request as their timeout. Errors of a peer, e.g. a block that
+ * exceeds its --max-table-size, are passed on to the client. Peers shouldn't be coordinators
+ * themselves.
+ */
+class TableCoordinator final : public ServiceHandlerInterface
+{
+  public:
+    using ResultT = service::BaseService::ResultT;
+
+    // block_rows is the maximal number of source rows per block, 0 splits the rows evenly
+    // among the peers
+    TableCoordinator(std::unique_ptr<ServiceHandlerInterface> local_handler,
+                     std::vector<Backend> peers,
+                     const std::size_t min_entries,
+                     const std::size_t block_rows,
+                     const std::chrono::milliseconds timeout);
+
+    engine::Status RunQuery(api::ParsedURL parsed_url, ResultT &result) override;
+
+    std::shared_ptr<const void> GetDataset() const override
+    {
+        return local_handler->GetDataset();
+    }
+
+  private:
+    std::unique_ptr<ServiceHandlerInterface> local_handler;
+    const std::vector<Backend> peers;
+    const std::size_t min_entries;
+    const std::size_t block_rows;
+    const std::chrono::milliseconds timeout;
+};
+}
+}
+
+#endif // SERVER_TABLE_COORDINATOR_HPP
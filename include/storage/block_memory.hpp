@@ -0,0 +1,36 @@
+#ifndef OSRM_STORAGE_BLOCK_MEMORY_HPP
+#define OSRM_STORAGE_BLOCK_MEMORY_HPP
+
+#include "storage/shared_datatype.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+
+// Memory taken by a block of the data layout
+struct BlockMemory
+{
+    DataLayout::BlockID id;
+    // all bytes of the block are mapped into the process
+    std::uint64_t bytes;
+    // bytes on pages that are in RAM, the others were never touched or are swapped out
+    std::uint64_t resident_bytes;
+    // used from a mapping of its file instead of the memory block
+    bool external;
+};
+
+// Memory of the non-empty blocks of the layout whose memory block starts at memory, the
+// largest blocks first. Residency is measured without touching the blocks.
+std::vector<BlockMemory> getBlockMemory(const DataLayout &layout, char *memory);
+
+// Logs the blocks and their totals, one line each, with the name of the dataset if it has one
+void logBlockMemory(const std::vector<BlockMemory> &blocks, const std::string &dataset_name);
+}
+}
+
+#endif
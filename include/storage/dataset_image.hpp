@@ -0,0 +1,110 @@
+#ifndef OSRM_STORAGE_DATASET_IMAGE_HPP
+#define OSRM_STORAGE_DATASET_IMAGE_HPP
+
+#include "storage/io.hpp"
+#include "storage/shared_datatype.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+
+// A dataset image (.osrm.image, written by osrm-pack) holds the memory block of a dataset as
+// Storage::PopulateData lays it out, so it is loaded with a single read or used from a mapping:
+//  - the fingerprint
+//  - the DataLayout with the number, size and alignment of the entries of all blocks
+//  - the size of the memory block
+//  - zeros up to IMAGE_DATA_OFFSET
+//  - the memory block with the canaries and the padding of the blocks
+// The blocks are aligned relative to the start of the memory block, so it can be used at every
+// address that is aligned for all blocks.
+const constexpr std::uint64_t IMAGE_DATA_OFFSET = 4096;
+
+static_assert(sizeof(util::FingerPrint) + sizeof(DataLayout) + sizeof(std::uint64_t) <=
+                  IMAGE_DATA_OFFSET,
+              "The header of the image has to fit in front of the memory block");
+
+// Largest alignment of the entries of a block, which the memory block has to be aligned for
+inline std::size_t getMemoryAlignment(const DataLayout &layout)
+{
+    return *std::max_element(layout.entry_align.begin(), layout.entry_align.end());
+}
+
+inline void checkImageMemory(const boost::filesystem::path &path,
+                             const DataLayout &layout,
+                             const char *memory)
+{
+    if (reinterpret_cast<std::uintptr_t>(memory) % getMemoryAlignment(layout) != 0)
+    {
+        throw util::exception("Memory for the image " + path.string() +
+                              " is not aligned for its blocks" + SOURCE_REF);
+    }
+}
+
+// Reads the layout of the memory block of the image
+inline DataLayout readImageLayout(const boost::filesystem::path &path)
+{
+    io::FileReader reader(path, io::FileReader::VerifyFingerprint);
+    const auto layout = reader.ReadOne<DataLayout>();
+    const auto memory_size = reader.ReadOne<std::uint64_t>();
+    if (memory_size != layout.GetSizeOfLayout() ||
+        reader.GetSize() + sizeof(util::FingerPrint) < IMAGE_DATA_OFFSET + memory_size)
+    {
+        throw util::exception("The image " + path.string() + " is truncated or corrupted" +
+                              SOURCE_REF);
+    }
+    return layout;
+}
+
+// Reads the memory block of the image with the layout of readImageLayout
+inline void
+readImageMemory(const boost::filesystem::path &path, const DataLayout &layout, char *memory)
+{
+    checkImageMemory(path, layout, memory);
+
+    io::FileReader reader(path, io::FileReader::VerifyFingerprint);
+    reader.Skip<char>(IMAGE_DATA_OFFSET - sizeof(util::FingerPrint));
+    reader.ReadInto(memory, layout.GetSizeOfLayout());
+}
+
+// Writes the memory block that was populated for the layout, none of its blocks can be
+// external
+inline void
+writeImage(const boost::filesystem::path &path, const DataLayout &layout, const char *memory)
+{
+    for (const auto id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+    {
+        if (layout.IsExternalBlock(static_cast<DataLayout::BlockID>(id)))
+        {
+            throw util::exception("Can't write the mapped block " +
+                                  std::string(block_id_to_name[id]) + " into an image" +
+                                  SOURCE_REF);
+        }
+    }
+    checkImageMemory(path, layout, memory);
+
+    io::FileWriter writer(path, io::FileWriter::GenerateFingerprint);
+    writer.WriteOne(layout);
+    writer.WriteOne<std::uint64_t>(layout.GetSizeOfLayout());
+    const std::vector<char> padding(IMAGE_DATA_OFFSET - sizeof(util::FingerPrint) -
+                                        sizeof(DataLayout) - sizeof(std::uint64_t),
+                                    0);
+    writer.WriteFrom(padding);
+    writer.WriteFrom(memory, layout.GetSizeOfLayout());
+}
+}
+}
+
+#endif
@@ -4,16 +4,20 @@
 #include "osrm/error_codes.hpp"
 
 #include "util/exception.hpp"
+#include "util/compressed_file.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/log.hpp"
+#include "util/parallel_io.hpp"
 #include "util/version.hpp"
 
 #include <boost/filesystem/fstream.hpp>
 #include <boost/iostreams/seek.hpp>
 
+#include <atomic>
 #include <cerrno>
 #include <cstring>
+#include <memory>
 #include <tuple>
 #include <type_traits>
 
@@ -59,6 +63,12 @@ class FileReader
             throw util::RuntimeError(
                 filepath.string(), ErrorCode::FileOpenError, SOURCE_REF, std::strerror(errno));
 
+        // compressed files are read through their reader at positions of the uncompressed file
+        if (util::IsCompressedFile(filepath))
+        {
+            compressed_reader = std::make_unique<util::CompressedFileReader>(filepath);
+        }
+
         if (flag == VerifyFingerprint && !ReadAndCheckFingerprint())
         {
             throw util::RuntimeError(filepath.string(), ErrorCode::InvalidFingerprint, SOURCE_REF);
@@ -67,6 +77,14 @@ class FileReader
 
     std::size_t GetSize()
     {
+        if (compressed_reader)
+        {
+            const auto file_size = compressed_reader->GetSize();
+            return fingerprint == FingerprintFlag::VerifyFingerprint
+                       ? file_size - sizeof(util::FingerPrint)
+                       : file_size;
+        }
+
         const boost::filesystem::ifstream::pos_type positon = input_stream.tellg();
         input_stream.seekg(0, std::ios::end);
         const boost::filesystem::ifstream::pos_type file_size = input_stream.tellg();
@@ -93,6 +111,16 @@ class FileReader
         }
     }
 
+    // Offset of the next read from the start of the file, including the fingerprint
+    std::uint64_t GetPosition()
+    {
+        return compressed_reader ? compressed_position
+                                 : static_cast<std::uint64_t>(input_stream.tellg());
+    }
+
+    // Whether the file is compressed, its blocks can then not be mapped into memory
+    bool IsCompressed() const { return static_cast<bool>(compressed_reader); }
+
     /* Read count objects of type T into pointer dest */
     template <typename T> void ReadInto(T *dest, const std::size_t count)
     {
@@ -105,6 +133,35 @@ class FileReader
         if (count == 0)
             return;
 
+        if (compressed_reader)
+        {
+            if (compressed_position + count * sizeof(T) > compressed_reader->GetSize())
+            {
+                throw util::RuntimeError(
+                    filepath.string(), ErrorCode::UnexpectedEndOfFile, SOURCE_REF);
+            }
+            compressed_reader->Read(
+                compressed_position, reinterpret_cast<char *>(dest), count * sizeof(T));
+            compressed_position += count * sizeof(T);
+            return;
+        }
+
+        // large blocks are read in slices from a few threads
+        if (count * sizeof(T) >= util::PARALLEL_IO_THRESHOLD)
+        {
+            const auto position = GetPosition();
+            if (util::ParallelRead(filepath,
+                                   position,
+                                   reinterpret_cast<char *>(dest),
+                                   count * sizeof(T),
+                                   DirectIO()))
+            {
+                input_stream.seekg(position + count * sizeof(T), std::ios::beg);
+                return;
+            }
+            // the stream reports why the block could not be read
+        }
+
         const auto &result = input_stream.read(reinterpret_cast<char *>(dest), count * sizeof(T));
         const std::size_t bytes_read = input_stream.gcount();
 
@@ -136,6 +193,11 @@ class FileReader
 
     template <typename T> void Skip(const std::size_t element_count)
     {
+        if (compressed_reader)
+        {
+            compressed_position += element_count * sizeof(T);
+            return;
+        }
         boost::iostreams::seek(input_stream, element_count * sizeof(T), BOOST_IOS::cur);
     }
 
@@ -175,10 +237,22 @@ class FileReader
         return true;
     }
 
+    // Reads large blocks of all readers past the page cache if the file system supports it,
+    // for data that is read once into memory of its own like the shared memory of a datastore
+    static void UseDirectIO(const bool use_direct_io) { DirectIO() = use_direct_io; }
+
   private:
+    static std::atomic<bool> &DirectIO()
+    {
+        static std::atomic<bool> direct_io{false};
+        return direct_io;
+    }
+
     const boost::filesystem::path filepath;
     boost::filesystem::ifstream input_stream;
     FingerprintFlag fingerprint;
+    std::unique_ptr<util::CompressedFileReader> compressed_reader;
+    std::uint64_t compressed_position = 0;
 };
 
 class FileWriter
@@ -222,6 +296,23 @@ class FileWriter
         if (count == 0)
             return;
 
+        // large blocks are written in slices from a few threads, after what the stream buffered
+        if (count * sizeof(T) >= util::PARALLEL_IO_THRESHOLD && output_stream.flush())
+        {
+            const auto position = static_cast<std::uint64_t>(output_stream.tellp());
+            if (util::ParallelWrite(filepath,
+                                    position,
+                                    reinterpret_cast<const char *>(src),
+                                    count * sizeof(T)))
+            {
+                output_stream.seekp(position + count * sizeof(T), std::ios::beg);
+                if (output_stream)
+                    return;
+            }
+            output_stream.clear();
+            output_stream.seekp(position, std::ios::beg);
+        }
+
         const auto &result =
             output_stream.write(reinterpret_cast<const char *>(src), count * sizeof(T));
 
@@ -7,6 +7,7 @@
 
 #include "storage/io.hpp"
 
+#include <cmath>
 #include <cstdint>
 
 namespace osrm
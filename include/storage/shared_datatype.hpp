@@ -19,17 +19,14 @@ namespace storage
 const constexpr char CANARY[4] = {'O', 'S', 'R', 'M'};
 
 const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
-                                            "GEOMETRY_ID_LIST",
-                                            "NAME_ID_LIST",
+                                            "EDGE_BASED_NODE_LIST",
                                             "COMPONENT_ID_LIST",
-                                            "TRAVEL_MODE_LIST",
-                                            "CLASSES_LIST",
                                             "CH_GRAPH_NODE_LIST",
                                             "CH_GRAPH_EDGE_LIST",
                                             "COORDINATE_LIST",
                                             "OSM_NODE_ID_LIST",
-                                            "TURN_INSTRUCTION",
-                                            "ENTRY_CLASSID",
+                                            "TURN_DATA_ID",
+                                            "TURN_DATA",
                                             "R_SEARCH_TREE",
                                             "R_SEARCH_TREE_LEVELS",
                                             "GEOMETRIES_INDEX",
@@ -50,9 +47,6 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "BEARING_BLOCKS",
                                             "BEARING_VALUES",
                                             "ENTRY_CLASS",
-                                            "LANE_DATA_ID",
-                                            "PRE_TURN_BEARING",
-                                            "POST_TURN_BEARING",
                                             "TURN_LANE_DATA",
                                             "LANE_DESCRIPTION_OFFSETS",
                                             "LANE_DESCRIPTION_MASKS",
@@ -67,26 +61,50 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "MLD_CELL_DESTINATION_BOUNDARY",
                                             "MLD_CELLS",
                                             "MLD_CELL_LEVEL_OFFSETS",
+                                            "MLD_CELL_METRIC_NAMES",
                                             "MLD_GRAPH_NODE_LIST",
                                             "MLD_GRAPH_EDGE_LIST",
-                                            "MLD_GRAPH_NODE_TO_OFFSET"};
+                                            "MLD_GRAPH_NODE_TO_OFFSET",
+                                            "CCH_GRAPH_NODE_LIST",
+                                            "CCH_GRAPH_EDGE_LIST",
+                                            "MLD_OVERLAY_NODES",
+                                            "MLD_OVERLAY_FORWARD_OFFSETS",
+                                            "MLD_OVERLAY_FORWARD_ARCS",
+                                            "MLD_OVERLAY_BACKWARD_OFFSETS",
+                                            "MLD_OVERLAY_BACKWARD_ARCS",
+                                            "LANDMARK_NODES",
+                                            "LANDMARK_UNITS",
+                                            "LANDMARK_DISTANCES",
+                                            "CONDITIONAL_TURN_IDS",
+                                            "CONDITIONAL_TURN_SOURCES",
+                                            "CONDITIONAL_TURN_TARGETS",
+                                            "CONDITIONAL_TURN_MASKS",
+                                            "CH_COMPRESSED_GRAPH_OFFSETS",
+                                            "CH_COMPRESSED_GRAPH_EDGES",
+                                            "R_SEARCH_TREE_LEAF_ACCESS",
+                                            "R_SEARCH_TREE_LEAVES",
+                                            "DISTANCE_ORACLE_REPRESENTATIVES",
+                                            "DISTANCE_ORACLE_CELLS",
+                                            "DISTANCE_ORACLE_NODE_DURATIONS",
+                                            "DISTANCE_ORACLE_CELL_DURATIONS",
+                                            "CH_HUB_LABEL_OFFSETS",
+                                            "CH_HUB_LABEL_HUBS",
+                                            "CH_HUB_LABEL_WEIGHTS",
+                                            "CH_HUB_LABEL_DURATIONS"};
 
 struct DataLayout
 {
     enum BlockID
     {
         NAME_CHAR_DATA = 0,
-        GEOMETRY_ID_LIST,
-        NAME_ID_LIST,
+        EDGE_BASED_NODE_LIST,
         COMPONENT_ID_LIST,
-        TRAVEL_MODE_LIST,
-        CLASSES_LIST,
         CH_GRAPH_NODE_LIST,
         CH_GRAPH_EDGE_LIST,
         COORDINATE_LIST,
         OSM_NODE_ID_LIST,
-        TURN_INSTRUCTION,
-        ENTRY_CLASSID,
+        TURN_DATA_ID,
+        TURN_DATA,
         R_SEARCH_TREE,
         R_SEARCH_TREE_LEVELS,
         GEOMETRIES_INDEX,
@@ -107,9 +125,6 @@ struct DataLayout
         BEARING_BLOCKS,
         BEARING_VALUES,
         ENTRY_CLASS,
-        LANE_DATA_ID,
-        PRE_TURN_BEARING,
-        POST_TURN_BEARING,
         TURN_LANE_DATA,
         LANE_DESCRIPTION_OFFSETS,
         LANE_DESCRIPTION_MASKS,
@@ -124,17 +139,52 @@ struct DataLayout
         MLD_CELL_DESTINATION_BOUNDARY,
         MLD_CELLS,
         MLD_CELL_LEVEL_OFFSETS,
+        MLD_CELL_METRIC_NAMES,
         MLD_GRAPH_NODE_LIST,
         MLD_GRAPH_EDGE_LIST,
         MLD_GRAPH_NODE_TO_OFFSET,
+        CCH_GRAPH_NODE_LIST,
+        CCH_GRAPH_EDGE_LIST,
+        MLD_OVERLAY_NODES,
+        MLD_OVERLAY_FORWARD_OFFSETS,
+        MLD_OVERLAY_FORWARD_ARCS,
+        MLD_OVERLAY_BACKWARD_OFFSETS,
+        MLD_OVERLAY_BACKWARD_ARCS,
+        LANDMARK_NODES,
+        LANDMARK_UNITS,
+        LANDMARK_DISTANCES,
+        CONDITIONAL_TURN_IDS,
+        CONDITIONAL_TURN_SOURCES,
+        CONDITIONAL_TURN_TARGETS,
+        CONDITIONAL_TURN_MASKS,
+        CH_COMPRESSED_GRAPH_OFFSETS,
+        CH_COMPRESSED_GRAPH_EDGES,
+        R_SEARCH_TREE_LEAF_ACCESS,
+        R_SEARCH_TREE_LEAVES,
+        DISTANCE_ORACLE_REPRESENTATIVES,
+        DISTANCE_ORACLE_CELLS,
+        DISTANCE_ORACLE_NODE_DURATIONS,
+        DISTANCE_ORACLE_CELL_DURATIONS,
+        CH_HUB_LABEL_OFFSETS,
+        CH_HUB_LABEL_HUBS,
+        CH_HUB_LABEL_WEIGHTS,
+        CH_HUB_LABEL_DURATIONS,
         NUM_BLOCKS
     };
 
     std::array<std::uint64_t, NUM_BLOCKS> num_entries;
     std::array<std::size_t, NUM_BLOCKS> entry_size;
     std::array<std::size_t, NUM_BLOCKS> entry_align;
+    // Blocks that are used from a mapping of their file instead of the memory block. Only
+    // layouts that never leave the process set them, the layout in shared memory has none.
+    std::array<const char *, NUM_BLOCKS> external_blocks;
+    // Identifies the state of the file each block was loaded from, 0 if there is none
+    std::array<std::uint64_t, NUM_BLOCKS> source_stamps;
 
-    DataLayout() : num_entries(), entry_size(), entry_align() {}
+    DataLayout()
+        : num_entries(), entry_size(), entry_align(), external_blocks(), source_stamps()
+    {
+    }
 
     template <typename T> inline void SetBlockSize(BlockID bid, uint64_t entries)
     {
@@ -146,6 +196,15 @@ struct DataLayout
 
     inline uint64_t GetBlockEntries(BlockID bid) const { return num_entries[bid]; }
 
+    // True if the block of the other layout was loaded from the same state of the same file
+    inline bool HasSameBlock(const DataLayout &other, BlockID bid) const
+    {
+        return source_stamps[bid] != 0 && source_stamps[bid] == other.source_stamps[bid] &&
+               num_entries[bid] == other.num_entries[bid] &&
+               entry_size[bid] == other.entry_size[bid] &&
+               entry_align[bid] == other.entry_align[bid];
+    }
+
     inline uint64_t GetBlockSize(BlockID bid) const
     {
         // special bit encoding
@@ -156,13 +215,23 @@ struct DataLayout
         return num_entries[bid] * entry_size[bid];
     }
 
+    inline void SetExternalBlock(BlockID bid, const char *ptr) { external_blocks[bid] = ptr; }
+
+    inline bool IsExternalBlock(BlockID bid) const { return external_blocks[bid] != nullptr; }
+
+    // External blocks take no space in the memory block
+    inline uint64_t GetBlockSizeInMemory(BlockID bid) const
+    {
+        return IsExternalBlock(bid) ? 0 : GetBlockSize(bid);
+    }
+
     inline uint64_t GetSizeOfLayout() const
     {
         uint64_t result = 0;
         for (auto i = 0; i < NUM_BLOCKS; i++)
         {
             BOOST_ASSERT(entry_align[i] > 0);
-            result += 2 * sizeof(CANARY) + GetBlockSize((BlockID)i) + entry_align[i];
+            result += 2 * sizeof(CANARY) + GetBlockSizeInMemory((BlockID)i) + entry_align[i];
         }
         return result;
     }
@@ -184,7 +253,7 @@ struct DataLayout
         {
             ptr = static_cast<char *>(ptr) + sizeof(CANARY);
             ptr = align(entry_align[i], entry_size[i], ptr);
-            ptr = static_cast<char *>(ptr) + GetBlockSize((BlockID)i);
+            ptr = static_cast<char *>(ptr) + GetBlockSizeInMemory((BlockID)i);
             ptr = static_cast<char *>(ptr) + sizeof(CANARY);
         }
 
@@ -202,6 +271,12 @@ struct DataLayout
     template <typename T, bool WRITE_CANARY = false>
     inline T *GetBlockPtr(char *shared_memory, BlockID bid) const
     {
+        // mappings of files are read-only and have no canaries
+        if (IsExternalBlock(bid))
+        {
+            return (T *)external_blocks[bid];
+        }
+
         char *ptr = (char *)GetAlignedBlockPtr(shared_memory, bid);
         if (WRITE_CANARY)
         {
@@ -239,15 +314,29 @@ enum SharedDataType
     REGION_2
 };
 
+// Copies of a region, one per NUMA node if osrm-datastore replicates the dataset
+const constexpr unsigned MAX_REGION_REPLICAS = 16;
+
+// Shared memory id of a copy of the region, the first one has the id of the region itself.
+// Only the lowest byte of the id is used for the key of the shared memory.
+constexpr int getReplicaID(const SharedDataType region, const unsigned replica)
+{
+    return static_cast<int>(region) + 16 * static_cast<int>(replica);
+}
+
 struct SharedDataTimestamp
 {
-    explicit SharedDataTimestamp(SharedDataType region, unsigned timestamp)
-        : region(region), timestamp(timestamp)
+    explicit SharedDataTimestamp(SharedDataType region,
+                                 unsigned timestamp,
+                                 unsigned num_replicas = 1)
+        : region(region), timestamp(timestamp), num_replicas(num_replicas)
     {
     }
 
     SharedDataType region;
     unsigned timestamp;
+    // the i-th copy of the region is on the i-th NUMA node of util::GetNUMANodes()
+    unsigned num_replicas;
 
     static constexpr const char *name = "osrm-region";
 };
@@ -267,6 +356,9 @@ inline std::string regionToString(const SharedDataType region)
     }
 }
 
+static_assert(getReplicaID(REGION_2, MAX_REGION_REPLICAS - 1) < 256,
+              "Replica ids need to fit into a byte.");
+
 static_assert(sizeof(block_id_to_name) / sizeof(*block_id_to_name) == DataLayout::NUM_BLOCKS,
               "Number of blocks needs to match the number of Block names.");
 }
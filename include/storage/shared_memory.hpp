@@ -3,6 +3,7 @@
 
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
+#include "util/huge_pages.hpp"
 #include "util/log.hpp"
 
 #include <boost/filesystem.hpp>
@@ -23,7 +24,9 @@
 
 #include <algorithm>
 #include <exception>
+#include <string>
 #include <thread>
+#include <utility>
 
 #include "storage/shared_memory_ownership.hpp"
 
@@ -32,14 +35,21 @@ namespace osrm
 namespace storage
 {
 
+// The regions are keyed by the lock file, so every named dataset gets a lock file of its own
+// and its regions can use the same ids as the ones of the unnamed dataset
 struct OSRMLockFile
 {
+    OSRMLockFile(std::string dataset_name = "") : dataset_name(std::move(dataset_name)) {}
+
     boost::filesystem::path operator()()
     {
         boost::filesystem::path temp_dir = boost::filesystem::temp_directory_path();
-        boost::filesystem::path lock_file = temp_dir / "osrm.lock";
+        boost::filesystem::path lock_file =
+            temp_dir / (dataset_name.empty() ? "osrm.lock" : "osrm-" + dataset_name + ".lock");
         return lock_file;
     }
+
+    std::string dataset_name;
 };
 
 #ifndef _WIN32
@@ -51,11 +61,15 @@ class SharedMemory
     SharedMemory(const SharedMemory &) = delete;
     SharedMemory &operator=(const SharedMemory &) = delete;
 
+    util::HugePages GetHugePages() const { return huge_pages; }
+
+    // Creates the region if a size is given, backed by huge pages if requested and available
     template <typename IdentifierT>
     SharedMemory(const boost::filesystem::path &lock_file,
                  const IdentifierT id,
-                 const uint64_t size = 0)
-        : key(lock_file.string().c_str(), id)
+                 const uint64_t size = 0,
+                 const bool use_huge_pages = false)
+        : key(lock_file.string().c_str(), id), huge_pages(util::HugePages::None)
     {
         // open only
         if (0 == size)
@@ -69,6 +83,18 @@ class SharedMemory
         // open or create
         else
         {
+#ifdef __linux__
+            // the readers map the region the same way no matter which pages back it
+            if (use_huge_pages && util::GetHugePageSize() > 0 &&
+                -1 != ::shmget(key.get_key(),
+                               util::RoundToHugePages(size),
+                               IPC_CREAT | SHM_HUGETLB | 0644))
+            {
+                huge_pages = util::HugePages::Explicit;
+            }
+#else
+            (void)use_huge_pages;
+#endif
             shm = boost::interprocess::xsi_shared_memory(
                 boost::interprocess::open_or_create, key, size);
             util::Log(logDEBUG) << "opening/creating " << shm.get_shmid() << " from id " << id
@@ -86,12 +112,13 @@ class SharedMemory
         }
     }
 
-    template <typename IdentifierT> static bool RegionExists(const IdentifierT id)
+    template <typename IdentifierT>
+    static bool RegionExists(const IdentifierT id, const std::string &dataset_name = "")
     {
         bool result = true;
         try
         {
-            OSRMLockFile lock_file;
+            OSRMLockFile lock_file(dataset_name);
             boost::interprocess::xsi_key key(lock_file().string().c_str(), id);
             result = RegionExists(key);
         }
@@ -102,9 +129,10 @@ class SharedMemory
         return result;
     }
 
-    template <typename IdentifierT> static bool Remove(const IdentifierT id)
+    template <typename IdentifierT>
+    static bool Remove(const IdentifierT id, const std::string &dataset_name = "")
     {
-        OSRMLockFile lock_file;
+        OSRMLockFile lock_file(dataset_name);
         boost::interprocess::xsi_key key(lock_file().string().c_str(), id);
         return Remove(key);
     }
@@ -190,6 +218,7 @@ class SharedMemory
     boost::interprocess::xsi_key key;
     boost::interprocess::xsi_shared_memory shm;
     boost::interprocess::mapped_region region;
+    util::HugePages huge_pages;
 };
 #else
 // Windows - specific code
@@ -201,9 +230,14 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
-    SharedMemory(const boost::filesystem::path &lock_file, const int id, const uint64_t size = 0)
+    util::HugePages GetHugePages() const { return util::HugePages::None; }
+
+    SharedMemory(const boost::filesystem::path &lock_file,
+                 const int id,
+                 const uint64_t size = 0,
+                 const bool /*use_huge_pages*/ = false)
     {
-        sprintf(key, "%s.%d", "osrm.lock", id);
+        build_key(lock_file, id, key);
         if (0 == size)
         { // read_only
             shm = boost::interprocess::shared_memory_object(
@@ -221,13 +255,13 @@ class SharedMemory
         }
     }
 
-    static bool RegionExists(const int id)
+    static bool RegionExists(const int id, const std::string &dataset_name = "")
     {
         bool result = true;
         try
         {
             char k[500];
-            build_key(id, k);
+            build_key(OSRMLockFile(dataset_name)(), id, k);
             result = RegionExists(k);
         }
         catch (...)
@@ -237,10 +271,10 @@ class SharedMemory
         return result;
     }
 
-    static bool Remove(const int id)
+    static bool Remove(const int id, const std::string &dataset_name = "")
     {
         char k[500];
-        build_key(id, k);
+        build_key(OSRMLockFile(dataset_name)(), id, k);
         return Remove(k);
     }
 
@@ -253,7 +287,10 @@ class SharedMemory
     }
 
   private:
-    static void build_key(int id, char *key) { sprintf(key, "%s.%d", "osrm.lock", id); }
+    static void build_key(const boost::filesystem::path &lock_file, int id, char *key)
+    {
+        sprintf(key, "%s.%d", lock_file.filename().string().c_str(), id);
+    }
 
     static bool RegionExists(const char *key)
     {
@@ -283,11 +320,14 @@ class SharedMemory
 #endif
 
 template <typename IdentifierT, typename LockFileT = OSRMLockFile>
-std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint64_t size = 0)
+std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id,
+                                               const uint64_t size = 0,
+                                               const bool use_huge_pages = false,
+                                               const std::string &dataset_name = "")
 {
     try
     {
-        LockFileT lock_file;
+        LockFileT lock_file(dataset_name);
         if (!boost::filesystem::exists(lock_file()))
         {
             if (0 == size)
@@ -299,7 +339,7 @@ std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint
                 boost::filesystem::ofstream ofs(lock_file());
             }
         }
-        return std::make_unique<SharedMemory>(lock_file(), id, size);
+        return std::make_unique<SharedMemory>(lock_file(), id, size, use_huge_pages);
     }
     catch (const boost::interprocess::interprocess_exception &e)
     {
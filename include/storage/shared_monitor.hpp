@@ -11,6 +11,8 @@
 #include <boost/interprocess/sync/interprocess_semaphore.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
+#include <string>
+
 #if defined(__linux__)
 // See issue #3911, boost interprocess is broken with a glibc > 2.25
 // #define USE_BOOST_INTERPROCESS_CONDITION 1
@@ -35,14 +37,16 @@ template <class Lock> class InvertedLock
 };
 }
 
-// The shared monitor implementation based on a semaphore and mutex
+// The shared monitor implementation based on a semaphore and mutex.
+// Every named dataset has a monitor of its own, the unnamed one uses Data::name.
 template <typename Data> struct SharedMonitor
 {
     using mutex_type = bi::interprocess_mutex;
 
-    SharedMonitor(const Data &initial_data)
+    SharedMonitor(const Data &initial_data, const std::string &dataset_name = "")
     {
-        shmem = bi::shared_memory_object(bi::open_or_create, Data::name, bi::read_write);
+        shmem = bi::shared_memory_object(
+            bi::open_or_create, getName(dataset_name).c_str(), bi::read_write);
 
         bi::offset_t size = 0;
         if (shmem.get_size(size) && size == 0)
@@ -58,18 +62,19 @@ template <typename Data> struct SharedMonitor
         }
     }
 
-    SharedMonitor()
+    explicit SharedMonitor(const std::string &dataset_name = "")
     {
+        const auto name = getName(dataset_name);
         try
         {
-            shmem = bi::shared_memory_object(bi::open_only, Data::name, bi::read_write);
+            shmem = bi::shared_memory_object(bi::open_only, name.c_str(), bi::read_write);
 
             bi::offset_t size = 0;
             if (!shmem.get_size(size) || size != internal_size + sizeof(Data))
             {
                 auto message =
                     boost::format("Wrong shared memory block '%1%' size %2%, expected %3% bytes") %
-                    (const char *)Data::name % size % (internal_size + sizeof(Data));
+                    name % size % (internal_size + sizeof(Data));
                 throw util::exception(message.str() + SOURCE_REF);
             }
 
@@ -79,7 +84,7 @@ template <typename Data> struct SharedMonitor
         {
             auto message = boost::format("No shared memory block '%1%' found, have you forgotten "
                                          "to run osrm-datastore?") %
-                           (const char *)Data::name;
+                           name;
             throw util::exception(message.str() + SOURCE_REF);
         }
     }
@@ -116,7 +121,16 @@ template <typename Data> struct SharedMonitor
     }
 #endif
 
-    static void remove() { bi::shared_memory_object::remove(Data::name); }
+    static void remove(const std::string &dataset_name = "")
+    {
+        bi::shared_memory_object::remove(getName(dataset_name).c_str());
+    }
+
+    static std::string getName(const std::string &dataset_name)
+    {
+        return dataset_name.empty() ? std::string(Data::name)
+                                    : std::string(Data::name) + "-" + dataset_name;
+    }
 
   private:
 #if USE_BOOST_INTERPROCESS_CONDITION
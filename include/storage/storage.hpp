@@ -33,21 +33,69 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <bitset>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
 namespace storage
 {
+
+// A block that is stored verbatim at an offset in one of the data files
+struct FileBlock
+{
+    DataLayout::BlockID id;
+    boost::filesystem::path path;
+    std::uint64_t offset;
+};
+
+using BlockSet = std::bitset<DataLayout::NUM_BLOCKS>;
+
+// Changes the data in use instead of loading the dataset from its files
+class DataUpdate
+{
+  public:
+    virtual ~DataUpdate() = default;
+
+    // Computes the update from the data in use. Returns the blocks that are written by `Write`,
+    // their sizes in `layout` can differ from the ones in use. All other blocks are copied.
+    virtual BlockSet Prepare(const DataLayout &in_use_layout,
+                             char *in_use_memory,
+                             DataLayout &layout) = 0;
+
+    // Writes the blocks returned by `Prepare` to the new region, the copied blocks are in place
+    virtual void Write(const DataLayout &layout, char *memory) = 0;
+};
+
 class Storage
 {
   public:
     Storage(StorageConfig config);
 
-    int Run(int max_wait);
+    // Loads the dataset into shared memory, one copy per NUMA node if it is replicated. Huge
+    // pages are used if requested and the system has enough of them reserved. Blocks whose
+    // files did not change since the region in use was loaded are copied from it if requested.
+    // If an update is given the new region is a copy of the region in use with the update
+    // applied instead. A named dataset has regions and a monitor of its own, so osrm-datastore
+    // can keep several datasets in shared memory and osrm-routed serves one of them by name.
+    int Run(int max_wait,
+            const std::string &dataset_name = "",
+            const bool replicate_per_numa_node = false,
+            const bool use_huge_pages = false,
+            const bool reuse_unchanged_blocks = false,
+            DataUpdate *update = nullptr);
 
     void PopulateLayout(DataLayout &layout);
-    void PopulateData(const DataLayout &layout, char *memory_ptr);
+    // Skips the external blocks of the layout and the given blocks
+    void PopulateData(const DataLayout &layout,
+                      char *memory_ptr,
+                      const BlockSet &skipped_blocks = BlockSet());
+
+    // Finds the blocks that can be used from a read-only mapping of their file. The blocks of a
+    // file are only returned if all of them are aligned for their entries in the file.
+    std::vector<FileBlock> PopulateFileBlocks(const DataLayout &layout);
 
   private:
     StorageConfig config;
@@ -30,13 +30,43 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <cstdint>
+#include <string>
+
 namespace osrm
 {
 namespace storage
 {
 
 /**
- * Configures OSRM's file storage paths.
+ * Where the queries read the leaves of the r-tree in the .fileIndex from:
+ *  - Mapped: a mapping of the file, paged in by the kernel with read ahead
+ *  - Random: a mapping of the file without read ahead, the leaves of a query are scattered
+ *  - Prefault: a mapping of the file with all of its pages read in when the data is loaded
+ *  - Load: the memory of the dataset, next to the branch nodes of the r-tree
+ */
+enum class RTreeLeafAccess : std::uint8_t
+{
+    Mapped,
+    Random,
+    Prefault,
+    Load
+};
+
+// Parses mapped, random, prefault or load, throws on anything else
+RTreeLeafAccess StringToRTreeLeafAccess(std::string access);
+
+// Names of datasets in shared memory become part of file and region names, they may only
+// contain letters, digits, '-' and '_'. The empty name is the unnamed dataset.
+bool IsValidDatasetName(const std::string &name);
+
+/**
+ * Configures OSRM's file storage paths and how the r-tree leaves are read from their file.
+ * With shared memory the access of osrm-datastore applies.
+ *
+ * With use_image the dataset is loaded from the image written by osrm-pack instead of the data
+ * files, only the .fileIndex is still read from its own file. The r-tree leaf access is the one
+ * the image was packed with.
  *
  * \see OSRM, EngineConfig
  */
@@ -55,6 +85,8 @@ struct StorageConfig final
     boost::filesystem::path ram_index_path;
     boost::filesystem::path file_index_path;
     boost::filesystem::path hsgr_data_path;
+    boost::filesystem::path compressed_hsgr_data_path;
+    boost::filesystem::path hub_labels_path;
     boost::filesystem::path node_based_nodes_data_path;
     boost::filesystem::path edge_based_nodes_data_path;
     boost::filesystem::path edges_data_path;
@@ -73,6 +105,15 @@ struct StorageConfig final
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
     boost::filesystem::path mld_graph_path;
+    boost::filesystem::path mld_overlay_hierarchy_path;
+    boost::filesystem::path cch_graph_path;
+    boost::filesystem::path landmarks_path;
+    boost::filesystem::path distance_oracle_path;
+    boost::filesystem::path conditional_turn_masks_path;
+    boost::filesystem::path image_path;
+
+    RTreeLeafAccess rtree_leaf_access = RTreeLeafAccess::Mapped;
+    bool use_image = false;
 };
 }
 }
@@ -0,0 +1,347 @@
+#ifndef OSRM_STORAGE_VIEW_FACTORY_HPP
+#define OSRM_STORAGE_VIEW_FACTORY_HPP
+
+#include "storage/shared_datatype.hpp"
+
+#include "contractor/compressed_search_graph.hpp"
+#include "contractor/hub_labels.hpp"
+
+#include "customizer/edge_based_graph.hpp"
+#include "customizer/overlay_hierarchy.hpp"
+
+#include "extractor/conditional_turn_masks.hpp"
+#include "extractor/segment_data_container.hpp"
+
+#include "partition/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/distance_oracle.hpp"
+#include "util/landmarks.hpp"
+#include "util/vector_view.hpp"
+
+namespace osrm
+{
+namespace storage
+{
+
+// Views of the data structures stored in the blocks of `memory_ptr`. Views that are going to
+// be populated write the canaries of their blocks, all others check them.
+
+template <bool WRITE_CANARY = false>
+inline extractor::SegmentDataView make_segment_data_view(char *memory_ptr,
+                                                         const DataLayout &layout)
+{
+    using SegmentWeightBlock = extractor::SegmentDataView::SegmentWeightVector::block_type;
+    using SegmentDurationBlock = extractor::SegmentDataView::SegmentDurationVector::block_type;
+
+    auto geometries_index_ptr =
+        layout.GetBlockPtr<unsigned, WRITE_CANARY>(memory_ptr, DataLayout::GEOMETRIES_INDEX);
+    util::vector_view<unsigned> geometry_begin_indices(
+        geometries_index_ptr, layout.num_entries[DataLayout::GEOMETRIES_INDEX]);
+
+    auto num_entries = layout.num_entries[DataLayout::GEOMETRIES_NODE_LIST];
+
+    auto geometries_node_list_ptr =
+        layout.GetBlockPtr<NodeID, WRITE_CANARY>(memory_ptr, DataLayout::GEOMETRIES_NODE_LIST);
+    util::vector_view<NodeID> geometry_node_list(geometries_node_list_ptr, num_entries);
+
+    auto geometries_fwd_weight_list_ptr = layout.GetBlockPtr<SegmentWeightBlock, WRITE_CANARY>(
+        memory_ptr, DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+    extractor::SegmentDataView::SegmentWeightVector geometry_fwd_weight_list(
+        util::vector_view<SegmentWeightBlock>(
+            geometries_fwd_weight_list_ptr,
+            layout.num_entries[DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]),
+        num_entries);
+
+    auto geometries_rev_weight_list_ptr = layout.GetBlockPtr<SegmentWeightBlock, WRITE_CANARY>(
+        memory_ptr, DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+    extractor::SegmentDataView::SegmentWeightVector geometry_rev_weight_list(
+        util::vector_view<SegmentWeightBlock>(
+            geometries_rev_weight_list_ptr,
+            layout.num_entries[DataLayout::GEOMETRIES_REV_WEIGHT_LIST]),
+        num_entries);
+
+    auto geometries_fwd_duration_list_ptr =
+        layout.GetBlockPtr<SegmentDurationBlock, WRITE_CANARY>(
+            memory_ptr, DataLayout::GEOMETRIES_FWD_DURATION_LIST);
+    extractor::SegmentDataView::SegmentDurationVector geometry_fwd_duration_list(
+        util::vector_view<SegmentDurationBlock>(
+            geometries_fwd_duration_list_ptr,
+            layout.num_entries[DataLayout::GEOMETRIES_FWD_DURATION_LIST]),
+        num_entries);
+
+    auto geometries_rev_duration_list_ptr =
+        layout.GetBlockPtr<SegmentDurationBlock, WRITE_CANARY>(
+            memory_ptr, DataLayout::GEOMETRIES_REV_DURATION_LIST);
+    extractor::SegmentDataView::SegmentDurationVector geometry_rev_duration_list(
+        util::vector_view<SegmentDurationBlock>(
+            geometries_rev_duration_list_ptr,
+            layout.num_entries[DataLayout::GEOMETRIES_REV_DURATION_LIST]),
+        num_entries);
+
+    auto datasources_list_ptr =
+        layout.GetBlockPtr<DatasourceID, WRITE_CANARY>(memory_ptr, DataLayout::DATASOURCES_LIST);
+    util::vector_view<DatasourceID> datasources_list(
+        datasources_list_ptr, layout.num_entries[DataLayout::DATASOURCES_LIST]);
+
+    return extractor::SegmentDataView{std::move(geometry_begin_indices),
+                                      std::move(geometry_node_list),
+                                      std::move(geometry_fwd_weight_list),
+                                      std::move(geometry_rev_weight_list),
+                                      std::move(geometry_fwd_duration_list),
+                                      std::move(geometry_rev_duration_list),
+                                      std::move(datasources_list)};
+}
+
+template <bool WRITE_CANARY = false>
+inline partition::MultiLevelPartitionView make_partition_view(char *memory_ptr,
+                                                              const DataLayout &layout)
+{
+    auto level_data =
+        layout.GetBlockPtr<partition::MultiLevelPartitionView::LevelData, WRITE_CANARY>(
+            memory_ptr, DataLayout::MLD_LEVEL_DATA);
+
+    auto mld_partition_ptr =
+        layout.GetBlockPtr<PartitionID, WRITE_CANARY>(memory_ptr, DataLayout::MLD_PARTITION);
+    auto partition_entries_count = layout.GetBlockEntries(DataLayout::MLD_PARTITION);
+    util::vector_view<PartitionID> partition(mld_partition_ptr, partition_entries_count);
+
+    auto mld_chilren_ptr =
+        layout.GetBlockPtr<CellID, WRITE_CANARY>(memory_ptr, DataLayout::MLD_CELL_TO_CHILDREN);
+    auto children_entries_count = layout.GetBlockEntries(DataLayout::MLD_CELL_TO_CHILDREN);
+    util::vector_view<CellID> cell_to_children(mld_chilren_ptr, children_entries_count);
+
+    return partition::MultiLevelPartitionView{
+        std::move(level_data), std::move(partition), std::move(cell_to_children)};
+}
+
+template <bool WRITE_CANARY = false>
+inline partition::CellStorageView make_cell_storage_view(char *memory_ptr,
+                                                         const DataLayout &layout)
+{
+    auto mld_cell_weights_ptr =
+        layout.GetBlockPtr<EdgeWeight, WRITE_CANARY>(memory_ptr, DataLayout::MLD_CELL_WEIGHTS);
+    auto mld_cell_duration_ptr = layout.GetBlockPtr<EdgeDuration, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_CELL_DURATIONS);
+    auto mld_source_boundary_ptr = layout.GetBlockPtr<NodeID, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+    auto mld_destination_boundary_ptr = layout.GetBlockPtr<NodeID, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+    auto mld_cells_ptr = layout.GetBlockPtr<partition::CellStorageView::CellData, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_CELLS);
+    auto mld_cell_level_offsets_ptr = layout.GetBlockPtr<std::uint64_t, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_CELL_LEVEL_OFFSETS);
+    auto mld_cell_metric_names_ptr =
+        layout.GetBlockPtr<char, WRITE_CANARY>(memory_ptr, DataLayout::MLD_CELL_METRIC_NAMES);
+
+    auto weight_entries_count = layout.GetBlockEntries(DataLayout::MLD_CELL_WEIGHTS);
+    auto duration_entries_count = layout.GetBlockEntries(DataLayout::MLD_CELL_DURATIONS);
+    auto source_boundary_entries_count =
+        layout.GetBlockEntries(DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+    auto destination_boundary_entries_count =
+        layout.GetBlockEntries(DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+    auto cells_entries_counts = layout.GetBlockEntries(DataLayout::MLD_CELLS);
+    auto cell_level_offsets_entries_count =
+        layout.GetBlockEntries(DataLayout::MLD_CELL_LEVEL_OFFSETS);
+    auto cell_metric_names_entries_count =
+        layout.GetBlockEntries(DataLayout::MLD_CELL_METRIC_NAMES);
+
+    util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
+    util::vector_view<EdgeDuration> durations(mld_cell_duration_ptr, duration_entries_count);
+    util::vector_view<NodeID> source_boundary(mld_source_boundary_ptr,
+                                              source_boundary_entries_count);
+    util::vector_view<NodeID> destination_boundary(mld_destination_boundary_ptr,
+                                                   destination_boundary_entries_count);
+    util::vector_view<partition::CellStorageView::CellData> cells(mld_cells_ptr,
+                                                                  cells_entries_counts);
+    util::vector_view<std::uint64_t> level_offsets(mld_cell_level_offsets_ptr,
+                                                   cell_level_offsets_entries_count);
+    util::vector_view<char> metric_names(mld_cell_metric_names_ptr,
+                                         cell_metric_names_entries_count);
+
+    return partition::CellStorageView{std::move(weights),
+                                      std::move(durations),
+                                      std::move(source_boundary),
+                                      std::move(destination_boundary),
+                                      std::move(cells),
+                                      std::move(level_offsets),
+                                      std::move(metric_names)};
+}
+
+template <bool WRITE_CANARY = false>
+inline customizer::MultiLevelEdgeBasedGraphView make_multi_level_graph_view(char *memory_ptr,
+                                                                          const DataLayout &layout)
+{
+    using GraphView = customizer::MultiLevelEdgeBasedGraphView;
+
+    auto graph_nodes_ptr = layout.GetBlockPtr<GraphView::NodeArrayEntry, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_GRAPH_NODE_LIST);
+    auto graph_edges_ptr = layout.GetBlockPtr<GraphView::EdgeArrayEntry, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_GRAPH_EDGE_LIST);
+    auto graph_node_to_offset_ptr = layout.GetBlockPtr<GraphView::EdgeOffset, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
+
+    util::vector_view<GraphView::NodeArrayEntry> node_list(
+        graph_nodes_ptr, layout.num_entries[DataLayout::MLD_GRAPH_NODE_LIST]);
+    util::vector_view<GraphView::EdgeArrayEntry> edge_list(
+        graph_edges_ptr, layout.num_entries[DataLayout::MLD_GRAPH_EDGE_LIST]);
+    util::vector_view<GraphView::EdgeOffset> node_to_offset(
+        graph_node_to_offset_ptr, layout.num_entries[DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
+
+    return GraphView(std::move(node_list), std::move(edge_list), std::move(node_to_offset));
+}
+
+template <bool WRITE_CANARY = false>
+inline customizer::OverlayHierarchyView make_overlay_hierarchy_view(char *memory_ptr,
+                                                                   const DataLayout &layout)
+{
+    using Arc = customizer::OverlayHierarchyView::Arc;
+
+    auto nodes_ptr =
+        layout.GetBlockPtr<NodeID, WRITE_CANARY>(memory_ptr, DataLayout::MLD_OVERLAY_NODES);
+    auto forward_offsets_ptr = layout.GetBlockPtr<std::uint64_t, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_OVERLAY_FORWARD_OFFSETS);
+    auto forward_arcs_ptr =
+        layout.GetBlockPtr<Arc, WRITE_CANARY>(memory_ptr, DataLayout::MLD_OVERLAY_FORWARD_ARCS);
+    auto backward_offsets_ptr = layout.GetBlockPtr<std::uint64_t, WRITE_CANARY>(
+        memory_ptr, DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS);
+    auto backward_arcs_ptr =
+        layout.GetBlockPtr<Arc, WRITE_CANARY>(memory_ptr, DataLayout::MLD_OVERLAY_BACKWARD_ARCS);
+
+    util::vector_view<NodeID> nodes(nodes_ptr,
+                                    layout.GetBlockEntries(DataLayout::MLD_OVERLAY_NODES));
+    util::vector_view<std::uint64_t> forward_offsets(
+        forward_offsets_ptr, layout.GetBlockEntries(DataLayout::MLD_OVERLAY_FORWARD_OFFSETS));
+    util::vector_view<Arc> forward_arcs(
+        forward_arcs_ptr, layout.GetBlockEntries(DataLayout::MLD_OVERLAY_FORWARD_ARCS));
+    util::vector_view<std::uint64_t> backward_offsets(
+        backward_offsets_ptr, layout.GetBlockEntries(DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS));
+    util::vector_view<Arc> backward_arcs(
+        backward_arcs_ptr, layout.GetBlockEntries(DataLayout::MLD_OVERLAY_BACKWARD_ARCS));
+
+    return customizer::OverlayHierarchyView{std::move(nodes),
+                                            std::move(forward_offsets),
+                                            std::move(forward_arcs),
+                                            std::move(backward_offsets),
+                                            std::move(backward_arcs)};
+}
+
+template <bool WRITE_CANARY = false>
+inline util::LandmarksView make_landmarks_view(char *memory_ptr, const DataLayout &layout)
+{
+    using Distance = util::LandmarksView::Distance;
+
+    auto nodes_ptr =
+        layout.GetBlockPtr<NodeID, WRITE_CANARY>(memory_ptr, DataLayout::LANDMARK_NODES);
+    auto units_ptr =
+        layout.GetBlockPtr<EdgeWeight, WRITE_CANARY>(memory_ptr, DataLayout::LANDMARK_UNITS);
+    auto distances_ptr =
+        layout.GetBlockPtr<Distance, WRITE_CANARY>(memory_ptr, DataLayout::LANDMARK_DISTANCES);
+
+    util::vector_view<NodeID> nodes(nodes_ptr, layout.GetBlockEntries(DataLayout::LANDMARK_NODES));
+    util::vector_view<EdgeWeight> units(units_ptr,
+                                        layout.GetBlockEntries(DataLayout::LANDMARK_UNITS));
+    util::vector_view<Distance> distances(distances_ptr,
+                                          layout.GetBlockEntries(DataLayout::LANDMARK_DISTANCES));
+
+    return util::LandmarksView{std::move(nodes), std::move(units), std::move(distances)};
+}
+
+template <bool WRITE_CANARY = false>
+inline util::DistanceOracleView make_distance_oracle_view(char *memory_ptr,
+                                                         const DataLayout &layout)
+{
+    auto representatives_ptr = layout.GetBlockPtr<NodeID, WRITE_CANARY>(
+        memory_ptr, DataLayout::DISTANCE_ORACLE_REPRESENTATIVES);
+    auto cells_ptr =
+        layout.GetBlockPtr<CellID, WRITE_CANARY>(memory_ptr, DataLayout::DISTANCE_ORACLE_CELLS);
+    auto node_durations_ptr = layout.GetBlockPtr<EdgeDuration, WRITE_CANARY>(
+        memory_ptr, DataLayout::DISTANCE_ORACLE_NODE_DURATIONS);
+    auto cell_durations_ptr = layout.GetBlockPtr<EdgeDuration, WRITE_CANARY>(
+        memory_ptr, DataLayout::DISTANCE_ORACLE_CELL_DURATIONS);
+
+    util::vector_view<NodeID> representatives(
+        representatives_ptr, layout.GetBlockEntries(DataLayout::DISTANCE_ORACLE_REPRESENTATIVES));
+    util::vector_view<CellID> cells(cells_ptr,
+                                    layout.GetBlockEntries(DataLayout::DISTANCE_ORACLE_CELLS));
+    util::vector_view<EdgeDuration> node_durations(
+        node_durations_ptr, layout.GetBlockEntries(DataLayout::DISTANCE_ORACLE_NODE_DURATIONS));
+    util::vector_view<EdgeDuration> cell_durations(
+        cell_durations_ptr, layout.GetBlockEntries(DataLayout::DISTANCE_ORACLE_CELL_DURATIONS));
+
+    return util::DistanceOracleView{std::move(representatives),
+                                    std::move(cells),
+                                    std::move(node_durations),
+                                    std::move(cell_durations)};
+}
+
+template <bool WRITE_CANARY = false>
+inline extractor::ConditionalTurnMasksView
+make_conditional_turn_masks_view(char *memory_ptr, const DataLayout &layout)
+{
+    auto turns_ptr =
+        layout.GetBlockPtr<EdgeID, WRITE_CANARY>(memory_ptr, DataLayout::CONDITIONAL_TURN_IDS);
+    auto sources_ptr =
+        layout.GetBlockPtr<NodeID, WRITE_CANARY>(memory_ptr, DataLayout::CONDITIONAL_TURN_SOURCES);
+    auto targets_ptr =
+        layout.GetBlockPtr<NodeID, WRITE_CANARY>(memory_ptr, DataLayout::CONDITIONAL_TURN_TARGETS);
+    auto masks_ptr = layout.GetBlockPtr<std::uint64_t, WRITE_CANARY>(
+        memory_ptr, DataLayout::CONDITIONAL_TURN_MASKS);
+
+    util::vector_view<EdgeID> turns(turns_ptr,
+                                    layout.GetBlockEntries(DataLayout::CONDITIONAL_TURN_IDS));
+    util::vector_view<NodeID> sources(sources_ptr,
+                                      layout.GetBlockEntries(DataLayout::CONDITIONAL_TURN_SOURCES));
+    util::vector_view<NodeID> targets(targets_ptr,
+                                      layout.GetBlockEntries(DataLayout::CONDITIONAL_TURN_TARGETS));
+    util::vector_view<std::uint64_t> masks(
+        masks_ptr, layout.GetBlockEntries(DataLayout::CONDITIONAL_TURN_MASKS));
+
+    return extractor::ConditionalTurnMasksView{
+        std::move(turns), std::move(sources), std::move(targets), std::move(masks)};
+}
+
+template <bool WRITE_CANARY = false>
+inline contractor::CompressedSearchGraphView
+make_compressed_search_graph_view(char *memory_ptr, const DataLayout &layout)
+{
+    auto offsets_ptr = layout.GetBlockPtr<std::uint64_t, WRITE_CANARY>(
+        memory_ptr, DataLayout::CH_COMPRESSED_GRAPH_OFFSETS);
+    auto edges_ptr = layout.GetBlockPtr<std::uint8_t, WRITE_CANARY>(
+        memory_ptr, DataLayout::CH_COMPRESSED_GRAPH_EDGES);
+
+    util::vector_view<std::uint64_t> offsets(
+        offsets_ptr, layout.GetBlockEntries(DataLayout::CH_COMPRESSED_GRAPH_OFFSETS));
+    util::vector_view<std::uint8_t> edges(
+        edges_ptr, layout.GetBlockEntries(DataLayout::CH_COMPRESSED_GRAPH_EDGES));
+
+    return contractor::CompressedSearchGraphView{std::move(offsets), std::move(edges)};
+}
+
+template <bool WRITE_CANARY = false>
+inline contractor::HubLabelsView make_hub_labels_view(char *memory_ptr, const DataLayout &layout)
+{
+    auto offsets_ptr = layout.GetBlockPtr<std::uint64_t, WRITE_CANARY>(
+        memory_ptr, DataLayout::CH_HUB_LABEL_OFFSETS);
+    auto hubs_ptr =
+        layout.GetBlockPtr<NodeID, WRITE_CANARY>(memory_ptr, DataLayout::CH_HUB_LABEL_HUBS);
+    auto weights_ptr =
+        layout.GetBlockPtr<EdgeWeight, WRITE_CANARY>(memory_ptr, DataLayout::CH_HUB_LABEL_WEIGHTS);
+    auto durations_ptr = layout.GetBlockPtr<EdgeDuration, WRITE_CANARY>(
+        memory_ptr, DataLayout::CH_HUB_LABEL_DURATIONS);
+
+    util::vector_view<std::uint64_t> offsets(
+        offsets_ptr, layout.GetBlockEntries(DataLayout::CH_HUB_LABEL_OFFSETS));
+    util::vector_view<NodeID> hubs(hubs_ptr, layout.GetBlockEntries(DataLayout::CH_HUB_LABEL_HUBS));
+    util::vector_view<EdgeWeight> weights(
+        weights_ptr, layout.GetBlockEntries(DataLayout::CH_HUB_LABEL_WEIGHTS));
+    util::vector_view<EdgeDuration> durations(
+        durations_ptr, layout.GetBlockEntries(DataLayout::CH_HUB_LABEL_DURATIONS));
+
+    return contractor::HubLabelsView{
+        std::move(offsets), std::move(hubs), std::move(weights), std::move(durations)};
+}
+}
+}
+
+#endif
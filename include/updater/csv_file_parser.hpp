@@ -3,12 +3,16 @@
 
 #include "updater/source.hpp"
 
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 
 #include <tbb/parallel_for.h>
-#include <tbb/spin_mutex.h>
 
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/filesystem.hpp>
@@ -16,6 +20,10 @@
 #include <boost/spirit/include/phoenix.hpp>
 #include <boost/spirit/include/qi.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -27,14 +35,23 @@ namespace updater
 // Key and Value structures must be a model of Random Access Sequence.
 // Also the Value structure must have source member that will be filled
 // with the corresponding file index in the CSV filenames vector.
+//
+// Files starting with an OSRM fingerprint are read as the binary lookup tables this parser
+// writes for each CSV file if `use_cache` is set. A cache is used instead of its CSV file as
+// long as it is not older than the CSV file.
 template <typename Key, typename Value> struct CSVFilesParser
 {
     using Iterator = boost::iostreams::mapped_file_source::iterator;
     using KeyRule = boost::spirit::qi::rule<Iterator, Key()>;
     using ValueRule = boost::spirit::qi::rule<Iterator, Value()>;
+    using Lookup = std::vector<std::pair<Key, Value>>;
 
-    CSVFilesParser(std::size_t start_index, const KeyRule &key_rule, const ValueRule &value_rule)
-        : start_index(start_index), key_rule(key_rule), value_rule(value_rule)
+    CSVFilesParser(std::size_t start_index,
+                   const KeyRule &key_rule,
+                   const ValueRule &value_rule,
+                   bool use_cache = false)
+        : start_index(start_index), key_rule(key_rule), value_rule(value_rule),
+          use_cache(use_cache)
     {
     }
 
@@ -43,41 +60,41 @@ template <typename Key, typename Value> struct CSVFilesParser
     {
         try
         {
-            tbb::spin_mutex mutex;
-            std::vector<std::pair<Key, Value>> lookup;
-            tbb::parallel_for(std::size_t{0},
-                              csv_filenames.size(),
-                              [&](const std::size_t idx) {
-                                  auto local = ParseCSVFile(csv_filenames[idx], start_index + idx);
-
-                                  { // Merge local CSV results into a flat global vector
-                                      tbb::spin_mutex::scoped_lock _{mutex};
-                                      lookup.insert(end(lookup),
-                                                    std::make_move_iterator(begin(local)),
-                                                    std::make_move_iterator(end(local)));
-                                  }
-                              });
-
-            // With flattened map-ish view of all the files, make a stable sort on key and source
-            // and unique them on key to keep only the value with the largest file index
-            // and the largest line number in a file.
-            // The operands order is swapped to make descending ordering on (key, source)
-            std::stable_sort(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                return rhs.first < lhs.first ||
-                       (rhs.first == lhs.first && rhs.second.source < lhs.second.source);
+            std::vector<Lookup> file_lookups(csv_filenames.size());
+            tbb::parallel_for(std::size_t{0}, csv_filenames.size(), [&](const std::size_t idx) {
+                file_lookups[idx] = LoadFile(csv_filenames[idx], start_index + idx);
             });
 
-            // Unique only on key to take the source precedence into account and remove duplicates.
-            const auto it =
-                std::unique(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                    return lhs.first == rhs.first;
+            Lookup lookup;
+            if (file_lookups.size() == 1)
+            {
+                lookup = std::move(file_lookups.front());
+            }
+            else
+            {
+                // The lookups of the files are sorted in descending key order already, merge
+                // them on (key, source) and unique them on key to keep only the value with the
+                // largest file index.
+                std::vector<std::size_t> runs{0};
+                for (auto &file_lookup : file_lookups)
+                {
+                    lookup.insert(end(lookup),
+                                  std::make_move_iterator(begin(file_lookup)),
+                                  std::make_move_iterator(end(file_lookup)));
+                    runs.push_back(lookup.size());
+                    Lookup{}.swap(file_lookup);
+                }
+                MergeRuns(lookup, std::move(runs), [](const auto &lhs, const auto &rhs) {
+                    return rhs.first < lhs.first ||
+                           (rhs.first == lhs.first && rhs.second.source < lhs.second.source);
                 });
-            lookup.erase(it, end(lookup));
+                UniqueOnKey(lookup);
+            }
 
             util::Log() << "In total loaded " << csv_filenames.size() << " file(s) with a total of "
                         << lookup.size() << " unique values";
 
-            return LookupTable<Key, Value>{lookup};
+            return LookupTable<Key, Value>{std::move(lookup)};
         }
         catch (const tbb::captured_exception &e)
         {
@@ -86,25 +103,124 @@ template <typename Key, typename Value> struct CSVFilesParser
     }
 
   private:
-    // Parse a single CSV file and return result as a vector<Key, Value>
-    auto ParseCSVFile(const std::string &filename, std::size_t file_id) const
+    // Lines parsed by one task, files are split at the first line break after each chunk
+    static constexpr std::size_t CHUNK_SIZE = 16 * 1024 * 1024;
+
+    // Sorts on descending key and keeps the value of the first line of duplicated keys
+    static bool ByKey(const std::pair<Key, Value> &lhs, const std::pair<Key, Value> &rhs)
     {
-        namespace qi = boost::spirit::qi;
+        return rhs.first < lhs.first;
+    }
+
+    static void UniqueOnKey(Lookup &lookup)
+    {
+        const auto it =
+            std::unique(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
+                return lhs.first == rhs.first;
+            });
+        lookup.erase(it, end(lookup));
+    }
+
+    // Merges the consecutive sorted runs of `lookup` starting at the given offsets pairwise
+    // in parallel, values of the earlier run come first for equal keys as in a stable sort
+    template <typename Compare>
+    static void MergeRuns(Lookup &lookup, std::vector<std::size_t> runs, Compare compare)
+    {
+        while (runs.size() > 2)
+        {
+            const auto num_pairs = (runs.size() - 1) / 2;
+            tbb::parallel_for(std::size_t{0}, num_pairs, [&](const std::size_t pair) {
+                std::inplace_merge(begin(lookup) + runs[2 * pair],
+                                   begin(lookup) + runs[2 * pair + 1],
+                                   begin(lookup) + runs[2 * pair + 2],
+                                   compare);
+            });
+
+            std::vector<std::size_t> merged_runs;
+            for (std::size_t run = 0; run < runs.size(); run += 2)
+            {
+                merged_runs.push_back(runs[run]);
+            }
+            if (merged_runs.back() != runs.back())
+            {
+                merged_runs.push_back(runs.back());
+            }
+            runs = std::move(merged_runs);
+        }
+    }
 
-        std::vector<std::pair<Key, Value>> result;
+    // Load a single CSV or binary file and return the result in descending key order
+    Lookup LoadFile(const std::string &filename, std::size_t file_id) const
+    {
+        Lookup result;
         try
         {
             if (boost::filesystem::file_size(filename) == 0)
                 return result;
 
+            BOOST_ASSERT(file_id <= std::numeric_limits<std::uint8_t>::max());
+            const auto cache_filename = filename + ".cache";
             boost::iostreams::mapped_file_source mmap(filename);
-            auto first = mmap.begin(), last = mmap.end();
+            if (IsBinaryFile(mmap))
+            {
+                result = ReadBinaryFile(filename);
+            }
+            else if (use_cache && boost::filesystem::exists(cache_filename) &&
+                     boost::filesystem::last_write_time(cache_filename) >=
+                         boost::filesystem::last_write_time(filename))
+            {
+                result = ReadBinaryFile(cache_filename);
+            }
+            else
+            {
+                result = ParseCSVFile(filename, mmap);
+                if (use_cache)
+                {
+                    WriteBinaryFile(cache_filename, result);
+                }
+            }
 
-            BOOST_ASSERT(file_id <= std::numeric_limits<std::uint8_t>::max());
-            ValueRule value_source =
-                value_rule[qi::_val = qi::_1, bind(&Value::source, qi::_val) = file_id];
+            for (auto &key_and_value : result)
+            {
+                key_and_value.second.source = file_id;
+            }
+
+            util::Log() << "Loaded " << filename << " with " << result.size() << " values";
+
+            return result;
+        }
+        catch (const boost::exception &e)
+        {
+            const auto message = boost::format("exception in loading %1%:\n %2%") % filename %
+                                 boost::diagnostic_information(e);
+            throw util::exception(message.str() + SOURCE_REF);
+        }
+    }
+
+    // Parse the lines of a CSV file in chunks in parallel
+    Lookup ParseCSVFile(const std::string &filename,
+                        const boost::iostreams::mapped_file_source &mmap) const
+    {
+        namespace qi = boost::spirit::qi;
+
+        std::vector<Iterator> chunks{mmap.begin()};
+        while (chunks.back() != mmap.end())
+        {
+            const std::size_t chunk_size = CHUNK_SIZE;
+            const auto chunk_end =
+                chunks.back() +
+                std::min<std::size_t>(std::distance(chunks.back(), mmap.end()), chunk_size);
+            const auto line_end = std::find(chunk_end, mmap.end(), '\n');
+            chunks.push_back(line_end == mmap.end() ? line_end : std::next(line_end));
+        }
+
+        std::vector<Lookup> chunk_results(chunks.size() - 1);
+        tbb::parallel_for(std::size_t{0}, chunk_results.size(), [&](const std::size_t chunk) {
             qi::rule<Iterator, std::pair<Key, Value>()> csv_line =
-                (key_rule >> ',' >> value_source) >> -(',' >> *(qi::char_ - qi::eol));
+                (key_rule >> ',' >> value_rule) >> -(',' >> *(qi::char_ - qi::eol));
+
+            auto first = chunks[chunk], last = chunks[chunk + 1];
+            auto &result = chunk_results[chunk];
             const auto ok = qi::parse(first, last, -(csv_line % qi::eol) >> *qi::eol, result);
 
             if (!ok || first != last)
@@ -119,21 +235,82 @@ template <typename Key, typename Value> struct CSVFilesParser
                 throw util::exception(message.str() + SOURCE_REF);
             }
 
-            util::Log() << "Loaded " << filename << " with " << result.size() << "values";
+            std::stable_sort(begin(result), end(result), ByKey);
+        });
 
-            return std::move(result);
+        Lookup result;
+        std::vector<std::size_t> runs{0};
+        for (auto &chunk_result : chunk_results)
+        {
+            result.insert(end(result),
+                          std::make_move_iterator(begin(chunk_result)),
+                          std::make_move_iterator(end(chunk_result)));
+            runs.push_back(result.size());
+            Lookup{}.swap(chunk_result);
         }
-        catch (const boost::exception &e)
+        MergeRuns(result, std::move(runs), ByKey);
+        UniqueOnKey(result);
+
+        return result;
+    }
+
+    static bool IsBinaryFile(const boost::iostreams::mapped_file_source &mmap)
+    {
+        util::FingerPrint fingerprint;
+        if (mmap.size() < sizeof(fingerprint))
+            return false;
+
+        std::copy(mmap.begin(),
+                  mmap.begin() + sizeof(fingerprint),
+                  reinterpret_cast<char *>(&fingerprint));
+        return fingerprint.IsValid();
+    }
+
+    // Binary files store the keys and the values of a lookup as separate vectors
+    static Lookup ReadBinaryFile(const std::string &filename)
+    {
+        const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+        storage::io::FileReader reader{filename, fingerprint};
+
+        std::vector<Key> keys;
+        std::vector<Value> values;
+        storage::serialization::read(reader, keys);
+        storage::serialization::read(reader, values);
+        if (keys.size() != values.size())
         {
-            const auto message = boost::format("exception in loading %1%:\n %2%") % filename %
-                                 boost::diagnostic_information(e);
-            throw util::exception(message.str() + SOURCE_REF);
+            throw util::exception("Lookup file " + filename + " has " +
+                                  std::to_string(keys.size()) + " keys but " +
+                                  std::to_string(values.size()) + " values" + SOURCE_REF);
         }
+
+        Lookup lookup(keys.size());
+        for (const auto index : util::irange<std::size_t>(0, keys.size()))
+        {
+            lookup[index] = {keys[index], values[index]};
+        }
+        return lookup;
+    }
+
+    static void WriteBinaryFile(const std::string &filename, const Lookup &lookup)
+    {
+        std::vector<Key> keys(lookup.size());
+        std::vector<Value> values(lookup.size());
+        for (const auto index : util::irange<std::size_t>(0, lookup.size()))
+        {
+            keys[index] = lookup[index].first;
+            values[index] = lookup[index].second;
+        }
+
+        const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+        storage::io::FileWriter writer{filename, fingerprint};
+        storage::serialization::write(writer, keys);
+        storage::serialization::write(writer, values);
     }
 
     const std::size_t start_index;
     const KeyRule key_rule;
     const ValueRule value_rule;
+    const bool use_cache;
 };
 }
 }
@@ -9,8 +9,16 @@ namespace updater
 {
 namespace csv
 {
-SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths);
-TurnLookupTable readTurnValues(const std::vector<std::string> &paths);
+// Reads the lookup tables from CSV files, `use_cache` keeps a binary copy of each file next to it
+SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths,
+                                     bool use_cache = false);
+TurnLookupTable readTurnValues(const std::vector<std::string> &paths, bool use_cache = false);
+
+// Reads lines of from,to,minute:speed[,minute:speed...] with the breakpoints of a speed profile
+// ordered by minute after midnight. The sources of the files are numbered from `start_index`.
+SpeedProfileLookupTable readSpeedProfiles(const std::vector<std::string> &paths,
+                                          std::size_t start_index,
+                                          bool use_cache = false);
 }
 }
 }
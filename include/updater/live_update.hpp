@@ -0,0 +1,59 @@
+#ifndef OSRM_UPDATER_LIVE_UPDATE_HPP
+#define OSRM_UPDATER_LIVE_UPDATE_HPP
+
+#include "updater/updater_config.hpp"
+
+#include "customizer/edge_based_graph.hpp"
+
+#include "extractor/datasources.hpp"
+#include "extractor/segment_data_container.hpp"
+
+#include "partition/multi_level_partition.hpp"
+
+#include "storage/storage.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace updater
+{
+
+// Applies the segment speed files of `config` on top of the MLD data in shared memory, so
+// speed updates accumulate without reloading or re-customizing the dataset files. Only the
+// segment data, the MLD graph and the cells of the changed edges are rewritten. The dataset
+// files are left unchanged, data loaded from them again does not contain the updates.
+class LiveUpdate final : public storage::DataUpdate
+{
+  public:
+    LiveUpdate(UpdaterConfig config);
+
+    storage::BlockSet Prepare(const storage::DataLayout &in_use_layout,
+                              char *in_use_memory,
+                              storage::DataLayout &layout) override;
+
+    void Write(const storage::DataLayout &layout, char *memory) override;
+
+  private:
+    using SegmentWeightBlock = extractor::SegmentDataView::SegmentWeightVector::block_type;
+    using SegmentDurationBlock = extractor::SegmentDataView::SegmentDurationVector::block_type;
+
+    UpdaterConfig config;
+
+    // updated copies of the segment data blocks in use
+    std::vector<SegmentWeightBlock> fwd_weights;
+    std::vector<SegmentWeightBlock> rev_weights;
+    std::vector<SegmentDurationBlock> fwd_durations;
+    std::vector<SegmentDurationBlock> rev_durations;
+    std::vector<DatasourceID> datasources;
+    extractor::Datasources datasources_names;
+
+    partition::MultiLevelPartition mlp;
+    std::unique_ptr<customizer::MultiLevelEdgeBasedGraph> graph;
+    std::vector<std::vector<bool>> changed_cells;
+};
+}
+}
+
+#endif
@@ -3,8 +3,12 @@
 
 #include "util/typedefs.hpp"
 
+#include <boost/assert.hpp>
 #include <boost/optional.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <vector>
 
 namespace osrm
@@ -55,6 +59,46 @@ struct SpeedSource final
     std::uint8_t source;
 };
 
+// Periodic piecewise linear speed of a segment over a day. The speed is interpolated between
+// breakpoints ordered by minute after midnight, after the last breakpoint it changes towards
+// the first one of the next day.
+struct SpeedProfile final
+{
+    static constexpr std::size_t MAX_BREAKPOINTS = 24;
+    static constexpr std::uint32_t MINUTES_PER_DAY = 24 * 60;
+
+    SpeedProfile() : num_breakpoints(0) {}
+
+    // Speed in km/h at `minute` after midnight
+    double operator()(const std::uint32_t minute) const
+    {
+        BOOST_ASSERT(num_breakpoints > 0);
+        const auto time = static_cast<std::int32_t>(minute % MINUTES_PER_DAY);
+        const auto next =
+            std::upper_bound(minutes.begin(), minutes.begin() + num_breakpoints, time) -
+            minutes.begin();
+
+        // the breakpoints around midnight belong to different days
+        const auto previous_index = next == 0 ? num_breakpoints - 1 : next - 1;
+        const auto next_index = next == num_breakpoints ? 0 : next;
+        const auto previous_minute = std::int32_t{minutes[previous_index]} -
+                                     (next == 0 ? std::int32_t{MINUTES_PER_DAY} : 0);
+        const auto next_minute = std::int32_t{minutes[next_index]} +
+                                 (next == num_breakpoints ? std::int32_t{MINUTES_PER_DAY} : 0);
+        if (next_minute == previous_minute)
+            return speeds[previous_index];
+
+        const auto ratio =
+            static_cast<double>(time - previous_minute) / (next_minute - previous_minute);
+        return speeds[previous_index] + ratio * (speeds[next_index] - speeds[previous_index]);
+    }
+
+    std::array<std::uint16_t, MAX_BREAKPOINTS> minutes;
+    std::array<float, MAX_BREAKPOINTS> speeds;
+    std::uint8_t num_breakpoints;
+    std::uint8_t source;
+};
+
 struct Turn final
 {
     std::uint64_t from, via, to;
@@ -88,6 +132,7 @@ struct PenaltySource final
 
 using SegmentLookupTable = LookupTable<Segment, SpeedSource>;
 using TurnLookupTable = LookupTable<Turn, PenaltySource>;
+using SpeedProfileLookupTable = LookupTable<Segment, SpeedProfile>;
 }
 }
 
@@ -0,0 +1,65 @@
+#ifndef OSRM_UPDATER_TIMEZONE_INDEX_HPP
+#define OSRM_UPDATER_TIMEZONE_INDEX_HPP
+
+#include "updater/updater_config.hpp"
+
+#include "extractor/restriction.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/timezones.hpp"
+
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace updater
+{
+
+const constexpr std::uint32_t INVALID_TIMEZONE_ID = std::numeric_limits<std::uint32_t>::max();
+
+// Time zone of the via node of every conditional turn restriction. Resolving it needs the time
+// zone shapes, the index only keeps the id of the zone of each restriction so evaluating the
+// restrictions again for another time is a lookup per restriction.
+class TimezoneIndex
+{
+  public:
+    TimezoneIndex() = default;
+    TimezoneIndex(std::vector<std::string> names, std::vector<std::uint32_t> timezones);
+    TimezoneIndex(const Timezoner &timezoner,
+                  const std::vector<extractor::TurnRestriction> &restrictions,
+                  const std::vector<util::Coordinate> &coordinates);
+
+    // Id of the time zone of the restriction or INVALID_TIMEZONE_ID if it lies in none
+    std::uint32_t GetTimezoneID(const std::size_t restriction) const
+    {
+        return timezones[restriction];
+    }
+
+    std::size_t GetNumberOfRestrictions() const { return timezones.size(); }
+
+    const std::vector<std::string> &GetTimezoneNames() const { return names; }
+    const std::vector<std::uint32_t> &GetTimezoneIDs() const { return timezones; }
+
+    // Local times at `utc_time` indexed by time zone id
+    // Thread safety: MT-Unsafe const:env
+    std::vector<struct tm> GetLocalTimes(const std::time_t utc_time) const;
+
+  private:
+    std::vector<std::string> names;
+    std::vector<std::uint32_t> timezones;
+};
+
+// Reads the index of `restrictions` from `config.timezone_index_path` if it was built from the
+// current time zone and restriction files. Otherwise the index is built from the time zone
+// shapes and written next to the dataset for the next update.
+TimezoneIndex loadTimezoneIndex(const UpdaterConfig &config,
+                                const std::vector<extractor::TurnRestriction> &restrictions,
+                                const std::vector<util::Coordinate> &coordinates);
+}
+}
+
+#endif
@@ -3,7 +3,10 @@
 
 #include "updater/updater_config.hpp"
 
+#include "extractor/conditional_turn_masks.hpp"
+#include "extractor/datasources.hpp"
 #include "extractor/edge_based_edge.hpp"
+#include "extractor/segment_data_container.hpp"
 
 #include <chrono>
 #include <vector>
@@ -24,7 +27,26 @@ class Updater
     LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
                                    std::vector<EdgeWeight> &node_weights) const;
 
+    // Updates the segment data in place instead of loading it from the dataset files.
+    // The weights of all edges are recomputed from it.
+    EdgeID LoadAndUpdateEdgeExpandedGraph(
+        extractor::SegmentDataView &segment_data,
+        std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list) const;
+
+    // Names of the data sources of the updated segments, "lua profile" and the speed files
+    extractor::Datasources GetDatasources() const;
+
+    // Evaluates the conditional turn restrictions in the time slots of the week of valid_now,
+    // or of the current time without it, for the queries to check at their departure time
+    extractor::ConditionalTurnMasks LoadConditionalTurnMasks() const;
+
   private:
+    template <typename SegmentDataT>
+    EdgeID UpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                                   std::vector<EdgeWeight> &node_weights,
+                                   SegmentDataT &segment_data,
+                                   const bool segment_data_in_memory) const;
+
     UpdaterConfig config;
 };
 }
@@ -31,7 +31,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/filesystem/path.hpp>
 
 #include <chrono>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -55,6 +57,9 @@ struct UpdaterConfig final
         datasource_names_path = osrm_input_path.string() + ".datasource_names";
         profile_properties_path = osrm_input_path.string() + ".properties";
         turn_restrictions_path = osrm_input_path.string() + ".restrictions";
+        timezone_index_path = osrm_input_path.string() + ".restrictions.timezones";
+        conditional_turn_masks_path = osrm_input_path.string() + ".conditional_turns";
+        way_index_path = osrm_input_path.string() + ".way_index";
     }
 
     boost::filesystem::path osrm_input_path;
@@ -75,10 +80,35 @@ struct UpdaterConfig final
 
     std::vector<std::string> segment_speed_lookup_paths;
     std::vector<std::string> turn_penalty_lookup_paths;
+
+    // Periodic speed profiles evaluated at `profile_minute` after midnight, their speeds take
+    // precedence over the ones of the segment speed files
+    std::vector<std::string> speed_profile_lookup_paths;
+    std::uint32_t profile_minute = 0;
+
+    // Binary files of speeds by OSM way, expanded to their segments with the way index written
+    // by osrm-extract --way-index. The speeds of the segment speed files take precedence.
+    std::vector<std::string> way_speed_lookup_paths;
+    std::string way_index_path;
     std::string datasource_names_path;
     std::string profile_properties_path;
     std::string turn_restrictions_path;
     std::string tz_file_path;
+    // Time zones of the conditional restrictions resolved from the shapes in `tz_file_path`
+    std::string timezone_index_path;
+    // Time slots of the week the conditional restrictions apply in, see
+    // `conditional_turns_at_query_time`
+    std::string conditional_turn_masks_path;
+
+    // Leave the weights of conditionally restricted turns as they are, the queries evaluate the
+    // restrictions at their departure time instead
+    bool conditional_turns_at_query_time = false;
+
+    // Keep a binary copy of each lookup file that is read instead while the file is unchanged
+    bool cache_lookup_files = false;
+
+    // Write the updated segment data, turn penalties and datasource names back to the dataset
+    bool save_updated_data = true;
 };
 }
 }
@@ -0,0 +1,64 @@
+#ifndef OSRM_UPDATER_WAY_SPEED_SOURCE_HPP
+#define OSRM_UPDATER_WAY_SPEED_SOURCE_HPP
+
+#include "updater/source.hpp"
+
+#include "extractor/way_index.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace updater
+{
+
+// Binary speed files for whole OSM ways, for feeds that know the ids of the ways they measure
+// speeds on but not the nodes of the ways. A file is a WaySpeedHeader followed by packed
+// little-endian WaySpeedRecords in any order, the later record wins for the same segment.
+struct WaySpeedHeader
+{
+    static constexpr const char MAGIC[8] = {'O', 'S', 'R', 'M', 'W', 'A', 'Y', 'S'};
+    static constexpr std::uint32_t VERSION = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct WaySpeedRecord
+{
+    static constexpr std::uint16_t WAY_END = 0xFFFF;
+    static constexpr std::uint8_t FORWARD = 1;
+    static constexpr std::uint8_t BACKWARD = 2;
+
+    std::uint64_t way_id;
+    // the segments first_segment <= segment < last_segment between the nodes of the way,
+    // WAY_END for all segments up to the end of the way
+    std::uint16_t first_segment;
+    std::uint16_t last_segment;
+    // km/h as in the segment speed files, a rate of NaN falls back to the speed
+    float speed;
+    float rate;
+    // FORWARD along the order of the nodes of the way, BACKWARD against it, or both
+    std::uint8_t directions;
+    std::uint8_t padding[3];
+};
+
+static_assert(sizeof(WaySpeedHeader) == 16, "way speed files have a 16 byte header");
+static_assert(sizeof(WaySpeedRecord) == 24, "way speed files have 24 byte records");
+
+// Reads the records of a way speed file, throws if it is malformed
+std::vector<WaySpeedRecord> readWaySpeedRecords(const std::string &path);
+
+// Speeds of the segments between the nodes of the ways of the files in the way index, the
+// sources of the files are numbered from `start_index`. Records of ways that are not in the
+// index are counted and skipped.
+SegmentLookupTable readWaySpeedValues(const std::vector<std::string> &paths,
+                                      std::size_t start_index,
+                                      const extractor::WayIndex &way_index);
+}
+}
+
+#endif
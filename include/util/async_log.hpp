@@ -0,0 +1,101 @@
+#ifndef OSRM_UTIL_ASYNC_LOG_HPP
+#define OSRM_UTIL_ASYNC_LOG_HPP
+
+#include "util/log.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Writes log lines on a background thread, so that threads that log never wait for the console
+ * or for each other.
+ *
+ * Every thread that pushes a line gets a single producer single consumer ring of its own. The
+ * writer thread drains the rings of all threads every few milliseconds and writes their lines
+ * in batches, the lines of a thread stay in order but lines of different threads may be
+ * interleaved differently than they were logged. Lines that don't fit into the full ring of a
+ * thread are dropped and counted instead of blocking the thread.
+ *
+ * util::Log hands its lines to the instance of GetInstance() while it is running.
+ */
+class AsyncLogWriter
+{
+  public:
+    static const constexpr std::size_t RING_CAPACITY = 4096;
+
+    AsyncLogWriter();
+    ~AsyncLogWriter();
+
+    AsyncLogWriter(const AsyncLogWriter &) = delete;
+    AsyncLogWriter &operator=(const AsyncLogWriter &) = delete;
+
+    static AsyncLogWriter &GetInstance();
+
+    // Starts the writer thread, warnings and errors are written to error_stream
+    void Start(std::ostream &output_stream, std::ostream &error_stream);
+    // Writes the lines still queued and joins the writer thread, lines pushed by threads that
+    // keep logging after that are lost
+    void Stop();
+    bool IsRunning() const { return running; }
+
+    // Queues the line and leaves an empty string in its place, false if the line was dropped
+    bool Push(LogLevel level, std::string &line);
+
+    // Lines dropped since the writer was started
+    std::size_t GetDropped() const { return dropped; }
+
+  private:
+    struct Entry
+    {
+        LogLevel level;
+        std::string line;
+    };
+
+    struct Ring
+    {
+        std::array<Entry, RING_CAPACITY> entries;
+        // only written by the producer
+        std::atomic<std::size_t> head{0};
+        // only written by the writer thread
+        std::atomic<std::size_t> tail{0};
+    };
+
+    Ring &GetLocalRing();
+    // Writes the lines queued in all rings
+    void Drain();
+    void Run();
+
+    const std::uint64_t id;
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<Ring>> rings;
+
+    std::ostream *output_stream = nullptr;
+    std::ostream *error_stream = nullptr;
+    std::string output_batch;
+    std::string error_batch;
+
+    std::atomic<bool> running{false};
+    std::atomic<std::size_t> dropped{0};
+    std::size_t reported_dropped = 0;
+    std::mutex wakeup_mutex;
+    std::condition_variable wakeup;
+    std::thread writer;
+};
+}
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <boost/assert.hpp>
 #include <cmath>
+#include <cstdint>
 #include <string>
 
 namespace osrm
@@ -92,6 +93,42 @@ inline bool CheckInBounds(const int A, const int B, const int range)
     }
 }
 
+// Bearings summarised in 16 bins of 22.5 degrees, bin 0 holds the rounded bearings 0-22,
+// bin 1 23-45 and so on. A set of bins is a mask with one bit per bin.
+using Bins = std::uint16_t;
+const constexpr int NUMBER_OF_BINS = 16;
+const constexpr Bins ALL_BINS = 0xffff;
+
+namespace detail
+{
+inline int BinIndex(const int A) { return ((A % 360) + 360) % 360 * NUMBER_OF_BINS / 360; }
+}
+
+// The bin of the rounded bearing A, modulo 360
+inline Bins BinOf(const int A) { return static_cast<Bins>(1u << detail::BinIndex(A)); }
+
+// The bins of all bearings that CheckInBounds accepts for B and range. The bins are
+// conservative, they may contain bearings that are not in bounds but never miss one.
+inline Bins BinsInBounds(const int B, const int range)
+{
+    // ranges this wide leave out less than a bin, so the interval might start and end in the
+    // same bin
+    if (2 * range + 1 >= 360 - 360 / NUMBER_OF_BINS)
+        return ALL_BINS;
+    if (range < 0)
+        return 0;
+
+    const int last_bin = detail::BinIndex(B + range);
+    Bins bins = 0;
+    for (int bin = detail::BinIndex(B - range);; bin = (bin + 1) % NUMBER_OF_BINS)
+    {
+        bins |= static_cast<Bins>(1u << bin);
+        if (bin == last_bin)
+            break;
+    }
+    return bins;
+}
+
 inline double reverse(const double bearing)
 {
     if (bearing >= 180)
@@ -0,0 +1,211 @@
+#ifndef OSRM_UTIL_BUFFER_CHAIN_HPP
+#define OSRM_UTIL_BUFFER_CHAIN_HPP
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+// Free list of the fixed-size buffers of BufferChain, shared by all threads. Only a bounded
+// number of buffers is kept so a single huge response doesn't pin its memory forever.
+class BufferPool
+{
+  public:
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+    static constexpr std::size_t MAX_POOLED_BUFFERS = 256;
+
+    static BufferPool &GetInstance()
+    {
+        static BufferPool pool;
+        return pool;
+    }
+
+    char *Acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!free_buffers.empty())
+            {
+                auto buffer = free_buffers.back();
+                free_buffers.pop_back();
+                return buffer;
+            }
+        }
+        return new char[BUFFER_SIZE];
+    }
+
+    void Release(char *buffer)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (free_buffers.size() < MAX_POOLED_BUFFERS)
+            {
+                free_buffers.push_back(buffer);
+                return;
+            }
+        }
+        delete[] buffer;
+    }
+
+    ~BufferPool()
+    {
+        for (auto buffer : free_buffers)
+            delete[] buffer;
+    }
+
+  private:
+    BufferPool() = default;
+
+    std::mutex mutex;
+    std::vector<char *> free_buffers;
+};
+}
+
+/**
+ * Output that is written into a chain of fixed-size pooled buffers instead of one contiguous
+ * block, so it never reallocates and copies what was written so far. The buffers can be handed
+ * to a scatter-gather write as they are.
+ *
+ * With a consumer the chain only holds one buffer: every buffer that runs full is passed to
+ * the consumer and reused, the last partial one when calling flush().
+ */
+class BufferChain
+{
+  public:
+    static constexpr std::size_t BUFFER_SIZE = detail::BufferPool::BUFFER_SIZE;
+    using ConsumerT = std::function<void(const char *data, std::size_t size)>;
+
+    BufferChain() = default;
+    explicit BufferChain(ConsumerT consumer_) : consumer(std::move(consumer_)) {}
+
+    BufferChain(const BufferChain &) = delete;
+    BufferChain &operator=(const BufferChain &) = delete;
+
+    BufferChain(BufferChain &&other) noexcept { swap(other); }
+    BufferChain &operator=(BufferChain &&other) noexcept
+    {
+        clear();
+        swap(other);
+        return *this;
+    }
+
+    ~BufferChain() { clear(); }
+
+    void push_back(const char character)
+    {
+        if (last_size == BUFFER_SIZE || buffers.empty())
+            grow();
+        buffers.back()[last_size++] = character;
+    }
+
+    void append(const char *data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            if (last_size == BUFFER_SIZE || buffers.empty())
+                grow();
+            const auto count = std::min(size, BUFFER_SIZE - last_size);
+            std::memcpy(buffers.back() + last_size, data, count);
+            last_size += count;
+            data += count;
+            size -= count;
+        }
+    }
+
+    /// Free space at the end of the chain to be written directly, e.g. by zlib.
+    /// The written bytes have to be added with commit().
+    std::pair<char *, std::size_t> prepare()
+    {
+        if (last_size == BUFFER_SIZE || buffers.empty())
+            grow();
+        return std::make_pair(buffers.back() + last_size, BUFFER_SIZE - last_size);
+    }
+
+    void commit(const std::size_t size)
+    {
+        BOOST_ASSERT(!buffers.empty() && last_size + size <= BUFFER_SIZE);
+        last_size += size;
+    }
+
+    /// Passes the content of the last buffer to the consumer
+    void flush()
+    {
+        BOOST_ASSERT(consumer);
+        if (!buffers.empty() && last_size > 0)
+        {
+            consumer(buffers.back(), last_size);
+            consumed_size += last_size;
+            last_size = 0;
+        }
+    }
+
+    /// Number of bytes written so far, including the ones passed to the consumer
+    std::size_t size() const
+    {
+        if (buffers.empty())
+            return consumed_size;
+        return consumed_size + (buffers.size() - 1) * BUFFER_SIZE + last_size;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t buffer_count() const { return buffers.size(); }
+
+    const char *buffer_data(const std::size_t index) const { return buffers[index]; }
+
+    std::size_t buffer_size(const std::size_t index) const
+    {
+        return index + 1 == buffers.size() ? last_size : BUFFER_SIZE;
+    }
+
+    void clear()
+    {
+        for (auto buffer : buffers)
+            detail::BufferPool::GetInstance().Release(buffer);
+        buffers.clear();
+        last_size = 0;
+        consumed_size = 0;
+    }
+
+  private:
+    void grow()
+    {
+        if (consumer && !buffers.empty())
+        {
+            flush();
+            return;
+        }
+        buffers.push_back(detail::BufferPool::GetInstance().Acquire());
+        last_size = 0;
+    }
+
+    void swap(BufferChain &other)
+    {
+        std::swap(buffers, other.buffers);
+        std::swap(last_size, other.last_size);
+        std::swap(consumed_size, other.consumed_size);
+        std::swap(consumer, other.consumer);
+    }
+
+    std::vector<char *> buffers;
+    std::size_t last_size = 0;
+    std::size_t consumed_size = 0;
+    ConsumerT consumer;
+};
+}
+}
+
+#endif // OSRM_UTIL_BUFFER_CHAIN_HPP
@@ -0,0 +1,98 @@
+#ifndef OSRM_UTIL_COMPRESSED_FILE_HPP
+#define OSRM_UTIL_COMPRESSED_FILE_HPP
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+enum class CompressionCodec : std::uint32_t
+{
+    Zlib = 1,
+    Zstd = 2
+};
+
+CompressionCodec StringToCompressionCodec(const std::string &codec);
+
+// Whether the codec was compiled in, zlib always is and zstd if it was found by the build
+bool IsCodecAvailable(const CompressionCodec codec);
+
+// Uncompressed bytes per frame if not set otherwise
+const constexpr std::size_t DEFAULT_COMPRESSION_FRAME_SIZE = 4 * 1024 * 1024;
+
+/**
+ * Files compressed in independent frames, so parts of them can be decompressed without the
+ * frames before and large parts can be decompressed by several threads at once.
+ *
+ * The file starts with a header holding a magic number, the codec, the uncompressed size of the
+ * frames and of the whole file, and the number of frames. All frames but the last hold
+ * frame_size bytes of the uncompressed file. The compressed frames follow back to back and after
+ * them the index: the offsets in the file all frames start at and the one they end at.
+ */
+struct CompressedFileHeader
+{
+    static const constexpr char MAGIC[8] = {'O', 'S', 'R', 'M', 'Z', 'I', 'P', '1'};
+
+    char magic[8];
+    CompressionCodec codec;
+    std::uint32_t frame_size;
+    std::uint64_t size;
+    std::uint64_t number_of_frames;
+};
+
+// Whether the file starts with the magic number of a compressed file
+bool IsCompressedFile(const boost::filesystem::path &path);
+
+// Compresses the input file into the output file, frames are compressed in parallel
+void CompressFile(const boost::filesystem::path &input_path,
+                  const boost::filesystem::path &output_path,
+                  const CompressionCodec codec,
+                  const int level,
+                  const std::size_t frame_size = DEFAULT_COMPRESSION_FRAME_SIZE);
+
+// Restores the original of a compressed file
+void DecompressFile(const boost::filesystem::path &input_path,
+                    const boost::filesystem::path &output_path);
+
+/**
+ * Reads ranges of the uncompressed contents of a compressed file. The frames a read covers
+ * completely are decompressed in parallel straight into the destination. The last frame read
+ * in part is kept, so small reads one after the other decompress each frame only once.
+ *
+ * Not safe to use from several threads.
+ */
+class CompressedFileReader
+{
+  public:
+    explicit CompressedFileReader(const boost::filesystem::path &path);
+
+    // Size of the uncompressed file
+    std::uint64_t GetSize() const { return header.size; }
+
+    // Reads size bytes of the uncompressed file from the offset, which have to be in the file
+    void Read(const std::uint64_t offset, char *destination, const std::size_t size);
+
+  private:
+    std::size_t GetFrameSize(const std::uint64_t frame) const;
+    void DecompressFrame(const std::uint64_t frame, char *destination) const;
+
+    const boost::filesystem::path path;
+    boost::iostreams::mapped_file_source file;
+    CompressedFileHeader header;
+    std::vector<std::uint64_t> frame_offsets;
+
+    std::vector<char> cached_frame;
+    std::uint64_t cached_frame_index;
+};
+}
+}
+
+#endif
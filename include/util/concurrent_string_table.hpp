@@ -0,0 +1,137 @@
+#ifndef CONCURRENT_STRING_TABLE_HPP
+#define CONCURRENT_STRING_TABLE_HPP
+
+#include "util/string_view.hpp"
+
+#include <boost/interprocess/sync/interprocess_upgradable_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+#include <boost/optional/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Hash table from strings to values for interning strings from many threads.
+ *
+ * The table is split into shards by the hash of the keys, each shard has its own lock so that
+ * threads only wait for each other if they access the same shard. The bytes of the keys are
+ * copied into large blocks of the shard instead of allocating every key on its own, the shards
+ * map views into these blocks. Keys carry their hash so that it can be computed once, outside of
+ * any lock.
+ */
+template <typename ValueType, std::size_t NumberOfShards = 64> class ConcurrentStringTable
+{
+  public:
+    struct Key
+    {
+        StringView string;
+        std::size_t hash;
+    };
+
+    static Key MakeKey(const StringView string)
+    {
+        return {string, std::hash<StringView>()(string)};
+    }
+
+    boost::optional<ValueType> Find(const Key &key) const
+    {
+        const auto &shard = GetShard(key);
+        ScopedReaderLock lock{shard.mutex};
+        const auto iter = shard.values.find(key);
+        if (iter == shard.values.end())
+            return boost::none;
+        return iter->second;
+    }
+
+    // Returns the value of the key and true if the key was added with the given value
+    std::pair<ValueType, bool> FindOrAdd(const Key &key, const ValueType value)
+    {
+        auto &shard = GetShard(key);
+        ScopedWriterLock lock{shard.mutex};
+        const auto iter = shard.values.find(key);
+        if (iter != shard.values.end())
+            return {iter->second, false};
+
+        const Key stored_key{shard.Store(key.string), key.hash};
+        shard.values.emplace(stored_key, value);
+        return {value, true};
+    }
+
+    std::size_t Size() const
+    {
+        std::size_t size = 0;
+        for (const auto &shard : shards)
+        {
+            ScopedReaderLock lock{shard.mutex};
+            size += shard.values.size();
+        }
+        return size;
+    }
+
+  private:
+    using UpgradableMutex = boost::interprocess::interprocess_upgradable_mutex;
+    using ScopedReaderLock = boost::interprocess::sharable_lock<UpgradableMutex>;
+    using ScopedWriterLock = boost::interprocess::scoped_lock<UpgradableMutex>;
+
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const { return key.hash; }
+    };
+    struct KeyEqual
+    {
+        bool operator()(const Key &lhs, const Key &rhs) const { return lhs.string == rhs.string; }
+    };
+
+    struct Shard
+    {
+        // copies the bytes into the current block, keys larger than a block get their own
+        StringView Store(const StringView string)
+        {
+            if (string.empty())
+                return {};
+            if (blocks.empty() || block_used + string.size() > BLOCK_SIZE)
+            {
+                const auto size = std::max(BLOCK_SIZE, string.size());
+                blocks.push_back(std::make_unique<char[]>(size));
+                block_used = 0;
+            }
+            const auto begin = blocks.back().get() + block_used;
+            std::memcpy(begin, string.data(), string.size());
+            block_used += string.size();
+            return {begin, string.size()};
+        }
+
+        std::unordered_map<Key, ValueType, KeyHash, KeyEqual> values;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::size_t block_used = 0;
+        mutable UpgradableMutex mutex;
+    };
+
+    const Shard &GetShard(const Key &key) const
+    {
+        return shards[(key.hash ^ key.hash >> 16) % NumberOfShards];
+    }
+    Shard &GetShard(const Key &key)
+    {
+        return shards[(key.hash ^ key.hash >> 16) % NumberOfShards];
+    }
+
+    std::array<Shard, NumberOfShards> shards;
+};
+}
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef OSRM_UTIL_CONVEX_HULL_HPP
+#define OSRM_UTIL_CONVEX_HULL_HPP
+
+#include "util/coordinate.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+// > 0 if a, b, c make a counter-clockwise turn, < 0 for clockwise and 0 if collinear
+inline std::int64_t
+crossProduct(const Coordinate &a, const Coordinate &b, const Coordinate &c)
+{
+    const auto ax = static_cast<std::int64_t>(static_cast<std::int32_t>(a.lon));
+    const auto ay = static_cast<std::int64_t>(static_cast<std::int32_t>(a.lat));
+    const auto bx = static_cast<std::int64_t>(static_cast<std::int32_t>(b.lon));
+    const auto by = static_cast<std::int64_t>(static_cast<std::int32_t>(b.lat));
+    const auto cx = static_cast<std::int64_t>(static_cast<std::int32_t>(c.lon));
+    const auto cy = static_cast<std::int64_t>(static_cast<std::int32_t>(c.lat));
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+}
+
+// Convex hull of the coordinates as a closed counter-clockwise ring (the first coordinate is
+// repeated at the end) as used by GeoJSON polygons. Uses Andrew's monotone chain on the fixed
+// point coordinates, so it doesn't account for the curvature of the earth.
+inline std::vector<Coordinate> convexHull(std::vector<Coordinate> coordinates)
+{
+    std::sort(coordinates.begin(),
+              coordinates.end(),
+              [](const Coordinate &lhs, const Coordinate &rhs) {
+                  return std::tie(lhs.lon, lhs.lat) < std::tie(rhs.lon, rhs.lat);
+              });
+    coordinates.erase(std::unique(coordinates.begin(), coordinates.end()), coordinates.end());
+
+    if (coordinates.size() < 3)
+    {
+        if (!coordinates.empty())
+            coordinates.push_back(coordinates.front());
+        return coordinates;
+    }
+
+    std::vector<Coordinate> hull(2 * coordinates.size());
+    std::size_t size = 0;
+
+    // lower hull
+    for (const auto &coordinate : coordinates)
+    {
+        while (size >= 2 && detail::crossProduct(hull[size - 2], hull[size - 1], coordinate) <= 0)
+            --size;
+        hull[size++] = coordinate;
+    }
+
+    // upper hull, the last coordinate of the lower hull is its first
+    const auto lower_size = size + 1;
+    for (auto iter = std::next(coordinates.rbegin()); iter != coordinates.rend(); ++iter)
+    {
+        while (size >= lower_size &&
+               detail::crossProduct(hull[size - 2], hull[size - 1], *iter) <= 0)
+            --size;
+        hull[size++] = *iter;
+    }
+
+    // the ring is closed by the first coordinate that was added again by the upper hull
+    hull.resize(size);
+    return hull;
+}
+}
+}
+
+#endif // OSRM_UTIL_CONVEX_HULL_HPP
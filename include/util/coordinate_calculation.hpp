@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <numeric>
 #include <utility>
 #include <vector>
@@ -47,6 +48,23 @@ double haversineDistance(const Coordinate first_coordinate, const Coordinate sec
 
 double greatCircleDistance(const Coordinate first_coordinate, const Coordinate second_coordinate);
 
+// Batched versions of haversineDistance and greatCircleDistance for the pairs first[i],
+// second[i] of count coordinates. They evaluate the same formulas on several pairs at once
+// with polynomial approximations of sin, cos and asin (AVX2 or NEON if the compiler targets
+// them), the results differ from the scalar functions by micrometers.
+void haversineDistances(const Coordinate *first,
+                        const Coordinate *second,
+                        const std::size_t count,
+                        double *distances);
+
+void greatCircleDistances(const Coordinate *first,
+                          const Coordinate *second,
+                          const std::size_t count,
+                          double *distances);
+
+// Sum of the haversine distances between consecutive coordinates of the count coordinates
+double haversineLength(const Coordinate *coordinates, const std::size_t count);
+
 // get the length of a full coordinate vector, using one of our basic functions to compute distances
 template <class BinaryOperation, typename iterator_type>
 double getLength(iterator_type begin, const iterator_type end, BinaryOperation op);
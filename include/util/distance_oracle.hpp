@@ -0,0 +1,140 @@
+#ifndef OSRM_UTIL_DISTANCE_ORACLE_HPP
+#define OSRM_UTIL_DISTANCE_ORACLE_HPP
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class DistanceOracleImpl;
+}
+using DistanceOracle = detail::DistanceOracleImpl<storage::Ownership::Container>;
+using DistanceOracleView = detail::DistanceOracleImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::DistanceOracleImpl<Ownership> &oracle);
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::DistanceOracleImpl<Ownership> &oracle);
+}
+
+namespace detail
+{
+/**
+ * Bounds of the duration of the shortest path between any two nodes out of the durations
+ * between the representatives of the cells of a partition.
+ *
+ * Every cell has a representative node. For every node the oracle stores its cell and the
+ * durations to and from the representative, and for every pair of cells the duration between
+ * their representatives. The path from -> to is at most as long as the detour over both
+ * representatives and at least as long as the path between the representatives minus the
+ * detours to them, so the bounds differ by the durations between both nodes and the
+ * representatives of their cells.
+ */
+template <storage::Ownership Ownership> class DistanceOracleImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    struct Bounds
+    {
+        EdgeDuration lower;
+        EdgeDuration upper;
+    };
+
+    DistanceOracleImpl() = default;
+
+    DistanceOracleImpl(Vector<NodeID> representatives_,
+                       Vector<CellID> cells_,
+                       Vector<EdgeDuration> node_durations_,
+                       Vector<EdgeDuration> cell_durations_)
+        : representatives(std::move(representatives_)), cells(std::move(cells_)),
+          node_durations(std::move(node_durations_)), cell_durations(std::move(cell_durations_))
+    {
+        BOOST_ASSERT(node_durations.size() == 2 * cells.size());
+        BOOST_ASSERT(cell_durations.size() == representatives.size() * representatives.size());
+    }
+
+    std::size_t GetNumberOfCells() const { return representatives.size(); }
+
+    std::size_t GetNumberOfNodes() const { return cells.size(); }
+
+    NodeID GetRepresentative(const CellID cell) const { return representatives[cell]; }
+
+    CellID GetCell(const NodeID node) const { return cells[node]; }
+
+    // Bounds of the duration of the shortest path from -> to, both MAXIMAL_EDGE_DURATION if one
+    // of the nodes isn't connected both ways to the representative of its cell or if there is
+    // no path between the representatives
+    Bounds GetBounds(const NodeID from, const NodeID to) const
+    {
+        BOOST_ASSERT(from < GetNumberOfNodes() && to < GetNumberOfNodes());
+        const auto number_of_cells = representatives.size();
+        const EdgeDuration from_to_representative = node_durations[2 * from];
+        const EdgeDuration representative_to_from = node_durations[2 * from + 1];
+        const EdgeDuration to_to_representative = node_durations[2 * to];
+        const EdgeDuration representative_to_to = node_durations[2 * to + 1];
+        const EdgeDuration between = cell_durations[cells[from] * number_of_cells + cells[to]];
+        if (from_to_representative == MAXIMAL_EDGE_DURATION ||
+            representative_to_from == MAXIMAL_EDGE_DURATION ||
+            to_to_representative == MAXIMAL_EDGE_DURATION ||
+            representative_to_to == MAXIMAL_EDGE_DURATION || between == MAXIMAL_EDGE_DURATION)
+        {
+            return {MAXIMAL_EDGE_DURATION, MAXIMAL_EDGE_DURATION};
+        }
+
+        // between <= representative -> from -> to -> representative
+        const auto lower = std::max(0, between - representative_to_from - to_to_representative);
+        const auto upper = from_to_representative + between + representative_to_to;
+        return {lower, upper};
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               DistanceOracleImpl &oracle);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const DistanceOracleImpl &oracle);
+
+  private:
+    Vector<NodeID> representatives;
+    Vector<CellID> cells;
+    // for every node the duration to the representative followed by the one from it
+    Vector<EdgeDuration> node_durations;
+    // durations between the representatives by rows of the source cell
+    Vector<EdgeDuration> cell_durations;
+};
+}
+
+// Arc of the graph the oracle is computed on
+struct DistanceOracleArc
+{
+    NodeID source;
+    NodeID target;
+    EdgeDuration duration;
+};
+
+// Picks the representative of every cell in the middle of a long path inside of the cell, which
+// keeps the detours to it short, and computes the durations from it to all representatives and
+// between it and the nodes of its cell with two searches over the graph for every cell. cells
+// holds the cell of every node, ids of cells are dense.
+DistanceOracle buildDistanceOracle(const std::vector<DistanceOracleArc> &arcs,
+                                   const std::vector<CellID> &cells,
+                                   const std::size_t number_of_cells);
+}
+}
+
+#endif
@@ -10,6 +10,9 @@
 
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <cstdint>
 
 #include <algorithm>
@@ -243,6 +246,92 @@ template <typename EdgeDataT> class DynamicGraph
         return EdgeIterator(node.first_edge + node.edges);
     }
 
+    // Makes room for `count` more edges behind the edges of every (node, count) pair of
+    // `reservations`, the nodes have to be distinct. Afterwards InsertEdge writes these edges
+    // in place, so edges of different nodes can be inserted in parallel. Nodes without enough
+    // free slots are moved to blocks at the end of the edge list that are cut out of a single
+    // resize in the order of `reservations`. Invalidates edge iterators for the moved nodes.
+    void ReserveEdges(const std::vector<std::pair<NodeIterator, unsigned>> &reservations)
+    {
+        // slots a node can grow into in place, empty for nodes that have to be moved
+        std::vector<std::pair<EdgeIterator, EdgeIterator>> free_slots(reservations.size());
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, reservations.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (const auto index : irange(range.begin(), range.end()))
+                              {
+                                  const auto begin = EndEdges(reservations[index].first);
+                                  const auto end = begin + reservations[index].second;
+                                  if (end > edge_list.size())
+                                      continue;
+                                  auto edge = begin;
+                                  while (edge < end && isDummy(edge))
+                                      ++edge;
+                                  if (edge == end)
+                                      free_slots[index] = {begin, end};
+                              }
+                          });
+
+        // the free slots of an empty node can lie in the gap behind another node,
+        // of overlapping slots only the first ones are used
+        std::vector<std::size_t> by_slots;
+        for (const auto index : irange<std::size_t>(0, reservations.size()))
+            if (free_slots[index].first != free_slots[index].second)
+                by_slots.push_back(index);
+        std::sort(by_slots.begin(), by_slots.end(), [&](const auto lhs, const auto rhs) {
+            return free_slots[lhs] < free_slots[rhs];
+        });
+        EdgeIterator claimed = 0;
+        for (const auto index : by_slots)
+        {
+            if (free_slots[index].first < claimed)
+                free_slots[index] = {};
+            else
+                claimed = free_slots[index].second;
+        }
+
+        const auto old_size = static_cast<EdgeIterator>(edge_list.size());
+        std::vector<EdgeIterator> new_blocks(reservations.size() + 1, old_size);
+        for (const auto index : irange<std::size_t>(0, reservations.size()))
+        {
+            const auto is_moved = free_slots[index].first == free_slots[index].second &&
+                                  reservations[index].second > 0;
+            const auto edges = node_array[reservations[index].first].edges;
+            new_blocks[index + 1] = new_blocks[index] +
+                                    (is_moved ? static_cast<EdgeIterator>(
+                                                    (edges + reservations[index].second) * 1.1 + 2)
+                                              : 0);
+        }
+        if (new_blocks.back() == old_size)
+            return;
+        edge_list.resize(new_blocks.back());
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, reservations.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (const auto index : irange(range.begin(), range.end()))
+                              {
+                                  const auto new_first_edge = new_blocks[index];
+                                  const auto block_end = new_blocks[index + 1];
+                                  if (new_first_edge == block_end)
+                                      continue;
+
+                                  // move the edges over and invalidate the old ones
+                                  Node &node = node_array[reservations[index].first];
+                                  for (const auto i : irange(0u, node.edges))
+                                  {
+                                      edge_list[new_first_edge + i] =
+                                          edge_list[node.first_edge + i];
+                                      makeDummy(node.first_edge + i);
+                                  }
+                                  for (const auto edge :
+                                       irange(new_first_edge + node.edges, block_end))
+                                  {
+                                      makeDummy(edge);
+                                  }
+                                  node.first_edge = new_first_edge;
+                              }
+                          });
+    }
+
     // removes an edge. Invalidates edge iterators for the source node
     void DeleteEdge(const NodeIterator source, const EdgeIterator e)
     {
@@ -7,7 +7,7 @@
 #include <unordered_map>
 #include <vector>
 
-#include "util/concurrent_id_map.hpp"
+#include "util/sharded_id_map.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/functional/hash.hpp>
@@ -98,7 +98,7 @@ class LaneTupleIdPair
     }
 };
 
-using LaneDataIdMap = ConcurrentIDMap<LaneTupleIdPair, LaneDataID, boost::hash<LaneTupleIdPair>>;
+using LaneDataIdMap = ShardedIDMap<LaneTupleIdPair, LaneDataID, boost::hash<LaneTupleIdPair>>;
 
 } // namespace guidance
 } // namespace util
@@ -0,0 +1,50 @@
+#ifndef OSRM_UTIL_HEAP_MEMORY_HPP
+#define OSRM_UTIL_HEAP_MEMORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Bytes held by the search heaps of each thread. The heaps are thread local, so every thread
+ * reports the memory of its own heaps after it used them and the metrics only read the
+ * reported values.
+ */
+class HeapMemoryMetrics
+{
+  public:
+    static HeapMemoryMetrics &GetInstance();
+
+    // Sets the bytes held by the heaps of the calling thread
+    void SetCurrent(const std::size_t bytes);
+
+    // Bytes by thread in Prometheus text format, threads are numbered in the order they first
+    // reported
+    std::string DumpPrometheus() const;
+
+  private:
+    struct ThreadMemory
+    {
+        explicit ThreadMemory(const std::size_t number) : number(number) {}
+
+        const std::size_t number;
+        std::atomic<std::size_t> bytes{0};
+    };
+
+    HeapMemoryMetrics() = default;
+
+    mutable std::mutex threads_lock;
+    std::vector<std::unique_ptr<ThreadMemory>> threads;
+};
+}
+}
+
+#endif // OSRM_UTIL_HEAP_MEMORY_HPP
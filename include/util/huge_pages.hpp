@@ -0,0 +1,58 @@
+#ifndef OSRM_UTIL_HUGE_PAGES_HPP
+#define OSRM_UTIL_HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace osrm
+{
+namespace util
+{
+
+// Pages a block of memory is backed by
+enum class HugePages : std::uint8_t
+{
+    None,        // the default pages of the system
+    Transparent, // transparent huge pages the kernel promotes the block to if it can
+    Explicit     // pages reserved for hugetlbfs
+};
+
+const char *ToString(const HugePages huge_pages);
+
+// Size of the huge pages that can be reserved, 0 if the system has none
+std::size_t GetHugePageSize();
+
+// Rounds the size up to whole huge pages
+std::size_t RoundToHugePages(const std::size_t size);
+
+/**
+ * Zero-initialized memory block of the process. If huge pages are requested they are taken
+ * from the reserved pool, or else the block is marked for transparent huge pages. Without
+ * either it falls back to default pages.
+ */
+class HugePageMemory
+{
+  public:
+    HugePageMemory(const std::size_t size, const bool use_huge_pages);
+    ~HugePageMemory();
+
+    HugePageMemory(const HugePageMemory &) = delete;
+    HugePageMemory &operator=(const HugePageMemory &) = delete;
+
+    char *Get() const { return memory; }
+    HugePages GetHugePages() const { return huge_pages; }
+
+  private:
+    char *memory;
+    void *mapping;
+    std::size_t mapping_size;
+    HugePages huge_pages;
+#ifndef __linux__
+    std::unique_ptr<char[]> fallback;
+#endif
+};
+}
+}
+
+#endif // OSRM_UTIL_HUGE_PAGES_HPP
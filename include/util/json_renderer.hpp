@@ -4,12 +4,16 @@
 #ifndef JSON_RENDERER_HPP
 #define JSON_RENDERER_HPP
 
+#include "util/buffer_chain.hpp"
 #include "util/cast.hpp"
 #include "util/string_util.hpp"
 
 #include "osrm/json_container.hpp"
 
+#include <cmath>
+#include <cstdint>
 #include <iterator>
+#include <limits>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -77,23 +81,102 @@ struct Renderer
     std::ostream &out;
 };
 
-struct ArrayRenderer
+namespace detail
 {
-    explicit ArrayRenderer(std::vector<char> &_out) : out(_out) {}
+inline void append(std::vector<char> &out, const char *data, const std::size_t size)
+{
+    out.insert(out.end(), data, data + size);
+}
+
+inline void append(BufferChain &out, const char *data, const std::size_t size)
+{
+    out.append(data, size);
+}
+
+// Formats numbers like cast::to_string_with_precision: rounded to six decimal digits without
+// trailing zeros, which keeps coordinates at 1e-6 degrees and durations at 0.1 s exact.
+const constexpr double NUMBER_SCALE = 1e6;
+// beyond this the scaled value doesn't fit an integer with all its digits
+const constexpr double MAX_FAST_SCALED_NUMBER = 4503599627370496.; // 2^52
+const constexpr std::size_t NUMBER_BUFFER_SIZE = 32;
+
+// Writes the number to the end of the buffer and returns the start of its characters, or
+// nullptr if the number can't be formatted without printf
+inline const char *formatNumber(const double value, char (&buffer)[NUMBER_BUFFER_SIZE])
+{
+    const auto magnitude = std::abs(value);
+    const auto scaled = magnitude * NUMBER_SCALE;
+    // NaN fails the comparison as well
+    if (!(scaled < MAX_FAST_SCALED_NUMBER))
+        return nullptr;
+
+    // the product is off from the exact scaled value by less than the bound, so rounding it
+    // gives the same digits as printf unless it is that close to halfway between two integers.
+    // Exact halves, like 0.0078125, are rounded to even by printf.
+    const auto error_bound = scaled * std::numeric_limits<double>::epsilon();
+    const auto truncated = std::floor(scaled);
+    if (std::abs(scaled - truncated - 0.5) <= error_bound)
+        return nullptr;
+    auto fixed = static_cast<std::uint64_t>(truncated) + (scaled - truncated > 0.5 ? 1 : 0);
+
+    char *begin = buffer + NUMBER_BUFFER_SIZE;
+    auto fraction = fixed % static_cast<std::uint64_t>(NUMBER_SCALE);
+    fixed /= static_cast<std::uint64_t>(NUMBER_SCALE);
+    if (fraction != 0)
+    {
+        int fraction_digits = 6;
+        while (fraction % 10 == 0)
+        {
+            fraction /= 10;
+            --fraction_digits;
+        }
+        for (; fraction_digits > 0; --fraction_digits)
+        {
+            *--begin = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        *--begin = '.';
+    }
+    do
+    {
+        *--begin = static_cast<char>('0' + fixed % 10);
+        fixed /= 10;
+    } while (fixed != 0);
+    // printf keeps the sign of negative numbers that round to zero
+    if (std::signbit(value))
+        *--begin = '-';
+
+    return begin;
+}
+
+template <typename OutputT> void appendNumber(OutputT &out, const double value)
+{
+    char buffer[NUMBER_BUFFER_SIZE];
+    const auto begin = formatNumber(value, buffer);
+    if (begin != nullptr)
+    {
+        append(out, begin, static_cast<std::size_t>(buffer + NUMBER_BUFFER_SIZE - begin));
+        return;
+    }
+    const std::string number_string = cast::to_string_with_precision(value);
+    append(out, number_string.data(), number_string.size());
+}
+}
+
+// Renders into a std::vector<char> or a BufferChain
+template <typename OutputT> struct BufferRenderer
+{
+    explicit BufferRenderer(OutputT &_out) : out(_out) {}
 
     void operator()(const String &string) const
     {
         out.push_back('\"');
         const auto string_to_insert = escape_JSON(string.value);
-        out.insert(std::end(out), std::begin(string_to_insert), std::end(string_to_insert));
+        detail::append(out, string_to_insert.data(), string_to_insert.size());
         out.push_back('\"');
     }
 
-    void operator()(const Number &number) const
-    {
-        const std::string number_string = cast::to_string_with_precision(number.value);
-        out.insert(out.end(), number_string.begin(), number_string.end());
-    }
+    void operator()(const Number &number) const { detail::appendNumber(out, number.value); }
 
     void operator()(const Object &object) const
     {
@@ -101,11 +184,11 @@ struct ArrayRenderer
         for (auto it = object.values.begin(), end = object.values.end(); it != end;)
         {
             out.push_back('\"');
-            out.insert(out.end(), it->first.begin(), it->first.end());
+            detail::append(out, it->first.data(), it->first.size());
             out.push_back('\"');
             out.push_back(':');
 
-            mapbox::util::apply_visitor(ArrayRenderer(out), it->second);
+            mapbox::util::apply_visitor(BufferRenderer(out), it->second);
             if (++it != end)
             {
                 out.push_back(',');
@@ -119,7 +202,7 @@ struct ArrayRenderer
         out.push_back('[');
         for (auto it = array.values.cbegin(), end = array.values.cend(); it != end;)
         {
-            mapbox::util::apply_visitor(ArrayRenderer(out), *it);
+            mapbox::util::apply_visitor(BufferRenderer(out), *it);
             if (++it != end)
             {
                 out.push_back(',');
@@ -128,38 +211,34 @@ struct ArrayRenderer
         out.push_back(']');
     }
 
-    void operator()(const True &) const
-    {
-        const std::string temp("true");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const True &) const { detail::append(out, "true", 4); }
 
-    void operator()(const False &) const
-    {
-        const std::string temp("false");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const False &) const { detail::append(out, "false", 5); }
 
-    void operator()(const Null &) const
-    {
-        const std::string temp("null");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
+    void operator()(const Null &) const { detail::append(out, "null", 4); }
 
   private:
-    std::vector<char> &out;
+    OutputT &out;
 };
 
+using ArrayRenderer = BufferRenderer<std::vector<char>>;
+
 inline void render(std::ostream &out, const Object &object)
 {
-    Value value = object;
-    mapbox::util::apply_visitor(Renderer(out), value);
+    const Renderer renderer(out);
+    renderer(object);
 }
 
 inline void render(std::vector<char> &out, const Object &object)
 {
-    Value value = object;
-    mapbox::util::apply_visitor(ArrayRenderer(out), value);
+    const ArrayRenderer renderer(out);
+    renderer(object);
+}
+
+inline void render(BufferChain &out, const Object &object)
+{
+    const BufferRenderer<BufferChain> renderer(out);
+    renderer(object);
 }
 
 } // namespace json
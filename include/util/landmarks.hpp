@@ -0,0 +1,159 @@
+#ifndef OSRM_UTIL_LANDMARKS_HPP
+#define OSRM_UTIL_LANDMARKS_HPP
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class LandmarksImpl;
+}
+using Landmarks = detail::LandmarksImpl<storage::Ownership::Container>;
+using LandmarksView = detail::LandmarksImpl<storage::Ownership::View>;
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::LandmarksImpl<Ownership> &landmarks);
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::LandmarksImpl<Ownership> &landmarks);
+}
+
+namespace detail
+{
+/**
+ * Shortest path weights between every node and a few landmarks, for lower bounds of the weight
+ * between any two nodes by the triangle inequality (ALT).
+ *
+ * The weights are stored in 16 bits as multiples of a unit of each landmark, rounded down, so
+ * the largest weight of a landmark still fits. The weights of a node are stored together, for
+ * every landmark the weight to it followed by the weight from it.
+ */
+template <storage::Ownership Ownership> class LandmarksImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    using Distance = std::uint16_t;
+    static constexpr Distance UNREACHABLE = std::numeric_limits<Distance>::max();
+
+    LandmarksImpl() = default;
+
+    LandmarksImpl(Vector<NodeID> landmarks_, Vector<EdgeWeight> units_, Vector<Distance> distances_)
+        : landmarks(std::move(landmarks_)), units(std::move(units_)),
+          distances(std::move(distances_))
+    {
+        BOOST_ASSERT(landmarks.size() == units.size());
+        BOOST_ASSERT(landmarks.empty() || distances.size() % (2 * landmarks.size()) == 0);
+    }
+
+    std::size_t GetNumberOfLandmarks() const { return landmarks.size(); }
+
+    std::size_t GetNumberOfNodes() const
+    {
+        return landmarks.empty() ? 0 : distances.size() / (2 * landmarks.size());
+    }
+
+    NodeID GetLandmark(const std::size_t index) const { return landmarks[index]; }
+
+    // Lower bound of the weight of the shortest path from -> to, 0 if the landmarks give none
+    EdgeWeight GetLowerBound(const NodeID from, const NodeID to) const
+    {
+        const auto stride = 2 * landmarks.size();
+        BOOST_ASSERT(from < GetNumberOfNodes() && to < GetNumberOfNodes());
+        const Distance *from_distances = distances.data() + from * stride;
+        const Distance *to_distances = distances.data() + to * stride;
+
+        EdgeWeight bound = 0;
+        for (std::size_t index = 0; index < landmarks.size(); ++index)
+        {
+            // the rounded down weights are up to one unit short
+            const EdgeWeight unit = units[index];
+            const EdgeWeight slack = unit - 1;
+
+            // weight(from -> to) >= weight(from -> landmark) - weight(to -> landmark)
+            const Distance from_to_landmark = from_distances[2 * index];
+            const Distance to_to_landmark = to_distances[2 * index];
+            if (from_to_landmark != UNREACHABLE && to_to_landmark != UNREACHABLE)
+            {
+                bound = std::max(bound, (from_to_landmark - to_to_landmark) * unit - slack);
+            }
+
+            // weight(from -> to) >= weight(landmark -> to) - weight(landmark -> from)
+            const Distance landmark_to_from = from_distances[2 * index + 1];
+            const Distance landmark_to_to = to_distances[2 * index + 1];
+            if (landmark_to_from != UNREACHABLE && landmark_to_to != UNREACHABLE)
+            {
+                bound = std::max(bound, (landmark_to_to - landmark_to_from) * unit - slack);
+            }
+        }
+        return bound;
+    }
+
+    // Moves the weights of every node to its new id, node ids are renumbered to permutation[id]
+    void Renumber(const std::vector<std::uint32_t> &permutation)
+    {
+        BOOST_ASSERT(permutation.size() == GetNumberOfNodes());
+        const auto stride = 2 * landmarks.size();
+        Vector<Distance> renumbered(distances.size());
+        for (std::size_t node = 0; node < permutation.size(); ++node)
+        {
+            std::copy(distances.begin() + node * stride,
+                      distances.begin() + (node + 1) * stride,
+                      renumbered.begin() + permutation[node] * stride);
+        }
+        distances = std::move(renumbered);
+        for (auto &landmark : landmarks)
+            landmark = permutation[landmark];
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               LandmarksImpl &landmarks);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const LandmarksImpl &landmarks);
+
+  private:
+    Vector<NodeID> landmarks;
+    Vector<EdgeWeight> units;
+    Vector<Distance> distances;
+};
+
+template <storage::Ownership Ownership>
+constexpr typename LandmarksImpl<Ownership>::Distance LandmarksImpl<Ownership>::UNREACHABLE;
+}
+
+// Arc of the graph the landmarks are selected on
+struct LandmarkArc
+{
+    NodeID source;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+// Selects the landmarks with the avoid heuristic and computes the weights between them and all
+// nodes. The first landmark is the node farthest from a random node, every further landmark is
+// a leaf of the largest subtree of a shortest path tree that the lower bounds of the landmarks
+// selected so far cover badly.
+Landmarks buildLandmarks(const std::size_t number_of_nodes,
+                         const std::vector<LandmarkArc> &arcs,
+                         const std::size_t number_of_landmarks);
+}
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef OSRM_UTIL_LRU_CACHE_HPP
+#define OSRM_UTIL_LRU_CACHE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Thread-safe least-recently-used cache. Entries are distributed over independently locked
+// shards by their hash, so concurrent lookups of different keys rarely contend on a mutex.
+// Every shard evicts its own least recently used entry once it is full.
+template <typename Key, typename Value, typename Hash = std::hash<Key>> class ShardedLRUCache
+{
+    struct Shard
+    {
+        using Entry = std::pair<Key, Value>;
+        using EntryList = std::list<Entry>;
+
+        std::mutex mutex;
+        EntryList entries;
+        std::unordered_map<Key, typename EntryList::iterator, Hash> index;
+    };
+
+  public:
+    explicit ShardedLRUCache(const std::size_t capacity, const std::size_t number_of_shards = 16)
+        : shard_capacity(
+              std::max<std::size_t>(1, capacity / std::max<std::size_t>(1, number_of_shards))),
+          shards(std::max<std::size_t>(1, number_of_shards)), hits(0), misses(0)
+    {
+        for (auto &shard : shards)
+        {
+            shard = std::make_unique<Shard>();
+        }
+    }
+
+    boost::optional<Value> Get(const Key &key)
+    {
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const auto iter = shard.index.find(key);
+        if (iter == shard.index.end())
+        {
+            misses++;
+            return boost::none;
+        }
+
+        // move the entry to the front of the recently used list
+        shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+        hits++;
+        return iter->second->second;
+    }
+
+    void Put(const Key &key, Value value)
+    {
+        auto &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        const auto iter = shard.index.find(key);
+        if (iter != shard.index.end())
+        {
+            iter->second->second = std::move(value);
+            shard.entries.splice(shard.entries.begin(), shard.entries, iter->second);
+            return;
+        }
+
+        if (shard.entries.size() >= shard_capacity)
+        {
+            BOOST_ASSERT(!shard.entries.empty());
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+
+        shard.entries.emplace_front(key, std::move(value));
+        shard.index.emplace(key, shard.entries.begin());
+    }
+
+    void Clear()
+    {
+        for (auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->entries.clear();
+            shard->index.clear();
+        }
+    }
+
+    std::size_t Size() const
+    {
+        std::size_t size = 0;
+        for (const auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            size += shard->entries.size();
+        }
+        return size;
+    }
+
+    std::uint64_t Hits() const { return hits; }
+    std::uint64_t Misses() const { return misses; }
+
+  private:
+    Shard &GetShard(const Key &key) { return *shards[Hash()(key) % shards.size()]; }
+
+    const std::size_t shard_capacity;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> misses;
+};
+}
+}
+
+#endif // OSRM_UTIL_LRU_CACHE_HPP
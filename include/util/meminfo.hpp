@@ -6,8 +6,14 @@
 #include <stxxl/mng>
 #ifndef _WIN32
 #include <sys/resource.h>
+#include <unistd.h>
 #endif
 
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <string>
+
 namespace osrm
 {
 namespace util
@@ -25,6 +31,37 @@ inline void DumpSTXXLStats()
 #endif
 }
 
+// Bytes of memory that can be allocated without swapping, 0 if unknown
+inline std::size_t GetAvailableMemory()
+{
+#ifdef __linux__
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line))
+    {
+        // e.g. "MemAvailable:   16096360 kB", counts the page cache that can be dropped
+        if (line.compare(0, 13, "MemAvailable:") == 0)
+        {
+            try
+            {
+                return static_cast<std::size_t>(std::stoull(line.substr(13))) * 1024;
+            }
+            catch (const std::exception &)
+            {
+                break;
+            }
+        }
+    }
+#endif
+#if !defined(_WIN32) && defined(_SC_AVPHYS_PAGES)
+    const auto pages = sysconf(_SC_AVPHYS_PAGES);
+    const auto page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0)
+        return static_cast<std::size_t>(pages) * static_cast<std::size_t>(page_size);
+#endif
+    return 0;
+}
+
 inline void DumpMemoryStats()
 {
 #ifndef _WIN32
@@ -8,11 +8,30 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace osrm
 {
 namespace util
 {
 
+// How the pages of a mapped file are read from it
+enum class MappedFileAccess : std::uint8_t
+{
+    Default,  // the kernel reads ahead around the faulting page
+    Random,   // only the faulting page is read, for scattered accesses
+    Prefault  // all pages are read and mapped up front, so accesses do not fault
+};
+
+// Advises the kernel of the access pattern of a mapping, only has an effect on Linux. With
+// Prefault this returns once all pages of the mapping are resident.
+void adviseMappedFile(const char *data, const std::size_t size, const MappedFileAccess access);
+
+// Bytes of [data, data + size) that lie on pages which are in RAM, measured with mincore on
+// Linux. Elsewhere all bytes are reported as resident.
+std::size_t getResidentBytes(const char *data, const std::size_t size);
+
 namespace detail
 {
 template <typename T, typename RegionT>
@@ -5,7 +5,9 @@
 #include "util/string_view.hpp"
 #include "util/typedefs.hpp"
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -22,6 +24,13 @@ class NameTable
     using ResultType = IndexedData::ResultType;
     using ValueType = IndexedData::ValueType;
 
+    // A string repeating an earlier one of at least MIN_DEDUPLICATED_LENGTH bytes can be stored
+    // as a reference to it: REFERENCE_MARKER followed by the index of the earlier string.
+    // The marker never starts a string of valid UTF-8, lookups still return views into the data.
+    static constexpr unsigned char REFERENCE_MARKER = 0xff;
+    static constexpr std::size_t REFERENCE_SIZE = 1 + sizeof(std::uint32_t);
+    static constexpr std::size_t MIN_DEDUPLICATED_LENGTH = 8;
+
     NameTable() {}
 
     // Read filename and store own data in m_buffer
@@ -39,7 +48,22 @@ class NameTable
     util::StringView GetRefForID(const NameID id) const;
     util::StringView GetPronunciationForID(const NameID id) const;
 
+    // True if a string would be read as a reference, no valid name looks like one
+    static bool IsReference(const util::StringView string)
+    {
+        return string.size() == REFERENCE_SIZE &&
+               static_cast<unsigned char>(string.front()) == REFERENCE_MARKER;
+    }
+
+    // Replaces the repeated strings of the data by references to their first copy,
+    // offsets holds the offset of every string into data followed by the total data size.
+    // Returns the number of bytes saved.
+    static std::size_t Deduplicate(std::vector<std::uint32_t> &offsets,
+                                   std::vector<unsigned char> &data);
+
   private:
+    util::StringView Get(const std::uint32_t index) const;
+
     using BufferType = std::unique_ptr<ValueType, std::function<void(void *)>>;
 
     BufferType m_buffer;
@@ -6,10 +6,17 @@
 #include "extractor/node_based_edge.hpp"
 #include "util/dynamic_graph.hpp"
 #include "util/graph_utils.hpp"
+#include "util/integer_range.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
 
+#include <boost/assert.hpp>
+
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace osrm
 {
@@ -109,6 +116,111 @@ NodeBasedDynamicGraphFromEdges(NodeID number_of_nodes,
 
     return graph;
 }
+
+/// The compressed node based graph in compressed sparse row format.
+///
+/// The graph is not modified after compression, so the edges of all nodes are stored in one
+/// contiguous range without the gaps a DynamicGraph leaves for insertions and deletions. The
+/// targets and the edge annotations are separate arrays: walking the adjacency of a node only
+/// touches the targets until the data of an edge is actually needed.
+class NodeBasedStaticGraph
+{
+  public:
+    using NodeIterator = NodeID;
+    using EdgeIterator = EdgeID;
+    using EdgeData = NodeBasedEdgeData;
+    using EdgeRange = range<EdgeIterator>;
+
+    NodeBasedStaticGraph() : first_edges(1, 0) {}
+
+    /// Compacts the edges of the compressed graph, `new_edge_ids` maps the edge ids of `graph`
+    /// to the ones of the compacted graph. Deleted edges are mapped to SPECIAL_EDGEID. The
+    /// edges of every node keep their order.
+    NodeBasedStaticGraph(const NodeBasedDynamicGraph &graph, std::vector<EdgeID> &new_edge_ids)
+    {
+        const auto number_of_nodes = graph.GetNumberOfNodes();
+
+        first_edges.resize(number_of_nodes + 1);
+        first_edges[0] = 0;
+        EdgeID number_of_old_edges = 0;
+        for (const auto node : irange(0u, number_of_nodes))
+        {
+            first_edges[node + 1] = first_edges[node] + graph.GetOutDegree(node);
+            number_of_old_edges = std::max(number_of_old_edges, graph.EndEdges(node));
+        }
+        BOOST_ASSERT(first_edges.back() == graph.GetNumberOfEdges());
+
+        targets.resize(first_edges.back());
+        edge_data.resize(first_edges.back());
+        new_edge_ids.assign(number_of_old_edges, SPECIAL_EDGEID);
+
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                          [&](const tbb::blocked_range<NodeID> &nodes) {
+                              for (const auto node : irange(nodes.begin(), nodes.end()))
+                              {
+                                  auto new_edge = first_edges[node];
+                                  for (const auto edge : graph.GetAdjacentEdgeRange(node))
+                                  {
+                                      targets[new_edge] = graph.GetTarget(edge);
+                                      edge_data[new_edge] = graph.GetEdgeData(edge);
+                                      new_edge_ids[edge] = new_edge++;
+                                  }
+                                  BOOST_ASSERT(new_edge == first_edges[node + 1]);
+                              }
+                          });
+    }
+
+    unsigned GetNumberOfNodes() const { return first_edges.size() - 1; }
+
+    unsigned GetNumberOfEdges() const { return targets.size(); }
+
+    unsigned GetOutDegree(const NodeIterator n) const
+    {
+        return first_edges[n + 1] - first_edges[n];
+    }
+
+    unsigned GetDirectedOutDegree(const NodeIterator n) const
+    {
+        return std::count_if(edge_data.begin() + BeginEdges(n),
+                             edge_data.begin() + EndEdges(n),
+                             [](const EdgeData &data) { return !data.reversed; });
+    }
+
+    NodeIterator GetTarget(const EdgeIterator e) const { return targets[e]; }
+
+    EdgeData &GetEdgeData(const EdgeIterator e) { return edge_data[e]; }
+
+    const EdgeData &GetEdgeData(const EdgeIterator e) const { return edge_data[e]; }
+
+    EdgeIterator BeginEdges(const NodeIterator n) const { return first_edges[n]; }
+
+    EdgeIterator EndEdges(const NodeIterator n) const { return first_edges[n + 1]; }
+
+    EdgeRange GetAdjacentEdgeRange(const NodeIterator n) const
+    {
+        return irange(BeginEdges(n), EndEdges(n));
+    }
+
+    // searches for a specific edge
+    EdgeIterator FindEdge(const NodeIterator from, const NodeIterator to) const
+    {
+        const auto begin = targets.begin() + BeginEdges(from);
+        const auto end = targets.begin() + EndEdges(from);
+        const auto iter = std::find(begin, end, to);
+        return iter == end ? SPECIAL_EDGEID : static_cast<EdgeIterator>(iter - targets.begin());
+    }
+
+    EdgeIterator FindEdgeInEitherDirection(const NodeIterator from, const NodeIterator to) const
+    {
+        const auto edge = FindEdge(from, to);
+        return SPECIAL_EDGEID != edge ? edge : FindEdge(to, from);
+    }
+
+  private:
+    std::vector<EdgeIterator> first_edges;
+    std::vector<NodeIterator> targets;
+    std::vector<EdgeData> edge_data;
+};
 }
 }
 
@@ -0,0 +1,41 @@
+#ifndef OSRM_UTIL_NUMA_HPP
+#define OSRM_UTIL_NUMA_HPP
+
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Ids of the NUMA nodes that have memory. Systems that don't report their topology, like
+// anything but Linux, have a single node 0.
+std::vector<unsigned> GetNUMANodes();
+
+// Cores of the NUMA node, empty if they are not known
+std::vector<unsigned> GetNUMANodeCPUs(const unsigned node);
+
+// NUMA node of the core the calling thread runs on
+unsigned GetCurrentNUMANode();
+
+// Memory the calling thread touches first is allocated on the node until the binding is
+// destroyed. Pages that were already allocated stay where they are.
+class ScopedNUMABinding
+{
+  public:
+    explicit ScopedNUMABinding(const unsigned node);
+    ~ScopedNUMABinding();
+
+    ScopedNUMABinding(const ScopedNUMABinding &) = delete;
+    ScopedNUMABinding &operator=(const ScopedNUMABinding &) = delete;
+
+    // false if the system doesn't support binding memory to nodes
+    bool IsBound() const { return bound; }
+
+  private:
+    bool bound;
+};
+}
+}
+
+#endif // OSRM_UTIL_NUMA_HPP
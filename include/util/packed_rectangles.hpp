@@ -0,0 +1,218 @@
+#ifndef OSRM_UTIL_PACKED_RECTANGLES_HPP
+#define OSRM_UTIL_PACKED_RECTANGLES_HPP
+
+#include "util/coordinate.hpp"
+#include "util/rectangle.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+// Same result as RectangleInt2D::GetMinSquaredDist for a range of rectangles of which the
+// bounds are stored in separate arrays. Coordinate differences fit into 32 bit, only their
+// squares need 64 bit.
+inline void minSquaredDistancesScalar(const std::int32_t *min_lon,
+                                      const std::int32_t *max_lon,
+                                      const std::int32_t *min_lat,
+                                      const std::int32_t *max_lat,
+                                      const std::size_t count,
+                                      const std::int32_t lon,
+                                      const std::int32_t lat,
+                                      std::uint64_t *squared_distances)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::int64_t d_lon = std::max(std::max(min_lon[i] - lon, lon - max_lon[i]), 0);
+        const std::int64_t d_lat = std::max(std::max(min_lat[i] - lat, lat - max_lat[i]), 0);
+        squared_distances[i] = static_cast<std::uint64_t>(d_lon * d_lon + d_lat * d_lat);
+    }
+}
+
+#if defined(__AVX2__)
+inline void minSquaredDistances(const std::int32_t *min_lon,
+                                const std::int32_t *max_lon,
+                                const std::int32_t *min_lat,
+                                const std::int32_t *max_lat,
+                                const std::size_t count,
+                                const std::int32_t lon,
+                                const std::int32_t lat,
+                                std::uint64_t *squared_distances)
+{
+    const auto lon_v = _mm256_set1_epi32(lon);
+    const auto lat_v = _mm256_set1_epi32(lat);
+    const auto zero = _mm256_setzero_si256();
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        // distance to the interval [min, max], zero inside of it
+        const auto difference =
+            [i, zero](const std::int32_t *min_values, const std::int32_t *max_values, __m256i v) {
+                const auto below = _mm256_sub_epi32(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(min_values + i)), v);
+                const auto above = _mm256_sub_epi32(
+                    v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(max_values + i)));
+                return _mm256_max_epi32(_mm256_max_epi32(below, above), zero);
+            };
+        const auto d_lon = difference(min_lon, max_lon, lon_v);
+        const auto d_lat = difference(min_lat, max_lat, lat_v);
+
+        // 32 x 32 -> 64 bit products of the even elements, then of the odd ones
+        const auto even = _mm256_add_epi64(_mm256_mul_epi32(d_lon, d_lon),
+                                           _mm256_mul_epi32(d_lat, d_lat));
+        const auto d_lon_odd = _mm256_srli_epi64(d_lon, 32);
+        const auto d_lat_odd = _mm256_srli_epi64(d_lat, 32);
+        const auto odd = _mm256_add_epi64(_mm256_mul_epi32(d_lon_odd, d_lon_odd),
+                                          _mm256_mul_epi32(d_lat_odd, d_lat_odd));
+
+        // back into element order: 0 1 | 4 5 and 2 3 | 6 7, then 0 1 2 3 and 4 5 6 7
+        const auto low = _mm256_unpacklo_epi64(even, odd);
+        const auto high = _mm256_unpackhi_epi64(even, odd);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(squared_distances + i),
+                            _mm256_permute2x128_si256(low, high, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(squared_distances + i + 4),
+                            _mm256_permute2x128_si256(low, high, 0x31));
+    }
+
+    minSquaredDistancesScalar(min_lon + i,
+                              max_lon + i,
+                              min_lat + i,
+                              max_lat + i,
+                              count - i,
+                              lon,
+                              lat,
+                              squared_distances + i);
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+inline void minSquaredDistances(const std::int32_t *min_lon,
+                                const std::int32_t *max_lon,
+                                const std::int32_t *min_lat,
+                                const std::int32_t *max_lat,
+                                const std::size_t count,
+                                const std::int32_t lon,
+                                const std::int32_t lat,
+                                std::uint64_t *squared_distances)
+{
+    const auto lon_v = vdupq_n_s32(lon);
+    const auto lat_v = vdupq_n_s32(lat);
+    const auto zero = vdupq_n_s32(0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto d_lon = vmaxq_s32(vmaxq_s32(vsubq_s32(vld1q_s32(min_lon + i), lon_v),
+                                               vsubq_s32(lon_v, vld1q_s32(max_lon + i))),
+                                     zero);
+        const auto d_lat = vmaxq_s32(vmaxq_s32(vsubq_s32(vld1q_s32(min_lat + i), lat_v),
+                                               vsubq_s32(lat_v, vld1q_s32(max_lat + i))),
+                                     zero);
+
+        const auto low = vmlal_s32(vmull_s32(vget_low_s32(d_lon), vget_low_s32(d_lon)),
+                                   vget_low_s32(d_lat),
+                                   vget_low_s32(d_lat));
+        const auto high = vmlal_s32(vmull_s32(vget_high_s32(d_lon), vget_high_s32(d_lon)),
+                                    vget_high_s32(d_lat),
+                                    vget_high_s32(d_lat));
+        vst1q_u64(squared_distances + i, vreinterpretq_u64_s64(low));
+        vst1q_u64(squared_distances + i + 2, vreinterpretq_u64_s64(high));
+    }
+
+    minSquaredDistancesScalar(min_lon + i,
+                              max_lon + i,
+                              min_lat + i,
+                              max_lat + i,
+                              count - i,
+                              lon,
+                              lat,
+                              squared_distances + i);
+}
+#else
+inline void minSquaredDistances(const std::int32_t *min_lon,
+                                const std::int32_t *max_lon,
+                                const std::int32_t *min_lat,
+                                const std::int32_t *max_lat,
+                                const std::size_t count,
+                                const std::int32_t lon,
+                                const std::int32_t lat,
+                                std::uint64_t *squared_distances)
+{
+    minSquaredDistancesScalar(
+        min_lon, max_lon, min_lat, max_lat, count, lon, lat, squared_distances);
+}
+#endif
+}
+
+/**
+ * Bounds of rectangles in a structure-of-arrays layout, so the distances of a location to
+ * consecutive rectangles can be computed with vector instructions.
+ * AVX2 and NEON kernels are used if the compiler targets them, otherwise a scalar loop.
+ */
+class PackedRectangles
+{
+  public:
+    PackedRectangles() = default;
+
+    template <typename Iterator, typename GetRectangleT>
+    PackedRectangles(Iterator first, const Iterator last, const GetRectangleT get_rectangle)
+    {
+        const auto size = static_cast<std::size_t>(std::distance(first, last));
+        min_lon.reserve(size);
+        max_lon.reserve(size);
+        min_lat.reserve(size);
+        max_lat.reserve(size);
+        for (; first != last; ++first)
+        {
+            const RectangleInt2D &rectangle = get_rectangle(*first);
+            min_lon.push_back(static_cast<std::int32_t>(rectangle.min_lon));
+            max_lon.push_back(static_cast<std::int32_t>(rectangle.max_lon));
+            min_lat.push_back(static_cast<std::int32_t>(rectangle.min_lat));
+            max_lat.push_back(static_cast<std::int32_t>(rectangle.max_lat));
+        }
+    }
+
+    std::size_t size() const { return min_lon.size(); }
+
+    // Writes the squared distances of the location to the rectangles [first, first + count)
+    void GetMinSquaredDists(const std::size_t first,
+                            const std::size_t count,
+                            const Coordinate location,
+                            std::uint64_t *squared_distances) const
+    {
+        BOOST_ASSERT(first + count <= size());
+        detail::minSquaredDistances(min_lon.data() + first,
+                                    max_lon.data() + first,
+                                    min_lat.data() + first,
+                                    max_lat.data() + first,
+                                    count,
+                                    static_cast<std::int32_t>(location.lon),
+                                    static_cast<std::int32_t>(location.lat),
+                                    squared_distances);
+    }
+
+  private:
+    std::vector<std::int32_t> min_lon;
+    std::vector<std::int32_t> max_lon;
+    std::vector<std::int32_t> min_lat;
+    std::vector<std::int32_t> max_lat;
+};
+}
+}
+
+#endif // OSRM_UTIL_PACKED_RECTANGLES_HPP
@@ -96,6 +96,7 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
     static_assert(Bits <= sizeof(WordT) * CHAR_BIT, "Maximum number of bits is 64.");
 
     static constexpr std::size_t WORD_BITS = sizeof(WordT) * CHAR_BIT;
+    static constexpr WordT VALUE_MASK = Bits == WORD_BITS ? ~WordT{0} : (WordT{1} << Bits) - 1;
     // number of elements per block, use the number of bits so we make sure
     // we can devide the total number of bits by the element bis
   public:
@@ -427,6 +428,70 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
         BOOST_ASSERT(static_cast<T>(back()) == value);
     }
 
+    // Decodes the elements [first, last) to out. The blocks are stored back to back, so the
+    // elements form one stream of bits that is read a word at a time without the block lookups
+    // of the element access.
+    template <typename OutputIterator>
+    OutputIterator
+    decode_range(const std::size_t first, const std::size_t last, OutputIterator out) const
+    {
+        BOOST_ASSERT(first <= last && last <= num_elements);
+
+        const auto first_bit = first * Bits;
+        auto word_index = first_bit / WORD_BITS;
+        std::size_t offset = first_bit % WORD_BITS;
+        for (auto index = first; index < last; ++index)
+        {
+            auto word = vec[word_index] >> offset;
+            // the sentinel word makes the upper word of the last element safe to read
+            if (offset + Bits > WORD_BITS)
+                word |= vec[word_index + 1] << (WORD_BITS - offset);
+            *out++ = get_lower_half_value<WordT, T>(word, VALUE_MASK, 0);
+
+            offset += Bits;
+            word_index += offset / WORD_BITS;
+            offset %= WORD_BITS;
+        }
+        return out;
+    }
+
+    // Encodes the values [begin, end) to the elements starting at first. Every word is
+    // written once, words shared with other elements are merged like set_value does, so
+    // neighbouring ranges can still be encoded in parallel.
+    template <typename InputIterator>
+    void encode_range(const std::size_t first, InputIterator begin, const InputIterator end)
+    {
+        const auto first_bit = first * Bits;
+        auto word_index = first_bit / WORD_BITS;
+        std::size_t offset = first_bit % WORD_BITS;
+        WordT word = 0;
+        WordT word_mask = 0;
+        for (auto index = first; begin != end; ++begin, ++index)
+        {
+            BOOST_ASSERT(index < num_elements);
+            const auto value = static_cast<WordT>(*begin);
+            BOOST_ASSERT_MSG(value <= VALUE_MASK, "Value too big for packed storage.");
+
+            word |= value << offset;
+            word_mask |= VALUE_MASK << offset;
+            if (offset + Bits < WORD_BITS)
+            {
+                offset += Bits;
+                continue;
+            }
+
+            merge_word(word_index, word, word_mask);
+            // the upper bits of the value start the next word
+            const auto shift = WORD_BITS - offset;
+            word = shift < WORD_BITS ? value >> shift : 0;
+            word_mask = shift < WORD_BITS ? VALUE_MASK >> shift : 0;
+            offset = offset + Bits - WORD_BITS;
+            ++word_index;
+        }
+        if (word_mask != 0)
+            merge_word(word_index, word, word_mask);
+    }
+
     std::size_t size() const { return num_elements; }
 
     void resize(std::size_t elements)
@@ -530,6 +595,25 @@ template <typename T, std::size_t Bits, storage::Ownership Ownership> class Pack
                      .compare_and_swap(new_upper_word, local_upper_word) != local_upper_word);
     }
 
+    // Sets the bits of the mask in the word at index to their value in bits
+    inline void merge_word(const std::size_t index, const WordT bits, const WordT mask)
+    {
+        auto &word = vec[index];
+        if (mask == ~WordT{0})
+        {
+            word = bits;
+            return;
+        }
+
+        WordT local_word, new_word;
+        do
+        {
+            local_word = word;
+            new_word = (local_word & ~mask) | (bits & mask);
+        } while (tbb::internal::as_atomic(word).compare_and_swap(new_word, local_word) !=
+                 local_word);
+    }
+
     util::ViewOrVector<WordT, Ownership> vec;
     std::uint64_t num_elements = 0;
 };
@@ -0,0 +1,46 @@
+#ifndef OSRM_UTIL_PARALLEL_IO_HPP
+#define OSRM_UTIL_PARALLEL_IO_HPP
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace osrm
+{
+namespace util
+{
+
+// Transfers of at least this many bytes are worth splitting into slices
+const constexpr std::size_t PARALLEL_IO_THRESHOLD = 32 * 1024 * 1024;
+
+// Size of the slices a few threads transfer concurrently with positional I/O
+const constexpr std::size_t PARALLEL_IO_SLICE_SIZE = 8 * 1024 * 1024;
+
+// Alignment of the offsets, sizes and buffers of direct I/O
+const constexpr std::size_t DIRECT_IO_ALIGNMENT = 4096;
+
+/**
+ * Reads size bytes at the offset of the file into the destination, in slices that are read
+ * concurrently. With direct I/O the slices bypass the page cache and are copied out of aligned
+ * buffers, if the file system does not support it they are read through the page cache.
+ *
+ * Returns false if the file could not be opened or was too short, the caller then falls back to
+ * a read that reports the error. Only supported on POSIX systems, returns false elsewhere.
+ */
+bool ParallelRead(const boost::filesystem::path &path,
+                  const std::uint64_t offset,
+                  char *destination,
+                  const std::size_t size,
+                  const bool direct_io);
+
+// Writes size bytes of the source at the offset of the file in slices written concurrently,
+// returns false if any of them could not be written
+bool ParallelWrite(const boost::filesystem::path &path,
+                   const std::uint64_t offset,
+                   const char *source,
+                   const std::size_t size);
+}
+}
+
+#endif
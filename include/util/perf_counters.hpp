@@ -0,0 +1,61 @@
+#ifndef OSRM_UTIL_PERF_COUNTERS_HPP
+#define OSRM_UTIL_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace osrm
+{
+namespace util
+{
+
+// Hardware events that are counted together
+enum class PerfEvent : std::uint8_t
+{
+    Cycles = 0,
+    Instructions = 1,
+    CacheMisses = 2, // last level cache
+    BranchMisses = 3,
+    None = 4
+};
+
+const constexpr std::size_t NUM_PERF_EVENTS = static_cast<std::size_t>(PerfEvent::None);
+
+const char *ToString(const PerfEvent event);
+
+using PerfEventCounts = std::array<std::uint64_t, NUM_PERF_EVENTS>;
+
+/**
+ * Hardware counters of the calling thread in user space, read with perf_event_open(2).
+ *
+ * The events are opened as one group so they are always scheduled on the PMU at the same time
+ * and their counts belong to the same intervals. Without Linux, a PMU or the permission to
+ * count (see /proc/sys/kernel/perf_event_paranoid) the counters are unavailable and read zeros.
+ */
+class PerfCounters
+{
+  public:
+    // Counters of the calling thread, opened on the first call
+    static PerfCounters &GetCurrent();
+
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool IsAvailable() const { return group_fd >= 0; }
+
+    // Events counted since the counters were opened
+    PerfEventCounts Read() const;
+
+  private:
+    PerfCounters();
+
+    int group_fd = -1;
+    std::array<int, NUM_PERF_EVENTS> fds;
+};
+}
+}
+
+#endif // OSRM_UTIL_PERF_COUNTERS_HPP
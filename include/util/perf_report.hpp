@@ -0,0 +1,96 @@
+#ifndef OSRM_UTIL_PERF_REPORT_HPP
+#define OSRM_UTIL_PERF_REPORT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Resources the process used up to a point in time
+struct ResourceUsage
+{
+    std::chrono::steady_clock::time_point time;
+    // user and system time of all threads
+    std::chrono::microseconds cpu_time{0};
+    // highest resident set size so far, 0 if unknown
+    std::uint64_t peak_rss = 0;
+    // bytes passed to read and write calls (rchar and wchar of /proc/self/io), including the
+    // ones served by the page cache, 0 if unknown. Access through mmap isn't counted.
+    std::uint64_t bytes_read = 0;
+    std::uint64_t bytes_written = 0;
+
+    static ResourceUsage GetCurrent();
+};
+
+/**
+ * Wall time, CPU time, peak memory and I/O of the stages of a preprocessing tool, written as
+ * JSON with --perf-report so the runs of the pipeline can be compared.
+ *
+ * Stages are recorded in the order they end, nested stages are reported separately and
+ * counted in their parent as well. Recording is cheap, it happens whether or not a report is
+ * written.
+ */
+class PerfReport
+{
+  public:
+    static PerfReport &GetInstance();
+
+    void Record(const std::string &stage, const ResourceUsage &begin, const ResourceUsage &end);
+
+    // Writes the stages and the totals since the start of the process. Thread utilisation is
+    // the CPU time divided by the wall time of the given number of threads.
+    void Write(const std::string &path, const std::string &tool, const unsigned threads) const;
+
+  private:
+    struct Stage
+    {
+        std::string name;
+        ResourceUsage begin;
+        ResourceUsage end;
+    };
+
+    PerfReport();
+
+    const ResourceUsage start;
+    mutable std::mutex stages_lock;
+    std::vector<Stage> stages;
+};
+
+// Records the resources used until Stop() or the end of the scope as a stage of the report
+class PerfStage
+{
+  public:
+    explicit PerfStage(std::string name_)
+        : name(std::move(name_)), begin(ResourceUsage::GetCurrent())
+    {
+    }
+
+    ~PerfStage() { Stop(); }
+
+    PerfStage(const PerfStage &) = delete;
+    PerfStage &operator=(const PerfStage &) = delete;
+
+    void Stop()
+    {
+        if (stopped)
+            return;
+        stopped = true;
+        PerfReport::GetInstance().Record(name, begin, ResourceUsage::GetCurrent());
+    }
+
+  private:
+    const std::string name;
+    const ResourceUsage begin;
+    bool stopped = false;
+};
+}
+}
+
+#endif // OSRM_UTIL_PERF_REPORT_HPP
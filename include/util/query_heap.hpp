@@ -1,13 +1,21 @@
 #ifndef OSRM_UTIL_QUERY_HEAP_HPP
 #define OSRM_UTIL_QUERY_HEAP_HPP
 
+#include "util/integer_range.hpp"
+#include "util/msb.hpp"
+
 #include <boost/assert.hpp>
 #include <boost/heap/d_ary_heap.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
 #include <map>
+#include <memory>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -21,13 +29,13 @@ template <typename NodeID, typename Key> class GenerationArrayStorage
 
   public:
     explicit GenerationArrayStorage(std::size_t size)
-        : positions(size, 0), generation(1), generations(size, 0)
+        : generation(1), generations(size, 0), positions(size, 0)
     {
     }
 
     Key &operator[](NodeID node)
     {
-        generation[node] = generation;
+        generations[node] = generation;
         return positions[node];
     }
 
@@ -51,12 +59,104 @@ template <typename NodeID, typename Key> class GenerationArrayStorage
         }
     }
 
+    std::size_t MemoryUsage() const
+    {
+        return generations.capacity() * sizeof(GenerationCounter) +
+               positions.capacity() * sizeof(Key);
+    }
+
+    // The array covers all nodes, there is nothing to release
+    void Shrink() { Clear(); }
+
   private:
     GenerationCounter generation;
     std::vector<GenerationCounter> generations;
     std::vector<Key> positions;
 };
 
+// Like GenerationArrayStorage but the array is split into fixed-size pages that are only
+// allocated once a node inside them is inserted. Searches that stay local to a small part
+// of the graph only pay for the pages they touch instead of one entry per graph node.
+template <typename NodeID, typename Key, unsigned PAGE_BITS = 12> class TwoLevelStorage
+{
+    using GenerationCounter = std::uint16_t;
+    static constexpr std::size_t PAGE_SIZE = std::size_t{1} << PAGE_BITS;
+    static constexpr std::size_t PAGE_MASK = PAGE_SIZE - 1;
+
+    struct Page
+    {
+        std::array<GenerationCounter, PAGE_SIZE> generations;
+        std::array<Key, PAGE_SIZE> positions;
+    };
+
+  public:
+    explicit TwoLevelStorage(std::size_t size)
+        : generation(1), pages((size + PAGE_SIZE - 1) / PAGE_SIZE)
+    {
+    }
+
+    Key &operator[](NodeID node)
+    {
+        auto &page = pages[node >> PAGE_BITS];
+        if (!page)
+        {
+            // value-initialization zeroes all generations
+            page = std::make_unique<Page>();
+            ++allocated_pages;
+        }
+        page->generations[node & PAGE_MASK] = generation;
+        return page->positions[node & PAGE_MASK];
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        const auto &page = pages[node >> PAGE_BITS];
+        if (!page || page->generations[node & PAGE_MASK] < generation)
+        {
+            return std::numeric_limits<Key>::max();
+        }
+        return page->positions[node & PAGE_MASK];
+    }
+
+    void Clear()
+    {
+        generation++;
+        // if generation overflows we end up at 0 again and need to clear all pages
+        if (generation == 0)
+        {
+            generation = 1;
+            for (auto &page : pages)
+            {
+                if (page)
+                {
+                    page->generations.fill(0);
+                }
+            }
+        }
+    }
+
+    std::size_t MemoryUsage() const
+    {
+        return pages.capacity() * sizeof(std::unique_ptr<Page>) + allocated_pages * sizeof(Page);
+    }
+
+    // Releases all pages, the next searches only allocate the ones they touch again
+    void Shrink()
+    {
+        for (auto &page : pages)
+        {
+            page.reset();
+        }
+        allocated_pages = 0;
+        generation = 1;
+    }
+
+  private:
+    GenerationCounter generation;
+    std::vector<std::unique_ptr<Page>> pages;
+    std::size_t allocated_pages = 0;
+};
+
 template <typename NodeID, typename Key> class ArrayStorage
 {
   public:
@@ -122,113 +222,226 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
 
     void Clear() { nodes.clear(); }
 
+    // The buckets and an estimate of the nodes of the map
+    std::size_t MemoryUsage() const
+    {
+        return nodes.bucket_count() * sizeof(void *) +
+               nodes.size() * (sizeof(typename decltype(nodes)::value_type) + sizeof(void *));
+    }
+
+    // Releases the buckets a large search space left behind
+    void Shrink()
+    {
+        std::unordered_map<NodeID, Key>().swap(nodes);
+        nodes.rehash(1000);
+    }
+
   private:
     std::unordered_map<NodeID, Key> nodes;
 };
 
-template <typename NodeID,
-          typename Key,
-          typename Weight,
-          typename Data,
-          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
-class QueryHeap
+enum class IndexStorageType
 {
-  public:
-    using WeightType = Weight;
-    using DataType = Data;
+    UnorderedMap,
+    GenerationArray,
+    TwoLevelArray
+};
 
-    explicit QueryHeap(std::size_t maxID) : node_index(maxID) { Clear(); }
+// Picks one of the index storages above at runtime. The type never changes over the lifetime
+// of the storage so the dispatch branch is trivially predictable, while the choice of backend
+// can be made from the engine configuration instead of at compile time.
+template <typename NodeID, typename Key> class SelectableStorage
+{
+  public:
+    explicit SelectableStorage(std::size_t size)
+        : SelectableStorage(size, IndexStorageType::UnorderedMap)
+    {
+    }
 
-    void Clear()
+    SelectableStorage(std::size_t size, IndexStorageType type)
+        : type(type), size(size), unordered_map(0),
+          generation_array(type == IndexStorageType::GenerationArray ? size : 0),
+          two_level_array(type == IndexStorageType::TwoLevelArray ? size : 0)
     {
-        heap.clear();
-        inserted_nodes.clear();
-        node_index.Clear();
     }
 
-    std::size_t Size() const { return heap.size(); }
+    Key &operator[](NodeID node)
+    {
+        switch (type)
+        {
+        case IndexStorageType::GenerationArray:
+            return generation_array[node];
+        case IndexStorageType::TwoLevelArray:
+            return two_level_array[node];
+        default:
+            return unordered_map[node];
+        }
+    }
 
-    bool Empty() const { return 0 == Size(); }
+    Key peek_index(const NodeID node) const
+    {
+        switch (type)
+        {
+        case IndexStorageType::GenerationArray:
+            return generation_array.peek_index(node);
+        case IndexStorageType::TwoLevelArray:
+            return two_level_array.peek_index(node);
+        default:
+            return unordered_map.peek_index(node);
+        }
+    }
 
-    void Insert(NodeID node, Weight weight, const Data &data)
+    void Clear()
     {
-        const auto index = static_cast<Key>(inserted_nodes.size());
-        const auto handle = heap.push(std::make_pair(weight, index));
-        inserted_nodes.emplace_back(HeapNode{handle, node, weight, data});
-        node_index[node] = index;
+        switch (type)
+        {
+        case IndexStorageType::GenerationArray:
+            generation_array.Clear();
+            break;
+        case IndexStorageType::TwoLevelArray:
+            two_level_array.Clear();
+            break;
+        default:
+            unordered_map.Clear();
+        }
     }
 
-    Data &GetData(NodeID node)
+    std::size_t MemoryUsage() const
     {
-        const auto index = node_index.peek_index(node);
-        return inserted_nodes[index].data;
+        switch (type)
+        {
+        case IndexStorageType::GenerationArray:
+            return generation_array.MemoryUsage();
+        case IndexStorageType::TwoLevelArray:
+            return two_level_array.MemoryUsage();
+        default:
+            return unordered_map.MemoryUsage();
+        }
     }
 
-    Data const &GetData(NodeID node) const
+    void Shrink()
     {
-        const auto index = node_index.peek_index(node);
-        return inserted_nodes[index].data;
+        switch (type)
+        {
+        case IndexStorageType::GenerationArray:
+            generation_array.Shrink();
+            break;
+        case IndexStorageType::TwoLevelArray:
+            two_level_array.Shrink();
+            break;
+        default:
+            unordered_map.Shrink();
+        }
     }
 
-    const Weight &GetKey(NodeID node) const
+    IndexStorageType Type() const { return type; }
+
+    std::size_t Capacity() const { return size; }
+
+    // The backend of the storage, TYPE has to be its type
+    template <IndexStorageType TYPE> auto &Backend()
     {
-        const auto index = node_index.peek_index(node);
-        return inserted_nodes[index].weight;
+        BOOST_ASSERT(type == TYPE);
+        return backend(std::integral_constant<IndexStorageType, TYPE>{});
     }
 
-    bool WasRemoved(const NodeID node) const
+  private:
+    auto &backend(std::integral_constant<IndexStorageType, IndexStorageType::UnorderedMap>)
     {
-        BOOST_ASSERT(WasInserted(node));
-        const Key index = node_index.peek_index(node);
-        return inserted_nodes[index].handle == HeapHandle{};
+        return unordered_map;
     }
+    auto &backend(std::integral_constant<IndexStorageType, IndexStorageType::GenerationArray>)
+    {
+        return generation_array;
+    }
+    auto &backend(std::integral_constant<IndexStorageType, IndexStorageType::TwoLevelArray>)
+    {
+        return two_level_array;
+    }
+
+    IndexStorageType type;
+    std::size_t size;
+    UnorderedMapStorage<NodeID, Key> unordered_map;
+    GenerationArrayStorage<NodeID, Key> generation_array;
+    TwoLevelStorage<NodeID, Key> two_level_array;
+};
 
-    bool WasInserted(const NodeID node) const
+// Calls the function with the storage type as std::integral_constant, so search kernels can be
+// instantiated for each backend of a SelectableStorage and are dispatched once per search
+template <typename Function>
+decltype(auto) dispatchIndexStorage(const IndexStorageType type, Function &&function)
+{
+    switch (type)
     {
-        const auto index = node_index.peek_index(node);
-        if (index >= static_cast<decltype(index)>(inserted_nodes.size()))
-        {
-            return false;
-        }
-        return inserted_nodes[index].node == node;
+    case IndexStorageType::GenerationArray:
+        return function(
+            std::integral_constant<IndexStorageType, IndexStorageType::GenerationArray>{});
+    case IndexStorageType::TwoLevelArray:
+        return function(
+            std::integral_constant<IndexStorageType, IndexStorageType::TwoLevelArray>{});
+    default:
+        return function(
+            std::integral_constant<IndexStorageType, IndexStorageType::UnorderedMap>{});
     }
+}
 
-    NodeID Min() const
+// The heaps below order the inserted nodes of a QueryHeap by their position in its list of
+// inserted nodes. They all pop by weight and, among equal weights, by the smaller position, so
+// every search settles the nodes in the same order with either of them.
+
+// Mutable d-ary heap with a handle per position for decrease-key
+template <typename Weight, typename Key> class DAryHeap
+{
+  public:
+    void Push(const Weight weight, const Key position)
     {
-        BOOST_ASSERT(!heap.empty());
-        return inserted_nodes[heap.top().second].node;
+        BOOST_ASSERT(static_cast<std::size_t>(position) == handles.size());
+        handles.push_back(heap.push(std::make_pair(weight, position)));
     }
 
-    Weight MinKey() const
+    void Decrease(const Key position, const Weight weight)
     {
-        BOOST_ASSERT(!heap.empty());
-        return heap.top().first;
+        heap.increase(handles[position], std::make_pair(weight, position));
     }
 
-    NodeID DeleteMin()
+    // Whether the position was pushed and not popped yet
+    bool Contains(const Key position) const { return handles[position] != HeapHandle{}; }
+
+    Key Top() const { return heap.top().second; }
+
+    Weight TopWeight() const { return heap.top().first; }
+
+    void Pop()
     {
-        BOOST_ASSERT(!heap.empty());
-        const Key removedIndex = heap.top().second;
+        handles[heap.top().second] = HeapHandle{};
         heap.pop();
-        inserted_nodes[removedIndex].handle = HeapHandle{};
-        return inserted_nodes[removedIndex].node;
     }
 
-    void DeleteAll()
+    std::size_t Size() const { return heap.size(); }
+
+    // Pops all positions, they are still known as popped
+    void PopAll()
     {
-        std::for_each(inserted_nodes.begin(), inserted_nodes.end(), [](auto &node) {
-            node.handle = HeapHandle();
-        });
+        std::fill(handles.begin(), handles.end(), HeapHandle{});
         heap.clear();
     }
 
-    void DecreaseKey(NodeID node, Weight weight)
+    void Clear()
     {
-        BOOST_ASSERT(!WasRemoved(node));
-        const auto index = node_index.peek_index(node);
-        auto &reference = inserted_nodes[index];
-        reference.weight = weight;
-        heap.increase(reference.handle, std::make_pair(weight, index));
+        handles.clear();
+        heap.clear();
+    }
+
+    void Shrink()
+    {
+        std::vector<HeapHandle>().swap(handles);
+        HeapContainer().swap(heap);
+    }
+
+    // the heap holds at most one entry per position
+    std::size_t MemoryUsage() const
+    {
+        return handles.capacity() * (sizeof(HeapHandle) + sizeof(HeapData));
     }
 
   private:
@@ -239,17 +452,395 @@ class QueryHeap
                                                   boost::heap::compare<std::greater<HeapData>>>;
     using HeapHandle = typename HeapContainer::handle_type;
 
+    std::vector<HeapHandle> handles;
+    HeapContainer heap;
+};
+
+// Monotone radix heap over the weight and the position packed into one 64 bit key. A key goes
+// into the bucket of the highest bit in which it differs from the last minimum, so only keys of
+// the lowest non-empty bucket are moved when it is refilled and every key moves at most 64
+// times. Decrease-key pushes the key again and leaves the old one behind to be skipped.
+//
+// Dijkstra never pushes a weight below the last minimum with non-negative edges. Smaller keys,
+// from negative edges, source offsets or a tie in weight with a smaller position, lower the last
+// minimum and move the keys of the buckets up to theirs instead.
+template <typename Weight, typename Key> class RadixHeap
+{
+    static_assert(std::is_integral<Weight>::value && sizeof(Weight) <= sizeof(std::uint32_t),
+                  "The weights of a radix heap need to fit into 32 bit");
+    static_assert(std::is_integral<Key>::value && sizeof(Key) <= sizeof(std::uint32_t),
+                  "The positions of a radix heap need to fit into 32 bit");
+
+    using PackedKey = std::uint64_t;
+    static constexpr std::size_t NUM_BUCKETS = 65;
+    static constexpr PackedKey POPPED = std::numeric_limits<PackedKey>::max();
+    // signed weights are ordered like unsigned ones with their sign bit flipped
+    static constexpr std::uint32_t SIGN_FLIP = std::is_signed<Weight>::value ? 0x80000000u : 0u;
+
+  public:
+    void Push(const Weight weight, const Key position)
+    {
+        BOOST_ASSERT(static_cast<std::size_t>(position) == keys.size());
+        const auto key = pack(weight, position);
+        keys.push_back(key);
+        insert(key);
+        ++size;
+    }
+
+    void Decrease(const Key position, const Weight weight)
+    {
+        const auto key = pack(weight, position);
+        keys[position] = key;
+        insert(key);
+    }
+
+    bool Contains(const Key position) const { return keys[position] != POPPED; }
+
+    Key Top() const
+    {
+        refill();
+        return static_cast<Key>(buckets[0].back() & 0xffffffffu);
+    }
+
+    Weight TopWeight() const
+    {
+        refill();
+        return static_cast<Weight>(static_cast<std::uint32_t>(buckets[0].back() >> 32) ^
+                                   SIGN_FLIP);
+    }
+
+    void Pop()
+    {
+        refill();
+        keys[buckets[0].back() & 0xffffffffu] = POPPED;
+        buckets[0].pop_back();
+        --size;
+    }
+
+    std::size_t Size() const { return size; }
+
+    void PopAll()
+    {
+        std::fill(keys.begin(), keys.end(), PackedKey{POPPED});
+        clearBuckets();
+    }
+
+    void Clear()
+    {
+        keys.clear();
+        clearBuckets();
+    }
+
+    void Shrink()
+    {
+        std::vector<PackedKey>().swap(keys);
+        for (auto &bucket : buckets)
+            std::vector<PackedKey>().swap(bucket);
+        clearBuckets();
+    }
+
+    std::size_t MemoryUsage() const
+    {
+        auto bytes = (keys.capacity() + moved.capacity()) * sizeof(PackedKey);
+        for (const auto &bucket : buckets)
+            bytes += bucket.capacity() * sizeof(PackedKey);
+        return bytes;
+    }
+
+  private:
+    static PackedKey pack(const Weight weight, const Key position)
+    {
+        return PackedKey{static_cast<std::uint32_t>(weight) ^ SIGN_FLIP} << 32 |
+               static_cast<std::uint32_t>(position);
+    }
+
+    std::size_t bucketIndex(const PackedKey key) const
+    {
+        return key == last ? 0 : msb(key ^ last) + 1;
+    }
+
+    // Decreased and popped positions leave their old keys behind
+    bool isStale(const PackedKey key) const { return keys[key & 0xffffffffu] != key; }
+
+    void insert(const PackedKey key)
+    {
+        if (key < last)
+        {
+            // the buckets above the one of the key relative to the old minimum don't change
+            const auto lowest = bucketIndex(key);
+            last = key;
+            redistribute(lowest);
+        }
+        buckets[bucketIndex(key)].push_back(key);
+    }
+
+    // Moves the keys of the buckets up to the highest one into their buckets for last
+    void redistribute(const std::size_t highest) const
+    {
+        for (const auto index : irange<std::size_t>(0, highest + 1))
+        {
+            moved.insert(moved.end(), buckets[index].begin(), buckets[index].end());
+            buckets[index].clear();
+        }
+        for (const auto key : moved)
+        {
+            if (!isStale(key))
+                buckets[bucketIndex(key)].push_back(key);
+        }
+        moved.clear();
+    }
+
+    // Makes the first bucket hold the minimum, its keys all equal last
+    void refill() const
+    {
+        BOOST_ASSERT(size > 0);
+        while (true)
+        {
+            auto &first = buckets[0];
+            while (!first.empty() && isStale(first.back()))
+                first.pop_back();
+            if (!first.empty())
+                return;
+
+            const auto lowest = std::find_if(buckets.begin() + 1,
+                                             buckets.end(),
+                                             [](const auto &bucket) { return !bucket.empty(); });
+            BOOST_ASSERT(lowest != buckets.end());
+
+            auto minimum = POPPED;
+            for (const auto key : *lowest)
+            {
+                if (!isStale(key))
+                    minimum = std::min(minimum, key);
+            }
+            if (minimum == POPPED)
+            {
+                lowest->clear();
+                continue;
+            }
+            last = minimum;
+            redistribute(std::distance(buckets.begin(), lowest));
+        }
+    }
+
+    void clearBuckets()
+    {
+        for (auto &bucket : buckets)
+            bucket.clear();
+        last = 0;
+        size = 0;
+    }
+
+    // the current key of every position or POPPED
+    std::vector<PackedKey> keys;
+    // refilling the first bucket doesn't change the order of the keys
+    mutable std::array<std::vector<PackedKey>, NUM_BUCKETS> buckets;
+    mutable std::vector<PackedKey> moved;
+    mutable PackedKey last = 0;
+    std::size_t size = 0;
+};
+
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>,
+          typename Heap = DAryHeap<Weight, Key>>
+class QueryHeap
+{
+  public:
+    using WeightType = Weight;
+    using DataType = Data;
+
+    template <typename... StorageArgs>
+    explicit QueryHeap(std::size_t maxID, StorageArgs &&... storage_args)
+        : node_index(maxID, std::forward<StorageArgs>(storage_args)...)
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        heap.Clear();
+        inserted_nodes.clear();
+        node_index.Clear();
+    }
+
+    // Bytes held by the heap, its inserted nodes and their index. Only the index storages that
+    // can be selected for a SelectableStorage report their memory.
+    std::size_t MemoryUsage() const
+    {
+        return inserted_nodes.capacity() * sizeof(HeapNode) + heap.MemoryUsage() +
+               node_index.MemoryUsage();
+    }
+
+    // Clears the heap and releases the memory its searches allocated beyond the fixed size of
+    // the index
+    void Shrink()
+    {
+        std::vector<HeapNode>().swap(inserted_nodes);
+        heap.Shrink();
+        node_index.Shrink();
+    }
+
+    std::size_t Size() const { return heap.Size(); }
+
+    bool Empty() const { return 0 == Size(); }
+
+    void Insert(NodeID node, Weight weight, const Data &data)
+    {
+        insert(node_index, node, weight, data);
+    }
+
+    Data &GetData(NodeID node) { return at(node_index, node).data; }
+
+    Data const &GetData(NodeID node) const { return at(node_index, node).data; }
+
+    const Weight &GetKey(NodeID node) const { return at(node_index, node).weight; }
+
+    bool WasRemoved(const NodeID node) const { return wasRemoved(node_index, node); }
+
+    bool WasInserted(const NodeID node) const { return wasInserted(node_index, node); }
+
+    NodeID Min() const
+    {
+        BOOST_ASSERT(!Empty());
+        return inserted_nodes[heap.Top()].node;
+    }
+
+    Weight MinKey() const
+    {
+        BOOST_ASSERT(!Empty());
+        return heap.TopWeight();
+    }
+
+    NodeID DeleteMin()
+    {
+        BOOST_ASSERT(!Empty());
+        const Key removedIndex = heap.Top();
+        heap.Pop();
+        ++settled_nodes;
+        return inserted_nodes[removedIndex].node;
+    }
+
+    // Nodes removed with DeleteMin since the heap was constructed, Clear() keeps counting
+    std::uint64_t GetSettledNodes() const { return settled_nodes; }
+
+    void DeleteAll() { heap.PopAll(); }
+
+    void DecreaseKey(NodeID node, Weight weight) { decreaseKey(node_index, node, weight); }
+
+    const IndexStorage &GetIndexStorage() const { return node_index; }
+
+    // The heap with the backend of its SelectableStorage resolved at compile time. Search
+    // kernels instantiated for the view skip the dispatch on the storage type of every lookup.
+    template <IndexStorageType TYPE> class StorageView
+    {
+      public:
+        using WeightType = Weight;
+        using DataType = Data;
+
+        explicit StorageView(QueryHeap &heap_)
+            : heap(heap_), index(heap_.node_index.template Backend<TYPE>())
+        {
+        }
+
+        std::size_t Size() const { return heap.Size(); }
+
+        bool Empty() const { return heap.Empty(); }
+
+        void Insert(NodeID node, Weight weight, const Data &data)
+        {
+            heap.insert(index, node, weight, data);
+        }
+
+        Data &GetData(NodeID node) { return heap.at(index, node).data; }
+
+        Data const &GetData(NodeID node) const { return heap.at(index, node).data; }
+
+        const Weight &GetKey(NodeID node) const { return heap.at(index, node).weight; }
+
+        bool WasRemoved(const NodeID node) const { return heap.wasRemoved(index, node); }
+
+        bool WasInserted(const NodeID node) const { return heap.wasInserted(index, node); }
+
+        NodeID Min() const { return heap.Min(); }
+
+        Weight MinKey() const { return heap.MinKey(); }
+
+        NodeID DeleteMin() { return heap.DeleteMin(); }
+
+        void DeleteAll() { heap.DeleteAll(); }
+
+        void DecreaseKey(NodeID node, Weight weight) { heap.decreaseKey(index, node, weight); }
+
+      private:
+        using Backend = std::remove_reference_t<decltype(
+            std::declval<IndexStorage &>().template Backend<TYPE>())>;
+
+        QueryHeap &heap;
+        Backend &index;
+    };
+
+    template <IndexStorageType TYPE> StorageView<TYPE> View() { return StorageView<TYPE>(*this); }
+
+  private:
     struct HeapNode
     {
-        HeapHandle handle;
         NodeID node;
         Weight weight;
         Data data;
     };
 
+    // The operations on the nodes by their index in the storage or one of its backends
+
+    template <typename IndexT>
+    void insert(IndexT &index, NodeID node, Weight weight, const Data &data)
+    {
+        const auto position = static_cast<Key>(inserted_nodes.size());
+        heap.Push(weight, position);
+        inserted_nodes.emplace_back(HeapNode{node, weight, data});
+        index[node] = position;
+    }
+
+    template <typename IndexT> HeapNode &at(const IndexT &index, NodeID node)
+    {
+        return inserted_nodes[index.peek_index(node)];
+    }
+
+    template <typename IndexT> const HeapNode &at(const IndexT &index, NodeID node) const
+    {
+        return inserted_nodes[index.peek_index(node)];
+    }
+
+    template <typename IndexT> bool wasRemoved(const IndexT &index, const NodeID node) const
+    {
+        BOOST_ASSERT(wasInserted(index, node));
+        return !heap.Contains(index.peek_index(node));
+    }
+
+    template <typename IndexT> bool wasInserted(const IndexT &index, const NodeID node) const
+    {
+        const auto position = index.peek_index(node);
+        if (position >= static_cast<decltype(position)>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[position].node == node;
+    }
+
+    template <typename IndexT> void decreaseKey(const IndexT &index, NodeID node, Weight weight)
+    {
+        BOOST_ASSERT(!wasRemoved(index, node));
+        const auto position = index.peek_index(node);
+        inserted_nodes[position].weight = weight;
+        heap.Decrease(position, weight);
+    }
+
     std::vector<HeapNode> inserted_nodes;
-    HeapContainer heap;
+    Heap heap;
     IndexStorage node_index;
+    std::uint64_t settled_nodes = 0;
 };
 }
 }
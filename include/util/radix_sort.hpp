@@ -0,0 +1,124 @@
+#ifndef OSRM_UTIL_RADIX_SORT_HPP
+#define OSRM_UTIL_RADIX_SORT_HPP
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace detail
+{
+// Stable LSD radix sort of the values by the key digit after digit, digits that are the same for
+// all keys are skipped. The blocks of values are counted and scattered in parallel.
+template <typename T, typename KeyT> void radixSortByDigits(std::vector<T> &values, KeyT key)
+{
+    constexpr std::size_t BITS = 11;
+    constexpr std::size_t BUCKETS = 1 << BITS;
+    constexpr std::size_t DIGITS = (64 + BITS - 1) / BITS;
+    constexpr std::size_t MIN_BLOCK_SIZE = 1 << 16;
+    constexpr std::size_t MAX_BLOCKS = 256;
+    using Histogram = std::array<std::size_t, BUCKETS>;
+
+    const auto size = values.size();
+    const auto block_size = std::max(MIN_BLOCK_SIZE, (size + MAX_BLOCKS - 1) / MAX_BLOCKS);
+    const auto number_of_blocks = (size + block_size - 1) / block_size;
+    const auto block_end = [&](const std::size_t block) {
+        return std::min(size, (block + 1) * block_size);
+    };
+
+    const std::uint64_t first_key = key(values.front());
+    std::vector<std::uint64_t> block_differences(number_of_blocks, 0);
+    tbb::parallel_for(std::size_t{0}, number_of_blocks, [&](const std::size_t block) {
+        std::uint64_t differences = 0;
+        for (auto position = block * block_size; position < block_end(block); ++position)
+            differences |= key(values[position]) ^ first_key;
+        block_differences[block] = differences;
+    });
+    std::uint64_t differences = 0;
+    for (const auto block : block_differences)
+        differences |= block;
+
+    std::vector<T> buffer(size);
+    std::vector<Histogram> offsets(number_of_blocks);
+    for (std::size_t digit = 0; digit < DIGITS; ++digit)
+    {
+        const auto shift = digit * BITS;
+        if (((differences >> shift) & (BUCKETS - 1)) == 0)
+            continue;
+        const auto bucket_of = [&](const T &value) {
+            return static_cast<std::size_t>(key(value) >> shift) & (BUCKETS - 1);
+        };
+
+        tbb::parallel_for(std::size_t{0}, number_of_blocks, [&](const std::size_t block) {
+            auto &histogram = offsets[block];
+            histogram.fill(0);
+            for (auto position = block * block_size; position < block_end(block); ++position)
+                ++histogram[bucket_of(values[position])];
+        });
+
+        // values of a bucket are placed block after block to keep the sort stable
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket)
+        {
+            for (auto &histogram : offsets)
+            {
+                const auto count = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += count;
+            }
+        }
+
+        tbb::parallel_for(std::size_t{0}, number_of_blocks, [&](const std::size_t block) {
+            auto &histogram = offsets[block];
+            for (auto position = block * block_size; position < block_end(block); ++position)
+                buffer[histogram[bucket_of(values[position])]++] = values[position];
+        });
+        values.swap(buffer);
+    }
+}
+}
+
+/**
+ * Sorts the values by an unsigned 64 bit key with a stable least significant digit radix sort
+ * that runs its passes in parallel. Values larger than a key and an index are not moved by the
+ * passes, the sorted keys select them in a final parallel gather. Needs a buffer of the size of
+ * the values.
+ */
+template <typename T, typename KeyT> void parallelRadixSort(std::vector<T> &values, KeyT key)
+{
+    if (values.size() < 2)
+        return;
+
+    using KeyedIndex = std::pair<std::uint64_t, std::size_t>;
+    if (sizeof(T) <= sizeof(KeyedIndex))
+    {
+        detail::radixSortByDigits(
+            values, [&key](const T &value) { return static_cast<std::uint64_t>(key(value)); });
+        return;
+    }
+
+    std::vector<KeyedIndex> keys(values.size());
+    tbb::parallel_for(std::size_t{0}, values.size(), [&](const std::size_t index) {
+        keys[index] = {static_cast<std::uint64_t>(key(values[index])), index};
+    });
+    detail::radixSortByDigits(keys, [](const KeyedIndex &value) { return value.first; });
+
+    std::vector<T> sorted(values.size());
+    tbb::parallel_for(std::size_t{0}, values.size(), [&](const std::size_t index) {
+        sorted[index] = values[keys[index].second];
+    });
+    values.swap(sorted);
+}
+}
+}
+
+#endif
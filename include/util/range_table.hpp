@@ -177,6 +177,12 @@ template <unsigned BLOCK_SIZE, storage::Ownership Ownership> class RangeTable
         return irange(begin_idx, end_idx);
     }
 
+    // Number of ranges the blocks have room for, the last block may not be full
+    std::size_t GetMaxNumberOfRanges() const
+    {
+        return static_cast<std::size_t>(block_offsets.size()) * (BLOCK_SIZE + 1);
+    }
+
     friend void serialization::write<BLOCK_SIZE, Ownership>(storage::io::FileWriter &writer,
                                                             const RangeTable &table);
     friend void serialization::read<BLOCK_SIZE, Ownership>(storage::io::FileReader &reader,
@@ -0,0 +1,187 @@
+#ifndef OSRM_UTIL_REQUEST_TIMING_HPP
+#define OSRM_UTIL_REQUEST_TIMING_HPP
+
+#include "util/timed_histogram.hpp"
+
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+#include "util/perf_counters.hpp"
+#endif
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Stages of a request that are measured separately
+enum class RequestStage : std::uint8_t
+{
+    Parse = 0,    // URL and query parameters
+    Queue = 1,    // waiting for the admission of the request
+    Snap = 2,     // phantom nodes of the input coordinates
+    Route = 3,    // the search, everything in the engine that isn't measured otherwise
+    Unpack = 4,   // unpacking and annotating the paths that were found
+    Assemble = 5, // building the response, e.g. guidance
+    Render = 6,   // serializing the response
+    None = 7
+};
+
+const constexpr std::size_t NUM_REQUEST_STAGES = static_cast<std::size_t>(RequestStage::None);
+
+// Name of the stage, "total" for None which stands for the whole request in the metrics
+const char *ToString(const RequestStage stage);
+
+/**
+ * Time spent in each stage of the request that is being handled by the current thread.
+ *
+ * Stages are exclusive: entering a stage pauses the one that was active, so e.g. the snapping
+ * done in the engine is not counted as routing as well.
+ *
+ * Builds with OSRM_ENABLE_PERF_COUNTERS also count the hardware events of the thread in each
+ * stage, which costs a system call every time a stage is entered.
+ *
+ * Traced requests additionally keep every interval spent in a stage, in the order they ended.
+ */
+class RequestTimings
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct TraceSpan
+    {
+        RequestStage stage;
+        Clock::time_point begin;
+        Clock::time_point end;
+    };
+
+    // Timings of the calling thread
+    static RequestTimings &GetCurrent();
+
+    // Starts measuring a new request, which is not traced
+    void Reset();
+
+    // Keeps the spans of the stages entered from now on until the next Reset()
+    void StartTrace() { traced = true; }
+    bool IsTraced() const { return traced; }
+    const std::vector<TraceSpan> &GetSpans() const { return spans; }
+
+    // Makes the stage the active one and returns the previously active stage
+    RequestStage Enter(const RequestStage stage);
+
+    bool IsMeasured(const RequestStage stage) const
+    {
+        return measured[static_cast<std::size_t>(stage)];
+    }
+
+    std::chrono::nanoseconds GetDuration(const RequestStage stage) const
+    {
+        return durations[static_cast<std::size_t>(stage)];
+    }
+
+    // Time since the last Reset()
+    std::chrono::nanoseconds GetTotal() const { return Clock::now() - start; }
+    Clock::time_point GetStart() const { return start; }
+
+    // Nodes the searches of the request settled, counted by the engine
+    void CountSettledNodes(const std::uint64_t count) { settled_nodes += count; }
+    std::uint64_t GetSettledNodes() const { return settled_nodes; }
+
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+    const PerfEventCounts &GetEventCounts(const RequestStage stage) const
+    {
+        return event_counts[static_cast<std::size_t>(stage)];
+    }
+
+    // Events counted since the last Reset()
+    PerfEventCounts GetTotalEventCounts() const;
+#endif
+
+  private:
+    std::array<std::chrono::nanoseconds, NUM_REQUEST_STAGES> durations{};
+    std::array<bool, NUM_REQUEST_STAGES> measured{};
+    RequestStage active = RequestStage::None;
+    Clock::time_point active_since = Clock::now();
+    Clock::time_point start = Clock::now();
+    std::uint64_t settled_nodes = 0;
+    bool traced = false;
+    std::vector<TraceSpan> spans;
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+    std::array<PerfEventCounts, NUM_REQUEST_STAGES> event_counts{};
+    PerfEventCounts active_since_counts{};
+    PerfEventCounts start_counts{};
+#endif
+};
+
+// Counts the time until the end of the scope to the stage
+class ScopedStageTimer
+{
+  public:
+    explicit ScopedStageTimer(const RequestStage stage)
+        : timings(RequestTimings::GetCurrent()), previous(timings.Enter(stage))
+    {
+    }
+
+    ~ScopedStageTimer() { timings.Enter(previous); }
+
+    ScopedStageTimer(const ScopedStageTimer &) = delete;
+    ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+  private:
+    RequestTimings &timings;
+    const RequestStage previous;
+};
+
+/**
+ * Durations of all handled requests by stage. Every thread records into histograms of its
+ * own, they are only merged when the metrics are read. With OSRM_ENABLE_PERF_COUNTERS the
+ * hardware events are summed by service and stage as well.
+ */
+class RequestMetrics
+{
+  public:
+    static RequestMetrics &GetInstance();
+
+    // Adds the stages measured for a request of the calling thread to the service, requests
+    // that weren't for a service have an empty one
+    void Record(const RequestTimings &timings, const std::string &service = "");
+
+    // Percentiles, sums and counts of the stages in Prometheus text format
+    std::string DumpPrometheus() const;
+
+  private:
+    struct ThreadHistograms
+    {
+        // one per stage, the last one for the whole request
+        std::array<LatencyHistogram, NUM_REQUEST_STAGES + 1> stages;
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+        struct ServiceEventCounts
+        {
+            std::uint64_t requests = 0;
+            // by stage like the histograms
+            std::array<PerfEventCounts, NUM_REQUEST_STAGES + 1> stages{};
+        };
+        // only contended while the metrics are read
+        std::mutex event_counts_lock;
+        std::map<std::string, ServiceEventCounts> event_counts;
+#endif
+    };
+
+    RequestMetrics() = default;
+
+    ThreadHistograms &GetThreadHistograms();
+
+    mutable std::mutex histograms_lock;
+    std::vector<std::unique_ptr<ThreadHistograms>> histograms;
+};
+}
+}
+
+#endif // OSRM_UTIL_REQUEST_TIMING_HPP
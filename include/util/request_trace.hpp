@@ -0,0 +1,47 @@
+#ifndef OSRM_UTIL_REQUEST_TRACE_HPP
+#define OSRM_UTIL_REQUEST_TRACE_HPP
+
+#include "util/request_timing.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Appends the stages of traced requests to a file in the Chrome trace event format, which can
+ * be opened with chrome://tracing or Perfetto.
+ *
+ * Every request is a complete event named after its service with the stages it spent time in
+ * nested below it. Events are on the thread that handled the request, timestamps count from
+ * the creation of the writer. The array of events is never closed so the file stays valid
+ * while it grows, the viewers accept that.
+ */
+class RequestTraceWriter
+{
+  public:
+    // Truncates the file, throws if it can't be opened
+    explicit RequestTraceWriter(const std::string &path);
+
+    RequestTraceWriter(const RequestTraceWriter &) = delete;
+    RequestTraceWriter &operator=(const RequestTraceWriter &) = delete;
+
+    // Writes the spans of a traced request of the calling thread
+    void Write(const RequestTimings &timings,
+               const std::string &service,
+               const std::string &url,
+               const unsigned status);
+
+  private:
+    const RequestTimings::Clock::time_point epoch;
+    std::mutex output_lock;
+    std::ofstream output;
+};
+}
+}
+
+#endif // OSRM_UTIL_REQUEST_TRACE_HPP
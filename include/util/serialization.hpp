@@ -1,7 +1,9 @@
 #ifndef OSMR_UTIL_SERIALIZATION_HPP
 #define OSMR_UTIL_SERIALIZATION_HPP
 
+#include "util/distance_oracle.hpp"
 #include "util/dynamic_graph.hpp"
+#include "util/landmarks.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
@@ -86,6 +88,42 @@ inline void write(storage::io::FileWriter &writer, const DynamicGraph<EdgeDataT>
         writer.WriteOne(graph.edge_list[index]);
     }
 }
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::LandmarksImpl<Ownership> &landmarks)
+{
+    storage::serialization::read(reader, landmarks.landmarks);
+    storage::serialization::read(reader, landmarks.units);
+    storage::serialization::read(reader, landmarks.distances);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::LandmarksImpl<Ownership> &landmarks)
+{
+    storage::serialization::write(writer, landmarks.landmarks);
+    storage::serialization::write(writer, landmarks.units);
+    storage::serialization::write(writer, landmarks.distances);
+}
+
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader, detail::DistanceOracleImpl<Ownership> &oracle)
+{
+    storage::serialization::read(reader, oracle.representatives);
+    storage::serialization::read(reader, oracle.cells);
+    storage::serialization::read(reader, oracle.node_durations);
+    storage::serialization::read(reader, oracle.cell_durations);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::DistanceOracleImpl<Ownership> &oracle)
+{
+    storage::serialization::write(writer, oracle.representatives);
+    storage::serialization::write(writer, oracle.cells);
+    storage::serialization::write(writer, oracle.node_durations);
+    storage::serialization::write(writer, oracle.cell_durations);
+}
 }
 }
 }
@@ -0,0 +1,107 @@
+#ifndef SHARDED_ID_MAP_HPP
+#define SHARDED_ID_MAP_HPP
+
+#include <boost/assert.hpp>
+#include <boost/interprocess/sync/interprocess_upgradable_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Map from keys to incrementing IDs for interning keys from many threads.
+ *
+ * Like ConcurrentIDMap, but the keys are split into shards by their hash and every shard has its
+ * own lock, so threads only wait for each other if they look up keys of the same shard. IDs are
+ * drawn from a counter shared by all shards and stay dense, in the order the keys were added.
+ */
+template <typename KeyType,
+          typename ValueType,
+          typename HashType = std::hash<KeyType>,
+          std::size_t NumberOfShards = 64>
+class ShardedIDMap
+{
+  public:
+    static_assert(std::is_unsigned<ValueType>::value, "Only unsigned integer types are supported.");
+
+    ShardedIDMap() : next_id(0) {}
+    ShardedIDMap(const ShardedIDMap &) = delete;
+    ShardedIDMap &operator=(const ShardedIDMap &) = delete;
+
+    ValueType ConcurrentFindOrAdd(const KeyType &key)
+    {
+        auto &shard = GetShard(key);
+        {
+            ScopedReaderLock sentry{shard.mutex};
+            const auto result = shard.data.find(key);
+            if (result != shard.data.end())
+            {
+                return result->second;
+            }
+        }
+        {
+            ScopedWriterLock sentry{shard.mutex};
+            const auto result = shard.data.find(key);
+            if (result != shard.data.end())
+            {
+                return result->second;
+            }
+            const auto id = next_id.fetch_add(1);
+            shard.data.emplace(key, id);
+            return id;
+        }
+    }
+
+    std::size_t Size() const { return next_id.load(); }
+
+    // Keys indexed by their IDs, must not run concurrently with ConcurrentFindOrAdd
+    std::vector<KeyType> GetKeysByID() const
+    {
+        std::vector<KeyType> keys(Size());
+        for (const auto &shard : shards)
+        {
+            for (const auto &pair : shard.data)
+            {
+                BOOST_ASSERT(pair.second < keys.size());
+                keys[pair.second] = pair.first;
+            }
+        }
+        return keys;
+    }
+
+  private:
+    using UpgradableMutex = boost::interprocess::interprocess_upgradable_mutex;
+    using ScopedReaderLock = boost::interprocess::sharable_lock<UpgradableMutex>;
+    using ScopedWriterLock = boost::interprocess::scoped_lock<UpgradableMutex>;
+
+    struct Shard
+    {
+        std::unordered_map<KeyType, ValueType, HashType> data;
+        mutable UpgradableMutex mutex;
+    };
+
+    Shard &GetShard(const KeyType &key)
+    {
+        const auto hash = HashType()(key);
+        return shards[(hash ^ hash >> 16) % NumberOfShards];
+    }
+
+    std::array<Shard, NumberOfShards> shards;
+    std::atomic<ValueType> next_id;
+};
+
+} // util
+} // osrm
+
+#endif // SHARDED_ID_MAP_HPP
@@ -0,0 +1,378 @@
+#ifndef OSRM_UTIL_SLAB_GRAPH_HPP
+#define OSRM_UTIL_SLAB_GRAPH_HPP
+
+#include "util/deallocating_vector.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Adjacency graph whose nodes keep their edges in blocks of a few size classes, like the
+ * slabs of a memory allocator. The sizes grow by at most a quarter from class to class, so
+ * a block wastes little space. A node that outgrows its block moves to a block of a larger
+ * class and returns the old one to a free list of its class, where other nodes pick it up.
+ * The edges of a node can be released as a whole once they aren't needed anymore, and Compact
+ * gives the space of the free blocks back once they take up much of the edge list.
+ *
+ * Unlike DynamicGraph the edge list never accumulates the blocks left behind by moved nodes,
+ * which keeps the memory of graphs with many insertions and deletions, e.g. a contraction,
+ * close to the size of its current edges.
+ */
+template <typename EdgeDataT> class SlabGraph
+{
+  public:
+    using EdgeData = EdgeDataT;
+    using NodeIterator = std::uint32_t;
+    using EdgeIterator = std::uint32_t;
+    using EdgeRange = range<EdgeIterator>;
+
+    class InputEdge
+    {
+      public:
+        NodeIterator source;
+        NodeIterator target;
+        EdgeDataT data;
+
+        InputEdge()
+            : source(std::numeric_limits<NodeIterator>::max()),
+              target(std::numeric_limits<NodeIterator>::max())
+        {
+        }
+
+        template <typename... Ts>
+        InputEdge(NodeIterator source, NodeIterator target, Ts &&... data)
+            : source(source), target(target), data(std::forward<Ts>(data)...)
+        {
+        }
+
+        bool operator<(const InputEdge &rhs) const
+        {
+            return std::tie(source, target) < std::tie(rhs.source, rhs.target);
+        }
+    };
+
+    // Sizes 1 to 8 followed by 10, 12, 14, 16, 20, 24, ...
+    static EdgeIterator GetBlockSize(const std::uint8_t size_class)
+    {
+        BOOST_ASSERT(size_class < NUMBER_OF_SIZE_CLASSES);
+        if (size_class < 8)
+            return size_class + 1;
+        const auto doublings = (size_class - 8) / 4;
+        const auto quarter = (size_class - 8) % 4;
+        return static_cast<EdgeIterator>(5 + quarter) << (doublings + 1);
+    }
+
+    // The smallest class with room for the edges
+    static std::uint8_t GetSizeClass(const EdgeIterator edges)
+    {
+        BOOST_ASSERT(edges > 0);
+        if (edges <= 8)
+            return static_cast<std::uint8_t>(edges - 1);
+        std::uint8_t size_class = 8;
+        while (GetBlockSize(size_class) < edges)
+            ++size_class;
+        return size_class;
+    }
+
+    /**
+     * Constructs a SlabGraph from a list of edges sorted by source node id. The blocks of the
+     * nodes are laid out in the order of the nodes.
+     */
+    template <class ContainerT> SlabGraph(const NodeIterator nodes, const ContainerT &graph)
+    {
+        // we need to cast here because DeallocatingVector does not have a valid const iterator
+        BOOST_ASSERT(std::is_sorted(const_cast<ContainerT &>(graph).begin(),
+                                    const_cast<ContainerT &>(graph).end()));
+
+        number_of_nodes = nodes;
+        number_of_edges = static_cast<EdgeIterator>(graph.size());
+        node_array.resize(number_of_nodes);
+        EdgeIterator edge = 0;
+        EdgeIterator position = 0;
+        for (const auto node : irange(0u, number_of_nodes))
+        {
+            const EdgeIterator first_edge = edge;
+            while (edge < number_of_edges && graph[edge].source == node)
+            {
+                ++edge;
+            }
+            if (edge == first_edge)
+                continue;
+            node_array[node].first_edge = position;
+            node_array[node].edges = edge - first_edge;
+            node_array[node].size_class = GetSizeClass(edge - first_edge);
+            position += GetBlockSize(node_array[node].size_class);
+        }
+        edge_list.resize(position);
+        edge = 0;
+        for (const auto node : irange(0u, number_of_nodes))
+        {
+            for (const auto i : GetAdjacentEdgeRange(node))
+            {
+                edge_list[i].target = graph[edge].target;
+                BOOST_ASSERT(edge_list[i].target < number_of_nodes);
+                edge_list[i].data = graph[edge].data;
+                ++edge;
+            }
+        }
+    }
+
+    unsigned GetNumberOfNodes() const { return number_of_nodes; }
+
+    unsigned GetNumberOfEdges() const { return number_of_edges; }
+
+    // Number of edges the blocks of all nodes and the free blocks have room for
+    std::size_t GetNumberOfSlots() const { return edge_list.size(); }
+
+    std::size_t GetNumberOfFreeSlots() const { return number_of_free_slots; }
+
+    unsigned GetOutDegree(const NodeIterator n) const { return node_array[n].edges; }
+
+    NodeIterator GetTarget(const EdgeIterator e) const { return edge_list[e].target; }
+
+    EdgeDataT &GetEdgeData(const EdgeIterator e) { return edge_list[e].data; }
+
+    const EdgeDataT &GetEdgeData(const EdgeIterator e) const { return edge_list[e].data; }
+
+    EdgeIterator BeginEdges(const NodeIterator n) const { return node_array[n].first_edge; }
+
+    EdgeIterator EndEdges(const NodeIterator n) const
+    {
+        return node_array[n].first_edge + node_array[n].edges;
+    }
+
+    EdgeRange GetAdjacentEdgeRange(const NodeIterator node) const
+    {
+        return irange(BeginEdges(node), EndEdges(node));
+    }
+
+    // Adds an edge, moves the edges of the source to a larger block if its block is full.
+    // Invalidates edge iterators for the source node.
+    EdgeIterator InsertEdge(const NodeIterator from, const NodeIterator to, const EdgeDataT &data)
+    {
+        Node &node = node_array[from];
+        if (node.size_class == NO_BLOCK || node.edges == GetBlockSize(node.size_class))
+        {
+            const auto old_node = node;
+            node.size_class = GetSizeClass(node.edges + 1);
+            node.first_edge = AllocateBlock(node.size_class);
+            MoveEdges(old_node, node.first_edge);
+            ReleaseBlock(old_node);
+        }
+        const EdgeIterator edge = node.first_edge + node.edges;
+        edge_list[edge].target = to;
+        edge_list[edge].data = data;
+        ++number_of_edges;
+        ++node.edges;
+        return edge;
+    }
+
+    // Makes room for `count` more edges in the blocks of every (node, count) pair of
+    // `reservations`, the nodes have to be distinct. Afterwards InsertEdge writes these edges
+    // in place, so edges of different nodes can be inserted in parallel. Blocks are allocated
+    // in the order of `reservations`. Invalidates edge iterators for the moved nodes.
+    void ReserveEdges(const std::vector<std::pair<NodeIterator, unsigned>> &reservations)
+    {
+        // nodes that get a new block with their old node, the old blocks are released after
+        // all edges moved since another node of the reservations could pick them up otherwise
+        std::vector<std::pair<NodeIterator, Node>> moves;
+        for (const auto &reservation : reservations)
+        {
+            Node &node = node_array[reservation.first];
+            const auto edges = node.edges + reservation.second;
+            if (reservation.second == 0 ||
+                (node.size_class != NO_BLOCK && edges <= GetBlockSize(node.size_class)))
+                continue;
+
+            moves.emplace_back(reservation.first, node);
+            node.size_class = GetSizeClass(edges);
+            node.first_edge = AllocateBlock(node.size_class);
+        }
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, moves.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (const auto index : irange(range.begin(), range.end()))
+                              {
+                                  MoveEdges(moves[index].second,
+                                            node_array[moves[index].first].first_edge);
+                              }
+                          });
+
+        for (const auto &move : moves)
+        {
+            ReleaseBlock(move.second);
+        }
+    }
+
+    // removes an edge. Invalidates edge iterators for the source node
+    void DeleteEdge(const NodeIterator source, const EdgeIterator e)
+    {
+        Node &node = node_array[source];
+        BOOST_ASSERT(node.edges > 0);
+        --number_of_edges;
+        --node.edges;
+        // swap with last edge
+        edge_list[e] = edge_list[node.first_edge + node.edges];
+    }
+
+    // removes all edges (source,target)
+    int32_t DeleteEdgesTo(const NodeIterator source, const NodeIterator target)
+    {
+        int32_t deleted = 0;
+        for (EdgeIterator i = BeginEdges(source), iend = EndEdges(source); i < iend - deleted; ++i)
+        {
+            if (edge_list[i].target == target)
+            {
+                do
+                {
+                    deleted++;
+                    edge_list[i] = edge_list[iend - deleted];
+                } while (i < iend - deleted && edge_list[i].target == target);
+            }
+        }
+
+        number_of_edges -= deleted;
+        node_array[source].edges -= deleted;
+
+        return deleted;
+    }
+
+    // Removes all edges of the node and returns its block to the free blocks
+    void ReleaseEdges(const NodeIterator source)
+    {
+        Node &node = node_array[source];
+        number_of_edges -= node.edges;
+        ReleaseBlock(node);
+        node = Node{};
+    }
+
+    // Moves the blocks of all nodes to the front of the edge list in the order of their positions
+    // and frees the space behind them, free blocks are dropped. Invalidates all edge iterators.
+    void Compact()
+    {
+        std::vector<NodeIterator> nodes;
+        for (const auto node : irange(0u, number_of_nodes))
+        {
+            if (node_array[node].size_class != NO_BLOCK)
+                nodes.push_back(node);
+        }
+        std::sort(nodes.begin(), nodes.end(), [this](const auto lhs, const auto rhs) {
+            return node_array[lhs].first_edge < node_array[rhs].first_edge;
+        });
+
+        EdgeIterator position = 0;
+        for (const auto node : nodes)
+        {
+            // blocks only move to the front, so copying forward doesn't overwrite any edges
+            MoveEdges(node_array[node], position);
+            node_array[node].first_edge = position;
+            position += GetBlockSize(node_array[node].size_class);
+        }
+        edge_list.resize(position);
+        for (auto &free_list : free_blocks)
+        {
+            free_list.clear();
+            free_list.shrink_to_fit();
+        }
+        number_of_free_slots = 0;
+    }
+
+    // searches for a specific edge
+    EdgeIterator FindEdge(const NodeIterator from, const NodeIterator to) const
+    {
+        for (const auto i : irange(BeginEdges(from), EndEdges(from)))
+        {
+            if (to == edge_list[i].target)
+            {
+                return i;
+            }
+        }
+        return SPECIAL_EDGEID;
+    }
+
+  private:
+    static constexpr std::uint8_t NUMBER_OF_SIZE_CLASSES = 8 + 4 * 28;
+    static constexpr std::uint8_t NO_BLOCK = std::numeric_limits<std::uint8_t>::max();
+
+    struct Node
+    {
+        // index of the first edge
+        EdgeIterator first_edge = 0;
+        // amount of edges
+        unsigned edges = 0;
+        // size class of the block that starts at first_edge
+        std::uint8_t size_class = NO_BLOCK;
+    };
+
+    struct Edge
+    {
+        NodeIterator target;
+        EdgeDataT data;
+    };
+
+    EdgeIterator AllocateBlock(const std::uint8_t size_class)
+    {
+        auto &free_list = free_blocks[size_class];
+        if (!free_list.empty())
+        {
+            const auto first_edge = free_list.back();
+            free_list.pop_back();
+            number_of_free_slots -= GetBlockSize(size_class);
+            return first_edge;
+        }
+        const auto first_edge = static_cast<EdgeIterator>(edge_list.size());
+        BOOST_ASSERT(edge_list.size() + GetBlockSize(size_class) <
+                     std::numeric_limits<EdgeIterator>::max());
+        edge_list.resize(edge_list.size() + GetBlockSize(size_class));
+        return first_edge;
+    }
+
+    void ReleaseBlock(const Node &node)
+    {
+        if (node.size_class != NO_BLOCK)
+        {
+            free_blocks[node.size_class].push_back(node.first_edge);
+            number_of_free_slots += GetBlockSize(node.size_class);
+        }
+    }
+
+    // copies the edges of the old block of a node to its new block
+    void MoveEdges(const Node &old_node, const EdgeIterator first_edge)
+    {
+        for (const auto i : irange(0u, old_node.edges))
+        {
+            edge_list[first_edge + i] = edge_list[old_node.first_edge + i];
+        }
+    }
+
+    NodeIterator number_of_nodes;
+    std::atomic_uint number_of_edges;
+    std::size_t number_of_free_slots = 0;
+
+    std::vector<Node> node_array;
+    DeallocatingVector<Edge> edge_list;
+    std::array<std::vector<EdgeIterator>, NUMBER_OF_SIZE_CLASSES> free_blocks;
+};
+}
+}
+
+#endif // OSRM_UTIL_SLAB_GRAPH_HPP
@@ -9,6 +9,7 @@
 #include "util/hilbert_value.hpp"
 #include "util/integer_range.hpp"
 #include "util/mmap_file.hpp"
+#include "util/packed_rectangles.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
@@ -28,10 +29,12 @@
 
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 // An extended alignment is implementation-defined, so use compiler attributes
@@ -91,7 +94,9 @@ class StaticRTree
      *                  W
      *
      * Step 1 - objects 01234567... are sorted by Hilbert code (these are the line
-     *          segments of the OSM roads)
+     *          segments of the OSM roads). They are sorted in runs that are spilled
+     *          next to the .fileIndex and merged while the leaves are written, so
+     *          no copy of all objects is held in memory.
      * Step 2 - we grab LEAF_NODE_SIZE of them at a time and create TreeNode A with a
      *          bounding-box that surrounds the first LEAF_NODE_SIZE objects
      * Step 2a- continue grabbing LEAF_NODE_SIZE objects, creating TreeNodes B,C,D,E...J
@@ -104,19 +109,13 @@ class StaticRTree
      * Step 3a- Repeat this process for each level, until you only create 1 TreeNode
      *          to contain its children (in this case, W).
      *
-     * As we create TreeNodes, we append them to the m_search_tree vector.
+     * The number of nodes of every level follows from the number of leaves, so
+     * m_search_tree is laid out from the root down, every level left to right:
      *
-     * After this part of the building process, m_search_tree will contain TreeNode
-     * objects in this order:
+     *   W UV PQR KLMNO ABCDEFGHIJ
      *
-     * ABCDEFGHIJ KLMNO PQR UV W
-     * 10         5     3   2  1  <- number of nodes in the level
-     *
-     * In order to make our math easy later on, we reverse the whole array,
-     * then reverse the nodes within each level:
-     *
-     *   Reversed:        W VU RQP ONMKL JIHGFEDCBA
-     *   Levels reversed: W UV PQR KLMNO ABCDEFGHIJ
+     * The leaves A..J are placed at the end and the nodes of each level above
+     * are computed in parallel from the level below.
      *
      * We also now have the following information:
      *
@@ -141,6 +140,9 @@ class StaticRTree
     static_assert(LEAF_PAGE_SIZE >= sizeof(EdgeDataT), "page size is too small");
     static_assert(((LEAF_PAGE_SIZE - 1) & LEAF_PAGE_SIZE) == 0, "page size is not a power of 2");
     static constexpr std::uint32_t LEAF_NODE_SIZE = (LEAF_PAGE_SIZE / sizeof(EdgeDataT));
+    // Cache lines at the start of a leaf that are prefetched when it becomes a candidate
+    static constexpr std::size_t LEAF_PREFETCH_LINES =
+        std::min<std::size_t>(4, (LEAF_NODE_SIZE * sizeof(EdgeDataT) + 63) / 64);
 
     struct CandidateSegment
     {
@@ -166,38 +168,68 @@ class StaticRTree
      * classes to navigate around.  The TreeNode is packed into m_search_tree
      * in a specific order so we can calculate positions of children
      * (see the children_indexes function)
+     * The bearing bins hold the bearings of the enabled directions of all segments below
+     * the node, so nodes without a matching bearing are not explored. Nodes without a segment
+     * of a big component below them are not explored by the queries in big components.
      */
     struct TreeNode
     {
         Rectangle minimum_bounding_rectangle;
+        bearing::Bins bearing_bins = 0;
+        bool has_big_component = false;
     };
 
+    // Number of objects sorted in memory at once while building the tree
+    static constexpr std::size_t DEFAULT_ELEMENTS_PER_RUN = 1 << 24;
+
+    using IsTinyComponent = std::function<bool(const EdgeDataT &)>;
+
   private:
     /**
-     * A lightweight wrapper for the Hilbert Code for each EdgeDataT object
-     * A vector of these is used to sort the EdgeDataT input onto the
-     * Hilbert Curve.
-     * The sorting doesn't modify the original array, so this struct
-     * maintains a pointer to the original index position (m_original_index)
-     * so we can fetch the original data from the sorted position.
+     * An EdgeDataT object with the Hilbert Code of its centroid, runs of these
+     * are sorted onto the Hilbert Curve and spilled to disk while building.
      */
-    struct WrappedInputElement
+    struct HilbertElement
     {
-        explicit WrappedInputElement(const uint64_t _hilbert_value,
-                                     const std::uint32_t _original_index)
-            : m_hilbert_value(_hilbert_value), m_original_index(_original_index)
+        std::uint64_t hilbert_value;
+        EdgeDataT object;
+
+        inline bool operator<(const HilbertElement &other) const
         {
+            return hilbert_value < other.hilbert_value;
         }
+    };
 
-        WrappedInputElement() : m_hilbert_value(0), m_original_index(UINT_MAX) {}
+    /**
+     * A run of objects sorted by Hilbert Code, kept in memory or read back from
+     * its file a buffer at a time.
+     */
+    struct SortedRun
+    {
+        static constexpr std::size_t BUFFER_SIZE = 1 << 16;
 
-        uint64_t m_hilbert_value;
-        std::uint32_t m_original_index;
+        const HilbertElement &Front() const { return buffer[position]; }
 
-        inline bool operator<(const WrappedInputElement &other) const
+        bool Empty() const { return position == buffer.size(); }
+
+        void Pop()
+        {
+            if (++position == buffer.size() && remaining > 0)
+                Refill();
+        }
+
+        void Refill()
         {
-            return m_hilbert_value < other.m_hilbert_value;
+            buffer.resize(std::min<std::uint64_t>(remaining, BUFFER_SIZE));
+            file->ReadInto(buffer.data(), buffer.size());
+            remaining -= buffer.size();
+            position = 0;
         }
+
+        std::unique_ptr<storage::io::FileReader> file;
+        std::uint64_t remaining = 0;
+        std::vector<HilbertElement> buffer;
+        std::size_t position = 0;
     };
 
     struct QueryCandidate
@@ -235,6 +267,24 @@ class StaticRTree
         std::uint32_t segment_index;
     };
 
+    /**
+     * Projected segments of recently explored leaves, shared by the queries of a batch.
+     * Leaves are stored in the slot of their offset, neighbouring queries explore mostly
+     * neighbouring leaves which have consecutive offsets in the packed tree.
+     */
+    struct LeafCache
+    {
+        static constexpr std::uint32_t NUMBER_OF_SLOTS = 64;
+
+        struct Slot
+        {
+            std::uint32_t leaf_offset = std::numeric_limits<std::uint32_t>::max();
+            std::vector<std::pair<FloatCoordinate, FloatCoordinate>> projected_segments;
+        };
+
+        std::array<Slot, NUMBER_OF_SLOTS> slots;
+    };
+
     // We use a const view type when we don't own the data, otherwise
     // we use a mutable type (usually becase we're building the tree)
     using TreeViewType = typename std::conditional<Ownership == storage::Ownership::View,
@@ -253,9 +303,12 @@ class StaticRTree
     // Holds the start indexes of each level in m_search_tree
     std::vector<std::uint64_t> m_tree_level_starts;
 
-    // mmap'd .fileIndex file
+    // Copy of the rectangles of m_search_tree for evaluating the children of a node at once
+    PackedRectangles m_packed_rectangles;
+
+    // mmap'd .fileIndex file, unless it was loaded by someone else
     boost::iostreams::mapped_file_source m_objects_region;
-    // This is a view of the EdgeDataT data mmap'd from the .fileIndex file
+    // This is a view of the EdgeDataT data of the .fileIndex file
     util::vector_view<const EdgeDataT> m_objects;
 
   public:
@@ -263,202 +316,40 @@ class StaticRTree
     StaticRTree &operator=(const StaticRTree &) = delete;
 
     // Construct a packed Hilbert-R-Tree with Kamel-Faloutsos algorithm [1]
+    // is_tiny_component tells the segments of tiny components apart, without it all segments
+    // count as segments of big components.
     explicit StaticRTree(const std::vector<EdgeDataT> &input_data_vector,
                          const std::string &tree_node_filename,
                          const std::string &leaf_node_filename,
-                         const Vector<Coordinate> &coordinate_list)
+                         const Vector<Coordinate> &coordinate_list,
+                         const std::size_t elements_per_run = DEFAULT_ELEMENTS_PER_RUN,
+                         const IsTinyComponent &is_tiny_component = {})
         : m_coordinate_list(coordinate_list)
     {
-        const auto element_count = input_data_vector.size();
-        std::vector<WrappedInputElement> input_wrapper_vector(element_count);
-
-        // Step 1 - create a vector of Hilbert Code/original position pairs
-        tbb::parallel_for(
-            tbb::blocked_range<uint64_t>(0, element_count),
-            [&input_data_vector, &input_wrapper_vector, this](
-                const tbb::blocked_range<uint64_t> &range) {
-                for (uint64_t element_counter = range.begin(), end = range.end();
-                     element_counter != end;
-                     ++element_counter)
-                {
-                    WrappedInputElement &current_wrapper = input_wrapper_vector[element_counter];
-                    current_wrapper.m_original_index = element_counter;
-
-                    EdgeDataT const &current_element = input_data_vector[element_counter];
-
-                    // Get Hilbert-Value for centroid in mercartor projection
-                    BOOST_ASSERT(current_element.u < m_coordinate_list.size());
-                    BOOST_ASSERT(current_element.v < m_coordinate_list.size());
-
-                    Coordinate current_centroid = coordinate_calculation::centroid(
-                        m_coordinate_list[current_element.u], m_coordinate_list[current_element.v]);
-                    current_centroid.lat = FixedLatitude{static_cast<std::int32_t>(
-                        COORDINATE_PRECISION *
-                        web_mercator::latToY(toFloating(current_centroid.lat)))};
-
-                    current_wrapper.m_hilbert_value = GetHilbertCode(current_centroid);
-                }
-            });
-
-        // sort the hilbert-value representatives
-        tbb::parallel_sort(input_wrapper_vector.begin(), input_wrapper_vector.end());
-        {
-            storage::io::FileWriter leaf_node_file(leaf_node_filename,
-                                                   storage::io::FileWriter::HasNoFingerprint);
-            // Note, we can't just write everything in one go, because the input_data_vector
-            // is not sorted by hilbert code, only the input_wrapper_vector is in the correct
-            // order.  Instead, we iterate over input_wrapper_vector, copy the hilbert-indexed
-            // entries from input_data_vector into a temporary contiguous array, then write
-            // that array to disk.
-
-            // Create the first level of TreeNodes - each bounding LEAF_NODE_COUNT EdgeDataT
-            // objects.
-            std::size_t wrapped_element_index = 0;
-            while (wrapped_element_index < element_count)
-            {
-                TreeNode current_node;
-
-                std::array<EdgeDataT, LEAF_NODE_SIZE> objects;
-                std::uint32_t object_count = 0;
-
-                // Loop over the next block of EdgeDataT, calculate the bounding box
-                // for the block, and save the data to write to disk in the correct
-                // order.
-                for (std::uint32_t object_index = 0;
-                     object_index < LEAF_NODE_SIZE && wrapped_element_index < element_count;
-                     ++object_index, ++wrapped_element_index)
-                {
-                    const std::uint32_t input_object_index =
-                        input_wrapper_vector[wrapped_element_index].m_original_index;
-                    const EdgeDataT &object = input_data_vector[input_object_index];
-
-                    object_count += 1;
-                    objects[object_index] = object;
-
-                    Coordinate projected_u{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
-                    Coordinate projected_v{
-                        web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
-
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
-                    BOOST_ASSERT(std::abs(toFloating(projected_v.lat).operator double()) <= 180.);
-
-                    Rectangle rectangle;
-                    rectangle.min_lon =
-                        std::min(rectangle.min_lon, std::min(projected_u.lon, projected_v.lon));
-                    rectangle.max_lon =
-                        std::max(rectangle.max_lon, std::max(projected_u.lon, projected_v.lon));
-
-                    rectangle.min_lat =
-                        std::min(rectangle.min_lat, std::min(projected_u.lat, projected_v.lat));
-                    rectangle.max_lat =
-                        std::max(rectangle.max_lat, std::max(projected_u.lat, projected_v.lat));
-
-                    BOOST_ASSERT(rectangle.IsValid());
-                    current_node.minimum_bounding_rectangle.MergeBoundingBoxes(rectangle);
-                }
-
-                // Write out our EdgeDataT block to the leaf node file
-                leaf_node_file.WriteFrom(objects.data(), object_count);
-
-                m_search_tree.emplace_back(current_node);
-            }
-
-            // leaf_node_file wil be RAII closed at this point
-        }
-
-        // Should hold the number of nodes at the lowest level of the graph (closest
-        // to the data)
-        std::uint32_t nodes_in_previous_level = m_search_tree.size();
-        m_tree_level_sizes.push_back(nodes_in_previous_level);
-
-        // Now, repeatedly create levels of nodes that contain BRANCHING_FACTOR
-        // nodes from the previous level.
-        while (nodes_in_previous_level > 1)
-        {
-            auto previous_level_start_pos = m_search_tree.size() - nodes_in_previous_level;
-
-            // We can calculate how many nodes will be in this level, we divide by
-            // BRANCHING_FACTOR
-            // and round up
-            std::uint32_t nodes_in_current_level =
-                std::ceil(static_cast<double>(nodes_in_previous_level) / BRANCHING_FACTOR);
-
-            for (auto current_node_idx : irange<std::size_t>(0, nodes_in_current_level))
-            {
-                TreeNode parent_node;
-                auto first_child_index =
-                    current_node_idx * BRANCHING_FACTOR + previous_level_start_pos;
-                auto last_child_index =
-                    first_child_index +
-                    std::min<std::size_t>(BRANCHING_FACTOR,
-                                          nodes_in_previous_level -
-                                              current_node_idx * BRANCHING_FACTOR);
-
-                // Calculate the bounding box for BRANCHING_FACTOR nodes in the previous
-                // level, then save that box as a new TreeNode in the new level.
-                for (auto child_node_idx : irange<std::size_t>(first_child_index, last_child_index))
-                {
-                    parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                        m_search_tree[child_node_idx].minimum_bounding_rectangle);
-                }
-                m_search_tree.emplace_back(parent_node);
-            }
-            nodes_in_previous_level = nodes_in_current_level;
-            m_tree_level_sizes.push_back(nodes_in_previous_level);
-        }
-        // At this point, we've got our tree built, but the nodes are in a weird order.
-        // Next thing we'll do is flip it around so that we don't end up with a lot of
-        // `size - n` math later on.
-
-        // Flip the tree so that the root node is at 0.
-        // This just makes our math during search a bit more intuitive
-        std::reverse(m_search_tree.begin(), m_search_tree.end());
-
-        // Same for the level sizes - root node / base level is at 0
-        std::reverse(m_tree_level_sizes.begin(), m_tree_level_sizes.end());
-
-        // The first level starts at 0
-        m_tree_level_starts = {0};
-        // The remaining levels start at the partial sum of the preceeding level sizes
-        std::partial_sum(m_tree_level_sizes.begin(),
-                         m_tree_level_sizes.end() - 1,
-                         std::back_inserter(m_tree_level_starts));
-
-        // Now we have to flip the coordinates within each level so that math is easier
-        // later on.  The workflow here is:
-        // The initial order of tree nodes in the m_search_tree array is roughly:
-        // 6789 345 12 0   (each block here is a level of the tree)
-        // Then we reverse it and get:
-        // 0 21 543 9876
-        // Now the loop below reverses each level to give us the final result
-        // 0 12 345 6789
-        // This ordering keeps the position math easy to understand during later
-        // searches
-        for (auto i : irange<std::size_t>(0, m_tree_level_sizes.size()))
-        {
-            std::reverse(m_search_tree.begin() + m_tree_level_starts[i],
-                         m_search_tree.begin() + m_tree_level_starts[i] + m_tree_level_sizes[i]);
-        }
-
-        // Write all the TreeNode data to disk
-        {
-            storage::io::FileWriter tree_node_file(tree_node_filename,
-                                                   storage::io::FileWriter::GenerateFingerprint);
-
-            std::uint64_t size_of_tree = m_search_tree.size();
-            BOOST_ASSERT_MSG(0 < size_of_tree, "tree empty");
-
-            tree_node_file.WriteOne(size_of_tree);
-            tree_node_file.WriteFrom(m_search_tree);
-
-            tree_node_file.WriteOne(static_cast<std::uint64_t>(m_tree_level_sizes.size()));
-            tree_node_file.WriteFrom(m_tree_level_sizes);
-        }
+        Build(input_data_vector,
+              [] {},
+              tree_node_filename,
+              leaf_node_filename,
+              elements_per_run,
+              is_tiny_component);
+    }
 
-        m_objects = mmapFile<EdgeDataT>(leaf_node_filename, m_objects_region);
+    // Same as above, but releases the input once it is sorted into runs, so the objects are
+    // not held twice while the leaves are written
+    explicit StaticRTree(std::vector<EdgeDataT> &&input_data_vector,
+                         const std::string &tree_node_filename,
+                         const std::string &leaf_node_filename,
+                         const Vector<Coordinate> &coordinate_list,
+                         const std::size_t elements_per_run = DEFAULT_ELEMENTS_PER_RUN,
+                         const IsTinyComponent &is_tiny_component = {})
+        : m_coordinate_list(coordinate_list)
+    {
+        Build(input_data_vector,
+              [&input_data_vector] { std::vector<EdgeDataT>().swap(input_data_vector); },
+              tree_node_filename,
+              leaf_node_filename,
+              elements_per_run,
+              is_tiny_component);
     }
 
     /**
@@ -489,22 +380,43 @@ class StaticRTree
                          std::back_inserter(m_tree_level_starts));
 
         m_objects = mmapFile<EdgeDataT>(leaf_file, m_objects_region);
+        PackRectangles();
     }
 
     /**
      * Constructs an r-tree from blocks of memory loaded by someone else
      * (usually a shared memory block created by osrm-datastore)
      * These memory blocks basically just contain the files read into RAM,
-     * excep the .fileIndex file always stays on disk, and we mmap() it as usual
+     * excep the .fileIndex file stays on disk, and we mmap() it with the given access pattern
      */
     explicit StaticRTree(const TreeNode *tree_node_ptr,
                          const uint64_t number_of_nodes,
                          const std::uint64_t *level_sizes_ptr,
                          const std::size_t number_of_levels,
                          const boost::filesystem::path &leaf_file,
+                         const Vector<Coordinate> &coordinate_list,
+                         const MappedFileAccess leaf_access = MappedFileAccess::Default)
+        : StaticRTree(tree_node_ptr,
+                      number_of_nodes,
+                      level_sizes_ptr,
+                      number_of_levels,
+                      util::vector_view<const EdgeDataT>(),
+                      coordinate_list)
+    {
+        m_objects = mmapFile<EdgeDataT>(leaf_file, m_objects_region);
+        adviseMappedFile(m_objects_region.data(), m_objects_region.size(), leaf_access);
+    }
+
+    // Same as above with the .fileIndex loaded into the memory block as well
+    explicit StaticRTree(const TreeNode *tree_node_ptr,
+                         const uint64_t number_of_nodes,
+                         const std::uint64_t *level_sizes_ptr,
+                         const std::size_t number_of_levels,
+                         const util::vector_view<const EdgeDataT> objects,
                          const Vector<Coordinate> &coordinate_list)
         : m_search_tree(tree_node_ptr, number_of_nodes), m_coordinate_list(coordinate_list),
-          m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels)
+          m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels),
+          m_objects(objects)
     {
         // The first level starts at 0
         m_tree_level_starts = {0};
@@ -512,7 +424,7 @@ class StaticRTree
         std::partial_sum(m_tree_level_sizes.begin(),
                          m_tree_level_sizes.end() - 1,
                          std::back_inserter(m_tree_level_starts));
-        m_objects = mmapFile<EdgeDataT>(leaf_file, m_objects_region);
+        PackRectangles();
     }
 
     /* Returns all features inside the bounding box.
@@ -602,6 +514,118 @@ class StaticRTree
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const FilterT filter,
                                    const TerminationT terminate) const
+    {
+        return Nearest(input_coordinate, bearing::ALL_BINS, false, filter, terminate, nullptr);
+    }
+
+    // Only explores the subtrees with a segment that has an enabled direction in the bearing
+    // bins, the filter still has to check the bearings of the segments.
+    template <typename FilterT, typename TerminationT>
+    std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
+                                   const bearing::Bins bearing_bins,
+                                   const FilterT filter,
+                                   const TerminationT terminate) const
+    {
+        return Nearest(input_coordinate, bearing_bins, false, filter, terminate, nullptr);
+    }
+
+    // Same as above, but only explores the subtrees with a segment of a big component. The
+    // filter still has to reject the segments of tiny components next to them.
+    template <typename FilterT, typename TerminationT>
+    std::vector<EdgeDataT> NearestInBigComponents(const Coordinate input_coordinate,
+                                                  const bearing::Bins bearing_bins,
+                                                  const FilterT filter,
+                                                  const TerminationT terminate) const
+    {
+        return Nearest(input_coordinate, bearing_bins, true, filter, terminate, nullptr);
+    }
+
+    // Nearest queries for many coordinates at once. The queries run in the order of the
+    // Hilbert values of the coordinates, so consecutive queries explore mostly the same leaves
+    // and share their projected segments. Filter and terminator get the index of the
+    // coordinate as first argument.
+    template <typename FilterT, typename TerminationT>
+    std::vector<std::vector<EdgeDataT>> Nearest(const std::vector<Coordinate> &input_coordinates,
+                                                const FilterT filter,
+                                                const TerminationT terminate) const
+    {
+        return Nearest(input_coordinates, std::vector<bearing::Bins>{}, filter, terminate);
+    }
+
+    // Same as above, segments are only returned if one of their enabled directions is in
+    // the bearing bins of their coordinate. The bins are either empty or have one entry per
+    // coordinate.
+    template <typename FilterT, typename TerminationT>
+    std::vector<std::vector<EdgeDataT>> Nearest(const std::vector<Coordinate> &input_coordinates,
+                                                const std::vector<bearing::Bins> &bearing_bins,
+                                                const FilterT filter,
+                                                const TerminationT terminate) const
+    {
+        return Nearest(input_coordinates, bearing_bins, false, filter, terminate);
+    }
+
+    // Batched version of NearestInBigComponents
+    template <typename FilterT, typename TerminationT>
+    std::vector<std::vector<EdgeDataT>>
+    NearestInBigComponents(const std::vector<Coordinate> &input_coordinates,
+                           const std::vector<bearing::Bins> &bearing_bins,
+                           const FilterT filter,
+                           const TerminationT terminate) const
+    {
+        return Nearest(input_coordinates, bearing_bins, true, filter, terminate);
+    }
+
+  private:
+    template <typename FilterT, typename TerminationT>
+    std::vector<std::vector<EdgeDataT>> Nearest(const std::vector<Coordinate> &input_coordinates,
+                                                const std::vector<bearing::Bins> &bearing_bins,
+                                                const bool big_components_only,
+                                                const FilterT filter,
+                                                const TerminationT terminate) const
+    {
+        BOOST_ASSERT(bearing_bins.empty() || bearing_bins.size() == input_coordinates.size());
+        std::vector<std::pair<std::uint64_t, std::size_t>> hilbert_order;
+        hilbert_order.reserve(input_coordinates.size());
+        for (const auto index : irange<std::size_t>(0, input_coordinates.size()))
+        {
+            // same projection as the centroids the tree was packed with
+            Coordinate projected_coordinate = input_coordinates[index];
+            projected_coordinate.lat = FixedLatitude{static_cast<std::int32_t>(
+                COORDINATE_PRECISION *
+                web_mercator::latToY(toFloating(projected_coordinate.lat)))};
+            hilbert_order.emplace_back(GetHilbertCode(projected_coordinate), index);
+        }
+        std::sort(hilbert_order.begin(), hilbert_order.end());
+
+        std::vector<std::vector<EdgeDataT>> results(input_coordinates.size());
+        LeafCache leaf_cache;
+        for (const auto &hilbert_and_index : hilbert_order)
+        {
+            const auto index = hilbert_and_index.second;
+            results[index] = Nearest(
+                input_coordinates[index],
+                bearing_bins.empty() ? bearing::ALL_BINS : bearing_bins[index],
+                big_components_only,
+                [&filter, index](const CandidateSegment &segment) {
+                    return filter(index, segment);
+                },
+                [&terminate, index](const std::size_t num_results,
+                                    const CandidateSegment &segment) {
+                    return terminate(index, num_results, segment);
+                },
+                &leaf_cache);
+        }
+
+        return results;
+    }
+
+    template <typename FilterT, typename TerminationT>
+    std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
+                                   const bearing::Bins bearing_bins,
+                                   const bool big_components_only,
+                                   const FilterT filter,
+                                   const TerminationT terminate,
+                                   LeafCache *leaf_cache) const
     {
         std::vector<EdgeDataT> results;
         auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
@@ -623,12 +647,16 @@ class StaticRTree
                     ExploreLeafNode(current_tree_index,
                                     fixed_projected_coordinate,
                                     projected_coordinate,
-                                    traversal_queue);
+                                    traversal_queue,
+                                    leaf_cache);
                 }
                 else
                 {
-                    ExploreTreeNode(
-                        current_tree_index, fixed_projected_coordinate, traversal_queue);
+                    ExploreTreeNode(current_tree_index,
+                                    fixed_projected_coordinate,
+                                    bearing_bins,
+                                    big_components_only,
+                                    traversal_queue);
                 }
             }
             else
@@ -662,29 +690,27 @@ class StaticRTree
         return results;
     }
 
-  private:
     /**
      * Iterates over all the objects in a leaf node and inserts them into our
      * search priority queue.  The speed of this function is very much governed
      * by the value of LEAF_NODE_SIZE, as we'll calculate the euclidean distance
      * for every child of each leaf node visited.
+     * With a leaf cache the projected segments of the leaf are reused if a previous
+     * query of the batch already explored it.
      */
     template <typename QueueT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
                          const Coordinate &projected_input_coordinate_fixed,
                          const FloatCoordinate &projected_input_coordinate,
-                         QueueT &traversal_queue) const
+                         QueueT &traversal_queue,
+                         LeafCache *leaf_cache) const
     {
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(is_leaf(leaf_id));
 
-        for (const auto i : child_indexes(leaf_id))
-        {
-            const auto &current_edge = m_objects[i];
-
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
-
+        const auto push_segment = [&](const std::size_t i,
+                                      const FloatCoordinate &projected_u,
+                                      const FloatCoordinate &projected_v) {
             FloatCoordinate projected_nearest;
             std::tie(std::ignore, projected_nearest) =
                 coordinate_calculation::projectPointOnSegment(
@@ -699,6 +725,40 @@ class StaticRTree
                                                 leaf_id,
                                                 static_cast<std::uint32_t>(i),
                                                 Coordinate{projected_nearest}});
+        };
+
+        if (leaf_cache == nullptr)
+        {
+            for (const auto i : child_indexes(leaf_id))
+            {
+                const auto &current_edge = m_objects[i];
+                push_segment(i,
+                             web_mercator::fromWGS84(m_coordinate_list[current_edge.u]),
+                             web_mercator::fromWGS84(m_coordinate_list[current_edge.v]));
+            }
+            return;
+        }
+
+        auto &slot = leaf_cache->slots[leaf_id.offset % LeafCache::NUMBER_OF_SLOTS];
+        if (slot.leaf_offset != leaf_id.offset)
+        {
+            slot.leaf_offset = leaf_id.offset;
+            slot.projected_segments.clear();
+            for (const auto i : child_indexes(leaf_id))
+            {
+                const auto &current_edge = m_objects[i];
+                slot.projected_segments.emplace_back(
+                    web_mercator::fromWGS84(m_coordinate_list[current_edge.u]),
+                    web_mercator::fromWGS84(m_coordinate_list[current_edge.v]));
+            }
+        }
+
+        auto projected_segment = slot.projected_segments.begin();
+        for (const auto i : child_indexes(leaf_id))
+        {
+            BOOST_ASSERT(projected_segment != slot.projected_segments.end());
+            push_segment(i, projected_segment->first, projected_segment->second);
+            ++projected_segment;
         }
     }
 
@@ -708,10 +768,14 @@ class StaticRTree
      * priority metric.
      * The closests distance to a box from our point is also the closest distance
      * to the closest line in that box (assuming the boxes hug their contents).
+     * Children without a segment in the bearing bins are skipped, and so are children
+     * without a segment of a big component if only those are searched.
      */
     template <class QueueT>
     void ExploreTreeNode(const TreeIndex &parent,
                          const Coordinate &fixed_projected_input_coordinate,
+                         const bearing::Bins bearing_bins,
+                         const bool big_components_only,
                          QueueT &traversal_queue) const
     {
         // Figure out which_id level the parent is on, and it's offset
@@ -719,18 +783,309 @@ class StaticRTree
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(!is_leaf(parent));
 
-        for (const auto child_index : child_indexes(parent))
+        // the children are stored consecutively, so all of their distances are computed at once
+        const auto children = child_indexes(parent);
+        BOOST_ASSERT(children.size() <= BRANCHING_FACTOR);
+        std::array<std::uint64_t, BRANCHING_FACTOR> squared_lower_bounds;
+        m_packed_rectangles.GetMinSquaredDists(children.front(),
+                                               children.size(),
+                                               fixed_projected_input_coordinate,
+                                               squared_lower_bounds.data());
+
+        // the bins are only looked at if they can rule out children
+        if (bearing_bins != bearing::ALL_BINS)
         {
-            const auto &child = m_search_tree[child_index];
-
-            const auto squared_lower_bound_to_element =
-                child.minimum_bounding_rectangle.GetMinSquaredDist(
-                    fixed_projected_input_coordinate);
+            for (const auto child_index : children)
+            {
+                if ((m_search_tree[child_index].bearing_bins & bearing_bins) == 0)
+                {
+                    squared_lower_bounds[child_index - children.front()] =
+                        std::numeric_limits<std::uint64_t>::max();
+                }
+            }
+        }
+        if (big_components_only)
+        {
+            for (const auto child_index : children)
+            {
+                if (!m_search_tree[child_index].has_big_component)
+                {
+                    squared_lower_bounds[child_index - children.front()] =
+                        std::numeric_limits<std::uint64_t>::max();
+                }
+            }
+        }
 
+        for (const auto child_index : children)
+        {
+            if (squared_lower_bounds[child_index - children.front()] ==
+                std::numeric_limits<std::uint64_t>::max())
+            {
+                continue;
+            }
             traversal_queue.push(QueryCandidate{
-                squared_lower_bound_to_element,
+                squared_lower_bounds[child_index - children.front()],
                 TreeIndex(parent.level + 1, child_index - m_tree_level_starts[parent.level + 1])});
         }
+
+        // The nearest leaves are almost always explored next, start loading their first objects
+        // while the queue is worked on. Leaves of pages that are not resident are not loaded.
+        if (parent.level + 2 == m_tree_level_starts.size())
+        {
+            const auto nearest = *std::min_element(squared_lower_bounds.begin(),
+                                                   squared_lower_bounds.begin() + children.size());
+            for (const auto child_index : children)
+            {
+                if (squared_lower_bounds[child_index - children.front()] == nearest &&
+                    nearest != std::numeric_limits<std::uint64_t>::max())
+                {
+                    const auto offset = child_index - m_tree_level_starts[parent.level + 1];
+                    PrefetchLeaf(offset * LEAF_NODE_SIZE);
+                }
+            }
+        }
+    }
+
+    void PrefetchLeaf(const std::size_t first_object) const
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        const auto *leaf = reinterpret_cast<const char *>(m_objects.data() + first_object);
+        for (std::size_t line = 0; line < LEAF_PREFETCH_LINES; ++line)
+        {
+            __builtin_prefetch(leaf + line * 64);
+        }
+#else
+        (void)first_object;
+#endif
+    }
+
+    template <typename ReleaseInputT>
+    void Build(const std::vector<EdgeDataT> &input_data_vector,
+               const ReleaseInputT release_input,
+               const std::string &tree_node_filename,
+               const std::string &leaf_node_filename,
+               const std::size_t elements_per_run,
+               const IsTinyComponent &is_tiny_component)
+    {
+        BOOST_ASSERT(elements_per_run > 0);
+        const auto element_count = input_data_vector.size();
+
+        // Step 1 - sort runs of Hilbert Code/object pairs, all but a single run go to disk
+        std::vector<SortedRun> runs;
+        std::vector<std::string> run_filenames;
+        for (std::size_t run_begin = 0; run_begin < element_count; run_begin += elements_per_run)
+        {
+            const auto run_size = std::min(elements_per_run, element_count - run_begin);
+            std::vector<HilbertElement> run(run_size);
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, run_size),
+                [&](const tbb::blocked_range<std::size_t> &range) {
+                    for (auto index = range.begin(), end = range.end(); index != end; ++index)
+                    {
+                        const EdgeDataT &current_element = input_data_vector[run_begin + index];
+
+                        // Get Hilbert-Value for centroid in mercartor projection
+                        BOOST_ASSERT(current_element.u < m_coordinate_list.size());
+                        BOOST_ASSERT(current_element.v < m_coordinate_list.size());
+
+                        Coordinate current_centroid =
+                            coordinate_calculation::centroid(m_coordinate_list[current_element.u],
+                                                             m_coordinate_list[current_element.v]);
+                        current_centroid.lat = FixedLatitude{static_cast<std::int32_t>(
+                            COORDINATE_PRECISION *
+                            web_mercator::latToY(toFloating(current_centroid.lat)))};
+
+                        run[index] = {GetHilbertCode(current_centroid), current_element};
+                    }
+                });
+            tbb::parallel_sort(run.begin(), run.end());
+
+            SortedRun sorted_run;
+            if (run_size == element_count)
+            {
+                sorted_run.buffer = std::move(run);
+            }
+            else
+            {
+                run_filenames.push_back(leaf_node_filename + ".run" +
+                                        std::to_string(run_filenames.size()));
+                {
+                    storage::io::FileWriter run_file(run_filenames.back(),
+                                                     storage::io::FileWriter::HasNoFingerprint);
+                    run_file.WriteFrom(run.data(), run.size());
+                }
+                sorted_run.file = std::make_unique<storage::io::FileReader>(
+                    run_filenames.back(), storage::io::FileReader::HasNoFingerprint);
+                sorted_run.remaining = run_size;
+                sorted_run.Refill();
+            }
+            runs.push_back(std::move(sorted_run));
+        }
+        release_input();
+
+        // Step 2 - merge the runs into LEAF_NODE_SIZE blocks of objects that are written
+        // to the leaf node file right away, and create a TreeNode bounding each
+        std::vector<TreeNode> leaves;
+        leaves.reserve((element_count + LEAF_NODE_SIZE - 1) / LEAF_NODE_SIZE);
+        {
+            storage::io::FileWriter leaf_node_file(leaf_node_filename,
+                                                   storage::io::FileWriter::HasNoFingerprint);
+
+            // the smallest Hilbert Code at the top, ties are taken from the earlier run
+            using RunHead = std::pair<std::uint64_t, std::size_t>;
+            std::priority_queue<RunHead, std::vector<RunHead>, std::greater<RunHead>> heads;
+            for (const auto run_index : irange<std::size_t>(0, runs.size()))
+            {
+                if (!runs[run_index].Empty())
+                    heads.push({runs[run_index].Front().hilbert_value, run_index});
+            }
+
+            std::array<EdgeDataT, LEAF_NODE_SIZE> objects;
+            std::uint32_t object_count = 0;
+            TreeNode current_node;
+            while (!heads.empty())
+            {
+                const auto run_index = heads.top().second;
+                auto &run = runs[run_index];
+                heads.pop();
+
+                const EdgeDataT &object = run.Front().object;
+                objects[object_count++] = object;
+
+                Coordinate projected_u{
+                    web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
+                Coordinate projected_v{
+                    web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
+
+                BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
+                BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
+                BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
+                BOOST_ASSERT(std::abs(toFloating(projected_v.lat).operator double()) <= 180.);
+
+                Rectangle rectangle;
+                rectangle.min_lon =
+                    std::min(rectangle.min_lon, std::min(projected_u.lon, projected_v.lon));
+                rectangle.max_lon =
+                    std::max(rectangle.max_lon, std::max(projected_u.lon, projected_v.lon));
+
+                rectangle.min_lat =
+                    std::min(rectangle.min_lat, std::min(projected_u.lat, projected_v.lat));
+                rectangle.max_lat =
+                    std::max(rectangle.max_lat, std::max(projected_u.lat, projected_v.lat));
+
+                BOOST_ASSERT(rectangle.IsValid());
+                current_node.minimum_bounding_rectangle.MergeBoundingBoxes(rectangle);
+
+                // the same bearings the bearing filter of the queries computes
+                const double forward_bearing = coordinate_calculation::bearing(
+                    m_coordinate_list[object.u], m_coordinate_list[object.v]);
+                const double backward_bearing = (forward_bearing + 180) > 360
+                                                    ? (forward_bearing - 180)
+                                                    : (forward_bearing + 180);
+                if (object.forward_segment_id.enabled)
+                    current_node.bearing_bins |= bearing::BinOf(std::round(forward_bearing));
+                if (object.reverse_segment_id.enabled)
+                    current_node.bearing_bins |= bearing::BinOf(std::round(backward_bearing));
+                if (!is_tiny_component || !is_tiny_component(object))
+                    current_node.has_big_component = true;
+
+                run.Pop();
+                if (!run.Empty())
+                    heads.push({run.Front().hilbert_value, run_index});
+
+                // Write out our EdgeDataT block to the leaf node file
+                if (object_count == LEAF_NODE_SIZE || heads.empty())
+                {
+                    leaf_node_file.WriteFrom(objects.data(), object_count);
+                    leaves.push_back(current_node);
+                    current_node = TreeNode{};
+                    object_count = 0;
+                }
+            }
+
+            // leaf_node_file wil be RAII closed at this point
+        }
+        runs.clear();
+        for (const auto &run_filename : run_filenames)
+        {
+            boost::filesystem::remove(run_filename);
+        }
+
+        // Step 3 - the levels hold BRANCHING_FACTOR nodes of the level below each, rounded
+        // up, computed from the root down
+        BOOST_ASSERT_MSG(!leaves.empty(), "tree empty");
+        m_tree_level_sizes = {static_cast<std::uint64_t>(leaves.size())};
+        while (m_tree_level_sizes.back() > 1)
+        {
+            m_tree_level_sizes.push_back(
+                (m_tree_level_sizes.back() + BRANCHING_FACTOR - 1) / BRANCHING_FACTOR);
+        }
+        std::reverse(m_tree_level_sizes.begin(), m_tree_level_sizes.end());
+
+        // The first level starts at 0
+        m_tree_level_starts = {0};
+        // The remaining levels start at the partial sum of the preceeding level sizes
+        std::partial_sum(m_tree_level_sizes.begin(),
+                         m_tree_level_sizes.end() - 1,
+                         std::back_inserter(m_tree_level_starts));
+
+        m_search_tree.resize(m_tree_level_starts.back() + m_tree_level_sizes.back());
+        std::move(leaves.begin(), leaves.end(), m_search_tree.begin() + m_tree_level_starts.back());
+        std::vector<TreeNode>().swap(leaves);
+
+        // Calculate the bounding box, bearing bins and components of the children of every node
+        // of a level at once, the children are the BRANCHING_FACTOR nodes at the same position
+        // in the level below
+        for (auto level = m_tree_level_sizes.size() - 1; level > 0; --level)
+        {
+            const auto parent_level = level - 1;
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, m_tree_level_sizes[parent_level]),
+                [&](const tbb::blocked_range<std::size_t> &range) {
+                    for (auto offset = range.begin(), end = range.end(); offset != end; ++offset)
+                    {
+                        const TreeIndex parent(parent_level, offset);
+                        TreeNode parent_node;
+                        for (const auto child_node_idx : child_indexes(parent))
+                        {
+                            parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
+                                m_search_tree[child_node_idx].minimum_bounding_rectangle);
+                            parent_node.bearing_bins |= m_search_tree[child_node_idx].bearing_bins;
+                            parent_node.has_big_component |=
+                                m_search_tree[child_node_idx].has_big_component;
+                        }
+                        m_search_tree[m_tree_level_starts[parent_level] + offset] = parent_node;
+                    }
+                });
+        }
+
+        // Write all the TreeNode data to disk
+        {
+            storage::io::FileWriter tree_node_file(tree_node_filename,
+                                                   storage::io::FileWriter::GenerateFingerprint);
+
+            std::uint64_t size_of_tree = m_search_tree.size();
+            BOOST_ASSERT_MSG(0 < size_of_tree, "tree empty");
+
+            tree_node_file.WriteOne(size_of_tree);
+            tree_node_file.WriteFrom(m_search_tree);
+
+            tree_node_file.WriteOne(static_cast<std::uint64_t>(m_tree_level_sizes.size()));
+            tree_node_file.WriteFrom(m_tree_level_sizes);
+        }
+
+        m_objects = mmapFile<EdgeDataT>(leaf_node_filename, m_objects_region);
+        PackRectangles();
+    }
+
+    void PackRectangles()
+    {
+        m_packed_rectangles =
+            PackedRectangles(m_search_tree.begin(),
+                             m_search_tree.end(),
+                             [](const TreeNode &node) -> const Rectangle & {
+                                 return node.minimum_bounding_rectangle;
+                             });
     }
 
     /**
@@ -2,6 +2,7 @@
 #define STRING_UTIL_HPP
 
 #include <cctype>
+#include <cstring>
 
 #include <random>
 #include <string>
@@ -125,6 +126,30 @@ inline std::size_t URIDecode(const std::string &input, std::string &output)
 }
 
 inline std::size_t URIDecodeInPlace(std::string &URI) { return URIDecode(URI, URI); }
+
+// Percent-encodes all characters that are not allowed in the path or query of a URI
+inline std::string URIEncode(const std::string &input)
+{
+    const constexpr char hex_digits[] = "0123456789ABCDEF";
+    std::string output;
+    output.reserve(input.size());
+    for (const char character : input)
+    {
+        const auto letter = static_cast<unsigned char>(character);
+        if (std::isalnum(letter) ||
+            (letter != 0 && std::strchr("-._~!$&'()*+,;=:@/?", letter) != nullptr))
+        {
+            output += character;
+        }
+        else
+        {
+            output += '%';
+            output += hex_digits[letter >> 4];
+            output += hex_digits[letter & 0xf];
+        }
+    }
+    return output;
+}
 }
 }
 
@@ -3,8 +3,12 @@
 
 #include "util/integer_range.hpp"
 
+#include <boost/assert.hpp>
+
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <sstream>
 #include <vector>
@@ -88,6 +92,60 @@ template <std::size_t TimeBinSize = 1000, std::size_t IndexBinSize = 1000> class
     std::vector<std::uint32_t> frame_offsets;
     std::vector<std::uint32_t> frame_counters;
 };
+
+/**
+ * Histogram of durations in microseconds with logarithmic bins: every power of two is split
+ * into four bins, so a bin is at most 25% wider than its lower bound.
+ *
+ * It is meant to be written by a single thread without locking while other threads read it,
+ * counts are only eventually consistent with each other.
+ */
+class LatencyHistogram
+{
+  public:
+    static constexpr std::size_t NUM_BINS = 160;
+
+    void Count(const std::uint64_t microseconds)
+    {
+        const auto bin = std::min(BinIndex(microseconds), NUM_BINS - 1);
+        bins[bin].store(bins[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum.store(sum.load(std::memory_order_relaxed) + microseconds, std::memory_order_relaxed);
+    }
+
+    std::uint64_t GetCount() const { return total.load(std::memory_order_relaxed); }
+
+    std::uint64_t GetSum() const { return sum.load(std::memory_order_relaxed); }
+
+    std::uint64_t GetBinCount(const std::size_t bin) const
+    {
+        return bins[bin].load(std::memory_order_relaxed);
+    }
+
+    // Smallest duration that falls into the bin
+    static std::uint64_t GetBinLowerBound(const std::size_t bin)
+    {
+        if (bin < 4)
+            return bin;
+        const auto exponent = bin / 4 + 1;
+        return (4 + bin % 4) << (exponent - 2);
+    }
+
+    static std::size_t BinIndex(const std::uint64_t microseconds)
+    {
+        if (microseconds < 4)
+            return microseconds;
+        std::size_t exponent = 0;
+        while ((microseconds >> (exponent + 1)) != 0)
+            ++exponent;
+        return 4 * (exponent - 1) + ((microseconds >> (exponent - 2)) & 3);
+    }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, NUM_BINS> bins{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> sum{0};
+};
 }
 }
 
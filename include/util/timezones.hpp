@@ -11,6 +11,8 @@
 #include <rapidjson/document.h>
 
 #include <chrono>
+#include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -28,6 +30,10 @@ using rtree_t =
     boost::geometry::index::rtree<std::pair<box_t, size_t>, boost::geometry::index::rstar<8>>;
 using local_time_t = std::pair<polygon_t, struct tm>;
 
+// Local time in the time zone `tzname` for `utc_time`
+// Thread safety: MT-Unsafe const:env
+struct tm getLocalTime(const char *tzname, std::time_t utc_time);
+
 class Timezoner
 {
   public:
@@ -38,11 +44,16 @@ class Timezoner
 
     boost::optional<struct tm> operator()(const point_t &point) const;
 
+    // Name of the time zone shape that contains `point`
+    boost::optional<std::string> GetTimezoneName(const point_t &point) const;
+
   private:
     void LoadLocalTimesRTree(rapidjson::Document &geojson, std::time_t utc_time);
+    boost::optional<std::size_t> FindPolygon(const point_t &point) const;
 
     rtree_t rtree;
     std::vector<local_time_t> local_times;
+    std::vector<std::string> local_time_names;
 };
 }
 }
@@ -6,6 +6,8 @@ local find_access_tag = require("lib/access").find_access_tag
 local Set = require('lib/set')
 local Sequence = require('lib/sequence')
 local Handlers = require("lib/handlers")
+local WayBatch = require("lib/way_batch")
+local NativeRules = require("lib/native_rules")
 local next = next       -- bind to local for speed
 
 -- set profile properties
@@ -262,6 +264,18 @@ local profile = {
   }
 }
 
+-- ways that are obviously not routable are rejected by osrm-extract without calling way_function
+native_way_rules = NativeRules.from_profile(profile, { 'highway', 'route' })
+
+-- turn penalties of turn_function below, computed by osrm-extract without calling into Lua.
+-- Remove this table when changing turn_function.
+native_turn_penalties = {
+  turn_penalty          = profile.turn_penalty,
+  turn_bias             = profile.turn_bias,
+  traffic_light_penalty = profile.traffic_light_penalty,
+  u_turn_penalty        = profile.u_turn_penalty
+}
+
 function get_name_suffix_list(vector)
   for index,suffix in ipairs(profile.suffix_list) do
       vector:Add(suffix)
@@ -387,6 +401,11 @@ function way_function(way, result)
   Handlers.run(handlers,way,result,data,profile)
 end
 
+-- all ways of a buffer at once, the tags are read through the LuaJIT FFI if available
+function process_ways(batch)
+  WayBatch.run(batch, way_function, { 'highway', 'route' })
+end
+
 function turn_function (turn)
   -- Use a sigmoid function to return a penalty that maxes out at turn_penalty
   -- over the space of 0-180 degrees.  Values here were chosen by fitting
@@ -0,0 +1,81 @@
+-- Builds the native_way_rules table from the tables of a profile that
+-- uses the way handlers of lib/handlers.lua.
+--
+-- osrm-extract evaluates these rules without calling into Lua and does
+-- not pass the ways they reject to the way_function, all other ways are
+-- processed by the profile as before. The rules mirror the checks of
+-- way_function, handle_blocked_ways, handle_access and handle_speed
+-- that make a way not routable; a profile changing these handlers must
+-- not use them.
+--
+-- native_way_rules = NativeRules.from_profile(profile, { 'highway', 'route' })
+
+local NativeRules = {}
+
+local function keys(set)
+  local list = {}
+  for key, value in pairs(set or {}) do
+    if value then
+      table.insert(list, key)
+    end
+  end
+  return list
+end
+
+-- tags that handle_blocked_ways rejects for the avoid set of the profile
+local avoided_tags = {
+  area = { area = 'yes' },
+  toll = { toll = 'yes' },
+  steps = { highway = 'steps' },
+  construction = { highway = 'construction', railway = 'construction' },
+  reversible = { oneway = 'reversible' },
+  impassable = { impassable = 'yes', status = 'impassable' }
+}
+
+local function add_tag(tags, key, value)
+  tags[key] = tags[key] or {}
+  table.insert(tags[key], value)
+end
+
+-- values of a table of speeds that handle_speed, handle_ferries or
+-- handle_movables use as a speed
+local function add_speeds(tags, key, speeds)
+  for value, speed in pairs(speeds or {}) do
+    if speed and speed > 0 then
+      add_tag(tags, key, value)
+    end
+  end
+end
+
+function NativeRules.from_profile(profile, required_keys)
+  local blocked_tags = {}
+  for avoided in pairs(profile.avoid or {}) do
+    for key, value in pairs(avoided_tags[avoided] or {}) do
+      add_tag(blocked_tags, key, value)
+    end
+  end
+
+  local speed_tags = {}
+  for key, speeds in pairs(profile.speeds or {}) do
+    add_speeds(speed_tags, key, speeds)
+  end
+  add_speeds(speed_tags, 'route', profile.route_speeds)
+  add_speeds(speed_tags, 'bridge', profile.bridge_speeds)
+
+  local access_keys = {}
+  for _, key in ipairs(profile.access_tags_hierarchy) do
+    table.insert(access_keys, key)
+  end
+
+  return {
+    required_keys = required_keys,
+    blocked_tags = blocked_tags,
+    speed_tags = speed_tags,
+    access_keys = access_keys,
+    access_blacklist = keys(profile.access_tag_blacklist),
+    restricted_access = keys(profile.restricted_access_tag_list),
+    restricted_highways = keys(profile.restricted_highway_whitelist)
+  }
+end
+
+return NativeRules
@@ -0,0 +1,82 @@
+-- Runs a way_function over the ways of a batch that osrm-extract passes
+-- to process_ways, instead of calling into the profile once per way.
+--
+-- The tags of the ways are read from the contiguous arrays of the batch
+-- with the LuaJIT FFI when it is available, plain Lua reads the tags of a
+-- way with a single call. Ways without any of the required tags are
+-- skipped without building a result for them.
+--
+-- function process_ways(batch)
+--   WayBatch.run(batch, way_function, { 'highway', 'route' })
+-- end
+
+local WayBatch = {}
+
+local has_ffi, ffi = pcall(require, 'ffi')
+
+-- way passed to the way_function, only the tags are held in Lua
+local Way = {}
+Way.__index = Way
+
+function Way:get_value_by_key(key)
+  local value = self.tags[key]
+  if value ~= '' then
+    return value
+  end
+end
+
+function Way:id()
+  return self.batch:way(self.index):id()
+end
+
+function Way:version()
+  return self.batch:way(self.index):version()
+end
+
+function Way:get_nodes()
+  return self.batch:way(self.index):get_nodes()
+end
+
+local function tag_reader(batch)
+  if has_ffi then
+    local offsets = ffi.cast('const uint32_t *', batch.tag_offsets)
+    local keys = ffi.cast('const char **', batch.keys)
+    local values = ffi.cast('const char **', batch.values)
+    local string = ffi.string
+    return function(index)
+      local tags = {}
+      for tag = offsets[index], offsets[index + 1] - 1 do
+        tags[string(keys[tag])] = string(values[tag])
+      end
+      return tags
+    end
+  end
+
+  return function(index)
+    return batch:get_tags(index)
+  end
+end
+
+local function has_any(tags, required)
+  for _, key in ipairs(required) do
+    local value = tags[key]
+    if value and value ~= '' then
+      return true
+    end
+  end
+  return false
+end
+
+-- Ways of the batch are indexed from 0 to batch.size - 1 like the FFI arrays.
+function WayBatch.run(batch, way_function, required)
+  local read_tags = tag_reader(batch)
+  for index = 0, batch.size - 1 do
+    local tags = read_tags(index)
+    if not required or has_any(tags, required) then
+      local way = setmetatable({ tags = tags, batch = batch, index = index }, Way)
+      way_function(way, batch:result(index))
+    end
+  end
+end
+
+return WayBatch
@@ -0,0 +1,128 @@
+#include "util/coordinate.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+#ifdef _WIN32
+#pragma optimize("", off)
+template <class T> void dont_optimize_away(T &&datum) { T local = datum; }
+#pragma optimize("", on)
+#else
+template <class T> void dont_optimize_away(T &&datum) { asm volatile("" : "+r"(datum)); }
+#endif
+
+struct Measurement
+{
+    double scalar_ms;
+    double batched_ms;
+    double max_absolute_error;
+    double max_relative_error;
+};
+
+// Pairs of coordinates like the segments of roads, a few meters to a kilometer apart
+std::pair<std::vector<util::Coordinate>, std::vector<util::Coordinate>>
+makeSegments(const std::size_t num_segments)
+{
+    std::mt19937 g(1337);
+    std::uniform_real_distribution<> lon_dist(-180, 180);
+    std::uniform_real_distribution<> lat_dist(-80, 80);
+    std::uniform_real_distribution<> offset_dist(-0.01, 0.01);
+
+    std::vector<util::Coordinate> first, second;
+    for (std::size_t index = 0; index < num_segments; ++index)
+    {
+        const auto lon = lon_dist(g);
+        const auto lat = lat_dist(g);
+        first.emplace_back(util::FloatLongitude{lon}, util::FloatLatitude{lat});
+        second.emplace_back(
+            util::FloatLongitude{std::max(-180., std::min(180., lon + offset_dist(g)))},
+            util::FloatLatitude{lat + offset_dist(g)});
+    }
+    return {std::move(first), std::move(second)};
+}
+
+template <std::size_t num_rounds, typename ScalarT, typename BatchedT>
+Measurement measure(const std::vector<util::Coordinate> &first,
+                    const std::vector<util::Coordinate> &second,
+                    const ScalarT scalar,
+                    const BatchedT batched)
+{
+    std::vector<double> scalar_distances(first.size());
+    std::vector<double> batched_distances(first.size());
+
+    TIMER_START(scalar);
+    for (std::size_t round = 0; round < num_rounds; ++round)
+    {
+        for (auto index : util::irange<std::size_t>(0, first.size()))
+        {
+            scalar_distances[index] = scalar(first[index], second[index]);
+        }
+        dont_optimize_away(scalar_distances.back());
+    }
+    TIMER_STOP(scalar);
+
+    TIMER_START(batched);
+    for (std::size_t round = 0; round < num_rounds; ++round)
+    {
+        batched(first.data(), second.data(), first.size(), batched_distances.data());
+        dont_optimize_away(batched_distances.back());
+    }
+    TIMER_STOP(batched);
+
+    Measurement measurement{TIMER_MSEC(scalar), TIMER_MSEC(batched), 0., 0.};
+    for (auto index : util::irange<std::size_t>(0, first.size()))
+    {
+        const auto error = std::abs(batched_distances[index] - scalar_distances[index]);
+        measurement.max_absolute_error = std::max(measurement.max_absolute_error, error);
+        if (scalar_distances[index] > 0)
+        {
+            measurement.max_relative_error =
+                std::max(measurement.max_relative_error, error / scalar_distances[index]);
+        }
+    }
+    return measurement;
+}
+
+void logMeasurement(const char *name,
+                    const Measurement &measurement,
+                    const std::size_t num_distances)
+{
+    util::Log() << name << ": scalar " << measurement.scalar_ms << " ms ("
+                << num_distances / (measurement.scalar_ms * 1000.) << " M/s), batched "
+                << measurement.batched_ms << " ms ("
+                << num_distances / (measurement.batched_ms * 1000.) << " M/s). "
+                << measurement.scalar_ms / measurement.batched_ms << "x, max error "
+                << measurement.max_absolute_error << " m, max relative error "
+                << measurement.max_relative_error;
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const constexpr std::size_t num_segments = 1000000;
+    const constexpr std::size_t num_rounds = 20;
+    const auto segments = makeSegments(num_segments);
+
+    const auto haversine =
+        measure<num_rounds>(segments.first,
+                            segments.second,
+                            util::coordinate_calculation::haversineDistance,
+                            util::coordinate_calculation::haversineDistances);
+    logMeasurement("haversine", haversine, num_segments * num_rounds);
+
+    const auto great_circle =
+        measure<num_rounds>(segments.first,
+                            segments.second,
+                            util::coordinate_calculation::greatCircleDistance,
+                            util::coordinate_calculation::greatCircleDistances);
+    logMeasurement("great circle", great_circle, num_segments * num_rounds);
+}
@@ -0,0 +1,101 @@
+#include "extractor/node_data_container.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+#ifdef _WIN32
+#pragma optimize("", off)
+template <class T> void dont_optimize_away(T &&datum) { T local = datum; }
+#pragma optimize("", on)
+#else
+template <class T> void dont_optimize_away(T &&datum) { asm volatile("" : "+r"(datum)); }
+#endif
+
+// The layout the edge-based node data had before: one array per field
+struct SeparateNodeData
+{
+    SeparateNodeData(std::size_t size)
+        : geometry_ids(size), name_ids(size), travel_modes(size), classes(size)
+    {
+    }
+
+    void SetData(NodeID node_id,
+                 GeometryID geometry_id,
+                 NameID name_id,
+                 extractor::TravelMode travel_mode,
+                 extractor::ClassData class_data)
+    {
+        geometry_ids[node_id] = geometry_id;
+        name_ids[node_id] = name_id;
+        travel_modes[node_id] = travel_mode;
+        classes[node_id] = class_data;
+    }
+
+    GeometryID GetGeometryID(const NodeID node_id) const { return geometry_ids[node_id]; }
+    NameID GetNameID(const NodeID node_id) const { return name_ids[node_id]; }
+    extractor::TravelMode GetTravelMode(const NodeID node_id) const
+    {
+        return travel_modes[node_id];
+    }
+    extractor::ClassData GetClassData(const NodeID node_id) const { return classes[node_id]; }
+
+    std::vector<GeometryID> geometry_ids;
+    std::vector<NameID> name_ids;
+    std::vector<extractor::TravelMode> travel_modes;
+    std::vector<extractor::ClassData> classes;
+};
+
+// Reads all fields of randomly chosen nodes, like annotating a path does
+template <std::size_t num_rounds, std::size_t num_entries, typename ContainerT>
+double measure_random_read()
+{
+    std::vector<NodeID> indices(num_entries);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::mt19937 g(1337);
+    std::shuffle(indices.begin(), indices.end(), g);
+
+    ContainerT container(num_entries);
+    for (auto idx : util::irange<std::size_t>(0, num_entries))
+    {
+        container.SetData(indices[idx],
+                          GeometryID{static_cast<NodeID>(idx), idx % 2 == 0},
+                          static_cast<NameID>(idx),
+                          static_cast<extractor::TravelMode>(idx % 8),
+                          static_cast<extractor::ClassData>(idx % 256));
+    }
+
+    TIMER_START(read);
+    for (auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        std::size_t sum = round;
+        for (auto idx : util::irange<std::size_t>(0, num_entries))
+        {
+            const auto node = indices[idx];
+            sum += container.GetGeometryID(node).id + container.GetNameID(node) +
+                   container.GetTravelMode(node) + container.GetClassData(node);
+        }
+        dont_optimize_away(sum);
+    }
+    TIMER_STOP(read);
+
+    return TIMER_MSEC(read);
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const auto separate_ms = measure_random_read<10, 10000000, SeparateNodeData>();
+    const auto packed_ms =
+        measure_random_read<10, 10000000, extractor::EdgeBasedNodeDataContainer>();
+
+    util::Log() << "random read: separate arrays " << separate_ms << " ms, packed records "
+                << packed_ms << " ms. " << separate_ms / packed_ms << "x";
+}
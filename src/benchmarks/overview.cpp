@@ -0,0 +1,57 @@
+#include "engine/douglas_peucker.hpp"
+#include "engine/polyline_compressor.hpp"
+#include "util/coordinate.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+// A long route as a random walk with coordinates about 50m apart
+std::vector<util::Coordinate> makeGeometry(const std::size_t size)
+{
+    std::mt19937 generator(1337);
+    std::normal_distribution<double> step(0, 0.0005);
+
+    std::vector<util::Coordinate> geometry;
+    geometry.reserve(size);
+    double lon = 7.41;
+    double lat = 43.73;
+    while (geometry.size() < size)
+    {
+        lon += step(generator);
+        lat += step(generator);
+        geometry.push_back({util::FloatLongitude{lon}, util::FloatLatitude{lat}});
+    }
+    return geometry;
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    const auto geometry = makeGeometry(1000000);
+
+    for (const auto zoom_level : {10u, 14u, 18u})
+    {
+        TIMER_START(simplify);
+        const auto simplified = engine::douglasPeucker(geometry, zoom_level);
+        TIMER_STOP(simplify);
+        util::Log() << "douglasPeucker z" << zoom_level << ": " << TIMER_MSEC(simplify) << " ms, "
+                    << geometry.size() << " -> " << simplified.size() << " coordinates";
+    }
+
+    TIMER_START(polyline);
+    const auto polyline = engine::encodePolyline<100000>(geometry.begin(), geometry.end());
+    TIMER_STOP(polyline);
+    util::Log() << "encodePolyline: " << TIMER_MSEC(polyline) << " ms, " << polyline.size()
+                << " bytes";
+
+    TIMER_START(polyline6);
+    const auto polyline6 = engine::encodePolyline<1000000>(geometry.begin(), geometry.end());
+    TIMER_STOP(polyline6);
+    util::Log() << "encodePolyline6: " << TIMER_MSEC(polyline6) << " ms, " << polyline6.size()
+                << " bytes";
+}
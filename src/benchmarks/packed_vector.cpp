@@ -8,6 +8,7 @@
 #include <numeric>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace osrm;
@@ -62,6 +63,70 @@ auto measure_random_access()
     return Measurement{TIMER_MSEC(write), TIMER_MSEC(read)};
 }
 
+// Reads and writes the vector in runs like the segments of geometries, element by element and
+// with the bulk decode_range and encode_range
+template <std::size_t num_rounds, std::size_t num_entries, std::size_t run_length, typename VectorT>
+auto measure_range_access()
+{
+    VectorT vector(num_entries);
+    std::vector<std::uint32_t> run(run_length);
+
+    TIMER_START(element_write);
+    for (auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        for (std::size_t begin = 0; begin + run_length <= num_entries; begin += run_length)
+        {
+            for (auto idx : util::irange<std::size_t>(0, run_length))
+            {
+                vector[begin + idx] = begin + idx + round;
+            }
+        }
+    }
+    TIMER_STOP(element_write);
+
+    TIMER_START(element_read);
+    for (auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        std::uint32_t sum = round;
+        for (std::size_t begin = 0; begin + run_length <= num_entries; begin += run_length)
+        {
+            for (auto idx : util::irange<std::size_t>(0, run_length))
+            {
+                sum += vector[begin + idx];
+            }
+        }
+        dont_optimize_away(sum);
+    }
+    TIMER_STOP(element_read);
+
+    TIMER_START(range_write);
+    for (auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        for (std::size_t begin = 0; begin + run_length <= num_entries; begin += run_length)
+        {
+            std::iota(run.begin(), run.end(), begin + round);
+            vector.encode_range(begin, run.begin(), run.end());
+        }
+    }
+    TIMER_STOP(range_write);
+
+    TIMER_START(range_read);
+    for (auto round : util::irange<std::size_t>(0, num_rounds))
+    {
+        std::uint32_t sum = round;
+        for (std::size_t begin = 0; begin + run_length <= num_entries; begin += run_length)
+        {
+            vector.decode_range(begin, begin + run_length, run.begin());
+            sum = std::accumulate(run.begin(), run.end(), sum);
+        }
+        dont_optimize_away(sum);
+    }
+    TIMER_STOP(range_read);
+
+    return std::make_pair(Measurement{TIMER_MSEC(element_write), TIMER_MSEC(element_read)},
+                          Measurement{TIMER_MSEC(range_write), TIMER_MSEC(range_read)});
+}
+
 int main(int, char **)
 {
     util::LogPolicy::GetInstance().Unmute();
@@ -78,4 +143,13 @@ int main(int, char **)
     util::Log() << "random read: std::vector " << result_plain.random_read_ms
                 << " ms, util::packed_vector " << result_packed.random_read_ms << " ms. "
                 << read_slowdown;
+
+    const auto result_ranges =
+        measure_range_access<1000, 1000000, 16, util::PackedVector<std::uint32_t, 22>>();
+    util::Log() << "runs of 16 write: elements " << result_ranges.first.random_write_ms
+                << " ms, encode_range " << result_ranges.second.random_write_ms << " ms. "
+                << result_ranges.first.random_write_ms / result_ranges.second.random_write_ms;
+    util::Log() << "runs of 16 read: elements " << result_ranges.first.random_read_ms
+                << " ms, decode_range " << result_ranges.second.random_read_ms << " ms. "
+                << result_ranges.first.random_read_ms / result_ranges.second.random_read_ms;
 }
@@ -0,0 +1,137 @@
+#include "server/api/parameters_parser.hpp"
+#include "server/api/url_parser.hpp"
+
+#include "engine/api/route_parameters.hpp"
+#include "engine/api/table_parameters.hpp"
+#include "engine/hint.hpp"
+
+#include "util/log.hpp"
+#include "util/string_util.hpp"
+#include "util/timing_util.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+
+// Counts all heap allocations of the process
+namespace
+{
+std::atomic<std::size_t> allocation_count{0};
+std::atomic<std::size_t> allocated_bytes{0};
+}
+
+void *operator new(std::size_t size)
+{
+    ++allocation_count;
+    allocated_bytes += size;
+    if (auto pointer = std::malloc(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+using namespace osrm;
+
+namespace
+{
+std::string makeQuery(const std::size_t num_coordinates, const bool with_options)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lon_distribution(13.2, 13.5);
+    std::uniform_real_distribution<double> lat_distribution(52.4, 52.6);
+
+    std::string coordinates, radiuses, bearings, hints, approaches;
+    const auto hint = engine::Hint{}.ToBase64();
+    for (std::size_t i = 0; i < num_coordinates; ++i)
+    {
+        const auto separator = i == 0 ? "" : ";";
+        coordinates += separator + std::to_string(lon_distribution(generator)) + "," +
+                       std::to_string(lat_distribution(generator));
+        radiuses += separator + std::string(i % 2 ? "unlimited" : "50");
+        bearings += separator + std::string("90,20");
+        hints += separator + hint;
+        approaches += separator + std::string("curb");
+    }
+
+    auto query = coordinates;
+    if (with_options)
+    {
+        query += "?radiuses=" + radiuses + "&bearings=" + bearings + "&hints=" + hints +
+                 "&approaches=" + approaches;
+    }
+    return query;
+}
+
+// decodes and parses the URL the way the request handler does
+template <typename ParameterT> bool parseRequest(const std::string &uri)
+{
+    // the request handler reuses the decoded string of its thread as well
+    static std::string request_string;
+    util::URIDecode(uri, request_string);
+
+    auto api_iterator = request_string.begin();
+    auto parsed_url = server::api::parseURL(api_iterator, request_string.end());
+    if (!parsed_url)
+        return false;
+
+    auto query_iterator = parsed_url->query.begin();
+    const auto parameters =
+        server::api::parseParameters<ParameterT>(query_iterator, parsed_url->query.end());
+    return parameters && query_iterator == parsed_url->query.end();
+}
+
+template <typename ParameterT>
+void benchmark(const std::string &name, const std::string &service, const std::string &query)
+{
+    const auto uri = "/" + service + "/v1/driving/" + query;
+    const std::size_t num_rounds = 10000;
+
+    // the first request initializes the static grammars
+    if (!parseRequest<ParameterT>(uri))
+    {
+        util::Log(logERROR) << "Could not parse " << uri;
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto start_count = allocation_count.load();
+    const auto start_bytes = allocated_bytes.load();
+    TIMER_START(parse);
+    for (std::size_t round = 0; round < num_rounds; ++round)
+    {
+        parseRequest<ParameterT>(uri);
+    }
+    TIMER_STOP(parse);
+
+    std::cout << std::setw(32) << std::left << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << TIMER_USEC(parse) / double(num_rounds)
+              << " us/request " << std::setw(10)
+              << (allocation_count - start_count) / double(num_rounds) << " allocations "
+              << std::setw(12) << (allocated_bytes - start_bytes) / double(num_rounds)
+              << " bytes" << std::endl;
+}
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    benchmark<engine::api::RouteParameters>("route 2 coordinates", "route", makeQuery(2, false));
+    benchmark<engine::api::RouteParameters>("route 25 coordinates", "route", makeQuery(25, false));
+    benchmark<engine::api::RouteParameters>(
+        "route 25 coordinates + options", "route", makeQuery(25, true));
+    benchmark<engine::api::RouteParameters>(
+        "route polyline", "route", "polyline(ofp_Ik_vpAilAyu@te@g`E)");
+    benchmark<engine::api::TableParameters>(
+        "table 100 coordinates", "table", makeQuery(100, false));
+    benchmark<engine::api::TableParameters>(
+        "table 100 coordinates + options", "table", makeQuery(100, true));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+#include "customizer/cell_customizer.hpp"
+#include "customizer/edge_based_graph.hpp"
+
+#include "extractor/files.hpp"
+#include "extractor/packed_osm_ids.hpp"
+
+#include "partition/cell_storage.hpp"
+#include "partition/files.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+// Number of cells, nodes and boundary nodes of every level of the partition
+void printPartitionStatistics(const partition::MultiLevelPartition &mlp,
+                              const partition::CellStorage &storage,
+                              const std::size_t number_of_nodes)
+{
+    std::cout << "level   #cells  max nodes  avg nodes  #sources  #destinations  "
+                 "max sources  max destinations\n";
+    for (const auto level : util::irange<LevelID>(1, mlp.GetNumberOfLevels()))
+    {
+        const auto number_of_cells = mlp.GetNumberOfCells(level);
+
+        std::vector<std::size_t> cell_nodes(number_of_cells, 0);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+            ++cell_nodes[mlp.GetCell(level, node)];
+
+        std::size_t sources = 0, destinations = 0, max_sources = 0, max_destinations = 0;
+        for (const auto cell_id : util::irange<CellID>(0, number_of_cells))
+        {
+            const auto cell = storage.GetCell(level, cell_id);
+            const std::size_t num_sources = cell.GetSourceNodes().size();
+            const std::size_t num_destinations = cell.GetDestinationNodes().size();
+            sources += num_sources;
+            destinations += num_destinations;
+            max_sources = std::max(max_sources, num_sources);
+            max_destinations = std::max(max_destinations, num_destinations);
+        }
+
+        std::cout << std::setw(5) << static_cast<int>(level) << std::setw(9) << number_of_cells
+                  << std::setw(11) << *std::max_element(cell_nodes.begin(), cell_nodes.end())
+                  << std::setw(11) << number_of_nodes / number_of_cells << std::setw(10)
+                  << sources << std::setw(15) << destinations << std::setw(13) << max_sources
+                  << std::setw(18) << max_destinations << "\n";
+    }
+}
+
+// Customizes all cells of the default metric level by level and reports the time of each
+void benchmarkCustomization(const partition::MultiLevelPartition &mlp,
+                            const customizer::MultiLevelEdgeBasedGraph &graph,
+                            partition::CellStorage &storage)
+{
+    customizer::CellCustomizer customizer(mlp);
+    customizer::CellCustomizer::Heap heap_exemplar(graph.GetNumberOfNodes());
+    customizer::CellCustomizer::HeapPtr heaps(heap_exemplar);
+
+    double total_seconds = 0;
+    for (const auto level : util::irange<LevelID>(1, mlp.GetNumberOfLevels()))
+    {
+        TIMER_START(level_customize);
+        tbb::parallel_for(tbb::blocked_range<CellID>(0, mlp.GetNumberOfCells(level)),
+                          [&](const tbb::blocked_range<CellID> &range) {
+                              auto &heap = heaps.local();
+                              for (auto id = range.begin(); id != range.end(); ++id)
+                                  customizer.Customize(graph, heap, storage, level, id);
+                          });
+        TIMER_STOP(level_customize);
+        total_seconds += TIMER_SEC(level_customize);
+        std::cout << "Customization of level " << static_cast<int>(level) << " took "
+                  << TIMER_MSEC(level_customize) << "ms\n";
+    }
+    std::cout << "Customization took " << total_seconds << " seconds\n";
+}
+
+// Routes between random pairs of node coordinates and reports the latency distribution
+void benchmarkQueries(const std::string &base_path,
+                      const std::vector<util::Coordinate> &coordinates,
+                      const std::size_t number_of_queries)
+{
+    EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = EngineConfig::Algorithm::MLD;
+    OSRM osrm{config};
+
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> distribution(0, coordinates.size() - 1);
+
+    RouteParameters params;
+    params.overview = RouteParameters::OverviewType::False;
+    params.steps = false;
+    params.coordinates.resize(2);
+
+    std::vector<double> latencies;
+    latencies.reserve(number_of_queries);
+    std::size_t failed = 0;
+    for (const auto query : util::irange<std::size_t>(0, number_of_queries))
+    {
+        (void)query;
+        params.coordinates[0] = coordinates[distribution(generator)];
+        params.coordinates[1] = coordinates[distribution(generator)];
+
+        json::Object result;
+        const auto start = std::chrono::steady_clock::now();
+        const auto rc = osrm.Route(params, result);
+        const auto stop = std::chrono::steady_clock::now();
+
+        failed += rc != Status::Ok;
+        latencies.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](const double p) {
+        return latencies[std::min<std::size_t>(latencies.size() - 1, p * latencies.size())];
+    };
+    const auto total = std::accumulate(latencies.begin(), latencies.end(), 0.);
+    std::cout << number_of_queries << " MLD queries (" << failed << " without route): "
+              << total / latencies.size() << "ms/query, median " << percentile(0.5) << "ms, 99% "
+              << percentile(0.99) << "ms, max " << latencies.back() << "ms\n";
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [number of queries]\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    const std::string base_path = argv[1];
+    const std::size_t number_of_queries = argc > 2 ? std::stoul(argv[2]) : 1000;
+
+    partition::MultiLevelPartition mlp;
+    partition::files::readPartition(base_path + ".partition", mlp);
+
+    partition::CellStorage storage;
+    partition::files::readCells(base_path + ".cells", storage);
+
+    customizer::MultiLevelEdgeBasedGraph graph;
+    partition::files::readGraph(base_path + ".mldgr", graph);
+
+    benchmarks::printPartitionStatistics(mlp, storage, graph.GetNumberOfNodes());
+    benchmarks::benchmarkCustomization(mlp, graph, storage);
+
+    std::vector<util::Coordinate> coordinates;
+    {
+        extractor::PackedOSMIDs osm_node_ids;
+        extractor::files::readNodes(base_path + ".nbg_nodes", coordinates, osm_node_ids);
+    }
+    benchmarks::benchmarkQueries(base_path, coordinates, number_of_queries);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,183 @@
+#include "util/query_heap.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+// Searches run on a grid of GRID_SIZE x GRID_SIZE nodes from random sources, as small searches
+// in a large graph they touch only a few of the node ids like the searches of the engine
+const constexpr unsigned GRID_SIZE = 2000;
+const constexpr std::size_t NUM_SOURCES = 50;
+
+#ifdef _WIN32
+#pragma optimize("", off)
+template <class T> void dont_optimize_away(T &&datum) { T local = datum; }
+#pragma optimize("", on)
+#else
+template <class T> void dont_optimize_away(T &&datum) { asm volatile("" : "+r"(datum)); }
+#endif
+
+struct HeapData
+{
+    NodeID parent;
+};
+
+// Weight of the edge between two neighbouring grid nodes, mixed from their ids
+EdgeWeight gridWeight(const NodeID from, const NodeID to)
+{
+    auto hash = static_cast<std::uint32_t>(from) * 2654435761u ^ static_cast<std::uint32_t>(to);
+    hash ^= hash >> 15;
+    return 1 + hash % 100;
+}
+
+// Dijkstra from the source that stops after settling settle_limit nodes, on a cleared heap
+template <typename HeapT>
+EdgeWeight search(HeapT &heap, const NodeID source, const std::size_t settle_limit)
+{
+    heap.Insert(source, 0, {source});
+
+    EdgeWeight weight = 0;
+    for (std::size_t settled = 0; settled < settle_limit && !heap.Empty(); ++settled)
+    {
+        weight = heap.MinKey();
+        const auto node = heap.DeleteMin();
+        const auto x = node % GRID_SIZE;
+        const auto y = node / GRID_SIZE;
+
+        const auto relax = [&](const NodeID target) {
+            const auto target_weight = weight + gridWeight(node, target);
+            if (!heap.WasInserted(target))
+            {
+                heap.Insert(target, target_weight, {node});
+            }
+            else if (target_weight < heap.GetKey(target))
+            {
+                heap.GetData(target).parent = node;
+                heap.DecreaseKey(target, target_weight);
+            }
+        };
+        if (x > 0)
+            relax(node - 1);
+        if (x + 1 < GRID_SIZE)
+            relax(node + 1);
+        if (y > 0)
+            relax(node - GRID_SIZE);
+        if (y + 1 < GRID_SIZE)
+            relax(node + GRID_SIZE);
+    }
+    return weight;
+}
+
+std::vector<NodeID> randomSources()
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<NodeID> distribution(0, GRID_SIZE * GRID_SIZE - 1);
+    std::vector<NodeID> sources(NUM_SOURCES);
+    for (auto &source : sources)
+        source = distribution(generator);
+    return sources;
+}
+
+template <typename HeapT, typename ClearT>
+void benchmark(const std::string &name,
+               HeapT &heap,
+               const ClearT &clear,
+               const std::size_t settle_limit)
+{
+    const auto sources = randomSources();
+
+    TIMER_START(search);
+    for (const auto source : sources)
+    {
+        clear();
+        dont_optimize_away(search(heap, source, settle_limit));
+    }
+    TIMER_STOP(search);
+
+    std::cout << std::setw(48) << std::left << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10)
+              << TIMER_USEC(search) / double(sources.size() * settle_limit) * 1000.
+              << " ns/settled node" << std::endl;
+}
+
+template <typename StorageT> void benchmarkStorage(const std::string &name)
+{
+    using Heap = util::QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, StorageT>;
+    Heap heap(GRID_SIZE * GRID_SIZE);
+    const auto clear = [&heap] { heap.Clear(); };
+
+    for (const std::size_t settle_limit : {1000, 10000, 100000})
+    {
+        benchmark(name + " " + std::to_string(settle_limit) + " nodes", heap, clear, settle_limit);
+    }
+}
+
+// The d-ary heap against the radix heap, both with the generation array
+template <typename HeapT> void benchmarkHeap(const std::string &name)
+{
+    using Heap = util::QueryHeap<NodeID,
+                                 NodeID,
+                                 EdgeWeight,
+                                 HeapData,
+                                 util::GenerationArrayStorage<NodeID, NodeID>,
+                                 HeapT>;
+    Heap heap(GRID_SIZE * GRID_SIZE);
+    const auto clear = [&heap] { heap.Clear(); };
+
+    for (const std::size_t settle_limit : {1000, 10000, 100000, 1000000})
+    {
+        benchmark(name + " " + std::to_string(settle_limit) + " nodes", heap, clear, settle_limit);
+    }
+}
+
+// The storage chosen at runtime, with the dispatch per lookup and resolved once per search
+template <util::IndexStorageType TYPE> void benchmarkSelectable(const std::string &name)
+{
+    using Heap = util::QueryHeap<NodeID,
+                                 NodeID,
+                                 EdgeWeight,
+                                 HeapData,
+                                 util::SelectableStorage<NodeID, NodeID>>;
+    Heap heap(GRID_SIZE * GRID_SIZE, TYPE);
+    auto view = heap.template View<TYPE>();
+    const auto clear = [&heap] { heap.Clear(); };
+
+    for (const std::size_t settle_limit : {1000, 10000, 100000})
+    {
+        const auto suffix = " " + std::to_string(settle_limit) + " nodes";
+        benchmark("selectable " + name + suffix, heap, clear, settle_limit);
+        benchmark("selectable " + name + " view" + suffix, view, clear, settle_limit);
+    }
+}
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    benchmarkStorage<util::ArrayStorage<NodeID, NodeID>>("array");
+    benchmarkStorage<util::GenerationArrayStorage<NodeID, NodeID>>("generation array");
+    benchmarkStorage<util::TwoLevelStorage<NodeID, NodeID>>("two level array");
+    benchmarkStorage<util::UnorderedMapStorage<NodeID, NodeID>>("unordered map");
+    benchmarkStorage<util::MapStorage<NodeID, NodeID>>("map");
+
+    benchmarkSelectable<util::IndexStorageType::GenerationArray>("generation array");
+    benchmarkSelectable<util::IndexStorageType::TwoLevelArray>("two level array");
+    benchmarkSelectable<util::IndexStorageType::UnorderedMap>("unordered map");
+
+    benchmarkHeap<util::DAryHeap<EdgeWeight, NodeID>>("d-ary heap");
+    benchmarkHeap<util::RadixHeap<EdgeWeight, NodeID>>("radix heap");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+const constexpr double EARTH_RADIUS = 6372797.560856;
+const constexpr double PI = 3.14159265358979323846;
+const constexpr std::size_t NUMBER_OF_BEARINGS = 16;
+const constexpr std::size_t NUMBER_OF_RINGS = 6;
+
+// Destinations around the center in all directions, at the radius in meters
+std::vector<util::Coordinate>
+ringCoordinates(const double center_lon, const double center_lat, const double radius)
+{
+    std::vector<util::Coordinate> coordinates;
+    const auto angle = radius / EARTH_RADIUS * 180. / PI;
+    for (std::size_t index = 0; index < NUMBER_OF_BEARINGS; ++index)
+    {
+        const auto bearing = 2. * PI * index / NUMBER_OF_BEARINGS;
+        const auto lat = center_lat + angle * std::cos(bearing);
+        const auto lon =
+            center_lon + angle * std::sin(bearing) / std::cos(center_lat * PI / 180.);
+        coordinates.push_back({util::FloatLongitude{lon}, util::FloatLatitude{lat}});
+    }
+    return coordinates;
+}
+
+// Milliseconds to route from the center to all destinations, counts the routes found
+double routeToAll(const OSRM &osrm,
+                  const util::Coordinate center,
+                  const std::vector<util::Coordinate> &destinations,
+                  std::size_t &routes)
+{
+    RouteParameters params;
+    params.overview = RouteParameters::OverviewType::False;
+    params.steps = false;
+    params.coordinates = {center, center};
+
+    routes = 0;
+    TIMER_START(route);
+    for (const auto &destination : destinations)
+    {
+        params.coordinates.back() = destination;
+        json::Object result;
+        if (osrm.Route(params, result) == Status::Ok)
+        {
+            routes++;
+        }
+    }
+    TIMER_STOP(route);
+    return TIMER_MSEC(route);
+}
+}
+
+// Times routes of increasing length with and without the cache of unpacked shortcuts
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " data.osrm [CH|MLD] [<center lon> <center lat> <first radius in m>]\n";
+        return EXIT_FAILURE;
+    }
+
+    util::LogPolicy::GetInstance().Unmute();
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && boost::to_lower_copy(std::string(argv[2])) == "mld")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+
+    // defaults to Monaco
+    const auto center_lon = argc > 5 ? std::stod(argv[3]) : 7.419758;
+    const auto center_lat = argc > 5 ? std::stod(argv[4]) : 43.731142;
+    const auto first_radius = argc > 5 ? std::stod(argv[5]) : 250.;
+    const util::Coordinate center{util::FloatLongitude{center_lon},
+                                  util::FloatLatitude{center_lat}};
+
+    const OSRM uncached_osrm{config};
+    config.shortcut_cache_size = 1000000;
+    const OSRM cached_osrm{config};
+
+    auto radius = first_radius;
+    for (std::size_t ring = 0; ring < NUMBER_OF_RINGS; ++ring, radius *= 2)
+    {
+        const auto destinations = ringCoordinates(center_lon, center_lat, radius);
+
+        std::size_t routes = 0;
+        const auto uncached = routeToAll(uncached_osrm, center, destinations, routes);
+        const auto cold = routeToAll(cached_osrm, center, destinations, routes);
+        const auto warm = routeToAll(cached_osrm, center, destinations, routes);
+
+        util::Log() << radius << " m: " << routes << " routes, uncached " << uncached
+                    << " ms, cold cache " << cold << " ms, warm cache " << warm << " ms";
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,195 @@
+#include "util/json_renderer.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/route_parameters.hpp"
+#include "osrm/status.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+const constexpr std::size_t NUM_ROUTES = 500;
+const constexpr std::size_t NUM_TABLE_COORDINATES = 100;
+
+// Fixed random coordinates in Monaco, the dataset of test/data
+std::vector<util::Coordinate> randomCoordinates(const std::size_t count)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lon_distribution(7.413, 7.436);
+    std::uniform_real_distribution<double> lat_distribution(43.727, 43.749);
+
+    std::vector<util::Coordinate> coordinates;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const auto lon = lon_distribution(generator);
+        const auto lat = lat_distribution(generator);
+        coordinates.push_back({util::FloatLongitude{lon}, util::FloatLatitude{lat}});
+    }
+    return coordinates;
+}
+
+void report(const std::string &name, const double usec, const std::size_t count)
+{
+    std::cout << std::setw(48) << std::left << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << usec / count << " us/query"
+              << std::endl;
+}
+
+// Routes between pairs of the coordinates, keeps the responses for rendering them later
+std::vector<json::Object> benchmarkRoutes(const std::string &name,
+                                          const OSRM &osrm,
+                                          const std::vector<util::Coordinate> &coordinates,
+                                          const bool full)
+{
+    RouteParameters params;
+    params.overview =
+        full ? RouteParameters::OverviewType::Full : RouteParameters::OverviewType::False;
+    params.steps = full;
+    params.coordinates.resize(2);
+
+    std::vector<json::Object> responses;
+    responses.reserve(coordinates.size() / 2);
+    std::size_t routes = 0;
+    TIMER_START(route);
+    for (std::size_t index = 0; index + 1 < coordinates.size(); index += 2)
+    {
+        params.coordinates[0] = coordinates[index];
+        params.coordinates[1] = coordinates[index + 1];
+        responses.emplace_back();
+        if (osrm.Route(params, responses.back()) == Status::Ok)
+            routes++;
+    }
+    TIMER_STOP(route);
+
+    report(name + " (" + std::to_string(routes) + " found)", TIMER_USEC(route), responses.size());
+    return responses;
+}
+
+// Tables between the first size coordinates, repeated to run about as long for all sizes
+json::Object benchmarkTable(const std::string &name,
+                            const OSRM &osrm,
+                            const std::vector<util::Coordinate> &coordinates,
+                            const std::size_t size)
+{
+    TableParameters params;
+    params.coordinates.assign(coordinates.begin(), coordinates.begin() + size);
+
+    const std::size_t rounds = std::max<std::size_t>(1, 20000 / (size * size));
+    json::Object response;
+    TIMER_START(table);
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        response = json::Object();
+        if (osrm.Table(params, response) != Status::Ok)
+        {
+            util::Log(logWARNING) << "Table of " << size << " coordinates failed";
+        }
+    }
+    TIMER_STOP(table);
+
+    report(name + " " + std::to_string(size) + "x" + std::to_string(size),
+           TIMER_USEC(table),
+           rounds);
+    return response;
+}
+
+void benchmarkRendering(const std::string &name, const std::vector<json::Object> &responses)
+{
+    const std::size_t rounds = 10;
+    std::size_t bytes = 0;
+    std::vector<char> buffer;
+    TIMER_START(render);
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        for (const auto &response : responses)
+        {
+            buffer.clear();
+            util::json::render(buffer, response);
+            bytes += buffer.size();
+        }
+    }
+    TIMER_STOP(render);
+
+    report(name + " (" + std::to_string(bytes / (rounds * responses.size())) + " bytes)",
+           TIMER_USEC(render),
+           rounds * responses.size());
+}
+
+const std::vector<std::pair<std::string, EngineConfig::HeapStorage>> HEAP_STORAGES = {
+    {"unordered map", EngineConfig::HeapStorage::UnorderedMap},
+    {"generation array", EngineConfig::HeapStorage::GenerationArray},
+    {"two level array", EngineConfig::HeapStorage::TwoLevelArray}};
+}
+
+// Times the point-to-point and many-to-many searches, path unpacking and the rendering of the
+// responses on a fixed set of queries, for the configured algorithm and all heap storages
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [CH|MLD]\n";
+        return EXIT_FAILURE;
+    }
+
+    util::LogPolicy::GetInstance().Unmute();
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && boost::to_lower_copy(std::string(argv[2])) == "mld")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+
+    const auto coordinates = randomCoordinates(2 * NUM_ROUTES);
+
+    const OSRM osrm{config};
+    // without an overview and steps a route is mostly the search and the unpacking of its path
+    benchmarkRoutes("route", osrm, coordinates, false);
+    const auto full_routes =
+        benchmarkRoutes("route with overview and steps", osrm, coordinates, true);
+    std::vector<json::Object> tables;
+    for (const auto size : std::vector<std::size_t>{2, 10, 25, NUM_TABLE_COORDINATES})
+    {
+        tables.push_back(benchmarkTable("table", osrm, coordinates, size));
+    }
+
+    for (const auto &storage : HEAP_STORAGES)
+    {
+        config.query_heap_storage = storage.second;
+        config.many_to_many_heap_storage = storage.second;
+        const OSRM heap_osrm{config};
+        benchmarkRoutes("route, " + storage.first, heap_osrm, coordinates, false);
+        benchmarkTable("table, " + storage.first, heap_osrm, coordinates, NUM_TABLE_COORDINATES);
+    }
+
+    benchmarkRendering("render route", full_routes);
+    benchmarkRendering("render table " + std::to_string(NUM_TABLE_COORDINATES) + "x" +
+                           std::to_string(NUM_TABLE_COORDINATES),
+                       {tables.back()});
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
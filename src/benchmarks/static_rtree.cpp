@@ -5,9 +5,13 @@
 #include "storage/io.hpp"
 #include "engine/geospatial_query.hpp"
 #include "util/coordinate.hpp"
+#include "util/packed_rectangles.hpp"
+#include "util/rectangle.hpp"
 #include "util/serialization.hpp"
 #include "util/timing_util.hpp"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <random>
 
@@ -62,6 +66,52 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
               << ")" << std::endl;
 }
 
+// Compares computing the distances to the children of a branch node one rectangle at a time with
+// the packed kernels used by StaticRTree::ExploreTreeNode.
+void benchmarkChildDistances(const std::vector<util::Coordinate> &queries)
+{
+    constexpr std::size_t BRANCHING_FACTOR = 64;
+    constexpr std::size_t NUMBER_OF_NODES = 1024;
+
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<util::RectangleInt2D> rectangles;
+    for (std::size_t i = 0; i < BRANCHING_FACTOR * NUMBER_OF_NODES; i++)
+    {
+        const auto lon_1 = lon_udist(mt_rand), lon_2 = lon_udist(mt_rand);
+        const auto lat_1 = lat_udist(mt_rand), lat_2 = lat_udist(mt_rand);
+        rectangles.push_back(util::RectangleInt2D{util::FixedLongitude{std::min(lon_1, lon_2)},
+                                                  util::FixedLongitude{std::max(lon_1, lon_2)},
+                                                  util::FixedLatitude{std::min(lat_1, lat_2)},
+                                                  util::FixedLatitude{std::max(lat_1, lat_2)}});
+    }
+    const util::PackedRectangles packed_rectangles(
+        rectangles.begin(), rectangles.end(), [](const util::RectangleInt2D &rectangle) {
+            return rectangle;
+        });
+
+    std::array<std::uint64_t, BRANCHING_FACTOR> distances;
+    std::uint64_t checksum = 0;
+    std::size_t node = 0;
+    benchmarkQuery(
+        queries, "child distances (one rectangle at a time)", [&](const util::Coordinate &q) {
+            const auto first = BRANCHING_FACTOR * (node++ % NUMBER_OF_NODES);
+            for (std::size_t i = 0; i < BRANCHING_FACTOR; ++i)
+                distances[i] = rectangles[first + i].GetMinSquaredDist(q);
+            checksum += *std::min_element(distances.begin(), distances.end());
+            return checksum;
+        });
+    node = 0;
+    benchmarkQuery(queries, "child distances (packed rectangles)", [&](const util::Coordinate &q) {
+        const auto first = BRANCHING_FACTOR * (node++ % NUMBER_OF_NODES);
+        packed_rectangles.GetMinSquaredDists(first, BRANCHING_FACTOR, q, distances.data());
+        checksum += *std::min_element(distances.begin(), distances.end());
+        return checksum;
+    });
+    std::cout << "Checksum " << checksum << std::endl;
+}
+
 void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
 {
     std::mt19937 mt_rand(RANDOM_SEED);
@@ -80,6 +130,25 @@ void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
     benchmarkQuery(queries, "raw RTree queries (10 results)", [&rtree](const util::Coordinate &q) {
         return rtree.Nearest(q, 10);
     });
+
+    std::cout << "Running batched RTree queries (10 results) with " << queries.size()
+              << " coordinates: " << std::flush;
+    TIMER_START(batch);
+    auto results = rtree.Nearest(
+        queries,
+        [](const std::size_t, const BenchStaticRTree::CandidateSegment &) {
+            return std::make_pair(true, true);
+        },
+        [](const std::size_t,
+           const std::size_t num_results,
+           const BenchStaticRTree::CandidateSegment &) { return num_results >= 10; });
+    (void)results;
+    TIMER_STOP(batch);
+    std::cout << "Took " << TIMER_SEC(batch) << " seconds "
+              << "(" << TIMER_MSEC(batch) << "ms"
+              << ")  ->  " << TIMER_MSEC(batch) / queries.size() << " ms/query" << std::endl;
+
+    benchmarkChildDistances(queries);
 }
 }
 }
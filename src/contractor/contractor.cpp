@@ -1,13 +1,20 @@
 #include "contractor/contractor.hpp"
+#include "contractor/compressed_search_graph.hpp"
 #include "contractor/crc32_processor.hpp"
 #include "contractor/files.hpp"
 #include "contractor/graph_contractor.hpp"
 #include "contractor/graph_contractor_adaptors.hpp"
+#include "contractor/hub_labels.hpp"
+#include "contractor/partitioned_contraction.hpp"
+#include "contractor/renumber.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/node_based_edge.hpp"
 
+#include "partition/files.hpp"
+#include "partition/multi_level_partition.hpp"
+
 #include "storage/io.hpp"
 
 #include "updater/updater.hpp"
@@ -16,12 +23,17 @@
 #include "util/exception_utils.hpp"
 #include "util/graph_loader.hpp"
 #include "util/integer_range.hpp"
+#include "util/landmarks.hpp"
 #include "util/log.hpp"
+#include "util/perf_report.hpp"
+#include "util/permutation.hpp"
 #include "util/static_graph.hpp"
 #include "util/string_util.hpp"
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <algorithm>
 #include <bitset>
 #include <cstdint>
@@ -34,6 +46,42 @@ namespace osrm
 {
 namespace contractor
 {
+namespace
+{
+// Encodes the .hsgr that was just written, reading it back covers the partitioned contraction
+// that never holds the whole hierarchy in memory
+void writeCompressedSearchGraph(const ContractorConfig &config)
+{
+    TIMER_START(compress);
+    util::PerfStage compress_stage("compress");
+    unsigned checksum;
+    QueryGraph graph;
+    files::readGraph(config.graph_output_path, checksum, graph);
+    const CompressedSearchGraph compressed{graph};
+    files::writeCompressedSearchGraph(config.compressed_graph_output_path, checksum, compressed);
+    compress_stage.Stop();
+    TIMER_STOP(compress);
+    util::Log() << "Compressed the " << graph.GetNumberOfEdges() << " edges of the hierarchy to "
+                << compressed.GetEncodedSize() << " bytes in " << TIMER_SEC(compress)
+                << " seconds";
+}
+
+// Labels the .hsgr that was just written, like its compressed copy
+void writeHubLabels(const ContractorConfig &config)
+{
+    TIMER_START(labels);
+    util::PerfStage labels_stage("hub labels");
+    unsigned checksum;
+    QueryGraph graph;
+    files::readGraph(config.graph_output_path, checksum, graph);
+    const HubLabels labels{graph};
+    files::writeHubLabels(config.hub_labels_output_path, checksum, labels);
+    labels_stage.Stop();
+    TIMER_STOP(labels);
+    util::Log() << "Computed " << labels.GetNumberOfEntries() << " hub label entries for "
+                << labels.GetNumberOfNodes() << " nodes in " << TIMER_SEC(labels) << " seconds";
+}
+}
 
 int Contractor::Run()
 {
@@ -42,8 +90,26 @@ int Contractor::Run()
         throw util::exception("Core factor must be between 0.0 to 1.0 (inclusive)" + SOURCE_REF);
     }
 
+    if (config.hub_labels && config.core_factor < 1.0)
+    {
+        throw util::exception("Hub labels need a hierarchy of all nodes, they can't be combined "
+                              "with a core" +
+                              SOURCE_REF);
+    }
+
+    if (config.partitioned && (config.core_factor < 1.0 || config.metric_update ||
+                               config.use_cached_priority || config.renumber_nodes ||
+                               config.landmarks > 0))
+    {
+        throw util::exception("Partitioned contraction contracts all nodes in its own order, it "
+                              "can't be combined with a core, the level cache, metric updates, "
+                              "renumbering or landmarks" +
+                              SOURCE_REF);
+    }
+
     TIMER_START(preparing);
 
+    util::PerfStage loading_stage("loading");
     util::Log() << "Reading node weights.";
     std::vector<EdgeWeight> node_weights;
     {
@@ -59,10 +125,88 @@ int Contractor::Run()
 
     updater::Updater updater(config.updater_config);
     EdgeID max_edge_id = updater.LoadAndUpdateEdgeExpandedGraph(edge_based_edge_list, node_weights);
+    loading_stage.Stop();
+
+    // landmarks of older weights might overestimate and give wrong routes
+    if (boost::filesystem::exists(config.landmarks_path))
+    {
+        boost::filesystem::remove(config.landmarks_path);
+    }
+    // stale copies and labels would be ignored for their checksum, do not leave them around
+    if (boost::filesystem::exists(config.compressed_graph_output_path))
+    {
+        boost::filesystem::remove(config.compressed_graph_output_path);
+    }
+    if (boost::filesystem::exists(config.hub_labels_output_path))
+    {
+        boost::filesystem::remove(config.hub_labels_output_path);
+    }
+
+    // the landmarks are selected on the whole graph before it is handed to the contraction
+    util::Landmarks landmarks;
+    if (config.landmarks > 0)
+    {
+        TIMER_START(landmarks);
+        util::PerfStage landmarks_stage("landmarks");
+        std::vector<util::LandmarkArc> arcs;
+        arcs.reserve(edge_based_edge_list.size());
+        for (const auto &edge : edge_based_edge_list)
+        {
+            if (edge.data.forward)
+                arcs.push_back({edge.source, edge.target, edge.data.weight});
+            if (edge.data.backward)
+                arcs.push_back({edge.target, edge.source, edge.data.weight});
+        }
+        landmarks = util::buildLandmarks(max_edge_id + 1, arcs, config.landmarks);
+        landmarks_stage.Stop();
+        TIMER_STOP(landmarks);
+        util::Log() << "Selecting " << landmarks.GetNumberOfLandmarks() << " landmarks took "
+                    << TIMER_SEC(landmarks) << " seconds";
+    }
 
     // Contracting the edge-expanded graph
 
+    if (config.partitioned)
+    {
+        partition::MultiLevelPartition partition;
+        partition::files::readPartition(config.partition_path, partition);
+        if (partition.GetNumberOfLevels() < 2)
+        {
+            throw util::exception("Partition " + config.partition_path + " has no cells" +
+                                  SOURCE_REF);
+        }
+
+        TIMER_START(contraction);
+        util::PerfStage contraction_stage("contraction");
+        auto node_levels = contractPartitioned(config,
+                                               partition,
+                                               max_edge_id + 1,
+                                               std::move(edge_based_edge_list),
+                                               std::move(node_weights));
+        contraction_stage.Stop();
+        TIMER_STOP(contraction);
+        util::Log() << "Contraction took " << TIMER_SEC(contraction) << " sec";
+
+        // all nodes are contracted
+        files::writeCoreMarker(config.core_output_path, std::vector<bool>{});
+        files::writeLevels(config.level_output_path, node_levels);
+        if (config.compress_search_graph)
+        {
+            writeCompressedSearchGraph(config);
+        }
+        if (config.hub_labels)
+        {
+            writeHubLabels(config);
+        }
+
+        TIMER_STOP(preparing);
+        util::Log() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
+        util::Log() << "finished preprocessing";
+        return 0;
+    }
+
     TIMER_START(contraction);
+    util::PerfStage contraction_stage("contraction");
     std::vector<bool> is_core_node;
     std::vector<float> node_levels;
     if (config.use_cached_priority)
@@ -70,22 +214,75 @@ int Contractor::Run()
         files::readLevels(config.level_output_path, node_levels);
     }
 
+    // the hierarchy that is about to be replaced provides the order and shortcuts to reuse
+    QueryGraph previous_hierarchy;
+    bool use_previous_hierarchy = false;
+    if (config.metric_update)
+    {
+        if (boost::filesystem::exists(config.level_output_path) &&
+            boost::filesystem::exists(config.graph_output_path))
+        {
+            std::vector<float> previous_levels;
+            unsigned previous_checksum;
+            files::readLevels(config.level_output_path, previous_levels);
+            files::readGraph(config.graph_output_path, previous_checksum, previous_hierarchy);
+            use_previous_hierarchy = previous_levels.size() == max_edge_id + 1 &&
+                                     previous_hierarchy.GetNumberOfNodes() == max_edge_id + 1;
+            if (use_previous_hierarchy)
+                node_levels = std::move(previous_levels);
+        }
+
+        if (!use_previous_hierarchy)
+            util::Log(logWARNING) << "No hierarchy of this graph to update, contracting all nodes";
+    }
+    const bool use_cached_levels = !node_levels.empty();
+
     util::DeallocatingVector<QueryEdge> contracted_edge_list;
     { // own scope to not keep the contractor around
         GraphContractor graph_contractor(max_edge_id + 1,
                                          adaptToContractorInput(std::move(edge_based_edge_list)),
                                          std::move(node_levels),
-                                         std::move(node_weights));
-        graph_contractor.Run(config.core_factor);
+                                         std::move(node_weights),
+                                         config.witness_search);
+        if (use_previous_hierarchy)
+        {
+            graph_contractor.UsePreviousShortcuts(previous_hierarchy);
+            previous_hierarchy = QueryGraph{};
+        }
+        graph_contractor.Run(config.core_factor, config.debug_timings);
 
         contracted_edge_list = graph_contractor.GetEdges<QueryEdge>();
         is_core_node = graph_contractor.GetCoreMarker();
         node_levels = graph_contractor.GetNodeLevels();
     }
+    contraction_stage.Stop();
     TIMER_STOP(contraction);
 
     util::Log() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
+    if (config.renumber_nodes)
+    {
+        TIMER_START(renumber);
+        util::PerfStage renumber_stage("renumber");
+        const auto permutation = makePermutation(node_levels, contracted_edge_list);
+        renumber(contracted_edge_list, permutation);
+        util::inplacePermutation(node_levels.begin(), node_levels.end(), permutation);
+        if (!is_core_node.empty())
+        {
+            std::vector<bool> renumbered_core_nodes(is_core_node.size());
+            for (const auto node : util::irange<NodeID>(0, is_core_node.size()))
+                renumbered_core_nodes[permutation[node]] = is_core_node[node];
+            is_core_node = std::move(renumbered_core_nodes);
+        }
+        renumberDataset(config, permutation);
+        if (landmarks.GetNumberOfLandmarks() > 0)
+            landmarks.Renumber(permutation);
+        renumber_stage.Stop();
+        TIMER_STOP(renumber);
+        util::Log() << "Renumbered data in " << TIMER_SEC(renumber) << " seconds";
+    }
+
+    util::PerfStage writing_stage("writing");
     {
         RangebasedCRC32 crc32_calculator;
         const unsigned checksum = crc32_calculator(contracted_edge_list);
@@ -96,10 +293,23 @@ int Contractor::Run()
     }
 
     files::writeCoreMarker(config.core_output_path, is_core_node);
-    if (!config.use_cached_priority)
+    if (!use_cached_levels || config.renumber_nodes)
     {
         files::writeLevels(config.level_output_path, node_levels);
     }
+    if (landmarks.GetNumberOfLandmarks() > 0)
+    {
+        files::writeLandmarks(config.landmarks_path, landmarks);
+    }
+    writing_stage.Stop();
+    if (config.compress_search_graph)
+    {
+        writeCompressedSearchGraph(config);
+    }
+    if (config.hub_labels)
+    {
+        writeHubLabels(config);
+    }
 
     TIMER_STOP(preparing);
 
@@ -5,7 +5,12 @@ namespace osrm
 namespace contractor
 {
 
-ContractorDijkstra::ContractorDijkstra(const std::size_t heap_size) : heap(heap_size) {}
+ContractorDijkstra::ContractorDijkstra(const std::size_t heap_size,
+                                       const WitnessHeapStorage storage,
+                                       const unsigned hop_limit)
+    : heap(heap_size, storage), hop_limit(hop_limit)
+{
+}
 
 void ContractorDijkstra::Run(const unsigned number_of_targets,
                              const int node_limit,
@@ -48,6 +53,10 @@ void ContractorDijkstra::RelaxNode(const NodeID node,
                                    const ContractorGraph &graph)
 {
     const short current_hop = heap.GetData(node).hop + 1;
+    if (hop_limit > 0 && static_cast<unsigned>(current_hop) > hop_limit)
+    {
+        return;
+    }
     for (auto edge : graph.GetAdjacentEdgeRange(node))
     {
         const ContractorEdgeData &data = graph.GetEdgeData(edge);
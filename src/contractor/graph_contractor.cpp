@@ -1,5 +1,8 @@
 #include "contractor/graph_contractor.hpp"
 
+#include <numeric>
+#include <tuple>
+
 namespace osrm
 {
 namespace contractor
@@ -13,8 +16,10 @@ GraphContractor::GraphContractor(int nodes, std::vector<ContractorEdge> input_ed
 GraphContractor::GraphContractor(int nodes,
                                  std::vector<ContractorEdge> edges,
                                  std::vector<float> node_levels_,
-                                 std::vector<EdgeWeight> node_weights_)
-    : node_levels(std::move(node_levels_)), node_weights(std::move(node_weights_))
+                                 std::vector<EdgeWeight> node_weights_,
+                                 WitnessSearchParameters witness_search_)
+    : node_levels(std::move(node_levels_)), node_weights(std::move(node_weights_)),
+      witness_search(std::move(witness_search_))
 {
     tbb::parallel_sort(edges.begin(), edges.end());
     NodeID edge = 0;
@@ -40,9 +45,21 @@ GraphContractor::GraphContractor(int nodes,
         forward_edge.data.originalEdges = reverse_edge.data.originalEdges = 1;
         forward_edge.data.weight = reverse_edge.data.weight = INVALID_EDGE_WEIGHT;
         forward_edge.data.duration = reverse_edge.data.duration = MAXIMAL_EDGE_DURATION;
+        // shortcuts of a partially contracted graph keep their middle node
+        ContractorEdgeData forward_shortcut, reverse_shortcut;
+        forward_shortcut.weight = reverse_shortcut.weight = INVALID_EDGE_WEIGHT;
         // remove parallel edges
         while (i < edges.size() && edges[i].source == source && edges[i].target == target)
         {
+            if (edges[i].data.shortcut)
+            {
+                if (edges[i].data.forward && edges[i].data.weight < forward_shortcut.weight)
+                    forward_shortcut = edges[i].data;
+                if (edges[i].data.backward && edges[i].data.weight < reverse_shortcut.weight)
+                    reverse_shortcut = edges[i].data;
+                ++i;
+                continue;
+            }
             if (edges[i].data.forward)
             {
                 forward_edge.data.weight = std::min(edges[i].data.weight, forward_edge.data.weight);
@@ -57,8 +74,24 @@ GraphContractor::GraphContractor(int nodes,
             }
             ++i;
         }
+        if (forward_shortcut.weight < forward_edge.data.weight)
+        {
+            forward_edge.data = forward_shortcut;
+            forward_edge.data.forward = true;
+            forward_edge.data.backward = false;
+        }
+        if (reverse_shortcut.weight < reverse_edge.data.weight)
+        {
+            reverse_edge.data = reverse_shortcut;
+            reverse_edge.data.forward = false;
+            reverse_edge.data.backward = true;
+        }
+        const bool same_shortcut = forward_edge.data.shortcut == reverse_edge.data.shortcut &&
+                                   (!forward_edge.data.shortcut ||
+                                    (forward_edge.data.id == reverse_edge.data.id &&
+                                     forward_edge.data.duration == reverse_edge.data.duration));
         // merge edges (s,t) and (t,s) into bidirectional edge
-        if (forward_edge.data.weight == reverse_edge.data.weight)
+        if (forward_edge.data.weight == reverse_edge.data.weight && same_shortcut)
         {
             if ((int)forward_edge.data.weight != INVALID_EDGE_WEIGHT)
             {
@@ -126,31 +159,25 @@ void GraphContractor::FlushDataAndRebuildContractorGraph(
         new_node_id_from_orig_id_map[node.id] = new_node_id;
         node.id = new_node_id;
     }
-    // walk over all nodes
+    // walk over all nodes, the edges of contracted nodes were released after their round
     for (const auto source : util::irange<NodeID>(0UL, contractor_graph->GetNumberOfNodes()))
     {
+        BOOST_ASSERT(SPECIAL_NODEID != new_node_id_from_orig_id_map[source] ||
+                     contractor_graph->GetOutDegree(source) == 0);
         for (auto current_edge : contractor_graph->GetAdjacentEdgeRange(source))
         {
             ContractorGraph::EdgeData &data = contractor_graph->GetEdgeData(current_edge);
             const NodeID target = contractor_graph->GetTarget(current_edge);
-            if (SPECIAL_NODEID == new_node_id_from_orig_id_map[source])
-            {
-                external_edge_list.push_back({source, target, data});
-            }
-            else
-            {
-                // node is not yet contracted.
-                // add (renumbered) outgoing edges to new util::DynamicGraph.
-                ContractorEdge new_edge = {new_node_id_from_orig_id_map[source],
-                                           new_node_id_from_orig_id_map[target],
-                                           data};
-                new_edge.data.is_original_via_node_ID = true;
-                BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[source],
-                                 "new source id not resolveable");
-                BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[target],
-                                 "new target id not resolveable");
-                new_edge_set.push_back(new_edge);
-            }
+            // add (renumbered) outgoing edges to new ContractorGraph.
+            ContractorEdge new_edge = {new_node_id_from_orig_id_map[source],
+                                       new_node_id_from_orig_id_map[target],
+                                       data};
+            new_edge.data.is_original_via_node_ID = true;
+            BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[source],
+                             "new source id not resolveable");
+            BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[target],
+                             "new target id not resolveable");
+            new_edge_set.push_back(new_edge);
         }
     }
     // Replace old priorities array by new one
@@ -168,7 +195,7 @@ void GraphContractor::FlushDataAndRebuildContractorGraph(
     thread_data_list.number_of_nodes = contractor_graph->GetNumberOfNodes();
 }
 
-void GraphContractor::Run(double core_factor)
+void GraphContractor::Run(double core_factor, bool debug_timings)
 {
     // for the preperation we can use a big grain size, which is much faster (probably cache)
     const constexpr size_t InitGrainSize = 100000;
@@ -183,7 +210,7 @@ void GraphContractor::Run(double core_factor)
 
     const NodeID number_of_nodes = contractor_graph->GetNumberOfNodes();
 
-    ThreadDataContainer thread_data_list(number_of_nodes);
+    ThreadDataContainer thread_data_list(number_of_nodes, witness_search);
 
     NodeID number_of_contracted_nodes = 0;
     std::vector<NodeDepth> node_depth;
@@ -230,6 +257,20 @@ void GraphContractor::Run(double core_factor)
     }
     BOOST_ASSERT(node_priorities.size() == number_of_nodes);
 
+    // kept nodes never block the contraction of their neighbours
+    std::size_t number_of_kept_nodes = 0;
+    if (!is_kept_node.empty())
+    {
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (is_kept_node[node])
+            {
+                node_priorities[node] = std::numeric_limits<float>::max();
+                ++number_of_kept_nodes;
+            }
+        }
+    }
+
     util::Log() << "preprocessing " << number_of_nodes << " nodes ...";
 
     util::UnbufferedLog log;
@@ -237,7 +278,9 @@ void GraphContractor::Run(double core_factor)
 
     unsigned current_level = 0;
     bool flushed_contractor = false;
-    while (remaining_nodes.size() > 1 &&
+    double flush_msec = 0;
+    std::vector<RoundTimings> round_timings;
+    while (remaining_nodes.size() > std::max<std::size_t>(1, number_of_kept_nodes) &&
            number_of_contracted_nodes < static_cast<NodeID>(number_of_nodes * core_factor))
     {
         if (!flushed_contractor && (number_of_contracted_nodes >
@@ -245,11 +288,15 @@ void GraphContractor::Run(double core_factor)
         {
             log << " [flush " << number_of_contracted_nodes << " nodes] ";
 
+            TIMER_START(flush);
             FlushDataAndRebuildContractorGraph(thread_data_list, remaining_nodes, node_priorities);
+            TIMER_STOP(flush);
+            flush_msec = TIMER_MSEC(flush);
 
             flushed_contractor = true;
         }
 
+        TIMER_START(independent_set);
         tbb::parallel_for(
             tbb::blocked_range<NodeID>(0, remaining_nodes.size(), IndependentGrainSize),
             [this, &node_priorities, &remaining_nodes, &thread_data_list](
@@ -260,7 +307,7 @@ void GraphContractor::Run(double core_factor)
                 {
                     const NodeID node = remaining_nodes[i].id;
                     remaining_nodes[i].is_independent =
-                        this->IsNodeIndependent(node_priorities, data, node);
+                        !this->IsKept(node) && this->IsNodeIndependent(node_priorities, data, node);
                 }
             });
 
@@ -272,14 +319,16 @@ void GraphContractor::Run(double core_factor)
         auto begin_independent_nodes_idx =
             std::distance(remaining_nodes.begin(), begin_independent_nodes);
         auto end_independent_nodes_idx = remaining_nodes.size();
+        TIMER_STOP(independent_set);
 
+        TIMER_START(contract_nodes);
         if (!use_cached_node_priorities)
         {
             // write out contraction level
             tbb::parallel_for(
                 tbb::blocked_range<NodeID>(
                     begin_independent_nodes_idx, end_independent_nodes_idx, ContractGrainSize),
-                [this, remaining_nodes, flushed_contractor, current_level](
+                [this, &remaining_nodes, flushed_contractor, current_level](
                     const tbb::blocked_range<NodeID> &range) {
                     if (flushed_contractor)
                     {
@@ -314,7 +363,9 @@ void GraphContractor::Run(double core_factor)
                     this->ContractNode<false>(data, x);
                 }
             });
+        TIMER_STOP(contract_nodes);
 
+        TIMER_START(delete_edges);
         tbb::parallel_for(
             tbb::blocked_range<NodeID>(
                 begin_independent_nodes_idx, end_independent_nodes_idx, DeleteGrainSize),
@@ -327,41 +378,14 @@ void GraphContractor::Run(double core_factor)
                 }
             });
 
-        // make sure we really sort each block
-        tbb::parallel_for(thread_data_list.data.range(),
-                          [&](const ThreadDataContainer::EnumerableThreadData::range_type &range) {
-                              for (auto &data : range)
-                                  tbb::parallel_sort(data->inserted_edges.begin(),
-                                                     data->inserted_edges.end());
-                          });
+        TIMER_STOP(delete_edges);
 
         // insert new edges
-        for (auto &data : thread_data_list.data)
-        {
-            for (const ContractorEdge &edge : data->inserted_edges)
-            {
-                const EdgeID current_edge_ID = contractor_graph->FindEdge(edge.source, edge.target);
-                if (current_edge_ID != SPECIAL_EDGEID)
-                {
-                    ContractorGraph::EdgeData &current_data =
-                        contractor_graph->GetEdgeData(current_edge_ID);
-                    if (current_data.shortcut && edge.data.forward == current_data.forward &&
-                        edge.data.backward == current_data.backward)
-                    {
-                        // found a duplicate edge with smaller weight, update it.
-                        if (edge.data.weight < current_data.weight)
-                        {
-                            current_data = edge.data;
-                        }
-                        // don't insert duplicates
-                        continue;
-                    }
-                }
-                contractor_graph->InsertEdge(edge.source, edge.target, edge.data);
-            }
-            data->inserted_edges.clear();
-        }
+        TIMER_START(insert_edges);
+        InsertShortcuts(thread_data_list);
+        TIMER_STOP(insert_edges);
 
+        TIMER_START(update_priorities);
         if (!use_cached_node_priorities)
         {
             tbb::parallel_for(
@@ -378,12 +402,27 @@ void GraphContractor::Run(double core_factor)
                     }
                 });
         }
+        TIMER_STOP(update_priorities);
+
+        // the edges of the contracted nodes are part of the hierarchy now
+        TIMER_START(release_nodes);
+        ReleaseContractedNodes(
+            remaining_nodes, begin_independent_nodes_idx, end_independent_nodes_idx);
+        TIMER_STOP(release_nodes);
 
         // remove contracted nodes from the pool
         BOOST_ASSERT(end_independent_nodes_idx - begin_independent_nodes_idx > 0);
         number_of_contracted_nodes += end_independent_nodes_idx - begin_independent_nodes_idx;
         remaining_nodes.resize(begin_independent_nodes_idx);
 
+        round_timings.push_back({end_independent_nodes_idx - begin_independent_nodes_idx,
+                                 TIMER_MSEC(independent_set),
+                                 TIMER_MSEC(contract_nodes),
+                                 TIMER_MSEC(delete_edges),
+                                 TIMER_MSEC(insert_edges),
+                                 TIMER_MSEC(update_priorities),
+                                 TIMER_MSEC(release_nodes)});
+
         p.PrintStatus(number_of_contracted_nodes);
         ++current_level;
     }
@@ -422,7 +461,10 @@ void GraphContractor::Run(double core_factor)
     }
 
     util::Log() << "[core] " << remaining_nodes.size() << " nodes "
-                << contractor_graph->GetNumberOfEdges() << " edges.";
+                << contractor_graph->GetNumberOfEdges() << " edges in "
+                << contractor_graph->GetNumberOfSlots() << " edge slots.";
+
+    LogRoundTimings(round_timings, flush_msec, debug_timings);
 
     thread_data_list.data.clear();
 }
@@ -433,6 +475,195 @@ std::vector<bool> GraphContractor::GetCoreMarker() { return std::move(is_core_no
 // Can only be called once because it invalides the node levels
 std::vector<float> GraphContractor::GetNodeLevels() { return std::move(node_levels); }
 
+void GraphContractor::KeepNodes(std::vector<bool> is_kept_node_)
+{
+    BOOST_ASSERT(is_kept_node_.size() == contractor_graph->GetNumberOfNodes());
+    is_kept_node = std::move(is_kept_node_);
+}
+
+std::vector<ContractorEdge> GraphContractor::GetKeptEdges()
+{
+    const auto original_id = [this](const NodeID id) {
+        return orig_node_id_from_new_node_id_map.empty() ? id
+                                                         : orig_node_id_from_new_node_id_map[id];
+    };
+
+    std::vector<ContractorEdge> edges;
+    std::vector<NodeID> targets;
+    for (const auto node : util::irange(0u, contractor_graph->GetNumberOfNodes()))
+    {
+        if (!IsKept(node))
+            continue;
+
+        targets.clear();
+        for (const auto edge : contractor_graph->GetAdjacentEdgeRange(node))
+        {
+            const auto target = contractor_graph->GetTarget(edge);
+            BOOST_ASSERT(IsKept(target));
+            ContractorEdge kept_edge{original_id(node), original_id(target),
+                                     contractor_graph->GetEdgeData(edge)};
+            if (kept_edge.data.shortcut && !kept_edge.data.is_original_via_node_ID)
+            {
+                kept_edge.data.id = original_id(kept_edge.data.id);
+            }
+            kept_edge.data.is_original_via_node_ID = true;
+            edges.push_back(kept_edge);
+            targets.push_back(target);
+        }
+        for (const auto target : targets)
+        {
+            contractor_graph->DeleteEdgesTo(node, target);
+        }
+    }
+    return edges;
+}
+
+void GraphContractor::UsePreviousShortcuts(const QueryGraph &hierarchy)
+{
+    const NodeID number_of_nodes = contractor_graph->GetNumberOfNodes();
+    BOOST_ASSERT(hierarchy.GetNumberOfNodes() == number_of_nodes);
+
+    // the middle node followed by the source and target of every directed shortcut
+    std::vector<std::tuple<NodeID, NodeID, NodeID>> shortcuts;
+    for (const auto node : util::irange(0u, hierarchy.GetNumberOfNodes()))
+    {
+        for (const auto edge : hierarchy.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = hierarchy.GetEdgeData(edge);
+            const auto target = hierarchy.GetTarget(edge);
+            // self-loops are inserted depending on the node weights only
+            if (!data.shortcut || target == node)
+                continue;
+
+            if (data.forward)
+                shortcuts.emplace_back(data.turn_id, node, target);
+            if (data.backward)
+                shortcuts.emplace_back(data.turn_id, target, node);
+        }
+    }
+    tbb::parallel_sort(shortcuts.begin(), shortcuts.end());
+    shortcuts.erase(std::unique(shortcuts.begin(), shortcuts.end()), shortcuts.end());
+
+    previous_shortcut_offsets.assign(number_of_nodes + 1, 0);
+    previous_shortcuts.clear();
+    previous_shortcuts.reserve(shortcuts.size());
+    for (const auto &shortcut : shortcuts)
+    {
+        ++previous_shortcut_offsets[std::get<0>(shortcut) + 1];
+        previous_shortcuts.emplace_back(std::get<1>(shortcut), std::get<2>(shortcut));
+    }
+    std::partial_sum(previous_shortcut_offsets.begin(),
+                     previous_shortcut_offsets.end(),
+                     previous_shortcut_offsets.begin());
+
+    util::Log() << "Reusing " << previous_shortcuts.size()
+                << " shortcuts of the previous hierarchy";
+}
+
+void GraphContractor::InsertShortcuts(ThreadDataContainer &thread_data_list)
+{
+    std::vector<std::size_t> offsets{0};
+    for (const auto &data : thread_data_list.data)
+        offsets.push_back(offsets.back() + data->inserted_edges.size());
+    if (offsets.back() == 0)
+        return;
+
+    std::vector<ContractorEdge> inserted_edges(offsets.back());
+    std::vector<ContractorThreadData *> thread_data;
+    for (auto &data : thread_data_list.data)
+        thread_data.push_back(data.get());
+    tbb::parallel_for(std::size_t{0}, thread_data.size(), [&](const std::size_t index) {
+        auto &edges = thread_data[index]->inserted_edges;
+        std::copy(edges.begin(), edges.end(), inserted_edges.begin() + offsets[index]);
+        // the buffers of rounds with many shortcuts aren't kept for the rest of the contraction
+        edges.clear();
+        edges.shrink_to_fit();
+    });
+    tbb::parallel_sort(inserted_edges.begin(), inserted_edges.end());
+
+    // shortcuts of one source are inserted by the same task into slots reserved beforehand,
+    // so the sources don't share any state
+    std::vector<std::size_t> source_begins;
+    std::vector<std::pair<NodeID, unsigned>> reservations;
+    for (const auto index : util::irange<std::size_t>(0, inserted_edges.size()))
+    {
+        const auto source = inserted_edges[index].source;
+        if (reservations.empty() || reservations.back().first != source)
+        {
+            source_begins.push_back(index);
+            reservations.emplace_back(source, 0);
+        }
+        ++reservations.back().second;
+    }
+    source_begins.push_back(inserted_edges.size());
+    contractor_graph->ReserveEdges(reservations);
+
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, reservations.size()),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (const auto source_index : util::irange(range.begin(), range.end()))
+            {
+                for (const auto index : util::irange(source_begins[source_index],
+                                                     source_begins[source_index + 1]))
+                {
+                    const auto &edge = inserted_edges[index];
+                    const EdgeID current_edge_ID =
+                        contractor_graph->FindEdge(edge.source, edge.target);
+                    if (current_edge_ID != SPECIAL_EDGEID)
+                    {
+                        ContractorGraph::EdgeData &current_data =
+                            contractor_graph->GetEdgeData(current_edge_ID);
+                        if (current_data.shortcut && edge.data.forward == current_data.forward &&
+                            edge.data.backward == current_data.backward)
+                        {
+                            // found a duplicate edge with smaller weight, update it.
+                            if (edge.data.weight < current_data.weight)
+                            {
+                                current_data = edge.data;
+                            }
+                            // don't insert duplicates
+                            continue;
+                        }
+                    }
+                    contractor_graph->InsertEdge(edge.source, edge.target, edge.data);
+                }
+            }
+        });
+}
+
+void GraphContractor::LogRoundTimings(const std::vector<RoundTimings> &round_timings,
+                                      const double flush_msec,
+                                      const bool debug_timings) const
+{
+    RoundTimings total{0, 0, 0, 0, 0, 0, 0};
+    for (const auto round : util::irange<std::size_t>(0, round_timings.size()))
+    {
+        const auto &timings = round_timings[round];
+        if (debug_timings)
+        {
+            util::Log() << "round " << round << ": " << timings.contracted_nodes
+                        << " nodes, independent set " << timings.independent_set
+                        << "ms, contraction " << timings.contraction << "ms, deletion "
+                        << timings.deletion << "ms, insertion " << timings.insertion
+                        << "ms, priorities " << timings.priorities << "ms, release "
+                        << timings.release << "ms";
+        }
+        total.contracted_nodes += timings.contracted_nodes;
+        total.independent_set += timings.independent_set;
+        total.contraction += timings.contraction;
+        total.deletion += timings.deletion;
+        total.insertion += timings.insertion;
+        total.priorities += timings.priorities;
+        total.release += timings.release;
+    }
+
+    util::Log() << "Contracted " << total.contracted_nodes << " nodes in " << round_timings.size()
+                << " rounds: independent sets " << total.independent_set << "ms, contraction "
+                << total.contraction << "ms, deletion " << total.deletion << "ms, insertion "
+                << total.insertion << "ms, priorities " << total.priorities << "ms, release "
+                << total.release << "ms, flush " << flush_msec << "ms";
+}
+
 float GraphContractor::EvaluateNodePriority(ContractorThreadData *const data,
                                             const NodeDepth node_depth,
                                             const NodeID node)
@@ -483,6 +714,88 @@ void GraphContractor::DeleteIncomingEdges(ContractorThreadData *data, const Node
     }
 }
 
+void GraphContractor::ReleaseContractedNodes(const std::vector<RemainingNodeData> &remaining_nodes,
+                                             const std::size_t begin,
+                                             const std::size_t end)
+{
+    std::vector<std::size_t> offsets(end - begin + 1, 0);
+    for (const auto position : util::irange(begin, end))
+    {
+        offsets[position - begin + 1] =
+            offsets[position - begin] +
+            contractor_graph->GetOutDegree(remaining_nodes[position].id);
+    }
+
+    std::vector<QueryEdge> edges(offsets.back());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(begin, end),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (const auto position : util::irange(range.begin(), range.end()))
+                          {
+                              const NodeID node = remaining_nodes[position].id;
+                              auto edge_index = offsets[position - begin];
+                              for (const auto edge : contractor_graph->GetAdjacentEdgeRange(node))
+                              {
+                                  edges[edge_index++] = MakeHierarchyEdge<QueryEdge>(
+                                      node,
+                                      contractor_graph->GetTarget(edge),
+                                      contractor_graph->GetEdgeData(edge));
+                              }
+                          }
+                      });
+    for (const auto &edge : edges)
+    {
+        external_edge_list.push_back(edge);
+    }
+
+    for (const auto position : util::irange(begin, end))
+    {
+        contractor_graph->ReleaseEdges(remaining_nodes[position].id);
+    }
+    // the released blocks are small while the shortcuts need ever larger ones, so their space
+    // is given back once most of the edge list is free
+    if (contractor_graph->GetNumberOfFreeSlots() > contractor_graph->GetNumberOfSlots() / 2)
+    {
+        contractor_graph->Compact();
+    }
+}
+
+bool GraphContractor::IsKept(const NodeID node) const
+{
+    if (is_kept_node.empty())
+        return false;
+    return is_kept_node[orig_node_id_from_new_node_id_map.empty()
+                            ? node
+                            : orig_node_id_from_new_node_id_map[node]];
+}
+
+bool GraphContractor::HasPreviousShortcuts(const NodeID node, const NodeID source) const
+{
+    if (previous_shortcut_offsets.empty())
+        return false;
+
+    const auto original_id = [this](const NodeID id) {
+        return orig_node_id_from_new_node_id_map.empty() ? id
+                                                         : orig_node_id_from_new_node_id_map[id];
+    };
+    const auto middle = original_id(node);
+    const auto begin = previous_shortcuts.begin() + previous_shortcut_offsets[middle];
+    const auto end = previous_shortcuts.begin() + previous_shortcut_offsets[middle + 1];
+    if (begin == end)
+        return false;
+
+    for (auto out_edge : contractor_graph->GetAdjacentEdgeRange(node))
+    {
+        const NodeID target = contractor_graph->GetTarget(out_edge);
+        if (!contractor_graph->GetEdgeData(out_edge).forward || target == node || target == source)
+            continue;
+
+        if (!std::binary_search(
+                begin, end, std::make_pair(original_id(source), original_id(target))))
+            return false;
+    }
+    return true;
+}
+
 bool GraphContractor::UpdateNodeNeighbours(std::vector<float> &priorities,
                                            std::vector<NodeDepth> &node_depth,
                                            ContractorThreadData *const data,
@@ -509,7 +822,8 @@ bool GraphContractor::UpdateNodeNeighbours(std::vector<float> &priorities,
     // re-evaluate priorities of neighboring nodes
     for (const NodeID u : neighbours)
     {
-        priorities[u] = EvaluateNodePriority(data, node_depth[u], u);
+        if (!IsKept(u))
+            priorities[u] = EvaluateNodePriority(data, node_depth[u], u);
     }
     return true;
 }
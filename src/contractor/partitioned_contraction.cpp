@@ -0,0 +1,255 @@
+#include "contractor/partitioned_contraction.hpp"
+#include "contractor/crc32_processor.hpp"
+#include "contractor/graph_contractor.hpp"
+#include "contractor/graph_contractor_adaptors.hpp"
+#include "contractor/query_graph.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/percent.hpp"
+#include "util/timing_util.hpp"
+
+#include <stxxl/sort>
+#include <stxxl/vector>
+
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <climits>
+#include <limits>
+#include <numeric>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+#ifndef _MSC_VER
+constexpr unsigned stxxl_memory =
+    ((sizeof(std::size_t) == 4) ? std::numeric_limits<int>::max()
+                                : std::numeric_limits<unsigned>::max());
+#else
+const unsigned stxxl_memory = ((sizeof(std::size_t) == 4) ? INT_MAX : UINT_MAX);
+#endif
+
+struct QueryEdgeSTXXLCompare
+{
+    using value_type = QueryEdge;
+    bool operator()(const value_type &lhs, const value_type &rhs) const { return lhs < rhs; }
+    value_type max_value() { return {SPECIAL_NODEID, SPECIAL_NODEID, QueryEdge::EdgeData{}}; }
+    value_type min_value() { return {0, 0, QueryEdge::EdgeData{}}; }
+};
+
+// Writes the sorted edges in the layout of files::writeGraph without holding them in memory
+void writeSortedGraph(const std::string &path,
+                      const NodeID number_of_nodes,
+                      const stxxl::vector<QueryEdge> &edges)
+{
+    // the external vector is not safe to read from several threads
+    IteratorbasedCRC32 crc32_calculator;
+    const unsigned checksum = crc32_calculator(edges.begin(), edges.end());
+
+    std::vector<QueryGraph::NodeArrayEntry> node_array(number_of_nodes + 1, {0});
+    for (const auto &edge : edges)
+    {
+        ++node_array[edge.source + 1].first_edge;
+    }
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        node_array[node + 1].first_edge += node_array[node].first_edge;
+    }
+
+    storage::io::FileWriter writer{path, storage::io::FileWriter::GenerateFingerprint};
+    writer.WriteOne(checksum);
+    storage::serialization::write(writer, node_array);
+    writer.WriteElementCount64(edges.size());
+    for (const auto &edge : edges)
+    {
+        writer.WriteOne(QueryGraph::EdgeArrayEntry{edge.target, edge.data});
+    }
+}
+}
+
+std::vector<float> contractPartitioned(const ContractorConfig &config,
+                                       const partition::MultiLevelPartition &partition,
+                                       const NodeID number_of_nodes,
+                                       std::vector<extractor::EdgeBasedEdge> edge_based_edge_list,
+                                       std::vector<EdgeWeight> node_weights)
+{
+    const LevelID highest_level = partition.GetNumberOfLevels() - 1;
+    const LevelID level = config.partition_level == 0
+                              ? highest_level
+                              : std::min<LevelID>(config.partition_level, highest_level);
+    const auto number_of_cells = partition.GetNumberOfCells(level);
+    const auto cell = [&](const NodeID node) { return partition.GetCell(level, node); };
+
+    // the nodes of every cell numbered from zero in their cell
+    std::vector<NodeID> cell_offsets(number_of_cells + 1, 0);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        ++cell_offsets[cell(node) + 1];
+    }
+    std::partial_sum(cell_offsets.begin(), cell_offsets.end(), cell_offsets.begin());
+    std::vector<NodeID> cell_nodes(number_of_nodes);
+    std::vector<NodeID> local_ids(number_of_nodes);
+    {
+        auto positions = cell_offsets;
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            const auto position = positions[cell(node)]++;
+            cell_nodes[position] = node;
+            local_ids[node] = position - cell_offsets[cell(node)];
+        }
+    }
+
+    // edges inside of a cell are grouped by their cell, the cut edges come last
+    std::vector<bool> is_boundary_node(number_of_nodes, false);
+    const auto edge_cell = [&](const extractor::EdgeBasedEdge &edge) {
+        const auto source_cell = cell(edge.source);
+        return source_cell == cell(edge.target) ? source_cell : number_of_cells;
+    };
+    for (const auto &edge : edge_based_edge_list)
+    {
+        if (edge.data.weight != INVALID_EDGE_WEIGHT && edge_cell(edge) == number_of_cells)
+        {
+            is_boundary_node[edge.source] = true;
+            is_boundary_node[edge.target] = true;
+        }
+    }
+    tbb::parallel_sort(edge_based_edge_list.begin(),
+                       edge_based_edge_list.end(),
+                       [&](const auto &lhs, const auto &rhs) {
+                           return edge_cell(lhs) < edge_cell(rhs);
+                       });
+    std::vector<std::size_t> edge_offsets(number_of_cells + 2, 0);
+    for (const auto &edge : edge_based_edge_list)
+    {
+        ++edge_offsets[edge_cell(edge) + 1];
+    }
+    std::partial_sum(edge_offsets.begin(), edge_offsets.end(), edge_offsets.begin());
+
+    std::vector<float> node_levels(number_of_nodes, 0);
+    float highest_cell_level = 0;
+    stxxl::vector<QueryEdge> contracted_edges;
+
+    std::vector<ContractorEdge> boundary_edges = adaptToContractorInput(
+        std::vector<extractor::EdgeBasedEdge>(edge_based_edge_list.begin() +
+                                                  edge_offsets[number_of_cells],
+                                              edge_based_edge_list.end()));
+
+    TIMER_START(contract_cells);
+    for (const auto cell_id : util::irange<CellID>(0, number_of_cells))
+    {
+        const auto nodes_begin = cell_offsets[cell_id];
+        const NodeID number_of_cell_nodes = cell_offsets[cell_id + 1] - nodes_begin;
+        if (number_of_cell_nodes == 0)
+            continue;
+        const auto global_id = [&](const NodeID local) { return cell_nodes[nodes_begin + local]; };
+
+        util::Log() << "Contracting cell " << cell_id << " of " << number_of_cells << " with "
+                    << number_of_cell_nodes << " nodes";
+
+        std::vector<extractor::EdgeBasedEdge> cell_edges(
+            edge_based_edge_list.begin() + edge_offsets[cell_id],
+            edge_based_edge_list.begin() + edge_offsets[cell_id + 1]);
+        for (auto &edge : cell_edges)
+        {
+            edge.source = local_ids[edge.source];
+            edge.target = local_ids[edge.target];
+        }
+        std::vector<EdgeWeight> cell_node_weights(number_of_cell_nodes);
+        std::vector<bool> is_kept_node(number_of_cell_nodes);
+        for (const auto local : util::irange<NodeID>(0, number_of_cell_nodes))
+        {
+            cell_node_weights[local] = node_weights[global_id(local)];
+            is_kept_node[local] = is_boundary_node[global_id(local)];
+        }
+
+        GraphContractor graph_contractor(number_of_cell_nodes,
+                                         adaptToContractorInput(std::move(cell_edges)),
+                                         {},
+                                         std::move(cell_node_weights),
+                                         config.witness_search);
+        graph_contractor.KeepNodes(is_kept_node);
+        graph_contractor.Run(1.0, config.debug_timings);
+
+        for (auto edge : graph_contractor.GetKeptEdges())
+        {
+            edge.source = global_id(edge.source);
+            edge.target = global_id(edge.target);
+            if (edge.data.shortcut)
+                edge.data.id = global_id(edge.data.id);
+            boundary_edges.push_back(edge);
+        }
+
+        const auto cell_levels = graph_contractor.GetNodeLevels();
+        for (const auto local : util::irange<NodeID>(0, number_of_cell_nodes))
+        {
+            if (!is_kept_node[local])
+            {
+                node_levels[global_id(local)] = cell_levels[local];
+                highest_cell_level = std::max(highest_cell_level, cell_levels[local]);
+            }
+        }
+
+        for (auto edge : graph_contractor.GetEdges<QueryEdge>())
+        {
+            edge.source = global_id(edge.source);
+            edge.target = global_id(edge.target);
+            if (edge.data.shortcut)
+                edge.data.turn_id = global_id(edge.data.turn_id);
+            contracted_edges.push_back(edge);
+        }
+    }
+    edge_based_edge_list.clear();
+    edge_based_edge_list.shrink_to_fit();
+    TIMER_STOP(contract_cells);
+    util::Log() << "Contracted " << number_of_cells << " cells of level " << level << " in "
+                << TIMER_SEC(contract_cells) << " seconds, " << contracted_edges.size()
+                << " edges spilled";
+
+    // the nodes inside of the cells have no edges left and are contracted right away
+    TIMER_START(contract_boundary);
+    {
+        GraphContractor graph_contractor(number_of_nodes,
+                                         std::move(boundary_edges),
+                                         {},
+                                         std::move(node_weights),
+                                         config.witness_search);
+        graph_contractor.Run(1.0, config.debug_timings);
+
+        const auto boundary_levels = graph_contractor.GetNodeLevels();
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (is_boundary_node[node])
+                node_levels[node] = highest_cell_level + 1 + boundary_levels[node];
+        }
+
+        for (const auto &edge : graph_contractor.GetEdges<QueryEdge>())
+        {
+            contracted_edges.push_back(edge);
+        }
+    }
+    TIMER_STOP(contract_boundary);
+    util::Log() << "Contracting the boundary nodes took " << TIMER_SEC(contract_boundary)
+                << " seconds";
+
+    TIMER_START(merge_edges);
+    stxxl::sort(contracted_edges.begin(),
+                contracted_edges.end(),
+                QueryEdgeSTXXLCompare(),
+                stxxl_memory);
+    writeSortedGraph(config.graph_output_path, number_of_nodes, contracted_edges);
+    TIMER_STOP(merge_edges);
+    util::Log() << "Merging " << contracted_edges.size() << " edges into "
+                << config.graph_output_path << " took " << TIMER_SEC(merge_edges) << " seconds";
+
+    return node_levels;
+}
+}
+}
@@ -0,0 +1,202 @@
+#include "contractor/renumber.hpp"
+
+#include "extractor/edge_based_edge.hpp"
+#include "extractor/edge_based_node_segment.hpp"
+#include "extractor/files.hpp"
+#include "extractor/nbg_to_ebg.hpp"
+#include "extractor/node_data_container.hpp"
+
+#include "partition/renumber.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/mmap_file.hpp"
+#include "util/permutation.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <stack>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+namespace osrm
+{
+namespace contractor
+{
+namespace
+{
+// rank 0 is the highest node, the bands have the sizes 1, 2, 4, 8, ...
+std::uint32_t getBand(const std::uint32_t rank)
+{
+    std::uint32_t band = 0;
+    for (auto size = rank + 1; size > 1; size /= 2)
+        ++band;
+    return band;
+}
+}
+
+std::vector<std::uint32_t> makePermutation(const std::vector<float> &node_levels,
+                                           const util::DeallocatingVector<QueryEdge> &edges)
+{
+    const auto number_of_nodes = static_cast<NodeID>(node_levels.size());
+
+    std::vector<NodeID> by_level(number_of_nodes);
+    std::iota(by_level.begin(), by_level.end(), 0);
+    tbb::parallel_sort(by_level.begin(), by_level.end(), [&](const NodeID lhs, const NodeID rhs) {
+        return node_levels[lhs] > node_levels[rhs] ||
+               (node_levels[lhs] == node_levels[rhs] && lhs < rhs);
+    });
+
+    std::vector<std::uint32_t> ranks(number_of_nodes);
+    for (const auto rank : util::irange<std::uint32_t>(0, number_of_nodes))
+        ranks[by_level[rank]] = rank;
+
+    // downward edges from the higher to the lower end of every edge
+    std::vector<EdgeID> first_down_edges(number_of_nodes + 1, 0);
+    for (const auto &edge : edges)
+    {
+        const auto upper = ranks[edge.source] < ranks[edge.target] ? edge.source : edge.target;
+        ++first_down_edges[upper + 1];
+    }
+    std::partial_sum(first_down_edges.begin(), first_down_edges.end(), first_down_edges.begin());
+
+    std::vector<NodeID> down_targets(first_down_edges.back());
+    {
+        auto positions = first_down_edges;
+        for (const auto &edge : edges)
+        {
+            const auto source_is_upper = ranks[edge.source] < ranks[edge.target];
+            const auto upper = source_is_upper ? edge.source : edge.target;
+            down_targets[positions[upper]++] = source_is_upper ? edge.target : edge.source;
+        }
+    }
+
+    // depth-first order along the downward edges, starting at the highest unvisited node
+    std::vector<std::uint32_t> dfs_order(number_of_nodes, SPECIAL_NODEID);
+    std::uint32_t next_order = 0;
+    std::stack<NodeID> stack;
+    for (const auto root : by_level)
+    {
+        if (dfs_order[root] != SPECIAL_NODEID)
+            continue;
+
+        stack.push(root);
+        while (!stack.empty())
+        {
+            const auto node = stack.top();
+            stack.pop();
+            if (dfs_order[node] != SPECIAL_NODEID)
+                continue;
+            dfs_order[node] = next_order++;
+
+            // push in reverse to visit the children in the order of their edges
+            for (auto edge = first_down_edges[node + 1]; edge > first_down_edges[node]; --edge)
+            {
+                const auto target = down_targets[edge - 1];
+                if (dfs_order[target] == SPECIAL_NODEID)
+                    stack.push(target);
+            }
+        }
+    }
+    BOOST_ASSERT(next_order == number_of_nodes);
+
+    std::vector<NodeID> ordering(by_level);
+    tbb::parallel_sort(ordering.begin(), ordering.end(), [&](const NodeID lhs, const NodeID rhs) {
+        const auto lhs_band = getBand(ranks[lhs]);
+        const auto rhs_band = getBand(ranks[rhs]);
+        return lhs_band < rhs_band || (lhs_band == rhs_band && dfs_order[lhs] < dfs_order[rhs]);
+    });
+
+    std::vector<std::uint32_t> permutation(number_of_nodes);
+    for (const auto index : util::irange<std::uint32_t>(0, number_of_nodes))
+        permutation[ordering[index]] = index;
+
+    return permutation;
+}
+
+void renumber(util::DeallocatingVector<QueryEdge> &edges,
+              const std::vector<std::uint32_t> &permutation)
+{
+    tbb::parallel_for(std::size_t{0}, edges.size(), [&](const std::size_t index) {
+        auto &edge = edges[index];
+        edge.source = permutation[edge.source];
+        edge.target = permutation[edge.target];
+        if (edge.data.shortcut)
+            edge.data.turn_id = permutation[edge.data.turn_id];
+    });
+    tbb::parallel_sort(edges.begin(), edges.end());
+}
+
+void renumberDataset(const ContractorConfig &config,
+                     const std::vector<std::uint32_t> &permutation)
+{
+    const auto &updater_config = config.updater_config;
+    {
+        EdgeID max_edge_id;
+        std::vector<extractor::EdgeBasedEdge> edge_based_edge_list;
+        extractor::files::readEdgeBasedGraph(
+            updater_config.edge_based_graph_path, max_edge_id, edge_based_edge_list);
+        for (auto &edge : edge_based_edge_list)
+        {
+            edge.source = permutation[edge.source];
+            edge.target = permutation[edge.target];
+        }
+        extractor::files::writeEdgeBasedGraph(
+            updater_config.edge_based_graph_path, max_edge_id, edge_based_edge_list);
+    }
+    {
+        std::vector<EdgeWeight> node_weights;
+        {
+            storage::io::FileReader reader(config.node_file_path,
+                                           storage::io::FileReader::VerifyFingerprint);
+            storage::serialization::read(reader, node_weights);
+        }
+        util::inplacePermutation(node_weights.begin(), node_weights.end(), permutation);
+        storage::io::FileWriter writer(config.node_file_path,
+                                       storage::io::FileWriter::GenerateFingerprint);
+        storage::serialization::write(writer, node_weights);
+    }
+    {
+        extractor::EdgeBasedNodeDataContainer node_data;
+        extractor::files::readNodeData(updater_config.edge_based_nodes_data_path, node_data);
+        partition::renumber(node_data, permutation);
+        extractor::files::writeNodeData(updater_config.edge_based_nodes_data_path, node_data);
+    }
+    {
+        boost::iostreams::mapped_file segment_region;
+        auto segments = util::mmapFile<extractor::EdgeBasedNodeSegment>(
+            updater_config.rtree_leaf_path, segment_region);
+        partition::renumber(segments, permutation);
+    }
+    {
+        std::vector<extractor::NBGToEBG> mapping;
+        extractor::files::readNBGMapping(config.cnbg_ebg_mapping_path, mapping);
+        for (auto &entry : mapping)
+        {
+            entry.forward_ebg_node = permutation[entry.forward_ebg_node];
+            if (entry.backward_ebg_node != SPECIAL_NODEID)
+                entry.backward_ebg_node = permutation[entry.backward_ebg_node];
+        }
+        extractor::files::writeNBGMapping(config.cnbg_ebg_mapping_path, mapping);
+    }
+
+    // the partition and the customized metrics of it refer to the old node ids
+    if (boost::filesystem::exists(config.partition_path))
+    {
+        util::Log(logWARNING) << "Found existing .osrm.partition file, removing. You need to "
+                                 "re-run osrm-partition and osrm-customize after renumbering.";
+        boost::filesystem::remove(config.partition_path);
+    }
+    for (const auto extension :
+         {".cells", ".mldgr", ".mldtop", ".cch", ".cchgr", ".landmarks", ".distance_oracle"})
+        boost::filesystem::remove(config.osrm_input_path.string() + extension);
+}
+}
+}
@@ -0,0 +1,431 @@
+#include "customizer/cch.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+namespace osrm
+{
+namespace customizer
+{
+
+namespace
+{
+// Best path found for one direction of an arc, the id is the middle node of shortcuts and the
+// turn id of original edges like in the CH
+struct ArcData
+{
+    EdgeWeight weight = INVALID_EDGE_WEIGHT;
+    EdgeWeight duration = 0;
+    NodeID id = SPECIAL_NODEID;
+    bool shortcut = false;
+
+    bool IsValid() const { return weight != INVALID_EDGE_WEIGHT; }
+
+    bool operator==(const ArcData &other) const
+    {
+        return weight == other.weight && duration == other.duration && id == other.id &&
+               shortcut == other.shortcut;
+    }
+};
+
+inline void relax(ArcData &arc, const ArcData &first, const ArcData &second, const NodeID middle)
+{
+    if (!first.IsValid() || !second.IsValid())
+        return;
+
+    const auto weight = static_cast<std::int64_t>(first.weight) + second.weight;
+    const auto duration = first.duration + second.duration;
+    if (weight >= INVALID_EDGE_WEIGHT ||
+        std::tie(weight, duration) >= std::tie(arc.weight, arc.duration))
+        return;
+
+    arc.weight = static_cast<EdgeWeight>(weight);
+    arc.duration = duration;
+    arc.id = middle;
+    arc.shortcut = true;
+}
+
+inline void relax(ArcData &arc, const EdgeBasedGraphEdgeData &data)
+{
+    const EdgeWeight duration = data.duration;
+    if (std::tie(data.weight, duration) >= std::tie(arc.weight, arc.duration))
+        return;
+
+    arc.weight = data.weight;
+    arc.duration = duration;
+    arc.id = data.turn_id;
+    arc.shortcut = false;
+}
+
+inline contractor::QueryEdge makeQueryEdge(
+    const NodeID source, const NodeID target, const ArcData &arc, bool forward, bool backward)
+{
+    contractor::QueryEdge::EdgeData data;
+    data.turn_id = arc.id;
+    data.shortcut = arc.shortcut;
+    data.weight = arc.weight;
+    data.duration = arc.duration;
+    data.forward = forward;
+    data.backward = backward;
+    return contractor::QueryEdge{source, target, data};
+}
+}
+
+CCHTopology::CCHTopology(const partition::MultiLevelPartition &partition,
+                         const MultiLevelEdgeBasedGraph &graph)
+{
+    const auto num_nodes = graph.GetNumberOfNodes();
+
+    // the arcs of the supergraph are symmetric, the directions only matter for the metric
+    std::vector<std::vector<NodeID>> neighbours(num_nodes);
+    std::vector<LevelID> boundary_levels(num_nodes, 0);
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, num_nodes),
+                      [&](const tbb::blocked_range<NodeID> &range) {
+                          for (const auto node : util::irange(range.begin(), range.end()))
+                          {
+                              auto &adjacent = neighbours[node];
+                              for (const auto edge : graph.GetAdjacentEdgeRange(node))
+                              {
+                                  const auto target = graph.GetTarget(edge);
+                                  if (target == node)
+                                      continue;
+                                  adjacent.push_back(target);
+
+                                  // only the end in the higher cell is a boundary node,
+                                  // which still separates the cells
+                                  const auto level =
+                                      partition.GetHighestDifferentLevel(node, target);
+                                  if (level > 0 && partition.GetCell(level, node) >
+                                                       partition.GetCell(level, target))
+                                      boundary_levels[node] =
+                                          std::max(boundary_levels[node], level);
+                              }
+                              std::sort(adjacent.begin(), adjacent.end());
+                              adjacent.erase(std::unique(adjacent.begin(), adjacent.end()),
+                                             adjacent.end());
+                          }
+                      });
+
+    // Nodes are contracted by minimum degree, the boundary nodes of each level only after all
+    // nodes of the levels below. The neighbours of a node are either inside of the same cell
+    // or on its boundary, so the cliques of the contracted nodes stay within the cell.
+    // The boundary nodes of the highest level are left, their cliques span the whole graph.
+    const auto top_level =
+        num_nodes == 0 ? 0 : *std::max_element(boundary_levels.begin(), boundary_levels.end());
+    order.reserve(num_nodes);
+    using QueueEntry = std::pair<std::size_t, NodeID>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    std::vector<bool> contracted(num_nodes, false);
+    std::vector<NodeID> merged;
+    for (LevelID level = 0; level < top_level; ++level)
+    {
+        for (const auto node : util::irange<NodeID>(0, num_nodes))
+        {
+            if (boundary_levels[node] == level)
+                queue.emplace(neighbours[node].size(), node);
+        }
+
+        while (!queue.empty())
+        {
+            const auto degree = queue.top().first;
+            const auto node = queue.top().second;
+            queue.pop();
+            if (contracted[node] || degree != neighbours[node].size())
+                continue;
+
+            contracted[node] = true;
+            order.push_back(node);
+
+            // the neighbours that are left become a clique, they are the upward arcs
+            const auto &clique = neighbours[node];
+            for (const auto neighbour : clique)
+            {
+                auto &adjacent = neighbours[neighbour];
+                merged.clear();
+                std::set_union(adjacent.begin(),
+                               adjacent.end(),
+                               clique.begin(),
+                               clique.end(),
+                               std::back_inserter(merged));
+                merged.erase(std::remove_if(merged.begin(),
+                                            merged.end(),
+                                            [&](const NodeID other) {
+                                                return other == node || other == neighbour;
+                                            }),
+                             merged.end());
+                adjacent.assign(merged.begin(), merged.end());
+
+                if (boundary_levels[neighbour] == level)
+                    queue.emplace(adjacent.size(), neighbour);
+            }
+        }
+    }
+    const auto num_contracted_nodes = order.size();
+
+    // The boundary nodes of the highest level are grouped by their cells from the top down
+    for (const auto node : util::irange<NodeID>(0, num_nodes))
+    {
+        if (!contracted[node])
+            order.push_back(node);
+    }
+    const auto num_levels = partition.GetNumberOfLevels();
+    std::sort(order.begin() + num_contracted_nodes, order.end(), [&](NodeID lhs, NodeID rhs) {
+        for (LevelID level = num_levels - 1; level > 0; --level)
+        {
+            const auto lhs_cell = partition.GetCell(level, lhs);
+            const auto rhs_cell = partition.GetCell(level, rhs);
+            if (lhs_cell != rhs_cell)
+                return lhs_cell < rhs_cell;
+        }
+        return lhs < rhs;
+    });
+
+    ranks.resize(num_nodes);
+    for (const auto rank : util::irange<NodeID>(0, num_nodes))
+    {
+        ranks[order[rank]] = rank;
+    }
+
+    // The upward neighbours of contracted nodes are final. The nodes that are left are
+    // contracted by passing their upward neighbours on to the lowest of them, which gives the
+    // same cliques as contracting them one after the other.
+    std::vector<std::vector<NodeID>> upward(num_nodes);
+    for (const auto rank : util::irange<NodeID>(0, num_nodes))
+    {
+        const auto node = order[rank];
+        auto &up = upward[rank];
+        for (const auto neighbour : neighbours[node])
+        {
+            if (ranks[neighbour] > rank)
+                up.push_back(ranks[neighbour]);
+        }
+        std::vector<NodeID>().swap(neighbours[node]);
+        std::sort(up.begin(), up.end());
+        up.erase(std::unique(up.begin(), up.end()), up.end());
+
+        if (rank >= num_contracted_nodes && up.size() > 1)
+        {
+            const auto parent = order[up.front()];
+            for (const auto other : util::irange<std::size_t>(1, up.size()))
+            {
+                neighbours[parent].push_back(order[up[other]]);
+            }
+        }
+    }
+
+    up_offsets.reserve(num_nodes + 1);
+    up_offsets.push_back(0);
+    for (const auto &up : upward)
+    {
+        up_targets.insert(up_targets.end(), up.begin(), up.end());
+        up_offsets.push_back(up_targets.size());
+    }
+
+    Initialize();
+}
+
+CCHTopology::CCHTopology(std::vector<NodeID> order_,
+                         std::vector<EdgeID> up_offsets_,
+                         std::vector<NodeID> up_targets_)
+    : order(std::move(order_)), up_offsets(std::move(up_offsets_)),
+      up_targets(std::move(up_targets_))
+{
+    BOOST_ASSERT(up_offsets.size() == order.size() + 1);
+    BOOST_ASSERT(up_offsets.back() == up_targets.size());
+
+    ranks.resize(order.size());
+    for (const auto rank : util::irange<NodeID>(0, order.size()))
+    {
+        ranks[order[rank]] = rank;
+    }
+
+    Initialize();
+}
+
+void CCHTopology::Initialize()
+{
+    const auto num_nodes = order.size();
+
+    std::vector<std::uint32_t> levels(num_nodes, 0);
+    down_offsets.assign(num_nodes + 1, 0);
+    for (const auto rank : util::irange<NodeID>(0, num_nodes))
+    {
+        for (const auto arc : util::irange(up_offsets[rank], up_offsets[rank + 1]))
+        {
+            const auto target = up_targets[arc];
+            levels[target] = std::max(levels[target], levels[rank] + 1);
+            ++down_offsets[target + 1];
+        }
+    }
+    std::partial_sum(down_offsets.begin(), down_offsets.end(), down_offsets.begin());
+
+    // arcs are visited by increasing source rank, so the arcs into a rank stay sorted
+    down_sources.resize(up_targets.size());
+    down_arcs.resize(up_targets.size());
+    auto positions = down_offsets;
+    for (const auto rank : util::irange<NodeID>(0, num_nodes))
+    {
+        for (const auto arc : util::irange(up_offsets[rank], up_offsets[rank + 1]))
+        {
+            const auto position = positions[up_targets[arc]]++;
+            down_sources[position] = rank;
+            down_arcs[position] = arc;
+        }
+    }
+
+    const auto num_levels =
+        num_nodes == 0 ? 0 : *std::max_element(levels.begin(), levels.end()) + 1;
+    level_offsets.assign(num_levels + 1, 0);
+    for (const auto level : levels)
+    {
+        ++level_offsets[level + 1];
+    }
+    std::partial_sum(level_offsets.begin(), level_offsets.end(), level_offsets.begin());
+    level_ranks.resize(num_nodes);
+    auto level_positions = level_offsets;
+    for (const auto rank : util::irange<NodeID>(0, num_nodes))
+    {
+        level_ranks[level_positions[levels[rank]]++] = rank;
+    }
+}
+
+bool CCHTopology::Covers(const MultiLevelEdgeBasedGraph &graph) const
+{
+    if (graph.GetNumberOfNodes() != order.size())
+        return false;
+
+    std::atomic<bool> covered{true};
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, graph.GetNumberOfNodes()),
+                      [&](const tbb::blocked_range<NodeID> &range) {
+                          for (const auto node : util::irange(range.begin(), range.end()))
+                          {
+                              for (const auto edge : graph.GetAdjacentEdgeRange(node))
+                              {
+                                  const auto target = graph.GetTarget(edge);
+                                  if (target == node)
+                                      continue;
+                                  const auto from = std::min(ranks[node], ranks[target]);
+                                  const auto to = std::max(ranks[node], ranks[target]);
+                                  if (FindArc(from, to) == SPECIAL_EDGEID)
+                                      covered = false;
+                              }
+                          }
+                      });
+    return covered;
+}
+
+contractor::QueryGraph CCHTopology::Customize(const MultiLevelEdgeBasedGraph &graph) const
+{
+    BOOST_ASSERT(Covers(graph));
+    const auto num_nodes = order.size();
+
+    // paths from the lower node of an arc to the upper one and back
+    std::vector<ArcData> forward(up_targets.size());
+    std::vector<ArcData> backward(up_targets.size());
+    // paths from every node back to itself through a lower node
+    std::vector<ArcData> loops(num_nodes);
+
+    // the edges around a node are stored at both ends, so each rank sets its own arcs only
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, num_nodes),
+                      [&](const tbb::blocked_range<NodeID> &range) {
+                          for (const auto rank : util::irange(range.begin(), range.end()))
+                          {
+                              const auto node = order[rank];
+                              for (const auto edge : graph.GetAdjacentEdgeRange(node))
+                              {
+                                  const auto target = graph.GetTarget(edge);
+                                  if (target == node || ranks[target] < rank)
+                                      continue;
+
+                                  const auto arc = FindArc(rank, ranks[target]);
+                                  const auto &data = graph.GetEdgeData(edge);
+                                  if (data.forward)
+                                      relax(forward[arc], data);
+                                  if (data.backward)
+                                      relax(backward[arc], data);
+                              }
+                          }
+                      });
+
+    // Every lower triangle (x, u, w) of an arc u -> w is a path over x. The arcs of x are final
+    // once its level is done, and the ranks of a level only write their own arcs.
+    for (const auto level : util::irange<std::size_t>(0, level_offsets.size() - 1))
+    {
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(level_offsets[level], level_offsets[level + 1]),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                for (const auto index : util::irange(range.begin(), range.end()))
+                {
+                    const auto rank = level_ranks[index];
+                    for (const auto down : util::irange(down_offsets[rank], down_offsets[rank + 1]))
+                    {
+                        const auto lower = down_sources[down];
+                        const auto lower_arc = down_arcs[down];
+                        const auto middle = order[lower];
+                        const auto &to_lower = backward[lower_arc];
+                        const auto &from_lower = forward[lower_arc];
+                        if (!to_lower.IsValid() && !from_lower.IsValid())
+                            continue;
+
+                        relax(loops[rank], to_lower, from_lower, middle);
+
+                        // the arcs of the lower node above this rank are a subset of its arcs
+                        auto arc = up_offsets[rank];
+                        for (const auto lower_up :
+                             util::irange(lower_arc + 1, up_offsets[lower + 1]))
+                        {
+                            while (up_targets[arc] != up_targets[lower_up])
+                                ++arc;
+                            BOOST_ASSERT(arc < up_offsets[rank + 1]);
+                            relax(forward[arc], to_lower, forward[lower_up], middle);
+                            relax(backward[arc], backward[lower_up], from_lower, middle);
+                        }
+                    }
+                }
+            });
+    }
+
+    std::vector<contractor::QueryEdge> edges;
+    for (const auto rank : util::irange<NodeID>(0, num_nodes))
+    {
+        const auto source = order[rank];
+        for (const auto arc : util::irange(up_offsets[rank], up_offsets[rank + 1]))
+        {
+            const auto target = order[up_targets[arc]];
+            if (forward[arc].IsValid() && forward[arc] == backward[arc])
+            {
+                edges.push_back(makeQueryEdge(source, target, forward[arc], true, true));
+                continue;
+            }
+            if (forward[arc].IsValid())
+                edges.push_back(makeQueryEdge(source, target, forward[arc], true, false));
+            if (backward[arc].IsValid())
+                edges.push_back(makeQueryEdge(source, target, backward[arc], false, true));
+        }
+
+        // loops are stored in both directions like the contractor inserts them
+        if (loops[rank].IsValid())
+        {
+            edges.push_back(makeQueryEdge(source, source, loops[rank], true, false));
+            edges.push_back(makeQueryEdge(source, source, loops[rank], false, true));
+        }
+    }
+    tbb::parallel_sort(edges.begin(), edges.end());
+
+    return contractor::QueryGraph{static_cast<std::uint32_t>(num_nodes), edges};
+}
+}
+}
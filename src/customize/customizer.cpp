@@ -1,6 +1,13 @@
 #include "customizer/customizer.hpp"
+#include "customizer/cch.hpp"
 #include "customizer/cell_customizer.hpp"
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/files.hpp"
+#include "customizer/overlay_hierarchy.hpp"
+
+#include "contractor/crc32_processor.hpp"
+#include "contractor/files.hpp"
+#include "extractor/files.hpp"
 
 #include "partition/cell_storage.hpp"
 #include "partition/edge_based_graph_reader.hpp"
@@ -11,9 +18,22 @@
 
 #include "updater/updater.hpp"
 
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/distance_oracle.hpp"
+#include "util/integer_range.hpp"
+#include "util/landmarks.hpp"
 #include "util/log.hpp"
+#include "util/perf_report.hpp"
 #include "util/timing_util.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace osrm
 {
 namespace customizer
@@ -71,10 +91,10 @@ void CellStorageStatistics(const Graph &graph,
     }
 }
 
-auto LoadAndUpdateEdgeExpandedGraph(const CustomizationConfig &config,
+auto LoadAndUpdateEdgeExpandedGraph(const updater::UpdaterConfig &config,
                                     const partition::MultiLevelPartition &mlp)
 {
-    updater::Updater updater(config.updater_config);
+    updater::Updater updater(config);
 
     EdgeID num_nodes;
     std::vector<extractor::EdgeBasedEdge> edge_based_edge_list;
@@ -93,33 +113,290 @@ auto LoadAndUpdateEdgeExpandedGraph(const CustomizationConfig &config,
     return edge_based_graph;
 }
 
+// The graph written by the last customization if the cells still hold the values computed
+// from it for the same metrics
+std::unique_ptr<MultiLevelEdgeBasedGraph>
+LoadPreviousGraph(const CustomizationConfig &config,
+                  const partition::CellStorage &storage,
+                  const std::vector<std::string> &metric_names)
+{
+    if (!boost::filesystem::exists(config.mld_graph_path))
+    {
+        util::Log() << "No previous customization found, customizing all cells";
+        return {};
+    }
+
+    // osrm-partition writes new cells without touching the graph, the customization writes
+    // the graph after its cells
+    if (boost::filesystem::last_write_time(config.mld_graph_path) <
+        boost::filesystem::last_write_time(config.mld_storage_path))
+    {
+        util::Log() << "Cells were written after the last customization, customizing all cells";
+        return {};
+    }
+
+    if (storage.GetMetricNames() != metric_names)
+    {
+        util::Log() << "Metrics differ from the last customization, customizing all cells";
+        return {};
+    }
+
+    auto graph = std::make_unique<MultiLevelEdgeBasedGraph>();
+    partition::files::readGraph(config.mld_graph_path, *graph);
+    return graph;
+}
+
+// The topology of the last CCH customization if it is newer than the partition and still has
+// an arc for every edge of the graph
+CCHTopology LoadOrBuildCCHTopology(const CustomizationConfig &config,
+                                   const partition::MultiLevelPartition &mlp,
+                                   const MultiLevelEdgeBasedGraph &graph)
+{
+    if (boost::filesystem::exists(config.cch_topology_path) &&
+        boost::filesystem::last_write_time(config.cch_topology_path) >=
+            boost::filesystem::last_write_time(config.mld_partition_path))
+    {
+        CCHTopology topology;
+        files::readCCHTopology(config.cch_topology_path, topology);
+        if (topology.GetNumberOfNodes() == graph.GetNumberOfNodes() && topology.Covers(graph))
+        {
+            util::Log() << "Reusing the CCH topology of the last customization";
+            return topology;
+        }
+        util::Log() << "Graph is not covered by the last CCH topology, rebuilding it";
+    }
+
+    TIMER_START(cch_topology);
+    util::PerfStage cch_topology_stage("cch_topology");
+    CCHTopology topology(mlp, graph);
+    cch_topology_stage.Stop();
+    TIMER_STOP(cch_topology);
+    util::Log() << "CCH topology with " << topology.GetNumberOfArcs() << " arcs took "
+                << TIMER_SEC(cch_topology) << " seconds";
+
+    files::writeCCHTopology(config.cch_topology_path, topology);
+    return topology;
+}
+
 int Customizer::Run(const CustomizationConfig &config)
 {
     TIMER_START(loading_data);
+    util::PerfStage loading_data_stage("loading_data");
 
     partition::MultiLevelPartition mlp;
     partition::files::readPartition(config.mld_partition_path, mlp);
 
-    auto edge_based_graph = LoadAndUpdateEdgeExpandedGraph(config, mlp);
+    auto edge_based_graph = LoadAndUpdateEdgeExpandedGraph(config.updater_config, mlp);
 
     partition::CellStorage storage;
     partition::files::readCells(config.mld_storage_path, storage);
+    loading_data_stage.Stop();
     TIMER_STOP(loading_data);
     util::Log() << "Loading partition data took " << TIMER_SEC(loading_data) << " seconds";
 
+    // the default metric is only named if there are others to choose from
+    std::vector<std::string> metric_names;
+    if (!config.metrics.empty())
+    {
+        metric_names.push_back("default");
+        for (const auto &metric : config.metrics)
+        {
+            if (std::find(metric_names.begin(), metric_names.end(), metric.name) !=
+                metric_names.end())
+            {
+                throw util::exception("Metric " + metric.name + " is given more than once" +
+                                      SOURCE_REF);
+            }
+            metric_names.push_back(metric.name);
+        }
+    }
+
+    const auto previous_graph =
+        config.incremental ? LoadPreviousGraph(config, storage, metric_names) : nullptr;
+    const auto changed_cells = [&](const MultiLevelEdgeBasedGraph &graph, std::size_t metric) {
+        if (!previous_graph)
+            return std::vector<std::vector<bool>>{};
+
+        auto cells = CellCustomizer(mlp).GetChangedCells(graph, *previous_graph, metric);
+        if (cells.empty())
+        {
+            util::Log() << "Graph differs from the last customization, customizing all cells";
+        }
+        return cells;
+    };
+
+    // all cells are overwritten by a full customization, existing values of the same metrics
+    // are only kept for an incremental one
+    if (storage.GetMetricNames() != metric_names)
+    {
+        storage.SetMetrics(metric_names);
+    }
+
     TIMER_START(cell_customize);
+    util::PerfStage cell_customize_stage("cell_customize");
     CellCustomizer customizer(mlp);
-    customizer.Customize(*edge_based_graph, storage);
+    customizer.Customize(*edge_based_graph, storage, 0, changed_cells(*edge_based_graph, 0));
+    cell_customize_stage.Stop();
     TIMER_STOP(cell_customize);
     util::Log() << "Cells customization took " << TIMER_SEC(cell_customize) << " seconds";
 
+    if (config.cch)
+    {
+        const auto topology = LoadOrBuildCCHTopology(config, mlp, *edge_based_graph);
+
+        TIMER_START(cch_customize);
+        util::PerfStage cch_customize_stage("cch_customize");
+        const auto hierarchy = topology.Customize(*edge_based_graph);
+        cch_customize_stage.Stop();
+        TIMER_STOP(cch_customize);
+        util::Log() << "CCH customization took " << TIMER_SEC(cch_customize) << " seconds";
+
+        TIMER_START(writing_cch_graph);
+        util::PerfStage writing_cch_graph_stage("writing_cch_graph");
+        // the checksum identifies the topology, the weights change with every customization
+        contractor::RangebasedCRC32 crc32_calculator;
+        const unsigned checksum = crc32_calculator(topology.GetUpTargets());
+        contractor::files::writeGraph(config.cch_graph_path, checksum, hierarchy);
+        writing_cch_graph_stage.Stop();
+        TIMER_STOP(writing_cch_graph);
+        util::Log() << "CCH graph writing took " << TIMER_SEC(writing_cch_graph) << " seconds";
+    }
+
+    if (config.overlay_hierarchy)
+    {
+        TIMER_START(overlay_hierarchy);
+        util::PerfStage overlay_hierarchy_stage("overlay_hierarchy");
+        const auto hierarchy = buildOverlayHierarchy(mlp, storage, *edge_based_graph);
+        files::writeOverlayHierarchy(config.mld_overlay_hierarchy_path, hierarchy);
+        overlay_hierarchy_stage.Stop();
+        TIMER_STOP(overlay_hierarchy);
+        util::Log() << "Overlay hierarchy with " << hierarchy.GetNumberOfNodes() << " nodes and "
+                    << hierarchy.GetNumberOfArcs() << " arcs took " << TIMER_SEC(overlay_hierarchy)
+                    << " seconds";
+    }
+    else if (boost::filesystem::exists(config.mld_overlay_hierarchy_path))
+    {
+        // a hierarchy of older cells would give wrong routes
+        boost::filesystem::remove(config.mld_overlay_hierarchy_path);
+    }
+
+    if (config.landmarks > 0)
+    {
+        TIMER_START(landmarks);
+        util::PerfStage landmarks_stage("landmarks");
+        std::vector<util::LandmarkArc> arcs;
+        for (const auto node : util::irange<NodeID>(0, edge_based_graph->GetNumberOfNodes()))
+        {
+            for (const auto edge : edge_based_graph->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = edge_based_graph->GetEdgeData(edge);
+                if (data.forward)
+                    arcs.push_back({node, edge_based_graph->GetTarget(edge), data.weight});
+            }
+        }
+        const auto landmarks =
+            util::buildLandmarks(edge_based_graph->GetNumberOfNodes(), arcs, config.landmarks);
+        contractor::files::writeLandmarks(config.landmarks_path, landmarks);
+        landmarks_stage.Stop();
+        TIMER_STOP(landmarks);
+        util::Log() << "Selecting " << landmarks.GetNumberOfLandmarks() << " landmarks took "
+                    << TIMER_SEC(landmarks) << " seconds";
+    }
+    else if (boost::filesystem::exists(config.landmarks_path))
+    {
+        // landmarks of older weights might overestimate and give wrong routes
+        boost::filesystem::remove(config.landmarks_path);
+    }
+
+    if (config.distance_oracle_level > 0)
+    {
+        if (config.distance_oracle_level >= mlp.GetNumberOfLevels())
+        {
+            throw util::exception("The partition has no level " +
+                                  std::to_string(config.distance_oracle_level) +
+                                  " for the distance oracle" + SOURCE_REF);
+        }
+
+        TIMER_START(distance_oracle);
+        util::PerfStage distance_oracle_stage("distance_oracle");
+        std::vector<util::DistanceOracleArc> arcs;
+        std::vector<CellID> cells(edge_based_graph->GetNumberOfNodes());
+        for (const auto node : util::irange<NodeID>(0, edge_based_graph->GetNumberOfNodes()))
+        {
+            cells[node] = mlp.GetCell(config.distance_oracle_level, node);
+            for (const auto edge : edge_based_graph->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = edge_based_graph->GetEdgeData(edge);
+                if (data.forward)
+                    arcs.push_back({node, edge_based_graph->GetTarget(edge), data.duration});
+            }
+        }
+        const auto oracle = util::buildDistanceOracle(
+            arcs, cells, mlp.GetNumberOfCells(config.distance_oracle_level));
+        files::writeDistanceOracle(config.distance_oracle_path, oracle);
+        distance_oracle_stage.Stop();
+        TIMER_STOP(distance_oracle);
+        util::Log() << "Distance oracle of " << oracle.GetNumberOfCells() << " cells took "
+                    << TIMER_SEC(distance_oracle) << " seconds";
+    }
+    else if (boost::filesystem::exists(config.distance_oracle_path))
+    {
+        // an oracle of older durations could approximate beyond its error bound
+        boost::filesystem::remove(config.distance_oracle_path);
+    }
+
+    const auto &conditional_turn_masks_path = config.updater_config.conditional_turn_masks_path;
+    if (config.updater_config.conditional_turns_at_query_time)
+    {
+        util::PerfStage conditional_turns_stage("conditional_turns");
+        const auto masks = updater::Updater(config.updater_config).LoadConditionalTurnMasks();
+        extractor::files::writeConditionalTurnMasks(conditional_turn_masks_path, masks);
+    }
+    else if (boost::filesystem::exists(conditional_turn_masks_path))
+    {
+        // the weights restrict the turns of the time of this update, the queries must not
+        // restrict the ones of other times on top of them
+        boost::filesystem::remove(conditional_turn_masks_path);
+    }
+
+    for (const auto metric : util::irange<std::size_t>(0, config.metrics.size()))
+    {
+        TIMER_START(metric_customize);
+        util::PerfStage metric_customize_stage("metric_customize");
+        // the metric starts from the segment data the default metric updated, which is not
+        // touched again so the dataset itself stays the default metric
+        auto metric_updater_config = config.updater_config;
+        metric_updater_config.segment_speed_lookup_paths =
+            config.metrics[metric].segment_speed_lookup_paths;
+        metric_updater_config.speed_profile_lookup_paths =
+            config.metrics[metric].speed_profile_lookup_paths;
+        metric_updater_config.profile_minute = config.metrics[metric].profile_minute;
+        metric_updater_config.turn_penalty_lookup_paths.clear();
+        metric_updater_config.way_speed_lookup_paths.clear();
+        metric_updater_config.valid_now = 0;
+        metric_updater_config.save_updated_data = false;
+
+        const auto metric_graph = LoadAndUpdateEdgeExpandedGraph(metric_updater_config, mlp);
+        customizer.Customize(
+            *metric_graph, storage, metric + 1, changed_cells(*metric_graph, metric + 1));
+        edge_based_graph->AppendMetric(*metric_graph);
+        metric_customize_stage.Stop();
+        TIMER_STOP(metric_customize);
+        util::Log() << "Customization of metric " << config.metrics[metric].name << " took "
+                    << TIMER_SEC(metric_customize) << " seconds";
+    }
+
     TIMER_START(writing_mld_data);
+    util::PerfStage writing_mld_data_stage("writing_mld_data");
     partition::files::writeCells(config.mld_storage_path, storage);
+    writing_mld_data_stage.Stop();
     TIMER_STOP(writing_mld_data);
     util::Log() << "MLD customization writing took " << TIMER_SEC(writing_mld_data) << " seconds";
 
     TIMER_START(writing_graph);
+    util::PerfStage writing_graph_stage("writing_graph");
     partition::files::writeGraph(config.mld_graph_path, *edge_based_graph);
+    writing_graph_stage.Stop();
     TIMER_STOP(writing_graph);
     util::Log() << "Graph writing took " << TIMER_SEC(writing_graph) << " seconds";
 
@@ -0,0 +1,293 @@
+#include "customizer/overlay_hierarchy.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+
+namespace
+{
+// Witness searches give up after settling this many nodes and keep the shortcut
+const constexpr std::size_t WITNESS_SEARCH_SETTLED_LIMIT = 500;
+
+struct ContractionArc
+{
+    EdgeWeight weight;
+    NodeID middle;
+};
+
+using Adjacency = std::unordered_map<NodeID, ContractionArc>;
+
+// Parallel arcs are merged into the shorter one
+void insertArc(Adjacency &arcs, const NodeID target, const ContractionArc &arc)
+{
+    const auto iter = arcs.find(target);
+    if (iter == arcs.end())
+        arcs.emplace(target, arc);
+    else if (arc.weight < iter->second.weight)
+        iter->second = arc;
+}
+
+struct Shortcut
+{
+    NodeID source;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+// Contracts the nodes of a small graph in the order of their edge difference, which is updated
+// lazily: a node is only contracted if its recomputed priority is still the smallest one.
+class OverlayContraction
+{
+  public:
+    explicit OverlayContraction(const std::size_t number_of_nodes)
+        : forward(number_of_nodes), backward(number_of_nodes), out_arcs(number_of_nodes),
+          in_arcs(number_of_nodes), contracted(number_of_nodes, false),
+          contracted_neighbours(number_of_nodes, 0)
+    {
+    }
+
+    void InsertArc(const NodeID source, const NodeID target, const EdgeWeight weight)
+    {
+        BOOST_ASSERT(source != target);
+        insertArc(out_arcs[source], target, {weight, SPECIAL_NODEID});
+        insertArc(in_arcs[target], source, {weight, SPECIAL_NODEID});
+    }
+
+    void Run()
+    {
+        using QueueEntry = std::pair<int, NodeID>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        for (const auto node : util::irange<NodeID>(0, out_arcs.size()))
+            queue.emplace(GetPriority(node, GetShortcuts(node)), node);
+
+        while (!queue.empty())
+        {
+            const auto node = queue.top().second;
+            queue.pop();
+
+            auto shortcuts = GetShortcuts(node);
+            const auto priority = GetPriority(node, shortcuts);
+            if (!queue.empty() && priority > queue.top().first)
+            {
+                queue.emplace(priority, node);
+                continue;
+            }
+            Contract(node, shortcuts);
+        }
+    }
+
+    // Arcs to higher ranked nodes of every node, sorted by their other end
+    std::vector<std::vector<OverlayHierarchy::Arc>> forward;
+    std::vector<std::vector<OverlayHierarchy::Arc>> backward;
+
+  private:
+    int GetPriority(const NodeID node, const std::vector<Shortcut> &shortcuts) const
+    {
+        return static_cast<int>(shortcuts.size()) - static_cast<int>(out_arcs[node].size()) -
+               static_cast<int>(in_arcs[node].size()) + contracted_neighbours[node];
+    }
+
+    // Arcs between the neighbours of the node that have no path of the same weight without it
+    std::vector<Shortcut> GetShortcuts(const NodeID node) const
+    {
+        std::vector<Shortcut> shortcuts;
+        for (const auto &in_arc : in_arcs[node])
+        {
+            const auto source = in_arc.first;
+            EdgeWeight max_out_weight = 0;
+            for (const auto &out_arc : out_arcs[node])
+                if (out_arc.first != source)
+                    max_out_weight = std::max(max_out_weight, out_arc.second.weight);
+
+            const auto max_weight = in_arc.second.weight + max_out_weight;
+
+            const auto distances = WitnessSearch(source, node, max_weight);
+            for (const auto &out_arc : out_arcs[node])
+            {
+                const auto target = out_arc.first;
+                if (target == source)
+                    continue;
+
+                const auto weight = in_arc.second.weight + out_arc.second.weight;
+                const auto witness = distances.find(target);
+                if (witness == distances.end() || witness->second > weight)
+                    shortcuts.push_back({source, target, weight});
+            }
+        }
+        return shortcuts;
+    }
+
+    // Distances of the nodes settled by a Dijkstra search from the source that avoids a node
+    std::unordered_map<NodeID, EdgeWeight>
+    WitnessSearch(const NodeID source, const NodeID avoided, const EdgeWeight max_weight) const
+    {
+        using QueueEntry = std::pair<EdgeWeight, NodeID>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        std::unordered_map<NodeID, EdgeWeight> tentative{{source, 0}};
+        std::unordered_map<NodeID, EdgeWeight> settled;
+
+        queue.emplace(0, source);
+        while (!queue.empty() && settled.size() < WITNESS_SEARCH_SETTLED_LIMIT)
+        {
+            EdgeWeight weight;
+            NodeID node;
+            std::tie(weight, node) = queue.top();
+            queue.pop();
+            if (weight > max_weight)
+                break;
+            if (!settled.emplace(node, weight).second)
+                continue;
+
+            for (const auto &arc : out_arcs[node])
+            {
+                if (arc.first == avoided)
+                    continue;
+                const auto to_weight = weight + arc.second.weight;
+                const auto iter = tentative.find(arc.first);
+                if (iter == tentative.end() || to_weight < iter->second)
+                {
+                    tentative[arc.first] = to_weight;
+                    queue.emplace(to_weight, arc.first);
+                }
+            }
+        }
+        return settled;
+    }
+
+    void Contract(const NodeID node, const std::vector<Shortcut> &shortcuts)
+    {
+        BOOST_ASSERT(!contracted[node]);
+        contracted[node] = true;
+
+        const auto by_target = [](const OverlayHierarchy::Arc &lhs,
+                                  const OverlayHierarchy::Arc &rhs) {
+            return lhs.target < rhs.target;
+        };
+        for (const auto &arc : out_arcs[node])
+        {
+            forward[node].push_back({arc.first, arc.second.weight, arc.second.middle});
+            in_arcs[arc.first].erase(node);
+            ++contracted_neighbours[arc.first];
+        }
+        for (const auto &arc : in_arcs[node])
+        {
+            backward[node].push_back({arc.first, arc.second.weight, arc.second.middle});
+            out_arcs[arc.first].erase(node);
+            ++contracted_neighbours[arc.first];
+        }
+        std::sort(forward[node].begin(), forward[node].end(), by_target);
+        std::sort(backward[node].begin(), backward[node].end(), by_target);
+        Adjacency().swap(out_arcs[node]);
+        Adjacency().swap(in_arcs[node]);
+
+        for (const auto &shortcut : shortcuts)
+        {
+            insertArc(out_arcs[shortcut.source], shortcut.target, {shortcut.weight, node});
+            insertArc(in_arcs[shortcut.target], shortcut.source, {shortcut.weight, node});
+        }
+    }
+
+    // arcs between the nodes that are not contracted yet
+    std::vector<Adjacency> out_arcs;
+    std::vector<Adjacency> in_arcs;
+
+    std::vector<bool> contracted;
+    std::vector<int> contracted_neighbours;
+};
+
+template <typename Arcs>
+void flatten(const Arcs &arcs_of_nodes,
+             std::vector<std::uint64_t> &offsets,
+             std::vector<OverlayHierarchy::Arc> &arcs)
+{
+    offsets.reserve(arcs_of_nodes.size() + 1);
+    offsets.push_back(0);
+    for (const auto &node_arcs : arcs_of_nodes)
+    {
+        arcs.insert(arcs.end(), node_arcs.begin(), node_arcs.end());
+        offsets.push_back(arcs.size());
+    }
+}
+}
+
+OverlayHierarchy buildOverlayHierarchy(const partition::MultiLevelPartition &partition,
+                                       const partition::CellStorage &storage,
+                                       const MultiLevelEdgeBasedGraph &graph)
+{
+    if (partition.GetNumberOfLevels() < 2)
+        return OverlayHierarchy{};
+
+    const LevelID level = partition.GetNumberOfLevels() - 1;
+    const auto number_of_cells = partition.GetNumberOfCells(level);
+
+    std::vector<NodeID> nodes;
+    for (const auto cell_id : util::irange<CellID>(0, number_of_cells))
+    {
+        const auto cell = storage.GetCell(level, cell_id);
+        nodes.insert(nodes.end(), cell.GetSourceNodes().begin(), cell.GetSourceNodes().end());
+        nodes.insert(
+            nodes.end(), cell.GetDestinationNodes().begin(), cell.GetDestinationNodes().end());
+    }
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    const auto overlay_node = [&nodes](const NodeID node) {
+        const auto iter = std::lower_bound(nodes.begin(), nodes.end(), node);
+        BOOST_ASSERT(iter != nodes.end() && *iter == node);
+        return static_cast<NodeID>(std::distance(nodes.begin(), iter));
+    };
+
+    OverlayContraction contraction(nodes.size());
+    for (const auto cell_id : util::irange<CellID>(0, number_of_cells))
+    {
+        const auto cell = storage.GetCell(level, cell_id);
+        for (const auto source : cell.GetSourceNodes())
+        {
+            auto destination = cell.GetDestinationNodes().begin();
+            for (const auto weight : cell.GetOutWeight(source))
+            {
+                BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
+                if (weight != INVALID_EDGE_WEIGHT && source != *destination)
+                    contraction.InsertArc(overlay_node(source), overlay_node(*destination), weight);
+                ++destination;
+            }
+        }
+    }
+    for (const auto node : util::irange<NodeID>(0, nodes.size()))
+    {
+        for (const auto edge : graph.GetBorderEdgeRange(level, nodes[node]))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            if (data.forward)
+                contraction.InsertArc(node, overlay_node(graph.GetTarget(edge)), data.weight);
+        }
+    }
+
+    contraction.Run();
+
+    std::vector<std::uint64_t> forward_offsets, backward_offsets;
+    std::vector<OverlayHierarchy::Arc> forward_arcs, backward_arcs;
+    flatten(contraction.forward, forward_offsets, forward_arcs);
+    flatten(contraction.backward, backward_offsets, backward_arcs);
+
+    return OverlayHierarchy{std::move(nodes),
+                            std::move(forward_offsets),
+                            std::move(forward_arcs),
+                            std::move(backward_offsets),
+                            std::move(backward_arcs)};
+}
+}
+}
@@ -0,0 +1,42 @@
+#include "engine/async_executor.hpp"
+
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+AsyncExecutor::AsyncExecutor(const int concurrency)
+    // no thread joins the arena to run its tasks, so none of its slots are reserved for one
+    : arena(concurrency == -1 ? tbb::task_arena::automatic : concurrency, 0)
+{
+}
+
+AsyncExecutor::~AsyncExecutor() { Wait(); }
+
+void AsyncExecutor::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> guard(pending_lock);
+        ++pending;
+    }
+
+    arena.enqueue([this, task = std::move(task)] {
+        task();
+
+        std::lock_guard<std::mutex> guard(pending_lock);
+        if (--pending == 0)
+        {
+            all_finished.notify_all();
+        }
+    });
+}
+
+void AsyncExecutor::Wait()
+{
+    std::unique_lock<std::mutex> lock(pending_lock);
+    all_finished.wait(lock, [this] { return pending == 0; });
+}
+}
+}
@@ -0,0 +1,59 @@
+#include "engine/conditional_turns.hpp"
+
+#include "util/integer_range.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+const ActiveConditionalTurns *&currentConditionalTurns()
+{
+    thread_local const ActiveConditionalTurns *current = nullptr;
+    return current;
+}
+}
+
+ActiveConditionalTurns::ActiveConditionalTurns(const extractor::ConditionalTurnMasksView &masks,
+                                               const partition::MultiLevelPartitionView &partition,
+                                               const std::uint32_t minute_of_week)
+    : restricted_cells(partition.GetNumberOfLevels())
+{
+    for (const auto index : util::irange<std::size_t>(0, masks.GetNumberOfTurns()))
+    {
+        if (!masks.IsRestricted(index, minute_of_week))
+            continue;
+
+        // the turns are sorted already
+        turns.push_back(masks.GetTurnID(index));
+        const auto source = masks.GetSource(index);
+        const auto target = masks.GetTarget(index);
+        for (const auto level : util::irange<LevelID>(1, partition.GetNumberOfLevels()))
+        {
+            const auto cell = partition.GetCell(level, source);
+            if (cell == partition.GetCell(level, target))
+                restricted_cells[level].push_back(cell);
+        }
+    }
+
+    for (auto &cells : restricted_cells)
+    {
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    }
+}
+
+ScopedConditionalTurns::ScopedConditionalTurns(const ActiveConditionalTurns *conditional_turns)
+    : previous(currentConditionalTurns())
+{
+    currentConditionalTurns() =
+        conditional_turns && !conditional_turns->Empty() ? conditional_turns : nullptr;
+}
+
+ScopedConditionalTurns::~ScopedConditionalTurns() { currentConditionalTurns() = previous; }
+
+const ActiveConditionalTurns *CurrentConditionalTurns() { return currentConditionalTurns(); }
+}
+}
@@ -0,0 +1,83 @@
+#include "engine/data_memory.hpp"
+
+#include "storage/block_memory.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+DataMemoryMetrics &DataMemoryMetrics::GetInstance()
+{
+    static DataMemoryMetrics metrics;
+    return metrics;
+}
+
+void DataMemoryMetrics::Register(
+    const std::string &dataset_name,
+    const unsigned replica,
+    const std::shared_ptr<datafacade::ContiguousBlockAllocator> &allocator)
+{
+    storage::logBlockMemory(storage::getBlockMemory(allocator->GetLayout(), allocator->GetMemory()),
+                            dataset_name);
+
+    std::lock_guard<std::mutex> guard(datasets_lock);
+    datasets.erase(std::remove_if(datasets.begin(),
+                                  datasets.end(),
+                                  [&](const Dataset &dataset) {
+                                      return dataset.allocator.expired() ||
+                                             (dataset.name == dataset_name &&
+                                              dataset.replica == replica);
+                                  }),
+                   datasets.end());
+    datasets.push_back({dataset_name, replica, allocator});
+}
+
+std::string DataMemoryMetrics::DumpPrometheus() const
+{
+    std::vector<std::pair<Dataset, std::shared_ptr<datafacade::ContiguousBlockAllocator>>> alive;
+    {
+        std::lock_guard<std::mutex> guard(datasets_lock);
+        for (const auto &dataset : datasets)
+        {
+            if (auto allocator = dataset.allocator.lock())
+                alive.emplace_back(dataset, std::move(allocator));
+        }
+    }
+
+    // measured outside of the lock, the references keep the memory mapped meanwhile
+    std::vector<std::vector<storage::BlockMemory>> blocks;
+    for (const auto &dataset : alive)
+    {
+        blocks.push_back(storage::getBlockMemory(dataset.second->GetLayout(),
+                                                 dataset.second->GetMemory()));
+    }
+
+    std::stringstream out;
+    const auto dump = [&](const char *metric, const char *help, const bool resident) {
+        out << "# HELP " << metric << " " << help << "\n";
+        out << "# TYPE " << metric << " gauge\n";
+        for (const auto index : util::irange<std::size_t>(0, alive.size()))
+        {
+            for (const auto &block : blocks[index])
+            {
+                out << metric << "{dataset=\"" << alive[index].first.name << "\",replica=\""
+                    << alive[index].first.replica << "\",block=\""
+                    << storage::block_id_to_name[block.id] << "\",source=\""
+                    << (block.external ? "file" : "memory") << "\"} "
+                    << (resident ? block.resident_bytes : block.bytes) << "\n";
+            }
+        }
+    };
+    dump("osrm_data_block_bytes", "Bytes of a block of the data that are mapped.", false);
+    dump("osrm_data_block_resident_bytes", "Bytes of a block of the data that are in RAM.", true);
+    return out.str();
+}
+}
+}
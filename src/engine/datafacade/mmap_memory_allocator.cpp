@@ -0,0 +1,75 @@
+#include "engine/datafacade/mmap_memory_allocator.hpp"
+#include "storage/dataset_image.hpp"
+#include "storage/storage.hpp"
+#include "util/compressed_file.hpp"
+#include "util/log.hpp"
+#include "util/mmap_file.hpp"
+
+#include "boost/assert.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+MMapMemoryAllocator::MMapMemoryAllocator(const storage::StorageConfig &config)
+{
+    storage::Storage storage(config);
+
+    internal_layout = std::make_unique<storage::DataLayout>();
+    storage.PopulateLayout(*internal_layout);
+
+    // The memory block of an image is used from the mapping as is
+    if (config.use_image && !util::IsCompressedFile(config.image_path))
+    {
+        auto &mapped_image =
+            mapped_files.emplace(config.image_path, boost::iostreams::mapped_file_source())
+                .first->second;
+        util::mmapFile<char>(config.image_path, mapped_image);
+        // the facades only read from the memory block
+        memory = const_cast<char *>(mapped_image.data()) + storage::IMAGE_DATA_OFFSET;
+        storage::checkImageMemory(config.image_path, *internal_layout, memory);
+
+        util::Log() << "Mapped " << internal_layout->GetSizeOfLayout() << " bytes of "
+                    << config.image_path.string();
+        return;
+    }
+
+    // Point the blocks stored verbatim into the mappings of their files
+    std::uint64_t mapped_size = 0;
+    for (const auto &block : storage.PopulateFileBlocks(*internal_layout))
+    {
+        auto mapped_file = mapped_files.find(block.path);
+        if (mapped_file == mapped_files.end())
+        {
+            mapped_file = mapped_files.emplace(block.path, boost::iostreams::mapped_file_source())
+                              .first;
+            util::mmapFile<char>(block.path, mapped_file->second);
+        }
+        BOOST_ASSERT(block.offset + internal_layout->GetBlockSize(block.id) <=
+                     mapped_file->second.size());
+
+        internal_layout->SetExternalBlock(block.id, mapped_file->second.data() + block.offset);
+        mapped_size += internal_layout->GetBlockSize(block.id);
+    }
+
+    // Only the remaining blocks are loaded into memory
+    const auto memory_size = internal_layout->GetSizeOfLayout();
+    internal_memory = std::make_unique<char[]>(memory_size);
+    memory = internal_memory.get();
+    storage.PopulateData(*internal_layout, memory);
+
+    util::Log() << "Mapped " << mapped_size << " bytes of " << mapped_files.size()
+                << " files, loaded " << memory_size << " bytes into memory";
+}
+
+MMapMemoryAllocator::~MMapMemoryAllocator() {}
+
+storage::DataLayout &MMapMemoryAllocator::GetLayout() { return *internal_layout.get(); }
+char *MMapMemoryAllocator::GetMemory() { return memory; }
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -1,5 +1,6 @@
 #include "engine/datafacade/process_memory_allocator.hpp"
 #include "storage/storage.hpp"
+#include "util/log.hpp"
 
 #include "boost/assert.hpp"
 
@@ -10,7 +11,8 @@ namespace engine
 namespace datafacade
 {
 
-ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &config)
+ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &config,
+                                               const bool use_huge_pages)
 {
     storage::Storage storage(config);
 
@@ -19,14 +21,20 @@ ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &con
     storage.PopulateLayout(*internal_layout);
 
     // Allocate the memory block, then load data from files into it
-    internal_memory = std::make_unique<char[]>(internal_layout->GetSizeOfLayout());
-    storage.PopulateData(*internal_layout, internal_memory.get());
+    internal_memory = std::make_unique<util::HugePageMemory>(internal_layout->GetSizeOfLayout(),
+                                                             use_huge_pages);
+    if (use_huge_pages)
+    {
+        util::Log() << "Memory of " << internal_layout->GetSizeOfLayout() << " bytes is backed by "
+                    << util::ToString(internal_memory->GetHugePages());
+    }
+    storage.PopulateData(*internal_layout, internal_memory->Get());
 }
 
 ProcessMemoryAllocator::~ProcessMemoryAllocator() {}
 
 storage::DataLayout &ProcessMemoryAllocator::GetLayout() { return *internal_layout.get(); }
-char *ProcessMemoryAllocator::GetMemory() { return internal_memory.get(); }
+char *ProcessMemoryAllocator::GetMemory() { return internal_memory->Get(); }
 
 } // namespace datafacade
 } // namespace engine
@@ -10,12 +10,16 @@ namespace engine
 namespace datafacade
 {
 
-SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region)
+SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region,
+                                             const unsigned replica,
+                                             const std::string &dataset_name)
 {
-    util::Log(logDEBUG) << "Loading new data for region " << regionToString(data_region);
+    util::Log(logDEBUG) << "Loading new data for region " << regionToString(data_region)
+                        << " (copy " << replica << ")";
 
-    BOOST_ASSERT(storage::SharedMemory::RegionExists(data_region));
-    m_large_memory = storage::makeSharedMemory(data_region);
+    const auto id = storage::getReplicaID(data_region, replica);
+    BOOST_ASSERT(storage::SharedMemory::RegionExists(id, dataset_name));
+    m_large_memory = storage::makeSharedMemory(id, 0, false, dataset_name);
 }
 
 SharedMemoryAllocator::~SharedMemoryAllocator() {}
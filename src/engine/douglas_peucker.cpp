@@ -1,6 +1,5 @@
 #include "engine/douglas_peucker.hpp"
 #include "util/coordinate.hpp"
-#include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/web_mercator.hpp"
 
@@ -9,7 +8,8 @@
 #include <algorithm>
 #include <cmath>
 #include <iterator>
-#include <stack>
+#include <limits>
+#include <tuple>
 #include <utility>
 
 namespace osrm
@@ -17,18 +17,79 @@ namespace osrm
 namespace engine
 {
 
-// Normed to the thresholds table
-std::uint64_t fastPerpendicularDistance(const util::FloatCoordinate &projected_start,
-                                        const util::FloatCoordinate &projected_target,
-                                        const util::FloatCoordinate &projected)
+namespace
 {
-    util::FloatCoordinate projected_point_on_segment;
-    std::tie(std::ignore, projected_point_on_segment) =
-        util::coordinate_calculation::projectPointOnSegment(
-            projected_start, projected_target, projected);
-    auto squared_distance = util::coordinate_calculation::squaredEuclideanDistance(
-        projected, projected_point_on_segment);
-    return squared_distance;
+// The projected coordinates as separate arrays, so the distances to a segment are computed in one
+// branch-free loop over contiguous values that the compiler can vectorise
+struct ProjectedGeometry
+{
+    explicit ProjectedGeometry(const std::size_t size)
+        : lons(size), lats(size), fixed_lons(size), fixed_lats(size)
+    {
+    }
+
+    std::vector<double> lons;
+    std::vector<double> lats;
+    // the thresholds are normed to the fixed precision of the projected coordinates
+    std::vector<std::int64_t> fixed_lons;
+    std::vector<std::int64_t> fixed_lats;
+};
+
+std::int64_t toFixedPrecision(const double value)
+{
+    return static_cast<std::int64_t>(std::round(value * COORDINATE_PRECISION));
+}
+
+// Finds the coordinate between first and last farthest from the segment connecting them. Computes
+// the same squared distances as projecting with projectPointOnSegment and comparing with
+// squaredEuclideanDistance. Returns last if no coordinate is farther than the threshold.
+std::pair<std::size_t, std::uint64_t> findFarthest(const ProjectedGeometry &geometry,
+                                                   const std::size_t first,
+                                                   const std::size_t last,
+                                                   const std::uint64_t threshold)
+{
+    const auto *const lons = geometry.lons.data();
+    const auto *const lats = geometry.lats.data();
+    const auto *const fixed_lons = geometry.fixed_lons.data();
+    const auto *const fixed_lats = geometry.fixed_lats.data();
+
+    const auto source_lon = lons[first];
+    const auto source_lat = lats[first];
+    const auto target_lon = lons[last];
+    const auto target_lat = lats[last];
+    const auto slope_lon = target_lon - source_lon;
+    const auto slope_lat = target_lat - source_lat;
+    const auto squared_length = slope_lon * slope_lon + slope_lat * slope_lat;
+    // all coordinates project onto the source of a degenerated segment
+    const auto has_length = squared_length >= std::numeric_limits<double>::epsilon();
+
+    std::uint64_t max_distance = 0;
+    auto farthest_index = last;
+    for (auto idx = first + 1; idx < last; ++idx)
+    {
+        const auto unnormed_ratio =
+            slope_lon * (lons[idx] - source_lon) + slope_lat * (lats[idx] - source_lat);
+        const auto normed_ratio = has_length ? unnormed_ratio / squared_length : 0.;
+        const auto ratio = std::min(std::max(normed_ratio, 0.), 1.);
+
+        const auto projected_lon =
+            toFixedPrecision((1.0 - ratio) * source_lon + target_lon * ratio);
+        const auto projected_lat =
+            toFixedPrecision((1.0 - ratio) * source_lat + target_lat * ratio);
+        const auto d_lon = fixed_lons[idx] - projected_lon;
+        const auto d_lat = fixed_lats[idx] - projected_lat;
+        const auto distance = static_cast<std::uint64_t>(d_lon * d_lon + d_lat * d_lat);
+
+        // found new feasible maximum?
+        if (distance > max_distance && distance > threshold)
+        {
+            farthest_index = idx;
+            max_distance = distance;
+        }
+    }
+
+    return {farthest_index, max_distance};
+}
 }
 
 std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::const_iterator begin,
@@ -44,10 +105,15 @@ std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::cons
         return {};
     }
 
-    std::vector<util::FloatCoordinate> projected_coordinates(size);
-    std::transform(begin, end, projected_coordinates.begin(), [](const util::Coordinate coord) {
-        return util::web_mercator::fromWGS84(coord);
-    });
+    ProjectedGeometry projected_geometry(size);
+    for (auto idx : util::irange<std::size_t>(0UL, size))
+    {
+        const auto projected = util::web_mercator::fromWGS84(begin[idx]);
+        projected_geometry.lons[idx] = static_cast<double>(projected.lon);
+        projected_geometry.lats[idx] = static_cast<double>(projected.lat);
+        projected_geometry.fixed_lons[idx] = toFixedPrecision(projected_geometry.lons[idx]);
+        projected_geometry.fixed_lats[idx] = toFixedPrecision(projected_geometry.lats[idx]);
+    }
 
     std::vector<bool> is_necessary(size, false);
     BOOST_ASSERT(is_necessary.size() >= 2);
@@ -55,53 +121,40 @@ std::vector<util::Coordinate> douglasPeucker(std::vector<util::Coordinate>::cons
     is_necessary.back() = true;
     using GeometryRange = std::pair<std::size_t, std::size_t>;
 
-    std::stack<GeometryRange> recursion_stack;
+    const auto threshold = detail::DOUGLAS_PEUCKER_THRESHOLDS[zoom_level];
+    std::vector<GeometryRange> recursion_stack;
 
-    recursion_stack.emplace(0UL, size - 1);
+    recursion_stack.emplace_back(0UL, size - 1);
 
     // mark locations as 'necessary' by divide-and-conquer
     while (!recursion_stack.empty())
     {
         // pop next element
-        const GeometryRange pair = recursion_stack.top();
-        recursion_stack.pop();
+        const GeometryRange pair = recursion_stack.back();
+        recursion_stack.pop_back();
         // sanity checks
         BOOST_ASSERT_MSG(is_necessary[pair.first], "left border must be necessary");
         BOOST_ASSERT_MSG(is_necessary[pair.second], "right border must be necessary");
         BOOST_ASSERT_MSG(pair.second < size, "right border outside of geometry");
         BOOST_ASSERT_MSG(pair.first <= pair.second, "left border on the wrong side");
 
-        std::uint64_t max_distance = 0;
-        auto farthest_entry_index = pair.second;
-
-        // sweep over range to find the maximum
-        for (auto idx = pair.first + 1; idx != pair.second; ++idx)
-        {
-            using namespace util::coordinate_calculation;
-            const auto distance = fastPerpendicularDistance(projected_coordinates[pair.first],
-                                                            projected_coordinates[pair.second],
-                                                            projected_coordinates[idx]);
-            // found new feasible maximum?
-            if (distance > max_distance &&
-                distance > detail::DOUGLAS_PEUCKER_THRESHOLDS[zoom_level])
-            {
-                farthest_entry_index = idx;
-                max_distance = distance;
-            }
-        }
+        std::size_t farthest_entry_index;
+        std::uint64_t max_distance;
+        std::tie(farthest_entry_index, max_distance) =
+            findFarthest(projected_geometry, pair.first, pair.second, threshold);
 
         // check if maximum violates a zoom level dependent threshold
-        if (max_distance > detail::DOUGLAS_PEUCKER_THRESHOLDS[zoom_level])
+        if (max_distance > threshold)
         {
             //  mark idx as necessary
             is_necessary[farthest_entry_index] = true;
             if (pair.first < farthest_entry_index)
             {
-                recursion_stack.emplace(pair.first, farthest_entry_index);
+                recursion_stack.emplace_back(pair.first, farthest_entry_index);
             }
             if (farthest_entry_index < pair.second)
             {
-                recursion_stack.emplace(farthest_entry_index, pair.second);
+                recursion_stack.emplace_back(farthest_entry_index, pair.second);
             }
         }
     }
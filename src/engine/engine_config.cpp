@@ -26,7 +26,19 @@ bool EngineConfig::IsValid() const
                               unlimited_or_more_than(max_locations_trip, 2) &&
                               unlimited_or_more_than(max_locations_viaroute, 2) &&
                               unlimited_or_more_than(max_results_nearest, 0) &&
-                              max_alternatives >= 0;
+                              unlimited_or_more_than(max_isochrone_duration, 0) &&
+                              unlimited_or_more_than(max_core_settled_nodes, 0) &&
+                              unlimited_or_more_than(max_query_time, 0) &&
+                              unlimited_or_more_than(max_heap_memory, -1) &&
+                              max_alternatives >= 0 && many_to_many_concurrency >= 1 &&
+                              match_concurrency >= 1 && alternatives_concurrency >= 1 &&
+                              leg_concurrency >= 1 && leg_concurrency_min_waypoints >= 2 &&
+                              (async_concurrency == -1 || async_concurrency >= 1) &&
+                              routing_cache_size >= 0 && snap_cache_size >= 0 &&
+                              shortcut_cache_size >= 0 && tile_cache_size >= 0 &&
+                              match_session_ttl >= 0 && warm_up_queries >= 0 &&
+                              trip_improvement_time >= 0 && trip_table_neighbours >= 0 &&
+                              storage::IsValidDatasetName(dataset_name);
 
     return ((use_shared_memory && all_path_are_empty) || storage_config.IsValid()) && limits_valid;
 }
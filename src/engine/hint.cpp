@@ -5,7 +5,6 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
-#include <iterator>
 #include <ostream>
 #include <tuple>
 
@@ -16,38 +15,43 @@ namespace engine
 
 bool Hint::IsValid(const util::Coordinate new_input_coordinates,
                    const datafacade::BaseDataFacade &facade) const
+{
+    return IsValid(new_input_coordinates, facade.GetCheckSum());
+}
+
+bool Hint::IsValid(const util::Coordinate new_input_coordinates,
+                   const std::uint32_t facade_checksum) const
 {
     auto is_same_input_coordinate = new_input_coordinates.lon == phantom.input_location.lon &&
                                     new_input_coordinates.lat == phantom.input_location.lat;
     // FIXME this does not use the number of nodes to validate the phantom because
     // GetNumberOfNodes()
     // depends on the graph which is algorithm dependent
-    return is_same_input_coordinate && phantom.IsValid() && facade.GetCheckSum() == data_checksum;
+    return facade_checksum == data_checksum && is_same_input_coordinate && phantom.IsValid();
 }
 
 std::string Hint::ToBase64() const
 {
-    auto base64 = encodeBase64Bytewise(*this);
-
-    // Make safe for usage as GET parameter in URLs
-    std::replace(begin(base64), end(base64), '+', '-');
-    std::replace(begin(base64), end(base64), '/', '_');
-
-    return base64;
+    // Safe for usage as GET parameter in URLs
+    return encodeBase64Bytewise(*this, Base64Alphabet::URL);
 }
 
 Hint Hint::FromBase64(const std::string &base64Hint)
 {
-    BOOST_ASSERT_MSG(base64Hint.size() == ENCODED_HINT_SIZE, "Hint has invalid size");
+    return FromBase64(base64Hint.data(), base64Hint.data() + base64Hint.size());
+}
 
-    // We need mutability but don't want to change the API
-    auto encoded = base64Hint;
+Hint Hint::FromBase64(const char *first, const char *last)
+{
+    BOOST_ASSERT_MSG(static_cast<std::size_t>(last - first) == ENCODED_HINT_SIZE,
+                     "Hint has invalid size");
 
-    // Reverses above encoding we need for GET parameters in URL
-    std::replace(begin(encoded), end(encoded), '-', '+');
-    std::replace(begin(encoded), end(encoded), '_', '/');
+    // The decoder reads the URL safe alphabet of above encoding as is
+    const auto size = std::min(static_cast<std::size_t>(last - first), ENCODED_HINT_SIZE);
 
-    return decodeBase64Bytewise<Hint>(encoded);
+    Hint hint;
+    decodeBase64(first, first + size, reinterpret_cast<unsigned char *>(&hint), sizeof(Hint));
+    return hint;
 }
 
 bool operator==(const Hint &lhs, const Hint &rhs)
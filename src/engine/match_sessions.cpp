@@ -0,0 +1,74 @@
+#include "engine/match_sessions.hpp"
+
+#include <boost/assert.hpp>
+
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+boost::optional<MatchSessions::Session>
+MatchSessions::Take(const unsigned epoch, const std::string &id, const Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    EvictExpired(now);
+
+    const auto iter = sessions.find(id);
+    if (iter == sessions.end())
+    {
+        return boost::none;
+    }
+
+    boost::optional<Session> session;
+    if (iter->second.epoch == epoch)
+    {
+        session = std::move(iter->second.session);
+    }
+    expiry_order.erase(iter->second.position);
+    sessions.erase(iter);
+    return session;
+}
+
+void MatchSessions::Put(const unsigned epoch,
+                        const std::string &id,
+                        Session session,
+                        const Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    EvictExpired(now);
+
+    const auto iter = sessions.find(id);
+    if (iter != sessions.end())
+    {
+        expiry_order.erase(iter->second.position);
+        sessions.erase(iter);
+    }
+
+    const auto position = expiry_order.insert(expiry_order.end(), id);
+    sessions.emplace(id, Entry{epoch, now + ttl, position, std::move(session)});
+}
+
+std::size_t MatchSessions::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return sessions.size();
+}
+
+void MatchSessions::EvictExpired(const Clock::time_point now)
+{
+    while (!expiry_order.empty())
+    {
+        const auto iter = sessions.find(expiry_order.front());
+        BOOST_ASSERT(iter != sessions.end());
+        if (iter->second.expires > now)
+        {
+            break;
+        }
+        sessions.erase(iter);
+        expiry_order.pop_front();
+    }
+}
+}
+}
@@ -0,0 +1,129 @@
+#include "engine/plugins/isochrone.hpp"
+
+#include "engine/api/isochrone_api.hpp"
+#include "engine/api/isochrone_parameters.hpp"
+#include "util/convex_hull.hpp"
+#include "util/integer_range.hpp"
+#include "util/request_timing.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace plugins
+{
+
+IsochronePlugin::IsochronePlugin(const int max_isochrone_duration)
+    : max_isochrone_duration(max_isochrone_duration)
+{
+}
+
+Status
+IsochronePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                               const RoutingAlgorithmsInterface &algorithms,
+                               const api::IsochroneParameters &params,
+                               util::json::Object &result) const
+{
+    if (!algorithms.HasOneToAllSearch())
+    {
+        return Error("NotImplemented",
+                     "One to all search is not implemented for the chosen search algorithm.",
+                     result);
+    }
+
+    BOOST_ASSERT(params.IsValid());
+
+    if (!CheckAllCoordinates(params.coordinates))
+    {
+        return Error("InvalidOptions", "Coordinates are invalid", result);
+    }
+
+    if (params.coordinates.size() != 1)
+    {
+        return Error("InvalidOptions", "Only one input coordinate is supported", result);
+    }
+
+    const auto max_contour = *std::max_element(params.contours.begin(), params.contours.end());
+    if (max_isochrone_duration > 0 && max_contour > max_isochrone_duration)
+    {
+        return Error("TooBig",
+                     "Contour duration is higher than current maximum (" +
+                         std::to_string(max_isochrone_duration) + ")",
+                     result);
+    }
+
+    const auto phantom_nodes = GetPhantomNodes(facade, params, algorithms.GetSnapCache());
+    if (phantom_nodes.size() != params.coordinates.size())
+    {
+        return Error("NoSegment", "Could not find a matching segment for coordinate", result);
+    }
+    const auto source = SnapPhantomNodes(phantom_nodes).front();
+
+    // durations are computed in deci-seconds
+    const auto to_duration = [](const double contour) {
+        return static_cast<EdgeDuration>(std::round(contour * 10.));
+    };
+    const auto node_durations = algorithms.OneToAllSearch(source, to_duration(max_contour));
+
+    // contours from the smallest to the largest
+    std::vector<std::size_t> contour_order(params.contours.size());
+    std::iota(contour_order.begin(), contour_order.end(), 0);
+    std::sort(contour_order.begin(), contour_order.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return params.contours[lhs] < params.contours[rhs];
+    });
+    std::vector<EdgeDuration> sorted_durations;
+    for (const auto index : contour_order)
+    {
+        sorted_durations.push_back(to_duration(params.contours[index]));
+    }
+
+    // start of every reached segment, grouped by the smallest contour it is part of
+    std::vector<std::vector<util::Coordinate>> contour_coordinates(params.contours.size());
+    for (const auto node : util::irange<NodeID>(0, node_durations.size()))
+    {
+        const auto duration = node_durations[node];
+        if (duration == MAXIMAL_EDGE_DURATION)
+            continue;
+
+        const auto contour =
+            std::lower_bound(sorted_durations.begin(), sorted_durations.end(), duration);
+        BOOST_ASSERT(contour != sorted_durations.end());
+
+        const auto geometry_index = facade.GetGeometryIndex(node);
+        // the reverse geometry starts where the forward one ends
+        const auto geometry = facade.GetUncompressedForwardGeometry(geometry_index.id);
+        BOOST_ASSERT(!geometry.empty());
+        contour_coordinates[std::distance(sorted_durations.begin(), contour)].push_back(
+            facade.GetCoordinateOfNode(geometry_index.forward ? geometry.front()
+                                                              : geometry.back()));
+    }
+
+    // the hull of a larger contour only depends on the hull of the smaller one and the
+    // coordinates that are added
+    std::vector<std::vector<util::Coordinate>> polygons(params.contours.size());
+    std::vector<util::Coordinate> hull{source.location};
+    for (const auto sorted_index : util::irange<std::size_t>(0, contour_order.size()))
+    {
+        auto &coordinates = contour_coordinates[sorted_index];
+        coordinates.insert(coordinates.end(), hull.begin(), hull.end());
+        hull = util::convexHull(std::move(coordinates));
+        polygons[contour_order[sorted_index]] = hull;
+    }
+
+    util::ScopedStageTimer assemble_timer(util::RequestStage::Assemble);
+    api::IsochroneAPI isochrone_api{facade, params};
+    isochrone_api.MakeResponse(source, polygons, result);
+
+    return Status::Ok;
+}
+}
+}
+}
@@ -6,11 +6,17 @@
 #include "engine/api/match_parameters_tidy.hpp"
 #include "engine/map_matching/bayes_classifier.hpp"
 #include "engine/map_matching/sub_matching.hpp"
+#include "engine/query_deadline.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_util.hpp"
+#include "util/request_timing.hpp"
 #include "util/string_util.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include <cstdlib>
 
 #include <algorithm>
@@ -109,8 +115,90 @@ void filterCandidates(const std::vector<util::Coordinate> &coordinates,
     }
 }
 
+// Splits the coordinates of a batch request and their values into the parameters of its traces
+std::vector<api::MatchParameters> splitTraces(const api::MatchParameters &parameters)
+{
+    auto options = parameters;
+    options.coordinates.clear();
+    options.hints.clear();
+    options.radiuses.clear();
+    options.bearings.clear();
+    options.approaches.clear();
+    options.timestamps.clear();
+    options.traces.clear();
+
+    std::vector<api::MatchParameters> traces;
+    traces.reserve(parameters.traces.size());
+    std::size_t trace_begin = 0;
+    for (const auto trace_size : parameters.traces)
+    {
+        traces.push_back(options);
+        auto &trace = traces.back();
+        const auto slice = [&](const auto &values, auto &trace_values) {
+            if (!values.empty())
+            {
+                trace_values.assign(values.begin() + trace_begin,
+                                    values.begin() + trace_begin + trace_size);
+            }
+        };
+        slice(parameters.coordinates, trace.coordinates);
+        slice(parameters.hints, trace.hints);
+        slice(parameters.radiuses, trace.radiuses);
+        slice(parameters.bearings, trace.bearings);
+        slice(parameters.approaches, trace.approaches);
+        slice(parameters.timestamps, trace.timestamps);
+        trace_begin += trace_size;
+    }
+    BOOST_ASSERT(trace_begin == parameters.coordinates.size());
+
+    return traces;
+}
+
+// Prepends the last point of the previous request of the session to the trace of the request
+api::MatchParameters continueSession(const MatchSessions::Session &session,
+                                     const api::MatchParameters &parameters)
+{
+    auto continued = parameters;
+    continued.coordinates.insert(continued.coordinates.begin(), session.coordinate);
+    if (!continued.hints.empty())
+        continued.hints.insert(continued.hints.begin(), boost::none);
+    if (!continued.bearings.empty())
+        continued.bearings.insert(continued.bearings.begin(), boost::none);
+    if (!continued.approaches.empty())
+        continued.approaches.insert(continued.approaches.begin(), boost::none);
+    if (!continued.radiuses.empty())
+        continued.radiuses.insert(continued.radiuses.begin(), session.radius);
+    if (!continued.timestamps.empty())
+        continued.timestamps.insert(continued.timestamps.begin(), *session.timestamp);
+    return continued;
+}
+
+template <typename Function>
+void MatchPlugin::ForEach(const std::size_t size, const Function &function) const
+{
+    if (match_concurrency == 1)
+    {
+        for (const auto index : util::irange<std::size_t>(0, size))
+        {
+            function(index);
+        }
+        return;
+    }
+
+    const auto *deadline = CurrentQueryDeadline();
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, size),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          const ScopedQueryDeadline task_deadline(deadline);
+                          for (auto index = range.begin(); index != range.end(); ++index)
+                          {
+                              function(index);
+                          }
+                      });
+}
+
 Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                                   const RoutingAlgorithmsInterface &algorithms,
+                                  const MatchSessionsView &sessions,
                                   const api::MatchParameters &parameters,
                                   util::json::Object &json_result) const
 {
@@ -121,6 +209,13 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
                      json_result);
     }
 
+    if (parameters.steps && !facade.HasGuidanceData())
+    {
+        return Error("NotImplemented",
+                     "Steps are not supported by datasets extracted with --routing-only.",
+                     json_result);
+    }
+
     BOOST_ASSERT(parameters.IsValid());
 
     // enforce maximum number of locations for performance reasons
@@ -135,6 +230,57 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
         return Error("InvalidValue", "Invalid coordinate value.", json_result);
     }
 
+    const auto handle = [&] {
+        if (parameters.traces.empty())
+        {
+            return MatchTrace(facade, algorithms, sessions, parameters, json_result);
+        }
+
+        // The traces of a batch are independent and each has its own status, the
+        // batch fails only if all of them do
+        const auto traces = splitTraces(parameters);
+        std::vector<util::json::Object> trace_results(traces.size());
+        std::vector<Status> trace_statuses(traces.size());
+        ForEach(traces.size(), [&](const std::size_t index) {
+            trace_statuses[index] =
+                MatchTrace(facade, algorithms, {}, traces[index], trace_results[index]);
+        });
+
+        util::json::Array json_traces;
+        json_traces.values.reserve(traces.size());
+        for (auto &trace_result : trace_results)
+        {
+            json_traces.values.push_back(std::move(trace_result));
+        }
+        json_result.values["traces"] = std::move(json_traces);
+        if (std::none_of(trace_statuses.begin(), trace_statuses.end(), [](const Status status) {
+                return status == Status::Ok;
+            }))
+        {
+            return Error("NoMatch", "Could not match any trace.", json_result);
+        }
+        json_result.values["code"] = "Ok";
+        return Status::Ok;
+    };
+
+    // All work of a request runs on the calling thread unless the plugin may use more threads
+    if (match_concurrency == 1)
+    {
+        return handle();
+    }
+
+    Status status;
+    tbb::task_arena arena(match_concurrency);
+    arena.execute([&] { status = handle(); });
+    return status;
+}
+
+Status MatchPlugin::MatchTrace(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                               const RoutingAlgorithmsInterface &algorithms,
+                               const MatchSessionsView &sessions,
+                               const api::MatchParameters &parameters,
+                               util::json::Object &json_result) const
+{
     // Check for same or increasing timestamps. Impl. note: Incontrast to `sort(first,
     // last, less_equal)` checking `greater` in reverse meets irreflexive requirements.
     const auto time_increases_monotonically = std::is_sorted(
@@ -146,17 +292,50 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
             "InvalidValue", "Timestamps need to be monotonically increasing.", json_result);
     }
 
+    // A session is restarted if the request can not continue its trace
+    boost::optional<MatchSessions::Session> session;
+    if (!parameters.session.empty())
+    {
+        if (!sessions)
+        {
+            return Error("NotImplemented", "Match sessions are not enabled.", json_result);
+        }
+
+        session = sessions.Take(parameters.session);
+        const auto can_continue = [&](const MatchSessions::Session &previous) {
+            if (previous.metric != parameters.metric ||
+                static_cast<bool>(previous.timestamp) == parameters.timestamps.empty())
+            {
+                return false;
+            }
+            return !previous.timestamp || *previous.timestamp <= parameters.timestamps.front();
+        };
+        if (session && !can_continue(*session))
+        {
+            session = boost::none;
+        }
+    }
+
+    // The trace of a continued session starts with the last point of its previous request,
+    // which connects the matching of the request to the previous one
+    api::MatchParameters continued_parameters;
+    if (session)
+    {
+        continued_parameters = continueSession(*session, parameters);
+    }
+    const auto &trace_parameters = session ? continued_parameters : parameters;
+
     SubMatchingList sub_matchings;
     api::tidy::Result tidied;
-    if (parameters.tidy)
+    if (trace_parameters.tidy)
     {
         // Transparently tidy match parameters, do map matching on tidied parameters.
         // Then use the mapping to restore the original <-> tidied relationship.
-        tidied = api::tidy::tidy(parameters);
+        tidied = api::tidy::tidy(trace_parameters);
     }
     else
     {
-        tidied = api::tidy::keep_all(parameters);
+        tidied = api::tidy::keep_all(trace_parameters);
     }
 
     // assuming radius is the standard deviation of a normal distribution
@@ -190,6 +369,11 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
     auto candidates_lists = GetPhantomNodesInRange(facade, tidied.parameters, search_radiuses);
 
     filterCandidates(tidied.parameters.coordinates, candidates_lists);
+    if (session)
+    {
+        // the viterbi column of the session belongs to the candidates it was computed for
+        candidates_lists.front() = std::move(session->candidates);
+    }
     if (std::all_of(candidates_lists.begin(),
                     candidates_lists.end(),
                     [](const std::vector<PhantomNodeWithDistance> &candidates) {
@@ -201,22 +385,62 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
                      json_result);
     }
 
+    const auto last_point = candidates_lists.size() - 1;
+    const auto makeSession = [&](std::vector<double> log_probabilities) {
+        const auto &tidied_parameters = tidied.parameters;
+        return MatchSessions::Session{
+            parameters.metric,
+            std::move(candidates_lists[last_point]),
+            std::move(log_probabilities),
+            tidied_parameters.coordinates[last_point],
+            tidied_parameters.timestamps.empty()
+                ? boost::none
+                : boost::make_optional(tidied_parameters.timestamps[last_point]),
+            tidied_parameters.radiuses.empty() ? boost::none
+                                               : tidied_parameters.radiuses[last_point]};
+    };
+
+    // The first request of a session may consist of a single point, which is matched once the
+    // next request continues the trace
+    if (candidates_lists.size() < 2)
+    {
+        BOOST_ASSERT(!parameters.session.empty() && !candidates_lists[last_point].empty());
+        sessions.Put(parameters.session, makeSession({}));
+
+        api::MatchAPI match_api{facade, trace_parameters, tidied};
+        match_api.MakeResponse({}, {}, json_result);
+        return Status::Ok;
+    }
+
+    routing_algorithms::TraceContinuation continuation;
+    if (session)
+    {
+        continuation.first_log_probabilities = std::move(session->log_probabilities);
+    }
+
     // call the actual map matching
     sub_matchings =
         algorithms.MapMatching(candidates_lists,
                                tidied.parameters.coordinates,
                                tidied.parameters.timestamps,
                                tidied.parameters.radiuses,
-                               parameters.gaps == api::MatchParameters::GapsType::Split);
+                               parameters.gaps == api::MatchParameters::GapsType::Split,
+                               parameters.session.empty() ? nullptr : &continuation);
+
+    if (!continuation.last_log_probabilities.empty())
+    {
+        sessions.Put(parameters.session,
+                     makeSession(std::move(continuation.last_log_probabilities)));
+    }
 
     if (sub_matchings.size() == 0)
     {
         return Error("NoMatch", "Could not match the trace.", json_result);
     }
 
+    // the routes of the sub matchings are unpacked and assembled independently
     std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
-    for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
-    {
+    ForEach(sub_matchings.size(), [&](const std::size_t index) {
         BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
 
         // FIXME we only run this to obtain the geometry
@@ -236,10 +460,11 @@ Status MatchPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
         sub_routes[index] =
             algorithms.ShortestPathSearch(sub_routes[index].segment_end_coordinates, {false});
         BOOST_ASSERT(sub_routes[index].shortest_path_weight != INVALID_EDGE_WEIGHT);
-    }
+    });
 
-    api::MatchAPI match_api{facade, parameters, tidied};
-    match_api.MakeResponse(sub_matchings, sub_routes, json_result);
+    util::ScopedStageTimer assemble_timer(util::RequestStage::Assemble);
+    api::MatchAPI match_api{facade, trace_parameters, tidied};
+    match_api.MakeResponse(sub_matchings, sub_routes, json_result, match_concurrency > 1);
 
     return Status::Ok;
 }
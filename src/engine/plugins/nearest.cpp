@@ -3,6 +3,7 @@
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/integer_range.hpp"
+#include "util/request_timing.hpp"
 
 #include <cstddef>
 #include <string>
@@ -52,6 +53,7 @@ NearestPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacad
     }
     BOOST_ASSERT(phantom_nodes.front().size() > 0);
 
+    util::ScopedStageTimer assemble_timer(util::RequestStage::Assemble);
     api::NearestAPI nearest_api(facade, params);
     nearest_api.MakeResponse(phantom_nodes, json_result);
 
@@ -1,17 +1,25 @@
 #include "engine/plugins/table.hpp"
 
+#include "engine/api/binary_builder.hpp"
 #include "engine/api/table_api.hpp"
 #include "engine/api/table_parameters.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/distance_oracle.hpp"
 #include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+#include "util/request_timing.hpp"
 #include "util/string_util.hpp"
 
+#include <cmath>
 #include <cstdlib>
 
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <boost/assert.hpp>
@@ -23,6 +31,224 @@ namespace engine
 namespace plugins
 {
 
+namespace
+{
+// Largest error of the durations of approximate tables relative to the shortest durations
+const constexpr double APPROXIMATION_ERROR = 0.03;
+
+// The bounds of the parameters in the units of the searches
+routing_algorithms::ManyToManyBounds
+GetBounds(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+          const api::TableParameters &params)
+{
+    routing_algorithms::ManyToManyBounds bounds;
+    if (params.max_duration)
+    {
+        bounds.max_duration = static_cast<EdgeDuration>(
+            std::min<double>(std::round(*params.max_duration * 10.), MAXIMAL_EDGE_DURATION));
+    }
+    if (params.max_weight)
+    {
+        bounds.max_weight = static_cast<EdgeWeight>(std::min<double>(
+            std::round(*params.max_weight * facade.GetWeightMultiplier()), INVALID_EDGE_WEIGHT));
+    }
+    return bounds;
+}
+
+// Keeps the entries of the nearest destinations of every source, ties by the order of the
+// destinations
+void KeepNearestResults(const std::size_t max_results,
+                        const std::size_t num_destinations,
+                        std::vector<EdgeWeight> &result_table,
+                        std::vector<double> &distance_table)
+{
+    std::vector<std::size_t> columns(num_destinations);
+    for (std::size_t row_begin = 0; row_begin < result_table.size();
+         row_begin += num_destinations)
+    {
+        const auto row = result_table.begin() + row_begin;
+        const auto reachable = static_cast<std::size_t>(std::count_if(
+            row, row + num_destinations, [](const EdgeWeight duration) {
+                return duration != MAXIMAL_EDGE_DURATION;
+            }));
+        if (reachable <= max_results)
+        {
+            continue;
+        }
+
+        for (std::size_t column = 0; column < num_destinations; ++column)
+        {
+            columns[column] = column;
+        }
+        std::nth_element(columns.begin(),
+                         columns.begin() + max_results,
+                         columns.end(),
+                         [row](const std::size_t lhs, const std::size_t rhs) {
+                             return std::tie(row[lhs], lhs) < std::tie(row[rhs], rhs);
+                         });
+        for (auto column = columns.begin() + max_results; column != columns.end(); ++column)
+        {
+            row[*column] = MAXIMAL_EDGE_DURATION;
+            if (!distance_table.empty())
+            {
+                distance_table[row_begin + *column] = std::numeric_limits<double>::max();
+            }
+        }
+    }
+}
+
+// Segments of a phantom node with the durations the searches start or end with on them
+struct PhantomSegments
+{
+    std::array<NodeID, 2> nodes;
+    std::array<EdgeDuration, 2> offsets;
+    std::size_t size = 0;
+
+    void Add(const NodeID node, const EdgeDuration offset)
+    {
+        nodes[size] = node;
+        offsets[size] = offset;
+        ++size;
+    }
+};
+
+PhantomSegments GetSourceSegments(const PhantomNode &phantom)
+{
+    PhantomSegments segments;
+    if (phantom.IsValidForwardSource())
+        segments.Add(phantom.forward_segment_id.id, -phantom.GetForwardDuration());
+    if (phantom.IsValidReverseSource())
+        segments.Add(phantom.reverse_segment_id.id, -phantom.GetReverseDuration());
+    return segments;
+}
+
+PhantomSegments GetTargetSegments(const PhantomNode &phantom)
+{
+    PhantomSegments segments;
+    if (phantom.IsValidForwardTarget())
+        segments.Add(phantom.forward_segment_id.id, phantom.GetForwardDuration());
+    if (phantom.IsValidReverseTarget())
+        segments.Add(phantom.reverse_segment_id.id, phantom.GetReverseDuration());
+    return segments;
+}
+
+// Bounds of the duration between two phantom nodes, the minimum of the bounds between their
+// segments with the offsets of the phantom nodes added like in the searches. Both are
+// MAXIMAL_EDGE_DURATION if the oracle has no bounds for one of the pairs of segments.
+util::DistanceOracleView::Bounds GetApproximateBounds(const util::DistanceOracleView &oracle,
+                                                      const PhantomSegments &source,
+                                                      const PhantomSegments &target)
+{
+    util::DistanceOracleView::Bounds bounds{MAXIMAL_EDGE_DURATION, MAXIMAL_EDGE_DURATION};
+    for (std::size_t from = 0; from < source.size; ++from)
+    {
+        for (std::size_t to = 0; to < target.size; ++to)
+        {
+            const auto segment_bounds = oracle.GetBounds(source.nodes[from], target.nodes[to]);
+            if (segment_bounds.upper == MAXIMAL_EDGE_DURATION)
+            {
+                return {MAXIMAL_EDGE_DURATION, MAXIMAL_EDGE_DURATION};
+            }
+            const auto offset = source.offsets[from] + target.offsets[to];
+            bounds.lower = std::min(bounds.lower, segment_bounds.lower + offset);
+            bounds.upper = std::min(bounds.upper, segment_bounds.upper + offset);
+        }
+    }
+    return bounds;
+}
+
+// Estimates the entries whose bounds are within APPROXIMATION_ERROR of the shortest duration by
+// the midpoint of their bounds. The other entries are computed exactly by one table of all of
+// their rows and columns.
+std::vector<EdgeWeight>
+ApproximateTable(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                 const RoutingAlgorithmsInterface &algorithms,
+                 const std::vector<PhantomNode> &phantoms,
+                 const api::TableParameters &params)
+{
+    const auto &oracle = facade.GetDistanceOracle();
+    const auto bounds = GetBounds(facade, params);
+    const auto index = [](const std::vector<std::size_t> &indices, const std::size_t position) {
+        return indices.empty() ? position : indices[position];
+    };
+    const auto num_sources = params.sources.empty() ? phantoms.size() : params.sources.size();
+    const auto num_destinations =
+        params.destinations.empty() ? phantoms.size() : params.destinations.size();
+
+    std::vector<PhantomSegments> target_segments(num_destinations);
+    for (std::size_t column = 0; column < num_destinations; ++column)
+        target_segments[column] = GetTargetSegments(phantoms[index(params.destinations, column)]);
+
+    std::vector<EdgeWeight> table(num_sources * num_destinations, MAXIMAL_EDGE_DURATION);
+    std::vector<std::vector<std::size_t>> exact_columns(num_sources);
+    std::vector<bool> is_exact_column(num_destinations, false);
+    for (std::size_t row = 0; row < num_sources; ++row)
+    {
+        const auto source_segments = GetSourceSegments(phantoms[index(params.sources, row)]);
+        for (std::size_t column = 0; column < num_destinations; ++column)
+        {
+            const auto entry_bounds =
+                GetApproximateBounds(oracle, source_segments, target_segments[column]);
+            if (entry_bounds.upper != MAXIMAL_EDGE_DURATION && entry_bounds.lower > 0 &&
+                entry_bounds.upper - entry_bounds.lower <=
+                    2 * APPROXIMATION_ERROR * entry_bounds.lower)
+            {
+                const auto estimate = (entry_bounds.lower + entry_bounds.upper) / 2;
+                if (estimate <= bounds.max_duration)
+                {
+                    table[row * num_destinations + column] = estimate;
+                }
+            }
+            else
+            {
+                exact_columns[row].push_back(column);
+                is_exact_column[column] = true;
+            }
+        }
+    }
+
+    std::vector<std::size_t> exact_sources, exact_destinations;
+    for (std::size_t row = 0; row < num_sources; ++row)
+    {
+        if (!exact_columns[row].empty())
+            exact_sources.push_back(index(params.sources, row));
+    }
+    for (std::size_t column = 0; column < num_destinations; ++column)
+    {
+        if (is_exact_column[column])
+            exact_destinations.push_back(index(params.destinations, column));
+    }
+    if (exact_sources.empty())
+    {
+        return table;
+    }
+
+    // every exact column has an exact entry, so a single table searches no more often than a
+    // search from every row to its exact entries would
+    const auto durations = algorithms.ManyToManySearch(
+        phantoms, exact_sources, exact_destinations, nullptr, bounds);
+    std::size_t exact_row = 0;
+    std::vector<std::size_t> exact_position(num_destinations);
+    for (std::size_t column = 0, position = 0; column < num_destinations; ++column)
+    {
+        if (is_exact_column[column])
+            exact_position[column] = position++;
+    }
+    for (std::size_t row = 0; row < num_sources; ++row)
+    {
+        if (exact_columns[row].empty())
+            continue;
+        for (const auto column : exact_columns[row])
+        {
+            table[row * num_destinations + column] =
+                durations[exact_row * exact_destinations.size() + exact_position[column]];
+        }
+        ++exact_row;
+    }
+    return table;
+}
+}
+
 TablePlugin::TablePlugin(const int max_locations_distance_table)
     : max_locations_distance_table(max_locations_distance_table)
 {
@@ -32,6 +258,74 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
                                   const RoutingAlgorithmsInterface &algorithms,
                                   const api::TableParameters &params,
                                   util::json::Object &result) const
+{
+    std::vector<EdgeWeight> result_table;
+    std::vector<double> distance_table;
+    std::vector<PhantomNode> snapped_phantoms;
+    const auto status = ComputeTable(
+        facade, algorithms, params, result_table, distance_table, snapped_phantoms, result);
+    if (status != Status::Ok)
+    {
+        return status;
+    }
+
+    util::ScopedStageTimer assemble_timer(util::RequestStage::Assemble);
+    api::TableAPI table_api{facade, params};
+    table_api.MakeResponse(result_table, distance_table, snapped_phantoms, result);
+
+    return Status::Ok;
+}
+
+Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                                  const RoutingAlgorithmsInterface &algorithms,
+                                  const api::TableParameters &params,
+                                  std::string &result) const
+{
+    std::vector<EdgeWeight> result_table;
+    std::vector<double> distance_table;
+    std::vector<PhantomNode> snapped_phantoms;
+    util::json::Object error;
+    const auto status = ComputeTable(
+        facade, algorithms, params, result_table, distance_table, snapped_phantoms, error);
+    const auto binary = params.format == api::OutputFormatType::Binary;
+
+    // the response is written straight to its serialized form
+    util::ScopedStageTimer render_timer(util::RequestStage::Render);
+    if (status != Status::Ok)
+    {
+        if (binary)
+        {
+            api::binary::encode(error, result);
+        }
+        else
+        {
+            std::vector<char> rendered_error;
+            util::json::render(rendered_error, error);
+            result.assign(rendered_error.begin(), rendered_error.end());
+        }
+        return status;
+    }
+
+    api::TableAPI table_api{facade, params};
+    if (binary)
+    {
+        table_api.MakeBinaryResponse(result_table, distance_table, snapped_phantoms, result);
+    }
+    else
+    {
+        table_api.MakeResponse(result_table, distance_table, snapped_phantoms, result);
+    }
+
+    return Status::Ok;
+}
+
+Status TablePlugin::ComputeTable(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                                 const RoutingAlgorithmsInterface &algorithms,
+                                 const api::TableParameters &params,
+                                 std::vector<EdgeWeight> &result_table,
+                                 std::vector<double> &distance_table,
+                                 std::vector<PhantomNode> &snapped_phantoms,
+                                 util::json::Object &result) const
 {
     if (!algorithms.HasManyToManySearch())
     {
@@ -60,6 +354,26 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
     const auto num_destinations =
         params.destinations.empty() ? params.coordinates.size() : params.destinations.size();
 
+    if (params.approximate)
+    {
+        if (params.annotations != api::TableParameters::AnnotationsType::Duration)
+        {
+            return Error("InvalidOptions", "Approximate tables only have durations", result);
+        }
+        if (params.max_weight)
+        {
+            return Error(
+                "InvalidOptions", "Approximate tables can't be bounded by max_weight", result);
+        }
+        if (facade.GetDistanceOracle().GetNumberOfCells() == 0)
+        {
+            return Error("NotImplemented",
+                         "Approximate tables need a distance oracle, see --distance-oracle-level "
+                         "of osrm-customize",
+                         result);
+        }
+    }
+
     if (max_locations_distance_table > 0 &&
         ((num_sources * num_destinations) >
          static_cast<std::size_t>(max_locations_distance_table * max_locations_distance_table)))
@@ -67,7 +381,7 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
         return Error("TooBig", "Too many table coordinates", result);
     }
 
-    auto phantom_nodes = GetPhantomNodes(facade, params);
+    auto phantom_nodes = GetPhantomNodes(facade, params, algorithms.GetSnapCache());
 
     if (phantom_nodes.size() != params.coordinates.size())
     {
@@ -77,17 +391,32 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
                      result);
     }
 
-    auto snapped_phantoms = SnapPhantomNodes(phantom_nodes);
-    auto result_table =
-        algorithms.ManyToManySearch(snapped_phantoms, params.sources, params.destinations);
+    snapped_phantoms = SnapPhantomNodes(phantom_nodes);
+    if (params.approximate)
+    {
+        result_table = ApproximateTable(facade, algorithms, snapped_phantoms, params);
+    }
+    else
+    {
+        const auto calculate_distance =
+            params.annotations & api::TableParameters::AnnotationsType::Distance;
+        result_table = algorithms.ManyToManySearch(snapped_phantoms,
+                                                   params.sources,
+                                                   params.destinations,
+                                                   calculate_distance ? &distance_table : nullptr,
+                                                   GetBounds(facade, params));
+    }
 
     if (result_table.empty())
     {
         return Error("NoTable", "No table found", result);
     }
 
-    api::TableAPI table_api{facade, params};
-    table_api.MakeResponse(result_table, snapped_phantoms, result);
+    if (params.max_results_per_source)
+    {
+        KeepNearestResults(
+            *params.max_results_per_source, num_destinations, result_table, distance_table);
+    }
 
     return Status::Ok;
 }
@@ -2,15 +2,21 @@
 
 #include "engine/api/trip_api.hpp"
 #include "engine/api/trip_parameters.hpp"
+#include "engine/query_deadline.hpp"
 #include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_held_karp.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
+#include "engine/trip/trip_sparse_table.hpp"
 #include "util/dist_table_wrapper.hpp" // to access the dist table more easily
 #include "util/json_container.hpp"
+#include "util/request_timing.hpp"
 
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
@@ -26,6 +32,16 @@ namespace engine
 namespace plugins
 {
 
+// The local search stops at the end of the improvement time, or earlier at the deadline of the
+// query which still has to route the trip afterwards
+std::chrono::steady_clock::time_point
+ImprovementDeadline(const std::chrono::milliseconds improvement_time)
+{
+    const auto improved_until = std::chrono::steady_clock::now() + improvement_time;
+    const auto *deadline = CurrentQueryDeadline();
+    return deadline ? std::min(improved_until, deadline->ExpiresAt()) : improved_until;
+}
+
 bool IsStronglyConnectedComponent(const util::DistTableWrapper<EdgeWeight> &result_table)
 {
     return std::find(std::begin(result_table), std::end(result_table), INVALID_EDGE_WEIGHT) ==
@@ -142,6 +158,61 @@ void ManipulateTableForFSE(const std::size_t source_id,
     //*********  End of changes to table  *************************************
 }
 
+// Computes durations only from each location to its nearest locations and builds the trip on
+// this sparse table. Returns an empty trip if a location cannot be reached or left.
+std::vector<NodeID> TripPlugin::ComputeSparseTrip(const RoutingAlgorithmsInterface &algorithms,
+                                                  const std::vector<PhantomNode> &snapped_phantoms,
+                                                  const std::size_t source_id,
+                                                  const std::size_t destination_id) const
+{
+    const auto number_of_locations = snapped_phantoms.size();
+
+    std::vector<util::Coordinate> coordinates;
+    coordinates.reserve(number_of_locations);
+    for (const auto &phantom : snapped_phantoms)
+    {
+        coordinates.push_back(phantom.location);
+    }
+
+    trip::SparseDistTable sparse_table(
+        algorithms.NearestTargetsSearch(snapped_phantoms, table_neighbours),
+        std::move(coordinates),
+        table_neighbours);
+
+    const bool fixed_start_and_end = source_id != INVALID_INDEX && destination_id != INVALID_INDEX;
+    if (fixed_start_and_end)
+    {
+        sparse_table.FixStartAndEnd(source_id, destination_id);
+    }
+
+    const auto neighbours = sparse_table.GetNeighbours();
+    std::vector<bool> reached(number_of_locations, false);
+    for (const auto &location_neighbours : neighbours)
+    {
+        if (location_neighbours.empty())
+            return {};
+        for (const auto neighbour : location_neighbours)
+            reached[neighbour] = true;
+    }
+    if (std::find(reached.begin(), reached.end(), false) != reached.end())
+    {
+        return {};
+    }
+
+    auto trip = trip::NeighbourListTrip(sparse_table,
+                                        neighbours,
+                                        fixed_start_and_end ? source_id : 0,
+                                        fixed_start_and_end ? destination_id : SPECIAL_NODEID);
+    if (improvement_time.count() > 0)
+    {
+        trip = trip::LocalSearchTrip(std::move(trip),
+                                     sparse_table,
+                                     neighbours,
+                                     ImprovementDeadline(improvement_time));
+    }
+    return trip;
+}
+
 Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                                  const RoutingAlgorithmsInterface &algorithms,
                                  const api::TripParameters &parameters,
@@ -160,6 +231,13 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
                      json_result);
     }
 
+    if (parameters.steps && !facade.HasGuidanceData())
+    {
+        return Error("NotImplemented",
+                     "Steps are not supported by datasets extracted with --routing-only.",
+                     json_result);
+    }
+
     BOOST_ASSERT(parameters.IsValid());
     const auto number_of_locations = parameters.coordinates.size();
 
@@ -192,7 +270,7 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
         return Error("InvalidValue", "Invalid coordinate value.", json_result);
     }
 
-    auto phantom_node_pairs = GetPhantomNodes(facade, parameters);
+    auto phantom_node_pairs = GetPhantomNodes(facade, parameters, algorithms.GetSnapCache());
     if (phantom_node_pairs.size() != number_of_locations)
     {
         return Error("NoSegment",
@@ -212,39 +290,66 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
 
     BOOST_ASSERT(snapped_phantoms.size() == number_of_locations);
 
-    // compute the duration table of all phantom nodes
-    auto result_table = util::DistTableWrapper<EdgeWeight>(
-        algorithms.ManyToManySearch(snapped_phantoms, {}, {}), number_of_locations);
-
-    if (result_table.size() == 0)
-    {
-        return Status::Error;
-    }
-
-    const constexpr std::size_t BF_MAX_FEASABLE = 10;
-    BOOST_ASSERT_MSG(result_table.size() == number_of_locations * number_of_locations,
-                     "Distance Table has wrong size");
-
-    if (!IsStronglyConnectedComponent(result_table))
-    {
-        return Error("NoTrips", "No trip visiting all destinations possible.", json_result);
-    }
-
-    if (fixed_start && fixed_end)
-    {
-        ManipulateTableForFSE(source_id, destination_id, result_table);
-    }
+    const constexpr std::size_t SPARSE_TABLE_MIN_LOCATIONS = 100;
 
     std::vector<NodeID> trip;
     trip.reserve(number_of_locations);
-    // get an optimized order in which the destinations should be visited
-    if (number_of_locations < BF_MAX_FEASABLE)
+    if (table_neighbours > 0 && number_of_locations > SPARSE_TABLE_MIN_LOCATIONS)
     {
-        trip = trip::BruteForceTrip(number_of_locations, result_table);
+        trip = ComputeSparseTrip(algorithms,
+                                 snapped_phantoms,
+                                 fixed_start && fixed_end ? source_id : INVALID_INDEX,
+                                 fixed_start && fixed_end ? destination_id : INVALID_INDEX);
+        if (trip.empty())
+        {
+            return Error("NoTrips", "No trip visiting all destinations possible.", json_result);
+        }
     }
     else
     {
-        trip = trip::FarthestInsertionTrip(number_of_locations, result_table);
+        // compute the duration table of all phantom nodes
+        auto result_table = util::DistTableWrapper<EdgeWeight>(
+            algorithms.ManyToManySearch(snapped_phantoms, {}, {}, nullptr, {}),
+            number_of_locations);
+
+        if (result_table.size() == 0)
+        {
+            return Status::Error;
+        }
+
+        const constexpr std::size_t BF_MAX_FEASABLE = 10;
+        BOOST_ASSERT_MSG(result_table.size() == number_of_locations * number_of_locations,
+                         "Distance Table has wrong size");
+
+        if (!IsStronglyConnectedComponent(result_table))
+        {
+            return Error("NoTrips", "No trip visiting all destinations possible.", json_result);
+        }
+
+        if (fixed_start && fixed_end)
+        {
+            ManipulateTableForFSE(source_id, destination_id, result_table);
+        }
+
+        // get an optimized order in which the destinations should be visited
+        if (number_of_locations < BF_MAX_FEASABLE)
+        {
+            trip = trip::BruteForceTrip(number_of_locations, result_table);
+        }
+        else if (number_of_locations <= trip::HELD_KARP_MAX_LOCATIONS)
+        {
+            trip = trip::HeldKarpTrip(number_of_locations, result_table);
+        }
+        else
+        {
+            trip = trip::FarthestInsertionTrip(number_of_locations, result_table);
+            if (improvement_time.count() > 0)
+            {
+                trip = trip::LocalSearchTrip(std::move(trip),
+                                             result_table,
+                                             ImprovementDeadline(improvement_time));
+            }
+        }
     }
 
     // rotate result such that roundtrip starts at node with index 0
@@ -265,10 +370,15 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
     // get the route when visiting all destinations in optimized order
     InternalRouteResult route =
         ComputeRoute(algorithms, snapped_phantoms, trip, parameters.roundtrip);
+    if (!route.is_valid())
+    {
+        return Error("NoTrips", "No trip visiting all destinations possible.", json_result);
+    }
 
     // get api response
     const std::vector<std::vector<NodeID>> trips = {trip};
     const std::vector<InternalRouteResult> routes = {route};
+    util::ScopedStageTimer assemble_timer(util::RequestStage::Assemble);
     api::TripAPI trip_api{facade, parameters};
     trip_api.MakeResponse(trips, routes, snapped_phantoms, json_result);
 
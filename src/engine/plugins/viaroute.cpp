@@ -6,6 +6,9 @@
 #include "util/for_each_pair.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/request_timing.hpp"
+
+#include <tbb/task_arena.h>
 
 #include <cstdlib>
 
@@ -21,8 +24,12 @@ namespace engine
 namespace plugins
 {
 
-ViaRoutePlugin::ViaRoutePlugin(int max_locations_viaroute, int max_alternatives)
-    : max_locations_viaroute(max_locations_viaroute), max_alternatives(max_alternatives)
+ViaRoutePlugin::ViaRoutePlugin(int max_locations_viaroute,
+                               int max_alternatives,
+                               int leg_concurrency,
+                               int leg_concurrency_min_waypoints)
+    : max_locations_viaroute(max_locations_viaroute), max_alternatives(max_alternatives),
+      leg_concurrency(leg_concurrency), leg_concurrency_min_waypoints(leg_concurrency_min_waypoints)
 {
 }
 
@@ -50,6 +57,13 @@ ViaRoutePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFaca
             json_result);
     }
 
+    if (route_parameters.steps && !facade.HasGuidanceData())
+    {
+        return Error("NotImplemented",
+                     "Steps are not supported by datasets extracted with --routing-only.",
+                     json_result);
+    }
+
     if (max_locations_viaroute > 0 &&
         (static_cast<int>(route_parameters.coordinates.size()) > max_locations_viaroute))
     {
@@ -75,7 +89,8 @@ ViaRoutePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFaca
         return Error("InvalidValue", "Invalid coordinate value.", json_result);
     }
 
-    auto phantom_node_pairs = GetPhantomNodes(facade, route_parameters);
+    auto phantom_node_pairs =
+        GetPhantomNodes(facade, route_parameters, algorithms.GetSnapCache());
     if (phantom_node_pairs.size() != route_parameters.coordinates.size())
     {
         return Error("NoSegment",
@@ -110,7 +125,10 @@ ViaRoutePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFaca
     // https://github.com/Project-OSRM/osrm-backend/issues/3905
     if (1 == start_end_nodes.size() && algorithms.HasAlternativePathSearch() && wants_alternatives)
     {
-        routes = algorithms.AlternativePathSearch(start_end_nodes.front(), number_of_alternatives);
+        const bool single_pass = route_parameters.alternatives_search ==
+                                 api::RouteParameters::AlternativesSearchType::SinglePass;
+        routes = algorithms.AlternativePathSearch(
+            start_end_nodes.front(), number_of_alternatives, single_pass);
     }
     else if (1 == start_end_nodes.size() && algorithms.HasDirectShortestPathSearch())
     {
@@ -127,7 +145,17 @@ ViaRoutePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFaca
 
     if (routes.routes[0].is_valid())
     {
-        route_api.MakeResponse(routes, json_result);
+        util::ScopedStageTimer assemble_timer(util::RequestStage::Assemble);
+        if (leg_concurrency > 1 &&
+            static_cast<int>(snapped_phantoms.size()) >= leg_concurrency_min_waypoints)
+        {
+            tbb::task_arena arena(leg_concurrency);
+            arena.execute([&] { route_api.MakeResponse(routes, json_result, true); });
+        }
+        else
+        {
+            route_api.MakeResponse(routes, json_result);
+        }
     }
     else
     {
@@ -0,0 +1,33 @@
+#include "engine/query_deadline.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+const QueryDeadline *&currentDeadline()
+{
+    thread_local const QueryDeadline *current = nullptr;
+    return current;
+}
+}
+
+ScopedQueryDeadline::ScopedQueryDeadline(const QueryDeadline &deadline)
+    : previous(currentDeadline())
+{
+    currentDeadline() = deadline.IsSet() ? &deadline : nullptr;
+}
+
+ScopedQueryDeadline::ScopedQueryDeadline(const QueryDeadline *deadline)
+    : previous(currentDeadline())
+{
+    currentDeadline() = deadline;
+}
+
+ScopedQueryDeadline::~ScopedQueryDeadline() { currentDeadline() = previous; }
+
+const QueryDeadline *CurrentQueryDeadline() { return currentDeadline(); }
+}
+}
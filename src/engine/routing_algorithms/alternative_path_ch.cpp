@@ -1,5 +1,6 @@
 #include "engine/routing_algorithms/alternative_path.hpp"
 #include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/query_deadline.hpp"
 
 #include "util/integer_range.hpp"
 
@@ -27,6 +28,8 @@ namespace
 const double constexpr VIAPATH_ALPHA = 0.25;   // alternative is local optimum on 25% sub-paths
 const double constexpr VIAPATH_EPSILON = 0.15; // alternative at most 15% longer
 const double constexpr VIAPATH_GAMMA = 0.75;   // alternative shares at most 75% with the shortest.
+// the single pass search verifies at most this many candidates with a T-Test search
+const std::size_t constexpr SINGLE_PASS_MAX_T_TESTS = 3;
 
 using QueryHeap = SearchEngineData<Algorithm>::QueryHeap;
 using SearchSpaceEdge = std::pair<NodeID, NodeID>;
@@ -317,87 +320,16 @@ void computeWeightAndSharingOfViaPath(
     // variable
 }
 
-// conduct T-Test
-bool viaNodeCandidatePassesTTest(
-    SearchEngineData<Algorithm> &engine_working_data,
-    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-    QueryHeap &existing_forward_heap,
-    QueryHeap &existing_reverse_heap,
-    QueryHeap &new_forward_heap,
-    QueryHeap &new_reverse_heap,
-    const RankedCandidateNode &candidate,
-    const EdgeWeight weight_of_shortest_path,
-    EdgeWeight *weight_of_via_path,
-    NodeID *s_v_middle,
-    NodeID *v_t_middle,
-    const EdgeWeight min_edge_offset)
+// conduct T-Test on the via path given by its packed halves <s,..,v> and <v,..,t>
+bool viaPathPassesTTest(SearchEngineData<Algorithm> &engine_working_data,
+                        const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                        const std::vector<NodeID> &packed_s_v_path,
+                        const std::vector<NodeID> &packed_v_t_path,
+                        const EdgeWeight weight_of_shortest_path,
+                        const EdgeWeight min_edge_offset)
 {
-    new_forward_heap.Clear();
-    new_reverse_heap.Clear();
-    std::vector<NodeID> packed_s_v_path;
-    std::vector<NodeID> packed_v_t_path;
-
-    *s_v_middle = SPECIAL_NODEID;
-    EdgeWeight upper_bound_s_v_path_weight = INVALID_EDGE_WEIGHT;
-    // compute path <s,..,v> by reusing forward search from s
-    new_reverse_heap.Insert(candidate.node, 0, candidate.node);
-    while (new_reverse_heap.Size() > 0)
-    {
-        routingStep<REVERSE_DIRECTION>(facade,
-                                       new_reverse_heap,
-                                       existing_forward_heap,
-                                       *s_v_middle,
-                                       upper_bound_s_v_path_weight,
-                                       min_edge_offset,
-                                       DO_NOT_FORCE_LOOPS,
-                                       DO_NOT_FORCE_LOOPS);
-    }
-
-    if (INVALID_EDGE_WEIGHT == upper_bound_s_v_path_weight)
-    {
-        return false;
-    }
-
-    // compute path <v,..,t> by reusing backward search from t
-    *v_t_middle = SPECIAL_NODEID;
-    EdgeWeight upper_bound_of_v_t_path_weight = INVALID_EDGE_WEIGHT;
-    new_forward_heap.Insert(candidate.node, 0, candidate.node);
-    while (new_forward_heap.Size() > 0)
-    {
-        routingStep<FORWARD_DIRECTION>(facade,
-                                       new_forward_heap,
-                                       existing_reverse_heap,
-                                       *v_t_middle,
-                                       upper_bound_of_v_t_path_weight,
-                                       min_edge_offset,
-                                       DO_NOT_FORCE_LOOPS,
-                                       DO_NOT_FORCE_LOOPS);
-    }
-
-    if (INVALID_EDGE_WEIGHT == upper_bound_of_v_t_path_weight)
-    {
-        return false;
-    }
-
-    *weight_of_via_path = upper_bound_s_v_path_weight + upper_bound_of_v_t_path_weight;
-
-    // retrieve packed paths
-    retrievePackedPathFromHeap(
-        existing_forward_heap, new_reverse_heap, *s_v_middle, packed_s_v_path);
-
-    retrievePackedPathFromHeap(
-        new_forward_heap, existing_reverse_heap, *v_t_middle, packed_v_t_path);
-
-    NodeID s_P = *s_v_middle, t_P = *v_t_middle;
-    if (SPECIAL_NODEID == s_P)
-    {
-        return false;
-    }
-
-    if (SPECIAL_NODEID == t_P)
-    {
-        return false;
-    }
+    BOOST_ASSERT(!packed_s_v_path.empty() && !packed_v_t_path.empty());
+    NodeID s_P = packed_s_v_path.back(), t_P = packed_v_t_path.front();
     const EdgeWeight T_threshold = static_cast<EdgeWeight>(VIAPATH_ALPHA * weight_of_shortest_path);
     EdgeWeight unpacked_until_weight = 0;
 
@@ -560,13 +492,104 @@ bool viaNodeCandidatePassesTTest(
     }
     return (upper_bound <= t_test_path_weight);
 }
+
+// compute the via path of the candidate by searches from it and conduct the T-Test
+bool viaNodeCandidatePassesTTest(
+    SearchEngineData<Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+    QueryHeap &existing_forward_heap,
+    QueryHeap &existing_reverse_heap,
+    QueryHeap &new_forward_heap,
+    QueryHeap &new_reverse_heap,
+    const RankedCandidateNode &candidate,
+    const EdgeWeight weight_of_shortest_path,
+    EdgeWeight *weight_of_via_path,
+    NodeID *s_v_middle,
+    NodeID *v_t_middle,
+    const EdgeWeight min_edge_offset)
+{
+    new_forward_heap.Clear();
+    new_reverse_heap.Clear();
+    std::vector<NodeID> packed_s_v_path;
+    std::vector<NodeID> packed_v_t_path;
+
+    *s_v_middle = SPECIAL_NODEID;
+    EdgeWeight upper_bound_s_v_path_weight = INVALID_EDGE_WEIGHT;
+    // compute path <s,..,v> by reusing forward search from s
+    new_reverse_heap.Insert(candidate.node, 0, candidate.node);
+    while (new_reverse_heap.Size() > 0)
+    {
+        routingStep<REVERSE_DIRECTION>(facade,
+                                       new_reverse_heap,
+                                       existing_forward_heap,
+                                       *s_v_middle,
+                                       upper_bound_s_v_path_weight,
+                                       min_edge_offset,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS);
+    }
+
+    if (INVALID_EDGE_WEIGHT == upper_bound_s_v_path_weight)
+    {
+        return false;
+    }
+
+    // compute path <v,..,t> by reusing backward search from t
+    *v_t_middle = SPECIAL_NODEID;
+    EdgeWeight upper_bound_of_v_t_path_weight = INVALID_EDGE_WEIGHT;
+    new_forward_heap.Insert(candidate.node, 0, candidate.node);
+    while (new_forward_heap.Size() > 0)
+    {
+        routingStep<FORWARD_DIRECTION>(facade,
+                                       new_forward_heap,
+                                       existing_reverse_heap,
+                                       *v_t_middle,
+                                       upper_bound_of_v_t_path_weight,
+                                       min_edge_offset,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS);
+    }
+
+    if (INVALID_EDGE_WEIGHT == upper_bound_of_v_t_path_weight)
+    {
+        return false;
+    }
+
+    *weight_of_via_path = upper_bound_s_v_path_weight + upper_bound_of_v_t_path_weight;
+
+    if (SPECIAL_NODEID == *s_v_middle)
+    {
+        return false;
+    }
+
+    if (SPECIAL_NODEID == *v_t_middle)
+    {
+        return false;
+    }
+
+    // retrieve packed paths
+    retrievePackedPathFromHeap(
+        existing_forward_heap, new_reverse_heap, *s_v_middle, packed_s_v_path);
+
+    retrievePackedPathFromHeap(
+        new_forward_heap, existing_reverse_heap, *v_t_middle, packed_v_t_path);
+
+    return viaPathPassesTTest(engine_working_data,
+                              facade,
+                              packed_s_v_path,
+                              packed_v_t_path,
+                              weight_of_shortest_path,
+                              min_edge_offset);
+}
+
 } // anon. namespace
 
 InternalManyRoutesResult
 alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
                       const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                       const PhantomNodes &phantom_node_pair,
-                      unsigned /*number_of_alternatives*/)
+                      unsigned /*number_of_alternatives*/,
+                      const bool single_pass)
 {
     InternalRouteResult primary_route;
     InternalRouteResult secondary_route;
@@ -581,13 +604,15 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
 
     // Init queues, semi-expensive because access to TSS invokes a sys-call
     engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
-    engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
+    if (!single_pass)
+    {
+        // the single pass search takes the via paths from the first heaps
+        engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
+    }
     engine_working_data.InitializeOrClearThirdThreadLocalStorage(facade.GetNumberOfNodes());
 
     auto &forward_heap1 = *engine_working_data.forward_heap_1;
     auto &reverse_heap1 = *engine_working_data.reverse_heap_1;
-    auto &forward_heap2 = *engine_working_data.forward_heap_2;
-    auto &reverse_heap2 = *engine_working_data.reverse_heap_2;
 
     EdgeWeight upper_bound_to_shortest_path_weight = INVALID_EDGE_WEIGHT;
     NodeID middle_node = SPECIAL_NODEID;
@@ -602,8 +627,10 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
     insertNodesInHeaps(forward_heap1, reverse_heap1, phantom_node_pair);
 
     // search from s and t till new_min/(1+epsilon) > weight_of_shortest_path
+    QueryDeadlineCheck check_deadline;
     while (0 < (forward_heap1.Size() + reverse_heap1.Size()))
     {
+        check_deadline();
         if (0 < forward_heap1.Size())
         {
             alternativeRoutingStep<FORWARD_DIRECTION>(facade,
@@ -711,7 +738,7 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
         }
     }
 
-    std::vector<NodeID> preselected_node_list;
+    std::vector<RankedCandidateNode> preselected_candidates;
     for (const NodeID node : via_node_candidate_list)
     {
         if (node == middle_node)
@@ -736,7 +763,7 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
 
         if (weight_passes && sharing_passes && stretch_passes)
         {
-            preselected_node_list.emplace_back(node);
+            preselected_candidates.emplace_back(node, approximated_weight, approximated_sharing);
         }
     }
 
@@ -751,8 +778,18 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
     std::vector<RankedCandidateNode> ranked_candidates_list;
 
     // prioritizing via nodes for deep inspection
-    for (const NodeID node : preselected_node_list)
+    for (const RankedCandidateNode &preselected : preselected_candidates)
     {
+        // the via path through the candidate in the search spaces has the approximated weight
+        // and sharing, the single pass search ranks the candidates by them
+        if (single_pass)
+        {
+            ranked_candidates_list.push_back(preselected);
+            continue;
+        }
+
+        CheckQueryDeadline();
+        const NodeID node = preselected.node;
         EdgeWeight weight_of_via_path = 0, sharing_of_via_path = 0;
         computeWeightAndSharingOfViaPath(engine_working_data,
                                          facade,
@@ -774,8 +811,42 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
     NodeID selected_via_node = SPECIAL_NODEID;
     EdgeWeight weight_of_via_path = INVALID_EDGE_WEIGHT;
     NodeID s_v_middle = SPECIAL_NODEID, v_t_middle = SPECIAL_NODEID;
+    std::vector<NodeID> packed_s_v_path;
+    std::vector<NodeID> packed_v_t_path;
+    std::size_t number_of_t_tests = 0;
     for (const RankedCandidateNode &candidate : ranked_candidates_list)
     {
+        CheckQueryDeadline();
+        if (single_pass)
+        {
+            if (number_of_t_tests++ == SINGLE_PASS_MAX_T_TESTS)
+            {
+                break;
+            }
+
+            packed_s_v_path.clear();
+            retrievePackedPathFromSingleHeap(forward_heap1, candidate.node, packed_s_v_path);
+            std::reverse(packed_s_v_path.begin(), packed_s_v_path.end());
+            packed_s_v_path.emplace_back(candidate.node);
+            packed_v_t_path.assign(1, candidate.node);
+            retrievePackedPathFromSingleHeap(reverse_heap1, candidate.node, packed_v_t_path);
+
+            if (viaPathPassesTTest(engine_working_data,
+                                   facade,
+                                   packed_s_v_path,
+                                   packed_v_t_path,
+                                   upper_bound_to_shortest_path_weight,
+                                   min_edge_offset))
+            {
+                selected_via_node = candidate.node;
+                weight_of_via_path = candidate.weight;
+                break;
+            }
+            continue;
+        }
+
+        auto &forward_heap2 = *engine_working_data.forward_heap_2;
+        auto &reverse_heap2 = *engine_working_data.reverse_heap_2;
         if (viaNodeCandidatePassesTTest(engine_working_data,
                                         facade,
                                         forward_heap1,
@@ -821,13 +892,22 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
     {
         std::vector<NodeID> packed_alternate_path;
         // retrieve alternate path
-        retrievePackedAlternatePath(forward_heap1,
-                                    reverse_heap1,
-                                    forward_heap2,
-                                    reverse_heap2,
-                                    s_v_middle,
-                                    v_t_middle,
-                                    packed_alternate_path);
+        if (single_pass)
+        {
+            packed_alternate_path = std::move(packed_s_v_path);
+            packed_alternate_path.insert(
+                packed_alternate_path.end(), packed_v_t_path.begin() + 1, packed_v_t_path.end());
+        }
+        else
+        {
+            retrievePackedAlternatePath(forward_heap1,
+                                        reverse_heap1,
+                                        *engine_working_data.forward_heap_2,
+                                        *engine_working_data.reverse_heap_2,
+                                        s_v_middle,
+                                        v_t_middle,
+                                        packed_alternate_path);
+        }
 
         secondary_route.unpacked_path_segments.resize(1);
         secondary_route.source_traversed_in_reverse.push_back(
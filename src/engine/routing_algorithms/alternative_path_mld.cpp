@@ -1,5 +1,7 @@
 #include "engine/routing_algorithms/alternative_path.hpp"
 #include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/conditional_turns.hpp"
+#include "engine/query_deadline.hpp"
 
 #include "util/static_assert.hpp"
 
@@ -15,6 +17,10 @@
 
 #include <boost/function_output_iterator.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 namespace osrm
 {
 namespace engine
@@ -442,114 +448,131 @@ filterAnnotatedRoutesByStretch(RandIt first, RandIt last, const InternalRouteRes
     return std::remove_if(first, last, over_duration_limit);
 }
 
-// Unpacks a range of WeightedViaNodePackedPaths into a range of WeightedViaNodeUnpackedPaths.
-// Note: destroys search engine heaps for recursive unpacking. Extract heap data you need before.
-template <typename InputIt, typename OutIt>
-void unpackPackedPaths(InputIt first,
-                       InputIt last,
-                       OutIt out,
-                       SearchEngineData<Algorithm> &search_engine_data,
-                       const Facade &facade,
-                       const PhantomNodes &phantom_node_pair)
+// Calls f for each index in [0, size). With a concurrency above one the indices are distributed
+// over the threads of the arena, so f must only write to the element at its index.
+template <typename F>
+void forEachIndex(tbb::task_arena &arena,
+                  const unsigned concurrency,
+                  const std::size_t size,
+                  const F &f)
 {
-    util::static_assert_iter_category<InputIt, std::input_iterator_tag>();
-    util::static_assert_iter_category<OutIt, std::output_iterator_tag>();
-    util::static_assert_iter_value<InputIt, WeightedViaNodePackedPath>();
+    if (concurrency <= 1 || size <= 1)
+    {
+        for (std::size_t index = 0; index < size; ++index)
+            f(index);
+        return;
+    }
+
+    const auto *deadline = CurrentQueryDeadline();
+    const auto *conditional_turns = CurrentConditionalTurns();
+    arena.execute([&] {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, size),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              const ScopedQueryDeadline task_deadline(deadline);
+                              const ScopedConditionalTurns task_turns(conditional_turns);
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                                  f(index);
+                          });
+    });
+}
 
+// Unpacks a WeightedViaNodePackedPath into a WeightedViaNodeUnpackedPath.
+// Note: destroys the search engine heaps of the calling thread for recursive unpacking.
+// Extract heap data you need before.
+WeightedViaNodeUnpackedPath unpackPackedPath(const WeightedViaNodePackedPath &weighted_packed_path,
+                                             SearchEngineData<Algorithm> &search_engine_data,
+                                             const Facade &facade,
+                                             const PhantomNodes &phantom_node_pair)
+{
     const bool force_loop_forward = needsLoopForward(phantom_node_pair);
     const bool force_loop_backward = needsLoopBackwards(phantom_node_pair);
 
     const Partition &partition = facade.GetMultiLevelPartition();
 
+    search_engine_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+
     Heap &forward_heap = *search_engine_data.forward_heap_1;
     Heap &reverse_heap = *search_engine_data.reverse_heap_1;
 
-    for (auto it = first; it != last; ++it, ++out)
-    {
-        const auto packed_path_weight = it->via.weight;
-        const auto packed_path_via = it->via.node;
+    const auto packed_path_weight = weighted_packed_path.via.weight;
+    const auto packed_path_via = weighted_packed_path.via.node;
 
-        const auto &packed_path = it->path;
+    const auto &packed_path = weighted_packed_path.path;
 
-        //
-        // Todo: dup. code with mld::search except for level entry: we run a slight mld::search
-        //       adaption here and then dispatch to mld::search for recursively descending down.
-        //
+    //
+    // Todo: dup. code with mld::search except for level entry: we run a slight mld::search
+    //       adaption here and then dispatch to mld::search for recursively descending down.
+    //
 
-        std::vector<NodeID> unpacked_nodes;
-        std::vector<EdgeID> unpacked_edges;
-        unpacked_nodes.reserve(packed_path.size());
-        unpacked_edges.reserve(packed_path.size());
+    std::vector<NodeID> unpacked_nodes;
+    std::vector<EdgeID> unpacked_edges;
+    unpacked_nodes.reserve(packed_path.size());
+    unpacked_edges.reserve(packed_path.size());
 
-        // Beware the edge case when start, via, end are all the same.
-        // In this case we return a single node, no edges. We also don't unpack.
-        if (packed_path.empty())
-        {
-            const auto source_node = packed_path_via;
-            unpacked_nodes.push_back(source_node);
+    // Beware the edge case when start, via, end are all the same.
+    // In this case we return a single node, no edges. We also don't unpack.
+    if (packed_path.empty())
+    {
+        const auto source_node = packed_path_via;
+        unpacked_nodes.push_back(source_node);
+    }
+    else
+    {
+        const auto source_node = std::get<0>(packed_path.front());
+        unpacked_nodes.push_back(source_node);
+    }
+
+    for (auto const &packed_edge : packed_path)
+    {
+        NodeID source, target;
+        bool overlay_edge;
+        std::tie(source, target, overlay_edge) = packed_edge;
+        if (!overlay_edge)
+        { // a base graph edge
+            unpacked_nodes.push_back(target);
+            unpacked_edges.push_back(facade.FindEdge(source, target));
         }
         else
-        {
-            const auto source_node = std::get<0>(packed_path.front());
-            unpacked_nodes.push_back(source_node);
-        }
-
-        for (auto const &packed_edge : packed_path)
-        {
-            NodeID source, target;
-            bool overlay_edge;
-            std::tie(source, target, overlay_edge) = packed_edge;
-            if (!overlay_edge)
-            { // a base graph edge
-                unpacked_nodes.push_back(target);
-                unpacked_edges.push_back(facade.FindEdge(source, target));
-            }
-            else
-            { // an overlay graph edge
-                LevelID level = getNodeQueryLevel(partition, source, phantom_node_pair); // XXX
-                CellID parent_cell_id = partition.GetCell(level, source);
-                BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-                LevelID sublevel = level - 1;
-
-                // Here heaps can be reused, let's go deeper!
-                forward_heap.Clear();
-                reverse_heap.Clear();
-                forward_heap.Insert(source, 0, {source});
-                reverse_heap.Insert(target, 0, {target});
-
-                // TODO: when structured bindings will be allowed change to
-                // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-                EdgeWeight subpath_weight;
-                std::vector<NodeID> subpath_nodes;
-                std::vector<EdgeID> subpath_edges;
-                std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(search_engine_data,
-                                                                                facade,
-                                                                                forward_heap,
-                                                                                reverse_heap,
-                                                                                force_loop_forward,
-                                                                                force_loop_backward,
-                                                                                INVALID_EDGE_WEIGHT,
-                                                                                sublevel,
-                                                                                parent_cell_id);
-                BOOST_ASSERT(!subpath_edges.empty());
-                BOOST_ASSERT(subpath_nodes.size() > 1);
-                BOOST_ASSERT(subpath_nodes.front() == source);
-                BOOST_ASSERT(subpath_nodes.back() == target);
-                unpacked_nodes.insert(
-                    unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-                unpacked_edges.insert(
-                    unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
-            }
+        { // an overlay graph edge
+            LevelID level = getNodeQueryLevel(partition, source, phantom_node_pair); // XXX
+            CellID parent_cell_id = partition.GetCell(level, source);
+            BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
+
+            LevelID sublevel = level - 1;
+
+            // Here heaps can be reused, let's go deeper!
+            forward_heap.Clear();
+            reverse_heap.Clear();
+            forward_heap.Insert(source, 0, {source});
+            reverse_heap.Insert(target, 0, {target});
+
+            // TODO: when structured bindings will be allowed change to
+            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
+            EdgeWeight subpath_weight;
+            std::vector<NodeID> subpath_nodes;
+            std::vector<EdgeID> subpath_edges;
+            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(search_engine_data,
+                                                                            facade,
+                                                                            forward_heap,
+                                                                            reverse_heap,
+                                                                            force_loop_forward,
+                                                                            force_loop_backward,
+                                                                            INVALID_EDGE_WEIGHT,
+                                                                            sublevel,
+                                                                            parent_cell_id);
+            BOOST_ASSERT(!subpath_edges.empty());
+            BOOST_ASSERT(subpath_nodes.size() > 1);
+            BOOST_ASSERT(subpath_nodes.front() == source);
+            BOOST_ASSERT(subpath_nodes.back() == target);
+            unpacked_nodes.insert(
+                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
         }
-
-        WeightedViaNodeUnpackedPath unpacked_path{
-            WeightedViaNode{packed_path_via, packed_path_weight},
-            std::move(unpacked_nodes),
-            std::move(unpacked_edges)};
-
-        out = std::move(unpacked_path);
     }
+
+    return WeightedViaNodeUnpackedPath{WeightedViaNode{packed_path_via, packed_path_weight},
+                                       std::move(unpacked_nodes),
+                                       std::move(unpacked_edges)};
 }
 
 // Generates via candidate nodes from the overlap of the two search spaces from s and t.
@@ -590,8 +613,11 @@ makeCandidateVias(SearchEngineData<Algorithm> &search_engine_data,
     EdgeWeight forward_heap_min = forward_heap.MinKey();
     EdgeWeight reverse_heap_min = reverse_heap.MinKey();
 
+    QueryDeadlineCheck check_deadline;
     while (forward_heap.Size() + reverse_heap.Size() > 0)
     {
+        check_deadline();
+
         if (shortest_path_weight != INVALID_EDGE_WEIGHT)
             overlap_weight = shortest_path_weight * kSearchSpaceOverlapFactor;
 
@@ -765,7 +791,8 @@ inline std::vector<EdgeWeight> retrievePackedPathWeightsFromHeap(const Heap &for
 InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &search_engine_data,
                                                const Facade &facade,
                                                const PhantomNodes &phantom_node_pair,
-                                               unsigned number_of_alternatives)
+                                               unsigned number_of_alternatives,
+                                               const bool /*single_pass*/)
 {
     const auto max_number_of_alternatives = number_of_alternatives;
     const auto max_number_of_alternatives_to_unpack =
@@ -775,6 +802,11 @@ InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &sear
 
     const Partition &partition = facade.GetMultiLevelPartition();
 
+    // Paths are reconstructed, unpacked and annotated independently of each other,
+    // with a concurrency above one on the threads of this arena.
+    const auto concurrency = search_engine_data.alternatives_concurrency;
+    tbb::task_arena arena(std::max(concurrency, 1u));
+
     // Prepare heaps for usage below. The searches will modify them in-place.
     search_engine_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
 
@@ -843,9 +875,14 @@ InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &sear
     const auto last_filtered = filterViaCandidatesByViaNotOnPath(
         weighted_packed_paths[0], candidate_vias_first + 1, candidate_vias_last);
 
-    // Store all alternative packed paths (if there are any).
-    auto into = std::back_inserter(weighted_packed_paths);
-    std::transform(begin(candidate_vias) + 1, last_filtered, into, extract_packed_path_from_heaps);
+    // Store all alternative packed paths (if there are any). The heaps are only read here.
+    const auto candidate_vias_with_path = begin(candidate_vias) + 1;
+    const std::size_t number_of_candidate_paths = last_filtered - candidate_vias_with_path;
+    weighted_packed_paths.resize(1 + number_of_candidate_paths);
+    forEachIndex(arena, concurrency, number_of_candidate_paths, [&](const std::size_t index) {
+        weighted_packed_paths[1 + index] =
+            extract_packed_path_from_heaps(candidate_vias_with_path[index]);
+    });
 
     // Filter packed paths with heuristics
 
@@ -869,18 +906,15 @@ InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &sear
 
     const auto paths_first = begin(weighted_packed_paths);
     const auto paths_last = begin(weighted_packed_paths) + 1 + number_of_filtered_alternative_paths;
-    const auto number_of_packed_paths = paths_last - paths_first;
+    const std::size_t number_of_packed_paths = paths_last - paths_first;
 
-    std::vector<WeightedViaNodeUnpackedPath> unpacked_paths;
-    unpacked_paths.reserve(number_of_packed_paths);
+    std::vector<WeightedViaNodeUnpackedPath> unpacked_paths(number_of_packed_paths);
 
     // Note: re-uses (read: destroys) heaps; we don't need them from here on anyway.
-    unpackPackedPaths(paths_first,
-                      paths_last,
-                      std::back_inserter(unpacked_paths),
-                      search_engine_data,
-                      facade,
-                      phantom_node_pair);
+    forEachIndex(arena, concurrency, number_of_packed_paths, [&](const std::size_t index) {
+        unpacked_paths[index] =
+            unpackPackedPath(paths_first[index], search_engine_data, facade, phantom_node_pair);
+    });
 
     //
     // Filter and rank a second time. This time instead of being fast and doing
@@ -896,23 +930,18 @@ InternalManyRoutesResult alternativePathSearch(SearchEngineData<Algorithm> &sear
         std::min(static_cast<std::size_t>(max_number_of_alternatives) + 1,
                  static_cast<std::size_t>(unpacked_paths_last - unpacked_paths_first));
     BOOST_ASSERT(number_of_unpacked_paths >= 1);
-    unpacked_paths_last = unpacked_paths_first + number_of_unpacked_paths;
 
     //
     // Annotate the unpacked path and transform to proper internal route result.
     //
 
-    std::vector<InternalRouteResult> routes;
-    routes.reserve(number_of_unpacked_paths);
-
-    const auto unpacked_path_to_route = [&](const WeightedViaNodeUnpackedPath &path) {
-        return extractRoute(facade, path.via.weight, phantom_node_pair, path.nodes, path.edges);
-    };
+    std::vector<InternalRouteResult> routes(number_of_unpacked_paths);
 
-    std::transform(unpacked_paths_first,
-                   unpacked_paths_last,
-                   std::back_inserter(routes),
-                   unpacked_path_to_route);
+    forEachIndex(arena, concurrency, number_of_unpacked_paths, [&](const std::size_t index) {
+        const auto &path = unpacked_paths_first[index];
+        routes[index] =
+            extractRoute(facade, path.via.weight, phantom_node_pair, path.nodes, path.edges);
+    });
 
     BOOST_ASSERT(routes.size() >= 1);
 
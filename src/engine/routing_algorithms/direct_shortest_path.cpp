@@ -54,6 +54,7 @@ directShortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
         ch::unpackPath(facade,
                        packed_leg.begin(),
                        packed_leg.end(),
+                       engine_working_data.shortcut_cache,
                        [&unpacked_nodes, &unpacked_edges](std::pair<NodeID, NodeID> &edge,
                                                           const auto &edge_id) {
                            BOOST_ASSERT(edge.first == unpacked_nodes.back());
@@ -75,6 +76,16 @@ template InternalRouteResult directShortestPathSearch(
     const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
     const PhantomNodes &phantom_nodes);
 
+// the customized CCH is searched like a CH
+template <>
+InternalRouteResult directShortestPathSearch(
+    SearchEngineData<cch::Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<cch::Algorithm> &facade,
+    const PhantomNodes &phantom_nodes)
+{
+    return directShortestPathSearch<ch::Algorithm>(engine_working_data, facade, phantom_nodes);
+}
+
 template <>
 InternalRouteResult directShortestPathSearch(
     SearchEngineData<mld::Algorithm> &engine_working_data,
@@ -91,14 +102,24 @@ InternalRouteResult directShortestPathSearch(
     EdgeWeight weight = INVALID_EDGE_WEIGHT;
     std::vector<NodeID> unpacked_nodes;
     std::vector<EdgeID> unpacked_edges;
-    std::tie(weight, unpacked_nodes, unpacked_edges) = mld::search(engine_working_data,
-                                                                   facade,
-                                                                   forward_heap,
-                                                                   reverse_heap,
-                                                                   DO_NOT_FORCE_LOOPS,
-                                                                   DO_NOT_FORCE_LOOPS,
-                                                                   INVALID_EDGE_WEIGHT,
-                                                                   phantom_nodes);
+    std::tie(weight, unpacked_nodes, unpacked_edges) =
+        engine_working_data.use_landmarks_for_route
+            ? mld::searchWithLandmarks(engine_working_data,
+                                       facade,
+                                       forward_heap,
+                                       reverse_heap,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS,
+                                       INVALID_EDGE_WEIGHT,
+                                       phantom_nodes)
+            : mld::search(engine_working_data,
+                          facade,
+                          forward_heap,
+                          reverse_heap,
+                          DO_NOT_FORCE_LOOPS,
+                          DO_NOT_FORCE_LOOPS,
+                          INVALID_EDGE_WEIGHT,
+                          phantom_nodes);
 
     return extractRoute(facade, weight, phantom_nodes, unpacked_nodes, unpacked_edges);
 }
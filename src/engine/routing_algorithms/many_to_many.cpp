@@ -1,11 +1,27 @@
 #include "engine/routing_algorithms/many_to_many.hpp"
+#include "engine/routing_algorithms/one_to_all.hpp"
 #include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+#include "engine/query_deadline.hpp"
+
+#include "util/integer_range.hpp"
 
 #include <boost/assert.hpp>
+#include <boost/range/iterator_range_core.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -17,19 +33,37 @@ namespace routing_algorithms
 
 namespace
 {
-struct NodeBucket
+// Number of targets from which one sweep over the union of their search spaces is cheaper
+// than running a backward search for each of them
+const constexpr std::size_t RESTRICTED_SWEEP_MIN_TARGETS = 16;
+
+// Number of collected phantoms in one level 1 cell from which their searches are run as one
+// search with a label for each of them, and the most labels such a search keeps per node
+const constexpr std::size_t CELL_GROUP_MIN_SIZE = 4;
+const constexpr std::size_t CELL_GROUP_LANES = 32;
+
+// Buckets of all searches of one side of the table in one contiguous array, sorted by the
+// settled node once they are done so the searches of the other side can look them up by binary
+// search.
+using SearchSpaceWithBuckets = std::vector<NodeBucket>;
+
+// Edge of a path of the table in the direction from its source to its target, relaxed by the
+// search of the source or by the one of the target. The levels of clique arcs depend on the
+// phantom of the search that relaxed them.
+struct PackedEdge
 {
-    unsigned target_id; // essentially a row in the weight matrix
-    EdgeWeight weight;
-    EdgeWeight duration;
-    NodeBucket(const unsigned target_id, const EdgeWeight weight, const EdgeWeight duration)
-        : target_id(target_id), weight(weight), duration(duration)
-    {
-    }
+    NodeID from;
+    NodeID to;
+    bool from_clique_arc;
+    bool from_source_search;
 };
 
-// FIXME This should be replaced by an std::unordered_multimap, though this needs benchmarking
-using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
+inline bool isFromCliqueArc(const ManyToManyHeapData &) { return false; }
+
+inline bool isFromCliqueArc(const ManyToManyMultiLayerDijkstraHeapData &data)
+{
+    return data.from_clique_arc;
+}
 
 inline bool
 addLoopWeight(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
@@ -97,6 +131,170 @@ void relaxOutgoingEdges(const datafacade::ContiguousInternalMemoryDataFacade<ch:
     }
 }
 
+inline bool
+restrictedSweepSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                      const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                      const std::vector<PhantomNode> &phantom_nodes,
+                      const std::vector<std::size_t> &source_indices,
+                      const std::vector<std::size_t> &target_indices,
+                      std::vector<EdgeWeight> &durations_table)
+{
+    durations_table = restrictedManyToManySearch(
+        engine_working_data, facade, phantom_nodes, source_indices, target_indices);
+    return true;
+}
+
+// Segment of a phantom node with the weight and duration its search starts with
+struct LabelSegment
+{
+    NodeID node;
+    EdgeWeight weight;
+    EdgeDuration duration;
+};
+
+// The segments of a phantom node with the offsets insertSourceInHeap or insertTargetInHeap give
+template <bool DIRECTION>
+std::vector<LabelSegment> getLabelSegments(const PhantomNode &phantom)
+{
+    const auto sign = DIRECTION == FORWARD_DIRECTION ? -1 : 1;
+    std::vector<LabelSegment> segments;
+    if (DIRECTION == FORWARD_DIRECTION ? phantom.IsValidForwardSource()
+                                       : phantom.IsValidForwardTarget())
+    {
+        segments.push_back({phantom.forward_segment_id.id,
+                            sign * phantom.GetForwardWeightPlusOffset(),
+                            sign * phantom.GetForwardDuration()});
+    }
+    if (DIRECTION == FORWARD_DIRECTION ? phantom.IsValidReverseSource()
+                                       : phantom.IsValidReverseTarget())
+    {
+        segments.push_back({phantom.reverse_segment_id.id,
+                            sign * phantom.GetReverseWeightPlusOffset(),
+                            sign * phantom.GetReverseDuration()});
+    }
+    return segments;
+}
+
+// Looks every entry up in the hub labels of the hierarchy instead of searching it. The sums
+// over the common hubs are the weights at the middle nodes of probeRoutingStep, a negative one
+// takes the loop at the node both phantoms are on like there.
+inline bool
+hubLabelSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+               const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+               const std::vector<PhantomNode> &phantom_nodes,
+               const std::vector<std::size_t> &source_indices,
+               const std::vector<std::size_t> &target_indices,
+               std::vector<EdgeWeight> &weights_table,
+               std::vector<EdgeWeight> &durations_table)
+{
+    const auto &labels = facade.GetHubLabels();
+    if (labels.GetNumberOfNodes() == 0)
+    {
+        return false;
+    }
+
+    const auto number_of_sources =
+        source_indices.empty() ? phantom_nodes.size() : source_indices.size();
+    const auto number_of_targets =
+        target_indices.empty() ? phantom_nodes.size() : target_indices.size();
+
+    std::vector<std::vector<LabelSegment>> target_segments(number_of_targets);
+    for (std::size_t column_idx = 0; column_idx < number_of_targets; ++column_idx)
+    {
+        target_segments[column_idx] = getLabelSegments<REVERSE_DIRECTION>(
+            phantom_nodes[target_indices.empty() ? column_idx : target_indices[column_idx]]);
+    }
+
+    const auto lookup_row = [&](const std::size_t row_idx) {
+        const auto source_segments = getLabelSegments<FORWARD_DIRECTION>(
+            phantom_nodes[source_indices.empty() ? row_idx : source_indices[row_idx]]);
+        for (std::size_t column_idx = 0; column_idx < number_of_targets; ++column_idx)
+        {
+            const auto entry = row_idx * number_of_targets + column_idx;
+            auto &current_weight = weights_table[entry];
+            auto &current_duration = durations_table[entry];
+            for (const auto &source : source_segments)
+            {
+                for (const auto &target : target_segments[column_idx])
+                {
+                    const auto offset_weight = source.weight + target.weight;
+                    const auto offset_duration = source.duration + target.duration;
+                    labels.ForEachCommonHub(
+                        source.node,
+                        target.node,
+                        [&](const NodeID hub, EdgeWeight weight, EdgeDuration duration) {
+                            weight += offset_weight;
+                            duration += offset_duration;
+                            if (weight < 0)
+                            {
+                                if (addLoopWeight(facade, hub, weight, duration))
+                                {
+                                    current_weight = std::min(current_weight, weight);
+                                    current_duration = std::min(current_duration, duration);
+                                }
+                            }
+                            else if (weight < current_weight)
+                            {
+                                current_weight = weight;
+                                current_duration = duration;
+                            }
+                        });
+                }
+            }
+        }
+    };
+
+    if (engine_working_data.many_to_many_concurrency > 1 && number_of_sources > 1)
+    {
+        tbb::task_arena arena(engine_working_data.many_to_many_concurrency);
+        arena.execute([&] {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_sources),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  for (auto row_idx = range.begin(); row_idx != range.end();
+                                       ++row_idx)
+                                  {
+                                      lookup_row(row_idx);
+                                  }
+                              });
+        });
+    }
+    else
+    {
+        for (std::size_t row_idx = 0; row_idx < number_of_sources; ++row_idx)
+        {
+            lookup_row(row_idx);
+        }
+    }
+    return true;
+}
+
+// Distance of a path of the table, its shortcuts are unpacked through the shortcut cache
+inline double
+getTablePathDistance(SearchEngineData<ch::Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                     const std::vector<PackedEdge> &packed_path,
+                     const NodeID middle,
+                     const PhantomNode &source_phantom,
+                     const PhantomNode &target_phantom)
+{
+    std::vector<NodeID> packed_nodes;
+    packed_nodes.reserve(packed_path.size() + 1);
+    packed_nodes.push_back(packed_path.empty() ? middle : packed_path.front().from);
+    for (const auto &edge : packed_path)
+    {
+        packed_nodes.push_back(edge.to);
+    }
+
+    std::vector<PathData> unpacked_path;
+    ch::unpackPath(facade,
+                   packed_nodes.begin(),
+                   packed_nodes.end(),
+                   {source_phantom, target_phantom},
+                   unpacked_path,
+                   engine_working_data.shortcut_cache);
+    return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+}
+
 inline bool addLoopWeight(const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &,
                           const NodeID,
                           EdgeWeight &,
@@ -105,6 +303,76 @@ inline bool addLoopWeight(const datafacade::ContiguousInternalMemoryDataFacade<m
     return false;
 }
 
+inline bool
+restrictedSweepSearch(SearchEngineData<mld::Algorithm> &,
+                      const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &,
+                      const std::vector<PhantomNode> &,
+                      const std::vector<std::size_t> &,
+                      const std::vector<std::size_t> &,
+                      std::vector<EdgeWeight> &)
+{ // MLD has no downward sweep graph
+    return false;
+}
+
+inline bool hubLabelSearch(SearchEngineData<mld::Algorithm> &,
+                           const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &,
+                           const std::vector<PhantomNode> &,
+                           const std::vector<std::size_t> &,
+                           const std::vector<std::size_t> &,
+                           std::vector<EdgeWeight> &,
+                           std::vector<EdgeWeight> &)
+{ // MLD has no hub labels
+    return false;
+}
+
+// Distance of a path of the table, its clique arcs are unpacked on the second heaps
+inline double
+getTablePathDistance(SearchEngineData<mld::Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+                     const std::vector<PackedEdge> &packed_path,
+                     const NodeID middle,
+                     const PhantomNode &source_phantom,
+                     const PhantomNode &target_phantom)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &unpack_forward_heap = *engine_working_data.forward_heap_2;
+    auto &unpack_reverse_heap = *engine_working_data.reverse_heap_2;
+
+    std::vector<NodeID> unpacked_nodes;
+    std::vector<EdgeID> unpacked_edges;
+    unpacked_nodes.push_back(packed_path.empty() ? middle : packed_path.front().from);
+    for (const auto &edge : packed_path)
+    {
+        if (!edge.from_clique_arc)
+        {
+            unpacked_nodes.push_back(edge.to);
+            unpacked_edges.push_back(facade.FindEdge(edge.from, edge.to));
+        }
+        else
+        {
+            const auto level = mld::getNodeQueryLevel(
+                partition, edge.from, edge.from_source_search ? source_phantom : target_phantom);
+            mld::unpackCliqueArc(engine_working_data,
+                                 facade,
+                                 unpack_forward_heap,
+                                 unpack_reverse_heap,
+                                 DO_NOT_FORCE_LOOPS,
+                                 DO_NOT_FORCE_LOOPS,
+                                 edge.from,
+                                 edge.to,
+                                 level,
+                                 unpacked_nodes,
+                                 unpacked_edges);
+        }
+    }
+
+    std::vector<PathData> unpacked_path;
+    annotatePath(
+        facade, {source_phantom, target_phantom}, unpacked_nodes, unpacked_edges, unpacked_path);
+    return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+}
+
 template <bool DIRECTION>
 void relaxOutgoingEdges(
     const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
@@ -217,76 +485,901 @@ void relaxOutgoingEdges(
     }
 }
 
-template <typename Algorithm>
-void forwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                        const unsigned row_idx,
-                        const unsigned number_of_targets,
-                        typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
-                        const SearchSpaceWithBuckets &search_space_with_buckets,
-                        std::vector<EdgeWeight> &weights_table,
-                        std::vector<EdgeWeight> &durations_table,
-                        const PhantomNode &phantom_node)
+template <bool DIRECTION, typename ManyToManyQueryHeap>
+void insertInHeap(ManyToManyQueryHeap &query_heap, const PhantomNode &phantom)
+{
+    if (DIRECTION == FORWARD_DIRECTION)
+        insertSourceInHeap(query_heap, phantom);
+    else
+        insertTargetInHeap(query_heap, phantom);
+}
+
+// Settles the next node and checks the buckets collected by the searches of the other side.
+// Buckets of backward searches store columns of the matrix and are probed by forward searches
+// for row_or_column_idx, buckets of forward searches store rows and are probed by backward
+// searches. The nodes the best paths meet at are kept if the middle nodes table is not empty.
+template <bool DIRECTION, typename Algorithm>
+void probeRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                      const unsigned row_or_column_idx,
+                      const unsigned number_of_targets,
+                      typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
+                      const SearchSpaceWithBuckets &search_space_with_buckets,
+                      std::vector<EdgeWeight> &weights_table,
+                      std::vector<EdgeWeight> &durations_table,
+                      std::vector<NodeID> &middle_nodes_table,
+                      const PhantomNode &phantom_node,
+                      const EdgeDuration max_duration)
 {
     const NodeID node = query_heap.DeleteMin();
-    const EdgeWeight source_weight = query_heap.GetKey(node);
-    const EdgeWeight source_duration = query_heap.GetData(node).duration;
+    const EdgeWeight weight = query_heap.GetKey(node);
+    const EdgeWeight duration = query_heap.GetData(node).duration;
+
+    // durations only grow along the paths, the ones over the node are longer than the bound
+    if (duration > max_duration)
+    {
+        return;
+    }
 
     // check if each encountered node has an entry
-    const auto bucket_iterator = search_space_with_buckets.find(node);
-    // iterate bucket if there exists one
-    if (bucket_iterator != search_space_with_buckets.end())
+    const auto bucket_list = boost::make_iterator_range(
+        std::equal_range(search_space_with_buckets.begin(),
+                         search_space_with_buckets.end(),
+                         node,
+                         NodeBucket::Compare()));
+    for (const auto &current_bucket : bucket_list)
+    {
+        const auto row_idx =
+            DIRECTION == FORWARD_DIRECTION ? row_or_column_idx : current_bucket.index;
+        const auto column_idx =
+            DIRECTION == FORWARD_DIRECTION ? current_bucket.index : row_or_column_idx;
+
+        const auto entry = row_idx * number_of_targets + column_idx;
+        auto &current_weight = weights_table[entry];
+        auto &current_duration = durations_table[entry];
+
+        // check if new weight is better
+        auto new_weight = weight + current_bucket.weight;
+        auto new_duration = duration + current_bucket.duration;
+
+        if (new_weight < 0)
+        {
+            if (addLoopWeight(facade, node, new_weight, new_duration))
+            {
+                if (!middle_nodes_table.empty() && new_weight < current_weight)
+                {
+                    middle_nodes_table[entry] = node;
+                }
+                current_weight = std::min(current_weight, new_weight);
+                current_duration = std::min(current_duration, new_duration);
+            }
+        }
+        else if (new_weight < current_weight)
+        {
+            current_weight = new_weight;
+            current_duration = new_duration;
+            if (!middle_nodes_table.empty())
+            {
+                middle_nodes_table[entry] = node;
+            }
+        }
+    }
+
+    relaxOutgoingEdges<DIRECTION>(facade, node, weight, duration, query_heap, phantom_node);
+}
+
+// Settles the next node and stores it in the search space bucket
+template <bool DIRECTION, typename Algorithm>
+void collectRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                        const unsigned row_or_column_idx,
+                        typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
+                        SearchSpaceWithBuckets &search_space_with_buckets,
+                        const PhantomNode &phantom_node,
+                        const EdgeDuration max_duration)
+{
+    const NodeID node = query_heap.DeleteMin();
+    const EdgeWeight weight = query_heap.GetKey(node);
+    const EdgeWeight duration = query_heap.GetData(node).duration;
+
+    if (duration > max_duration)
+    {
+        return;
+    }
+
+    const auto &data = query_heap.GetData(node);
+    search_space_with_buckets.emplace_back(
+        node, data.parent, isFromCliqueArc(data), row_or_column_idx, weight, duration);
+
+    relaxOutgoingEdges<DIRECTION>(facade, node, weight, duration, query_heap, phantom_node);
+}
+
+template <bool DIRECTION, typename Algorithm>
+void collectSearch(SearchEngineData<Algorithm> &engine_working_data,
+                   const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                   const unsigned row_or_column_idx,
+                   const PhantomNode &phantom,
+                   SearchSpaceWithBuckets &search_space_with_buckets,
+                   const ManyToManyBounds &bounds = {})
+{
+    CheckQueryDeadline();
+    auto &query_heap = *(engine_working_data.many_to_many_heap);
+
+    query_heap.Clear();
+    insertInHeap<DIRECTION>(query_heap, phantom);
+
+    // explore search space up to the bounds
+    while (!query_heap.Empty() && query_heap.MinKey() <= bounds.max_weight)
+    {
+        collectRoutingStep<DIRECTION>(facade,
+                                      row_or_column_idx,
+                                      query_heap,
+                                      search_space_with_buckets,
+                                      phantom,
+                                      bounds.max_duration);
+    }
+}
+
+// Phantoms of the collecting side whose searches run as one, see collectGroupSearch
+using CollectGroups = std::vector<std::vector<unsigned>>;
+
+// The CH searches start from the phantoms alone
+template <typename GetCollected>
+CollectGroups groupCollected(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &,
+                             const std::size_t number_of_collected,
+                             const GetCollected &)
+{
+    CollectGroups groups(number_of_collected);
+    for (const auto index : util::irange<std::size_t>(0, number_of_collected))
+        groups[index].push_back(index);
+    return groups;
+}
+
+// Phantoms on segments in the same level 1 cells search the same overlay graph, their searches
+// only differ in their weights at the boundary of the cell. At least CELL_GROUP_MIN_SIZE of
+// them are searched together in groups of up to CELL_GROUP_LANES, the others alone.
+template <typename GetCollected>
+CollectGroups
+groupCollected(const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+               const std::size_t number_of_collected,
+               const GetCollected &collected_phantom)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    const auto has_cells = partition.GetNumberOfLevels() > 1;
+    const auto cell = [&](const SegmentID &segment) {
+        return segment.enabled ? partition.GetCell(1, segment.id) : INVALID_CELL_ID;
+    };
+    const auto cells_of = [&](const std::size_t index) {
+        const auto &phantom = collected_phantom(index);
+        return std::make_pair(cell(phantom.forward_segment_id), cell(phantom.reverse_segment_id));
+    };
+
+    std::vector<unsigned> indices(number_of_collected);
+    std::iota(indices.begin(), indices.end(), 0);
+    if (has_cells)
+    {
+        std::stable_sort(indices.begin(), indices.end(), [&](const auto lhs, const auto rhs) {
+            return cells_of(lhs) < cells_of(rhs);
+        });
+    }
+
+    CollectGroups groups;
+    auto first = indices.begin();
+    while (first != indices.end())
+    {
+        const auto cells = cells_of(*first);
+        const auto last = has_cells ? std::find_if(first,
+                                                   indices.end(),
+                                                   [&](const auto index) {
+                                                       return cells_of(index) != cells;
+                                                   })
+                                    : first + 1;
+        if (static_cast<std::size_t>(last - first) < CELL_GROUP_MIN_SIZE)
+        {
+            for (; first != last; ++first)
+                groups.push_back({*first});
+            continue;
+        }
+        for (; first != last;)
+        {
+            const auto size = std::min<std::size_t>(last - first, CELL_GROUP_LANES);
+            groups.emplace_back(first, first + size);
+            first += size;
+        }
+    }
+    return groups;
+}
+
+template <bool DIRECTION, typename GetCollected>
+void collectGroupSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                        const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                        const std::vector<unsigned> &group,
+                        const GetCollected &collected_phantom,
+                        SearchSpaceWithBuckets &search_space_with_buckets,
+                        const ManyToManyBounds &bounds)
+{
+    for (const auto index : group)
+    {
+        collectSearch<DIRECTION>(engine_working_data,
+                                 facade,
+                                 index,
+                                 collected_phantom(index),
+                                 search_space_with_buckets,
+                                 bounds);
+    }
+}
+
+// One search for the phantoms of a group, which keeps a label with the weight, duration and
+// parent of every phantom at each node. The phantoms share their cells and so the query level
+// of every node, the search relaxes the same edges as the search of each phantom alone would.
+// A node is queued with the smallest weight of its labels that changed since it was relaxed
+// last and relaxes all of them, so a label can be relaxed again after it got smaller. The
+// buckets are only written at the end from the final labels, which is where the searches of
+// clustered phantoms overlap: the overlay part of the search is done once for all of them.
+template <bool DIRECTION, typename GetCollected>
+void collectGroupSearch(
+    SearchEngineData<mld::Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+    const std::vector<unsigned> &group,
+    const GetCollected &collected_phantom,
+    SearchSpaceWithBuckets &search_space_with_buckets,
+    const ManyToManyBounds &bounds)
+{
+    if (group.size() == 1)
     {
-        const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-        for (const NodeBucket &current_bucket : bucket_list)
+        collectSearch<DIRECTION>(engine_working_data,
+                                 facade,
+                                 group.front(),
+                                 collected_phantom(group.front()),
+                                 search_space_with_buckets,
+                                 bounds);
+        return;
+    }
+
+    CheckQueryDeadline();
+    const auto &partition = facade.GetMultiLevelPartition();
+    const auto &cells = facade.GetCellStorage();
+    const auto &group_phantom = collected_phantom(group.front());
+    const auto lanes = group.size();
+
+    using Label = ManyToManyGroupSearch::Label;
+    const Label unreached{INVALID_EDGE_WEIGHT, MAXIMAL_EDGE_DURATION, SPECIAL_NODEID, false, false};
+
+    // the labels and the queue keep their memory for the next groups of the thread
+    auto &group_search = *(engine_working_data.many_to_many_group_search);
+    group_search.Clear();
+    auto &slots = group_search.slots;
+    auto &nodes = group_search.nodes;
+    auto &labels = group_search.labels;
+    auto &queued_weights = group_search.queued_weights;
+    auto &queue = group_search.queue;
+    const std::greater<ManyToManyGroupSearch::QueueEntry> queue_order;
+
+    const auto update = [&](const NodeID node,
+                            const std::size_t lane,
+                            const EdgeWeight weight,
+                            const EdgeDuration duration,
+                            const NodeID parent,
+                            const bool from_clique_arc) {
+        const auto inserted = slots.emplace(node, nodes.size());
+        const auto slot = inserted.first->second;
+        if (inserted.second)
+        {
+            nodes.push_back(node);
+            labels.resize(labels.size() + lanes, unreached);
+            queued_weights.push_back(INVALID_EDGE_WEIGHT);
+        }
+
+        auto &label = labels[slot * lanes + lane];
+        if (weight >= label.weight)
+            return;
+        label = {weight, duration, parent, from_clique_arc, true};
+        if (weight < queued_weights[slot])
+        {
+            queued_weights[slot] = weight;
+            queue.emplace_back(weight, slot);
+            std::push_heap(queue.begin(), queue.end(), queue_order);
+        }
+    };
+
+    for (const auto lane : util::irange<std::size_t>(0, lanes))
+    {
+        const auto &phantom = collected_phantom(group[lane]);
+        const auto forward = phantom.forward_segment_id.id;
+        const auto reverse = phantom.reverse_segment_id.id;
+        if (DIRECTION == FORWARD_DIRECTION)
+        {
+            if (phantom.IsValidForwardSource())
+                update(forward,
+                       lane,
+                       -phantom.GetForwardWeightPlusOffset(),
+                       -phantom.GetForwardDuration(),
+                       forward,
+                       false);
+            if (phantom.IsValidReverseSource())
+                update(reverse,
+                       lane,
+                       -phantom.GetReverseWeightPlusOffset(),
+                       -phantom.GetReverseDuration(),
+                       reverse,
+                       false);
+        }
+        else
+        {
+            if (phantom.IsValidForwardTarget())
+                update(forward,
+                       lane,
+                       phantom.GetForwardWeightPlusOffset(),
+                       phantom.GetForwardDuration(),
+                       forward,
+                       false);
+            if (phantom.IsValidReverseTarget())
+                update(reverse,
+                       lane,
+                       phantom.GetReverseWeightPlusOffset(),
+                       phantom.GetReverseDuration(),
+                       reverse,
+                       false);
+        }
+    }
+
+    const auto highest_different_level = [&](const SegmentID &segment, const NodeID node) {
+        return segment.enabled ? partition.GetHighestDifferentLevel(segment.id, node)
+                               : INVALID_LEVEL_ID;
+    };
+
+    auto &relaxed = group_search.relaxed;
+    while (!queue.empty() && queue.front().first <= bounds.max_weight)
+    {
+        const auto weight = queue.front().first;
+        const auto slot = queue.front().second;
+        std::pop_heap(queue.begin(), queue.end(), queue_order);
+        queue.pop_back();
+        if (weight != queued_weights[slot])
+            continue;
+        queued_weights[slot] = INVALID_EDGE_WEIGHT;
+
+        // the labels are copied, the updates of other nodes can move them
+        relaxed.clear();
+        for (const auto lane : util::irange<std::size_t>(0, lanes))
         {
-            // get target id from bucket entry
-            const unsigned column_idx = current_bucket.target_id;
-            const EdgeWeight target_weight = current_bucket.weight;
-            const EdgeWeight target_duration = current_bucket.duration;
+            auto &label = labels[slot * lanes + lane];
+            if (!label.changed)
+                continue;
+            label.changed = false;
+            if (label.weight <= bounds.max_weight && label.duration <= bounds.max_duration)
+                relaxed.emplace_back(lane, label);
+        }
 
-            auto &current_weight = weights_table[row_idx * number_of_targets + column_idx];
-            auto &current_duration = durations_table[row_idx * number_of_targets + column_idx];
+        const auto node = nodes[slot];
+        const auto level =
+            std::min(highest_different_level(group_phantom.forward_segment_id, node),
+                     highest_different_level(group_phantom.reverse_segment_id, node));
 
-            // check if new weight is better
-            auto new_weight = source_weight + target_weight;
-            auto new_duration = source_duration + target_duration;
+        const auto relax_shortcuts = [&](const auto &ends, auto weights, auto durations) {
+            auto end = ends.begin();
+            auto shortcut_duration = durations.begin();
+            for (const auto shortcut_weight : weights)
+            {
+                const NodeID to = *end;
+                if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
+                {
+                    for (const auto &lane_and_label : relaxed)
+                    {
+                        const auto &label = lane_and_label.second;
+                        if (!label.from_clique_arc)
+                            update(to,
+                                   lane_and_label.first,
+                                   label.weight + shortcut_weight,
+                                   label.duration + *shortcut_duration,
+                                   node,
+                                   true);
+                    }
+                }
+                ++end;
+                ++shortcut_duration;
+            }
+        };
+        if (level >= 1)
+        {
+            const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
+            if (DIRECTION == FORWARD_DIRECTION)
+                relax_shortcuts(
+                    cell.GetDestinationNodes(), cell.GetOutWeight(node), cell.GetOutDuration(node));
+            else
+                relax_shortcuts(
+                    cell.GetSourceNodes(), cell.GetInWeight(node), cell.GetInDuration(node));
+        }
 
-            if (new_weight < 0)
+        for (const auto edge : facade.GetBorderEdgeRange(level, node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            if (DIRECTION == FORWARD_DIRECTION ? data.forward : data.backward)
             {
-                if (addLoopWeight(facade, node, new_weight, new_duration))
+                const NodeID to = facade.GetTarget(edge);
+                for (const auto &lane_and_label : relaxed)
                 {
-                    current_weight = std::min(current_weight, new_weight);
-                    current_duration = std::min(current_duration, new_duration);
+                    const auto &label = lane_and_label.second;
+                    update(to,
+                           lane_and_label.first,
+                           label.weight + data.weight,
+                           label.duration + data.duration,
+                           node,
+                           false);
                 }
             }
-            else if (new_weight < current_weight)
+        }
+    }
+
+    for (const auto slot : util::irange<std::size_t>(0, nodes.size()))
+    {
+        for (const auto lane : util::irange<std::size_t>(0, lanes))
+        {
+            const auto &label = labels[slot * lanes + lane];
+            if (label.weight != INVALID_EDGE_WEIGHT && label.weight <= bounds.max_weight &&
+                label.duration <= bounds.max_duration)
             {
-                current_weight = new_weight;
-                current_duration = new_duration;
+                search_space_with_buckets.emplace_back(nodes[slot],
+                                                       label.parent,
+                                                       label.from_clique_arc,
+                                                       group[lane],
+                                                       label.weight,
+                                                       label.duration);
             }
         }
     }
+}
+
+template <bool DIRECTION, typename Algorithm>
+void probeSearch(SearchEngineData<Algorithm> &engine_working_data,
+                 const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                 const unsigned row_or_column_idx,
+                 const unsigned number_of_targets,
+                 const PhantomNode &phantom,
+                 const SearchSpaceWithBuckets &search_space_with_buckets,
+                 std::vector<EdgeWeight> &weights_table,
+                 std::vector<EdgeWeight> &durations_table,
+                 std::vector<NodeID> &middle_nodes_table,
+                 const ManyToManyBounds &bounds)
+{
+    CheckQueryDeadline();
+    auto &query_heap = *(engine_working_data.many_to_many_heap);
+
+    query_heap.Clear();
+    insertInHeap<DIRECTION>(query_heap, phantom);
+
+    // explore search space up to the bounds
+    while (!query_heap.Empty() && query_heap.MinKey() <= bounds.max_weight)
+    {
+        probeRoutingStep<DIRECTION>(facade,
+                                    row_or_column_idx,
+                                    number_of_targets,
+                                    query_heap,
+                                    search_space_with_buckets,
+                                    weights_table,
+                                    durations_table,
+                                    middle_nodes_table,
+                                    phantom,
+                                    bounds.max_duration);
+    }
+}
+
+inline const NodeBucket &
+findBucket(const SearchSpaceWithBuckets &buckets, const NodeID node, const unsigned index)
+{
+    const auto bucket_list =
+        std::equal_range(buckets.begin(), buckets.end(), node, NodeBucket::Compare());
+    const auto bucket =
+        std::find_if(bucket_list.first, bucket_list.second, [index](const NodeBucket &bucket) {
+            return bucket.index == index;
+        });
+    BOOST_ASSERT(bucket != bucket_list.second);
+    return *bucket;
+}
+
+template <bool DIRECTION>
+PackedEdge makePackedEdge(const NodeID parent, const NodeID node, const bool from_clique_arc)
+{
+    // backward searches relax the edges towards their parents
+    if (DIRECTION == FORWARD_DIRECTION)
+        return {parent, node, from_clique_arc, true};
+    return {node, parent, from_clique_arc, false};
+}
+
+// Path of an entry of the table from its source to its target. The probing search, which still
+// holds its heap, met the search of the collected index at the middle node, the edges of that
+// one are retrieved from the parents in its buckets. A weight of the entry that is not the sum
+// of the weights of both at the middle node is the weight of a path over a loop at it.
+template <bool DIRECTION, typename ManyToManyQueryHeap>
+std::vector<PackedEdge> retrieveTablePackedPath(const ManyToManyQueryHeap &query_heap,
+                                                const SearchSpaceWithBuckets &buckets,
+                                                const NodeID middle,
+                                                const unsigned index,
+                                                const EdgeWeight weight)
+{
+    std::vector<PackedEdge> probed_edges;
+    for (auto node = middle; query_heap.GetData(node).parent != node;)
+    {
+        const auto &data = query_heap.GetData(node);
+        probed_edges.push_back(makePackedEdge<DIRECTION>(data.parent, node, isFromCliqueArc(data)));
+        node = data.parent;
+    }
+
+    std::vector<PackedEdge> collected_edges;
+    const auto *bucket = &findBucket(buckets, middle, index);
+    const bool over_loop = weight != query_heap.GetKey(middle) + bucket->weight;
+    while (bucket->parent_node != bucket->middle_node)
+    {
+        collected_edges.push_back(makePackedEdge<!DIRECTION>(
+            bucket->parent_node, bucket->middle_node, bucket->from_clique_arc));
+        bucket = &findBucket(buckets, bucket->parent_node, index);
+    }
+
+    // both were retrieved starting at the middle node
+    auto &forward_edges = DIRECTION == FORWARD_DIRECTION ? probed_edges : collected_edges;
+    const auto &reverse_edges = DIRECTION == FORWARD_DIRECTION ? collected_edges : probed_edges;
+    std::reverse(forward_edges.begin(), forward_edges.end());
+    if (over_loop)
+    {
+        forward_edges.push_back({middle, middle, false, true});
+    }
+    forward_edges.insert(forward_edges.end(), reverse_edges.begin(), reverse_edges.end());
+    return std::move(forward_edges);
+}
+
+// Distances of the entries the probing search of row_or_column_idx found paths for. Only these
+// paths are unpacked, the search of each entry itself never looks at the geometry.
+template <bool DIRECTION, typename Algorithm, typename GetCollected>
+void probedDistances(SearchEngineData<Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     const unsigned row_or_column_idx,
+                     const std::size_t number_of_collected,
+                     const std::size_t number_of_targets,
+                     const PhantomNode &phantom,
+                     const GetCollected &collected_phantom,
+                     const SearchSpaceWithBuckets &search_space_with_buckets,
+                     const std::vector<EdgeWeight> &weights_table,
+                     const std::vector<NodeID> &middle_nodes_table,
+                     std::vector<double> &distances_table)
+{
+    CheckQueryDeadline();
+    const auto &query_heap = *(engine_working_data.many_to_many_heap);
+
+    for (std::size_t index = 0; index < number_of_collected; ++index)
+    {
+        const auto row_idx = DIRECTION == FORWARD_DIRECTION ? row_or_column_idx : index;
+        const auto column_idx = DIRECTION == FORWARD_DIRECTION ? index : row_or_column_idx;
+        const auto entry = row_idx * number_of_targets + column_idx;
+        const auto middle = middle_nodes_table[entry];
+        if (middle == SPECIAL_NODEID)
+        {
+            continue;
+        }
 
-    relaxOutgoingEdges<FORWARD_DIRECTION>(
-        facade, node, source_weight, source_duration, query_heap, phantom_node);
+        const auto packed_path = retrieveTablePackedPath<DIRECTION>(
+            query_heap, search_space_with_buckets, middle, index, weights_table[entry]);
+        const auto &source_phantom =
+            DIRECTION == FORWARD_DIRECTION ? phantom : collected_phantom(index);
+        const auto &target_phantom =
+            DIRECTION == FORWARD_DIRECTION ? collected_phantom(index) : phantom;
+        distances_table[entry] = getTablePathDistance(
+            engine_working_data, facade, packed_path, middle, source_phantom, target_phantom);
+    }
 }
 
+// A path to a target found by a nearest targets search
+struct TargetCandidate
+{
+    unsigned index;
+    EdgeWeight weight;
+    EdgeDuration duration;
+};
+
+// Forward search that keeps the number_of_nearest targets with the shortest paths found so far.
+// Paths through nodes that are settled later are at least as long as the key of the node, so
+// the search stops once the key reaches the weight of the farthest of these targets.
 template <typename Algorithm>
-void backwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
-                         const unsigned column_idx,
-                         typename SearchEngineData<Algorithm>::ManyToManyQueryHeap &query_heap,
-                         SearchSpaceWithBuckets &search_space_with_buckets,
-                         const PhantomNode &phantom_node)
+std::vector<NearestTarget>
+probeNearestSearch(SearchEngineData<Algorithm> &engine_working_data,
+                   const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                   const unsigned row_idx,
+                   const std::size_t number_of_nearest,
+                   const PhantomNode &phantom,
+                   const SearchSpaceWithBuckets &search_space_with_buckets)
 {
-    const NodeID node = query_heap.DeleteMin();
-    const EdgeWeight target_weight = query_heap.GetKey(node);
-    const EdgeWeight target_duration = query_heap.GetData(node).duration;
+    CheckQueryDeadline();
+    auto &query_heap = *(engine_working_data.many_to_many_heap);
+
+    query_heap.Clear();
+    insertInHeap<FORWARD_DIRECTION>(query_heap, phantom);
+
+    std::vector<TargetCandidate> candidates;
+    candidates.reserve(number_of_nearest);
+    const auto by_weight = [](const TargetCandidate &lhs, const TargetCandidate &rhs) {
+        return lhs.weight < rhs.weight;
+    };
+
+    EdgeWeight weight_bound = INVALID_EDGE_WEIGHT;
+    while (!query_heap.Empty() && query_heap.MinKey() < weight_bound)
+    {
+        const NodeID node = query_heap.DeleteMin();
+        const EdgeWeight weight = query_heap.GetKey(node);
+        const EdgeWeight duration = query_heap.GetData(node).duration;
+
+        const auto bucket_list = boost::make_iterator_range(
+            std::equal_range(search_space_with_buckets.begin(),
+                             search_space_with_buckets.end(),
+                             node,
+                             NodeBucket::Compare()));
+        for (const auto &current_bucket : bucket_list)
+        {
+            if (current_bucket.index == row_idx)
+                continue;
+
+            auto new_weight = weight + current_bucket.weight;
+            auto new_duration = duration + current_bucket.duration;
+            if (new_weight < 0 && !addLoopWeight(facade, node, new_weight, new_duration))
+                continue;
+
+            const auto candidate = std::find_if(
+                candidates.begin(), candidates.end(), [&](const TargetCandidate &target) {
+                    return target.index == current_bucket.index;
+                });
+            if (candidate != candidates.end())
+            {
+                if (new_weight < candidate->weight)
+                    *candidate = {current_bucket.index, new_weight, new_duration};
+            }
+            else if (candidates.size() < number_of_nearest)
+            {
+                candidates.push_back({current_bucket.index, new_weight, new_duration});
+            }
+            else
+            {
+                const auto farthest =
+                    std::max_element(candidates.begin(), candidates.end(), by_weight);
+                if (new_weight < farthest->weight)
+                    *farthest = {current_bucket.index, new_weight, new_duration};
+            }
+        }
+
+        if (candidates.size() == number_of_nearest)
+        {
+            weight_bound =
+                std::max_element(candidates.begin(), candidates.end(), by_weight)->weight;
+        }
+
+        relaxOutgoingEdges<FORWARD_DIRECTION>(facade, node, weight, duration, query_heap, phantom);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), by_weight);
+    std::vector<NearestTarget> nearest_targets;
+    nearest_targets.reserve(candidates.size());
+    for (const auto &candidate : candidates)
+    {
+        nearest_targets.push_back({candidate.index, candidate.duration});
+    }
+    return nearest_targets;
+}
+
+// Collects the search spaces of the phantoms of one side of the table into buckets and probes
+// them with the searches of the other side. Backward searches of the targets collect columns
+// and forward searches of the sources probe them for their rows, or forward searches collect
+// rows that backward searches probe, see probeRoutingStep.
+template <bool COLLECT_DIRECTION, typename Algorithm, typename GetCollected, typename GetProbed>
+void bucketManyToManySearch(
+    SearchEngineData<Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+    const std::size_t number_of_collected,
+    const std::size_t number_of_probed,
+    const std::size_t number_of_targets,
+    const GetCollected &collected_phantom,
+    const GetProbed &probed_phantom,
+    std::vector<EdgeWeight> &weights_table,
+    std::vector<EdgeWeight> &durations_table,
+    std::vector<NodeID> &middle_nodes_table,
+    std::vector<double> &distances_table,
+    const ManyToManyBounds &collect_bounds,
+    const ManyToManyBounds &probe_bounds)
+{
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
+
+    auto &search_space_with_buckets = *(engine_working_data.many_to_many_buckets);
+    for (const auto &group : groupCollected(facade, number_of_collected, collected_phantom))
+    {
+        collectGroupSearch<COLLECT_DIRECTION>(engine_working_data,
+                                              facade,
+                                              group,
+                                              collected_phantom,
+                                              search_space_with_buckets,
+                                              collect_bounds);
+    }
+
+    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+
+    for (std::size_t index = 0; index < number_of_probed; ++index)
+    {
+        probeSearch<!COLLECT_DIRECTION>(engine_working_data,
+                                        facade,
+                                        index,
+                                        number_of_targets,
+                                        probed_phantom(index),
+                                        search_space_with_buckets,
+                                        weights_table,
+                                        durations_table,
+                                        middle_nodes_table,
+                                        probe_bounds);
+        if (!distances_table.empty())
+        {
+            probedDistances<!COLLECT_DIRECTION>(engine_working_data,
+                                                facade,
+                                                index,
+                                                number_of_collected,
+                                                number_of_targets,
+                                                probed_phantom(index),
+                                                collected_phantom,
+                                                search_space_with_buckets,
+                                                weights_table,
+                                                middle_nodes_table,
+                                                distances_table);
+        }
+    }
+}
+
+// Like bucketManyToManySearch but runs the collecting searches in parallel, each task
+// collecting buckets into its own thread-local set that are merged into one sorted search space
+// afterwards. The probing searches then write disjoint rows or columns of the tables and can
+// run in parallel without locking.
+template <bool COLLECT_DIRECTION, typename Algorithm, typename GetCollected, typename GetProbed>
+void parallelManyToManySearch(
+    SearchEngineData<Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+    const std::size_t number_of_collected,
+    const std::size_t number_of_probed,
+    const std::size_t number_of_targets,
+    const GetCollected &collected_phantom,
+    const GetProbed &probed_phantom,
+    std::vector<EdgeWeight> &weights_table,
+    std::vector<EdgeWeight> &durations_table,
+    std::vector<NodeID> &middle_nodes_table,
+    std::vector<double> &distances_table,
+    const ManyToManyBounds &collect_bounds,
+    const ManyToManyBounds &probe_bounds)
+{
+    const auto number_of_nodes = facade.GetNumberOfNodes();
+
+    const auto groups = groupCollected(facade, number_of_collected, collected_phantom);
+
+    const auto *deadline = CurrentQueryDeadline();
+    tbb::task_arena arena(engine_working_data.many_to_many_concurrency);
+    arena.execute([&] {
+        tbb::enumerable_thread_specific<SearchSpaceWithBuckets> thread_buckets;
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, groups.size()),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                const ScopedQueryDeadline task_deadline(deadline);
+                engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(number_of_nodes);
+                auto &buckets = thread_buckets.local();
+                for (auto index = range.begin(); index != range.end(); ++index)
+                {
+                    collectGroupSearch<COLLECT_DIRECTION>(engine_working_data,
+                                                          facade,
+                                                          groups[index],
+                                                          collected_phantom,
+                                                          buckets,
+                                                          collect_bounds);
+                }
+            });
 
-    // store settled nodes in search space bucket
-    search_space_with_buckets[node].emplace_back(column_idx, target_weight, target_duration);
+        std::size_t number_of_buckets = 0;
+        for (const auto &buckets : thread_buckets)
+        {
+            number_of_buckets += buckets.size();
+        }
+        SearchSpaceWithBuckets search_space_with_buckets;
+        search_space_with_buckets.reserve(number_of_buckets);
+        for (const auto &buckets : thread_buckets)
+        {
+            search_space_with_buckets.insert(
+                search_space_with_buckets.end(), buckets.begin(), buckets.end());
+        }
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
 
-    relaxOutgoingEdges<REVERSE_DIRECTION>(
-        facade, node, target_weight, target_duration, query_heap, phantom_node);
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_probed),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                const ScopedQueryDeadline task_deadline(deadline);
+                engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(number_of_nodes);
+                for (auto index = range.begin(); index != range.end(); ++index)
+                {
+                    probeSearch<!COLLECT_DIRECTION>(engine_working_data,
+                                                    facade,
+                                                    index,
+                                                    number_of_targets,
+                                                    probed_phantom(index),
+                                                    search_space_with_buckets,
+                                                    weights_table,
+                                                    durations_table,
+                                                    middle_nodes_table,
+                                                    probe_bounds);
+                    if (!distances_table.empty())
+                    {
+                        probedDistances<!COLLECT_DIRECTION>(engine_working_data,
+                                                            facade,
+                                                            index,
+                                                            number_of_collected,
+                                                            number_of_targets,
+                                                            probed_phantom(index),
+                                                            collected_phantom,
+                                                            search_space_with_buckets,
+                                                            weights_table,
+                                                            middle_nodes_table,
+                                                            distances_table);
+                    }
+                }
+            });
+    });
+}
+
+// The searches of the targets meet the ones of the sources, which start at the negative offsets
+// of their phantoms. The paths of the targets to the middle nodes can be longer than the whole
+// paths by the largest of these offsets.
+template <typename GetSource>
+ManyToManyBounds getTargetBounds(const ManyToManyBounds &bounds,
+                                 const std::size_t number_of_sources,
+                                 const GetSource &source_phantom)
+{
+    std::int64_t max_weight_offset = 0;
+    std::int64_t max_duration_offset = 0;
+    for (std::size_t index = 0; index < number_of_sources; ++index)
+    {
+        const auto &phantom = source_phantom(index);
+        if (phantom.IsValidForwardSource())
+        {
+            max_weight_offset = std::max<std::int64_t>(max_weight_offset,
+                                                       phantom.GetForwardWeightPlusOffset());
+            max_duration_offset =
+                std::max<std::int64_t>(max_duration_offset, phantom.GetForwardDuration());
+        }
+        if (phantom.IsValidReverseSource())
+        {
+            max_weight_offset = std::max<std::int64_t>(max_weight_offset,
+                                                       phantom.GetReverseWeightPlusOffset());
+            max_duration_offset =
+                std::max<std::int64_t>(max_duration_offset, phantom.GetReverseDuration());
+        }
+    }
+
+    ManyToManyBounds target_bounds;
+    if (bounds.max_weight != INVALID_EDGE_WEIGHT)
+    {
+        target_bounds.max_weight = static_cast<EdgeWeight>(std::min<std::int64_t>(
+            bounds.max_weight + max_weight_offset, INVALID_EDGE_WEIGHT - 1));
+    }
+    if (bounds.max_duration != MAXIMAL_EDGE_DURATION)
+    {
+        target_bounds.max_duration = static_cast<EdgeDuration>(std::min<std::int64_t>(
+            bounds.max_duration + max_duration_offset, MAXIMAL_EDGE_DURATION - 1));
+    }
+    return target_bounds;
+}
+
+// Both searches of an entry stay within the bounds, the paths they make up can still be beyond
+inline void applyBounds(const ManyToManyBounds &bounds,
+                        const std::vector<EdgeWeight> &weights_table,
+                        std::vector<EdgeWeight> &durations_table,
+                        std::vector<double> &distances_table)
+{
+    for (std::size_t entry = 0; entry < durations_table.size(); ++entry)
+    {
+        if (weights_table[entry] > bounds.max_weight ||
+            durations_table[entry] > bounds.max_duration)
+        {
+            durations_table[entry] = MAXIMAL_EDGE_DURATION;
+            if (!distances_table.empty())
+            {
+                distances_table[entry] = std::numeric_limits<double>::max();
+            }
+        }
+    }
 }
 }
 
@@ -296,7 +1389,9 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
                  const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                  const std::vector<PhantomNode> &phantom_nodes,
                  const std::vector<std::size_t> &source_indices,
-                 const std::vector<std::size_t> &target_indices)
+                 const std::vector<std::size_t> &target_indices,
+                 std::vector<double> *distances_table,
+                 const ManyToManyBounds &bounds)
 {
     const auto number_of_sources =
         source_indices.empty() ? phantom_nodes.size() : source_indices.size();
@@ -307,80 +1402,145 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
     std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
     std::vector<EdgeWeight> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
 
-    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
-
-    auto &query_heap = *(engine_working_data.many_to_many_heap);
+    // the middle nodes are only kept to retrieve the paths of the distances
+    const auto calculate_distance = distances_table != nullptr;
+    std::vector<NodeID> middle_nodes_table(calculate_distance ? number_of_entries : 0,
+                                           SPECIAL_NODEID);
+    std::vector<double> no_distances;
+    auto &distances = calculate_distance ? *distances_table : no_distances;
+    distances.assign(calculate_distance ? number_of_entries : 0,
+                     std::numeric_limits<double>::max());
 
-    SearchSpaceWithBuckets search_space_with_buckets;
+    const auto source_phantom = [&](const std::size_t row_idx) -> const PhantomNode & {
+        return source_indices.empty() ? phantom_nodes[row_idx]
+                                      : phantom_nodes[source_indices[row_idx]];
+    };
+    const auto target_phantom = [&](const std::size_t column_idx) -> const PhantomNode & {
+        return target_indices.empty() ? phantom_nodes[column_idx]
+                                      : phantom_nodes[target_indices[column_idx]];
+    };
 
-    unsigned column_idx = 0;
-    const auto search_target_phantom = [&](const PhantomNode &phantom) {
-        // clear heap and insert target nodes
-        query_heap.Clear();
-        insertTargetInHeap(query_heap, phantom);
+    // the searches of the sources start at the beginning of the paths
+    const auto &source_bounds = bounds;
+    const auto target_bounds =
+        bounds.IsBounded() ? getTargetBounds(bounds, number_of_sources, source_phantom) : bounds;
 
-        // explore search space
-        while (!query_heap.Empty())
+    // the labels keep no paths to take the distances of
+    if (!calculate_distance && hubLabelSearch(engine_working_data,
+                                              facade,
+                                              phantom_nodes,
+                                              source_indices,
+                                              target_indices,
+                                              weights_table,
+                                              durations_table))
+    {
+        if (bounds.IsBounded())
         {
-            backwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets, phantom);
+            applyBounds(bounds, weights_table, durations_table, distances);
         }
-        ++column_idx;
-    };
+        return durations_table;
+    }
 
-    // for each source do forward search
-    unsigned row_idx = 0;
-    const auto search_source_phantom = [&](const PhantomNode &phantom) {
-        // clear heap and insert source nodes
-        query_heap.Clear();
-        insertSourceInHeap(query_heap, phantom);
+    // The smaller side collects the buckets, so skewed tables store fewer of them and the
+    // searches of the larger side scan a smaller search space
+    const bool collect_sources = number_of_sources < number_of_targets;
 
-        // explore search space
-        while (!query_heap.Empty())
+    if (engine_working_data.many_to_many_concurrency > 1 &&
+        std::min(number_of_sources, number_of_targets) > 1)
+    {
+        if (collect_sources)
         {
-            forwardRoutingStep(facade,
-                               row_idx,
-                               number_of_targets,
-                               query_heap,
-                               search_space_with_buckets,
-                               weights_table,
-                               durations_table,
-                               phantom);
+            parallelManyToManySearch<FORWARD_DIRECTION>(engine_working_data,
+                                                        facade,
+                                                        number_of_sources,
+                                                        number_of_targets,
+                                                        number_of_targets,
+                                                        source_phantom,
+                                                        target_phantom,
+                                                        weights_table,
+                                                        durations_table,
+                                                        middle_nodes_table,
+                                                        distances,
+                                                        source_bounds,
+                                                        target_bounds);
         }
-        ++row_idx;
-    };
-
-    if (target_indices.empty())
-    {
-        for (const auto &phantom : phantom_nodes)
+        else
         {
-            search_target_phantom(phantom);
+            parallelManyToManySearch<REVERSE_DIRECTION>(engine_working_data,
+                                                        facade,
+                                                        number_of_targets,
+                                                        number_of_sources,
+                                                        number_of_targets,
+                                                        target_phantom,
+                                                        source_phantom,
+                                                        weights_table,
+                                                        durations_table,
+                                                        middle_nodes_table,
+                                                        distances,
+                                                        target_bounds,
+                                                        source_bounds);
         }
-    }
-    else
-    {
-        for (const auto index : target_indices)
+        if (bounds.IsBounded())
         {
-            const auto &phantom = phantom_nodes[index];
-            search_target_phantom(phantom);
+            applyBounds(bounds, weights_table, durations_table, distances);
         }
+        return durations_table;
     }
 
-    if (source_indices.empty())
+    // the sweep does not keep the paths it finds and is not bounded, up to a full batch of
+    // sources take a single sweep
+    if (!calculate_distance && !bounds.IsBounded() &&
+        number_of_sources <= RESTRICTED_SWEEP_LANES &&
+        number_of_targets >= RESTRICTED_SWEEP_MIN_TARGETS &&
+        restrictedSweepSearch(engine_working_data,
+                              facade,
+                              phantom_nodes,
+                              source_indices,
+                              target_indices,
+                              durations_table))
     {
-        for (const auto &phantom : phantom_nodes)
-        {
-            search_source_phantom(phantom);
-        }
+        return durations_table;
+    }
+
+    // e.g. one-to-many collects the search space of the single source once and lets the
+    // backward searches of the targets probe it
+    if (collect_sources)
+    {
+        bucketManyToManySearch<FORWARD_DIRECTION>(engine_working_data,
+                                                  facade,
+                                                  number_of_sources,
+                                                  number_of_targets,
+                                                  number_of_targets,
+                                                  source_phantom,
+                                                  target_phantom,
+                                                  weights_table,
+                                                  durations_table,
+                                                  middle_nodes_table,
+                                                  distances,
+                                                  source_bounds,
+                                                  target_bounds);
     }
     else
     {
-        for (const auto index : source_indices)
-        {
-            const auto &phantom = phantom_nodes[index];
-            search_source_phantom(phantom);
-        }
+        bucketManyToManySearch<REVERSE_DIRECTION>(engine_working_data,
+                                                  facade,
+                                                  number_of_targets,
+                                                  number_of_sources,
+                                                  number_of_targets,
+                                                  target_phantom,
+                                                  source_phantom,
+                                                  weights_table,
+                                                  durations_table,
+                                                  middle_nodes_table,
+                                                  distances,
+                                                  target_bounds,
+                                                  source_bounds);
     }
 
+    if (bounds.IsBounded())
+    {
+        applyBounds(bounds, weights_table, durations_table, distances);
+    }
     return durations_table;
 }
 
@@ -389,14 +1549,102 @@ manyToManySearch(SearchEngineData<ch::Algorithm> &engine_working_data,
                  const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
                  const std::vector<PhantomNode> &phantom_nodes,
                  const std::vector<std::size_t> &source_indices,
-                 const std::vector<std::size_t> &target_indices);
+                 const std::vector<std::size_t> &target_indices,
+                 std::vector<double> *distances_table,
+                 const ManyToManyBounds &bounds);
+
+// the customized CCH is searched like a CH
+template <>
+std::vector<EdgeWeight>
+manyToManySearch(SearchEngineData<cch::Algorithm> &engine_working_data,
+                 const datafacade::ContiguousInternalMemoryDataFacade<cch::Algorithm> &facade,
+                 const std::vector<PhantomNode> &phantom_nodes,
+                 const std::vector<std::size_t> &source_indices,
+                 const std::vector<std::size_t> &target_indices,
+                 std::vector<double> *distances_table,
+                 const ManyToManyBounds &bounds)
+{
+    return manyToManySearch<ch::Algorithm>(engine_working_data,
+                                           facade,
+                                           phantom_nodes,
+                                           source_indices,
+                                           target_indices,
+                                           distances_table,
+                                           bounds);
+}
 
 template std::vector<EdgeWeight>
 manyToManySearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                  const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
                  const std::vector<PhantomNode> &phantom_nodes,
                  const std::vector<std::size_t> &source_indices,
-                 const std::vector<std::size_t> &target_indices);
+                 const std::vector<std::size_t> &target_indices,
+                 std::vector<double> *distances_table,
+                 const ManyToManyBounds &bounds);
+
+template <typename Algorithm>
+std::vector<std::vector<NearestTarget>>
+nearestTargetsSearch(SearchEngineData<Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     const std::vector<PhantomNode> &phantom_nodes,
+                     const std::size_t number_of_nearest)
+{
+    std::vector<std::vector<NearestTarget>> nearest_targets(phantom_nodes.size());
+    if (number_of_nearest == 0)
+    {
+        return nearest_targets;
+    }
+
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
+
+    auto &search_space_with_buckets = *(engine_working_data.many_to_many_buckets);
+
+    for (std::size_t column_idx = 0; column_idx < phantom_nodes.size(); ++column_idx)
+    {
+        collectSearch<REVERSE_DIRECTION>(engine_working_data,
+                                         facade,
+                                         column_idx,
+                                         phantom_nodes[column_idx],
+                                         search_space_with_buckets);
+    }
+
+    std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+
+    for (std::size_t row_idx = 0; row_idx < phantom_nodes.size(); ++row_idx)
+    {
+        nearest_targets[row_idx] = probeNearestSearch(engine_working_data,
+                                                      facade,
+                                                      row_idx,
+                                                      number_of_nearest,
+                                                      phantom_nodes[row_idx],
+                                                      search_space_with_buckets);
+    }
+
+    return nearest_targets;
+}
+
+template std::vector<std::vector<NearestTarget>>
+nearestTargetsSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                     const std::vector<PhantomNode> &phantom_nodes,
+                     const std::size_t number_of_nearest);
+
+template <>
+std::vector<std::vector<NearestTarget>>
+nearestTargetsSearch(SearchEngineData<cch::Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<cch::Algorithm> &facade,
+                     const std::vector<PhantomNode> &phantom_nodes,
+                     const std::size_t number_of_nearest)
+{
+    return nearestTargetsSearch<ch::Algorithm>(
+        engine_working_data, facade, phantom_nodes, number_of_nearest);
+}
+
+template std::vector<std::vector<NearestTarget>>
+nearestTargetsSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+                     const std::vector<PhantomNode> &phantom_nodes,
+                     const std::size_t number_of_nearest);
 
 } // namespace routing_algorithms
 } // namespace engine
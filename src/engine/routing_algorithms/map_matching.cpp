@@ -5,6 +5,7 @@
 #include "engine/map_matching/hidden_markov_model.hpp"
 #include "engine/map_matching/matching_confidence.hpp"
 #include "engine/map_matching/sub_matching.hpp"
+#include "engine/query_deadline.hpp"
 
 #include "util/coordinate_calculation.hpp"
 #include "util/for_each_pair.hpp"
@@ -55,10 +56,10 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                             const std::vector<util::Coordinate> &trace_coordinates,
                             const std::vector<unsigned> &trace_timestamps,
                             const std::vector<boost::optional<double>> &trace_gps_precision,
-                            const bool allow_splitting)
+                            const bool allow_splitting,
+                            TraceContinuation *continuation)
 {
     map_matching::MatchingConfidence confidence;
-    map_matching::EmissionLogProbability default_emission_log_probability(DEFAULT_GPS_PRECISION);
     map_matching::TransitionLogProbability transition_log_probability(MATCHING_BETA);
 
     SubMatchingList sub_matchings;
@@ -80,47 +81,31 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
     }();
     const auto max_broken_time = median_sample_time * MAX_BROKEN_STATES;
 
+    // gps precisions are mostly the same for all points of a trace, so the constants of the
+    // emission probability are only recomputed if it changes
     std::vector<std::vector<double>> emission_log_probabilities(trace_coordinates.size());
-    if (trace_gps_precision.empty())
+    map_matching::EmissionLogProbability emission_log_probability(DEFAULT_GPS_PRECISION);
+    for (auto t = 0UL; t < candidates_list.size(); ++t)
     {
-        for (auto t = 0UL; t < candidates_list.size(); ++t)
+        const auto sigma_z = !trace_gps_precision.empty() && trace_gps_precision[t]
+                                 ? *trace_gps_precision[t]
+                                 : DEFAULT_GPS_PRECISION;
+        if (sigma_z != emission_log_probability.sigma_z)
         {
-            emission_log_probabilities[t].resize(candidates_list[t].size());
-            std::transform(candidates_list[t].begin(),
-                           candidates_list[t].end(),
-                           emission_log_probabilities[t].begin(),
-                           [&](const PhantomNodeWithDistance &candidate) {
-                               return default_emission_log_probability(candidate.distance);
-                           });
+            emission_log_probability = map_matching::EmissionLogProbability(sigma_z);
         }
+        emission_log_probability(candidates_list[t], emission_log_probabilities[t]);
     }
-    else
+
+    if (continuation)
     {
-        for (auto t = 0UL; t < candidates_list.size(); ++t)
+        if (!continuation->first_log_probabilities.empty())
         {
-            emission_log_probabilities[t].resize(candidates_list[t].size());
-            if (trace_gps_precision[t])
-            {
-                map_matching::EmissionLogProbability emission_log_probability(
-                    *trace_gps_precision[t]);
-                std::transform(
-                    candidates_list[t].begin(),
-                    candidates_list[t].end(),
-                    emission_log_probabilities[t].begin(),
-                    [&emission_log_probability](const PhantomNodeWithDistance &candidate) {
-                        return emission_log_probability(candidate.distance);
-                    });
-            }
-            else
-            {
-                std::transform(candidates_list[t].begin(),
-                               candidates_list[t].end(),
-                               emission_log_probabilities[t].begin(),
-                               [&](const PhantomNodeWithDistance &candidate) {
-                                   return default_emission_log_probability(candidate.distance);
-                               });
-            }
+            BOOST_ASSERT(continuation->first_log_probabilities.size() ==
+                         candidates_list.front().size());
+            emission_log_probabilities.front() = continuation->first_log_probabilities;
         }
+        continuation->last_log_probabilities.clear();
     }
 
     HMM model(candidates_list, emission_log_probabilities);
@@ -144,6 +129,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
     prev_unbroken_timestamps.push_back(initial_timestamp);
     for (auto t = initial_timestamp + 1; t < candidates_list.size(); ++t)
     {
+        // checked once per timestamp, before the searches between its candidates
+        CheckQueryDeadline();
 
         const auto step_time = [&] {
             if (use_timestamps)
@@ -204,6 +191,8 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                 ((haversine_distance + max_distance_delta) / 4.) * facade.GetWeightMultiplier();
 
             // compute d_t for this timestamp and the next one
+            std::vector<std::size_t> transitions;
+            std::vector<PhantomNode> transition_targets;
             for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
             {
                 if (prev_pruned[s])
@@ -211,23 +200,39 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
                     continue;
                 }
 
+                // the candidates that can still improve, are all searched from s at once
+                transitions.clear();
+                transition_targets.clear();
                 for (const auto s_prime : util::irange<std::size_t>(0UL, current_viterbi.size()))
                 {
                     const double emission_pr = emission_log_probabilities[t][s_prime];
-                    double new_value = prev_viterbi[s] + emission_pr;
-                    if (current_viterbi[s_prime] > new_value)
+                    if (current_viterbi[s_prime] > prev_viterbi[s] + emission_pr)
                     {
                         continue;
                     }
+                    transitions.push_back(s_prime);
+                    transition_targets.push_back(current_timestamps_list[s_prime].phantom_node);
+                }
+                if (transitions.empty())
+                {
+                    continue;
+                }
+
+                const auto network_distances =
+                    getNetworkDistances(engine_working_data,
+                                        facade,
+                                        forward_heap,
+                                        reverse_heap,
+                                        prev_unbroken_timestamps_list[s].phantom_node,
+                                        transition_targets,
+                                        weight_upper_bound);
 
-                    double network_distance =
-                        getNetworkDistance(engine_working_data,
-                                           facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           prev_unbroken_timestamps_list[s].phantom_node,
-                                           current_timestamps_list[s_prime].phantom_node,
-                                           weight_upper_bound);
+                for (const auto transition : util::irange<std::size_t>(0UL, transitions.size()))
+                {
+                    const auto s_prime = transitions[transition];
+                    const double emission_pr = emission_log_probabilities[t][s_prime];
+                    double new_value = prev_viterbi[s] + emission_pr;
+                    const double network_distance = network_distances[transition];
 
                     // get distance diff between loc1/2 and locs/s_prime
                     const auto d_t = std::abs(network_distance - haversine_distance);
@@ -308,6 +313,21 @@ SubMatchingList mapMatching(SearchEngineData<Algorithm> &engine_working_data,
         split_points.push_back(prev_unbroken_timestamps.back() + 1);
     }
 
+    const auto last_timestamp = candidates_list.size() - 1;
+    if (continuation && !model.breakage[last_timestamp])
+    {
+        // only the differences of the values matter for the viterbi path, shifting them keeps
+        // the values of long traces in range
+        auto &last_log_probabilities = continuation->last_log_probabilities;
+        last_log_probabilities = model.viterbi[last_timestamp];
+        const auto max_log_probability =
+            *std::max_element(last_log_probabilities.begin(), last_log_probabilities.end());
+        for (auto &log_probability : last_log_probabilities)
+        {
+            log_probability -= max_log_probability;
+        }
+    }
+
     std::size_t sub_matching_begin = initial_timestamp;
     for (const auto sub_matching_end : split_points)
     {
@@ -427,7 +447,30 @@ mapMatching(SearchEngineData<ch::Algorithm> &engine_working_data,
             const std::vector<util::Coordinate> &trace_coordinates,
             const std::vector<unsigned> &trace_timestamps,
             const std::vector<boost::optional<double>> &trace_gps_precision,
-            const bool allow_splitting);
+            const bool allow_splitting,
+            TraceContinuation *continuation);
+
+// the customized CCH is searched like a CH
+template <>
+SubMatchingList
+mapMatching(SearchEngineData<cch::Algorithm> &engine_working_data,
+            const datafacade::ContiguousInternalMemoryDataFacade<cch::Algorithm> &facade,
+            const CandidateLists &candidates_list,
+            const std::vector<util::Coordinate> &trace_coordinates,
+            const std::vector<unsigned> &trace_timestamps,
+            const std::vector<boost::optional<double>> &trace_gps_precision,
+            const bool allow_splitting,
+            TraceContinuation *continuation)
+{
+    return mapMatching<ch::Algorithm>(engine_working_data,
+                                      facade,
+                                      candidates_list,
+                                      trace_coordinates,
+                                      trace_timestamps,
+                                      trace_gps_precision,
+                                      allow_splitting,
+                                      continuation);
+}
 
 template SubMatchingList
 mapMatching(SearchEngineData<corech::Algorithm> &engine_working_data,
@@ -436,7 +479,8 @@ mapMatching(SearchEngineData<corech::Algorithm> &engine_working_data,
             const std::vector<util::Coordinate> &trace_coordinates,
             const std::vector<unsigned> &trace_timestamps,
             const std::vector<boost::optional<double>> &trace_gps_precision,
-            const bool allow_splitting);
+            const bool allow_splitting,
+            TraceContinuation *continuation);
 
 template SubMatchingList
 mapMatching(SearchEngineData<mld::Algorithm> &engine_working_data,
@@ -445,7 +489,8 @@ mapMatching(SearchEngineData<mld::Algorithm> &engine_working_data,
             const std::vector<util::Coordinate> &trace_coordinates,
             const std::vector<unsigned> &trace_timestamps,
             const std::vector<boost::optional<double>> &trace_gps_precision,
-            const bool allow_splitting);
+            const bool allow_splitting,
+            TraceContinuation *continuation);
 
 } // namespace routing_algorithms
 } // namespace engine
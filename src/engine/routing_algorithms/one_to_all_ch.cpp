@@ -0,0 +1,499 @@
+#include "engine/routing_algorithms/one_to_all.hpp"
+#include "engine/routing_algorithms/routing_base_ch.hpp"
+
+#include "contractor/downward_sweep_graph.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+namespace
+{
+using SweepGraph = contractor::DownwardSweepGraph;
+using Rank = SweepGraph::Rank;
+using ManyToManyQueryHeap = SearchEngineData<ch::Algorithm>::ManyToManyQueryHeap;
+
+// Best way back to the start of a source node after leaving it. Targets that lie before the
+// source on the same segment can only be reached like that.
+class SourceReentries
+{
+  public:
+    explicit SourceReentries(const PhantomNode &source)
+    {
+        if (source.IsValidForwardSource())
+            entries[0].node = source.forward_segment_id.id;
+        if (source.IsValidReverseSource())
+            entries[1].node = source.reverse_segment_id.id;
+    }
+
+    bool IsSource(const NodeID node) const
+    {
+        return node != SPECIAL_NODEID && (entries[0].node == node || entries[1].node == node);
+    }
+
+    void Update(const NodeID node, const EdgeWeight weight, const EdgeDuration duration)
+    {
+        for (auto &entry : entries)
+        {
+            if (entry.node == node && weight < entry.weight)
+            {
+                entry.weight = weight;
+                entry.duration = duration;
+            }
+        }
+    }
+
+    // Adds the way back to a negative weight of a target on a source segment
+    bool Reenter(const NodeID node, EdgeWeight &weight, EdgeDuration &duration) const
+    {
+        BOOST_ASSERT(weight < 0);
+        for (const auto &entry : entries)
+        {
+            if (entry.node == node && entry.weight != INVALID_EDGE_WEIGHT)
+            {
+                weight = entry.weight + weight - initial_weight(node);
+                duration = entry.duration + duration - initial_duration(node);
+                return weight >= 0;
+            }
+        }
+        return false;
+    }
+
+    void SetInitial(const NodeID node, const EdgeWeight weight, const EdgeDuration duration)
+    {
+        for (auto &entry : entries)
+        {
+            if (entry.node == node)
+            {
+                entry.initial_weight = weight;
+                entry.initial_duration = duration;
+            }
+        }
+    }
+
+  private:
+    EdgeWeight initial_weight(const NodeID node) const
+    {
+        return entries[0].node == node ? entries[0].initial_weight : entries[1].initial_weight;
+    }
+
+    EdgeDuration initial_duration(const NodeID node) const
+    {
+        return entries[0].node == node ? entries[0].initial_duration : entries[1].initial_duration;
+    }
+
+    struct Entry
+    {
+        NodeID node = SPECIAL_NODEID;
+        EdgeWeight initial_weight = 0;
+        EdgeDuration initial_duration = 0;
+        EdgeWeight weight = INVALID_EDGE_WEIGHT;
+        EdgeDuration duration = MAXIMAL_EDGE_DURATION;
+    };
+    std::array<Entry, 2> entries;
+};
+
+// Upward search from the source, reports every settled node. The weights of stalled nodes are
+// not minimal but still belong to a path, the sweep corrects them from above.
+template <typename SettleCallback>
+void upwardSearch(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+                  ManyToManyQueryHeap &query_heap,
+                  const PhantomNode &source_phantom,
+                  SourceReentries &reentries,
+                  const SettleCallback &settle)
+{
+    query_heap.Clear();
+    insertSourceInHeap(query_heap, source_phantom);
+
+    for (const auto &segment : {source_phantom.forward_segment_id.id,
+                                source_phantom.reverse_segment_id.id})
+    {
+        if (reentries.IsSource(segment) && query_heap.WasInserted(segment))
+        {
+            const auto weight = query_heap.GetKey(segment);
+            const auto duration = query_heap.GetData(segment).duration;
+            reentries.SetInitial(segment, weight, duration);
+
+            // Special case for CH when contractor creates a loop edge node->node
+            const auto loop_weight = ch::getLoopWeight<false>(facade, segment);
+            if (loop_weight != INVALID_EDGE_WEIGHT)
+            {
+                reentries.Update(segment,
+                                 weight + loop_weight,
+                                 duration + ch::getLoopWeight<true>(facade, segment));
+            }
+        }
+    }
+
+    while (!query_heap.Empty())
+    {
+        const NodeID node = query_heap.DeleteMin();
+        const EdgeWeight weight = query_heap.GetKey(node);
+        const EdgeDuration duration = query_heap.GetData(node).duration;
+
+        settle(node, weight, duration);
+
+        if (ch::stallAtNode<FORWARD_DIRECTION>(facade, node, weight, query_heap))
+        {
+            continue;
+        }
+
+        for (const auto edge : facade.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = facade.GetEdgeData(edge);
+            const NodeID to = facade.GetTarget(edge);
+            if (!data.forward || to == node)
+            {
+                continue;
+            }
+
+            BOOST_ASSERT_MSG(data.weight > 0, "edge_weight invalid");
+            const EdgeWeight to_weight = weight + data.weight;
+            const EdgeDuration to_duration = duration + data.duration;
+
+            if (reentries.IsSource(to))
+            {
+                reentries.Update(to, to_weight, to_duration);
+            }
+
+            if (!query_heap.WasInserted(to))
+            {
+                query_heap.Insert(to, to_weight, {node, to_duration});
+            }
+            else if (to_weight < query_heap.GetKey(to))
+            {
+                query_heap.GetData(to) = {node, to_duration};
+                query_heap.DecreaseKey(to, to_weight);
+            }
+        }
+    }
+}
+
+// Shortest weight and duration of a target phantom from the weights of its segment nodes
+template <typename GetNodeWeight>
+void relaxTarget(const PhantomNode &target_phantom,
+                 const SourceReentries &reentries,
+                 const GetNodeWeight &node_weight,
+                 EdgeWeight &target_weight,
+                 EdgeDuration &target_duration)
+{
+    const auto relax = [&](const NodeID node,
+                           const EdgeWeight offset,
+                           const EdgeDuration offset_duration) {
+        EdgeWeight weight;
+        EdgeDuration duration;
+        std::tie(weight, duration) = node_weight(node);
+        if (weight == INVALID_EDGE_WEIGHT)
+            return;
+
+        weight += offset;
+        duration += offset_duration;
+        if (weight < 0 && !reentries.Reenter(node, weight, duration))
+            return;
+
+        if (weight < target_weight)
+        {
+            target_weight = weight;
+            target_duration = duration;
+        }
+    };
+
+    if (target_phantom.IsValidForwardTarget())
+    {
+        relax(target_phantom.forward_segment_id.id,
+              target_phantom.GetForwardWeightPlusOffset(),
+              target_phantom.GetForwardDuration());
+    }
+    if (target_phantom.IsValidReverseTarget())
+    {
+        relax(target_phantom.reverse_segment_id.id,
+              target_phantom.GetReverseWeightPlusOffset(),
+              target_phantom.GetReverseDuration());
+    }
+}
+
+// Downward edges of the sweep graph among the nodes on the upward search spaces of the targets,
+// renumbered to positions in the selection.
+struct RestrictedSweepGraph
+{
+    struct Edge
+    {
+        std::size_t source;
+        EdgeWeight weight;
+        EdgeDuration duration;
+    };
+
+    RestrictedSweepGraph(const SweepGraph &graph, const std::vector<NodeID> &target_nodes)
+    {
+        std::unordered_set<Rank> selected;
+        std::vector<Rank> stack;
+        for (const auto node : target_nodes)
+        {
+            if (selected.insert(graph.GetRank(node)).second)
+                stack.push_back(graph.GetRank(node));
+        }
+
+        while (!stack.empty())
+        {
+            const auto rank = stack.back();
+            stack.pop_back();
+            for (const auto edge : graph.GetIncomingEdgeRange(rank))
+            {
+                const auto source = graph.GetEdge(edge).source;
+                if (selected.insert(source).second)
+                    stack.push_back(source);
+            }
+        }
+
+        ranks.assign(selected.begin(), selected.end());
+        std::sort(ranks.begin(), ranks.end());
+
+        first_edge.reserve(ranks.size() + 1);
+        for (const auto rank : ranks)
+        {
+            first_edge.push_back(edges.size());
+            for (const auto edge : graph.GetIncomingEdgeRange(rank))
+            {
+                const auto &sweep_edge = graph.GetEdge(edge);
+                edges.push_back(
+                    {Position(sweep_edge.source), sweep_edge.weight, sweep_edge.duration});
+            }
+        }
+        first_edge.push_back(edges.size());
+    }
+
+    std::size_t Position(const Rank rank) const
+    {
+        const auto position = Find(rank);
+        BOOST_ASSERT(position != ranks.size());
+        return position;
+    }
+
+    // Position of a rank or the number of selected ranks if it is not selected
+    std::size_t Find(const Rank rank) const
+    {
+        const auto iter = std::lower_bound(ranks.begin(), ranks.end(), rank);
+        if (iter == ranks.end() || *iter != rank)
+            return ranks.size();
+        return std::distance(ranks.begin(), iter);
+    }
+
+    std::vector<Rank> ranks;
+    std::vector<std::size_t> first_edge;
+    std::vector<Edge> edges;
+};
+}
+
+std::vector<EdgeDuration>
+oneToAllSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
+               const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+               const PhantomNode &source_phantom,
+               const EdgeDuration max_duration)
+{
+    const auto &graph = facade.GetDownwardSweepGraph();
+    const auto number_of_nodes = graph.GetNumberOfNodes();
+
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &query_heap = *engine_working_data.many_to_many_heap;
+
+    // indexed by rank so the sweep reads and writes both arrays front to back
+    std::vector<EdgeWeight> weights(number_of_nodes, INVALID_EDGE_WEIGHT);
+    std::vector<EdgeDuration> durations(number_of_nodes, MAXIMAL_EDGE_DURATION);
+
+    SourceReentries reentries(source_phantom);
+    upwardSearch(facade,
+                 query_heap,
+                 source_phantom,
+                 reentries,
+                 [&](const NodeID node, const EdgeWeight weight, const EdgeDuration duration) {
+                     const auto rank = graph.GetRank(node);
+                     weights[rank] = weight;
+                     durations[rank] = duration;
+                 });
+
+    for (const auto rank : util::irange<Rank>(0, number_of_nodes))
+    {
+        for (const auto edge : graph.GetIncomingEdgeRange(rank))
+        {
+            const auto &sweep_edge = graph.GetEdge(edge);
+            const auto source_weight = weights[sweep_edge.source];
+            if (source_weight != INVALID_EDGE_WEIGHT &&
+                source_weight + sweep_edge.weight < weights[rank])
+            {
+                weights[rank] = source_weight + sweep_edge.weight;
+                durations[rank] = durations[sweep_edge.source] + sweep_edge.duration;
+            }
+        }
+    }
+
+    std::vector<EdgeDuration> node_durations(number_of_nodes, MAXIMAL_EDGE_DURATION);
+    for (const auto rank : util::irange<Rank>(0, number_of_nodes))
+    {
+        // nodes of the source segment start behind the source
+        const auto duration = std::max<EdgeDuration>(0, durations[rank]);
+        if (weights[rank] != INVALID_EDGE_WEIGHT && duration <= max_duration)
+        {
+            node_durations[graph.GetNode(rank)] = duration;
+        }
+    }
+
+    return node_durations;
+}
+
+std::vector<EdgeWeight> restrictedManyToManySearch(
+    SearchEngineData<ch::Algorithm> &engine_working_data,
+    const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
+    const std::vector<PhantomNode> &phantom_nodes,
+    const std::vector<std::size_t> &source_indices,
+    const std::vector<std::size_t> &target_indices)
+{
+    const auto number_of_sources =
+        source_indices.empty() ? phantom_nodes.size() : source_indices.size();
+    const auto number_of_targets =
+        target_indices.empty() ? phantom_nodes.size() : target_indices.size();
+    const auto source_phantom = [&](const std::size_t row_idx) -> const PhantomNode & {
+        return source_indices.empty() ? phantom_nodes[row_idx]
+                                      : phantom_nodes[source_indices[row_idx]];
+    };
+    const auto target_phantom = [&](const std::size_t column_idx) -> const PhantomNode & {
+        return target_indices.empty() ? phantom_nodes[column_idx]
+                                      : phantom_nodes[target_indices[column_idx]];
+    };
+
+    const auto &graph = facade.GetDownwardSweepGraph();
+
+    std::vector<NodeID> target_nodes;
+    for (const auto column_idx : util::irange<std::size_t>(0, number_of_targets))
+    {
+        const auto &phantom = target_phantom(column_idx);
+        if (phantom.IsValidForwardTarget())
+            target_nodes.push_back(phantom.forward_segment_id.id);
+        if (phantom.IsValidReverseTarget())
+            target_nodes.push_back(phantom.reverse_segment_id.id);
+    }
+    const RestrictedSweepGraph restricted_graph(graph, target_nodes);
+    const auto number_of_selected = restricted_graph.ranks.size();
+
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &query_heap = *engine_working_data.many_to_many_heap;
+
+    // The sources are swept in batches of RESTRICTED_SWEEP_LANES. Every selected node holds the
+    // weights of all lanes next to each other, so a batch reads the edges once and the lane
+    // loops have a fixed length the compiler can vectorize.
+    const constexpr auto LANES = RESTRICTED_SWEEP_LANES;
+    std::vector<EdgeWeight> weights(number_of_selected * LANES);
+    std::vector<EdgeDuration> durations(number_of_selected * LANES);
+
+    std::vector<EdgeWeight> weights_table(number_of_sources * number_of_targets,
+                                          INVALID_EDGE_WEIGHT);
+    std::vector<EdgeWeight> durations_table(number_of_sources * number_of_targets,
+                                            MAXIMAL_EDGE_DURATION);
+
+    std::vector<SourceReentries> reentries;
+    reentries.reserve(LANES);
+    for (std::size_t first_row = 0; first_row < number_of_sources; first_row += LANES)
+    {
+        const auto number_of_lanes = std::min(LANES, number_of_sources - first_row);
+        std::fill(weights.begin(), weights.end(), INVALID_EDGE_WEIGHT);
+        std::fill(durations.begin(), durations.end(), MAXIMAL_EDGE_DURATION);
+
+        reentries.clear();
+        for (const auto lane : util::irange<std::size_t>(0, number_of_lanes))
+        {
+            reentries.emplace_back(source_phantom(first_row + lane));
+            upwardSearch(
+                facade,
+                query_heap,
+                source_phantom(first_row + lane),
+                reentries.back(),
+                [&](const NodeID node, const EdgeWeight weight, const EdgeDuration duration) {
+                    const auto position = restricted_graph.Find(graph.GetRank(node));
+                    if (position != number_of_selected)
+                    {
+                        weights[position * LANES + lane] = weight;
+                        durations[position * LANES + lane] = duration;
+                    }
+                });
+        }
+
+        for (const auto position : util::irange<std::size_t>(0, number_of_selected))
+        {
+            std::array<EdgeWeight, LANES> pulled_weights;
+            std::array<EdgeDuration, LANES> pulled_durations;
+            pulled_weights.fill(INVALID_EDGE_WEIGHT);
+            pulled_durations.fill(MAXIMAL_EDGE_DURATION);
+            for (const auto edge : util::irange(restricted_graph.first_edge[position],
+                                                restricted_graph.first_edge[position + 1]))
+            {
+                const auto &sweep_edge = restricted_graph.edges[edge];
+                const auto *source_weights = &weights[sweep_edge.source * LANES];
+                const auto *source_durations = &durations[sweep_edge.source * LANES];
+                for (std::size_t lane = 0; lane < LANES; ++lane)
+                {
+                    if (source_weights[lane] != INVALID_EDGE_WEIGHT &&
+                        source_weights[lane] + sweep_edge.weight < pulled_weights[lane])
+                    {
+                        pulled_weights[lane] = source_weights[lane] + sweep_edge.weight;
+                        pulled_durations[lane] = source_durations[lane] + sweep_edge.duration;
+                    }
+                }
+            }
+
+            const auto node = graph.GetNode(restricted_graph.ranks[position]);
+            for (const auto lane : util::irange<std::size_t>(0, number_of_lanes))
+            {
+                if (reentries[lane].IsSource(node))
+                {
+                    reentries[lane].Update(node, pulled_weights[lane], pulled_durations[lane]);
+                }
+            }
+
+            auto *position_weights = &weights[position * LANES];
+            auto *position_durations = &durations[position * LANES];
+            for (std::size_t lane = 0; lane < LANES; ++lane)
+            {
+                if (pulled_weights[lane] < position_weights[lane])
+                {
+                    position_weights[lane] = pulled_weights[lane];
+                    position_durations[lane] = pulled_durations[lane];
+                }
+            }
+        }
+
+        for (const auto lane : util::irange<std::size_t>(0, number_of_lanes))
+        {
+            const auto row_idx = first_row + lane;
+            const auto node_weight = [&](const NodeID node) {
+                const auto index =
+                    restricted_graph.Position(graph.GetRank(node)) * LANES + lane;
+                return std::make_pair(weights[index], durations[index]);
+            };
+            for (const auto column_idx : util::irange<std::size_t>(0, number_of_targets))
+            {
+                relaxTarget(target_phantom(column_idx),
+                            reentries[lane],
+                            node_weight,
+                            weights_table[row_idx * number_of_targets + column_idx],
+                            durations_table[row_idx * number_of_targets + column_idx]);
+            }
+        }
+    }
+
+    return durations_table;
+}
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
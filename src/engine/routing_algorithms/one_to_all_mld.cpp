@@ -0,0 +1,180 @@
+#include "engine/routing_algorithms/one_to_all.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+namespace
+{
+using ManyToManyQueryHeap = SearchEngineData<mld::Algorithm>::ManyToManyQueryHeap;
+
+// Highest level on which the node can be expanded. Cells that contain the source have to be
+// searched on a lower level like in every MLD query. On top of that a node can only take the
+// shortcuts of a cell it entered across the border of that cell: nodes that were reached inside a
+// cell after descending into it are not source nodes of the cell.
+LevelID getOverlayLevel(const partition::MultiLevelPartitionView &partition,
+                        const PhantomNode &source_phantom,
+                        const NodeID node,
+                        const NodeID parent,
+                        const bool from_clique_arc)
+{
+    auto highest_diffrent_level = [&partition, node](const SegmentID &phantom_node) {
+        if (phantom_node.enabled)
+            return partition.GetHighestDifferentLevel(phantom_node.id, node);
+        return INVALID_LEVEL_ID;
+    };
+    const auto level = std::min(highest_diffrent_level(source_phantom.forward_segment_id),
+                                highest_diffrent_level(source_phantom.reverse_segment_id));
+
+    // nodes at the end of a shortcut don't take shortcuts again, the level only selects the
+    // border edges that leave the cell
+    if (from_clique_arc)
+        return level;
+
+    return std::min(level, partition.GetHighestDifferentLevel(parent, node));
+}
+
+// Descends from the overlay level until all exits of the cell of the node are reached within
+// the budget. Cells that are crossed completely are skipped with their shortcuts and only the
+// cells the budget frontier runs through are searched on lower levels.
+LevelID getFrontierLevel(const partition::MultiLevelPartitionView &partition,
+                         const partition::CellStorageView &cells,
+                         const NodeID node,
+                         const EdgeDuration duration,
+                         const EdgeDuration max_duration,
+                         LevelID level)
+{
+    for (; level >= 1; --level)
+    {
+        const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
+        auto shortcut_durations = cell.GetOutDuration(node);
+        const auto crossed = std::none_of(
+            shortcut_durations.begin(), shortcut_durations.end(), [&](const EdgeDuration value) {
+                return value != MAXIMAL_EDGE_DURATION && duration + value > max_duration;
+            });
+        if (crossed)
+            break;
+    }
+    return level;
+}
+
+void relaxOutgoingEdges(
+    const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+    const NodeID node,
+    const EdgeWeight weight,
+    const EdgeDuration duration,
+    const bool from_clique_arc,
+    const LevelID level,
+    const EdgeDuration max_duration,
+    ManyToManyQueryHeap &query_heap)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    const auto &cells = facade.GetCellStorage();
+
+    const auto relax = [&](const NodeID to,
+                           const EdgeWeight to_weight,
+                           const EdgeDuration to_duration,
+                           const bool to_from_clique_arc) {
+        if (to_duration > max_duration)
+            return;
+
+        if (!query_heap.WasInserted(to))
+        {
+            query_heap.Insert(to, to_weight, {node, to_from_clique_arc, to_duration});
+        }
+        else if (to_weight < query_heap.GetKey(to))
+        {
+            query_heap.GetData(to) = {node, to_from_clique_arc, to_duration};
+            query_heap.DecreaseKey(to, to_weight);
+        }
+    };
+
+    if (level >= 1 && !from_clique_arc)
+    {
+        const auto &cell = cells.GetCell(level, partition.GetCell(level, node));
+        auto destination = cell.GetDestinationNodes().begin();
+        auto shortcut_durations = cell.GetOutDuration(node);
+        for (auto shortcut_weight : cell.GetOutWeight(node))
+        {
+            BOOST_ASSERT(destination != cell.GetDestinationNodes().end());
+            BOOST_ASSERT(!shortcut_durations.empty());
+            const NodeID to = *destination;
+            if (shortcut_weight != INVALID_EDGE_WEIGHT && node != to)
+            {
+                relax(to, weight + shortcut_weight, duration + shortcut_durations.front(), true);
+            }
+            ++destination;
+            shortcut_durations.advance_begin(1);
+        }
+        BOOST_ASSERT(shortcut_durations.empty());
+    }
+
+    for (const auto edge : facade.GetBorderEdgeRange(level, node))
+    {
+        const auto &data = facade.GetEdgeData(edge);
+        if (data.forward)
+        {
+            BOOST_ASSERT_MSG(data.weight > 0, "edge_weight invalid");
+            relax(facade.GetTarget(edge), weight + data.weight, duration + data.duration, false);
+        }
+    }
+}
+}
+
+std::vector<EdgeDuration>
+oneToAllSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
+               const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
+               const PhantomNode &source_phantom,
+               const EdgeDuration max_duration)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+    const auto &cells = facade.GetCellStorage();
+
+    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
+    auto &query_heap = *engine_working_data.many_to_many_heap;
+    insertSourceInHeap(query_heap, source_phantom);
+
+    std::vector<EdgeDuration> node_durations(facade.GetNumberOfNodes(), MAXIMAL_EDGE_DURATION);
+    while (!query_heap.Empty())
+    {
+        const NodeID node = query_heap.DeleteMin();
+        const EdgeWeight weight = query_heap.GetKey(node);
+        // copied, relaxing the edges can move the heap data
+        const auto node_data = query_heap.GetData(node);
+
+        // nodes of the source segment start behind the source
+        node_durations[node] = std::max<EdgeDuration>(0, node_data.duration);
+
+        auto level = getOverlayLevel(
+            partition, source_phantom, node, node_data.parent, node_data.from_clique_arc);
+        if (!node_data.from_clique_arc)
+        {
+            level = getFrontierLevel(
+                partition, cells, node, node_data.duration, max_duration, level);
+        }
+
+        relaxOutgoingEdges(facade,
+                           node,
+                           weight,
+                           node_data.duration,
+                           node_data.from_clique_arc,
+                           level,
+                           max_duration,
+                           query_heap);
+    }
+
+    return node_durations;
+}
+
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
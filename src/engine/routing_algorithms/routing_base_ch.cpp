@@ -1,4 +1,7 @@
 #include "engine/routing_algorithms/routing_base_ch.hpp"
+#include "engine/routing_algorithms/landmark_potential.hpp"
+
+#include "util/integer_range.hpp"
 
 namespace osrm
 {
@@ -98,31 +101,35 @@ void search(SearchEngineData<Algorithm> & /*engine_working_data*/,
     BOOST_ASSERT(reverse_heap.MinKey() >= 0);
 
     // run two-Target Dijkstra routing step.
-    while (0 < (forward_heap.Size() + reverse_heap.Size()))
-    {
-        if (!forward_heap.Empty())
-        {
-            routingStep<FORWARD_DIRECTION>(facade,
-                                           forward_heap,
-                                           reverse_heap,
-                                           middle,
-                                           weight,
-                                           min_edge_offset,
-                                           force_loop_forward,
-                                           force_loop_reverse);
-        }
-        if (!reverse_heap.Empty())
+    util::dispatchIndexStorage(forward_heap.GetIndexStorage().Type(), [&](const auto type) {
+        auto forward_view = forward_heap.View<decltype(type)::value>();
+        auto reverse_view = reverse_heap.View<decltype(type)::value>();
+        while (0 < (forward_view.Size() + reverse_view.Size()))
         {
-            routingStep<REVERSE_DIRECTION>(facade,
-                                           reverse_heap,
-                                           forward_heap,
-                                           middle,
-                                           weight,
-                                           min_edge_offset,
-                                           force_loop_reverse,
-                                           force_loop_forward);
+            if (!forward_view.Empty())
+            {
+                routingStep<FORWARD_DIRECTION>(facade,
+                                               forward_view,
+                                               reverse_view,
+                                               middle,
+                                               weight,
+                                               min_edge_offset,
+                                               force_loop_forward,
+                                               force_loop_reverse);
+            }
+            if (!reverse_view.Empty())
+            {
+                routingStep<REVERSE_DIRECTION>(facade,
+                                               reverse_view,
+                                               forward_view,
+                                               middle,
+                                               weight,
+                                               min_edge_offset,
+                                               force_loop_reverse,
+                                               force_loop_forward);
+            }
         }
-    }
+    });
 
     // No path found for both target nodes?
     if (weight_upper_bound <= weight || SPECIAL_NODEID == middle)
@@ -190,19 +197,170 @@ double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
 
     return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
 }
+
+std::vector<double>
+getNetworkDistances(SearchEngineData<Algorithm> & /*engine_working_data*/,
+                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                    SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const PhantomNode &source_phantom,
+                    const std::vector<PhantomNode> &target_phantoms,
+                    EdgeWeight weight_upper_bound)
+{
+    std::vector<double> distances(target_phantoms.size(), std::numeric_limits<double>::max());
+
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    insertSourceInForwardHeap(forward_heap, source_phantom);
+    if (forward_heap.Empty())
+    {
+        return distances;
+    }
+
+    // get offset to account for offsets on phantom nodes on compressed edges
+    const auto min_edge_offset = std::min(0, forward_heap.MinKey());
+
+    // the reverse heap is empty, so the upward search settles all nodes below the bound
+    NodeID middle = SPECIAL_NODEID;
+    EdgeWeight forward_upper_bound = weight_upper_bound;
+    while (!forward_heap.Empty())
+    {
+        routingStep<FORWARD_DIRECTION>(facade,
+                                       forward_heap,
+                                       reverse_heap,
+                                       middle,
+                                       forward_upper_bound,
+                                       min_edge_offset,
+                                       DO_NOT_FORCE_LOOPS,
+                                       DO_NOT_FORCE_LOOPS);
+    }
+
+    for (const auto index : util::irange<std::size_t>(0UL, target_phantoms.size()))
+    {
+        const auto &target_phantom = target_phantoms[index];
+        reverse_heap.Clear();
+        insertTargetInReverseHeap(reverse_heap, target_phantom);
+
+        // the keys of the forward heap are final, the steps stop at the best path found
+        middle = SPECIAL_NODEID;
+        EdgeWeight weight = weight_upper_bound;
+        while (!reverse_heap.Empty())
+        {
+            routingStep<REVERSE_DIRECTION>(facade,
+                                           reverse_heap,
+                                           forward_heap,
+                                           middle,
+                                           weight,
+                                           min_edge_offset,
+                                           DO_NOT_FORCE_LOOPS,
+                                           DO_NOT_FORCE_LOOPS);
+        }
+
+        if (weight_upper_bound <= weight || SPECIAL_NODEID == middle)
+        {
+            continue;
+        }
+
+        std::vector<NodeID> packed_path;
+        if (weight != forward_heap.GetKey(middle) + reverse_heap.GetKey(middle))
+        {
+            // self loop makes up the full path
+            packed_path.push_back(middle);
+            packed_path.push_back(middle);
+        }
+        else
+        {
+            retrievePackedPathFromHeap(forward_heap, reverse_heap, middle, packed_path);
+        }
+
+        std::vector<PathData> unpacked_path;
+        unpackPath(facade,
+                   packed_path.begin(),
+                   packed_path.end(),
+                   {source_phantom, target_phantom},
+                   unpacked_path);
+        distances[index] = getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
+    }
+
+    return distances;
+}
 } // namespace ch
 
 namespace corech
 {
-// Assumes that heaps are already setup correctly.
-// A forced loop might be necessary, if source and target are on the same segment.
-// If this is the case and the offsets of the respective direction are larger for the source
-// than the target
-// then a force loop is required (e.g. source_phantom.forward_segment_id ==
-// target_phantom.forward_segment_id
-// && source_phantom.GetForwardWeightPlusOffset() > target_phantom.GetForwardWeightPlusOffset())
-// requires
-// a force loop, if the heaps have been initialized with positive offsets.
+namespace
+{
+// Routing step of the core search directed by the potentials, the keys of the heaps are the
+// weights of the nodes plus their potentials. Nodes are reinserted if reached with a smaller
+// weight after they were settled, see LandmarkPotential.
+template <bool DIRECTION, typename PotentialT, typename OppositePotentialT, typename HeapT>
+void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                 HeapT &forward_heap,
+                 HeapT &reverse_heap,
+                 const PotentialT &potential,
+                 const OppositePotentialT &opposite_potential,
+                 NodeID &middle_node_id,
+                 EdgeWeight &upper_bound,
+                 const bool force_loop_forward,
+                 const bool force_loop_reverse)
+{
+    const NodeID node = forward_heap.DeleteMin();
+    const EdgeWeight weight = forward_heap.GetKey(node) - potential(node);
+
+    if (reverse_heap.WasInserted(node))
+    {
+        const EdgeWeight new_weight =
+            reverse_heap.GetKey(node) - opposite_potential(node) + weight;
+        if (new_weight < upper_bound)
+        {
+            if ((force_loop_forward && forward_heap.GetData(node).parent == node) ||
+                (force_loop_reverse && reverse_heap.GetData(node).parent == node) ||
+                new_weight < 0)
+            {
+                ch::anyAdjacentEdge<DIRECTION>(
+                    facade, node, [&](const NodeID to, const EdgeWeight edge_weight) {
+                        const EdgeWeight loop_weight = new_weight + edge_weight;
+                        if (to == node && loop_weight >= 0 && loop_weight < upper_bound)
+                        {
+                            middle_node_id = node;
+                            upper_bound = loop_weight;
+                        }
+                        return false;
+                    });
+            }
+            else
+            {
+                middle_node_id = node;
+                upper_bound = new_weight;
+            }
+        }
+    }
+
+    ch::anyAdjacentEdge<DIRECTION>(
+        facade, node, [&](const NodeID to, const EdgeWeight edge_weight) {
+            BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
+            const EdgeWeight to_weight = weight + edge_weight;
+
+            if (!forward_heap.WasInserted(to))
+            {
+                forward_heap.Insert(to, to_weight + potential(to), node);
+            }
+            else if (to_weight < forward_heap.GetKey(to) - potential(to))
+            {
+                if (forward_heap.WasRemoved(to))
+                {
+                    forward_heap.Insert(to, to_weight + potential(to), node);
+                }
+                else
+                {
+                    forward_heap.GetData(to).parent = node;
+                    forward_heap.DecreaseKey(to, to_weight + potential(to));
+                }
+            }
+            return false;
+        });
+}
+
 void search(SearchEngineData<Algorithm> &engine_working_data,
             const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
             SearchEngineData<Algorithm>::QueryHeap &forward_heap,
@@ -211,8 +369,9 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
             std::vector<NodeID> &packed_leg,
             const bool force_loop_forward,
             const bool force_loop_reverse,
-            const PhantomNodes & /*phantom_nodes*/,
-            EdgeWeight weight_upper_bound)
+            const PhantomNodes &phantom_nodes,
+            const EdgeWeight weight_upper_bound,
+            const bool use_landmarks)
 {
     NodeID middle = SPECIAL_NODEID;
     weight = weight_upper_bound;
@@ -271,13 +430,14 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
         }
     }
 
-    const auto insertInCoreHeap = [](const CoreEntryPoint &p, auto &core_heap) {
+    const auto insertInCoreHeap = [](
+        const CoreEntryPoint &p, auto &core_heap, const auto &potential) {
         NodeID id;
         EdgeWeight weight;
         NodeID parent;
         // TODO this should use std::apply when we get c++17 support
         std::tie(id, weight, parent) = p;
-        core_heap.Insert(id, weight, parent);
+        core_heap.Insert(id, weight + potential(id), parent);
     };
 
     engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
@@ -285,14 +445,117 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
     auto &forward_core_heap = *engine_working_data.forward_heap_2;
     auto &reverse_core_heap = *engine_working_data.reverse_heap_2;
 
+    // each step of the core searches settles a node
+    const auto max_core_steps = engine_working_data.max_core_settled_nodes;
+    std::size_t core_steps = 0;
+    bool core_exhausted = false;
+
+    // the core search is directed to the phantom nodes the first search started with
+    const auto &landmarks = facade.GetLandmarks();
+    if (use_landmarks && landmarks.GetNumberOfLandmarks() > 0 && !force_loop_forward &&
+        !force_loop_reverse)
+    {
+        const LandmarkPotential<FORWARD_DIRECTION> forward_potential(
+            landmarks, reverse_heap, phantom_nodes.target_phantom);
+        const LandmarkPotential<REVERSE_DIRECTION> reverse_potential(
+            landmarks, forward_heap, phantom_nodes.source_phantom);
+
+        for (const auto &p : forward_entry_points)
+        {
+            insertInCoreHeap(p, forward_core_heap, forward_potential);
+        }
+
+        for (const auto &p : reverse_entry_points)
+        {
+            insertInCoreHeap(p, reverse_core_heap, reverse_potential);
+        }
+
+        // the keys of either heap bound the weights of all paths through its remaining nodes
+        const auto storage = forward_core_heap.GetIndexStorage().Type();
+        util::dispatchIndexStorage(storage, [&](const auto type) {
+            auto forward_view = forward_core_heap.View<decltype(type)::value>();
+            auto reverse_view = reverse_core_heap.View<decltype(type)::value>();
+            while (0 < forward_view.Size() && 0 < reverse_view.Size() &&
+                   weight > forward_view.MinKey() && weight > reverse_view.MinKey())
+            {
+                if (core_steps >= max_core_steps)
+                {
+                    core_exhausted = true;
+                    break;
+                }
+                core_steps += 2;
+                routingStep<FORWARD_DIRECTION>(facade,
+                                               forward_view,
+                                               reverse_view,
+                                               forward_potential,
+                                               reverse_potential,
+                                               middle,
+                                               weight,
+                                               force_loop_forward,
+                                               force_loop_reverse);
+                if (reverse_view.Empty())
+                    break;
+                routingStep<REVERSE_DIRECTION>(facade,
+                                               reverse_view,
+                                               forward_view,
+                                               reverse_potential,
+                                               forward_potential,
+                                               middle,
+                                               weight,
+                                               force_loop_reverse,
+                                               force_loop_forward);
+            }
+        });
+
+        if (core_exhausted || weight_upper_bound <= weight || SPECIAL_NODEID == middle)
+        {
+            weight = INVALID_EDGE_WEIGHT;
+            return;
+        }
+
+        if (facade.IsCoreNode(middle))
+        {
+            const EdgeWeight core_weight =
+                forward_core_heap.GetKey(middle) - forward_potential(middle) +
+                reverse_core_heap.GetKey(middle) - reverse_potential(middle);
+            if (weight != core_weight)
+            {
+                // self loop
+                packed_leg.push_back(middle);
+                packed_leg.push_back(middle);
+                return;
+            }
+
+            std::vector<NodeID> packed_core_leg;
+            ch::retrievePackedPathFromHeap(
+                forward_core_heap, reverse_core_heap, middle, packed_core_leg);
+            BOOST_ASSERT(packed_core_leg.size() > 0);
+            ch::retrievePackedPathFromSingleHeap(forward_heap, packed_core_leg.front(), packed_leg);
+            std::reverse(packed_leg.begin(), packed_leg.end());
+            packed_leg.insert(packed_leg.end(), packed_core_leg.begin(), packed_core_leg.end());
+            ch::retrievePackedPathFromSingleHeap(reverse_heap, packed_core_leg.back(), packed_leg);
+        }
+        else if (weight != forward_heap.GetKey(middle) + reverse_heap.GetKey(middle))
+        {
+            // self loop
+            packed_leg.push_back(middle);
+            packed_leg.push_back(middle);
+        }
+        else
+        {
+            ch::retrievePackedPathFromHeap(forward_heap, reverse_heap, middle, packed_leg);
+        }
+        return;
+    }
+
     for (const auto &p : forward_entry_points)
     {
-        insertInCoreHeap(p, forward_core_heap);
+        insertInCoreHeap(p, forward_core_heap, ZeroPotential{});
     }
 
     for (const auto &p : reverse_entry_points)
     {
-        insertInCoreHeap(p, reverse_core_heap);
+        insertInCoreHeap(p, reverse_core_heap, ZeroPotential{});
     }
 
     // get offset to account for offsets on phantom nodes on compressed edges
@@ -308,30 +571,40 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
     BOOST_ASSERT(min_core_edge_offset <= 0);
 
     // run two-target Dijkstra routing step on core with termination criterion
-    while (0 < forward_core_heap.Size() && 0 < reverse_core_heap.Size() &&
-           weight > (forward_core_heap.MinKey() + reverse_core_heap.MinKey()))
-    {
-        ch::routingStep<FORWARD_DIRECTION, ch::DISABLE_STALLING>(facade,
-                                                                 forward_core_heap,
-                                                                 reverse_core_heap,
-                                                                 middle,
-                                                                 weight,
-                                                                 min_core_edge_offset,
-                                                                 force_loop_forward,
-                                                                 force_loop_reverse);
-
-        ch::routingStep<REVERSE_DIRECTION, ch::DISABLE_STALLING>(facade,
-                                                                 reverse_core_heap,
-                                                                 forward_core_heap,
-                                                                 middle,
-                                                                 weight,
-                                                                 min_core_edge_offset,
-                                                                 force_loop_reverse,
-                                                                 force_loop_forward);
-    }
+    util::dispatchIndexStorage(forward_core_heap.GetIndexStorage().Type(), [&](const auto type) {
+        auto forward_view = forward_core_heap.View<decltype(type)::value>();
+        auto reverse_view = reverse_core_heap.View<decltype(type)::value>();
+        while (0 < forward_view.Size() && 0 < reverse_view.Size() &&
+               weight > (forward_view.MinKey() + reverse_view.MinKey()))
+        {
+            if (core_steps >= max_core_steps)
+            {
+                core_exhausted = true;
+                break;
+            }
+            core_steps += 2;
+            ch::routingStep<FORWARD_DIRECTION, ch::DISABLE_STALLING>(facade,
+                                                                     forward_view,
+                                                                     reverse_view,
+                                                                     middle,
+                                                                     weight,
+                                                                     min_core_edge_offset,
+                                                                     force_loop_forward,
+                                                                     force_loop_reverse);
+
+            ch::routingStep<REVERSE_DIRECTION, ch::DISABLE_STALLING>(facade,
+                                                                     reverse_view,
+                                                                     forward_view,
+                                                                     middle,
+                                                                     weight,
+                                                                     min_core_edge_offset,
+                                                                     force_loop_reverse,
+                                                                     force_loop_forward);
+        }
+    });
 
-    // No path found for both target nodes?
-    if (weight_upper_bound <= weight || SPECIAL_NODEID == middle)
+    // No path found for both target nodes, or not within the nodes the core search may settle?
+    if (core_exhausted || weight_upper_bound <= weight || SPECIAL_NODEID == middle)
     {
         weight = INVALID_EDGE_WEIGHT;
         return;
@@ -379,6 +652,40 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
         }
     }
 }
+} // namespace
+
+// Assumes that heaps are already setup correctly.
+// A forced loop might be necessary, if source and target are on the same segment.
+// If this is the case and the offsets of the respective direction are larger for the source
+// than the target
+// then a force loop is required (e.g. source_phantom.forward_segment_id ==
+// target_phantom.forward_segment_id
+// && source_phantom.GetForwardWeightPlusOffset() > target_phantom.GetForwardWeightPlusOffset())
+// requires
+// a force loop, if the heaps have been initialized with positive offsets.
+void search(SearchEngineData<Algorithm> &engine_working_data,
+            const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+            SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+            SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+            EdgeWeight &weight,
+            std::vector<NodeID> &packed_leg,
+            const bool force_loop_forward,
+            const bool force_loop_reverse,
+            const PhantomNodes &phantom_nodes,
+            EdgeWeight weight_upper_bound)
+{
+    search(engine_working_data,
+           facade,
+           forward_heap,
+           reverse_heap,
+           weight,
+           packed_leg,
+           force_loop_forward,
+           force_loop_reverse,
+           phantom_nodes,
+           weight_upper_bound,
+           engine_working_data.use_landmarks_for_route);
+}
 
 // Requires the heaps for be empty
 // If heaps should be adjusted to be initialized outside of this function,
@@ -407,7 +714,8 @@ double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
            DO_NOT_FORCE_LOOPS,
            DO_NOT_FORCE_LOOPS,
            {source_phantom, target_phantom},
-           weight_upper_bound);
+           weight_upper_bound,
+           engine_working_data.use_landmarks_for_match);
 
     if (weight == INVALID_EDGE_WEIGHT)
         return std::numeric_limits<double>::max();
@@ -421,6 +729,30 @@ double getNetworkDistance(SearchEngineData<Algorithm> &engine_working_data,
 
     return getPathDistance(facade, unpacked_path, source_phantom, target_phantom);
 }
+
+std::vector<double>
+getNetworkDistances(SearchEngineData<Algorithm> &engine_working_data,
+                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                    SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                    SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                    const PhantomNode &source_phantom,
+                    const std::vector<PhantomNode> &target_phantoms,
+                    EdgeWeight weight_upper_bound)
+{
+    std::vector<double> distances;
+    distances.reserve(target_phantoms.size());
+    for (const auto &target_phantom : target_phantoms)
+    {
+        distances.push_back(getNetworkDistance(engine_working_data,
+                                               facade,
+                                               forward_heap,
+                                               reverse_heap,
+                                               source_phantom,
+                                               target_phantom,
+                                               weight_upper_bound));
+    }
+    return distances;
+}
 } // namespace corech
 
 } // namespace routing_algorithms
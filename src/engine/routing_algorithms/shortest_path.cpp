@@ -4,6 +4,11 @@
 
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include <memory>
 
 namespace osrm
@@ -177,20 +182,24 @@ void search(SearchEngineData<Algorithm> &engine_working_data,
     }
 }
 
+// The legs are independent of each other once the packed path is known, they are unpacked on up
+// to concurrency threads
 template <typename Algorithm>
 void unpackLegs(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                 const std::vector<PhantomNodes> &phantom_nodes_vector,
                 const std::vector<NodeID> &total_packed_path,
                 const std::vector<std::size_t> &packed_leg_begin,
                 const EdgeWeight shortest_path_weight,
+                const unsigned concurrency,
+                const ShortcutCacheView &shortcut_cache,
                 InternalRouteResult &raw_route_data)
 {
-    raw_route_data.unpacked_path_segments.resize(packed_leg_begin.size() - 1);
+    const auto number_of_legs = packed_leg_begin.size() - 1;
+    raw_route_data.unpacked_path_segments.resize(number_of_legs);
 
     raw_route_data.shortest_path_weight = shortest_path_weight;
 
-    for (const auto current_leg : util::irange<std::size_t>(0UL, packed_leg_begin.size() - 1))
-    {
+    const auto unpack_leg = [&](const std::size_t current_leg) {
         auto leg_begin = total_packed_path.begin() + packed_leg_begin[current_leg];
         auto leg_end = total_packed_path.begin() + packed_leg_begin[current_leg + 1];
         const auto &unpack_phantom_node_pair = phantom_nodes_vector[current_leg];
@@ -198,8 +207,35 @@ void unpackLegs(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                    leg_begin,
                    leg_end,
                    unpack_phantom_node_pair,
-                   raw_route_data.unpacked_path_segments[current_leg]);
+                   raw_route_data.unpacked_path_segments[current_leg],
+                   shortcut_cache);
+    };
+
+    if (concurrency > 1)
+    {
+        tbb::task_arena arena(concurrency);
+        arena.execute([&] {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_legs),
+                              [&](const tbb::blocked_range<std::size_t> &range) {
+                                  for (auto leg = range.begin(); leg != range.end(); ++leg)
+                                  {
+                                      unpack_leg(leg);
+                                  }
+                              });
+        });
+    }
+    else
+    {
+        for (const auto current_leg : util::irange<std::size_t>(0UL, number_of_legs))
+        {
+            unpack_leg(current_leg);
+        }
+    }
 
+    for (const auto current_leg : util::irange<std::size_t>(0UL, number_of_legs))
+    {
+        auto leg_begin = total_packed_path.begin() + packed_leg_begin[current_leg];
+        auto leg_end = total_packed_path.begin() + packed_leg_begin[current_leg + 1];
         raw_route_data.source_traversed_in_reverse.push_back(
             (*leg_begin != phantom_nodes_vector[current_leg].source_phantom.forward_segment_id.id));
         raw_route_data.target_traversed_in_reverse.push_back(
@@ -224,6 +260,12 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
 
     engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
 
+    // one more waypoint than legs
+    const auto leg_concurrency = phantom_nodes_vector.size() + 1 >=
+                                         engine_working_data.leg_concurrency_min_waypoints
+                                     ? engine_working_data.leg_concurrency
+                                     : 1u;
+
     auto &forward_heap = *engine_working_data.forward_heap_1;
     auto &reverse_heap = *engine_working_data.reverse_heap_1;
 
@@ -438,6 +480,8 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                    total_packed_path_to_forward,
                    packed_leg_to_forward_begin,
                    total_weight_to_forward,
+                   leg_concurrency,
+                   engine_working_data.shortcut_cache,
                    raw_route_data);
     }
     else
@@ -451,6 +495,8 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                    total_packed_path_to_reverse,
                    packed_leg_to_reverse_begin,
                    total_weight_to_reverse,
+                   leg_concurrency,
+                   engine_working_data.shortcut_cache,
                    raw_route_data);
     }
 
@@ -463,6 +509,18 @@ shortestPathSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
                    const boost::optional<bool> continue_straight_at_waypoint);
 
+// the customized CCH is searched like a CH
+template <>
+InternalRouteResult
+shortestPathSearch(SearchEngineData<cch::Algorithm> &engine_working_data,
+                   const datafacade::ContiguousInternalMemoryDataFacade<cch::Algorithm> &facade,
+                   const std::vector<PhantomNodes> &phantom_nodes_vector,
+                   const boost::optional<bool> continue_straight_at_waypoint)
+{
+    return shortestPathSearch<ch::Algorithm>(
+        engine_working_data, facade, phantom_nodes_vector, continue_straight_at_waypoint);
+}
+
 template InternalRouteResult
 shortestPathSearch(SearchEngineData<corech::Algorithm> &engine_working_data,
                    const datafacade::ContiguousInternalMemoryDataFacade<corech::Algorithm> &facade,
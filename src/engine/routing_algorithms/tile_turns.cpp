@@ -101,8 +101,6 @@ std::vector<TurnData> generateTurns(const datafacade &facade,
     //         w
     //  uv is the "approach"
     //  vw is the "exit"
-    std::vector<EdgeWeight> approach_weight_vector;
-    std::vector<EdgeWeight> approach_duration_vector;
 
     // Look at every node in the directed graph we created
     for (const auto &startnode : sorted_startnodes)
@@ -148,31 +146,20 @@ std::vector<TurnData> generateTurns(const datafacade &facade,
                     const auto &data = facade.GetEdgeData(edge_based_edge_id);
 
                     // Now, calculate the sum of the weight of all the segments.
-                    if (edge_based_node_info.find(approachedge.edge_based_node_id)
-                            ->second.is_geometry_forward)
-                    {
-                        approach_weight_vector = facade.GetUncompressedForwardWeights(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedForwardDurations(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                    }
-                    else
-                    {
-                        approach_weight_vector = facade.GetUncompressedReverseWeights(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedReverseDurations(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                    }
-                    const auto sum_node_weight = std::accumulate(approach_weight_vector.begin(),
-                                                                 approach_weight_vector.end(),
-                                                                 EdgeWeight{0});
-                    const auto sum_node_duration = std::accumulate(approach_duration_vector.begin(),
-                                                                   approach_duration_vector.end(),
-                                                                   EdgeWeight{0});
+                    const auto &approach_node_info =
+                        edge_based_node_info.find(approachedge.edge_based_node_id)->second;
+                    const auto geometry_id = approach_node_info.packed_geometry_id;
+                    const auto sum_range = [](const auto &range) {
+                        return std::accumulate(range.begin(), range.end(), EdgeWeight{0});
+                    };
+                    const auto sum_node_weight =
+                        approach_node_info.is_geometry_forward
+                            ? sum_range(facade.GetUncompressedForwardWeights(geometry_id))
+                            : sum_range(facade.GetUncompressedReverseWeights(geometry_id));
+                    const auto sum_node_duration =
+                        approach_node_info.is_geometry_forward
+                            ? sum_range(facade.GetUncompressedForwardDurations(geometry_id))
+                            : sum_range(facade.GetUncompressedReverseDurations(geometry_id));
 
                     // The edge.weight is the whole edge weight, which includes the turn
                     // cost.
@@ -0,0 +1,62 @@
+#include "engine/routing_cache.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+
+boost::optional<EdgeWeight> RoutingCache::GetDuration(const unsigned epoch,
+                                                      const PhantomNode &source,
+                                                      const PhantomNode &target)
+{
+    return durations.Get(DurationKey{epoch, PhantomNodeKey{source}, PhantomNodeKey{target}});
+}
+
+void RoutingCache::PutDuration(const unsigned epoch,
+                               const PhantomNode &source,
+                               const PhantomNode &target,
+                               const EdgeWeight duration)
+{
+    durations.Put(DurationKey{epoch, PhantomNodeKey{source}, PhantomNodeKey{target}}, duration);
+}
+
+RoutingCache::RouteKey RoutingCache::MakeRouteKey(const unsigned epoch,
+                                                  const RouteKind kind,
+                                                  const std::vector<PhantomNodes> &legs)
+{
+    RouteKey key{epoch, kind, {}};
+    key.waypoints.reserve(legs.size() * 2);
+    for (const auto &leg : legs)
+    {
+        key.waypoints.emplace_back(leg.source_phantom);
+        key.waypoints.emplace_back(leg.target_phantom);
+    }
+    return key;
+}
+
+boost::optional<InternalRouteResult> RoutingCache::GetRoute(const unsigned epoch,
+                                                            const RouteKind kind,
+                                                            const std::vector<PhantomNodes> &legs)
+{
+    auto route = routes.Get(MakeRouteKey(epoch, kind, legs));
+    if (route)
+    {
+        // the cached route might have been computed for other input coordinates
+        route->segment_end_coordinates = legs;
+    }
+    return route;
+}
+
+void RoutingCache::PutRoute(const unsigned epoch,
+                            const RouteKind kind,
+                            const std::vector<PhantomNodes> &legs,
+                            const InternalRouteResult &route)
+{
+    routes.Put(MakeRouteKey(epoch, kind, legs), route);
+}
+
+std::uint64_t RoutingCache::Hits() const { return durations.Hits() + routes.Hits(); }
+
+std::uint64_t RoutingCache::Misses() const { return durations.Misses() + routes.Misses(); }
+}
+}
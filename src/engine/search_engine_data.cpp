@@ -1,132 +1,301 @@
 #include "engine/search_engine_data.hpp"
 
+#include "util/heap_memory.hpp"
+
+#include <initializer_list>
+#include <limits>
+
 namespace osrm
 {
 namespace engine
 {
 
-// CH heaps
-using CH = routing_algorithms::ch::Algorithm;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_1;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_2;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_2;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_3;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_3;
-SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
-
-void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
+namespace
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
+util::IndexStorageType toIndexStorageType(const EngineConfig::HeapStorage storage,
+                                          const util::IndexStorageType default_storage)
+{
+    switch (storage)
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+    case EngineConfig::HeapStorage::UnorderedMap:
+        return util::IndexStorageType::UnorderedMap;
+    case EngineConfig::HeapStorage::GenerationArray:
+        return util::IndexStorageType::GenerationArray;
+    case EngineConfig::HeapStorage::TwoLevelArray:
+        return util::IndexStorageType::TwoLevelArray;
+    default:
+        return default_storage;
     }
+}
 
-    if (reverse_heap_1.get())
+// Heaps are shared by all engines of the same algorithm on a thread, so they need to be
+// re-created if the dataset has a different number of nodes or another storage was requested.
+template <typename HeapPtr>
+void initializeOrClearHeap(HeapPtr &heap,
+                           const unsigned number_of_nodes,
+                           const util::IndexStorageType storage)
+{
+    using Heap = typename HeapPtr::element_type;
+
+    if (heap.get() && heap->GetIndexStorage().Capacity() == number_of_nodes &&
+        heap->GetIndexStorage().Type() == storage)
     {
-        reverse_heap_1->Clear();
+        heap->Clear();
     }
     else
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+        heap.reset(new Heap(number_of_nodes, storage));
     }
 }
 
-void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+// Keeps the capacity of the bucket vector around so repeated table queries don't re-allocate
+template <typename BucketsPtr> void initializeOrClearBuckets(BucketsPtr &buckets)
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
-    {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
+    using Buckets = typename BucketsPtr::element_type;
 
-    if (reverse_heap_2.get())
+    if (buckets.get())
     {
-        reverse_heap_2->Clear();
+        buckets->clear();
     }
     else
     {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
+        buckets.reset(new Buckets());
     }
 }
 
-void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
+std::size_t toMaxHeapMemory(const int max_heap_memory)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    return max_heap_memory < 0 ? std::numeric_limits<std::size_t>::max()
+                               : static_cast<std::size_t>(max_heap_memory) * 1024 * 1024;
+}
 
-    if (reverse_heap_3.get())
+template <typename... HeapPtrs> std::uint64_t countSettledNodes(const HeapPtrs &... heaps)
+{
+    std::uint64_t settled_nodes = 0;
+    for (const auto count : {(heaps.get() ? heaps->GetSettledNodes() : std::uint64_t{0})...})
     {
-        reverse_heap_3->Clear();
+        settled_nodes += count;
     }
-    else
+    return settled_nodes;
+}
+
+// The heaps keep what the largest search of the thread allocated. Only once they hold more
+// than the limit together they are shrunk, so the usual queries never allocate them again.
+template <typename BucketsPtr, typename... HeapPtrs>
+void shrinkThreadLocalStorage(const std::size_t max_memory,
+                              BucketsPtr &buckets,
+                              HeapPtrs &... heaps)
+{
+    const auto memory_usage = [&] {
+        std::size_t bytes = buckets.get() ? buckets->capacity() * sizeof(NodeBucket) : 0;
+        for (const auto heap_bytes : {(heaps.get() ? heaps->MemoryUsage() : std::size_t{0})...})
+        {
+            bytes += heap_bytes;
+        }
+        return bytes;
+    };
+
+    auto bytes = memory_usage();
+    if (bytes > max_memory)
     {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
+        if (buckets.get())
+        {
+            typename BucketsPtr::element_type().swap(*buckets);
+        }
+        (void)std::initializer_list<int>{(heaps.get() ? heaps->Shrink() : void(), 0)...};
+        bytes = memory_usage();
     }
+    util::HeapMemoryMetrics::GetInstance().SetCurrent(bytes);
+}
+}
+
+// CH heaps
+using CH = routing_algorithms::ch::Algorithm;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_1;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_2;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_2;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_3;
+SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_3;
+SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
+SearchEngineData<CH>::SearchSpaceWithBucketsPtr SearchEngineData<CH>::many_to_many_buckets;
+
+// CH search spaces are small and local, so paged arrays avoid hashing without
+// allocating an entry per graph node for each of the six point-to-point heaps.
+SearchEngineData<CH>::SearchEngineData(const EngineConfig &config)
+    : query_heap_storage(
+          toIndexStorageType(config.query_heap_storage, util::IndexStorageType::TwoLevelArray)),
+      many_to_many_heap_storage(toIndexStorageType(config.many_to_many_heap_storage,
+                                                   util::IndexStorageType::TwoLevelArray)),
+      max_heap_memory(toMaxHeapMemory(config.max_heap_memory)),
+      many_to_many_concurrency(config.many_to_many_concurrency),
+      leg_concurrency(config.leg_concurrency),
+      leg_concurrency_min_waypoints(config.leg_concurrency_min_waypoints),
+      use_landmarks_for_route(config.use_landmarks_for_route),
+      use_landmarks_for_match(config.use_landmarks_for_match),
+      max_core_settled_nodes(config.max_core_settled_nodes < 0
+                                 ? std::numeric_limits<std::size_t>::max()
+                                 : static_cast<std::size_t>(config.max_core_settled_nodes))
+{
+}
+
+void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_1, number_of_nodes, query_heap_storage);
+    initializeOrClearHeap(reverse_heap_1, number_of_nodes, query_heap_storage);
+}
+
+void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_2, number_of_nodes, query_heap_storage);
+    initializeOrClearHeap(reverse_heap_2, number_of_nodes, query_heap_storage);
+}
+
+void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_3, number_of_nodes, query_heap_storage);
+    initializeOrClearHeap(reverse_heap_3, number_of_nodes, query_heap_storage);
 }
 
 void SearchEngineData<CH>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(many_to_many_heap, number_of_nodes, many_to_many_heap_storage);
+    initializeOrClearBuckets(many_to_many_buckets);
 }
 
+void SearchEngineData<CH>::ShrinkThreadLocalStorage()
+{
+    shrinkThreadLocalStorage(max_heap_memory,
+                             many_to_many_buckets,
+                             forward_heap_1,
+                             reverse_heap_1,
+                             forward_heap_2,
+                             reverse_heap_2,
+                             forward_heap_3,
+                             reverse_heap_3,
+                             many_to_many_heap);
+}
+
+std::uint64_t SearchEngineData<CH>::GetSettledNodes() const
+{
+    return countSettledNodes(forward_heap_1,
+                             reverse_heap_1,
+                             forward_heap_2,
+                             reverse_heap_2,
+                             forward_heap_3,
+                             reverse_heap_3,
+                             many_to_many_heap);
+}
+
+void ManyToManyGroupSearch::Clear()
+{
+    slots.clear();
+    nodes.clear();
+    labels.clear();
+    queued_weights.clear();
+    queue.clear();
+    relaxed.clear();
+}
+
+std::size_t ManyToManyGroupSearch::MemoryUsage() const
+{
+    return slots.bucket_count() * sizeof(void *) +
+           slots.size() * (sizeof(decltype(slots)::value_type) + sizeof(void *)) +
+           nodes.capacity() * sizeof(NodeID) + labels.capacity() * sizeof(Label) +
+           queued_weights.capacity() * sizeof(EdgeWeight) +
+           queue.capacity() * sizeof(QueueEntry) +
+           relaxed.capacity() * sizeof(decltype(relaxed)::value_type);
+}
+
+void ManyToManyGroupSearch::Shrink() { *this = ManyToManyGroupSearch(); }
+
 // MLD
 using MLD = routing_algorithms::mld::Algorithm;
 SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::forward_heap_1;
 SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::reverse_heap_1;
+SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::forward_heap_2;
+SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::reverse_heap_2;
+SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::overlay_forward_heap;
+SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::overlay_reverse_heap;
 SearchEngineData<MLD>::ManyToManyHeapPtr SearchEngineData<MLD>::many_to_many_heap;
+SearchEngineData<MLD>::SearchSpaceWithBucketsPtr SearchEngineData<MLD>::many_to_many_buckets;
+SearchEngineData<MLD>::ManyToManyGroupSearchPtr SearchEngineData<MLD>::many_to_many_group_search;
+
+// MLD many-to-many searches jump across the whole graph on the overlay levels
+// which would touch most pages of a paged array, so they keep using the hash map.
+SearchEngineData<MLD>::SearchEngineData(const EngineConfig &config)
+    : query_heap_storage(
+          toIndexStorageType(config.query_heap_storage, util::IndexStorageType::TwoLevelArray)),
+      many_to_many_heap_storage(toIndexStorageType(config.many_to_many_heap_storage,
+                                                   util::IndexStorageType::UnorderedMap)),
+      max_heap_memory(toMaxHeapMemory(config.max_heap_memory)),
+      many_to_many_concurrency(config.many_to_many_concurrency),
+      leg_concurrency(config.leg_concurrency),
+      leg_concurrency_min_waypoints(config.leg_concurrency_min_waypoints),
+      alternatives_concurrency(config.alternatives_concurrency),
+      use_landmarks_for_route(config.use_landmarks_for_route),
+      use_landmarks_for_match(config.use_landmarks_for_match)
+{
+}
 
 void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(forward_heap_1, number_of_nodes, query_heap_storage);
+    initializeOrClearHeap(reverse_heap_1, number_of_nodes, query_heap_storage);
+}
 
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+void SearchEngineData<MLD>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_2, number_of_nodes, query_heap_storage);
+    initializeOrClearHeap(reverse_heap_2, number_of_nodes, query_heap_storage);
+}
+
+// The overlay graph is small and most of it is searched, so it gets plain arrays
+void SearchEngineData<MLD>::InitializeOrClearOverlayThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(
+        overlay_forward_heap, number_of_nodes, util::IndexStorageType::GenerationArray);
+    initializeOrClearHeap(
+        overlay_reverse_heap, number_of_nodes, util::IndexStorageType::GenerationArray);
 }
 
 void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
+    initializeOrClearHeap(many_to_many_heap, number_of_nodes, many_to_many_heap_storage);
+    initializeOrClearBuckets(many_to_many_buckets);
+    if (many_to_many_group_search.get())
     {
-        many_to_many_heap->Clear();
+        many_to_many_group_search->Clear();
     }
     else
     {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
+        many_to_many_group_search.reset(new ManyToManyGroupSearch());
     }
 }
+
+void SearchEngineData<MLD>::ShrinkThreadLocalStorage()
+{
+    shrinkThreadLocalStorage(max_heap_memory,
+                             many_to_many_buckets,
+                             forward_heap_1,
+                             reverse_heap_1,
+                             forward_heap_2,
+                             reverse_heap_2,
+                             overlay_forward_heap,
+                             overlay_reverse_heap,
+                             many_to_many_heap,
+                             many_to_many_group_search);
+}
+
+std::uint64_t SearchEngineData<MLD>::GetSettledNodes() const
+{
+    return countSettledNodes(forward_heap_1,
+                             reverse_heap_1,
+                             forward_heap_2,
+                             reverse_heap_2,
+                             overlay_forward_heap,
+                             overlay_reverse_heap,
+                             many_to_many_heap);
+}
 }
 }
@@ -0,0 +1,27 @@
+#include "engine/snap_cache.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+
+boost::optional<PhantomNodePair> SnapCache::Get(const unsigned epoch,
+                                                const util::Coordinate coordinate,
+                                                const boost::optional<double> &radius,
+                                                const boost::optional<Bearing> &bearing,
+                                                const boost::optional<Approach> &approach)
+{
+    return snaps.Get(SnapKey{epoch, coordinate, radius, bearing, approach});
+}
+
+void SnapCache::Put(const unsigned epoch,
+                    const util::Coordinate coordinate,
+                    const boost::optional<double> &radius,
+                    const boost::optional<Bearing> &bearing,
+                    const boost::optional<Approach> &approach,
+                    const PhantomNodePair &phantom_nodes)
+{
+    snaps.Put(SnapKey{epoch, coordinate, radius, bearing, approach}, phantom_nodes);
+}
+}
+}
@@ -0,0 +1,131 @@
+#include "engine/tile_cache.hpp"
+
+#include "util/log.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace osrm
+{
+namespace engine
+{
+
+TileCache::TileCache(const std::size_t capacity, boost::filesystem::path directory_)
+    : directory(std::move(directory_))
+{
+    if (capacity > 0)
+    {
+        tiles =
+            std::make_unique<util::ShardedLRUCache<TileKey, std::string, TileKeyHash>>(capacity);
+    }
+}
+
+std::string TileCache::DatasetName(const unsigned checksum, const std::string &timestamp)
+{
+    auto name = std::to_string(checksum);
+    if (!timestamp.empty())
+    {
+        name += '-';
+        for (const auto character : timestamp)
+        {
+            name += std::isalnum(static_cast<unsigned char>(character)) ? character : '_';
+        }
+    }
+    return name;
+}
+
+boost::optional<std::string> TileCache::Get(const unsigned epoch,
+                                            const std::string &dataset,
+                                            const unsigned x,
+                                            const unsigned y,
+                                            const unsigned z)
+{
+    if (tiles)
+    {
+        if (auto tile = tiles->Get(TileKey{epoch, x, y, z}))
+        {
+            hits++;
+            return tile;
+        }
+    }
+
+    if (!directory.empty())
+    {
+        std::ifstream file(TilePath(dataset, x, y, z).string(), std::ios::binary);
+        if (file)
+        {
+            std::string tile{std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>()};
+            if (file.good() || file.eof())
+            {
+                if (tiles)
+                {
+                    tiles->Put(TileKey{epoch, x, y, z}, tile);
+                }
+                hits++;
+                return tile;
+            }
+        }
+    }
+
+    misses++;
+    return boost::none;
+}
+
+void TileCache::Put(const unsigned epoch,
+                    const std::string &dataset,
+                    const unsigned x,
+                    const unsigned y,
+                    const unsigned z,
+                    const std::string &tile)
+{
+    if (tiles)
+    {
+        tiles->Put(TileKey{epoch, x, y, z}, tile);
+    }
+
+    if (directory.empty())
+    {
+        return;
+    }
+
+    // write to a temporary file that is renamed once complete, so concurrent readers and
+    // writers of the same tile never see a partial one
+    const auto path = TilePath(dataset, x, y, z);
+    boost::system::error_code error;
+    boost::filesystem::create_directories(path.parent_path(), error);
+    const auto temporary_path =
+        path.parent_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.tmp", error);
+    {
+        std::ofstream file(temporary_path.string(), std::ios::binary);
+        file.write(tile.data(), tile.size());
+        if (!file)
+        {
+            util::Log(logWARNING) << "Could not persist tile " << z << "/" << x << "/" << y
+                                  << " to " << path;
+            file.close();
+            boost::filesystem::remove(temporary_path, error);
+            return;
+        }
+    }
+    boost::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        boost::filesystem::remove(temporary_path, error);
+    }
+}
+
+boost::filesystem::path TileCache::TilePath(const std::string &dataset,
+                                            const unsigned x,
+                                            const unsigned y,
+                                            const unsigned z) const
+{
+    return directory / dataset / std::to_string(z) / std::to_string(x) /
+           (std::to_string(y) + ".mvt");
+}
+}
+}
@@ -1,77 +1,93 @@
 #include "extractor/compressed_edge_container.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 
 #include <boost/assert.hpp>
-#include <boost/filesystem.hpp>
-#include <boost/filesystem/fstream.hpp>
-#include <boost/numeric/conversion/cast.hpp>
 
+#include <algorithm>
 #include <limits>
-#include <string>
-
-#include <iostream>
+#include <utility>
 
 namespace osrm
 {
 namespace extractor
 {
 
-CompressedEdgeContainer::CompressedEdgeContainer()
+constexpr unsigned CompressedEdgeContainer::INVALID_SEGMENT;
+
+CompressedEdgeContainer::CompressedEdgeContainer() {}
+
+CompressedEdgeContainer::SegmentList &
+CompressedEdgeContainer::GetOrCreateList(const EdgeID edge_id)
 {
-    m_free_list.reserve(100);
-    IncreaseFreeList();
+    BOOST_ASSERT(!IsCompacted());
+    if (edge_id >= m_segment_lists.size())
+    {
+        m_segment_lists.resize(edge_id + 1);
+    }
+    return m_segment_lists[edge_id];
 }
 
-void CompressedEdgeContainer::IncreaseFreeList()
+void CompressedEdgeContainer::Append(SegmentList &list, const OnewayCompressedEdge &segment)
 {
-    m_compressed_oneway_geometries.resize(m_compressed_oneway_geometries.size() + 100);
-    for (unsigned i = 100; i > 0; --i)
+    const unsigned index = m_segment_pool.size();
+    m_segment_pool.push_back(segment);
+    m_next_segment.push_back(INVALID_SEGMENT);
+
+    if (list.head == INVALID_SEGMENT)
     {
-        m_free_list.emplace_back(free_list_maximum);
-        ++free_list_maximum;
+        list.head = index;
     }
+    else
+    {
+        m_next_segment[list.last] = index;
+    }
+    list.second_last = list.last;
+    list.last = index;
+    ++list.length;
 }
 
 bool CompressedEdgeContainer::HasEntryForID(const EdgeID edge_id) const
 {
-    auto iter = m_edge_id_to_list_index_map.find(edge_id);
-    return iter != m_edge_id_to_list_index_map.end();
+    if (IsCompacted())
+    {
+        return edge_id + 1 < m_bucket_offsets.size() &&
+               m_bucket_offsets[edge_id] != m_bucket_offsets[edge_id + 1];
+    }
+    return edge_id < m_segment_lists.size() && m_segment_lists[edge_id].length > 0;
 }
 
 bool CompressedEdgeContainer::HasZippedEntryForForwardID(const EdgeID edge_id) const
 {
-    auto iter = m_forward_edge_id_to_zipped_index_map.find(edge_id);
-    return iter != m_forward_edge_id_to_zipped_index_map.end();
+    return edge_id < m_forward_edge_id_to_zipped_index.size() &&
+           m_forward_edge_id_to_zipped_index[edge_id] != INVALID_SEGMENT;
 }
 
 bool CompressedEdgeContainer::HasZippedEntryForReverseID(const EdgeID edge_id) const
 {
-    auto iter = m_reverse_edge_id_to_zipped_index_map.find(edge_id);
-    return iter != m_reverse_edge_id_to_zipped_index_map.end();
+    return edge_id < m_reverse_edge_id_to_zipped_index.size() &&
+           m_reverse_edge_id_to_zipped_index[edge_id] != INVALID_SEGMENT;
 }
 
 unsigned CompressedEdgeContainer::GetPositionForID(const EdgeID edge_id) const
 {
-    auto map_iterator = m_edge_id_to_list_index_map.find(edge_id);
-    BOOST_ASSERT(map_iterator != m_edge_id_to_list_index_map.end());
-    BOOST_ASSERT(map_iterator->second < m_compressed_oneway_geometries.size());
-    return map_iterator->second;
+    BOOST_ASSERT(IsCompacted());
+    BOOST_ASSERT(HasEntryForID(edge_id));
+    return m_bucket_offsets[edge_id];
 }
 
 unsigned CompressedEdgeContainer::GetZippedPositionForForwardID(const EdgeID edge_id) const
 {
-    auto map_iterator = m_forward_edge_id_to_zipped_index_map.find(edge_id);
-    BOOST_ASSERT(map_iterator != m_forward_edge_id_to_zipped_index_map.end());
-    BOOST_ASSERT(map_iterator->second < segment_data->nodes.size());
-    return map_iterator->second;
+    BOOST_ASSERT(HasZippedEntryForForwardID(edge_id));
+    BOOST_ASSERT(m_forward_edge_id_to_zipped_index[edge_id] < segment_data->nodes.size());
+    return m_forward_edge_id_to_zipped_index[edge_id];
 }
 
 unsigned CompressedEdgeContainer::GetZippedPositionForReverseID(const EdgeID edge_id) const
 {
-    auto map_iterator = m_reverse_edge_id_to_zipped_index_map.find(edge_id);
-    BOOST_ASSERT(map_iterator != m_reverse_edge_id_to_zipped_index_map.end());
-    BOOST_ASSERT(map_iterator->second < segment_data->nodes.size());
-    return map_iterator->second;
+    BOOST_ASSERT(HasZippedEntryForReverseID(edge_id));
+    BOOST_ASSERT(m_reverse_edge_id_to_zipped_index[edge_id] < segment_data->nodes.size());
+    return m_reverse_edge_id_to_zipped_index[edge_id];
 }
 
 SegmentWeight CompressedEdgeContainer::ClipWeight(const SegmentWeight weight)
@@ -128,67 +144,38 @@ void CompressedEdgeContainer::CompressEdge(const EdgeID edge_id_1,
     // 2. find list for edge_id_2, if yes add all elements and delete it
 
     // Add via node id. List is created if it does not exist
-    if (!HasEntryForID(edge_id_1))
-    {
-        // create a new entry in the map
-        if (0 == m_free_list.size())
-        {
-            // make sure there is a place to put the entries
-            IncreaseFreeList();
-        }
-        BOOST_ASSERT(!m_free_list.empty());
-        m_edge_id_to_list_index_map[edge_id_1] = m_free_list.back();
-        m_free_list.pop_back();
-    }
-
-    // find bucket index
-    const auto iter = m_edge_id_to_list_index_map.find(edge_id_1);
-    BOOST_ASSERT(iter != m_edge_id_to_list_index_map.end());
-    const unsigned edge_bucket_id1 = iter->second;
-    BOOST_ASSERT(edge_bucket_id1 == GetPositionForID(edge_id_1));
-    BOOST_ASSERT(edge_bucket_id1 < m_compressed_oneway_geometries.size());
-
-    std::vector<OnewayCompressedEdge> &edge_bucket_list1 =
-        m_compressed_oneway_geometries[edge_bucket_id1];
+    SegmentList &edge_list1 = GetOrCreateList(edge_id_1);
 
     // note we don't save the start coordinate: it is implicitly given by edge 1
-    // weight1 is the distance to the (currently) last coordinate in the bucket
-    if (edge_bucket_list1.empty())
+    // weight1 is the distance to the (currently) last coordinate in the list
+    if (edge_list1.length == 0)
     {
-        edge_bucket_list1.emplace_back(
-            OnewayCompressedEdge{via_node_id, ClipWeight(weight1), ClipDuration(duration1)});
+        Append(edge_list1,
+               OnewayCompressedEdge{via_node_id, ClipWeight(weight1), ClipDuration(duration1)});
     }
 
-    BOOST_ASSERT(0 < edge_bucket_list1.size());
-    BOOST_ASSERT(!edge_bucket_list1.empty());
+    BOOST_ASSERT(0 < edge_list1.length);
 
     if (HasEntryForID(edge_id_2))
     {
-        // second edge is not atomic anymore
-        const unsigned list_to_remove_index = GetPositionForID(edge_id_2);
-        BOOST_ASSERT(list_to_remove_index < m_compressed_oneway_geometries.size());
-
-        std::vector<OnewayCompressedEdge> &edge_bucket_list2 =
-            m_compressed_oneway_geometries[list_to_remove_index];
+        // second edge is not atomic anymore, link its list to the list of edge_id_1
+        SegmentList &edge_list2 = m_segment_lists[edge_id_2];
+        BOOST_ASSERT(&edge_list1 != &edge_list2);
 
-        // found an existing list, append it to the list of edge_id_1
-        edge_bucket_list1.insert(
-            edge_bucket_list1.end(), edge_bucket_list2.begin(), edge_bucket_list2.end());
+        m_next_segment[edge_list1.last] = edge_list2.head;
+        edge_list1.second_last = edge_list2.length > 1 ? edge_list2.second_last : edge_list1.last;
+        edge_list1.last = edge_list2.last;
+        edge_list1.length += edge_list2.length;
 
         // remove the list of edge_id_2
-        m_edge_id_to_list_index_map.erase(edge_id_2);
-        BOOST_ASSERT(m_edge_id_to_list_index_map.end() ==
-                     m_edge_id_to_list_index_map.find(edge_id_2));
-        edge_bucket_list2.clear();
-        BOOST_ASSERT(0 == edge_bucket_list2.size());
-        m_free_list.emplace_back(list_to_remove_index);
-        BOOST_ASSERT(list_to_remove_index == m_free_list.back());
+        edge_list2 = SegmentList{};
+        BOOST_ASSERT(!HasEntryForID(edge_id_2));
     }
     else
     {
         // we are certain that the second edge is atomic.
-        edge_bucket_list1.emplace_back(
-            OnewayCompressedEdge{target_node_id, ClipWeight(weight2), ClipDuration(duration2)});
+        Append(edge_list1,
+               OnewayCompressedEdge{target_node_id, ClipWeight(weight2), ClipDuration(duration2)});
     }
 }
 
@@ -202,50 +189,89 @@ void CompressedEdgeContainer::AddUncompressedEdge(const EdgeID edge_id,
     BOOST_ASSERT(SPECIAL_NODEID != target_node_id);
     BOOST_ASSERT(INVALID_EDGE_WEIGHT != weight);
 
-    // Add via node id. List is created if it does not exist
-    if (!HasEntryForID(edge_id))
+    // List is created if it does not exist
+    SegmentList &edge_list = GetOrCreateList(edge_id);
+
+    // note we don't save the start coordinate: it is implicitly given by edge_id
+    // weight is the distance to the (currently) last coordinate in the list
+    // Don't re-add this if it's already in there.
+    if (edge_list.length == 0)
     {
-        // create a new entry in the map
-        if (0 == m_free_list.size())
+        Append(edge_list,
+               OnewayCompressedEdge{target_node_id, ClipWeight(weight), ClipDuration(duration)});
+    }
+}
+
+void CompressedEdgeContainer::RenumberEdges(const std::vector<EdgeID> &new_edge_ids)
+{
+    BOOST_ASSERT(!IsCompacted());
+
+    std::vector<SegmentList> renumbered_lists;
+    for (const auto edge_id : util::irange<std::size_t>(0, m_segment_lists.size()))
+    {
+        if (m_segment_lists[edge_id].length == 0)
+            continue;
+
+        BOOST_ASSERT(edge_id < new_edge_ids.size());
+        const auto new_edge_id = new_edge_ids[edge_id];
+        BOOST_ASSERT(new_edge_id != SPECIAL_EDGEID);
+        if (new_edge_id >= renumbered_lists.size())
         {
-            // make sure there is a place to put the entries
-            IncreaseFreeList();
+            renumbered_lists.resize(new_edge_id + 1);
         }
-        BOOST_ASSERT(!m_free_list.empty());
-        m_edge_id_to_list_index_map[edge_id] = m_free_list.back();
-        m_free_list.pop_back();
+        renumbered_lists[new_edge_id] = m_segment_lists[edge_id];
     }
+    m_segment_lists = std::move(renumbered_lists);
+}
 
-    // find bucket index
-    const auto iter = m_edge_id_to_list_index_map.find(edge_id);
-    BOOST_ASSERT(iter != m_edge_id_to_list_index_map.end());
-    const unsigned edge_bucket_id = iter->second;
-    BOOST_ASSERT(edge_bucket_id == GetPositionForID(edge_id));
-    BOOST_ASSERT(edge_bucket_id < m_compressed_oneway_geometries.size());
+// Copies the linked lists into one array ordered by edge id in two passes, the first one counts
+// the segments of every edge
+void CompressedEdgeContainer::Compact()
+{
+    BOOST_ASSERT(!IsCompacted());
 
-    std::vector<OnewayCompressedEdge> &edge_bucket_list =
-        m_compressed_oneway_geometries[edge_bucket_id];
+    m_bucket_offsets.resize(m_segment_lists.size() + 1);
+    m_bucket_offsets[0] = 0;
+    for (const auto edge_id : util::irange<std::size_t>(0, m_segment_lists.size()))
+    {
+        m_bucket_offsets[edge_id + 1] = m_bucket_offsets[edge_id] + m_segment_lists[edge_id].length;
+    }
 
-    // note we don't save the start coordinate: it is implicitly given by edge_id
-    // weight is the distance to the (currently) last coordinate in the bucket
-    // Don't re-add this if it's already in there.
-    if (edge_bucket_list.empty())
+    m_segments.resize(m_bucket_offsets.back());
+    for (const auto edge_id : util::irange<std::size_t>(0, m_segment_lists.size()))
     {
-        edge_bucket_list.emplace_back(
-            OnewayCompressedEdge{target_node_id, ClipWeight(weight), ClipDuration(duration)});
+        auto position = m_bucket_offsets[edge_id];
+        for (auto index = m_segment_lists[edge_id].head; index != INVALID_SEGMENT;
+             index = m_next_segment[index])
+        {
+            m_segments[position++] = m_segment_pool[index];
+        }
+        BOOST_ASSERT(position == m_bucket_offsets[edge_id + 1]);
     }
+
+    // free the linked lists
+    std::vector<SegmentList>().swap(m_segment_lists);
+    std::vector<OnewayCompressedEdge>().swap(m_segment_pool);
+    std::vector<unsigned>().swap(m_next_segment);
 }
 
 void CompressedEdgeContainer::InitializeBothwayVector()
 {
+    Compact();
+
+    const auto number_of_edges = m_bucket_offsets.size() - 1;
+    m_forward_edge_id_to_zipped_index.assign(number_of_edges, INVALID_SEGMENT);
+    m_reverse_edge_id_to_zipped_index.assign(number_of_edges, INVALID_SEGMENT);
+
+    // every geometry is stored with one more node than the segments of one direction
     segment_data = std::make_unique<SegmentDataContainer>();
-    segment_data->index.reserve(m_compressed_oneway_geometries.size());
-    segment_data->nodes.reserve(m_compressed_oneway_geometries.size());
-    segment_data->fwd_weights.reserve(m_compressed_oneway_geometries.size());
-    segment_data->rev_weights.reserve(m_compressed_oneway_geometries.size());
-    segment_data->fwd_durations.reserve(m_compressed_oneway_geometries.size());
-    segment_data->rev_durations.reserve(m_compressed_oneway_geometries.size());
-    segment_data->datasources.reserve(m_compressed_oneway_geometries.size());
+    segment_data->index.reserve(number_of_edges / 2);
+    segment_data->nodes.reserve(m_segments.size() / 2 + number_of_edges / 2);
+    segment_data->fwd_weights.reserve(m_segments.size() / 2 + number_of_edges / 2);
+    segment_data->rev_weights.reserve(m_segments.size() / 2 + number_of_edges / 2);
+    segment_data->fwd_durations.reserve(m_segments.size() / 2 + number_of_edges / 2);
+    segment_data->rev_durations.reserve(m_segments.size() / 2 + number_of_edges / 2);
+    segment_data->datasources.reserve(m_segments.size() / 2 + number_of_edges / 2);
 }
 
 unsigned CompressedEdgeContainer::ZipEdges(const EdgeID f_edge_id, const EdgeID r_edge_id)
@@ -256,8 +282,8 @@ unsigned CompressedEdgeContainer::ZipEdges(const EdgeID f_edge_id, const EdgeID
     BOOST_ASSERT(forward_bucket.size() == reverse_bucket.size());
 
     const unsigned zipped_geometry_id = segment_data->index.size();
-    m_forward_edge_id_to_zipped_index_map[f_edge_id] = zipped_geometry_id;
-    m_reverse_edge_id_to_zipped_index_map[r_edge_id] = zipped_geometry_id;
+    m_forward_edge_id_to_zipped_index[f_edge_id] = zipped_geometry_id;
+    m_reverse_edge_id_to_zipped_index[r_edge_id] = zipped_geometry_id;
 
     segment_data->index.emplace_back(segment_data->nodes.size());
 
@@ -301,17 +327,17 @@ unsigned CompressedEdgeContainer::ZipEdges(const EdgeID f_edge_id, const EdgeID
 
 void CompressedEdgeContainer::PrintStatistics() const
 {
-    const uint64_t compressed_edges = m_compressed_oneway_geometries.size();
-    BOOST_ASSERT(0 == compressed_edges % 2);
-    BOOST_ASSERT(m_compressed_oneway_geometries.size() + m_free_list.size() > 0);
+    BOOST_ASSERT(IsCompacted());
 
-    uint64_t compressed_geometries = 0;
+    uint64_t compressed_edges = 0;
     uint64_t longest_chain_length = 0;
-    for (const std::vector<OnewayCompressedEdge> &current_vector : m_compressed_oneway_geometries)
+    for (const auto edge_id : util::irange<std::size_t>(0, m_bucket_offsets.size() - 1))
     {
-        compressed_geometries += current_vector.size();
-        longest_chain_length = std::max(longest_chain_length, (uint64_t)current_vector.size());
+        const uint64_t chain_length = m_bucket_offsets[edge_id + 1] - m_bucket_offsets[edge_id];
+        compressed_edges += chain_length > 0 ? 1 : 0;
+        longest_chain_length = std::max(longest_chain_length, chain_length);
     }
+    const uint64_t compressed_geometries = m_segments.size();
 
     if (clipped_weights > 0)
     {
@@ -333,11 +359,13 @@ void CompressedEdgeContainer::PrintStatistics() const
                 << (float)compressed_geometries / std::max((uint64_t)1, compressed_edges);
 }
 
-const CompressedEdgeContainer::OnewayEdgeBucket &
+CompressedEdgeContainer::OnewayEdgeBucket
 CompressedEdgeContainer::GetBucketReference(const EdgeID edge_id) const
 {
-    const unsigned index = m_edge_id_to_list_index_map.at(edge_id);
-    return m_compressed_oneway_geometries.at(index);
+    BOOST_ASSERT(IsCompacted());
+    BOOST_ASSERT(HasEntryForID(edge_id));
+    const auto begin = m_bucket_offsets[edge_id];
+    return OnewayEdgeBucket(m_segments.data() + begin, m_bucket_offsets[edge_id + 1] - begin);
 }
 
 // Since all edges are technically in the compressed geometry container,
@@ -346,27 +374,36 @@ CompressedEdgeContainer::GetBucketReference(const EdgeID edge_id) const
 // that only contain one original segment
 bool CompressedEdgeContainer::IsTrivial(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    return bucket.size() == 1;
+    if (IsCompacted())
+        return GetBucketReference(edge_id).size() == 1;
+    return m_segment_lists.at(edge_id).length == 1;
 }
 
 NodeID CompressedEdgeContainer::GetFirstEdgeTargetID(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    BOOST_ASSERT(bucket.size() >= 1);
-    return bucket.front().node_id;
+    BOOST_ASSERT(HasEntryForID(edge_id));
+    if (IsCompacted())
+        return GetBucketReference(edge_id).front().node_id;
+    return m_segment_pool[m_segment_lists.at(edge_id).head].node_id;
 }
 NodeID CompressedEdgeContainer::GetLastEdgeTargetID(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    BOOST_ASSERT(bucket.size() >= 1);
-    return bucket.back().node_id;
+    BOOST_ASSERT(HasEntryForID(edge_id));
+    if (IsCompacted())
+        return GetBucketReference(edge_id).back().node_id;
+    return m_segment_pool[m_segment_lists.at(edge_id).last].node_id;
 }
 NodeID CompressedEdgeContainer::GetLastEdgeSourceID(const EdgeID edge_id) const
 {
-    const auto &bucket = GetBucketReference(edge_id);
-    BOOST_ASSERT(bucket.size() >= 2);
-    return bucket[bucket.size() - 2].node_id;
+    if (IsCompacted())
+    {
+        const auto bucket = GetBucketReference(edge_id);
+        BOOST_ASSERT(bucket.size() >= 2);
+        return bucket[bucket.size() - 2].node_id;
+    }
+    const auto &list = m_segment_lists.at(edge_id);
+    BOOST_ASSERT(list.length >= 2);
+    return m_segment_pool[list.second_last].node_id;
 }
 
 std::unique_ptr<SegmentDataContainer> CompressedEdgeContainer::ToSegmentData()
@@ -26,6 +26,7 @@
 #include <cmath>
 #include <iomanip>
 #include <limits>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -39,10 +40,14 @@ namespace osrm
 {
 namespace extractor
 {
+
+constexpr std::size_t EdgeBasedGraphFactory::RENUMBER_BLOCK_SIZE;
+constexpr std::size_t EdgeBasedGraphFactory::GENERATE_NODES_BLOCK_SIZE;
+
 // Configuration to find representative candidate for turn angle calculations
 
 EdgeBasedGraphFactory::EdgeBasedGraphFactory(
-    std::shared_ptr<util::NodeBasedDynamicGraph> node_based_graph,
+    std::shared_ptr<util::NodeBasedStaticGraph> node_based_graph,
     CompressedEdgeContainer &compressed_edge_container,
     const std::unordered_set<NodeID> &barrier_nodes,
     const std::unordered_set<NodeID> &traffic_lights,
@@ -52,8 +57,8 @@ EdgeBasedGraphFactory::EdgeBasedGraphFactory(
     ProfileProperties profile_properties,
     const util::NameTable &name_table,
     guidance::LaneDescriptionMap &lane_description_map)
-    : m_max_edge_id(0), m_coordinates(coordinates), m_osm_node_ids(osm_node_ids),
-      m_node_based_graph(std::move(node_based_graph)),
+    : m_number_of_edge_based_edges(0), m_max_edge_id(0), m_coordinates(coordinates),
+      m_osm_node_ids(osm_node_ids), m_node_based_graph(std::move(node_based_graph)),
       m_restriction_map(std::move(restriction_map)), m_barrier_nodes(barrier_nodes),
       m_traffic_lights(traffic_lights), m_compressed_edge_container(compressed_edge_container),
       profile_properties(std::move(profile_properties)), name_table(name_table),
@@ -61,14 +66,6 @@ EdgeBasedGraphFactory::EdgeBasedGraphFactory(
 {
 }
 
-void EdgeBasedGraphFactory::GetEdgeBasedEdges(
-    util::DeallocatingVector<EdgeBasedEdge> &output_edge_list)
-{
-    BOOST_ASSERT_MSG(0 == output_edge_list.size(), "Vector is not empty");
-    using std::swap; // Koenig swap
-    swap(m_edge_based_edge_list, output_edge_list);
-}
-
 void EdgeBasedGraphFactory::GetEdgeBasedNodes(EdgeBasedNodeDataContainer &data_container)
 {
     using std::swap; // Koenig swap
@@ -95,7 +92,9 @@ void EdgeBasedGraphFactory::GetEdgeBasedNodeWeights(std::vector<EdgeWeight> &out
 
 EdgeID EdgeBasedGraphFactory::GetHighestEdgeID() { return m_max_edge_id; }
 
-NBGToEBG EdgeBasedGraphFactory::InsertEdgeBasedNode(const NodeID node_u, const NodeID node_v)
+void EdgeBasedGraphFactory::InsertEdgeBasedNode(const NodeID node_u,
+                                                const NodeID node_v,
+                                                EdgeBasedNodeBlock &block)
 {
     // merge edges together into one EdgeBasedNode
     BOOST_ASSERT(node_u != SPECIAL_NODEID);
@@ -115,6 +114,7 @@ NBGToEBG EdgeBasedGraphFactory::InsertEdgeBasedNode(const NodeID node_u, const N
 
     BOOST_ASSERT(forward_data.edge_id != SPECIAL_NODEID || reverse_data.edge_id != SPECIAL_NODEID);
 
+    // every forward edge id belongs to one node-based edge, so blocks write different weights
     if (forward_data.edge_id != SPECIAL_NODEID && reverse_data.edge_id == SPECIAL_NODEID)
         m_edge_based_node_weights[forward_data.edge_id] = INVALID_EDGE_WEIGHT;
 
@@ -130,8 +130,6 @@ NBGToEBG EdgeBasedGraphFactory::InsertEdgeBasedNode(const NodeID node_u, const N
     // There should always be some geometry
     BOOST_ASSERT(0 != segment_count);
 
-    const unsigned packed_geometry_id = m_compressed_edge_container.ZipEdges(edge_id_1, edge_id_2);
-
     NodeID current_edge_source_coordinate_id = node_u;
 
     const auto edge_id_to_segment_id = [](const NodeID edge_based_node_id) {
@@ -143,22 +141,6 @@ NBGToEBG EdgeBasedGraphFactory::InsertEdgeBasedNode(const NodeID node_u, const N
         return SegmentID{edge_based_node_id, true};
     };
 
-    // Add edge-based node data for forward and reverse nodes indexed by edge_id
-    BOOST_ASSERT(forward_data.edge_id != SPECIAL_EDGEID);
-    m_edge_based_node_container.SetData(forward_data.edge_id,
-                                        GeometryID{packed_geometry_id, true},
-                                        forward_data.name_id,
-                                        forward_data.travel_mode,
-                                        forward_data.classes);
-    if (reverse_data.edge_id != SPECIAL_EDGEID)
-    {
-        m_edge_based_node_container.SetData(reverse_data.edge_id,
-                                            GeometryID{packed_geometry_id, false},
-                                            reverse_data.name_id,
-                                            reverse_data.travel_mode,
-                                            reverse_data.classes);
-    }
-
     // Add segments of edge-based nodes
     for (const auto i : util::irange(std::size_t{0}, segment_count))
     {
@@ -170,23 +152,49 @@ NBGToEBG EdgeBasedGraphFactory::InsertEdgeBasedNode(const NodeID node_u, const N
         BOOST_ASSERT(current_edge_target_coordinate_id != current_edge_source_coordinate_id);
 
         // build edges
-        m_edge_based_node_segments.emplace_back(edge_id_to_segment_id(forward_data.edge_id),
-                                                edge_id_to_segment_id(reverse_data.edge_id),
-                                                current_edge_source_coordinate_id,
-                                                current_edge_target_coordinate_id,
-                                                i);
-
-        m_edge_based_node_is_startpoint.push_back(forward_data.startpoint ||
-                                                  reverse_data.startpoint);
+        block.segments.emplace_back(edge_id_to_segment_id(forward_data.edge_id),
+                                    edge_id_to_segment_id(reverse_data.edge_id),
+                                    current_edge_source_coordinate_id,
+                                    current_edge_target_coordinate_id,
+                                    i);
+
+        block.startpoints.push_back(forward_data.startpoint || reverse_data.startpoint);
         current_edge_source_coordinate_id = current_edge_target_coordinate_id;
     }
 
     BOOST_ASSERT(current_edge_source_coordinate_id == node_v);
 
-    return NBGToEBG{node_u, node_v, forward_data.edge_id, reverse_data.edge_id};
+    block.edges.emplace_back(edge_id_1, edge_id_2);
+    block.mapping.push_back(
+        NBGToEBG{node_u, node_v, forward_data.edge_id, reverse_data.edge_id});
+}
+
+void EdgeBasedGraphFactory::ZipEdgeBasedNode(const EdgeID edge_id_1, const EdgeID edge_id_2)
+{
+    const EdgeData &forward_data = m_node_based_graph->GetEdgeData(edge_id_1);
+    const EdgeData &reverse_data = m_node_based_graph->GetEdgeData(edge_id_2);
+
+    const unsigned packed_geometry_id = m_compressed_edge_container.ZipEdges(edge_id_1, edge_id_2);
+
+    // Add edge-based node data for forward and reverse nodes indexed by edge_id
+    BOOST_ASSERT(forward_data.edge_id != SPECIAL_EDGEID);
+    m_edge_based_node_container.SetData(forward_data.edge_id,
+                                        GeometryID{packed_geometry_id, true},
+                                        forward_data.name_id,
+                                        forward_data.travel_mode,
+                                        forward_data.classes);
+    if (reverse_data.edge_id != SPECIAL_EDGEID)
+    {
+        m_edge_based_node_container.SetData(reverse_data.edge_id,
+                                            GeometryID{packed_geometry_id, false},
+                                            reverse_data.name_id,
+                                            reverse_data.travel_mode,
+                                            reverse_data.classes);
+    }
 }
 
 void EdgeBasedGraphFactory::Run(ScriptingEnvironment &scripting_environment,
+                                const std::string &edge_based_graph_filename,
                                 const std::string &turn_data_filename,
                                 const std::string &turn_lane_data_filename,
                                 const std::string &turn_weight_penalties_filename,
@@ -207,6 +215,7 @@ void EdgeBasedGraphFactory::Run(ScriptingEnvironment &scripting_environment,
 
     TIMER_START(generate_edges);
     GenerateEdgeExpandedEdges(scripting_environment,
+                              edge_based_graph_filename,
                               turn_data_filename,
                               turn_lane_data_filename,
                               turn_weight_penalties_filename,
@@ -222,86 +231,154 @@ void EdgeBasedGraphFactory::Run(ScriptingEnvironment &scripting_environment,
 }
 
 /// Renumbers all _forward_ edges and sets the edge_id.
-/// A specific numbering is not important. Any unique ID will do.
+/// The forward edges are numbered in the order of the node-based graph: blocks of edges are
+/// counted in parallel, the prefix sum of the counts is the first id of every block.
 /// Returns the number of edge based nodes.
 unsigned EdgeBasedGraphFactory::RenumberEdges()
 {
-    // heuristic: node-based graph node is a simple intersection with four edges (edge-based nodes)
-    m_edge_based_node_weights.reserve(4 * m_node_based_graph->GetNumberOfNodes());
-
-    // renumber edge based node of outgoing edges
-    unsigned numbered_edges_count = 0;
-    for (const auto current_node : util::irange(0u, m_node_based_graph->GetNumberOfNodes()))
-    {
-        for (const auto current_edge : m_node_based_graph->GetAdjacentEdgeRange(current_node))
-        {
-            EdgeData &edge_data = m_node_based_graph->GetEdgeData(current_edge);
-
-            // only number incoming edges
-            if (edge_data.reversed)
-            {
-                continue;
-            }
+    const EdgeID number_of_edges = m_node_based_graph->GetNumberOfEdges();
+    const std::size_t number_of_blocks =
+        (number_of_edges + RENUMBER_BLOCK_SIZE - 1) / RENUMBER_BLOCK_SIZE;
+    const auto blockRange = [number_of_edges](const std::size_t block) {
+        return util::irange<EdgeID>(
+            block * RENUMBER_BLOCK_SIZE,
+            std::min<EdgeID>((block + 1) * RENUMBER_BLOCK_SIZE, number_of_edges));
+    };
 
-            m_edge_based_node_weights.push_back(edge_data.weight);
+    // only number incoming edges
+    std::vector<EdgeID> block_offsets(number_of_blocks + 1, 0);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_blocks),
+                      [&](const tbb::blocked_range<std::size_t> &blocks) {
+                          for (const auto block : util::irange(blocks.begin(), blocks.end()))
+                          {
+                              for (const auto edge : blockRange(block))
+                              {
+                                  if (!m_node_based_graph->GetEdgeData(edge).reversed)
+                                      ++block_offsets[block + 1];
+                              }
+                          }
+                      });
+    std::partial_sum(block_offsets.begin(), block_offsets.end(), block_offsets.begin());
 
-            BOOST_ASSERT(numbered_edges_count < m_node_based_graph->GetNumberOfEdges());
-            edge_data.edge_id = numbered_edges_count;
-            ++numbered_edges_count;
+    const auto numbered_edges_count = block_offsets.back();
+    m_edge_based_node_weights.resize(numbered_edges_count);
 
-            BOOST_ASSERT(SPECIAL_NODEID != edge_data.edge_id);
-        }
-    }
+    // renumber edge based node of outgoing edges
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_blocks),
+                      [&](const tbb::blocked_range<std::size_t> &blocks) {
+                          for (const auto block : util::irange(blocks.begin(), blocks.end()))
+                          {
+                              auto edge_id = block_offsets[block];
+                              for (const auto edge : blockRange(block))
+                              {
+                                  EdgeData &edge_data = m_node_based_graph->GetEdgeData(edge);
+                                  if (edge_data.reversed)
+                                      continue;
+
+                                  m_edge_based_node_weights[edge_id] = edge_data.weight;
+                                  edge_data.edge_id = edge_id++;
+                                  BOOST_ASSERT(SPECIAL_NODEID != edge_data.edge_id);
+                              }
+                              BOOST_ASSERT(edge_id == block_offsets[block + 1]);
+                          }
+                      });
 
     return numbered_edges_count;
 }
 
 /// Creates the nodes in the edge expanded graph from edges in the node-based graph.
+/// Blocks of node-based nodes generate their segments in parallel into buffers that are
+/// concatenated in the order of the blocks. The geometries are zipped in the same order
+/// afterwards, so the output does not depend on the number of threads.
 std::vector<NBGToEBG> EdgeBasedGraphFactory::GenerateEdgeExpandedNodes()
 {
-    std::vector<NBGToEBG> mapping;
-
     // Allocate memory for edge-based nodes
     m_edge_based_node_container = EdgeBasedNodeDataContainer(m_max_edge_id + 1);
 
     util::Log() << "Generating edge expanded nodes ... ";
-    {
-        util::UnbufferedLog log;
-        util::Percent progress(log, m_node_based_graph->GetNumberOfNodes());
 
-        m_compressed_edge_container.InitializeBothwayVector();
+    m_compressed_edge_container.InitializeBothwayVector();
 
-        // loop over all edges and generate new set of nodes
-        for (const auto nbg_node_u : util::irange(0u, m_node_based_graph->GetNumberOfNodes()))
-        {
-            BOOST_ASSERT(nbg_node_u != SPECIAL_NODEID);
-            progress.PrintStatus(nbg_node_u);
-            for (EdgeID nbg_edge_id : m_node_based_graph->GetAdjacentEdgeRange(nbg_node_u))
+    const NodeID number_of_nodes = m_node_based_graph->GetNumberOfNodes();
+    const std::size_t number_of_blocks =
+        (number_of_nodes + GENERATE_NODES_BLOCK_SIZE - 1) / GENERATE_NODES_BLOCK_SIZE;
+    std::vector<EdgeBasedNodeBlock> blocks(number_of_blocks);
+
+    // loop over all edges and generate new set of nodes
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, number_of_blocks),
+        [&](const tbb::blocked_range<std::size_t> &block_range) {
+            for (const auto block : util::irange(block_range.begin(), block_range.end()))
             {
-                BOOST_ASSERT(nbg_edge_id != SPECIAL_EDGEID);
+                const auto first_node = static_cast<NodeID>(block * GENERATE_NODES_BLOCK_SIZE);
+                const auto last_node = std::min<NodeID>(
+                    (block + 1) * GENERATE_NODES_BLOCK_SIZE, number_of_nodes);
+                for (const auto nbg_node_u : util::irange(first_node, last_node))
+                {
+                    BOOST_ASSERT(nbg_node_u != SPECIAL_NODEID);
+                    for (EdgeID nbg_edge_id :
+                         m_node_based_graph->GetAdjacentEdgeRange(nbg_node_u))
+                    {
+                        BOOST_ASSERT(nbg_edge_id != SPECIAL_EDGEID);
 
-                const EdgeData &nbg_edge_data = m_node_based_graph->GetEdgeData(nbg_edge_id);
-                const NodeID nbg_node_v = m_node_based_graph->GetTarget(nbg_edge_id);
-                BOOST_ASSERT(nbg_node_v != SPECIAL_NODEID);
-                BOOST_ASSERT(nbg_node_u != nbg_node_v);
+                        const EdgeData &nbg_edge_data =
+                            m_node_based_graph->GetEdgeData(nbg_edge_id);
+                        const NodeID nbg_node_v = m_node_based_graph->GetTarget(nbg_edge_id);
+                        BOOST_ASSERT(nbg_node_v != SPECIAL_NODEID);
+                        BOOST_ASSERT(nbg_node_u != nbg_node_v);
 
-                // pick only every other edge, since we have every edge as an outgoing
-                // and incoming egde
-                if (nbg_node_u >= nbg_node_v)
-                {
-                    continue;
-                }
+                        // pick only every other edge, since we have every edge as an outgoing
+                        // and incoming egde
+                        if (nbg_node_u >= nbg_node_v)
+                        {
+                            continue;
+                        }
 
-                // if we found a non-forward edge reverse and try again
-                if (nbg_edge_data.edge_id == SPECIAL_NODEID)
-                {
-                    mapping.push_back(InsertEdgeBasedNode(nbg_node_v, nbg_node_u));
-                }
-                else
-                {
-                    mapping.push_back(InsertEdgeBasedNode(nbg_node_u, nbg_node_v));
+                        // if we found a non-forward edge reverse and try again
+                        if (nbg_edge_data.edge_id == SPECIAL_NODEID)
+                        {
+                            InsertEdgeBasedNode(nbg_node_v, nbg_node_u, blocks[block]);
+                        }
+                        else
+                        {
+                            InsertEdgeBasedNode(nbg_node_u, nbg_node_v, blocks[block]);
+                        }
+                    }
                 }
             }
+        });
+
+    std::size_t number_of_mappings = 0;
+    std::size_t number_of_segments = 0;
+    for (const auto &block : blocks)
+    {
+        number_of_mappings += block.mapping.size();
+        number_of_segments += block.segments.size();
+    }
+
+    std::vector<NBGToEBG> mapping;
+    mapping.reserve(number_of_mappings);
+    m_edge_based_node_segments.reserve(number_of_segments);
+    m_edge_based_node_is_startpoint.reserve(number_of_segments);
+    {
+        util::UnbufferedLog log;
+        util::Percent progress(log, number_of_blocks);
+        for (const auto block : util::irange<std::size_t>(0, number_of_blocks))
+        {
+            progress.PrintStatus(block);
+            auto &node_block = blocks[block];
+            for (const auto &edges : node_block.edges)
+            {
+                ZipEdgeBasedNode(edges.first, edges.second);
+            }
+            mapping.insert(mapping.end(), node_block.mapping.begin(), node_block.mapping.end());
+            m_edge_based_node_segments.insert(m_edge_based_node_segments.end(),
+                                              node_block.segments.begin(),
+                                              node_block.segments.end());
+            m_edge_based_node_is_startpoint.insert(m_edge_based_node_is_startpoint.end(),
+                                                   node_block.startpoints.begin(),
+                                                   node_block.startpoints.end());
+            node_block = EdgeBasedNodeBlock{};
         }
     }
 
@@ -317,6 +394,7 @@ std::vector<NBGToEBG> EdgeBasedGraphFactory::GenerateEdgeExpandedNodes()
 /// Actually it also generates turn data and serializes them...
 void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     ScriptingEnvironment &scripting_environment,
+    const std::string &edge_based_graph_filename,
     const std::string &turn_data_filename,
     const std::string &turn_lane_data_filename,
     const std::string &turn_weight_penalties_filename,
@@ -334,6 +412,23 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     storage::io::FileWriter turn_penalties_index_file(turn_penalties_index_filename,
                                                       storage::io::FileWriter::HasNoFingerprint);
 
+    // The edges and the penalties per turn are streamed to their files by the output stage of the
+    // pipeline below instead of being collected in memory first. The files have the layout of
+    // files::writeEdgeBasedGraph and storage::serialization::write, their element counts are
+    // only known at the end and are patched in once all turns are written.
+    storage::io::FileWriter edge_based_graph_file(edge_based_graph_filename,
+                                                  storage::io::FileWriter::GenerateFingerprint);
+    edge_based_graph_file.WriteElementCount64(m_max_edge_id);
+    edge_based_graph_file.WriteElementCount64(0);
+
+    storage::io::FileWriter turn_weight_penalties_file(
+        turn_weight_penalties_filename, storage::io::FileWriter::GenerateFingerprint);
+    turn_weight_penalties_file.WriteElementCount64(0);
+
+    storage::io::FileWriter turn_duration_penalties_file(
+        turn_duration_penalties_filename, storage::io::FileWriter::GenerateFingerprint);
+    turn_duration_penalties_file.WriteElementCount64(0);
+
     TurnDataExternalContainer turn_data_container;
 
     // Loop over all turns and generate new set of edges.
@@ -353,12 +448,11 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     guidance::lanes::TurnLaneHandler turn_lane_handler(
         *m_node_based_graph, lane_description_map, turn_analysis, lane_data_map);
 
-    bearing_class_by_node_based_node.resize(m_node_based_graph->GetNumberOfNodes(),
-                                            std::numeric_limits<std::uint32_t>::max());
-
-    // FIXME these need to be tuned in pre-allocated size
-    std::vector<TurnPenalty> turn_weight_penalties;
-    std::vector<TurnPenalty> turn_duration_penalties;
+    if (!profile_properties.routing_only)
+    {
+        bearing_class_by_node_based_node.resize(m_node_based_graph->GetNumberOfNodes(),
+                                                std::numeric_limits<std::uint32_t>::max());
+    }
 
     const auto weight_multiplier =
         scripting_environment.GetProfileProperties().GetWeightMultiplier();
@@ -367,10 +461,11 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     // pipeline.  Sets of intersection IDs are batched in groups of GRAINSIZE (100)
     // `generator_stage`,
     // then those groups are processed in parallel `processor_stage`.  Finally, results are
-    // appended to the various buffer vectors by the `output_stage` in the same order
+    // written to the output files by the `output_stage` in the same order
     // that the `generator_stage` created them in (tbb::filter::serial_in_order creates this
     // guarantee).  The order needs to be maintained because we depend on it later in the
-    // processing pipeline.
+    // processing pipeline. Only as many buffers as the pipeline has tokens are in flight, so
+    // the memory used does not grow with the number of turns.
     {
         util::UnbufferedLog log;
 
@@ -432,6 +527,10 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                 if (buffer->nodes_processed == 0)
                     return buffer;
 
+                // The penalties of all turns of the range are computed by the profile with a
+                // single call once the range is done, the edges get their base weights first
+                std::vector<ExtractionTurn> extracted_turns;
+
                 for (auto node_at_center_of_intersection = intersection_node_range.begin(),
                           end = intersection_node_range.end();
                      node_at_center_of_intersection < end;
@@ -493,25 +592,32 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                         OSRM_ASSERT(intersection.valid(),
                                     m_coordinates[node_at_center_of_intersection]);
 
-                        intersection = turn_lane_handler.assignTurnLanes(
-                            node_along_road_entering, incoming_edge, std::move(intersection));
+                        // Routing-only datasets keep the turn types, the turn penalties
+                        // depend on them, but skip the lanes and intersection classes that only
+                        // the turn-by-turn instructions use.
+                        EntryClassID entry_class_id = INVALID_ENTRY_CLASSID;
+                        if (!profile_properties.routing_only)
+                        {
+                            intersection = turn_lane_handler.assignTurnLanes(
+                                node_along_road_entering, incoming_edge, std::move(intersection));
 
-                        // the entry class depends on the turn, so we have to classify the
-                        // interesction for
-                        // every edge
-                        const auto turn_classification = classifyIntersection(intersection);
+                            // the entry class depends on the turn, so we have to classify the
+                            // interesction for
+                            // every edge
+                            const auto turn_classification = classifyIntersection(intersection);
 
-                        const auto entry_class_id =
-                            entry_class_hash.ConcurrentFindOrAdd(turn_classification.first);
+                            entry_class_id =
+                                entry_class_hash.ConcurrentFindOrAdd(turn_classification.first);
 
-                        const auto bearing_class_id =
-                            bearing_class_hash.ConcurrentFindOrAdd(turn_classification.second);
+                            const auto bearing_class_id =
+                                bearing_class_hash.ConcurrentFindOrAdd(turn_classification.second);
 
-                        // Note - this is strictly speaking not thread safe, but we know we
-                        // should never be touching the same element twice, so we should
-                        // be fine.
-                        bearing_class_by_node_based_node[node_at_center_of_intersection] =
-                            bearing_class_id;
+                            // Note - this is strictly speaking not thread safe, but we know we
+                            // should never be touching the same element twice, so we should
+                            // be fine.
+                            bearing_class_by_node_based_node[node_at_center_of_intersection] =
+                                bearing_class_id;
+                        }
 
                         for (const auto &turn : intersection)
                         {
@@ -529,52 +635,35 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                             BOOST_ASSERT(!edge_data2.reversed);
 
                             // the following is the core of the loop.
-                            buffer->turn_data_container.push_back(
-                                {turn.instruction,
-                                 turn.lane_data_id,
-                                 entry_class_id,
-                                 util::guidance::TurnBearing(intersection[0].bearing),
-                                 util::guidance::TurnBearing(turn.bearing)});
-
-                            // compute weight and duration penalties
+                            if (!profile_properties.routing_only)
+                            {
+                                buffer->turn_data_container.push_back(
+                                    {turn.instruction,
+                                     turn.lane_data_id,
+                                     entry_class_id,
+                                     util::guidance::TurnBearing(intersection[0].bearing),
+                                     util::guidance::TurnBearing(turn.bearing)});
+                            }
+
+                            // weight and duration penalties are computed for the whole range
                             auto is_traffic_light =
                                 m_traffic_lights.count(node_at_center_of_intersection);
-                            ExtractionTurn extracted_turn(turn, is_traffic_light);
-                            extracted_turn.source_restricted = edge_data1.restricted;
-                            extracted_turn.target_restricted = edge_data2.restricted;
-                            scripting_environment.ProcessTurn(extracted_turn);
-
-                            // turn penalties are limited to [-2^15, 2^15) which roughly
-                            // translates to 54 minutes and fits signed 16bit deci-seconds
-                            auto weight_penalty = boost::numeric_cast<TurnPenalty>(
-                                extracted_turn.weight * weight_multiplier);
-                            auto duration_penalty =
-                                boost::numeric_cast<TurnPenalty>(extracted_turn.duration * 10.);
+                            extracted_turns.emplace_back(turn, is_traffic_light);
+                            extracted_turns.back().source_restricted = edge_data1.restricted;
+                            extracted_turns.back().target_restricted = edge_data2.restricted;
 
                             BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
                             BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
 
-                            // auto turn_id = m_edge_based_edge_list.size();
-                            auto weight =
-                                boost::numeric_cast<EdgeWeight>(edge_data1.weight + weight_penalty);
-                            auto duration = boost::numeric_cast<EdgeWeight>(edge_data1.duration +
-                                                                            duration_penalty);
                             buffer->edges_list.emplace_back(
                                 edge_data1.edge_id,
                                 edge_data2.edge_id,
-                                SPECIAL_NODEID, // This will be updated once the main loop
-                                                // completes!
-                                weight,
-                                duration,
+                                SPECIAL_NODEID, // This will be updated by the output stage
+                                edge_data1.weight,
+                                edge_data1.duration,
                                 true,
                                 false);
-
-                            BOOST_ASSERT(buffer->turn_weight_penalties.size() ==
-                                         buffer->edges_list.size() - 1);
-                            buffer->turn_weight_penalties.push_back(weight_penalty);
-                            BOOST_ASSERT(buffer->turn_duration_penalties.size() ==
-                                         buffer->edges_list.size() - 1);
-                            buffer->turn_duration_penalties.push_back(duration_penalty);
+                            BOOST_ASSERT(extracted_turns.size() == buffer->edges_list.size());
 
                             // We write out the mapping between the edge-expanded edges and the
                             // original nodes. Since each edge represents a possible maneuver,
@@ -603,6 +692,31 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                     }
                 }
 
+                scripting_environment.ProcessTurns(extracted_turns);
+
+                buffer->turn_weight_penalties.reserve(extracted_turns.size());
+                buffer->turn_duration_penalties.reserve(extracted_turns.size());
+                for (const auto index : util::irange<std::size_t>(0, extracted_turns.size()))
+                {
+                    const auto &extracted_turn = extracted_turns[index];
+                    auto &edge_data = buffer->edges_list[index].data;
+
+                    // turn penalties are limited to [-2^15, 2^15) which roughly
+                    // translates to 54 minutes and fits signed 16bit deci-seconds
+                    auto weight_penalty = boost::numeric_cast<TurnPenalty>(
+                        extracted_turn.weight * weight_multiplier);
+                    auto duration_penalty =
+                        boost::numeric_cast<TurnPenalty>(extracted_turn.duration * 10.);
+
+                    edge_data.weight =
+                        boost::numeric_cast<EdgeWeight>(edge_data.weight + weight_penalty);
+                    edge_data.duration =
+                        boost::numeric_cast<EdgeWeight>(edge_data.duration + duration_penalty);
+
+                    buffer->turn_weight_penalties.push_back(weight_penalty);
+                    buffer->turn_duration_penalties.push_back(duration_penalty);
+                }
+
                 return buffer;
             });
 
@@ -622,16 +736,17 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                 nodes_completed += buffer->nodes_processed;
                 progress.PrintStatus(nodes_completed);
 
+                // The turn_id of every EdgeBasedEdge equals its position in the .ebg file
                 // NOTE: potential overflow here if we hit 2^32 routable edges
-                m_edge_based_edge_list.append(buffer->edges_list.begin(), buffer->edges_list.end());
-                BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
-
-                turn_weight_penalties.insert(turn_weight_penalties.end(),
-                                             buffer->turn_weight_penalties.begin(),
-                                             buffer->turn_weight_penalties.end());
-                turn_duration_penalties.insert(turn_duration_penalties.end(),
-                                               buffer->turn_duration_penalties.begin(),
-                                               buffer->turn_duration_penalties.end());
+                for (auto &edge : buffer->edges_list)
+                {
+                    edge.data.turn_id = m_number_of_edge_based_edges++;
+                }
+                BOOST_ASSERT(m_number_of_edge_based_edges <= std::numeric_limits<NodeID>::max());
+
+                edge_based_graph_file.WriteFrom(buffer->edges_list);
+                turn_weight_penalties_file.WriteFrom(buffer->turn_weight_penalties);
+                turn_duration_penalties_file.WriteFrom(buffer->turn_duration_penalties);
                 turn_data_container.append(buffer->turn_data_container);
 
                 turn_indexes_write_buffer.insert(turn_indexes_write_buffer.end(),
@@ -664,45 +779,34 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
         }
     }
 
-    util::Log() << "Reunmbering turns";
-    // Now, update the turn_id property on every EdgeBasedEdge - it will equal the
-    // position in the m_edge_based_edge_list array for each object.
-    tbb::parallel_for(tbb::blocked_range<NodeID>(0, m_edge_based_edge_list.size()),
-                      [this](const tbb::blocked_range<NodeID> &range) {
-                          for (auto x = range.begin(), end = range.end(); x != end; ++x)
-                          {
-                              m_edge_based_edge_list[x].data.turn_id = x;
-                          }
-                      });
+    // Patch in the number of edges and penalties behind the fingerprint and the max edge id
+    edge_based_graph_file.SkipToBeginning();
+    edge_based_graph_file.Skip<std::uint64_t>(1);
+    edge_based_graph_file.WriteElementCount64(m_number_of_edge_based_edges);
 
-    // write weight penalties per turn
-    BOOST_ASSERT(turn_weight_penalties.size() == turn_duration_penalties.size());
-    {
-        storage::io::FileWriter writer(turn_weight_penalties_filename,
-                                       storage::io::FileWriter::GenerateFingerprint);
-        storage::serialization::write(writer, turn_weight_penalties);
-    }
+    turn_weight_penalties_file.SkipToBeginning();
+    turn_weight_penalties_file.WriteElementCount64(m_number_of_edge_based_edges);
 
-    {
-        storage::io::FileWriter writer(turn_duration_penalties_filename,
-                                       storage::io::FileWriter::GenerateFingerprint);
-        storage::serialization::write(writer, turn_duration_penalties);
-    }
+    turn_duration_penalties_file.SkipToBeginning();
+    turn_duration_penalties_file.WriteElementCount64(m_number_of_edge_based_edges);
 
-    util::Log() << "Created " << entry_class_hash.data.size() << " entry classes and "
-                << bearing_class_hash.data.size() << " Bearing Classes";
+    const auto shape_cache_statistics =
+        turn_analysis.GetIntersectionGenerator().GetShapeCacheStatistics();
+    const auto shape_lookups = shape_cache_statistics.first + shape_cache_statistics.second;
+    util::Log() << "Intersection shape cache: " << shape_cache_statistics.first << " hits of "
+                << shape_lookups << " lookups ("
+                << (shape_lookups == 0 ? 0. : 100. * shape_cache_statistics.first / shape_lookups)
+                << "%)";
+
+    util::Log() << "Created " << entry_class_hash.Size() << " entry classes and "
+                << bearing_class_hash.Size() << " Bearing Classes";
 
     util::Log() << "Writing Turn Lane Data to File...";
     {
         storage::io::FileWriter writer(turn_lane_data_filename,
                                        storage::io::FileWriter::GenerateFingerprint);
 
-        std::vector<util::guidance::LaneTupleIdPair> lane_data(lane_data_map.data.size());
-        // extract lane data sorted by ID
-        for (auto itr : lane_data_map.data)
-            lane_data[itr.second] = itr.first;
-
-        storage::serialization::write(writer, lane_data);
+        storage::serialization::write(writer, lane_data_map.GetKeysByID());
     }
     util::Log() << "done.";
 
@@ -711,7 +815,7 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     util::Log() << "Generated " << m_edge_based_node_segments.size() << " edge based node segments";
     util::Log() << "Node-based graph contains " << node_based_edge_counter << " edges";
     util::Log() << "Edge-expanded graph ...";
-    util::Log() << "  contains " << m_edge_based_edge_list.size() << " edges";
+    util::Log() << "  contains " << m_number_of_edge_based_edges << " edges";
     util::Log() << "  skips " << restricted_turns_counter << " turns, "
                                                              "defined by "
                 << m_restriction_map->size() << " restrictions";
@@ -721,13 +825,7 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
 
 std::vector<util::guidance::BearingClass> EdgeBasedGraphFactory::GetBearingClasses() const
 {
-    std::vector<util::guidance::BearingClass> result(bearing_class_hash.data.size());
-    for (const auto &pair : bearing_class_hash.data)
-    {
-        BOOST_ASSERT(pair.second < result.size());
-        result[pair.second] = pair.first;
-    }
-    return result;
+    return bearing_class_hash.GetKeysByID();
 }
 
 const std::vector<BearingClassID> &EdgeBasedGraphFactory::GetBearingClassIds() const
@@ -742,13 +840,7 @@ std::vector<BearingClassID> &EdgeBasedGraphFactory::GetBearingClassIds()
 
 std::vector<util::guidance::EntryClass> EdgeBasedGraphFactory::GetEntryClasses() const
 {
-    std::vector<util::guidance::EntryClass> result(entry_class_hash.data.size());
-    for (const auto &pair : entry_class_hash.data)
-    {
-        BOOST_ASSERT(pair.second < result.size());
-        result[pair.second] = pair.first;
-    }
-    return result;
+    return entry_class_hash.GetKeysByID();
 }
 
 } // namespace extractor
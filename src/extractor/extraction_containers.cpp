@@ -1,6 +1,7 @@
 #include "extractor/extraction_containers.hpp"
 #include "extractor/extraction_segment.hpp"
 #include "extractor/extraction_way.hpp"
+#include "extractor/files.hpp"
 #include "extractor/restriction.hpp"
 #include "extractor/serialization.hpp"
 
@@ -9,8 +10,12 @@
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
+#include "util/hilbert_value.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/meminfo.hpp"
 #include "util/name_table.hpp"
+#include "util/radix_sort.hpp"
 #include "util/timing_util.hpp"
 
 #include "storage/io.hpp"
@@ -21,12 +26,23 @@
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/ref.hpp>
 
+#include <osmium/index/map/dense_mem_array.hpp>
+#include <osmium/index/map/dense_mmap_array.hpp>
+#include <osmium/index/map/sparse_mem_array.hpp>
+#include <osmium/index/map/sparse_mmap_array.hpp>
+
 #include <stxxl/sort>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <limits>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 namespace
 {
@@ -42,6 +58,17 @@ struct OSMNodeIDSTXXLLess
     value_type min_value() { return MIN_OSM_NODEID; }
 };
 
+struct WayNodesStxxlCompare
+{
+    using value_type = oe::WayNodes;
+    bool operator()(const value_type &lhs, const value_type &rhs) const
+    {
+        return lhs.way_id < rhs.way_id;
+    }
+    value_type max_value() { return value_type{MAX_OSM_WAYID, 0, 0}; }
+    value_type min_value() { return value_type{MIN_OSM_WAYID, 0, 0}; }
+};
+
 struct CmpEdgeByOSMStartID
 {
     using value_type = oe::InternalExtractorEdge;
@@ -108,6 +135,185 @@ struct CmpEdgeByInternalSourceTargetAndName
     const oe::ExtractionContainers::STXXLNameCharData &name_data;
     const oe::ExtractionContainers::STXXLNameOffsets &name_offsets;
 };
+
+// The vector is sorted in memory if a copy of it and the buffer of the radix sort fit into the
+// available memory next to the blocks cached by stxxl
+template <typename T> bool fitsIntoMemory(const stxxl::vector<T> &vector)
+{
+    return 3 * vector.size() * sizeof(T) <= osrm::util::GetAvailableMemory();
+}
+
+template <typename T, typename KeyT>
+std::vector<T> radixSortedCopy(const stxxl::vector<T> &vector, const KeyT &key)
+{
+    std::vector<T> values(vector.begin(), vector.end());
+    osrm::util::parallelRadixSort(values, key);
+    return values;
+}
+
+// Sorts by the integer key in memory if possible and with stxxl and `compare` otherwise, both
+// order the values by the key only
+template <typename T, typename KeyT, typename CompareT>
+bool sortByKey(stxxl::vector<T> &vector, const KeyT &key, CompareT compare, unsigned stxxl_memory)
+{
+    if (!fitsIntoMemory(vector))
+    {
+        stxxl::sort(vector.begin(), vector.end(), compare, stxxl_memory);
+        return false;
+    }
+
+    const auto values = radixSortedCopy(vector, key);
+    std::copy(values.begin(), values.end(), vector.begin());
+    return true;
+}
+
+// Same as sortByKey, but values with the same key are ordered by `compare` in memory as well
+template <typename T, typename KeyT, typename CompareT>
+bool sortByKeyAndCompare(stxxl::vector<T> &vector,
+                         const KeyT &key,
+                         CompareT compare,
+                         unsigned stxxl_memory)
+{
+    if (!fitsIntoMemory(vector))
+    {
+        stxxl::sort(vector.begin(), vector.end(), compare, stxxl_memory);
+        return false;
+    }
+
+    auto values = radixSortedCopy(vector, key);
+    for (auto begin = values.begin(); begin != values.end();)
+    {
+        const auto begin_key = key(*begin);
+        const auto end = std::find_if(
+            begin, values.end(), [&](const T &value) { return key(value) != begin_key; });
+        if (std::distance(begin, end) > 1)
+            std::sort(begin, end, compare);
+        begin = end;
+    }
+    std::copy(values.begin(), values.end(), vector.begin());
+    return true;
+}
+
+const auto osm_node_id_key = [](const OSMNodeID id) { return static_cast<std::uint64_t>(id); };
+
+// Anonymous memory maps if available, so unused parts of the dense array are never touched
+std::unique_ptr<oe::ExtractionContainers::NodeLocationIndex>
+makeNodeLocationIndex(const oe::ExtractorConfig::NodeLocations locations)
+{
+    using Id = osmium::unsigned_object_id_type;
+    switch (locations)
+    {
+    case oe::ExtractorConfig::NodeLocations::Dense:
+#ifdef OSMIUM_HAS_INDEX_MAP_DENSE_MMAP_ARRAY
+        return std::make_unique<osmium::index::map::DenseMmapArray<Id, osmium::Location>>();
+#else
+        return std::make_unique<osmium::index::map::DenseMemArray<Id, osmium::Location>>();
+#endif
+    case oe::ExtractorConfig::NodeLocations::Sparse:
+#ifdef OSMIUM_HAS_INDEX_MAP_SPARSE_MMAP_ARRAY
+        return std::make_unique<osmium::index::map::SparseMmapArray<Id, osmium::Location>>();
+#else
+        return std::make_unique<osmium::index::map::SparseMemArray<Id, osmium::Location>>();
+#endif
+    case oe::ExtractorConfig::NodeLocations::Sorted:
+        break;
+    }
+    return nullptr;
+}
+
+// Computes the weights and durations of edges from the coordinates of their sources to the
+// coordinates of their targets with the profile and sets their internal target ids. The segment
+// function of the profile runs in parallel on batches of edges, each thread with its own Lua
+// context, and the results are written back to the edges in order. Edges are oriented from the
+// smaller to the larger internal node id, which is important for the multi-edge removal.
+class EdgeTargetBatch
+{
+  public:
+    static const constexpr std::size_t BATCH_SIZE = 64 * 1024;
+
+    explicit EdgeTargetBatch(oe::ScriptingEnvironment &scripting_environment)
+        : scripting_environment(scripting_environment),
+          weight_multiplier(scripting_environment.GetProfileProperties().GetWeightMultiplier())
+    {
+        pending.reserve(BATCH_SIZE);
+    }
+
+    // Queues the segment of the edge at the index, the batch is processed once it is full
+    template <typename EdgeVectorT>
+    void Add(EdgeVectorT &edges,
+             const std::size_t index,
+             oe::InternalExtractorEdge &internal_edge,
+             const osrm::util::Coordinate target_coordinate,
+             const NodeID target)
+    {
+        BOOST_ASSERT(internal_edge.source_coordinate.lat !=
+                     osrm::util::FixedLatitude{std::numeric_limits<std::int32_t>::min()});
+        BOOST_ASSERT(internal_edge.source_coordinate.lon !=
+                     osrm::util::FixedLongitude{std::numeric_limits<std::int32_t>::min()});
+
+        osrm::util::Coordinate source_coord(internal_edge.source_coordinate);
+        osrm::util::Coordinate target_coord(target_coordinate);
+
+        // flip source and target coordinates if segment is in backward direction only
+        if (!internal_edge.result.forward && internal_edge.result.backward)
+            std::swap(source_coord, target_coord);
+
+        const auto distance =
+            osrm::util::coordinate_calculation::greatCircleDistance(source_coord, target_coord);
+        const auto weight = internal_edge.weight_data(distance);
+        const auto duration = internal_edge.duration_data(distance);
+
+        pending.push_back(PendingEdge{
+            index,
+            target,
+            oe::ExtractionSegment(source_coord, target_coord, distance, weight, duration)});
+        if (pending.size() == BATCH_SIZE)
+            Flush(edges);
+    }
+
+    // Runs the profile on the queued segments and writes their results into the edges
+    template <typename EdgeVectorT> void Flush(EdgeVectorT &edges)
+    {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, pending.size(), 1024),
+                          [this](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                                  scripting_environment.ProcessSegment(pending[index].segment);
+                          });
+
+        for (const auto &pending_edge : pending)
+        {
+            auto &edge = edges[pending_edge.index].result;
+            edge.weight = std::max<EdgeWeight>(
+                1, std::round(pending_edge.segment.weight * weight_multiplier));
+            edge.duration =
+                std::max<EdgeWeight>(1, std::round(pending_edge.segment.duration * 10.));
+            edge.target = pending_edge.target;
+
+            if (edge.source > edge.target)
+            {
+                std::swap(edge.source, edge.target);
+
+                // std::swap does not work with bit-fields
+                bool temp = edge.forward;
+                edge.forward = edge.backward;
+                edge.backward = temp;
+            }
+        }
+        pending.clear();
+    }
+
+  private:
+    struct PendingEdge
+    {
+        std::size_t index;
+        NodeID target;
+        oe::ExtractionSegment segment;
+    };
+
+    oe::ScriptingEnvironment &scripting_environment;
+    const double weight_multiplier;
+    std::vector<PendingEdge> pending;
+};
 }
 
 namespace osrm
@@ -115,7 +321,12 @@ namespace osrm
 namespace extractor
 {
 
-ExtractionContainers::ExtractionContainers()
+ExtractionContainers::ExtractionContainers(const ExtractorConfig::NodeLocations locations,
+                                           const bool deduplicate_names,
+                                           const bool spatial_node_order,
+                                           const bool way_index)
+    : node_locations(makeNodeLocationIndex(locations)), way_index(way_index),
+      spatial_node_order(spatial_node_order), deduplicate_names(deduplicate_names)
 {
     // Check if stxxl can be instantiated
     stxxl::vector<unsigned> dummy_vector;
@@ -138,6 +349,8 @@ void ExtractionContainers::FlushVectors()
     name_char_data.flush();
     name_offsets.flush();
     way_start_end_id_list.flush();
+    way_nodes_list.flush();
+    way_node_id_list.flush();
 }
 
 /**
@@ -147,6 +360,7 @@ void ExtractionContainers::FlushVectors()
  * - map start-end nodes of ways to ways used in restrictions to compute compressed
  *   trippe representation
  * - filter nodes list to nodes that are referenced by ways
+ * - renumber the nodes along a Hilbert curve if requested
  * - merge edges with nodes to include location of start/end points and serialize
  *
  */
@@ -161,6 +375,10 @@ void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environme
     FlushVectors();
 
     PrepareNodes();
+    if (spatial_node_order)
+    {
+        RenumberNodes();
+    }
     WriteNodes(file_out);
     PrepareEdges(scripting_environment);
     WriteEdges(file_out);
@@ -170,6 +388,30 @@ void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environme
     WriteCharData(name_file_name);
 }
 
+void ExtractionContainers::WriteWayIndex(const std::string &way_index_file_name)
+{
+    util::UnbufferedLog log;
+    log << "writing way index ... ";
+    TIMER_START(write_way_index);
+
+    way_nodes_list.flush();
+    way_node_id_list.flush();
+    stxxl::sort(way_nodes_list.begin(), way_nodes_list.end(), WayNodesStxxlCompare(), stxxl_memory);
+
+    std::vector<WayNodes> ways(way_nodes_list.begin(), way_nodes_list.end());
+    PackedOSMIDs nodes;
+    nodes.reserve(way_node_id_list.size());
+    for (const auto node : way_node_id_list)
+    {
+        nodes.push_back(node);
+    }
+    const auto number_of_ways = ways.size();
+    files::writeWayIndex(way_index_file_name, WayIndex{std::move(ways), std::move(nodes)});
+
+    TIMER_STOP(write_way_index);
+    log << "ok, after " << TIMER_SEC(write_way_index) << "s, " << number_of_ways << " ways";
+}
+
 void ExtractionContainers::WriteCharData(const std::string &file_name)
 {
     util::UnbufferedLog log;
@@ -178,10 +420,23 @@ void ExtractionContainers::WriteCharData(const std::string &file_name)
     storage::io::FileWriter file(file_name, storage::io::FileWriter::GenerateFingerprint);
 
     const util::NameTable::IndexedData indexed_data;
-    indexed_data.write(file, name_offsets.begin(), name_offsets.end(), name_char_data.begin());
+    if (!deduplicate_names)
+    {
+        indexed_data.write(file, name_offsets.begin(), name_offsets.end(), name_char_data.begin());
+
+        TIMER_STOP(write_index);
+        log << "ok, after " << TIMER_SEC(write_index) << "s";
+        return;
+    }
+
+    std::vector<std::uint32_t> offsets(name_offsets.begin(), name_offsets.end());
+    std::vector<unsigned char> data(name_char_data.begin(), name_char_data.end());
+    const auto saved = util::NameTable::Deduplicate(offsets, data);
+    indexed_data.write(file, offsets.begin(), offsets.end(), data.begin());
 
     TIMER_STOP(write_index);
-    log << "ok, after " << TIMER_SEC(write_index) << "s";
+    log << "ok, after " << TIMER_SEC(write_index) << "s, " << saved << " of "
+        << name_char_data.size() << " bytes saved by deduplication";
 }
 
 void ExtractionContainers::PrepareNodes()
@@ -190,10 +445,11 @@ void ExtractionContainers::PrepareNodes()
         util::UnbufferedLog log;
         log << "Sorting used nodes        ... " << std::flush;
         TIMER_START(sorting_used_nodes);
-        stxxl::sort(
-            used_node_id_list.begin(), used_node_id_list.end(), OSMNodeIDSTXXLLess(), stxxl_memory);
+        const auto in_memory = sortByKey(
+            used_node_id_list, osm_node_id_key, OSMNodeIDSTXXLLess(), stxxl_memory);
         TIMER_STOP(sorting_used_nodes);
-        log << "ok, after " << TIMER_SEC(sorting_used_nodes) << "s";
+        log << "ok, after " << TIMER_SEC(sorting_used_nodes) << "s"
+            << (in_memory ? " in memory" : "");
     }
 
     {
@@ -206,6 +462,17 @@ void ExtractionContainers::PrepareNodes()
         log << "ok, after " << TIMER_SEC(erasing_dups) << "s";
     }
 
+    if (node_locations)
+    {
+        util::UnbufferedLog log;
+        log << "Sorting node locations    ... " << std::flush;
+        TIMER_START(sorting_node_locations);
+        // only sorts a sparse index
+        node_locations->sort();
+        TIMER_STOP(sorting_node_locations);
+        log << "ok, after " << TIMER_SEC(sorting_node_locations) << "s";
+    }
+    else
     {
         struct QueryNodeSTXXLCompare
         {
@@ -222,10 +489,14 @@ void ExtractionContainers::PrepareNodes()
         util::UnbufferedLog log;
         log << "Sorting all nodes         ... " << std::flush;
         TIMER_START(sorting_nodes);
-        stxxl::sort(
-            all_nodes_list.begin(), all_nodes_list.end(), QueryNodeSTXXLCompare(), stxxl_memory);
+        const auto in_memory =
+            sortByKey(all_nodes_list,
+                      [](const QueryNode &node) { return osm_node_id_key(node.node_id); },
+                      QueryNodeSTXXLCompare(),
+                      stxxl_memory);
         TIMER_STOP(sorting_nodes);
-        log << "ok, after " << TIMER_SEC(sorting_nodes) << "s";
+        log << "ok, after " << TIMER_SEC(sorting_nodes) << "s"
+            << (in_memory ? " in memory" : "");
     }
 
     {
@@ -233,10 +504,6 @@ void ExtractionContainers::PrepareNodes()
         log << "Building node id map      ... " << std::flush;
         TIMER_START(id_map);
         external_to_internal_node_id_map.reserve(used_node_id_list.size());
-        auto node_iter = all_nodes_list.begin();
-        auto ref_iter = used_node_id_list.begin();
-        const auto all_nodes_list_end = all_nodes_list.end();
-        const auto used_node_id_list_end = used_node_id_list.end();
         // Note: despite being able to handle 64 bit OSM node ids, we can't
         // handle > uint32_t actual usable nodes.  This should be OK for a while
         // because we usually route on a *lot* less than 2^32 of the OSM
@@ -244,22 +511,38 @@ void ExtractionContainers::PrepareNodes()
         std::uint64_t internal_id = 0;
 
         // compute the intersection of nodes that were referenced and nodes we actually have
-        while (node_iter != all_nodes_list_end && ref_iter != used_node_id_list_end)
+        if (node_locations)
         {
-            if (node_iter->node_id < *ref_iter)
+            for (const auto node_id : used_node_id_list)
             {
-                node_iter++;
-                continue;
+                if (node_locations->get_noexcept(osm_node_id_key(node_id)).valid())
+                    external_to_internal_node_id_map[node_id] =
+                        static_cast<NodeID>(internal_id++);
             }
-            if (node_iter->node_id > *ref_iter)
+        }
+        else
+        {
+            auto node_iter = all_nodes_list.begin();
+            auto ref_iter = used_node_id_list.begin();
+            const auto all_nodes_list_end = all_nodes_list.end();
+            const auto used_node_id_list_end = used_node_id_list.end();
+            while (node_iter != all_nodes_list_end && ref_iter != used_node_id_list_end)
             {
+                if (node_iter->node_id < *ref_iter)
+                {
+                    node_iter++;
+                    continue;
+                }
+                if (node_iter->node_id > *ref_iter)
+                {
+                    ref_iter++;
+                    continue;
+                }
+                BOOST_ASSERT(node_iter->node_id == *ref_iter);
+                external_to_internal_node_id_map[*ref_iter] = static_cast<NodeID>(internal_id++);
+                node_iter++;
                 ref_iter++;
-                continue;
             }
-            BOOST_ASSERT(node_iter->node_id == *ref_iter);
-            external_to_internal_node_id_map[*ref_iter] = static_cast<NodeID>(internal_id++);
-            node_iter++;
-            ref_iter++;
         }
         if (internal_id > std::numeric_limits<NodeID>::max())
         {
@@ -273,17 +556,101 @@ void ExtractionContainers::PrepareNodes()
     }
 }
 
-void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environment)
+template <typename CallbackT>
+void ExtractionContainers::ForEachUsedNode(const CallbackT &callback) const
+{
+    if (node_locations)
+    {
+        for (const auto node_id : used_node_id_list)
+        {
+            const auto location = node_locations->get_noexcept(osm_node_id_key(node_id));
+            if (location.valid())
+                callback(QueryNode{util::FixedLongitude{location.x()},
+                                   util::FixedLatitude{location.y()},
+                                   node_id});
+        }
+        return;
+    }
+
+    // identify all used nodes by a merging step of two sorted lists
+    auto node_iterator = all_nodes_list.begin();
+    auto node_id_iterator = used_node_id_list.begin();
+    const auto used_node_id_list_end = used_node_id_list.end();
+    const auto all_nodes_list_end = all_nodes_list.end();
+
+    while (node_id_iterator != used_node_id_list_end && node_iterator != all_nodes_list_end)
+    {
+        if (*node_id_iterator < node_iterator->node_id)
+        {
+            ++node_id_iterator;
+            continue;
+        }
+        if (*node_id_iterator > node_iterator->node_id)
+        {
+            ++node_iterator;
+            continue;
+        }
+        BOOST_ASSERT(*node_id_iterator == node_iterator->node_id);
+
+        callback(*node_iterator);
+
+        ++node_id_iterator;
+        ++node_iterator;
+    }
+}
+
+// Sorts the nodes by the Hilbert value of their coordinates and renumbers them in that order.
+// Runs before anything refers to the internal ids, only the id map has to be updated.
+void ExtractionContainers::RenumberNodes()
+{
+    util::UnbufferedLog log;
+    log << "Renumbering nodes spatially ... " << std::flush;
+    TIMER_START(renumber_nodes);
+
+    std::vector<std::pair<std::uint64_t, NodeID>> hilbert_order;
+    hilbert_order.reserve(max_internal_node_id);
+    ForEachUsedNode([&](const QueryNode &node) {
+        const auto old_id = static_cast<NodeID>(hilbert_order.size());
+        hilbert_order.emplace_back(util::GetHilbertCode(util::Coordinate{node.lon, node.lat}),
+                                   old_id);
+    });
+    BOOST_ASSERT(hilbert_order.size() == max_internal_node_id);
+    util::parallelRadixSort(hilbert_order,
+                            [](const std::pair<std::uint64_t, NodeID> &value) {
+                                return value.first;
+                            });
+
+    spatial_node_ids.resize(hilbert_order.size());
+    for (const auto new_id : util::irange<std::size_t>(0, hilbert_order.size()))
+    {
+        spatial_node_ids[hilbert_order[new_id].second] = static_cast<NodeID>(new_id);
+    }
+    for (auto &external_and_internal_id : external_to_internal_node_id_map)
+    {
+        external_and_internal_id.second = spatial_node_ids[external_and_internal_id.second];
+    }
+
+    TIMER_STOP(renumber_nodes);
+    log << "ok, after " << TIMER_SEC(renumber_nodes) << "s";
+}
+
+// Merges the edges sorted by their source and by their target with the nodes sorted by OSM id
+void ExtractionContainers::MergeEdgesWithNodes(ScriptingEnvironment &scripting_environment)
 {
     // Sort edges by start.
     {
         util::UnbufferedLog log;
         log << "Sorting edges by start    ... " << std::flush;
         TIMER_START(sort_edges_by_start);
-        stxxl::sort(
-            all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMStartID(), stxxl_memory);
+        const auto in_memory = sortByKey(all_edges_list,
+                                         [](const InternalExtractorEdge &edge) {
+                                             return osm_node_id_key(edge.result.osm_source_id);
+                                         },
+                                         CmpEdgeByOSMStartID(),
+                                         stxxl_memory);
         TIMER_STOP(sort_edges_by_start);
-        log << "ok, after " << TIMER_SEC(sort_edges_by_start) << "s";
+        log << "ok, after " << TIMER_SEC(sort_edges_by_start) << "s"
+            << (in_memory ? " in memory" : "");
     }
 
     {
@@ -351,10 +718,15 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         util::UnbufferedLog log;
         log << "Sorting edges by target   ... " << std::flush;
         TIMER_START(sort_edges_by_target);
-        stxxl::sort(
-            all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMTargetID(), stxxl_memory);
+        const auto in_memory = sortByKey(all_edges_list,
+                                         [](const InternalExtractorEdge &edge) {
+                                             return osm_node_id_key(edge.result.osm_target_id);
+                                         },
+                                         CmpEdgeByOSMTargetID(),
+                                         stxxl_memory);
         TIMER_STOP(sort_edges_by_target);
-        log << "ok, after " << TIMER_SEC(sort_edges_by_target) << "s";
+        log << "ok, after " << TIMER_SEC(sort_edges_by_target) << "s"
+            << (in_memory ? " in memory" : "");
     }
 
     {
@@ -367,8 +739,7 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         const auto all_edges_list_end_ = all_edges_list.end();
         const auto all_nodes_list_end_ = all_nodes_list.end();
 
-        const auto weight_multiplier =
-            scripting_environment.GetProfileProperties().GetWeightMultiplier();
+        EdgeTargetBatch batch(scripting_environment);
 
         while (edge_iterator != all_edges_list_end_ && node_iterator != all_nodes_list_end_)
         {
@@ -394,48 +765,18 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
             }
 
             BOOST_ASSERT(edge_iterator->result.osm_target_id == node_iterator->node_id);
-            BOOST_ASSERT(edge_iterator->source_coordinate.lat !=
-                         util::FixedLatitude{std::numeric_limits<std::int32_t>::min()});
-            BOOST_ASSERT(edge_iterator->source_coordinate.lon !=
-                         util::FixedLongitude{std::numeric_limits<std::int32_t>::min()});
-
-            util::Coordinate source_coord(edge_iterator->source_coordinate);
-            util::Coordinate target_coord{node_iterator->lon, node_iterator->lat};
-
-            // flip source and target coordinates if segment is in backward direction only
-            if (!edge_iterator->result.forward && edge_iterator->result.backward)
-                std::swap(source_coord, target_coord);
-
-            const auto distance =
-                util::coordinate_calculation::greatCircleDistance(source_coord, target_coord);
-            const auto weight = edge_iterator->weight_data(distance);
-            const auto duration = edge_iterator->duration_data(distance);
-
-            ExtractionSegment segment(source_coord, target_coord, distance, weight, duration);
-            scripting_environment.ProcessSegment(segment);
-
-            auto &edge = edge_iterator->result;
-            edge.weight = std::max<EdgeWeight>(1, std::round(segment.weight * weight_multiplier));
-            edge.duration = std::max<EdgeWeight>(1, std::round(segment.duration * 10.));
 
             // assign new node id
             auto id_iter = external_to_internal_node_id_map.find(node_iterator->node_id);
             BOOST_ASSERT(id_iter != external_to_internal_node_id_map.end());
-            edge.target = id_iter->second;
-
-            // orient edges consistently: source id < target id
-            // important for multi-edge removal
-            if (edge.source > edge.target)
-            {
-                std::swap(edge.source, edge.target);
-
-                // std::swap does not work with bit-fields
-                bool temp = edge.forward;
-                edge.forward = edge.backward;
-                edge.backward = temp;
-            }
+            batch.Add(all_edges_list,
+                      edge_iterator - all_edges_list.begin(),
+                      *edge_iterator,
+                      util::Coordinate{node_iterator->lon, node_iterator->lat},
+                      id_iter->second);
             ++edge_iterator;
         }
+        batch.Flush(all_edges_list);
 
         // Remove all remaining edges. They are invalid because there are no corresponding nodes for
         // them. This happens when using osmosis with bbox or polygon to extract smaller areas.
@@ -447,6 +788,82 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         TIMER_STOP(compute_weights);
         log << "ok, after " << TIMER_SEC(compute_weights) << "s";
     }
+}
+
+// Finds the coordinates and internal ids of the source and target of every edge in the node
+// location index, the edges keep their order.
+void ExtractionContainers::LookupEdgeNodes(ScriptingEnvironment &scripting_environment)
+{
+    util::UnbufferedLog log;
+    log << "Looking up edge nodes     ... " << std::flush;
+    TIMER_START(lookup_edge_nodes);
+
+    EdgeTargetBatch batch(scripting_environment);
+
+    const auto findInternalID = [this](const OSMNodeID id) {
+        const auto id_iter = external_to_internal_node_id_map.find(id);
+        return id_iter == external_to_internal_node_id_map.end() ? SPECIAL_NODEID
+                                                                 : id_iter->second;
+    };
+    const auto findLocation = [this](const OSMNodeID id) {
+        return node_locations->get_noexcept(static_cast<std::uint64_t>(id));
+    };
+
+    for (auto edge_iterator = all_edges_list.begin(); edge_iterator != all_edges_list.end();
+         ++edge_iterator)
+    {
+        auto &edge = *edge_iterator;
+
+        // remove loops
+        if (edge.result.osm_source_id == edge.result.osm_target_id)
+        {
+            edge.result.source = SPECIAL_NODEID;
+            edge.result.target = SPECIAL_NODEID;
+            continue;
+        }
+
+        edge.result.source = findInternalID(edge.result.osm_source_id);
+        if (edge.result.source == SPECIAL_NODEID)
+        {
+            util::Log(logDEBUG) << "Found invalid node reference "
+                                << static_cast<std::uint64_t>(edge.result.osm_source_id);
+            continue;
+        }
+
+        const auto target = findInternalID(edge.result.osm_target_id);
+        if (target == SPECIAL_NODEID)
+        {
+            util::Log(logDEBUG) << "Found invalid node reference "
+                                << static_cast<std::uint64_t>(edge.result.osm_target_id);
+            edge.result.target = SPECIAL_NODEID;
+            continue;
+        }
+
+        // only nodes with a location have an internal id
+        const auto source_location = findLocation(edge.result.osm_source_id);
+        const auto target_location = findLocation(edge.result.osm_target_id);
+        BOOST_ASSERT(source_location.valid() && target_location.valid());
+        edge.source_coordinate = util::Coordinate{util::FixedLongitude{source_location.x()},
+                                                  util::FixedLatitude{source_location.y()}};
+        batch.Add(all_edges_list,
+                  edge_iterator - all_edges_list.begin(),
+                  edge,
+                  util::Coordinate{util::FixedLongitude{target_location.x()},
+                                   util::FixedLatitude{target_location.y()}},
+                  target);
+    }
+    batch.Flush(all_edges_list);
+
+    TIMER_STOP(lookup_edge_nodes);
+    log << "ok, after " << TIMER_SEC(lookup_edge_nodes) << "s";
+}
+
+void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environment)
+{
+    if (node_locations)
+        LookupEdgeNodes(scripting_environment);
+    else
+        MergeEdgesWithNodes(scripting_environment);
 
     // Sort edges by start.
     {
@@ -454,13 +871,17 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         log << "Sorting edges by renumbered start ... ";
         TIMER_START(sort_edges_by_renumbered_start);
         std::mutex name_data_mutex;
-        stxxl::sort(
-            all_edges_list.begin(),
-            all_edges_list.end(),
+        // invalid ids are the largest ones, so the key orders them like the comparator
+        const auto in_memory = sortByKeyAndCompare(
+            all_edges_list,
+            [](const InternalExtractorEdge &edge) {
+                return (static_cast<std::uint64_t>(edge.result.source) << 32) | edge.result.target;
+            },
             CmpEdgeByInternalSourceTargetAndName{name_data_mutex, name_char_data, name_offsets},
             stxxl_memory);
         TIMER_STOP(sort_edges_by_renumbered_start);
-        log << "ok, after " << TIMER_SEC(sort_edges_by_renumbered_start) << "s";
+        log << "ok, after " << TIMER_SEC(sort_edges_by_renumbered_start) << "s"
+            << (in_memory ? " in memory" : "");
     }
 
     BOOST_ASSERT(all_edges_list.size() > 0);
@@ -606,30 +1027,17 @@ void ExtractionContainers::WriteNodes(storage::io::FileWriter &file_out) const
         util::UnbufferedLog log;
         log << "Confirming/Writing used nodes     ... ";
         TIMER_START(write_nodes);
-        // identify all used nodes by a merging step of two sorted lists
-        auto node_iterator = all_nodes_list.begin();
-        auto node_id_iterator = used_node_id_list.begin();
-        const auto used_node_id_list_end = used_node_id_list.end();
-        const auto all_nodes_list_end = all_nodes_list.end();
-
-        while (node_id_iterator != used_node_id_list_end && node_iterator != all_nodes_list_end)
+        if (spatial_node_ids.empty())
         {
-            if (*node_id_iterator < node_iterator->node_id)
-            {
-                ++node_id_iterator;
-                continue;
-            }
-            if (*node_id_iterator > node_iterator->node_id)
-            {
-                ++node_iterator;
-                continue;
-            }
-            BOOST_ASSERT(*node_id_iterator == node_iterator->node_id);
-
-            file_out.WriteOne((*node_iterator));
-
-            ++node_id_iterator;
-            ++node_iterator;
+            ForEachUsedNode([&](const QueryNode &node) { file_out.WriteOne(node); });
+        }
+        else
+        {
+            std::vector<QueryNode> nodes(spatial_node_ids.size());
+            std::size_t index = 0;
+            ForEachUsedNode(
+                [&](const QueryNode &node) { nodes[spatial_node_ids[index++]] = node; });
+            file_out.WriteFrom(nodes);
         }
         TIMER_STOP(write_nodes);
         log << "ok, after " << TIMER_SEC(write_nodes) << "s";
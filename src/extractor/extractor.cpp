@@ -8,7 +8,10 @@
 #include "extractor/files.hpp"
 #include "extractor/raster_source.hpp"
 #include "extractor/restriction_parser.hpp"
+#include "extractor/osm_change_merger.hpp"
+#include "extractor/parallel_scc.hpp"
 #include "extractor/scripting_environment.hpp"
+#include "extractor/serialization.hpp"
 
 #include "storage/io.hpp"
 
@@ -17,7 +20,9 @@
 #include "util/graph_loader.hpp"
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/mmap_file.hpp"
 #include "util/name_table.hpp"
+#include "util/perf_report.hpp"
 #include "util/range_table.hpp"
 #include "util/timing_util.hpp"
 
@@ -29,16 +34,17 @@
 // Keep debug include to make sure the debug header is in sync with types.
 #include "util/debug.hpp"
 
-#include "extractor/tarjan_scc.hpp"
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/iterator/function_input_iterator.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/scope_exit.hpp>
 
 #include <osmium/io/any_input.hpp>
 
+#include <tbb/parallel_sort.h>
 #include <tbb/pipeline.h>
 #include <tbb/task_scheduler_init.h>
 
@@ -48,10 +54,12 @@
 #include <atomic>
 #include <bitset>
 #include <chrono>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <string>
 #include <thread>
 #include <tuple>
 #include <type_traits>
@@ -65,6 +73,62 @@ namespace extractor
 
 namespace
 {
+// Identifies the input and the options of ParseOSMData, a checkpoint is only used for the
+// same input file with the same options
+struct ParseCheckpointHeader
+{
+    std::uint64_t input_size;
+    std::int64_t input_write_time;
+    std::uint8_t use_metadata;
+    std::uint8_t parse_conditionals;
+    std::uint64_t profile_hash;
+    std::uint64_t changes_hash;
+    std::uint8_t routing_only;
+    // the restrictions of the checkpoint refer to the internal node ids
+    std::uint8_t spatial_node_order;
+    std::uint8_t way_index;
+
+    bool SameInput(const ParseCheckpointHeader &other) const
+    {
+        return input_size == other.input_size && input_write_time == other.input_write_time &&
+               changes_hash == other.changes_hash &&
+               use_metadata == other.use_metadata &&
+               parse_conditionals == other.parse_conditionals &&
+               routing_only == other.routing_only &&
+               spatial_node_order == other.spatial_node_order && way_index == other.way_index;
+    }
+};
+
+ParseCheckpointHeader MakeParseCheckpointHeader(const ExtractorConfig &config)
+{
+    std::uint64_t profile_hash = 0;
+    if (!config.profile_path.empty() && boost::filesystem::exists(config.profile_path))
+    {
+        boost::filesystem::ifstream profile(config.profile_path, std::ios::binary);
+        const std::string script{std::istreambuf_iterator<char>(profile),
+                                 std::istreambuf_iterator<char>()};
+        profile_hash = std::hash<std::string>()(script);
+    }
+
+    std::size_t changes_hash = 0;
+    for (const auto &path : config.change_paths)
+    {
+        boost::hash_combine(changes_hash, path.string());
+        boost::hash_combine(changes_hash, boost::filesystem::file_size(path));
+        boost::hash_combine(changes_hash, boost::filesystem::last_write_time(path));
+    }
+
+    return {boost::filesystem::file_size(config.input_path),
+            static_cast<std::int64_t>(boost::filesystem::last_write_time(config.input_path)),
+            config.use_metadata,
+            config.parse_conditionals,
+            profile_hash,
+            changes_hash,
+            config.routing_only,
+            config.spatial_node_order,
+            config.way_index};
+}
+
 // Converts the class name map into a fixed mapping of index to name
 void SetClassNames(const ExtractorCallbacks::ClassesMap &classes_map,
                    ProfileProperties &profile_properties)
@@ -99,28 +163,78 @@ void SetClassNames(const ExtractorCallbacks::ClassesMap &classes_map,
  */
 int Extractor::run(ScriptingEnvironment &scripting_environment)
 {
+    return run({this}, {&scripting_environment});
+}
+
+int Extractor::run(const std::vector<Extractor *> &extractors,
+                   const std::vector<ScriptingEnvironment *> &scripting_environments)
+{
+    BOOST_ASSERT(!extractors.empty() && extractors.size() == scripting_environments.size());
     util::LogPolicy::GetInstance().Unmute();
 
+    const auto &config = extractors.front()->config;
     const unsigned recommended_num_threads = tbb::task_scheduler_init::default_num_threads();
     const auto number_of_threads = std::min(recommended_num_threads, config.requested_num_threads);
     tbb::task_scheduler_init init(number_of_threads ? number_of_threads
                                                     : tbb::task_scheduler_init::automatic);
 
-    guidance::LaneDescriptionMap turn_lane_map;
-    std::vector<TurnRestriction> turn_restrictions;
-    std::tie(turn_lane_map, turn_restrictions) =
-        ParseOSMData(scripting_environment, number_of_threads);
+    // only the profiles without a checkpoint of an earlier run parse the input
+    std::vector<ParseResult> results(extractors.size());
+    std::vector<Extractor *> parsing_extractors;
+    std::vector<ScriptingEnvironment *> parsing_environments;
+    std::vector<std::size_t> parsing_indexes;
+    for (const auto index : util::irange<std::size_t>(0, extractors.size()))
+    {
+        if (!config.resume || !extractors[index]->ReadParseCheckpoint(std::get<0>(results[index]),
+                                                                      std::get<1>(results[index])))
+        {
+            parsing_extractors.push_back(extractors[index]);
+            parsing_environments.push_back(scripting_environments[index]);
+            parsing_indexes.push_back(index);
+        }
+    }
+    if (!parsing_extractors.empty())
+    {
+        util::PerfStage parsing_stage("parsing");
+        auto parse_results =
+            ParseOSMData(parsing_extractors, parsing_environments, number_of_threads);
+        for (const auto index : util::irange<std::size_t>(0, parsing_indexes.size()))
+        {
+            auto &result = results[parsing_indexes[index]];
+            result = std::move(parse_results[index]);
+            parsing_extractors[index]->WriteParseCheckpoint(std::get<0>(result),
+                                                            std::get<1>(result));
+        }
+    }
+
+    for (const auto index : util::irange<std::size_t>(0, extractors.size()))
+    {
+        if (extractors.size() > 1)
+        {
+            util::Log() << "Building the dataset " << extractors[index]->config.output_file_name;
+        }
+        extractors[index]->BuildDataset(*scripting_environments[index],
+                                        std::get<0>(results[index]),
+                                        std::get<1>(results[index]));
+    }
 
+    return 0;
+}
+
+void Extractor::BuildDataset(ScriptingEnvironment &scripting_environment,
+                             guidance::LaneDescriptionMap &turn_lane_map,
+                             std::vector<TurnRestriction> &turn_restrictions)
+{
     // Transform the node-based graph that OSM is based on into an edge-based graph
     // that is better for routing.  Every edge becomes a node, and every valid
     // movement (e.g. turn from A->B, and B->A) becomes an edge
     util::Log() << "Generating edge-expanded graph representation";
 
     TIMER_START(expansion);
+    util::PerfStage expansion_stage("expansion");
 
     EdgeBasedNodeDataContainer edge_based_nodes_container;
     std::vector<EdgeBasedNodeSegment> edge_based_node_segments;
-    util::DeallocatingVector<EdgeBasedEdge> edge_based_edge_list;
     std::vector<bool> node_is_startpoint;
     std::vector<EdgeWeight> edge_based_node_weights;
     std::vector<util::Coordinate> coordinates;
@@ -133,7 +247,6 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
                                              edge_based_node_segments,
                                              node_is_startpoint,
                                              edge_based_node_weights,
-                                             edge_based_edge_list,
                                              config.intersection_class_data_output_path,
                                              turn_restrictions,
                                              turn_lane_map);
@@ -142,10 +255,12 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
     auto max_edge_id = graph_size.second;
 
     TIMER_STOP(expansion);
+    expansion_stage.Stop();
 
     util::Log() << "Saving edge-based node weights to file.";
     TIMER_START(timer_write_node_weights);
     {
+        util::PerfStage write_stage("writing_node_weights");
         storage::io::FileWriter writer(config.edge_based_node_weights_output_path,
                                        storage::io::FileWriter::GenerateFingerprint);
         storage::serialization::write(writer, edge_based_node_weights);
@@ -154,26 +269,36 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
     util::Log() << "Done writing. (" << TIMER_SEC(timer_write_node_weights) << ")";
 
     util::Log() << "Computing strictly connected components ...";
-    FindComponents(
-        max_edge_id, edge_based_edge_list, edge_based_node_segments, edge_based_nodes_container);
+    util::PerfStage components_stage("components");
+    FindComponents(max_edge_id,
+                   config.edge_graph_output_path,
+                   edge_based_node_segments,
+                   edge_based_nodes_container);
+    components_stage.Stop();
 
     util::Log() << "Building r-tree ...";
     TIMER_START(rtree);
-    BuildRTree(std::move(edge_based_node_segments), std::move(node_is_startpoint), coordinates);
+    util::PerfStage rtree_stage("rtree");
+    BuildRTree(std::move(edge_based_node_segments),
+               std::move(node_is_startpoint),
+               coordinates,
+               edge_based_nodes_container);
+    rtree_stage.Stop();
 
     TIMER_STOP(rtree);
 
     util::Log() << "Writing nodes for nodes-based and edges-based graphs ...";
+    util::PerfStage write_nodes_stage("writing_nodes");
     files::writeNodes(config.node_based_nodes_data_path, coordinates, osm_node_ids);
     files::writeNodeData(config.edge_based_nodes_data_path, edge_based_nodes_container);
+    write_nodes_stage.Stop();
 
-    util::Log() << "Writing edge-based-graph edges       ... " << std::flush;
-    TIMER_START(write_edges);
-    files::writeEdgeBasedGraph(config.edge_graph_output_path, max_edge_id, edge_based_edge_list);
-    TIMER_STOP(write_edges);
-    util::Log() << "ok, after " << TIMER_SEC(write_edges) << "s";
-
-    util::Log() << "Processed " << edge_based_edge_list.size() << " edges";
+    if (config.turn_cost_tables)
+    {
+        util::Log() << "Writing turn cost tables ...";
+        util::PerfStage turn_costs_stage("turn_cost_tables");
+        WriteTurnCostTable();
+    }
 
     const auto nodes_per_second =
         static_cast<std::uint64_t>(number_of_node_based_nodes / TIMER_SEC(expansion));
@@ -184,27 +309,55 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
                 << " edges/sec";
     util::Log() << "To prepare the data for routing, run: "
                 << "./osrm-contract " << config.output_file_name;
-
-    return 0;
 }
 
-std::tuple<guidance::LaneDescriptionMap, std::vector<TurnRestriction>>
-Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
+std::vector<Extractor::ParseResult>
+Extractor::ParseOSMData(const std::vector<Extractor *> &extractors,
+                        const std::vector<ScriptingEnvironment *> &scripting_environments,
                         const unsigned number_of_threads)
 {
+    BOOST_ASSERT(!extractors.empty() && extractors.size() == scripting_environments.size());
     TIMER_START(extracting);
 
+    // the input and the parsing options are the same for all profiles
+    const auto &config = extractors.front()->config;
+
+    // the files of a previous run are overwritten from here on
+    for (const auto extractor : extractors)
+    {
+        boost::filesystem::remove(extractor->config.parse_checkpoint_path);
+    }
+
     util::Log() << "Input file: " << config.input_path.filename().string();
-    if (!config.profile_path.empty())
+    for (const auto extractor : extractors)
     {
-        util::Log() << "Profile: " << config.profile_path.filename().string();
+        if (!extractor->config.profile_path.empty())
+        {
+            util::Log() << "Profile: " << extractor->config.profile_path.filename().string();
+        }
     }
     util::Log() << "Threads: " << number_of_threads;
 
     const osmium::io::File input_file(config.input_path.string());
 
-    osmium::io::Reader reader(
-        input_file, (config.use_metadata ? osmium::io::read_meta::yes : osmium::io::read_meta::no));
+    const auto read_metadata =
+        config.use_metadata ? osmium::io::read_meta::yes : osmium::io::read_meta::no;
+
+    // Only the nodes of routable ways are kept, the others are parsed but discarded later.
+    // Reading the ways and relations first allows to skip the profile and the storage for all
+    // other nodes when reading the nodes in a second pass.
+    const bool two_pass = config.two_pass_parsing && config.change_paths.empty();
+    if (config.two_pass_parsing && !two_pass)
+    {
+        util::Log(logWARNING) << "Changes can only be applied while reading the input in one "
+                                 "pass, parsing in one pass";
+    }
+
+    // with two passes this reader only reads the header
+    osmium::io::Reader reader(input_file,
+                              two_pass ? osmium::osm_entity_bits::nothing
+                                       : osmium::osm_entity_bits::all,
+                              read_metadata);
 
     const osmium::io::Header header = reader.header();
 
@@ -215,17 +368,48 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     util::Log() << "Parsing in progress..";
     TIMER_START(parsing);
 
-    ExtractionContainers extraction_containers;
-    ExtractorCallbacks::ClassesMap classes_map;
-    guidance::LaneDescriptionMap turn_lane_map;
-    auto extractor_callbacks =
-        std::make_unique<ExtractorCallbacks>(extraction_containers,
-                                             classes_map,
-                                             turn_lane_map,
-                                             scripting_environment.GetProfileProperties());
+    // Everything a profile collects from the input, the buffers are decoded once and passed to
+    // the profiles one after the other
+    struct ProfileParse
+    {
+        ProfileParse(const ExtractorConfig &config, ScriptingEnvironment &scripting_environment)
+            : scripting_environment(scripting_environment),
+              extraction_containers(config.node_locations,
+                                    config.deduplicate_names,
+                                    config.spatial_node_order,
+                                    config.way_index),
+              extractor_callbacks(std::make_unique<ExtractorCallbacks>(
+                  extraction_containers,
+                  classes_map,
+                  turn_lane_map,
+                  scripting_environment.GetProfileProperties())),
+              restrictions(scripting_environment.GetRestrictions()),
+              restriction_parser(scripting_environment.GetProfileProperties().use_turn_restrictions,
+                                 config.parse_conditionals,
+                                 restrictions)
+        {
+        }
+
+        ScriptingEnvironment &scripting_environment;
+        ExtractionContainers extraction_containers;
+        ExtractorCallbacks::ClassesMap classes_map;
+        guidance::LaneDescriptionMap turn_lane_map;
+        std::unique_ptr<ExtractorCallbacks> extractor_callbacks;
+        std::vector<std::string> restrictions;
+        const RestrictionParser restriction_parser;
+    };
+    std::vector<std::unique_ptr<ProfileParse>> profiles;
+    for (const auto index : util::irange<std::size_t>(0, extractors.size()))
+    {
+        profiles.push_back(std::make_unique<ProfileParse>(extractors[index]->config,
+                                                          *scripting_environments[index]));
+    }
 
     // setup raster sources
-    scripting_environment.SetupSources();
+    for (const auto &profile : profiles)
+    {
+        profile->scripting_environment.SetupSources();
+    }
 
     std::string generator = header.get("generator");
     if (generator.empty())
@@ -242,17 +426,13 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     }
     util::Log() << "timestamp: " << timestamp;
 
-    storage::io::FileWriter timestamp_file(config.timestamp_file_name,
-                                           storage::io::FileWriter::GenerateFingerprint);
-
-    timestamp_file.WriteFrom(timestamp.c_str(), timestamp.length());
+    for (const auto extractor : extractors)
+    {
+        storage::io::FileWriter timestamp_file(extractor->config.timestamp_file_name,
+                                               storage::io::FileWriter::GenerateFingerprint);
 
-    std::vector<std::string> restrictions = scripting_environment.GetRestrictions();
-    // setup restriction parser
-    const RestrictionParser restriction_parser(
-        scripting_environment.GetProfileProperties().use_turn_restrictions,
-        config.parse_conditionals,
-        restrictions);
+        timestamp_file.WriteFrom(timestamp.c_str(), timestamp.length());
+    }
 
     std::mutex process_mutex;
 
@@ -260,63 +440,173 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     struct ParsedBuffer
     {
         SharedBuffer buffer;
-        std::vector<std::pair<const osmium::Node &, ExtractionNode>> resulting_nodes;
-        std::vector<std::pair<const osmium::Way &, ExtractionWay>> resulting_ways;
-        std::vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
+        // one per profile
+        std::vector<ExtractorCallbacks::Fragment> fragments;
+        std::size_t number_of_nodes;
+        std::size_t number_of_ways;
+        std::size_t number_of_relations;
+    };
+
+    std::unique_ptr<OSMChangeMerger> change_merger;
+    if (!config.change_paths.empty())
+    {
+        change_merger = std::make_unique<OSMChangeMerger>(
+            OSMChangeMerger::ReadChanges(config.change_paths));
+        util::Log() << "Applying changes to " << change_merger->GetNumberOfChanges()
+                    << " objects";
+    }
+
+    // only set for the second pass, the sorted ids of the nodes used by routable ways
+    std::vector<OSMNodeID> used_nodes;
+    const auto isUsedNode = [&used_nodes](const osmium::Node &node) {
+        return std::binary_search(used_nodes.begin(),
+                                  used_nodes.end(),
+                                  OSMNodeID{static_cast<std::uint64_t>(node.id())});
     };
 
+    // the reader of the current pass
+    osmium::io::Reader *pass_reader = &reader;
+    bool finished_changes = false;
     tbb::filter_t<void, SharedBuffer> buffer_reader(
         tbb::filter::serial_in_order, [&](tbb::flow_control &fc) {
-            if (auto buffer = reader.read())
+            if (auto buffer = pass_reader->read())
             {
+                if (change_merger)
+                    buffer = change_merger->Merge(std::move(buffer));
                 return std::make_shared<const osmium::memory::Buffer>(std::move(buffer));
             }
-            else
+            if (change_merger && !finished_changes)
             {
-                fc.stop();
-                return SharedBuffer{};
+                finished_changes = true;
+                auto created = change_merger->Finish();
+                if (created.committed() > 0)
+                    return std::make_shared<const osmium::memory::Buffer>(std::move(created));
             }
+            fc.stop();
+            return SharedBuffer{};
         });
+    // runs the profiles and converts their results into edges with names, turn lanes and
+    // classes numbered per buffer
     tbb::filter_t<SharedBuffer, std::shared_ptr<ParsedBuffer>> buffer_transform(
-        tbb::filter::parallel, [&](const SharedBuffer buffer) {
+        tbb::filter::parallel, [&](SharedBuffer buffer) {
             if (!buffer)
                 return std::shared_ptr<ParsedBuffer>{};
 
+            if (!used_nodes.empty())
+            {
+                osmium::memory::Buffer used_buffer(buffer->committed(),
+                                                   osmium::memory::Buffer::auto_grow::yes);
+                for (const auto &node : buffer->select<osmium::Node>())
+                {
+                    if (isUsedNode(node))
+                    {
+                        used_buffer.add_item(node);
+                        used_buffer.commit();
+                    }
+                }
+                buffer = std::make_shared<const osmium::memory::Buffer>(std::move(used_buffer));
+            }
+
             auto parsed_buffer = std::make_shared<ParsedBuffer>();
             parsed_buffer->buffer = buffer;
-            scripting_environment.ProcessElements(*buffer,
-                                                  restriction_parser,
-                                                  parsed_buffer->resulting_nodes,
-                                                  parsed_buffer->resulting_ways,
-                                                  parsed_buffer->resulting_restrictions);
+            parsed_buffer->fragments.resize(profiles.size());
+
+            std::vector<std::pair<const osmium::Node &, ExtractionNode>> resulting_nodes;
+            std::vector<std::pair<const osmium::Way &, ExtractionWay>> resulting_ways;
+            std::vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
+            for (const auto index : util::irange<std::size_t>(0, profiles.size()))
+            {
+                auto &profile = *profiles[index];
+                resulting_nodes.clear();
+                resulting_ways.clear();
+                resulting_restrictions.clear();
+                profile.scripting_environment.ProcessElements(*buffer,
+                                                              profile.restriction_parser,
+                                                              resulting_nodes,
+                                                              resulting_ways,
+                                                              resulting_restrictions);
+
+                // every profile gets all elements, counted once
+                if (index == 0)
+                {
+                    parsed_buffer->number_of_nodes = resulting_nodes.size();
+                    parsed_buffer->number_of_ways = resulting_ways.size();
+                    parsed_buffer->number_of_relations = resulting_restrictions.size();
+                }
+                auto &fragment = parsed_buffer->fragments[index];
+                for (const auto &result : resulting_nodes)
+                {
+                    profile.extractor_callbacks->ProcessNode(
+                        fragment, result.first, result.second);
+                }
+                for (const auto &result : resulting_ways)
+                {
+                    profile.extractor_callbacks->ProcessWay(fragment, result.first, result.second);
+                }
+                for (const auto &result : resulting_restrictions)
+                {
+                    profile.extractor_callbacks->ProcessRestriction(fragment, result);
+                }
+            }
             return parsed_buffer;
         });
+    // only the global ids and the order of the external memory containers are kept serial
     tbb::filter_t<std::shared_ptr<ParsedBuffer>, void> buffer_storage(
         tbb::filter::serial_in_order, [&](const std::shared_ptr<ParsedBuffer> parsed_buffer) {
             if (!parsed_buffer)
                 return;
 
-            number_of_nodes += parsed_buffer->resulting_nodes.size();
-            // put parsed objects thru extractor callbacks
-            for (const auto &result : parsed_buffer->resulting_nodes)
-            {
-                extractor_callbacks->ProcessNode(result.first, result.second);
-            }
-            number_of_ways += parsed_buffer->resulting_ways.size();
-            for (const auto &result : parsed_buffer->resulting_ways)
+            number_of_nodes += parsed_buffer->number_of_nodes;
+            number_of_ways += parsed_buffer->number_of_ways;
+            number_of_relations += parsed_buffer->number_of_relations;
+            for (const auto index : util::irange<std::size_t>(0, profiles.size()))
             {
-                extractor_callbacks->ProcessWay(result.first, result.second);
-            }
-            number_of_relations += parsed_buffer->resulting_restrictions.size();
-            for (const auto &result : parsed_buffer->resulting_restrictions)
-            {
-                extractor_callbacks->ProcessRestriction(result);
+                profiles[index]->extractor_callbacks->Store(parsed_buffer->fragments[index]);
             }
         });
 
     // Number of pipeline tokens that yielded the best speedup was about 1.5 * num_cores
-    tbb::parallel_pipeline(tbb::task_scheduler_init::default_num_threads() * 1.5,
-                           buffer_reader & buffer_transform & buffer_storage);
+    const auto number_of_tokens = tbb::task_scheduler_init::default_num_threads() * 1.5;
+    if (two_pass)
+    {
+        reader.close();
+        {
+            osmium::io::Reader way_reader(input_file,
+                                          osmium::osm_entity_bits::way |
+                                              osmium::osm_entity_bits::relation,
+                                          read_metadata);
+            pass_reader = &way_reader;
+            tbb::parallel_pipeline(number_of_tokens,
+                                   buffer_reader & buffer_transform & buffer_storage);
+            way_reader.close();
+        }
+
+        // the nodes used by the ways of any of the profiles
+        for (const auto &profile : profiles)
+        {
+            const auto &used_node_ids = profile->extraction_containers.used_node_id_list;
+            used_nodes.insert(used_nodes.end(), used_node_ids.begin(), used_node_ids.end());
+        }
+        tbb::parallel_sort(used_nodes.begin(), used_nodes.end());
+        used_nodes.erase(std::unique(used_nodes.begin(), used_nodes.end()), used_nodes.end());
+        used_nodes.shrink_to_fit();
+        util::Log() << "Reading the " << used_nodes.size() << " nodes of routable ways";
+
+        // no way uses a node, nothing to read
+        if (!used_nodes.empty())
+        {
+            osmium::io::Reader node_reader(input_file, osmium::osm_entity_bits::node, read_metadata);
+            pass_reader = &node_reader;
+            tbb::parallel_pipeline(number_of_tokens,
+                                   buffer_reader & buffer_transform & buffer_storage);
+            node_reader.close();
+        }
+        std::vector<OSMNodeID>().swap(used_nodes);
+    }
+    else
+    {
+        tbb::parallel_pipeline(number_of_tokens, buffer_reader & buffer_transform & buffer_storage);
+    }
 
     TIMER_STOP(parsing);
     util::Log() << "Parsing finished after " << TIMER_SEC(parsing) << " seconds";
@@ -324,54 +614,165 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     util::Log() << "Raw input contains " << number_of_nodes << " nodes, " << number_of_ways
                 << " ways, and " << number_of_relations << " relations";
 
-    extractor_callbacks.reset();
-
-    if (extraction_containers.all_edges_list.empty())
+    std::vector<ParseResult> results;
+    for (const auto index : util::irange<std::size_t>(0, profiles.size()))
     {
-        throw util::exception(std::string("There are no edges remaining after parsing.") +
-                              SOURCE_REF);
-    }
+        auto &profile = *profiles[index];
+        const auto &profile_config = extractors[index]->config;
+        profile.extractor_callbacks.reset();
 
-    extraction_containers.PrepareData(scripting_environment,
-                                      config.output_file_name,
-                                      config.restriction_file_name,
-                                      config.names_file_name);
+        if (profile.extraction_containers.all_edges_list.empty())
+        {
+            throw util::exception(std::string("There are no edges remaining after parsing") +
+                                  (profiles.size() > 1
+                                       ? " with " + profile_config.profile_path.string()
+                                       : std::string()) +
+                                  "." + SOURCE_REF);
+        }
 
-    auto profile_properties = scripting_environment.GetProfileProperties();
-    SetClassNames(classes_map, profile_properties);
-    files::writeProfileProperties(config.profile_properties_output_path, profile_properties);
+        profile.extraction_containers.PrepareData(profile.scripting_environment,
+                                                  profile_config.output_file_name,
+                                                  profile_config.restriction_file_name,
+                                                  profile_config.names_file_name);
+        if (profile_config.way_index)
+        {
+            profile.extraction_containers.WriteWayIndex(profile_config.way_index_path);
+        }
+
+        auto profile_properties = profile.scripting_environment.GetProfileProperties();
+        SetClassNames(profile.classes_map, profile_properties);
+        profile_properties.routing_only = profile_config.routing_only;
+        files::writeProfileProperties(profile_config.profile_properties_output_path,
+                                      profile_properties);
+
+        results.emplace_back(
+            std::move(profile.turn_lane_map),
+            std::move(profile.extraction_containers.unconditional_turn_restrictions));
+
+        // the containers of a profile are not needed anymore once its files are written
+        profiles[index].reset();
+    }
 
     TIMER_STOP(extracting);
     util::Log() << "extraction finished after " << TIMER_SEC(extracting) << "s";
 
-    return std::make_tuple(std::move(turn_lane_map),
-                           std::move(extraction_containers.unconditional_turn_restrictions));
+    return results;
+}
+
+void Extractor::WriteParseCheckpoint(const guidance::LaneDescriptionMap &turn_lane_map,
+                                     const std::vector<TurnRestriction> &turn_restrictions) const
+{
+    storage::io::FileWriter writer(config.parse_checkpoint_path,
+                                   storage::io::FileWriter::GenerateFingerprint);
+
+    writer.WriteOne(MakeParseCheckpointHeader(config));
+
+    std::vector<std::uint32_t> turn_lane_offsets;
+    std::vector<guidance::TurnLaneType::Mask> turn_lane_masks;
+    std::tie(turn_lane_offsets, turn_lane_masks) =
+        guidance::transformTurnLaneMapIntoArrays(turn_lane_map);
+    storage::serialization::write(writer, turn_lane_offsets);
+    storage::serialization::write(writer, turn_lane_masks);
+
+    writer.WriteElementCount64(turn_restrictions.size());
+    for (const auto &restriction : turn_restrictions)
+    {
+        serialization::write(writer, restriction);
+    }
+}
+
+bool Extractor::ReadParseCheckpoint(guidance::LaneDescriptionMap &turn_lane_map,
+                                    std::vector<TurnRestriction> &turn_restrictions) const
+{
+    std::vector<std::string> stage_files = {config.parse_checkpoint_path,
+                                            config.output_file_name,
+                                            config.restriction_file_name,
+                                            config.names_file_name,
+                                            config.timestamp_file_name,
+                                            config.profile_properties_output_path};
+    if (config.way_index)
+        stage_files.push_back(config.way_index_path);
+    for (const auto &file : stage_files)
+    {
+        if (!boost::filesystem::exists(file))
+        {
+            util::Log() << "Can not resume, " << file << " is missing";
+            return false;
+        }
+    }
+
+    storage::io::FileReader reader(config.parse_checkpoint_path,
+                                   storage::io::FileReader::VerifyFingerprint);
+
+    const auto header = reader.ReadOne<ParseCheckpointHeader>();
+    const auto expected_header = MakeParseCheckpointHeader(config);
+    if (!header.SameInput(expected_header))
+    {
+        util::Log() << "Can not resume, the checkpoint was written for a different input file "
+                       "or parsing options";
+        return false;
+    }
+    if (header.profile_hash != expected_header.profile_hash)
+    {
+        util::Log(logWARNING) << "The profile changed since the checkpoint was written, the "
+                                 "node and way results of the previous run are used";
+    }
+
+    std::vector<std::uint32_t> turn_lane_offsets;
+    std::vector<guidance::TurnLaneType::Mask> turn_lane_masks;
+    storage::serialization::read(reader, turn_lane_offsets);
+    storage::serialization::read(reader, turn_lane_masks);
+    turn_lane_map = guidance::transformArraysIntoTurnLaneMap(turn_lane_offsets, turn_lane_masks);
+
+    serialization::read(reader, turn_restrictions);
+
+    util::Log() << "Resuming after parsing with " << turn_restrictions.size()
+                << " turn restrictions from " << config.parse_checkpoint_path;
+    return true;
 }
 
 void Extractor::FindComponents(unsigned max_edge_id,
-                               const util::DeallocatingVector<EdgeBasedEdge> &input_edge_list,
+                               const std::string &edge_based_graph_path,
                                const std::vector<EdgeBasedNodeSegment> &input_node_segments,
                                EdgeBasedNodeDataContainer &nodes_container) const
 {
     using InputEdge = util::static_graph_details::SortableEdgeWithData<void>;
     using UncontractedGraph = util::StaticGraph<void>;
+
+    // The edges were streamed to the .ebg file by the EdgeBasedGraphFactory, only their end
+    // points are read back in blocks. See files::writeEdgeBasedGraph for the layout.
+    storage::io::FileReader reader(edge_based_graph_path,
+                                   storage::io::FileReader::VerifyFingerprint);
+    const auto stored_max_edge_id = reader.ReadElementCount64();
+    BOOST_ASSERT(stored_max_edge_id == max_edge_id);
+    (void)stored_max_edge_id;
+    const auto number_of_edges = reader.ReadElementCount64();
+
     std::vector<InputEdge> edges;
-    edges.reserve(input_edge_list.size() * 2);
+    edges.reserve(number_of_edges * 2);
 
-    for (const auto &edge : input_edge_list)
+    const constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+    std::vector<EdgeBasedEdge> block;
+    for (std::uint64_t edges_read = 0; edges_read < number_of_edges; edges_read += block.size())
     {
-        BOOST_ASSERT_MSG(static_cast<unsigned int>(std::max(edge.data.weight, 1)) > 0,
-                         "edge distance < 1");
-        BOOST_ASSERT(edge.source <= max_edge_id);
-        BOOST_ASSERT(edge.target <= max_edge_id);
-        if (edge.data.forward)
-        {
-            edges.push_back({edge.source, edge.target});
-        }
+        block.resize(std::min<std::uint64_t>(BLOCK_SIZE, number_of_edges - edges_read));
+        reader.ReadInto(block);
 
-        if (edge.data.backward)
+        for (const auto &edge : block)
         {
-            edges.push_back({edge.target, edge.source});
+            BOOST_ASSERT_MSG(static_cast<unsigned int>(std::max(edge.data.weight, 1)) > 0,
+                             "edge distance < 1");
+            BOOST_ASSERT(edge.source <= max_edge_id);
+            BOOST_ASSERT(edge.target <= max_edge_id);
+            if (edge.data.forward)
+            {
+                edges.push_back({edge.source, edge.target});
+            }
+
+            if (edge.data.backward)
+            {
+                edges.push_back({edge.target, edge.source});
+            }
         }
     }
 
@@ -393,7 +794,7 @@ void Extractor::FindComponents(unsigned max_edge_id,
 
     auto uncontracted_graph = UncontractedGraph(max_edge_id + 1, edges);
 
-    TarjanSCC<UncontractedGraph> component_search(uncontracted_graph);
+    ParallelSCC<UncontractedGraph> component_search(uncontracted_graph);
     component_search.Run();
 
     for (NodeID node_id = 0; node_id <= max_edge_id; ++node_id)
@@ -449,7 +850,6 @@ Extractor::BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
                                   std::vector<EdgeBasedNodeSegment> &edge_based_node_segments,
                                   std::vector<bool> &node_is_startpoint,
                                   std::vector<EdgeWeight> &edge_based_node_weights,
-                                  util::DeallocatingVector<EdgeBasedEdge> &edge_based_edge_list,
                                   const std::string &intersection_class_output_file,
                                   std::vector<TurnRestriction> &turn_restrictions,
                                   guidance::LaneDescriptionMap &turn_lane_map)
@@ -468,22 +868,38 @@ Extractor::BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
                               *restriction_map,
                               *node_based_graph,
                               compressed_edge_container);
+    // the restrictions are final once the graph is compressed
+    restriction_map->Compact();
+
+    // the graph is not modified anymore, compact it and drop the gaps of the dynamic graph
+    std::shared_ptr<util::NodeBasedStaticGraph> compressed_node_based_graph;
+    {
+        std::vector<EdgeID> new_edge_ids;
+        compressed_node_based_graph =
+            std::make_shared<util::NodeBasedStaticGraph>(*node_based_graph, new_edge_ids);
+        compressed_edge_container.RenumberEdges(new_edge_ids);
+        node_based_graph.reset();
+    }
 
     util::NameTable name_table(config.names_file_name);
 
+    auto profile_properties = scripting_environment.GetProfileProperties();
+    profile_properties.routing_only = config.routing_only;
+
     EdgeBasedGraphFactory edge_based_graph_factory(
-        node_based_graph,
+        compressed_node_based_graph,
         compressed_edge_container,
         barrier_nodes,
         traffic_lights,
         std::const_pointer_cast<RestrictionMap const>(restriction_map),
         coordinates,
         osm_node_ids,
-        scripting_environment.GetProfileProperties(),
+        profile_properties,
         name_table,
         turn_lane_map);
 
     edge_based_graph_factory.Run(scripting_environment,
+                                 config.edge_graph_output_path,
                                  config.edge_output_path,
                                  config.turn_lane_data_file_name,
                                  config.turn_weight_penalties_path,
@@ -511,29 +927,33 @@ Extractor::BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
     };
 
     compressed_node_based_graph_writing = std::async(std::launch::async, [&] {
-        WriteCompressedNodeBasedGraph(
-            config.compressed_node_based_graph_output_path, *node_based_graph, coordinates);
+        WriteCompressedNodeBasedGraph(config.compressed_node_based_graph_output_path,
+                                      *compressed_node_based_graph,
+                                      coordinates);
     });
 
     {
+        // routing-only datasets have no lane data referring to the descriptions
         std::vector<std::uint32_t> turn_lane_offsets;
         std::vector<guidance::TurnLaneType::Mask> turn_lane_masks;
-        std::tie(turn_lane_offsets, turn_lane_masks) =
-            guidance::transformTurnLaneMapIntoArrays(turn_lane_map);
+        if (!config.routing_only)
+        {
+            std::tie(turn_lane_offsets, turn_lane_masks) =
+                guidance::transformTurnLaneMapIntoArrays(turn_lane_map);
+        }
         files::writeTurnLaneDescriptions(
             config.turn_lane_descriptions_file_name, turn_lane_offsets, turn_lane_masks);
     }
     files::writeSegmentData(config.geometry_output_path,
                             *compressed_edge_container.ToSegmentData());
 
-    edge_based_graph_factory.GetEdgeBasedEdges(edge_based_edge_list);
     edge_based_graph_factory.GetEdgeBasedNodes(edge_based_nodes_container);
     edge_based_graph_factory.GetEdgeBasedNodeSegments(edge_based_node_segments);
     edge_based_graph_factory.GetStartPointMarkers(node_is_startpoint);
     edge_based_graph_factory.GetEdgeBasedNodeWeights(edge_based_node_weights);
     auto max_edge_id = edge_based_graph_factory.GetHighestEdgeID();
 
-    const std::size_t number_of_node_based_nodes = node_based_graph->GetNumberOfNodes();
+    const std::size_t number_of_node_based_nodes = compressed_node_based_graph->GetNumberOfNodes();
 
     util::Log() << "Writing Intersection Classification Data";
     TIMER_START(write_intersections);
@@ -555,7 +975,8 @@ Extractor::BuildEdgeExpandedGraph(ScriptingEnvironment &scripting_environment,
  */
 void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_segments,
                            std::vector<bool> node_is_startpoint,
-                           const std::vector<util::Coordinate> &coordinates)
+                           const std::vector<util::Coordinate> &coordinates,
+                           const EdgeBasedNodeDataContainer &nodes_container)
 {
     util::Log() << "Constructing r-tree of " << edge_based_node_segments.size()
                 << " segments build on-top of " << coordinates.size() << " coordinates";
@@ -583,19 +1004,27 @@ void Extractor::BuildRTree(std::vector<EdgeBasedNodeSegment> edge_based_node_seg
                               SOURCE_REF);
     }
     edge_based_node_segments.resize(new_size);
+    std::vector<bool>().swap(node_is_startpoint);
 
+    // the tree releases the segments once they are sorted into runs on disk, its nodes
+    // record if there is a segment of a big component below them
     TIMER_START(construction);
-    util::StaticRTree<EdgeBasedNodeSegment> rtree(edge_based_node_segments,
-                                                  config.rtree_nodes_output_path,
-                                                  config.rtree_leafs_output_path,
-                                                  coordinates);
+    using RTree = util::StaticRTree<EdgeBasedNodeSegment>;
+    RTree rtree(std::move(edge_based_node_segments),
+                config.rtree_nodes_output_path,
+                config.rtree_leafs_output_path,
+                coordinates,
+                RTree::DEFAULT_ELEMENTS_PER_RUN,
+                [&nodes_container](const EdgeBasedNodeSegment &segment) {
+                    return nodes_container.GetComponentID(segment.forward_segment_id.id).is_tiny;
+                });
 
     TIMER_STOP(construction);
     util::Log() << "finished r-tree construction in " << TIMER_SEC(construction) << " seconds";
 }
 
 void Extractor::WriteCompressedNodeBasedGraph(const std::string &path,
-                                              const util::NodeBasedDynamicGraph &graph,
+                                              const util::NodeBasedStaticGraph &graph,
                                               const std::vector<util::Coordinate> &coordinates)
 {
     const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
@@ -636,5 +1065,30 @@ void Extractor::WriteCompressedNodeBasedGraph(const std::string &path,
     }
 }
 
+void Extractor::WriteTurnCostTable() const
+{
+    TIMER_START(turn_costs);
+    std::vector<TurnPenalty> turn_weight_penalties;
+    {
+        storage::io::FileReader reader(config.turn_weight_penalties_path,
+                                       storage::io::FileReader::VerifyFingerprint);
+        storage::serialization::read(reader, turn_weight_penalties);
+    }
+
+    boost::iostreams::mapped_file_source turn_index_region;
+    const auto turn_indexes = util::mmapFile<lookup::TurnIndexBlock>(
+        config.turn_penalties_index_path, turn_index_region);
+
+    const TurnCostTable turn_costs(turn_indexes, turn_weight_penalties);
+    files::writeTurnCostTable(config.turn_cost_table_path, turn_costs);
+    TIMER_STOP(turn_costs);
+
+    util::Log() << "Turn cost tables of " << turn_costs.GetNumberOfIntersections()
+                << " intersections take " << turn_costs.GetSizeInBytes() << " bytes, the "
+                << turn_indexes.size() << " edges of the edge-based graph take "
+                << turn_indexes.size() * sizeof(EdgeBasedEdge) << " bytes ("
+                << TIMER_SEC(turn_costs) << "s)";
+}
+
 } // namespace extractor
 } // namespace osrm
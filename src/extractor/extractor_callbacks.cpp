@@ -9,7 +9,9 @@
 
 #include "util/for_each_pair.hpp"
 #include "util/guidance/turn_lanes.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/name_table.hpp"
 
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/optional/optional.hpp>
@@ -19,6 +21,7 @@
 
 #include "osrm/coordinate.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <iterator>
 #include <limits>
@@ -43,42 +46,42 @@ ExtractorCallbacks::ExtractorCallbacks(ExtractionContainers &extraction_containe
       force_split_edges(properties.force_split_edges)
 {
     // we reserved 0, 1, 2, 3, 4 for the empty case
-    string_map[MapKey("", "", "", "", "")] = 0;
+    const std::string empty_key(4, '\0');
+    string_map.FindOrAdd(NameTable::MakeKey(empty_key), 0);
     lane_description_map.data[TurnLaneDescription()] = 0;
 }
 
 /**
  * Takes the node position from osmium and the filtered properties from the lua
- * profile and saves them to external memory.
- *
- * warning: caller needs to take care of synchronization!
+ * profile and saves them to the fragment.
  */
-void ExtractorCallbacks::ProcessNode(const osmium::Node &input_node,
-                                     const ExtractionNode &result_node)
+void ExtractorCallbacks::ProcessNode(Fragment &fragment,
+                                     const osmium::Node &input_node,
+                                     const ExtractionNode &result_node) const
 {
     const auto id = OSMNodeID{static_cast<std::uint64_t>(input_node.id())};
 
-    external_memory.all_nodes_list.push_back(
+    fragment.nodes.push_back(
         QueryNode{util::toFixed(util::UnsafeFloatLongitude{input_node.location().lon()}),
                   util::toFixed(util::UnsafeFloatLatitude{input_node.location().lat()}),
                   id});
 
     if (result_node.barrier)
     {
-        external_memory.barrier_nodes.push_back(id);
+        fragment.barrier_nodes.push_back(id);
     }
     if (result_node.traffic_lights)
     {
-        external_memory.traffic_lights.push_back(id);
+        fragment.traffic_lights.push_back(id);
     }
 }
 
 void ExtractorCallbacks::ProcessRestriction(
-    const boost::optional<InputRestrictionContainer> &restriction)
+    Fragment &fragment, const boost::optional<InputRestrictionContainer> &restriction) const
 {
     if (restriction)
     {
-        external_memory.restrictions_list.push_back(restriction.get());
+        fragment.restrictions.push_back(restriction.get());
         // util::Log() << "from: " << restriction.get().restriction.from.node <<
         //                           ",via: " << restriction.get().restriction.via.node <<
         //                           ", to: " << restriction.get().restriction.to.node <<
@@ -91,11 +94,11 @@ void ExtractorCallbacks::ProcessRestriction(
  * by the lua profile inside ```parsed_way``` and computes all edge segments.
  *
  * Depending on the forward/backwards weights the edges are split into forward
- * and backward edges.
- *
- * warning: caller needs to take care of synchronization!
+ * and backward edges. Names, turn lanes and classes get ids of the fragment.
  */
-void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const ExtractionWay &parsed_way)
+void ExtractorCallbacks::ProcessWay(Fragment &fragment,
+                                    const osmium::Way &input_way,
+                                    const ExtractionWay &parsed_way) const
 {
     if ((parsed_way.forward_travel_mode == TRAVEL_MODE_INACCESSIBLE ||
          parsed_way.forward_speed <= 0) &&
@@ -187,23 +190,18 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
         }
     }
 
-    const auto classStringToMask = [this](const std::string &class_name) {
-        auto iter = classes_map.find(class_name);
-        if (iter == classes_map.end())
+    const auto classStringToMask = [&fragment](const std::string &class_name) {
+        auto iter = std::find(fragment.classes.begin(), fragment.classes.end(), class_name);
+        if (iter == fragment.classes.end())
         {
-            if (classes_map.size() > MAX_CLASS_INDEX)
+            if (fragment.classes.size() > MAX_CLASS_INDEX)
             {
                 throw util::exception("Maximum number of classes if " +
                                       std::to_string(MAX_CLASS_INDEX + 1));
             }
-            ClassData class_mask = 1u << classes_map.size();
-            classes_map[class_name] = class_mask;
-            return class_mask;
-        }
-        else
-        {
-            return iter->second;
+            iter = fragment.classes.insert(iter, class_name);
         }
+        return ClassData{1u} << std::distance(fragment.classes.begin(), iter);
     };
     const auto classesToMask = [&](const auto &classes) {
         ClassData mask = 0;
@@ -288,74 +286,56 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
         return lane_description;
     };
 
-    // convert the lane description into an ID and, if necessary, remember the description in the
-    // description_map
+    // convert the lane description into an ID of the fragment and, if necessary, remember the
+    // description in the fragment
     const auto requestId = [&](const std::string &lane_string) {
         if (lane_string.empty())
             return INVALID_LANE_DESCRIPTIONID;
-        TurnLaneDescription lane_description = laneStringToDescription(std::move(lane_string));
 
-        return lane_description_map.ConcurrentFindOrAdd(lane_description);
+        const auto iter = fragment.lane_indices.find(lane_string);
+        if (iter != fragment.lane_indices.end())
+            return iter->second;
+
+        const auto id = static_cast<LaneDescriptionID>(fragment.lane_descriptions.size());
+        fragment.lane_descriptions.push_back(laneStringToDescription(lane_string));
+        fragment.lane_indices.emplace(lane_string, id);
+        return id;
     };
 
-    // Deduplicates street names, refs, destinations, pronunciation, exits.
-    // In case we do not already store the key, inserts (key, id) tuple and return id.
-    // Otherwise fetches the id based on the name and returns it without insertion.
     const auto turn_lane_id_forward = requestId(parsed_way.turn_lanes_forward);
     const auto turn_lane_id_backward = requestId(parsed_way.turn_lanes_backward);
 
     const auto road_classification = parsed_way.road_classification;
 
-    // Get the unique identifier for the street name, destination, and ref
-    const auto name_iterator = string_map.find(MapKey(parsed_way.name,
-                                                      parsed_way.destinations,
-                                                      parsed_way.ref,
-                                                      parsed_way.pronunciation,
-                                                      parsed_way.exits));
-    NameID name_id = EMPTY_NAMEID;
-    if (string_map.end() == name_iterator)
+    // Deduplicates street names, refs, destinations, pronunciation, exits with the names that
+    // were stored already. Names that are not known yet get an id in the fragment.
+    auto &name_key = fragment.name_key;
+    name_key.clear();
+    for (const auto *part : {&parsed_way.name,
+                             &parsed_way.destinations,
+                             &parsed_way.pronunciation,
+                             &parsed_way.ref,
+                             &parsed_way.exits})
     {
-        // name_offsets has a sentinel element with the total name data size
-        // take the sentinels index as the name id of the new name data pack
-        // (name [name_id], destination [+1], pronunciation [+2], ref [+3], exits [+4])
-        name_id = external_memory.name_offsets.size() - 1;
-
-        std::copy(parsed_way.name.begin(),
-                  parsed_way.name.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.destinations.begin(),
-                  parsed_way.destinations.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.pronunciation.begin(),
-                  parsed_way.pronunciation.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.ref.begin(),
-                  parsed_way.ref.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.exits.begin(),
-                  parsed_way.exits.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        auto k = MapKey{parsed_way.name,
-                        parsed_way.destinations,
-                        parsed_way.ref,
-                        parsed_way.pronunciation,
-                        parsed_way.exits};
-        auto v = MapVal{name_id};
-        string_map.emplace(std::move(k), std::move(v));
+        name_key.append(*part);
+        // nothing valid reads as a reference to another name, see util::NameTable
+        if (util::NameTable::IsReference(*part))
+            name_key[name_key.size() - part->size()] = '?';
+        name_key.push_back('\0');
+    }
+    name_key.pop_back();
+    const auto key = NameTable::MakeKey(name_key);
+    const NameID name_id = fragment.name_ids.size();
+    if (const auto stored_name_id = string_map.Find(key))
+    {
+        fragment.name_ids.push_back(*stored_name_id);
     }
     else
     {
-        name_id = name_iterator->second;
+        fragment.name_ids.push_back(INVALID_NAMEID);
+        fragment.name_hashes.push_back(key.hash);
+        fragment.name_offsets.push_back(fragment.name_data.size());
+        fragment.name_data.append(name_key);
     }
 
     const bool in_forward_direction =
@@ -382,7 +362,7 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
             nodes.cbegin(),
             nodes.cend(),
             [&](const osmium::NodeRef &first_node, const osmium::NodeRef &last_node) {
-                external_memory.all_edges_list.push_back(
+                fragment.edges.push_back(
                     InternalExtractorEdge(OSMNodeID{static_cast<std::uint64_t>(first_node.ref())},
                                           OSMNodeID{static_cast<std::uint64_t>(last_node.ref())},
                                           name_id,
@@ -409,7 +389,7 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
             nodes.cbegin(),
             nodes.cend(),
             [&](const osmium::NodeRef &first_node, const osmium::NodeRef &last_node) {
-                external_memory.all_edges_list.push_back(
+                fragment.edges.push_back(
                     InternalExtractorEdge(OSMNodeID{static_cast<std::uint64_t>(first_node.ref())},
                                           OSMNodeID{static_cast<std::uint64_t>(last_node.ref())},
                                           name_id,
@@ -432,17 +412,151 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
 
     std::transform(nodes.begin(),
                    nodes.end(),
-                   std::back_inserter(external_memory.used_node_id_list),
+                   std::back_inserter(fragment.used_node_ids),
                    [](const osmium::NodeRef &ref) {
                        return OSMNodeID{static_cast<std::uint64_t>(ref.ref())};
                    });
 
-    external_memory.way_start_end_id_list.push_back(
+    fragment.ways.push_back(
         {OSMWayID{static_cast<std::uint32_t>(input_way.id())},
          OSMNodeID{static_cast<std::uint64_t>(nodes[0].ref())},
          OSMNodeID{static_cast<std::uint64_t>(nodes[1].ref())},
          OSMNodeID{static_cast<std::uint64_t>(nodes[nodes.size() - 2].ref())},
          OSMNodeID{static_cast<std::uint64_t>(nodes.back().ref())}});
+    if (external_memory.way_index)
+        fragment.way_node_counts.push_back(static_cast<std::uint32_t>(nodes.size()));
+}
+
+/**
+ * Assigns the global ids to the names, turn lane descriptions and classes of the fragment and
+ * saves its nodes, edges and restrictions to external memory.
+ *
+ * warning: caller needs to take care of synchronization!
+ */
+void ExtractorCallbacks::Store(Fragment &fragment)
+{
+    std::size_t new_name = 0;
+    for (auto &name_id : fragment.name_ids)
+    {
+        if (name_id != INVALID_NAMEID)
+            continue;
+
+        const auto begin = fragment.name_offsets[new_name];
+        const auto end = new_name + 1 < fragment.name_offsets.size()
+                             ? fragment.name_offsets[new_name + 1]
+                             : fragment.name_data.size();
+        const NameTable::Key key{util::StringView(fragment.name_data.data() + begin, end - begin),
+                                 fragment.name_hashes[new_name]};
+        ++new_name;
+
+        // name_offsets has a sentinel element with the total name data size
+        // take the sentinels index as the name id of the new name data pack
+        // (name [name_id], destination [+1], pronunciation [+2], ref [+3], exits [+4])
+        const auto added = string_map.FindOrAdd(key, external_memory.name_offsets.size() - 1);
+        name_id = added.first;
+        if (added.second)
+        {
+            for (const auto character : key.string)
+            {
+                if (character == '\0')
+                    external_memory.name_offsets.push_back(external_memory.name_char_data.size());
+                else
+                    external_memory.name_char_data.push_back(character);
+            }
+            external_memory.name_offsets.push_back(external_memory.name_char_data.size());
+        }
+    }
+
+    std::vector<LaneDescriptionID> lane_description_ids;
+    lane_description_ids.reserve(fragment.lane_descriptions.size());
+    for (const auto &lane_description : fragment.lane_descriptions)
+    {
+        lane_description_ids.push_back(lane_description_map.ConcurrentFindOrAdd(lane_description));
+    }
+
+    std::vector<ClassData> class_masks;
+    class_masks.reserve(fragment.classes.size());
+    for (const auto &class_name : fragment.classes)
+    {
+        auto iter = classes_map.find(class_name);
+        if (iter == classes_map.end())
+        {
+            if (classes_map.size() > MAX_CLASS_INDEX)
+            {
+                throw util::exception("Maximum number of classes if " +
+                                      std::to_string(MAX_CLASS_INDEX + 1));
+            }
+            iter = classes_map.emplace(class_name, ClassData{1u} << classes_map.size()).first;
+        }
+        class_masks.push_back(iter->second);
+    }
+    const auto toGlobalClasses = [&class_masks](const ClassData local_classes) {
+        ClassData mask = 0;
+        for (const auto index : util::irange<std::size_t>(0, class_masks.size()))
+        {
+            if (local_classes & (ClassData{1u} << index))
+                mask |= class_masks[index];
+        }
+        return mask;
+    };
+
+    if (external_memory.node_locations)
+    {
+        for (const auto &node : fragment.nodes)
+            external_memory.node_locations->set(
+                static_cast<std::uint64_t>(node.node_id),
+                osmium::Location{static_cast<std::int32_t>(node.lon),
+                                 static_cast<std::int32_t>(node.lat)});
+    }
+    else
+    {
+        for (const auto &node : fragment.nodes)
+            external_memory.all_nodes_list.push_back(node);
+    }
+    external_memory.barrier_nodes.insert(external_memory.barrier_nodes.end(),
+                                         fragment.barrier_nodes.begin(),
+                                         fragment.barrier_nodes.end());
+    external_memory.traffic_lights.insert(external_memory.traffic_lights.end(),
+                                          fragment.traffic_lights.begin(),
+                                          fragment.traffic_lights.end());
+
+    for (auto &edge : fragment.edges)
+    {
+        edge.result.name_id = fragment.name_ids[edge.result.name_id];
+        if (edge.result.lane_description_id != INVALID_LANE_DESCRIPTIONID)
+        {
+            edge.result.lane_description_id = lane_description_ids[edge.result.lane_description_id];
+        }
+        if (edge.result.classes != 0)
+        {
+            edge.result.classes = toGlobalClasses(edge.result.classes);
+        }
+        external_memory.all_edges_list.push_back(edge);
+    }
+    for (const auto &node_id : fragment.used_node_ids)
+        external_memory.used_node_id_list.push_back(node_id);
+    for (const auto &way : fragment.ways)
+        external_memory.way_start_end_id_list.push_back(way);
+
+    if (external_memory.way_index)
+    {
+        BOOST_ASSERT(fragment.way_node_counts.size() == fragment.ways.size());
+        auto node_id = fragment.used_node_ids.begin();
+        for (const auto index : util::irange<std::size_t>(0, fragment.ways.size()))
+        {
+            const auto count = fragment.way_node_counts[index];
+            external_memory.way_nodes_list.push_back(
+                WayNodes{fragment.ways[index].way_id,
+                         external_memory.way_node_id_list.size(),
+                         count});
+            for (const auto end = node_id + count; node_id != end; ++node_id)
+                external_memory.way_node_id_list.push_back(*node_id);
+        }
+    }
+
+    external_memory.restrictions_list.insert(external_memory.restrictions_list.end(),
+                                             fragment.restrictions.begin(),
+                                             fragment.restrictions.end());
 }
 
 } // namespace extractor
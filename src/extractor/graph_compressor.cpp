@@ -8,11 +8,617 @@
 
 #include "util/log.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
 namespace osrm
 {
 namespace extractor
 {
 
+namespace
+{
+using EdgeData = util::NodeBasedDynamicGraph::EdgeData;
+
+//    reverse_e2   forward_e2
+// u <---------- v -----------> w
+//    ----------> <-----------
+//    forward_e1   reverse_e1
+//
+// Will be compressed to:
+//
+//    reverse_e1
+// u <---------- w
+//    ---------->
+//    forward_e1
+struct CompressionEdges
+{
+    NodeID node_u;
+    NodeID node_w;
+    EdgeID forward_e1;
+    EdgeID forward_e2;
+    EdgeID reverse_e1;
+    EdgeID reverse_e2;
+};
+
+// Finds the edges of a degree 2 node, the edges into it are looked up with find_edge(from, to)
+template <typename FindEdge>
+CompressionEdges getCompressionEdges(const util::NodeBasedDynamicGraph &graph,
+                                     const NodeID node_v,
+                                     FindEdge find_edge)
+{
+    BOOST_ASSERT(2 == graph.GetOutDegree(node_v));
+
+    const bool reverse_edge_order = graph.GetEdgeData(graph.BeginEdges(node_v)).reversed;
+    const EdgeID forward_e2 = graph.BeginEdges(node_v) + reverse_edge_order;
+    BOOST_ASSERT(SPECIAL_EDGEID != forward_e2);
+    BOOST_ASSERT(forward_e2 >= graph.BeginEdges(node_v) && forward_e2 < graph.EndEdges(node_v));
+    const EdgeID reverse_e2 = graph.BeginEdges(node_v) + 1 - reverse_edge_order;
+    BOOST_ASSERT(SPECIAL_EDGEID != reverse_e2);
+    BOOST_ASSERT(reverse_e2 >= graph.BeginEdges(node_v) && reverse_e2 < graph.EndEdges(node_v));
+
+    const NodeID node_w = graph.GetTarget(forward_e2);
+    BOOST_ASSERT(SPECIAL_NODEID != node_w);
+    BOOST_ASSERT(node_v != node_w);
+    const NodeID node_u = graph.GetTarget(reverse_e2);
+    BOOST_ASSERT(SPECIAL_NODEID != node_u);
+    BOOST_ASSERT(node_u != node_v);
+
+    const EdgeID forward_e1 = find_edge(node_u, node_v);
+    BOOST_ASSERT(SPECIAL_EDGEID != forward_e1);
+    BOOST_ASSERT(node_v == graph.GetTarget(forward_e1));
+    const EdgeID reverse_e1 = find_edge(node_w, node_v);
+    BOOST_ASSERT(SPECIAL_EDGEID != reverse_e1);
+    BOOST_ASSERT(node_v == graph.GetTarget(reverse_e1));
+
+    return {node_u, node_w, forward_e1, forward_e2, reverse_e1, reverse_e2};
+}
+
+bool canCombine(const util::NodeBasedDynamicGraph &graph, const CompressionEdges &edges)
+{
+    const EdgeData &fwd_edge_data1 = graph.GetEdgeData(edges.forward_e1);
+    const EdgeData &fwd_edge_data2 = graph.GetEdgeData(edges.forward_e2);
+    const EdgeData &rev_edge_data1 = graph.GetEdgeData(edges.reverse_e1);
+    const EdgeData &rev_edge_data2 = graph.GetEdgeData(edges.reverse_e2);
+
+    // this case can happen if two ways with different names overlap
+    if (fwd_edge_data1.name_id != rev_edge_data1.name_id ||
+        fwd_edge_data2.name_id != rev_edge_data2.name_id)
+    {
+        return false;
+    }
+
+    return fwd_edge_data1.CanCombineWith(fwd_edge_data2) &&
+           rev_edge_data1.CanCombineWith(rev_edge_data2);
+}
+
+// The checks of a node that do not depend on the compression of other nodes
+bool isCompressibleNode(const std::unordered_set<NodeID> &barrier_nodes,
+                        const RestrictionMap &restriction_map,
+                        const util::NodeBasedDynamicGraph &graph,
+                        const NodeID node_v)
+{
+    // only contract degree 2 vertices
+    if (2 != graph.GetOutDegree(node_v))
+    {
+        return false;
+    }
+
+    // don't contract barrier node
+    if (barrier_nodes.end() != barrier_nodes.find(node_v))
+    {
+        return false;
+    }
+
+    // check if v is a via node for a turn restriction, i.e. a 'directed' barrier node
+    if (restriction_map.IsViaNode(node_v))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// Compresses v if its edges are compatible, the graph modifications that are not confined to the
+// edges around v are left to the update: deleting the edges of v, fixing up turn restrictions and
+// storing the compressed geometry.
+template <typename Update>
+void compressNode(const std::unordered_set<NodeID> &traffic_lights,
+                  util::NodeBasedDynamicGraph &graph,
+                  const NodeID node_v,
+                  const CompressionEdges &edges,
+                  Update &update)
+{
+    if (!canCombine(graph, edges))
+    {
+        return;
+    }
+
+    const NodeID node_u = edges.node_u;
+    const NodeID node_w = edges.node_w;
+    const EdgeData &fwd_edge_data1 = graph.GetEdgeData(edges.forward_e1);
+    const EdgeData &fwd_edge_data2 = graph.GetEdgeData(edges.forward_e2);
+    const EdgeData &rev_edge_data1 = graph.GetEdgeData(edges.reverse_e1);
+    const EdgeData &rev_edge_data2 = graph.GetEdgeData(edges.reverse_e2);
+
+    BOOST_ASSERT(fwd_edge_data1.name_id == rev_edge_data1.name_id);
+    BOOST_ASSERT(fwd_edge_data2.name_id == rev_edge_data2.name_id);
+
+    /*
+     * Remember Lane Data for compressed parts. This handles scenarios where lane-data
+     * is
+     * only kept up until a traffic light.
+     *
+     *                |    |
+     * ----------------    |
+     *         -^ |        |
+     * -----------         |
+     *         -v |        |
+     * ---------------     |
+     *                |    |
+     *
+     *  u ------- v ---- w
+     *
+     * Since the edge is compressable, we can transfer:
+     * "left|right" (uv) and "" (uw) into a string with "left|right" (uw) for the
+     * compressed
+     * edge.
+     * Doing so, we might mess up the point from where the lanes are shown. It should be
+     * reasonable, since the announcements have to come early anyhow. So there is a
+     * potential danger in here, but it saves us from adding a lot of additional edges
+     * for
+     * turn-lanes. Without this,we would have to treat any turn-lane beginning/ending
+     * just
+     * like a barrier.
+     */
+    const auto selectLaneID = [](const LaneDescriptionID front, const LaneDescriptionID back) {
+        // A lane has tags: u - (front) - v - (back) - w
+        // During contraction, we keep only one of the tags. Usually the one closer to
+        // the
+        // intersection is preferred. If its empty, however, we keep the non-empty one
+        if (back == INVALID_LANE_DESCRIPTIONID)
+            return front;
+        return back;
+    };
+    graph.GetEdgeData(edges.forward_e1).lane_description_id =
+        selectLaneID(fwd_edge_data1.lane_description_id, fwd_edge_data2.lane_description_id);
+    graph.GetEdgeData(edges.reverse_e1).lane_description_id =
+        selectLaneID(rev_edge_data1.lane_description_id, rev_edge_data2.lane_description_id);
+    graph.GetEdgeData(edges.forward_e2).lane_description_id =
+        selectLaneID(fwd_edge_data2.lane_description_id, fwd_edge_data1.lane_description_id);
+    graph.GetEdgeData(edges.reverse_e2).lane_description_id =
+        selectLaneID(rev_edge_data2.lane_description_id, rev_edge_data1.lane_description_id);
+
+    // Do not compress edge if it crosses a traffic signal.
+    // This can't be done in CanCombineWith, becase we only store the
+    // traffic signals in the `traffic_lights` list, which EdgeData
+    // doesn't have access to.
+    const bool has_node_penalty = traffic_lights.find(node_v) != traffic_lights.end();
+    if (has_node_penalty)
+        return;
+
+    // Get weights before graph is modified
+    const auto forward_weight1 = fwd_edge_data1.weight;
+    const auto forward_weight2 = fwd_edge_data2.weight;
+    const auto forward_duration1 = fwd_edge_data1.duration;
+    const auto forward_duration2 = fwd_edge_data2.duration;
+
+    BOOST_ASSERT(0 != forward_weight1);
+    BOOST_ASSERT(0 != forward_weight2);
+
+    const auto reverse_weight1 = rev_edge_data1.weight;
+    const auto reverse_weight2 = rev_edge_data2.weight;
+    const auto reverse_duration1 = rev_edge_data1.duration;
+    const auto reverse_duration2 = rev_edge_data2.duration;
+
+    BOOST_ASSERT(0 != reverse_weight1);
+    BOOST_ASSERT(0 != reverse_weight2);
+
+    // add weight of e2's to e1
+    graph.GetEdgeData(edges.forward_e1).weight += forward_weight2;
+    graph.GetEdgeData(edges.reverse_e1).weight += reverse_weight2;
+
+    // add duration of e2's to e1
+    graph.GetEdgeData(edges.forward_e1).duration += forward_duration2;
+    graph.GetEdgeData(edges.reverse_e1).duration += reverse_duration2;
+
+    // extend e1's to targets of e2's
+    graph.SetTarget(edges.forward_e1, node_w);
+    graph.SetTarget(edges.reverse_e1, node_u);
+
+    // remove e2's (if bidir, otherwise only one)
+    update.DeleteEdges(node_v, edges.forward_e2, edges.reverse_e2);
+
+    // update any involved turn restrictions
+    update.FixupTurnRestrictions(node_u, node_v, node_w);
+
+    // store compressed geometry in container
+    update.CompressEdge(edges.forward_e1,
+                        edges.forward_e2,
+                        node_v,
+                        node_w,
+                        forward_weight1,
+                        forward_weight2,
+                        forward_duration1,
+                        forward_duration2);
+    update.CompressEdge(edges.reverse_e1,
+                        edges.reverse_e2,
+                        node_v,
+                        node_u,
+                        reverse_weight1,
+                        reverse_weight2,
+                        reverse_duration1,
+                        reverse_duration2);
+}
+
+// Applies the compression of a node directly
+struct DirectUpdate
+{
+    void DeleteEdges(const NodeID node_v, const EdgeID forward_e2, const EdgeID reverse_e2)
+    {
+        graph.DeleteEdge(node_v, forward_e2);
+        graph.DeleteEdge(node_v, reverse_e2);
+    }
+
+    void FixupTurnRestrictions(const NodeID node_u, const NodeID node_v, const NodeID node_w)
+    {
+        restriction_map.FixupStartingTurnRestriction(node_u, node_v, node_w);
+        restriction_map.FixupArrivingTurnRestriction(node_u, node_v, node_w, graph);
+
+        restriction_map.FixupStartingTurnRestriction(node_w, node_v, node_u);
+        restriction_map.FixupArrivingTurnRestriction(node_w, node_v, node_u, graph);
+    }
+
+    void CompressEdge(const EdgeID edge_id_1,
+                      const EdgeID edge_id_2,
+                      const NodeID via_node_id,
+                      const NodeID target_node_id,
+                      const EdgeWeight weight1,
+                      const EdgeWeight weight2,
+                      const EdgeDuration duration1,
+                      const EdgeDuration duration2)
+    {
+        geometry_compressor.CompressEdge(edge_id_1,
+                                         edge_id_2,
+                                         via_node_id,
+                                         target_node_id,
+                                         weight1,
+                                         weight2,
+                                         duration1,
+                                         duration2);
+    }
+
+    util::NodeBasedDynamicGraph &graph;
+    RestrictionMap &restriction_map;
+    CompressedEdgeContainer &geometry_compressor;
+};
+
+// Records the modifications of the compression of a chain that touch shared state, they are
+// applied after the chains of a batch are compressed. Deleting the edges of a node is deferred
+// as well since it changes the edge count of the graph.
+struct ChainUpdate
+{
+    struct CompressedEdge
+    {
+        EdgeID edge_id_1;
+        EdgeID edge_id_2;
+        NodeID via_node_id;
+        NodeID target_node_id;
+        EdgeWeight weight1;
+        EdgeWeight weight2;
+        EdgeDuration duration1;
+        EdgeDuration duration2;
+    };
+
+    struct DeletedEdges
+    {
+        NodeID node_v;
+        EdgeID forward_e2;
+        EdgeID reverse_e2;
+    };
+
+    void DeleteEdges(const NodeID node_v, const EdgeID forward_e2, const EdgeID reverse_e2)
+    {
+        deleted_edges.push_back({node_v, forward_e2, reverse_e2});
+    }
+
+    // the chains compressed in parallel contain neither sources nor via nodes of restrictions
+    void FixupTurnRestrictions(const NodeID, const NodeID, const NodeID) {}
+
+    void CompressEdge(const EdgeID edge_id_1,
+                      const EdgeID edge_id_2,
+                      const NodeID via_node_id,
+                      const NodeID target_node_id,
+                      const EdgeWeight weight1,
+                      const EdgeWeight weight2,
+                      const EdgeDuration duration1,
+                      const EdgeDuration duration2)
+    {
+        compressed_edges.push_back({edge_id_1,
+                                    edge_id_2,
+                                    via_node_id,
+                                    target_node_id,
+                                    weight1,
+                                    weight2,
+                                    duration1,
+                                    duration2});
+    }
+
+    void Apply(util::NodeBasedDynamicGraph &graph, CompressedEdgeContainer &geometry_compressor)
+    {
+        for (const auto &edge : compressed_edges)
+        {
+            geometry_compressor.CompressEdge(edge.edge_id_1,
+                                             edge.edge_id_2,
+                                             edge.via_node_id,
+                                             edge.target_node_id,
+                                             edge.weight1,
+                                             edge.weight2,
+                                             edge.duration1,
+                                             edge.duration2);
+        }
+        for (const auto &edges : deleted_edges)
+        {
+            graph.DeleteEdge(edges.node_v, edges.forward_e2);
+            graph.DeleteEdge(edges.node_v, edges.reverse_e2);
+        }
+        compressed_edges.clear();
+        deleted_edges.clear();
+    }
+
+    std::vector<CompressedEdge> compressed_edges;
+    std::vector<DeletedEdges> deleted_edges;
+    // nodes of the current chain, reused between chains
+    std::vector<NodeID> chain_nodes;
+};
+
+// Maximal path of chain nodes between the nodes first_endpoint and last_endpoint that are not
+// chain nodes. The entry edges are the edges of the endpoints into the chain.
+struct Chain
+{
+    NodeID first_node;
+    NodeID first_endpoint;
+    NodeID last_endpoint;
+    EdgeID first_entry;
+    EdgeID last_entry;
+    bool has_restriction_source;
+};
+
+// The other neighbour of a chain node
+NodeID nextChainNode(const util::NodeBasedDynamicGraph &graph,
+                     const NodeID node,
+                     const NodeID previous)
+{
+    const auto edge = graph.BeginEdges(node);
+    const auto target = graph.GetTarget(edge);
+    return target == previous ? graph.GetTarget(edge + 1) : target;
+}
+
+// Chain nodes pass all checks of the compression that do not depend on other nodes being
+// compressed before. Edges of compressed nodes keep the data of the edge that survives, so along
+// a chain all edges are compatible independent of the order of compression.
+std::vector<std::uint8_t> findChainNodes(const std::unordered_set<NodeID> &barrier_nodes,
+                                         const RestrictionMap &restriction_map,
+                                         const util::NodeBasedDynamicGraph &graph)
+{
+    std::vector<std::uint8_t> is_chain_node(graph.GetNumberOfNodes(), false);
+    tbb::parallel_for(
+        tbb::blocked_range<NodeID>(0, graph.GetNumberOfNodes()),
+        [&](const tbb::blocked_range<NodeID> &range) {
+            for (auto node_v = range.begin(); node_v != range.end(); ++node_v)
+            {
+                if (!isCompressibleNode(barrier_nodes, restriction_map, graph, node_v))
+                    continue;
+
+                const auto first_target = graph.GetTarget(graph.BeginEdges(node_v));
+                const auto second_target = graph.GetTarget(graph.BeginEdges(node_v) + 1);
+                if (first_target == second_target)
+                    continue;
+
+                const auto find_edge = [&graph](const NodeID from, const NodeID to) {
+                    return graph.FindEdge(from, to);
+                };
+                is_chain_node[node_v] =
+                    canCombine(graph, getCompressionEdges(graph, node_v, find_edge));
+            }
+        });
+    return is_chain_node;
+}
+
+// Walks all chains from their ends, every chain is found from both ends and kept from the end
+// with the smaller node id.
+std::vector<Chain> findChains(const std::vector<std::uint8_t> &is_chain_node,
+                              const RestrictionMap &restriction_map,
+                              const util::NodeBasedDynamicGraph &graph)
+{
+    tbb::enumerable_thread_specific<std::vector<Chain>> thread_chains;
+    tbb::parallel_for(
+        tbb::blocked_range<NodeID>(0, graph.GetNumberOfNodes()),
+        [&](const tbb::blocked_range<NodeID> &range) {
+            auto &chains = thread_chains.local();
+            for (auto head = range.begin(); head != range.end(); ++head)
+            {
+                if (!is_chain_node[head])
+                    continue;
+
+                const auto first_edge = graph.BeginEdges(head);
+                NodeID first_endpoint = graph.GetTarget(first_edge);
+                if (is_chain_node[first_endpoint])
+                {
+                    first_endpoint = graph.GetTarget(first_edge + 1);
+                    if (is_chain_node[first_endpoint])
+                        continue;
+                }
+
+                NodeID previous = first_endpoint;
+                NodeID current = head;
+                NodeID next = nextChainNode(graph, current, previous);
+                bool has_restriction_source = restriction_map.IsSourceNode(head);
+                while (is_chain_node[next])
+                {
+                    previous = current;
+                    current = next;
+                    next = nextChainNode(graph, current, previous);
+                    has_restriction_source |= restriction_map.IsSourceNode(current);
+                }
+
+                if (current < head)
+                    continue;
+
+                chains.push_back({head,
+                                  first_endpoint,
+                                  next,
+                                  graph.FindEdge(first_endpoint, head),
+                                  graph.FindEdge(next, current),
+                                  has_restriction_source});
+            }
+        });
+
+    std::vector<Chain> chains;
+    for (const auto &local_chains : thread_chains)
+    {
+        chains.insert(chains.end(), local_chains.begin(), local_chains.end());
+    }
+    return chains;
+}
+
+// Keeps the chains whose compression does not depend on other chains or on turn restrictions.
+// Chains between the same endpoints, loops and chains parallel to an edge between their
+// endpoints are compressed depending on the order of their nodes. Chains that start at a via node
+// or contain the source of a restriction have to update the restrictions.
+void removeDependentChains(const RestrictionMap &restriction_map,
+                           const util::NodeBasedDynamicGraph &graph,
+                           std::vector<Chain> &chains)
+{
+    const auto endpoints = [](const Chain &chain) {
+        return std::make_pair(std::min(chain.first_endpoint, chain.last_endpoint),
+                              std::max(chain.first_endpoint, chain.last_endpoint));
+    };
+    tbb::parallel_sort(chains.begin(), chains.end(), [&](const Chain &lhs, const Chain &rhs) {
+        return std::make_tuple(endpoints(lhs), lhs.first_node) <
+               std::make_tuple(endpoints(rhs), rhs.first_node);
+    });
+
+    std::vector<std::uint8_t> is_independent(chains.size());
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, chains.size()),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (auto index = range.begin(); index != range.end(); ++index)
+            {
+                const auto &chain = chains[index];
+                const auto shares_endpoints =
+                    (index > 0 && endpoints(chains[index - 1]) == endpoints(chain)) ||
+                    (index + 1 < chains.size() &&
+                     endpoints(chains[index + 1]) == endpoints(chain));
+                is_independent[index] =
+                    chain.first_endpoint != chain.last_endpoint && !shares_endpoints &&
+                    !chain.has_restriction_source &&
+                    !restriction_map.IsViaNode(chain.first_endpoint) &&
+                    !restriction_map.IsViaNode(chain.last_endpoint) &&
+                    graph.FindEdgeInEitherDirection(chain.first_endpoint, chain.last_endpoint) ==
+                        SPECIAL_EDGEID;
+            }
+        });
+
+    std::size_t index = 0;
+    chains.erase(std::remove_if(chains.begin(),
+                                chains.end(),
+                                [&](const Chain &) { return !is_independent[index++]; }),
+                 chains.end());
+}
+
+// Compresses the nodes of the chain in the order of their ids like the serial compression does.
+// All edges that are modified belong to the chain: the edges of its nodes and the entry edges.
+void compressChain(const std::unordered_set<NodeID> &traffic_lights,
+                   util::NodeBasedDynamicGraph &graph,
+                   const Chain &chain,
+                   std::vector<std::uint8_t> &compressed_in_parallel,
+                   ChainUpdate &update)
+{
+    auto &nodes = update.chain_nodes;
+    nodes.clear();
+    NodeID previous = chain.first_endpoint;
+    for (NodeID node = chain.first_node; node != chain.last_endpoint;)
+    {
+        nodes.push_back(node);
+        const auto next = nextChainNode(graph, node, previous);
+        previous = node;
+        node = next;
+    }
+    std::sort(nodes.begin(), nodes.end());
+
+    // edges of chain nodes are only deleted after the chain, they still point to their
+    // neighbours in the chain until those are compressed
+    const auto find_edge = [&](const NodeID from, const NodeID to) {
+        if (from == chain.first_endpoint)
+            return chain.first_entry;
+        if (from == chain.last_endpoint)
+            return chain.last_entry;
+        const auto first_edge = graph.BeginEdges(from);
+        return graph.GetTarget(first_edge) == to ? first_edge : first_edge + 1;
+    };
+
+    for (const auto node_v : nodes)
+    {
+        compressed_in_parallel[node_v] = true;
+        const auto edges = getCompressionEdges(graph, node_v, find_edge);
+        compressNode(traffic_lights, graph, node_v, edges, update);
+    }
+}
+
+// Compresses the independent chains in parallel and returns the nodes that were handled, the
+// result is the same as if they were compressed one by one in the order of their ids.
+std::vector<std::uint8_t>
+compressIndependentChains(const std::unordered_set<NodeID> &barrier_nodes,
+                          const std::unordered_set<NodeID> &traffic_lights,
+                          const RestrictionMap &restriction_map,
+                          util::NodeBasedDynamicGraph &graph,
+                          CompressedEdgeContainer &geometry_compressor)
+{
+    auto chains = findChains(
+        findChainNodes(barrier_nodes, restriction_map, graph), restriction_map, graph);
+    const auto number_of_chains = chains.size();
+    removeDependentChains(restriction_map, graph, chains);
+    util::Log() << "Compressing " << chains.size() << " of " << number_of_chains
+                << " chains in parallel";
+
+    std::vector<std::uint8_t> compressed_in_parallel(graph.GetNumberOfNodes(), false);
+    tbb::enumerable_thread_specific<ChainUpdate> updates;
+
+    // the geometry is added to the container after every batch to bound the memory of the
+    // recorded updates
+    constexpr std::size_t CHAIN_BATCH_SIZE = 64 * 1024;
+    for (std::size_t batch_begin = 0; batch_begin < chains.size(); batch_begin += CHAIN_BATCH_SIZE)
+    {
+        const auto batch_end = std::min(chains.size(), batch_begin + CHAIN_BATCH_SIZE);
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(batch_begin, batch_end),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                auto &update = updates.local();
+                for (auto index = range.begin(); index != range.end(); ++index)
+                {
+                    compressChain(
+                        traffic_lights, graph, chains[index], compressed_in_parallel, update);
+                }
+            });
+
+        for (auto &update : updates)
+        {
+            update.Apply(graph, geometry_compressor);
+        }
+    }
+
+    return compressed_in_parallel;
+}
+}
+
 void GraphCompressor::Compress(const std::unordered_set<NodeID> &barrier_nodes,
                                const std::unordered_set<NodeID> &traffic_lights,
                                RestrictionMap &restriction_map,
@@ -22,207 +628,37 @@ void GraphCompressor::Compress(const std::unordered_set<NodeID> &barrier_nodes,
     const unsigned original_number_of_nodes = graph.GetNumberOfNodes();
     const unsigned original_number_of_edges = graph.GetNumberOfEdges();
 
+    // Most degree 2 nodes are on chains that can be compressed independently of each other,
+    // the remaining nodes are compressed one by one.
+    const auto compressed_in_parallel = compressIndependentChains(
+        barrier_nodes, traffic_lights, restriction_map, graph, geometry_compressor);
+
     {
         util::UnbufferedLog log;
         util::Percent progress(log, original_number_of_nodes);
 
+        DirectUpdate update{graph, restriction_map, geometry_compressor};
         for (const NodeID node_v : util::irange(0u, original_number_of_nodes))
         {
             progress.PrintStatus(node_v);
 
-            // only contract degree 2 vertices
-            if (2 != graph.GetOutDegree(node_v))
+            if (compressed_in_parallel[node_v] ||
+                !isCompressibleNode(barrier_nodes, restriction_map, graph, node_v))
             {
                 continue;
             }
 
-            // don't contract barrier node
-            if (barrier_nodes.end() != barrier_nodes.find(node_v))
-            {
-                continue;
-            }
-
-            // check if v is a via node for a turn restriction, i.e. a 'directed' barrier node
-            if (restriction_map.IsViaNode(node_v))
-            {
-                continue;
-            }
+            const auto edges =
+                getCompressionEdges(graph, node_v, [&graph](const NodeID from, const NodeID to) {
+                    return graph.FindEdge(from, to);
+                });
 
-            //    reverse_e2   forward_e2
-            // u <---------- v -----------> w
-            //    ----------> <-----------
-            //    forward_e1   reverse_e1
-            //
-            // Will be compressed to:
-            //
-            //    reverse_e1
-            // u <---------- w
-            //    ---------->
-            //    forward_e1
-            //
-            // If the edges are compatible.
-            const bool reverse_edge_order = graph.GetEdgeData(graph.BeginEdges(node_v)).reversed;
-            const EdgeID forward_e2 = graph.BeginEdges(node_v) + reverse_edge_order;
-            BOOST_ASSERT(SPECIAL_EDGEID != forward_e2);
-            BOOST_ASSERT(forward_e2 >= graph.BeginEdges(node_v) &&
-                         forward_e2 < graph.EndEdges(node_v));
-            const EdgeID reverse_e2 = graph.BeginEdges(node_v) + 1 - reverse_edge_order;
-            BOOST_ASSERT(SPECIAL_EDGEID != reverse_e2);
-            BOOST_ASSERT(reverse_e2 >= graph.BeginEdges(node_v) &&
-                         reverse_e2 < graph.EndEdges(node_v));
-
-            const EdgeData &fwd_edge_data2 = graph.GetEdgeData(forward_e2);
-            const EdgeData &rev_edge_data2 = graph.GetEdgeData(reverse_e2);
-
-            const NodeID node_w = graph.GetTarget(forward_e2);
-            BOOST_ASSERT(SPECIAL_NODEID != node_w);
-            BOOST_ASSERT(node_v != node_w);
-            const NodeID node_u = graph.GetTarget(reverse_e2);
-            BOOST_ASSERT(SPECIAL_NODEID != node_u);
-            BOOST_ASSERT(node_u != node_v);
-
-            const EdgeID forward_e1 = graph.FindEdge(node_u, node_v);
-            BOOST_ASSERT(SPECIAL_EDGEID != forward_e1);
-            BOOST_ASSERT(node_v == graph.GetTarget(forward_e1));
-            const EdgeID reverse_e1 = graph.FindEdge(node_w, node_v);
-            BOOST_ASSERT(SPECIAL_EDGEID != reverse_e1);
-            BOOST_ASSERT(node_v == graph.GetTarget(reverse_e1));
-
-            const EdgeData &fwd_edge_data1 = graph.GetEdgeData(forward_e1);
-            const EdgeData &rev_edge_data1 = graph.GetEdgeData(reverse_e1);
-
-            if (graph.FindEdgeInEitherDirection(node_u, node_w) != SPECIAL_EDGEID)
+            if (graph.FindEdgeInEitherDirection(edges.node_u, edges.node_w) != SPECIAL_EDGEID)
             {
                 continue;
             }
 
-            // this case can happen if two ways with different names overlap
-            if (fwd_edge_data1.name_id != rev_edge_data1.name_id ||
-                fwd_edge_data2.name_id != rev_edge_data2.name_id)
-            {
-                continue;
-            }
-
-            if (fwd_edge_data1.CanCombineWith(fwd_edge_data2) &&
-                rev_edge_data1.CanCombineWith(rev_edge_data2))
-            {
-                BOOST_ASSERT(graph.GetEdgeData(forward_e1).name_id ==
-                             graph.GetEdgeData(reverse_e1).name_id);
-                BOOST_ASSERT(graph.GetEdgeData(forward_e2).name_id ==
-                             graph.GetEdgeData(reverse_e2).name_id);
-
-                /*
-                 * Remember Lane Data for compressed parts. This handles scenarios where lane-data
-                 * is
-                 * only kept up until a traffic light.
-                 *
-                 *                |    |
-                 * ----------------    |
-                 *         -^ |        |
-                 * -----------         |
-                 *         -v |        |
-                 * ---------------     |
-                 *                |    |
-                 *
-                 *  u ------- v ---- w
-                 *
-                 * Since the edge is compressable, we can transfer:
-                 * "left|right" (uv) and "" (uw) into a string with "left|right" (uw) for the
-                 * compressed
-                 * edge.
-                 * Doing so, we might mess up the point from where the lanes are shown. It should be
-                 * reasonable, since the announcements have to come early anyhow. So there is a
-                 * potential danger in here, but it saves us from adding a lot of additional edges
-                 * for
-                 * turn-lanes. Without this,we would have to treat any turn-lane beginning/ending
-                 * just
-                 * like a barrier.
-                 */
-                const auto selectLaneID = [](const LaneDescriptionID front,
-                                             const LaneDescriptionID back) {
-                    // A lane has tags: u - (front) - v - (back) - w
-                    // During contraction, we keep only one of the tags. Usually the one closer to
-                    // the
-                    // intersection is preferred. If its empty, however, we keep the non-empty one
-                    if (back == INVALID_LANE_DESCRIPTIONID)
-                        return front;
-                    return back;
-                };
-                graph.GetEdgeData(forward_e1).lane_description_id = selectLaneID(
-                    fwd_edge_data1.lane_description_id, fwd_edge_data2.lane_description_id);
-                graph.GetEdgeData(reverse_e1).lane_description_id = selectLaneID(
-                    rev_edge_data1.lane_description_id, rev_edge_data2.lane_description_id);
-                graph.GetEdgeData(forward_e2).lane_description_id = selectLaneID(
-                    fwd_edge_data2.lane_description_id, fwd_edge_data1.lane_description_id);
-                graph.GetEdgeData(reverse_e2).lane_description_id = selectLaneID(
-                    rev_edge_data2.lane_description_id, rev_edge_data1.lane_description_id);
-
-                // Do not compress edge if it crosses a traffic signal.
-                // This can't be done in CanCombineWith, becase we only store the
-                // traffic signals in the `traffic_lights` list, which EdgeData
-                // doesn't have access to.
-                const bool has_node_penalty = traffic_lights.find(node_v) != traffic_lights.end();
-                if (has_node_penalty)
-                    continue;
-
-                // Get weights before graph is modified
-                const auto forward_weight1 = fwd_edge_data1.weight;
-                const auto forward_weight2 = fwd_edge_data2.weight;
-                const auto forward_duration1 = fwd_edge_data1.duration;
-                const auto forward_duration2 = fwd_edge_data2.duration;
-
-                BOOST_ASSERT(0 != forward_weight1);
-                BOOST_ASSERT(0 != forward_weight2);
-
-                const auto reverse_weight1 = rev_edge_data1.weight;
-                const auto reverse_weight2 = rev_edge_data2.weight;
-                const auto reverse_duration1 = rev_edge_data1.duration;
-                const auto reverse_duration2 = rev_edge_data2.duration;
-
-                BOOST_ASSERT(0 != reverse_weight1);
-                BOOST_ASSERT(0 != reverse_weight2);
-
-                // add weight of e2's to e1
-                graph.GetEdgeData(forward_e1).weight += forward_weight2;
-                graph.GetEdgeData(reverse_e1).weight += reverse_weight2;
-
-                // add duration of e2's to e1
-                graph.GetEdgeData(forward_e1).duration += forward_duration2;
-                graph.GetEdgeData(reverse_e1).duration += reverse_duration2;
-
-                // extend e1's to targets of e2's
-                graph.SetTarget(forward_e1, node_w);
-                graph.SetTarget(reverse_e1, node_u);
-
-                // remove e2's (if bidir, otherwise only one)
-                graph.DeleteEdge(node_v, forward_e2);
-                graph.DeleteEdge(node_v, reverse_e2);
-
-                // update any involved turn restrictions
-                restriction_map.FixupStartingTurnRestriction(node_u, node_v, node_w);
-                restriction_map.FixupArrivingTurnRestriction(node_u, node_v, node_w, graph);
-
-                restriction_map.FixupStartingTurnRestriction(node_w, node_v, node_u);
-                restriction_map.FixupArrivingTurnRestriction(node_w, node_v, node_u, graph);
-
-                // store compressed geometry in container
-                geometry_compressor.CompressEdge(forward_e1,
-                                                 forward_e2,
-                                                 node_v,
-                                                 node_w,
-                                                 forward_weight1,
-                                                 forward_weight2,
-                                                 forward_duration1,
-                                                 forward_duration2);
-                geometry_compressor.CompressEdge(reverse_e1,
-                                                 reverse_e2,
-                                                 node_v,
-                                                 node_u,
-                                                 reverse_weight1,
-                                                 reverse_weight2,
-                                                 reverse_duration1,
-                                                 reverse_duration2);
-            }
+            compressNode(traffic_lights, graph, node_v, edges, update);
         }
     }
 
@@ -58,7 +58,7 @@ double GetOffsetCorrectionFactor(const RoadClassification &road_classification)
 }
 
 CoordinateExtractor::CoordinateExtractor(
-    const util::NodeBasedDynamicGraph &node_based_graph,
+    const util::NodeBasedStaticGraph &node_based_graph,
     const extractor::CompressedEdgeContainer &compressed_geometries,
     const std::vector<util::Coordinate> &node_coordinates)
     : node_based_graph(node_based_graph), compressed_geometries(compressed_geometries),
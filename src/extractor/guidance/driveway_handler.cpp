@@ -13,7 +13,7 @@ namespace guidance
 {
 
 DrivewayHandler::DrivewayHandler(const IntersectionGenerator &intersection_generator,
-                                 const util::NodeBasedDynamicGraph &node_based_graph,
+                                 const util::NodeBasedStaticGraph &node_based_graph,
                                  const std::vector<util::Coordinate> &coordinates,
                                  const util::NameTable &name_table,
                                  const SuffixTable &street_name_suffix_table)
@@ -32,7 +32,7 @@ const constexpr bool USE_HIGH_PRECISION_MODE = !USE_LOW_PRECISION_MODE;
 }
 
 IntersectionGenerator::IntersectionGenerator(
-    const util::NodeBasedDynamicGraph &node_based_graph,
+    const util::NodeBasedStaticGraph &node_based_graph,
     const RestrictionMap &restriction_map,
     const std::unordered_set<NodeID> &barrier_nodes,
     const std::vector<util::Coordinate> &coordinates,
@@ -53,6 +53,39 @@ IntersectionShape
 IntersectionGenerator::ComputeIntersectionShape(const NodeID node_at_center_of_intersection,
                                                 const boost::optional<NodeID> sorting_base,
                                                 const bool use_low_precision_angles) const
+{
+    IntersectionShape intersection =
+        shape_caches.local().Get(node_at_center_of_intersection, use_low_precision_angles, [&] {
+            return ComputeUnsortedIntersectionShape(node_at_center_of_intersection,
+                                                    use_low_precision_angles);
+        });
+
+    if (!intersection.empty())
+    {
+        const auto base_bearing = [&]() {
+            if (sorting_base)
+            {
+                const auto itr =
+                    std::find_if(intersection.begin(),
+                                 intersection.end(),
+                                 [&](const IntersectionShapeData &data) {
+                                     return node_based_graph.GetTarget(data.eid) == *sorting_base;
+                                 });
+                if (itr != intersection.end())
+                    return util::bearing::reverse(itr->bearing);
+            }
+            return util::bearing::reverse(intersection.begin()->bearing);
+        }();
+        std::sort(intersection.begin(),
+                  intersection.end(),
+                  makeCompareShapeDataAngleToBearing(base_bearing));
+    }
+
+    return intersection;
+}
+
+IntersectionShape IntersectionGenerator::ComputeUnsortedIntersectionShape(
+    const NodeID node_at_center_of_intersection, const bool use_low_precision_angles) const
 {
     IntersectionShape intersection;
     // reserve enough items (+ the possibly missing u-turn edge)
@@ -126,27 +159,6 @@ IntersectionGenerator::ComputeIntersectionShape(const NodeID node_at_center_of_i
         intersection.push_back({edge_connected_to_intersection, bearing, segment_length});
     }
 
-    if (!intersection.empty())
-    {
-        const auto base_bearing = [&]() {
-            if (sorting_base)
-            {
-                const auto itr =
-                    std::find_if(intersection.begin(),
-                                 intersection.end(),
-                                 [&](const IntersectionShapeData &data) {
-                                     return node_based_graph.GetTarget(data.eid) == *sorting_base;
-                                 });
-                if (itr != intersection.end())
-                    return util::bearing::reverse(itr->bearing);
-            }
-            return util::bearing::reverse(intersection.begin()->bearing);
-        }();
-        std::sort(intersection.begin(),
-                  intersection.end(),
-                  makeCompareShapeDataAngleToBearing(base_bearing));
-    }
-
     return intersection;
 }
 
@@ -421,6 +433,17 @@ const CoordinateExtractor &IntersectionGenerator::GetCoordinateExtractor() const
     return coordinate_extractor;
 }
 
+std::pair<std::size_t, std::size_t> IntersectionGenerator::GetShapeCacheStatistics() const
+{
+    std::pair<std::size_t, std::size_t> statistics{0, 0};
+    for (const auto &cache : shape_caches)
+    {
+        statistics.first += cache.hits;
+        statistics.second += cache.misses;
+    }
+    return statistics;
+}
+
 } // namespace guidance
 } // namespace extractor
 } // namespace osrm
@@ -11,7 +11,7 @@
 #include <algorithm>
 #include <cstddef>
 
-using EdgeData = osrm::util::NodeBasedDynamicGraph::EdgeData;
+using EdgeData = osrm::util::NodeBasedStaticGraph::EdgeData;
 using osrm::extractor::guidance::getTurnDirection;
 using osrm::util::angularDeviation;
 
@@ -30,7 +30,7 @@ inline bool requiresAnnouncement(const EdgeData &from, const EdgeData &to)
 }
 }
 
-IntersectionHandler::IntersectionHandler(const util::NodeBasedDynamicGraph &node_based_graph,
+IntersectionHandler::IntersectionHandler(const util::NodeBasedStaticGraph &node_based_graph,
                                          const std::vector<util::Coordinate> &coordinates,
                                          const util::NameTable &name_table,
                                          const SuffixTable &street_name_suffix_table,
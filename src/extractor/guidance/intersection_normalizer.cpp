@@ -14,7 +14,7 @@ namespace extractor
 namespace guidance
 {
 
-IntersectionNormalizer::IntersectionNormalizer(const util::NodeBasedDynamicGraph &node_based_graph,
+IntersectionNormalizer::IntersectionNormalizer(const util::NodeBasedStaticGraph &node_based_graph,
                                                const std::vector<util::Coordinate> &coordinates,
                                                const util::NameTable &name_table,
                                                const SuffixTable &street_name_suffix_table,
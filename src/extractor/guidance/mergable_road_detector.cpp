@@ -24,7 +24,7 @@ namespace
 {
 // check a connected road for equality of a name
 inline auto makeCheckRoadForName(const NameID name_id,
-                                 const util::NodeBasedDynamicGraph &node_based_graph,
+                                 const util::NodeBasedStaticGraph &node_based_graph,
                                  const util::NameTable &name_table,
                                  const SuffixTable &suffix_table)
 {
@@ -43,7 +43,7 @@ inline auto makeCheckRoadForName(const NameID name_id,
 }
 }
 
-MergableRoadDetector::MergableRoadDetector(const util::NodeBasedDynamicGraph &node_based_graph,
+MergableRoadDetector::MergableRoadDetector(const util::NodeBasedStaticGraph &node_based_graph,
                                            const std::vector<util::Coordinate> &node_coordinates,
                                            const IntersectionGenerator &intersection_generator,
                                            const CoordinateExtractor &coordinate_extractor,
@@ -14,7 +14,7 @@ namespace guidance
 {
 
 // ---------------------------------------------------------------------------------
-NodeBasedGraphWalker::NodeBasedGraphWalker(const util::NodeBasedDynamicGraph &node_based_graph,
+NodeBasedGraphWalker::NodeBasedGraphWalker(const util::NodeBasedStaticGraph &node_based_graph,
                                            const IntersectionGenerator &intersection_generator)
     : node_based_graph(node_based_graph), intersection_generator(intersection_generator)
 {
@@ -64,7 +64,7 @@ boost::optional<EdgeID> SelectRoadByNameOnlyChoiceAndStraightness::
 operator()(const NodeID /*nid*/,
            const EdgeID /*via_edge_id*/,
            const IntersectionView &intersection,
-           const util::NodeBasedDynamicGraph &node_based_graph) const
+           const util::NodeBasedStaticGraph &node_based_graph) const
 {
     BOOST_ASSERT(!intersection.empty());
     const auto comparator = [this, &node_based_graph](const IntersectionViewData &lhs,
@@ -108,7 +108,7 @@ boost::optional<EdgeID> SelectStraightmostRoadByNameAndOnlyChoice::
 operator()(const NodeID /*nid*/,
            const EdgeID /*via_edge_id*/,
            const IntersectionView &intersection,
-           const util::NodeBasedDynamicGraph &node_based_graph) const
+           const util::NodeBasedStaticGraph &node_based_graph) const
 {
     BOOST_ASSERT(!intersection.empty());
     if (intersection.size() == 1)
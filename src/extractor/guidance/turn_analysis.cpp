@@ -19,14 +19,14 @@ namespace extractor
 namespace guidance
 {
 
-using EdgeData = util::NodeBasedDynamicGraph::EdgeData;
+using EdgeData = util::NodeBasedStaticGraph::EdgeData;
 
 bool requiresAnnouncement(const EdgeData &from, const EdgeData &to)
 {
     return !from.CanCombineWith(to);
 }
 
-TurnAnalysis::TurnAnalysis(const util::NodeBasedDynamicGraph &node_based_graph,
+TurnAnalysis::TurnAnalysis(const util::NodeBasedStaticGraph &node_based_graph,
                            const std::vector<util::Coordinate> &coordinates,
                            const RestrictionMap &restriction_map,
                            const std::unordered_set<NodeID> &barrier_nodes,
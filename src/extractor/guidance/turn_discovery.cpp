@@ -23,7 +23,7 @@ bool findPreviousIntersection(const NodeID node_v,
                               const EdgeID via_edge,
                               const Intersection &intersection,
                               const IntersectionGenerator &intersection_generator,
-                              const util::NodeBasedDynamicGraph &node_based_graph,
+                              const util::NodeBasedStaticGraph &node_based_graph,
                               // output parameters
                               NodeID &result_node,
                               EdgeID &result_via_edge,
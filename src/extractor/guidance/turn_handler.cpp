@@ -110,7 +110,7 @@ std::size_t TurnHandler::Fork::getLeftIndex() const
     return std::distance(intersection_base, end) - 1;
 }
 
-TurnHandler::TurnHandler(const util::NodeBasedDynamicGraph &node_based_graph,
+TurnHandler::TurnHandler(const util::NodeBasedStaticGraph &node_based_graph,
                          const std::vector<util::Coordinate> &coordinates,
                          const util::NameTable &name_table,
                          const SuffixTable &street_name_suffix_table,
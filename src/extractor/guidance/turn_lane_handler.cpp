@@ -33,7 +33,7 @@ std::size_t getNumberOfTurns(const Intersection &intersection)
 }
 } // namespace
 
-TurnLaneHandler::TurnLaneHandler(const util::NodeBasedDynamicGraph &node_based_graph,
+TurnLaneHandler::TurnLaneHandler(const util::NodeBasedStaticGraph &node_based_graph,
                                  LaneDescriptionMap &lane_description_map,
                                  const TurnAnalysis &turn_analysis,
                                  util::guidance::LaneDataIdMap &id_map)
@@ -0,0 +1,55 @@
+#include "extractor/native_turn_penalties.hpp"
+
+#include <cmath>
+
+namespace osrm
+{
+namespace extractor
+{
+
+NativeTurnPenalties::NativeTurnPenalties(const double turn_penalty,
+                                         const double turn_bias,
+                                         const double traffic_light_penalty,
+                                         const double u_turn_penalty,
+                                         const ProfileProperties &properties)
+    : turn_penalty(turn_penalty), turn_bias(turn_bias),
+      traffic_light_penalty(traffic_light_penalty), u_turn_penalty(u_turn_penalty),
+      max_turn_weight(properties.GetMaxTurnWeight()),
+      distance_weight(properties.GetWeightName() == "distance"),
+      routability_weight(properties.GetWeightName() == "routability")
+{
+}
+
+// Keep the order of the operations of turn_function in profiles/car.lua, the penalties have to
+// match the ones computed by Lua bit by bit
+void NativeTurnPenalties::Apply(ExtractionTurn &turn) const
+{
+    if (turn.has_traffic_light)
+        turn.duration = traffic_light_penalty;
+
+    if (turn.turn_type != guidance::TurnType::NoTurn)
+    {
+        if (turn.angle >= 0)
+        {
+            turn.duration += turn_penalty / (1 + std::exp(-((13 / turn_bias) * turn.angle / 180 -
+                                                            6.5 * turn_bias)));
+        }
+        else
+        {
+            turn.duration += turn_penalty / (1 + std::exp(-((13 * turn_bias) * -turn.angle / 180 -
+                                                            6.5 / turn_bias)));
+        }
+
+        if (turn.direction_modifier == guidance::DirectionModifier::UTurn)
+            turn.duration += u_turn_penalty;
+    }
+
+    // for distance based routing there are no penalties based on the turn angle
+    turn.weight = distance_weight ? 0 : turn.duration;
+
+    // penalize turns from non-local access only segments onto local access only tags
+    if (routability_weight && !turn.source_restricted && turn.target_restricted)
+        turn.weight = max_turn_weight;
+}
+}
+}
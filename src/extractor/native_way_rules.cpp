@@ -0,0 +1,138 @@
+#include "extractor/native_way_rules.hpp"
+
+#include <osmium/osm/tag.hpp>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace osrm
+{
+namespace extractor
+{
+
+namespace
+{
+const char *getValue(const osmium::TagList &tags, const char *key)
+{
+    const auto value = tags.get_value_by_key(key);
+    return value && *value ? value : nullptr;
+}
+
+void insertSorted(std::vector<std::string> &values, std::string value)
+{
+    const auto position = std::lower_bound(values.begin(), values.end(), value);
+    if (position == values.end() || *position != value)
+        values.insert(position, std::move(value));
+}
+
+bool containsValue(const std::vector<std::string> &values, const char *value)
+{
+    if (!value)
+        return false;
+    return std::binary_search(values.begin(),
+                              values.end(),
+                              value,
+                              [](const auto &lhs, const auto &rhs) {
+                                  return std::strcmp(&lhs[0], &rhs[0]) < 0;
+                              });
+}
+}
+
+void NativeWayRules::AddRequiredKey(std::string key) { required_keys.push_back(std::move(key)); }
+
+void NativeWayRules::AddBlockedTag(std::string key, std::string value)
+{
+    blocked_tags.push_back({std::move(key), std::move(value)});
+}
+
+void NativeWayRules::AddSpeedTag(std::string key, std::string value)
+{
+    speed_tags.push_back({std::move(key), std::move(value)});
+}
+
+void NativeWayRules::AddAccessKey(std::string key)
+{
+    access_keys.push_back(key);
+    access_keys.push_back(key + ":forward");
+    access_keys.push_back(key + ":backward");
+}
+
+void NativeWayRules::AddBlacklistedAccess(std::string value)
+{
+    insertSorted(blacklisted_access, std::move(value));
+}
+
+void NativeWayRules::AddRestrictedAccess(std::string value)
+{
+    insertSorted(restricted_access, std::move(value));
+}
+
+void NativeWayRules::AddRestrictedHighway(std::string value)
+{
+    insertSorted(restricted_highways, std::move(value));
+}
+
+bool NativeWayRules::IsRestricted(const char *highway, const char *access) const
+{
+    return containsValue(restricted_highways, highway) && containsValue(restricted_access, access);
+}
+
+bool NativeWayRules::Rejects(const osmium::TagList &tags) const
+{
+    BOOST_ASSERT(!Empty());
+
+    if (std::none_of(required_keys.begin(), required_keys.end(), [&](const auto &key) {
+            return getValue(tags, key.c_str()) != nullptr;
+        }))
+    {
+        return true;
+    }
+
+    for (const auto &tag : blocked_tags)
+    {
+        const auto value = getValue(tags, tag.key.c_str());
+        if (value && tag.value == value)
+            return true;
+    }
+
+    // same search as Tags.get_forward_backward_by_set of the profiles
+    const char *forward = nullptr;
+    const char *backward = nullptr;
+    for (auto key = access_keys.begin(); key != access_keys.end(); key += 3)
+    {
+        forward = forward ? forward : getValue(tags, key[1].c_str());
+        backward = backward ? backward : getValue(tags, key[2].c_str());
+        if (!forward || !backward)
+        {
+            const auto common = getValue(tags, key[0].c_str());
+            forward = forward ? forward : common;
+            backward = backward ? backward : common;
+        }
+        if (forward && backward)
+            break;
+    }
+
+    const auto highway = getValue(tags, "highway");
+    const auto blocks = [&](const char *access) {
+        return containsValue(blacklisted_access, access) && !IsRestricted(highway, access);
+    };
+    if (blocks(forward) && blocks(backward))
+        return true;
+
+    if (!forward && !backward && std::none_of(speed_tags.begin(),
+                                              speed_tags.end(),
+                                              [&](const auto &tag) {
+                                                  const auto value =
+                                                      getValue(tags, tag.key.c_str());
+                                                  return value && tag.value == value;
+                                              }))
+    {
+        return true;
+    }
+
+    return false;
+}
+}
+}
@@ -0,0 +1,115 @@
+#include "extractor/osm_change_merger.hpp"
+
+#include "util/log.hpp"
+
+#include <osmium/io/any_input.hpp>
+#include <osmium/osm/object.hpp>
+#include <osmium/osm/object_comparisons.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace osrm
+{
+namespace extractor
+{
+
+namespace
+{
+// the order of sorted OSM files, see osmium::object_order_type_id_version
+bool isBefore(const osmium::OSMObject &lhs, const osmium::OSMObject &rhs)
+{
+    return std::make_tuple(lhs.type(), lhs.id() < 0, lhs.positive_id()) <
+           std::make_tuple(rhs.type(), rhs.id() < 0, rhs.positive_id());
+}
+}
+
+OSMChangeMerger::OSMChangeMerger(osmium::memory::Buffer changes_) : buffer(std::move(changes_))
+{
+    for (const auto &object : buffer.select<osmium::OSMObject>())
+    {
+        changes.push_back(&object);
+    }
+
+    // the newest version wins, of equal versions the one of the last change file
+    std::reverse(changes.begin(), changes.end());
+    std::stable_sort(
+        changes.begin(), changes.end(), osmium::object_order_type_id_reverse_version());
+    changes.erase(std::unique(changes.begin(), changes.end(), osmium::object_equal_type_id()),
+                  changes.end());
+}
+
+osmium::memory::Buffer
+OSMChangeMerger::ReadChanges(const std::vector<boost::filesystem::path> &paths)
+{
+    osmium::memory::Buffer changes(1024 * 1024, osmium::memory::Buffer::auto_grow::yes);
+    for (const auto &path : paths)
+    {
+        util::Log() << "Reading changes from " << path.filename().string();
+        // the versions are needed to order the changes, so metadata is always read
+        osmium::io::Reader reader(osmium::io::File(path.string()), osmium::io::read_meta::yes);
+        while (auto read_buffer = reader.read())
+        {
+            changes.add_buffer(read_buffer);
+            changes.commit();
+        }
+        reader.close();
+    }
+    return changes;
+}
+
+void OSMChangeMerger::CopyChangesBefore(osmium::memory::Buffer &output,
+                                        const osmium::OSMObject *object)
+{
+    for (; next_change < changes.size() && (!object || isBefore(*changes[next_change], *object));
+         ++next_change)
+    {
+        if (changes[next_change]->visible())
+        {
+            output.add_item(*changes[next_change]);
+            output.commit();
+        }
+    }
+}
+
+osmium::memory::Buffer OSMChangeMerger::Merge(osmium::memory::Buffer input)
+{
+    if (next_change == changes.size())
+        return input;
+
+    const osmium::OSMObject *last = nullptr;
+    for (const auto &object : input.select<osmium::OSMObject>())
+    {
+        last = &object;
+    }
+    if (!last || isBefore(*last, *changes[next_change]))
+        return input;
+
+    osmium::memory::Buffer output(input.committed(), osmium::memory::Buffer::auto_grow::yes);
+    for (const auto &object : input.select<osmium::OSMObject>())
+    {
+        CopyChangesBefore(output, &object);
+
+        if (next_change < changes.size() && !isBefore(object, *changes[next_change]))
+        {
+            if (changes[next_change]->visible())
+                output.add_item(*changes[next_change]);
+            ++next_change;
+        }
+        else
+        {
+            output.add_item(object);
+        }
+        output.commit();
+    }
+    return output;
+}
+
+osmium::memory::Buffer OSMChangeMerger::Finish()
+{
+    osmium::memory::Buffer output(1024 * 1024, osmium::memory::Buffer::auto_grow::yes);
+    CopyChangesBefore(output, nullptr);
+    return output;
+}
+}
+}
@@ -7,12 +7,109 @@
 #include "util/typedefs.hpp"
 
 #include <cmath>
+#include <map>
 
 namespace osrm
 {
 namespace extractor
 {
 
+constexpr std::size_t TiledRasterGrid::DEFAULT_TILE_SIZE;
+constexpr std::size_t TiledRasterGrid::DEFAULT_CACHE_SIZE;
+
+void TiledRasterGrid::Write(const boost::filesystem::path &filepath,
+                            const RasterGrid &grid,
+                            const std::size_t tile_size)
+{
+    BOOST_ASSERT(tile_size > 0);
+    const Header header{grid.GetWidth(), grid.GetHeight(), tile_size};
+    if (grid.GetSize() < header.width * header.height)
+    {
+        throw util::exception("Raster source has " + std::to_string(grid.GetSize()) +
+                              " values, expected " + std::to_string(header.width) + "x" +
+                              std::to_string(header.height) + SOURCE_REF);
+    }
+
+    storage::io::FileWriter writer(filepath, storage::io::FileWriter::GenerateFingerprint);
+    writer.WriteOne(header);
+
+    Tile tile(tile_size * tile_size);
+    for (std::size_t tile_y = 0; tile_y * tile_size < header.height; ++tile_y)
+    {
+        for (std::size_t tile_x = 0; tile_x * tile_size < header.width; ++tile_x)
+        {
+            std::fill(tile.begin(), tile.end(), 0);
+            for (std::size_t y = tile_y * tile_size;
+                 y < std::min<std::size_t>((tile_y + 1) * tile_size, header.height);
+                 ++y)
+            {
+                for (std::size_t x = tile_x * tile_size;
+                     x < std::min<std::size_t>((tile_x + 1) * tile_size, header.width);
+                     ++x)
+                {
+                    tile[(y % tile_size) * tile_size + (x % tile_size)] = grid(x, y);
+                }
+            }
+            writer.WriteFrom(tile);
+        }
+    }
+}
+
+TiledRasterGrid::TiledRasterGrid(const boost::filesystem::path &filepath_,
+                                 const std::size_t cache_size)
+    : filepath(filepath_), tiles(cache_size, std::min<std::size_t>(cache_size, 16))
+{
+    {
+        storage::io::FileReader reader(filepath, storage::io::FileReader::VerifyFingerprint);
+        header = reader.ReadOne<Header>();
+    }
+    if (header.tile_size == 0 || header.width == 0 || header.height == 0)
+    {
+        throw util::exception("Invalid tiled raster source " + filepath.string() + SOURCE_REF);
+    }
+    tiles_per_row = (header.width + header.tile_size - 1) / header.tile_size;
+
+    file.open(filepath, std::ios::binary);
+    if (!file)
+    {
+        throw util::exception("Failed to open tiled raster source " + filepath.string() +
+                              SOURCE_REF);
+    }
+}
+
+std::shared_ptr<const TiledRasterGrid::Tile>
+TiledRasterGrid::GetTile(const std::size_t tile_x, const std::size_t tile_y) const
+{
+    const auto tile_index = tile_y * tiles_per_row + tile_x;
+    if (auto cached = tiles.Get(tile_index))
+        return *cached;
+
+    const auto tile_length = header.tile_size * header.tile_size;
+    auto tile = std::make_shared<Tile>(tile_length);
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        file.seekg(sizeof(util::FingerPrint) + sizeof(Header) +
+                   tile_index * tile_length * sizeof(std::int32_t));
+        file.read(reinterpret_cast<char *>(tile->data()), tile_length * sizeof(std::int32_t));
+        if (!file)
+        {
+            throw util::exception("Failed to read tile " + std::to_string(tile_index) + " of " +
+                                  filepath.string() + SOURCE_REF);
+        }
+    }
+    // two threads missing the same tile both read it, the later one replaces the first copy
+    tiles.Put(tile_index, tile);
+    return tile;
+}
+
+std::int32_t TiledRasterGrid::operator()(const std::size_t x, const std::size_t y) const
+{
+    BOOST_ASSERT(x < header.width && y < header.height);
+    const auto tile_size = header.tile_size;
+    const auto tile = GetTile(x / tile_size, y / tile_size);
+    return (*tile)[(y % tile_size) * tile_size + (x % tile_size)];
+}
+
 RasterSource::RasterSource(RasterGrid _raster_data,
                            std::size_t _width,
                            std::size_t _height,
@@ -28,6 +125,20 @@ RasterSource::RasterSource(RasterGrid _raster_data,
     BOOST_ASSERT(ystep != 0);
 }
 
+RasterSource::RasterSource(std::shared_ptr<const TiledRasterGrid> _tiled_data,
+                           int _xmin,
+                           int _xmax,
+                           int _ymin,
+                           int _ymax)
+    : xstep(CalcSize(_xmin, _xmax, _tiled_data->GetWidth())),
+      ystep(CalcSize(_ymin, _ymax, _tiled_data->GetHeight())), tiled_data(std::move(_tiled_data)),
+      width(tiled_data->GetWidth()), height(tiled_data->GetHeight()), xmin(_xmin), xmax(_xmax),
+      ymin(_ymin), ymax(_ymax)
+{
+    BOOST_ASSERT(xstep != 0);
+    BOOST_ASSERT(ystep != 0);
+}
+
 float RasterSource::CalcSize(int min, int max, std::size_t count) const
 {
     BOOST_ASSERT(count > 0);
@@ -45,7 +156,7 @@ RasterDatum RasterSource::GetRasterData(const int lon, const int lat) const
     const std::size_t xth = static_cast<std::size_t>(round((lon - xmin) / xstep));
     const std::size_t yth = static_cast<std::size_t>(round((ymax - lat) / ystep));
 
-    return {raster_data(xth, yth)};
+    return {GetValue(xth, yth)};
 }
 
 // Query raster source using bilinear interpolation
@@ -72,10 +183,10 @@ RasterDatum RasterSource::GetRasterInterpolate(const int lon, const int lat) con
     const float fromRight = 1 - fromLeft;
     const float fromBottom = 1 - fromTop;
 
-    return {static_cast<std::int32_t>(raster_data(left, top) * (fromRight * fromBottom) +
-                                      raster_data(right, top) * (fromLeft * fromBottom) +
-                                      raster_data(left, bottom) * (fromRight * fromTop) +
-                                      raster_data(right, bottom) * (fromLeft * fromTop))};
+    return {static_cast<std::int32_t>(GetValue(left, top) * (fromRight * fromBottom) +
+                                      GetValue(right, top) * (fromLeft * fromBottom) +
+                                      GetValue(left, bottom) * (fromRight * fromTop) +
+                                      GetValue(right, bottom) * (fromLeft * fromTop))};
 }
 
 // Load raster source into memory
@@ -124,6 +235,57 @@ int SourceContainer::LoadRasterSource(const std::string &path_string,
     return source_id;
 }
 
+std::shared_ptr<const TiledRasterGrid>
+SourceContainer::OpenTiledRasterGrid(const std::string &path)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const TiledRasterGrid>> grids;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto grid = grids[path].lock();
+    if (!grid)
+    {
+        grid = std::make_shared<const TiledRasterGrid>(path);
+        grids[path] = grid;
+    }
+    return grid;
+}
+
+// Load the header of a tiled raster source, the tiles are read on demand
+int SourceContainer::LoadTiledRasterSource(
+    const std::string &path_string, double xmin, double xmax, double ymin, double ymax)
+{
+    const auto _xmin = static_cast<std::int32_t>(util::toFixed(util::FloatLongitude{xmin}));
+    const auto _xmax = static_cast<std::int32_t>(util::toFixed(util::FloatLongitude{xmax}));
+    const auto _ymin = static_cast<std::int32_t>(util::toFixed(util::FloatLatitude{ymin}));
+    const auto _ymax = static_cast<std::int32_t>(util::toFixed(util::FloatLatitude{ymax}));
+
+    const auto itr = LoadedSourcePaths.find(path_string);
+    if (itr != LoadedSourcePaths.end())
+    {
+        util::Log() << "[source loader] Already loaded source '" << path_string << "' at source_id "
+                    << itr->second;
+        return itr->second;
+    }
+
+    int source_id = static_cast<int>(LoadedSources.size());
+
+    util::Log() << "[source loader] Opening tiles of " << path_string << "  ... ";
+
+    boost::filesystem::path filepath(path_string);
+    if (!boost::filesystem::exists(filepath))
+    {
+        throw util::RuntimeError(
+            path_string, ErrorCode::FileOpenError, SOURCE_REF, "File not found");
+    }
+
+    RasterSource source{OpenTiledRasterGrid(path_string), _xmin, _xmax, _ymin, _ymax};
+    LoadedSourcePaths.emplace(path_string, source_id);
+    LoadedSources.push_back(std::move(source));
+
+    return source_id;
+}
+
 // External function for looking up nearest data point from a specified source
 RasterDatum SourceContainer::GetRasterDataFromSource(unsigned int source_id, double lon, double lat)
 {
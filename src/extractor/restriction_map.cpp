@@ -1,11 +1,15 @@
 #include "extractor/restriction_map.hpp"
 
+#include <algorithm>
+#include <utility>
+
 namespace osrm
 {
 namespace extractor
 {
 
-RestrictionMap::RestrictionMap(const std::vector<TurnRestriction> &restriction_list) : m_count(0)
+RestrictionMap::RestrictionMap(const std::vector<TurnRestriction> &restriction_list)
+    : m_count(0), m_compacted(false)
 {
     // decompose restriction consisting of a start, via and end node into a
     // a pair of starting edge and a list of all end nodes
@@ -53,8 +57,74 @@ RestrictionMap::RestrictionMap(const std::vector<TurnRestriction> &restriction_l
     }
 }
 
+void RestrictionMap::Compact()
+{
+    BOOST_ASSERT(!m_compacted);
+
+    std::vector<std::pair<RestrictionSource, unsigned>> sources(m_restriction_map.begin(),
+                                                                m_restriction_map.end());
+    std::sort(sources.begin(), sources.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    m_sources.reserve(sources.size());
+    m_target_offsets.reserve(sources.size() + 1);
+    m_target_offsets.push_back(0);
+    for (const auto &source : sources)
+    {
+        const auto &bucket = m_restriction_bucket_list[source.second];
+        m_sources.push_back(source.first);
+        m_targets.insert(m_targets.end(), bucket.begin(), bucket.end());
+        m_target_offsets.push_back(m_targets.size());
+    }
+
+    const auto toBitVector = [](const std::unordered_set<NodeID> &nodes) {
+        const auto max_node = std::max_element(nodes.begin(), nodes.end());
+        std::vector<bool> is_contained(max_node == nodes.end() ? 0 : *max_node + 1);
+        for (const auto node : nodes)
+            is_contained[node] = true;
+        return is_contained;
+    };
+    m_is_start_node = toBitVector(m_restriction_start_nodes);
+    m_is_via_node = toBitVector(m_no_turn_via_node_set);
+
+    // free the memory of the hash tables
+    decltype(m_restriction_bucket_list)().swap(m_restriction_bucket_list);
+    decltype(m_restriction_map)().swap(m_restriction_map);
+    decltype(m_restriction_start_nodes)().swap(m_restriction_start_nodes);
+    decltype(m_no_turn_via_node_set)().swap(m_no_turn_via_node_set);
+
+    m_compacted = true;
+}
+
+RestrictionMap::TargetRange RestrictionMap::GetTargets(const NodeID node_u,
+                                                       const NodeID node_v) const
+{
+    if (m_compacted)
+    {
+        const RestrictionSource source{node_u, node_v};
+        const auto iter = std::lower_bound(m_sources.begin(), m_sources.end(), source);
+        if (iter == m_sources.end() || !(*iter == source))
+            return {nullptr, nullptr};
+
+        const auto index = std::distance(m_sources.begin(), iter);
+        return {m_targets.data() + m_target_offsets[index],
+                m_targets.data() + m_target_offsets[index + 1]};
+    }
+
+    const auto restriction_iter = m_restriction_map.find({node_u, node_v});
+    if (restriction_iter == m_restriction_map.end())
+        return {nullptr, nullptr};
+
+    const auto &bucket = m_restriction_bucket_list.at(restriction_iter->second);
+    return {bucket.data(), bucket.data() + bucket.size()};
+}
+
 bool RestrictionMap::IsViaNode(const NodeID node) const
 {
+    if (m_compacted)
+        return node < m_is_via_node.size() && m_is_via_node[node];
+
     return m_no_turn_via_node_set.find(node) != m_no_turn_via_node_set.end();
 }
 
@@ -66,6 +136,7 @@ void RestrictionMap::FixupStartingTurnRestriction(const NodeID node_u,
     BOOST_ASSERT(node_u != SPECIAL_NODEID);
     BOOST_ASSERT(node_v != SPECIAL_NODEID);
     BOOST_ASSERT(node_w != SPECIAL_NODEID);
+    BOOST_ASSERT(!m_compacted);
 
     if (!IsSourceNode(node_v))
     {
@@ -97,17 +168,11 @@ NodeID RestrictionMap::CheckForEmanatingIsOnlyTurn(const NodeID node_u, const No
         return SPECIAL_NODEID;
     }
 
-    const auto restriction_iter = m_restriction_map.find({node_u, node_v});
-    if (restriction_iter != m_restriction_map.end())
+    for (const RestrictionTarget &restriction_target : GetTargets(node_u, node_v))
     {
-        const unsigned index = restriction_iter->second;
-        const auto &bucket = m_restriction_bucket_list.at(index);
-        for (const RestrictionTarget &restriction_target : bucket)
+        if (restriction_target.is_only)
         {
-            if (restriction_target.is_only)
-            {
-                return restriction_target.target_node;
-            }
+            return restriction_target.target_node;
         }
     }
     return SPECIAL_NODEID;
@@ -127,16 +192,7 @@ bool RestrictionMap::CheckIfTurnIsRestricted(const NodeID node_u,
         return false;
     }
 
-    const auto restriction_iter = m_restriction_map.find({node_u, node_v});
-    if (restriction_iter == m_restriction_map.end())
-    {
-        return false;
-    }
-
-    const unsigned index = restriction_iter->second;
-    const auto &bucket = m_restriction_bucket_list.at(index);
-
-    for (const RestrictionTarget &restriction_target : bucket)
+    for (const RestrictionTarget &restriction_target : GetTargets(node_u, node_v))
     {
         if (node_w == restriction_target.target_node && // target found
             !restriction_target.is_only)                // and not an only_-restr.
@@ -153,6 +209,9 @@ bool RestrictionMap::CheckIfTurnIsRestricted(const NodeID node_u,
 // check of node is the start of any restriction
 bool RestrictionMap::IsSourceNode(const NodeID node) const
 {
+    if (m_compacted)
+        return node < m_is_start_node.size() && m_is_start_node[node];
+
     return m_restriction_start_nodes.find(node) != m_restriction_start_nodes.end();
 }
 }
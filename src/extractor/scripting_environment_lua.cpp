@@ -6,14 +6,18 @@
 #include "extractor/extraction_turn.hpp"
 #include "extractor/extraction_way.hpp"
 #include "extractor/internal_extractor_edge.hpp"
+#include "extractor/native_turn_penalties.hpp"
+#include "extractor/native_way_rules.hpp"
 #include "extractor/profile_properties.hpp"
 #include "extractor/query_node.hpp"
 #include "extractor/raster_source.hpp"
 #include "extractor/restriction_parser.hpp"
+#include "extractor/way_memo_cache.hpp"
 #include "util/coordinate.hpp"
 #include "util/exception.hpp"
 #include "util/log.hpp"
 #include "util/lua_util.hpp"
+#include "util/integer_range.hpp"
 #include "util/typedefs.hpp"
 
 #include <osmium/osm.hpp>
@@ -76,6 +80,61 @@ template <class T> double lonToDouble(T const &object)
     return static_cast<double>(util::toFloating(object.lon));
 }
 
+namespace
+{
+// Reads the tables of native_way_rules, lists are arrays of strings and tags are tables from
+// keys to arrays of values
+NativeWayRules loadNativeWayRules(const sol::table &table)
+{
+    NativeWayRules rules;
+    const auto for_each_value = [&table](const char *name, const auto &add) {
+        auto list = table.get<sol::optional<sol::table>>(name);
+        if (!list)
+            return;
+        for (std::size_t index = 1; index <= list->size(); ++index)
+            add(list->get<std::string>(index));
+    };
+    const auto for_each_tag = [&table](const char *name, const auto &add) {
+        auto tags = table.get<sol::optional<sol::table>>(name);
+        if (!tags)
+            return;
+        tags->for_each([&add](sol::object key, sol::object values) {
+            const auto list = values.as<sol::table>();
+            for (std::size_t index = 1; index <= list.size(); ++index)
+                add(key.as<std::string>(), list.get<std::string>(index));
+        });
+    };
+
+    for_each_value("required_keys", [&](std::string key) { rules.AddRequiredKey(key); });
+    for_each_value("access_keys", [&](std::string key) { rules.AddAccessKey(key); });
+    for_each_value("access_blacklist",
+                   [&](std::string value) { rules.AddBlacklistedAccess(value); });
+    for_each_value("restricted_access",
+                   [&](std::string value) { rules.AddRestrictedAccess(value); });
+    for_each_value("restricted_highways",
+                   [&](std::string value) { rules.AddRestrictedHighway(value); });
+    for_each_tag("blocked_tags",
+                 [&](std::string key, std::string value) { rules.AddBlockedTag(key, value); });
+    for_each_tag("speed_tags",
+                 [&](std::string key, std::string value) { rules.AddSpeedTag(key, value); });
+
+    return rules;
+}
+
+// Reads way_memo, the keys the way function reads and optionally the size of the cache
+WayMemoCache loadWayMemoCache(const sol::table &table)
+{
+    WayMemoCache memo;
+    const auto keys = table.get<sol::table>("keys");
+    for (std::size_t index = 1; index <= keys.size(); ++index)
+        memo.AddKey(keys.get<std::string>(index));
+    const auto max_entries = table.get<sol::optional<std::size_t>>("max_entries");
+    if (max_entries)
+        memo.SetMaxEntries(*max_entries);
+    return memo;
+}
+}
+
 Sol2ScriptingEnvironment::Sol2ScriptingEnvironment(const std::string &file_name)
     : file_name(file_name)
 {
@@ -219,6 +278,8 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
     context.state.new_usertype<SourceContainer>("sources",
                                                 "load",
                                                 &SourceContainer::LoadRasterSource,
+                                                "load_tiles",
+                                                &SourceContainer::LoadTiledRasterSource,
                                                 "query",
                                                 &SourceContainer::GetRasterDataFromSource,
                                                 "interpolate",
@@ -368,6 +429,44 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
         sol::property([](const ExtractionWay &way) { return way.backward_restricted; },
                       [](ExtractionWay &way, bool flag) { way.backward_restricted = flag; }));
 
+    context.state.new_usertype<LuaWayBatch>(
+        "WayBatch",
+        "size",
+        sol::property(&LuaWayBatch::Size),
+        "way",
+        [](const LuaWayBatch &batch, std::size_t index) -> const osmium::Way & {
+            return *batch.ways.at(index);
+        },
+        "result",
+        [](LuaWayBatch &batch, std::size_t index) -> ExtractionWay & {
+            return batch.results.at(index);
+        },
+        "get_value_by_key",
+        [](const LuaWayBatch &batch, std::size_t index, const char *key) {
+            return get_value_by_key(*batch.ways.at(index), key);
+        },
+        "get_tags",
+        [](const LuaWayBatch &batch, std::size_t index, sol::this_state state) {
+            const auto begin = batch.tag_offsets.at(index);
+            const auto end = batch.tag_offsets.at(index + 1);
+            auto tags = sol::table::create(state.L, 0, static_cast<int>(end - begin));
+            for (auto tag = begin; tag < end; ++tag)
+            {
+                tags[batch.keys[tag]] = batch.values[tag];
+            }
+            return tags;
+        },
+        // raw arrays for the LuaJIT FFI: uint32_t[size + 1] and const char *[]
+        "tag_offsets",
+        sol::property([](LuaWayBatch &batch) {
+            return static_cast<void *>(batch.tag_offsets.data());
+        }),
+        "keys",
+        sol::property([](LuaWayBatch &batch) { return static_cast<void *>(batch.keys.data()); }),
+        "values",
+        sol::property(
+            [](LuaWayBatch &batch) { return static_cast<void *>(batch.values.data()); }));
+
     context.state.new_usertype<ExtractionSegment>("ExtractionSegment",
                                                   "source",
                                                   &ExtractionSegment::source,
@@ -398,6 +497,9 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
                                                "target_restricted",
                                                &ExtractionTurn::target_restricted);
 
+    context.state.new_usertype<LuaTurnBatch>(
+        "TurnBatch", "size", sol::property(&LuaTurnBatch::Size), "turn", &LuaTurnBatch::Turn);
+
     // Keep in mind .location is undefined since we're not using libosmium's location cache
     context.state.new_usertype<osmium::NodeRef>("NodeRef", "id", &osmium::NodeRef::ref);
 
@@ -434,15 +536,43 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
 
     // cache references to functions for faster execution
     context.turn_function = context.state["turn_function"];
+    context.turns_function = context.state["process_turns"];
     context.node_function = context.state["node_function"];
     context.way_function = context.state["way_function"];
+    context.ways_function = context.state["process_ways"];
     context.segment_function = context.state["segment_function"];
 
     context.has_turn_penalty_function = context.turn_function.valid();
+    context.has_turns_function = context.turns_function.valid();
     context.has_node_function = context.node_function.valid();
     context.has_way_function = context.way_function.valid();
+    context.has_ways_function = context.ways_function.valid();
+
+    auto native_way_rules = context.state.get<sol::optional<sol::table>>("native_way_rules");
+    if (native_way_rules)
+    {
+        context.native_way_rules = loadNativeWayRules(*native_way_rules);
+    }
+
+    auto way_memo = context.state.get<sol::optional<sol::table>>("way_memo");
+    if (way_memo)
+    {
+        context.way_memo = loadWayMemoCache(*way_memo);
+    }
     context.has_segment_function = context.segment_function.valid();
 
+    auto native_turn_penalties =
+        context.state.get<sol::optional<sol::table>>("native_turn_penalties");
+    if (native_turn_penalties)
+    {
+        context.native_turn_penalties =
+            NativeTurnPenalties(native_turn_penalties->get<double>("turn_penalty"),
+                                native_turn_penalties->get<double>("turn_bias"),
+                                native_turn_penalties->get<double>("traffic_light_penalty"),
+                                native_turn_penalties->get<double>("u_turn_penalty"),
+                                context.properties);
+    }
+
     // Check profile API version
     auto maybe_version = context.state.get<sol::optional<int>>("api_version");
     if (maybe_version)
@@ -502,6 +632,12 @@ void Sol2ScriptingEnvironment::ProcessElements(
     ExtractionWay result_way;
     std::vector<InputRestrictionContainer> result_res;
     auto &local_context = this->GetSol2Context();
+    auto &way_batch = local_context.way_batch;
+    way_batch.Clear();
+    auto &way_memo = local_context.way_memo;
+    auto &batch_fingerprints = local_context.way_batch_fingerprints;
+    batch_fingerprints.clear();
+    std::string fingerprint;
 
     for (auto entity = buffer.cbegin(), end = buffer.cend(); entity != end; ++entity)
     {
@@ -519,11 +655,43 @@ void Sol2ScriptingEnvironment::ProcessElements(
                 static_cast<const osmium::Node &>(*entity), std::move(result_node)));
             break;
         case osmium::item_type::way:
+            if (!local_context.native_way_rules.Empty() &&
+                local_context.native_way_rules.Rejects(
+                    static_cast<const osmium::Way &>(*entity).tags()))
+            {
+                resulting_ways.push_back(std::pair<const osmium::Way &, ExtractionWay>(
+                    static_cast<const osmium::Way &>(*entity), ExtractionWay()));
+                break;
+            }
+            if (!way_memo.Empty())
+            {
+                way_memo.Fingerprint(static_cast<const osmium::Way &>(*entity).tags(),
+                                     fingerprint);
+                if (const auto memoized = way_memo.Find(fingerprint))
+                {
+                    resulting_ways.push_back(std::pair<const osmium::Way &, ExtractionWay>(
+                        static_cast<const osmium::Way &>(*entity), *memoized));
+                    break;
+                }
+            }
+            if (local_context.has_ways_function)
+            {
+                way_batch.Add(static_cast<const osmium::Way &>(*entity));
+                if (!way_memo.Empty())
+                {
+                    batch_fingerprints.push_back(fingerprint);
+                }
+                break;
+            }
             result_way.clear();
             if (local_context.has_way_function)
             {
                 local_context.ProcessWay(static_cast<const osmium::Way &>(*entity), result_way);
             }
+            if (!way_memo.Empty())
+            {
+                way_memo.Insert(fingerprint, result_way);
+            }
             resulting_ways.push_back(std::pair<const osmium::Way &, ExtractionWay>(
                 static_cast<const osmium::Way &>(*entity), std::move(result_way)));
             break;
@@ -540,6 +708,20 @@ void Sol2ScriptingEnvironment::ProcessElements(
             break;
         }
     }
+
+    if (way_batch.Size() > 0)
+    {
+        local_context.ProcessWays(way_batch);
+        for (const auto index : util::irange<std::size_t>(0, way_batch.Size()))
+        {
+            if (!way_memo.Empty())
+            {
+                way_memo.Insert(batch_fingerprints[index], way_batch.results[index]);
+            }
+            resulting_ways.push_back(std::pair<const osmium::Way &, ExtractionWay>(
+                *way_batch.ways[index], std::move(way_batch.results[index])));
+        }
+    }
 }
 
 std::vector<std::string> Sol2ScriptingEnvironment::GetNameSuffixList()
@@ -636,6 +818,45 @@ void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
     }
 }
 
+void Sol2ScriptingEnvironment::ProcessTurns(std::vector<ExtractionTurn> &turns)
+{
+    auto &context = GetSol2Context();
+
+    // the batched and the native penalties are only available with api_version=1
+    if (context.api_version != 1 ||
+        (!context.native_turn_penalties && !context.has_turns_function))
+    {
+        for (auto &turn : turns)
+        {
+            ProcessTurn(turn);
+        }
+        return;
+    }
+
+    if (context.native_turn_penalties)
+    {
+        for (auto &turn : turns)
+        {
+            context.native_turn_penalties->Apply(turn);
+        }
+    }
+    else
+    {
+        LuaTurnBatch batch{&turns};
+        context.turns_function(&batch);
+    }
+
+    // Turn weight falls back to the duration value in deciseconds
+    // or uses the extracted unit-less weight value
+    if (context.properties.fallback_to_duration)
+    {
+        for (auto &turn : turns)
+        {
+            turn.weight = turn.duration;
+        }
+    }
+}
+
 void Sol2ScriptingEnvironment::ProcessSegment(ExtractionSegment &segment)
 {
     auto &context = GetSol2Context();
@@ -669,5 +890,33 @@ void LuaScriptingContext::ProcessWay(const osmium::Way &way, ExtractionWay &resu
 
     way_function(way, result);
 }
+
+void LuaScriptingContext::ProcessWays(LuaWayBatch &batch)
+{
+    BOOST_ASSERT(state.lua_state() != nullptr);
+
+    ways_function(batch);
+}
+
+void LuaWayBatch::Clear()
+{
+    ways.clear();
+    tag_offsets.assign(1, 0);
+    keys.clear();
+    values.clear();
+    results.clear();
+}
+
+void LuaWayBatch::Add(const osmium::Way &way)
+{
+    ways.push_back(&way);
+    for (const auto &tag : way.tags())
+    {
+        keys.push_back(tag.key());
+        values.push_back(tag.value());
+    }
+    tag_offsets.push_back(static_cast<std::uint32_t>(keys.size()));
+    results.emplace_back();
+}
 }
 }
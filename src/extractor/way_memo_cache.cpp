@@ -0,0 +1,43 @@
+#include "extractor/way_memo_cache.hpp"
+
+#include <osmium/osm/tag.hpp>
+
+namespace osrm
+{
+namespace extractor
+{
+
+void WayMemoCache::AddKey(std::string key) { keys.push_back(std::move(key)); }
+
+void WayMemoCache::Fingerprint(const osmium::TagList &tags, std::string &fingerprint) const
+{
+    fingerprint.clear();
+    for (const auto &key : keys)
+    {
+        const auto value = tags.get_value_by_key(key.c_str());
+        if (value)
+        {
+            // OSM values can't contain a 0 byte, so it separates them unambiguously
+            fingerprint.push_back('=');
+            fingerprint.append(value);
+        }
+        fingerprint.push_back('\0');
+    }
+}
+
+const ExtractionWay *WayMemoCache::Find(const std::string &fingerprint) const
+{
+    const auto result = results.find(fingerprint);
+    return result == results.end() ? nullptr : &result->second;
+}
+
+void WayMemoCache::Insert(const std::string &fingerprint, const ExtractionWay &result)
+{
+    if (results.size() >= max_entries)
+    {
+        results.clear();
+    }
+    results.emplace(fingerprint, result);
+}
+}
+}
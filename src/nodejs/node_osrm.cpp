@@ -14,11 +14,19 @@
 
 #include "nodejs/node_osrm.hpp"
 #include "nodejs/node_osrm_support.hpp"
+#include "nodejs/worker_pool.hpp"
 
 namespace node_osrm
 {
 
-Engine::Engine(osrm::EngineConfig &config) : Base(), this_(std::make_shared<osrm::OSRM>(config)) {}
+Engine::Engine(osrm::EngineConfig &config, const WorkerPoolConfig &pool_config)
+    : Base(), this_(std::make_shared<osrm::OSRM>(config))
+{
+    if (pool_config.threads > 0)
+    {
+        pool = std::make_shared<WorkerPool>(pool_config);
+    }
+}
 
 Nan::Persistent<v8::Function> &Engine::constructor()
 {
@@ -67,11 +75,16 @@ NAN_MODULE_INIT(Engine::Init)
  * ```
  *
  * @param {Object|String} [options={shared_memory: true}] Options for creating an OSRM object or string to the `.osrm` file.
- * @param {String} [options.algorithm] The algorithm to use for routing. Can be 'CH', 'CoreCH' or 'MLD'. Default is 'CH'.
+ * @param {String} [options.algorithm] The algorithm to use for routing. Can be 'CH', 'CoreCH', 'MLD' or 'CCH'. Default is 'CH'.
  *        Make sure you prepared the dataset with the correct toolchain.
  * @param {Boolean} [options.shared_memory] Connects to the persistent shared memory datastore.
  *        This requires you to run `osrm-datastore` prior to creating an `OSRM` object.
+ * @param {String} [options.dataset_name] Connects to the dataset osrm-datastore loaded into shared memory under this name with `--dataset-name`.
  * @param {String} [options.path] The path to the `.osrm` files. This is mutually exclusive with setting {options.shared_memory} to true.
+ * @param {Number} [options.worker_threads=0] Runs the queries of this object on up to this many threads of its own instead of the libuv threadpool,
+ *        so they neither compete with file system and DNS work nor depend on `UV_THREADPOOL_SIZE`. `0` uses the libuv threadpool.
+ * @param {Number} [options.max_queued_requests=0] With `worker_threads`, queries beyond this many pending ones fail right away with `ServiceUnavailable`.
+ *        `0` queues any number of queries.
  *
  * @class OSRM
  *
@@ -87,7 +100,11 @@ NAN_METHOD(Engine::New)
             if (!config)
                 return;
 
-            auto *const self = new Engine(*config);
+            const auto pool_config = argumentsToWorkerPoolConfig(info);
+            if (!pool_config)
+                return;
+
+            auto *const self = new Engine(*config, *pool_config);
             self->Wrap(info.This());
         }
         catch (const std::exception &ex)
@@ -116,29 +133,41 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
 
     BOOST_ASSERT(params->IsValid());
 
+    // tiles are always returned as Buffer
+    using ParamPtr = decltype(params);
+    boost::optional<ResultFormat> format = ResultFormat::Object;
+    if (!std::is_same<ParamPtr, tile_parameters_ptr>::value)
+        format = argumentsToResultFormat(info);
+    if (!format)
+        return;
+
     if (!info[info.Length() - 1]->IsFunction())
         return Nan::ThrowTypeError("last argument must be a callback function");
 
     auto *const self = Nan::ObjectWrap::Unwrap<Engine>(info.Holder());
-    using ParamPtr = decltype(params);
 
     struct Worker final : Nan::AsyncWorker
     {
         using Base = Nan::AsyncWorker;
 
         Worker(std::shared_ptr<osrm::OSRM> osrm_,
+               std::shared_ptr<WorkerPool> pool_,
                ParamPtr params_,
                ServiceMemFn service,
+               const ResultFormat format,
                Nan::Callback *callback)
-            : Base(callback), osrm{std::move(osrm_)}, service{std::move(service)},
-              params{std::move(params_)}
+            : Base(callback), osrm{std::move(osrm_)}, pool{std::move(pool_)},
+              service{std::move(service)}, params{std::move(params_)}, format{format}
         {
         }
 
+        void Reject(const char *message) { SetErrorMessage(message); }
+
         void Execute() override try
         {
             const auto status = ((*osrm).*(service))(*params, result);
             ParseResult(status, result);
+            RenderResult(format, result, rendered);
         }
         catch (const std::exception &e)
         {
@@ -150,13 +179,17 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
             Nan::HandleScope scope;
 
             const constexpr auto argc = 2u;
-            v8::Local<v8::Value> argv[argc] = {Nan::Null(), render(result)};
+            v8::Local<v8::Value> argv[argc] = {Nan::Null(),
+                                               format == ResultFormat::Object
+                                                   ? render(result)
+                                                   : renderBuffer(std::move(rendered))};
 
             callback->Call(argc, argv);
         }
 
         // Keeps the OSRM object alive even after shutdown until we're done with callback
         std::shared_ptr<osrm::OSRM> osrm;
+        std::shared_ptr<WorkerPool> pool;
         ServiceMemFn service;
         const ParamPtr params;
 
@@ -167,10 +200,28 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
                                       osrm::json::Object>::type;
 
         ObjectOrString result;
+
+        const ResultFormat format;
+        std::vector<char> rendered;
     };
 
     auto *callback = new Nan::Callback{info[info.Length() - 1].As<v8::Function>()};
-    Nan::AsyncQueueWorker(new Worker{self->this_, std::move(params), service, callback});
+    auto *worker =
+        new Worker{self->this_, self->pool, std::move(params), service, *format, callback};
+    if (!self->pool)
+    {
+        Nan::AsyncQueueWorker(worker);
+    }
+    else if (self->pool->IsFull())
+    {
+        // fails asynchronously like any other query
+        worker->Reject("ServiceUnavailable");
+        self->pool->Skip(worker);
+    }
+    else
+    {
+        self->pool->Queue(worker);
+    }
 }
 
 // clang-format off
@@ -189,11 +240,16 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
  * @param {Number} [options.alternatives=0] Search for up to this many alternative routes.
  * *Please note that even if alternative routes are requested, a result cannot be guaranteed.*
  * @param {Boolean} [options.steps=false] Return route steps for each route leg.
+ * @param {Boolean} [options.alternative_steps=true] Return route steps for the alternative routes as well, otherwise only for the first route.
+ * @param {Boolean} [options.intersections=true] List the intersections passed by each step.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
  * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Boolean} [options.continue_straight] Forces the route to keep going straight at waypoints and don't do a uturn even if it would be faster. Default value depends on the profile.
  *                  `null`/`true`/`false`
+ * @param {String} [options.format=object] `object` passes the result as JavaScript objects, `json_buffer` as a `Buffer` with the JSON text
+ *                                          and `binary` as a `Buffer` in the binary format of `format=binary` of the HTTP API.
+ *                                          The buffers are rendered on the worker thread, which keeps big results from blocking the event loop.
  * @param {Function} callback
  *
  * @returns {Object} An array of [Waypoint](#waypoint) objects representing all waypoints in order AND an array of [`Route`](#route) objects ordered by descending recommendation rank.
@@ -228,6 +284,9 @@ NAN_METHOD(Engine::route) //
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
  * @param {Number} [options.number=1] Number of nearest segments that should be returned.
  * Must be an integer greater than or equal to `1`.
+ * @param {String} [options.format=object] `object` passes the result as JavaScript objects, `json_buffer` as a `Buffer` with the JSON text
+ *                                          and `binary` as a `Buffer` in the binary format of `format=binary` of the HTTP API.
+ *                                          The buffers are rendered on the worker thread, which keeps big results from blocking the event loop.
  * @param {Function} callback
  *
  * @returns {Object} containing `waypoints`.
@@ -269,11 +328,21 @@ NAN_METHOD(Engine::nearest) //
  * location with given index as source. Default is to use all.
  * @param {Array} [options.destinations] An array of `index` elements (`0 <= integer <
  * #coordinates`) to use location with given index as destination. Default is to use all.
+ * @param {Array} [options.annotations] An array of `duration` and/or `distance`, the tables to return. Default is `duration`.
+ * @param {Number} [options.max_duration] Routes longer than this many seconds are not searched, their entries are `null`.
+ * @param {Number} [options.max_weight] Routes with a larger weight of the profile are not searched, their entries are `null`.
+ * @param {Number} [options.max_results_per_source] Only the entries of this many nearest destinations of every source by duration are kept, the others are `null`.
+ * @param {Boolean} [options.approximate=false] Estimate the durations from the distance oracle of the dataset (see `osrm-customize --distance-oracle-level`), at most 3% off the fastest duration.
+ * @param {String} [options.format=object] `object` passes the result as JavaScript objects, `json_buffer` as a `Buffer` with the JSON text
+ *                                          and `binary` as a `Buffer` in the binary format of `format=binary` of the HTTP API.
+ *                                          The buffers are rendered on the worker thread, which keeps big results from blocking the event loop.
  * @param {Function} callback
  *
- * @returns {Object} containing `durations`, `sources`, and `destinations`.
+ * @returns {Object} containing `durations`, `distances`, `sources`, and `destinations`.
  * **`durations`**: array of arrays that stores the matrix in row-major order. `durations[i][j]` gives the travel time from the i-th waypoint to the j-th waypoint.
  *                  Values are given in seconds.
+ * **`distances`**: array of arrays that stores the matrix in row-major order. `distances[i][j]` gives the length of the route from the i-th waypoint to the j-th waypoint.
+ *                  Values are given in meters. Only present with `annotations` containing `distance`.
  * **`sources`**: array of [`Ẁaypoint`](#waypoint) objects describing all sources in order.
  * **`destinations`**: array of [`Ẁaypoint`](#waypoint) objects describing all destinations in order.
  *
@@ -345,11 +414,15 @@ NAN_METHOD(Engine::tile)
  *                                   Can be `null` or an array of `[{value},{range}]` with `integer 0 .. 360,integer 0 .. 180`.
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
  * @param {Boolean} [options.steps=false] Return route steps for each route.
+ * @param {Boolean} [options.intersections=true] List the intersections passed by each step.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
  * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Array<Number>} [options.timestamps] Timestamp of the input location (integers, UNIX-like timestamp).
  * @param {Array} [options.radiuses] Standard deviation of GPS precision used for map matching. If applicable use GPS accuracy. Can be `null` for default value `5` meters or `double >= 0`.
+ * @param {String} [options.format=object] `object` passes the result as JavaScript objects, `json_buffer` as a `Buffer` with the JSON text
+ *                                          and `binary` as a `Buffer` in the binary format of `format=binary` of the HTTP API.
+ *                                          The buffers are rendered on the worker thread, which keeps big results from blocking the event loop.
  * @param {Function} callback
  *
  * @returns {Object} containing `tracepoints` and `matchings`.
@@ -411,9 +484,13 @@ NAN_METHOD(Engine::match) //
  * @param {Array} [options.radiuses] Limits the coordinate snapping to streets in the given radius in meters. Can be `double >= 0` or `null` (unlimited, default).
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
  * @param {Boolean} [options.steps=false] Return route steps for each route.
+ * @param {Boolean} [options.intersections=true] List the intersections passed by each step.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
  * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified`
+ * @param {String} [options.format=object] `object` passes the result as JavaScript objects, `json_buffer` as a `Buffer` with the JSON text
+ *                                          and `binary` as a `Buffer` in the binary format of `format=binary` of the HTTP API.
+ *                                          The buffers are rendered on the worker thread, which keeps big results from blocking the event loop.
  * @param {Function} callback
  * @param {Boolean} [options.roundtrip=true] Return route is a roundtrip.
  * @param {String} [options.source=any] Return route starts at `any` or `first` coordinate.
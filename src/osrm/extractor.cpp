@@ -3,6 +3,9 @@
 #include "extractor/extractor_config.hpp"
 #include "extractor/scripting_environment_lua.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace osrm
 {
 
@@ -14,4 +17,25 @@ void extract(const extractor::ExtractorConfig &config)
     extractor::Extractor(config).run(scripting_environment);
 }
 
+void extract(const std::vector<extractor::ExtractorConfig> &configs)
+{
+    std::vector<std::unique_ptr<extractor::Sol2ScriptingEnvironment>> scripting_environments;
+    std::vector<extractor::Extractor> extractors;
+    for (const auto &config : configs)
+    {
+        scripting_environments.push_back(std::make_unique<extractor::Sol2ScriptingEnvironment>(
+            config.profile_path.string().c_str()));
+        extractors.emplace_back(config);
+    }
+
+    std::vector<extractor::Extractor *> extractor_pointers;
+    std::vector<extractor::ScriptingEnvironment *> environment_pointers;
+    for (auto index = 0u; index < configs.size(); ++index)
+    {
+        extractor_pointers.push_back(&extractors[index]);
+        environment_pointers.push_back(scripting_environments[index].get());
+    }
+    extractor::Extractor::run(extractor_pointers, environment_pointers);
+}
+
 } // ns osrm
@@ -1,19 +1,91 @@
 #include "osrm/osrm.hpp"
 #include "engine/algorithm.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
 #include "engine/api/table_parameters.hpp"
 #include "engine/api/trip_parameters.hpp"
+#include "engine/async_executor.hpp"
 #include "engine/engine.hpp"
 #include "engine/engine_config.hpp"
 #include "engine/status.hpp"
 
+#include <exception>
 #include <memory>
+#include <utility>
 
 namespace osrm
 {
 
+namespace
+{
+void setException(json::Object &result, const std::exception &exception)
+{
+    result.values.clear();
+    result.values["code"] = "InternalError";
+    result.values["message"] = exception.what();
+}
+
+void setException(std::string &result, const std::exception &exception)
+{
+    result = exception.what();
+}
+
+template <typename ParametersT, typename ResultT>
+using QueryT = Status (engine::EngineInterface::*)(const ParametersT &, ResultT &) const;
+
+// Runs the query on the executor and hands the result to the callback. Only the engine is
+// captured since it stays put when the OSRM instance is moved.
+template <typename ParametersT, typename ResultT>
+void enqueueQuery(engine::AsyncExecutor &executor,
+                  const engine::EngineInterface *engine,
+                  QueryT<ParametersT, ResultT> query,
+                  ParametersT parameters,
+                  AsyncCallback<ResultT> callback)
+{
+    executor.Enqueue(
+        [ engine, query, parameters = std::move(parameters), callback = std::move(callback) ]() {
+            ResultT result;
+            Status status;
+            try
+            {
+                status = (engine->*query)(parameters, result);
+            }
+            catch (const std::exception &exception)
+            {
+                setException(result, exception);
+                status = Status::Error;
+            }
+            callback(status, std::move(result));
+        });
+}
+
+// Runs the query on the executor and fulfills the returned future with the result
+template <typename ResultT, typename ParametersT>
+std::future<AsyncResult<ResultT>> enqueueQuery(engine::AsyncExecutor &executor,
+                                               const engine::EngineInterface *engine,
+                                               QueryT<ParametersT, ResultT> query,
+                                               ParametersT parameters)
+{
+    auto promise = std::make_shared<std::promise<AsyncResult<ResultT>>>();
+    auto future = promise->get_future();
+    executor.Enqueue([ engine, query, parameters = std::move(parameters), promise ]() {
+        try
+        {
+            AsyncResult<ResultT> result;
+            result.status = (engine->*query)(parameters, result.result);
+            promise->set_value(std::move(result));
+        }
+        catch (...)
+        {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+}
+
 // Pimpl idiom
 
 OSRM::OSRM(engine::EngineConfig &config)
@@ -21,6 +93,7 @@ OSRM::OSRM(engine::EngineConfig &config)
     using CH = engine::routing_algorithms::ch::Algorithm;
     using CoreCH = engine::routing_algorithms::corech::Algorithm;
     using MLD = engine::routing_algorithms::mld::Algorithm;
+    using CCH = engine::routing_algorithms::cch::Algorithm;
 
     // First, check that necessary core data is available
     if (!config.use_shared_memory && !config.storage_config.IsValid())
@@ -30,11 +103,12 @@ OSRM::OSRM(engine::EngineConfig &config)
     }
     else if (config.use_shared_memory)
     {
-        storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
+        storage::SharedMonitor<storage::SharedDataTimestamp> barrier(config.dataset_name);
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
+        auto mem =
+            storage::makeSharedMemory(barrier.data().region, 0, false, config.dataset_name);
         auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
         if (layout->GetBlockSize(storage::DataLayout::NAME_CHAR_DATA) == 0)
             throw util::exception(
@@ -77,6 +151,15 @@ OSRM::OSRM(engine::EngineConfig &config)
             throw util::exception("Dataset is not compatible with MLD.");
         }
     }
+    else if (config.algorithm == EngineConfig::Algorithm::CCH)
+    {
+        bool cch_compatible = engine::Engine<CCH>::CheckCompability(config);
+        // throw error if the hierarchy was not customized
+        if (!cch_compatible)
+        {
+            throw util::exception("Dataset is not compatible with CCH.");
+        }
+    }
 
     switch (config.algorithm)
     {
@@ -89,13 +172,25 @@ OSRM::OSRM(engine::EngineConfig &config)
     case EngineConfig::Algorithm::MLD:
         engine_ = std::make_unique<engine::Engine<MLD>>(config);
         break;
+    case EngineConfig::Algorithm::CCH:
+        engine_ = std::make_unique<engine::Engine<CCH>>(config);
+        break;
     default:
         util::exception("Algorithm not implemented!");
     }
+
+    executor_ = std::make_unique<engine::AsyncExecutor>(config.async_concurrency);
 }
 OSRM::~OSRM() = default;
 OSRM::OSRM(OSRM &&) noexcept = default;
-OSRM &OSRM::operator=(OSRM &&) noexcept = default;
+
+OSRM &OSRM::operator=(OSRM &&other) noexcept
+{
+    // the queued queries of this instance have to finish before its engine is replaced
+    executor_ = std::move(other.executor_);
+    engine_ = std::move(other.engine_);
+    return *this;
+}
 
 // Forward to implementation
 
@@ -110,6 +205,11 @@ engine::Status OSRM::Table(const engine::api::TableParameters &params, json::Obj
     return engine_->Table(params, result);
 }
 
+engine::Status OSRM::Table(const engine::api::TableParameters &params, std::string &result) const
+{
+    return engine_->Table(params, result);
+}
+
 engine::Status OSRM::Nearest(const engine::api::NearestParameters &params,
                              json::Object &result) const
 {
@@ -131,4 +231,128 @@ engine::Status OSRM::Tile(const engine::api::TileParameters &params, std::string
     return engine_->Tile(params, result);
 }
 
+engine::Status OSRM::Isochrone(const engine::api::IsochroneParameters &params,
+                               json::Object &result) const
+{
+    return engine_->Isochrone(params, result);
+}
+
+std::shared_ptr<const void> OSRM::GetDataset() const { return engine_->GetDataset(); }
+
+// Queue on the executor
+
+void OSRM::RouteAsync(RouteParameters params, AsyncCallback<json::Object> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Route,
+                 std::move(params),
+                 std::move(callback));
+}
+
+std::future<AsyncResult<json::Object>> OSRM::RouteAsync(RouteParameters params) const
+{
+    return enqueueQuery<json::Object>(
+        *executor_, engine_.get(), &engine::EngineInterface::Route, std::move(params));
+}
+
+void OSRM::TableAsync(TableParameters params, AsyncCallback<json::Object> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Table,
+                 std::move(params),
+                 std::move(callback));
+}
+
+std::future<AsyncResult<json::Object>> OSRM::TableAsync(TableParameters params) const
+{
+    return enqueueQuery<json::Object>(
+        *executor_, engine_.get(), &engine::EngineInterface::Table, std::move(params));
+}
+
+void OSRM::TableAsync(TableParameters params, AsyncCallback<std::string> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Table,
+                 std::move(params),
+                 std::move(callback));
+}
+
+void OSRM::NearestAsync(NearestParameters params, AsyncCallback<json::Object> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Nearest,
+                 std::move(params),
+                 std::move(callback));
+}
+
+std::future<AsyncResult<json::Object>> OSRM::NearestAsync(NearestParameters params) const
+{
+    return enqueueQuery<json::Object>(
+        *executor_, engine_.get(), &engine::EngineInterface::Nearest, std::move(params));
+}
+
+void OSRM::TripAsync(TripParameters params, AsyncCallback<json::Object> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Trip,
+                 std::move(params),
+                 std::move(callback));
+}
+
+std::future<AsyncResult<json::Object>> OSRM::TripAsync(TripParameters params) const
+{
+    return enqueueQuery<json::Object>(
+        *executor_, engine_.get(), &engine::EngineInterface::Trip, std::move(params));
+}
+
+void OSRM::MatchAsync(MatchParameters params, AsyncCallback<json::Object> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Match,
+                 std::move(params),
+                 std::move(callback));
+}
+
+std::future<AsyncResult<json::Object>> OSRM::MatchAsync(MatchParameters params) const
+{
+    return enqueueQuery<json::Object>(
+        *executor_, engine_.get(), &engine::EngineInterface::Match, std::move(params));
+}
+
+void OSRM::TileAsync(TileParameters params, AsyncCallback<std::string> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Tile,
+                 std::move(params),
+                 std::move(callback));
+}
+
+std::future<AsyncResult<std::string>> OSRM::TileAsync(TileParameters params) const
+{
+    return enqueueQuery<std::string>(
+        *executor_, engine_.get(), &engine::EngineInterface::Tile, std::move(params));
+}
+
+void OSRM::IsochroneAsync(IsochroneParameters params, AsyncCallback<json::Object> callback) const
+{
+    enqueueQuery(*executor_,
+                 engine_.get(),
+                 &engine::EngineInterface::Isochrone,
+                 std::move(params),
+                 std::move(callback));
+}
+
+std::future<AsyncResult<json::Object>> OSRM::IsochroneAsync(IsochroneParameters params) const
+{
+    return enqueueQuery<json::Object>(
+        *executor_, engine_.get(), &engine::EngineInterface::Isochrone, std::move(params));
+}
+
 } // ns osrm
@@ -6,7 +6,6 @@
 #include <cstdint>
 #include <iostream>
 #include <limits>
-#include <map>
 #include <numeric>
 #include <queue>
 #include <string>
@@ -14,6 +13,10 @@
 
 #include "util/timing_util.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
 namespace osrm
 {
 namespace partition
@@ -98,29 +101,20 @@ AnnotatedPartition::AnnotatedPartition(const BisectionGraph &graph,
 {
     // create a sorted vector of bisection ids that exist in the network
     std::vector<SizedID> implicit_tree = [&]() {
-        std::map<BisectionID, SizedID> existing_ids;
-
-        // insert an ID into the sized_id set or increase the count if the element should be already
-        // present in the set of known ids
-        const auto insert_or_augment = [&existing_ids](const BisectionID id) {
-            SizedID sized_id = {id, 1};
-            auto maybe_existing_id = existing_ids.find(id);
-            if (maybe_existing_id == existing_ids.end())
-                existing_ids[id] = sized_id;
-            else
-                maybe_existing_id->second.count++;
-        };
-        std::for_each(bisection_ids.begin(), bisection_ids.end(), insert_or_augment);
+        std::vector<BisectionID> sorted_ids(bisection_ids);
+        tbb::parallel_sort(sorted_ids.begin(), sorted_ids.end());
 
+        // count the occurrences of every ID present
         std::vector<SizedID> result;
-        result.resize(existing_ids.size() + 1);
-        std::transform(existing_ids.begin(),
-                       existing_ids.end(),
-                       result.begin(),
-                       [](const auto &pair) { return pair.second; });
+        for (auto begin = sorted_ids.begin(); begin != sorted_ids.end();)
+        {
+            const auto end = std::upper_bound(begin, sorted_ids.end(), *begin);
+            result.push_back({*begin, static_cast<std::size_t>(std::distance(begin, end))});
+            begin = end;
+        }
 
         // sentinel
-        result.back() = {std::numeric_limits<BisectionID>::max(), 0};
+        result.push_back({std::numeric_limits<BisectionID>::max(), 0});
 
         return result;
     }();
@@ -356,30 +350,40 @@ AnnotatedPartition::ComputeCellIDs(std::vector<std::pair<BisectionID, std::int32
 {
     std::vector<std::uint32_t> cell_ids(graph.NumberOfNodes(), INVALID_CELLID);
 
-    std::sort(prefixes.begin(), prefixes.end(), [](const auto lhs, const auto rhs) {
+    tbb::parallel_sort(prefixes.begin(), prefixes.end(), [](const auto lhs, const auto rhs) {
         return lhs.first < rhs.first;
     });
 
-    for (const auto &node : graph.Nodes())
-    {
-        // find the cell_id of node in the current levels
-        const auto id = bisection_ids[node.original_id];
-
-        const auto is_prefixed_by = [id](const auto &prefix) {
-            return masked(id, prefix.second) == prefix.first;
-        };
-
-        const auto prefix = std::lower_bound(
-            prefixes.begin(), prefixes.end(), id, [&](const auto prefix, const BisectionID id) {
-                return prefix.first < masked(id, prefix.second);
-            });
-
-        if (prefix == prefixes.end())
-            continue;
-
-        if (is_prefixed_by(*prefix))
-            cell_ids[node.original_id] = std::distance(prefixes.begin(), prefix);
-    }
+    // every node writes its own cell id only
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, graph.NumberOfNodes()),
+                      [&](const tbb::blocked_range<NodeID> &range) {
+                          for (auto node_id = range.begin(); node_id != range.end(); ++node_id)
+                          {
+                              const auto &node = graph.Node(node_id);
+
+                              // find the cell_id of node in the current levels
+                              const auto id = bisection_ids[node.original_id];
+
+                              const auto is_prefixed_by = [id](const auto &prefix) {
+                                  return masked(id, prefix.second) == prefix.first;
+                              };
+
+                              const auto prefix = std::lower_bound(
+                                  prefixes.begin(),
+                                  prefixes.end(),
+                                  id,
+                                  [&](const auto prefix, const BisectionID id) {
+                                      return prefix.first < masked(id, prefix.second);
+                                  });
+
+                              if (prefix == prefixes.end())
+                                  continue;
+
+                              if (is_prefixed_by(*prefix))
+                                  cell_ids[node.original_id] =
+                                      std::distance(prefixes.begin(), prefix);
+                          }
+                      });
     return cell_ids;
 }
 
@@ -1,5 +1,9 @@
 #include "partition/bisection_to_partition.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
 namespace osrm
 {
 namespace partition
@@ -16,6 +20,9 @@ struct CellBisection
 };
 static constexpr std::size_t NUM_BISECTION_BITS = sizeof(BisectionID) * CHAR_BIT;
 
+// cells with more nodes are partitioned by all threads, in blocks of this size
+static constexpr std::size_t PARALLEL_PARTITION_BLOCK_SIZE = 1 << 16;
+
 std::vector<std::uint32_t> getLargeCells(const std::size_t max_cell_size,
                                          const std::vector<CellBisection> &cells)
 {
@@ -34,19 +41,129 @@ Partition cellsToPartition(const std::vector<CellBisection> &cells,
                            const std::vector<std::uint32_t> &permutation)
 {
     Partition partition(permutation.size(), INVALID_CELL_ID);
-    CellID cell_id = 0;
-    for (const auto &cell : cells)
-    {
-        std::for_each(permutation.begin() + cell.begin,
-                      permutation.begin() + cell.end,
-                      [&partition, cell_id](const auto node_id) { partition[node_id] = cell_id; });
-        cell_id++;
-    }
+    tbb::parallel_for(tbb::blocked_range<CellID>(0, cells.size()),
+                      [&](const tbb::blocked_range<CellID> &range) {
+                          for (auto cell_id = range.begin(); cell_id != range.end(); ++cell_id)
+                          {
+                              const auto &cell = cells[cell_id];
+                              std::for_each(permutation.begin() + cell.begin,
+                                            permutation.begin() + cell.end,
+                                            [&partition, cell_id](const auto node_id) {
+                                                partition[node_id] = cell_id;
+                                            });
+                          }
+                      });
     BOOST_ASSERT(std::find(partition.begin(), partition.end(), INVALID_CELL_ID) == partition.end());
 
     return partition;
 }
 
+// Moves the nodes of [begin, end) for which `is_left` holds to the front and returns the first
+// node of the right side. Large ranges are partitioned block wise in parallel: the blocks count
+// their left nodes, and a prefix sum over the counts gives each block its output positions.
+template <typename IsLeftT>
+std::uint32_t partitionNodes(std::vector<std::uint32_t> &permutation,
+                             const std::uint32_t begin,
+                             const std::uint32_t end,
+                             const IsLeftT &is_left)
+{
+    if (end - begin <= PARALLEL_PARTITION_BLOCK_SIZE)
+        return std::partition(permutation.begin() + begin, permutation.begin() + end, is_left) -
+               permutation.begin();
+
+    const std::size_t num_blocks =
+        (end - begin + PARALLEL_PARTITION_BLOCK_SIZE - 1) / PARALLEL_PARTITION_BLOCK_SIZE;
+    const auto block_begin = [&](const std::size_t block) {
+        const auto offset =
+            std::min<std::size_t>(block * PARALLEL_PARTITION_BLOCK_SIZE, end - begin);
+        return begin + static_cast<std::uint32_t>(offset);
+    };
+
+    std::vector<std::uint32_t> left_offsets(num_blocks + 1, 0);
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](const std::size_t block) {
+        left_offsets[block + 1] =
+            std::count_if(permutation.begin() + block_begin(block),
+                          permutation.begin() + block_begin(block + 1),
+                          is_left);
+    });
+    std::partial_sum(left_offsets.begin(), left_offsets.end(), left_offsets.begin());
+    const auto middle = begin + left_offsets.back();
+
+    const std::vector<std::uint32_t> nodes(permutation.begin() + begin,
+                                           permutation.begin() + end);
+    tbb::parallel_for(std::size_t{0}, num_blocks, [&](const std::size_t block) {
+        auto left = begin + left_offsets[block];
+        auto right = middle + (block_begin(block) - begin) - left_offsets[block];
+        for (auto index = block_begin(block); index < block_begin(block + 1); ++index)
+        {
+            const auto node_id = nodes[index - begin];
+            permutation[is_left(node_id) ? left++ : right++] = node_id;
+        }
+    });
+
+    return middle;
+}
+
+// Splits a cell at the highest bisection bit in which its nodes differ. Returns the right part
+// if there is one, otherwise a cell with begin == end.
+CellBisection splitCell(const std::vector<BisectionID> &node_to_bisection_id,
+                        std::vector<std::uint32_t> &permutation,
+                        CellBisection &cell)
+{
+    BOOST_ASSERT(cell.bit < NUM_BISECTION_BITS);
+
+    // Go over all nodes and sum up the bits to determine at which position the first one
+    // bit is
+    BisectionID sum = tbb::parallel_reduce(
+        tbb::blocked_range<std::uint32_t>(cell.begin, cell.end, PARALLEL_PARTITION_BLOCK_SIZE),
+        BisectionID{0},
+        [&](const tbb::blocked_range<std::uint32_t> &range, BisectionID initial) {
+            return std::accumulate(permutation.begin() + range.begin(),
+                                   permutation.begin() + range.end(),
+                                   initial,
+                                   [&](const BisectionID lhs, const NodeID rhs) {
+                                       return lhs | node_to_bisection_id[rhs];
+                                   });
+        },
+        [](const BisectionID lhs, const BisectionID rhs) { return lhs | rhs; });
+    // masks all bit strictly higher then cell.bit
+    BOOST_ASSERT(sizeof(unsigned long long) * CHAR_BIT > sizeof(BisectionID) * CHAR_BIT);
+    const BisectionID mask = (1ULL << (cell.bit + 1)) - 1;
+    BOOST_ASSERT(mask == 0 || util::msb(mask) == cell.bit);
+    const auto masked_sum = sum & mask;
+    // we can't split the cell anymore, but it also doesn't conform to the max size
+    // constraint
+    // -> we need to remove it from the optimization
+    if (masked_sum == 0)
+    {
+        cell.tabu = true;
+        return CellBisection{cell.end, cell.end, 0, true};
+    }
+    const auto bit = util::msb(masked_sum);
+    // determines if an bisection ID is on the left side of the partition
+    const BisectionID is_left_mask = 1ULL << bit;
+    BOOST_ASSERT(util::msb(is_left_mask) == bit);
+
+    const auto is_left = [is_left_mask, &node_to_bisection_id](const auto node_id) {
+        return (node_to_bisection_id[node_id] & is_left_mask) != 0;
+    };
+    const std::uint32_t middle = partitionNodes(permutation, cell.begin, cell.end, is_left);
+
+    if (bit > 0)
+        cell.bit = bit - 1;
+    else
+        cell.tabu = true;
+    if (middle == cell.begin || middle == cell.end)
+        return CellBisection{cell.end, cell.end, 0, true};
+
+    const auto old_end = cell.end;
+    cell.end = middle;
+    return CellBisection{middle, old_end, static_cast<std::uint8_t>(cell.bit), cell.tabu};
+}
+
+// The large cells of a round are split in parallel, they cover disjoint ranges of the
+// permutation. The new cells are appended in the order of the large cells, the same order a
+// serial split would give.
 void partitionLevel(const std::vector<BisectionID> &node_to_bisection_id,
                     std::size_t max_cell_size,
                     std::vector<std::uint32_t> &permutation,
@@ -55,57 +172,21 @@ void partitionLevel(const std::vector<BisectionID> &node_to_bisection_id,
     for (auto large_cells = getLargeCells(max_cell_size, cells); large_cells.size() > 0;
          large_cells = getLargeCells(max_cell_size, cells))
     {
-        for (const auto cell_index : large_cells)
+        std::vector<CellBisection> right_cells(large_cells.size());
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, large_cells.size(), 1),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  right_cells[index] = splitCell(node_to_bisection_id,
+                                                                 permutation,
+                                                                 cells[large_cells[index]]);
+                              }
+                          });
+
+        for (const auto &right_cell : right_cells)
         {
-            auto &cell = cells[cell_index];
-            BOOST_ASSERT(cell.bit < NUM_BISECTION_BITS);
-
-            // Go over all nodes and sum up the bits to determine at which position the first one
-            // bit is
-            BisectionID sum =
-                std::accumulate(permutation.begin() + cell.begin,
-                                permutation.begin() + cell.end,
-                                BisectionID{0},
-                                [&node_to_bisection_id](const BisectionID lhs, const NodeID rhs) {
-                                    return lhs | node_to_bisection_id[rhs];
-                                });
-            // masks all bit strictly higher then cell.bit
-            BOOST_ASSERT(sizeof(unsigned long long) * CHAR_BIT > sizeof(BisectionID) * CHAR_BIT);
-            const BisectionID mask = (1ULL << (cell.bit + 1)) - 1;
-            BOOST_ASSERT(mask == 0 || util::msb(mask) == cell.bit);
-            const auto masked_sum = sum & mask;
-            // we can't split the cell anymore, but it also doesn't conform to the max size
-            // constraint
-            // -> we need to remove it from the optimization
-            if (masked_sum == 0)
-            {
-                cell.tabu = true;
-                continue;
-            }
-            const auto bit = util::msb(masked_sum);
-            // determines if an bisection ID is on the left side of the partition
-            const BisectionID is_left_mask = 1ULL << bit;
-            BOOST_ASSERT(util::msb(is_left_mask) == bit);
-
-            std::uint32_t middle =
-                std::partition(permutation.begin() + cell.begin,
-                               permutation.begin() + cell.end,
-                               [is_left_mask, &node_to_bisection_id](const auto node_id) {
-                                   return node_to_bisection_id[node_id] & is_left_mask;
-                               }) -
-                permutation.begin();
-
-            if (bit > 0)
-                cell.bit = bit - 1;
-            else
-                cell.tabu = true;
-            if (middle != cell.begin && middle != cell.end)
-            {
-                auto old_end = cell.end;
-                cell.end = middle;
-                cells.push_back(
-                    CellBisection{middle, old_end, static_cast<std::uint8_t>(cell.bit), cell.tabu});
-            }
+            if (right_cell.begin != right_cell.end)
+                cells.push_back(right_cell);
         }
     }
 }
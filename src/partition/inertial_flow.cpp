@@ -1,5 +1,6 @@
 #include "partition/inertial_flow.hpp"
 #include "partition/bisection_graph.hpp"
+#include "partition/push_relabel_max_flow.hpp"
 #include "partition/reorder_first_last.hpp"
 
 #include <algorithm>
@@ -112,6 +113,9 @@ bestMinCut(const GraphView &view, const std::size_t n, const double ratio, const
 
     tbb::blocked_range<std::size_t> range{0, n, 1};
 
+    // the few large views at the top of the recursion would keep only `n` cores busy otherwise
+    const bool use_parallel_flow = view.NumberOfNodes() >= PushRelabelMaxFlow::MIN_PARALLEL_NODES;
+
     const auto balance_delta = [&view](const auto num_nodes_source) {
         const std::int64_t difference =
             static_cast<std::int64_t>(view.NumberOfNodes()) / 2 - num_nodes_source;
@@ -124,7 +128,8 @@ bestMinCut(const GraphView &view, const std::size_t n, const double ratio, const
             const auto slope = -1. + round * (2. / n);
 
             auto order = makeSpatialOrder(view, ratio, slope);
-            auto cut = DinicMaxFlow()(view, order.sources, order.sinks);
+            auto cut = use_parallel_flow ? PushRelabelMaxFlow()(view, order.sources, order.sinks)
+                                         : DinicMaxFlow()(view, order.sources, order.sinks);
             auto cut_balance = get_balance(cut.num_nodes_source);
 
             {
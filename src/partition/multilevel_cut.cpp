@@ -0,0 +1,414 @@
+#include "partition/multilevel_cut.hpp"
+#include "partition/bisection_graph.hpp"
+#include "partition/inertial_flow.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+namespace osrm
+{
+namespace partition
+{
+namespace
+{
+// stop coarsening if a matching removes less than this share of the nodes
+const constexpr double MIN_COARSENING_REDUCTION = 0.05;
+// a refinement pass stops after this many moves that did not improve the cut
+const constexpr std::size_t MAX_UNPRODUCTIVE_MOVES = 256;
+const constexpr std::size_t MAX_REFINEMENT_PASSES = 4;
+
+using Weight = std::uint32_t;
+using WeightedEdge = std::pair<NodeID, Weight>;
+
+// Undirected graph with node weights (the number of nodes of the view a node stands for) and edge
+// weights (the number of edges of the view between them)
+struct WeightedGraph
+{
+    std::vector<Weight> node_weights;
+    std::vector<util::Coordinate> coordinates;
+    std::vector<EdgeID> first_edges;
+    std::vector<NodeID> targets;
+    std::vector<Weight> edge_weights;
+
+    NodeID NumberOfNodes() const { return node_weights.size(); }
+    auto Edges(const NodeID node) const
+    {
+        return util::irange(first_edges[node], first_edges[node + 1]);
+    }
+};
+
+// Builds the adjacency arrays in parallel, `collect(node, edges)` returns the edges of a node.
+template <typename CollectFn> void makeEdges(WeightedGraph &graph, const CollectFn &collect)
+{
+    const auto number_of_nodes = graph.NumberOfNodes();
+    const tbb::blocked_range<NodeID> range(0, number_of_nodes);
+    graph.first_edges.assign(number_of_nodes + 1, 0);
+
+    tbb::enumerable_thread_specific<std::vector<WeightedEdge>> buffer;
+    tbb::parallel_for(range, [&](const tbb::blocked_range<NodeID> &nodes) {
+        auto &edges = buffer.local();
+        for (auto node = nodes.begin(); node != nodes.end(); ++node)
+        {
+            collect(node, edges);
+            graph.first_edges[node + 1] = edges.size();
+        }
+    });
+    std::partial_sum(graph.first_edges.begin(), graph.first_edges.end(), graph.first_edges.begin());
+
+    graph.targets.resize(graph.first_edges.back());
+    graph.edge_weights.resize(graph.first_edges.back());
+    tbb::parallel_for(range, [&](const tbb::blocked_range<NodeID> &nodes) {
+        auto &edges = buffer.local();
+        for (auto node = nodes.begin(); node != nodes.end(); ++node)
+        {
+            collect(node, edges);
+            auto edge = graph.first_edges[node];
+            for (const auto &each : edges)
+            {
+                graph.targets[edge] = each.first;
+                graph.edge_weights[edge] = each.second;
+                ++edge;
+            }
+        }
+    });
+}
+
+// Sorts the edges of a node by target, adds up the weights of parallel edges and drops loops.
+void mergeEdges(const NodeID node, std::vector<WeightedEdge> &edges)
+{
+    std::sort(edges.begin(), edges.end());
+    auto out = edges.begin();
+    for (const auto &edge : edges)
+    {
+        if (edge.first == node)
+            continue;
+        if (out != edges.begin() && std::prev(out)->first == edge.first)
+            std::prev(out)->second += edge.second;
+        else
+            *out++ = edge;
+    }
+    edges.erase(out, edges.end());
+}
+
+// The finest level is the view itself. Parallel edges count once, as in the flow computations.
+WeightedGraph makeWeightedGraph(const GraphView &view)
+{
+    WeightedGraph graph;
+    graph.node_weights.resize(view.NumberOfNodes(), 1);
+    graph.coordinates.reserve(view.NumberOfNodes());
+    for (const auto &node : view.Nodes())
+        graph.coordinates.push_back(node.coordinate);
+
+    makeEdges(graph, [&view](const NodeID node, std::vector<WeightedEdge> &edges) {
+        edges.clear();
+        for (const auto &edge : view.Edges(node))
+            edges.emplace_back(edge.target, 1);
+        mergeEdges(node, edges);
+        for (auto &edge : edges)
+            edge.second = 1;
+    });
+    return graph;
+}
+
+// Matches every node with the unmatched neighbour it shares the heaviest edge with, preferring
+// light neighbours on ties. Returns the coarse node of every node and the number of coarse nodes.
+std::pair<std::vector<NodeID>, NodeID> matchHeavyEdges(const WeightedGraph &graph,
+                                                       const std::size_t max_node_weight)
+{
+    const auto number_of_nodes = graph.NumberOfNodes();
+    std::vector<NodeID> partners(number_of_nodes, SPECIAL_NODEID);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        if (partners[node] != SPECIAL_NODEID)
+            continue;
+
+        auto partner = node;
+        Weight partner_weight = 0;
+        for (const auto edge : graph.Edges(node))
+        {
+            const auto target = graph.targets[edge];
+            const auto weight = graph.edge_weights[edge];
+            if (partners[target] != SPECIAL_NODEID ||
+                graph.node_weights[node] + graph.node_weights[target] > max_node_weight)
+                continue;
+
+            if (weight > partner_weight ||
+                (weight == partner_weight &&
+                 graph.node_weights[target] < graph.node_weights[partner]))
+            {
+                partner = target;
+                partner_weight = weight;
+            }
+        }
+        partners[node] = partner;
+        partners[partner] = node;
+    }
+
+    std::vector<NodeID> mapping(number_of_nodes);
+    NodeID number_of_coarse_nodes = 0;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        // the lower node of a pair numbers both
+        if (partners[node] < node)
+            continue;
+        mapping[node] = number_of_coarse_nodes;
+        mapping[partners[node]] = number_of_coarse_nodes;
+        ++number_of_coarse_nodes;
+    }
+    return std::make_pair(std::move(mapping), number_of_coarse_nodes);
+}
+
+// Contracts the matched pairs, coarse nodes are located at the center of their nodes.
+WeightedGraph contract(const WeightedGraph &graph,
+                       const std::vector<NodeID> &mapping,
+                       const NodeID number_of_coarse_nodes)
+{
+    WeightedGraph coarse;
+    coarse.node_weights.resize(number_of_coarse_nodes, 0);
+
+    std::vector<std::array<NodeID, 2>> members(number_of_coarse_nodes,
+                                               {{SPECIAL_NODEID, SPECIAL_NODEID}});
+    std::vector<std::array<std::int64_t, 2>> coordinate_sums(number_of_coarse_nodes, {{0, 0}});
+    for (const auto node : util::irange<NodeID>(0, graph.NumberOfNodes()))
+    {
+        const auto coarse_node = mapping[node];
+        const std::int64_t weight = graph.node_weights[node];
+        const auto &coordinate = graph.coordinates[node];
+        coarse.node_weights[coarse_node] += weight;
+        coordinate_sums[coarse_node][0] += weight * static_cast<std::int32_t>(coordinate.lon);
+        coordinate_sums[coarse_node][1] += weight * static_cast<std::int32_t>(coordinate.lat);
+        members[coarse_node][members[coarse_node][0] == SPECIAL_NODEID ? 0 : 1] = node;
+    }
+
+    coarse.coordinates.reserve(number_of_coarse_nodes);
+    for (const auto coarse_node : util::irange<NodeID>(0, number_of_coarse_nodes))
+    {
+        const std::int64_t weight = coarse.node_weights[coarse_node];
+        const auto &sums = coordinate_sums[coarse_node];
+        coarse.coordinates.emplace_back(
+            util::FixedLongitude{static_cast<std::int32_t>(sums[0] / weight)},
+            util::FixedLatitude{static_cast<std::int32_t>(sums[1] / weight)});
+    }
+
+    makeEdges(coarse, [&](const NodeID coarse_node, std::vector<WeightedEdge> &edges) {
+        edges.clear();
+        for (const auto node : members[coarse_node])
+        {
+            if (node == SPECIAL_NODEID)
+                continue;
+            for (const auto edge : graph.Edges(node))
+                edges.emplace_back(mapping[graph.targets[edge]], graph.edge_weights[edge]);
+        }
+        mergeEdges(coarse_node, edges);
+    });
+    return coarse;
+}
+
+// The inertial flow on the coarsest graph ignores the weights, the refinement accounts for them.
+std::vector<bool> initialCut(const WeightedGraph &graph,
+                             const std::size_t num_slopes,
+                             const double balance,
+                             const double source_sink_rate)
+{
+    std::vector<BisectionInputEdge> edges;
+    edges.reserve(graph.targets.size());
+    for (const auto node : util::irange<NodeID>(0, graph.NumberOfNodes()))
+        for (const auto edge : graph.Edges(node))
+            edges.emplace_back(node, graph.targets[edge]);
+
+    const auto bisection_graph = makeBisectionGraph(graph.coordinates, edges);
+    const GraphView view(bisection_graph);
+    return computeInertialFlowCut(view, num_slopes, balance, source_sink_rate).flags;
+}
+
+// Fiduccia-Mattheyses refinement: every pass moves each node at most once to the other side, in
+// the order of the decrease in the cut weight, even if the cut gets worse. The cut only keeps the
+// moves up to the best state seen in the pass. Moves never make the heavier side heavier than the
+// balance allows, or than it already is. Returns the weight of the cut.
+std::size_t refineCut(const WeightedGraph &graph, std::vector<bool> &sides, const double balance)
+{
+    const auto number_of_nodes = graph.NumberOfNodes();
+    BOOST_ASSERT(sides.size() == number_of_nodes);
+
+    std::array<std::size_t, 2> side_weights{{0, 0}};
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        side_weights[sides[node]] += graph.node_weights[node];
+    const auto allowed_weight =
+        static_cast<std::size_t>(balance * (side_weights[0] + side_weights[1]) / 2);
+
+    // how much the cut decreases if a node switches sides
+    std::vector<std::int64_t> gains(number_of_nodes, 0);
+    std::int64_t cut = 0;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (const auto edge : graph.Edges(node))
+        {
+            const std::int64_t weight = graph.edge_weights[edge];
+            if (sides[graph.targets[edge]] != sides[node])
+            {
+                gains[node] += weight;
+                cut += weight;
+            }
+            else
+            {
+                gains[node] -= weight;
+            }
+        }
+    }
+    cut /= 2;
+
+    const auto move = [&](const NodeID node) {
+        cut -= gains[node];
+        gains[node] = -gains[node];
+        side_weights[sides[node]] -= graph.node_weights[node];
+        sides[node] = !sides[node];
+        side_weights[sides[node]] += graph.node_weights[node];
+
+        for (const auto edge : graph.Edges(node))
+        {
+            const std::int64_t weight = graph.edge_weights[edge];
+            const auto target = graph.targets[edge];
+            gains[target] += sides[target] == sides[node] ? -2 * weight : 2 * weight;
+        }
+    };
+
+    // first reduce the excess weight over the allowed balance, then the cut, then the imbalance
+    const auto rate = [&]() {
+        const auto heavier = std::max(side_weights[0], side_weights[1]);
+        const std::size_t excess = heavier > allowed_weight ? heavier - allowed_weight : 0;
+        return std::make_tuple(excess, cut, heavier);
+    };
+
+    std::vector<bool> locked(number_of_nodes);
+    std::vector<NodeID> moves;
+    for (std::size_t pass = 0; pass < MAX_REFINEMENT_PASSES; ++pass)
+    {
+        std::fill(locked.begin(), locked.end(), false);
+        moves.clear();
+
+        std::priority_queue<std::pair<std::int64_t, NodeID>> queue;
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            const auto edges = graph.Edges(node);
+            if (std::any_of(edges.begin(), edges.end(), [&](const auto edge) {
+                    return sides[graph.targets[edge]] != sides[node];
+                }))
+                queue.emplace(gains[node], node);
+        }
+
+        const auto max_side_weight =
+            std::max(allowed_weight, std::max(side_weights[0], side_weights[1]));
+        auto best = rate();
+        std::size_t best_moves = 0;
+        std::size_t unproductive_moves = 0;
+
+        while (!queue.empty() && unproductive_moves < MAX_UNPRODUCTIVE_MOVES)
+        {
+            const auto node = queue.top().second;
+            const auto gain = queue.top().first;
+            queue.pop();
+
+            // skip outdated entries, the current gain has been queued as well
+            if (locked[node] || gain != gains[node])
+                continue;
+            if (side_weights[!sides[node]] + graph.node_weights[node] > max_side_weight)
+                continue;
+
+            move(node);
+            locked[node] = true;
+            moves.push_back(node);
+
+            for (const auto edge : graph.Edges(node))
+            {
+                const auto target = graph.targets[edge];
+                if (!locked[target])
+                    queue.emplace(gains[target], target);
+            }
+
+            const auto current = rate();
+            if (current < best)
+            {
+                best = current;
+                best_moves = moves.size();
+                unproductive_moves = 0;
+            }
+            else
+            {
+                ++unproductive_moves;
+            }
+        }
+
+        // undo all moves after the best state
+        for (auto index = moves.size(); index > best_moves; --index)
+            move(moves[index - 1]);
+
+        if (best_moves == 0)
+            break;
+    }
+
+    BOOST_ASSERT(cut >= 0);
+    return cut;
+}
+} // namespace
+
+DinicMaxFlow::MinCut computeMultilevelCut(const GraphView &view,
+                                          const std::size_t coarsest_size,
+                                          const std::size_t num_slopes,
+                                          const double balance,
+                                          const double source_sink_rate)
+{
+    BOOST_ASSERT(coarsest_size > 0);
+
+    // coarse nodes should not get much heavier than the average node of the coarsest graph
+    const auto max_node_weight = std::max<std::size_t>(2, 2 * view.NumberOfNodes() / coarsest_size);
+
+    std::vector<WeightedGraph> graphs;
+    std::vector<std::vector<NodeID>> mappings;
+    graphs.push_back(makeWeightedGraph(view));
+    while (graphs.back().NumberOfNodes() > coarsest_size)
+    {
+        const auto number_of_nodes = graphs.back().NumberOfNodes();
+        auto matching = matchHeavyEdges(graphs.back(), max_node_weight);
+        if (matching.second > (1. - MIN_COARSENING_REDUCTION) * number_of_nodes)
+            break;
+
+        graphs.push_back(contract(graphs.back(), matching.first, matching.second));
+        mappings.push_back(std::move(matching.first));
+    }
+
+    auto sides = initialCut(graphs.back(), num_slopes, balance, source_sink_rate);
+    auto cut = refineCut(graphs.back(), sides, balance);
+
+    // project the cut onto the next finer level and improve it there
+    for (auto level = mappings.size(); level > 0; --level)
+    {
+        graphs.pop_back();
+        const auto &mapping = mappings[level - 1];
+        std::vector<bool> finer_sides(mapping.size());
+        for (const auto node : util::irange<NodeID>(0, mapping.size()))
+            finer_sides[node] = sides[mapping[node]];
+        sides = std::move(finer_sides);
+        cut = refineCut(graphs.back(), sides, balance);
+    }
+
+    const std::size_t num_nodes_source = std::count(sides.begin(), sides.end(), true);
+    return {num_nodes_source, cut, std::move(sides)};
+}
+
+} // namespace partition
+} // namespace osrm
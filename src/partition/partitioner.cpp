@@ -12,6 +12,9 @@
 
 #include "extractor/files.hpp"
 
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
 #include "util/coordinate.hpp"
 #include "util/geojson_debug_logger.hpp"
 #include "util/geojson_debug_policies.hpp"
@@ -19,6 +22,7 @@
 #include "util/json_container.hpp"
 #include "util/log.hpp"
 #include "util/mmap_file.hpp"
+#include "util/perf_report.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -113,41 +117,53 @@ auto getGraphBisection(const PartitionConfig &config)
 
     util::Log() << " running partition: " << config.max_cell_sizes.front() << " " << config.balance
                 << " " << config.boundary_factor << " " << config.num_optimizing_cuts << " "
-                << config.small_component_size
-                << " # max_cell_size balance boundary cuts small_component_size";
+                << config.small_component_size << " " << config.coarsening_threshold
+                << " # max_cell_size balance boundary cuts small_component_size"
+                   " coarsening_threshold";
     RecursiveBisection recursive_bisection(graph,
                                            config.max_cell_sizes.front(),
                                            config.balance,
                                            config.boundary_factor,
                                            config.num_optimizing_cuts,
-                                           config.small_component_size);
+                                           config.small_component_size,
+                                           config.coarsening_threshold);
 
     // Return bisection ids, keyed by node based graph nodes
     return recursive_bisection.BisectionIDs();
 }
 
-int Partitioner::Run(const PartitionConfig &config)
+// Number of nodes of the edge based graph, read from the header of the .ebg file
+std::size_t getNumberOfEdgeBasedNodes(const boost::filesystem::path &path)
 {
-    const std::vector<BisectionID> &node_based_partition_ids = getGraphBisection(config);
+    storage::io::FileReader reader(path, storage::io::FileReader::VerifyFingerprint);
+    return reader.ReadElementCount64() + 1;
+}
+
+// Estimated peak memory of LoadEdgeBasedGraph: the edges read from the file, the twice as many
+// directed edges and their tidied copy, which becomes the dynamic graph.
+std::uint64_t estimateEdgeBasedGraphMemory(const boost::filesystem::path &path)
+{
+    return 5 * boost::filesystem::file_size(path);
+}
+
+// Translates the bisection of the compressed node based graph to the edge based graph nodes.
+// The bisection graph, the node based ids and the mapping are freed before this returns.
+std::vector<BisectionID> getEdgeBasedBisection(const PartitionConfig &config)
+{
+    const auto node_based_partition_ids = getGraphBisection(config);
 
     // Up until now we worked on the compressed node based graph.
     // But what we actually need is a partition for the edge based graph to work on.
-    // The following loads a mapping from node based graph to edge based graph.
-    // Then loads the edge based graph tanslates the partition and modifies it.
-    // For details see #3205
+    // The following loads a mapping from node based graph to edge based graph
+    // and translates the partition. For details see #3205
 
     std::vector<extractor::NBGToEBG> mapping;
     extractor::files::readNBGMapping(config.cnbg_ebg_mapping_path.string(), mapping);
     util::Log() << "Loaded node based graph to edge based graph mapping";
 
-    auto edge_based_graph = LoadEdgeBasedGraph(config.edge_based_graph_path);
-    util::Log() << "Loaded edge based graph for mapping partition ids: "
-                << edge_based_graph.GetNumberOfEdges() << " edges, "
-                << edge_based_graph.GetNumberOfNodes() << " nodes";
-
     // Partition ids, keyed by edge based graph nodes
-    std::vector<NodeID> edge_based_partition_ids(edge_based_graph.GetNumberOfNodes(),
-                                                 SPECIAL_NODEID);
+    std::vector<BisectionID> edge_based_partition_ids(
+        getNumberOfEdgeBasedNodes(config.edge_based_graph_path), SPECIAL_NODEID);
 
     // Only resolve all easy cases in the first pass
     for (const auto &entry : mapping)
@@ -159,15 +175,70 @@ int Partitioner::Run(const PartitionConfig &config)
 
         // This heuristic strategy seems to work best, even beating chosing the minimum
         // border edge bisection ID
+        BOOST_ASSERT(forward_node < edge_based_partition_ids.size());
         edge_based_partition_ids[forward_node] = node_based_partition_ids[u];
         if (backward_node != SPECIAL_NODEID)
+        {
+            BOOST_ASSERT(backward_node < edge_based_partition_ids.size());
             edge_based_partition_ids[backward_node] = node_based_partition_ids[v];
+        }
+    }
+
+    return edge_based_partition_ids;
+}
+
+// Loads the edge based graph. If that would exceed the memory budget, the graph is read from a
+// mapping of the file and the partition ids wait on disk while it is built.
+DynamicEdgeBasedGraph loadEdgeBasedGraph(const PartitionConfig &config,
+                                         std::vector<BisectionID> &edge_based_partition_ids)
+{
+    const std::uint64_t ids_memory = edge_based_partition_ids.size() * sizeof(BisectionID);
+    const std::uint64_t graph_memory = estimateEdgeBasedGraphMemory(config.edge_based_graph_path);
+    const auto max_memory = static_cast<std::uint64_t>(config.max_memory * (1 << 30));
+
+    if (config.max_memory <= 0 || ids_memory + graph_memory <= max_memory)
+        return LoadEdgeBasedGraph(config.edge_based_graph_path);
+
+    util::Log() << "Loading the edge based graph needs about "
+                << (ids_memory + graph_memory) / (1 << 20) << " MiB, using external memory";
+
+    const auto ids_path = config.partition_path.string() + ".tmp";
+    {
+        storage::io::FileWriter writer(ids_path, storage::io::FileWriter::HasNoFingerprint);
+        storage::serialization::write(writer, edge_based_partition_ids);
+    }
+    std::vector<BisectionID>().swap(edge_based_partition_ids);
+
+    auto edge_based_graph = LoadMappedEdgeBasedGraph(config.edge_based_graph_path);
+
+    {
+        storage::io::FileReader reader(ids_path, storage::io::FileReader::HasNoFingerprint);
+        storage::serialization::read(reader, edge_based_partition_ids);
     }
+    boost::filesystem::remove(ids_path);
+
+    return edge_based_graph;
+}
+
+int Partitioner::Run(const PartitionConfig &config)
+{
+    util::PerfStage bisection_stage("bisection");
+    auto edge_based_partition_ids = getEdgeBasedBisection(config);
+    bisection_stage.Stop();
+
+    util::PerfStage loading_stage("loading_edge_based_graph");
+    auto edge_based_graph = loadEdgeBasedGraph(config, edge_based_partition_ids);
+    loading_stage.Stop();
+    util::Log() << "Loaded edge based graph for mapping partition ids: "
+                << edge_based_graph.GetNumberOfEdges() << " edges, "
+                << edge_based_graph.GetNumberOfNodes() << " nodes";
+    BOOST_ASSERT(edge_based_partition_ids.size() == edge_based_graph.GetNumberOfNodes());
 
     std::vector<Partition> partitions;
     std::vector<std::uint32_t> level_to_num_cells;
     std::tie(partitions, level_to_num_cells) =
         bisectionToPartition(edge_based_partition_ids, config.max_cell_sizes);
+    std::vector<BisectionID>().swap(edge_based_partition_ids);
 
     auto num_unconnected = removeUnconnectedBoundaryNodes(edge_based_graph, partitions);
     util::Log() << "Fixed " << num_unconnected << " unconnected nodes";
@@ -180,6 +251,7 @@ int Partitioner::Run(const PartitionConfig &config)
     }
 
     TIMER_START(renumber);
+    util::PerfStage renumber_stage("renumber");
     auto permutation = makePermutation(edge_based_graph, partitions);
     renumber(edge_based_graph, permutation);
     renumber(partitions, permutation);
@@ -202,6 +274,7 @@ int Partitioner::Run(const PartitionConfig &config)
         boost::filesystem::remove(config.hsgr_path);
     }
     TIMER_STOP(renumber);
+    renumber_stage.Stop();
     util::Log() << "Renumbered data in " << TIMER_SEC(renumber) << " seconds";
 
     TIMER_START(packed_mlp);
@@ -210,16 +283,20 @@ int Partitioner::Run(const PartitionConfig &config)
     util::Log() << "MultiLevelPartition constructed in " << TIMER_SEC(packed_mlp) << " seconds";
 
     TIMER_START(cell_storage);
+    util::PerfStage cell_storage_stage("cell_storage");
     CellStorage storage(mlp, edge_based_graph);
+    cell_storage_stage.Stop();
     TIMER_STOP(cell_storage);
     util::Log() << "CellStorage constructed in " << TIMER_SEC(cell_storage) << " seconds";
 
     TIMER_START(writing_mld_data);
+    util::PerfStage writing_stage("writing_mld_data");
     files::writePartition(config.partition_path, mlp);
     files::writeCells(config.storage_path, storage);
     extractor::files::writeEdgeBasedGraph(config.edge_based_graph_path,
                                           edge_based_graph.GetNumberOfNodes() - 1,
                                           graphToEdges(edge_based_graph));
+    writing_stage.Stop();
     TIMER_STOP(writing_mld_data);
     util::Log() << "MLD data writing took " << TIMER_SEC(writing_mld_data) << " seconds";
 
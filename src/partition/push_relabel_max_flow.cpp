@@ -0,0 +1,386 @@
+#include "partition/push_relabel_max_flow.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+namespace osrm
+{
+namespace partition
+{
+
+constexpr std::size_t PushRelabelMaxFlow::MIN_PARALLEL_NODES;
+
+namespace
+{
+// nodes that are put onto the next active list / frontier, per thread
+struct LocalNodes
+{
+    std::vector<NodeID> nodes;
+    std::size_t work = 0;
+};
+using NodeBuffer = tbb::enumerable_thread_specific<LocalNodes>;
+
+std::vector<NodeID> flatten(NodeBuffer &buffer, std::size_t &work)
+{
+    std::vector<NodeID> nodes;
+    for (auto &local : buffer)
+    {
+        nodes.insert(nodes.end(), local.nodes.begin(), local.nodes.end());
+        work += local.work;
+    }
+    return nodes;
+}
+
+// collects the distinct neighbours of a node, without the node itself
+void neighbours(const GraphView &view, const NodeID node, std::vector<NodeID> &targets)
+{
+    targets.clear();
+    for (const auto &edge : view.Edges(node))
+        if (edge.target != node)
+            targets.push_back(edge.target);
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+}
+
+// a global relabel is done every time the nodes scanned the arcs of the graph this often
+const constexpr double GLOBAL_RELABEL_FREQUENCY = 0.5;
+} // end namespace
+
+PushRelabelMaxFlow::MinCut PushRelabelMaxFlow::operator()(const GraphView &view,
+                                                          const SourceSinkNodes &source_nodes,
+                                                          const SourceSinkNodes &sink_nodes) const
+{
+    BOOST_ASSERT(DinicMaxFlow().Validate(view, source_nodes, sink_nodes));
+
+    const auto number_of_nodes = view.NumberOfNodes();
+
+    State state{MakeResidualGraph(view),
+                std::vector<NodeKind>(number_of_nodes, NodeKind::Inner),
+                std::vector<Label>(number_of_nodes, 0),
+                std::vector<Capacity>(number_of_nodes, 0),
+                std::vector<std::atomic<Capacity>>(number_of_nodes),
+                std::vector<std::atomic<std::uint32_t>>(number_of_nodes),
+                std::vector<std::atomic<std::uint32_t>>(number_of_nodes)};
+
+    for (const auto node : source_nodes)
+        state.kinds[node] = NodeKind::Source;
+    for (const auto node : sink_nodes)
+        state.kinds[node] = NodeKind::Sink;
+
+    auto active = SaturateSources(state);
+
+    const auto relabel_work = static_cast<std::size_t>(
+        GLOBAL_RELABEL_FREQUENCY * (number_of_nodes + state.graph.targets.size()));
+    std::size_t work = relabel_work;
+
+    while (!active.empty())
+    {
+        if (work >= relabel_work)
+        {
+            GlobalRelabel(state);
+            work = 0;
+
+            // nodes that cannot reach the sinks anymore keep their excess
+            active.erase(std::remove_if(active.begin(),
+                                        active.end(),
+                                        [&](const NodeID node) {
+                                            return state.labels[node] >= number_of_nodes;
+                                        }),
+                         active.end());
+        }
+
+        active = Discharge(state, active, work);
+    }
+
+    // the labels of the nodes that can still reach a sink in the residual graph are valid
+    // distances, all others are on the source side of the cut
+    GlobalRelabel(state);
+
+    std::size_t flow_value = 0;
+    for (const auto node : sink_nodes)
+        flow_value += state.added_excess[node].load(std::memory_order_relaxed);
+
+    std::vector<bool> flags(number_of_nodes);
+    std::size_t num_nodes_source = 0;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        flags[node] = state.labels[node] >= number_of_nodes;
+        num_nodes_source += flags[node];
+    }
+
+    return {num_nodes_source, flow_value, std::move(flags)};
+}
+
+PushRelabelMaxFlow::ResidualGraph
+PushRelabelMaxFlow::MakeResidualGraph(const GraphView &view) const
+{
+    const NodeID number_of_nodes = view.NumberOfNodes();
+    const tbb::blocked_range<NodeID> range(0, number_of_nodes);
+
+    ResidualGraph graph;
+    graph.first_arcs.resize(number_of_nodes + 1, 0);
+
+    tbb::enumerable_thread_specific<std::vector<NodeID>> buffer;
+    tbb::parallel_for(range, [&](const tbb::blocked_range<NodeID> &nodes) {
+        auto &targets = buffer.local();
+        for (auto node = nodes.begin(); node != nodes.end(); ++node)
+        {
+            neighbours(view, node, targets);
+            graph.first_arcs[node + 1] = targets.size();
+        }
+    });
+    std::partial_sum(graph.first_arcs.begin(), graph.first_arcs.end(), graph.first_arcs.begin());
+
+    const auto number_of_arcs = graph.first_arcs.back();
+    graph.targets.resize(number_of_arcs);
+    graph.reverse_arcs.resize(number_of_arcs);
+    graph.residuals.resize(number_of_arcs, 1);
+
+    tbb::parallel_for(range, [&](const tbb::blocked_range<NodeID> &nodes) {
+        auto &targets = buffer.local();
+        for (auto node = nodes.begin(); node != nodes.end(); ++node)
+        {
+            neighbours(view, node, targets);
+            std::copy(
+                targets.begin(), targets.end(), graph.targets.begin() + graph.first_arcs[node]);
+        }
+    });
+
+    // the graph is undirected, so every arc has its reverse arc in the adjacency of its target
+    tbb::parallel_for(range, [&](const tbb::blocked_range<NodeID> &nodes) {
+        for (auto node = nodes.begin(); node != nodes.end(); ++node)
+        {
+            for (auto arc = graph.first_arcs[node]; arc != graph.first_arcs[node + 1]; ++arc)
+            {
+                const auto target = graph.targets[arc];
+                const auto begin = graph.targets.begin() + graph.first_arcs[target];
+                const auto end = graph.targets.begin() + graph.first_arcs[target + 1];
+                const auto reverse = std::lower_bound(begin, end, node);
+                BOOST_ASSERT(reverse != end && *reverse == node);
+                graph.reverse_arcs[arc] = std::distance(graph.targets.begin(), reverse);
+            }
+        }
+    });
+
+    return graph;
+}
+
+std::vector<NodeID> PushRelabelMaxFlow::SaturateSources(State &state) const
+{
+    auto &graph = state.graph;
+    const NodeID number_of_nodes = state.kinds.size();
+
+    ++state.round;
+    NodeBuffer next_buffer;
+    tbb::parallel_for(
+        tbb::blocked_range<NodeID>(0, number_of_nodes),
+        [&](const tbb::blocked_range<NodeID> &nodes) {
+            auto &next = next_buffer.local();
+            for (auto node = nodes.begin(); node != nodes.end(); ++node)
+            {
+                if (state.kinds[node] != NodeKind::Source)
+                    continue;
+
+                for (auto arc = graph.first_arcs[node]; arc != graph.first_arcs[node + 1]; ++arc)
+                {
+                    const auto target = graph.targets[arc];
+                    if (state.kinds[target] == NodeKind::Source)
+                        continue;
+
+                    // arcs out of sources are only ever touched here, by the source itself
+                    const auto delta = graph.residuals[arc];
+                    graph.residuals[arc] -= delta;
+                    graph.residuals[graph.reverse_arcs[arc]] += delta;
+                    state.added_excess[target].fetch_add(delta, std::memory_order_relaxed);
+
+                    if (state.kinds[target] == NodeKind::Inner &&
+                        state.queued[target].exchange(state.round, std::memory_order_relaxed) !=
+                            state.round)
+                        next.nodes.push_back(target);
+                }
+            }
+        });
+
+    std::size_t work = 0;
+    auto active = flatten(next_buffer, work);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, active.size()),
+                      [&](const tbb::blocked_range<std::size_t> &indices) {
+                          for (auto index = indices.begin(); index != indices.end(); ++index)
+                          {
+                              const auto node = active[index];
+                              state.excess[node] = state.added_excess[node].exchange(0);
+                          }
+                      });
+    return active;
+}
+
+std::vector<NodeID> PushRelabelMaxFlow::Discharge(State &state,
+                                                  const std::vector<NodeID> &active,
+                                                  std::size_t &work) const
+{
+    auto &graph = state.graph;
+    const Label number_of_nodes = state.kinds.size();
+    const tbb::blocked_range<std::size_t> active_range(0, active.size());
+
+    ++state.round;
+    NodeBuffer next_buffer;
+
+    const auto enqueue = [&state](const NodeID node, LocalNodes &next) {
+        if (state.queued[node].exchange(state.round, std::memory_order_relaxed) != state.round)
+            next.nodes.push_back(node);
+    };
+
+    // Push along all admissible arcs. Only the upper end of an arc (v,w) with label(v) = label(w)
+    // + 1 can push along it, so the residuals of (v,w) and (w,v) are only written by v.
+    tbb::parallel_for(active_range, [&](const tbb::blocked_range<std::size_t> &indices) {
+        auto &next = next_buffer.local();
+        for (auto index = indices.begin(); index != indices.end(); ++index)
+        {
+            const auto node = active[index];
+            const auto label = state.labels[node];
+            auto excess = state.excess[node];
+
+            const auto end = graph.first_arcs[node + 1];
+            auto arc = graph.first_arcs[node];
+            for (; arc != end && excess > 0; ++arc)
+            {
+                const auto target = graph.targets[arc];
+                // check the labels first, the residual might be written by the target otherwise
+                if (label != state.labels[target] + 1 || graph.residuals[arc] == 0)
+                    continue;
+
+                const auto delta = std::min(excess, graph.residuals[arc]);
+                graph.residuals[arc] -= delta;
+                graph.residuals[graph.reverse_arcs[arc]] += delta;
+                excess -= delta;
+                state.added_excess[target].fetch_add(delta, std::memory_order_relaxed);
+
+                if (state.kinds[target] == NodeKind::Inner)
+                    enqueue(target, next);
+            }
+            next.work += arc - graph.first_arcs[node];
+            state.excess[node] = excess;
+        }
+    });
+
+    // Relabel all nodes with excess left. They have no admissible arcs anymore, so their labels
+    // increase. The new labels are computed from the old ones, so they are valid in any order.
+    std::vector<Label> new_labels(active.size());
+    tbb::parallel_for(active_range, [&](const tbb::blocked_range<std::size_t> &indices) {
+        auto &next = next_buffer.local();
+        for (auto index = indices.begin(); index != indices.end(); ++index)
+        {
+            const auto node = active[index];
+            new_labels[index] = state.labels[node];
+            if (state.excess[node] == 0)
+                continue;
+
+            Label new_label = number_of_nodes;
+            for (auto arc = graph.first_arcs[node]; arc != graph.first_arcs[node + 1]; ++arc)
+                if (graph.residuals[arc] > 0)
+                    new_label = std::min(new_label, state.labels[graph.targets[arc]] + 1);
+            next.work += graph.first_arcs[node + 1] - graph.first_arcs[node];
+
+            BOOST_ASSERT(new_label > state.labels[node]);
+            new_labels[index] = new_label;
+            enqueue(node, next);
+        }
+    });
+
+    tbb::parallel_for(active_range, [&](const tbb::blocked_range<std::size_t> &indices) {
+        for (auto index = indices.begin(); index != indices.end(); ++index)
+            state.labels[active[index]] = new_labels[index];
+    });
+
+    auto next_active = flatten(next_buffer, work);
+
+    // add the received excess and drop all nodes that got relabeled to the source side
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, next_active.size()),
+                      [&](const tbb::blocked_range<std::size_t> &indices) {
+                          for (auto index = indices.begin(); index != indices.end(); ++index)
+                          {
+                              const auto node = next_active[index];
+                              state.excess[node] += state.added_excess[node].exchange(0);
+                          }
+                      });
+    next_active.erase(std::remove_if(next_active.begin(),
+                                     next_active.end(),
+                                     [&](const NodeID node) {
+                                         return state.labels[node] >= number_of_nodes;
+                                     }),
+                      next_active.end());
+
+    return next_active;
+}
+
+void PushRelabelMaxFlow::GlobalRelabel(State &state) const
+{
+    const auto &graph = state.graph;
+    const Label number_of_nodes = state.kinds.size();
+
+    ++state.relabel_round;
+    NodeBuffer next_buffer;
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                      [&](const tbb::blocked_range<NodeID> &nodes) {
+                          auto &next = next_buffer.local();
+                          for (auto node = nodes.begin(); node != nodes.end(); ++node)
+                          {
+                              if (state.kinds[node] == NodeKind::Sink)
+                              {
+                                  state.labels[node] = 0;
+                                  state.reached[node].store(state.relabel_round,
+                                                            std::memory_order_relaxed);
+                                  next.nodes.push_back(node);
+                              }
+                              else
+                              {
+                                  state.labels[node] = number_of_nodes;
+                              }
+                          }
+                      });
+
+    std::size_t work = 0;
+    auto frontier = flatten(next_buffer, work);
+    for (Label level = 1; !frontier.empty(); ++level)
+    {
+        next_buffer.clear();
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, frontier.size()),
+            [&](const tbb::blocked_range<std::size_t> &indices) {
+                auto &next = next_buffer.local();
+                for (auto index = indices.begin(); index != indices.end(); ++index)
+                {
+                    const auto node = frontier[index];
+                    for (auto arc = graph.first_arcs[node]; arc != graph.first_arcs[node + 1];
+                         ++arc)
+                    {
+                        // follow arcs backwards that can still send flow towards the sinks
+                        const auto target = graph.targets[arc];
+                        if (state.kinds[target] != NodeKind::Inner ||
+                            graph.residuals[graph.reverse_arcs[arc]] == 0)
+                            continue;
+
+                        if (state.reached[target].exchange(state.relabel_round,
+                                                           std::memory_order_relaxed) !=
+                            state.relabel_round)
+                        {
+                            state.labels[target] = level;
+                            next.nodes.push_back(target);
+                        }
+                    }
+                }
+            });
+        frontier = flatten(next_buffer, work);
+    }
+}
+
+} // namespace partition
+} // namespace osrm
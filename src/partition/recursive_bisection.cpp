@@ -1,5 +1,6 @@
 #include "partition/recursive_bisection.hpp"
 #include "partition/inertial_flow.hpp"
+#include "partition/multilevel_cut.hpp"
 
 #include "partition/graph_view.hpp"
 #include "partition/recursive_bisection_state.hpp"
@@ -27,7 +28,8 @@ RecursiveBisection::RecursiveBisection(BisectionGraph &bisection_graph_,
                                        const double balance,
                                        const double boundary_factor,
                                        const std::size_t num_optimizing_cuts,
-                                       const std::size_t small_component_size)
+                                       const std::size_t small_component_size,
+                                       const std::size_t coarsening_threshold)
     : bisection_graph(bisection_graph_), internal_state(bisection_graph_)
 {
     auto components = internal_state.PrePartitionWithSCC(small_component_size);
@@ -70,8 +72,16 @@ RecursiveBisection::RecursiveBisection(BisectionGraph &bisection_graph_,
 
     // Bisect graph into two parts. Get partition point and recurse left and right in parallel.
     tbb::parallel_do(begin(forest), end(forest), [&](const TreeNode &node, Feeder &feeder) {
-        const auto cut =
-            computeInertialFlowCut(node.graph, num_optimizing_cuts, balance, boundary_factor);
+        // large cells are bisected on a coarsened graph
+        const auto coarsen =
+            coarsening_threshold > 0 && node.graph.NumberOfNodes() > coarsening_threshold;
+        const auto cut = coarsen ? computeMultilevelCut(node.graph,
+                                                        coarsening_threshold,
+                                                        num_optimizing_cuts,
+                                                        balance,
+                                                        boundary_factor)
+                                 : computeInertialFlowCut(
+                                       node.graph, num_optimizing_cuts, balance, boundary_factor);
         const auto center = internal_state.ApplyBisection(
             node.graph.Begin(), node.graph.End(), node.depth, cut.flags);
 
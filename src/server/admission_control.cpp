@@ -0,0 +1,86 @@
+#include "server/admission_control.hpp"
+
+#include <sstream>
+
+namespace osrm
+{
+namespace server
+{
+
+AdmissionControl::Ticket::~Ticket()
+{
+    if (state)
+    {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            --state->running;
+        }
+        state->slot_released.notify_one();
+    }
+}
+
+AdmissionControl::AdmissionControl(const std::unordered_map<std::string, ServiceLimits> &limits,
+                                   const std::chrono::milliseconds max_wait)
+    : max_wait(max_wait)
+{
+    for (const auto &service_limits : limits)
+    {
+        auto state = std::make_unique<ServiceState>();
+        state->limits = service_limits.second;
+        services.emplace(service_limits.first, std::move(state));
+    }
+}
+
+AdmissionControl::Ticket AdmissionControl::Admit(const std::string &service)
+{
+    const auto iter = services.find(service);
+    if (iter == services.end())
+    {
+        return Ticket::Unlimited();
+    }
+    auto &state = *iter->second;
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    // new requests don't overtake the ones that are already waiting
+    if (state.waiting == 0 && state.running < state.limits.max_concurrent)
+    {
+        ++state.running;
+        return Ticket(&state, true);
+    }
+
+    if (state.waiting >= state.limits.max_queued)
+    {
+        ++state.rejected;
+        return Ticket(nullptr, false);
+    }
+
+    ++state.waiting;
+    const auto has_slot = state.slot_released.wait_for(
+        lock, max_wait, [&state] { return state.running < state.limits.max_concurrent; });
+    --state.waiting;
+
+    if (!has_slot)
+    {
+        ++state.rejected;
+        return Ticket(nullptr, false);
+    }
+
+    ++state.running;
+    return Ticket(&state, true);
+}
+
+std::string AdmissionControl::DumpPrometheus() const
+{
+    std::stringstream out;
+    out << "# HELP osrm_rejected_requests_total Requests rejected because their service was at "
+           "its concurrency limit.\n";
+    out << "# TYPE osrm_rejected_requests_total counter\n";
+    for (const auto &service : services)
+    {
+        out << "osrm_rejected_requests_total{service=\"" << service.first << "\"} "
+            << service.second->rejected.load() << "\n";
+    }
+    return out.str();
+}
+}
+}
@@ -0,0 +1,359 @@
+#include "server/api/body_parser.hpp"
+
+#include "engine/hint.hpp"
+#include "util/coordinate.hpp"
+
+#include "rapidjson/reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace osrm
+{
+namespace server
+{
+namespace api
+{
+
+namespace
+{
+enum class Member
+{
+    None,
+    Coordinates,
+    Hints,
+    Radiuses,
+    Bearings,
+    Approaches,
+    Sources,
+    Destinations,
+    Timestamps
+};
+
+Member getMember(const char *key, const rapidjson::SizeType length)
+{
+    const auto is = [key, length](const char *name) {
+        return std::strlen(name) == length && std::equal(key, key + length, name);
+    };
+    if (is("coordinates"))
+        return Member::Coordinates;
+    if (is("hints"))
+        return Member::Hints;
+    if (is("radiuses"))
+        return Member::Radiuses;
+    if (is("bearings"))
+        return Member::Bearings;
+    if (is("approaches"))
+        return Member::Approaches;
+    if (is("sources"))
+        return Member::Sources;
+    if (is("destinations"))
+        return Member::Destinations;
+    if (is("timestamps"))
+        return Member::Timestamps;
+    return Member::None;
+}
+
+bool isHintCharacter(const char character)
+{
+    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') ||
+           (character >= '0' && character <= '9') || character == '-' || character == '_' ||
+           character == '=';
+}
+
+// Receives the values of the body as the reader comes across them, the object is at depth 1,
+// the lists of its members at depth 2 and the pairs of coordinates and bearings at depth 3.
+class BodyHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, BodyHandler>
+{
+  public:
+    explicit BodyHandler(BodyParameters &parameters) : parameters(parameters) {}
+
+    bool Default() { return false; }
+
+    bool Null()
+    {
+        if (depth != 2)
+            return false;
+        auto &base = parameters.base;
+        switch (member)
+        {
+        case Member::Hints:
+            Reserve(base.hints).emplace_back(boost::none);
+            return true;
+        case Member::Radiuses:
+            Reserve(base.radiuses).emplace_back(boost::none);
+            return true;
+        case Member::Bearings:
+            Reserve(base.bearings).emplace_back(boost::none);
+            return true;
+        case Member::Approaches:
+            Reserve(base.approaches).emplace_back(boost::none);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // the reader reports non-negative integers as unsigned
+    bool Uint(const unsigned value) { return Index(value); }
+    bool Uint64(const std::uint64_t value) { return Index(value); }
+    bool Int(const int value) { return Number(value); }
+    bool Int64(const std::int64_t value) { return Number(static_cast<double>(value)); }
+    bool Double(const double value) { return Number(value); }
+
+    bool String(const char *value, const rapidjson::SizeType length, bool)
+    {
+        if (depth != 2)
+            return false;
+        auto &base = parameters.base;
+        if (member == Member::Hints)
+        {
+            if (length == 0)
+            {
+                Reserve(base.hints).emplace_back(boost::none);
+                return true;
+            }
+            if (length != engine::ENCODED_HINT_SIZE ||
+                !std::all_of(value, value + length, isHintCharacter))
+                return false;
+            Reserve(base.hints).emplace_back(engine::Hint::FromBase64(value, value + length));
+            return true;
+        }
+        const std::string text(value, length);
+        if (member == Member::Radiuses && text == "unlimited")
+        {
+            Reserve(base.radiuses).emplace_back(std::numeric_limits<double>::infinity());
+            return true;
+        }
+        if (member == Member::Approaches && (text == "curb" || text == "unrestricted"))
+        {
+            Reserve(base.approaches)
+                .emplace_back(text == "curb" ? engine::Approach::CURB
+                                             : engine::Approach::UNRESTRICTED);
+            return true;
+        }
+        return false;
+    }
+
+    bool StartObject() { return depth++ == 0; }
+
+    bool Key(const char *key, const rapidjson::SizeType length, bool)
+    {
+        member = getMember(key, length);
+        if (depth != 1 || member == Member::None)
+            return false;
+        // a list given twice would be joined
+        const auto bit = 1u << static_cast<unsigned>(member);
+        if (seen_members & bit)
+            return false;
+        seen_members |= bit;
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType)
+    {
+        --depth;
+        return depth == 0 && !parameters.base.coordinates.empty();
+    }
+
+    bool StartArray()
+    {
+        if (depth == 1 && member != Member::None)
+        {
+            ++depth;
+            return true;
+        }
+        if (depth == 2 && (member == Member::Coordinates || member == Member::Bearings))
+        {
+            ++depth;
+            pair_size = 0;
+            return true;
+        }
+        return false;
+    }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+        --depth;
+        if (depth == 1)
+        {
+            member = Member::None;
+            return true;
+        }
+        if (pair_size != 2)
+            return false;
+        if (member == Member::Coordinates)
+        {
+            parameters.base.coordinates.emplace_back(util::UnsafeFloatLongitude{pair[0]},
+                                                     util::UnsafeFloatLatitude{pair[1]});
+            return true;
+        }
+        Reserve(parameters.base.bearings)
+            .emplace_back(engine::Bearing{static_cast<short>(pair[0]),
+                                          static_cast<short>(pair[1])});
+        return true;
+    }
+
+  private:
+    // lists per coordinate are as long as the coordinates if those come first
+    template <typename T> std::vector<T> &Reserve(std::vector<T> &list) const
+    {
+        if (list.empty())
+            list.reserve(parameters.base.coordinates.size());
+        return list;
+    }
+
+    bool Index(const std::uint64_t value)
+    {
+        if (depth == 2 && (member == Member::Sources || member == Member::Destinations))
+        {
+            auto &indices =
+                member == Member::Sources ? parameters.sources : parameters.destinations;
+            indices.push_back(value);
+            return true;
+        }
+        if (depth == 2 && member == Member::Timestamps)
+        {
+            if (value > std::numeric_limits<unsigned>::max())
+                return false;
+            parameters.timestamps.push_back(static_cast<unsigned>(value));
+            return true;
+        }
+        return Number(static_cast<double>(value));
+    }
+
+    bool Number(const double value)
+    {
+        if (depth == 2 && member == Member::Radiuses)
+        {
+            Reserve(parameters.base.radiuses).emplace_back(value);
+            return true;
+        }
+        if (depth != 3 || pair_size == 2)
+            return false;
+        // bearings are whole degrees as in the URL
+        if (member == Member::Bearings &&
+            (value != std::trunc(value) || value < std::numeric_limits<short>::min() ||
+             value > std::numeric_limits<short>::max()))
+            return false;
+        pair[pair_size++] = value;
+        return true;
+    }
+
+    BodyParameters &parameters;
+    Member member = Member::None;
+    unsigned seen_members = 0;
+    unsigned depth = 0;
+    double pair[2];
+    std::size_t pair_size = 0;
+};
+
+const constexpr std::size_t BINARY_COORDINATE_SIZE = 2 * sizeof(std::int32_t);
+
+template <typename Range> void appendList(std::string &query, const Range &range)
+{
+    for (auto element = range.begin(); element != range.end(); ++element)
+    {
+        if (element != range.begin())
+            query.push_back(';');
+        query += *element;
+    }
+}
+}
+
+bool parseJSONBody(const std::string &body, BodyParameters &parameters)
+{
+    BodyHandler handler(parameters);
+    rapidjson::StringStream stream(body.c_str());
+    rapidjson::Reader reader;
+    // a 0 byte would end the stream before the end of the body
+    return reader.Parse(stream, handler) && stream.Tell() == body.size();
+}
+
+bool parseBinaryBody(const std::string &body, BodyParameters &parameters)
+{
+    if (body.empty() || body.size() % BINARY_COORDINATE_SIZE != 0)
+        return false;
+
+    auto &coordinates = parameters.base.coordinates;
+    coordinates.reserve(body.size() / BINARY_COORDINATE_SIZE);
+    for (std::size_t offset = 0; offset < body.size(); offset += BINARY_COORDINATE_SIZE)
+    {
+        std::int32_t lon, lat;
+        std::memcpy(&lon, body.data() + offset, sizeof(lon));
+        std::memcpy(&lat, body.data() + offset + sizeof(lon), sizeof(lat));
+        coordinates.emplace_back(util::FixedLongitude{lon}, util::FixedLatitude{lat});
+    }
+    return true;
+}
+
+void prependBodyQuery(const BodyParameters &parameters, std::string &query)
+{
+    const auto &base = parameters.base;
+    const auto toString = [](const auto value) {
+        return std::to_string(static_cast<double>(value));
+    };
+
+    std::vector<std::string> values;
+    for (const auto coordinate : base.coordinates)
+    {
+        values.push_back(toString(util::toFloating(coordinate.lon)) + ',' +
+                         toString(util::toFloating(coordinate.lat)));
+    }
+    std::string text;
+    appendList(text, values);
+
+    // the extension, e.g. .json, stays in front of the options
+    const auto separator = query.find('?');
+    text += query.substr(0, separator);
+
+    std::vector<std::string> options;
+    const auto addOption = [&options, &values](const char *name) {
+        if (values.empty())
+            return;
+        options.push_back(name);
+        appendList(options.back(), values);
+        values.clear();
+    };
+
+    values.clear();
+    for (const auto &hint : base.hints)
+        values.push_back(hint ? hint->ToBase64() : "");
+    addOption("hints=");
+    for (const auto &radius : base.radiuses)
+        values.push_back(!radius ? "" : std::isinf(*radius) ? "unlimited" : toString(*radius));
+    addOption("radiuses=");
+    for (const auto &bearing : base.bearings)
+        values.push_back(bearing ? std::to_string(bearing->bearing) + ',' +
+                                       std::to_string(bearing->range)
+                                 : "");
+    addOption("bearings=");
+    for (const auto &approach : base.approaches)
+        values.push_back(!approach ? "" : *approach == engine::Approach::CURB ? "curb"
+                                                                                : "unrestricted");
+    addOption("approaches=");
+    for (const auto source : parameters.sources)
+        values.push_back(std::to_string(source));
+    addOption("sources=");
+    for (const auto destination : parameters.destinations)
+        values.push_back(std::to_string(destination));
+    addOption("destinations=");
+    for (const auto timestamp : parameters.timestamps)
+        values.push_back(std::to_string(timestamp));
+    addOption("timestamps=");
+
+    if (separator != std::string::npos)
+        options.push_back(query.substr(separator + 1));
+    for (auto option = options.begin(); option != options.end(); ++option)
+    {
+        text.push_back(option == options.begin() ? '?' : '&');
+        text += *option;
+    }
+    query = std::move(text);
+}
+}
+}
+}
@@ -1,5 +1,7 @@
 #include "server/api/parameters_parser.hpp"
 
+#include "server/api/coordinate_list_parser.hpp"
+#include "server/api/isochrone_parameter_grammar.hpp"
 #include "server/api/match_parameter_grammar.hpp"
 #include "server/api/nearest_parameter_grammar.hpp"
 #include "server/api/route_parameters_grammar.hpp"
@@ -7,6 +9,9 @@
 #include "server/api/tile_parameter_grammar.hpp"
 #include "server/api/trip_parameter_grammar.hpp"
 
+#include "util/request_timing.hpp"
+
+#include <algorithm>
 #include <type_traits>
 
 namespace osrm
@@ -26,22 +31,88 @@ using is_grammar_t =
                                std::is_same<NearestParametersGrammar<>, T>::value ||
                                std::is_same<TripParametersGrammar<>, T>::value ||
                                std::is_same<MatchParametersGrammar<>, T>::value ||
-                               std::is_same<TileParametersGrammar<>, T>::value>;
+                               std::is_same<TileParametersGrammar<>, T>::value ||
+                               std::is_same<IsochroneParametersGrammar<>, T>::value>;
+
+// The coordinates are the part of the query up to the options, there is one more coordinate
+// than separators between them. A polyline just reserves one. Plain coordinate lists are
+// parsed right away, the grammar skips the coordinates then.
+template <typename ParameterT,
+          typename std::enable_if<
+              std::is_base_of<engine::api::BaseParameters, ParameterT>::value, int>::type = 0>
+void parseCoordinates(ParameterT &parameters,
+                      std::string::iterator &iter,
+                      const std::string::iterator end)
+{
+    parameters.coordinates.reserve(1 + std::count(iter, std::find(iter, end, '?'), ';'));
+    parseCoordinateList(iter, end, parameters.coordinates);
+}
+
+template <typename ParameterT,
+          typename std::enable_if<
+              !std::is_base_of<engine::api::BaseParameters, ParameterT>::value, int>::type = 0>
+void parseCoordinates(ParameterT &, std::string::iterator &, const std::string::iterator)
+{
+}
+
+// The lists of a body are moved, the ones that the service does not have fail the parsing
+void moveBase(BodyParameters &body, engine::api::BaseParameters &parameters)
+{
+    parameters.coordinates = std::move(body.base.coordinates);
+    parameters.hints = std::move(body.base.hints);
+    parameters.radiuses = std::move(body.base.radiuses);
+    parameters.bearings = std::move(body.base.bearings);
+    parameters.approaches = std::move(body.base.approaches);
+}
+
+bool moveBody(BodyParameters &body, engine::api::BaseParameters &parameters)
+{
+    moveBase(body, parameters);
+    return body.sources.empty() && body.destinations.empty() && body.timestamps.empty();
+}
+
+bool moveBody(BodyParameters &body, engine::api::TableParameters &parameters)
+{
+    moveBase(body, parameters);
+    parameters.sources = std::move(body.sources);
+    parameters.destinations = std::move(body.destinations);
+    return body.timestamps.empty();
+}
+
+bool moveBody(BodyParameters &body, engine::api::MatchParameters &parameters)
+{
+    moveBase(body, parameters);
+    parameters.timestamps = std::move(body.timestamps);
+    return body.sources.empty() && body.destinations.empty();
+}
+
+bool moveBody(BodyParameters &, engine::api::TileParameters &) { return false; }
 
 template <typename ParameterT,
           typename GrammarT,
           typename std::enable_if<detail::is_parameter_t<ParameterT>::value, int>::type = 0,
           typename std::enable_if<detail::is_grammar_t<GrammarT>::value, int>::type = 0>
-boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
+boost::optional<ParameterT> parseParameters(boost::optional<BodyParameters> &body,
+                                            std::string::iterator &iter,
                                             const std::string::iterator end)
 {
     using It = std::decay<decltype(iter)>::type;
 
     static const GrammarT grammar;
+    util::ScopedStageTimer parse_timer(util::RequestStage::Parse);
 
     try
     {
         ParameterT parameters;
+        if (body)
+        {
+            if (!moveBody(*body, parameters))
+                return boost::none;
+        }
+        else
+        {
+            parseCoordinates(parameters, iter, end);
+        }
         const auto ok =
             boost::spirit::qi::parse(iter, end, grammar(boost::phoenix::ref(parameters)));
 
@@ -66,49 +137,73 @@ boost::optional<ParameterT> parseParameters(std::string::iterator &iter,
 } // ns detail
 
 template <>
-boost::optional<engine::api::RouteParameters> parseParameters(std::string::iterator &iter,
-                                                              const std::string::iterator end)
+boost::optional<engine::api::RouteParameters>
+parseParameters(boost::optional<BodyParameters> &body,
+                std::string::iterator &iter,
+                const std::string::iterator end)
+{
+    return detail::parseParameters<engine::api::RouteParameters, RouteParametersGrammar<>>(
+        body, iter, end);
+}
+
+template <>
+boost::optional<engine::api::TableParameters>
+parseParameters(boost::optional<BodyParameters> &body,
+                std::string::iterator &iter,
+                const std::string::iterator end)
 {
-    return detail::parseParameters<engine::api::RouteParameters, RouteParametersGrammar<>>(iter,
-                                                                                           end);
+    return detail::parseParameters<engine::api::TableParameters, TableParametersGrammar<>>(
+        body, iter, end);
 }
 
 template <>
-boost::optional<engine::api::TableParameters> parseParameters(std::string::iterator &iter,
-                                                              const std::string::iterator end)
+boost::optional<engine::api::NearestParameters>
+parseParameters(boost::optional<BodyParameters> &body,
+                std::string::iterator &iter,
+                const std::string::iterator end)
 {
-    return detail::parseParameters<engine::api::TableParameters, TableParametersGrammar<>>(iter,
-                                                                                           end);
+    return detail::parseParameters<engine::api::NearestParameters, NearestParametersGrammar<>>(
+        body, iter, end);
 }
 
 template <>
-boost::optional<engine::api::NearestParameters> parseParameters(std::string::iterator &iter,
-                                                                const std::string::iterator end)
+boost::optional<engine::api::TripParameters>
+parseParameters(boost::optional<BodyParameters> &body,
+                std::string::iterator &iter,
+                const std::string::iterator end)
 {
-    return detail::parseParameters<engine::api::NearestParameters, NearestParametersGrammar<>>(iter,
-                                                                                               end);
+    return detail::parseParameters<engine::api::TripParameters, TripParametersGrammar<>>(
+        body, iter, end);
 }
 
 template <>
-boost::optional<engine::api::TripParameters> parseParameters(std::string::iterator &iter,
-                                                             const std::string::iterator end)
+boost::optional<engine::api::MatchParameters>
+parseParameters(boost::optional<BodyParameters> &body,
+                std::string::iterator &iter,
+                const std::string::iterator end)
 {
-    return detail::parseParameters<engine::api::TripParameters, TripParametersGrammar<>>(iter, end);
+    return detail::parseParameters<engine::api::MatchParameters, MatchParametersGrammar<>>(
+        body, iter, end);
 }
 
 template <>
-boost::optional<engine::api::MatchParameters> parseParameters(std::string::iterator &iter,
-                                                              const std::string::iterator end)
+boost::optional<engine::api::TileParameters>
+parseParameters(boost::optional<BodyParameters> &body,
+                std::string::iterator &iter,
+                const std::string::iterator end)
 {
-    return detail::parseParameters<engine::api::MatchParameters, MatchParametersGrammar<>>(iter,
-                                                                                           end);
+    return detail::parseParameters<engine::api::TileParameters, TileParametersGrammar<>>(
+        body, iter, end);
 }
 
 template <>
-boost::optional<engine::api::TileParameters> parseParameters(std::string::iterator &iter,
-                                                             const std::string::iterator end)
+boost::optional<engine::api::IsochroneParameters>
+parseParameters(boost::optional<BodyParameters> &body,
+                std::string::iterator &iter,
+                const std::string::iterator end)
 {
-    return detail::parseParameters<engine::api::TileParameters, TileParametersGrammar<>>(iter, end);
+    return detail::parseParameters<engine::api::IsochroneParameters, IsochroneParametersGrammar<>>(
+        body, iter, end);
 }
 
 } // ns api
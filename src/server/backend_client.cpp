@@ -0,0 +1,190 @@
+#include "server/backend_client.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/asio.hpp>
+
+#include <memory>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+using boost::asio::ip::tcp;
+
+struct Connection
+{
+    Connection(boost::asio::io_service &io_service) : resolver(io_service), socket(io_service) {}
+
+    tcp::resolver resolver;
+    tcp::socket socket;
+    std::string request;
+    boost::asio::streambuf response;
+};
+
+std::string makeRequest(const BackendRequest &request)
+{
+    auto message = (request.body.empty() ? "GET " : "POST ") + request.uri +
+                   " HTTP/1.0\r\nHost: " + request.backend.host + "\r\nConnection: close\r\n";
+    if (!request.body.empty())
+    {
+        message += "Content-Type: text/plain\r\nContent-Length: " +
+                   std::to_string(request.body.size()) + "\r\n";
+    }
+    for (const auto &header : request.headers)
+    {
+        message += header.first + ": " + header.second + "\r\n";
+    }
+    message += "\r\n";
+    return message + request.body;
+}
+
+BackendReply parseReply(const Backend &backend, const boost::asio::streambuf &response)
+{
+    const std::string reply{boost::asio::buffers_begin(response.data()),
+                            boost::asio::buffers_end(response.data())};
+    const auto headers_end = reply.find("\r\n\r\n");
+    const auto status_begin = reply.find(' ');
+    if (headers_end == std::string::npos || status_begin == std::string::npos ||
+        status_begin > headers_end)
+    {
+        throw util::exception("Malformed reply of backend " + backend.host + ":" + backend.port +
+                              SOURCE_REF);
+    }
+
+    BackendReply parsed_reply;
+    parsed_reply.status = reply.substr(status_begin + 1, 3);
+    for (auto line_begin = reply.find("\r\n") + 2; line_begin < headers_end;)
+    {
+        const auto line_end = reply.find("\r\n", line_begin);
+        const auto line = reply.substr(line_begin, line_end - line_begin);
+        if (boost::istarts_with(line, "Content-Type:"))
+        {
+            parsed_reply.content_type = boost::trim_copy(line.substr(13));
+        }
+        line_begin = line_end + 2;
+    }
+    parsed_reply.content = reply.substr(headers_end + 4);
+    return parsed_reply;
+}
+}
+
+Backend Backend::FromString(const std::string &backend)
+{
+    const auto separator = backend.rfind(':');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == backend.size() ||
+        backend.find_first_not_of("0123456789", separator + 1) != std::string::npos)
+    {
+        throw util::exception("Invalid backend " + backend + ", expected HOST:PORT" + SOURCE_REF);
+    }
+    return Backend{backend.substr(0, separator), backend.substr(separator + 1)};
+}
+
+std::vector<BackendReply> fetchFromBackends(const std::vector<BackendRequest> &requests,
+                                            const std::chrono::milliseconds timeout)
+{
+    // all operations are asynchronous so the timer or a failed request can cancel them
+    boost::asio::io_service io_service;
+    boost::asio::deadline_timer timer(io_service,
+                                      boost::posix_time::milliseconds(timeout.count()));
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::size_t pending = requests.size();
+    bool timed_out = false;
+    // the first request that failed, the others were cancelled because of it
+    const BackendRequest *failed_request = nullptr;
+    boost::system::error_code error;
+
+    const auto cancel = [&] {
+        for (auto &connection : connections)
+        {
+            connection->resolver.cancel();
+            connection->socket.close();
+        }
+    };
+    const auto finish = [&](const BackendRequest &request,
+                            const boost::system::error_code &operation_error) {
+        if (operation_error && !failed_request && !timed_out)
+        {
+            failed_request = &request;
+            error = operation_error;
+            cancel();
+        }
+        if (--pending == 0)
+            timer.cancel();
+    };
+
+    timer.async_wait([&](const boost::system::error_code &timer_error) {
+        if (timer_error != boost::asio::error::operation_aborted)
+        {
+            timed_out = true;
+            cancel();
+        }
+    });
+    for (const auto &request : requests)
+    {
+        connections.push_back(std::make_unique<Connection>(io_service));
+        const auto connection = connections.back().get();
+        connection->request = makeRequest(request);
+        const auto done = [&finish, request = &request](const boost::system::error_code &error) {
+            finish(*request, error);
+        };
+        connection->resolver.async_resolve(
+            tcp::resolver::query(request.backend.host, request.backend.port),
+            [connection, done](const boost::system::error_code &resolve_error,
+                               tcp::resolver::iterator endpoints) {
+                if (resolve_error)
+                    return done(resolve_error);
+                boost::asio::async_connect(
+                    connection->socket,
+                    endpoints,
+                    [connection, done](const boost::system::error_code &connect_error,
+                                       tcp::resolver::iterator) {
+                        if (connect_error)
+                            return done(connect_error);
+                        boost::asio::async_write(
+                            connection->socket,
+                            boost::asio::buffer(connection->request),
+                            [connection, done](const boost::system::error_code &write_error,
+                                               std::size_t) {
+                                if (write_error)
+                                    return done(write_error);
+                                // the backend closes the connection after the reply
+                                boost::asio::async_read(
+                                    connection->socket,
+                                    connection->response,
+                                    [done](const boost::system::error_code &read_error,
+                                           std::size_t) {
+                                        done(read_error == boost::asio::error::eof
+                                                 ? boost::system::error_code()
+                                                 : read_error);
+                                    });
+                            });
+                    });
+            });
+    }
+    io_service.run();
+
+    if (timed_out || failed_request)
+    {
+        // all backends that didn't reply in time are to blame, the first one is reported
+        const auto &backend = failed_request ? failed_request->backend : requests.front().backend;
+        throw util::exception("Backend " + backend.host + ":" + backend.port + " failed: " +
+                              (timed_out ? "timed out" : error.message()) + SOURCE_REF);
+    }
+
+    std::vector<BackendReply> replies;
+    for (const auto index : util::irange<std::size_t>(0, requests.size()))
+    {
+        replies.push_back(parseReply(requests[index].backend, connections[index]->response));
+    }
+    return replies;
+}
+}
+}
@@ -0,0 +1,88 @@
+#include "server/compute_pool.hpp"
+
+#include <boost/assert.hpp>
+
+#include <sstream>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+ComputePool::ComputePool(const int concurrency)
+    // no thread joins the arena to run its tasks, so none of its slots are reserved for one
+    : arena(concurrency == -1 ? tbb::task_arena::automatic : concurrency, 0)
+{
+}
+
+ComputePool::~ComputePool() { Wait(); }
+
+void ComputePool::Enqueue(const ComputePriority priority, std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> guard(queue_lock);
+        queues[static_cast<std::size_t>(priority)].push_back(std::move(task));
+        ++pending;
+    }
+
+    // every arena task runs one queued task, the one with the highest priority at the time a
+    // worker picks it up rather than the one it was enqueued for
+    arena.enqueue([this] { RunNext(); });
+}
+
+void ComputePool::RunNext()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> guard(queue_lock);
+        for (auto &queue : queues)
+        {
+            if (!queue.empty())
+            {
+                task = std::move(queue.front());
+                queue.pop_front();
+                break;
+            }
+        }
+    }
+    BOOST_ASSERT(task);
+    task();
+
+    std::lock_guard<std::mutex> guard(queue_lock);
+    if (--pending == 0)
+    {
+        all_finished.notify_all();
+    }
+}
+
+void ComputePool::Wait()
+{
+    std::unique_lock<std::mutex> lock(queue_lock);
+    all_finished.wait(lock, [this] { return pending == 0; });
+}
+
+ComputePriority ComputePool::GetPriority(const std::string &service)
+{
+    if (service == "table" || service == "match" || service == "trip" || service == "isochrone")
+    {
+        return ComputePriority::Low;
+    }
+    return ComputePriority::High;
+}
+
+std::string ComputePool::DumpPrometheus() const
+{
+    std::lock_guard<std::mutex> guard(queue_lock);
+
+    std::stringstream out;
+    out << "# HELP osrm_compute_queued_requests Requests waiting for a compute thread.\n"
+        << "# TYPE osrm_compute_queued_requests gauge\n"
+        << "osrm_compute_queued_requests{priority=\"high\"} "
+        << queues[static_cast<std::size_t>(ComputePriority::High)].size() << "\n"
+        << "osrm_compute_queued_requests{priority=\"low\"} "
+        << queues[static_cast<std::size_t>(ComputePriority::Low)].size() << "\n";
+    return out.str();
+}
+}
+}
@@ -4,8 +4,6 @@
 
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
 
 #include <iterator>
 #include <string>
@@ -16,134 +14,209 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+namespace
 {
+boost::asio::ip::address getRemoteAddress(boost::asio::ip::tcp::socket &socket)
+{
+    boost::system::error_code endpoint_error;
+    return socket.remote_endpoint(endpoint_error).address();
 }
 
-boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+// clients of Unix domain sockets are on the same host
+boost::asio::ip::address getRemoteAddress(boost::asio::local::stream_protocol::socket &)
+{
+    return boost::asio::ip::address_v4::loopback();
+}
+#endif
+}
+
+template <typename Protocol>
+BasicConnection<Protocol>::BasicConnection(boost::asio::io_service &io_service,
+                                           RequestHandler &handler,
+                                           const unsigned keep_alive_timeout,
+                                           const unsigned keep_alive_max_requests,
+                                           const std::size_t max_body_size)
+    : strand(io_service), TCP_socket(io_service), timer(io_service), request_handler(handler),
+      request_parser(max_body_size), unprocessed_begin(nullptr), unprocessed_end(nullptr),
+      keep_alive_timeout(keep_alive_timeout), keep_alive_max_requests(keep_alive_max_requests),
+      processed_requests(0), keep_alive(false)
+{
+}
+
+template <typename Protocol>
+typename BasicConnection<Protocol>::socket_type &BasicConnection<Protocol>::socket()
+{
+    return TCP_socket;
+}
 
 /// Start the first asynchronous operation for the connection.
-void Connection::start()
+template <typename Protocol> void BasicConnection<Protocol>::start() { read_some(); }
+
+template <typename Protocol> void BasicConnection<Protocol>::read_some()
 {
+    if (keep_alive_timeout > 0)
+    {
+        timer.expires_from_now(boost::posix_time::seconds(keep_alive_timeout));
+        timer.async_wait(strand.wrap(boost::bind(&BasicConnection::handle_timeout,
+                                                 this->shared_from_this(),
+                                                 boost::asio::placeholders::error)));
+    }
+
     TCP_socket.async_read_some(
         boost::asio::buffer(incoming_data_buffer),
-        strand.wrap(boost::bind(&Connection::handle_read,
+        strand.wrap(boost::bind(&BasicConnection::handle_read,
                                 this->shared_from_this(),
                                 boost::asio::placeholders::error,
                                 boost::asio::placeholders::bytes_transferred)));
 }
 
-void Connection::handle_read(const boost::system::error_code &error, std::size_t bytes_transferred)
+template <typename Protocol>
+void BasicConnection<Protocol>::handle_read(const boost::system::error_code &error,
+                                            std::size_t bytes_transferred)
 {
+    // cancels the wait of the timer
+    timer.expires_at(boost::posix_time::pos_infin);
+
     if (error)
     {
         return;
     }
 
+    process_data(incoming_data_buffer.data(), incoming_data_buffer.data() + bytes_transferred);
+}
+
+template <typename Protocol> void BasicConnection<Protocol>::process_data(char *begin, char *end)
+{
     // no error detected, let's parse the request
     http::compression_type compression_type(http::no_compression);
     RequestParser::RequestStatus result;
-    std::tie(result, compression_type) =
-        request_parser.parse(current_request,
-                             incoming_data_buffer.data(),
-                             incoming_data_buffer.data() + bytes_transferred);
+    std::tie(result, compression_type, unprocessed_begin) =
+        request_parser.parse(current_request, begin, end);
+    unprocessed_end = end;
 
     // the request has been parsed
     if (result == RequestParser::RequestStatus::valid)
     {
-        current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
+        current_request.compression = compression_type;
+        current_request.endpoint = getRemoteAddress(TCP_socket);
 
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
+        auto *compute_pool = request_handler.GetComputePool();
+        if (compute_pool)
         {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
-            output_buffer = current_reply.to_buffers();
-            break;
+            // nothing else touches the request and the reply until the reply is written, the
+            // connection doesn't read while the request is handled
+            auto self = this->shared_from_this();
+            compute_pool->Enqueue(RequestHandler::GetPriority(current_request), [self] {
+                self->request_handler.HandleRequest(self->current_request, self->current_reply);
+                self->strand.dispatch([self] { self->write_reply(); });
+            });
+        }
+        else
+        {
+            request_handler.HandleRequest(current_request, current_reply);
+            write_reply();
         }
-        // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
     }
     else if (result == RequestParser::RequestStatus::invalid)
-    { // request is not parseable
+    { // request is not parseable, the start of a following request can't be found
+        keep_alive = false;
         current_reply = http::reply::stock_reply(http::reply::bad_request);
 
         boost::asio::async_write(TCP_socket,
                                  current_reply.to_buffers(),
-                                 strand.wrap(boost::bind(&Connection::handle_write,
+                                 strand.wrap(boost::bind(&BasicConnection::handle_write,
                                                          this->shared_from_this(),
                                                          boost::asio::placeholders::error)));
     }
     else
     {
         // we don't have a result yet, so continue reading
-        TCP_socket.async_read_some(
-            boost::asio::buffer(incoming_data_buffer),
-            strand.wrap(boost::bind(&Connection::handle_read,
-                                    this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    boost::asio::placeholders::bytes_transferred)));
+        read_some();
     }
 }
 
-/// Handle completion of a write operation.
-void Connection::handle_write(const boost::system::error_code &error)
+template <typename Protocol> void BasicConnection<Protocol>::write_reply()
 {
-    if (!error)
+    ++processed_requests;
+    keep_alive = current_request.keep_alive && keep_alive_timeout > 0 &&
+                 processed_requests < keep_alive_max_requests;
+    for (auto &header : current_reply.headers)
     {
-        // Initiate graceful connection closure.
-        boost::system::error_code ignore_error;
-        TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+        if (header.name == "Connection")
+        {
+            header.value = keep_alive ? "keep-alive" : "close";
+        }
     }
+
+    // the content was already compressed while rendering it
+    output_buffer = current_reply.to_buffers();
+    // write result to stream
+    boost::asio::async_write(TCP_socket,
+                             output_buffer,
+                             strand.wrap(boost::bind(&BasicConnection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
 }
 
-std::vector<char> Connection::compress_buffers(const std::vector<char> &uncompressed_data,
-                                               const http::compression_type compression_type)
+/// Handle completion of a write operation.
+template <typename Protocol>
+void BasicConnection<Protocol>::handle_write(const boost::system::error_code &error)
 {
-    boost::iostreams::gzip_params compression_parameters;
+    if (error)
+    {
+        return;
+    }
+
+    if (!keep_alive)
+    {
+        shutdown();
+        return;
+    }
+
+    // prepare for the next request on the same connection
+    request_parser.reset();
+    current_request.clear();
+    current_reply.clear();
+    output_buffer.clear();
 
-    // there's a trade-off between speed and size. speed wins
-    compression_parameters.level = boost::iostreams::zlib::best_speed;
-    // check which compression flavor is used
-    if (http::deflate_rfc1951 == compression_type)
+    // pipelined requests are answered in order before reading again
+    if (unprocessed_begin != unprocessed_end)
     {
-        compression_parameters.noheader = true;
+        process_data(unprocessed_begin, unprocessed_end);
+    }
+    else
+    {
+        read_some();
+    }
+}
+
+template <typename Protocol>
+void BasicConnection<Protocol>::handle_timeout(const boost::system::error_code &error)
+{
+    // the timer was cancelled or has already expired when data arrived
+    if (error == boost::asio::error::operation_aborted ||
+        timer.expires_at() > boost::asio::deadline_timer::traits_type::now())
+    {
+        return;
     }
 
-    std::vector<char> compressed_data;
-    // plug data into boost's compression stream
-    boost::iostreams::filtering_ostream gzip_stream;
-    gzip_stream.push(boost::iostreams::gzip_compressor(compression_parameters));
-    gzip_stream.push(boost::iostreams::back_inserter(compressed_data));
-    gzip_stream.write(&uncompressed_data[0], uncompressed_data.size());
-    boost::iostreams::close(gzip_stream);
+    // an idle connection is closed, the pending read completes with an error
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(socket_type::shutdown_both, ignore_error);
+    TCP_socket.close(ignore_error);
+}
 
-    return compressed_data;
+template <typename Protocol> void BasicConnection<Protocol>::shutdown()
+{
+    // Initiate graceful connection closure.
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(socket_type::shutdown_both, ignore_error);
 }
+
+template class BasicConnection<boost::asio::ip::tcp>;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+template class BasicConnection<boost::asio::local::stream_protocol>;
+#endif
 }
 }
@@ -0,0 +1,310 @@
+#include "server/http/compressor.hpp"
+
+#include "util/exception.hpp"
+
+#include <boost/algorithm/string/erase.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+namespace
+{
+// Higher is better, encodings this build doesn't support are never selected
+int getPreference(const std::string &coding)
+{
+#ifdef OSRM_HAVE_ZSTD
+    if (boost::iequals(coding, "zstd"))
+        return 4;
+#endif
+#ifdef OSRM_HAVE_BROTLI
+    if (boost::iequals(coding, "br"))
+        return 3;
+#endif
+    if (boost::iequals(coding, "gzip"))
+        return 2;
+    if (boost::iequals(coding, "deflate"))
+        return 1;
+    return 0;
+}
+
+compression_type toCompressionType(const int preference)
+{
+    switch (preference)
+    {
+    case 4:
+        return zstd_rfc8878;
+    case 3:
+        return brotli_rfc7932;
+    case 2:
+        return gzip_rfc1952;
+    case 1:
+        return deflate_rfc1951;
+    default:
+        return no_compression;
+    }
+}
+
+#ifdef OSRM_HAVE_ZSTD
+// Creating a zstd context is expensive, every thread reuses one of its own
+ZSTD_CCtx *getThreadZstdContext()
+{
+    thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(ZSTD_createCCtx(),
+                                                                              &ZSTD_freeCCtx);
+    if (!context)
+        throw util::exception("Could not initialize zstd compression");
+    ZSTD_CCtx_reset(context.get(), ZSTD_reset_session_and_parameters);
+    return context.get();
+}
+#endif
+}
+
+compression_type selectCompression(const std::string &accept_encoding)
+{
+    std::vector<std::string> codings;
+    boost::split(codings, accept_encoding, [](const char c) { return c == ','; });
+
+    int best_preference = 0;
+    for (const auto &coding_with_parameters : codings)
+    {
+        const auto parameters_begin = coding_with_parameters.find(';');
+        const auto coding = boost::trim_copy(coding_with_parameters.substr(0, parameters_begin));
+
+        if (parameters_begin != std::string::npos)
+        {
+            // q=0 means not acceptable, other qualities are not ranked
+            auto parameters = coding_with_parameters.substr(parameters_begin + 1);
+            boost::erase_all(parameters, " ");
+            if (boost::istarts_with(parameters, "q=") &&
+                std::strtod(parameters.c_str() + 2, nullptr) <= 0.)
+                continue;
+        }
+
+        best_preference = std::max(best_preference, getPreference(coding));
+    }
+
+    return toCompressionType(best_preference);
+}
+
+const char *toContentEncoding(const compression_type type)
+{
+    switch (type)
+    {
+    case gzip_rfc1952:
+        return "gzip";
+    case deflate_rfc1951:
+        return "deflate";
+    case brotli_rfc7932:
+        return "br";
+    case zstd_rfc8878:
+        return "zstd";
+    case no_compression:
+        break;
+    }
+    BOOST_ASSERT_MSG(false, "no content encoding without compression");
+    return "identity";
+}
+
+Compressor::Compressor(const compression_type type,
+                       const CompressionConfig &config,
+                       util::BufferChain &output)
+    : type(type), output(output)
+{
+    BOOST_ASSERT(type != no_compression);
+
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+
+    switch (type)
+    {
+#ifdef OSRM_HAVE_BROTLI
+    case brotli_rfc7932:
+        brotli_state = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+        if (!brotli_state ||
+            !BrotliEncoderSetParameter(brotli_state, BROTLI_PARAM_QUALITY, config.brotli_level))
+        {
+            throw util::exception("Could not initialize brotli compression");
+        }
+        break;
+#endif
+#ifdef OSRM_HAVE_ZSTD
+    case zstd_rfc8878:
+        zstd_context = getThreadZstdContext();
+        if (ZSTD_isError(ZSTD_CCtx_setParameter(
+                zstd_context, ZSTD_c_compressionLevel, config.zstd_level)))
+        {
+            throw util::exception("Could not initialize zstd compression");
+        }
+        break;
+#endif
+    case gzip_rfc1952:
+    case deflate_rfc1951:
+    {
+        // raw deflate streams have no header, 16 added to the window bits selects the gzip wrapper
+        const int window_bits = type == deflate_rfc1951 ? -MAX_WBITS : MAX_WBITS + 16;
+        if (deflateInit2(&stream,
+                         config.gzip_level,
+                         Z_DEFLATED,
+                         window_bits,
+                         8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw util::exception("Could not initialize zlib compression");
+        }
+        break;
+    }
+    default:
+        throw util::exception("Compression is not supported by this build");
+    }
+}
+
+Compressor::~Compressor()
+{
+    switch (type)
+    {
+#ifdef OSRM_HAVE_BROTLI
+    case brotli_rfc7932:
+        BrotliEncoderDestroyInstance(brotli_state);
+        break;
+#endif
+#ifdef OSRM_HAVE_ZSTD
+    case zstd_rfc8878:
+        // the context belongs to the thread
+        break;
+#endif
+    default:
+        deflateEnd(&stream);
+    }
+}
+
+void Compressor::write(const char *data, const std::size_t size)
+{
+    switch (type)
+    {
+#ifdef OSRM_HAVE_BROTLI
+    case brotli_rfc7932:
+        compressBrotli(data, size, BROTLI_OPERATION_PROCESS);
+        break;
+#endif
+#ifdef OSRM_HAVE_ZSTD
+    case zstd_rfc8878:
+        compressZstd(data, size, ZSTD_e_continue);
+        break;
+#endif
+    default:
+        deflate(data, size, Z_NO_FLUSH);
+    }
+}
+
+void Compressor::finish()
+{
+    switch (type)
+    {
+#ifdef OSRM_HAVE_BROTLI
+    case brotli_rfc7932:
+        compressBrotli(nullptr, 0, BROTLI_OPERATION_FINISH);
+        break;
+#endif
+#ifdef OSRM_HAVE_ZSTD
+    case zstd_rfc8878:
+        compressZstd(nullptr, 0, ZSTD_e_end);
+        break;
+#endif
+    default:
+        deflate(nullptr, 0, Z_FINISH);
+    }
+}
+
+void Compressor::deflate(const char *data, const std::size_t size, const int flush)
+{
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = static_cast<uInt>(size);
+
+    int result;
+    do
+    {
+        const auto free_space = output.prepare();
+        stream.next_out = reinterpret_cast<Bytef *>(free_space.first);
+        stream.avail_out = static_cast<uInt>(free_space.second);
+        result = ::deflate(&stream, flush);
+        BOOST_ASSERT(result != Z_STREAM_ERROR);
+        output.commit(free_space.second - stream.avail_out);
+        // the output buffer was filled completely, there might be more output pending
+    } while (stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    BOOST_ASSERT(stream.avail_in == 0);
+}
+
+#ifdef OSRM_HAVE_BROTLI
+void Compressor::compressBrotli(const char *data,
+                                const std::size_t size,
+                                const BrotliEncoderOperation operation)
+{
+    auto next_in = reinterpret_cast<const std::uint8_t *>(data);
+    std::size_t available_in = size;
+
+    while (true)
+    {
+        const auto free_space = output.prepare();
+        auto next_out = reinterpret_cast<std::uint8_t *>(free_space.first);
+        std::size_t available_out = free_space.second;
+        if (!BrotliEncoderCompressStream(brotli_state,
+                                         operation,
+                                         &available_in,
+                                         &next_in,
+                                         &available_out,
+                                         &next_out,
+                                         nullptr))
+        {
+            throw util::exception("Brotli compression failed");
+        }
+        output.commit(free_space.second - available_out);
+
+        const bool done = available_in == 0 && !BrotliEncoderHasMoreOutput(brotli_state);
+        if (done && (operation != BROTLI_OPERATION_FINISH || BrotliEncoderIsFinished(brotli_state)))
+            break;
+    }
+}
+#endif
+
+#ifdef OSRM_HAVE_ZSTD
+void Compressor::compressZstd(const char *data,
+                              const std::size_t size,
+                              const ZSTD_EndDirective mode)
+{
+    ZSTD_inBuffer input = {data, size, 0};
+
+    while (true)
+    {
+        const auto free_space = output.prepare();
+        ZSTD_outBuffer output_buffer = {free_space.first, free_space.second, 0};
+        const auto remaining = ZSTD_compressStream2(zstd_context, &output_buffer, &input, mode);
+        if (ZSTD_isError(remaining))
+        {
+            throw util::exception(std::string("zstd compression failed: ") +
+                                  ZSTD_getErrorName(remaining));
+        }
+        output.commit(output_buffer.pos);
+
+        // everything is flushed at the end, otherwise zstd may buffer input internally
+        if (mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size)
+            break;
+    }
+}
+#endif
+}
+}
+}
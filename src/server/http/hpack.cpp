@@ -0,0 +1,468 @@
+#include "server/http/hpack.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+namespace osrm
+{
+namespace server
+{
+namespace http
+{
+
+namespace
+{
+// every entry of the dynamic table counts with its strings and this overhead
+const constexpr std::size_t ENTRY_OVERHEAD = 32;
+// integers are never larger than sizes of tables and strings, longer encodings are rejected
+const constexpr unsigned MAX_INTEGER_SHIFT = 28;
+const constexpr std::size_t EOS_SYMBOL = 256;
+const constexpr unsigned MAX_CODE_LENGTH = 30;
+
+struct StaticEntry
+{
+    const char *name;
+    const char *value;
+};
+
+// RFC 7541 Appendix A
+const constexpr std::array<StaticEntry, 61> STATIC_TABLE = {{
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""}
+}};
+
+struct HuffmanCode
+{
+    std::uint32_t code;
+    unsigned length;
+};
+
+// RFC 7541 Appendix B, the code of every byte value and of the end of string symbol
+const constexpr std::array<HuffmanCode, 257> HUFFMAN_CODES = {{
+    {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28}, {0xfffffe4, 28},
+    {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28}, {0xfffffe8, 28}, {0xffffea, 24},
+    {0x3ffffffc, 30}, {0xfffffe9, 28}, {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28},
+    {0xfffffec, 28}, {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+    {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28}, {0xffffff4, 28},
+    {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28}, {0xffffff8, 28}, {0xffffff9, 28},
+    {0xffffffa, 28}, {0xffffffb, 28}, {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+    {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11}, {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8},
+    {0x7fb, 11}, {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6}, {0x0, 5}, {0x1, 5}, {0x2, 5},
+    {0x19, 6}, {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6}, {0x1e, 6}, {0x1f, 6}, {0x5c, 7},
+    {0xfb, 8}, {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10}, {0x1ffa, 13}, {0x21, 6},
+    {0x5d, 7}, {0x5e, 7}, {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7}, {0x63, 7}, {0x64, 7},
+    {0x65, 7}, {0x66, 7}, {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7}, {0x6b, 7}, {0x6c, 7},
+    {0x6d, 7}, {0x6e, 7}, {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7}, {0xfc, 8}, {0x73, 7},
+    {0xfd, 8}, {0x1ffb, 13}, {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6}, {0x7ffd, 15},
+    {0x3, 5}, {0x23, 6}, {0x4, 5}, {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6}, {0x27, 6}, {0x6, 5},
+    {0x74, 7}, {0x75, 7}, {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5}, {0x2b, 6}, {0x76, 7},
+    {0x2c, 6}, {0x8, 5}, {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7}, {0x79, 7}, {0x7a, 7}, {0x7b, 7},
+    {0x7ffe, 15}, {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28}, {0xfffe6, 20},
+    {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20}, {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22},
+    {0x7fffd9, 23}, {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23}, {0x7fffdd, 23},
+    {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23}, {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22},
+    {0x7fffe0, 23}, {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23}, {0x7fffe4, 23},
+    {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23}, {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23},
+    {0xffffef, 24}, {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22}, {0x3fffdc, 22},
+    {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21}, {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22},
+    {0xfffff0, 24}, {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23}, {0x1fffe0, 21},
+    {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21}, {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23},
+    {0x7fffef, 23}, {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22}, {0x7ffff0, 23},
+    {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23}, {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20},
+    {0x7fff1, 19}, {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25}, {0x3ffffe2, 26},
+    {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27}, {0x7ffffdf, 27}, {0x3ffffe5, 26},
+    {0xfffff1, 24}, {0x1ffffed, 25}, {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26},
+    {0x7ffffe0, 27}, {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+    {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26}, {0xffffffd, 28},
+    {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27}, {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20},
+    {0x1fffe6, 21}, {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23}, {0x3fffea, 22},
+    {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25}, {0xfffff4, 24}, {0xfffff5, 24},
+    {0x3ffffea, 26}, {0x7ffff4, 23}, {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26},
+    {0x3ffffed, 26}, {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+    {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27}, {0x7ffffee, 27},
+    {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26}, {0x3fffffff, 30}
+}};
+
+// The codes are canonical: shorter codes come first and codes of the same length are ordered by
+// their symbols. A code is decoded by comparing it with the first code of each length, like the
+// inflate of zlib does.
+struct HuffmanTable
+{
+    HuffmanTable()
+    {
+        counts.fill(0);
+        for (const auto &code : HUFFMAN_CODES)
+        {
+            counts[code.length]++;
+        }
+        std::array<std::size_t, MAX_CODE_LENGTH + 1> offsets;
+        offsets[0] = 0;
+        for (unsigned length = 1; length <= MAX_CODE_LENGTH; ++length)
+        {
+            offsets[length] = offsets[length - 1] + counts[length - 1];
+        }
+        for (std::size_t symbol = 0; symbol < HUFFMAN_CODES.size(); ++symbol)
+        {
+            symbols[offsets[HUFFMAN_CODES[symbol].length]++] = static_cast<std::uint16_t>(symbol);
+        }
+    }
+
+    std::array<std::uint32_t, MAX_CODE_LENGTH + 1> counts;
+    std::array<std::uint16_t, 257> symbols;
+};
+
+const HuffmanTable &getHuffmanTable()
+{
+    static const HuffmanTable table;
+    return table;
+}
+
+std::size_t entrySize(const std::string &name, const std::string &value)
+{
+    return name.size() + value.size() + ENTRY_OVERHEAD;
+}
+
+bool decodeString(const char *&begin, const char *end, std::string &output)
+{
+    if (begin == end)
+    {
+        return false;
+    }
+    const bool huffman = static_cast<std::uint8_t>(*begin) & 0x80;
+    std::uint64_t length;
+    if (!detail::DecodeInteger(begin, end, 7, length) ||
+        length > static_cast<std::uint64_t>(std::distance(begin, end)))
+    {
+        return false;
+    }
+    output.clear();
+    const char *string_end = begin + length;
+    if (huffman)
+    {
+        if (!detail::DecodeHuffman(begin, string_end, output))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        output.assign(begin, string_end);
+    }
+    begin = string_end;
+    return true;
+}
+
+void encodeString(const std::string &value, std::string &output)
+{
+    detail::EncodeInteger(value.size(), 7, 0x00, output);
+    output += value;
+}
+}
+
+namespace detail
+{
+bool DecodeInteger(const char *&begin,
+                   const char *end,
+                   const unsigned prefix_bits,
+                   std::uint64_t &value)
+{
+    BOOST_ASSERT(prefix_bits >= 1 && prefix_bits <= 8);
+    if (begin == end)
+    {
+        return false;
+    }
+    const std::uint64_t max_prefix = (1u << prefix_bits) - 1;
+    value = static_cast<std::uint8_t>(*begin++) & max_prefix;
+    if (value < max_prefix)
+    {
+        return true;
+    }
+    for (unsigned shift = 0; begin != end; shift += 7)
+    {
+        if (shift > MAX_INTEGER_SHIFT)
+        {
+            return false;
+        }
+        const auto byte = static_cast<std::uint8_t>(*begin++);
+        value += static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void EncodeInteger(std::uint64_t value,
+                   const unsigned prefix_bits,
+                   const char first_byte,
+                   std::string &output)
+{
+    BOOST_ASSERT(prefix_bits >= 1 && prefix_bits <= 8);
+    const std::uint64_t max_prefix = (1u << prefix_bits) - 1;
+    if (value < max_prefix)
+    {
+        output.push_back(static_cast<char>(first_byte | value));
+        return;
+    }
+    output.push_back(static_cast<char>(first_byte | max_prefix));
+    value -= max_prefix;
+    while (value >= 0x80)
+    {
+        output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+}
+
+bool DecodeHuffman(const char *begin, const char *end, std::string &output)
+{
+    const auto &table = getHuffmanTable();
+
+    // the code read so far and the first code and symbol of its length
+    std::uint32_t code = 0;
+    std::uint32_t first = 0;
+    std::size_t index = 0;
+    unsigned length = 0;
+    // the bits of the current code, the last one may only be padded with ones
+    std::uint32_t bits = 0;
+
+    for (; begin != end; ++begin)
+    {
+        const auto byte = static_cast<std::uint8_t>(*begin);
+        for (int bit = 7; bit >= 0; --bit)
+        {
+            const std::uint32_t value = (byte >> bit) & 1;
+            code |= value;
+            bits = (bits << 1) | value;
+            ++length;
+            const auto count = table.counts[length];
+            if (code - first < count)
+            {
+                const auto symbol = table.symbols[index + (code - first)];
+                if (symbol == EOS_SYMBOL)
+                {
+                    return false;
+                }
+                output.push_back(static_cast<char>(symbol));
+                code = first = 0;
+                index = 0;
+                length = 0;
+                bits = 0;
+                continue;
+            }
+            if (length == MAX_CODE_LENGTH)
+            {
+                return false;
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+    }
+
+    // padding is a prefix of the end of string code, which consists of ones
+    return length < 8 && bits == (1u << length) - 1;
+}
+}
+
+HPackDecoder::HPackDecoder(const std::size_t max_table_size)
+    : table_size(0), current_max_table_size(max_table_size), max_table_size(max_table_size)
+{
+}
+
+bool HPackDecoder::Lookup(const std::uint64_t index, std::string &name, std::string &value) const
+{
+    if (index == 0)
+    {
+        return false;
+    }
+    if (index <= STATIC_TABLE.size())
+    {
+        name = STATIC_TABLE[index - 1].name;
+        value = STATIC_TABLE[index - 1].value;
+        return true;
+    }
+    const auto dynamic_index = index - STATIC_TABLE.size() - 1;
+    if (dynamic_index >= dynamic_table.size())
+    {
+        return false;
+    }
+    name = dynamic_table[dynamic_index].name;
+    value = dynamic_table[dynamic_index].value;
+    return true;
+}
+
+void HPackDecoder::Evict(const std::size_t max_size)
+{
+    while (table_size > max_size)
+    {
+        BOOST_ASSERT(!dynamic_table.empty());
+        table_size -= entrySize(dynamic_table.back().name, dynamic_table.back().value);
+        dynamic_table.pop_back();
+    }
+}
+
+void HPackDecoder::Insert(const std::string &name, const std::string &value)
+{
+    const auto size = entrySize(name, value);
+    // an entry larger than the table empties it and isn't added
+    if (size > current_max_table_size)
+    {
+        Evict(0);
+        return;
+    }
+    Evict(current_max_table_size - size);
+    dynamic_table.emplace_front(name, value);
+    table_size += size;
+}
+
+bool HPackDecoder::Decode(const char *begin, const char *end, std::vector<header> &headers)
+{
+    std::string name, value;
+    // table size updates are only allowed before the first header of a block
+    bool first_header = true;
+    while (begin != end)
+    {
+        const auto byte = static_cast<std::uint8_t>(*begin);
+        std::uint64_t index;
+
+        if (byte & 0x80)
+        {
+            // indexed header field
+            if (!detail::DecodeInteger(begin, end, 7, index) || !Lookup(index, name, value))
+            {
+                return false;
+            }
+            headers.emplace_back(name, value);
+            first_header = false;
+            continue;
+        }
+
+        if ((byte & 0xe0) == 0x20)
+        {
+            // dynamic table size update
+            if (!first_header || !detail::DecodeInteger(begin, end, 5, index) ||
+                index > max_table_size)
+            {
+                return false;
+            }
+            current_max_table_size = static_cast<std::size_t>(index);
+            Evict(current_max_table_size);
+            continue;
+        }
+
+        // literal header fields with incremental indexing, without indexing or never indexed
+        const bool indexed = (byte & 0xc0) == 0x40;
+        if (!detail::DecodeInteger(begin, end, indexed ? 6 : 4, index))
+        {
+            return false;
+        }
+        if (index == 0)
+        {
+            if (!decodeString(begin, end, name))
+            {
+                return false;
+            }
+        }
+        else if (!Lookup(index, name, value))
+        {
+            return false;
+        }
+        if (!decodeString(begin, end, value))
+        {
+            return false;
+        }
+        if (indexed)
+        {
+            Insert(name, value);
+        }
+        headers.emplace_back(name, value);
+        first_header = false;
+    }
+    return true;
+}
+
+void EncodeHeader(const std::string &name, const std::string &value, std::string &block)
+{
+    // literal header field without indexing, with an indexed name if there is one
+    const auto entry =
+        std::find_if(STATIC_TABLE.begin(), STATIC_TABLE.end(), [&name](const StaticEntry &entry) {
+            return name == entry.name;
+        });
+    if (entry != STATIC_TABLE.end())
+    {
+        detail::EncodeInteger(std::distance(STATIC_TABLE.begin(), entry) + 1, 4, 0x00, block);
+    }
+    else
+    {
+        block.push_back(0x00);
+        encodeString(name, block);
+    }
+    encodeString(value, block);
+}
+}
+}
+}
@@ -15,9 +15,11 @@ const char internal_server_error_html[] =
     "{\"code\": \"InternalError\",\"message\":\"Internal Server Error\"}";
 const char seperators[] = {':', ' '};
 const char crlf[] = {'\r', '\n'};
-const std::string http_ok_string = "HTTP/1.0 200 OK\r\n";
-const std::string http_bad_request_string = "HTTP/1.0 400 Bad Request\r\n";
-const std::string http_internal_server_error_string = "HTTP/1.0 500 Internal Server Error\r\n";
+const std::string http_ok_string = "HTTP/1.1 200 OK\r\n";
+const std::string http_bad_request_string = "HTTP/1.1 400 Bad Request\r\n";
+const std::string http_internal_server_error_string = "HTTP/1.1 500 Internal Server Error\r\n";
+const std::string http_service_unavailable_string = "HTTP/1.1 503 Service Unavailable\r\n";
+const std::string http_gateway_timeout_string = "HTTP/1.1 504 Gateway Timeout\r\n";
 
 void reply::set_size(const std::size_t size)
 {
@@ -30,21 +32,17 @@ void reply::set_size(const std::size_t size)
     }
 }
 
-void reply::set_uncompressed_size() { set_size(content.size()); }
+void reply::set_uncompressed_size()
+{
+    set_size(content.size() + content_chain.size() +
+             (shared_content ? shared_content->size() : 0));
+}
 
 std::vector<boost::asio::const_buffer> reply::to_buffers()
 {
-    std::vector<boost::asio::const_buffer> buffers;
-    buffers.push_back(status_to_buffer(status));
-    for (const header &h : headers)
-    {
-        buffers.push_back(boost::asio::buffer(h.name));
-        buffers.push_back(boost::asio::buffer(seperators));
-        buffers.push_back(boost::asio::buffer(h.value));
-        buffers.push_back(boost::asio::buffer(crlf));
-    }
-    buffers.push_back(boost::asio::buffer(crlf));
-    buffers.push_back(boost::asio::buffer(content));
+    std::vector<boost::asio::const_buffer> buffers = headers_to_buffers();
+    const auto body = body_to_buffers();
+    buffers.insert(buffers.end(), body.begin(), body.end());
     return buffers;
 }
 
@@ -63,6 +61,26 @@ std::vector<boost::asio::const_buffer> reply::headers_to_buffers()
     return buffers;
 }
 
+std::vector<boost::asio::const_buffer> reply::body_to_buffers()
+{
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.push_back(boost::asio::buffer(content));
+    for (std::size_t index = 0; index < content_chain.buffer_count(); ++index)
+    {
+        buffers.push_back(boost::asio::buffer(content_chain.buffer_data(index),
+                                              content_chain.buffer_size(index)));
+    }
+    if (shared_content)
+    {
+        for (std::size_t index = 0; index < shared_content->buffer_count(); ++index)
+        {
+            buffers.push_back(boost::asio::buffer(shared_content->buffer_data(index),
+                                                  shared_content->buffer_size(index)));
+        }
+    }
+    return buffers;
+}
+
 reply reply::stock_reply(const reply::status_type status)
 {
     reply reply;
@@ -100,13 +118,31 @@ boost::asio::const_buffer reply::status_to_buffer(const reply::status_type statu
     {
         return boost::asio::buffer(http_internal_server_error_string);
     }
+    if (reply::service_unavailable == status)
+    {
+        return boost::asio::buffer(http_service_unavailable_string);
+    }
+    if (reply::gateway_timeout == status)
+    {
+        return boost::asio::buffer(http_gateway_timeout_string);
+    }
     return boost::asio::buffer(http_bad_request_string);
 }
 
 reply::reply() : status(ok)
 {
-    // We do not currently support keep alive. Always set 'Connection: close'.
+    // The connection replaces the value if it is kept alive after this reply.
+    headers.emplace_back("Connection", "close");
+}
+
+void reply::clear()
+{
+    status = ok;
+    headers.clear();
     headers.emplace_back("Connection", "close");
+    content.clear();
+    content_chain.clear();
+    shared_content.reset();
 }
 }
 }
@@ -0,0 +1,910 @@
+#include "server/http2_connection.hpp"
+#include "server/http/compressor.hpp"
+#include "server/request_handler.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+const constexpr char CONNECTION_PREFACE[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+const constexpr std::size_t CONNECTION_PREFACE_SIZE = sizeof(CONNECTION_PREFACE) - 1;
+const constexpr std::size_t FRAME_HEADER_SIZE = 9;
+// the server never announces larger frames, the client may allow larger ones
+const constexpr std::size_t DEFAULT_FRAME_SIZE = 16384;
+const constexpr std::size_t MAX_FRAME_SIZE = (1 << 24) - 1;
+const constexpr std::int64_t DEFAULT_WINDOW_SIZE = 65535;
+const constexpr std::int64_t MAX_WINDOW_SIZE = 0x7fffffff;
+// header blocks that are continued beyond this close the connection
+const constexpr std::size_t MAX_HEADER_BLOCK_SIZE = 64 * 1024;
+// more would overflow the milliseconds of a timeout
+const constexpr std::size_t MAX_TIMEOUT_DIGITS = 9;
+
+enum FrameType : std::uint8_t
+{
+    DATA = 0x0,
+    HEADERS = 0x1,
+    PRIORITY = 0x2,
+    RST_STREAM = 0x3,
+    SETTINGS = 0x4,
+    PUSH_PROMISE = 0x5,
+    PING = 0x6,
+    GOAWAY = 0x7,
+    WINDOW_UPDATE = 0x8,
+    CONTINUATION = 0x9
+};
+
+const constexpr std::uint8_t FLAG_END_STREAM = 0x1;
+const constexpr std::uint8_t FLAG_ACK = 0x1;
+const constexpr std::uint8_t FLAG_END_HEADERS = 0x4;
+const constexpr std::uint8_t FLAG_PADDED = 0x8;
+const constexpr std::uint8_t FLAG_PRIORITY = 0x20;
+
+enum SettingsParameter : std::uint16_t
+{
+    SETTINGS_ENABLE_PUSH = 0x2,
+    SETTINGS_MAX_CONCURRENT_STREAMS = 0x3,
+    SETTINGS_INITIAL_WINDOW_SIZE = 0x4,
+    SETTINGS_MAX_FRAME_SIZE = 0x5
+};
+
+enum ErrorCode : std::uint32_t
+{
+    NO_ERROR = 0x0,
+    PROTOCOL_ERROR = 0x1,
+    FLOW_CONTROL_ERROR = 0x3,
+    STREAM_CLOSED = 0x5,
+    FRAME_SIZE_ERROR = 0x6,
+    REFUSED_STREAM = 0x7,
+    COMPRESSION_ERROR = 0x9,
+    ENHANCE_YOUR_CALM = 0xb
+};
+
+std::uint32_t readUInt32(const char *data)
+{
+    return static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[0])) << 24 |
+           static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[1])) << 16 |
+           static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[2])) << 8 |
+           static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[3]));
+}
+
+void appendUInt32(std::string &output, const std::uint32_t value)
+{
+    output.push_back(static_cast<char>(value >> 24));
+    output.push_back(static_cast<char>(value >> 16));
+    output.push_back(static_cast<char>(value >> 8));
+    output.push_back(static_cast<char>(value));
+}
+
+void appendFrameHeader(std::string &output,
+                       const std::size_t length,
+                       const FrameType type,
+                       const std::uint8_t flags,
+                       const std::uint32_t stream_id)
+{
+    BOOST_ASSERT(length <= MAX_FRAME_SIZE);
+    output.push_back(static_cast<char>(length >> 16));
+    output.push_back(static_cast<char>(length >> 8));
+    output.push_back(static_cast<char>(length));
+    output.push_back(static_cast<char>(type));
+    output.push_back(static_cast<char>(flags));
+    appendUInt32(output, stream_id);
+}
+
+void appendWindowUpdate(std::string &output,
+                        const std::uint32_t stream_id,
+                        const std::uint32_t increment)
+{
+    appendFrameHeader(output, 4, WINDOW_UPDATE, 0, stream_id);
+    appendUInt32(output, increment);
+}
+
+void appendResetStream(std::string &output,
+                       const std::uint32_t stream_id,
+                       const std::uint32_t error_code)
+{
+    appendFrameHeader(output, 4, RST_STREAM, 0, stream_id);
+    appendUInt32(output, error_code);
+}
+
+// header names are in lower case, the headers of HTTP/1.1 connections are left out
+void encodeReplyHeaders(const http::reply &reply, std::string &block)
+{
+    http::EncodeHeader(":status", std::to_string(static_cast<int>(reply.status)), block);
+    for (const auto &header : reply.headers)
+    {
+        std::string name = header.name;
+        std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+        if (name == "connection" || name == "keep-alive" || name == "transfer-encoding")
+        {
+            continue;
+        }
+        http::EncodeHeader(name, header.value, block);
+    }
+}
+
+// false if a pseudo header the request needs is missing
+bool setRequestHeaders(const std::vector<http::header> &headers, http::request &request)
+{
+    for (const auto &header : headers)
+    {
+        if (header.name == ":method")
+        {
+            request.method = header.value;
+        }
+        else if (header.name == ":path")
+        {
+            request.uri = header.value;
+        }
+        else if (header.name == "accept-encoding")
+        {
+            request.compression = http::selectCompression(header.value);
+        }
+        else if (header.name == "referer")
+        {
+            request.referrer = header.value;
+        }
+        else if (header.name == "user-agent")
+        {
+            request.agent = header.value;
+        }
+        else if (header.name == "content-type")
+        {
+            request.content_type = header.value;
+        }
+        // the time in milliseconds the client waits for the reply, other values are ignored
+        else if (header.name == "x-osrm-timeout" && !header.value.empty() &&
+                 header.value.size() <= MAX_TIMEOUT_DIGITS &&
+                 std::all_of(header.value.begin(), header.value.end(), [](const char c) {
+                     return c >= '0' && c <= '9';
+                 }))
+        {
+            request.timeout = std::stoul(header.value);
+        }
+        else if (header.name == "x-osrm-trace")
+        {
+            request.trace = header.value == "1";
+        }
+    }
+    // the streams of a connection don't end the connection
+    request.keep_alive = true;
+    return !request.method.empty() && !request.uri.empty();
+}
+}
+
+Http2Connection::Http2Connection(boost::asio::io_service &io_service,
+                                 RequestHandler &handler,
+                                 const unsigned keep_alive_timeout,
+                                 const std::size_t max_body_size)
+    : io_service(io_service), strand(io_service), TCP_socket(io_service), timer(io_service),
+      request_handler(handler), preface_received(false), header_stream_id(0),
+      header_end_stream(false), last_stream_id(0), handled_requests(0),
+      send_window(DEFAULT_WINDOW_SIZE), initial_window_size(DEFAULT_WINDOW_SIZE),
+      max_frame_size(DEFAULT_FRAME_SIZE), writing(false), closing(false), going_away(false),
+      keep_alive_timeout(keep_alive_timeout), max_body_size(max_body_size)
+{
+}
+
+boost::asio::ip::tcp::socket &Http2Connection::socket() { return TCP_socket; }
+
+void Http2Connection::start()
+{
+    appendFrameHeader(pending_frames, 6, SETTINGS, 0, 0);
+    pending_frames.push_back(0);
+    pending_frames.push_back(static_cast<char>(SETTINGS_MAX_CONCURRENT_STREAMS));
+    appendUInt32(pending_frames, MAX_CONCURRENT_STREAMS);
+    flush();
+    read_some();
+}
+
+void Http2Connection::read_some()
+{
+    if (is_idle())
+    {
+        start_timer();
+    }
+
+    TCP_socket.async_read_some(
+        boost::asio::buffer(incoming_data_buffer),
+        strand.wrap(boost::bind(&Http2Connection::handle_read,
+                                this->shared_from_this(),
+                                boost::asio::placeholders::error,
+                                boost::asio::placeholders::bytes_transferred)));
+}
+
+void Http2Connection::handle_read(const boost::system::error_code &error,
+                                  std::size_t bytes_transferred)
+{
+    // cancels the wait of the timer
+    timer.expires_at(boost::posix_time::pos_infin);
+
+    if (error || going_away)
+    {
+        return;
+    }
+
+    input.insert(input.end(),
+                 incoming_data_buffer.data(),
+                 incoming_data_buffer.data() + bytes_transferred);
+    const bool valid = process_input();
+    flush();
+    if (valid)
+    {
+        read_some();
+    }
+}
+
+bool Http2Connection::process_input()
+{
+    auto begin = input.data();
+    const auto end = input.data() + input.size();
+
+    if (!preface_received)
+    {
+        const auto size =
+            std::min(CONNECTION_PREFACE_SIZE, static_cast<std::size_t>(end - begin));
+        if (std::memcmp(begin, CONNECTION_PREFACE, size) != 0)
+        {
+            // not a HTTP/2 client, there is nobody to send a GOAWAY to
+            shutdown();
+            return false;
+        }
+        if (size < CONNECTION_PREFACE_SIZE)
+        {
+            return true;
+        }
+        preface_received = true;
+        begin += CONNECTION_PREFACE_SIZE;
+    }
+
+    while (static_cast<std::size_t>(end - begin) >= FRAME_HEADER_SIZE)
+    {
+        const std::size_t length = static_cast<std::uint8_t>(begin[0]) << 16 |
+                                   static_cast<std::uint8_t>(begin[1]) << 8 |
+                                   static_cast<std::uint8_t>(begin[2]);
+        if (length > DEFAULT_FRAME_SIZE)
+        {
+            return go_away(FRAME_SIZE_ERROR);
+        }
+        if (static_cast<std::size_t>(end - begin) < FRAME_HEADER_SIZE + length)
+        {
+            break;
+        }
+
+        const auto type = static_cast<std::uint8_t>(begin[3]);
+        const auto flags = static_cast<std::uint8_t>(begin[4]);
+        const auto stream_id = readUInt32(begin + 5) & 0x7fffffff;
+        if (!handle_frame(type, flags, stream_id, begin + FRAME_HEADER_SIZE, length))
+        {
+            return false;
+        }
+        begin += FRAME_HEADER_SIZE + length;
+    }
+
+    input.erase(input.begin(), input.begin() + (begin - input.data()));
+    return true;
+}
+
+bool Http2Connection::handle_frame(const std::uint8_t type,
+                                   const std::uint8_t flags,
+                                   const std::uint32_t stream_id,
+                                   const char *payload,
+                                   const std::size_t length)
+{
+    // a header block has to be continued right away
+    if (header_stream_id != 0 && (type != CONTINUATION || stream_id != header_stream_id))
+    {
+        return go_away(PROTOCOL_ERROR);
+    }
+
+    switch (type)
+    {
+    case DATA:
+        return handle_data(flags, stream_id, payload, length);
+    case HEADERS:
+        return handle_headers(flags, stream_id, payload, length);
+    case PRIORITY:
+        // replies are sent as soon as they are done, priorities don't change that
+        if (stream_id == 0)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        return true;
+    case RST_STREAM:
+        if (stream_id == 0 || stream_id > last_stream_id)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        if (length != 4)
+        {
+            return go_away(FRAME_SIZE_ERROR);
+        }
+        // the request is still handled but its reply is dropped
+        streams.erase(stream_id);
+        return true;
+    case SETTINGS:
+        return handle_settings(flags, stream_id, payload, length);
+    case PUSH_PROMISE:
+        // clients can't push
+        return go_away(PROTOCOL_ERROR);
+    case PING:
+        if (stream_id != 0)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        if (length != 8)
+        {
+            return go_away(FRAME_SIZE_ERROR);
+        }
+        if ((flags & FLAG_ACK) == 0)
+        {
+            appendFrameHeader(pending_frames, 8, PING, FLAG_ACK, 0);
+            pending_frames.append(payload, length);
+        }
+        return true;
+    case GOAWAY:
+        if (stream_id != 0)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        closing = true;
+        return true;
+    case WINDOW_UPDATE:
+        return handle_window_update(stream_id, payload, length);
+    case CONTINUATION:
+        if (header_stream_id == 0)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        if (header_block.size() + length > MAX_HEADER_BLOCK_SIZE)
+        {
+            return go_away(ENHANCE_YOUR_CALM);
+        }
+        header_block.append(payload, length);
+        if (flags & FLAG_END_HEADERS)
+        {
+            return end_header_block();
+        }
+        return true;
+    default:
+        // unknown frame types are ignored
+        return true;
+    }
+}
+
+bool Http2Connection::handle_data(const std::uint8_t flags,
+                                  const std::uint32_t stream_id,
+                                  const char *payload,
+                                  const std::size_t length)
+{
+    if (stream_id == 0 || stream_id > last_stream_id)
+    {
+        return go_away(PROTOCOL_ERROR);
+    }
+
+    std::size_t data_begin = 0;
+    std::size_t data_end = length;
+    if (flags & FLAG_PADDED)
+    {
+        if (length == 0 || static_cast<std::uint8_t>(payload[0]) >= length)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        data_begin = 1;
+        data_end = length - static_cast<std::uint8_t>(payload[0]);
+    }
+
+    // the data counts against the window of the connection even if the stream is closed
+    if (length > 0)
+    {
+        appendWindowUpdate(pending_frames, 0, static_cast<std::uint32_t>(length));
+    }
+
+    const auto stream = streams.find(stream_id);
+    if (stream == streams.end())
+    {
+        reset_stream(stream_id, STREAM_CLOSED);
+        return true;
+    }
+    auto &request = stream->second.request;
+    if (!request)
+    {
+        // the request is complete or was rejected before its body was, the data is dropped
+        return true;
+    }
+
+    if (request->body.size() + (data_end - data_begin) > max_body_size)
+    {
+        // answered right away like a request that was handled
+        request.reset();
+        ++handled_requests;
+        handle_reply(stream_id,
+                     std::make_shared<http::reply>(
+                         http::reply::stock_reply(http::reply::bad_request)));
+        return true;
+    }
+    request->body.append(payload + data_begin, payload + data_end);
+
+    if (flags & FLAG_END_STREAM)
+    {
+        dispatch(stream_id);
+    }
+    else if (length > 0)
+    {
+        appendWindowUpdate(pending_frames, stream_id, static_cast<std::uint32_t>(length));
+    }
+    return true;
+}
+
+bool Http2Connection::handle_headers(const std::uint8_t flags,
+                                     const std::uint32_t stream_id,
+                                     const char *payload,
+                                     const std::size_t length)
+{
+    if (stream_id == 0)
+    {
+        return go_away(PROTOCOL_ERROR);
+    }
+
+    std::size_t block_begin = 0;
+    std::size_t padding = 0;
+    if (flags & FLAG_PADDED)
+    {
+        if (length == 0)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        padding = static_cast<std::uint8_t>(payload[0]);
+        block_begin = 1;
+    }
+    if (flags & FLAG_PRIORITY)
+    {
+        block_begin += 5;
+    }
+    if (block_begin + padding > length)
+    {
+        return go_away(PROTOCOL_ERROR);
+    }
+
+    header_block.assign(payload + block_begin, payload + length - padding);
+    header_stream_id = stream_id;
+    header_end_stream = flags & FLAG_END_STREAM;
+    if (flags & FLAG_END_HEADERS)
+    {
+        return end_header_block();
+    }
+    return true;
+}
+
+bool Http2Connection::end_header_block()
+{
+    const auto stream_id = header_stream_id;
+    header_stream_id = 0;
+
+    // every block is decoded, the table of the decoder has to stay in sync with the client
+    std::vector<http::header> headers;
+    if (!decoder.Decode(
+            header_block.data(), header_block.data() + header_block.size(), headers))
+    {
+        return go_away(COMPRESSION_ERROR);
+    }
+
+    const auto stream = streams.find(stream_id);
+    if (stream != streams.end())
+    {
+        // trailers end the request, they are not used
+        if (!stream->second.request || !header_end_stream)
+        {
+            reset_stream(stream_id, PROTOCOL_ERROR);
+            return true;
+        }
+        dispatch(stream_id);
+        return true;
+    }
+
+    if (stream_id <= last_stream_id || stream_id % 2 == 0)
+    {
+        return go_away(PROTOCOL_ERROR);
+    }
+    last_stream_id = stream_id;
+
+    // the client doesn't open streams anymore after its GOAWAY
+    if (closing)
+    {
+        return true;
+    }
+    if (streams.size() >= MAX_CONCURRENT_STREAMS || handled_requests >= MAX_CONCURRENT_STREAMS)
+    {
+        reset_stream(stream_id, REFUSED_STREAM);
+        return true;
+    }
+
+    auto request = std::make_shared<http::request>();
+    if (!setRequestHeaders(headers, *request))
+    {
+        reset_stream(stream_id, PROTOCOL_ERROR);
+        return true;
+    }
+    boost::system::error_code endpoint_error;
+    request->endpoint = TCP_socket.remote_endpoint(endpoint_error).address();
+
+    auto &new_stream = streams[stream_id];
+    new_stream.request = std::move(request);
+    new_stream.send_window = initial_window_size;
+    if (header_end_stream)
+    {
+        dispatch(stream_id);
+    }
+    return true;
+}
+
+bool Http2Connection::handle_settings(const std::uint8_t flags,
+                                      const std::uint32_t stream_id,
+                                      const char *payload,
+                                      const std::size_t length)
+{
+    if (stream_id != 0)
+    {
+        return go_away(PROTOCOL_ERROR);
+    }
+    if (flags & FLAG_ACK)
+    {
+        return length == 0 || go_away(FRAME_SIZE_ERROR);
+    }
+    if (length % 6 != 0)
+    {
+        return go_away(FRAME_SIZE_ERROR);
+    }
+
+    for (std::size_t offset = 0; offset < length; offset += 6)
+    {
+        const auto parameter = static_cast<std::uint16_t>(
+            static_cast<std::uint8_t>(payload[offset]) << 8 |
+            static_cast<std::uint8_t>(payload[offset + 1]));
+        const auto value = readUInt32(payload + offset + 2);
+
+        if (parameter == SETTINGS_ENABLE_PUSH && value > 1)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        if (parameter == SETTINGS_MAX_FRAME_SIZE)
+        {
+            if (value < DEFAULT_FRAME_SIZE || value > MAX_FRAME_SIZE)
+            {
+                return go_away(PROTOCOL_ERROR);
+            }
+            max_frame_size = value;
+        }
+        if (parameter == SETTINGS_INITIAL_WINDOW_SIZE)
+        {
+            if (value > MAX_WINDOW_SIZE)
+            {
+                return go_away(FLOW_CONTROL_ERROR);
+            }
+            // the windows of the open streams change by the difference
+            const auto delta = static_cast<std::int64_t>(value) - initial_window_size;
+            initial_window_size = value;
+            for (auto &stream : streams)
+            {
+                stream.second.send_window += delta;
+                if (stream.second.send_window > MAX_WINDOW_SIZE)
+                {
+                    return go_away(FLOW_CONTROL_ERROR);
+                }
+                queue(stream.first);
+            }
+        }
+    }
+
+    appendFrameHeader(pending_frames, 0, SETTINGS, FLAG_ACK, 0);
+    return true;
+}
+
+bool Http2Connection::handle_window_update(const std::uint32_t stream_id,
+                                           const char *payload,
+                                           const std::size_t length)
+{
+    if (length != 4)
+    {
+        return go_away(FRAME_SIZE_ERROR);
+    }
+    const auto increment = readUInt32(payload) & 0x7fffffff;
+
+    if (stream_id == 0)
+    {
+        if (increment == 0)
+        {
+            return go_away(PROTOCOL_ERROR);
+        }
+        send_window += increment;
+        return send_window <= MAX_WINDOW_SIZE || go_away(FLOW_CONTROL_ERROR);
+    }
+
+    // updates of closed streams can still arrive
+    const auto stream = streams.find(stream_id);
+    if (stream == streams.end())
+    {
+        return true;
+    }
+    if (increment == 0)
+    {
+        reset_stream(stream_id, PROTOCOL_ERROR);
+        return true;
+    }
+    stream->second.send_window += increment;
+    if (stream->second.send_window > MAX_WINDOW_SIZE)
+    {
+        reset_stream(stream_id, FLOW_CONTROL_ERROR);
+        return true;
+    }
+    queue(stream_id);
+    return true;
+}
+
+void Http2Connection::dispatch(const std::uint32_t stream_id)
+{
+    auto &stream = streams[stream_id];
+    BOOST_ASSERT(stream.request);
+    const auto request = std::move(stream.request);
+    ++handled_requests;
+
+    // the request handler may take a while, the connection keeps reading and writing meanwhile
+    auto self = this->shared_from_this();
+    auto handle = [self, stream_id, request] {
+        auto reply = std::make_shared<http::reply>();
+        self->request_handler.HandleRequest(*request, *reply);
+        self->strand.dispatch([self, stream_id, reply] {
+            self->handle_reply(stream_id, reply);
+            self->flush();
+        });
+    };
+    auto *compute_pool = request_handler.GetComputePool();
+    if (compute_pool)
+    {
+        compute_pool->Enqueue(RequestHandler::GetPriority(*request), std::move(handle));
+    }
+    else
+    {
+        io_service.post(std::move(handle));
+    }
+}
+
+void Http2Connection::handle_reply(const std::uint32_t stream_id,
+                                   std::shared_ptr<http::reply> reply)
+{
+    BOOST_ASSERT(handled_requests > 0);
+    --handled_requests;
+
+    const auto stream = streams.find(stream_id);
+    if (stream == streams.end() || going_away)
+    {
+        return;
+    }
+
+    std::string block;
+    encodeReplyHeaders(*reply, block);
+
+    std::vector<boost::asio::const_buffer> body;
+    for (const auto &buffer : reply->body_to_buffers())
+    {
+        if (boost::asio::buffer_size(buffer) > 0)
+        {
+            body.push_back(buffer);
+        }
+    }
+
+    // the header block is split into frames the client accepts
+    std::size_t offset = 0;
+    do
+    {
+        const auto size = std::min(block.size() - offset, max_frame_size);
+        const bool last = offset + size == block.size();
+        std::uint8_t flags = last ? FLAG_END_HEADERS : 0;
+        if (offset == 0 && body.empty())
+        {
+            flags |= FLAG_END_STREAM;
+        }
+        appendFrameHeader(
+            pending_frames, size, offset == 0 ? HEADERS : CONTINUATION, flags, stream_id);
+        pending_frames.append(block, offset, size);
+        offset += size;
+    } while (offset < block.size());
+
+    if (body.empty())
+    {
+        streams.erase(stream);
+        return;
+    }
+    stream->second.reply = std::move(reply);
+    stream->second.body = std::move(body);
+    queue(stream_id);
+}
+
+void Http2Connection::reset_stream(const std::uint32_t stream_id, const std::uint32_t error_code)
+{
+    appendResetStream(pending_frames, stream_id, error_code);
+    streams.erase(stream_id);
+}
+
+bool Http2Connection::go_away(const std::uint32_t error_code)
+{
+    if (!going_away)
+    {
+        appendFrameHeader(pending_frames, 8, GOAWAY, 0, 0);
+        appendUInt32(pending_frames, last_stream_id);
+        appendUInt32(pending_frames, error_code);
+        going_away = true;
+    }
+    return false;
+}
+
+void Http2Connection::queue(const std::uint32_t stream_id)
+{
+    auto &stream = streams[stream_id];
+    if (stream.reply && !stream.queued && stream.send_window > 0)
+    {
+        stream.queued = true;
+        sending_streams.push_back(stream_id);
+    }
+}
+
+void Http2Connection::flush()
+{
+    if (writing)
+    {
+        return;
+    }
+
+    write_data.clear();
+    write_buffers.clear();
+    write_replies.clear();
+
+    if (!pending_frames.empty())
+    {
+        write_data.push_back(std::move(pending_frames));
+        pending_frames.clear();
+        write_buffers.push_back(boost::asio::buffer(write_data.back()));
+    }
+
+    // one DATA frame per stream in turn, as long as the windows allow it
+    while (!going_away && send_window > 0 && !sending_streams.empty())
+    {
+        const auto stream_id = sending_streams.front();
+        sending_streams.pop_front();
+        const auto iter = streams.find(stream_id);
+        if (iter == streams.end())
+        {
+            continue;
+        }
+        auto &stream = iter->second;
+        if (stream.send_window <= 0)
+        {
+            stream.queued = false;
+            continue;
+        }
+
+        const auto frame_size = static_cast<std::size_t>(std::min<std::int64_t>(
+            std::min(send_window, stream.send_window), static_cast<std::int64_t>(max_frame_size)));
+        write_data.emplace_back();
+        auto &frame_header = write_data.back();
+        write_buffers.push_back(boost::asio::const_buffer());
+        const auto frame_header_index = write_buffers.size() - 1;
+
+        std::size_t size = 0;
+        while (size < frame_size && stream.body_index < stream.body.size())
+        {
+            auto &buffer = stream.body[stream.body_index];
+            const auto part = std::min(frame_size - size, boost::asio::buffer_size(buffer));
+            write_buffers.push_back(boost::asio::buffer(buffer, part));
+            buffer = buffer + part;
+            size += part;
+            if (boost::asio::buffer_size(buffer) == 0)
+            {
+                ++stream.body_index;
+            }
+        }
+        const bool last = stream.body_index == stream.body.size();
+        appendFrameHeader(frame_header, size, DATA, last ? FLAG_END_STREAM : 0, stream_id);
+        write_buffers[frame_header_index] = boost::asio::buffer(frame_header);
+
+        send_window -= size;
+        stream.send_window -= size;
+        // the body stays alive until it is written even if the stream is reset meanwhile
+        write_replies.push_back(stream.reply);
+        if (last)
+        {
+            streams.erase(iter);
+        }
+        else
+        {
+            sending_streams.push_back(stream_id);
+        }
+    }
+
+    if (write_buffers.empty())
+    {
+        if (closing && is_idle())
+        {
+            shutdown();
+        }
+        return;
+    }
+
+    writing = true;
+    boost::asio::async_write(TCP_socket,
+                             write_buffers,
+                             strand.wrap(boost::bind(&Http2Connection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
+}
+
+void Http2Connection::handle_write(const boost::system::error_code &error)
+{
+    writing = false;
+    if (error)
+    {
+        return;
+    }
+
+    if (going_away)
+    {
+        shutdown();
+        return;
+    }
+
+    flush();
+    if (!writing && is_idle())
+    {
+        start_timer();
+    }
+}
+
+bool Http2Connection::is_idle() const { return streams.empty() && handled_requests == 0; }
+
+void Http2Connection::start_timer()
+{
+    if (keep_alive_timeout > 0)
+    {
+        timer.expires_from_now(boost::posix_time::seconds(keep_alive_timeout));
+        timer.async_wait(strand.wrap(boost::bind(&Http2Connection::handle_timeout,
+                                                 this->shared_from_this(),
+                                                 boost::asio::placeholders::error)));
+    }
+}
+
+void Http2Connection::handle_timeout(const boost::system::error_code &error)
+{
+    // the timer was cancelled or has already expired when data arrived
+    if (error == boost::asio::error::operation_aborted ||
+        timer.expires_at() > boost::asio::deadline_timer::traits_type::now() || !is_idle())
+    {
+        return;
+    }
+
+    go_away(NO_ERROR);
+    flush();
+}
+
+void Http2Connection::shutdown()
+{
+    // Initiate graceful connection closure, the pending read completes with an error.
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+    TCP_socket.close(ignore_error);
+}
+}
+}
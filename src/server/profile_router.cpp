@@ -0,0 +1,68 @@
+#include "server/profile_router.hpp"
+
+#include "server/api/parsed_url.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/json_container.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+ProfileDataset ProfileDataset::FromString(const std::string &dataset)
+{
+    const auto separator = dataset.find('=');
+    // profiles are parsed from the URL as alphanumeric names
+    const auto profile_end = dataset.begin() + std::min(separator, dataset.size());
+    const bool alphanumeric = std::all_of(dataset.begin(), profile_end, [](const char character) {
+        return std::isalnum(static_cast<unsigned char>(character));
+    });
+    if (separator == std::string::npos || separator == 0 || separator + 1 == dataset.size() ||
+        !alphanumeric)
+    {
+        throw util::exception("Invalid dataset " + dataset +
+                              ", expected PROFILE=PATH with an alphanumeric profile" + SOURCE_REF);
+    }
+    return ProfileDataset{dataset.substr(0, separator), dataset.substr(separator + 1)};
+}
+
+ProfileRouter::ProfileRouter(std::unique_ptr<ServiceHandlerInterface> default_handler)
+    : default_handler(std::move(default_handler))
+{
+}
+
+void ProfileRouter::AddProfile(const std::string &profile,
+                               std::unique_ptr<ServiceHandlerInterface> handler)
+{
+    if (!handlers.emplace(profile, std::move(handler)).second)
+    {
+        throw util::exception("Several datasets for the profile " + profile + SOURCE_REF);
+    }
+}
+
+engine::Status ProfileRouter::RunQuery(api::ParsedURL parsed_url, ResultT &result)
+{
+    const auto handler = handlers.find(parsed_url.profile);
+    if (handler != handlers.end())
+    {
+        return handler->second->RunQuery(std::move(parsed_url), result);
+    }
+    if (default_handler)
+    {
+        return default_handler->RunQuery(std::move(parsed_url), result);
+    }
+
+    result = util::json::Object();
+    auto &json_result = result.get<util::json::Object>();
+    json_result.values["code"] = "InvalidProfile";
+    json_result.values["message"] = "Profile " + parsed_url.profile + " not found!";
+    return engine::Status::Error;
+}
+}
+}
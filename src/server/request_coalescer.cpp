@@ -0,0 +1,94 @@
+#include "server/request_coalescer.hpp"
+
+#include <boost/assert.hpp>
+
+#include <sstream>
+
+namespace osrm
+{
+namespace server
+{
+
+RequestCoalescer::Ticket::~Ticket()
+{
+    // a leader that didn't publish lets its followers compute their replies
+    if (coalescer && leader)
+    {
+        coalescer->Complete(key, flight, nullptr);
+    }
+}
+
+void RequestCoalescer::Ticket::Publish(std::shared_ptr<const SharedReply> reply)
+{
+    BOOST_ASSERT(leader && coalescer);
+    coalescer->Complete(key, flight, std::move(reply));
+    coalescer = nullptr;
+}
+
+std::shared_ptr<const SharedReply> RequestCoalescer::Ticket::Wait(const Clock::time_point until)
+{
+    BOOST_ASSERT(!leader);
+    std::unique_lock<std::mutex> lock(flight->mutex);
+    const auto is_done = [this] { return flight->done; };
+    if (until == Clock::time_point::max())
+    {
+        flight->completed.wait(lock, is_done);
+    }
+    else if (!flight->completed.wait_until(lock, until, is_done))
+    {
+        return nullptr;
+    }
+    if (flight->reply)
+    {
+        ++coalescer->shared_replies;
+    }
+    return flight->reply;
+}
+
+RequestCoalescer::Ticket RequestCoalescer::Join(std::string key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto iter = flights.find(key);
+    if (iter != flights.end())
+    {
+        ++followers;
+        return Ticket(this, std::move(key), iter->second, false);
+    }
+
+    auto flight = std::make_shared<Flight>();
+    flights.emplace(key, flight);
+    return Ticket(this, std::move(key), std::move(flight), true);
+}
+
+void RequestCoalescer::Complete(const std::string &key,
+                                const std::shared_ptr<Flight> &flight,
+                                std::shared_ptr<const SharedReply> reply)
+{
+    {
+        // requests that arrive from now on start a new computation
+        std::lock_guard<std::mutex> lock(mutex);
+        flights.erase(key);
+    }
+    {
+        std::lock_guard<std::mutex> lock(flight->mutex);
+        flight->done = true;
+        flight->reply = std::move(reply);
+    }
+    flight->completed.notify_all();
+}
+
+std::string RequestCoalescer::DumpPrometheus() const
+{
+    std::stringstream out;
+    out << "# HELP osrm_coalesced_requests_total Requests that waited for an identical request "
+           "in flight.\n";
+    out << "# TYPE osrm_coalesced_requests_total counter\n";
+    out << "osrm_coalesced_requests_total " << followers.load() << "\n";
+    out << "# HELP osrm_shared_replies_total Requests that were sent the reply of an identical "
+           "request.\n";
+    out << "# TYPE osrm_shared_replies_total counter\n";
+    out << "osrm_shared_replies_total " << shared_replies.load() << "\n";
+    return out.str();
+}
+}
+}
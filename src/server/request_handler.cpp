@@ -1,31 +1,43 @@
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
 
+#include "server/api/body_parser.hpp"
 #include "server/api/url_parser.hpp"
+#include "server/http/compressor.hpp"
 #include "server/http/reply.hpp"
 #include "server/http/request.hpp"
 
+#include "util/buffer_chain.hpp"
+#include "util/heap_memory.hpp"
 #include "util/json_renderer.hpp"
 #include "util/log.hpp"
+#include "util/request_timing.hpp"
 #include "util/string_util.hpp"
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
+#include "engine/data_memory.hpp"
 #include "engine/status.hpp"
 #include "osrm/osrm.hpp"
 #include "util/json_container.hpp"
 
-#include <boost/iostreams/copy.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/optional.hpp>
 
+#include <cctype>
 #include <ctime>
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace osrm
 {
@@ -38,6 +50,312 @@ void RequestHandler::RegisterServiceHandler(
     service_handler = std::move(service_handler_);
 }
 
+namespace
+{
+// Seconds a client should wait after a request got rejected by the admission control
+const constexpr unsigned RETRY_AFTER_SECONDS = 1;
+
+// Requests with a body may end the URL after the profile or continue with the options right
+// after it, e.g. /table/v1/driving?annotations=distance, the slash after the profile is added
+void addProfileSlash(std::string &request_string)
+{
+    // /{service}/v{version}/{profile}
+    const auto version = request_string.find('/', 1);
+    const auto profile =
+        version == std::string::npos ? version : request_string.find('/', version + 1);
+    if (profile == std::string::npos)
+    {
+        return;
+    }
+    const auto profile_end = std::find_if_not(request_string.begin() + profile + 1,
+                                              request_string.end(),
+                                              [](const char character) {
+                                                  return std::isalnum(
+                                                      static_cast<unsigned char>(character));
+                                              });
+    if (profile_end == request_string.end() || *profile_end != '/')
+    {
+        request_string.insert(profile_end, '/');
+    }
+}
+
+// JSON and binary bodies of POST requests hold the coordinates and the lists per coordinate,
+// which are parsed straight into the body parameters. Other bodies continue the URL in its
+// syntax. Returns false if the body is malformed.
+bool parseBody(const http::request &current_request,
+               std::string &request_string,
+               boost::optional<api::BodyParameters> &body)
+{
+    if (current_request.method != "POST" || current_request.body.empty())
+    {
+        return true;
+    }
+
+    addProfileSlash(request_string);
+    if (boost::istarts_with(current_request.content_type, "application/json"))
+    {
+        body.emplace();
+        return api::parseJSONBody(current_request.body, *body);
+    }
+    if (boost::istarts_with(current_request.content_type, api::BINARY_BODY_CONTENT_TYPE))
+    {
+        body.emplace();
+        return api::parseBinaryBody(current_request.body, *body);
+    }
+    request_string += current_request.body;
+    return true;
+}
+
+// Only table requests have sources and destinations and only match requests timestamps
+bool isTakenBy(const api::BodyParameters &body, const std::string &service)
+{
+    return service != "tile" &&
+           (service == "table" || (body.sources.empty() && body.destinations.empty())) &&
+           (service == "match" || body.timestamps.empty());
+}
+
+// Headers of the reply that are the same for every request with the same reply
+std::vector<std::pair<std::string, std::string>> GetSharedHeaders(const http::reply &reply)
+{
+    std::vector<std::pair<std::string, std::string>> headers;
+    for (const auto &header : reply.headers)
+    {
+        // set by the connection of each request
+        if (header.name != "Connection")
+        {
+            headers.emplace_back(header.name, header.value);
+        }
+    }
+    return headers;
+}
+
+// Copy of the reply for the response cache, its content is stored compactly
+std::shared_ptr<const CachedReply> CacheReply(const std::string &service,
+                                              const http::reply &reply)
+{
+    auto cached_reply = std::make_shared<CachedReply>();
+    cached_reply->service = service;
+    cached_reply->headers = GetSharedHeaders(reply);
+    cached_reply->content.reserve(reply.content_chain.size());
+    for (std::size_t index = 0; index < reply.content_chain.buffer_count(); ++index)
+    {
+        cached_reply->content.append(reply.content_chain.buffer_data(index),
+                                     reply.content_chain.buffer_size(index));
+    }
+    return cached_reply;
+}
+
+// Moves the content of the reply into one that is shared with the followers of the request
+std::shared_ptr<const SharedReply> ShareReply(http::reply &reply)
+{
+    auto shared_reply = std::make_shared<SharedReply>();
+    shared_reply->headers = GetSharedHeaders(reply);
+    reply.shared_content =
+        std::make_shared<const util::BufferChain>(std::move(reply.content_chain));
+    shared_reply->content = reply.shared_content;
+    return shared_reply;
+}
+
+// Appends a logfmt value, quoted if it is empty or contains spaces, quotes or equal signs
+void appendLogfmtValue(std::string &line, const std::string &value)
+{
+    const bool quoted = value.empty() || value.find_first_of(" \"=\\\t") != std::string::npos;
+    if (!quoted)
+    {
+        line += value;
+        return;
+    }
+
+    line.push_back('"');
+    for (const char character : value)
+    {
+        if (character == '"' || character == '\\')
+        {
+            line.push_back('\\');
+        }
+        line.push_back(character);
+    }
+    line.push_back('"');
+}
+
+// Server-Timing header value with the durations of all measured stages in milliseconds
+std::string GetServerTiming(const util::RequestTimings &timings)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::stringstream value;
+    value << std::fixed << std::setprecision(3);
+    for (std::size_t index = 0; index < util::NUM_REQUEST_STAGES; ++index)
+    {
+        const auto stage = static_cast<util::RequestStage>(index);
+        if (timings.IsMeasured(stage))
+        {
+            value << util::ToString(stage) << ";dur="
+                  << Milliseconds(timings.GetDuration(stage)).count() << ", ";
+        }
+    }
+    value << util::ToString(util::RequestStage::None)
+          << ";dur=" << Milliseconds(timings.GetTotal()).count();
+    return value.str();
+}
+
+// True for the given share of the calls
+bool IsSampled(const double sample_rate)
+{
+    if (sample_rate >= 1.0)
+    {
+        return true;
+    }
+    if (sample_rate <= 0.0)
+    {
+        return false;
+    }
+    thread_local std::mt19937 generator{std::random_device{}()};
+    return std::uniform_real_distribution<double>{0.0, 1.0}(generator) < sample_rate;
+}
+}
+
+bool RequestHandler::IsAccessLogged(const http::reply &current_reply) const
+{
+    return current_reply.status != http::reply::ok || IsSampled(access_log_sample_rate);
+}
+
+bool RequestHandler::IsTraced(const http::request &current_request) const
+{
+    return trace_writer && (current_request.trace || IsSampled(trace_sample_rate));
+}
+
+AdmissionControl::Ticket RequestHandler::Admit(const std::string &service) const
+{
+    if (!admission_control)
+    {
+        return AdmissionControl::Ticket::Unlimited();
+    }
+    util::ScopedStageTimer queue_timer(util::RequestStage::Queue);
+    return admission_control->Admit(service);
+}
+
+void RequestHandler::HandleMetricsRequest(http::reply &current_reply) const
+{
+    auto metrics = util::RequestMetrics::GetInstance().DumpPrometheus();
+    metrics += util::HeapMemoryMetrics::GetInstance().DumpPrometheus();
+    metrics += engine::DataMemoryMetrics::GetInstance().DumpPrometheus();
+    if (admission_control)
+    {
+        metrics += admission_control->DumpPrometheus();
+    }
+    if (coalescer)
+    {
+        metrics += coalescer->DumpPrometheus();
+    }
+    if (response_cache)
+    {
+        metrics += response_cache->DumpPrometheus();
+    }
+    if (compute_pool)
+    {
+        metrics += compute_pool->DumpPrometheus();
+    }
+    current_reply.content_chain.append(metrics.data(), metrics.size());
+    current_reply.headers.emplace_back("Content-Type", "text/plain; version=0.0.4");
+    current_reply.headers.emplace_back("Content-Length", std::to_string(metrics.size()));
+}
+
+ComputePriority RequestHandler::GetPriority(const http::request &current_request)
+{
+    // the service is the first segment of the URI, e.g. /table/v1/...
+    const auto &uri = current_request.uri;
+    const std::size_t begin = uri.empty() || uri.front() != '/' ? 0 : 1;
+    const auto end = std::min(uri.find('/', begin), uri.size());
+    return ComputePool::GetPriority(uri.substr(begin, end - begin));
+}
+
+engine::QueryDeadline RequestHandler::MakeDeadline(const unsigned timeout) const
+{
+    // the earlier of the timeout of the client and the one of the server
+    const bool client_timeout_is_earlier =
+        timeout > 0 && (max_query_time < 0 || timeout < static_cast<unsigned>(max_query_time));
+    const auto max_time = client_timeout_is_earlier ? static_cast<int>(timeout) : max_query_time;
+    return max_time < 0 ? engine::QueryDeadline{}
+                        : engine::QueryDeadline::In(std::chrono::milliseconds(max_time));
+}
+
+void RequestHandler::RenderReply(const http::request &request,
+                                 const ServiceHandler::ResultT &result,
+                                 http::reply &reply) const
+{
+    reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
+    reply.headers.emplace_back("Access-Control-Allow-Methods", "GET, POST");
+    reply.headers.emplace_back("Access-Control-Allow-Headers", "X-Requested-With, Content-Type");
+    // the content is written into pooled buffers, compressed while it is rendered if the
+    // client accepts it. The compressor is only created for the first buffer that is passed
+    // on, that's when the size of small replies is known.
+    const bool compress = request.compression != http::no_compression;
+    std::unique_ptr<http::Compressor> compressor;
+    util::BufferChain uncompressed_content;
+    bool rendered = false;
+    if (compress)
+    {
+        uncompressed_content = util::BufferChain([&](const char *data, const std::size_t size) {
+            if (!compressor && rendered && size < compression.min_size)
+            {
+                reply.content_chain.append(data, size);
+                return;
+            }
+            if (!compressor)
+            {
+                compressor = std::make_unique<http::Compressor>(
+                    request.compression, compression, reply.content_chain);
+            }
+            compressor->write(data, size);
+        });
+    }
+    auto &content = compress ? uncompressed_content : reply.content_chain;
+
+    if (result.is<util::json::Object>())
+    {
+        reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+        reply.headers.emplace_back("Content-Disposition", "inline; filename=\"response.json\"");
+
+        util::json::render(content, result.get<util::json::Object>());
+    }
+    else if (result.is<service::RenderedJSON>())
+    {
+        reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+        reply.headers.emplace_back("Content-Disposition", "inline; filename=\"response.json\"");
+
+        const auto &rendered = result.get<service::RenderedJSON>().value;
+        content.append(rendered.data(), rendered.size());
+    }
+    else if (result.is<service::RenderedBinary>())
+    {
+        reply.headers.emplace_back("Content-Type", "application/x-osrm-binary");
+
+        const auto &rendered = result.get<service::RenderedBinary>().value;
+        content.append(rendered.data(), rendered.size());
+    }
+    else
+    {
+        BOOST_ASSERT(result.is<std::string>());
+        content.append(result.get<std::string>().data(), result.get<std::string>().size());
+
+        reply.headers.emplace_back("Content-Type", "application/x-protobuf");
+    }
+
+    if (compress)
+    {
+        rendered = true;
+        uncompressed_content.flush();
+    }
+    if (compressor)
+    {
+        compressor->finish();
+        reply.headers.insert(reply.headers.begin(),
+                             {"Content-Encoding", http::toContentEncoding(request.compression)});
+    }
+    reply.headers.emplace_back("Content-Length", std::to_string(reply.content_chain.size()));
+}
+
 void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
 {
     if (!service_handler)
@@ -48,34 +366,139 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
     }
 
     const auto tid = std::this_thread::get_id();
+    auto &timings = util::RequestTimings::GetCurrent();
+    timings.Reset();
+    if (IsTraced(current_request))
+    {
+        timings.StartTrace();
+    }
+    const auto deadline = MakeDeadline(current_request.timeout);
 
     // parse command
     try
     {
         TIMER_START(request_duration);
-        std::string request_string;
+        // reused by the requests of the thread so it doesn't allocate each time
+        thread_local std::string request_string;
         util::URIDecode(current_request.uri, request_string);
+        boost::optional<api::BodyParameters> body;
+        const bool valid_body = parseBody(current_request, request_string, body);
+        // the request string is the key of the replies, a parsed body is not part of it
+        const bool cacheable = valid_body && !body;
 
         util::Log(logDEBUG) << "[req][" << tid << "] " << request_string;
 
+        if (request_string == "/metrics")
+        {
+            HandleMetricsRequest(current_reply);
+            return;
+        }
+
+        // identical requests have the same reply, the encoding is part of the key since the
+        // content is kept compressed
+        std::string reply_key;
+        if ((coalescer || response_cache) && cacheable)
+        {
+            reply_key = std::to_string(current_request.compression) + " " + request_string;
+        }
+
+        // repeated requests are answered from the cache before they are even parsed
+        unsigned cache_epoch = 0;
+        std::shared_ptr<const CachedReply> cached_reply;
+        if (response_cache && cacheable)
+        {
+            cache_epoch = response_cache->GetEpoch(service_handler->GetDataset());
+            cached_reply = response_cache->Get(cache_epoch, reply_key);
+        }
+
         auto api_iterator = request_string.begin();
-        auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
+        boost::optional<api::ParsedURL> maybe_parsed_url;
+        if (valid_body && !cached_reply)
+        {
+            util::ScopedStageTimer parse_timer(util::RequestStage::Parse);
+            maybe_parsed_url =
+                api::parseURL(api_iterator, request_string.end(), static_cast<bool>(body));
+        }
         ServiceHandler::ResultT result;
+        // the parsed URL is moved into the query
+        std::string service;
 
-        // check if the was an error with the request
-        if (maybe_parsed_url && api_iterator == request_string.end())
+        // identical requests in flight share the reply of the first one
+        boost::optional<RequestCoalescer::Ticket> flight;
+        std::shared_ptr<const SharedReply> shared_reply;
+        if (coalescer && cacheable && maybe_parsed_url && api_iterator == request_string.end())
         {
+            flight.emplace(coalescer->Join(reply_key));
+            if (!flight->IsLeader())
+            {
+                util::ScopedStageTimer queue_timer(util::RequestStage::Queue);
+                shared_reply = flight->Wait(deadline.ExpiresAt());
+            }
+        }
 
-            const engine::Status status =
-                service_handler->RunQuery(*std::move(maybe_parsed_url), result);
-            if (status != engine::Status::Ok)
+        // check if the was an error with the request
+        if (cached_reply)
+        {
+            service = cached_reply->service;
+        }
+        else if (shared_reply)
+        {
+            service = maybe_parsed_url->service;
+        }
+        else if (!valid_body)
+        {
+            current_reply.status = http::reply::bad_request;
+            result = util::json::Object();
+            auto &json_result = result.get<util::json::Object>();
+            json_result.values["code"] = "InvalidBody";
+            json_result.values["message"] = "Body is neither a JSON object of the coordinates and "
+                                             "lists per coordinate nor binary coordinates";
+        }
+        else if (body && maybe_parsed_url && !isTakenBy(*body, maybe_parsed_url->service))
+        {
+            current_reply.status = http::reply::bad_request;
+            result = util::json::Object();
+            auto &json_result = result.get<util::json::Object>();
+            json_result.values["code"] = "InvalidBody";
+            json_result.values["message"] =
+                "Body has lists the " + maybe_parsed_url->service + " service does not take";
+        }
+        else if (maybe_parsed_url && api_iterator == request_string.end())
+        {
+            const auto ticket = Admit(maybe_parsed_url->service);
+            if (!ticket)
             {
-                // 4xx bad request return code
-                current_reply.status = http::reply::bad_request;
+                // 503 so clients back off instead of waiting for a reply that might time out
+                current_reply.status = http::reply::service_unavailable;
+                current_reply.headers.emplace_back("Retry-After",
+                                                   std::to_string(RETRY_AFTER_SECONDS));
+                result = util::json::Object();
+                auto &json_result = result.get<util::json::Object>();
+                json_result.values["code"] = "ServiceUnavailable";
+                json_result.values["message"] =
+                    "Too many " + maybe_parsed_url->service + " requests, retry later";
             }
             else
             {
-                BOOST_ASSERT(status == engine::Status::Ok);
+                service = maybe_parsed_url->service;
+                maybe_parsed_url->deadline = deadline;
+                maybe_parsed_url->body = std::move(body);
+                const engine::Status status =
+                    service_handler->RunQuery(*std::move(maybe_parsed_url), result);
+                if (status != engine::Status::Ok && deadline.IsExpired())
+                {
+                    // the searches gave up, the Timeout error is in the result
+                    current_reply.status = http::reply::gateway_timeout;
+                }
+                else if (status != engine::Status::Ok)
+                {
+                    // 4xx bad request return code
+                    current_reply.status = http::reply::bad_request;
+                }
+                else
+                {
+                    BOOST_ASSERT(status == engine::Status::Ok);
+                }
             }
         }
         else
@@ -98,65 +521,102 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
                                             std::to_string(position) + ": \"" + context + "\"";
         }
 
-        current_reply.headers.emplace_back("Access-Control-Allow-Origin", "*");
-        current_reply.headers.emplace_back("Access-Control-Allow-Methods", "GET");
-        current_reply.headers.emplace_back("Access-Control-Allow-Headers",
-                                           "X-Requested-With, Content-Type");
-        if (result.is<util::json::Object>())
+        timings.Enter(util::RequestStage::Render);
+        if (cached_reply)
         {
-            current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
-            current_reply.headers.emplace_back("Content-Disposition",
-                                               "inline; filename=\"response.json\"");
-
-            util::json::render(current_reply.content, result.get<util::json::Object>());
+            for (const auto &header : cached_reply->headers)
+            {
+                current_reply.headers.emplace_back(header.first, header.second);
+            }
+            current_reply.content.assign(cached_reply->content.begin(),
+                                         cached_reply->content.end());
+        }
+        else if (shared_reply)
+        {
+            for (const auto &header : shared_reply->headers)
+            {
+                current_reply.headers.emplace_back(header.first, header.second);
+            }
+            current_reply.shared_content = shared_reply->content;
         }
         else
         {
-            BOOST_ASSERT(result.is<std::string>());
-            current_reply.content.resize(result.get<std::string>().size());
-            std::copy(result.get<std::string>().cbegin(),
-                      result.get<std::string>().cend(),
-                      current_reply.content.begin());
-
-            current_reply.headers.emplace_back("Content-Type", "application/x-protobuf");
+            RenderReply(current_request, result, current_reply);
+            // matching a trace can continue a session, the reply depends on earlier requests
+            if (response_cache && cacheable && current_reply.status == http::reply::ok &&
+                service != "match")
+            {
+                response_cache->Put(cache_epoch, reply_key, CacheReply(service, current_reply));
+            }
+            if (flight && flight->IsLeader() && current_reply.status == http::reply::ok)
+            {
+                flight->Publish(ShareReply(current_reply));
+            }
         }
+        timings.Enter(util::RequestStage::None);
 
-        // set headers
-        current_reply.headers.emplace_back("Content-Length",
-                                           std::to_string(current_reply.content.size()));
-
-        if (!std::getenv("DISABLE_ACCESS_LOGGING"))
+        if (server_timing)
+        {
+            current_reply.headers.emplace_back("Server-Timing", GetServerTiming(timings));
+        }
+        util::RequestMetrics::GetInstance().Record(timings, service);
+        if (timings.IsTraced())
         {
-            // deactivated as GCC apparently does not implement that, not even in 4.9
-            // std::time_t t = std::time(nullptr);
-            // util::Log() << std::put_time(std::localtime(&t), "%m-%d-%Y
-            // %H:%M:%S") <<
-            //     " " << current_request.endpoint.to_string() << " " <<
-            //     current_request.referrer << ( 0 == current_request.referrer.length() ? "- " :" ")
-            //     <<
-            //     current_request.agent << ( 0 == current_request.agent.length() ? "- " :" ") <<
-            //     request;
+            trace_writer->Write(timings, service, request_string, current_reply.status);
+        }
 
-            time_t ltime;
-            struct tm *time_stamp;
+        if (!std::getenv("DISABLE_ACCESS_LOGGING") && IsAccessLogged(current_reply))
+        {
             TIMER_STOP(request_duration);
+            const time_t ltime = time(nullptr);
 
-            ltime = time(nullptr);
-            time_stamp = localtime(&ltime);
-            // log timestamp
-            util::Log() << (time_stamp->tm_mday < 10 ? "0" : "") << time_stamp->tm_mday << "-"
-                        << (time_stamp->tm_mon + 1 < 10 ? "0" : "") << (time_stamp->tm_mon + 1)
-                        << "-" << 1900 + time_stamp->tm_year << " "
-                        << (time_stamp->tm_hour < 10 ? "0" : "") << time_stamp->tm_hour << ":"
-                        << (time_stamp->tm_min < 10 ? "0" : "") << time_stamp->tm_min << ":"
-                        << (time_stamp->tm_sec < 10 ? "0" : "") << time_stamp->tm_sec << " "
-                        << TIMER_MSEC(request_duration) << "ms "
-                        << current_request.endpoint.to_string() << " " << current_request.referrer
-                        << (0 == current_request.referrer.length() ? "- " : " ")
-                        << current_request.agent
-                        << (0 == current_request.agent.length() ? "- " : " ")
-                        << current_reply.status << " " //
-                        << request_string;
+            if (access_log_format == AccessLogFormat::Logfmt)
+            {
+                struct tm time_stamp;
+                gmtime_r(&ltime, &time_stamp);
+                char time_string[sizeof("1970-01-01T00:00:00Z")];
+                std::strftime(
+                    time_string, sizeof(time_string), "%Y-%m-%dT%H:%M:%SZ", &time_stamp);
+
+                std::string line;
+                line.reserve(128 + request_string.size());
+                line += "time=";
+                line += time_string;
+                line += " duration_ms=";
+                line += std::to_string(TIMER_MSEC(request_duration));
+                line += " remote=";
+                line += current_request.endpoint.to_string();
+                line += " status=";
+                line += std::to_string(current_reply.status);
+                line += " service=";
+                appendLogfmtValue(line, service);
+                line += " referrer=";
+                appendLogfmtValue(line, current_request.referrer);
+                line += " agent=";
+                appendLogfmtValue(line, current_request.agent);
+                line += " request=";
+                appendLogfmtValue(line, request_string);
+                util::Log() << line;
+            }
+            else
+            {
+                const struct tm *time_stamp = localtime(&ltime);
+                // log timestamp
+                util::Log() << (time_stamp->tm_mday < 10 ? "0" : "") << time_stamp->tm_mday << "-"
+                            << (time_stamp->tm_mon + 1 < 10 ? "0" : "") << (time_stamp->tm_mon + 1)
+                            << "-" << 1900 + time_stamp->tm_year << " "
+                            << (time_stamp->tm_hour < 10 ? "0" : "") << time_stamp->tm_hour << ":"
+                            << (time_stamp->tm_min < 10 ? "0" : "") << time_stamp->tm_min << ":"
+                            << (time_stamp->tm_sec < 10 ? "0" : "") << time_stamp->tm_sec << " "
+                            << TIMER_MSEC(request_duration) << "ms "
+                            << current_request.endpoint.to_string() << " "
+                            << current_request.referrer
+                            << (0 == current_request.referrer.length() ? "- " : " ")
+                            << current_request.agent
+                            << (0 == current_request.agent.length() ? "- " : " ")
+                            << current_reply.status << " " //
+                            << request_string;
+            }
         }
     }
     catch (const std::exception &e)
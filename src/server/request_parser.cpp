@@ -1,11 +1,13 @@
 #include "server/request_parser.hpp"
 
 #include "server/http/compression_type.hpp"
+#include "server/http/compressor.hpp"
 #include "server/http/header.hpp"
 #include "server/http/request.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
 
+#include <algorithm>
 #include <string>
 
 namespace osrm
@@ -13,26 +15,57 @@ namespace osrm
 namespace server
 {
 
-RequestParser::RequestParser()
+namespace
+{
+// more would overflow the milliseconds of a timeout
+const constexpr std::size_t MAX_TIMEOUT_DIGITS = 9;
+}
+
+RequestParser::RequestParser(const std::size_t max_body_size)
     : state(internal_state::method_start), current_header({"", ""}),
-      selected_compression(http::no_compression)
+      selected_compression(http::no_compression), http_version_major(0), http_version_minor(0),
+      max_body_size(max_body_size), content_length(0)
+{
+}
+
+void RequestParser::reset()
 {
+    state = internal_state::method_start;
+    current_header.clear();
+    selected_compression = http::no_compression;
+    http_version_major = 0;
+    http_version_minor = 0;
+    content_length = 0;
 }
 
-std::tuple<RequestParser::RequestStatus, http::compression_type>
+std::tuple<RequestParser::RequestStatus, http::compression_type, char *>
 RequestParser::parse(http::request &current_request, char *begin, char *end)
 {
     while (begin != end)
     {
+        if (state == internal_state::body)
+        {
+            auto &body = current_request.body;
+            const auto count =
+                std::min<std::size_t>(end - begin, content_length - body.size());
+            body.append(begin, count);
+            begin += count;
+            if (body.size() == content_length)
+            {
+                return std::make_tuple(RequestStatus::valid, selected_compression, begin);
+            }
+            continue;
+        }
+
         RequestStatus result = consume(current_request, *begin++);
         if (result != RequestStatus::indeterminate)
         {
-            return std::make_tuple(result, selected_compression);
+            return std::make_tuple(result, selected_compression, begin);
         }
     }
     RequestStatus result = RequestStatus::indeterminate;
 
-    return std::make_tuple(result, selected_compression);
+    return std::make_tuple(result, selected_compression, begin);
 }
 
 RequestParser::RequestStatus RequestParser::consume(http::request &current_request,
@@ -46,6 +79,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             return RequestStatus::invalid;
         }
         state = internal_state::method;
+        current_request.method.push_back(input);
         return RequestStatus::indeterminate;
     case internal_state::method:
         if (input == ' ')
@@ -57,6 +91,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         {
             return RequestStatus::invalid;
         }
+        current_request.method.push_back(input);
         return RequestStatus::indeterminate;
     case internal_state::uri_start:
         if (is_CTL(input))
@@ -116,6 +151,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_major_start:
         if (is_digit(input))
         {
+            http_version_major = input - '0';
             state = internal_state::http_version_major;
             return RequestStatus::indeterminate;
         }
@@ -128,12 +164,14 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            http_version_major = 10 * http_version_major + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
     case internal_state::http_version_minor_start:
         if (is_digit(input))
         {
+            http_version_minor = input - '0';
             state = internal_state::http_version_minor;
             return RequestStatus::indeterminate;
         }
@@ -141,11 +179,15 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_minor:
         if (input == '\r')
         {
+            // HTTP/1.1 connections are persistent unless the client asks to close them
+            current_request.keep_alive =
+                http_version_major > 1 || (http_version_major == 1 && http_version_minor >= 1);
             state = internal_state::expecting_newline_1;
             return RequestStatus::indeterminate;
         }
         if (is_digit(input))
         {
+            http_version_minor = 10 * http_version_minor + (input - '0');
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
@@ -159,15 +201,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::header_line_start:
         if (boost::iequals(current_header.name, "Accept-Encoding"))
         {
-            /* giving gzip precedence over deflate */
-            if (boost::icontains(current_header.value, "deflate"))
-            {
-                selected_compression = http::deflate_rfc1951;
-            }
-            if (boost::icontains(current_header.value, "gzip"))
-            {
-                selected_compression = http::gzip_rfc1952;
-            }
+            selected_compression = http::selectCompression(current_header.value);
         }
 
         if (boost::iequals(current_header.name, "Referer"))
@@ -180,6 +214,60 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             current_request.agent = current_header.value;
         }
 
+        if (boost::iequals(current_header.name, "Content-Type"))
+        {
+            current_request.content_type = current_header.value;
+        }
+
+        if (boost::iequals(current_header.name, "Content-Length"))
+        {
+            if (current_header.value.empty() ||
+                !std::all_of(current_header.value.begin(),
+                             current_header.value.end(),
+                             [this](const char character) { return is_digit(character); }))
+            {
+                return RequestStatus::invalid;
+            }
+            // digits beyond the maximal size would only overflow
+            content_length = 0;
+            for (const auto digit : current_header.value)
+            {
+                content_length = 10 * content_length + (digit - '0');
+                if (content_length > max_body_size)
+                {
+                    return RequestStatus::invalid;
+                }
+            }
+        }
+
+        // the time in milliseconds the client waits for the reply, other values are ignored
+        if (boost::iequals(current_header.name, "X-OSRM-Timeout") &&
+            !current_header.value.empty() &&
+            current_header.value.size() <= MAX_TIMEOUT_DIGITS &&
+            std::all_of(current_header.value.begin(),
+                        current_header.value.end(),
+                        [this](const char character) { return is_digit(character); }))
+        {
+            current_request.timeout = std::stoul(current_header.value);
+        }
+
+        if (boost::iequals(current_header.name, "X-OSRM-Trace"))
+        {
+            current_request.trace = current_header.value == "1";
+        }
+
+        if (boost::iequals(current_header.name, "Connection"))
+        {
+            if (boost::icontains(current_header.value, "close"))
+            {
+                current_request.keep_alive = false;
+            }
+            else if (boost::icontains(current_header.value, "keep-alive"))
+            {
+                current_request.keep_alive = true;
+            }
+        }
+
         if (input == '\r')
         {
             state = internal_state::expecting_newline_3;
@@ -247,8 +335,20 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
-    default: // expecting_newline_3
-        return input == '\n' ? RequestStatus::valid : RequestStatus::invalid;
+    case internal_state::expecting_newline_3:
+        if (input != '\n')
+        {
+            return RequestStatus::invalid;
+        }
+        if (content_length == 0)
+        {
+            return RequestStatus::valid;
+        }
+        // the body grows as its bytes arrive, a Content-Length alone allocates nothing
+        state = internal_state::body;
+        return RequestStatus::indeterminate;
+    default: // body, copied by parse
+        return RequestStatus::invalid;
     }
 }
 
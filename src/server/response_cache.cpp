@@ -0,0 +1,152 @@
+#include "server/response_cache.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <sstream>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+// Bytes of a reply and its key, including the bookkeeping of the cache
+std::size_t GetSize(const std::string &key, const CachedReply &reply)
+{
+    auto size = 2 * key.size() + reply.service.size() + reply.content.size() +
+                sizeof(CachedReply) + 64;
+    for (const auto &header : reply.headers)
+    {
+        size += header.first.size() + header.second.size() + sizeof(header);
+    }
+    return size;
+}
+}
+
+ResponseCache::ResponseCache(const std::size_t capacity,
+                             const std::chrono::seconds ttl,
+                             const std::size_t number_of_shards)
+    : shard_capacity(capacity / std::max<std::size_t>(1, number_of_shards)), ttl(ttl),
+      shards(std::max<std::size_t>(1, number_of_shards))
+{
+    for (auto &shard : shards)
+    {
+        shard = std::make_unique<Shard>();
+    }
+}
+
+unsigned ResponseCache::GetEpoch(const std::shared_ptr<const void> &dataset)
+{
+    const auto dataset_epoch = epoch.Get(dataset);
+    // the replies of the previous dataset are unreachable, free their memory right away
+    if (current_epoch.exchange(dataset_epoch) != dataset_epoch)
+    {
+        Clear();
+    }
+    return dataset_epoch;
+}
+
+std::shared_ptr<const CachedReply>
+ResponseCache::Get(const unsigned epoch, const std::string &key, const Clock::time_point now)
+{
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    const auto iter = shard.index.find(key);
+    if (iter == shard.index.end())
+    {
+        ++misses;
+        return nullptr;
+    }
+
+    const auto entry = iter->second;
+    if (entry->epoch != epoch || entry->expires <= now)
+    {
+        Erase(shard, entry);
+        ++misses;
+        return nullptr;
+    }
+
+    shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+    ++hits;
+    return entry->reply;
+}
+
+void ResponseCache::Put(const unsigned epoch,
+                        const std::string &key,
+                        std::shared_ptr<const CachedReply> reply,
+                        const Clock::time_point now)
+{
+    BOOST_ASSERT(reply);
+    const auto entry_size = GetSize(key, *reply);
+    if (entry_size > shard_capacity)
+    {
+        return;
+    }
+
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    const auto iter = shard.index.find(key);
+    if (iter != shard.index.end())
+    {
+        Erase(shard, iter->second);
+    }
+    while (shard.size + entry_size > shard_capacity)
+    {
+        BOOST_ASSERT(!shard.entries.empty());
+        Erase(shard, std::prev(shard.entries.end()));
+    }
+
+    shard.entries.push_front(Entry{key, epoch, now + ttl, entry_size, std::move(reply)});
+    shard.index.emplace(key, shard.entries.begin());
+    shard.size += entry_size;
+    size += entry_size;
+}
+
+void ResponseCache::Clear()
+{
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        size -= shard->size;
+        shard->entries.clear();
+        shard->index.clear();
+        shard->size = 0;
+    }
+}
+
+std::string ResponseCache::DumpPrometheus() const
+{
+    std::stringstream out;
+    out << "# HELP osrm_response_cache_hits_total Requests answered from the response cache.\n";
+    out << "# TYPE osrm_response_cache_hits_total counter\n";
+    out << "osrm_response_cache_hits_total " << hits.load() << "\n";
+    out << "# HELP osrm_response_cache_misses_total Requests the response cache had no reply "
+           "for.\n";
+    out << "# TYPE osrm_response_cache_misses_total counter\n";
+    out << "osrm_response_cache_misses_total " << misses.load() << "\n";
+    out << "# HELP osrm_response_cache_bytes Bytes of the replies in the response cache.\n";
+    out << "# TYPE osrm_response_cache_bytes gauge\n";
+    out << "osrm_response_cache_bytes " << size.load() << "\n";
+    return out.str();
+}
+
+ResponseCache::Shard &ResponseCache::GetShard(const std::string &key)
+{
+    return *shards[std::hash<std::string>()(key) % shards.size()];
+}
+
+void ResponseCache::Erase(Shard &shard, const Shard::EntryList::iterator entry)
+{
+    shard.index.erase(entry->key);
+    shard.size -= entry->size;
+    size -= entry->size;
+    shard.entries.erase(entry);
+}
+}
+}
@@ -36,20 +36,28 @@ std::string getWrongOptionHelp(const engine::api::MatchParameters &parameters)
     {
         help = "Number of coordinates needs to be at least two.";
     }
+    else if (!param_size_mismatch && !parameters.traces.empty())
+    {
+        help = "Traces need to have at least two coordinates each, add up to the number of "
+               "coordinates and can not continue a session.";
+    }
 
     return help;
 }
 } // anon. ns
 
-engine::Status
-MatchService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+engine::Status MatchService::RunQuery(std::size_t prefix_length,
+                                      std::string &query,
+                                      boost::optional<api::BodyParameters> &body,
+                                      const engine::QueryDeadline &deadline,
+                                      ResultT &result)
 {
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
     auto query_iterator = query.begin();
     auto parameters =
-        api::parseParameters<engine::api::MatchParameters>(query_iterator, query.end());
+        api::parseParameters<engine::api::MatchParameters>(body, query_iterator, query.end());
     if (!parameters || query_iterator != query.end())
     {
         const auto position = std::distance(query.begin(), query_iterator);
@@ -67,8 +75,10 @@ MatchService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
         return engine::Status::Error;
     }
     BOOST_ASSERT(parameters->IsValid());
+    parameters->deadline = deadline;
 
-    return BaseService::routing_machine.Match(*parameters, json_result);
+    const auto status = BaseService::routing_machine.Match(*parameters, json_result);
+    return FormatResult(*parameters, status, result);
 }
 }
 }
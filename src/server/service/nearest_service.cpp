@@ -35,15 +35,18 @@ std::string getWrongOptionHelp(const engine::api::NearestParameters &parameters)
 }
 } // anon. ns
 
-engine::Status
-NearestService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+engine::Status NearestService::RunQuery(std::size_t prefix_length,
+                                        std::string &query,
+                                        boost::optional<api::BodyParameters> &body,
+                                        const engine::QueryDeadline &deadline,
+                                        ResultT &result)
 {
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
     auto query_iterator = query.begin();
     auto parameters =
-        api::parseParameters<engine::api::NearestParameters>(query_iterator, query.end());
+        api::parseParameters<engine::api::NearestParameters>(body, query_iterator, query.end());
     if (!parameters || query_iterator != query.end())
     {
         const auto position = std::distance(query.begin(), query_iterator);
@@ -61,8 +64,10 @@ NearestService::RunQuery(std::size_t prefix_length, std::string &query, ResultT
         return engine::Status::Error;
     }
     BOOST_ASSERT(parameters->IsValid());
+    parameters->deadline = deadline;
 
-    return BaseService::routing_machine.Nearest(*parameters, json_result);
+    const auto status = BaseService::routing_machine.Nearest(*parameters, json_result);
+    return FormatResult(*parameters, status, result);
 }
 }
 }
@@ -39,15 +39,18 @@ std::string getWrongOptionHelp(const engine::api::RouteParameters &parameters)
 }
 } // anon. ns
 
-engine::Status
-RouteService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+engine::Status RouteService::RunQuery(std::size_t prefix_length,
+                                      std::string &query,
+                                      boost::optional<api::BodyParameters> &body,
+                                      const engine::QueryDeadline &deadline,
+                                      ResultT &result)
 {
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
     auto query_iterator = query.begin();
     auto parameters =
-        api::parseParameters<engine::api::RouteParameters>(query_iterator, query.end());
+        api::parseParameters<engine::api::RouteParameters>(body, query_iterator, query.end());
     if (!parameters || query_iterator != query.end())
     {
         const auto position = std::distance(query.begin(), query_iterator);
@@ -65,8 +68,10 @@ RouteService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
         return engine::Status::Error;
     }
     BOOST_ASSERT(parameters->IsValid());
+    parameters->deadline = deadline;
 
-    return BaseService::routing_machine.Route(*parameters, json_result);
+    const auto status = BaseService::routing_machine.Route(*parameters, json_result);
+    return FormatResult(*parameters, status, result);
 }
 }
 }
@@ -60,15 +60,18 @@ std::string getWrongOptionHelp(const engine::api::TableParameters &parameters)
 }
 } // anon. ns
 
-engine::Status
-TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+engine::Status TableService::RunQuery(std::size_t prefix_length,
+                                      std::string &query,
+                                      boost::optional<api::BodyParameters> &body,
+                                      const engine::QueryDeadline &deadline,
+                                      ResultT &result)
 {
     result = util::json::Object();
     auto &json_result = result.get<util::json::Object>();
 
     auto query_iterator = query.begin();
     auto parameters =
-        api::parseParameters<engine::api::TableParameters>(query_iterator, query.end());
+        api::parseParameters<engine::api::TableParameters>(body, query_iterator, query.end());
     if (!parameters || query_iterator != query.end())
     {
         const auto position = std::distance(query.begin(), query_iterator);
@@ -86,8 +89,17 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
         return engine::Status::Error;
     }
     BOOST_ASSERT(parameters->IsValid());
+    parameters->deadline = deadline;
 
-    return BaseService::routing_machine.Table(*parameters, json_result);
+    // big tables are rendered without building every duration as a json value
+    if (parameters->format == engine::api::OutputFormatType::Binary)
+    {
+        result = RenderedBinary();
+        return BaseService::routing_machine.Table(*parameters,
+                                                  result.get<RenderedBinary>().value);
+    }
+    result = RenderedJSON();
+    return BaseService::routing_machine.Table(*parameters, result.get<RenderedJSON>().value);
 }
 }
 }
@@ -15,11 +15,15 @@ namespace server
 namespace service
 {
 
-engine::Status TileService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &result)
+engine::Status TileService::RunQuery(std::size_t prefix_length,
+                                     std::string &query,
+                                     boost::optional<api::BodyParameters> &body,
+                                     const engine::QueryDeadline & /*deadline*/,
+                                     ResultT &result)
 {
     auto query_iterator = query.begin();
     auto parameters =
-        api::parseParameters<engine::api::TileParameters>(query_iterator, query.end());
+        api::parseParameters<engine::api::TileParameters>(body, query_iterator, query.end());
     if (!parameters || query_iterator != query.end())
     {
         const auto position = std::distance(query.begin(), query_iterator);
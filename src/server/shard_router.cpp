@@ -0,0 +1,215 @@
+#include "server/shard_router.hpp"
+
+#include "server/api/parameters_parser.hpp"
+#include "server/api/parsed_url.hpp"
+
+#include "engine/api/isochrone_parameters.hpp"
+#include "engine/api/match_parameters.hpp"
+#include "engine/api/nearest_parameters.hpp"
+#include "engine/api/route_parameters.hpp"
+#include "engine/api/table_parameters.hpp"
+#include "engine/api/trip_parameters.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+#include "util/string_util.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+template <typename ParametersT>
+boost::optional<std::vector<util::Coordinate>> parseCoordinates(const std::string &query)
+{
+    auto parameters = api::parseParameters<ParametersT>(query);
+    if (!parameters)
+        return boost::none;
+    return std::move(parameters->coordinates);
+}
+
+boost::optional<std::vector<util::Coordinate>> parseCoordinates(const api::ParsedURL &parsed_url)
+{
+    if (parsed_url.body)
+        return parsed_url.body->base.coordinates;
+    if (parsed_url.service == "route")
+        return parseCoordinates<engine::api::RouteParameters>(parsed_url.query);
+    if (parsed_url.service == "table")
+        return parseCoordinates<engine::api::TableParameters>(parsed_url.query);
+    if (parsed_url.service == "nearest")
+        return parseCoordinates<engine::api::NearestParameters>(parsed_url.query);
+    if (parsed_url.service == "trip")
+        return parseCoordinates<engine::api::TripParameters>(parsed_url.query);
+    if (parsed_url.service == "match")
+        return parseCoordinates<engine::api::MatchParameters>(parsed_url.query);
+    if (parsed_url.service == "isochrone")
+        return parseCoordinates<engine::api::IsochroneParameters>(parsed_url.query);
+    return boost::none;
+}
+
+double parseDegrees(const std::string &value, const double limit)
+{
+    std::size_t parsed_size = 0;
+    double degrees = 0;
+    try
+    {
+        degrees = std::stod(value, &parsed_size);
+    }
+    catch (const std::exception &)
+    {
+    }
+    if (parsed_size == 0 || parsed_size != value.size() || degrees < -limit || degrees > limit)
+    {
+        throw util::exception("Invalid coordinate " + value + SOURCE_REF);
+    }
+    return degrees;
+}
+
+std::int64_t getArea(const Shard &shard)
+{
+    return std::int64_t{static_cast<std::int32_t>(shard.north_east.lon) -
+                        static_cast<std::int32_t>(shard.south_west.lon)} *
+           (static_cast<std::int32_t>(shard.north_east.lat) -
+            static_cast<std::int32_t>(shard.south_west.lat));
+}
+}
+
+Shard Shard::FromString(const std::string &shard)
+{
+    const auto name_end = shard.find('=');
+    const auto box_end = shard.find('@');
+    if (name_end == std::string::npos || name_end == 0 || box_end == std::string::npos ||
+        box_end < name_end)
+    {
+        throw util::exception("Invalid shard " + shard +
+                              ", expected NAME=MIN_LON,MIN_LAT,MAX_LON,MAX_LAT@HOST:PORT" +
+                              SOURCE_REF);
+    }
+
+    std::vector<std::string> bounds;
+    for (auto begin = name_end + 1; begin <= box_end; ++begin)
+    {
+        const auto end = std::min(shard.find(',', begin), box_end);
+        bounds.push_back(shard.substr(begin, end - begin));
+        begin = end;
+    }
+    if (bounds.size() != 4)
+    {
+        throw util::exception("Invalid bounding box of shard " + shard + SOURCE_REF);
+    }
+
+    const util::Coordinate south_west{util::FloatLongitude{parseDegrees(bounds[0], 180)},
+                                      util::FloatLatitude{parseDegrees(bounds[1], 90)}};
+    const util::Coordinate north_east{util::FloatLongitude{parseDegrees(bounds[2], 180)},
+                                      util::FloatLatitude{parseDegrees(bounds[3], 90)}};
+    if (south_west.lon > north_east.lon || south_west.lat > north_east.lat)
+    {
+        throw util::exception("Empty bounding box of shard " + shard + SOURCE_REF);
+    }
+
+    return Shard{shard.substr(0, name_end),
+                 south_west,
+                 north_east,
+                 Backend::FromString(shard.substr(box_end + 1))};
+}
+
+ShardRouter::ShardRouter(std::vector<Shard> shards_,
+                         boost::optional<Backend> fallback,
+                         const std::chrono::milliseconds timeout)
+    : shards(std::move(shards_)), fallback(std::move(fallback)), timeout(timeout)
+{
+    BOOST_ASSERT(!shards.empty());
+    std::stable_sort(shards.begin(), shards.end(), [](const Shard &lhs, const Shard &rhs) {
+        return getArea(lhs) < getArea(rhs);
+    });
+}
+
+const Backend *ShardRouter::SelectBackend(const std::vector<util::Coordinate> &coordinates) const
+{
+    for (const auto &shard : shards)
+    {
+        if (std::all_of(coordinates.begin(),
+                        coordinates.end(),
+                        [&shard](const util::Coordinate coordinate) {
+                            return shard.Contains(coordinate);
+                        }))
+        {
+            return &shard.backend;
+        }
+    }
+    return fallback ? &*fallback : nullptr;
+}
+
+engine::Status ShardRouter::RunQuery(api::ParsedURL parsed_url, ResultT &result)
+{
+    const Backend *backend = nullptr;
+    const auto coordinates = parseCoordinates(parsed_url);
+    if (coordinates && !coordinates->empty())
+    {
+        backend = SelectBackend(*coordinates);
+        if (!backend)
+        {
+            result = util::json::Object();
+            auto &json_result = result.get<util::json::Object>();
+            json_result.values["code"] = "NoShard";
+            json_result.values["message"] = "No shard covers all coordinates";
+            return engine::Status::Error;
+        }
+    }
+    else
+    {
+        // the backend reports the error or serves the request without coordinates
+        backend = fallback ? &*fallback : &shards.front().backend;
+    }
+
+    const auto path = "/" + parsed_url.service + "/v" + std::to_string(parsed_url.version) + "/" +
+                      parsed_url.profile;
+    // a body is passed on in the syntax of the URL as the body of a POST request
+    if (parsed_url.body)
+    {
+        api::prependBodyQuery(*parsed_url.body, parsed_url.query);
+        return Forward(*backend, util::URIEncode(path), parsed_url.query, result);
+    }
+    return Forward(*backend, util::URIEncode(path + "/" + parsed_url.query), {}, result);
+}
+
+engine::Status ShardRouter::Forward(const Backend &backend,
+                                    const std::string &uri,
+                                    const std::string &body,
+                                    ResultT &result) const
+{
+    auto reply =
+        std::move(fetchFromBackends({BackendRequest{backend, uri, body, {}}}, timeout).front());
+    if (reply.status != "200" && reply.status != "400")
+    {
+        throw util::exception("Backend " + backend.host + ":" + backend.port +
+                              " replied with status " + reply.status + SOURCE_REF);
+    }
+
+    // the content type decides how the request handler sends the reply on
+    if (boost::starts_with(reply.content_type, "application/json"))
+    {
+        result = service::RenderedJSON{std::move(reply.content)};
+    }
+    else if (reply.content_type == "application/x-osrm-binary")
+    {
+        result = service::RenderedBinary{std::move(reply.content)};
+    }
+    else
+    {
+        result = std::move(reply.content);
+    }
+
+    return reply.status == "200" ? engine::Status::Ok : engine::Status::Error;
+}
+}
+}
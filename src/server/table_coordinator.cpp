@@ -0,0 +1,514 @@
+#include "server/table_coordinator.hpp"
+
+#include "server/api/parameters_parser.hpp"
+#include "server/api/parsed_url.hpp"
+
+#include "engine/api/binary_builder.hpp"
+#include "engine/api/binary_format.hpp"
+#include "engine/api/table_parameters.hpp"
+#include "engine/hint.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/integer_range.hpp"
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/split.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+namespace
+{
+namespace binary = engine::api::binary;
+
+const constexpr char BINARY_CONTENT_TYPE[] = "application/x-osrm-binary";
+
+// Coordinates of a query and its options, e.g. sources=0;1
+struct SplitQuery
+{
+    std::string coordinates;
+    std::vector<std::string> options;
+};
+
+SplitQuery splitQuery(const std::string &query)
+{
+    // encoded polylines may contain a '?', but no ')'
+    const auto coordinates_end = boost::starts_with(query, "polyline") ? query.find(')') : 0;
+    const auto separator =
+        query.find('?', coordinates_end == std::string::npos ? 0 : coordinates_end);
+
+    SplitQuery split_query{query.substr(0, separator), {}};
+    if (separator != std::string::npos)
+    {
+        const auto options = query.substr(separator + 1);
+        boost::split(split_query.options, options, [](const char c) { return c == '&'; });
+    }
+    return split_query;
+}
+
+// The query with the options of the keys in dropped replaced by the added ones
+std::string joinQuery(const SplitQuery &query,
+                      const std::vector<std::string> &dropped,
+                      const std::vector<std::string> &added)
+{
+    auto joined = query.coordinates;
+    auto separator = '?';
+    for (const auto &option : query.options)
+    {
+        const auto key = option.substr(0, option.find('='));
+        if (std::find(dropped.begin(), dropped.end(), key) == dropped.end())
+        {
+            joined += separator + option;
+            separator = '&';
+        }
+    }
+    for (const auto &option : added)
+    {
+        joined += separator + option;
+        separator = '&';
+    }
+    return joined;
+}
+
+template <typename Range> std::string joinList(const Range &range)
+{
+    std::string joined;
+    for (const auto &element : range)
+    {
+        if (!joined.empty())
+            joined.push_back(';');
+        joined += element;
+    }
+    return joined;
+}
+
+util::json::Value toJSON(const binary::Value &value)
+{
+    switch (value.type())
+    {
+    case binary::ValueType::String:
+        return util::json::String(value.GetString());
+    case binary::ValueType::Number:
+        return util::json::Number(value.GetNumber());
+    case binary::ValueType::Object:
+    {
+        util::json::Object object;
+        for (const auto index : util::irange<std::size_t>(0, value.size()))
+        {
+            object.values[value.GetKey(index).GetString()] = toJSON(value.GetMember(index));
+        }
+        return object;
+    }
+    case binary::ValueType::Array:
+    {
+        util::json::Array array;
+        for (const auto index : util::irange<std::size_t>(0, value.size()))
+        {
+            array.values.push_back(toJSON(value[index]));
+        }
+        return array;
+    }
+    case binary::ValueType::NumberArray:
+    {
+        util::json::Array array;
+        std::transform(value.GetNumbers(),
+                       value.GetNumbers() + value.size(),
+                       std::back_inserter(array.values),
+                       [](const double number) -> util::json::Value {
+                           if (std::isnan(number))
+                               return util::json::Null();
+                           return util::json::Number(number);
+                       });
+        return array;
+    }
+    case binary::ValueType::True:
+        return util::json::True();
+    case binary::ValueType::False:
+        return util::json::False();
+    default:
+        return util::json::Null();
+    }
+}
+
+// Root of a binary reply, throws util::exception if it isn't one
+binary::Value getRoot(const std::string &reply, const std::string &source)
+{
+    if (reply.size() < sizeof(binary::Header) ||
+        !std::equal(binary::MAGIC, binary::MAGIC + sizeof(binary::MAGIC), reply.data()))
+    {
+        throw util::exception("Malformed binary reply of " + source + SOURCE_REF);
+    }
+    const auto root = binary::GetRoot(reply.data());
+    if (root.type() != binary::ValueType::Object)
+    {
+        throw util::exception("Malformed binary reply of " + source + SOURCE_REF);
+    }
+    return root;
+}
+
+// Member of a reply that is an array of the given size, throws util::exception otherwise
+binary::Value getArray(const binary::Value &root,
+                       const std::string &key,
+                       const std::size_t size,
+                       const std::string &source)
+{
+    const auto array = root[key];
+    if (array.type() != binary::ValueType::Array || array.size() != size)
+    {
+        throw util::exception("Reply of " + source + " has no " + key + " of " +
+                              std::to_string(size) + " elements" + SOURCE_REF);
+    }
+    return array;
+}
+
+// Hint of a waypoint of a reply, throws util::exception if it has none
+std::string getHint(const binary::Value &waypoint, const std::string &source)
+{
+    const auto hint = waypoint.type() == binary::ValueType::Object
+                          ? waypoint["hint"]
+                          : binary::Value(nullptr, binary::Slot{binary::ValueType::Null, 0, 0});
+    if (hint.type() != binary::ValueType::String || hint.size() != engine::ENCODED_HINT_SIZE)
+    {
+        throw util::exception("Waypoint without a hint in the reply of " + source + SOURCE_REF);
+    }
+    return hint.GetString();
+}
+
+// Rows of a table of a reply, throws util::exception if they don't have the given size
+binary::Value getRows(const binary::Value &root,
+                      const std::string &key,
+                      const std::size_t num_rows,
+                      const std::size_t num_columns,
+                      const std::string &source)
+{
+    const auto rows = getArray(root, key, num_rows, source);
+    for (const auto row : util::irange<std::size_t>(0, rows.size()))
+    {
+        if (rows[row].type() != binary::ValueType::NumberArray || rows[row].size() != num_columns)
+        {
+            throw util::exception("Malformed " + key + " in the reply of " + source + SOURCE_REF);
+        }
+    }
+    return rows;
+}
+
+// Converts a binary or json result to the format of the request
+void formatResult(const bool binary_format, service::BaseService::ResultT &result)
+{
+    if (binary_format && result.is<util::json::Object>())
+    {
+        service::RenderedBinary binary_result;
+        binary::encode(result.get<util::json::Object>(), binary_result.value);
+        result = std::move(binary_result);
+    }
+    else if (!binary_format && result.is<service::RenderedBinary>())
+    {
+        const auto root = toJSON(getRoot(result.get<service::RenderedBinary>().value, "table"));
+        result = root.get<util::json::Object>();
+    }
+}
+
+util::json::Value makeWaypoint(const binary::Value &waypoint, const bool with_hint)
+{
+    auto json_waypoint = toJSON(waypoint);
+    if (!with_hint && json_waypoint.is<util::json::Object>())
+    {
+        json_waypoint.get<util::json::Object>().values.erase("hint");
+    }
+    return json_waypoint;
+}
+
+// Rows of the tables of all blocks, null for NaN like the table service renders them
+void appendRows(const std::vector<binary::Value> &tables, std::vector<char> &out)
+{
+    out.push_back('[');
+    bool first_row = true;
+    for (const auto &table : tables)
+    {
+        for (const auto row_index : util::irange<std::size_t>(0, table.size()))
+        {
+            if (!first_row)
+                out.push_back(',');
+            first_row = false;
+
+            const auto row = table[row_index];
+            out.push_back('[');
+            for (const auto column : util::irange<std::size_t>(0, row.size()))
+            {
+                if (column > 0)
+                    out.push_back(',');
+                const auto number = row.GetNumbers()[column];
+                if (std::isnan(number))
+                    util::json::detail::append(out, "null", 4);
+                else
+                    util::json::detail::appendNumber(out, number);
+            }
+            out.push_back(']');
+        }
+    }
+    out.push_back(']');
+}
+
+binary::Slot encodeRows(binary::Builder &builder, const std::vector<binary::Value> &tables)
+{
+    std::vector<binary::Slot> rows;
+    for (const auto &table : tables)
+    {
+        for (const auto row_index : util::irange<std::size_t>(0, table.size()))
+        {
+            const auto row = table[row_index];
+            rows.push_back(builder.EncodeNumbers(row.GetNumbers(),
+                                                 row.GetNumbers() + row.size(),
+                                                 [](const double number) { return number; }));
+        }
+    }
+    return builder.EncodeArray(rows);
+}
+}
+
+TableCoordinator::TableCoordinator(std::unique_ptr<ServiceHandlerInterface> local_handler,
+                                   std::vector<Backend> peers,
+                                   const std::size_t min_entries,
+                                   const std::size_t block_rows,
+                                   const std::chrono::milliseconds timeout)
+    : local_handler(std::move(local_handler)), peers(std::move(peers)), min_entries(min_entries),
+      block_rows(block_rows), timeout(timeout)
+{
+    BOOST_ASSERT(!this->peers.empty());
+}
+
+engine::Status TableCoordinator::RunQuery(api::ParsedURL parsed_url, ResultT &result)
+{
+    if (parsed_url.service != "table" || parsed_url.version != 1)
+    {
+        return local_handler->RunQuery(std::move(parsed_url), result);
+    }
+
+    // the blocks of the peers are requested in the syntax of the URL
+    if (parsed_url.body)
+    {
+        api::prependBodyQuery(*parsed_url.body, parsed_url.query);
+        parsed_url.body = boost::none;
+    }
+
+    // the local handler reports invalid queries and computes small tables
+    const auto parameters =
+        api::parseParameters<engine::api::TableParameters>(parsed_url.query);
+    if (!parameters || !parameters->IsValid())
+    {
+        return local_handler->RunQuery(std::move(parsed_url), result);
+    }
+    const auto num_coordinates = parameters->coordinates.size();
+    auto sources = parameters->sources;
+    if (sources.empty())
+    {
+        sources.resize(num_coordinates);
+        std::iota(sources.begin(), sources.end(), 0);
+    }
+    const auto num_destinations =
+        parameters->destinations.empty() ? num_coordinates : parameters->destinations.size();
+    if (sources.size() < 2 || sources.size() * num_destinations <= min_entries)
+    {
+        return local_handler->RunQuery(std::move(parsed_url), result);
+    }
+
+    const auto binary_format = parameters->format == engine::api::OutputFormatType::Binary;
+    const auto query = splitQuery(parsed_url.query);
+
+    // a single row of a table whose searches stop at their start snaps all coordinates
+    auto snap_url = parsed_url;
+    snap_url.query = joinQuery(query,
+                               {"sources",
+                                "destinations",
+                                "annotations",
+                                "max_duration",
+                                "max_weight",
+                                "max_results_per_source",
+                                "approximate",
+                                "generate_hints",
+                                "format"},
+                               {"sources=0",
+                                "destinations=all",
+                                "annotations=duration",
+                                "max_duration=0",
+                                "generate_hints=true",
+                                "format=binary"});
+    const auto snap_status = local_handler->RunQuery(std::move(snap_url), result);
+    if (snap_status != engine::Status::Ok || !result.is<service::RenderedBinary>())
+    {
+        formatResult(binary_format, result);
+        return snap_status;
+    }
+    const auto snapped = std::move(result.get<service::RenderedBinary>().value);
+    const auto snapped_waypoints =
+        getArray(getRoot(snapped, "the coordinator"), "destinations", num_coordinates, "table");
+    std::vector<std::string> hints;
+    for (const auto index : util::irange<std::size_t>(0, num_coordinates))
+    {
+        hints.push_back(getHint(snapped_waypoints[index], "the coordinator"));
+    }
+    const auto checksum = engine::Hint::FromBase64(hints.front()).data_checksum;
+
+    // peers get the time that is left of the request
+    std::vector<std::pair<std::string, std::string>> headers;
+    auto fetch_timeout = timeout;
+    if (parsed_url.deadline.ExpiresAt() != engine::QueryDeadline::Clock::time_point::max())
+    {
+        const auto remaining = std::max<std::chrono::milliseconds>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                parsed_url.deadline.ExpiresAt() - engine::QueryDeadline::Clock::now()),
+            std::chrono::milliseconds(1));
+        headers.emplace_back("X-OSRM-Timeout", std::to_string(remaining.count()));
+        fetch_timeout = std::min(fetch_timeout, remaining);
+    }
+
+    const auto rows_per_block =
+        block_rows > 0 ? block_rows : (sources.size() + peers.size() - 1) / peers.size();
+    const auto hints_option = "hints=" + joinList(hints);
+    const std::vector<std::string> dropped_options = {
+        "sources", "hints", "generate_hints", "format"};
+    std::vector<BackendRequest> requests;
+    std::vector<std::size_t> block_sizes;
+    for (std::size_t first = 0; first < sources.size(); first += rows_per_block)
+    {
+        const auto last = std::min(first + rows_per_block, sources.size());
+        std::vector<std::string> block_sources;
+        std::transform(sources.begin() + first,
+                       sources.begin() + last,
+                       std::back_inserter(block_sources),
+                       [](const std::size_t source) { return std::to_string(source); });
+
+        const auto &peer = peers[requests.size() % peers.size()];
+        requests.push_back(BackendRequest{
+            peer,
+            "/table/v1/" + parsed_url.profile,
+            joinQuery(query,
+                      dropped_options,
+                      {"sources=" + joinList(block_sources),
+                       hints_option,
+                       "generate_hints=true",
+                       "format=binary"}),
+            headers});
+        block_sizes.push_back(last - first);
+    }
+    const auto replies = fetchFromBackends(requests, fetch_timeout);
+
+    const auto with_durations =
+        parameters->annotations & engine::api::TableParameters::AnnotationsType::Duration;
+    const auto with_distances =
+        parameters->annotations & engine::api::TableParameters::AnnotationsType::Distance;
+    std::vector<binary::Value> block_sources;
+    std::vector<binary::Value> block_destinations;
+    std::vector<binary::Value> block_durations;
+    std::vector<binary::Value> block_distances;
+    for (const auto index : util::irange<std::size_t>(0, replies.size()))
+    {
+        const auto &reply = replies[index];
+        const auto &peer = requests[index].backend;
+        const auto source = "peer " + peer.host + ":" + peer.port;
+        if (reply.status == "400" && reply.content_type == BINARY_CONTENT_TYPE)
+        {
+            result = service::RenderedBinary{reply.content};
+            formatResult(binary_format, result);
+            return engine::Status::Error;
+        }
+        if (reply.status != "200" || reply.content_type != BINARY_CONTENT_TYPE)
+        {
+            throw util::exception("Table " + source + " replied with status " + reply.status +
+                                  SOURCE_REF);
+        }
+
+        const auto root = getRoot(reply.content, source);
+        const auto sources_of_block = getArray(root, "sources", block_sizes[index], source);
+        if (engine::Hint::FromBase64(getHint(sources_of_block[0], source)).data_checksum !=
+            checksum)
+        {
+            throw util::exception("Table " + source +
+                                  " serves another dataset than the coordinator" + SOURCE_REF);
+        }
+        block_sources.push_back(sources_of_block);
+        block_destinations.push_back(getArray(root, "destinations", num_destinations, source));
+        if (with_durations)
+        {
+            block_durations.push_back(
+                getRows(root, "durations", block_sizes[index], num_destinations, source));
+        }
+        if (with_distances)
+        {
+            block_distances.push_back(
+                getRows(root, "distances", block_sizes[index], num_destinations, source));
+        }
+    }
+    // all blocks have the same destinations
+    const auto &destinations = block_destinations.front();
+
+    // the blocks are copied in the order of the sources
+    util::json::Array json_sources;
+    for (const auto &sources_of_block : block_sources)
+    {
+        for (const auto index : util::irange<std::size_t>(0, sources_of_block.size()))
+        {
+            json_sources.values.push_back(
+                makeWaypoint(sources_of_block[index], parameters->generate_hints));
+        }
+    }
+    util::json::Array json_destinations;
+    for (const auto index : util::irange<std::size_t>(0, destinations.size()))
+    {
+        json_destinations.values.push_back(
+            makeWaypoint(destinations[index], parameters->generate_hints));
+    }
+
+    if (binary_format)
+    {
+        service::RenderedBinary merged;
+        binary::Builder builder(merged.value);
+        std::vector<std::pair<std::string, binary::Slot>> members;
+        members.emplace_back("sources", builder.Encode(json_sources));
+        members.emplace_back("destinations", builder.Encode(json_destinations));
+        if (with_durations)
+            members.emplace_back("durations", encodeRows(builder, block_durations));
+        if (with_distances)
+            members.emplace_back("distances", encodeRows(builder, block_distances));
+        members.emplace_back("code", builder.EncodeString("Ok"));
+        builder.Finish(builder.EncodeObject(std::move(members)));
+        result = std::move(merged);
+        return engine::Status::Ok;
+    }
+
+    util::json::Object waypoints;
+    waypoints.values["sources"] = std::move(json_sources);
+    waypoints.values["destinations"] = std::move(json_destinations);
+    waypoints.values["code"] = "Ok";
+    std::vector<char> merged;
+    util::json::render(merged, waypoints);
+    BOOST_ASSERT(merged.size() >= 2 && merged.back() == '}');
+    merged.pop_back();
+    if (with_durations)
+    {
+        util::json::detail::append(merged, ",\"durations\":", 13);
+        appendRows(block_durations, merged);
+    }
+    if (with_distances)
+    {
+        util::json::detail::append(merged, ",\"distances\":", 13);
+        appendRows(block_distances, merged);
+    }
+    merged.push_back('}');
+    result = service::RenderedJSON{std::string(merged.begin(), merged.end())};
+    return engine::Status::Ok;
+}
+}
+}
@@ -0,0 +1,67 @@
+#include "storage/block_memory.hpp"
+
+#include "util/log.hpp"
+#include "util/mmap_file.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace osrm
+{
+namespace storage
+{
+
+std::vector<BlockMemory> getBlockMemory(const DataLayout &layout, char *memory)
+{
+    std::vector<BlockMemory> blocks;
+    for (int index = 0; index < DataLayout::NUM_BLOCKS; ++index)
+    {
+        const auto id = static_cast<DataLayout::BlockID>(index);
+        // the core marker takes a word even if it has no entries
+        if (layout.GetBlockEntries(id) == 0)
+            continue;
+        const auto bytes = layout.GetBlockSize(id);
+
+        // the pointer of GetBlockPtr checks the canaries, which would page them in
+        const auto external = layout.IsExternalBlock(id);
+        const auto *block = external ? layout.external_blocks[id]
+                                     : static_cast<const char *>(
+                                           layout.GetAlignedBlockPtr(memory, id));
+        blocks.push_back({id, bytes, util::getResidentBytes(block, bytes), external});
+    }
+
+    std::stable_sort(blocks.begin(), blocks.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.bytes > rhs.bytes;
+    });
+    return blocks;
+}
+
+void logBlockMemory(const std::vector<BlockMemory> &blocks, const std::string &dataset_name)
+{
+    const auto prefix = dataset_name.empty() ? std::string() : dataset_name + ": ";
+    const auto log_line =
+        [&](const std::string &name, const std::uint64_t bytes, const std::uint64_t resident) {
+            util::Log() << prefix << name << " " << std::fixed << std::setprecision(1)
+                        << bytes / (1024. * 1024.) << " MiB, " << resident / (1024. * 1024.)
+                        << " MiB resident";
+        };
+
+    std::uint64_t total = 0, total_resident = 0, total_external = 0;
+    for (const auto &block : blocks)
+    {
+        log_line(std::string(block_id_to_name[block.id]) + (block.external ? " (file)" : ""),
+                 block.bytes,
+                 block.resident_bytes);
+        total += block.bytes;
+        total_resident += block.resident_bytes;
+        total_external += block.external ? block.bytes : 0;
+    }
+    log_line("all blocks", total, total_resident);
+    if (total_external > 0)
+    {
+        util::Log() << prefix << std::fixed << std::setprecision(1)
+                    << total_external / (1024. * 1024.) << " MiB of them are mapped from files";
+    }
+}
+}
+}
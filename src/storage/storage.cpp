@@ -1,15 +1,20 @@
 #include "storage/storage.hpp"
 
+#include "storage/block_memory.hpp"
+#include "storage/dataset_image.hpp"
 #include "storage/io.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
 #include "storage/shared_memory_ownership.hpp"
 #include "storage/shared_monitor.hpp"
+#include "storage/view_factory.hpp"
 
 #include "contractor/files.hpp"
 #include "contractor/query_graph.hpp"
 
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/files.hpp"
+#include "customizer/overlay_hierarchy.hpp"
 
 #include "extractor/class_data.hpp"
 #include "extractor/compressed_edge_container.hpp"
@@ -33,31 +38,45 @@
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
+#include "util/huge_pages.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/numa.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
 
 #ifdef __linux__
 #include <sys/mman.h>
 #endif
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
+#include <tbb/task_group.h>
+
 #include <cstdint>
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <new>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -71,16 +90,222 @@ using EdgeBasedGraph = util::StaticGraph<extractor::EdgeBasedEdge::EdgeData>;
 
 using Monitor = SharedMonitor<SharedDataTimestamp>;
 
+namespace
+{
+// Walks over a data file and records the offsets its blocks start at
+class FileBlockLocator
+{
+  public:
+    FileBlockLocator(const boost::filesystem::path &path, const DataLayout &layout)
+        : path(path), layout(layout), reader(path, io::FileReader::VerifyFingerprint)
+    {
+    }
+
+    // The entries of the block follow directly
+    template <typename T> void Entries(const DataLayout::BlockID id)
+    {
+        blocks.push_back(FileBlock{id, path, reader.GetPosition()});
+        reader.Skip<T>(layout.GetBlockEntries(id));
+    }
+
+    // The entries of the block follow their number, as storage::serialization writes vectors
+    template <typename T> void Vector(const DataLayout::BlockID id)
+    {
+        const auto count = reader.ReadElementCount64();
+        if (count != layout.GetBlockEntries(id))
+        {
+            throw util::exception("Unexpected size of " + std::string(block_id_to_name[id]) +
+                                  " in " + path.string() + SOURCE_REF);
+        }
+        Entries<T>(id);
+    }
+
+    template <typename T> void Skip(const std::size_t count) { reader.Skip<T>(count); }
+
+    // Adds the blocks of the file only if a mapping of it can be used for all of them
+    void AddTo(std::vector<FileBlock> &file_blocks) const
+    {
+        if (reader.IsCompressed())
+        {
+            util::Log() << path.string() << " is compressed, loading its blocks into memory";
+            return;
+        }
+
+        const auto aligned =
+            std::all_of(blocks.begin(), blocks.end(), [this](const FileBlock &block) {
+                return block.offset % layout.entry_align[block.id] == 0;
+            });
+        if (!aligned)
+        {
+            util::Log(logWARNING) << "Blocks of " << path.string()
+                                  << " are not aligned in the file, loading them into memory";
+            return;
+        }
+        file_blocks.insert(file_blocks.end(), blocks.begin(), blocks.end());
+    }
+
+  private:
+    const boost::filesystem::path path;
+    const DataLayout &layout;
+    io::FileReader reader;
+    std::vector<FileBlock> blocks;
+};
+
+// The file each block is loaded from
+std::array<boost::filesystem::path, DataLayout::NUM_BLOCKS>
+getBlockSources(const StorageConfig &config)
+{
+    std::array<boost::filesystem::path, DataLayout::NUM_BLOCKS> sources;
+    const auto set = [&sources](const boost::filesystem::path &path,
+                                std::initializer_list<DataLayout::BlockID> ids) {
+        for (const auto id : ids)
+            sources[id] = path;
+    };
+
+    set(config.names_data_path, {DataLayout::NAME_CHAR_DATA});
+    set(config.edge_based_nodes_data_path,
+        {DataLayout::EDGE_BASED_NODE_LIST, DataLayout::COMPONENT_ID_LIST});
+    set(config.hsgr_data_path,
+        {DataLayout::HSGR_CHECKSUM,
+         DataLayout::CH_GRAPH_NODE_LIST,
+         DataLayout::CH_GRAPH_EDGE_LIST});
+    set(config.compressed_hsgr_data_path,
+        {DataLayout::CH_COMPRESSED_GRAPH_OFFSETS, DataLayout::CH_COMPRESSED_GRAPH_EDGES});
+    set(config.hub_labels_path,
+        {DataLayout::CH_HUB_LABEL_OFFSETS,
+         DataLayout::CH_HUB_LABEL_HUBS,
+         DataLayout::CH_HUB_LABEL_WEIGHTS,
+         DataLayout::CH_HUB_LABEL_DURATIONS});
+    set(config.cch_graph_path, {DataLayout::CCH_GRAPH_NODE_LIST, DataLayout::CCH_GRAPH_EDGE_LIST});
+    set(config.node_based_nodes_data_path,
+        {DataLayout::COORDINATE_LIST, DataLayout::OSM_NODE_ID_LIST});
+    set(config.edges_data_path,
+        {DataLayout::TURN_DATA_ID, DataLayout::TURN_DATA});
+    set(config.ram_index_path, {DataLayout::R_SEARCH_TREE, DataLayout::R_SEARCH_TREE_LEVELS});
+    set(config.geometries_path,
+        {DataLayout::GEOMETRIES_INDEX,
+         DataLayout::GEOMETRIES_NODE_LIST,
+         DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+         DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+         DataLayout::GEOMETRIES_FWD_DURATION_LIST,
+         DataLayout::GEOMETRIES_REV_DURATION_LIST,
+         DataLayout::DATASOURCES_LIST});
+    set(config.timestamp_path, {DataLayout::TIMESTAMP});
+    // the block only holds the path, which is part of the stamp
+    set(config.file_index_path, {DataLayout::FILE_INDEX_PATH, DataLayout::R_SEARCH_TREE_LEAVES});
+    set(config.core_data_path, {DataLayout::CH_CORE_MARKER});
+    set(config.datasource_names_path, {DataLayout::DATASOURCES_NAMES});
+    set(config.properties_path, {DataLayout::PROPERTIES});
+    set(config.intersection_class_path,
+        {DataLayout::BEARING_CLASSID,
+         DataLayout::BEARING_OFFSETS,
+         DataLayout::BEARING_BLOCKS,
+         DataLayout::BEARING_VALUES,
+         DataLayout::ENTRY_CLASS});
+    set(config.turn_lane_data_path, {DataLayout::TURN_LANE_DATA});
+    set(config.turn_lane_description_path,
+        {DataLayout::LANE_DESCRIPTION_OFFSETS, DataLayout::LANE_DESCRIPTION_MASKS});
+    set(config.turn_weight_penalties_path, {DataLayout::TURN_WEIGHT_PENALTIES});
+    set(config.turn_duration_penalties_path, {DataLayout::TURN_DURATION_PENALTIES});
+    set(config.mld_partition_path,
+        {DataLayout::MLD_LEVEL_DATA, DataLayout::MLD_PARTITION, DataLayout::MLD_CELL_TO_CHILDREN});
+    set(config.mld_storage_path,
+        {DataLayout::MLD_CELL_WEIGHTS,
+         DataLayout::MLD_CELL_DURATIONS,
+         DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+         DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+         DataLayout::MLD_CELLS,
+         DataLayout::MLD_CELL_LEVEL_OFFSETS,
+         DataLayout::MLD_CELL_METRIC_NAMES});
+    set(config.mld_graph_path,
+        {DataLayout::MLD_GRAPH_NODE_LIST,
+         DataLayout::MLD_GRAPH_EDGE_LIST,
+         DataLayout::MLD_GRAPH_NODE_TO_OFFSET});
+    set(config.mld_overlay_hierarchy_path,
+        {DataLayout::MLD_OVERLAY_NODES,
+         DataLayout::MLD_OVERLAY_FORWARD_OFFSETS,
+         DataLayout::MLD_OVERLAY_FORWARD_ARCS,
+         DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS,
+         DataLayout::MLD_OVERLAY_BACKWARD_ARCS});
+    set(config.landmarks_path,
+        {DataLayout::LANDMARK_NODES, DataLayout::LANDMARK_UNITS, DataLayout::LANDMARK_DISTANCES});
+    set(config.distance_oracle_path,
+        {DataLayout::DISTANCE_ORACLE_REPRESENTATIVES,
+         DataLayout::DISTANCE_ORACLE_CELLS,
+         DataLayout::DISTANCE_ORACLE_NODE_DURATIONS,
+         DataLayout::DISTANCE_ORACLE_CELL_DURATIONS});
+    set(config.conditional_turn_masks_path,
+        {DataLayout::CONDITIONAL_TURN_IDS,
+         DataLayout::CONDITIONAL_TURN_SOURCES,
+         DataLayout::CONDITIONAL_TURN_TARGETS,
+         DataLayout::CONDITIONAL_TURN_MASKS});
+
+    return sources;
+}
+
+// Changes whenever the file is rewritten or replaced, 0 if it does not exist
+std::uint64_t getFileStamp(const boost::filesystem::path &path)
+{
+    const auto absolute_path = boost::filesystem::absolute(path).string();
+    std::size_t stamp = std::hash<std::string>()(absolute_path);
+#ifndef _WIN32
+    struct stat status;
+    if (::stat(absolute_path.c_str(), &status) != 0)
+        return 0;
+    boost::hash_combine(stamp, status.st_dev);
+    boost::hash_combine(stamp, status.st_ino);
+    boost::hash_combine(stamp, status.st_size);
+    boost::hash_combine(stamp, status.st_mtim.tv_sec);
+    boost::hash_combine(stamp, status.st_mtim.tv_nsec);
+#else
+    boost::system::error_code error;
+    const auto size = boost::filesystem::file_size(path, error);
+    if (error)
+        return 0;
+    boost::hash_combine(stamp, size);
+    boost::hash_combine(stamp, boost::filesystem::last_write_time(path));
+#endif
+    return std::max<std::uint64_t>(stamp, 1);
+}
+
+void copyBlocks(const DataLayout &from_layout,
+                char *from_memory,
+                const DataLayout &to_layout,
+                char *to_memory,
+                const BlockSet &blocks)
+{
+    for (const auto id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+    {
+        if (!blocks[id])
+            continue;
+
+        const auto bid = static_cast<DataLayout::BlockID>(id);
+        BOOST_ASSERT(to_layout.GetBlockSize(bid) == from_layout.GetBlockSize(bid));
+        const auto from_ptr = from_layout.GetBlockPtr<char>(from_memory, bid);
+        const auto to_ptr = to_layout.GetBlockPtr<char, true>(to_memory, bid);
+        std::copy(from_ptr, from_ptr + from_layout.GetBlockSize(bid), to_ptr);
+    }
+}
+}
+
 Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
 
-int Storage::Run(int max_wait)
+int Storage::Run(int max_wait,
+                 const std::string &dataset_name,
+                 const bool replicate_per_numa_node,
+                 const bool use_huge_pages,
+                 const bool reuse_unchanged_blocks,
+                 DataUpdate *update)
 {
     BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
 
     util::LogPolicy::GetInstance().Unmute();
 
+    // only updates of the same dataset wait for each other
     boost::filesystem::path lock_path =
-        boost::filesystem::temp_directory_path() / "osrm-datastore.lock";
+        boost::filesystem::temp_directory_path() /
+        (dataset_name.empty() ? "osrm-datastore.lock"
+                              : "osrm-datastore-" + dataset_name + ".lock");
     if (!boost::filesystem::exists(lock_path))
     {
         boost::filesystem::ofstream ofs(lock_path);
@@ -108,8 +333,9 @@ int Storage::Run(int max_wait)
 
     // Get the next region ID and time stamp without locking shared barriers.
     // Because of datastore_lock the only write operation can occur sequentially later.
-    Monitor monitor(SharedDataTimestamp{REGION_NONE, 0});
+    Monitor monitor(SharedDataTimestamp{REGION_NONE, 0}, dataset_name);
     auto in_use_region = monitor.data().region;
+    auto in_use_replicas = monitor.data().num_replicas;
     auto next_timestamp = monitor.data().timestamp + 1;
     auto next_region =
         in_use_region == REGION_2 || in_use_region == REGION_NONE ? REGION_1 : REGION_2;
@@ -117,30 +343,147 @@ int Storage::Run(int max_wait)
     // ensure that the shared memory region we want to write to is really removed
     // this is only needef for failure recovery because we actually wait for all clients
     // to detach at the end of the function
-    if (storage::SharedMemory::RegionExists(next_region))
+    for (const auto replica : util::irange(0u, MAX_REGION_REPLICAS))
     {
-        util::Log(logWARNING) << "Old shared memory region " << regionToString(next_region)
-                              << " still exists.";
-        util::UnbufferedLog() << "Retrying removal... ";
-        storage::SharedMemory::Remove(next_region);
-        util::UnbufferedLog() << "ok.";
+        const auto id = getReplicaID(next_region, replica);
+        if (storage::SharedMemory::RegionExists(id, dataset_name))
+        {
+            util::Log(logWARNING) << "Old shared memory region " << regionToString(next_region)
+                                  << " (copy " << replica << ") still exists.";
+            util::UnbufferedLog() << "Retrying removal... ";
+            storage::SharedMemory::Remove(id, dataset_name);
+            util::UnbufferedLog() << "ok.";
+        }
     }
 
     util::Log() << "Loading data into " << regionToString(next_region);
 
     // Populate a memory layout into stack memory
     DataLayout layout;
-    PopulateLayout(layout);
+
+    // The region in use is only read from, it is marked for removal after the swap
+    std::unique_ptr<SharedMemory> in_use_memory;
+    BlockSet reused_blocks;
+    BlockSet updated_blocks;
+    if (update)
+    {
+        if (in_use_region == REGION_NONE ||
+            !storage::SharedMemory::RegionExists(in_use_region, dataset_name))
+        {
+            throw util::exception("There is no data in shared memory to update" + SOURCE_REF);
+        }
+
+        in_use_memory = makeSharedMemory(in_use_region, 0, false, dataset_name);
+        const auto &in_use_layout = *static_cast<const DataLayout *>(in_use_memory->Ptr());
+        layout = in_use_layout;
+        updated_blocks =
+            update->Prepare(in_use_layout,
+                            static_cast<char *>(in_use_memory->Ptr()) + sizeof(DataLayout),
+                            layout);
+
+        // the updated blocks no longer match their files
+        for (const auto id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+        {
+            if (updated_blocks[id])
+                layout.source_stamps[id] = 0;
+        }
+        reused_blocks = ~updated_blocks;
+        util::Log() << "Updating " << updated_blocks.count() << " of " << DataLayout::NUM_BLOCKS
+                    << " blocks of the data in " << regionToString(in_use_region);
+    }
+    else
+    {
+        PopulateLayout(layout);
+    }
+
+    // an image is read at once, copying some of its blocks instead saves nothing
+    if (!update && reuse_unchanged_blocks && !config.use_image && in_use_region != REGION_NONE &&
+        storage::SharedMemory::RegionExists(in_use_region, dataset_name))
+    {
+        in_use_memory = makeSharedMemory(in_use_region, 0, false, dataset_name);
+        const auto &in_use_layout = *static_cast<const DataLayout *>(in_use_memory->Ptr());
+        std::uint64_t reused_size = 0;
+        for (const auto id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+        {
+            const auto bid = static_cast<DataLayout::BlockID>(id);
+            if (layout.HasSameBlock(in_use_layout, bid))
+            {
+                reused_blocks.set(id);
+                reused_size += layout.GetBlockSize(bid);
+            }
+        }
+        util::Log() << "Copying " << reused_blocks.count() << " of " << DataLayout::NUM_BLOCKS
+                    << " blocks with " << reused_size << " bytes from "
+                    << regionToString(in_use_region) << ", their files did not change";
+    }
+
+    const auto nodes = util::GetNUMANodes();
+    const auto num_replicas =
+        replicate_per_numa_node ? std::min<unsigned>(nodes.size(), MAX_REGION_REPLICAS) : 1u;
+    if (replicate_per_numa_node && num_replicas < nodes.size())
+    {
+        util::Log(logWARNING) << "Only the first " << num_replicas << " of " << nodes.size()
+                              << " NUMA nodes get a copy of the data";
+    }
 
     // Allocate shared memory block
     auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
-    util::Log() << "Allocating shared memory of " << regions_size << " bytes";
-    auto data_memory = makeSharedMemory(next_region, regions_size);
+    std::vector<std::unique_ptr<SharedMemory>> data_memories;
+    for (const auto replica : util::irange(0u, num_replicas))
+    {
+        // the pages of a copy are allocated on its node when they are first touched, which
+        // is when they are mapped as all memory is locked
+        std::unique_ptr<util::ScopedNUMABinding> binding;
+        if (num_replicas > 1)
+        {
+            util::Log() << "Allocating shared memory of " << regions_size
+                        << " bytes on NUMA node " << nodes[replica];
+            binding = std::make_unique<util::ScopedNUMABinding>(nodes[replica]);
+        }
+        else
+        {
+            util::Log() << "Allocating shared memory of " << regions_size << " bytes";
+        }
+        data_memories.push_back(makeSharedMemory(
+            getReplicaID(next_region, replica), regions_size, use_huge_pages, dataset_name));
+        if (use_huge_pages)
+        {
+            util::Log() << "Shared memory is backed by "
+                        << util::ToString(data_memories.back()->GetHugePages());
+        }
 
-    // Copy memory layout to shared memory and populate data
-    char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
-    memcpy(shared_memory_ptr, &layout, sizeof(layout));
-    PopulateData(layout, shared_memory_ptr + sizeof(layout));
+        // Copy memory layout to shared memory and populate data
+        char *shared_memory_ptr = static_cast<char *>(data_memories.back()->Ptr());
+        if (replica == 0)
+        {
+            memcpy(shared_memory_ptr, &layout, sizeof(layout));
+            if (!update)
+            {
+                PopulateData(layout, shared_memory_ptr + sizeof(layout), reused_blocks);
+            }
+            if (reused_blocks.any())
+            {
+                copyBlocks(*static_cast<const DataLayout *>(in_use_memory->Ptr()),
+                           static_cast<char *>(in_use_memory->Ptr()) + sizeof(DataLayout),
+                           layout,
+                           shared_memory_ptr + sizeof(layout),
+                           reused_blocks);
+                // detach, we wait for all users of the old region to do so below
+                in_use_memory.reset();
+            }
+            if (update)
+            {
+                update->Write(layout, shared_memory_ptr + sizeof(layout));
+            }
+        }
+        else
+        {
+            memcpy(shared_memory_ptr, data_memories.front()->Ptr(), regions_size);
+        }
+    }
+    logBlockMemory(
+        getBlockMemory(layout, static_cast<char *>(data_memories.front()->Ptr()) + sizeof(layout)),
+        dataset_name);
 
     { // Lock for write access shared region mutex
         boost::interprocess::scoped_lock<Monitor::mutex_type> lock(monitor.get_mutex(),
@@ -155,9 +498,9 @@ int Storage::Run(int max_wait)
                     << "Could not aquire current region lock after " << max_wait
                     << " seconds. Removing locked block and creating a new one. All currently "
                        "attached processes will not receive notifications and must be restarted";
-                Monitor::remove();
+                Monitor::remove(dataset_name);
                 in_use_region = REGION_NONE;
-                monitor = Monitor(SharedDataTimestamp{REGION_NONE, 0});
+                monitor = Monitor(SharedDataTimestamp{REGION_NONE, 0}, dataset_name);
             }
         }
         else
@@ -168,6 +511,7 @@ int Storage::Run(int max_wait)
         // Update the current region ID and timestamp
         monitor.data().region = next_region;
         monitor.data().timestamp = next_timestamp;
+        monitor.data().num_replicas = num_replicas;
     }
 
     util::Log() << "All data loaded. Notify all client about new data in "
@@ -176,21 +520,29 @@ int Storage::Run(int max_wait)
 
     // SHMCTL(2): Mark the segment to be destroyed. The segment will actually be destroyed
     // only after the last process detaches it.
-    if (in_use_region != REGION_NONE && storage::SharedMemory::RegionExists(in_use_region))
+    if (in_use_region != REGION_NONE)
     {
-        util::UnbufferedLog() << "Marking old shared memory region "
-                              << regionToString(in_use_region) << " for removal... ";
+        for (const auto replica : util::irange(0u, std::max(in_use_replicas, 1u)))
+        {
+            const auto id = getReplicaID(in_use_region, replica);
+            if (!storage::SharedMemory::RegionExists(id, dataset_name))
+                continue;
 
-        // aquire a handle for the old shared memory region before we mark it for deletion
-        // we will need this to wait for all users to detach
-        auto in_use_shared_memory = makeSharedMemory(in_use_region);
+            util::UnbufferedLog() << "Marking old shared memory region "
+                                  << regionToString(in_use_region) << " (copy " << replica
+                                  << ") for removal... ";
 
-        storage::SharedMemory::Remove(in_use_region);
-        util::UnbufferedLog() << "ok.";
+            // aquire a handle for the old shared memory region before we mark it for deletion
+            // we will need this to wait for all users to detach
+            auto in_use_shared_memory = makeSharedMemory(id, 0, false, dataset_name);
 
-        util::UnbufferedLog() << "Waiting for clients to detach... ";
-        in_use_shared_memory->WaitForDetach();
-        util::UnbufferedLog() << " ok.";
+            storage::SharedMemory::Remove(id, dataset_name);
+            util::UnbufferedLog() << "ok.";
+
+            util::UnbufferedLog() << "Waiting for clients to detach... ";
+            in_use_shared_memory->WaitForDetach();
+            util::UnbufferedLog() << " ok.";
+        }
     }
 
     util::Log() << "All clients switched.";
@@ -205,6 +557,32 @@ int Storage::Run(int max_wait)
  */
 void Storage::PopulateLayout(DataLayout &layout)
 {
+    if (config.use_image)
+    {
+        util::Log() << "load the dataset image " << config.image_path;
+        layout = readImageLayout(config.image_path);
+
+        // the image keeps the stamps of the files it was packed from
+        const auto sources = getBlockSources(config);
+        std::vector<std::string> changed_files;
+        for (const auto id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+        {
+            const auto stamp = getFileStamp(sources[id]);
+            const auto name = sources[id].filename().string();
+            if (stamp != 0 && layout.source_stamps[id] != 0 && stamp != layout.source_stamps[id] &&
+                std::find(changed_files.begin(), changed_files.end(), name) == changed_files.end())
+            {
+                changed_files.push_back(name);
+            }
+        }
+        for (const auto &name : changed_files)
+        {
+            util::Log(logWARNING) << name << " changed since " << config.image_path.string()
+                                  << " was packed, the image holds its previous data";
+        }
+        return;
+    }
+
     {
         auto absolute_file_index_path = boost::filesystem::absolute(config.file_index_path);
 
@@ -232,17 +610,11 @@ void Storage::PopulateLayout(DataLayout &layout)
     // Loading information for original edges
     {
         io::FileReader edges_file(config.edges_data_path, io::FileReader::VerifyFingerprint);
-        const auto number_of_original_edges = edges_file.ReadElementCount64();
+        const auto number_of_original_edges = edges_file.ReadVectorSize<std::uint32_t>();
+        const auto number_of_turn_data = edges_file.ReadVectorSize<extractor::TurnData>();
 
-        // note: settings this all to the same size is correct, we extract them from the same struct
-        layout.SetBlockSize<util::guidance::TurnBearing>(DataLayout::PRE_TURN_BEARING,
-                                                         number_of_original_edges);
-        layout.SetBlockSize<util::guidance::TurnBearing>(DataLayout::POST_TURN_BEARING,
-                                                         number_of_original_edges);
-        layout.SetBlockSize<extractor::guidance::TurnInstruction>(DataLayout::TURN_INSTRUCTION,
-                                                                  number_of_original_edges);
-        layout.SetBlockSize<LaneDataID>(DataLayout::LANE_DATA_ID, number_of_original_edges);
-        layout.SetBlockSize<EntryClassID>(DataLayout::ENTRY_CLASSID, number_of_original_edges);
+        layout.SetBlockSize<std::uint32_t>(DataLayout::TURN_DATA_ID, number_of_original_edges);
+        layout.SetBlockSize<extractor::TurnData>(DataLayout::TURN_DATA, number_of_turn_data);
     }
 
     {
@@ -250,18 +622,16 @@ void Storage::PopulateLayout(DataLayout &layout)
                                        io::FileReader::VerifyFingerprint);
         const auto nodes_number = nodes_data_file.ReadElementCount64();
 
-        layout.SetBlockSize<NodeID>(DataLayout::GEOMETRY_ID_LIST, nodes_number);
-        layout.SetBlockSize<NameID>(DataLayout::NAME_ID_LIST, nodes_number);
+        layout.SetBlockSize<extractor::EdgeBasedNode>(DataLayout::EDGE_BASED_NODE_LIST,
+                                                      nodes_number);
         layout.SetBlockSize<ComponentID>(DataLayout::COMPONENT_ID_LIST, nodes_number);
-        layout.SetBlockSize<extractor::TravelMode>(DataLayout::TRAVEL_MODE_LIST, nodes_number);
-        layout.SetBlockSize<extractor::ClassData>(DataLayout::CLASSES_LIST, nodes_number);
     }
 
     if (boost::filesystem::exists(config.hsgr_data_path))
     {
         io::FileReader reader(config.hsgr_data_path, io::FileReader::VerifyFingerprint);
 
-        reader.Skip<std::uint32_t>(1); // checksum
+        const auto checksum = reader.ReadOne<std::uint32_t>();
         auto num_nodes = reader.ReadVectorSize<contractor::QueryGraph::NodeArrayEntry>();
         auto num_edges = reader.ReadVectorSize<contractor::QueryGraph::EdgeArrayEntry>();
 
@@ -270,6 +640,50 @@ void Storage::PopulateLayout(DataLayout &layout)
                                                                     num_nodes);
         layout.SetBlockSize<contractor::QueryGraph::EdgeArrayEntry>(DataLayout::CH_GRAPH_EDGE_LIST,
                                                                     num_edges);
+
+        // the compressed copy is only used while it was encoded from this very hierarchy
+        std::uint64_t num_offsets = 0;
+        std::uint64_t num_bytes = 0;
+        if (boost::filesystem::exists(config.compressed_hsgr_data_path))
+        {
+            io::FileReader compressed_reader(config.compressed_hsgr_data_path,
+                                             io::FileReader::VerifyFingerprint);
+            if (compressed_reader.ReadOne<std::uint32_t>() == checksum)
+            {
+                num_offsets = compressed_reader.ReadVectorSize<std::uint64_t>();
+                num_bytes = compressed_reader.ReadVectorSize<std::uint8_t>();
+            }
+            else
+            {
+                util::Log(logWARNING) << config.compressed_hsgr_data_path.string()
+                                      << " was not compressed from the current .hsgr, ignoring it";
+            }
+        }
+        layout.SetBlockSize<std::uint64_t>(DataLayout::CH_COMPRESSED_GRAPH_OFFSETS, num_offsets);
+        layout.SetBlockSize<std::uint8_t>(DataLayout::CH_COMPRESSED_GRAPH_EDGES, num_bytes);
+
+        // so are the hub labels
+        std::uint64_t num_label_offsets = 0;
+        std::uint64_t num_label_entries = 0;
+        if (boost::filesystem::exists(config.hub_labels_path))
+        {
+            io::FileReader labels_reader(config.hub_labels_path,
+                                         io::FileReader::VerifyFingerprint);
+            if (labels_reader.ReadOne<std::uint32_t>() == checksum)
+            {
+                num_label_offsets = labels_reader.ReadVectorSize<std::uint64_t>();
+                num_label_entries = labels_reader.ReadVectorSize<NodeID>();
+            }
+            else
+            {
+                util::Log(logWARNING) << config.hub_labels_path.string()
+                                      << " was not built from the current .hsgr, ignoring it";
+            }
+        }
+        layout.SetBlockSize<std::uint64_t>(DataLayout::CH_HUB_LABEL_OFFSETS, num_label_offsets);
+        layout.SetBlockSize<NodeID>(DataLayout::CH_HUB_LABEL_HUBS, num_label_entries);
+        layout.SetBlockSize<EdgeWeight>(DataLayout::CH_HUB_LABEL_WEIGHTS, num_label_entries);
+        layout.SetBlockSize<EdgeDuration>(DataLayout::CH_HUB_LABEL_DURATIONS, num_label_entries);
     }
     else
     {
@@ -278,6 +692,35 @@ void Storage::PopulateLayout(DataLayout &layout)
                                                                     0);
         layout.SetBlockSize<contractor::QueryGraph::EdgeArrayEntry>(DataLayout::CH_GRAPH_EDGE_LIST,
                                                                     0);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::CH_COMPRESSED_GRAPH_OFFSETS, 0);
+        layout.SetBlockSize<std::uint8_t>(DataLayout::CH_COMPRESSED_GRAPH_EDGES, 0);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::CH_HUB_LABEL_OFFSETS, 0);
+        layout.SetBlockSize<NodeID>(DataLayout::CH_HUB_LABEL_HUBS, 0);
+        layout.SetBlockSize<EdgeWeight>(DataLayout::CH_HUB_LABEL_WEIGHTS, 0);
+        layout.SetBlockSize<EdgeDuration>(DataLayout::CH_HUB_LABEL_DURATIONS, 0);
+    }
+
+    // the customized CCH is stored like the .hsgr, the hints still refer to the checksum of the
+    // latter so the one of this file is not loaded
+    if (boost::filesystem::exists(config.cch_graph_path))
+    {
+        io::FileReader reader(config.cch_graph_path, io::FileReader::VerifyFingerprint);
+
+        reader.Skip<std::uint32_t>(1); // checksum
+        auto num_nodes = reader.ReadVectorSize<contractor::QueryGraph::NodeArrayEntry>();
+        auto num_edges = reader.ReadVectorSize<contractor::QueryGraph::EdgeArrayEntry>();
+
+        layout.SetBlockSize<contractor::QueryGraph::NodeArrayEntry>(
+            DataLayout::CCH_GRAPH_NODE_LIST, num_nodes);
+        layout.SetBlockSize<contractor::QueryGraph::EdgeArrayEntry>(
+            DataLayout::CCH_GRAPH_EDGE_LIST, num_edges);
+    }
+    else
+    {
+        layout.SetBlockSize<contractor::QueryGraph::NodeArrayEntry>(
+            DataLayout::CCH_GRAPH_NODE_LIST, 0);
+        layout.SetBlockSize<contractor::QueryGraph::EdgeArrayEntry>(
+            DataLayout::CCH_GRAPH_EDGE_LIST, 0);
     }
 
     // load rsearch tree size
@@ -291,6 +734,18 @@ void Storage::PopulateLayout(DataLayout &layout)
         layout.SetBlockSize<std::uint64_t>(DataLayout::R_SEARCH_TREE_LEVELS, tree_levels_size);
     }
 
+    // the leaves of the rtree are only loaded if requested, else they are mapped from the file
+    {
+        layout.SetBlockSize<RTreeLeafAccess>(DataLayout::R_SEARCH_TREE_LEAF_ACCESS, 1);
+        std::uint64_t leaves_size = 0;
+        if (config.rtree_leaf_access == RTreeLeafAccess::Load)
+        {
+            io::FileReader leaf_file(config.file_index_path, io::FileReader::HasNoFingerprint);
+            leaves_size = leaf_file.GetSize() / sizeof(RTreeLeaf);
+        }
+        layout.SetBlockSize<RTreeLeaf>(DataLayout::R_SEARCH_TREE_LEAVES, leaves_size);
+    }
+
     {
         layout.SetBlockSize<extractor::ProfileProperties>(DataLayout::PROPERTIES, 1);
     }
@@ -394,8 +849,8 @@ void Storage::PopulateLayout(DataLayout &layout)
         auto num_discreate_bearings = reader.ReadVectorSize<DiscreteBearing>();
         layout.SetBlockSize<DiscreteBearing>(DataLayout::BEARING_VALUES, num_discreate_bearings);
 
-        auto num_bearing_classes = reader.ReadVectorSize<BearingClassID>();
-        layout.SetBlockSize<BearingClassID>(DataLayout::BEARING_CLASSID, num_bearing_classes);
+        auto num_bearing_class_id_bytes = reader.ReadVectorSize<std::uint8_t>();
+        layout.SetBlockSize<std::uint8_t>(DataLayout::BEARING_CLASSID, num_bearing_class_id_bytes);
 
         reader.Skip<std::uint32_t>(1); // sum_lengths
         const auto bearing_blocks = reader.ReadVectorSize<unsigned>();
@@ -461,6 +916,8 @@ void Storage::PopulateLayout(DataLayout &layout)
             const auto level_offsets_count = reader.ReadVectorSize<std::uint64_t>();
             layout.SetBlockSize<std::uint64_t>(DataLayout::MLD_CELL_LEVEL_OFFSETS,
                                                level_offsets_count);
+            const auto metric_names_count = reader.ReadVectorSize<char>();
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_METRIC_NAMES, metric_names_count);
         }
         else
         {
@@ -470,6 +927,7 @@ void Storage::PopulateLayout(DataLayout &layout)
             layout.SetBlockSize<char>(DataLayout::MLD_CELL_DESTINATION_BOUNDARY, 0);
             layout.SetBlockSize<char>(DataLayout::MLD_CELLS, 0);
             layout.SetBlockSize<char>(DataLayout::MLD_CELL_LEVEL_OFFSETS, 0);
+            layout.SetBlockSize<char>(DataLayout::MLD_CELL_METRIC_NAMES, 0);
         }
 
         if (boost::filesystem::exists(config.mld_graph_path))
@@ -499,31 +957,198 @@ void Storage::PopulateLayout(DataLayout &layout)
             layout.SetBlockSize<customizer::MultiLevelEdgeBasedGraph::EdgeOffset>(
                 DataLayout::MLD_GRAPH_NODE_TO_OFFSET, 0);
         }
+
+        using OverlayArc = customizer::OverlayHierarchy::Arc;
+        if (boost::filesystem::exists(config.mld_overlay_hierarchy_path))
+        {
+            io::FileReader reader(config.mld_overlay_hierarchy_path,
+                                  io::FileReader::VerifyFingerprint);
+
+            const auto num_nodes = reader.ReadVectorSize<NodeID>();
+            const auto num_forward_offsets = reader.ReadVectorSize<std::uint64_t>();
+            const auto num_forward_arcs = reader.ReadVectorSize<OverlayArc>();
+            const auto num_backward_offsets = reader.ReadVectorSize<std::uint64_t>();
+            const auto num_backward_arcs = reader.ReadVectorSize<OverlayArc>();
+
+            layout.SetBlockSize<NodeID>(DataLayout::MLD_OVERLAY_NODES, num_nodes);
+            layout.SetBlockSize<std::uint64_t>(DataLayout::MLD_OVERLAY_FORWARD_OFFSETS,
+                                               num_forward_offsets);
+            layout.SetBlockSize<OverlayArc>(DataLayout::MLD_OVERLAY_FORWARD_ARCS,
+                                            num_forward_arcs);
+            layout.SetBlockSize<std::uint64_t>(DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS,
+                                               num_backward_offsets);
+            layout.SetBlockSize<OverlayArc>(DataLayout::MLD_OVERLAY_BACKWARD_ARCS,
+                                            num_backward_arcs);
+        }
+        else
+        {
+            layout.SetBlockSize<NodeID>(DataLayout::MLD_OVERLAY_NODES, 0);
+            layout.SetBlockSize<std::uint64_t>(DataLayout::MLD_OVERLAY_FORWARD_OFFSETS, 0);
+            layout.SetBlockSize<OverlayArc>(DataLayout::MLD_OVERLAY_FORWARD_ARCS, 0);
+            layout.SetBlockSize<std::uint64_t>(DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS, 0);
+            layout.SetBlockSize<OverlayArc>(DataLayout::MLD_OVERLAY_BACKWARD_ARCS, 0);
+        }
     }
+
+    // landmarks of the MLD graph or of the CoreCH core, both share the edge-based node ids
+    {
+        using Distance = util::Landmarks::Distance;
+        if (boost::filesystem::exists(config.landmarks_path))
+        {
+            io::FileReader reader(config.landmarks_path, io::FileReader::VerifyFingerprint);
+
+            const auto num_landmarks = reader.ReadVectorSize<NodeID>();
+            const auto num_units = reader.ReadVectorSize<EdgeWeight>();
+            const auto num_distances = reader.ReadVectorSize<Distance>();
+
+            layout.SetBlockSize<NodeID>(DataLayout::LANDMARK_NODES, num_landmarks);
+            layout.SetBlockSize<EdgeWeight>(DataLayout::LANDMARK_UNITS, num_units);
+            layout.SetBlockSize<Distance>(DataLayout::LANDMARK_DISTANCES, num_distances);
+        }
+        else
+        {
+            layout.SetBlockSize<NodeID>(DataLayout::LANDMARK_NODES, 0);
+            layout.SetBlockSize<EdgeWeight>(DataLayout::LANDMARK_UNITS, 0);
+            layout.SetBlockSize<Distance>(DataLayout::LANDMARK_DISTANCES, 0);
+        }
+    }
+
+    // durations between the cells of a level of the MLD partition for approximate tables
+    if (boost::filesystem::exists(config.distance_oracle_path))
+    {
+        io::FileReader reader(config.distance_oracle_path, io::FileReader::VerifyFingerprint);
+
+        const auto num_representatives = reader.ReadVectorSize<NodeID>();
+        const auto num_cells = reader.ReadVectorSize<CellID>();
+        const auto num_node_durations = reader.ReadVectorSize<EdgeDuration>();
+        const auto num_cell_durations = reader.ReadVectorSize<EdgeDuration>();
+
+        layout.SetBlockSize<NodeID>(DataLayout::DISTANCE_ORACLE_REPRESENTATIVES,
+                                    num_representatives);
+        layout.SetBlockSize<CellID>(DataLayout::DISTANCE_ORACLE_CELLS, num_cells);
+        layout.SetBlockSize<EdgeDuration>(DataLayout::DISTANCE_ORACLE_NODE_DURATIONS,
+                                          num_node_durations);
+        layout.SetBlockSize<EdgeDuration>(DataLayout::DISTANCE_ORACLE_CELL_DURATIONS,
+                                          num_cell_durations);
+    }
+    else
+    {
+        layout.SetBlockSize<NodeID>(DataLayout::DISTANCE_ORACLE_REPRESENTATIVES, 0);
+        layout.SetBlockSize<CellID>(DataLayout::DISTANCE_ORACLE_CELLS, 0);
+        layout.SetBlockSize<EdgeDuration>(DataLayout::DISTANCE_ORACLE_NODE_DURATIONS, 0);
+        layout.SetBlockSize<EdgeDuration>(DataLayout::DISTANCE_ORACLE_CELL_DURATIONS, 0);
+    }
+
+    // time slots of the conditional turn restrictions the queries evaluate
+    if (boost::filesystem::exists(config.conditional_turn_masks_path))
+    {
+        io::FileReader reader(config.conditional_turn_masks_path,
+                              io::FileReader::VerifyFingerprint);
+
+        const auto num_turns = reader.ReadVectorSize<EdgeID>();
+        const auto num_sources = reader.ReadVectorSize<NodeID>();
+        const auto num_targets = reader.ReadVectorSize<NodeID>();
+        const auto num_masks = reader.ReadVectorSize<std::uint64_t>();
+
+        layout.SetBlockSize<EdgeID>(DataLayout::CONDITIONAL_TURN_IDS, num_turns);
+        layout.SetBlockSize<NodeID>(DataLayout::CONDITIONAL_TURN_SOURCES, num_sources);
+        layout.SetBlockSize<NodeID>(DataLayout::CONDITIONAL_TURN_TARGETS, num_targets);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::CONDITIONAL_TURN_MASKS, num_masks);
+    }
+    else
+    {
+        layout.SetBlockSize<EdgeID>(DataLayout::CONDITIONAL_TURN_IDS, 0);
+        layout.SetBlockSize<NodeID>(DataLayout::CONDITIONAL_TURN_SOURCES, 0);
+        layout.SetBlockSize<NodeID>(DataLayout::CONDITIONAL_TURN_TARGETS, 0);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::CONDITIONAL_TURN_MASKS, 0);
+    }
+
+    const auto sources = getBlockSources(config);
+    for (const auto id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+    {
+        layout.source_stamps[id] = getFileStamp(sources[id]);
+    }
+    // comes from the config and not from a file, so it is never copied from the data in use
+    layout.source_stamps[DataLayout::R_SEARCH_TREE_LEAF_ACCESS] = 0;
 }
 
-void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
+void Storage::PopulateData(const DataLayout &layout,
+                           char *memory_ptr,
+                           const BlockSet &skipped_blocks)
 {
     BOOST_ASSERT(memory_ptr != nullptr);
 
+    // the image holds all blocks, it is never combined with blocks of the data in use
+    if (config.use_image)
+    {
+        BOOST_ASSERT(std::none_of(
+            layout.external_blocks.begin(), layout.external_blocks.end(), [](const char *ptr) {
+                return ptr != nullptr;
+            }));
+        TIMER_START(load);
+        readImageMemory(config.image_path, layout, memory_ptr);
+        TIMER_STOP(load);
+
+        const auto megabytes = layout.GetSizeOfLayout() / (1024. * 1024.);
+        util::Log() << "Loaded " << config.image_path.filename().string() << ": " << megabytes
+                    << " MiB in " << TIMER_SEC(load) << "s ("
+                    << megabytes / std::max(TIMER_SEC(load), 1e-6) << " MiB/s)";
+        return;
+    }
+
+    // blocks of the same file are loaded together, so they are all skipped or none
+    const auto is_filled = [&](const DataLayout::BlockID id) {
+        return layout.IsExternalBlock(id) || skipped_blocks[id];
+    };
+
+    // Every file is read by a task of its own into its blocks, which no other task writes to
+    const auto sources = getBlockSources(config);
+    tbb::task_group loads;
+    const auto load = [&](const DataLayout::BlockID id, auto read) {
+        if (is_filled(id))
+            return;
+
+        loads.run([&, id, read] {
+            TIMER_START(load);
+            read();
+            TIMER_STOP(load);
+
+            std::uint64_t size = 0;
+            for (const auto other_id : util::irange<std::size_t>(0, DataLayout::NUM_BLOCKS))
+            {
+                if (sources[other_id] == sources[id])
+                    size += layout.GetBlockSize(static_cast<DataLayout::BlockID>(other_id));
+            }
+            const auto megabytes = size / (1024. * 1024.);
+            util::Log() << "Loaded " << sources[id].filename().string() << ": " << megabytes
+                        << " MiB in " << TIMER_SEC(load) << "s ("
+                        << megabytes / std::max(TIMER_SEC(load), 1e-6) << " MiB/s)";
+        });
+    };
+
     // read actual data into shared memory object //
 
     // Load the HSGR file
     if (boost::filesystem::exists(config.hsgr_data_path))
     {
-        auto graph_nodes_ptr = layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
-            memory_ptr, storage::DataLayout::CH_GRAPH_NODE_LIST);
-        auto graph_edges_ptr = layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
-            memory_ptr, storage::DataLayout::CH_GRAPH_EDGE_LIST);
-        auto checksum = layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
-
-        util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
-            graph_nodes_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
-        util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
-            graph_edges_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
-
-        contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
-        contractor::files::readGraph(config.hsgr_data_path, *checksum, graph_view);
+        load(DataLayout::CH_GRAPH_NODE_LIST, [&] {
+            auto graph_nodes_ptr =
+                layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+                    memory_ptr, storage::DataLayout::CH_GRAPH_NODE_LIST);
+            auto graph_edges_ptr =
+                layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+                    memory_ptr, storage::DataLayout::CH_GRAPH_EDGE_LIST);
+            auto checksum =
+                layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
+
+            util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
+                graph_nodes_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
+            util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
+                graph_edges_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
+
+            contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
+            contractor::files::readGraph(config.hsgr_data_path, *checksum, graph_view);
+        });
     }
     else
     {
@@ -534,7 +1159,63 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             memory_ptr, DataLayout::CH_GRAPH_EDGE_LIST);
     }
 
+    if (layout.GetBlockEntries(DataLayout::CH_COMPRESSED_GRAPH_OFFSETS) > 0)
+    {
+        load(DataLayout::CH_COMPRESSED_GRAPH_OFFSETS, [&] {
+            auto graph = make_compressed_search_graph_view<true>(memory_ptr, layout);
+            unsigned checksum;
+            contractor::files::readCompressedSearchGraph(
+                config.compressed_hsgr_data_path, checksum, graph);
+        });
+    }
+    else
+    {
+        make_compressed_search_graph_view<true>(memory_ptr, layout);
+    }
+
+    if (layout.GetBlockEntries(DataLayout::CH_HUB_LABEL_OFFSETS) > 0)
+    {
+        load(DataLayout::CH_HUB_LABEL_OFFSETS, [&] {
+            auto labels = make_hub_labels_view<true>(memory_ptr, layout);
+            unsigned checksum;
+            contractor::files::readHubLabels(config.hub_labels_path, checksum, labels);
+        });
+    }
+    else
+    {
+        make_hub_labels_view<true>(memory_ptr, layout);
+    }
+
+    if (boost::filesystem::exists(config.cch_graph_path))
+    {
+        load(DataLayout::CCH_GRAPH_NODE_LIST, [&] {
+            auto graph_nodes_ptr =
+                layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+                    memory_ptr, storage::DataLayout::CCH_GRAPH_NODE_LIST);
+            auto graph_edges_ptr =
+                layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+                    memory_ptr, storage::DataLayout::CCH_GRAPH_EDGE_LIST);
+
+            util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
+                graph_nodes_ptr, layout.num_entries[storage::DataLayout::CCH_GRAPH_NODE_LIST]);
+            util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
+                graph_edges_ptr, layout.num_entries[storage::DataLayout::CCH_GRAPH_EDGE_LIST]);
+
+            unsigned checksum;
+            contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
+            contractor::files::readGraph(config.cch_graph_path, checksum, graph_view);
+        });
+    }
+    else
+    {
+        layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+            memory_ptr, DataLayout::CCH_GRAPH_NODE_LIST);
+        layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+            memory_ptr, DataLayout::CCH_GRAPH_EDGE_LIST);
+    }
+
     // store the filename of the on-disk portion of the RTree
+    if (!is_filled(DataLayout::FILE_INDEX_PATH))
     {
         const auto file_index_path_ptr =
             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::FILE_INDEX_PATH);
@@ -551,7 +1232,7 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
     }
 
     // Name data
-    {
+    load(DataLayout::NAME_CHAR_DATA, [&] {
         io::FileReader name_file(config.names_data_path, io::FileReader::VerifyFingerprint);
         std::size_t name_file_size = name_file.GetSize();
 
@@ -560,10 +1241,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::NAME_CHAR_DATA);
 
         name_file.ReadInto<char>(name_char_ptr, name_file_size);
-    }
+    });
 
     // Turn lane data
-    {
+    load(DataLayout::TURN_LANE_DATA, [&] {
         io::FileReader lane_data_file(config.turn_lane_data_path,
                                       io::FileReader::VerifyFingerprint);
 
@@ -576,10 +1257,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
         BOOST_ASSERT(lane_tuple_count * sizeof(util::guidance::LaneTupleIdPair) ==
                      layout.GetBlockSize(DataLayout::TURN_LANE_DATA));
         lane_data_file.ReadInto(turn_lane_data_ptr, lane_tuple_count);
-    }
+    });
 
     // Turn lane descriptions
-    {
+    load(DataLayout::LANE_DESCRIPTION_OFFSETS, [&] {
         auto offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
             memory_ptr, storage::DataLayout::LANE_DESCRIPTION_OFFSETS);
         util::vector_view<std::uint32_t> offsets(
@@ -592,154 +1273,56 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
 
         extractor::files::readTurnLaneDescriptions(
             config.turn_lane_description_path, offsets, masks);
-    }
+    });
 
     // Load edge-based nodes data
-    {
-        auto geometry_id_list_ptr =
-            layout.GetBlockPtr<GeometryID, true>(memory_ptr, storage::DataLayout::GEOMETRY_ID_LIST);
-        util::vector_view<GeometryID> geometry_ids(
-            geometry_id_list_ptr, layout.num_entries[storage::DataLayout::GEOMETRY_ID_LIST]);
-
-        auto name_id_list_ptr =
-            layout.GetBlockPtr<NameID, true>(memory_ptr, storage::DataLayout::NAME_ID_LIST);
-        util::vector_view<NameID> name_ids(name_id_list_ptr,
-                                           layout.num_entries[storage::DataLayout::NAME_ID_LIST]);
+    load(DataLayout::EDGE_BASED_NODE_LIST, [&] {
+        auto nodes_ptr = layout.GetBlockPtr<extractor::EdgeBasedNode, true>(
+            memory_ptr, storage::DataLayout::EDGE_BASED_NODE_LIST);
+        util::vector_view<extractor::EdgeBasedNode> nodes(
+            nodes_ptr, layout.num_entries[storage::DataLayout::EDGE_BASED_NODE_LIST]);
 
         auto component_ids_ptr = layout.GetBlockPtr<ComponentID, true>(
             memory_ptr, storage::DataLayout::COMPONENT_ID_LIST);
         util::vector_view<ComponentID> component_ids(
             component_ids_ptr, layout.num_entries[storage::DataLayout::COMPONENT_ID_LIST]);
 
-        auto travel_mode_list_ptr = layout.GetBlockPtr<extractor::TravelMode, true>(
-            memory_ptr, storage::DataLayout::TRAVEL_MODE_LIST);
-        util::vector_view<extractor::TravelMode> travel_modes(
-            travel_mode_list_ptr, layout.num_entries[storage::DataLayout::TRAVEL_MODE_LIST]);
-
-        auto classes_list_ptr = layout.GetBlockPtr<extractor::ClassData, true>(
-            memory_ptr, storage::DataLayout::CLASSES_LIST);
-        util::vector_view<extractor::ClassData> classes(
-            classes_list_ptr, layout.num_entries[storage::DataLayout::CLASSES_LIST]);
-
-        extractor::EdgeBasedNodeDataView node_data(std::move(geometry_ids),
-                                                   std::move(name_ids),
-                                                   std::move(component_ids),
-                                                   std::move(travel_modes),
-                                                   std::move(classes));
+        extractor::EdgeBasedNodeDataView node_data(std::move(nodes), std::move(component_ids));
 
         extractor::files::readNodeData(config.edge_based_nodes_data_path, node_data);
-    }
+    });
 
     // Load original edge data
-    {
-        const auto lane_data_id_ptr =
-            layout.GetBlockPtr<LaneDataID, true>(memory_ptr, storage::DataLayout::LANE_DATA_ID);
-        util::vector_view<LaneDataID> lane_data_ids(
-            lane_data_id_ptr, layout.num_entries[storage::DataLayout::LANE_DATA_ID]);
-
-        const auto turn_instruction_list_ptr =
-            layout.GetBlockPtr<extractor::guidance::TurnInstruction, true>(
-                memory_ptr, storage::DataLayout::TURN_INSTRUCTION);
-        util::vector_view<extractor::guidance::TurnInstruction> turn_instructions(
-            turn_instruction_list_ptr, layout.num_entries[storage::DataLayout::TURN_INSTRUCTION]);
-
-        const auto entry_class_id_list_ptr =
-            layout.GetBlockPtr<EntryClassID, true>(memory_ptr, storage::DataLayout::ENTRY_CLASSID);
-        util::vector_view<EntryClassID> entry_class_ids(
-            entry_class_id_list_ptr, layout.num_entries[storage::DataLayout::ENTRY_CLASSID]);
-
-        const auto pre_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing, true>(
-            memory_ptr, storage::DataLayout::PRE_TURN_BEARING);
-        util::vector_view<util::guidance::TurnBearing> pre_turn_bearings(
-            pre_turn_bearing_ptr, layout.num_entries[storage::DataLayout::PRE_TURN_BEARING]);
-
-        const auto post_turn_bearing_ptr = layout.GetBlockPtr<util::guidance::TurnBearing, true>(
-            memory_ptr, storage::DataLayout::POST_TURN_BEARING);
-        util::vector_view<util::guidance::TurnBearing> post_turn_bearings(
-            post_turn_bearing_ptr, layout.num_entries[storage::DataLayout::POST_TURN_BEARING]);
-
-        extractor::TurnDataView turn_data(std::move(turn_instructions),
-                                          std::move(lane_data_ids),
-                                          std::move(entry_class_ids),
-                                          std::move(pre_turn_bearings),
-                                          std::move(post_turn_bearings));
+    load(DataLayout::TURN_DATA_ID, [&] {
+        const auto turn_data_id_ptr =
+            layout.GetBlockPtr<std::uint32_t, true>(memory_ptr, storage::DataLayout::TURN_DATA_ID);
+        util::vector_view<std::uint32_t> turn_data_ids(
+            turn_data_id_ptr, layout.num_entries[storage::DataLayout::TURN_DATA_ID]);
+
+        const auto turn_data_ptr = layout.GetBlockPtr<extractor::TurnData, true>(
+            memory_ptr, storage::DataLayout::TURN_DATA);
+        util::vector_view<extractor::TurnData> turn_data_list(
+            turn_data_ptr, layout.num_entries[storage::DataLayout::TURN_DATA]);
+
+        extractor::TurnDataView turn_data(std::move(turn_data_ids), std::move(turn_data_list));
 
         extractor::files::readTurnData(config.edges_data_path, turn_data);
-    }
+    });
 
     // load compressed geometry
-    {
-        auto geometries_index_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, storage::DataLayout::GEOMETRIES_INDEX);
-        util::vector_view<unsigned> geometry_begin_indices(
-            geometries_index_ptr, layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX]);
-
-        auto num_entries = layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST];
-
-        auto geometries_node_list_ptr =
-            layout.GetBlockPtr<NodeID, true>(memory_ptr, storage::DataLayout::GEOMETRIES_NODE_LIST);
-        util::vector_view<NodeID> geometry_node_list(geometries_node_list_ptr, num_entries);
-
-        auto geometries_fwd_weight_list_ptr =
-            layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type, true>(
-                memory_ptr, storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
-        extractor::SegmentDataView::SegmentWeightVector geometry_fwd_weight_list(
-            util::vector_view<extractor::SegmentDataView::SegmentWeightVector::block_type>(
-                geometries_fwd_weight_list_ptr,
-                layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST]),
-            num_entries);
-
-        auto geometries_rev_weight_list_ptr =
-            layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type, true>(
-                memory_ptr, storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
-        extractor::SegmentDataView::SegmentWeightVector geometry_rev_weight_list(
-            util::vector_view<extractor::SegmentDataView::SegmentWeightVector::block_type>(
-                geometries_rev_weight_list_ptr,
-                layout.num_entries[storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST]),
-            num_entries);
-
-        auto geometries_fwd_duration_list_ptr =
-            layout.GetBlockPtr<extractor::SegmentDataView::SegmentDurationVector::block_type, true>(
-                memory_ptr, storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST);
-        extractor::SegmentDataView::SegmentDurationVector geometry_fwd_duration_list(
-            util::vector_view<extractor::SegmentDataView::SegmentDurationVector::block_type>(
-                geometries_fwd_duration_list_ptr,
-                layout.num_entries[storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST]),
-            num_entries);
-
-        auto geometries_rev_duration_list_ptr =
-            layout.GetBlockPtr<extractor::SegmentDataView::SegmentDurationVector::block_type, true>(
-                memory_ptr, storage::DataLayout::GEOMETRIES_REV_DURATION_LIST);
-        extractor::SegmentDataView::SegmentDurationVector geometry_rev_duration_list(
-            util::vector_view<extractor::SegmentDataView::SegmentDurationVector::block_type>(
-                geometries_rev_duration_list_ptr,
-                layout.num_entries[storage::DataLayout::GEOMETRIES_REV_DURATION_LIST]),
-            num_entries);
-
-        auto datasources_list_ptr = layout.GetBlockPtr<DatasourceID, true>(
-            memory_ptr, storage::DataLayout::DATASOURCES_LIST);
-        util::vector_view<DatasourceID> datasources_list(
-            datasources_list_ptr, layout.num_entries[storage::DataLayout::DATASOURCES_LIST]);
-
-        extractor::SegmentDataView segment_data{std::move(geometry_begin_indices),
-                                                std::move(geometry_node_list),
-                                                std::move(geometry_fwd_weight_list),
-                                                std::move(geometry_rev_weight_list),
-                                                std::move(geometry_fwd_duration_list),
-                                                std::move(geometry_rev_duration_list),
-                                                std::move(datasources_list)};
-
+    load(DataLayout::GEOMETRIES_INDEX, [&] {
+        auto segment_data = make_segment_data_view<true>(memory_ptr, layout);
         extractor::files::readSegmentData(config.geometries_path, segment_data);
-    }
+    });
 
-    {
+    load(DataLayout::DATASOURCES_NAMES, [&] {
         const auto datasources_names_ptr = layout.GetBlockPtr<extractor::Datasources, true>(
             memory_ptr, DataLayout::DATASOURCES_NAMES);
         extractor::files::readDatasources(config.datasource_names_path, *datasources_names_ptr);
-    }
+    });
 
     // Loading list of coordinates
-    {
+    load(DataLayout::COORDINATE_LIST, [&] {
         const auto coordinates_ptr =
             layout.GetBlockPtr<util::Coordinate, true>(memory_ptr, DataLayout::COORDINATE_LIST);
         const auto osmnodeid_ptr =
@@ -753,30 +1336,30 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             layout.num_entries[DataLayout::COORDINATE_LIST]);
 
         extractor::files::readNodes(config.node_based_nodes_data_path, coordinates, osm_node_ids);
-    }
+    });
 
     // load turn weight penalties
-    {
+    load(DataLayout::TURN_WEIGHT_PENALTIES, [&] {
         io::FileReader turn_weight_penalties_file(config.turn_weight_penalties_path,
                                                   io::FileReader::VerifyFingerprint);
         const auto number_of_penalties = turn_weight_penalties_file.ReadElementCount64();
         const auto turn_weight_penalties_ptr =
             layout.GetBlockPtr<TurnPenalty, true>(memory_ptr, DataLayout::TURN_WEIGHT_PENALTIES);
         turn_weight_penalties_file.ReadInto(turn_weight_penalties_ptr, number_of_penalties);
-    }
+    });
 
     // load turn duration penalties
-    {
+    load(DataLayout::TURN_DURATION_PENALTIES, [&] {
         io::FileReader turn_duration_penalties_file(config.turn_duration_penalties_path,
                                                     io::FileReader::VerifyFingerprint);
         const auto number_of_penalties = turn_duration_penalties_file.ReadElementCount64();
         const auto turn_duration_penalties_ptr =
             layout.GetBlockPtr<TurnPenalty, true>(memory_ptr, DataLayout::TURN_DURATION_PENALTIES);
         turn_duration_penalties_file.ReadInto(turn_duration_penalties_ptr, number_of_penalties);
-    }
+    });
 
     // store timestamp
-    {
+    load(DataLayout::TIMESTAMP, [&] {
         io::FileReader timestamp_file(config.timestamp_path, io::FileReader::VerifyFingerprint);
         const auto timestamp_size = timestamp_file.GetSize();
 
@@ -784,10 +1367,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::TIMESTAMP);
         BOOST_ASSERT(timestamp_size == layout.num_entries[DataLayout::TIMESTAMP]);
         timestamp_file.ReadInto(timestamp_ptr, timestamp_size);
-    }
+    });
 
     // store search tree portion of rtree
-    {
+    load(DataLayout::R_SEARCH_TREE, [&] {
         io::FileReader tree_node_file(config.ram_index_path, io::FileReader::VerifyFingerprint);
         // perform this read so that we're at the right stream position for the next
         // read.
@@ -803,30 +1386,52 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
 
         tree_node_file.ReadInto(rtree_levelsizes_ptr,
                                 layout.num_entries[DataLayout::R_SEARCH_TREE_LEVELS]);
+    });
+
+    if (!is_filled(DataLayout::R_SEARCH_TREE_LEAF_ACCESS))
+    {
+        *layout.GetBlockPtr<RTreeLeafAccess, true>(
+            memory_ptr, DataLayout::R_SEARCH_TREE_LEAF_ACCESS) = config.rtree_leaf_access;
     }
 
-    if (boost::filesystem::exists(config.core_data_path))
+    if (layout.GetBlockEntries(DataLayout::R_SEARCH_TREE_LEAVES) > 0)
+    {
+        load(DataLayout::R_SEARCH_TREE_LEAVES, [&] {
+            io::FileReader leaf_file(config.file_index_path, io::FileReader::HasNoFingerprint);
+            const auto leaves_ptr =
+                layout.GetBlockPtr<RTreeLeaf, true>(memory_ptr, DataLayout::R_SEARCH_TREE_LEAVES);
+            leaf_file.ReadInto(leaves_ptr, layout.num_entries[DataLayout::R_SEARCH_TREE_LEAVES]);
+        });
+    }
+    else
     {
-        auto core_marker_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, storage::DataLayout::CH_CORE_MARKER);
-        util::vector_view<bool> is_core_node(
-            core_marker_ptr, layout.num_entries[storage::DataLayout::CH_CORE_MARKER]);
+        layout.GetBlockPtr<RTreeLeaf, true>(memory_ptr, DataLayout::R_SEARCH_TREE_LEAVES);
+    }
 
-        contractor::files::readCoreMarker(config.core_data_path, is_core_node);
+    if (boost::filesystem::exists(config.core_data_path))
+    {
+        load(DataLayout::CH_CORE_MARKER, [&] {
+            auto core_marker_ptr =
+                layout.GetBlockPtr<unsigned, true>(memory_ptr, storage::DataLayout::CH_CORE_MARKER);
+            util::vector_view<bool> is_core_node(
+                core_marker_ptr, layout.num_entries[storage::DataLayout::CH_CORE_MARKER]);
+
+            contractor::files::readCoreMarker(config.core_data_path, is_core_node);
+        });
     }
 
     // load profile properties
-    {
+    load(DataLayout::PROPERTIES, [&] {
         const auto profile_properties_ptr = layout.GetBlockPtr<extractor::ProfileProperties, true>(
             memory_ptr, DataLayout::PROPERTIES);
         extractor::files::readProfileProperties(config.properties_path, *profile_properties_ptr);
-    }
+    });
 
     // Load intersection data
-    {
-        auto bearing_class_id_ptr = layout.GetBlockPtr<BearingClassID, true>(
+    load(DataLayout::BEARING_CLASSID, [&] {
+        auto bearing_class_id_ptr = layout.GetBlockPtr<std::uint8_t, true>(
             memory_ptr, storage::DataLayout::BEARING_CLASSID);
-        util::vector_view<BearingClassID> bearing_class_id(
+        util::vector_view<std::uint8_t> bearing_class_id(
             bearing_class_id_ptr, layout.num_entries[storage::DataLayout::BEARING_CLASSID]);
 
         auto bearing_values_ptr = layout.GetBlockPtr<DiscreteBearing, true>(
@@ -857,114 +1462,300 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
 
         extractor::files::readIntersections(
             config.intersection_class_path, intersection_bearings_view, entry_classes);
-    }
+    });
 
+    // Loading MLD Data
+    if (boost::filesystem::exists(config.mld_partition_path))
     {
-        // Loading MLD Data
-        if (boost::filesystem::exists(config.mld_partition_path))
-        {
+        load(DataLayout::MLD_LEVEL_DATA, [&] {
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_LEVEL_DATA) > 0);
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_TO_CHILDREN) > 0);
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0);
 
-            auto level_data =
-                layout.GetBlockPtr<partition::MultiLevelPartitionView::LevelData, true>(
-                    memory_ptr, storage::DataLayout::MLD_LEVEL_DATA);
-
-            auto mld_partition_ptr = layout.GetBlockPtr<PartitionID, true>(
-                memory_ptr, storage::DataLayout::MLD_PARTITION);
-            auto partition_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_PARTITION);
-            util::vector_view<PartitionID> partition(mld_partition_ptr, partition_entries_count);
-
-            auto mld_chilren_ptr = layout.GetBlockPtr<CellID, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_TO_CHILDREN);
-            auto children_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_TO_CHILDREN);
-            util::vector_view<CellID> cell_to_children(mld_chilren_ptr, children_entries_count);
-
-            partition::MultiLevelPartitionView mlp{
-                std::move(level_data), std::move(partition), std::move(cell_to_children)};
+            auto mlp = make_partition_view<true>(memory_ptr, layout);
             partition::files::readPartition(config.mld_partition_path, mlp);
-        }
+        });
+    }
 
-        if (boost::filesystem::exists(config.mld_storage_path))
-        {
+    if (boost::filesystem::exists(config.mld_storage_path))
+    {
+        load(DataLayout::MLD_CELLS, [&] {
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
 
-            auto mld_cell_weights_ptr = layout.GetBlockPtr<EdgeWeight, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto mld_cell_duration_ptr = layout.GetBlockPtr<EdgeDuration, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_DURATIONS);
-            auto mld_source_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
-            auto mld_destination_boundary_ptr = layout.GetBlockPtr<NodeID, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
-            auto mld_cells_ptr = layout.GetBlockPtr<partition::CellStorageView::CellData, true>(
-                memory_ptr, storage::DataLayout::MLD_CELLS);
-            auto mld_cell_level_offsets_ptr = layout.GetBlockPtr<std::uint64_t, true>(
-                memory_ptr, storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
-
-            auto weight_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_WEIGHTS);
-            auto duration_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DURATIONS);
-            auto source_boundary_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY);
-            auto destination_boundary_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
-            auto cells_entries_counts = layout.GetBlockEntries(storage::DataLayout::MLD_CELLS);
-            auto cell_level_offsets_entries_count =
-                layout.GetBlockEntries(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS);
-
-            util::vector_view<EdgeWeight> weights(mld_cell_weights_ptr, weight_entries_count);
-            util::vector_view<EdgeDuration> durations(mld_cell_duration_ptr,
-                                                      duration_entries_count);
-            util::vector_view<NodeID> source_boundary(mld_source_boundary_ptr,
-                                                      source_boundary_entries_count);
-            util::vector_view<NodeID> destination_boundary(mld_destination_boundary_ptr,
-                                                           destination_boundary_entries_count);
-            util::vector_view<partition::CellStorageView::CellData> cells(mld_cells_ptr,
-                                                                          cells_entries_counts);
-            util::vector_view<std::uint64_t> level_offsets(mld_cell_level_offsets_ptr,
-                                                           cell_level_offsets_entries_count);
-
-            partition::CellStorageView storage{std::move(weights),
-                                               std::move(durations),
-                                               std::move(source_boundary),
-                                               std::move(destination_boundary),
-                                               std::move(cells),
-                                               std::move(level_offsets)};
+            auto storage = make_cell_storage_view<true>(memory_ptr, layout);
             partition::files::readCells(config.mld_storage_path, storage);
-        }
-
-        if (boost::filesystem::exists(config.mld_graph_path))
-        {
+        });
+    }
 
-            auto graph_nodes_ptr =
-                layout.GetBlockPtr<customizer::MultiLevelEdgeBasedGraphView::NodeArrayEntry, true>(
-                    memory_ptr, storage::DataLayout::MLD_GRAPH_NODE_LIST);
-            auto graph_edges_ptr =
-                layout.GetBlockPtr<customizer::MultiLevelEdgeBasedGraphView::EdgeArrayEntry, true>(
-                    memory_ptr, storage::DataLayout::MLD_GRAPH_EDGE_LIST);
-            auto graph_node_to_offset_ptr =
-                layout.GetBlockPtr<customizer::MultiLevelEdgeBasedGraphView::EdgeOffset, true>(
-                    memory_ptr, storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
-
-            util::vector_view<customizer::MultiLevelEdgeBasedGraphView::NodeArrayEntry> node_list(
-                graph_nodes_ptr, layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_LIST]);
-            util::vector_view<customizer::MultiLevelEdgeBasedGraphView::EdgeArrayEntry> edge_list(
-                graph_edges_ptr, layout.num_entries[storage::DataLayout::MLD_GRAPH_EDGE_LIST]);
-            util::vector_view<customizer::MultiLevelEdgeBasedGraphView::EdgeOffset> node_to_offset(
-                graph_node_to_offset_ptr,
-                layout.num_entries[storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET]);
-
-            customizer::MultiLevelEdgeBasedGraphView graph_view(
-                std::move(node_list), std::move(edge_list), std::move(node_to_offset));
+    if (boost::filesystem::exists(config.mld_graph_path))
+    {
+        load(DataLayout::MLD_GRAPH_NODE_LIST, [&] {
+            auto graph_view = make_multi_level_graph_view<true>(memory_ptr, layout);
             partition::files::readGraph(config.mld_graph_path, graph_view);
-        }
+        });
+    }
+
+    if (boost::filesystem::exists(config.mld_overlay_hierarchy_path))
+    {
+        load(DataLayout::MLD_OVERLAY_NODES, [&] {
+            auto hierarchy = make_overlay_hierarchy_view<true>(memory_ptr, layout);
+            customizer::files::readOverlayHierarchy(config.mld_overlay_hierarchy_path, hierarchy);
+        });
+    }
+    else
+    {
+        make_overlay_hierarchy_view<true>(memory_ptr, layout);
     }
+
+    if (boost::filesystem::exists(config.landmarks_path))
+    {
+        load(DataLayout::LANDMARK_NODES, [&] {
+            auto landmarks = make_landmarks_view<true>(memory_ptr, layout);
+            contractor::files::readLandmarks(config.landmarks_path, landmarks);
+        });
+    }
+    else
+    {
+        make_landmarks_view<true>(memory_ptr, layout);
+    }
+
+    if (boost::filesystem::exists(config.distance_oracle_path))
+    {
+        load(DataLayout::DISTANCE_ORACLE_REPRESENTATIVES, [&] {
+            auto oracle = make_distance_oracle_view<true>(memory_ptr, layout);
+            customizer::files::readDistanceOracle(config.distance_oracle_path, oracle);
+        });
+    }
+    else
+    {
+        make_distance_oracle_view<true>(memory_ptr, layout);
+    }
+
+    if (boost::filesystem::exists(config.conditional_turn_masks_path))
+    {
+        load(DataLayout::CONDITIONAL_TURN_IDS, [&] {
+            auto masks = make_conditional_turn_masks_view<true>(memory_ptr, layout);
+            extractor::files::readConditionalTurnMasks(config.conditional_turn_masks_path, masks);
+        });
+    }
+    else
+    {
+        make_conditional_turn_masks_view<true>(memory_ptr, layout);
+    }
+
+    // rethrows the first error of a task
+    loads.wait();
+}
+
+std::vector<FileBlock> Storage::PopulateFileBlocks(const DataLayout &layout)
+{
+    using SegmentWeightBlock = extractor::SegmentDataView::SegmentWeightVector::block_type;
+    using SegmentDurationBlock = extractor::SegmentDataView::SegmentDurationVector::block_type;
+    using MLDGraph = customizer::MultiLevelEdgeBasedGraphView;
+
+    std::vector<FileBlock> file_blocks;
+
+    // the blocks of an image are used from a mapping of the image as a whole
+    if (config.use_image)
+    {
+        return file_blocks;
+    }
+
+    if (boost::filesystem::exists(config.hsgr_data_path))
+    {
+        FileBlockLocator locator(config.hsgr_data_path, layout);
+        locator.Entries<unsigned>(DataLayout::HSGR_CHECKSUM);
+        locator.Vector<contractor::QueryGraphView::NodeArrayEntry>(DataLayout::CH_GRAPH_NODE_LIST);
+        locator.Vector<contractor::QueryGraphView::EdgeArrayEntry>(DataLayout::CH_GRAPH_EDGE_LIST);
+        locator.AddTo(file_blocks);
+    }
+
+    if (layout.GetBlockEntries(DataLayout::CH_COMPRESSED_GRAPH_OFFSETS) > 0)
+    {
+        FileBlockLocator locator(config.compressed_hsgr_data_path, layout);
+        locator.Skip<unsigned>(1); // checksum
+        locator.Vector<std::uint64_t>(DataLayout::CH_COMPRESSED_GRAPH_OFFSETS);
+        locator.Vector<std::uint8_t>(DataLayout::CH_COMPRESSED_GRAPH_EDGES);
+        locator.AddTo(file_blocks);
+    }
+
+    if (layout.GetBlockEntries(DataLayout::CH_HUB_LABEL_OFFSETS) > 0)
+    {
+        FileBlockLocator locator(config.hub_labels_path, layout);
+        locator.Skip<unsigned>(1); // checksum
+        locator.Vector<std::uint64_t>(DataLayout::CH_HUB_LABEL_OFFSETS);
+        locator.Vector<NodeID>(DataLayout::CH_HUB_LABEL_HUBS);
+        locator.Vector<EdgeWeight>(DataLayout::CH_HUB_LABEL_WEIGHTS);
+        locator.Vector<EdgeDuration>(DataLayout::CH_HUB_LABEL_DURATIONS);
+        locator.AddTo(file_blocks);
+    }
+
+    if (boost::filesystem::exists(config.cch_graph_path))
+    {
+        FileBlockLocator locator(config.cch_graph_path, layout);
+        locator.Skip<unsigned>(1); // checksum
+        locator.Vector<contractor::QueryGraphView::NodeArrayEntry>(DataLayout::CCH_GRAPH_NODE_LIST);
+        locator.Vector<contractor::QueryGraphView::EdgeArrayEntry>(DataLayout::CCH_GRAPH_EDGE_LIST);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.names_data_path, layout);
+        locator.Entries<char>(DataLayout::NAME_CHAR_DATA);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.turn_lane_data_path, layout);
+        locator.Vector<util::guidance::LaneTupleIdPair>(DataLayout::TURN_LANE_DATA);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.turn_lane_description_path, layout);
+        locator.Vector<std::uint32_t>(DataLayout::LANE_DESCRIPTION_OFFSETS);
+        locator.Vector<extractor::guidance::TurnLaneType::Mask>(DataLayout::LANE_DESCRIPTION_MASKS);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.edge_based_nodes_data_path, layout);
+        locator.Vector<extractor::EdgeBasedNode>(DataLayout::EDGE_BASED_NODE_LIST);
+        locator.Vector<ComponentID>(DataLayout::COMPONENT_ID_LIST);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.edges_data_path, layout);
+        locator.Vector<std::uint32_t>(DataLayout::TURN_DATA_ID);
+        locator.Vector<extractor::TurnData>(DataLayout::TURN_DATA);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        // the packed vectors store their number of elements first
+        FileBlockLocator locator(config.geometries_path, layout);
+        locator.Vector<unsigned>(DataLayout::GEOMETRIES_INDEX);
+        locator.Vector<NodeID>(DataLayout::GEOMETRIES_NODE_LIST);
+        locator.Skip<std::uint64_t>(1);
+        locator.Vector<SegmentWeightBlock>(DataLayout::GEOMETRIES_FWD_WEIGHT_LIST);
+        locator.Skip<std::uint64_t>(1);
+        locator.Vector<SegmentWeightBlock>(DataLayout::GEOMETRIES_REV_WEIGHT_LIST);
+        locator.Skip<std::uint64_t>(1);
+        locator.Vector<SegmentDurationBlock>(DataLayout::GEOMETRIES_FWD_DURATION_LIST);
+        locator.Skip<std::uint64_t>(1);
+        locator.Vector<SegmentDurationBlock>(DataLayout::GEOMETRIES_REV_DURATION_LIST);
+        locator.Vector<DatasourceID>(DataLayout::DATASOURCES_LIST);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.node_based_nodes_data_path, layout);
+        locator.Vector<util::Coordinate>(DataLayout::COORDINATE_LIST);
+        locator.Skip<std::uint64_t>(1);
+        locator.Vector<extractor::PackedOSMIDsView::block_type>(DataLayout::OSM_NODE_ID_LIST);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.turn_weight_penalties_path, layout);
+        locator.Vector<TurnPenalty>(DataLayout::TURN_WEIGHT_PENALTIES);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.turn_duration_penalties_path, layout);
+        locator.Vector<TurnPenalty>(DataLayout::TURN_DURATION_PENALTIES);
+        locator.AddTo(file_blocks);
+    }
+
+    {
+        FileBlockLocator locator(config.ram_index_path, layout);
+        locator.Vector<RTreeNode>(DataLayout::R_SEARCH_TREE);
+        locator.Vector<std::uint64_t>(DataLayout::R_SEARCH_TREE_LEVELS);
+        locator.AddTo(file_blocks);
+    }
+
+    // the .fileIndex holds nothing but the leaves
+    if (layout.GetBlockEntries(DataLayout::R_SEARCH_TREE_LEAVES) > 0)
+    {
+        file_blocks.push_back(
+            FileBlock{DataLayout::R_SEARCH_TREE_LEAVES, config.file_index_path, 0});
+    }
+
+    if (boost::filesystem::exists(config.mld_partition_path))
+    {
+        FileBlockLocator locator(config.mld_partition_path, layout);
+        locator.Entries<partition::MultiLevelPartitionView::LevelData>(DataLayout::MLD_LEVEL_DATA);
+        locator.Vector<PartitionID>(DataLayout::MLD_PARTITION);
+        locator.Vector<CellID>(DataLayout::MLD_CELL_TO_CHILDREN);
+        locator.AddTo(file_blocks);
+    }
+
+    if (boost::filesystem::exists(config.mld_storage_path))
+    {
+        FileBlockLocator locator(config.mld_storage_path, layout);
+        locator.Vector<EdgeWeight>(DataLayout::MLD_CELL_WEIGHTS);
+        locator.Vector<EdgeDuration>(DataLayout::MLD_CELL_DURATIONS);
+        locator.Vector<NodeID>(DataLayout::MLD_CELL_SOURCE_BOUNDARY);
+        locator.Vector<NodeID>(DataLayout::MLD_CELL_DESTINATION_BOUNDARY);
+        locator.Vector<partition::CellStorageView::CellData>(DataLayout::MLD_CELLS);
+        locator.Vector<std::uint64_t>(DataLayout::MLD_CELL_LEVEL_OFFSETS);
+        locator.Vector<char>(DataLayout::MLD_CELL_METRIC_NAMES);
+        locator.AddTo(file_blocks);
+    }
+
+    if (boost::filesystem::exists(config.mld_graph_path))
+    {
+        FileBlockLocator locator(config.mld_graph_path, layout);
+        locator.Vector<MLDGraph::NodeArrayEntry>(DataLayout::MLD_GRAPH_NODE_LIST);
+        locator.Vector<MLDGraph::EdgeArrayEntry>(DataLayout::MLD_GRAPH_EDGE_LIST);
+        locator.Vector<MLDGraph::EdgeOffset>(DataLayout::MLD_GRAPH_NODE_TO_OFFSET);
+        locator.AddTo(file_blocks);
+    }
+
+    if (boost::filesystem::exists(config.mld_overlay_hierarchy_path))
+    {
+        FileBlockLocator locator(config.mld_overlay_hierarchy_path, layout);
+        locator.Vector<NodeID>(DataLayout::MLD_OVERLAY_NODES);
+        locator.Vector<std::uint64_t>(DataLayout::MLD_OVERLAY_FORWARD_OFFSETS);
+        locator.Vector<customizer::OverlayHierarchy::Arc>(DataLayout::MLD_OVERLAY_FORWARD_ARCS);
+        locator.Vector<std::uint64_t>(DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS);
+        locator.Vector<customizer::OverlayHierarchy::Arc>(DataLayout::MLD_OVERLAY_BACKWARD_ARCS);
+        locator.AddTo(file_blocks);
+    }
+
+    if (boost::filesystem::exists(config.landmarks_path))
+    {
+        FileBlockLocator locator(config.landmarks_path, layout);
+        locator.Vector<NodeID>(DataLayout::LANDMARK_NODES);
+        locator.Vector<EdgeWeight>(DataLayout::LANDMARK_UNITS);
+        locator.Vector<util::Landmarks::Distance>(DataLayout::LANDMARK_DISTANCES);
+        locator.AddTo(file_blocks);
+    }
+
+    if (boost::filesystem::exists(config.distance_oracle_path))
+    {
+        FileBlockLocator locator(config.distance_oracle_path, layout);
+        locator.Vector<NodeID>(DataLayout::DISTANCE_ORACLE_REPRESENTATIVES);
+        locator.Vector<CellID>(DataLayout::DISTANCE_ORACLE_CELLS);
+        locator.Vector<EdgeDuration>(DataLayout::DISTANCE_ORACLE_NODE_DURATIONS);
+        locator.Vector<EdgeDuration>(DataLayout::DISTANCE_ORACLE_CELL_DURATIONS);
+        locator.AddTo(file_blocks);
+    }
+
+    if (boost::filesystem::exists(config.conditional_turn_masks_path))
+    {
+        FileBlockLocator locator(config.conditional_turn_masks_path, layout);
+        locator.Vector<EdgeID>(DataLayout::CONDITIONAL_TURN_IDS);
+        locator.Vector<NodeID>(DataLayout::CONDITIONAL_TURN_SOURCES);
+        locator.Vector<NodeID>(DataLayout::CONDITIONAL_TURN_TARGETS);
+        locator.Vector<std::uint64_t>(DataLayout::CONDITIONAL_TURN_MASKS);
+        locator.AddTo(file_blocks);
+    }
+
+    return file_blocks;
 }
 }
 }
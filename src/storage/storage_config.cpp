@@ -1,8 +1,14 @@
 #include "storage/storage_config.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
 #include "util/log.hpp"
 
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/filesystem/operations.hpp>
 
+#include <algorithm>
+#include <cctype>
+
 namespace osrm
 {
 namespace storage
@@ -24,9 +30,33 @@ bool CheckFileList(const std::vector<boost::filesystem::path> &files)
 }
 }
 
+RTreeLeafAccess StringToRTreeLeafAccess(std::string access)
+{
+    boost::to_lower(access);
+
+    if (access == "mapped")
+        return RTreeLeafAccess::Mapped;
+    if (access == "random")
+        return RTreeLeafAccess::Random;
+    if (access == "prefault")
+        return RTreeLeafAccess::Prefault;
+    if (access == "load")
+        return RTreeLeafAccess::Load;
+    throw util::exception("Unknown r-tree leaf access " + access + SOURCE_REF);
+}
+
+bool IsValidDatasetName(const std::string &name)
+{
+    return std::all_of(name.begin(), name.end(), [](const char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+    });
+}
+
 StorageConfig::StorageConfig(const boost::filesystem::path &base)
     : ram_index_path{base.string() + ".ramIndex"}, file_index_path{base.string() + ".fileIndex"},
       hsgr_data_path{base.string() + ".hsgr"},
+      compressed_hsgr_data_path{base.string() + ".hsgr.compressed"},
+      hub_labels_path{base.string() + ".hsgr.labels"},
       node_based_nodes_data_path{base.string() + ".nbg_nodes"},
       edge_based_nodes_data_path{base.string() + ".ebg_nodes"},
       edges_data_path{base.string() + ".edges"}, core_data_path{base.string() + ".core"},
@@ -38,12 +68,22 @@ StorageConfig::StorageConfig(const boost::filesystem::path &base)
       intersection_class_path{base.string() + ".icd"}, turn_lane_data_path{base.string() + ".tld"},
       turn_lane_description_path{base.string() + ".tls"},
       mld_partition_path{base.string() + ".partition"}, mld_storage_path{base.string() + ".cells"},
-      mld_graph_path{base.string() + ".mldgr"}
+      mld_graph_path{base.string() + ".mldgr"},
+      mld_overlay_hierarchy_path{base.string() + ".mldtop"},
+      cch_graph_path{base.string() + ".cchgr"}, landmarks_path{base.string() + ".landmarks"},
+      distance_oracle_path{base.string() + ".distance_oracle"},
+      conditional_turn_masks_path{base.string() + ".conditional_turns"},
+      image_path{base.string() + ".image"}
 {
 }
 
 bool StorageConfig::IsValid() const
 {
+    if (use_image)
+    {
+        return CheckFileList({image_path, file_index_path});
+    }
+
     // Common files
     if (!CheckFileList({ram_index_path,
                         file_index_path,
@@ -0,0 +1,726 @@
+#include "server/api/body_parser.hpp"
+#include "server/api/parsed_url.hpp"
+#include "server/api/url_parser.hpp"
+#include "server/service_handler.hpp"
+#include "server/shard_router.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/json_renderer.hpp"
+#include "util/log.hpp"
+#include "util/request_timing.hpp"
+#include "util/string_util.hpp"
+#include "util/version.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct ReplayConfig
+{
+    boost::filesystem::path log_path;
+    boost::filesystem::path dataset_path;
+    std::string algorithm = "CH";
+    bool shared_memory = false;
+    bool mmap = false;
+    std::string url;
+    unsigned concurrency = 1;
+    double rate = 0;
+    unsigned repeat = 1;
+    std::size_t warmup = 0;
+};
+
+// A request of the log: the target is the path and query of the URL, a body makes it a POST
+struct Request
+{
+    std::string target;
+    std::string body;
+    std::string service;
+};
+
+// Outcome of one replayed request, with the durations of the stages the server measured
+struct Sample
+{
+    std::size_t request;
+    bool ok;
+    double latency;
+    std::array<double, util::NUM_REQUEST_STAGES> stages;
+    std::array<bool, util::NUM_REQUEST_STAGES> measured;
+};
+
+/**
+ * Lines of the request log are URLs like osrm-routed receives them, with or without the scheme
+ * and host, optionally after the method. Anything after the URL is the body of a POST request,
+ * i.e. a JSON object or the rest of the URL in the syntax of a GET request:
+ *
+ *   /route/v1/driving/7.41,43.73;7.42,43.74?steps=true
+ *   GET http://localhost:5000/nearest/v1/driving/7.41,43.73
+ *   POST /table/v1/driving {"coordinates": [[7.41,43.73],[7.42,43.74]]}
+ *
+ * Empty lines and lines starting with # are skipped.
+ */
+bool parseLogLine(std::string line, Request &request)
+{
+    boost::trim(line);
+    if (line.empty() || line.front() == '#')
+        return false;
+
+    for (const auto *method : {"GET ", "POST "})
+    {
+        if (boost::starts_with(line, method))
+        {
+            line = boost::trim_left_copy(line.substr(std::char_traits<char>::length(method)));
+        }
+    }
+    for (const auto *scheme : {"http://", "https://"})
+    {
+        if (boost::starts_with(line, scheme))
+        {
+            const auto path = line.find('/', std::char_traits<char>::length(scheme));
+            line = path == std::string::npos ? "/" : line.substr(path);
+        }
+    }
+    if (line.front() != '/')
+        return false;
+
+    const auto end_of_target = line.find_first_of(" \t");
+    request.target = line.substr(0, end_of_target);
+    request.body = end_of_target == std::string::npos
+                       ? std::string()
+                       : boost::trim_copy(line.substr(end_of_target));
+
+    const auto end_of_service = request.target.find_first_of("/?", 1);
+    request.service = request.target.substr(1, end_of_service - 1);
+    return true;
+}
+
+std::vector<Request> readLog(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream stream(path);
+    if (!stream)
+    {
+        throw util::exception("Could not open the request log " + path.string() + SOURCE_REF);
+    }
+
+    std::vector<Request> requests;
+    std::string line;
+    std::size_t skipped = 0;
+    while (std::getline(stream, line))
+    {
+        Request request;
+        const auto trimmed = boost::trim_copy(line);
+        if (parseLogLine(trimmed, request))
+            requests.push_back(std::move(request));
+        else if (!trimmed.empty() && trimmed.front() != '#')
+            skipped++;
+    }
+    if (skipped > 0)
+    {
+        util::Log(logWARNING) << "Skipped " << skipped << " lines of " << path.string()
+                              << " that are not URLs";
+    }
+    return requests;
+}
+
+class Executor
+{
+  public:
+    virtual ~Executor() = default;
+
+    // Runs the request from the calling thread, fills the outcome and stages of the sample
+    virtual void Run(const Request &request, Sample &sample) = 0;
+};
+
+// Handles the requests like osrm-routed does, minus the HTTP connections
+class EngineExecutor final : public Executor
+{
+  public:
+    explicit EngineExecutor(EngineConfig &config) : service_handler(config) {}
+
+    void Run(const Request &request, Sample &sample) override
+    {
+        auto &timings = util::RequestTimings::GetCurrent();
+        timings.Reset();
+
+        thread_local std::string request_string;
+        boost::optional<server::api::ParsedURL> parsed_url;
+        boost::optional<server::api::BodyParameters> body;
+        bool valid = true;
+        std::string::iterator iterator;
+        {
+            util::ScopedStageTimer parse_timer(util::RequestStage::Parse);
+            util::URIDecode(request.target, request_string);
+            // JSON bodies hold the coordinates, other bodies follow the profile in the URL
+            if (!request.body.empty() && request.body.front() == '{')
+            {
+                body.emplace();
+                valid = server::api::parseJSONBody(request.body, *body);
+                const auto options = request_string.find('?');
+                if (options == std::string::npos && request_string.back() != '/')
+                    request_string.push_back('/');
+                else if (options != std::string::npos && request_string[options - 1] != '/')
+                    request_string.insert(options, "/");
+            }
+            else if (!request.body.empty())
+            {
+                if (request_string.back() != '/')
+                    request_string.push_back('/');
+                request_string += request.body;
+            }
+            iterator = request_string.begin();
+            if (valid)
+                parsed_url = server::api::parseURL(
+                    iterator, request_string.end(), body.is_initialized());
+            if (parsed_url)
+                parsed_url->body = std::move(body);
+        }
+
+        sample.ok = false;
+        if (parsed_url && iterator == request_string.end())
+        {
+            server::ServiceHandler::ResultT result;
+            sample.ok =
+                service_handler.RunQuery(*std::move(parsed_url), result) == engine::Status::Ok;
+
+            util::ScopedStageTimer render_timer(util::RequestStage::Render);
+            thread_local std::vector<char> rendered;
+            rendered.clear();
+            if (result.is<util::json::Object>())
+                util::json::render(rendered, result.get<util::json::Object>());
+        }
+        timings.Enter(util::RequestStage::None);
+
+        for (std::size_t index = 0; index < util::NUM_REQUEST_STAGES; ++index)
+        {
+            const auto stage = static_cast<util::RequestStage>(index);
+            sample.measured[index] = timings.IsMeasured(stage);
+            sample.stages[index] = Milliseconds(timings.GetDuration(stage)).count();
+        }
+    }
+
+  private:
+    server::ServiceHandler service_handler;
+};
+
+// Sends the requests to an osrm-routed over a keep-alive connection of each thread. The stages
+// are read from the Server-Timing header, which osrm-routed --server-timing sends.
+class HTTPExecutor final : public Executor
+{
+  public:
+    explicit HTTPExecutor(const std::string &url)
+    {
+        auto rest = url;
+        if (boost::starts_with(rest, "http://"))
+            rest = rest.substr(7);
+        const auto path = rest.find('/');
+        if (path != std::string::npos)
+        {
+            prefix = rest.substr(path);
+            if (prefix.back() == '/')
+                prefix.pop_back();
+            rest = rest.substr(0, path);
+        }
+        backend = server::Backend::FromString(rest);
+    }
+
+    void Run(const Request &request, Sample &sample) override
+    {
+        thread_local std::unique_ptr<Connection> connection;
+        if (!connection)
+            connection = std::make_unique<Connection>();
+
+        sample.measured.fill(false);
+        std::string server_timing;
+        unsigned status = 0;
+        // a kept alive connection might have been closed by the server meanwhile
+        for (int attempt = 0; attempt < 2 && status == 0; ++attempt)
+        {
+            try
+            {
+                status = connection->Send(*this, request, server_timing);
+            }
+            catch (const boost::system::system_error &e)
+            {
+                connection->Close();
+                if (attempt == 1)
+                    util::Log(logWARNING) << "Request to " << backend.host << ":"
+                                          << backend.port << " failed: " << e.what();
+            }
+        }
+        sample.ok = status == 200;
+        parseServerTiming(server_timing, sample);
+    }
+
+  private:
+    class Connection
+    {
+      public:
+        Connection() : socket(io_service) {}
+
+        void Close()
+        {
+            boost::system::error_code ignored;
+            socket.close(ignored);
+            buffer.consume(buffer.size());
+            connected = false;
+        }
+
+        // Returns the status code of the response
+        unsigned
+        Send(const HTTPExecutor &executor, const Request &request, std::string &server_timing)
+        {
+            if (!connected)
+            {
+                boost::asio::ip::tcp::resolver resolver(io_service);
+                boost::asio::connect(socket,
+                                     resolver.resolve(boost::asio::ip::tcp::resolver::query(
+                                         executor.backend.host, executor.backend.port)));
+                socket.set_option(boost::asio::ip::tcp::no_delay(true));
+                connected = true;
+            }
+
+            std::string message = (request.body.empty() ? "GET " : "POST ") + executor.prefix +
+                                  request.target + " HTTP/1.1\r\nHost: " + executor.backend.host +
+                                  "\r\nConnection: keep-alive\r\n";
+            if (!request.body.empty())
+            {
+                message += std::string("Content-Type: ") +
+                           (request.body.front() == '{' ? "application/json" : "text/plain") +
+                           "\r\nContent-Length: " + std::to_string(request.body.size()) +
+                           "\r\n";
+            }
+            message += "\r\n" + request.body;
+            boost::asio::write(socket, boost::asio::buffer(message));
+
+            const auto header_size = boost::asio::read_until(socket, buffer, "\r\n\r\n");
+            std::string header(boost::asio::buffers_begin(buffer.data()),
+                               boost::asio::buffers_begin(buffer.data()) + header_size);
+            buffer.consume(header_size);
+
+            std::istringstream lines(header);
+            std::string line;
+            std::getline(lines, line);
+            unsigned status = 0;
+            std::istringstream(line.substr(std::min<std::size_t>(line.size(), 9))) >> status;
+
+            std::size_t content_length = std::string::npos;
+            bool close = false;
+            while (std::getline(lines, line))
+            {
+                const auto colon = line.find(':');
+                if (colon == std::string::npos)
+                    continue;
+                const auto name = boost::to_lower_copy(line.substr(0, colon));
+                const auto value = boost::trim_copy(line.substr(colon + 1));
+                if (name == "content-length")
+                    content_length = std::stoul(value);
+                else if (name == "connection")
+                    close = boost::iequals(value, "close");
+                else if (name == "server-timing")
+                    server_timing = value;
+            }
+
+            // the body is discarded, without a length it ends with the connection
+            boost::system::error_code error;
+            if (content_length == std::string::npos)
+            {
+                boost::asio::read(socket, buffer, boost::asio::transfer_all(), error);
+                close = true;
+            }
+            else if (buffer.size() < content_length)
+            {
+                boost::asio::read(
+                    socket, buffer, boost::asio::transfer_exactly(content_length - buffer.size()));
+            }
+            buffer.consume(std::min(buffer.size(), content_length));
+
+            if (close)
+                Close();
+            return status;
+        }
+
+      private:
+        boost::asio::io_service io_service;
+        boost::asio::ip::tcp::socket socket;
+        boost::asio::streambuf buffer;
+        bool connected = false;
+    };
+
+    // Reads a header like "parse;dur=0.012, snap;dur=0.087, total;dur=1.234"
+    static void parseServerTiming(const std::string &value, Sample &sample)
+    {
+        std::istringstream entries(value);
+        std::string entry;
+        while (std::getline(entries, entry, ','))
+        {
+            boost::trim(entry);
+            const auto separator = entry.find(";dur=");
+            if (separator == std::string::npos)
+                continue;
+            const auto name = entry.substr(0, separator);
+            for (std::size_t index = 0; index < util::NUM_REQUEST_STAGES; ++index)
+            {
+                if (name == util::ToString(static_cast<util::RequestStage>(index)))
+                {
+                    sample.measured[index] = true;
+                    sample.stages[index] = std::stod(entry.substr(separator + 5));
+                }
+            }
+        }
+    }
+
+    server::Backend backend;
+    std::string prefix;
+};
+
+double percentile(const std::vector<double> &sorted, const double fraction)
+{
+    if (sorted.empty())
+        return 0;
+    const auto index = static_cast<std::size_t>(fraction * sorted.size());
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void printLatencies(const std::string &name, std::vector<double> latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "  " << std::setw(10) << std::left << name << std::right << std::fixed
+              << std::setprecision(3);
+    for (const auto fraction : {0.5, 0.9, 0.99, 0.999})
+    {
+        std::cout << std::setw(11) << percentile(latencies, fraction);
+    }
+    std::cout << std::setw(11) << (latencies.empty() ? 0. : latencies.back()) << std::endl;
+}
+
+// Throughput, latency percentiles and the percentiles of each stage per service
+void report(const std::vector<Request> &requests,
+            const std::vector<Sample> &samples,
+            const double seconds)
+{
+    std::map<std::string, std::vector<const Sample *>> services;
+    for (const auto &sample : samples)
+    {
+        services[requests[sample.request].service].push_back(&sample);
+        services["all"].push_back(&sample);
+    }
+
+    for (const auto &service : services)
+    {
+        const auto &service_samples = service.second;
+        const auto errors = std::count_if(service_samples.begin(),
+                                          service_samples.end(),
+                                          [](const Sample *sample) { return !sample->ok; });
+        std::cout << service.first << ": " << service_samples.size() << " requests, " << errors
+                  << " failed, " << std::fixed << std::setprecision(1)
+                  << service_samples.size() / seconds << " requests/s" << std::endl;
+        std::cout << "  ms        " << std::setw(11) << "p50" << std::setw(11) << "p90"
+                  << std::setw(11) << "p99" << std::setw(11) << "p99.9" << std::setw(11)
+                  << "max" << std::endl;
+
+        std::vector<double> latencies;
+        for (const auto *sample : service_samples)
+            latencies.push_back(sample->latency);
+        printLatencies("latency", std::move(latencies));
+
+        for (std::size_t index = 0; index < util::NUM_REQUEST_STAGES; ++index)
+        {
+            std::vector<double> durations;
+            for (const auto *sample : service_samples)
+            {
+                if (sample->measured[index])
+                    durations.push_back(sample->stages[index]);
+            }
+            if (!durations.empty())
+            {
+                printLatencies(util::ToString(static_cast<util::RequestStage>(index)),
+                               std::move(durations));
+            }
+        }
+    }
+}
+
+EngineConfig::Algorithm stringToAlgorithm(std::string algorithm)
+{
+    boost::to_lower(algorithm);
+
+    if (algorithm == "ch")
+        return EngineConfig::Algorithm::CH;
+    if (algorithm == "corech")
+        return EngineConfig::Algorithm::CoreCH;
+    if (algorithm == "mld")
+        return EngineConfig::Algorithm::MLD;
+    if (algorithm == "cch")
+        return EngineConfig::Algorithm::CCH;
+    throw util::RuntimeError(algorithm, ErrorCode::UnknownAlgorithm, SOURCE_REF);
+}
+
+return_code parseArguments(int argc, char *argv[], ReplayConfig &config)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("dataset,d",
+         boost::program_options::value<boost::filesystem::path>(&config.dataset_path),
+         "Replay against an engine in this process that loads the .osrm dataset")
+        //
+        ("algorithm,a",
+         boost::program_options::value<std::string>(&config.algorithm)
+             ->default_value(config.algorithm),
+         "Algorithm of the dataset: CH, CoreCH, MLD or CCH")
+        //
+        ("shared-memory,s",
+         boost::program_options::bool_switch(&config.shared_memory)->default_value(false),
+         "Use the dataset osrm-datastore loaded into shared memory instead of --dataset")
+        //
+        ("mmap,m",
+         boost::program_options::bool_switch(&config.mmap)->default_value(false),
+         "Map the dataset files into memory instead of loading them")
+        //
+        ("url,u",
+         boost::program_options::value<std::string>(&config.url),
+         "Replay against the osrm-routed at this URL, e.g. http://localhost:5000")
+        //
+        ("concurrency,c",
+         boost::program_options::value<unsigned>(&config.concurrency)
+             ->default_value(config.concurrency),
+         "Number of requests in flight at once")
+        //
+        ("rate,r",
+         boost::program_options::value<double>(&config.rate)->default_value(config.rate),
+         "Requests per second started on schedule, 0 replays as fast as possible. Latencies "
+         "count from the scheduled start, so they include the wait of requests that fall "
+         "behind")
+        //
+        ("repeat",
+         boost::program_options::value<unsigned>(&config.repeat)->default_value(config.repeat),
+         "Number of times the log is replayed")
+        //
+        ("warmup",
+         boost::program_options::value<std::size_t>(&config.warmup)
+             ->default_value(config.warmup),
+         "Number of requests replayed first that are not counted");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "log",
+        boost::program_options::value<boost::filesystem::path>(&config.log_path),
+        "Request log to replay");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("log", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() +
+        " <requests.log> (--dataset <data.osrm> | --shared-memory | --url <url>) [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    const auto targets = !config.dataset_path.empty() + config.shared_memory + !config.url.empty();
+    if (config.log_path.empty() || targets != 1)
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    if (config.concurrency == 0 || config.repeat == 0 || config.rate < 0)
+    {
+        util::Log(logERROR) << "Concurrency and repeat must be 1 or larger, the rate positive";
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    ReplayConfig config;
+
+    const auto result = parseArguments(argc, argv, config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    const auto requests = readLog(config.log_path);
+    if (requests.empty())
+    {
+        util::Log(logERROR) << "No requests in " << config.log_path.string();
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<Executor> executor;
+    if (config.url.empty())
+    {
+        EngineConfig engine_config;
+        if (!config.shared_memory)
+            engine_config.storage_config = {config.dataset_path};
+        engine_config.use_shared_memory = config.shared_memory;
+        engine_config.use_mmap = config.mmap;
+        engine_config.algorithm = stringToAlgorithm(config.algorithm);
+        if (!engine_config.IsValid())
+        {
+            util::Log(logERROR) << "Required files are missing, cannot continue";
+            return EXIT_FAILURE;
+        }
+        executor = std::make_unique<EngineExecutor>(engine_config);
+    }
+    else
+    {
+        executor = std::make_unique<HTTPExecutor>(config.url);
+    }
+
+    const auto total = requests.size() * config.repeat + config.warmup;
+    util::Log() << "Replaying " << total << " requests with " << config.concurrency
+                << " in flight"
+                << (config.rate > 0 ? " at " + std::to_string(config.rate) + " requests/s" : "");
+
+    // every thread takes the next request, with a rate it waits until the request is due
+    std::atomic<std::size_t> next_request{0};
+    std::mutex samples_lock;
+    std::vector<Sample> samples;
+    samples.reserve(total - config.warmup);
+    const auto replay_start = Clock::now();
+    Clock::time_point measure_start = replay_start;
+    std::atomic<std::size_t> warmed_up{0};
+
+    const auto work = [&] {
+        std::vector<Sample> thread_samples;
+        for (auto index = next_request++; index < total; index = next_request++)
+        {
+            auto start = Clock::now();
+            if (config.rate > 0)
+            {
+                const auto due =
+                    replay_start + std::chrono::duration_cast<Clock::duration>(
+                                       std::chrono::duration<double>(index / config.rate));
+                std::this_thread::sleep_until(due);
+                start = due;
+            }
+
+            Sample sample;
+            sample.request = index % requests.size();
+            executor->Run(requests[sample.request], sample);
+            sample.latency = Milliseconds(Clock::now() - start).count();
+
+            if (index >= config.warmup)
+            {
+                thread_samples.push_back(sample);
+            }
+            else if (++warmed_up == config.warmup)
+            {
+                std::lock_guard<std::mutex> guard(samples_lock);
+                measure_start = Clock::now();
+            }
+        }
+        std::lock_guard<std::mutex> guard(samples_lock);
+        samples.insert(samples.end(), thread_samples.begin(), thread_samples.end());
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned thread = 1; thread < config.concurrency; ++thread)
+        threads.emplace_back(work);
+    work();
+    for (auto &thread : threads)
+        thread.join();
+
+    const auto seconds = std::chrono::duration<double>(Clock::now() - measure_start).count();
+    report(requests, samples, seconds);
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
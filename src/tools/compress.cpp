@@ -0,0 +1,212 @@
+#include "osrm/exception.hpp"
+#include "util/compressed_file.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct CompressConfig
+{
+    std::vector<boost::filesystem::path> paths;
+    util::CompressionCodec codec = util::IsCodecAvailable(util::CompressionCodec::Zstd)
+                                       ? util::CompressionCodec::Zstd
+                                       : util::CompressionCodec::Zlib;
+    int level = 3;
+    std::size_t frame_size = util::DEFAULT_COMPRESSION_FRAME_SIZE / 1024;
+    bool decompress = false;
+};
+
+// Files that are mapped into memory directly and have to stay uncompressed
+bool isMappedDirectly(const boost::filesystem::path &path)
+{
+    const auto extension = path.extension().string();
+    return extension == ".fileIndex" || extension == ".turn_penalties_index";
+}
+
+return_code parseArguments(int argc, char *argv[], CompressConfig &config)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    std::string codec = config.codec == util::CompressionCodec::Zstd ? "zstd" : "zlib";
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("codec",
+         boost::program_options::value<std::string>(&codec)->default_value(codec),
+         "Compression codec: zstd (if this build supports it) or zlib")
+        //
+        ("level",
+         boost::program_options::value<int>(&config.level)->default_value(config.level),
+         "Compression level of the codec, higher levels compress better but slower")
+        //
+        ("frame-size",
+         boost::program_options::value<std::size_t>(&config.frame_size)
+             ->default_value(config.frame_size),
+         "Uncompressed size of the independently compressed frames in KiB")
+        //
+        ("decompress,d",
+         boost::program_options::bool_switch(&config.decompress)->default_value(false),
+         "Restore the uncompressed files");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<std::vector<boost::filesystem::path>>(&config.paths),
+        "Files to compress in place");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", -1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() +
+        " <data.osrm.hsgr> [<data.osrm.ebg> ...] [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help") || config.paths.empty())
+    {
+        std::cout << visible_options;
+        return config.paths.empty() ? return_code::fail : return_code::exit;
+    }
+
+    config.codec = util::StringToCompressionCodec(codec);
+    if (!util::IsCodecAvailable(config.codec))
+    {
+        util::Log(logERROR) << "This build does not support the " << codec << " codec";
+        return return_code::fail;
+    }
+
+    if (config.frame_size == 0 || config.frame_size > 1024 * 1024)
+    {
+        util::Log(logERROR) << "The frame size must be between 1 KiB and 1 GiB";
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    CompressConfig config;
+
+    const auto result = parseArguments(argc, argv, config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    for (const auto &path : config.paths)
+    {
+        if (!boost::filesystem::is_regular_file(path))
+        {
+            util::Log(logERROR) << "Input file " << path << " not found!";
+            return EXIT_FAILURE;
+        }
+        if (isMappedDirectly(path))
+        {
+            util::Log(logWARNING) << "Skipping " << path.string()
+                                  << ", it is mapped into memory and can not be compressed";
+            continue;
+        }
+        if (util::IsCompressedFile(path) != config.decompress)
+        {
+            util::Log() << "Skipping " << path.string() << ", it is "
+                        << (config.decompress ? "not" : "already") << " compressed";
+            continue;
+        }
+
+        // the file is only replaced once the converted one is complete
+        auto temporary_path = path;
+        temporary_path += ".tmp";
+
+        TIMER_START(convert);
+        if (config.decompress)
+        {
+            util::DecompressFile(path, temporary_path);
+        }
+        else
+        {
+            util::CompressFile(
+                path, temporary_path, config.codec, config.level, config.frame_size * 1024);
+        }
+        TIMER_STOP(convert);
+
+        const auto original_size = boost::filesystem::file_size(path);
+        const auto converted_size = boost::filesystem::file_size(temporary_path);
+        boost::filesystem::rename(temporary_path, path);
+
+        util::Log() << (config.decompress ? "Decompressed " : "Compressed ") << path.string()
+                    << " from " << original_size << " to " << converted_size << " bytes in "
+                    << TIMER_SEC(convert) << " seconds";
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
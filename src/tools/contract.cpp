@@ -2,10 +2,12 @@
 #include "osrm/contractor.hpp"
 #include "osrm/contractor_config.hpp"
 #include "osrm/exception.hpp"
+#include "util/exception.hpp"
 #include "util/log.hpp"
 #include "util/timezones.hpp"
 #include "util/version.hpp"
 
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 #include <boost/program_options/errors.hpp>
@@ -16,8 +18,10 @@
 #include <exception>
 #include <new>
 #include <ostream>
+#include <string>
 
 #include "util/meminfo.hpp"
+#include "util/perf_report.hpp"
 
 using namespace osrm;
 
@@ -28,13 +32,33 @@ enum class return_code : unsigned
     exit
 };
 
-return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig &contractor_config)
+static contractor::WitnessHeapStorage stringToWitnessHeapStorage(std::string storage)
+{
+    boost::to_lower(storage);
+
+    if (storage == "hash")
+        return contractor::WitnessHeapStorage::Hash;
+    if (storage == "array")
+        return contractor::WitnessHeapStorage::Array;
+    if (storage == "paged")
+        return contractor::WitnessHeapStorage::Paged;
+    throw util::exception("Unknown witness heap storage " + storage + SOURCE_REF);
+}
+
+return_code parseArguments(int argc,
+                           char *argv[],
+                           contractor::ContractorConfig &contractor_config,
+                           std::string &perf_report_path)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
-    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
+        "perf-report",
+        boost::program_options::value<std::string>(&perf_report_path),
+        "Write the wall time, CPU time, peak memory and I/O of each stage as JSON to this file");
 
     // declare a group of options that will be allowed on command line
+    std::string witness_heap_storage;
     boost::program_options::options_description config_options("Configuration");
     config_options.add_options()(
         "threads,t",
@@ -44,20 +68,95 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         "core,k",
         boost::program_options::value<double>(&contractor_config.core_factor)->default_value(1.0),
         "Percentage of the graph (in vertices) to contract [0..1]")(
+        "debug-timings",
+        boost::program_options::bool_switch(&contractor_config.debug_timings)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Log the time spent in the phases of every contraction round")(
+        "renumber-nodes",
+        boost::program_options::bool_switch(&contractor_config.renumber_nodes)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Renumber the nodes by their level and the hierarchy for faster queries, this rewrites the "
+        "edge-expanded graph, its node data and the spatial index")(
+        "landmarks",
+        boost::program_options::value<unsigned>(&contractor_config.landmarks)->default_value(0),
+        "Number of landmarks that direct the searches in the core of CoreCH towards their "
+        "target, 0 for none. Every landmark stores 4 bytes per edge-based node")(
+        "compress-search-graph",
+        boost::program_options::bool_switch(&contractor_config.compress_search_graph)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store a compressed copy of the edges the CH searches read in .osrm.hsgr.compressed, "
+        "best combined with --renumber-nodes")(
+        "hub-labels",
+        boost::program_options::bool_switch(&contractor_config.hub_labels)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store the hub labels of the hierarchy in .osrm.hsgr.labels to answer durations-only "
+        "tables without searches, at many times the memory of the hierarchy")(
+        "partitioned",
+        boost::program_options::bool_switch(&contractor_config.partitioned)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Contract the cells of the .partition file written by osrm-partition one at a time to "
+        "use less memory, the edges of contracted nodes are kept on disk")(
+        "partition-level",
+        boost::program_options::value<unsigned>(&contractor_config.partition_level)
+            ->default_value(0),
+        "Use with `--partitioned`. Level of the partition whose cells are contracted one at a "
+        "time, 0 for the highest level")(
+        "witness-heap-storage",
+        boost::program_options::value<std::string>(&witness_heap_storage)
+            ->default_value("hash"),
+        "Index of the witness search heaps: hash, array (one entry per node and thread) or paged")(
+        "witness-node-limit",
+        boost::program_options::value<int>(
+            &contractor_config.witness_search.contraction_node_limit)
+            ->default_value(2000),
+        "Maximum number of nodes settled by a witness search when contracting a node")(
+        "witness-simulation-node-limit",
+        boost::program_options::value<int>(
+            &contractor_config.witness_search.simulation_node_limit)
+            ->default_value(1000),
+        "Maximum number of nodes settled by a witness search when simulating a contraction")(
+        "witness-hop-limit",
+        boost::program_options::value<unsigned>(&contractor_config.witness_search.hop_limit)
+            ->default_value(0),
+        "Maximum number of edges of a witness path, 0 for no limit. Lower limits contract "
+        "faster but add shortcuts")(
         "segment-speed-file",
         boost::program_options::value<std::vector<std::string>>(
             &contractor_config.updater_config.segment_speed_lookup_paths)
             ->composing(),
         "Lookup files containing nodeA, nodeB, speed data to adjust edge weights")(
+        "way-speed-file",
+        boost::program_options::value<std::vector<std::string>>(
+            &contractor_config.updater_config.way_speed_lookup_paths)
+            ->composing(),
+        "Binary files with speeds of OSM ways or ranges of their segments to adjust edge "
+        "weights, needs the .osrm.way_index of osrm-extract --way-index")(
         "turn-penalty-file",
         boost::program_options::value<std::vector<std::string>>(
             &contractor_config.updater_config.turn_penalty_lookup_paths)
             ->composing(),
         "Lookup files containing from_, to_, via_nodes, and turn penalties to adjust turn weights")(
+        "cache-lookup-files",
+        boost::program_options::bool_switch(&contractor_config.updater_config.cache_lookup_files)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store a binary copy next to each lookup file, read instead of the file while it is "
+        "unchanged")(
         "level-cache,o",
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
         "Use .level file to retain the contaction level for each node from the last run.")(
+        "metric-update",
+        boost::program_options::bool_switch(&contractor_config.metric_update)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Keep the node order and the shortcuts of the existing .hsgr file and only update the "
+        "weights. Shortcuts needed for the new weights are still found by witness searches.")(
         "edge-weight-updates-over-factor",
         boost::program_options::value<double>(
             &contractor_config.updater_config.log_edge_updates_factor)
@@ -126,6 +225,16 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
 
     boost::program_options::notify(option_variables);
 
+    try
+    {
+        contractor_config.witness_search.storage = stringToWitnessHeapStorage(witness_heap_storage);
+    }
+    catch (const util::exception &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
     if (!option_variables.count("input"))
     {
         std::cout << visible_options;
@@ -141,7 +250,8 @@ int main(int argc, char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
     contractor::ContractorConfig contractor_config;
 
-    const return_code result = parseArguments(argc, argv, contractor_config);
+    std::string perf_report_path;
+    const return_code result = parseArguments(argc, argv, contractor_config, perf_report_path);
 
     if (return_code::fail == result)
     {
@@ -185,6 +295,11 @@ int main(int argc, char *argv[]) try
 
     util::DumpSTXXLStats();
     util::DumpMemoryStats();
+    if (!perf_report_path.empty())
+    {
+        util::PerfReport::GetInstance().Write(
+            perf_report_path, "osrm-contract", contractor_config.requested_num_threads);
+    }
 
     return EXIT_SUCCESS;
 }
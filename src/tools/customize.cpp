@@ -1,16 +1,25 @@
 #include "customizer/customizer.hpp"
+#include "customizer/time_buckets.hpp"
 
 #include "osrm/exception.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 #include "util/meminfo.hpp"
+#include "util/perf_report.hpp"
 #include "util/version.hpp"
 
 #include <tbb/task_scheduler_init.h>
 
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
+#include <string>
+#include <vector>
 
 using namespace osrm;
 
@@ -21,12 +30,21 @@ enum class return_code : unsigned
     exit
 };
 
-return_code
-parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customization_config)
+return_code parseArguments(int argc,
+                           char *argv[],
+                           customizer::CustomizationConfig &customization_config,
+                           std::string &perf_report_path)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
-    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
+        "perf-report",
+        boost::program_options::value<std::string>(&perf_report_path),
+        "Write the wall time, CPU time, peak memory and I/O of each stage as JSON to this file");
+
+    std::vector<std::string> metric_specs;
+    std::vector<std::string> speed_profile_paths;
+    unsigned time_buckets = 96;
 
     // declare a group of options that will be allowed both on command line
     boost::program_options::options_description config_options("Configuration");
@@ -41,12 +59,24 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
                 &customization_config.updater_config.segment_speed_lookup_paths)
                 ->composing(),
             "Lookup files containing nodeA, nodeB, speed data to adjust edge weights")(
+            "way-speed-file",
+            boost::program_options::value<std::vector<std::string>>(
+                &customization_config.updater_config.way_speed_lookup_paths)
+                ->composing(),
+            "Binary files with speeds of OSM ways or ranges of their segments to adjust edge "
+            "weights, needs the .osrm.way_index of osrm-extract --way-index")(
             "turn-penalty-file",
             boost::program_options::value<std::vector<std::string>>(
                 &customization_config.updater_config.turn_penalty_lookup_paths)
                 ->composing(),
             "Lookup files containing from_, to_, via_nodes, and turn penalties to adjust turn "
-            "weights")("edge-weight-updates-over-factor",
+            "weights")("cache-lookup-files",
+                       boost::program_options::bool_switch(
+                           &customization_config.updater_config.cache_lookup_files)
+                           ->implicit_value(true)
+                           ->default_value(false),
+                       "Store a binary copy next to each lookup file, read instead of the file "
+                       "while it is unchanged")("edge-weight-updates-over-factor",
                        boost::program_options::value<double>(
                            &customization_config.updater_config.log_edge_updates_factor)
                            ->default_value(0.0),
@@ -65,7 +95,58 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
                 &customization_config.updater_config.tz_file_path)
                 ->default_value(""),
             "Required for conditional turn restriction parsing, provide a geojson file containing "
-            "time zone boundaries");
+            "time zone boundaries")(
+            "conditional-turns-at-query-time",
+            boost::program_options::bool_switch(
+                &customization_config.updater_config.conditional_turns_at_query_time)
+                ->implicit_value(true)
+                ->default_value(false),
+            "Store the time slots of the week conditional turn restrictions apply in instead of "
+            "applying them to the weights, MLD route requests with depart_at check them at their "
+            "departure time. Dates are taken from the week of --parse-conditionals-from-now, or "
+            "of the current time without it")(
+            "metric",
+            boost::program_options::value<std::vector<std::string>>(&metric_specs)->composing(),
+            "Additional metric in the form name=file[,file...], customized from the given "
+            "segment speed files and selectable per request with metric=name")(
+            "speed-profile-file",
+            boost::program_options::value<std::vector<std::string>>(&speed_profile_paths)
+                ->composing(),
+            "Lookup files containing nodeA, nodeB, minute:speed[,minute:speed...] with the "
+            "breakpoints of periodic speed profiles over a day. A metric is customized for each "
+            "time bucket, requests select it with depart_at")(
+            "time-buckets",
+            boost::program_options::value<unsigned>(&time_buckets)->default_value(96),
+            "Use with `--speed-profile-file`. Number of time buckets a day is split into, each "
+            "one adds a metric to the cells and the graph")(
+            "incremental",
+            boost::program_options::bool_switch(&customization_config.incremental)
+                ->implicit_value(true)
+                ->default_value(false),
+            "Only customize the cells whose edges changed since the last customization of the "
+            "same partition")("cch",
+                              boost::program_options::bool_switch(&customization_config.cch)
+                                  ->implicit_value(true)
+                                  ->default_value(false),
+                              "Also customize the default metric into a contraction hierarchy "
+                              "for the CCH algorithm, ordered by the partition")(
+            "overlay-hierarchy",
+            boost::program_options::bool_switch(&customization_config.overlay_hierarchy)
+                ->implicit_value(true)
+                ->default_value(false),
+            "Also contract the top level cells of the default metric into a hierarchy, so MLD "
+            "queries between top level cells only search the cells of their ends locally")(
+            "landmarks",
+            boost::program_options::value<unsigned>(&customization_config.landmarks)
+                ->default_value(0),
+            "Number of landmarks of the default metric that direct MLD queries towards their "
+            "target, 0 for none. Every landmark stores 4 bytes per edge-based node")(
+            "distance-oracle-level",
+            boost::program_options::value<unsigned>(&customization_config.distance_oracle_level)
+                ->default_value(0),
+            "Level of the cells of a distance oracle of the durations for approximate tables, 0 "
+            "for none. Stores 12 bytes per edge-based node and 4 bytes per pair of cells, every "
+            "cell costs a search over the whole graph");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
@@ -124,6 +205,57 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
         return return_code::fail;
     }
 
+    for (const auto &spec : metric_specs)
+    {
+        const auto separator = spec.find('=');
+        customizer::MetricConfig metric;
+        if (separator != std::string::npos)
+        {
+            metric.name = spec.substr(0, separator);
+            const auto paths = spec.substr(separator + 1);
+            boost::split(metric.segment_speed_lookup_paths, paths, boost::is_any_of(","));
+        }
+
+        const auto has_empty_path = std::any_of(metric.segment_speed_lookup_paths.begin(),
+                                                metric.segment_speed_lookup_paths.end(),
+                                                [](const auto &path) { return path.empty(); });
+        // metric names need to be usable as a request parameter
+        const auto valid_name =
+            !metric.name.empty() && !customizer::timeBucketMinute(metric.name) &&
+            std::all_of(metric.name.begin(), metric.name.end(), [](const char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-';
+            });
+        if (!valid_name || metric.segment_speed_lookup_paths.empty() || has_empty_path)
+        {
+            util::Log(logERROR) << "Invalid metric " << spec << ", expected name=file[,file...] "
+                                << "with a name of letters, digits, '_' and '-' that is not "
+                                << "the name of a time bucket";
+            return return_code::fail;
+        }
+        customization_config.metrics.push_back(std::move(metric));
+    }
+
+    if (!speed_profile_paths.empty())
+    {
+        if (time_buckets == 0 || customizer::MINUTES_PER_DAY % time_buckets != 0)
+        {
+            util::Log(logERROR) << "Invalid number of time buckets " << time_buckets
+                                << ", a day needs to be split into buckets of whole minutes";
+            return return_code::fail;
+        }
+
+        // the profiles are evaluated in the middle of each bucket
+        const auto bucket_minutes = customizer::MINUTES_PER_DAY / time_buckets;
+        for (const auto bucket : util::irange(0u, time_buckets))
+        {
+            customizer::MetricConfig metric;
+            metric.name = customizer::timeBucketMetricName(bucket * bucket_minutes);
+            metric.speed_profile_lookup_paths = speed_profile_paths;
+            metric.profile_minute = bucket * bucket_minutes + bucket_minutes / 2;
+            customization_config.metrics.push_back(std::move(metric));
+        }
+    }
+
     return return_code::ok;
 }
 
@@ -132,7 +264,8 @@ int main(int argc, char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
     customizer::CustomizationConfig customization_config;
 
-    const auto result = parseArguments(argc, argv, customization_config);
+    std::string perf_report_path;
+    const auto result = parseArguments(argc, argv, customization_config, perf_report_path);
 
     if (return_code::fail == result)
     {
@@ -165,6 +298,11 @@ int main(int argc, char *argv[]) try
     auto exitcode = customizer::Customizer().Run(customization_config);
 
     util::DumpMemoryStats();
+    if (!perf_report_path.empty())
+    {
+        util::PerfReport::GetInstance().Write(
+            perf_report_path, "osrm-customize", customization_config.requested_num_threads);
+    }
 
     return exitcode;
 }
@@ -1,10 +1,15 @@
 #include "tools/extract-conditionals.hpp"
 
 #include "util/exception.hpp"
+#include "util/integer_range.hpp"
 #include "util/opening_hours.hpp"
 #include "util/timezones.hpp"
 #include "util/version.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <unordered_map>
@@ -159,6 +164,66 @@ void ParseCheckCommandArguments(const char *executable,
     po::notify(vm);
 }
 
+enum class ConditionState : std::uint8_t
+{
+    Inactive,
+    Active,
+    Invalid
+};
+
+// Checks the conditions of all items at their local time in parallel. Every distinct condition
+// is parsed once, the local times of the time zones were computed when the R-tree was loaded
+// and the lookups only read it.
+template <typename Item, typename GetCondition, typename GetLocalTime>
+std::vector<ConditionState> CheckConditions(const std::vector<Item> &items,
+                                            GetCondition get_condition,
+                                            const GetLocalTime &get_local_time)
+{
+    std::vector<std::string> conditions;
+    std::vector<std::size_t> item_conditions(items.size());
+    {
+        std::unordered_map<std::string, std::size_t> condition_ids;
+        for (const auto index : osrm::util::irange<std::size_t>(0, items.size()))
+        {
+            const auto &condition = get_condition(items[index]);
+            const auto inserted = condition_ids.insert({condition, conditions.size()});
+            if (inserted.second)
+                conditions.push_back(condition);
+            item_conditions[index] = inserted.first->second;
+        }
+    }
+
+    std::vector<std::vector<osrm::util::OpeningHours>> opening_hours(conditions.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, conditions.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (const auto index : osrm::util::irange(range.begin(), range.end()))
+                              opening_hours[index] =
+                                  osrm::util::ParseOpeningHours(conditions[index]);
+                      });
+
+    std::vector<ConditionState> states(items.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, items.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (const auto index : osrm::util::irange(range.begin(), range.end()))
+                          {
+                              const auto &hours = opening_hours[item_conditions[index]];
+                              if (hours.empty())
+                              {
+                                  states[index] = ConditionState::Invalid;
+                                  continue;
+                              }
+
+                              const auto &location = items[index].location;
+                              const auto &local_time =
+                                  get_local_time(point_t{location.lon(), location.lat()});
+                              states[index] = osrm::util::CheckOpeningHours(hours, local_time)
+                                                  ? ConditionState::Active
+                                                  : ConditionState::Inactive;
+                          }
+                      });
+    return states;
+}
+
 // clang-format off
 BOOST_FUSION_ADAPT_ADT(LocatedConditionalRestriction,
   (osmium::object_id_type, osmium::object_id_type, obj.restriction.from, obj.restriction.from = val)
@@ -340,24 +405,26 @@ int RestrictionsCheckCommand(const char *executable, const std::vector<std::stri
     }
     std::ostream output_stream(output_buffer);
 
-    // For each conditional restriction if condition is active than print a line
-    for (auto &value : conditional_restrictions)
-    {
-        const auto &location = value.location;
-        const auto &restriction = value.restriction;
-
-        // Get local time of the restriction
-        const auto &local_time = get_local_time(point_t{location.lon(), location.lat()});
+    // TODO: check restriction type [:<transportation mode>][:<direction>]
+    // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Tagging
 
-        // TODO: check restriction type [:<transportation mode>][:<direction>]
-        // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Tagging
+    // TODO: parsing will fail for combined conditions, e.g. Sa-Su AND weight>7
+    // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Combined_conditions:_AND
 
-        // TODO: parsing will fail for combined conditions, e.g. Sa-Su AND weight>7
-        // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Combined_conditions:_AND
+    const auto states = CheckConditions(
+        conditional_restrictions,
+        [](const LocatedConditionalRestriction &value) -> const std::string & {
+            return value.restriction.condition;
+        },
+        get_local_time);
 
-        const auto &opening_hours = osrm::util::ParseOpeningHours(restriction.condition);
+    // For each conditional restriction if condition is active than print a line, in the order
+    // of the input
+    for (const auto index : osrm::util::irange<std::size_t>(0, conditional_restrictions.size()))
+    {
+        const auto &restriction = conditional_restrictions[index].restriction;
 
-        if (opening_hours.empty())
+        if (states[index] == ConditionState::Invalid)
         {
             osrm::util::Log(logWARNING)
                 << "Condition parsing failed for \"" << restriction.condition << "\" at the turn "
@@ -365,7 +432,7 @@ int RestrictionsCheckCommand(const char *executable, const std::vector<std::stri
             continue;
         }
 
-        if (osrm::util::CheckOpeningHours(opening_hours, local_time))
+        if (states[index] == ConditionState::Active)
         {
             output_stream << restriction.from << "," << restriction.via << "," << restriction.to
                           << "," << restriction_value << "\n";
@@ -435,24 +502,26 @@ int SpeedLimitsCheckCommand(const char *executable, const std::vector<std::strin
     }
     std::ostream output_stream(output_buffer);
 
-    // For each conditional restriction if condition is active than print a line
-    for (auto &value : speed_limits)
-    {
-        const auto &location = value.location;
-        const auto &speed_limit = value.speed_limit;
-
-        // Get local time of the restriction
-        const auto &local_time = get_local_time(point_t{location.lon(), location.lat()});
+    // TODO: check speed limit type [:<transportation mode>][:<direction>]
+    // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Tagging
 
-        // TODO: check speed limit type [:<transportation mode>][:<direction>]
-        // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Tagging
+    // TODO: parsing will fail for combined conditions, e.g. Sa-Su AND weight>7
+    // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Combined_conditions:_AND
 
-        // TODO: parsing will fail for combined conditions, e.g. Sa-Su AND weight>7
-        // http://wiki.openstreetmap.org/wiki/Conditional_restrictions#Combined_conditions:_AND
+    const auto states = CheckConditions(
+        speed_limits,
+        [](const LocatedConditionalSpeedLimit &value) -> const std::string & {
+            return value.speed_limit.condition;
+        },
+        get_local_time);
 
-        const auto &opening_hours = osrm::util::ParseOpeningHours(speed_limit.condition);
+    // For each conditional speed limit if condition is active than print a line, in the order
+    // of the input
+    for (const auto index : osrm::util::irange<std::size_t>(0, speed_limits.size()))
+    {
+        const auto &speed_limit = speed_limits[index].speed_limit;
 
-        if (opening_hours.empty())
+        if (states[index] == ConditionState::Invalid)
         {
             osrm::util::Log(logWARNING) << "Condition parsing failed for \""
                                         << speed_limit.condition << "\" on the segment "
@@ -460,7 +529,7 @@ int SpeedLimitsCheckCommand(const char *executable, const std::vector<std::strin
             continue;
         }
 
-        if (osrm::util::CheckOpeningHours(opening_hours, local_time))
+        if (states[index] == ConditionState::Active)
         {
             output_stream << speed_limit.from << "," << speed_limit.to << "," << speed_limit.value
                           << "\n";
@@ -1,19 +1,27 @@
 #include "osrm/exception.hpp"
 #include "osrm/extractor.hpp"
 #include "osrm/extractor_config.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
 #include "util/log.hpp"
 #include "util/version.hpp"
 
 #include <tbb/task_scheduler_init.h>
 
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <exception>
 #include <new>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "util/meminfo.hpp"
+#include "util/perf_report.hpp"
 
 using namespace osrm;
 
@@ -24,19 +32,43 @@ enum class return_code : unsigned
     exit
 };
 
-return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &extractor_config)
+static extractor::ExtractorConfig::NodeLocations stringToNodeLocations(std::string locations)
 {
+    boost::to_lower(locations);
+
+    if (locations == "sorted")
+        return extractor::ExtractorConfig::NodeLocations::Sorted;
+    if (locations == "dense")
+        return extractor::ExtractorConfig::NodeLocations::Dense;
+    if (locations == "sparse")
+        return extractor::ExtractorConfig::NodeLocations::Sparse;
+    throw util::exception("Unknown node location storage " + locations + SOURCE_REF);
+}
+
+return_code parseArguments(int argc,
+                           char *argv[],
+                           extractor::ExtractorConfig &extractor_config,
+                           std::vector<boost::filesystem::path> &profile_paths,
+                           std::string &perf_report_path)
+{
+    std::string node_locations;
+
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
-    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
+        "perf-report",
+        boost::program_options::value<std::string>(&perf_report_path),
+        "Write the wall time, CPU time, peak memory and I/O of each stage as JSON to this file");
 
     // declare a group of options that will be allowed both on command line
     boost::program_options::options_description config_options("Configuration");
     config_options.add_options()(
         "profile,p",
-        boost::program_options::value<boost::filesystem::path>(&extractor_config.profile_path)
-            ->default_value("profiles/car.lua"),
-        "Path to LUA routing profile")(
+        boost::program_options::value<std::vector<boost::filesystem::path>>(&profile_paths)
+            ->composing()
+            ->default_value({"profiles/car.lua"}, "profiles/car.lua"),
+        "Path to LUA routing profile. With several profiles the input is parsed once and a "
+        "dataset <input>.<profile name>.osrm is written for each one")(
         "threads,t",
         boost::program_options::value<unsigned int>(&extractor_config.requested_num_threads)
             ->default_value(tbb::task_scheduler_init::default_num_threads()),
@@ -56,7 +88,58 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
             ->implicit_value(true)
             ->default_value(false),
         "Save conditional restrictions found during extraction to disk for use "
-        "during contraction");
+        "during contraction")(
+        "resume",
+        boost::program_options::bool_switch(&extractor_config.resume)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Skip parsing if the files of an earlier run on the same input are complete")(
+        "apply-changes",
+        boost::program_options::value<std::vector<boost::filesystem::path>>(
+            &extractor_config.change_paths)
+            ->multitoken()
+            ->composing(),
+        "Apply OSM change files (.osc) to the input while parsing, in the given order")(
+        "routing-only",
+        boost::program_options::bool_switch(&extractor_config.routing_only)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Skip the guidance preprocessing, the dataset supports no steps=true requests")(
+        "two-pass-parsing",
+        boost::program_options::bool_switch(&extractor_config.two_pass_parsing)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Read the ways first and then only the nodes of routable ways, this reads the input "
+        "twice but skips the profile for all other nodes")(
+        "deduplicate-names",
+        boost::program_options::bool_switch(&extractor_config.deduplicate_names)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store repeated street names, refs, destinations and exits only once, this needs the "
+        "names in memory while writing them")(
+        "spatial-node-order",
+        boost::program_options::bool_switch(&extractor_config.spatial_node_order)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Number the nodes along a Hilbert curve through their coordinates instead of by their "
+        "OSM ids, so nearby intersections and their geometries are close in memory")(
+        "way-index",
+        boost::program_options::bool_switch(&extractor_config.way_index)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Write the nodes of every routable way by its OSM id to .osrm.way_index, so "
+        "osrm-contract and osrm-customize can apply --way-speed-file updates")(
+        "experimental-turn-cost-tables",
+        boost::program_options::bool_switch(&extractor_config.turn_cost_tables)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Also write the turn penalties of every intersection as a matrix of its entries and "
+        "exits to .osrm.turn_costs, for routing on the node-based graph")(
+        "node-locations",
+        boost::program_options::value<std::string>(&node_locations)->default_value("sorted"),
+        "Storage of the node coordinates while parsing. Can be sorted (external memory, sorted "
+        "with the edges), dense (array by OSM id, for planet-sized inputs) or sparse (sorted "
+        "pairs of id and coordinate, for extracts).");
 
     bool dummy;
     // hidden options, will be allowed on command line, but will not be
@@ -120,6 +203,8 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         return return_code::exit;
     }
 
+    extractor_config.node_locations = stringToNodeLocations(node_locations);
+
     return return_code::ok;
 }
 
@@ -127,8 +212,11 @@ int main(int argc, char *argv[]) try
 {
     util::LogPolicy::GetInstance().Unmute();
     extractor::ExtractorConfig extractor_config;
+    std::vector<boost::filesystem::path> profile_paths;
+    std::string perf_report_path;
 
-    const auto result = parseArguments(argc, argv, extractor_config);
+    const auto result =
+        parseArguments(argc, argv, extractor_config, profile_paths, perf_report_path);
 
     if (return_code::fail == result)
     {
@@ -140,8 +228,6 @@ int main(int argc, char *argv[]) try
         return EXIT_SUCCESS;
     }
 
-    extractor_config.UseDefaultOutputNames();
-
     if (1 > extractor_config.requested_num_threads)
     {
         util::Log(logERROR) << "Number of threads must be 1 or larger";
@@ -155,17 +241,51 @@ int main(int argc, char *argv[]) try
         return EXIT_FAILURE;
     }
 
-    if (!boost::filesystem::is_regular_file(extractor_config.profile_path))
+    for (const auto &profile_path : profile_paths)
     {
-        util::Log(logERROR) << "Profile " << extractor_config.profile_path.string()
-                            << " not found!";
-        return EXIT_FAILURE;
+        if (!boost::filesystem::is_regular_file(profile_path))
+        {
+            util::Log(logERROR) << "Profile " << profile_path.string() << " not found!";
+            return EXIT_FAILURE;
+        }
     }
 
-    osrm::extract(extractor_config);
+    if (profile_paths.size() == 1)
+    {
+        extractor_config.profile_path = profile_paths.front();
+        extractor_config.UseDefaultOutputNames();
+        osrm::extract(extractor_config);
+    }
+    else
+    {
+        // the datasets are named after the profiles
+        std::vector<extractor::ExtractorConfig> configs;
+        std::set<std::string> dataset_names;
+        for (const auto &profile_path : profile_paths)
+        {
+            const auto dataset_name = profile_path.stem().string();
+            if (!dataset_names.insert(dataset_name).second)
+            {
+                util::Log(logERROR) << "Several profiles are named " << dataset_name
+                                    << ", their datasets would overwrite each other";
+                return EXIT_FAILURE;
+            }
+            configs.push_back(extractor_config);
+            configs.back().profile_path = profile_path;
+            configs.back().UseDefaultOutputNames(dataset_name);
+        }
+        osrm::extract(configs);
+    }
 
     util::DumpSTXXLStats();
     util::DumpMemoryStats();
+    if (!perf_report_path.empty())
+    {
+        // the extractor doesn't use more threads than the machine has
+        const auto threads = std::min<unsigned>(tbb::task_scheduler_init::default_num_threads(),
+                                                extractor_config.requested_num_threads);
+        util::PerfReport::GetInstance().Write(perf_report_path, "osrm-extract", threads);
+    }
 
     return EXIT_SUCCESS;
 }
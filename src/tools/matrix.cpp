@@ -0,0 +1,557 @@
+#include "engine/api/binary_format.hpp"
+#include "engine/hint.hpp"
+#include "engine/routing_algorithms/one_to_all.hpp"
+#include "util/exception.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/nearest_parameters.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/storage_config.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/assert.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/program_options.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace osrm;
+
+/**
+ * osrm-matrix writes the table of all locations of a file to all of them as a binary file:
+ *
+ * | header      | MatrixHeader                                                            |
+ * | durations   | rows of float seconds, NaN if there is no route, if requested           |
+ * | distances   | rows of float meters, NaN if there is no route, if requested            |
+ *
+ * All values are little-endian, row i holds the entries from location i to all locations in
+ * the order of the file.
+ */
+namespace
+{
+
+const constexpr char MATRIX_MAGIC[8] = {'O', 'S', 'R', 'M', 'M', 'T', 'R', 'X'};
+const constexpr std::uint32_t MATRIX_VERSION = 1;
+const constexpr std::uint32_t MATRIX_DURATIONS = 0x01;
+const constexpr std::uint32_t MATRIX_DISTANCES = 0x02;
+
+struct MatrixHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t annotations;
+    std::uint64_t number_of_locations;
+};
+static_assert(sizeof(MatrixHeader) == 24,
+              "MatrixHeader is part of the format and must not be padded");
+
+// Bytes a table query holds per entry and table: the search result, the double of the binary
+// response and some slack for the distances the engine unpacks in double precision
+const constexpr std::size_t BYTES_PER_TABLE_ENTRY = 24;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct MatrixConfig
+{
+    EngineConfig engine_config;
+    boost::filesystem::path locations_path;
+    boost::filesystem::path output_path;
+    std::string algorithm = "CH";
+    std::string annotations = "duration";
+    std::uint32_t annotation_flags = MATRIX_DURATIONS;
+    std::size_t memory_budget = 1024;
+    bool sweep = false;
+    unsigned requested_num_threads = std::thread::hardware_concurrency();
+};
+
+return_code parseArguments(int argc, char *argv[], MatrixConfig &config)
+{
+    boost::filesystem::path base_path;
+
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("annotations",
+         boost::program_options::value<std::string>(&config.annotations)
+             ->default_value(config.annotations),
+         "Tables to write: duration, distance or duration,distance")
+        //
+        ("memory-budget",
+         boost::program_options::value<std::size_t>(&config.memory_budget)
+             ->default_value(config.memory_budget),
+         "MiB the table queries in flight may use, sets the number of destinations per tile")
+        //
+        ("sweep",
+         boost::program_options::value<bool>(&config.sweep)->implicit_value(true)->default_value(
+             false),
+         "Compute tiles of a few sources to all locations with one sweep each (CH, durations "
+         "only)")
+        //
+        ("threads,t",
+         boost::program_options::value<unsigned>(&config.requested_num_threads)
+             ->default_value(config.requested_num_threads),
+         "Number of threads to use")
+        //
+        ("shared-memory,s",
+         boost::program_options::value<bool>(&config.engine_config.use_shared_memory)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Load data from shared memory")
+        //
+        ("algorithm,a",
+         boost::program_options::value<std::string>(&config.algorithm)
+             ->default_value(config.algorithm),
+         "Algorithm to use for the data. Can be CH, CoreCH, MLD, CCH.");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<boost::filesystem::path>(&base_path),
+        "Input file in .osrm format")(
+        "locations,l",
+        boost::program_options::value<boost::filesystem::path>(&config.locations_path),
+        "File with a <lon>,<lat> location per line")(
+        "output,o",
+        boost::program_options::value<boost::filesystem::path>(&config.output_path),
+        "Matrix file to write");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1).add("locations", 1).add("output", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() +
+        " <input.osrm> <locations.csv> <output.matrix> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    try
+    {
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    // with shared memory the dataset can be left out, the locations are then the first argument
+    if (!option_variables.count("output") && config.engine_config.use_shared_memory &&
+        option_variables.count("locations"))
+    {
+        config.output_path = config.locations_path;
+        config.locations_path = base_path;
+        base_path.clear();
+    }
+    else if (!option_variables.count("output"))
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    if (!base_path.empty())
+    {
+        config.engine_config.storage_config = storage::StorageConfig(base_path);
+    }
+
+    std::vector<std::string> annotations;
+    boost::split(annotations, config.annotations, boost::is_any_of(","));
+    config.annotation_flags = 0;
+    for (const auto &annotation : annotations)
+    {
+        if (annotation == "duration")
+            config.annotation_flags |= MATRIX_DURATIONS;
+        else if (annotation == "distance")
+            config.annotation_flags |= MATRIX_DISTANCES;
+        else
+        {
+            util::Log(logERROR) << "Unknown annotation " << annotation;
+            return return_code::fail;
+        }
+    }
+
+    if (config.memory_budget == 0)
+    {
+        util::Log(logERROR) << "The memory budget must be 1 MiB or larger";
+        return return_code::fail;
+    }
+
+    if (config.requested_num_threads == 0)
+    {
+        util::Log(logERROR) << "Number of threads must be 1 or larger";
+        return return_code::fail;
+    }
+
+    boost::to_lower(config.algorithm);
+    if (config.algorithm == "ch")
+        config.engine_config.algorithm = EngineConfig::Algorithm::CH;
+    else if (config.algorithm == "corech")
+        config.engine_config.algorithm = EngineConfig::Algorithm::CoreCH;
+    else if (config.algorithm == "mld")
+        config.engine_config.algorithm = EngineConfig::Algorithm::MLD;
+    else if (config.algorithm == "cch")
+        config.engine_config.algorithm = EngineConfig::Algorithm::CCH;
+    else
+    {
+        util::Log(logERROR) << "Unknown algorithm " << config.algorithm;
+        return return_code::fail;
+    }
+
+    if (config.sweep &&
+        (config.annotation_flags != MATRIX_DURATIONS ||
+         config.engine_config.algorithm != EngineConfig::Algorithm::CH))
+    {
+        util::Log(logERROR) << "--sweep computes durations on CH datasets only";
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+// Locations of a file with a <lon>,<lat> pair per line, empty lines and lines starting with #
+// are skipped
+std::vector<util::Coordinate> readLocations(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream input(path);
+    if (!input)
+    {
+        throw util::exception("Could not open " + path.string());
+    }
+
+    std::vector<util::Coordinate> locations;
+    std::string line;
+    std::vector<std::string> values;
+    for (std::size_t line_number = 1; std::getline(input, line); ++line_number)
+    {
+        boost::trim(line);
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+
+        boost::split(values, line, boost::is_any_of(","));
+        try
+        {
+            if (values.size() != 2)
+            {
+                throw std::invalid_argument(line);
+            }
+            const util::Coordinate location{util::FloatLongitude{std::stod(values[0])},
+                                            util::FloatLatitude{std::stod(values[1])}};
+            if (!location.IsValid())
+            {
+                throw std::invalid_argument(line);
+            }
+            locations.push_back(location);
+        }
+        catch (const std::exception &)
+        {
+            throw util::exception(path.string() + ":" + std::to_string(line_number) +
+                                  " is not a valid <lon>,<lat> location");
+        }
+    }
+    return locations;
+}
+
+// Snaps every location once, the table queries only decode the hints
+std::vector<boost::optional<engine::Hint>>
+snapLocations(const OSRM &osrm, const std::vector<util::Coordinate> &locations)
+{
+    std::vector<boost::optional<engine::Hint>> hints(locations.size());
+    std::atomic<std::size_t> failed{0};
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, locations.size()),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            NearestParameters params;
+            params.coordinates.resize(1);
+            for (auto index = range.begin(); index != range.end(); ++index)
+            {
+                params.coordinates.front() = locations[index];
+                json::Object result;
+                if (osrm.Nearest(params, result) != Status::Ok)
+                {
+                    util::Log(logWARNING) << "Could not snap location " << index;
+                    failed++;
+                    continue;
+                }
+                const auto &waypoints = result.values["waypoints"].get<json::Array>();
+                const auto &waypoint = waypoints.values.front().get<json::Object>();
+                hints[index] = engine::Hint::FromBase64(
+                    waypoint.values.at("hint").get<json::String>().value);
+            }
+        });
+
+    if (failed > 0)
+    {
+        throw util::exception(std::to_string(failed.load()) + " of " +
+                              std::to_string(locations.size()) +
+                              " locations could not be snapped");
+    }
+    return hints;
+}
+
+// Copies the rows of a table of the binary response into the matrix from first_row and
+// first_column on
+void copyTable(const engine::api::binary::Value &table,
+               const std::size_t number_of_locations,
+               const std::size_t first_row,
+               const std::size_t first_column,
+               float *matrix)
+{
+    BOOST_ASSERT(table.type() == engine::api::binary::ValueType::Array);
+    BOOST_ASSERT(first_row + table.size() <= number_of_locations);
+    for (std::size_t row = 0; row < table.size(); ++row)
+    {
+        const auto values = table[row];
+        BOOST_ASSERT(values.type() == engine::api::binary::ValueType::NumberArray);
+        std::transform(values.GetNumbers(),
+                       values.GetNumbers() + values.size(),
+                       matrix + (first_row + row) * number_of_locations + first_column,
+                       [](const double value) { return static_cast<float>(value); });
+    }
+}
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    MatrixConfig config;
+
+    const auto result = parseArguments(argc, argv, config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    if (!config.engine_config.use_shared_memory && !config.engine_config.storage_config.IsValid())
+    {
+        util::Log(logERROR) << "Required files are missing, cannot continue";
+        return EXIT_FAILURE;
+    }
+
+    const auto locations = readLocations(config.locations_path);
+    if (locations.size() < 2)
+    {
+        util::Log(logERROR) << "At least two locations are needed for a matrix";
+        return EXIT_FAILURE;
+    }
+    const auto number_of_locations = locations.size();
+
+    const OSRM osrm(config.engine_config);
+    tbb::task_arena arena(config.requested_num_threads);
+
+    TIMER_START(snap);
+    std::vector<boost::optional<engine::Hint>> hints;
+    arena.execute([&] { hints = snapLocations(osrm, locations); });
+    TIMER_STOP(snap);
+    util::Log() << "Snapping " << number_of_locations << " locations took " << TIMER_SEC(snap)
+                << " seconds.";
+
+    // Every tile is the table of all locations to a range of destinations. Its searches collect
+    // the buckets of these destinations once and probe them with the searches of all sources.
+    // With --sweep a tile is the table of a batch of sources to all locations instead, which
+    // the engine computes with a single sweep over the search spaces of all locations.
+    const auto number_of_tables =
+        (config.annotation_flags & MATRIX_DURATIONS ? 1 : 0) +
+        (config.annotation_flags & MATRIX_DISTANCES ? 1 : 0);
+    const auto tile_width =
+        config.sweep
+            ? std::min(number_of_locations, engine::routing_algorithms::RESTRICTED_SWEEP_LANES)
+            : std::max<std::size_t>(1,
+                                    std::min<std::size_t>(
+                                        number_of_locations,
+                                        (config.memory_budget << 20) /
+                                            (config.requested_num_threads * number_of_locations *
+                                             number_of_tables * BYTES_PER_TABLE_ENTRY)));
+    const auto number_of_tiles = (number_of_locations + tile_width - 1) / tile_width;
+
+    // The tiles are written in place into a mapping of the file, the pages are left to the
+    // page cache and not counted against the budget
+    const auto table_size = number_of_locations * number_of_locations * sizeof(float);
+    boost::iostreams::mapped_file_params output_params(config.output_path.string());
+    output_params.flags = boost::iostreams::mapped_file::readwrite;
+    output_params.new_file_size = sizeof(MatrixHeader) + number_of_tables * table_size;
+    boost::iostreams::mapped_file output(output_params);
+
+    MatrixHeader header;
+    std::copy(MATRIX_MAGIC, MATRIX_MAGIC + sizeof(MATRIX_MAGIC), header.magic);
+    header.version = MATRIX_VERSION;
+    header.annotations = config.annotation_flags;
+    header.number_of_locations = number_of_locations;
+    std::memcpy(output.data(), &header, sizeof(header));
+    auto *tables = reinterpret_cast<float *>(output.data() + sizeof(MatrixHeader));
+    auto *durations = config.annotation_flags & MATRIX_DURATIONS ? tables : nullptr;
+    auto *distances = config.annotation_flags & MATRIX_DISTANCES
+                          ? tables + (durations ? number_of_locations * number_of_locations : 0)
+                          : nullptr;
+
+    util::Log() << "Computing the " << number_of_locations << "x" << number_of_locations
+                << " matrix in " << number_of_tiles << " tiles of " << tile_width
+                << (config.sweep ? " sources" : " destinations") << " with "
+                << config.requested_num_threads << " threads";
+
+    TableParameters table_params;
+    table_params.coordinates = locations;
+    table_params.hints = std::move(hints);
+    table_params.generate_hints = false;
+    table_params.format = engine::api::OutputFormatType::Binary;
+    table_params.annotations = TableParameters::AnnotationsType::None;
+    if (durations)
+        table_params.annotations =
+            table_params.annotations | TableParameters::AnnotationsType::Duration;
+    if (distances)
+        table_params.annotations =
+            table_params.annotations | TableParameters::AnnotationsType::Distance;
+
+    TIMER_START(matrix);
+    std::atomic<std::size_t> failed{0};
+    std::atomic<std::size_t> finished{0};
+    std::mutex log_mutex;
+    arena.execute([&] {
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_tiles, 1),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                auto params = table_params;
+                std::string response;
+                for (auto tile = range.begin(); tile != range.end(); ++tile)
+                {
+                    const auto first_index = tile * tile_width;
+                    const auto last_index =
+                        std::min(first_index + tile_width, number_of_locations);
+                    auto &indices = config.sweep ? params.sources : params.destinations;
+                    indices.resize(last_index - first_index);
+                    std::iota(indices.begin(), indices.end(), first_index);
+                    const auto first_row = config.sweep ? first_index : 0;
+                    const auto first_column = config.sweep ? 0 : first_index;
+
+                    const auto status = osrm.Table(params, response);
+                    const auto root = engine::api::binary::GetRoot(response.data());
+                    if (status != Status::Ok)
+                    {
+                        std::lock_guard<std::mutex> lock(log_mutex);
+                        util::Log(logERROR) << "Tile " << tile << " failed: "
+                                            << root["message"].GetString();
+                        failed++;
+                        continue;
+                    }
+
+                    if (durations)
+                        copyTable(root["durations"],
+                                  number_of_locations,
+                                  first_row,
+                                  first_column,
+                                  durations);
+                    if (distances)
+                        copyTable(root["distances"],
+                                  number_of_locations,
+                                  first_row,
+                                  first_column,
+                                  distances);
+
+                    const auto done = ++finished;
+                    if (done % std::max<std::size_t>(1, number_of_tiles / 10) == 0)
+                    {
+                        std::lock_guard<std::mutex> lock(log_mutex);
+                        util::Log() << done << " of " << number_of_tiles << " tiles done";
+                    }
+                }
+            });
+    });
+    output.close();
+    TIMER_STOP(matrix);
+
+    if (failed > 0)
+    {
+        util::Log(logERROR) << failed.load() << " of " << number_of_tiles << " tiles failed";
+        return EXIT_FAILURE;
+    }
+    util::Log() << "Computing the matrix took " << TIMER_SEC(matrix) << " seconds.";
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
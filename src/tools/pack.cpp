@@ -0,0 +1,182 @@
+#include "storage/dataset_image.hpp"
+#include "storage/shared_datatype.hpp"
+#include "storage/storage.hpp"
+#include "storage/storage_config.hpp"
+
+#include "osrm/exception.hpp"
+#include "util/exception.hpp"
+#include "util/huge_pages.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace osrm;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+return_code parseArguments(int argc,
+                           char *argv[],
+                           boost::filesystem::path &base_path,
+                           boost::filesystem::path &image_path,
+                           std::string &rtree_leaves)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("output,o",
+         boost::program_options::value<boost::filesystem::path>(&image_path),
+         "Path of the image, <data.osrm>.image by default")
+        //
+        ("rtree-leaves",
+         boost::program_options::value<std::string>(&rtree_leaves)->default_value("mapped"),
+         "How the leaves of the r-tree are read when the image is loaded: mapped from their "
+         "file, random to map them without read ahead, prefault to map them with all pages "
+         "read in, or load to copy them into the image.");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<boost::filesystem::path>(&base_path),
+        "Base path of the dataset to pack");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <data.osrm> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help") || base_path.empty())
+    {
+        std::cout << visible_options;
+        return base_path.empty() ? return_code::fail : return_code::exit;
+    }
+
+    return return_code::ok;
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    boost::filesystem::path base_path;
+    boost::filesystem::path image_path;
+    std::string rtree_leaves;
+
+    const auto result = parseArguments(argc, argv, base_path, image_path, rtree_leaves);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    storage::StorageConfig config(base_path);
+    if (!config.IsValid())
+    {
+        util::Log(logERROR) << "Config contains invalid file paths. Exiting!";
+        return EXIT_FAILURE;
+    }
+    try
+    {
+        config.rtree_leaf_access = storage::StringToRTreeLeafAccess(rtree_leaves);
+    }
+    catch (const util::exception &e)
+    {
+        util::Log(logERROR) << e.what();
+        return EXIT_FAILURE;
+    }
+    if (image_path.empty())
+    {
+        image_path = config.image_path;
+    }
+
+    TIMER_START(pack);
+    storage::Storage storage(config);
+    storage::DataLayout layout;
+    storage.PopulateLayout(layout);
+
+    // the memory block is laid out exactly as osrm-datastore lays it out in shared memory
+    util::HugePageMemory memory(layout.GetSizeOfLayout(), false);
+    storage.PopulateData(layout, memory.Get());
+
+    // the image is only replaced once it is complete
+    auto temporary_path = image_path;
+    temporary_path += ".tmp";
+    storage::writeImage(temporary_path, layout, memory.Get());
+    boost::filesystem::rename(temporary_path, image_path);
+    TIMER_STOP(pack);
+
+    util::Log() << "Packed " << boost::filesystem::file_size(image_path) << " bytes into "
+                << image_path.string() << " in " << TIMER_SEC(pack) << " seconds";
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::bad_alloc &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    util::Log(logERROR) << "Please provide more memory or consider using a larger swapfile";
+    return EXIT_FAILURE;
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
@@ -4,6 +4,7 @@
 #include "osrm/exception.hpp"
 #include "util/log.hpp"
 #include "util/meminfo.hpp"
+#include "util/perf_report.hpp"
 #include "util/timing_util.hpp"
 #include "util/version.hpp"
 
@@ -18,6 +19,7 @@
 #include <iostream>
 #include <iterator>
 #include <regex>
+#include <string>
 
 using namespace osrm;
 
@@ -69,11 +71,17 @@ void validate(boost::any &v, const std::vector<std::string> &values, MaxCellSize
     v = boost::any(MaxCellSizesArgument{output});
 }
 
-return_code parseArguments(int argc, char *argv[], partition::PartitionConfig &config)
+return_code parseArguments(int argc,
+                           char *argv[],
+                           partition::PartitionConfig &config,
+                           std::string &perf_report_path)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
-    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
+        "perf-report",
+        boost::program_options::value<std::string>(&perf_report_path),
+        "Write the wall time, CPU time, peak memory and I/O of each stage as JSON to this file");
 
     // declare a group of options that will be allowed both on command line
     boost::program_options::options_description config_options("Configuration");
@@ -103,6 +111,18 @@ return_code parseArguments(int argc, char *argv[], partition::PartitionConfig &c
              ->default_value(config.small_component_size),
          "Size threshold for small components.")
         //
+        ("coarsening-threshold",
+         boost::program_options::value<std::size_t>(&config.coarsening_threshold)
+             ->default_value(config.coarsening_threshold),
+         "Cells with more nodes are bisected on a coarsened graph of at most this many nodes, "
+         "0 disables the coarsening.")
+        //
+        ("max-memory",
+         boost::program_options::value<double>(&config.max_memory)
+             ->default_value(config.max_memory),
+         "Memory budget in GiB for loading the edge based graph. Above it the graph is read from "
+         "a memory mapping and intermediate data is kept on disk, 0 disables the limit.")
+        //
         ("max-cell-sizes",
          boost::program_options::value<MaxCellSizesArgument>()->default_value(
              MaxCellSizesArgument{config.max_cell_sizes}),
@@ -186,7 +206,8 @@ int main(int argc, char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
     partition::PartitionConfig partition_config;
 
-    const auto result = parseArguments(argc, argv, partition_config);
+    std::string perf_report_path;
+    const auto result = parseArguments(argc, argv, partition_config, perf_report_path);
 
     if (return_code::fail == result)
     {
@@ -236,6 +257,11 @@ int main(int argc, char *argv[]) try
     util::Log() << "Bisection took " << TIMER_SEC(bisect) << " seconds.";
 
     util::DumpMemoryStats();
+    if (!perf_report_path.empty())
+    {
+        util::PerfReport::GetInstance().Write(
+            perf_report_path, "osrm-partition", partition_config.requested_num_threads);
+    }
 
     return exitcode;
 }
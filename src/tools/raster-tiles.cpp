@@ -0,0 +1,177 @@
+#include "extractor/raster_source.hpp"
+
+#include "osrm/exception.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace osrm;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct RasterTilesConfig
+{
+    boost::filesystem::path input_path;
+    boost::filesystem::path output_path;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t tile_size = extractor::TiledRasterGrid::DEFAULT_TILE_SIZE;
+};
+
+return_code parseArguments(int argc, char *argv[], RasterTilesConfig &config)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("rows",
+         boost::program_options::value<std::size_t>(&config.rows)->required(),
+         "Number of rows of the ASCII grid")
+        //
+        ("cols",
+         boost::program_options::value<std::size_t>(&config.cols)->required(),
+         "Number of columns of the ASCII grid")
+        //
+        ("tile-size",
+         boost::program_options::value<std::size_t>(&config.tile_size)
+             ->default_value(config.tile_size),
+         "Width and height of the tiles in grid cells");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<boost::filesystem::path>(&config.input_path),
+        "Input ASCII grid")(
+        "output,o",
+        boost::program_options::value<boost::filesystem::path>(&config.output_path),
+        "Output tiled raster file");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1).add("output", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() +
+        " <input.asc> <output.tiles> --rows <rows> --cols <cols> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    try
+    {
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (!option_variables.count("input") || !option_variables.count("output"))
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    if (config.rows == 0 || config.cols == 0 || config.tile_size == 0)
+    {
+        util::Log(logERROR) << "Rows, columns and the tile size must be 1 or larger";
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    RasterTilesConfig config;
+
+    const auto result = parseArguments(argc, argv, config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    if (!boost::filesystem::is_regular_file(config.input_path))
+    {
+        util::Log(logERROR) << "Input file " << config.input_path << " not found!";
+        return EXIT_FAILURE;
+    }
+
+    TIMER_START(convert);
+    util::Log() << "Reading " << config.input_path.string();
+    const extractor::RasterGrid grid(config.input_path, config.cols, config.rows);
+
+    util::Log() << "Writing tiles of " << config.tile_size << "x" << config.tile_size
+                << " cells to " << config.output_path.string();
+    extractor::TiledRasterGrid::Write(config.output_path, grid, config.tile_size);
+    TIMER_STOP(convert);
+    util::Log() << "Conversion took " << TIMER_SEC(convert) << " seconds.";
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
@@ -1,7 +1,13 @@
+#include "server/http/compressor.hpp"
+#include "server/profile_router.hpp"
 #include "server/server.hpp"
+#include "server/shard_router.hpp"
+#include "server/table_coordinator.hpp"
+#include "util/async_log.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
 #include "util/meminfo.hpp"
+#include "util/request_trace.hpp"
 #include "util/version.hpp"
 
 #include "osrm/engine_config.hpp"
@@ -18,6 +24,7 @@
 
 #include <signal.h>
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
 #include <future>
@@ -26,6 +33,8 @@
 #include <new>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -62,25 +71,141 @@ static EngineConfig::Algorithm stringToAlgorithm(std::string algorithm)
         return EngineConfig::Algorithm::CoreCH;
     if (algorithm == "mld")
         return EngineConfig::Algorithm::MLD;
+    if (algorithm == "cch")
+        return EngineConfig::Algorithm::CCH;
     throw util::RuntimeError(algorithm, ErrorCode::UnknownAlgorithm, SOURCE_REF);
 }
 
+static EngineConfig::HeapStorage stringToHeapStorage(std::string storage)
+{
+    boost::to_lower(storage);
+
+    if (storage == "default")
+        return EngineConfig::HeapStorage::Default;
+    if (storage == "hash")
+        return EngineConfig::HeapStorage::UnorderedMap;
+    if (storage == "array")
+        return EngineConfig::HeapStorage::GenerationArray;
+    if (storage == "paged")
+        return EngineConfig::HeapStorage::TwoLevelArray;
+    throw util::exception("Unknown heap storage " + storage + SOURCE_REF);
+}
+
+static server::AccessLogFormat stringToAccessLogFormat(std::string format)
+{
+    boost::to_lower(format);
+
+    if (format == "plain")
+        return server::AccessLogFormat::Plain;
+    if (format == "logfmt")
+        return server::AccessLogFormat::Logfmt;
+    throw util::exception("Unknown access log format " + format + SOURCE_REF);
+}
+
+// parses the SERVICE=N limits of --max-concurrent-requests
+static std::unordered_map<std::string, server::ServiceLimits>
+stringsToServiceLimits(const std::vector<std::string> &max_concurrent_requests,
+                       const int max_queued_requests)
+{
+    std::unordered_map<std::string, server::ServiceLimits> limits;
+    for (const auto &service_limit : max_concurrent_requests)
+    {
+        const auto separator = service_limit.find('=');
+        std::size_t parsed_size = 0;
+        int max_concurrent = 0;
+        if (separator != std::string::npos && separator > 0)
+        {
+            try
+            {
+                max_concurrent = std::stoi(service_limit.substr(separator + 1), &parsed_size);
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+        if (max_concurrent < 1 || separator + 1 + parsed_size != service_limit.size())
+        {
+            throw util::exception("Invalid concurrency limit " + service_limit +
+                                  ", expected SERVICE=N with N > 0" + SOURCE_REF);
+        }
+        limits[service_limit.substr(0, separator)] = server::ServiceLimits{
+            static_cast<unsigned>(max_concurrent), static_cast<unsigned>(max_queued_requests)};
+    }
+    return limits;
+}
+
 // generate boost::program_options object for the routing part
 inline unsigned generateServerProgramOptions(const int argc,
                                              const char *argv[],
                                              boost::filesystem::path &base_path,
                                              std::string &ip_address,
                                              int &ip_port,
+                                             int &http2_port,
+                                             std::string &unix_socket,
                                              int &requested_num_threads,
+                                             int &compute_threads,
+                                             int &keep_alive_timeout,
+                                             int &keep_alive_max_requests,
+                                             int &max_body_size,
+                                             bool &reuse_port,
+                                             bool &pin_threads,
+                                             bool &server_timing,
+                                             bool &async_logging,
+                                             std::string &access_log_format,
+                                             double &access_log_sample_rate,
+                                             std::string &trace_file,
+                                             double &trace_sample_rate,
+                                             bool &coalesce_requests,
+                                             int &response_cache_size,
+                                             int &response_cache_ttl,
+                                             server::http::CompressionConfig &compression,
+                                             std::vector<std::string> &max_concurrent_requests,
+                                             int &max_queued_requests,
+                                             int &max_queue_wait,
+                                             std::vector<std::string> &shards,
+                                             std::string &fallback_backend,
+                                             int &backend_timeout,
+                                             std::vector<std::string> &table_peers,
+                                             std::size_t &table_peer_min_size,
+                                             std::size_t &table_peer_rows,
+                                             std::vector<std::string> &datasets,
                                              bool &use_shared_memory,
+                                             std::string &dataset_name,
+                                             bool &warm_up_data,
+                                             int &warm_up_queries,
+                                             bool &use_huge_pages,
+                                             bool &use_mmap,
+                                             bool &use_image,
+                                             std::string &rtree_leaves,
                                              std::string &algorithm,
+                                             std::string &query_heap_storage,
+                                             std::string &many_to_many_heap_storage,
+                                             bool &use_landmarks_for_route,
+                                             bool &use_landmarks_for_match,
                                              bool &trial,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
                                              int &max_results_nearest,
-                                             int &max_alternatives)
+                                             int &max_alternatives,
+                                             int &max_isochrone_duration,
+                                             int &max_core_settled_nodes,
+                                             int &max_query_time,
+                                             int &max_heap_memory,
+                                             int &many_to_many_concurrency,
+                                             int &match_concurrency,
+                                             int &alternatives_concurrency,
+                                             int &leg_concurrency,
+                                             int &leg_concurrency_min_waypoints,
+                                             int &trip_improvement_time,
+                                             int &trip_table_neighbours,
+                                             int &routing_cache_size,
+                                             int &snap_cache_size,
+                                             int &shortcut_cache_size,
+                                             int &tile_cache_size,
+                                             boost::filesystem::path &tile_cache_path,
+                                             int &match_session_ttl)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -99,16 +224,161 @@ inline unsigned generateServerProgramOptions(const int argc,
          "IP address") //
         ("port,p",
          value<int>(&ip_port)->default_value(5000),
-         "TCP/IP port") //
+         "TCP/IP port, 0 only listens on the Unix domain socket") //
+        ("unix-socket",
+         value<std::string>(&unix_socket),
+         "Path of a Unix domain socket to listen on for clients on the same host") //
+        ("http2-port",
+         value<int>(&http2_port)->default_value(0),
+         "TCP/IP port that serves cleartext HTTP/2 to clients with prior knowledge, 0 disables "
+         "it") //
         ("threads,t",
          value<int>(&requested_num_threads)->default_value(8),
          "Number of threads to use") //
+        ("compute-threads",
+         value<int>(&compute_threads)->default_value(0),
+         "Number of threads that handle the requests, the server threads then only read and "
+         "write them. 0 handles them on the server threads, -1 uses all hardware threads.") //
+        ("keep-alive-timeout",
+         value<int>(&keep_alive_timeout)->default_value(5),
+         "Seconds an idle persistent connection is kept open, 0 closes connections after each "
+         "reply") //
+        ("keep-alive-max-requests",
+         value<int>(&keep_alive_max_requests)->default_value(512),
+         "Max. number of requests answered on a persistent connection") //
+        ("max-body-size",
+         value<int>(&max_body_size)->default_value(
+             static_cast<int>(server::RequestParser::DEFAULT_MAX_BODY_SIZE)),
+         "Max. size in bytes of the body of POST requests") //
+        ("reuse-port",
+         value<bool>(&reuse_port)->implicit_value(true)->default_value(false),
+         "Give every thread an acceptor of its own bound with SO_REUSEPORT, the kernel "
+         "distributes connections between the threads") //
+        ("pin-threads",
+         value<bool>(&pin_threads)->implicit_value(true)->default_value(false),
+         "Pin every server thread to a core") //
+        ("server-timing",
+         value<bool>(&server_timing)->implicit_value(true)->default_value(false),
+         "Add a Server-Timing header with the time spent in each stage to replies") //
+        ("async-logging",
+         value<bool>(&async_logging)->implicit_value(true)->default_value(false),
+         "Write log lines from a background thread, request threads don't wait for the "
+         "output") //
+        ("access-log-format",
+         value<std::string>(&access_log_format)->default_value("plain"),
+         "Format of the access log lines: plain or logfmt") //
+        ("access-log-sample-rate",
+         value<double>(&access_log_sample_rate)->default_value(1.0),
+         "Share of the successful requests written to the access log, failed requests are "
+         "always logged") //
+        ("trace-file",
+         value<std::string>(&trace_file),
+         "Write the stages of traced requests to this file in the Chrome trace format") //
+        ("trace-sample-rate",
+         value<double>(&trace_sample_rate)->default_value(0.0),
+         "Share of the requests that are traced, requests with an X-OSRM-Trace: 1 header are "
+         "always traced") //
+        ("coalesce-requests",
+         value<bool>(&coalesce_requests)->implicit_value(true)->default_value(false),
+         "Let identical requests that arrive while the first of them is handled share its "
+         "reply") //
+        ("response-cache-size",
+         value<int>(&response_cache_size)->default_value(0),
+         "MiB of successful replies kept to answer repeated requests without running them, 0 "
+         "disables the cache") //
+        ("response-cache-ttl",
+         value<int>(&response_cache_ttl)->default_value(60),
+         "Seconds a reply is kept in the response cache") //
+        ("gzip-level",
+         value<int>(&compression.gzip_level)->default_value(compression.gzip_level),
+         "Compression level of gzip and deflate encoded replies, 1 (fastest) to 9") //
+        ("brotli-level",
+         value<int>(&compression.brotli_level)->default_value(compression.brotli_level),
+         "Compression level of brotli encoded replies, 0 (fastest) to 11") //
+        ("zstd-level",
+         value<int>(&compression.zstd_level)->default_value(compression.zstd_level),
+         "Compression level of zstd encoded replies, 1 (fastest) to 19") //
+        ("compression-min-size",
+         value<std::size_t>(&compression.min_size)->default_value(compression.min_size),
+         "Replies smaller than this many bytes are sent uncompressed, at most 65536") //
+        ("max-concurrent-requests",
+         value<std::vector<std::string>>(&max_concurrent_requests)->multitoken()->composing(),
+         "Max. number of requests of a service handled at the same time as SERVICE=N, e.g. "
+         "table=2. Services without a limit are not limited.") //
+        ("max-queued-requests",
+         value<int>(&max_queued_requests)->default_value(4),
+         "Max. number of requests waiting for a limited service, more are rejected with 503") //
+        ("max-queue-wait",
+         value<int>(&max_queue_wait)->default_value(1000),
+         "Milliseconds a request waits for a limited service before it is rejected with 503") //
+        ("shard",
+         value<std::vector<std::string>>(&shards)->multitoken()->composing(),
+         "Pass requests on to the backend owning their coordinates instead of loading a "
+         "dataset, as NAME=MIN_LON,MIN_LAT,MAX_LON,MAX_LAT@HOST:PORT") //
+        ("fallback-backend",
+         value<std::string>(&fallback_backend),
+         "Backend as HOST:PORT for the requests no shard covers all coordinates of") //
+        ("backend-timeout",
+         value<int>(&backend_timeout)->default_value(30000),
+         "Milliseconds the router waits for the reply of a backend or table peer") //
+        ("table-peer",
+         value<std::vector<std::string>>(&table_peers)->multitoken()->composing(),
+         "osrm-routed as HOST:PORT with the same dataset that computes blocks of the source "
+         "rows of large tables") //
+        ("table-peer-min-size",
+         value<std::size_t>(&table_peer_min_size)->default_value(250000),
+         "Tables with more entries than this are split among the table peers") //
+        ("table-peer-rows",
+         value<std::size_t>(&table_peer_rows)->default_value(0),
+         "Max. number of source rows a table peer computes per request, 0 splits the rows "
+         "evenly among the peers") //
+        ("dataset",
+         value<std::vector<std::string>>(&datasets)->multitoken()->composing(),
+         "Answer the requests of a profile from another dataset as PROFILE=PATH, e.g. "
+         "truck=/data/map.truck.osrm. Other profiles are answered from the dataset of the base "
+         "path or shared memory if there is one.") //
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("dataset-name",
+         value<std::string>(&dataset_name)->default_value(""),
+         "Name of the dataset in shared memory, as loaded with osrm-datastore --dataset-name") //
+        ("warm-up",
+         value<bool>(&warm_up_data)->implicit_value(true)->default_value(false),
+         "Page in the graphs, the r-tree and the cells of datasets in shared memory before "
+         "using them") //
+        ("warm-up-queries",
+         value<int>(&warm_up_queries)->default_value(0),
+         "Number of snapping queries run on datasets in shared memory before using them, "
+         "with --warm-up") //
+        ("huge-pages",
+         value<bool>(&use_huge_pages)->implicit_value(true)->default_value(false),
+         "Back the data loaded into memory with huge pages if the system has them") //
+        ("mmap",
+         value<bool>(&use_mmap)->implicit_value(true)->default_value(false),
+         "Map the data files into memory instead of loading them") //
+        ("image",
+         value<bool>(&use_image)->implicit_value(true)->default_value(false),
+         "Load the dataset from the image written by osrm-pack, or map it with --mmap") //
+        ("rtree-leaves",
+         value<std::string>(&rtree_leaves)->default_value("mapped"),
+         "How the leaves of the r-tree are read. Can be mapped, random, prefault, load.") //
         ("algorithm,a",
          value<std::string>(&algorithm)->default_value("CH"),
-         "Algorithm to use for the data. Can be CH, CoreCH, MLD.") //
+         "Algorithm to use for the data. Can be CH, CoreCH, MLD, CCH.") //
+        ("query-heap-storage",
+         value<std::string>(&query_heap_storage)->default_value("default"),
+         "Node index storage of point-to-point search heaps. Can be default, hash, array, "
+         "paged.") //
+        ("many-to-many-heap-storage",
+         value<std::string>(&many_to_many_heap_storage)->default_value("default"),
+         "Node index storage of the table search heap. Can be default, hash, array, paged.") //
+        ("landmarks-for-route",
+         value<bool>(&use_landmarks_for_route)->implicit_value(true)->default_value(true),
+         "Direct the searches of route and trip requests by the landmarks of the dataset") //
+        ("landmarks-for-match",
+         value<bool>(&use_landmarks_for_match)->implicit_value(true)->default_value(false),
+         "Direct the searches of match requests by the landmarks of the dataset") //
         ("max-viaroute-size",
          value<int>(&max_locations_viaroute)->default_value(500),
          "Max. locations supported in viaroute query") //
@@ -126,7 +396,67 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. results supported in nearest query") //
         ("max-alternatives",
          value<int>(&max_alternatives)->default_value(3),
-         "Max. number of alternatives supported in the MLD route query");
+         "Max. number of alternatives supported in the MLD route query") //
+        ("max-isochrone-duration",
+         value<int>(&max_isochrone_duration)->default_value(3600),
+         "Max. contour duration in seconds supported in isochrone query") //
+        ("max-core-settled-nodes",
+         value<int>(&max_core_settled_nodes)->default_value(-1),
+         "Max. number of nodes the core search of CoreCH may settle for a route, -1 for no "
+         "limit") //
+        ("max-query-time",
+         value<int>(&max_query_time)->default_value(-1),
+         "Max. time in milliseconds a query may run before it fails with a Timeout error, can be "
+         "lowered per request with the X-OSRM-Timeout header. -1 for no limit") //
+        ("max-heap-memory",
+         value<int>(&max_heap_memory)->default_value(-1),
+         "Max. MiB the search heaps of a thread keep after a query, larger ones are released. "
+         "-1 for no limit") //
+        ("many-to-many-concurrency",
+         value<int>(&many_to_many_concurrency)->default_value(1),
+         "Max. number of threads used by a single distance table query") //
+        ("match-concurrency",
+         value<int>(&match_concurrency)->default_value(1),
+         "Max. number of threads used by a single map matching query") //
+        ("alternatives-concurrency",
+         value<int>(&alternatives_concurrency)->default_value(1),
+         "Max. number of threads used by a single MLD alternative routes query") //
+        ("leg-concurrency",
+         value<int>(&leg_concurrency)->default_value(1),
+         "Max. number of threads unpacking and assembling the legs of a single route query") //
+        ("leg-concurrency-min-waypoints",
+         value<int>(&leg_concurrency_min_waypoints)->default_value(16),
+         "Min. number of waypoints of a route query to unpack and assemble its legs on "
+         "multiple threads") //
+        ("trip-improvement-time",
+         value<int>(&trip_improvement_time)->default_value(0),
+         "Max. milliseconds a trip query improves its order of locations by local search, "
+         "0 disables it") //
+        ("trip-table-neighbours",
+         value<int>(&trip_table_neighbours)->default_value(0),
+         "Number of nearest locations trips through more than 100 locations compute durations "
+         "to, 0 computes the durations between all locations") //
+        ("routing-cache-size",
+         value<int>(&routing_cache_size)->default_value(0),
+         "Max. number of route and table results cached across requests, 0 disables the cache") //
+        ("snap-cache-size",
+         value<int>(&snap_cache_size)->default_value(0),
+         "Max. number of snapped input coordinates cached across requests, 0 disables the "
+         "cache") //
+        ("shortcut-cache-size",
+         value<int>(&shortcut_cache_size)->default_value(0),
+         "Max. number of unpacked CH shortcuts and MLD clique arcs cached across requests, 0 "
+         "disables the cache") //
+        ("tile-cache-size",
+         value<int>(&tile_cache_size)->default_value(0),
+         "Max. number of encoded tiles cached across requests, 0 disables the cache") //
+        ("tile-cache-path",
+         value<boost::filesystem::path>(&tile_cache_path),
+         "Directory tiles are persisted to and served from, e.g. as pre-rendered by "
+         "osrm-tiles") //
+        ("match-session-ttl",
+         value<int>(&match_session_ttl)->default_value(0),
+         "Seconds a match session is kept without being continued, 0 disables the sessions");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -176,10 +506,22 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    if (!shards.empty())
+    {
+        if (use_shared_memory || option_variables.count("base"))
+        {
+            util::Log(logWARNING) << "Routing to shards, the dataset is not loaded.";
+        }
+        return INIT_OK_START_ENGINE;
+    }
     if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
     }
+    else if (!use_shared_memory && !datasets.empty())
+    {
+        return INIT_OK_START_ENGINE;
+    }
     else if (use_shared_memory && !option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -199,26 +541,108 @@ int main(int argc, const char *argv[]) try
 
     bool trial_run = false;
     std::string ip_address;
-    int ip_port, requested_thread_num;
+    int ip_port, http2_port, requested_thread_num, keep_alive_timeout, keep_alive_max_requests;
+    int compute_threads;
+    std::string unix_socket;
+    int max_body_size;
+    bool reuse_port = false;
+    bool pin_threads = false;
+    bool server_timing = false;
+    bool async_logging = false;
+    std::string access_log_format;
+    double access_log_sample_rate;
+    std::string trace_file;
+    double trace_sample_rate;
+    bool coalesce_requests = false;
+    int response_cache_size, response_cache_ttl;
+    server::http::CompressionConfig compression;
+    std::vector<std::string> max_concurrent_requests;
+    int max_queued_requests, max_queue_wait;
+    std::vector<std::string> shards;
+    std::string fallback_backend;
+    int backend_timeout;
+    std::vector<std::string> table_peers;
+    std::size_t table_peer_min_size, table_peer_rows;
+    std::vector<std::string> datasets;
 
     EngineConfig config;
     boost::filesystem::path base_path;
+    std::string rtree_leaves;
+    bool use_image = false;
     std::string algorithm;
+    std::string query_heap_storage;
+    std::string many_to_many_heap_storage;
     const unsigned init_result = generateServerProgramOptions(argc,
                                                               argv,
                                                               base_path,
                                                               ip_address,
                                                               ip_port,
+                                                              http2_port,
+                                                              unix_socket,
                                                               requested_thread_num,
+                                                              compute_threads,
+                                                              keep_alive_timeout,
+                                                              keep_alive_max_requests,
+                                                              max_body_size,
+                                                              reuse_port,
+                                                              pin_threads,
+                                                              server_timing,
+                                                              async_logging,
+                                                              access_log_format,
+                                                              access_log_sample_rate,
+                                                              trace_file,
+                                                              trace_sample_rate,
+                                                              coalesce_requests,
+                                                              response_cache_size,
+                                                              response_cache_ttl,
+                                                              compression,
+                                                              max_concurrent_requests,
+                                                              max_queued_requests,
+                                                              max_queue_wait,
+                                                              shards,
+                                                              fallback_backend,
+                                                              backend_timeout,
+                                                              table_peers,
+                                                              table_peer_min_size,
+                                                              table_peer_rows,
+                                                              datasets,
                                                               config.use_shared_memory,
+                                                              config.dataset_name,
+                                                              config.warm_up_data,
+                                                              config.warm_up_queries,
+                                                              config.use_huge_pages,
+                                                              config.use_mmap,
+                                                              use_image,
+                                                              rtree_leaves,
                                                               algorithm,
+                                                              query_heap_storage,
+                                                              many_to_many_heap_storage,
+                                                              config.use_landmarks_for_route,
+                                                              config.use_landmarks_for_match,
                                                               trial_run,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
                                                               config.max_locations_map_matching,
                                                               config.max_results_nearest,
-                                                              config.max_alternatives);
+                                                              config.max_alternatives,
+                                                              config.max_isochrone_duration,
+                                                              config.max_core_settled_nodes,
+                                                              config.max_query_time,
+                                                              config.max_heap_memory,
+                                                              config.many_to_many_concurrency,
+                                                              config.match_concurrency,
+                                                              config.alternatives_concurrency,
+                                                              config.leg_concurrency,
+                                                              config.leg_concurrency_min_waypoints,
+                                                              config.trip_improvement_time,
+                                                              config.trip_table_neighbours,
+                                                              config.routing_cache_size,
+                                                              config.snap_cache_size,
+                                                              config.shortcut_cache_size,
+                                                              config.tile_cache_size,
+                                                              config.tile_cache_path,
+                                                              config.match_session_ttl);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -227,16 +651,28 @@ int main(int argc, const char *argv[]) try
     {
         return EXIT_FAILURE;
     }
+    // the router doesn't load a dataset of its own
+    const bool route_to_shards = !shards.empty();
+    if (route_to_shards && !table_peers.empty())
+    {
+        util::Log(logERROR) << "Table peers need a dataset to snap the coordinates on, they "
+                               "can't be used with shards";
+        return EXIT_FAILURE;
+    }
+    // the dataset of the profiles without a dataset of their own
+    const bool serve_default_dataset =
+        !route_to_shards && (datasets.empty() || config.use_shared_memory || !base_path.empty());
     if (!base_path.empty())
     {
         config.storage_config = storage::StorageConfig(base_path);
+        config.storage_config.use_image = use_image;
     }
-    if (!config.use_shared_memory && !config.storage_config.IsValid())
+    if (serve_default_dataset && !config.use_shared_memory && !config.storage_config.IsValid())
     {
         util::Log(logERROR) << "Required files are missing, cannot continue";
         return EXIT_FAILURE;
     }
-    if (!config.IsValid())
+    if (serve_default_dataset && !config.IsValid())
     {
         if (base_path.empty() != config.use_shared_memory)
         {
@@ -245,17 +681,84 @@ int main(int argc, const char *argv[]) try
         return EXIT_FAILURE;
     }
     config.algorithm = stringToAlgorithm(algorithm);
+    server::AccessLogFormat access_log;
+    std::shared_ptr<util::RequestTraceWriter> trace_writer;
+    try
+    {
+        access_log = stringToAccessLogFormat(access_log_format);
+        if (!trace_file.empty())
+        {
+            trace_writer = std::make_shared<util::RequestTraceWriter>(trace_file);
+        }
+        config.query_heap_storage = stringToHeapStorage(query_heap_storage);
+        config.many_to_many_heap_storage = stringToHeapStorage(many_to_many_heap_storage);
+        config.storage_config.rtree_leaf_access = storage::StringToRTreeLeafAccess(rtree_leaves);
+    }
+    catch (const util::exception &e)
+    {
+        util::Log(logERROR) << e.what();
+        return EXIT_FAILURE;
+    }
+
+    if (access_log_sample_rate <= 0 || access_log_sample_rate > 1)
+    {
+        util::Log(logERROR) << "The access log sample rate must be greater than 0 and at most 1";
+        return EXIT_FAILURE;
+    }
+
+    if (trace_sample_rate < 0 || trace_sample_rate > 1)
+    {
+        util::Log(logERROR) << "The trace sample rate must be between 0 and 1";
+        return EXIT_FAILURE;
+    }
+
+    if (async_logging)
+    {
+        util::AsyncLogWriter::GetInstance().Start(std::cout, std::cerr);
+    }
 
     util::Log() << "starting up engines, " << OSRM_VERSION;
 
-    if (config.use_shared_memory)
+    if (route_to_shards)
+    {
+        util::Log() << "Routing to " << shards.size() << " shards";
+    }
+    else if (config.use_shared_memory)
     {
         util::Log() << "Loading from shared memory";
+        if (config.use_mmap)
+        {
+            util::Log(logWARNING) << "Shared memory is used, the data files are not mapped.";
+        }
+    }
+    else if (config.warm_up_data)
+    {
+        util::Log(logWARNING) << "Only datasets in shared memory are warmed up.";
+    }
+    else if (config.use_mmap)
+    {
+        util::Log() << "Mapping the data files into memory";
+        if (config.use_huge_pages)
+        {
+            util::Log(logWARNING) << "Mapped data files are not backed by huge pages.";
+        }
     }
 
     util::Log() << "Threads: " << requested_thread_num;
+    if (compute_threads != 0)
+    {
+        util::Log() << "Compute threads: " << compute_threads;
+    }
     util::Log() << "IP address: " << ip_address;
     util::Log() << "IP port: " << ip_port;
+    if (!unix_socket.empty())
+    {
+        util::Log() << "Unix domain socket: " << unix_socket;
+    }
+    if (http2_port > 0)
+    {
+        util::Log() << "HTTP/2 port: " << http2_port;
+    }
 
 #ifndef _WIN32
     int sig = 0;
@@ -265,10 +768,237 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-    auto service_handler = std::make_unique<server::ServiceHandler>(config);
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    std::unique_ptr<server::ServiceHandlerInterface> service_handler;
+    if (route_to_shards)
+    {
+        if (backend_timeout < 1)
+        {
+            util::Log(logERROR) << "Backend timeout must be positive";
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            std::vector<server::Shard> parsed_shards;
+            for (const auto &shard : shards)
+            {
+                parsed_shards.push_back(server::Shard::FromString(shard));
+            }
+            boost::optional<server::Backend> fallback;
+            if (!fallback_backend.empty())
+            {
+                fallback = server::Backend::FromString(fallback_backend);
+            }
+            service_handler =
+                std::make_unique<server::ShardRouter>(std::move(parsed_shards),
+                                                      std::move(fallback),
+                                                      std::chrono::milliseconds(backend_timeout));
+        }
+        catch (const util::exception &e)
+        {
+            util::Log(logERROR) << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+    else if (datasets.empty())
+    {
+        service_handler = std::make_unique<server::ServiceHandler>(config);
+    }
+    else
+    {
+        try
+        {
+            auto router = std::make_unique<server::ProfileRouter>(
+                serve_default_dataset ? std::make_unique<server::ServiceHandler>(config)
+                                      : nullptr);
+            for (const auto &dataset : datasets)
+            {
+                const auto profile_dataset = server::ProfileDataset::FromString(dataset);
+
+                // datasets of profiles are loaded like the one of the base path, only a single
+                // dataset can be in shared memory
+                auto profile_config = config;
+                profile_config.use_shared_memory = false;
+                profile_config.storage_config = storage::StorageConfig(profile_dataset.base_path);
+                profile_config.storage_config.use_image = use_image;
+                profile_config.storage_config.rtree_leaf_access =
+                    config.storage_config.rtree_leaf_access;
+                if (!profile_config.storage_config.IsValid() || !profile_config.IsValid())
+                {
+                    util::Log(logERROR) << "Required files of the dataset of the profile "
+                                        << profile_dataset.profile << " are missing";
+                    return EXIT_FAILURE;
+                }
+
+                util::Log() << "Answering profile " << profile_dataset.profile << " from "
+                            << profile_dataset.base_path.string();
+                router->AddProfile(profile_dataset.profile,
+                                   std::make_unique<server::ServiceHandler>(profile_config));
+            }
+            service_handler = std::move(router);
+        }
+        catch (const util::exception &e)
+        {
+            util::Log(logERROR) << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+    if (!table_peers.empty())
+    {
+        if (backend_timeout < 1)
+        {
+            util::Log(logERROR) << "Backend timeout must be positive";
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            std::vector<server::Backend> peers;
+            for (const auto &peer : table_peers)
+            {
+                peers.push_back(server::Backend::FromString(peer));
+            }
+            util::Log() << "Splitting tables of more than " << table_peer_min_size
+                        << " entries among " << peers.size() << " table peers";
+            service_handler = std::make_unique<server::TableCoordinator>(
+                std::move(service_handler),
+                std::move(peers),
+                table_peer_min_size,
+                table_peer_rows,
+                std::chrono::milliseconds(backend_timeout));
+        }
+        catch (const util::exception &e)
+        {
+            util::Log(logERROR) << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+    if (keep_alive_timeout < 0 || keep_alive_max_requests < 1)
+    {
+        util::Log(logERROR) << "Keep-alive timeout must not be negative and at least one request "
+                               "has to be allowed per connection";
+        return EXIT_FAILURE;
+    }
+
+    if (ip_port < 0 || (ip_port == 0 && unix_socket.empty()))
+    {
+        util::Log(logERROR) << "Port must be positive, or 0 with a Unix domain socket";
+        return EXIT_FAILURE;
+    }
+
+#ifndef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    if (!unix_socket.empty())
+    {
+        util::Log(logERROR) << "Unix domain sockets are not supported on this platform";
+        return EXIT_FAILURE;
+    }
+#endif
+
+    if (http2_port < 0 || (http2_port > 0 && http2_port == ip_port))
+    {
+        util::Log(logERROR) << "HTTP/2 port must not be negative or the port of HTTP/1.1";
+        return EXIT_FAILURE;
+    }
+
+    if (max_body_size < 0)
+    {
+        util::Log(logERROR) << "Max. body size must not be negative";
+        return EXIT_FAILURE;
+    }
+
+    if (max_queued_requests < 0 || max_queue_wait < 0)
+    {
+        util::Log(logERROR) << "Queued requests and queue wait must not be negative";
+        return EXIT_FAILURE;
+    }
+
+    if (response_cache_size < 0 || response_cache_ttl < 1)
+    {
+        util::Log(logERROR) << "Response cache size must not be negative and its time to live "
+                               "must be positive";
+        return EXIT_FAILURE;
+    }
+
+    if (compression.gzip_level < 1 || compression.gzip_level > 9 ||
+        compression.brotli_level < 0 || compression.brotli_level > 11 ||
+        compression.zstd_level < 1 || compression.zstd_level > 19 ||
+        compression.min_size > server::http::CompressionConfig::MAX_MIN_SIZE)
+    {
+        util::Log(logERROR) << "Compression levels or minimum size out of range";
+        return EXIT_FAILURE;
+    }
+
+    std::unordered_map<std::string, server::ServiceLimits> service_limits;
+    try
+    {
+        service_limits = stringsToServiceLimits(max_concurrent_requests, max_queued_requests);
+    }
+    catch (const util::exception &e)
+    {
+        util::Log(logERROR) << e.what();
+        return EXIT_FAILURE;
+    }
+    if (compute_threads < -1)
+    {
+        util::Log(logERROR) << "Number of compute threads must be -1 or more";
+        return EXIT_FAILURE;
+    }
+    // requests wait for admission on the threads that handle them
+    const auto handler_threads =
+        compute_threads == 0
+            ? static_cast<unsigned>(requested_thread_num)
+            : compute_threads == -1 ? std::max(1u, std::thread::hardware_concurrency())
+                                    : static_cast<unsigned>(compute_threads);
+    for (const auto &limits : service_limits)
+    {
+        if (limits.second.max_concurrent + limits.second.max_queued >= handler_threads)
+        {
+            util::Log(logWARNING) << "Requests of " << limits.first
+                                  << " can occupy all threads, other services stall while they "
+                                     "are handled";
+        }
+    }
+
+    auto routing_server = server::Server::CreateServer(ip_address,
+                                                       ip_port,
+                                                       requested_thread_num,
+                                                       keep_alive_timeout,
+                                                       keep_alive_max_requests,
+                                                       reuse_port,
+                                                       pin_threads);
+
+    if (http2_port > 0)
+    {
+        routing_server->ListenHttp2(ip_address, http2_port);
+    }
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    if (!unix_socket.empty())
+    {
+        routing_server->ListenLocal(unix_socket);
+    }
+#endif
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
+    routing_server->EnableServerTiming(server_timing);
+    routing_server->SetAccessLog(access_log, access_log_sample_rate);
+    routing_server->SetTracing(std::move(trace_writer), trace_sample_rate);
+    routing_server->EnableRequestCoalescing(coalesce_requests);
+    routing_server->SetCompression(compression);
+    routing_server->SetMaxBodySize(static_cast<std::size_t>(max_body_size));
+    routing_server->SetMaxQueryTime(config.max_query_time);
+    if (compute_threads != 0)
+    {
+        routing_server->SetComputePool(std::make_unique<server::ComputePool>(compute_threads));
+    }
+    if (response_cache_size > 0)
+    {
+        routing_server->SetResponseCache(std::make_unique<server::ResponseCache>(
+            static_cast<std::size_t>(response_cache_size) * 1024 * 1024,
+            std::chrono::seconds(response_cache_ttl)));
+    }
+    if (!service_limits.empty())
+    {
+        routing_server->SetAdmissionControl(std::make_unique<server::AdmissionControl>(
+            service_limits, std::chrono::milliseconds(max_queue_wait)));
+    }
 
     if (trial_run)
     {
@@ -324,6 +1054,7 @@ int main(int argc, const char *argv[]) try
     util::Log() << "freeing objects";
     routing_server.reset();
     util::Log() << "shutdown completed";
+    util::AsyncLogWriter::GetInstance().Stop();
 }
 catch (const osrm::RuntimeError &e)
 {
@@ -1,7 +1,10 @@
+#include "storage/io.hpp"
 #include "storage/shared_memory.hpp"
 #include "storage/shared_monitor.hpp"
 #include "storage/storage.hpp"
+#include "updater/live_update.hpp"
 #include "osrm/exception.hpp"
+#include "util/exception.hpp"
 #include "util/log.hpp"
 #include "util/meminfo.hpp"
 #include "util/typedefs.hpp"
@@ -12,21 +15,36 @@
 
 #include <csignal>
 #include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
 
 using namespace osrm;
 
-void removeLocks() { storage::SharedMonitor<storage::SharedDataTimestamp>::remove(); }
+// the dataset the locks of are removed on a signal
+std::string dataset_name;
 
-void deleteRegion(const storage::SharedDataType region)
+void removeLocks(const std::string &dataset_name)
 {
-    if (storage::SharedMemory::RegionExists(region) && !storage::SharedMemory::Remove(region))
+    storage::SharedMonitor<storage::SharedDataTimestamp>::remove(dataset_name);
+}
+
+void deleteRegion(const storage::SharedDataType region, const std::string &dataset_name)
+{
+    for (unsigned replica = 0; replica < storage::MAX_REGION_REPLICAS; ++replica)
     {
-        util::Log(logWARNING) << "could not delete shared memory region "
-                              << storage::regionToString(region);
+        const auto id = storage::getReplicaID(region, replica);
+        if (storage::SharedMemory::RegionExists(id, dataset_name) &&
+            !storage::SharedMemory::Remove(id, dataset_name))
+        {
+            util::Log(logWARNING) << "could not delete shared memory region "
+                                  << storage::regionToString(region) << " (copy " << replica
+                                  << ")";
+        }
     }
 }
 
-void springClean()
+void springClean(const std::string &dataset_name)
 {
     osrm::util::Log() << "Releasing all locks";
     osrm::util::Log() << "ATTENTION! BE CAREFUL!";
@@ -43,9 +61,9 @@ void springClean()
     }
     else
     {
-        deleteRegion(storage::REGION_1);
-        deleteRegion(storage::REGION_2);
-        removeLocks();
+        deleteRegion(storage::REGION_1, dataset_name);
+        deleteRegion(storage::REGION_2, dataset_name);
+        removeLocks(dataset_name);
     }
 }
 
@@ -53,13 +71,25 @@ void springClean()
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              std::string &dataset_name,
+                              bool &numa_replicas,
+                              bool &huge_pages,
+                              bool &reuse_unchanged,
+                              std::string &rtree_leaves,
+                              bool &direct_io,
+                              bool &use_image,
+                              updater::UpdaterConfig &updater_config)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
     generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message")(
         "remove-locks,r", "Remove locks")("spring-clean,s",
-                                          "Spring-cleaning all shared memory regions");
+                                          "Spring-cleaning all shared memory regions")(
+        "dataset-name",
+        boost::program_options::value<std::string>(&dataset_name)->default_value(""),
+        "Name of the dataset to load, remove the locks of or spring-clean. Every named dataset "
+        "has shared memory regions of its own, osrm-routed serves one with --dataset-name.");
 
     // declare a group of options that will be allowed both on command line
     // as well as in a config file
@@ -67,7 +97,58 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()("max-wait",
                                  boost::program_options::value<int>(&max_wait)->default_value(-1),
                                  "Maximum number of seconds to wait on a running data update "
-                                 "before aquiring the lock by force.");
+                                 "before aquiring the lock by force.")(
+        "numa-replicas",
+        boost::program_options::value<bool>(&numa_replicas)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Load a copy of the data per NUMA node, osrm-routed uses the copy of the node a "
+        "request is handled on.")(
+        "huge-pages",
+        boost::program_options::value<bool>(&huge_pages)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Back the shared memory with huge pages if enough of them are reserved.")(
+        "reuse-unchanged",
+        boost::program_options::value<bool>(&reuse_unchanged)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Copy the data of files that did not change since the data in use was loaded from "
+        "shared memory instead of reading the files.")(
+        "rtree-leaves",
+        boost::program_options::value<std::string>(&rtree_leaves)->default_value("mapped"),
+        "How the leaves of the r-tree are read: mapped from their file, random to map them "
+        "without read ahead, prefault to map them with all pages read in, or load to copy "
+        "them into shared memory.")(
+        "direct-io",
+        boost::program_options::value<bool>(&direct_io)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Read the large blocks of the data files past the page cache, which then keeps other "
+        "data.")(
+        "image",
+        boost::program_options::value<bool>(&use_image)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Load the dataset from the image written by osrm-pack with a single read instead of "
+        "the data files.")(
+        "segment-speed-file",
+        boost::program_options::value<std::vector<std::string>>(
+            &updater_config.segment_speed_lookup_paths)
+            ->composing(),
+        "Apply the segment speeds of the given files to the MLD data in shared memory instead "
+        "of loading the dataset. Updates accumulate, the dataset files are not changed.")(
+        "edge-weight-updates-over-factor",
+        boost::program_options::value<double>(&updater_config.log_edge_updates_factor)
+            ->default_value(0.0),
+        "Use with `--segment-speed-file`. Provide an `x` factor, by which Extractor will log edge "
+        "weights updated by more than this factor")(
+        "cache-lookup-files",
+        boost::program_options::bool_switch(&updater_config.cache_lookup_files)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Store a binary copy next to each lookup file, read instead of the file "
+        "while it is unchanged");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -105,6 +186,12 @@ bool generateDataStoreOptions(const int argc,
                                           .positional(positional_options)
                                           .run(),
                                       option_variables);
+        boost::program_options::notify(option_variables);
+        // the name becomes part of the names of the lock file and the monitor
+        if (!storage::IsValidDatasetName(dataset_name))
+        {
+            throw boost::program_options::invalid_option_value(dataset_name);
+        }
     }
     catch (const boost::program_options::error &e)
     {
@@ -126,24 +213,22 @@ bool generateDataStoreOptions(const int argc,
 
     if (option_variables.count("remove-locks"))
     {
-        removeLocks();
+        removeLocks(dataset_name);
         return false;
     }
 
     if (option_variables.count("spring-clean"))
     {
-        springClean();
+        springClean(dataset_name);
         return false;
     }
 
-    boost::program_options::notify(option_variables);
-
     return true;
 }
 
 [[noreturn]] void CleanupSharedBarriers(int signum)
 { // Here the lock state of named mutexes is unknown, make a hard cleanup
-    removeLocks();
+    removeLocks(dataset_name);
     std::_Exit(128 + signum);
 }
 
@@ -159,19 +244,59 @@ int main(const int argc, const char *argv[]) try
 
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, base_path, max_wait))
+    bool numa_replicas = false;
+    bool huge_pages = false;
+    bool reuse_unchanged = false;
+    std::string rtree_leaves;
+    bool direct_io = false;
+    bool use_image = false;
+    updater::UpdaterConfig updater_config;
+    if (!generateDataStoreOptions(argc,
+                                  argv,
+                                  base_path,
+                                  max_wait,
+                                  dataset_name,
+                                  numa_replicas,
+                                  huge_pages,
+                                  reuse_unchanged,
+                                  rtree_leaves,
+                                  direct_io,
+                                  use_image,
+                                  updater_config))
     {
         return EXIT_SUCCESS;
     }
     storage::StorageConfig config(base_path);
+    config.use_image = use_image;
     if (!config.IsValid())
     {
         util::Log(logERROR) << "Config contains invalid file paths. Exiting!";
         return EXIT_FAILURE;
     }
+    try
+    {
+        config.rtree_leaf_access = storage::StringToRTreeLeafAccess(rtree_leaves);
+    }
+    catch (const util::exception &e)
+    {
+        util::Log(logERROR) << e.what();
+        return EXIT_FAILURE;
+    }
+    storage::io::FileReader::UseDirectIO(direct_io);
     storage::Storage storage(std::move(config));
 
-    return storage.Run(max_wait);
+    std::unique_ptr<updater::LiveUpdate> update;
+    if (!updater_config.segment_speed_lookup_paths.empty())
+    {
+        updater_config.osrm_input_path = base_path;
+        updater_config.UseDefaultOutputNames();
+        updater_config.valid_now = 0;
+        updater_config.save_updated_data = false;
+        update = std::make_unique<updater::LiveUpdate>(std::move(updater_config));
+    }
+
+    return storage.Run(
+        max_wait, dataset_name, numa_replicas, huge_pages, reuse_unchanged, update.get());
 }
 catch (const osrm::RuntimeError &e)
 {
@@ -0,0 +1,334 @@
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+#include "util/web_mercator.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/exception.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/storage_config.hpp"
+#include "osrm/tile_parameters.hpp"
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace osrm;
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct TilesConfig
+{
+    EngineConfig engine_config;
+    std::string algorithm = "CH";
+    std::string bbox;
+    std::vector<double> bounds;
+    unsigned min_zoom = 12;
+    unsigned max_zoom = 16;
+    unsigned requested_num_threads = std::thread::hardware_concurrency();
+};
+
+bool parseBoundingBox(const std::string &bbox, std::vector<double> &bounds)
+{
+    std::vector<std::string> values;
+    boost::split(values, bbox, boost::is_any_of(","));
+    if (values.size() != 4)
+    {
+        return false;
+    }
+    try
+    {
+        std::transform(values.begin(),
+                       values.end(),
+                       std::back_inserter(bounds),
+                       [](const std::string &value) { return std::stod(value); });
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+    return bounds[0] <= bounds[2] && bounds[1] <= bounds[3];
+}
+
+return_code parseArguments(int argc, char *argv[], TilesConfig &config)
+{
+    boost::filesystem::path base_path;
+
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("bbox",
+         boost::program_options::value<std::string>(&config.bbox)->required(),
+         "Area to render as <min lon>,<min lat>,<max lon>,<max lat>")
+        //
+        ("min-zoom",
+         boost::program_options::value<unsigned>(&config.min_zoom)
+             ->default_value(config.min_zoom),
+         "Lowest zoom level to render, at least 12")
+        //
+        ("max-zoom",
+         boost::program_options::value<unsigned>(&config.max_zoom)
+             ->default_value(config.max_zoom),
+         "Highest zoom level to render, at most 19")
+        //
+        ("threads,t",
+         boost::program_options::value<unsigned>(&config.requested_num_threads)
+             ->default_value(config.requested_num_threads),
+         "Number of threads to use")
+        //
+        ("shared-memory,s",
+         boost::program_options::value<bool>(&config.engine_config.use_shared_memory)
+             ->implicit_value(true)
+             ->default_value(false),
+         "Load data from shared memory")
+        //
+        ("algorithm,a",
+         boost::program_options::value<std::string>(&config.algorithm)
+             ->default_value(config.algorithm),
+         "Algorithm to use for the data. Can be CH, CoreCH, MLD, CCH.");
+
+    // hidden options, will be allowed on command line, but will not be
+    // shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<boost::filesystem::path>(&base_path),
+        "Input file in .osrm format")(
+        "output,o",
+        boost::program_options::value<boost::filesystem::path>(
+            &config.engine_config.tile_cache_path),
+        "Tile directory to render to");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1).add("output", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() +
+        " <input.osrm> <tile directory> --bbox <min lon>,<min lat>,<max lon>,<max lat> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    try
+    {
+        boost::program_options::notify(option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (!option_variables.count("output") ||
+        (!option_variables.count("input") && !config.engine_config.use_shared_memory))
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    if (!base_path.empty())
+    {
+        config.engine_config.storage_config = storage::StorageConfig(base_path);
+    }
+
+    if (!parseBoundingBox(config.bbox, config.bounds))
+    {
+        util::Log(logERROR) << "The bounding box must be given as <min lon>,<min lat>,<max lon>,"
+                               "<max lat>";
+        return return_code::fail;
+    }
+
+    if (config.min_zoom < 12 || config.max_zoom > 19 || config.min_zoom > config.max_zoom)
+    {
+        util::Log(logERROR) << "Zoom levels must be between 12 and 19";
+        return return_code::fail;
+    }
+
+    if (config.requested_num_threads == 0)
+    {
+        util::Log(logERROR) << "Number of threads must be 1 or larger";
+        return return_code::fail;
+    }
+
+    boost::to_lower(config.algorithm);
+    if (config.algorithm == "ch")
+        config.engine_config.algorithm = EngineConfig::Algorithm::CH;
+    else if (config.algorithm == "corech")
+        config.engine_config.algorithm = EngineConfig::Algorithm::CoreCH;
+    else if (config.algorithm == "mld")
+        config.engine_config.algorithm = EngineConfig::Algorithm::MLD;
+    else if (config.algorithm == "cch")
+        config.engine_config.algorithm = EngineConfig::Algorithm::CCH;
+    else
+    {
+        util::Log(logERROR) << "Unknown algorithm " << config.algorithm;
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+// The tiles of a zoom level covering the bounding box
+std::vector<TileParameters> bboxTiles(const std::vector<double> &bbox, const unsigned zoom)
+{
+    const auto last_tile = (1u << zoom) - 1;
+    const auto toTile = [last_tile](const double pixel) {
+        const auto tile = std::floor(pixel / util::web_mercator::TILE_SIZE);
+        return static_cast<unsigned>(std::min<double>(std::max(tile, 0.), last_tile));
+    };
+
+    const auto min_x = toTile(util::web_mercator::degreeToPixel(
+        util::web_mercator::clamp(util::FloatLongitude{bbox[0]}), zoom));
+    const auto max_x = toTile(util::web_mercator::degreeToPixel(
+        util::web_mercator::clamp(util::FloatLongitude{bbox[2]}), zoom));
+    // pixels count from the north
+    const auto min_y = toTile(util::web_mercator::degreeToPixel(
+        util::web_mercator::clamp(util::FloatLatitude{bbox[3]}), zoom));
+    const auto max_y = toTile(util::web_mercator::degreeToPixel(
+        util::web_mercator::clamp(util::FloatLatitude{bbox[1]}), zoom));
+
+    std::vector<TileParameters> tiles;
+    for (auto x = min_x; x <= max_x; ++x)
+    {
+        for (auto y = min_y; y <= max_y; ++y)
+        {
+            tiles.push_back(TileParameters{x, y, zoom});
+        }
+    }
+    return tiles;
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    TilesConfig config;
+
+    const auto result = parseArguments(argc, argv, config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    if (!config.engine_config.use_shared_memory && !config.engine_config.storage_config.IsValid())
+    {
+        util::Log(logERROR) << "Required files are missing, cannot continue";
+        return EXIT_FAILURE;
+    }
+
+    // tiles are only persisted, they are not needed again by this process
+    config.engine_config.tile_cache_size = 0;
+    const OSRM osrm(config.engine_config);
+
+    std::vector<TileParameters> tiles;
+    for (auto zoom = config.min_zoom; zoom <= config.max_zoom; ++zoom)
+    {
+        const auto zoom_tiles = bboxTiles(config.bounds, zoom);
+        tiles.insert(tiles.end(), zoom_tiles.begin(), zoom_tiles.end());
+    }
+
+    util::Log() << "Rendering " << tiles.size() << " tiles to "
+                << config.engine_config.tile_cache_path.string() << " with "
+                << config.requested_num_threads << " threads";
+
+    TIMER_START(render);
+    std::atomic<std::size_t> failed{0};
+    tbb::task_arena arena(config.requested_num_threads);
+    arena.execute([&] {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, tiles.size()),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              std::string tile;
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  // tiles rendered by an earlier run are read, not rendered
+                                  if (osrm.Tile(tiles[index], tile) != Status::Ok)
+                                  {
+                                      failed++;
+                                  }
+                              }
+                          });
+    });
+    TIMER_STOP(render);
+
+    if (failed > 0)
+    {
+        util::Log(logERROR) << failed << " of " << tiles.size() << " tiles could not be rendered";
+        return EXIT_FAILURE;
+    }
+    util::Log() << "Rendering took " << TIMER_SEC(render) << " seconds.";
+
+    return EXIT_SUCCESS;
+}
+catch (const osrm::RuntimeError &e)
+{
+    util::Log(logERROR) << e.what();
+    return e.GetCode();
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
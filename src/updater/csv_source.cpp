@@ -23,6 +23,30 @@ BOOST_FUSION_ADAPT_STRUCT(osrm::updater::PenaltySource,
 namespace
 {
 namespace qi = boost::spirit::qi;
+namespace ph = boost::phoenix;
+
+using Breakpoints = std::vector<std::pair<unsigned, double>>;
+
+bool makeSpeedProfile(const Breakpoints &breakpoints, osrm::updater::SpeedProfile &profile)
+{
+    using osrm::updater::SpeedProfile;
+    if (breakpoints.empty() || breakpoints.size() > SpeedProfile::MAX_BREAKPOINTS)
+        return false;
+
+    profile.num_breakpoints = breakpoints.size();
+    for (std::size_t index = 0; index < breakpoints.size(); ++index)
+    {
+        const auto minute = breakpoints[index].first;
+        const auto speed = breakpoints[index].second;
+        const auto ordered = index == 0 || breakpoints[index - 1].first < minute;
+        if (minute >= SpeedProfile::MINUTES_PER_DAY || !ordered || !(speed >= 0.))
+            return false;
+
+        profile.minutes[index] = minute;
+        profile.speeds[index] = speed;
+    }
+    return true;
+}
 }
 
 namespace osrm
@@ -31,20 +55,37 @@ namespace updater
 {
 namespace csv
 {
-SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths)
+SegmentLookupTable readSegmentValues(const std::vector<std::string> &paths, bool use_cache)
 {
-    CSVFilesParser<Segment, SpeedSource> parser(
-        1, qi::ulong_long >> ',' >> qi::ulong_long, qi::uint_ >> -(',' >> qi::double_));
+    CSVFilesParser<Segment, SpeedSource> parser(1,
+                                                qi::ulong_long >> ',' >> qi::ulong_long,
+                                                qi::uint_ >> -(',' >> qi::double_),
+                                                use_cache);
 
     return parser(paths);
 }
 
-TurnLookupTable readTurnValues(const std::vector<std::string> &paths)
+TurnLookupTable readTurnValues(const std::vector<std::string> &paths, bool use_cache)
 {
     CSVFilesParser<Turn, PenaltySource> parser(1,
                                                qi::ulong_long >> ',' >> qi::ulong_long >> ',' >>
                                                    qi::ulong_long,
-                                               qi::double_ >> -(',' >> qi::double_));
+                                               qi::double_ >> -(',' >> qi::double_),
+                                               use_cache);
+    return parser(paths);
+}
+
+SpeedProfileLookupTable readSpeedProfiles(const std::vector<std::string> &paths,
+                                          std::size_t start_index,
+                                          bool use_cache)
+{
+    using Iterator = CSVFilesParser<Segment, SpeedProfile>::Iterator;
+    const qi::rule<Iterator, Breakpoints()> breakpoints = (qi::uint_ >> ':' >> qi::double_) % ',';
+    const qi::rule<Iterator, SpeedProfile()> profile =
+        breakpoints[qi::_pass = ph::bind(&makeSpeedProfile, qi::_1, qi::_val)];
+
+    CSVFilesParser<Segment, SpeedProfile> parser(
+        start_index, qi::ulong_long >> ',' >> qi::ulong_long, profile, use_cache);
     return parser(paths);
 }
 }
@@ -0,0 +1,252 @@
+#include "updater/live_update.hpp"
+#include "updater/updater.hpp"
+
+#include "customizer/cell_customizer.hpp"
+
+#include "partition/edge_based_graph_reader.hpp"
+#include "partition/files.hpp"
+
+#include "storage/view_factory.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/vector_view.hpp"
+
+#include <algorithm>
+
+namespace osrm
+{
+namespace updater
+{
+
+namespace
+{
+const constexpr storage::DataLayout::BlockID OVERLAY_HIERARCHY_BLOCKS[] = {
+    storage::DataLayout::MLD_OVERLAY_NODES,
+    storage::DataLayout::MLD_OVERLAY_FORWARD_OFFSETS,
+    storage::DataLayout::MLD_OVERLAY_FORWARD_ARCS,
+    storage::DataLayout::MLD_OVERLAY_BACKWARD_OFFSETS,
+    storage::DataLayout::MLD_OVERLAY_BACKWARD_ARCS};
+
+const constexpr storage::DataLayout::BlockID LANDMARK_BLOCKS[] = {
+    storage::DataLayout::LANDMARK_NODES,
+    storage::DataLayout::LANDMARK_UNITS,
+    storage::DataLayout::LANDMARK_DISTANCES};
+
+const constexpr storage::DataLayout::BlockID DISTANCE_ORACLE_BLOCKS[] = {
+    storage::DataLayout::DISTANCE_ORACLE_REPRESENTATIVES,
+    storage::DataLayout::DISTANCE_ORACLE_CELLS,
+    storage::DataLayout::DISTANCE_ORACLE_NODE_DURATIONS,
+    storage::DataLayout::DISTANCE_ORACLE_CELL_DURATIONS};
+
+template <typename T>
+void copyBlock(const storage::DataLayout &layout,
+               char *memory,
+               const storage::DataLayout::BlockID bid,
+               std::vector<T> &data)
+{
+    const auto ptr = layout.GetBlockPtr<T>(memory, bid);
+    data.assign(ptr, ptr + layout.num_entries[bid]);
+}
+
+template <typename T>
+void writeBlock(const storage::DataLayout &layout,
+                char *memory,
+                const storage::DataLayout::BlockID bid,
+                const std::vector<T> &data)
+{
+    BOOST_ASSERT(layout.num_entries[bid] == data.size());
+    const auto ptr = layout.GetBlockPtr<T, true>(memory, bid);
+    std::copy(data.begin(), data.end(), ptr);
+}
+}
+
+LiveUpdate::LiveUpdate(UpdaterConfig config_) : config(std::move(config_))
+{
+    if (!config.turn_penalty_lookup_paths.empty() || config.valid_now > 0)
+        throw util::exception("Only segment speeds can be updated in shared memory" + SOURCE_REF);
+}
+
+storage::BlockSet LiveUpdate::Prepare(const storage::DataLayout &in_use_layout,
+                                      char *in_use_memory,
+                                      storage::DataLayout &layout)
+{
+    using storage::DataLayout;
+
+    if (in_use_layout.GetBlockSize(DataLayout::MLD_GRAPH_NODE_LIST) == 0 ||
+        in_use_layout.GetBlockSize(DataLayout::MLD_CELLS) == 0)
+        throw util::exception("Updates in shared memory need a customized MLD dataset" +
+                              SOURCE_REF);
+
+    const auto in_use_cells = storage::make_cell_storage_view(in_use_memory, in_use_layout);
+    if (in_use_cells.GetNumberOfMetrics() != 1)
+        throw util::exception("Updates in shared memory support a single metric only" +
+                              SOURCE_REF);
+
+    if (in_use_layout.GetBlockSize(DataLayout::CH_GRAPH_NODE_LIST) > 0)
+        util::Log(logWARNING) << "The CH graph is not updated, only MLD queries use the updates";
+
+    TIMER_START(update);
+
+    copyBlock(in_use_layout, in_use_memory, DataLayout::GEOMETRIES_FWD_WEIGHT_LIST, fwd_weights);
+    copyBlock(in_use_layout, in_use_memory, DataLayout::GEOMETRIES_REV_WEIGHT_LIST, rev_weights);
+    copyBlock(
+        in_use_layout, in_use_memory, DataLayout::GEOMETRIES_FWD_DURATION_LIST, fwd_durations);
+    copyBlock(
+        in_use_layout, in_use_memory, DataLayout::GEOMETRIES_REV_DURATION_LIST, rev_durations);
+    copyBlock(in_use_layout, in_use_memory, DataLayout::DATASOURCES_LIST, datasources);
+
+    // the geometry itself is not changed by an update and is read from the data in use
+    const auto num_entries = in_use_layout.num_entries[DataLayout::GEOMETRIES_NODE_LIST];
+    util::vector_view<unsigned> index(
+        in_use_layout.GetBlockPtr<unsigned>(in_use_memory, DataLayout::GEOMETRIES_INDEX),
+        in_use_layout.num_entries[DataLayout::GEOMETRIES_INDEX]);
+    util::vector_view<NodeID> nodes(
+        in_use_layout.GetBlockPtr<NodeID>(in_use_memory, DataLayout::GEOMETRIES_NODE_LIST),
+        num_entries);
+
+    using SegmentWeightVector = extractor::SegmentDataView::SegmentWeightVector;
+    using SegmentDurationVector = extractor::SegmentDataView::SegmentDurationVector;
+    extractor::SegmentDataView segment_data{
+        std::move(index),
+        std::move(nodes),
+        SegmentWeightVector{util::vector_view<SegmentWeightBlock>(fwd_weights.data(),
+                                                                  fwd_weights.size()),
+                            num_entries},
+        SegmentWeightVector{util::vector_view<SegmentWeightBlock>(rev_weights.data(),
+                                                                  rev_weights.size()),
+                            num_entries},
+        SegmentDurationVector{util::vector_view<SegmentDurationBlock>(fwd_durations.data(),
+                                                                      fwd_durations.size()),
+                              num_entries},
+        SegmentDurationVector{util::vector_view<SegmentDurationBlock>(rev_durations.data(),
+                                                                      rev_durations.size()),
+                              num_entries},
+        util::vector_view<DatasourceID>(datasources.data(), datasources.size())};
+
+    Updater updater(config);
+    std::vector<extractor::EdgeBasedEdge> edge_based_edge_list;
+    const auto num_nodes =
+        updater.LoadAndUpdateEdgeExpandedGraph(segment_data, edge_based_edge_list) + 1;
+    datasources_names = updater.GetDatasources();
+
+    partition::files::readPartition(config.osrm_input_path.string() + ".partition", mlp);
+
+    auto directed = partition::splitBidirectionalEdges(edge_based_edge_list);
+    auto tidied = partition::prepareEdgesForUsageInGraph<customizer::StaticEdgeBasedGraphEdge>(
+        std::move(directed));
+    graph =
+        std::make_unique<customizer::MultiLevelEdgeBasedGraph>(mlp, num_nodes, std::move(tidied));
+
+    // Only the cells of changed edges need to be customized again, unless an update changed
+    // the topology of the graph by closing or opening roads
+    const auto in_use_graph = storage::make_multi_level_graph_view(in_use_memory, in_use_layout);
+    changed_cells = customizer::CellCustomizer(mlp).GetChangedCells(*graph, in_use_graph);
+    if (changed_cells.empty())
+        util::Log() << "Graph topology changed, customizing all cells";
+
+    layout.SetBlockSize<customizer::MultiLevelEdgeBasedGraph::NodeArrayEntry>(
+        DataLayout::MLD_GRAPH_NODE_LIST, graph->GetNodeArraySize());
+    layout.SetBlockSize<customizer::MultiLevelEdgeBasedGraph::EdgeArrayEntry>(
+        DataLayout::MLD_GRAPH_EDGE_LIST, graph->GetEdgeArraySize());
+    layout.SetBlockSize<customizer::MultiLevelEdgeBasedGraph::EdgeOffset>(
+        DataLayout::MLD_GRAPH_NODE_TO_OFFSET, graph->GetNodeToEdgeOffsetSize());
+
+    TIMER_STOP(update);
+    util::Log() << "Updated the edge based graph in " << TIMER_SEC(update) << " seconds";
+
+    storage::BlockSet updated_blocks;
+
+    // the overlay hierarchy is contracted from the cells of the old weights, without it the
+    // queries use the customized overlay graph of the top level again
+    if (in_use_layout.GetBlockSize(DataLayout::MLD_OVERLAY_NODES) > 0)
+    {
+        util::Log(logWARNING) << "The overlay hierarchy is not updated, it is removed";
+        for (const auto bid : OVERLAY_HIERARCHY_BLOCKS)
+        {
+            layout.SetBlockSize<char>(bid, 0);
+            updated_blocks.set(bid);
+        }
+    }
+
+    // lower bounds of the old weights overestimate the ones that got faster since
+    if (in_use_layout.GetBlockSize(DataLayout::LANDMARK_NODES) > 0)
+    {
+        util::Log(logWARNING) << "The landmarks are not updated, they are removed";
+        for (const auto bid : LANDMARK_BLOCKS)
+        {
+            layout.SetBlockSize<char>(bid, 0);
+            updated_blocks.set(bid);
+        }
+    }
+
+    // the bounds of the old durations don't hold for the new ones
+    if (in_use_layout.GetBlockSize(DataLayout::DISTANCE_ORACLE_REPRESENTATIVES) > 0)
+    {
+        util::Log(logWARNING) << "The distance oracle is not updated, it is removed";
+        for (const auto bid : DISTANCE_ORACLE_BLOCKS)
+        {
+            layout.SetBlockSize<char>(bid, 0);
+            updated_blocks.set(bid);
+        }
+    }
+
+    for (const auto bid : {DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+                           DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+                           DataLayout::GEOMETRIES_FWD_DURATION_LIST,
+                           DataLayout::GEOMETRIES_REV_DURATION_LIST,
+                           DataLayout::DATASOURCES_LIST,
+                           DataLayout::DATASOURCES_NAMES,
+                           DataLayout::MLD_GRAPH_NODE_LIST,
+                           DataLayout::MLD_GRAPH_EDGE_LIST,
+                           DataLayout::MLD_GRAPH_NODE_TO_OFFSET})
+    {
+        updated_blocks.set(bid);
+    }
+    return updated_blocks;
+}
+
+void LiveUpdate::Write(const storage::DataLayout &layout, char *memory)
+{
+    using storage::DataLayout;
+
+    writeBlock(layout, memory, DataLayout::GEOMETRIES_FWD_WEIGHT_LIST, fwd_weights);
+    writeBlock(layout, memory, DataLayout::GEOMETRIES_REV_WEIGHT_LIST, rev_weights);
+    writeBlock(layout, memory, DataLayout::GEOMETRIES_FWD_DURATION_LIST, fwd_durations);
+    writeBlock(layout, memory, DataLayout::GEOMETRIES_REV_DURATION_LIST, rev_durations);
+    writeBlock(layout, memory, DataLayout::DATASOURCES_LIST, datasources);
+    *layout.GetBlockPtr<extractor::Datasources, true>(memory, DataLayout::DATASOURCES_NAMES) =
+        datasources_names;
+
+    auto graph_view = storage::make_multi_level_graph_view<true>(memory, layout);
+    graph->CopyTo(graph_view);
+
+    // writes the canaries of the overlay hierarchy, the landmarks and the distance oracle if they
+    // were removed
+    for (const auto bid : OVERLAY_HIERARCHY_BLOCKS)
+    {
+        if (layout.GetBlockSize(bid) == 0)
+            layout.GetBlockPtr<char, true>(memory, bid);
+    }
+    for (const auto bid : LANDMARK_BLOCKS)
+    {
+        if (layout.GetBlockSize(bid) == 0)
+            layout.GetBlockPtr<char, true>(memory, bid);
+    }
+    for (const auto bid : DISTANCE_ORACLE_BLOCKS)
+    {
+        if (layout.GetBlockSize(bid) == 0)
+            layout.GetBlockPtr<char, true>(memory, bid);
+    }
+
+    // the cells were copied from the data in use
+    TIMER_START(customize);
+    auto cells = storage::make_cell_storage_view(memory, layout);
+    customizer::CellCustomizer(mlp).Customize(*graph, cells, 0, changed_cells);
+    TIMER_STOP(customize);
+    util::Log() << "Cells customization took " << TIMER_SEC(customize) << " seconds";
+}
+}
+}
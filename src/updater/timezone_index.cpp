@@ -0,0 +1,180 @@
+#include "updater/timezone_index.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/optional.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace updater
+{
+
+namespace
+{
+// Size and modification time of the files an index was built from
+std::vector<std::int64_t> getSourceStamps(const UpdaterConfig &config)
+{
+    std::vector<std::int64_t> stamps;
+    for (const auto &path : {config.tz_file_path, config.turn_restrictions_path})
+    {
+        if (!boost::filesystem::exists(path))
+            throw util::exception("failed to open " + path + SOURCE_REF);
+        stamps.push_back(boost::filesystem::file_size(path));
+        stamps.push_back(boost::filesystem::last_write_time(path));
+    }
+    return stamps;
+}
+
+boost::optional<TimezoneIndex> readTimezoneIndex(const std::string &path,
+                                                 const std::vector<std::int64_t> &stamps,
+                                                 const std::size_t num_restrictions)
+{
+    if (!boost::filesystem::exists(path))
+        return boost::none;
+
+    storage::io::FileReader reader{path, storage::io::FileReader::VerifyFingerprint};
+    std::vector<std::int64_t> index_stamps;
+    storage::serialization::read(reader, index_stamps);
+    if (index_stamps != stamps)
+        return boost::none;
+
+    // time zone names are stored one after the other, each terminated by a null character
+    std::vector<char> packed_names;
+    std::vector<std::uint32_t> timezones;
+    storage::serialization::read(reader, packed_names);
+    storage::serialization::read(reader, timezones);
+    if (timezones.size() != num_restrictions)
+        return boost::none;
+
+    std::vector<std::string> names;
+    for (auto name = packed_names.begin(); name != packed_names.end();)
+    {
+        const auto end = std::find(name, packed_names.end(), '\0');
+        names.emplace_back(name, end);
+        name = end == packed_names.end() ? end : std::next(end);
+    }
+
+    const auto num_names = names.size();
+    if (std::any_of(timezones.begin(), timezones.end(), [num_names](const auto id) {
+            return id != INVALID_TIMEZONE_ID && id >= num_names;
+        }))
+        throw util::exception("Time zone index " + path + " refers to unknown time zones" +
+                              SOURCE_REF);
+
+    return TimezoneIndex{std::move(names), std::move(timezones)};
+}
+
+void writeTimezoneIndex(const std::string &path,
+                        const std::vector<std::int64_t> &stamps,
+                        const TimezoneIndex &index)
+{
+    std::vector<char> packed_names;
+    for (const auto &name : index.GetTimezoneNames())
+    {
+        packed_names.insert(packed_names.end(), name.begin(), name.end());
+        packed_names.push_back('\0');
+    }
+
+    storage::io::FileWriter writer{path, storage::io::FileWriter::GenerateFingerprint};
+    storage::serialization::write(writer, stamps);
+    storage::serialization::write(writer, packed_names);
+    storage::serialization::write(writer, index.GetTimezoneIDs());
+}
+}
+
+TimezoneIndex::TimezoneIndex(std::vector<std::string> names_,
+                             std::vector<std::uint32_t> timezones_)
+    : names(std::move(names_)), timezones(std::move(timezones_))
+{
+}
+
+TimezoneIndex::TimezoneIndex(const Timezoner &timezoner,
+                             const std::vector<extractor::TurnRestriction> &restrictions,
+                             const std::vector<util::Coordinate> &coordinates)
+    : timezones(restrictions.size(), INVALID_TIMEZONE_ID)
+{
+    // the point in polygon tests are independent, only the ids are assigned in order
+    std::vector<boost::optional<std::string>> restriction_names(restrictions.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, restrictions.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (const auto index : util::irange(range.begin(), range.end()))
+                          {
+                              const auto &via = coordinates[restrictions[index].via.node];
+                              const auto lon = static_cast<double>(util::toFloating(via.lon));
+                              const auto lat = static_cast<double>(util::toFloating(via.lat));
+                              restriction_names[index] =
+                                  timezoner.GetTimezoneName(point_t{lon, lat});
+                          }
+                      });
+
+    std::unordered_map<std::string, std::uint32_t> name_to_id;
+    for (const auto index : util::irange<std::size_t>(0, restrictions.size()))
+    {
+        if (!restriction_names[index])
+            continue;
+
+        const auto inserted = name_to_id.insert({*restriction_names[index], names.size()});
+        if (inserted.second)
+            names.push_back(*restriction_names[index]);
+        timezones[index] = inserted.first->second;
+    }
+}
+
+std::vector<struct tm> TimezoneIndex::GetLocalTimes(const std::time_t utc_time) const
+{
+    std::vector<struct tm> local_times;
+    local_times.reserve(names.size());
+    for (const auto &name : names)
+        local_times.push_back(getLocalTime(name.c_str(), utc_time));
+    return local_times;
+}
+
+TimezoneIndex loadTimezoneIndex(const UpdaterConfig &config,
+                                const std::vector<extractor::TurnRestriction> &restrictions,
+                                const std::vector<util::Coordinate> &coordinates)
+{
+    if (config.tz_file_path.empty())
+        throw util::exception("Missing time zone geojson file" + SOURCE_REF);
+
+    const auto stamps = getSourceStamps(config);
+    if (auto index = readTimezoneIndex(config.timezone_index_path, stamps, restrictions.size()))
+    {
+        util::Log() << "Loaded the time zones of " << restrictions.size()
+                    << " conditional restrictions from " << config.timezone_index_path;
+        return std::move(*index);
+    }
+
+    TIMER_START(build_index);
+    const Timezoner timezoner(config.tz_file_path, config.valid_now);
+    TimezoneIndex index(timezoner, restrictions, coordinates);
+    TIMER_STOP(build_index);
+    util::Log() << "Resolving the time zones of " << restrictions.size()
+                << " conditional restrictions took " << TIMER_MSEC(build_index) << "ms.";
+
+    // the index only saves time on the next update, failing to write it is not an error
+    try
+    {
+        writeTimezoneIndex(config.timezone_index_path, stamps, index);
+    }
+    catch (const util::exception &e)
+    {
+        util::Log(logWARNING) << "Could not write the time zone index: " << e.what();
+    }
+
+    return index;
+}
+}
+}
@@ -1,7 +1,10 @@
 #include "updater/updater.hpp"
 #include "updater/csv_source.hpp"
+#include "updater/timezone_index.hpp"
+#include "updater/way_speed_source.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
+#include "extractor/conditional_turn_masks.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/files.hpp"
 #include "extractor/node_based_edge.hpp"
@@ -25,27 +28,35 @@
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/geometry.hpp>
 #include <boost/geometry/index/rtree.hpp>
 #include <boost/interprocess/file_mapping.hpp>
 #include <boost/interprocess/mapped_region.hpp>
+#include <boost/optional.hpp>
 
 #include <tbb/blocked_range.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
 #include <tbb/parallel_invoke.h>
 
 #include <algorithm>
 #include <atomic>
 #include <bitset>
+#include <cmath>
 #include <cstdint>
+#include <ctime>
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <numeric>
 #include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace std
@@ -142,18 +153,127 @@ void checkWeightsConsistency(
 }
 #endif
 
-tbb::concurrent_vector<GeometryID>
+// The files the speeds of updated segments come from, their sources are numbered from 1 on
+std::vector<std::string> speedSourcePaths(const UpdaterConfig &config)
+{
+    auto paths = config.segment_speed_lookup_paths;
+    paths.insert(paths.end(),
+                 config.speed_profile_lookup_paths.begin(),
+                 config.speed_profile_lookup_paths.end());
+    paths.insert(paths.end(),
+                 config.way_speed_lookup_paths.begin(),
+                 config.way_speed_lookup_paths.end());
+    return paths;
+}
+
+// Merges two lookups sorted in descending key order, the value of `preferred` is kept for
+// segments in both
+SegmentLookupTable mergeSpeeds(const std::vector<std::pair<Segment, SpeedSource>> &preferred,
+                               const std::vector<std::pair<Segment, SpeedSource>> &other)
+{
+    const auto by_key = [](const auto &lhs, const auto &rhs) { return rhs.first < lhs.first; };
+    SegmentLookupTable result;
+    result.lookup.reserve(preferred.size() + other.size());
+    std::merge(preferred.begin(),
+               preferred.end(),
+               other.begin(),
+               other.end(),
+               std::back_inserter(result.lookup),
+               by_key);
+    result.lookup.erase(std::unique(result.lookup.begin(),
+                                    result.lookup.end(),
+                                    [](const auto &lhs, const auto &rhs) {
+                                        return lhs.first == rhs.first;
+                                    }),
+                        result.lookup.end());
+    return result;
+}
+
+// Speeds of the profiles at `minute` after midnight replacing the ones of the same segments
+SegmentLookupTable applySpeedProfiles(const SegmentLookupTable &segment_speed_lookup,
+                                      const SpeedProfileLookupTable &speed_profile_lookup,
+                                      const std::uint32_t minute)
+{
+    std::vector<std::pair<Segment, SpeedSource>> profile_speeds(
+        speed_profile_lookup.lookup.size());
+    std::transform(speed_profile_lookup.lookup.begin(),
+                   speed_profile_lookup.lookup.end(),
+                   profile_speeds.begin(),
+                   [minute](const auto &segment_and_profile) {
+                       SpeedSource value;
+                       value.speed = std::lround(segment_and_profile.second(minute));
+                       value.source = segment_and_profile.second.source;
+                       return std::make_pair(segment_and_profile.first, value);
+                   });
+
+    // both lookups are sorted in descending key order
+    return mergeSpeeds(profile_speeds, segment_speed_lookup.lookup);
+}
+
+// Flags of the directions of a geometry that were updated
+const constexpr std::uint8_t FORWARD_UPDATED = 1;
+const constexpr std::uint8_t REVERSE_UPDATED = 2;
+
+// Collects the updated directions of all geometries ordered by geometry id and direction. Each
+// block of geometries is counted and then written at its offset by a single task.
+std::vector<GeometryID> collectUpdatedSegments(const std::vector<std::uint8_t> &updated_directions)
+{
+    const constexpr std::size_t BLOCK_SIZE = 1 << 16;
+    const auto num_geometries = updated_directions.size();
+    const auto num_blocks = (num_geometries + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const auto block_range = [&](const std::size_t block) {
+        const auto begin = block * BLOCK_SIZE;
+        return util::irange<std::size_t>(begin, std::min(num_geometries, begin + BLOCK_SIZE));
+    };
+
+    std::vector<std::size_t> block_offsets(num_blocks + 1, 0);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_blocks), [&](const auto &range) {
+        for (auto block = range.begin(); block < range.end(); ++block)
+        {
+            std::size_t count = 0;
+            for (const auto geometry_id : block_range(block))
+            {
+                const auto directions = updated_directions[geometry_id];
+                count += (directions & FORWARD_UPDATED) + (directions >> 1);
+            }
+            block_offsets[block + 1] = count;
+        }
+    });
+    std::partial_sum(block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+    std::vector<GeometryID> updated_segments(block_offsets.back());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_blocks), [&](const auto &range) {
+        for (auto block = range.begin(); block < range.end(); ++block)
+        {
+            auto output = updated_segments.begin() + block_offsets[block];
+            for (const auto geometry_id : block_range(block))
+            {
+                const auto directions = updated_directions[geometry_id];
+                if (directions & REVERSE_UPDATED)
+                    *output++ = GeometryID{static_cast<NodeID>(geometry_id), false};
+                if (directions & FORWARD_UPDATED)
+                    *output++ = GeometryID{static_cast<NodeID>(geometry_id), true};
+            }
+        }
+    });
+
+    return updated_segments;
+}
+
+template <typename SegmentDataT>
+std::vector<GeometryID>
 updateSegmentData(const UpdaterConfig &config,
                   const extractor::ProfileProperties &profile_properties,
                   const SegmentLookupTable &segment_speed_lookup,
-                  extractor::SegmentDataContainer &segment_data,
+                  SegmentDataT &segment_data,
                   std::vector<util::Coordinate> &coordinates,
                   extractor::PackedOSMIDs &osm_node_ids)
 {
     // vector to count used speeds for logging
     // size offset by one since index 0 is used for speeds not from external file
     using counters_type = std::vector<std::size_t>;
-    std::size_t num_counters = config.segment_speed_lookup_paths.size() + 1;
+    const auto source_paths = speedSourcePaths(config);
+    std::size_t num_counters = source_paths.size() + 1;
     tbb::enumerable_thread_specific<counters_type> segment_speeds_counters(
         counters_type(num_counters, 0));
     const constexpr auto LUA_SOURCE = 0;
@@ -187,30 +307,49 @@ updateSegmentData(const UpdaterConfig &config,
 
     // The check here is enabled by the `--edge-weight-updates-over-factor` flag it logs a
     // warning if the new duration exceeds a heuristic of what a reasonable duration update is
-    std::unique_ptr<extractor::SegmentDataContainer> segment_data_backup;
+    using DirectionalGeometryID = extractor::SegmentDataContainer::DirectionalGeometryID;
+    std::vector<SegmentDuration> old_fwd_durations;
+    std::vector<SegmentDuration> old_rev_durations;
     if (config.log_edge_updates_factor > 0)
     {
-        // copy the old data so we can compare later
-        segment_data_backup = std::make_unique<extractor::SegmentDataContainer>(segment_data);
+        // copy the old durations so we can compare later, the segment data might be a view
+        // so only the durations are copied, both oriented in forward direction
+        std::vector<SegmentDuration> durations;
+        for (const auto geometry_id :
+             util::irange<DirectionalGeometryID>(0, segment_data.GetNumberOfGeometries()))
+        {
+            segment_data.DecodeForwardDurations(geometry_id, durations);
+            old_fwd_durations.insert(old_fwd_durations.end(), durations.begin(), durations.end());
+            segment_data.DecodeReverseDurations(geometry_id, durations);
+            old_rev_durations.insert(
+                old_rev_durations.end(), durations.rbegin(), durations.rend());
+        }
     }
 
-    tbb::concurrent_vector<GeometryID> updated_segments;
+    // every geometry is handled by a single task, so its flags are written without contention
+    std::vector<std::uint8_t> updated_directions(segment_data.GetNumberOfGeometries(), 0);
 
-    using DirectionalGeometryID = extractor::SegmentDataContainer::DirectionalGeometryID;
     auto range = tbb::blocked_range<DirectionalGeometryID>(0, segment_data.GetNumberOfGeometries());
     tbb::parallel_for(range, [&, LUA_SOURCE](const auto &range) {
         auto &counters = segment_speeds_counters.local();
+        std::vector<util::Coordinate> geometry_coordinates;
         std::vector<double> segment_lengths;
         for (auto geometry_id = range.begin(); geometry_id < range.end(); geometry_id++)
         {
             auto nodes_range = segment_data.GetForwardGeometry(geometry_id);
 
-            segment_lengths.clear();
-            segment_lengths.reserve(nodes_range.size() + 1);
-            util::for_each_pair(nodes_range, [&](const auto &u, const auto &v) {
-                segment_lengths.push_back(util::coordinate_calculation::greatCircleDistance(
-                    coordinates[u], coordinates[v]));
-            });
+            // the lengths of all segments of the geometry are computed in one batch
+            geometry_coordinates.clear();
+            for (const auto node : nodes_range)
+            {
+                geometry_coordinates.push_back(coordinates[node]);
+            }
+            segment_lengths.resize(geometry_coordinates.empty() ? 0
+                                                                : geometry_coordinates.size() - 1);
+            util::coordinate_calculation::greatCircleDistances(geometry_coordinates.data(),
+                                                               geometry_coordinates.data() + 1,
+                                                               segment_lengths.size(),
+                                                               segment_lengths.data());
 
             auto fwd_weights_range = segment_data.GetForwardWeights(geometry_id);
             auto fwd_durations_range = segment_data.GetForwardDurations(geometry_id);
@@ -238,7 +377,7 @@ updateSegmentData(const UpdaterConfig &config,
                 }
             }
             if (fwd_was_updated)
-                updated_segments.push_back(GeometryID{geometry_id, true});
+                updated_directions[geometry_id] |= FORWARD_UPDATED;
 
             // In this case we want it oriented from in forward directions
             auto rev_weights_range =
@@ -271,7 +410,7 @@ updateSegmentData(const UpdaterConfig &config,
                 }
             }
             if (rev_was_updated)
-                updated_segments.push_back(GeometryID{geometry_id, false});
+                updated_directions[geometry_id] |= REVERSE_UPDATED;
         }
     }); // parallel_for
 
@@ -296,7 +435,7 @@ updateSegmentData(const UpdaterConfig &config,
             // segments_speeds_counters has 0 as LUA, segment_speed_filenames not, thus we need
             // to susbstract 1 to avoid off-by-one error
             util::Log() << "Used " << merged_counters[i] << " speeds from "
-                        << config.segment_speed_lookup_paths[i - 1];
+                        << source_paths[i - 1];
         }
     }
 
@@ -309,8 +448,7 @@ updateSegmentData(const UpdaterConfig &config,
 
     if (config.log_edge_updates_factor > 0)
     {
-        BOOST_ASSERT(segment_data_backup);
-
+        std::size_t old_durations_offset = 0;
         for (const auto geometry_id :
              util::irange<DirectionalGeometryID>(0, segment_data.GetNumberOfGeometries()))
         {
@@ -321,9 +459,9 @@ updateSegmentData(const UpdaterConfig &config,
             auto new_rev_durations_range =
                 boost::adaptors::reverse(segment_data.GetReverseDurations(geometry_id));
             auto new_rev_datasources_range = segment_data.GetForwardDatasources(geometry_id);
-            auto old_fwd_durations_range = segment_data_backup->GetForwardDurations(geometry_id);
-            auto old_rev_durations_range =
-                boost::adaptors::reverse(segment_data_backup->GetReverseDurations(geometry_id));
+            auto old_fwd_durations_begin = old_fwd_durations.begin() + old_durations_offset;
+            auto old_rev_durations_begin = old_rev_durations.begin() + old_durations_offset;
+            old_durations_offset += new_fwd_durations_range.size();
 
             for (const auto segment_offset :
                  util::irange<std::size_t>(0, new_fwd_durations_range.size()))
@@ -331,17 +469,17 @@ updateSegmentData(const UpdaterConfig &config,
                 if (new_fwd_datasources_range[segment_offset] == LUA_SOURCE)
                     continue;
 
-                if (old_fwd_durations_range[segment_offset] >=
+                if (old_fwd_durations_begin[segment_offset] >=
                     (new_fwd_durations_range[segment_offset] * config.log_edge_updates_factor))
                 {
                     auto from = osm_node_ids[nodes_range[segment_offset]];
                     auto to = osm_node_ids[nodes_range[segment_offset + 1]];
                     util::Log(logWARNING)
                         << "[weight updates] Edge weight update from "
-                        << old_fwd_durations_range[segment_offset] / 10. << "s to "
+                        << old_fwd_durations_begin[segment_offset] / 10. << "s to "
                         << new_fwd_durations_range[segment_offset] / 10. << "s Segment: " << from
                         << "," << to << " based on "
-                        << config.segment_speed_lookup_paths
+                        << source_paths
                                [new_fwd_datasources_range[segment_offset] - 1];
                 }
             }
@@ -352,27 +490,27 @@ updateSegmentData(const UpdaterConfig &config,
                 if (new_rev_datasources_range[segment_offset] == LUA_SOURCE)
                     continue;
 
-                if (old_rev_durations_range[segment_offset] >=
+                if (old_rev_durations_begin[segment_offset] >=
                     (new_rev_durations_range[segment_offset] * config.log_edge_updates_factor))
                 {
                     auto from = osm_node_ids[nodes_range[segment_offset + 1]];
                     auto to = osm_node_ids[nodes_range[segment_offset]];
                     util::Log(logWARNING)
                         << "[weight updates] Edge weight update from "
-                        << old_rev_durations_range[segment_offset] / 10. << "s to "
+                        << old_rev_durations_begin[segment_offset] / 10. << "s to "
                         << new_rev_durations_range[segment_offset] / 10. << "s Segment: " << from
                         << "," << to << " based on "
-                        << config.segment_speed_lookup_paths
+                        << source_paths
                                [new_rev_datasources_range[segment_offset] - 1];
                 }
             }
         }
     }
 
-    return updated_segments;
+    return collectUpdatedSegments(updated_directions);
 }
 
-void saveDatasourcesNames(const UpdaterConfig &config)
+extractor::Datasources makeDatasources(const UpdaterConfig &config)
 {
     extractor::Datasources sources;
     DatasourceID source = 0;
@@ -382,22 +520,51 @@ void saveDatasourcesNames(const UpdaterConfig &config)
     // Only write the filename, without path or extension.
     // This prevents information leakage, and keeps names short
     // for rendering in the debug tiles.
-    for (auto const &name : config.segment_speed_lookup_paths)
+    for (auto const &name : speedSourcePaths(config))
     {
         sources.SetSourceName(source, boost::filesystem::path(name).stem().string());
         source++;
     }
 
+    return sources;
+}
+
+void saveDatasourcesNames(const UpdaterConfig &config)
+{
+    auto sources = makeDatasources(config);
     extractor::files::writeDatasources(config.datasource_names_path, sources);
 }
 
+// Turns are looked up in chunks of consecutive turns. The OSM ids of a chunk are sorted and
+// merged with the sorted penalties, so every lookup continues where the previous one ended.
+const constexpr std::uint64_t TURN_PENALTY_CHUNK_SIZE = 64 * 1024;
+
+using TurnPenaltyIterator = decltype(TurnLookupTable::lookup)::const_iterator;
+
+// First penalty in [first, last) that is not less than the turn, searched with doubling steps
+// from first because the turns of a chunk are looked up in order
+TurnPenaltyIterator
+lowerBoundFrom(TurnPenaltyIterator first, const TurnPenaltyIterator last, const Turn &turn)
+{
+    std::ptrdiff_t step = 1;
+    while (last - first > step && first[step].first < turn)
+    {
+        first += step;
+        step *= 2;
+    }
+    return std::lower_bound(first,
+                            last - first > step ? first + step : last,
+                            turn,
+                            [](const auto &lhs, const auto &rhs) { return lhs.first < rhs; });
+}
+
 std::vector<std::uint64_t>
 updateTurnPenalties(const UpdaterConfig &config,
                     const extractor::ProfileProperties &profile_properties,
                     const TurnLookupTable &turn_penalty_lookup,
                     std::vector<TurnPenalty> &turn_weight_penalties,
                     std::vector<TurnPenalty> &turn_duration_penalties,
-                    extractor::PackedOSMIDs osm_node_ids)
+                    const extractor::PackedOSMIDs &osm_node_ids)
 {
     const auto weight_multiplier = profile_properties.GetWeightMultiplier();
 
@@ -406,46 +573,77 @@ updateTurnPenalties(const UpdaterConfig &config,
     auto turn_index_blocks = util::mmapFile<extractor::lookup::TurnIndexBlock>(
         config.turn_penalties_index_path, turn_index_region);
 
-    // Get the turn penalty and update to the new value if required
+    using TurnAndIndex = std::pair<Turn, std::uint64_t>;
+    tbb::enumerable_thread_specific<std::vector<TurnAndIndex>> chunk_turns;
+    tbb::enumerable_thread_specific<std::vector<std::uint64_t>> updated_turns_per_thread;
+
+    const auto &penalties = turn_penalty_lookup.lookup;
+    tbb::parallel_for(
+        tbb::blocked_range<std::uint64_t>(0, turn_weight_penalties.size(), TURN_PENALTY_CHUNK_SIZE),
+        [&](const tbb::blocked_range<std::uint64_t> &range) {
+            // edges are stored by internal OSRM ids, these need to be mapped back to OSM ids
+            auto &turns = chunk_turns.local();
+            turns.clear();
+            for (auto edge_index = range.begin(); edge_index < range.end(); ++edge_index)
+            {
+                const extractor::lookup::TurnIndexBlock internal_turn =
+                    turn_index_blocks[edge_index];
+                turns.emplace_back(Turn{osm_node_ids[internal_turn.from_id],
+                                        osm_node_ids[internal_turn.via_id],
+                                        osm_node_ids[internal_turn.to_id]},
+                                   edge_index);
+            }
+            std::sort(turns.begin(), turns.end(), [](const auto &lhs, const auto &rhs) {
+                return lhs.first < rhs.first;
+            });
+
+            auto &updated_turns = updated_turns_per_thread.local();
+            auto penalty = penalties.begin();
+            for (const auto &turn : turns)
+            {
+                const auto &osm_turn = turn.first;
+                const auto edge_index = turn.second;
+                // original turn weight/duration values
+                auto turn_weight_penalty = turn_weight_penalties[edge_index];
+                auto turn_duration_penalty = turn_duration_penalties[edge_index];
+
+                penalty = lowerBoundFrom(penalty, penalties.end(), osm_turn);
+                if (penalty != penalties.end() && !(osm_turn < penalty->first))
+                {
+                    const auto &value = penalty->second;
+                    turn_duration_penalty =
+                        boost::numeric_cast<TurnPenalty>(std::round(value.duration * 10.));
+                    turn_weight_penalty = boost::numeric_cast<TurnPenalty>(
+                        std::round(std::isfinite(value.weight)
+                                       ? value.weight * weight_multiplier
+                                       : turn_duration_penalty * weight_multiplier / 10.));
+
+                    turn_duration_penalties[edge_index] = turn_duration_penalty;
+                    turn_weight_penalties[edge_index] = turn_weight_penalty;
+                    updated_turns.push_back(edge_index);
+                }
+
+                if (turn_weight_penalty < 0)
+                {
+                    util::Log(logWARNING)
+                        << "Negative turn penalty at " << osm_turn.from << ", " << osm_turn.via
+                        << ", " << osm_turn.to << ": turn penalty " << turn_weight_penalty;
+                }
+            }
+        });
+
+    // the geometries of the updated turns are sorted later on, their order doesn't matter
     std::vector<std::uint64_t> updated_turns;
-    for (std::uint64_t edge_index = 0; edge_index < turn_weight_penalties.size(); ++edge_index)
+    for (const auto &thread_updated_turns : updated_turns_per_thread)
     {
-        // edges are stored by internal OSRM ids, these need to be mapped back to OSM ids
-        const extractor::lookup::TurnIndexBlock internal_turn = turn_index_blocks[edge_index];
-        const Turn osm_turn{osm_node_ids[internal_turn.from_id],
-                            osm_node_ids[internal_turn.via_id],
-                            osm_node_ids[internal_turn.to_id]};
-        // original turn weight/duration values
-        auto turn_weight_penalty = turn_weight_penalties[edge_index];
-        auto turn_duration_penalty = turn_duration_penalties[edge_index];
-
-        if (auto value = turn_penalty_lookup(osm_turn))
-        {
-            turn_duration_penalty =
-                boost::numeric_cast<TurnPenalty>(std::round(value->duration * 10.));
-            turn_weight_penalty = boost::numeric_cast<TurnPenalty>(std::round(
-                std::isfinite(value->weight) ? value->weight * weight_multiplier
-                                             : turn_duration_penalty * weight_multiplier / 10.));
-
-            turn_duration_penalties[edge_index] = turn_duration_penalty;
-            turn_weight_penalties[edge_index] = turn_weight_penalty;
-            updated_turns.push_back(edge_index);
-        }
-
-        if (turn_weight_penalty < 0)
-        {
-            util::Log(logWARNING) << "Negative turn penalty at " << osm_turn.from << ", "
-                                  << osm_turn.via << ", " << osm_turn.to << ": turn penalty "
-                                  << turn_weight_penalty;
-        }
+        updated_turns.insert(
+            updated_turns.end(), thread_updated_turns.begin(), thread_updated_turns.end());
     }
-
     return updated_turns;
 }
 
-bool IsRestrictionValid(const Timezoner &tz_handler,
+bool IsRestrictionValid(const boost::optional<struct tm> &local_time,
                         const extractor::TurnRestriction &turn,
-                        const std::vector<util::Coordinate> &coordinates,
                         const extractor::PackedOSMIDs &osm_node_ids)
 {
     const auto via_node = osm_node_ids[turn.via.node];
@@ -458,12 +656,9 @@ bool IsRestrictionValid(const Timezoner &tz_handler,
         return false;
     }
 
-    const auto lon = static_cast<double>(toFloating(coordinates[turn.via.node].lon));
-    const auto lat = static_cast<double>(toFloating(coordinates[turn.via.node].lat));
     const auto &condition = turn.condition;
 
-    // Get local time of the restriction
-    const auto &local_time = tz_handler(point_t{lon, lat});
+    // Local time of the restriction
     if (!local_time)
         return false;
 
@@ -483,9 +678,8 @@ std::vector<std::uint64_t>
 updateConditionalTurns(const UpdaterConfig &config,
                        std::vector<TurnPenalty> &turn_weight_penalties,
                        const std::vector<extractor::TurnRestriction> &conditional_turns,
-                       std::vector<util::Coordinate> &coordinates,
-                       extractor::PackedOSMIDs &osm_node_ids,
-                       Timezoner time_zone_handler)
+                       const TimezoneIndex &timezones,
+                       extractor::PackedOSMIDs &osm_node_ids)
 {
     // Mapped file pointer for turn indices
     boost::iostreams::mapped_file_source turn_index_region;
@@ -501,11 +695,30 @@ updateConditionalTurns(const UpdaterConfig &config,
     std::unordered_set<std::tuple<NodeID, NodeID, NodeID>,
                        std::hash<std::tuple<NodeID, NodeID, NodeID>>>
         is_no_set;
-    for (const auto &c : conditional_turns)
+    // the time zone of every restriction is known, so they are evaluated independently
+    const auto local_times = timezones.GetLocalTimes(config.valid_now);
+    std::vector<std::uint8_t> is_valid(conditional_turns.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, conditional_turns.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (const auto index : util::irange(range.begin(), range.end()))
+                          {
+                              const auto timezone = timezones.GetTimezoneID(index);
+                              const auto local_time =
+                                  timezone == INVALID_TIMEZONE_ID
+                                      ? boost::none
+                                      : boost::make_optional(local_times[timezone]);
+                              is_valid[index] = IsRestrictionValid(
+                                  local_time, conditional_turns[index], osm_node_ids);
+                          }
+                      });
+
+    for (const auto index : util::irange<std::size_t>(0, conditional_turns.size()))
     {
         // only add restrictions to the lookups if the restriction is valid now
-        if (!IsRestrictionValid(time_zone_handler, c, coordinates, osm_node_ids))
+        if (!is_valid[index])
             continue;
+
+        const auto &c = conditional_turns[index];
         if (c.flags.is_only)
         {
             is_only_lookup.lookup.push_back({std::make_tuple(c.from.node, c.via.node), c.to.node});
@@ -545,6 +758,155 @@ updateConditionalTurns(const UpdaterConfig &config,
 
     return updated_turns;
 }
+
+// Times of the slots of the week the time stamp falls into. The times of the slots are local,
+// their dates only matter for the conditions that depend on them, e.g. on the month.
+std::vector<struct tm> getTimeSlotsOfWeek(const std::time_t utc_time)
+{
+    const auto to_tm = [](const std::time_t time) {
+        struct tm timeinfo;
+#if defined(_WIN32)
+        gmtime_s(&timeinfo, &time);
+#else
+        gmtime_r(&time, &timeinfo);
+#endif
+        return timeinfo;
+    };
+
+    const auto now = to_tm(utc_time);
+    const std::time_t days_since_monday = (now.tm_wday + 6) % 7;
+    const std::time_t monday =
+        utc_time - ((days_since_monday * 24 + now.tm_hour) * 60 + now.tm_min) * 60 - now.tm_sec;
+
+    std::vector<struct tm> time_slots;
+    time_slots.reserve(extractor::TIME_SLOTS_PER_WEEK);
+    for (const auto slot : util::irange<std::time_t>(0, extractor::TIME_SLOTS_PER_WEEK))
+        time_slots.push_back(to_tm(monday + slot * extractor::MINUTES_PER_TIME_SLOT * 60));
+    return time_slots;
+}
+
+// Evaluates the conditional restrictions in every time slot of the week and collects the
+// turns they restrict, like updateConditionalTurns does for a single point in time
+std::vector<extractor::ConditionalTurn>
+getConditionalTurns(const UpdaterConfig &config,
+                    const std::vector<extractor::TurnRestriction> &conditional_turns,
+                    const std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                    const extractor::PackedOSMIDs &osm_node_ids)
+{
+    boost::iostreams::mapped_file_source turn_index_region;
+    auto turn_index_blocks = util::mmapFile<extractor::lookup::TurnIndexBlock>(
+        config.turn_penalties_index_path, turn_index_region);
+
+    const auto time_slots =
+        getTimeSlotsOfWeek(config.valid_now > 0 ? config.valid_now : std::time(nullptr));
+    std::vector<extractor::TimeSlotMask> masks(conditional_turns.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, conditional_turns.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (const auto index : util::irange(range.begin(), range.end()))
+                          {
+                              const auto &turn = conditional_turns[index];
+                              auto &mask = masks[index];
+                              mask.fill(0);
+                              // logs the restrictions whose condition failed to parse
+                              if (turn.condition.empty() &&
+                                  !IsRestrictionValid(boost::none, turn, osm_node_ids))
+                                  continue;
+
+                              for (const auto slot : util::irange<std::uint32_t>(
+                                       0, extractor::TIME_SLOTS_PER_WEEK))
+                              {
+                                  if (util::CheckOpeningHours(turn.condition, time_slots[slot]))
+                                      extractor::setTimeSlot(mask, slot);
+                              }
+                          }
+                      });
+
+    using OnlyTurn = std::pair<NodeID, extractor::TimeSlotMask>;
+    std::unordered_map<std::tuple<NodeID, NodeID>, std::vector<OnlyTurn>> is_only_lookup;
+    std::unordered_map<std::tuple<NodeID, NodeID, NodeID>, extractor::TimeSlotMask> is_no_lookup;
+    for (const auto index : util::irange<std::size_t>(0, conditional_turns.size()))
+    {
+        // restrictions that never apply or failed to parse
+        if (extractor::isTimeSlotEmpty(masks[index]))
+            continue;
+
+        const auto &c = conditional_turns[index];
+        if (c.flags.is_only)
+        {
+            is_only_lookup[std::make_tuple(c.from.node, c.via.node)].emplace_back(c.to.node,
+                                                                                  masks[index]);
+        }
+        else
+        {
+            auto &mask = is_no_lookup[std::make_tuple(c.from.node, c.via.node, c.to.node)];
+            for (const auto word : util::irange<std::size_t>(0, mask.size()))
+                mask[word] |= masks[index][word];
+        }
+    }
+
+    std::vector<extractor::ConditionalTurn> restricted_turns;
+    for (std::uint64_t turn_id = 0; turn_id < turn_index_blocks.size(); ++turn_id)
+    {
+        const extractor::lookup::TurnIndexBlock internal_turn = turn_index_blocks[turn_id];
+
+        extractor::TimeSlotMask mask{};
+        const auto is_no = is_no_lookup.find(
+            std::make_tuple(internal_turn.from_id, internal_turn.via_id, internal_turn.to_id));
+        if (is_no != is_no_lookup.end())
+            mask = is_no->second;
+
+        // with only_* restrictions, the turn on which the restriction is tagged is valid
+        const auto is_only =
+            is_only_lookup.find(std::make_tuple(internal_turn.from_id, internal_turn.via_id));
+        if (is_only != is_only_lookup.end())
+        {
+            for (const auto &only_turn : is_only->second)
+            {
+                if (only_turn.first == internal_turn.to_id)
+                    continue;
+                for (const auto word : util::irange<std::size_t>(0, mask.size()))
+                    mask[word] |= only_turn.second[word];
+            }
+        }
+
+        if (!extractor::isTimeSlotEmpty(mask))
+        {
+            const auto &edge = edge_based_edge_list[turn_id];
+            BOOST_ASSERT(edge.data.turn_id == turn_id);
+            restricted_turns.push_back(
+                {static_cast<EdgeID>(turn_id), edge.source, edge.target, mask});
+        }
+    }
+
+    return restricted_turns;
+}
+}
+
+extractor::ConditionalTurnMasks Updater::LoadConditionalTurnMasks() const
+{
+    TIMER_START(conditionals);
+    EdgeID max_edge_id = 0;
+    std::vector<extractor::EdgeBasedEdge> edge_based_edge_list;
+    std::vector<util::Coordinate> coordinates;
+    extractor::PackedOSMIDs osm_node_ids;
+    std::vector<extractor::TurnRestriction> conditional_turns;
+    {
+        extractor::files::readEdgeBasedGraph(
+            config.edge_based_graph_path, max_edge_id, edge_based_edge_list);
+        extractor::files::readNodes(config.node_based_nodes_data_path, coordinates, osm_node_ids);
+
+        using storage::io::FileReader;
+        FileReader reader(config.turn_restrictions_path, FileReader::VerifyFingerprint);
+        extractor::serialization::read(reader, conditional_turns);
+    }
+
+    extractor::ConditionalTurnMasks masks(
+        getConditionalTurns(config, conditional_turns, edge_based_edge_list, osm_node_ids));
+    TIMER_STOP(conditionals);
+    util::Log() << "Evaluating " << conditional_turns.size()
+                << " conditional restrictions over a week took " << TIMER_MSEC(conditionals)
+                << "ms, they restrict " << masks.GetNumberOfTurns() << " turns";
+    return masks;
 }
 
 Updater::NumNodesAndEdges Updater::LoadAndUpdateEdgeExpandedGraph() const
@@ -558,6 +920,26 @@ Updater::NumNodesAndEdges Updater::LoadAndUpdateEdgeExpandedGraph() const
 EdgeID
 Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
                                         std::vector<EdgeWeight> &node_weights) const
+{
+    extractor::SegmentDataContainer segment_data;
+    return UpdateEdgeExpandedGraph(edge_based_edge_list, node_weights, segment_data, false);
+}
+
+EdgeID Updater::LoadAndUpdateEdgeExpandedGraph(
+    extractor::SegmentDataView &segment_data,
+    std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list) const
+{
+    std::vector<EdgeWeight> node_weights;
+    return UpdateEdgeExpandedGraph(edge_based_edge_list, node_weights, segment_data, true);
+}
+
+extractor::Datasources Updater::GetDatasources() const { return makeDatasources(config); }
+
+template <typename SegmentDataT>
+EdgeID Updater::UpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                                        std::vector<EdgeWeight> &node_weights,
+                                        SegmentDataT &segment_data,
+                                        const bool segment_data_in_memory) const
 {
     TIMER_START(load_edges);
 
@@ -569,31 +951,40 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
         config.edge_based_graph_path, max_edge_id, edge_based_edge_list);
     extractor::files::readNodes(config.node_based_nodes_data_path, coordinates, osm_node_ids);
 
-    const bool update_conditional_turns =
-        !config.turn_restrictions_path.empty() && config.valid_now;
-    const bool update_edge_weights = !config.segment_speed_lookup_paths.empty();
+    const bool update_conditional_turns = !config.turn_restrictions_path.empty() &&
+                                          config.valid_now &&
+                                          !config.conditional_turns_at_query_time;
+    const bool update_edge_weights = !config.segment_speed_lookup_paths.empty() ||
+                                     !config.speed_profile_lookup_paths.empty() ||
+                                     !config.way_speed_lookup_paths.empty();
     const bool update_turn_penalties = !config.turn_penalty_lookup_paths.empty();
 
     if (!update_edge_weights && !update_turn_penalties && !update_conditional_turns)
     {
-        saveDatasourcesNames(config);
+        if (config.save_updated_data)
+        {
+            saveDatasourcesNames(config);
+        }
         return max_edge_id;
     }
 
-    if (config.segment_speed_lookup_paths.size() + config.turn_penalty_lookup_paths.size() > 255)
+    if (config.segment_speed_lookup_paths.size() + config.speed_profile_lookup_paths.size() +
+            config.way_speed_lookup_paths.size() + config.turn_penalty_lookup_paths.size() >
+        255)
         throw util::exception("Limit of 255 segment speed and turn penalty files each reached" +
                               SOURCE_REF);
 
     extractor::EdgeBasedNodeDataContainer node_data;
     extractor::TurnDataContainer turn_data;
-    extractor::SegmentDataContainer segment_data;
     extractor::ProfileProperties profile_properties;
     std::vector<TurnPenalty> turn_weight_penalties;
     std::vector<TurnPenalty> turn_duration_penalties;
+    TIMER_START(load_data);
     if (update_edge_weights || update_turn_penalties || update_conditional_turns)
     {
         const auto load_segment_data = [&] {
-            extractor::files::readSegmentData(config.geometry_path, segment_data);
+            if (!segment_data_in_memory)
+                extractor::files::readSegmentData(config.geometry_path, segment_data);
         };
 
         const auto load_node_data = [&] {
@@ -638,11 +1029,50 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
         FileReader reader(config.turn_restrictions_path, FileReader::VerifyFingerprint);
         extractor::serialization::read(reader, conditional_turns);
     }
-
-    tbb::concurrent_vector<GeometryID> updated_segments;
-    if (update_edge_weights)
-    {
-        auto segment_speed_lookup = csv::readSegmentValues(config.segment_speed_lookup_paths);
+    TIMER_STOP(load_data);
+    util::Log() << "Loading the dataset data took " << TIMER_MSEC(load_data) << "ms.";
+
+    // the segments and the turn penalties are updated at the same time, they share no data
+    std::vector<GeometryID> updated_segments;
+    const auto update_segments = [&] {
+        if (!update_edge_weights)
+            return;
+
+        TIMER_START(lookup);
+        SegmentLookupTable segment_speed_lookup;
+        if (!config.segment_speed_lookup_paths.empty())
+        {
+            segment_speed_lookup = csv::readSegmentValues(config.segment_speed_lookup_paths,
+                                                          config.cache_lookup_files);
+        }
+        if (!config.way_speed_lookup_paths.empty())
+        {
+            if (!boost::filesystem::exists(config.way_index_path))
+                throw util::exception("Way speed files need " + config.way_index_path +
+                                      ", run osrm-extract with --way-index" + SOURCE_REF);
+
+            extractor::WayIndex way_index;
+            extractor::files::readWayIndex(config.way_index_path, way_index);
+            const auto way_speed_lookup =
+                readWaySpeedValues(config.way_speed_lookup_paths,
+                                   config.segment_speed_lookup_paths.size() +
+                                       config.speed_profile_lookup_paths.size() + 1,
+                                   way_index);
+            // the speeds of single segments are more specific than the ones of their ways
+            segment_speed_lookup =
+                mergeSpeeds(segment_speed_lookup.lookup, way_speed_lookup.lookup);
+        }
+        if (!config.speed_profile_lookup_paths.empty())
+        {
+            const auto speed_profile_lookup =
+                csv::readSpeedProfiles(config.speed_profile_lookup_paths,
+                                       config.segment_speed_lookup_paths.size() + 1,
+                                       config.cache_lookup_files);
+            segment_speed_lookup = applySpeedProfiles(
+                segment_speed_lookup, speed_profile_lookup, config.profile_minute);
+        }
+        TIMER_STOP(lookup);
+        util::Log() << "Reading segment speed files took " << TIMER_MSEC(lookup) << "ms.";
 
         TIMER_START(segment);
         updated_segments = updateSegmentData(config,
@@ -652,49 +1082,70 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                                              coordinates,
                                              osm_node_ids);
         // Now save out the updated compressed geometries
-        extractor::files::writeSegmentData(config.geometry_path, segment_data);
+        if (config.save_updated_data)
+        {
+            extractor::files::writeSegmentData(config.geometry_path, segment_data);
+        }
         TIMER_STOP(segment);
         util::Log() << "Updating segment data took " << TIMER_MSEC(segment) << "ms.";
-    }
+    };
 
-    auto turn_penalty_lookup = csv::readTurnValues(config.turn_penalty_lookup_paths);
-    if (update_turn_penalties)
-    {
+    std::vector<GeometryID> updated_turn_geometries;
+    const auto update_turns = [&] {
+        if (!update_turn_penalties)
+            return;
+
+        TIMER_START(lookup);
+        auto turn_penalty_lookup =
+            csv::readTurnValues(config.turn_penalty_lookup_paths, config.cache_lookup_files);
+        TIMER_STOP(lookup);
+        util::Log() << "Reading turn penalty files took " << TIMER_MSEC(lookup) << "ms.";
+
+        TIMER_START(turns);
         auto updated_turn_penalties = updateTurnPenalties(config,
                                                           profile_properties,
                                                           turn_penalty_lookup,
                                                           turn_weight_penalties,
                                                           turn_duration_penalties,
                                                           osm_node_ids);
-        const auto offset = updated_segments.size();
-        updated_segments.resize(offset + updated_turn_penalties.size());
+        updated_turn_geometries.resize(updated_turn_penalties.size());
         // we need to re-compute all edges that have updated turn penalties.
         // this marks it for re-computation
         std::transform(updated_turn_penalties.begin(),
                        updated_turn_penalties.end(),
-                       updated_segments.begin() + offset,
+                       updated_turn_geometries.begin(),
                        [&node_data, &edge_based_edge_list](const std::uint64_t turn_id) {
                            const auto node_id = edge_based_edge_list[turn_id].source;
                            return node_data.GetGeometryID(node_id);
                        });
-    }
+        TIMER_STOP(turns);
+        util::Log() << "Updating turn penalties took " << TIMER_MSEC(turns) << "ms.";
+    };
+
+    tbb::parallel_invoke(update_segments, update_turns);
+
+    // the updated segments are ordered by geometry, only the geometries of updated turns need
+    // to be sorted and merged in
+    const auto num_updated_segments = updated_segments.size();
+    updated_segments.insert(
+        updated_segments.end(), updated_turn_geometries.begin(), updated_turn_geometries.end());
 
     if (update_conditional_turns)
     {
+        TIMER_START(conditionals);
         // initialize instance of class that handles time zone resolution
         if (config.valid_now <= 0)
         {
             util::Log(logERROR) << "Given UTC time is invalid: " << config.valid_now;
             throw;
         }
-        const Timezoner time_zone_handler = Timezoner(config.tz_file_path, config.valid_now);
+        const auto timezones = loadTimezoneIndex(config, conditional_turns, coordinates);
 
         auto updated_turn_penalties = updateConditionalTurns(config,
                                                              turn_weight_penalties,
                                                              conditional_turns,
-                                                             coordinates,
-                                                             osm_node_ids,
-                                                             time_zone_handler);
+                                                             timezones,
+                                                             osm_node_ids);
         const auto offset = updated_segments.size();
         updated_segments.resize(offset + updated_turn_penalties.size());
         // we need to re-compute all edges that have updated turn penalties.
@@ -706,49 +1157,57 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                            const auto node_id = edge_based_edge_list[turn_id].source;
                            return node_data.GetGeometryID(node_id);
                        });
+        TIMER_STOP(conditionals);
+        util::Log() << "Updating conditional turns took " << TIMER_MSEC(conditionals) << "ms.";
     }
 
-    tbb::parallel_sort(updated_segments.begin(),
-                       updated_segments.end(),
-                       [](const GeometryID lhs, const GeometryID rhs) {
-                           return std::tie(lhs.id, lhs.forward) < std::tie(rhs.id, rhs.forward);
-                       });
+    TIMER_START(edges);
+    const auto by_geometry = [](const GeometryID lhs, const GeometryID rhs) {
+        return std::tie(lhs.id, lhs.forward) < std::tie(rhs.id, rhs.forward);
+    };
+    const auto same_geometry = [](const GeometryID lhs, const GeometryID rhs) {
+        return lhs.id == rhs.id && lhs.forward == rhs.forward;
+    };
+    if (updated_segments.size() > num_updated_segments)
+    {
+        const auto turns_begin = updated_segments.begin() + num_updated_segments;
+        tbb::parallel_sort(turns_begin, updated_segments.end(), by_geometry);
+        std::inplace_merge(
+            updated_segments.begin(), turns_begin, updated_segments.end(), by_geometry);
+        updated_segments.erase(
+            std::unique(updated_segments.begin(), updated_segments.end(), same_geometry),
+            updated_segments.end());
+    }
 
     using WeightAndDuration = std::tuple<EdgeWeight, EdgeWeight>;
     const auto compute_new_weight_and_duration =
         [&](const GeometryID geometry_id) -> WeightAndDuration {
-        EdgeWeight new_weight = 0;
-        EdgeWeight new_duration = 0;
+        // the segments of a geometry are decoded at once instead of element by element
+        thread_local std::vector<SegmentWeight> weights;
+        thread_local std::vector<SegmentDuration> durations;
         if (geometry_id.forward)
         {
-            const auto weights = segment_data.GetForwardWeights(geometry_id.id);
-            for (const auto weight : weights)
-            {
-                if (weight == INVALID_SEGMENT_WEIGHT)
-                {
-                    new_weight = INVALID_EDGE_WEIGHT;
-                    break;
-                }
-                new_weight += weight;
-            }
-            const auto durations = segment_data.GetForwardDurations(geometry_id.id);
-            new_duration = std::accumulate(durations.begin(), durations.end(), EdgeWeight{0});
+            segment_data.DecodeForwardWeights(geometry_id.id, weights);
+            segment_data.DecodeForwardDurations(geometry_id.id, durations);
         }
         else
         {
-            const auto weights = segment_data.GetReverseWeights(geometry_id.id);
-            for (const auto weight : weights)
+            segment_data.DecodeReverseWeights(geometry_id.id, weights);
+            segment_data.DecodeReverseDurations(geometry_id.id, durations);
+        }
+
+        EdgeWeight new_weight = 0;
+        for (const auto weight : weights)
+        {
+            if (weight == INVALID_SEGMENT_WEIGHT)
             {
-                if (weight == INVALID_SEGMENT_WEIGHT)
-                {
-                    new_weight = INVALID_EDGE_WEIGHT;
-                    break;
-                }
-                new_weight += weight;
+                new_weight = INVALID_EDGE_WEIGHT;
+                break;
             }
-            const auto durations = segment_data.GetReverseDurations(geometry_id.id);
-            new_duration = std::accumulate(durations.begin(), durations.end(), EdgeWeight{0});
+            new_weight += weight;
         }
+        const auto new_duration =
+            std::accumulate(durations.begin(), durations.end(), EdgeWeight{0});
         return std::make_tuple(new_weight, new_duration);
     };
 
@@ -762,71 +1221,77 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                           }
                       });
 
+    // The edges read from the .ebg file only match the segment data of the dataset files, so
+    // if the segment data is kept in memory all edges need to be computed from it
+    const bool update_all_edges = segment_data_in_memory && update_edge_weights;
+
     const auto update_edge = [&](extractor::EdgeBasedEdge &edge) {
         const auto node_id = edge.source;
         const auto geometry_id = node_data.GetGeometryID(node_id);
-        auto updated_iter = std::lower_bound(updated_segments.begin(),
-                                             updated_segments.end(),
-                                             geometry_id,
-                                             [](const GeometryID lhs, const GeometryID rhs) {
-                                                 return std::tie(lhs.id, lhs.forward) <
-                                                        std::tie(rhs.id, rhs.forward);
-                                             });
-        if (updated_iter != updated_segments.end() && updated_iter->id == geometry_id.id &&
-            updated_iter->forward == geometry_id.forward)
-        {
-            // Find a segment with zero speed and simultaneously compute the new edge
-            // weight
-            EdgeWeight new_weight;
-            EdgeWeight new_duration;
-            std::tie(new_weight, new_duration) =
-                accumulated_segment_data[updated_iter - updated_segments.begin()];
 
-            // Update the node-weight cache. This is the weight of the edge-based-node
-            // only,
-            // it doesn't include the turn. We may visit the same node multiple times,
-            // but
-            // we should always assign the same value here.
-            if (node_weights.size() > 0)
-                node_weights[edge.source] = new_weight;
-
-            // We found a zero-speed edge, so we'll skip this whole edge-based-edge
-            // which
-            // effectively removes it from the routing network.
-            if (new_weight == INVALID_EDGE_WEIGHT)
+        // Find a segment with zero speed and simultaneously compute the new edge
+        // weight
+        EdgeWeight new_weight;
+        EdgeWeight new_duration;
+        if (update_all_edges)
+        {
+            std::tie(new_weight, new_duration) = compute_new_weight_and_duration(geometry_id);
+        }
+        else
+        {
+            auto updated_iter = std::lower_bound(
+                updated_segments.begin(), updated_segments.end(), geometry_id, by_geometry);
+            if (updated_iter == updated_segments.end() ||
+                !same_geometry(*updated_iter, geometry_id))
             {
-                edge.data.weight = INVALID_EDGE_WEIGHT;
                 return;
             }
 
-            // Get the turn penalty and update to the new value if required
-            auto turn_weight_penalty = turn_weight_penalties[edge.data.turn_id];
-            auto turn_duration_penalty = turn_duration_penalties[edge.data.turn_id];
-            const auto num_nodes = segment_data.GetForwardGeometry(geometry_id.id).size();
-            const auto weight_min_value = static_cast<EdgeWeight>(num_nodes);
-            if (turn_weight_penalty + new_weight < weight_min_value)
+            std::tie(new_weight, new_duration) =
+                accumulated_segment_data[updated_iter - updated_segments.begin()];
+        }
+
+        // Update the node-weight cache. This is the weight of the edge-based-node
+        // only, it doesn't include the turn. We may visit the same node multiple times,
+        // but we should always assign the same value here.
+        if (node_weights.size() > 0)
+            node_weights[edge.source] = new_weight;
+
+        // We found a zero-speed edge, so we'll skip this whole edge-based-edge
+        // which effectively removes it from the routing network.
+        if (new_weight == INVALID_EDGE_WEIGHT)
+        {
+            edge.data.weight = INVALID_EDGE_WEIGHT;
+            return;
+        }
+
+        // Get the turn penalty and update to the new value if required
+        auto turn_weight_penalty = turn_weight_penalties[edge.data.turn_id];
+        auto turn_duration_penalty = turn_duration_penalties[edge.data.turn_id];
+        const auto num_nodes = segment_data.GetForwardGeometry(geometry_id.id).size();
+        const auto weight_min_value = static_cast<EdgeWeight>(num_nodes);
+        if (turn_weight_penalty + new_weight < weight_min_value)
+        {
+            if (turn_weight_penalty < 0)
             {
-                if (turn_weight_penalty < 0)
-                {
-                    util::Log(logWARNING) << "turn penalty " << turn_weight_penalty
-                                          << " is too negative: clamping turn weight to "
-                                          << weight_min_value;
-                    turn_weight_penalty = weight_min_value - new_weight;
-                    turn_weight_penalties[edge.data.turn_id] = turn_weight_penalty;
-                }
-                else
-                {
-                    new_weight = weight_min_value;
-                }
+                util::Log(logWARNING) << "turn penalty " << turn_weight_penalty
+                                      << " is too negative: clamping turn weight to "
+                                      << weight_min_value;
+                turn_weight_penalty = weight_min_value - new_weight;
+                turn_weight_penalties[edge.data.turn_id] = turn_weight_penalty;
+            }
+            else
+            {
+                new_weight = weight_min_value;
             }
-
-            // Update edge weight
-            edge.data.weight = new_weight + turn_weight_penalty;
-            edge.data.duration = new_duration + turn_duration_penalty;
         }
+
+        // Update edge weight
+        edge.data.weight = new_weight + turn_weight_penalty;
+        edge.data.duration = new_duration + turn_duration_penalty;
     };
 
-    if (updated_segments.size() > 0)
+    if (update_all_edges || updated_segments.size() > 0)
     {
         tbb::parallel_for(tbb::blocked_range<std::size_t>(0, edge_based_edge_list.size()),
                           [&](const auto &range) {
@@ -836,8 +1301,11 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                               }
                           });
     }
+    TIMER_STOP(edges);
+    util::Log() << "Updating edge weights took " << TIMER_MSEC(edges) << "ms.";
 
-    if (update_turn_penalties || update_conditional_turns)
+    TIMER_START(save);
+    if (config.save_updated_data && (update_turn_penalties || update_conditional_turns))
     {
         const auto save_penalties = [](const auto &filename, const auto &data) -> void {
             storage::io::FileWriter writer(filename, storage::io::FileWriter::GenerateFingerprint);
@@ -850,14 +1318,19 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
     }
 
 #if !defined(NDEBUG)
-    if (config.turn_penalty_lookup_paths.empty())
+    if (config.turn_penalty_lookup_paths.empty() && !segment_data_in_memory)
     { // don't check weights consistency with turn updates that can break assertion
         // condition with turn weight penalties negative updates
         checkWeightsConsistency(config, edge_based_edge_list);
     }
 #endif
 
-    saveDatasourcesNames(config);
+    if (config.save_updated_data)
+    {
+        saveDatasourcesNames(config);
+    }
+    TIMER_STOP(save);
+    util::Log() << "Saving the updated data took " << TIMER_MSEC(save) << "ms.";
 
     TIMER_STOP(load_edges);
     util::Log() << "Done reading edges in " << TIMER_MSEC(load_edges) << "ms.";
@@ -0,0 +1,164 @@
+#include "updater/way_speed_source.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace osrm
+{
+namespace updater
+{
+
+constexpr const char WaySpeedHeader::MAGIC[8];
+constexpr std::uint32_t WaySpeedHeader::VERSION;
+constexpr std::uint16_t WaySpeedRecord::WAY_END;
+constexpr std::uint8_t WaySpeedRecord::FORWARD;
+constexpr std::uint8_t WaySpeedRecord::BACKWARD;
+
+namespace
+{
+using SegmentSpeeds = std::vector<std::pair<Segment, SpeedSource>>;
+
+// Records of a file are expanded in blocks of this size by one task each
+constexpr std::size_t RECORDS_PER_BLOCK = 64 * 1024;
+
+bool isValid(const WaySpeedRecord &record)
+{
+    return record.first_segment < record.last_segment && std::isfinite(record.speed) &&
+           record.speed >= 0 && record.speed <= std::numeric_limits<unsigned>::max() &&
+           !(record.rate <= 0) && !std::isinf(record.rate) && record.directions != 0 &&
+           (record.directions & ~(WaySpeedRecord::FORWARD | WaySpeedRecord::BACKWARD)) == 0;
+}
+
+// The segment speeds of the records in the order of the records
+SegmentSpeeds expandRecords(const std::vector<WaySpeedRecord> &records,
+                            const std::uint8_t source,
+                            const extractor::WayIndex &way_index,
+                            std::size_t &missing_ways)
+{
+    const auto number_of_blocks = (records.size() + RECORDS_PER_BLOCK - 1) / RECORDS_PER_BLOCK;
+    std::vector<SegmentSpeeds> blocks(number_of_blocks);
+    std::vector<std::size_t> block_missing_ways(number_of_blocks, 0);
+    tbb::parallel_for(std::size_t{0}, number_of_blocks, [&](const std::size_t block) {
+        const auto end = std::min(records.size(), (block + 1) * RECORDS_PER_BLOCK);
+        for (const auto index : util::irange(block * RECORDS_PER_BLOCK, end))
+        {
+            const auto &record = records[index];
+            SpeedSource value;
+            value.speed = static_cast<unsigned>(std::lround(record.speed));
+            if (!std::isnan(record.rate))
+                value.rate = record.rate;
+            value.source = source;
+
+            const auto found =
+                record.way_id <= std::numeric_limits<std::uint32_t>::max() &&
+                way_index.ForEachSegment(
+                    OSMWayID{static_cast<std::uint32_t>(record.way_id)},
+                    [&](const std::uint64_t segment, const OSMNodeID from, const OSMNodeID to) {
+                        if (segment < record.first_segment || segment >= record.last_segment)
+                            return;
+                        if (record.directions & WaySpeedRecord::FORWARD)
+                            blocks[block].emplace_back(Segment{from, to}, value);
+                        if (record.directions & WaySpeedRecord::BACKWARD)
+                            blocks[block].emplace_back(Segment{to, from}, value);
+                    });
+            if (!found)
+                ++block_missing_ways[block];
+        }
+    });
+
+    SegmentSpeeds speeds;
+    for (auto &block : blocks)
+    {
+        speeds.insert(speeds.end(), block.begin(), block.end());
+        SegmentSpeeds{}.swap(block);
+    }
+    for (const auto count : block_missing_ways)
+        missing_ways += count;
+    return speeds;
+}
+}
+
+std::vector<WaySpeedRecord> readWaySpeedRecords(const std::string &path)
+{
+    std::vector<WaySpeedRecord> records;
+    if (boost::filesystem::file_size(path) == 0)
+        return records;
+
+    boost::iostreams::mapped_file_source mmap(path);
+    WaySpeedHeader header;
+    if (mmap.size() < sizeof(header))
+        throw util::exception("Way speed file " + path + " is too short" + SOURCE_REF);
+    std::memcpy(&header, mmap.data(), sizeof(header));
+    if (std::memcmp(header.magic, WaySpeedHeader::MAGIC, sizeof(header.magic)) != 0)
+        throw util::exception("Way speed file " + path + " has no OSRMWAYS header" + SOURCE_REF);
+    if (header.version != WaySpeedHeader::VERSION)
+        throw util::exception("Way speed file " + path + " has the unsupported version " +
+                              std::to_string(header.version) + SOURCE_REF);
+
+    const auto data_size = mmap.size() - sizeof(header);
+    if (data_size % sizeof(WaySpeedRecord) != 0)
+        throw util::exception("Way speed file " + path + " ends within a record" + SOURCE_REF);
+
+    records.resize(data_size / sizeof(WaySpeedRecord));
+    std::memcpy(records.data(), mmap.data() + sizeof(header), data_size);
+
+    const auto invalid = std::find_if_not(records.begin(), records.end(), isValid);
+    if (invalid != records.end())
+        throw util::exception("Way speed file " + path + " has an invalid record " +
+                              std::to_string(std::distance(records.begin(), invalid)) + " of way " +
+                              std::to_string(invalid->way_id) + SOURCE_REF);
+
+    return records;
+}
+
+SegmentLookupTable readWaySpeedValues(const std::vector<std::string> &paths,
+                                      const std::size_t start_index,
+                                      const extractor::WayIndex &way_index)
+{
+    SegmentSpeeds speeds;
+    for (const auto index : util::irange<std::size_t>(0, paths.size()))
+    {
+        const auto records = readWaySpeedRecords(paths[index]);
+        std::size_t missing_ways = 0;
+        auto file_speeds = expandRecords(
+            records, static_cast<std::uint8_t>(start_index + index), way_index, missing_ways);
+        util::Log() << "Loaded " << paths[index] << " with " << records.size()
+                    << " ways and " << file_speeds.size() << " segment values";
+        if (missing_ways > 0)
+            util::Log(logWARNING) << missing_ways << " ways of " << paths[index]
+                                  << " are not in the way index";
+
+        speeds.insert(speeds.end(),
+                      std::make_move_iterator(file_speeds.begin()),
+                      std::make_move_iterator(file_speeds.end()));
+    }
+
+    // descending key order as the other lookups, the value of the latest record comes first
+    // and is the one kept for duplicated segments
+    std::reverse(speeds.begin(), speeds.end());
+    std::stable_sort(speeds.begin(), speeds.end(), [](const auto &lhs, const auto &rhs) {
+        return rhs.first < lhs.first;
+    });
+    const auto same_key = [](const auto &lhs, const auto &rhs) { return lhs.first == rhs.first; };
+    speeds.erase(std::unique(speeds.begin(), speeds.end(), same_key), speeds.end());
+
+    util::Log() << "In total loaded " << paths.size() << " way speed file(s) with a total of "
+                << speeds.size() << " unique values";
+
+    return SegmentLookupTable{std::move(speeds)};
+}
+}
+}
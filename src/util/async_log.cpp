@@ -0,0 +1,165 @@
+#include "util/async_log.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+const constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(5);
+
+std::uint64_t nextWriterId()
+{
+    static std::atomic<std::uint64_t> next_id{0};
+    return next_id++;
+}
+}
+
+AsyncLogWriter::AsyncLogWriter() : id(nextWriterId()) {}
+
+AsyncLogWriter::~AsyncLogWriter() { Stop(); }
+
+AsyncLogWriter &AsyncLogWriter::GetInstance()
+{
+    static AsyncLogWriter instance;
+    return instance;
+}
+
+void AsyncLogWriter::Start(std::ostream &output_stream_, std::ostream &error_stream_)
+{
+    BOOST_ASSERT(!running);
+    output_stream = &output_stream_;
+    error_stream = &error_stream_;
+    dropped = 0;
+    reported_dropped = 0;
+    running = true;
+    writer = std::thread([this] { Run(); });
+}
+
+void AsyncLogWriter::Stop()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+    wakeup.notify_one();
+    writer.join();
+}
+
+AsyncLogWriter::Ring &AsyncLogWriter::GetLocalRing()
+{
+    // the rings of the writers this thread logged to, usually just the global one
+    thread_local std::vector<std::pair<std::uint64_t, std::shared_ptr<Ring>>> local_rings;
+    const auto local_ring =
+        std::find_if(local_rings.begin(), local_rings.end(), [this](const auto &ring) {
+            return ring.first == id;
+        });
+    if (local_ring != local_rings.end())
+    {
+        return *local_ring->second;
+    }
+
+    auto ring = std::make_shared<Ring>();
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        rings.push_back(ring);
+    }
+    local_rings.emplace_back(id, ring);
+    return *ring;
+}
+
+bool AsyncLogWriter::Push(const LogLevel level, std::string &line)
+{
+    auto &ring = GetLocalRing();
+    const auto head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) == RING_CAPACITY)
+    {
+        dropped++;
+        return false;
+    }
+
+    auto &entry = ring.entries[head % RING_CAPACITY];
+    entry.level = level;
+    // the cleared string of the slot goes back to the caller, so lines reuse their memory
+    entry.line.swap(line);
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogWriter::Drain()
+{
+    std::vector<std::shared_ptr<Ring>> current_rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        // rings of threads that exited are dropped once they are empty
+        rings.erase(std::remove_if(rings.begin(),
+                                   rings.end(),
+                                   [](const std::shared_ptr<Ring> &ring) {
+                                       return ring.use_count() == 1 &&
+                                              ring->head.load(std::memory_order_acquire) ==
+                                                  ring->tail.load(std::memory_order_relaxed);
+                                   }),
+                    rings.end());
+        current_rings = rings;
+    }
+
+    for (const auto &ring : current_rings)
+    {
+        auto tail = ring->tail.load(std::memory_order_relaxed);
+        const auto head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail)
+        {
+            auto &entry = ring->entries[tail % RING_CAPACITY];
+            auto &batch =
+                entry.level == logWARNING || entry.level == logERROR ? error_batch : output_batch;
+            batch.append(entry.line);
+            batch.push_back('\n');
+            entry.line.clear();
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+
+    const std::size_t total_dropped = dropped;
+    if (total_dropped != reported_dropped)
+    {
+        error_batch += "[warn] " + std::to_string(total_dropped - reported_dropped) +
+                       " log lines were dropped, the logging threads were faster than the "
+                       "output\n";
+        reported_dropped = total_dropped;
+    }
+
+    if (!output_batch.empty())
+    {
+        output_stream->write(output_batch.data(), output_batch.size());
+        output_stream->flush();
+        output_batch.clear();
+    }
+    if (!error_batch.empty())
+    {
+        error_stream->write(error_batch.data(), error_batch.size());
+        error_stream->flush();
+        error_batch.clear();
+    }
+}
+
+void AsyncLogWriter::Run()
+{
+    while (running)
+    {
+        Drain();
+        std::unique_lock<std::mutex> lock(wakeup_mutex);
+        wakeup.wait_for(lock, DRAIN_INTERVAL, [this] { return !running; });
+    }
+    // lines pushed after this are lost, the writer is stopped once the threads stopped logging
+    Drain();
+}
+}
+}
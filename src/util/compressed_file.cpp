@@ -0,0 +1,389 @@
+#include "util/compressed_file.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <zlib.h>
+#ifdef OSRM_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace osrm
+{
+namespace util
+{
+
+constexpr char CompressedFileHeader::MAGIC[8];
+
+namespace
+{
+// Frames compressed at once, bounds the memory used while compressing
+const constexpr std::size_t FRAMES_PER_BATCH = 64;
+
+std::size_t compressBound(const CompressionCodec codec, const std::size_t size)
+{
+    switch (codec)
+    {
+    case CompressionCodec::Zlib:
+        return ::compressBound(size);
+#ifdef OSRM_HAVE_ZSTD
+    case CompressionCodec::Zstd:
+        return ZSTD_compressBound(size);
+#endif
+    default:
+        throw util::exception("Unsupported compression codec" + SOURCE_REF);
+    }
+}
+
+// Compresses the source into the destination, returns the compressed size
+std::size_t compressFrame(const CompressionCodec codec,
+                          const int level,
+                          const char *source,
+                          const std::size_t size,
+                          char *destination,
+                          const std::size_t capacity)
+{
+    switch (codec)
+    {
+    case CompressionCodec::Zlib:
+    {
+        uLongf compressed_size = capacity;
+        if (::compress2(reinterpret_cast<Bytef *>(destination),
+                        &compressed_size,
+                        reinterpret_cast<const Bytef *>(source),
+                        size,
+                        level) != Z_OK)
+        {
+            throw util::exception("Could not compress a frame with zlib" + SOURCE_REF);
+        }
+        return compressed_size;
+    }
+#ifdef OSRM_HAVE_ZSTD
+    case CompressionCodec::Zstd:
+    {
+        const auto compressed_size = ZSTD_compress(destination, capacity, source, size, level);
+        if (ZSTD_isError(compressed_size))
+        {
+            throw util::exception(std::string("Could not compress a frame with zstd: ") +
+                                  ZSTD_getErrorName(compressed_size) + SOURCE_REF);
+        }
+        return compressed_size;
+    }
+#endif
+    default:
+        throw util::exception("Unsupported compression codec" + SOURCE_REF);
+    }
+}
+
+void readHeader(const boost::filesystem::path &path,
+                const char *data,
+                const std::size_t size,
+                CompressedFileHeader &header)
+{
+    if (size < sizeof(header))
+    {
+        throw util::exception(path.string() + " is too short for a compressed file" + SOURCE_REF);
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CompressedFileHeader::MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw util::exception(path.string() + " is not a compressed file" + SOURCE_REF);
+    }
+    if (!IsCodecAvailable(header.codec))
+    {
+        throw util::exception(path.string() +
+                              " was compressed with a codec this build does not support" +
+                              SOURCE_REF);
+    }
+    const auto index_size = (header.number_of_frames + 1) * sizeof(std::uint64_t);
+    if (header.frame_size == 0 || size < sizeof(header) + index_size ||
+        header.number_of_frames != (header.size + header.frame_size - 1) / header.frame_size)
+    {
+        throw util::exception(path.string() + " has a corrupt compression header" + SOURCE_REF);
+    }
+}
+}
+
+CompressionCodec StringToCompressionCodec(const std::string &codec)
+{
+    if (codec == "zlib")
+        return CompressionCodec::Zlib;
+    if (codec == "zstd")
+        return CompressionCodec::Zstd;
+    throw util::exception("Unknown compression codec " + codec + ", expected zlib or zstd");
+}
+
+bool IsCodecAvailable(const CompressionCodec codec)
+{
+    switch (codec)
+    {
+    case CompressionCodec::Zlib:
+        return true;
+    case CompressionCodec::Zstd:
+#ifdef OSRM_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+bool IsCompressedFile(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream stream(path, std::ios::binary);
+    char magic[sizeof(CompressedFileHeader::MAGIC)];
+    return stream.read(magic, sizeof(magic)) &&
+           std::memcmp(magic, CompressedFileHeader::MAGIC, sizeof(magic)) == 0;
+}
+
+void CompressFile(const boost::filesystem::path &input_path,
+                  const boost::filesystem::path &output_path,
+                  const CompressionCodec codec,
+                  const int level,
+                  const std::size_t frame_size)
+{
+    if (!IsCodecAvailable(codec))
+    {
+        throw util::exception("The compression codec is not supported by this build" +
+                              SOURCE_REF);
+    }
+    if (frame_size == 0 || frame_size > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw util::exception("Invalid compression frame size " + std::to_string(frame_size) +
+                              SOURCE_REF);
+    }
+
+    boost::filesystem::ifstream input(input_path, std::ios::binary);
+    boost::filesystem::ofstream output(output_path, std::ios::binary);
+    if (!input || !output)
+    {
+        throw util::exception("Could not open " + (input ? output_path : input_path).string() +
+                              SOURCE_REF);
+    }
+
+    CompressedFileHeader header;
+    std::memcpy(header.magic, CompressedFileHeader::MAGIC, sizeof(header.magic));
+    header.codec = codec;
+    header.frame_size = static_cast<std::uint32_t>(frame_size);
+    header.size = boost::filesystem::file_size(input_path);
+    header.number_of_frames = (header.size + frame_size - 1) / frame_size;
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<std::uint64_t> frame_offsets;
+    frame_offsets.reserve(header.number_of_frames + 1);
+    frame_offsets.push_back(sizeof(header));
+
+    const auto bound = compressBound(codec, frame_size);
+    const auto frames_per_batch =
+        std::min<std::uint64_t>(FRAMES_PER_BATCH, header.number_of_frames);
+    std::vector<char> uncompressed(
+        std::min<std::uint64_t>(frames_per_batch * frame_size, header.size));
+    std::vector<char> compressed(frames_per_batch * bound);
+    std::vector<std::size_t> compressed_sizes(frames_per_batch);
+    for (std::uint64_t first_frame = 0; first_frame < header.number_of_frames;
+         first_frame += FRAMES_PER_BATCH)
+    {
+        const auto number_of_frames =
+            std::min<std::uint64_t>(FRAMES_PER_BATCH, header.number_of_frames - first_frame);
+        const auto batch_size =
+            std::min<std::uint64_t>(number_of_frames * frame_size,
+                                    header.size - first_frame * frame_size);
+        if (!input.read(uncompressed.data(), batch_size))
+        {
+            throw util::exception("Could not read " + input_path.string() + SOURCE_REF);
+        }
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_frames, 1),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              for (auto frame = range.begin(); frame < range.end(); ++frame)
+                              {
+                                  const auto offset = frame * frame_size;
+                                  compressed_sizes[frame] = compressFrame(
+                                      codec,
+                                      level,
+                                      uncompressed.data() + offset,
+                                      std::min<std::size_t>(frame_size, batch_size - offset),
+                                      compressed.data() + frame * bound,
+                                      bound);
+                              }
+                          });
+
+        for (std::size_t frame = 0; frame < number_of_frames; ++frame)
+        {
+            output.write(compressed.data() + frame * bound, compressed_sizes[frame]);
+            frame_offsets.push_back(frame_offsets.back() + compressed_sizes[frame]);
+        }
+    }
+
+    output.write(reinterpret_cast<const char *>(frame_offsets.data()),
+                 frame_offsets.size() * sizeof(std::uint64_t));
+    if (!output.flush())
+    {
+        throw util::exception("Could not write " + output_path.string() + SOURCE_REF);
+    }
+}
+
+void DecompressFile(const boost::filesystem::path &input_path,
+                    const boost::filesystem::path &output_path)
+{
+    CompressedFileReader reader(input_path);
+    boost::filesystem::ofstream output(output_path, std::ios::binary);
+    if (!output)
+    {
+        throw util::exception("Could not open " + output_path.string() + SOURCE_REF);
+    }
+
+    const std::uint64_t batch_size = FRAMES_PER_BATCH * DEFAULT_COMPRESSION_FRAME_SIZE;
+    std::vector<char> buffer(std::min(batch_size, reader.GetSize()));
+    for (std::uint64_t offset = 0; offset < reader.GetSize(); offset += batch_size)
+    {
+        const auto size = std::min(batch_size, reader.GetSize() - offset);
+        reader.Read(offset, buffer.data(), size);
+        output.write(buffer.data(), size);
+    }
+    if (!output.flush())
+    {
+        throw util::exception("Could not write " + output_path.string() + SOURCE_REF);
+    }
+}
+
+CompressedFileReader::CompressedFileReader(const boost::filesystem::path &path_)
+    : path(path_), cached_frame_index(std::numeric_limits<std::uint64_t>::max())
+{
+    try
+    {
+        file.open(path);
+    }
+    catch (const std::exception &e)
+    {
+        throw util::exception("Could not map " + path.string() + ": " + e.what() + SOURCE_REF);
+    }
+
+    readHeader(path, file.data(), file.size(), header);
+
+    frame_offsets.resize(header.number_of_frames + 1);
+    const auto index_size = frame_offsets.size() * sizeof(std::uint64_t);
+    std::memcpy(frame_offsets.data(), file.data() + file.size() - index_size, index_size);
+
+    const auto frames_end = file.size() - index_size;
+    if (frame_offsets.front() != sizeof(header) || frame_offsets.back() != frames_end ||
+        !std::is_sorted(frame_offsets.begin(), frame_offsets.end()))
+    {
+        throw util::exception(path.string() + " has a corrupt frame index" + SOURCE_REF);
+    }
+}
+
+std::size_t CompressedFileReader::GetFrameSize(const std::uint64_t frame) const
+{
+    return std::min<std::uint64_t>(header.frame_size, header.size - frame * header.frame_size);
+}
+
+void CompressedFileReader::DecompressFrame(const std::uint64_t frame, char *destination) const
+{
+    const auto *source = file.data() + frame_offsets[frame];
+    const std::size_t compressed_size = frame_offsets[frame + 1] - frame_offsets[frame];
+    const std::size_t size = GetFrameSize(frame);
+
+    bool success = false;
+    switch (header.codec)
+    {
+    case CompressionCodec::Zlib:
+    {
+        uLongf decompressed_size = size;
+        success = ::uncompress(reinterpret_cast<Bytef *>(destination),
+                               &decompressed_size,
+                               reinterpret_cast<const Bytef *>(source),
+                               compressed_size) == Z_OK &&
+                  decompressed_size == size;
+        break;
+    }
+#ifdef OSRM_HAVE_ZSTD
+    case CompressionCodec::Zstd:
+    {
+        const auto decompressed_size = ZSTD_decompress(destination, size, source, compressed_size);
+        success = !ZSTD_isError(decompressed_size) && decompressed_size == size;
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+
+    if (!success)
+    {
+        throw util::exception("Could not decompress frame " + std::to_string(frame) + " of " +
+                              path.string() + SOURCE_REF);
+    }
+}
+
+void CompressedFileReader::Read(const std::uint64_t offset,
+                                char *destination,
+                                const std::size_t size)
+{
+    if (size == 0)
+        return;
+    BOOST_ASSERT(offset + size <= header.size);
+
+    const auto frame_size = header.frame_size;
+    const auto first_frame = offset / frame_size;
+    const auto last_frame = (offset + size - 1) / frame_size;
+
+    // copies the part of a frame that is read out of a decompressed frame
+    const auto copy_part = [&](const std::uint64_t frame, const char *decompressed) {
+        const auto begin = std::max(offset, frame * frame_size);
+        const auto end = std::min(offset + size, frame * frame_size + GetFrameSize(frame));
+        std::copy(decompressed + (begin - frame * frame_size),
+                  decompressed + (end - frame * frame_size),
+                  destination + (begin - offset));
+    };
+    const auto is_read_completely = [&](const std::uint64_t frame) {
+        return frame * frame_size >= offset &&
+               frame * frame_size + GetFrameSize(frame) <= offset + size;
+    };
+
+    if (first_frame == last_frame && !is_read_completely(first_frame))
+    {
+        if (cached_frame_index != first_frame)
+        {
+            cached_frame.resize(GetFrameSize(first_frame));
+            cached_frame_index = std::numeric_limits<std::uint64_t>::max();
+            DecompressFrame(first_frame, cached_frame.data());
+            cached_frame_index = first_frame;
+        }
+        copy_part(first_frame, cached_frame.data());
+        return;
+    }
+
+    tbb::parallel_for(
+        tbb::blocked_range<std::uint64_t>(first_frame, last_frame + 1, 1),
+        [&](const tbb::blocked_range<std::uint64_t> &range) {
+            for (auto frame = range.begin(); frame < range.end(); ++frame)
+            {
+                if (is_read_completely(frame))
+                {
+                    DecompressFrame(frame, destination + (frame * frame_size - offset));
+                }
+                else
+                {
+                    std::vector<char> decompressed(GetFrameSize(frame));
+                    DecompressFrame(frame, decompressed.data());
+                    copy_part(frame, decompressed.data());
+                }
+            }
+        });
+}
+}
+}
@@ -6,10 +6,18 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <utility>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace osrm
 {
 namespace util
@@ -82,6 +90,389 @@ double greatCircleDistance(const Coordinate coordinate_1, const Coordinate coord
     return std::hypot(x_value, y_value) * detail::EARTH_RADIUS;
 }
 
+namespace
+{
+// Taylor coefficients of (sin(x) / x - 1) / x^2 in x^2, highest first. Accurate to 1e-13 for
+// |x| <= pi / 2.
+const constexpr double SIN_COEFFICIENTS[] = {1. / 355687428096000.,
+                                             -1. / 1307674368000.,
+                                             1. / 6227020800.,
+                                             -1. / 39916800.,
+                                             1. / 362880.,
+                                             -1. / 5040.,
+                                             1. / 120.,
+                                             -1. / 6.};
+// Taylor coefficients of (asin(x) / x - 1) / x^2 in x^2, highest first. Accurate to 1e-12 for
+// 0 <= x <= 0.5, larger arguments are reflected into this range.
+const constexpr double ASIN_COEFFICIENTS[] = {100180065. / 23622320128.,
+                                              9694845. / 2080374784.,
+                                              5014575. / 973078528.,
+                                              1300075. / 226492416.,
+                                              676039. / 104857600.,
+                                              88179. / 12058624.,
+                                              46189. / 5505024.,
+                                              12155. / 1245184.,
+                                              6435. / 557056.,
+                                              143. / 10240.,
+                                              231. / 13312.,
+                                              63. / 2816.,
+                                              35. / 1152.,
+                                              5. / 112.,
+                                              3. / 40.,
+                                              1. / 6.};
+
+const constexpr double HALF_PI = 1.5707963267948966;
+const constexpr double PI = 3.1415926535897931;
+const constexpr double FIXED_TO_RAD =
+    static_cast<double>(detail::DEGREE_TO_RAD) / COORDINATE_PRECISION;
+const constexpr double DOUBLE_EARTH_RADIUS = 2. * static_cast<double>(detail::EARTH_RADIUS);
+// pairs converted to radians at once by the batched functions
+const constexpr std::size_t DISTANCE_BATCH_SIZE = 64;
+
+// The kernels take the latitudes and longitudes of the pairs in radians in separate arrays.
+// Every kernel works on the pairs one at a time with the same polynomials, so the results
+// don't depend on the instruction set.
+inline double sinPolynomial(const double x)
+{
+    const double x2 = x * x;
+    double p = SIN_COEFFICIENTS[0];
+    for (std::size_t i = 1; i < sizeof(SIN_COEFFICIENTS) / sizeof(double); ++i)
+        p = p * x2 + SIN_COEFFICIENTS[i];
+    return x + x * x2 * p;
+}
+
+inline double asinPolynomial(const double x)
+{
+    const double x2 = x * x;
+    double p = ASIN_COEFFICIENTS[0];
+    for (std::size_t i = 1; i < sizeof(ASIN_COEFFICIENTS) / sizeof(double); ++i)
+        p = p * x2 + ASIN_COEFFICIENTS[i];
+    return x + x * x2 * p;
+}
+
+inline double haversinePair(const double lat1,
+                                    const double lon1,
+                                    const double lat2,
+                                    const double lon2)
+{
+    const double sin_dlat = sinPolynomial(std::abs(lat1 - lat2) * 0.5);
+    // half the longitude difference is up to pi, sin is symmetric around pi / 2
+    const double half_dlon = std::abs(lon1 - lon2) * 0.5;
+    const double sin_dlon = sinPolynomial(std::min(half_dlon, PI - half_dlon));
+    const double cos_lat1 = sinPolynomial(HALF_PI - std::abs(lat1));
+    const double cos_lat2 = sinPolynomial(HALF_PI - std::abs(lat2));
+    const double aharv = std::min(
+        std::max(sin_dlat * sin_dlat + cos_lat1 * cos_lat2 * sin_dlon * sin_dlon, 0.), 1.);
+    // asin(s) = pi / 2 - 2 asin(sqrt((1 - s) / 2)) for the arguments above 0.5
+    const double s = std::sqrt(aharv);
+    const double arc = s <= 0.5 ? asinPolynomial(s)
+                                : HALF_PI - 2. * asinPolynomial(std::sqrt((1. - s) * 0.5));
+    return DOUBLE_EARTH_RADIUS * arc;
+}
+
+inline double greatCirclePair(const double lat1,
+                                      const double lon1,
+                                      const double lat2,
+                                      const double lon2)
+{
+    const double cos_lat = sinPolynomial(HALF_PI - std::abs((lat1 + lat2) * 0.5));
+    const double x_value = (lon2 - lon1) * cos_lat;
+    const double y_value = lat2 - lat1;
+    return std::sqrt(x_value * x_value + y_value * y_value) *
+           static_cast<double>(detail::EARTH_RADIUS);
+}
+
+void haversineKernelScalar(const double *lat1,
+                           const double *lon1,
+                           const double *lat2,
+                           const double *lon2,
+                           const std::size_t count,
+                           double *distances)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        distances[i] = haversinePair(lat1[i], lon1[i], lat2[i], lon2[i]);
+}
+
+void greatCircleKernelScalar(const double *lat1,
+                             const double *lon1,
+                             const double *lat2,
+                             const double *lon2,
+                             const std::size_t count,
+                             double *distances)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        distances[i] = greatCirclePair(lat1[i], lon1[i], lat2[i], lon2[i]);
+}
+
+#if defined(__AVX2__)
+inline __m256d sinPolynomial(const __m256d x)
+{
+    const auto x2 = _mm256_mul_pd(x, x);
+    auto p = _mm256_set1_pd(SIN_COEFFICIENTS[0]);
+    for (std::size_t i = 1; i < sizeof(SIN_COEFFICIENTS) / sizeof(double); ++i)
+        p = _mm256_add_pd(_mm256_mul_pd(p, x2), _mm256_set1_pd(SIN_COEFFICIENTS[i]));
+    return _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(x, x2), p));
+}
+
+inline __m256d asinPolynomial(const __m256d x)
+{
+    const auto x2 = _mm256_mul_pd(x, x);
+    auto p = _mm256_set1_pd(ASIN_COEFFICIENTS[0]);
+    for (std::size_t i = 1; i < sizeof(ASIN_COEFFICIENTS) / sizeof(double); ++i)
+        p = _mm256_add_pd(_mm256_mul_pd(p, x2), _mm256_set1_pd(ASIN_COEFFICIENTS[i]));
+    return _mm256_add_pd(x, _mm256_mul_pd(_mm256_mul_pd(x, x2), p));
+}
+
+inline __m256d absolute(const __m256d x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.), x); }
+
+void haversineKernel(const double *lat1,
+                     const double *lon1,
+                     const double *lat2,
+                     const double *lon2,
+                     const std::size_t count,
+                     double *distances)
+{
+    const auto half = _mm256_set1_pd(0.5);
+    const auto half_pi = _mm256_set1_pd(HALF_PI);
+    const auto pi = _mm256_set1_pd(PI);
+    const auto one = _mm256_set1_pd(1.);
+    const auto zero = _mm256_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto lat1_v = _mm256_loadu_pd(lat1 + i);
+        const auto lat2_v = _mm256_loadu_pd(lat2 + i);
+        const auto half_dlon = _mm256_mul_pd(
+            absolute(_mm256_sub_pd(_mm256_loadu_pd(lon1 + i), _mm256_loadu_pd(lon2 + i))), half);
+
+        const auto sin_dlat =
+            sinPolynomial(_mm256_mul_pd(absolute(_mm256_sub_pd(lat1_v, lat2_v)), half));
+        const auto sin_dlon =
+            sinPolynomial(_mm256_min_pd(half_dlon, _mm256_sub_pd(pi, half_dlon)));
+        const auto cos_lat1 = sinPolynomial(_mm256_sub_pd(half_pi, absolute(lat1_v)));
+        const auto cos_lat2 = sinPolynomial(_mm256_sub_pd(half_pi, absolute(lat2_v)));
+
+        auto aharv = _mm256_add_pd(
+            _mm256_mul_pd(sin_dlat, sin_dlat),
+            _mm256_mul_pd(_mm256_mul_pd(cos_lat1, cos_lat2), _mm256_mul_pd(sin_dlon, sin_dlon)));
+        aharv = _mm256_min_pd(_mm256_max_pd(aharv, zero), one);
+
+        const auto s = _mm256_sqrt_pd(aharv);
+        const auto small = asinPolynomial(s);
+        const auto reflected = _mm256_sub_pd(
+            half_pi,
+            _mm256_mul_pd(_mm256_set1_pd(2.),
+                          asinPolynomial(_mm256_sqrt_pd(
+                              _mm256_mul_pd(_mm256_sub_pd(one, s), half)))));
+        const auto arc =
+            _mm256_blendv_pd(reflected, small, _mm256_cmp_pd(s, half, _CMP_LE_OQ));
+        _mm256_storeu_pd(distances + i,
+                         _mm256_mul_pd(_mm256_set1_pd(DOUBLE_EARTH_RADIUS), arc));
+    }
+
+    haversineKernelScalar(lat1 + i, lon1 + i, lat2 + i, lon2 + i, count - i, distances + i);
+}
+
+void greatCircleKernel(const double *lat1,
+                       const double *lon1,
+                       const double *lat2,
+                       const double *lon2,
+                       const std::size_t count,
+                       double *distances)
+{
+    const auto half = _mm256_set1_pd(0.5);
+    const auto half_pi = _mm256_set1_pd(HALF_PI);
+    const auto earth_radius = _mm256_set1_pd(static_cast<double>(detail::EARTH_RADIUS));
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const auto lat1_v = _mm256_loadu_pd(lat1 + i);
+        const auto lat2_v = _mm256_loadu_pd(lat2 + i);
+        const auto cos_lat = sinPolynomial(
+            _mm256_sub_pd(half_pi, absolute(_mm256_mul_pd(_mm256_add_pd(lat1_v, lat2_v), half))));
+        const auto x_value = _mm256_mul_pd(
+            _mm256_sub_pd(_mm256_loadu_pd(lon2 + i), _mm256_loadu_pd(lon1 + i)), cos_lat);
+        const auto y_value = _mm256_sub_pd(lat2_v, lat1_v);
+        const auto length = _mm256_sqrt_pd(
+            _mm256_add_pd(_mm256_mul_pd(x_value, x_value), _mm256_mul_pd(y_value, y_value)));
+        _mm256_storeu_pd(distances + i, _mm256_mul_pd(length, earth_radius));
+    }
+
+    greatCircleKernelScalar(lat1 + i, lon1 + i, lat2 + i, lon2 + i, count - i, distances + i);
+}
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+inline float64x2_t sinPolynomial(const float64x2_t x)
+{
+    const auto x2 = vmulq_f64(x, x);
+    auto p = vdupq_n_f64(SIN_COEFFICIENTS[0]);
+    for (std::size_t i = 1; i < sizeof(SIN_COEFFICIENTS) / sizeof(double); ++i)
+        p = vaddq_f64(vmulq_f64(p, x2), vdupq_n_f64(SIN_COEFFICIENTS[i]));
+    return vaddq_f64(x, vmulq_f64(vmulq_f64(x, x2), p));
+}
+
+inline float64x2_t asinPolynomial(const float64x2_t x)
+{
+    const auto x2 = vmulq_f64(x, x);
+    auto p = vdupq_n_f64(ASIN_COEFFICIENTS[0]);
+    for (std::size_t i = 1; i < sizeof(ASIN_COEFFICIENTS) / sizeof(double); ++i)
+        p = vaddq_f64(vmulq_f64(p, x2), vdupq_n_f64(ASIN_COEFFICIENTS[i]));
+    return vaddq_f64(x, vmulq_f64(vmulq_f64(x, x2), p));
+}
+
+void haversineKernel(const double *lat1,
+                     const double *lon1,
+                     const double *lat2,
+                     const double *lon2,
+                     const std::size_t count,
+                     double *distances)
+{
+    const auto half = vdupq_n_f64(0.5);
+    const auto half_pi = vdupq_n_f64(HALF_PI);
+    const auto pi = vdupq_n_f64(PI);
+    const auto one = vdupq_n_f64(1.);
+    const auto zero = vdupq_n_f64(0.);
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const auto lat1_v = vld1q_f64(lat1 + i);
+        const auto lat2_v = vld1q_f64(lat2 + i);
+        const auto half_dlon =
+            vmulq_f64(vabdq_f64(vld1q_f64(lon1 + i), vld1q_f64(lon2 + i)), half);
+
+        const auto sin_dlat = sinPolynomial(vmulq_f64(vabdq_f64(lat1_v, lat2_v), half));
+        const auto sin_dlon = sinPolynomial(vminq_f64(half_dlon, vsubq_f64(pi, half_dlon)));
+        const auto cos_lat1 = sinPolynomial(vsubq_f64(half_pi, vabsq_f64(lat1_v)));
+        const auto cos_lat2 = sinPolynomial(vsubq_f64(half_pi, vabsq_f64(lat2_v)));
+
+        auto aharv =
+            vaddq_f64(vmulq_f64(sin_dlat, sin_dlat),
+                      vmulq_f64(vmulq_f64(cos_lat1, cos_lat2), vmulq_f64(sin_dlon, sin_dlon)));
+        aharv = vminq_f64(vmaxq_f64(aharv, zero), one);
+
+        const auto s = vsqrtq_f64(aharv);
+        const auto small = asinPolynomial(s);
+        const auto reflected =
+            vsubq_f64(half_pi,
+                      vmulq_f64(vdupq_n_f64(2.),
+                                asinPolynomial(vsqrtq_f64(vmulq_f64(vsubq_f64(one, s), half)))));
+        const auto arc = vbslq_f64(vcleq_f64(s, half), small, reflected);
+        vst1q_f64(distances + i, vmulq_f64(vdupq_n_f64(DOUBLE_EARTH_RADIUS), arc));
+    }
+
+    haversineKernelScalar(lat1 + i, lon1 + i, lat2 + i, lon2 + i, count - i, distances + i);
+}
+
+void greatCircleKernel(const double *lat1,
+                       const double *lon1,
+                       const double *lat2,
+                       const double *lon2,
+                       const std::size_t count,
+                       double *distances)
+{
+    const auto half = vdupq_n_f64(0.5);
+    const auto half_pi = vdupq_n_f64(HALF_PI);
+    const auto earth_radius = vdupq_n_f64(static_cast<double>(detail::EARTH_RADIUS));
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const auto lat1_v = vld1q_f64(lat1 + i);
+        const auto lat2_v = vld1q_f64(lat2 + i);
+        const auto cos_lat = sinPolynomial(
+            vsubq_f64(half_pi, vabsq_f64(vmulq_f64(vaddq_f64(lat1_v, lat2_v), half))));
+        const auto x_value =
+            vmulq_f64(vsubq_f64(vld1q_f64(lon2 + i), vld1q_f64(lon1 + i)), cos_lat);
+        const auto y_value = vsubq_f64(lat2_v, lat1_v);
+        const auto length =
+            vsqrtq_f64(vaddq_f64(vmulq_f64(x_value, x_value), vmulq_f64(y_value, y_value)));
+        vst1q_f64(distances + i, vmulq_f64(length, earth_radius));
+    }
+
+    greatCircleKernelScalar(lat1 + i, lon1 + i, lat2 + i, lon2 + i, count - i, distances + i);
+}
+#else
+void haversineKernel(const double *lat1,
+                     const double *lon1,
+                     const double *lat2,
+                     const double *lon2,
+                     const std::size_t count,
+                     double *distances)
+{
+    haversineKernelScalar(lat1, lon1, lat2, lon2, count, distances);
+}
+
+void greatCircleKernel(const double *lat1,
+                       const double *lon1,
+                       const double *lat2,
+                       const double *lon2,
+                       const std::size_t count,
+                       double *distances)
+{
+    greatCircleKernelScalar(lat1, lon1, lat2, lon2, count, distances);
+}
+#endif
+
+// Converts batches of pairs to radians in separate arrays and runs the kernel on them
+template <typename KernelT>
+void batchedDistances(const Coordinate *first,
+                      const Coordinate *second,
+                      const std::size_t count,
+                      double *distances,
+                      const KernelT kernel)
+{
+    std::array<double, DISTANCE_BATCH_SIZE> lat1, lon1, lat2, lon2;
+    for (std::size_t begin = 0; begin < count; begin += DISTANCE_BATCH_SIZE)
+    {
+        const auto size = std::min(DISTANCE_BATCH_SIZE, count - begin);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            lat1[i] = static_cast<std::int32_t>(first[begin + i].lat) * FIXED_TO_RAD;
+            lon1[i] = static_cast<std::int32_t>(first[begin + i].lon) * FIXED_TO_RAD;
+            lat2[i] = static_cast<std::int32_t>(second[begin + i].lat) * FIXED_TO_RAD;
+            lon2[i] = static_cast<std::int32_t>(second[begin + i].lon) * FIXED_TO_RAD;
+        }
+        kernel(lat1.data(), lon1.data(), lat2.data(), lon2.data(), size, distances + begin);
+    }
+}
+}
+
+void haversineDistances(const Coordinate *first,
+                        const Coordinate *second,
+                        const std::size_t count,
+                        double *distances)
+{
+    batchedDistances(first, second, count, distances, haversineKernel);
+}
+
+void greatCircleDistances(const Coordinate *first,
+                          const Coordinate *second,
+                          const std::size_t count,
+                          double *distances)
+{
+    batchedDistances(first, second, count, distances, greatCircleKernel);
+}
+
+double haversineLength(const Coordinate *coordinates, const std::size_t count)
+{
+    if (count < 2)
+        return 0.;
+
+    std::array<double, DISTANCE_BATCH_SIZE> distances;
+    double length = 0.;
+    for (std::size_t begin = 0; begin + 1 < count; begin += DISTANCE_BATCH_SIZE)
+    {
+        const auto size = std::min(DISTANCE_BATCH_SIZE, count - 1 - begin);
+        haversineDistances(coordinates + begin, coordinates + begin + 1, size, distances.data());
+        // summed in order, like the scalar loops the batches replace
+        for (std::size_t i = 0; i < size; ++i)
+            length += distances[i];
+    }
+    return length;
+}
+
 double perpendicularDistance(const Coordinate segment_source,
                              const Coordinate segment_target,
                              const Coordinate query_location,
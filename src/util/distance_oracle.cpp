@@ -0,0 +1,265 @@
+#include "util/distance_oracle.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+// Arcs by one of their ends in compressed sparse row format
+struct Adjacency
+{
+    Adjacency(const std::size_t number_of_nodes,
+              const std::vector<DistanceOracleArc> &arcs,
+              const bool by_source)
+        : offsets(number_of_nodes + 1, 0), heads(arcs.size()), durations(arcs.size())
+    {
+        for (const auto &arc : arcs)
+            ++offsets[(by_source ? arc.source : arc.target) + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        auto positions = offsets;
+        for (const auto &arc : arcs)
+        {
+            const auto tail = by_source ? arc.source : arc.target;
+            const auto position = positions[tail]++;
+            heads[position] = by_source ? arc.target : arc.source;
+            durations[position] = arc.duration;
+        }
+    }
+
+    std::size_t GetNumberOfNodes() const { return offsets.size() - 1; }
+
+    std::vector<std::size_t> offsets;
+    std::vector<NodeID> heads;
+    std::vector<EdgeDuration> durations;
+};
+
+using Entry = std::pair<EdgeDuration, NodeID>;
+using Queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+// Dijkstra that only follows the arcs inside of the cell of its source. The durations of all
+// nodes are kept between the searches, each search only resets the nodes of the one before.
+class CellSearch
+{
+  public:
+    CellSearch(const Adjacency &graph, const std::vector<CellID> &cells)
+        : graph(graph), cells(cells), durations(graph.GetNumberOfNodes(), MAXIMAL_EDGE_DURATION),
+          parents(graph.GetNumberOfNodes(), SPECIAL_NODEID)
+    {
+    }
+
+    // The nodes reachable inside of the cell in the order of their duration
+    const std::vector<NodeID> &Run(const NodeID source)
+    {
+        for (const auto node : settled)
+        {
+            durations[node] = MAXIMAL_EDGE_DURATION;
+            parents[node] = SPECIAL_NODEID;
+        }
+        settled.clear();
+
+        const auto cell = cells[source];
+        Queue queue;
+        durations[source] = 0;
+        parents[source] = source;
+        queue.emplace(0, source);
+        while (!queue.empty())
+        {
+            const auto duration = queue.top().first;
+            const auto node = queue.top().second;
+            queue.pop();
+            if (duration != durations[node])
+                continue;
+            settled.push_back(node);
+
+            for (const auto index : irange(graph.offsets[node], graph.offsets[node + 1]))
+            {
+                const auto head = graph.heads[index];
+                const auto to_duration = duration + graph.durations[index];
+                if (cells[head] == cell && to_duration < durations[head])
+                {
+                    durations[head] = to_duration;
+                    parents[head] = node;
+                    queue.emplace(to_duration, head);
+                }
+            }
+        }
+        return settled;
+    }
+
+    EdgeDuration GetDuration(const NodeID node) const { return durations[node]; }
+
+    NodeID GetParent(const NodeID node) const { return parents[node]; }
+
+  private:
+    const Adjacency &graph;
+    const std::vector<CellID> &cells;
+    std::vector<EdgeDuration> durations;
+    std::vector<NodeID> parents;
+    std::vector<NodeID> settled;
+};
+
+// Dijkstra over the whole graph that stops as soon as settle returns false
+template <typename SettleT>
+void search(const Adjacency &graph,
+            const NodeID source,
+            std::vector<EdgeDuration> &durations,
+            SettleT settle)
+{
+    std::fill(durations.begin(), durations.end(), MAXIMAL_EDGE_DURATION);
+    Queue queue;
+    durations[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto duration = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (duration != durations[node])
+            continue;
+        if (!settle(node, duration))
+            return;
+
+        for (const auto index : irange(graph.offsets[node], graph.offsets[node + 1]))
+        {
+            const auto head = graph.heads[index];
+            const auto to_duration = duration + graph.durations[index];
+            if (to_duration < durations[head])
+            {
+                durations[head] = to_duration;
+                queue.emplace(to_duration, head);
+            }
+        }
+    }
+}
+
+// The middle of the path to the farthest node from a node that is far from any node of the cell
+NodeID selectRepresentative(CellSearch &search, const NodeID node)
+{
+    const auto start = search.Run(node).back();
+    const auto end = search.Run(start).back();
+    const auto half = search.GetDuration(end) / 2;
+
+    auto representative = end;
+    while (representative != start && search.GetDuration(representative) > half)
+        representative = search.GetParent(representative);
+    return representative;
+}
+}
+
+DistanceOracle buildDistanceOracle(const std::vector<DistanceOracleArc> &arcs,
+                                   const std::vector<CellID> &cells,
+                                   const std::size_t number_of_cells)
+{
+    const auto number_of_nodes = cells.size();
+    if (number_of_nodes == 0 || number_of_cells == 0)
+        return DistanceOracle{};
+
+    const Adjacency forward(number_of_nodes, arcs, true);
+    const Adjacency backward(number_of_nodes, arcs, false);
+
+    // the first node of every cell with an arc is where its representative is searched from
+    std::vector<NodeID> representatives(number_of_cells, SPECIAL_NODEID);
+    for (const auto node : irange<NodeID>(0, number_of_nodes))
+    {
+        BOOST_ASSERT(cells[node] < number_of_cells);
+        if (representatives[cells[node]] == SPECIAL_NODEID &&
+            forward.offsets[node] != forward.offsets[node + 1])
+        {
+            representatives[cells[node]] = node;
+        }
+    }
+
+    CellSearch cell_search(forward, cells);
+    for (auto &representative : representatives)
+    {
+        if (representative != SPECIAL_NODEID)
+            representative = selectRepresentative(cell_search, representative);
+    }
+
+    std::vector<bool> is_representative(number_of_nodes, false);
+    std::size_t number_of_representatives = 0;
+    for (const auto representative : representatives)
+    {
+        if (representative != SPECIAL_NODEID)
+        {
+            is_representative[representative] = true;
+            ++number_of_representatives;
+        }
+    }
+    std::vector<std::size_t> cell_sizes(number_of_cells, 0);
+    for (const auto cell : cells)
+        ++cell_sizes[cell];
+
+    // The searches from a representative stop as soon as they settled all representatives and
+    // all nodes of its cell, the ones to it as soon as they settled the nodes of its cell. Only
+    // the searches of a cell write the durations of its nodes.
+    std::vector<EdgeDuration> node_durations(2 * number_of_nodes, MAXIMAL_EDGE_DURATION);
+    std::vector<EdgeDuration> cell_durations(number_of_cells * number_of_cells,
+                                             MAXIMAL_EDGE_DURATION);
+    tbb::parallel_for(
+        tbb::blocked_range<CellID>(0, number_of_cells),
+        [&](const tbb::blocked_range<CellID> &range) {
+            std::vector<EdgeDuration> durations(number_of_nodes);
+            for (const auto cell : irange(range.begin(), range.end()))
+            {
+                const auto representative = representatives[cell];
+                if (representative == SPECIAL_NODEID)
+                    continue;
+
+                auto row = cell_durations.begin() + cell * number_of_cells;
+                auto remaining_representatives = number_of_representatives;
+                auto remaining_nodes = cell_sizes[cell];
+                search(forward,
+                       representative,
+                       durations,
+                       [&](const NodeID node, const EdgeDuration duration) {
+                           if (is_representative[node])
+                           {
+                               row[cells[node]] = duration;
+                               --remaining_representatives;
+                           }
+                           if (cells[node] == cell)
+                           {
+                               node_durations[2 * node + 1] = duration;
+                               --remaining_nodes;
+                           }
+                           return remaining_representatives > 0 || remaining_nodes > 0;
+                       });
+
+                remaining_nodes = cell_sizes[cell];
+                search(backward,
+                       representative,
+                       durations,
+                       [&](const NodeID node, const EdgeDuration duration) {
+                           if (cells[node] == cell)
+                           {
+                               node_durations[2 * node] = duration;
+                               --remaining_nodes;
+                           }
+                           return remaining_nodes > 0;
+                       });
+            }
+        });
+
+    return DistanceOracle{std::move(representatives),
+                          std::vector<CellID>(cells),
+                          std::move(node_durations),
+                          std::move(cell_durations)};
+}
+}
+}
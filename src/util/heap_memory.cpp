@@ -0,0 +1,60 @@
+#include "util/heap_memory.hpp"
+
+#include <sstream>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+// Resets the memory of the thread once it exits and its heaps are released
+template <typename ThreadMemory> struct ThreadMemoryGuard
+{
+    ~ThreadMemoryGuard()
+    {
+        if (memory)
+        {
+            memory->bytes = 0;
+        }
+    }
+
+    ThreadMemory *memory = nullptr;
+};
+}
+
+HeapMemoryMetrics &HeapMemoryMetrics::GetInstance()
+{
+    static HeapMemoryMetrics metrics;
+    return metrics;
+}
+
+void HeapMemoryMetrics::SetCurrent(const std::size_t bytes)
+{
+    // the entries outlive their thread so the numbers of the threads stay stable
+    thread_local ThreadMemoryGuard<ThreadMemory> thread_memory;
+    if (!thread_memory.memory)
+    {
+        std::lock_guard<std::mutex> guard(threads_lock);
+        threads.push_back(std::make_unique<ThreadMemory>(threads.size()));
+        thread_memory.memory = threads.back().get();
+    }
+    thread_memory.memory->bytes = bytes;
+}
+
+std::string HeapMemoryMetrics::DumpPrometheus() const
+{
+    std::stringstream out;
+    out << "# HELP osrm_search_heap_bytes Bytes held by the search heaps of a thread.\n";
+    out << "# TYPE osrm_search_heap_bytes gauge\n";
+    std::lock_guard<std::mutex> guard(threads_lock);
+    for (const auto &thread : threads)
+    {
+        out << "osrm_search_heap_bytes{thread=\"" << thread->number << "\"} "
+            << thread->bytes.load() << "\n";
+    }
+    return out.str();
+}
+}
+}
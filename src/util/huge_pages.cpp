@@ -0,0 +1,139 @@
+#include "util/huge_pages.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <new>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+#ifdef __linux__
+// madvise succeeds even if transparent huge pages are turned off
+bool transparentHugePagesEnabled()
+{
+    boost::filesystem::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string modes;
+    return std::getline(file, modes) && modes.find("[never]") == std::string::npos;
+}
+#endif
+}
+
+const char *ToString(const HugePages huge_pages)
+{
+    switch (huge_pages)
+    {
+    case HugePages::Transparent:
+        return "transparent huge pages";
+    case HugePages::Explicit:
+        return "huge pages";
+    case HugePages::None:
+        break;
+    }
+    return "default pages";
+}
+
+std::size_t GetHugePageSize()
+{
+#ifdef __linux__
+    static const std::size_t huge_page_size = [] {
+        boost::filesystem::ifstream meminfo("/proc/meminfo");
+        std::string line;
+        while (std::getline(meminfo, line))
+        {
+            // e.g. "Hugepagesize:       2048 kB"
+            if (line.compare(0, 13, "Hugepagesize:") == 0)
+            {
+                try
+                {
+                    return static_cast<std::size_t>(std::stoull(line.substr(13))) * 1024;
+                }
+                catch (const std::exception &)
+                {
+                    break;
+                }
+            }
+        }
+        return std::size_t{0};
+    }();
+    return huge_page_size;
+#else
+    return 0;
+#endif
+}
+
+std::size_t RoundToHugePages(const std::size_t size)
+{
+    const auto huge_page_size = GetHugePageSize();
+    if (huge_page_size == 0)
+        return size;
+    return (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+HugePageMemory::HugePageMemory(const std::size_t size, const bool use_huge_pages)
+    : memory(nullptr), mapping(nullptr), mapping_size(0), huge_pages(HugePages::None)
+{
+#ifdef __linux__
+    const auto huge_page_size = GetHugePageSize();
+    if (use_huge_pages && huge_page_size > 0)
+    {
+        mapping_size = RoundToHugePages(std::max<std::size_t>(size, 1));
+        // fails right away if not enough pages are reserved
+        mapping = mmap(nullptr,
+                       mapping_size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                       -1,
+                       0);
+        if (mapping != MAP_FAILED)
+        {
+            memory = static_cast<char *>(mapping);
+            huge_pages = HugePages::Explicit;
+            return;
+        }
+    }
+
+    // transparent huge pages only cover aligned ranges, so the block starts at a huge page
+    const auto alignment = use_huge_pages ? huge_page_size : 0;
+    mapping_size = std::max<std::size_t>(size, 1) + alignment;
+    mapping = mmap(
+        nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    memory = static_cast<char *>(mapping);
+    if (alignment > 0)
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(mapping);
+        memory += (alignment - address % alignment) % alignment;
+        if (transparentHugePagesEnabled() &&
+            madvise(memory, mapping_size - alignment, MADV_HUGEPAGE) == 0)
+        {
+            huge_pages = HugePages::Transparent;
+        }
+    }
+#else
+    (void)use_huge_pages;
+    fallback = std::make_unique<char[]>(size);
+    memory = fallback.get();
+#endif
+}
+
+HugePageMemory::~HugePageMemory()
+{
+#ifdef __linux__
+    munmap(mapping, mapping_size);
+#endif
+}
+}
+}
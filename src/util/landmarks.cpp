@@ -0,0 +1,279 @@
+#include "util/landmarks.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <tbb/parallel_invoke.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+// Chosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+// Arcs by one of their ends in compressed sparse row format
+struct Adjacency
+{
+    Adjacency(const std::size_t number_of_nodes,
+              const std::vector<LandmarkArc> &arcs,
+              const bool by_source)
+        : offsets(number_of_nodes + 1, 0), heads(arcs.size()), weights(arcs.size())
+    {
+        for (const auto &arc : arcs)
+            ++offsets[(by_source ? arc.source : arc.target) + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        auto positions = offsets;
+        for (const auto &arc : arcs)
+        {
+            const auto tail = by_source ? arc.source : arc.target;
+            const auto position = positions[tail]++;
+            heads[position] = by_source ? arc.target : arc.source;
+            weights[position] = arc.weight;
+        }
+    }
+
+    std::size_t GetNumberOfNodes() const { return offsets.size() - 1; }
+
+    std::vector<std::size_t> offsets;
+    std::vector<NodeID> heads;
+    std::vector<EdgeWeight> weights;
+};
+
+// Weights of the shortest paths from the source, INVALID_EDGE_WEIGHT for unreached nodes. The
+// parents and the settled nodes in the order of their weight are only recorded if requested.
+std::vector<EdgeWeight> dijkstra(const Adjacency &graph,
+                                 const NodeID source,
+                                 std::vector<NodeID> *parents = nullptr,
+                                 std::vector<NodeID> *settled = nullptr)
+{
+    std::vector<EdgeWeight> weights(graph.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+    if (parents)
+        parents->assign(graph.GetNumberOfNodes(), SPECIAL_NODEID);
+    if (settled)
+        settled->clear();
+
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    weights[source] = 0;
+    if (parents)
+        (*parents)[source] = source;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto weight = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (weight != weights[node])
+            continue;
+        if (settled)
+            settled->push_back(node);
+
+        for (const auto index : irange(graph.offsets[node], graph.offsets[node + 1]))
+        {
+            const auto head = graph.heads[index];
+            const auto to_weight = weight + graph.weights[index];
+            if (to_weight < weights[head])
+            {
+                weights[head] = to_weight;
+                if (parents)
+                    (*parents)[head] = node;
+                queue.emplace(to_weight, head);
+            }
+        }
+    }
+    return weights;
+}
+
+// Quantizes the weights of all nodes to and from one landmark into their columns
+EdgeWeight storeLandmark(const std::vector<EdgeWeight> &to_landmark,
+                         const std::vector<EdgeWeight> &from_landmark,
+                         const std::size_t index,
+                         const std::size_t number_of_landmarks,
+                         std::vector<Landmarks::Distance> &distances)
+{
+    EdgeWeight max_weight = 0;
+    for (const auto &weights : {std::cref(to_landmark), std::cref(from_landmark)})
+        for (const auto weight : weights.get())
+            if (weight != INVALID_EDGE_WEIGHT)
+                max_weight = std::max(max_weight, weight);
+
+    // the largest weight is stored as UNREACHABLE - 1
+    const EdgeWeight max_distance = Landmarks::UNREACHABLE - 1;
+    const EdgeWeight unit = std::max<EdgeWeight>(1, (max_weight + max_distance - 1) / max_distance);
+
+    const auto quantize = [unit](const EdgeWeight weight) {
+        return weight == INVALID_EDGE_WEIGHT ? Landmarks::UNREACHABLE
+                                             : static_cast<Landmarks::Distance>(weight / unit);
+    };
+    const auto stride = 2 * number_of_landmarks;
+    for (const auto node : irange<std::size_t>(0, to_landmark.size()))
+    {
+        distances[node * stride + 2 * index] = quantize(to_landmark[node]);
+        distances[node * stride + 2 * index + 1] = quantize(from_landmark[node]);
+    }
+    return unit;
+}
+
+// Weights of the first landmarks only, out of the weights of all nodes to and from all landmarks
+std::vector<Landmarks::Distance> selectColumns(const std::vector<Landmarks::Distance> &distances,
+                                               const std::size_t number_of_landmarks,
+                                               const std::size_t number_of_selected)
+{
+    const auto stride = 2 * number_of_landmarks;
+    const auto number_of_nodes = distances.size() / stride;
+
+    std::vector<Landmarks::Distance> selected;
+    selected.reserve(number_of_nodes * 2 * number_of_selected);
+    for (const auto node : irange<std::size_t>(0, number_of_nodes))
+    {
+        const auto row = distances.begin() + node * stride;
+        selected.insert(selected.end(), row, row + 2 * number_of_selected);
+    }
+    return selected;
+}
+}
+
+Landmarks buildLandmarks(const std::size_t number_of_nodes,
+                         const std::vector<LandmarkArc> &arcs,
+                         const std::size_t number_of_landmarks)
+{
+    if (number_of_nodes == 0 || number_of_landmarks == 0)
+        return Landmarks{};
+
+    const Adjacency forward(number_of_nodes, arcs, true);
+    const Adjacency backward(number_of_nodes, arcs, false);
+
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> random_node(0, number_of_nodes - 1);
+    const auto root = [&] {
+        // isolated nodes would only reach themselves
+        for (;;)
+        {
+            const auto node = random_node(generator);
+            if (forward.offsets[node] != forward.offsets[node + 1])
+                return node;
+        }
+    };
+
+    std::vector<NodeID> landmarks;
+    std::vector<EdgeWeight> units;
+    std::vector<Landmarks::Distance> distances(number_of_nodes * 2 * number_of_landmarks);
+    std::vector<bool> is_landmark(number_of_nodes, false);
+
+    std::vector<NodeID> parents, settled;
+    std::vector<std::uint64_t> sizes(number_of_nodes);
+    std::vector<bool> covered(number_of_nodes);
+    while (landmarks.size() < number_of_landmarks && !arcs.empty())
+    {
+        NodeID landmark = SPECIAL_NODEID;
+        if (landmarks.empty())
+        {
+            dijkstra(forward, root(), nullptr, &settled);
+            landmark = settled.back();
+        }
+        else
+        {
+            const Landmarks selected{
+                landmarks, units, selectColumns(distances, number_of_landmarks, landmarks.size())};
+
+            const auto source = root();
+            const auto weights = dijkstra(forward, source, &parents, &settled);
+
+            // the size of a subtree sums how much the lower bounds underestimate the weights of
+            // its nodes, subtrees with a landmark are covered and have none
+            std::fill(sizes.begin(), sizes.end(), 0);
+            std::fill(covered.begin(), covered.end(), false);
+            for (auto iter = settled.rbegin(); iter != settled.rend(); ++iter)
+            {
+                const auto node = *iter;
+                covered[node] = covered[node] || is_landmark[node];
+                sizes[node] =
+                    covered[node] ? 0
+                                  : sizes[node] + weights[node] -
+                                        selected.GetLowerBound(source, static_cast<NodeID>(node));
+                if (parents[node] != node)
+                {
+                    sizes[parents[node]] += sizes[node];
+                    covered[parents[node]] = covered[parents[node]] || covered[node];
+                }
+            }
+
+            // children of the nodes of the tree
+            std::vector<std::size_t> first_child(number_of_nodes + 1, 0);
+            for (const auto node : settled)
+                if (parents[node] != node)
+                    ++first_child[parents[node] + 1];
+            std::partial_sum(first_child.begin(), first_child.end(), first_child.begin());
+            std::vector<NodeID> children(first_child.back());
+            {
+                auto positions = first_child;
+                for (const auto node : settled)
+                    if (parents[node] != node)
+                        children[positions[parents[node]]++] = node;
+            }
+
+            // descends from the root along the largest subtrees down to a leaf, the root itself
+            // is always covered if a landmark is reachable
+            landmark = source;
+            for (;;)
+            {
+                NodeID largest = SPECIAL_NODEID;
+                const auto begin = first_child[landmark], end = first_child[landmark + 1];
+                for (const auto child :
+                     boost::make_iterator_range(children.begin() + begin, children.begin() + end))
+                {
+                    if (largest == SPECIAL_NODEID || sizes[child] > sizes[largest])
+                        largest = child;
+                }
+                if (largest == SPECIAL_NODEID || sizes[largest] == 0)
+                    break;
+                landmark = largest;
+            }
+
+            // if the bounds are exact everywhere the farthest new node is the best guess
+            if (landmark == source)
+            {
+                const auto farthest =
+                    std::find_if(settled.rbegin(), settled.rend(), [&](const NodeID node) {
+                        return !is_landmark[node];
+                    });
+                landmark = farthest == settled.rend() ? source : *farthest;
+            }
+        }
+
+        if (is_landmark[landmark])
+        {
+            util::Log(logWARNING) << "Only found " << landmarks.size() << " distinct landmarks";
+            break;
+        }
+
+        std::vector<EdgeWeight> to_landmark, from_landmark;
+        tbb::parallel_invoke([&] { to_landmark = dijkstra(backward, landmark); },
+                             [&] { from_landmark = dijkstra(forward, landmark); });
+        units.push_back(storeLandmark(
+            to_landmark, from_landmark, landmarks.size(), number_of_landmarks, distances));
+        landmarks.push_back(landmark);
+        is_landmark[landmark] = true;
+    }
+
+    // fewer landmarks than requested are stored densely
+    if (landmarks.size() < number_of_landmarks)
+        distances = selectColumns(distances, number_of_landmarks, landmarks.size());
+
+    return Landmarks{std::move(landmarks), std::move(units), std::move(distances)};
+}
+}
+}
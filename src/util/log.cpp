@@ -1,4 +1,5 @@
 #include "util/log.hpp"
+#include "util/async_log.hpp"
 #include "util/isatty.hpp"
 #include <cstdio>
 #include <iostream>
@@ -38,7 +39,12 @@ LogPolicy &LogPolicy::GetInstance()
 Log::Log(LogLevel level_, std::ostream &ostream) : level(level_), stream(ostream)
 {
     const bool is_terminal = IsStdoutATTY();
-    std::lock_guard<std::mutex> lock(get_mutex());
+    // only a shared stream needs the lock, buffered lines are written at once when they end
+    std::unique_lock<std::mutex> lock(get_mutex(), std::defer_lock);
+    if (&stream != &buffer)
+    {
+        lock.lock();
+    }
     switch (level)
     {
     case logWARNING:
@@ -75,39 +81,56 @@ std::mutex &Log::get_mutex()
  */
 Log::~Log()
 {
-    std::lock_guard<std::mutex> lock(get_mutex());
     const bool usestd = (&stream == &buffer);
-    if (!LogPolicy::GetInstance().IsMute())
+    if (LogPolicy::GetInstance().IsMute())
+    {
+        return;
+    }
+
+    const bool is_terminal = IsStdoutATTY();
+    auto &async_writer = AsyncLogWriter::GetInstance();
+    if (usestd && async_writer.IsRunning())
     {
-        const bool is_terminal = IsStdoutATTY();
-        if (usestd)
-        {
-            switch (level)
-            {
-            case logWARNING:
-            case logERROR:
-                std::cerr << buffer.str();
-                std::cerr << (is_terminal ? COL_RESET : "");
-                std::cerr << std::endl;
-                break;
-            case logDEBUG:
 #ifdef NDEBUG
-                break;
-#endif
-            case logINFO:
-            default:
-                std::cout << buffer.str();
-                std::cout << (is_terminal ? COL_RESET : "");
-                std::cout << std::endl;
-                break;
-            }
+        if (level == logDEBUG)
+        {
+            return;
         }
-        else
+#endif
+        std::string line = buffer.str();
+        line += is_terminal ? COL_RESET : "";
+        async_writer.Push(level, line);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(get_mutex());
+    if (usestd)
+    {
+        switch (level)
         {
-            stream << (is_terminal ? COL_RESET : "");
-            stream << std::endl;
+        case logWARNING:
+        case logERROR:
+            std::cerr << buffer.str();
+            std::cerr << (is_terminal ? COL_RESET : "");
+            std::cerr << std::endl;
+            break;
+        case logDEBUG:
+#ifdef NDEBUG
+            break;
+#endif
+        case logINFO:
+        default:
+            std::cout << buffer.str();
+            std::cout << (is_terminal ? COL_RESET : "");
+            std::cout << std::endl;
+            break;
         }
     }
+    else
+    {
+        stream << (is_terminal ? COL_RESET : "");
+        stream << std::endl;
+    }
 }
 
 UnbufferedLog::UnbufferedLog(LogLevel level_)
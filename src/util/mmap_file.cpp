@@ -0,0 +1,79 @@
+#include "util/mmap_file.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+void adviseMappedFile(const char *data, const std::size_t size, const MappedFileAccess access)
+{
+#ifdef __linux__
+    if (size == 0 || access == MappedFileAccess::Default)
+        return;
+
+    // mappings of whole files start at a page boundary
+    auto *address = const_cast<char *>(data);
+    if (access == MappedFileAccess::Random)
+    {
+        madvise(address, size, MADV_RANDOM);
+        return;
+    }
+
+    // starts the read of the whole file, then faults every page in like MAP_POPULATE would
+    madvise(address, size, MADV_WILLNEED);
+    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    volatile char sink = 0;
+    for (std::size_t offset = 0; offset < size; offset += page_size)
+    {
+        sink = sink + data[offset];
+    }
+#else
+    (void)data;
+    (void)size;
+    (void)access;
+#endif
+}
+
+std::size_t getResidentBytes(const char *data, const std::size_t size)
+{
+#ifdef __linux__
+    if (size == 0)
+        return 0;
+
+    // mincore wants the address of a page, blocks of the data layout start anywhere
+    const auto page_size = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(data);
+    const auto end = begin + size;
+    const auto first_page = begin & ~(page_size - 1);
+    const auto num_pages = (end - first_page + page_size - 1) / page_size;
+
+    std::vector<unsigned char> pages(num_pages);
+    if (mincore(reinterpret_cast<void *>(first_page), end - first_page, pages.data()) != 0)
+        return 0;
+
+    std::size_t resident = 0;
+    for (std::size_t index = 0; index < num_pages; ++index)
+    {
+        if ((pages[index] & 1) == 0)
+            continue;
+        const auto page_begin = std::max<std::uintptr_t>(first_page + index * page_size, begin);
+        const auto page_end = std::min<std::uintptr_t>(first_page + (index + 1) * page_size, end);
+        resident += page_end - page_begin;
+    }
+    return resident;
+#else
+    (void)data;
+    return size;
+#endif
+}
+}
+}
@@ -2,6 +2,11 @@
 #include "storage/io.hpp"
 #include "util/log.hpp"
 
+#include <boost/assert.hpp>
+
+#include <cstring>
+#include <unordered_map>
+
 namespace osrm
 {
 namespace util
@@ -32,12 +37,72 @@ void NameTable::reset(ValueType *begin, ValueType *end)
     m_name_table.reset(begin, end);
 }
 
+std::size_t NameTable::Deduplicate(std::vector<std::uint32_t> &offsets,
+                                   std::vector<unsigned char> &data)
+{
+    BOOST_ASSERT(!offsets.empty() && offsets.back() == data.size());
+
+    std::vector<std::uint32_t> deduplicated_offsets;
+    std::vector<unsigned char> deduplicated_data;
+    deduplicated_offsets.reserve(offsets.size());
+    deduplicated_data.reserve(data.size());
+
+    const auto *chars = reinterpret_cast<const char *>(data.data());
+    std::unordered_map<StringView, std::uint32_t> first_copies;
+    for (std::uint32_t index = 0; index + 1 < offsets.size(); ++index)
+    {
+        const auto begin = data.begin() + offsets[index];
+        const auto end = data.begin() + offsets[index + 1];
+        const StringView string(chars + offsets[index], offsets[index + 1] - offsets[index]);
+        BOOST_ASSERT(!IsReference(string));
+
+        deduplicated_offsets.push_back(deduplicated_data.size());
+        if (string.size() < MIN_DEDUPLICATED_LENGTH)
+        {
+            deduplicated_data.insert(deduplicated_data.end(), begin, end);
+            continue;
+        }
+
+        const auto first_copy = first_copies.emplace(string, index);
+        if (first_copy.second)
+        {
+            deduplicated_data.insert(deduplicated_data.end(), begin, end);
+        }
+        else
+        {
+            const auto first_index = first_copy.first->second;
+            unsigned char reference[REFERENCE_SIZE] = {REFERENCE_MARKER};
+            std::memcpy(reference + 1, &first_index, sizeof(first_index));
+            deduplicated_data.insert(
+                deduplicated_data.end(), std::begin(reference), std::end(reference));
+        }
+    }
+    deduplicated_offsets.push_back(deduplicated_data.size());
+
+    const auto saved = data.size() - deduplicated_data.size();
+    offsets.swap(deduplicated_offsets);
+    data.swap(deduplicated_data);
+    return saved;
+}
+
+StringView NameTable::Get(const std::uint32_t index) const
+{
+    const auto string = m_name_table.at(index);
+    if (!IsReference(string))
+        return string;
+
+    std::uint32_t first_index;
+    std::memcpy(&first_index, string.data() + 1, sizeof(first_index));
+    BOOST_ASSERT(first_index < index);
+    return m_name_table.at(first_index);
+}
+
 StringView NameTable::GetNameForID(const NameID id) const
 {
     if (id == INVALID_NAMEID)
         return {};
 
-    return m_name_table.at(id + 0);
+    return Get(id + 0);
 }
 
 StringView NameTable::GetDestinationsForID(const NameID id) const
@@ -45,7 +110,7 @@ StringView NameTable::GetDestinationsForID(const NameID id) const
     if (id == INVALID_NAMEID)
         return {};
 
-    return m_name_table.at(id + 1);
+    return Get(id + 1);
 }
 
 StringView NameTable::GetExitsForID(const NameID id) const
@@ -53,7 +118,7 @@ StringView NameTable::GetExitsForID(const NameID id) const
     if (id == INVALID_NAMEID)
         return {};
 
-    return m_name_table.at(id + 4);
+    return Get(id + 4);
 }
 
 StringView NameTable::GetRefForID(const NameID id) const
@@ -73,7 +138,7 @@ StringView NameTable::GetRefForID(const NameID id) const
     // Offset 0 is name, 1 is destination, 2 is pronunciation, 3 is ref, 4 is exits
     // See datafacades and extractor callbacks for details.
     const constexpr auto OFFSET_REF = 3u;
-    return m_name_table.at(id + OFFSET_REF);
+    return Get(id + OFFSET_REF);
 }
 
 StringView NameTable::GetPronunciationForID(const NameID id) const
@@ -93,7 +158,7 @@ StringView NameTable::GetPronunciationForID(const NameID id) const
     // Offset 0 is name, 1 is destination, 2 is pronunciation, 3 is ref, 4 is exits
     // See datafacades and extractor callbacks for details.
     const constexpr auto OFFSET_PRONUNCIATION = 2u;
-    return m_name_table.at(id + OFFSET_PRONUNCIATION);
+    return Get(id + OFFSET_PRONUNCIATION);
 }
 
 } // namespace util
@@ -0,0 +1,151 @@
+#include "util/numa.hpp"
+
+#include "util/log.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+#ifdef __linux__
+const constexpr char NODE_DIRECTORY[] = "/sys/devices/system/node/";
+
+// set_mempolicy(2) modes, numaif.h is not always installed
+const constexpr int MEMPOLICY_DEFAULT = 0;
+const constexpr int MEMPOLICY_BIND = 2;
+const constexpr unsigned MAX_NODES = 1024;
+const constexpr unsigned BITS_PER_WORD = 8 * sizeof(unsigned long);
+
+// Parses lists like "0-3,8,10-11" of the sysfs node and cpu files
+std::vector<unsigned> readList(const std::string &path)
+{
+    std::vector<unsigned> values;
+    boost::filesystem::ifstream file(path);
+    std::string list;
+    if (!std::getline(file, list))
+        return values;
+
+    std::size_t begin = 0;
+    while (begin < list.size())
+    {
+        auto end = list.find(',', begin);
+        end = end == std::string::npos ? list.size() : end;
+        const auto range = list.substr(begin, end - begin);
+        const auto dash = range.find('-');
+        try
+        {
+            const auto first = std::stoul(range.substr(0, dash));
+            const auto last =
+                dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (auto value = first; value <= last; ++value)
+                values.push_back(static_cast<unsigned>(value));
+        }
+        catch (const std::exception &)
+        {
+            return {};
+        }
+        begin = end + 1;
+    }
+    return values;
+}
+
+bool setMemoryPolicy(const int mode, const unsigned long *mask, const unsigned long max_node)
+{
+    return syscall(SYS_set_mempolicy, mode, mask, max_node) == 0;
+}
+#endif
+}
+
+std::vector<unsigned> GetNUMANodes()
+{
+#ifdef __linux__
+    auto nodes = readList(std::string(NODE_DIRECTORY) + "has_memory");
+    if (nodes.empty())
+        nodes = readList(std::string(NODE_DIRECTORY) + "online");
+    nodes.erase(std::remove_if(nodes.begin(),
+                               nodes.end(),
+                               [](const unsigned node) { return node >= MAX_NODES; }),
+                nodes.end());
+    if (!nodes.empty())
+        return nodes;
+#endif
+    return {0};
+}
+
+std::vector<unsigned> GetNUMANodeCPUs(const unsigned node)
+{
+#ifdef __linux__
+    return readList(std::string(NODE_DIRECTORY) + "node" + std::to_string(node) + "/cpulist");
+#else
+    (void)node;
+    return {};
+#endif
+}
+
+unsigned GetCurrentNUMANode()
+{
+#ifdef __linux__
+    // sched_getcpu is a vDSO call, the node of each core is only looked up once
+    static const std::vector<unsigned> cpu_nodes = [] {
+        std::vector<unsigned> cpu_nodes;
+        for (const auto node : GetNUMANodes())
+        {
+            for (const auto cpu : GetNUMANodeCPUs(node))
+            {
+                cpu_nodes.resize(std::max<std::size_t>(cpu_nodes.size(), cpu + 1), 0);
+                cpu_nodes[cpu] = node;
+            }
+        }
+        return cpu_nodes;
+    }();
+
+    const auto cpu = sched_getcpu();
+    if (cpu >= 0 && static_cast<std::size_t>(cpu) < cpu_nodes.size())
+        return cpu_nodes[cpu];
+#endif
+    return 0;
+}
+
+ScopedNUMABinding::ScopedNUMABinding(const unsigned node) : bound(false)
+{
+#ifdef __linux__
+    if (node < MAX_NODES)
+    {
+        unsigned long mask[MAX_NODES / BITS_PER_WORD] = {};
+        mask[node / BITS_PER_WORD] = 1UL << (node % BITS_PER_WORD);
+        // the kernel expects one more than the number of bits in the mask
+        bound = setMemoryPolicy(MEMPOLICY_BIND, mask, MAX_NODES + 1);
+    }
+#else
+    (void)node;
+#endif
+    if (!bound)
+    {
+        util::Log(logWARNING) << "Could not bind memory to NUMA node " << node;
+    }
+}
+
+ScopedNUMABinding::~ScopedNUMABinding()
+{
+#ifdef __linux__
+    if (bound)
+    {
+        setMemoryPolicy(MEMPOLICY_DEFAULT, nullptr, 0);
+    }
+#endif
+}
+}
+}
@@ -0,0 +1,219 @@
+#include "util/parallel_io.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+// More concurrent requests than this don't make storage devices faster
+const constexpr unsigned MAX_IO_THREADS = 4;
+
+#ifndef _WIN32
+class FileDescriptor
+{
+  public:
+    FileDescriptor(const boost::filesystem::path &path, const int flags)
+        : descriptor(::open(path.c_str(), flags))
+    {
+    }
+    ~FileDescriptor()
+    {
+        if (descriptor >= 0)
+            ::close(descriptor);
+    }
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+    explicit operator bool() const { return descriptor >= 0; }
+    int Get() const { return descriptor; }
+
+  private:
+    int descriptor;
+};
+
+// Calls transfer(slice offset, slice size) for all slices from a few threads, false if any
+// transfer failed
+template <typename TransferT> bool forEachSlice(const std::size_t size, TransferT transfer)
+{
+    const auto number_of_slices = (size + PARALLEL_IO_SLICE_SIZE - 1) / PARALLEL_IO_SLICE_SIZE;
+    const auto number_of_threads = std::min<std::size_t>(
+        number_of_slices,
+        std::max(1u, std::min(MAX_IO_THREADS, std::thread::hardware_concurrency())));
+
+    std::atomic<std::size_t> next_slice{0};
+    std::atomic<bool> success{true};
+    const auto work = [&] {
+        for (auto slice = next_slice++; slice < number_of_slices && success; slice = next_slice++)
+        {
+            const auto slice_offset = slice * PARALLEL_IO_SLICE_SIZE;
+            const auto slice_size = std::min(PARALLEL_IO_SLICE_SIZE, size - slice_offset);
+            if (!transfer(slice_offset, slice_size))
+                success = false;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t thread = 1; thread < number_of_threads; ++thread)
+        threads.emplace_back(work);
+    work();
+    for (auto &thread : threads)
+        thread.join();
+
+    return success;
+}
+
+// Reads all bytes of the range, pread reads less near the end of the file or on signals
+bool readFully(const int descriptor, char *destination, std::size_t size, std::uint64_t offset)
+{
+    while (size > 0)
+    {
+        const auto bytes_read = ::pread(descriptor, destination, size, offset);
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
+        if (bytes_read <= 0)
+            return false;
+        destination += bytes_read;
+        offset += bytes_read;
+        size -= bytes_read;
+    }
+    return true;
+}
+
+// The same for direct I/O, returns the number of bytes read which is less at the end of the file
+std::size_t
+readDirect(const int descriptor, char *buffer, const std::size_t size, const std::uint64_t offset)
+{
+    std::size_t total = 0;
+    while (total < size)
+    {
+        const auto bytes_read = ::pread(descriptor, buffer + total, size - total, offset + total);
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
+        if (bytes_read <= 0)
+            break;
+        total += bytes_read;
+        // only the last read of the file ends before an aligned size
+        if (total % DIRECT_IO_ALIGNMENT != 0)
+            break;
+    }
+    return total;
+}
+#endif
+}
+
+bool ParallelRead(const boost::filesystem::path &path,
+                  const std::uint64_t offset,
+                  char *destination,
+                  const std::size_t size,
+                  const bool direct_io)
+{
+#ifndef _WIN32
+#ifdef O_DIRECT
+    if (direct_io)
+    {
+        FileDescriptor file(path, O_RDONLY | O_DIRECT);
+        if (file)
+        {
+            struct AlignedFree
+            {
+                void operator()(char *buffer) const { std::free(buffer); }
+            };
+
+            const auto success = forEachSlice(size, [&](const std::size_t slice_offset,
+                                                        const std::size_t slice_size) {
+                // the aligned range that covers the slice
+                const auto begin = offset + slice_offset;
+                const auto aligned_begin = begin / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+                const auto aligned_size = (begin + slice_size - aligned_begin +
+                                           DIRECT_IO_ALIGNMENT - 1) /
+                                          DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+
+                void *memory = nullptr;
+                if (::posix_memalign(&memory, DIRECT_IO_ALIGNMENT, aligned_size) != 0)
+                    return false;
+                std::unique_ptr<char, AlignedFree> buffer(static_cast<char *>(memory));
+
+                const auto head = begin - aligned_begin;
+                const auto bytes_read =
+                    readDirect(file.Get(), buffer.get(), aligned_size, aligned_begin);
+                if (bytes_read < head + slice_size)
+                    return false;
+                std::memcpy(destination + slice_offset, buffer.get() + head, slice_size);
+                return true;
+            });
+            if (success)
+                return true;
+        }
+        // fall back to the page cache, e.g. on tmpfs that has no direct I/O
+    }
+#else
+    (void)direct_io;
+#endif
+
+    FileDescriptor file(path, O_RDONLY);
+    if (!file)
+        return false;
+    return forEachSlice(size, [&](const std::size_t slice_offset, const std::size_t slice_size) {
+        return readFully(file.Get(), destination + slice_offset, slice_size, offset + slice_offset);
+    });
+#else
+    (void)path;
+    (void)offset;
+    (void)destination;
+    (void)size;
+    (void)direct_io;
+    return false;
+#endif
+}
+
+bool ParallelWrite(const boost::filesystem::path &path,
+                   const std::uint64_t offset,
+                   const char *source,
+                   const std::size_t size)
+{
+#ifndef _WIN32
+    FileDescriptor file(path, O_WRONLY);
+    if (!file)
+        return false;
+    return forEachSlice(size, [&](std::size_t slice_offset, const std::size_t slice_size) {
+        const auto slice_end = slice_offset + slice_size;
+        while (slice_offset < slice_end)
+        {
+            const auto bytes_written = ::pwrite(file.Get(),
+                                                source + slice_offset,
+                                                slice_end - slice_offset,
+                                                offset + slice_offset);
+            if (bytes_written < 0 && errno == EINTR)
+                continue;
+            if (bytes_written <= 0)
+                return false;
+            slice_offset += bytes_written;
+        }
+        return true;
+    });
+#else
+    (void)path;
+    (void)offset;
+    (void)source;
+    (void)size;
+    return false;
+#endif
+}
+}
+}
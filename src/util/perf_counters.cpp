@@ -0,0 +1,127 @@
+#include "util/perf_counters.hpp"
+#include "util/log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+#ifdef __linux__
+const constexpr std::uint64_t PERF_EVENT_CONFIGS[NUM_PERF_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+int openCounter(const std::uint64_t config, const int group_fd)
+{
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.config = config;
+    attributes.read_format = PERF_FORMAT_GROUP;
+    // the engine itself, also allowed for unprivileged users by the default paranoia level
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // the calling thread on any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, group_fd, 0));
+}
+#endif
+}
+
+const char *ToString(const PerfEvent event)
+{
+    switch (event)
+    {
+    case PerfEvent::Cycles:
+        return "cycles";
+    case PerfEvent::Instructions:
+        return "instructions";
+    case PerfEvent::CacheMisses:
+        return "cache_misses";
+    case PerfEvent::BranchMisses:
+        return "branch_misses";
+    case PerfEvent::None:
+        break;
+    }
+    return "none";
+}
+
+PerfCounters &PerfCounters::GetCurrent()
+{
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+PerfCounters::PerfCounters()
+{
+    fds.fill(-1);
+#ifdef __linux__
+    for (std::size_t index = 0; index < NUM_PERF_EVENTS; ++index)
+    {
+        fds[index] = openCounter(PERF_EVENT_CONFIGS[index], index == 0 ? -1 : fds[0]);
+        if (fds[index] < 0)
+        {
+            static std::atomic<bool> warned{false};
+            if (!warned.exchange(true))
+            {
+                util::Log(logWARNING) << "Hardware counters are unavailable, can not count "
+                                      << ToString(static_cast<PerfEvent>(index)) << ": "
+                                      << std::strerror(errno);
+            }
+            for (std::size_t opened = 0; opened < index; ++opened)
+            {
+                close(fds[opened]);
+                fds[opened] = -1;
+            }
+            return;
+        }
+    }
+    group_fd = fds[0];
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (const auto fd : fds)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+#endif
+}
+
+PerfEventCounts PerfCounters::Read() const
+{
+    PerfEventCounts counts{};
+#ifdef __linux__
+    if (group_fd < 0)
+        return counts;
+
+    // the number of events followed by their values in the order they were opened
+    std::uint64_t values[NUM_PERF_EVENTS + 1];
+    if (read(group_fd, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)))
+    {
+        std::copy(values + 1, values + 1 + NUM_PERF_EVENTS, counts.begin());
+    }
+#endif
+    return counts;
+}
+}
+}
@@ -0,0 +1,121 @@
+#include "util/perf_report.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+double ToSeconds(const std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+void WriteUsage(std::ostream &out,
+                const ResourceUsage &begin,
+                const ResourceUsage &end,
+                const unsigned threads)
+{
+    const auto wall_time = ToSeconds(end.time - begin.time);
+    const auto cpu_time = ToSeconds(end.cpu_time - begin.cpu_time);
+    const auto utilisation = wall_time > 0 && threads > 0 ? cpu_time / (wall_time * threads) : 0.;
+    out << "\"wall_time_seconds\":" << wall_time << ",\"cpu_time_seconds\":" << cpu_time
+        << ",\"thread_utilisation\":" << utilisation << ",\"peak_rss_bytes\":" << end.peak_rss
+        << ",\"bytes_read\":" << end.bytes_read - begin.bytes_read
+        << ",\"bytes_written\":" << end.bytes_written - begin.bytes_written;
+}
+}
+
+ResourceUsage ResourceUsage::GetCurrent()
+{
+    ResourceUsage usage;
+    usage.time = std::chrono::steady_clock::now();
+#ifndef _WIN32
+    rusage self;
+    if (getrusage(RUSAGE_SELF, &self) == 0)
+    {
+        usage.cpu_time = std::chrono::seconds(self.ru_utime.tv_sec + self.ru_stime.tv_sec) +
+                         std::chrono::microseconds(self.ru_utime.tv_usec + self.ru_stime.tv_usec);
+#ifdef __linux__
+        // Under linux, ru.maxrss is in kb
+        usage.peak_rss = static_cast<std::uint64_t>(self.ru_maxrss) * 1024;
+#else
+        usage.peak_rss = static_cast<std::uint64_t>(self.ru_maxrss);
+#endif
+    }
+#endif
+#ifdef __linux__
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    std::uint64_t value;
+    while (io >> key >> value)
+    {
+        if (key == "rchar:")
+            usage.bytes_read = value;
+        else if (key == "wchar:")
+            usage.bytes_written = value;
+    }
+#endif
+    return usage;
+}
+
+PerfReport &PerfReport::GetInstance()
+{
+    static PerfReport report;
+    return report;
+}
+
+PerfReport::PerfReport() : start(ResourceUsage::GetCurrent()) {}
+
+void PerfReport::Record(const std::string &stage,
+                        const ResourceUsage &begin,
+                        const ResourceUsage &end)
+{
+    std::lock_guard<std::mutex> guard(stages_lock);
+    stages.push_back({stage, begin, end});
+}
+
+void PerfReport::Write(const std::string &path,
+                       const std::string &tool,
+                       const unsigned threads) const
+{
+    const auto end = ResourceUsage::GetCurrent();
+
+    std::stringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"tool\":\"" << tool << "\",\"threads\":" << threads << ",\"total\":{";
+    WriteUsage(out, start, end, threads);
+    out << "},\"stages\":[";
+    {
+        std::lock_guard<std::mutex> guard(stages_lock);
+        for (auto stage = stages.begin(); stage != stages.end(); ++stage)
+        {
+            out << (stage == stages.begin() ? "" : ",") << "\n{\"name\":\"" << stage->name
+                << "\",";
+            WriteUsage(out, stage->begin, stage->end, threads);
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    std::ofstream file(path, std::ios::trunc);
+    file << out.str();
+    if (!file)
+    {
+        throw util::exception("Could not write the performance report " + path + SOURCE_REF);
+    }
+}
+}
+}
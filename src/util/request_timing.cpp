@@ -0,0 +1,284 @@
+#include "util/request_timing.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+const constexpr std::size_t TOTAL_INDEX = NUM_REQUEST_STAGES;
+const constexpr double QUANTILES[] = {0.5, 0.9, 0.99};
+}
+
+const char *ToString(const RequestStage stage)
+{
+    switch (stage)
+    {
+    case RequestStage::Parse:
+        return "parse";
+    case RequestStage::Queue:
+        return "queue";
+    case RequestStage::Snap:
+        return "snap";
+    case RequestStage::Route:
+        return "route";
+    case RequestStage::Unpack:
+        return "unpack";
+    case RequestStage::Assemble:
+        return "assemble";
+    case RequestStage::Render:
+        return "render";
+    case RequestStage::None:
+        break;
+    }
+    return "total";
+}
+
+RequestTimings &RequestTimings::GetCurrent()
+{
+    thread_local RequestTimings timings;
+    return timings;
+}
+
+void RequestTimings::Reset()
+{
+    durations.fill(std::chrono::nanoseconds::zero());
+    measured.fill(false);
+    active = RequestStage::None;
+    active_since = start = Clock::now();
+    settled_nodes = 0;
+    traced = false;
+    spans.clear();
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+    for (auto &counts : event_counts)
+        counts.fill(0);
+    active_since_counts = start_counts = PerfCounters::GetCurrent().Read();
+#endif
+}
+
+RequestStage RequestTimings::Enter(const RequestStage stage)
+{
+    const auto now = Clock::now();
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+    const auto now_counts = PerfCounters::GetCurrent().Read();
+#endif
+    if (active != RequestStage::None)
+    {
+        durations[static_cast<std::size_t>(active)] += now - active_since;
+        if (traced)
+            spans.push_back({active, active_since, now});
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+        auto &counts = event_counts[static_cast<std::size_t>(active)];
+        for (std::size_t event = 0; event < NUM_PERF_EVENTS; ++event)
+            counts[event] += now_counts[event] - active_since_counts[event];
+#endif
+    }
+    if (stage != RequestStage::None)
+    {
+        measured[static_cast<std::size_t>(stage)] = true;
+    }
+
+    const auto previous = active;
+    active = stage;
+    active_since = now;
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+    active_since_counts = now_counts;
+#endif
+    return previous;
+}
+
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+PerfEventCounts RequestTimings::GetTotalEventCounts() const
+{
+    auto counts = PerfCounters::GetCurrent().Read();
+    for (std::size_t event = 0; event < NUM_PERF_EVENTS; ++event)
+        counts[event] -= start_counts[event];
+    return counts;
+}
+#endif
+
+RequestMetrics &RequestMetrics::GetInstance()
+{
+    static RequestMetrics metrics;
+    return metrics;
+}
+
+RequestMetrics::ThreadHistograms &RequestMetrics::GetThreadHistograms()
+{
+    // the histograms outlive their thread so the requests it handled stay counted
+    thread_local ThreadHistograms *thread_histograms = nullptr;
+    if (!thread_histograms)
+    {
+        std::lock_guard<std::mutex> guard(histograms_lock);
+        histograms.push_back(std::make_unique<ThreadHistograms>());
+        thread_histograms = histograms.back().get();
+    }
+    return *thread_histograms;
+}
+
+void RequestMetrics::Record(const RequestTimings &timings, const std::string &service)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    auto &thread_histograms = GetThreadHistograms();
+    for (std::size_t index = 0; index < NUM_REQUEST_STAGES; ++index)
+    {
+        const auto stage = static_cast<RequestStage>(index);
+        if (timings.IsMeasured(stage))
+        {
+            thread_histograms.stages[index].Count(
+                duration_cast<microseconds>(timings.GetDuration(stage)).count());
+        }
+    }
+    thread_histograms.stages[TOTAL_INDEX].Count(
+        duration_cast<microseconds>(timings.GetTotal()).count());
+
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+    if (service.empty() || !PerfCounters::GetCurrent().IsAvailable())
+        return;
+
+    const auto total_counts = timings.GetTotalEventCounts();
+    std::lock_guard<std::mutex> guard(thread_histograms.event_counts_lock);
+    auto &service_counts = thread_histograms.event_counts[service];
+    service_counts.requests++;
+    for (std::size_t index = 0; index <= TOTAL_INDEX; ++index)
+    {
+        const auto &counts = index == TOTAL_INDEX
+                                 ? total_counts
+                                 : timings.GetEventCounts(static_cast<RequestStage>(index));
+        for (std::size_t event = 0; event < NUM_PERF_EVENTS; ++event)
+            service_counts.stages[index][event] += counts[event];
+    }
+#else
+    (void)service;
+#endif
+}
+
+std::string RequestMetrics::DumpPrometheus() const
+{
+    // merge the histograms of all threads
+    std::array<std::array<std::uint64_t, LatencyHistogram::NUM_BINS>, TOTAL_INDEX + 1> bins{};
+    std::array<std::uint64_t, TOTAL_INDEX + 1> counts{};
+    std::array<std::uint64_t, TOTAL_INDEX + 1> sums{};
+    {
+        std::lock_guard<std::mutex> guard(histograms_lock);
+        for (const auto &thread_histograms : histograms)
+        {
+            for (std::size_t index = 0; index <= TOTAL_INDEX; ++index)
+            {
+                const auto &histogram = thread_histograms->stages[index];
+                for (std::size_t bin = 0; bin < LatencyHistogram::NUM_BINS; ++bin)
+                {
+                    bins[index][bin] += histogram.GetBinCount(bin);
+                }
+                counts[index] += histogram.GetCount();
+                sums[index] += histogram.GetSum();
+            }
+        }
+    }
+
+    std::stringstream out;
+    out << std::setprecision(9);
+    out << "# HELP osrm_request_duration_seconds Time spent handling requests by stage.\n";
+    out << "# TYPE osrm_request_duration_seconds summary\n";
+    for (std::size_t index = 0; index <= TOTAL_INDEX; ++index)
+    {
+        const std::string label =
+            std::string("stage=\"") + ToString(static_cast<RequestStage>(index)) + "\"";
+
+        // the bin total is used since the counts are updated independently
+        std::uint64_t total = 0;
+        for (const auto count : bins[index])
+            total += count;
+
+        for (const auto quantile : QUANTILES)
+        {
+            out << "osrm_request_duration_seconds{" << label << ",quantile=\"" << quantile
+                << "\"} ";
+            if (total == 0)
+            {
+                // Prometheus expects NaN for quantiles without observations
+                out << "NaN\n";
+                continue;
+            }
+
+            // midpoint of the bin that holds the quantile
+            const auto rank =
+                std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(quantile * total)));
+            std::uint64_t seen = 0;
+            std::size_t bin = 0;
+            while (seen + bins[index][bin] < rank)
+                seen += bins[index][bin++];
+            BOOST_ASSERT(bin < LatencyHistogram::NUM_BINS);
+
+            const auto lower = LatencyHistogram::GetBinLowerBound(bin);
+            const auto upper = bin + 1 < LatencyHistogram::NUM_BINS
+                                   ? LatencyHistogram::GetBinLowerBound(bin + 1)
+                                   : lower;
+            out << 0.5e-6 * (lower + upper) << "\n";
+        }
+        out << "osrm_request_duration_seconds_sum{" << label << "} " << 1e-6 * sums[index]
+            << "\n";
+        out << "osrm_request_duration_seconds_count{" << label << "} " << counts[index] << "\n";
+    }
+
+#ifdef OSRM_ENABLE_PERF_COUNTERS
+    // merge the event counts of all threads
+    std::map<std::string, ThreadHistograms::ServiceEventCounts> event_counts;
+    {
+        std::lock_guard<std::mutex> guard(histograms_lock);
+        for (const auto &thread_histograms : histograms)
+        {
+            std::lock_guard<std::mutex> counts_guard(thread_histograms->event_counts_lock);
+            for (const auto &service_counts : thread_histograms->event_counts)
+            {
+                auto &merged = event_counts[service_counts.first];
+                merged.requests += service_counts.second.requests;
+                for (std::size_t index = 0; index <= TOTAL_INDEX; ++index)
+                {
+                    for (std::size_t event = 0; event < NUM_PERF_EVENTS; ++event)
+                        merged.stages[index][event] += service_counts.second.stages[index][event];
+                }
+            }
+        }
+    }
+
+    out << "# HELP osrm_perf_counter_requests_total Requests whose hardware events were counted "
+           "by service.\n";
+    out << "# TYPE osrm_perf_counter_requests_total counter\n";
+    for (const auto &service_counts : event_counts)
+    {
+        out << "osrm_perf_counter_requests_total{service=\"" << service_counts.first << "\"} "
+            << service_counts.second.requests << "\n";
+    }
+    out << "# HELP osrm_perf_counter_events_total Hardware events counted while handling requests "
+           "by service and stage.\n";
+    out << "# TYPE osrm_perf_counter_events_total counter\n";
+    for (const auto &service_counts : event_counts)
+    {
+        for (std::size_t index = 0; index <= TOTAL_INDEX; ++index)
+        {
+            for (std::size_t event = 0; event < NUM_PERF_EVENTS; ++event)
+            {
+                out << "osrm_perf_counter_events_total{service=\"" << service_counts.first
+                    << "\",stage=\"" << ToString(static_cast<RequestStage>(index))
+                    << "\",event=\"" << ToString(static_cast<PerfEvent>(event)) << "\"} "
+                    << service_counts.second.stages[index][event] << "\n";
+            }
+        }
+    }
+#endif
+
+    return out.str();
+}
+}
+}
@@ -0,0 +1,86 @@
+#include "util/request_trace.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/string_util.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace osrm
+{
+namespace util
+{
+
+namespace
+{
+// Small ids for the threads so the viewer keeps one row per thread
+unsigned GetTraceThreadID()
+{
+    static std::atomic<unsigned> next_thread_id{1};
+    thread_local const unsigned thread_id = next_thread_id++;
+    return thread_id;
+}
+
+double ToMicroseconds(const std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+void AppendEvent(std::stringstream &out,
+                 const char *name,
+                 const double timestamp,
+                 const double duration,
+                 const unsigned thread_id)
+{
+    out << "{\"name\":\"" << name << "\",\"cat\":\"osrm\",\"ph\":\"X\",\"ts\":" << timestamp
+        << ",\"dur\":" << duration << ",\"pid\":1,\"tid\":" << thread_id;
+}
+}
+
+RequestTraceWriter::RequestTraceWriter(const std::string &path)
+    : epoch(RequestTimings::Clock::now()), output(path, std::ios::trunc)
+{
+    if (!output)
+    {
+        throw util::exception("Could not open the trace file " + path + SOURCE_REF);
+    }
+    output << "[\n";
+    output.flush();
+}
+
+void RequestTraceWriter::Write(const RequestTimings &timings,
+                               const std::string &service,
+                               const std::string &url,
+                               const unsigned status)
+{
+    const auto thread_id = GetTraceThreadID();
+    const auto name = service.empty() ? std::string("request") : escape_JSON(service);
+
+    std::stringstream out;
+    out << std::fixed << std::setprecision(3);
+    AppendEvent(out,
+                name.c_str(),
+                ToMicroseconds(timings.GetStart() - epoch),
+                ToMicroseconds(timings.GetTotal()),
+                thread_id);
+    out << ",\"args\":{\"url\":\"" << escape_JSON(url) << "\",\"status\":" << status
+        << ",\"settled_nodes\":" << timings.GetSettledNodes() << "}},\n";
+    for (const auto &span : timings.GetSpans())
+    {
+        AppendEvent(out,
+                    ToString(span.stage),
+                    ToMicroseconds(span.begin - epoch),
+                    ToMicroseconds(span.end - span.begin),
+                    thread_id);
+        out << "},\n";
+    }
+
+    std::lock_guard<std::mutex> guard(output_lock);
+    output << out.str();
+    output.flush();
+}
+}
+}
@@ -26,6 +26,21 @@ namespace osrm
 namespace updater
 {
 
+struct tm getLocalTime(const char *tzname, std::time_t utc_time)
+{
+    struct tm timeinfo;
+#if defined(_WIN32)
+    _putenv_s("TZ", tzname);
+    _tzset();
+    localtime_s(&timeinfo, &utc_time);
+#else
+    setenv("TZ", tzname, 1);
+    tzset();
+    localtime_r(&utc_time, &timeinfo);
+#endif
+    return timeinfo;
+}
+
 Timezoner::Timezoner(const char geojson[], std::time_t utc_time_now)
 {
     util::Log() << "Time zone validation based on UTC time : " << utc_time_now;
@@ -87,17 +102,7 @@ void Timezoner::LoadLocalTimesRTree(rapidjson::Document &geojson, std::time_t ut
         auto it = local_time_memo.find(tzname);
         if (it == local_time_memo.end())
         {
-            struct tm timeinfo;
-#if defined(_WIN32)
-            _putenv_s("TZ", tzname);
-            _tzset();
-            localtime_s(&timeinfo, &utc_time);
-#else
-            setenv("TZ", tzname, 1);
-            tzset();
-            localtime_r(&utc_time, &timeinfo);
-#endif
-            it = local_time_memo.insert({tzname, timeinfo}).first;
+            it = local_time_memo.insert({tzname, getLocalTime(tzname, utc_time)}).first;
         }
 
         return it->second;
@@ -145,6 +150,7 @@ void Timezoner::LoadLocalTimesRTree(rapidjson::Document &geojson, std::time_t ut
             const auto &tzname =
                 features_array[i].GetObject()["properties"].GetObject()["tzid"].GetString();
             local_times.push_back(local_time_t{polygon, get_local_time_in_tz(tzname)});
+            local_time_names.push_back(tzname);
         }
         else
         {
@@ -156,7 +162,7 @@ void Timezoner::LoadLocalTimesRTree(rapidjson::Document &geojson, std::time_t ut
     rtree = rtree_t(polygons);
 }
 
-boost::optional<struct tm> Timezoner::operator()(const point_t &point) const
+boost::optional<std::size_t> Timezoner::FindPolygon(const point_t &point) const
 {
     std::vector<rtree_t::value_type> result;
     rtree.query(boost::geometry::index::intersects(point), std::back_inserter(result));
@@ -164,9 +170,25 @@ boost::optional<struct tm> Timezoner::operator()(const point_t &point) const
     {
         const auto index = v.second;
         if (boost::geometry::within(point, local_times[index].first))
-            return local_times[index].second;
+            return index;
     }
     return boost::none;
 }
+
+boost::optional<struct tm> Timezoner::operator()(const point_t &point) const
+{
+    const auto index = FindPolygon(point);
+    if (!index)
+        return boost::none;
+    return local_times[*index].second;
+}
+
+boost::optional<std::string> Timezoner::GetTimezoneName(const point_t &point) const
+{
+    const auto index = FindPolygon(point);
+    if (!index)
+        return boost::none;
+    return local_time_names[*index];
+}
 }
 }
@@ -3,6 +3,7 @@ var test = require('tape');
 var monaco_path = require('./constants').data_path;
 var monaco_mld_path = require('./constants').mld_data_path;
 var monaco_corech_path = require('./constants').corech_data_path;
+var three_test_coordinates = require('./constants').three_test_coordinates;
 
 test('constructor: throws if new keyword is not used', function(assert) {
     assert.plan(1);
@@ -58,13 +59,13 @@ test('constructor: throws if given a non-string/obj argument', function(assert)
 test('constructor: throws if given an unkown algorithm', function(assert) {
     assert.plan(1);
     assert.throws(function() { new OSRM({algorithm: 'Foo', shared_memory: true}); },
-        /algorithm option must be one of 'CH', 'CoreCH', or 'MLD'/);
+        /algorithm option must be one of 'CH', 'CoreCH', 'MLD', or 'CCH'/);
 });
 
 test('constructor: throws if given an invalid algorithm', function(assert) {
     assert.plan(1);
     assert.throws(function() { new OSRM({algorithm: 3, shared_memory: true}); },
-        /algorithm option must be a string and one of 'CH', 'CoreCH', or 'MLD'/);
+        /algorithm option must be a string and one of 'CH', 'CoreCH', 'MLD', or 'CCH'/);
 });
 
 test('constructor: loads MLD if given as algorithm', function(assert) {
@@ -98,6 +99,42 @@ test('constructor: throws if data doesn\'t match algorithm', function(assert) {
     assert.throws(function() { new OSRM({algorithm: 'MLD', path: monaco_path}); });
 });
 
+test('constructor: throws if given an invalid worker_threads option', function(assert) {
+    assert.plan(2);
+    assert.throws(function() { new OSRM({path: monaco_path, worker_threads: -1}); },
+        /worker_threads must be an integer >= 0/);
+    assert.throws(function() { new OSRM({path: monaco_path, max_queued_requests: 2}); },
+        /max_queued_requests requires worker_threads/);
+});
+
+test('constructor: runs queries on worker threads of its own', function(assert) {
+    assert.plan(2);
+    var osrm = new OSRM({path: monaco_path, worker_threads: 2});
+    osrm.route({coordinates: three_test_coordinates}, function(err, route) {
+        assert.ifError(err);
+        assert.ok(route.routes.length > 0);
+    });
+});
+
+test('constructor: rejects queries beyond max_queued_requests', function(assert) {
+    var osrm = new OSRM({path: monaco_path, worker_threads: 1, max_queued_requests: 1});
+    var queries = 10;
+    var rejected = 0;
+    var finished = 0;
+    for (var i = 0; i < queries; ++i) {
+        osrm.route({coordinates: three_test_coordinates}, function(err) {
+            if (err) {
+                assert.equal(err.message, 'ServiceUnavailable');
+                rejected++;
+            }
+            if (++finished === queries) {
+                assert.ok(rejected > 0 && rejected < queries);
+                assert.end();
+            }
+        });
+    }
+});
+
 require('./route.js');
 require('./trip.js');
 require('./match.js');
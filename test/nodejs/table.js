@@ -166,3 +166,28 @@ test('table: distance table in Monaco without hints', function(assert) {
         table.destinations.map(assertHasNoHints);
     });
 });
+
+test('table: distance table in Monaco as buffers', function(assert) {
+    assert.plan(8);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: two_test_coordinates,
+        format: 'json_buffer'
+    };
+    osrm.table(options, function(err, buffer) {
+        assert.ifError(err);
+        assert.ok(Buffer.isBuffer(buffer), 'result must be a buffer');
+        var table = JSON.parse(buffer.toString());
+        assert.equal(table.durations.length, 2);
+        assert.equal(table.durations[0][0], 0);
+    });
+    options.format = 'binary';
+    osrm.table(options, function(err, buffer) {
+        assert.ifError(err);
+        assert.ok(Buffer.isBuffer(buffer), 'result must be a buffer');
+        assert.ok(buffer.length > 0);
+    });
+    options.format = 'xml';
+    assert.throws(function() { osrm.table(options, function(err, res) {}); },
+        /format must be one of: \[object, json_buffer, binary\]/);
+});
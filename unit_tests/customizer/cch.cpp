@@ -0,0 +1,204 @@
+#include <boost/test/unit_test.hpp>
+
+#include "customizer/cch.hpp"
+#include "customizer/edge_based_graph.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include <functional>
+#include <queue>
+#include <random>
+
+using namespace osrm;
+using namespace osrm::customizer;
+using namespace osrm::partition;
+
+namespace
+{
+struct MockEdge
+{
+    NodeID start;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+auto makeGraph(const MultiLevelPartition &mlp,
+               const std::size_t num_nodes,
+               const std::vector<MockEdge> &mock_edges)
+{
+    std::vector<StaticEdgeBasedGraphEdge> edges;
+    for (const auto &m : mock_edges)
+    {
+        const auto turn_id = static_cast<NodeID>(edges.size());
+        edges.emplace_back(m.start, m.target, turn_id, m.weight, 2 * m.weight, true, false);
+        edges.emplace_back(m.target, m.start, turn_id, m.weight, 2 * m.weight, false, true);
+    }
+    std::sort(edges.begin(), edges.end());
+    return MultiLevelEdgeBasedGraph(mlp, num_nodes, edges);
+}
+
+// Distances from the source over the edges usable in the given direction
+template <typename GraphT, typename UseEdge>
+std::vector<EdgeWeight> dijkstra(const GraphT &graph, const NodeID source, UseEdge use_edge)
+{
+    std::vector<EdgeWeight> distances(graph.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distances[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto distance = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (distance != distances[node])
+            continue;
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            const auto target = graph.GetTarget(edge);
+            if (use_edge(data) && distance + data.weight < distances[target])
+            {
+                distances[target] = distance + data.weight;
+                queue.emplace(distances[target], target);
+            }
+        }
+    }
+    return distances;
+}
+
+// Compares the upward searches of the hierarchy with a Dijkstra for all pairs of nodes
+void checkDistances(const MultiLevelEdgeBasedGraph &graph, const contractor::QueryGraph &hierarchy)
+{
+    BOOST_REQUIRE_EQUAL(graph.GetNumberOfNodes(), hierarchy.GetNumberOfNodes());
+    const auto forward = [](const auto &data) { return data.forward; };
+    const auto backward = [](const auto &data) { return data.backward; };
+
+    const auto num_nodes = graph.GetNumberOfNodes();
+    std::vector<std::vector<EdgeWeight>> upward_backward;
+    for (const auto node : util::irange<NodeID>(0, num_nodes))
+    {
+        upward_backward.push_back(dijkstra(hierarchy, node, backward));
+    }
+
+    for (const auto source : util::irange<NodeID>(0, num_nodes))
+    {
+        const auto expected = dijkstra(graph, source, forward);
+        const auto upward_forward = dijkstra(hierarchy, source, forward);
+        for (const auto target : util::irange<NodeID>(0, num_nodes))
+        {
+            EdgeWeight distance = INVALID_EDGE_WEIGHT;
+            for (const auto middle : util::irange<NodeID>(0, num_nodes))
+            {
+                if (upward_forward[middle] != INVALID_EDGE_WEIGHT &&
+                    upward_backward[target][middle] != INVALID_EDGE_WEIGHT)
+                {
+                    distance = std::min(distance,
+                                        upward_forward[middle] + upward_backward[target][middle]);
+                }
+            }
+            BOOST_CHECK_EQUAL(distance, expected[target]);
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(cch_tests)
+
+BOOST_AUTO_TEST_CASE(two_level_test)
+{
+    // node:                0  1  2  3  4  5
+    std::vector<CellID> l1{{0, 0, 0, 1, 1, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {
+        {0, 1, 1}, {1, 2, 1}, {2, 3, 1}, {3, 4, 1}, {4, 5, 1}, {5, 0, 1}};
+    auto graph = makeGraph(mlp, 6, edges);
+
+    CCHTopology topology(mlp, graph);
+    BOOST_CHECK_EQUAL(topology.GetNumberOfNodes(), 6);
+    BOOST_CHECK(topology.Covers(graph));
+
+    // the cut edges 2 -> 3 and 5 -> 0 make 3 and 5 the boundary nodes, they are ranked last
+    const std::vector<NodeID> order = {0, 1, 2, 4, 3, 5};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        topology.GetOrder().begin(), topology.GetOrder().end(), order.begin(), order.end());
+
+    const auto hierarchy = topology.Customize(graph);
+    checkDistances(graph, hierarchy);
+
+    // 5 -> 1 is a shortcut over 0 and durations are carried along with the weights
+    const auto edge = hierarchy.FindEdge(1, 5);
+    BOOST_REQUIRE(edge != SPECIAL_EDGEID);
+    const auto &data = hierarchy.GetEdgeData(edge);
+    BOOST_CHECK(!data.forward);
+    BOOST_CHECK(data.backward);
+    BOOST_CHECK(data.shortcut);
+    BOOST_CHECK_EQUAL(data.turn_id, 0);
+    BOOST_CHECK_EQUAL(data.weight, 2);
+    BOOST_CHECK_EQUAL(data.duration, 4);
+
+    // arcs are stored at their lower node only, the highest node only has the loop around
+    // the ring in both directions
+    BOOST_CHECK_EQUAL(hierarchy.FindEdge(5, 1), SPECIAL_EDGEID);
+    BOOST_REQUIRE_EQUAL(hierarchy.GetOutDegree(5), 2);
+    for (const auto loop : hierarchy.GetAdjacentEdgeRange(5))
+    {
+        BOOST_CHECK_EQUAL(hierarchy.GetTarget(loop), 5);
+        BOOST_CHECK_EQUAL(hierarchy.GetEdgeData(loop).weight, 6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(grid_test)
+{
+    // 8x8 grid with cells of 2x2 nodes on the first level and of 4x4 nodes on the second
+    const NodeID size = 8;
+    std::vector<CellID> l1, l2, l3;
+    for (const auto node : util::irange<NodeID>(0, size * size))
+    {
+        const auto x = node % size, y = node / size;
+        l1.push_back(x / 2 + 4 * (y / 2));
+        l2.push_back(x / 4 + 2 * (y / 4));
+        l3.push_back(x / 4);
+    }
+    MultiLevelPartition mlp{{l1, l2, l3}, {16, 4, 2}};
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<EdgeWeight> weight(1, 20);
+    std::vector<MockEdge> edges;
+    for (const auto node : util::irange<NodeID>(0, size * size))
+    {
+        const auto x = node % size, y = node / size;
+        for (const auto neighbour :
+             {x + 1 < size ? node + 1 : node, y + 1 < size ? node + size : node})
+        {
+            if (neighbour == node)
+                continue;
+            // every third street is one-way
+            edges.push_back({node, neighbour, weight(generator)});
+            if (edges.size() % 3 != 0)
+                edges.push_back({neighbour, node, weight(generator)});
+        }
+    }
+    auto graph = makeGraph(mlp, size * size, edges);
+
+    CCHTopology topology(mlp, graph);
+    BOOST_CHECK(topology.Covers(graph));
+    checkDistances(graph, topology.Customize(graph));
+
+    // the topology is independent of the weights
+    for (auto &edge : edges)
+        edge.weight = weight(generator);
+    auto updated_graph = makeGraph(mlp, size * size, edges);
+    CCHTopology stored_topology(
+        topology.GetOrder(), topology.GetUpOffsets(), topology.GetUpTargets());
+    BOOST_CHECK(stored_topology.Covers(updated_graph));
+    checkDistances(updated_graph, stored_topology.Customize(updated_graph));
+
+    // closing a road is covered, new roads are not
+    edges.pop_back();
+    BOOST_CHECK(topology.Covers(makeGraph(mlp, size * size, edges)));
+    edges.push_back({0, size * size - 1, 1});
+    BOOST_CHECK(!topology.Covers(makeGraph(mlp, size * size, edges)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
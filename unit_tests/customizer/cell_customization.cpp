@@ -270,4 +270,100 @@ BOOST_AUTO_TEST_CASE(four_levels_test)
     CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(12), storage_rec.GetCell(2, 1).GetInWeight(12));
 }
 
+BOOST_AUTO_TEST_CASE(grid_levels_match_shortest_paths)
+{
+    // an 8x8 grid with cells of 2x2, 4x4 and 8x4 nodes, the cells of levels 2 and 3 are small
+    // enough to be customized on the matrices of their boundary nodes
+    const constexpr NodeID SIZE = 8;
+    const auto node_id = [&](NodeID x, NodeID y) { return y * SIZE + x; };
+    std::vector<CellID> l1(SIZE * SIZE), l2(SIZE * SIZE), l3(SIZE * SIZE);
+    for (NodeID y = 0; y < SIZE; ++y)
+    {
+        for (NodeID x = 0; x < SIZE; ++x)
+        {
+            l1[node_id(x, y)] = (y / 2) * (SIZE / 2) + x / 2;
+            l2[node_id(x, y)] = (y / 4) * (SIZE / 4) + x / 4;
+            l3[node_id(x, y)] = y / 4;
+        }
+    }
+    MultiLevelPartition mlp{{l1, l2, l3}, {16, 4, 2}};
+
+    // edges in both directions with differing weights, some streets are one way
+    std::vector<MockEdge> edges;
+    std::uint32_t seed = 42;
+    const auto next_weight = [&seed] {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<EdgeWeight>((seed >> 16) % 10 + 1);
+    };
+    for (NodeID y = 0; y < SIZE; ++y)
+    {
+        for (NodeID x = 0; x < SIZE; ++x)
+        {
+            if (x + 1 < SIZE)
+            {
+                edges.push_back({node_id(x, y), node_id(x + 1, y), next_weight()});
+                if ((x + y) % 3 != 0)
+                    edges.push_back({node_id(x + 1, y), node_id(x, y), next_weight()});
+            }
+            if (y + 1 < SIZE)
+            {
+                edges.push_back({node_id(x, y + 1), node_id(x, y), next_weight()});
+                if ((x + y) % 4 != 0)
+                    edges.push_back({node_id(x, y), node_id(x, y + 1), next_weight()});
+            }
+        }
+    }
+    auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    customizer.Customize(graph, storage);
+
+    // shortest paths inside a cell, by relaxing its edges until nothing changes
+    const auto shortest_weight = [&](LevelID level, NodeID source, NodeID target) {
+        const auto cell = mlp.GetCell(level, source);
+        std::vector<EdgeWeight> weights(SIZE * SIZE, INVALID_EDGE_WEIGHT);
+        weights[source] = 0;
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (const auto &edge : edges)
+            {
+                if (mlp.GetCell(level, edge.start) != cell ||
+                    mlp.GetCell(level, edge.target) != cell ||
+                    weights[edge.start] == INVALID_EDGE_WEIGHT ||
+                    weights[edge.start] + edge.weight >= weights[edge.target])
+                    continue;
+                weights[edge.target] = weights[edge.start] + edge.weight;
+                changed = true;
+            }
+        }
+        return weights[target];
+    };
+
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = storage.GetCell(level, id);
+            BOOST_CHECK(!cell.GetSourceNodes().empty());
+            for (const auto source : cell.GetSourceNodes())
+            {
+                auto duration = cell.GetOutDuration(source).begin();
+                auto destination = cell.GetDestinationNodes().begin();
+                for (const auto weight : cell.GetOutWeight(source))
+                {
+                    const auto expected = shortest_weight(level, source, *destination);
+                    BOOST_CHECK_EQUAL(weight, expected);
+                    BOOST_CHECK_EQUAL(*duration,
+                                      expected == INVALID_EDGE_WEIGHT ? MAXIMAL_EDGE_DURATION
+                                                                      : 2 * expected);
+                    ++duration;
+                    ++destination;
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
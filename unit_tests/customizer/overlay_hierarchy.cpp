@@ -0,0 +1,216 @@
+#include <boost/test/unit_test.hpp>
+
+#include "customizer/cell_customizer.hpp"
+#include "customizer/edge_based_graph.hpp"
+#include "customizer/overlay_hierarchy.hpp"
+#include "partition/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <random>
+
+using namespace osrm;
+using namespace osrm::customizer;
+using namespace osrm::partition;
+
+namespace
+{
+struct MockEdge
+{
+    NodeID start;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+auto makeGraph(const MultiLevelPartition &mlp,
+               const std::size_t num_nodes,
+               const std::vector<MockEdge> &mock_edges)
+{
+    std::vector<StaticEdgeBasedGraphEdge> edges;
+    for (const auto &m : mock_edges)
+    {
+        const auto turn_id = static_cast<NodeID>(edges.size());
+        edges.emplace_back(m.start, m.target, turn_id, m.weight, 2 * m.weight, true, false);
+        edges.emplace_back(m.target, m.start, turn_id, m.weight, 2 * m.weight, false, true);
+    }
+    std::sort(edges.begin(), edges.end());
+    return MultiLevelEdgeBasedGraph(mlp, num_nodes, edges);
+}
+
+// Distances from the source along the forward edges of the graph
+std::vector<EdgeWeight> dijkstra(const MultiLevelEdgeBasedGraph &graph, const NodeID source)
+{
+    std::vector<EdgeWeight> distances(graph.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distances[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto distance = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (distance != distances[node])
+            continue;
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const auto &data = graph.GetEdgeData(edge);
+            const auto target = graph.GetTarget(edge);
+            if (data.forward && distance + data.weight < distances[target])
+            {
+                distances[target] = distance + data.weight;
+                queue.emplace(distances[target], target);
+            }
+        }
+    }
+    return distances;
+}
+
+// Distances from the overlay node along the upward arcs of the hierarchy
+template <typename GetArcs>
+std::vector<EdgeWeight>
+upwardSearch(const OverlayHierarchy &hierarchy, const NodeID source, GetArcs get_arcs)
+{
+    std::vector<EdgeWeight> distances(hierarchy.GetNumberOfNodes(), INVALID_EDGE_WEIGHT);
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distances[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto distance = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (distance != distances[node])
+            continue;
+        for (const auto &arc : get_arcs(node))
+        {
+            if (distance + arc.weight < distances[arc.target])
+            {
+                distances[arc.target] = distance + arc.weight;
+                queue.emplace(distances[arc.target], arc.target);
+            }
+        }
+    }
+    return distances;
+}
+
+// The distances between the boundary nodes of the top level are the ones of the graph, and
+// every hierarchy arc unpacks into a chain of overlay arcs between its ends
+void checkHierarchy(const MultiLevelEdgeBasedGraph &graph, const OverlayHierarchy &hierarchy)
+{
+    const auto num_nodes = static_cast<NodeID>(hierarchy.GetNumberOfNodes());
+    const auto forward = [&](const NodeID node) { return hierarchy.GetForwardArcs(node); };
+    const auto backward = [&](const NodeID node) { return hierarchy.GetBackwardArcs(node); };
+
+    std::vector<std::vector<EdgeWeight>> upward_backward;
+    for (const auto node : util::irange<NodeID>(0, num_nodes))
+        upward_backward.push_back(upwardSearch(hierarchy, node, backward));
+
+    for (const auto source : util::irange<NodeID>(0, num_nodes))
+    {
+        const auto expected = dijkstra(graph, hierarchy.GetNode(source));
+        const auto upward_forward = upwardSearch(hierarchy, source, forward);
+        for (const auto target : util::irange<NodeID>(0, num_nodes))
+        {
+            EdgeWeight distance = INVALID_EDGE_WEIGHT;
+            for (const auto middle : util::irange<NodeID>(0, num_nodes))
+            {
+                if (upward_forward[middle] != INVALID_EDGE_WEIGHT &&
+                    upward_backward[target][middle] != INVALID_EDGE_WEIGHT)
+                {
+                    distance = std::min(distance,
+                                        upward_forward[middle] + upward_backward[target][middle]);
+                }
+            }
+            BOOST_CHECK_EQUAL(distance, expected[hierarchy.GetNode(target)]);
+        }
+
+        for (const auto &arc : hierarchy.GetForwardArcs(source))
+        {
+            std::vector<std::pair<NodeID, NodeID>> path;
+            hierarchy.UnpackArc(source, arc.target, std::back_inserter(path));
+            BOOST_REQUIRE(!path.empty());
+            BOOST_CHECK_EQUAL(path.front().first, source);
+            BOOST_CHECK_EQUAL(path.back().second, arc.target);
+            BOOST_CHECK_EQUAL(path.size() == 1, arc.middle == SPECIAL_NODEID);
+            for (const auto index : util::irange<std::size_t>(1, path.size()))
+                BOOST_CHECK_EQUAL(path[index - 1].second, path[index].first);
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(overlay_hierarchy_tests)
+
+BOOST_AUTO_TEST_CASE(ring_test)
+{
+    // node:                0  1  2  3  4  5
+    std::vector<CellID> l1{{0, 0, 0, 1, 1, 1}};
+    MultiLevelPartition mlp{{l1}, {2}};
+
+    std::vector<MockEdge> edges = {
+        {0, 1, 1}, {1, 2, 1}, {2, 3, 1}, {3, 4, 1}, {4, 5, 1}, {5, 0, 1}};
+    auto graph = makeGraph(mlp, 6, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    customizer.Customize(graph, storage);
+
+    // the cut edges 2 -> 3 and 5 -> 0 make 0, 2, 3 and 5 the overlay nodes
+    const auto hierarchy = buildOverlayHierarchy(mlp, storage, graph);
+    BOOST_REQUIRE_EQUAL(hierarchy.GetNumberOfNodes(), 4);
+    BOOST_CHECK_EQUAL(hierarchy.GetNode(0), 0);
+    BOOST_CHECK_EQUAL(hierarchy.GetNode(1), 2);
+    BOOST_CHECK_EQUAL(hierarchy.GetNode(2), 3);
+    BOOST_CHECK_EQUAL(hierarchy.GetNode(3), 5);
+    BOOST_CHECK_EQUAL(hierarchy.GetOverlayNode(3), 2);
+    BOOST_CHECK_EQUAL(hierarchy.GetOverlayNode(1), SPECIAL_NODEID);
+
+    checkHierarchy(graph, hierarchy);
+}
+
+BOOST_AUTO_TEST_CASE(grid_test)
+{
+    // 8x8 grid with cells of 2x2 nodes on the first level and four cells on the top level
+    const NodeID size = 8;
+    std::vector<CellID> l1, l2;
+    for (const auto node : util::irange<NodeID>(0, size * size))
+    {
+        const auto x = node % size, y = node / size;
+        l1.push_back(x / 2 + 4 * (y / 2));
+        l2.push_back(x / 4 + 2 * (y / 4));
+    }
+    MultiLevelPartition mlp{{l1, l2}, {16, 4}};
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<EdgeWeight> weight(1, 20);
+    std::vector<MockEdge> edges;
+    for (const auto node : util::irange<NodeID>(0, size * size))
+    {
+        const auto x = node % size, y = node / size;
+        for (const auto neighbour :
+             {x + 1 < size ? node + 1 : node, y + 1 < size ? node + size : node})
+        {
+            if (neighbour == node)
+                continue;
+            // every third street is one-way
+            edges.push_back({node, neighbour, weight(generator)});
+            if (edges.size() % 3 != 0)
+                edges.push_back({neighbour, node, weight(generator)});
+        }
+    }
+    auto graph = makeGraph(mlp, size * size, edges);
+
+    CellStorage storage(mlp, graph);
+    CellCustomizer customizer(mlp);
+    customizer.Customize(graph, storage);
+
+    const auto hierarchy = buildOverlayHierarchy(mlp, storage, graph);
+    BOOST_CHECK(hierarchy.GetNumberOfNodes() > 0);
+    checkHierarchy(graph, hierarchy);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+#include "engine/async_executor.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(async_executor)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(runs_all_tasks)
+{
+    AsyncExecutor executor(2);
+
+    std::atomic<int> finished{0};
+    for (int i = 0; i < 100; ++i)
+    {
+        executor.Enqueue([&finished] { ++finished; });
+    }
+    executor.Wait();
+
+    BOOST_CHECK_EQUAL(finished, 100);
+}
+
+BOOST_AUTO_TEST_CASE(enqueue_does_not_block)
+{
+    AsyncExecutor executor(1);
+
+    std::mutex blocker;
+    std::atomic<int> finished{0};
+    {
+        std::lock_guard<std::mutex> guard(blocker);
+        for (int i = 0; i < 10; ++i)
+        {
+            executor.Enqueue([&] {
+                std::lock_guard<std::mutex> task_guard(blocker);
+                ++finished;
+            });
+        }
+        // all tasks are held up by the lock, but queueing them returned
+        BOOST_CHECK_EQUAL(finished, 0);
+    }
+    executor.Wait();
+
+    BOOST_CHECK_EQUAL(finished, 10);
+}
+
+BOOST_AUTO_TEST_CASE(limits_concurrency)
+{
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    {
+        AsyncExecutor executor(2);
+        for (int i = 0; i < 20; ++i)
+        {
+            executor.Enqueue([&] {
+                const auto now_running = ++running;
+                auto seen = max_running.load();
+                while (now_running > seen && !max_running.compare_exchange_weak(seen, now_running))
+                {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                --running;
+            });
+        }
+        // the destructor waits for the tasks
+    }
+
+    BOOST_CHECK_EQUAL(running, 0);
+    BOOST_CHECK_LE(max_running, 2);
+    BOOST_CHECK_GE(max_running, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -75,4 +75,83 @@ BOOST_AUTO_TEST_CASE(hint_encoding_decoding_roundtrip_bytewise)
                            reinterpret_cast<const unsigned char *>(&decoded)));
 }
 
+BOOST_AUTO_TEST_CASE(url_alphabet)
+{
+    using namespace osrm::engine;
+
+    const unsigned char bytes[] = {0xfb, 0xff, 0xbf};
+
+    BOOST_CHECK_EQUAL(encodeBase64(bytes, sizeof(bytes)), "+/+/");
+    BOOST_CHECK_EQUAL(encodeBase64(bytes, sizeof(bytes), Base64Alphabet::URL), "-_-_");
+    BOOST_CHECK_EQUAL(decodeBase64("+/+/"), decodeBase64("-_-_"));
+    BOOST_CHECK_EQUAL(decodeBase64("-_-_"), std::string(bytes, bytes + sizeof(bytes)));
+}
+
+// Long enough for the vectorized blocks and the tails of every length
+BOOST_AUTO_TEST_CASE(all_bytes_roundtrip)
+{
+    using namespace osrm::engine;
+
+    std::string bytes;
+    for (int repeat = 0; repeat < 2; ++repeat)
+        for (int byte = 0; byte < 256; ++byte)
+            bytes.push_back(static_cast<char>(byte * 7 + repeat));
+
+    const std::string alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (std::size_t size = 1; size <= bytes.size(); ++size)
+    {
+        const auto encoded = encodeBase64(bytes.data(), size);
+        BOOST_REQUIRE_EQUAL(encoded.size(), (size + 2) / 3 * 4);
+
+        // every character is the six bits of the input at its position
+        for (std::size_t index = 0; index < size * 8 / 6; ++index)
+        {
+            const auto bit = index * 6;
+            const auto byte = static_cast<unsigned char>(bytes[bit / 8]);
+            const auto next =
+                bit / 8 + 1 < size ? static_cast<unsigned char>(bytes[bit / 8 + 1]) : 0u;
+            const auto value = ((byte << 8 | next) >> (10 - bit % 8)) & 0x3f;
+            BOOST_REQUIRE_EQUAL(encoded[index], alphabet[value]);
+        }
+
+        BOOST_REQUIRE_EQUAL(decodeBase64(encoded), bytes.substr(0, size));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(invalid_characters)
+{
+    using namespace osrm::engine;
+
+    auto encoded = encodeBase64(std::string(48, 'x'));
+    BOOST_CHECK_EQUAL(decodeBase64(encoded), std::string(48, 'x'));
+
+    // in the first block, a later block and the tail
+    for (const std::size_t position : {3, 40, 62})
+    {
+        auto invalid = encoded;
+        invalid[position] = '.';
+        BOOST_CHECK_THROW(decodeBase64(invalid), boost::archive::iterators::dataflow_exception);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hint_validation_with_checksum)
+{
+    using namespace osrm::engine;
+    using namespace osrm::util;
+
+    const osrm::test::MockDataFacade<osrm::engine::routing_algorithms::ch::Algorithm> facade{};
+
+    PhantomNode phantom;
+    phantom.location = Coordinate{FloatLongitude{7.4}, FloatLatitude{43.7}};
+    phantom.input_location = phantom.location;
+    const Hint hint{phantom, facade.GetCheckSum()};
+
+    BOOST_CHECK(hint.IsValid(phantom.input_location, facade));
+    BOOST_CHECK(hint.IsValid(phantom.input_location, facade.GetCheckSum()));
+    BOOST_CHECK(!hint.IsValid(phantom.input_location, facade.GetCheckSum() + 1));
+    BOOST_CHECK(!hint.IsValid(Coordinate{FloatLongitude{7.5}, FloatLatitude{43.7}},
+                              facade.GetCheckSum()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+#include "engine/api/binary_builder.hpp"
+#include "engine/api/binary_format.hpp"
+
+#include "util/json_container.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(binary_format)
+
+using namespace osrm;
+using namespace osrm::engine::api;
+
+BOOST_AUTO_TEST_CASE(encode_json_object)
+{
+    util::json::Object waypoint;
+    waypoint.values["name"] = "Unter den Linden";
+    util::json::Array location;
+    location.values.push_back(util::json::Number{13.38886});
+    location.values.push_back(util::json::Number{52.517037});
+    waypoint.values["location"] = std::move(location);
+
+    util::json::Array row;
+    row.values.push_back(util::json::Number{0.});
+    row.values.push_back(util::json::Null());
+    util::json::Array durations;
+    durations.values.push_back(std::move(row));
+
+    util::json::Array waypoints;
+    waypoints.values.push_back(std::move(waypoint));
+    waypoints.values.push_back(util::json::Null());
+
+    util::json::Object object;
+    object.values["code"] = "Ok";
+    object.values["waypoints"] = std::move(waypoints);
+    object.values["durations"] = std::move(durations);
+    object.values["empty"] = util::json::Array();
+    object.values["valid"] = util::json::True();
+    object.values["distance"] = util::json::Number{1234.5};
+
+    std::string data;
+    binary::encode(object, data);
+    BOOST_CHECK_EQUAL(data.size() % 8, 0);
+
+    const auto root = binary::GetRoot(data.data());
+    BOOST_CHECK(root.type() == binary::ValueType::Object);
+    BOOST_CHECK_EQUAL(root.size(), 6);
+    // members are sorted by key
+    BOOST_CHECK_EQUAL(root.GetKey(0).GetString(), "code");
+    BOOST_CHECK_EQUAL(root.GetKey(5).GetString(), "waypoints");
+
+    BOOST_CHECK_EQUAL(root["code"].GetString(), "Ok");
+    BOOST_CHECK_EQUAL(root["distance"].GetNumber(), 1234.5);
+    BOOST_CHECK(root["valid"].type() == binary::ValueType::True);
+    BOOST_CHECK(root["missing"].type() == binary::ValueType::Null);
+    BOOST_CHECK(root["empty"].type() == binary::ValueType::Array);
+    BOOST_CHECK_EQUAL(root["empty"].size(), 0);
+
+    const auto first_waypoint = root["waypoints"][0];
+    BOOST_CHECK_EQUAL(first_waypoint["name"].GetString(), "Unter den Linden");
+    const auto coordinates = first_waypoint["location"];
+    BOOST_CHECK(coordinates.type() == binary::ValueType::NumberArray);
+    BOOST_CHECK_EQUAL(coordinates.size(), 2);
+    BOOST_CHECK_EQUAL(coordinates.GetNumbers()[0], 13.38886);
+    BOOST_CHECK_EQUAL(coordinates.GetNumbers()[1], 52.517037);
+    BOOST_CHECK(root["waypoints"][1].type() == binary::ValueType::Null);
+
+    // arrays of numbers and nulls are number arrays with NaN for null
+    const auto first_row = root["durations"][0];
+    BOOST_CHECK(first_row.type() == binary::ValueType::NumberArray);
+    BOOST_CHECK_EQUAL(first_row.GetNumbers()[0], 0.);
+    BOOST_CHECK(std::isnan(first_row.GetNumbers()[1]));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
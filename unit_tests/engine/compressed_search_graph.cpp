@@ -0,0 +1,98 @@
+#include "contractor/compressed_search_graph.hpp"
+#include "contractor/files.hpp"
+#include "contractor/query_edge.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include "../common/temporary_file.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(compressed_search_graph)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+using QueryGraph = util::StaticGraph<QueryEdge::EdgeData>;
+using InputEdge = QueryGraph::InputEdge;
+
+namespace
+{
+InputEdge
+makeEdge(NodeID source, NodeID target, EdgeWeight weight, bool forward, bool backward)
+{
+    QueryEdge::EdgeData data;
+    data.weight = weight;
+    data.duration = 1;
+    data.forward = forward;
+    data.backward = backward;
+    return InputEdge{source, target, data};
+}
+
+template <typename CompressedGraphT>
+void checkEdges(const QueryGraph &graph, const CompressedGraphT &compressed)
+{
+    BOOST_REQUIRE_EQUAL(compressed.GetNumberOfNodes(), graph.GetNumberOfNodes());
+    for (const auto node : util::irange<NodeID>(0, graph.GetNumberOfNodes()))
+    {
+        auto decoded = compressed.GetAdjacentEdges(node).begin();
+        const auto end = compressed.GetAdjacentEdges(node).end();
+        for (const auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            BOOST_REQUIRE(decoded != end);
+            const auto &data = graph.GetEdgeData(edge);
+            BOOST_CHECK_EQUAL(decoded->target, graph.GetTarget(edge));
+            BOOST_CHECK_EQUAL(decoded->weight, data.weight);
+            BOOST_CHECK_EQUAL(decoded->forward, data.forward);
+            BOOST_CHECK_EQUAL(decoded->backward, data.backward);
+            ++decoded;
+        }
+        BOOST_CHECK(decoded == end);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(encode_decode_test)
+{
+    const NodeID far_node = (1u << 20) + 5;
+    std::vector<InputEdge> edges = {makeEdge(0, 0, 7, true, true),
+                                    makeEdge(0, 2, 1, true, false),
+                                    makeEdge(0, far_node, (1 << 30) + 3, false, true),
+                                    makeEdge(2, 1, 127, true, true),
+                                    makeEdge(2, 3, 128, false, true),
+                                    makeEdge(far_node, 3, 16384, true, false),
+                                    makeEdge(far_node, far_node + 1, 1 << 30, true, true)};
+    std::sort(edges.begin(), edges.end());
+    const QueryGraph graph(far_node + 2, edges);
+
+    const CompressedSearchGraph compressed(graph);
+    checkEdges(graph, compressed);
+
+    // nodes without edges take no space
+    BOOST_CHECK(compressed.GetAdjacentEdges(1).empty());
+    BOOST_CHECK(compressed.GetAdjacentEdges(far_node - 1).empty());
+    BOOST_CHECK_LT(compressed.GetEncodedSize(), edges.size() * 8);
+}
+
+BOOST_AUTO_TEST_CASE(file_roundtrip_test)
+{
+    std::vector<InputEdge> edges = {makeEdge(0, 1, 3, true, true),
+                                    makeEdge(1, 2, 300000, true, false),
+                                    makeEdge(3, 0, 5, false, true)};
+    std::sort(edges.begin(), edges.end());
+    const QueryGraph graph(4, edges);
+
+    TemporaryFile tmp;
+    files::writeCompressedSearchGraph(tmp.path, 42, CompressedSearchGraph(graph));
+
+    unsigned checksum = 0;
+    CompressedSearchGraph compressed;
+    files::readCompressedSearchGraph(tmp.path, checksum, compressed);
+    BOOST_CHECK_EQUAL(checksum, 42);
+    checkEdges(graph, compressed);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
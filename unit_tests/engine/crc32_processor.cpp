@@ -0,0 +1,69 @@
+#include "contractor/crc32_processor.hpp"
+#include "util/deallocating_vector.hpp"
+
+#include <boost/crc.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(crc32_processor)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+// CRC32C without initial and final xor
+template <typename T> unsigned referenceCRC32(const std::vector<T> &values)
+{
+    boost::crc_optimal<32, 0x1EDC6F41, 0x0, 0x0, true, true> crc;
+    crc.process_bytes(values.data(), values.size() * sizeof(T));
+    return crc.checksum();
+}
+}
+
+BOOST_AUTO_TEST_CASE(software_and_hardware_test)
+{
+    const std::string check = "123456789";
+    const auto reference = referenceCRC32(std::vector<char>(check.begin(), check.end()));
+    BOOST_CHECK_EQUAL(detail::ComputeInSoftware(0, check.data(), check.size()), reference);
+    if (detail::HasHardwareCRC32())
+    {
+        BOOST_CHECK_EQUAL(detail::ComputeInHardware(0, check.data(), check.size()), reference);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(combine_test)
+{
+    const std::string check = "123456789";
+    const auto whole = detail::ComputeInSoftware(0, check.data(), check.size());
+    for (std::size_t split = 0; split <= check.size(); ++split)
+    {
+        const auto first = detail::ComputeInSoftware(0, check.data(), split);
+        const auto second =
+            detail::ComputeInSoftware(0, check.data() + split, check.size() - split);
+        BOOST_CHECK_EQUAL(detail::CombineCRC32(first, second, check.size() - split), whole);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(slices_test)
+{
+    // more than two slices, the last one partially filled
+    std::vector<std::uint32_t> values(RangebasedCRC32::SLICE_SIZE / 2 + 12345);
+    std::iota(values.begin(), values.end(), 7);
+    const auto reference = referenceCRC32(values);
+
+    BOOST_CHECK_EQUAL(RangebasedCRC32()(values), reference);
+    BOOST_CHECK_EQUAL(IteratorbasedCRC32()(values.begin(), values.end()), reference);
+
+    util::DeallocatingVector<std::uint32_t> deallocating_values;
+    for (const auto value : values)
+        deallocating_values.push_back(value);
+    BOOST_CHECK_EQUAL(RangebasedCRC32()(deallocating_values), reference);
+
+    BOOST_CHECK_EQUAL(RangebasedCRC32()(std::vector<std::uint32_t>()), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+#include "engine/data_memory.hpp"
+#include "storage/block_memory.hpp"
+#include "storage/shared_datatype.hpp"
+#include "util/huge_pages.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(data_memory)
+
+using namespace osrm;
+using storage::DataLayout;
+
+namespace
+{
+const constexpr std::uint64_t NUM_COORDINATES = 1 << 17;
+
+// Layout with coordinates and names in the memory block and the geometries in a vector, as if
+// they were mapped from their file. Only the canaries of the memory block are written.
+class TestAllocator final : public engine::datafacade::ContiguousBlockAllocator
+{
+  public:
+    TestAllocator() : geometries(1000, 7)
+    {
+        for (const auto id : util::irange<int>(0, DataLayout::NUM_BLOCKS))
+        {
+            layout.SetBlockSize<char>(static_cast<DataLayout::BlockID>(id), 0);
+        }
+        layout.SetBlockSize<char>(DataLayout::NAME_CHAR_DATA, 13);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::COORDINATE_LIST, NUM_COORDINATES);
+        layout.SetBlockSize<std::uint32_t>(DataLayout::GEOMETRIES_NODE_LIST, geometries.size());
+        layout.SetExternalBlock(DataLayout::GEOMETRIES_NODE_LIST,
+                                reinterpret_cast<const char *>(geometries.data()));
+
+        memory = std::make_unique<util::HugePageMemory>(layout.GetSizeOfLayout(), false);
+        for (const auto id : util::irange<int>(0, DataLayout::NUM_BLOCKS))
+        {
+            layout.GetBlockPtr<char, true>(memory->Get(), static_cast<DataLayout::BlockID>(id));
+        }
+    }
+
+    DataLayout &GetLayout() override { return layout; }
+    char *GetMemory() override { return memory->Get(); }
+
+  private:
+    DataLayout layout;
+    std::vector<std::uint32_t> geometries;
+    std::unique_ptr<util::HugePageMemory> memory;
+};
+}
+
+BOOST_AUTO_TEST_CASE(block_memory)
+{
+    TestAllocator allocator;
+    auto &layout = allocator.GetLayout();
+
+    auto blocks = storage::getBlockMemory(layout, allocator.GetMemory());
+    BOOST_REQUIRE_EQUAL(blocks.size(), 3);
+    BOOST_CHECK_EQUAL(blocks[0].id, DataLayout::COORDINATE_LIST);
+    BOOST_CHECK_EQUAL(blocks[0].bytes, NUM_COORDINATES * sizeof(std::uint64_t));
+    BOOST_CHECK(!blocks[0].external);
+    BOOST_CHECK_EQUAL(blocks[1].id, DataLayout::GEOMETRIES_NODE_LIST);
+    BOOST_CHECK_EQUAL(blocks[1].bytes, 4000);
+    BOOST_CHECK(blocks[1].external);
+    BOOST_CHECK_EQUAL(blocks[1].resident_bytes, 4000);
+    BOOST_CHECK_EQUAL(blocks[2].id, DataLayout::NAME_CHAR_DATA);
+    BOOST_CHECK_EQUAL(blocks[2].bytes, 13);
+#ifdef __linux__
+    // only the pages of the canaries were touched
+    BOOST_CHECK_LT(blocks[0].resident_bytes, blocks[0].bytes / 2);
+#endif
+
+    const auto coordinates =
+        layout.GetBlockPtr<std::uint64_t>(allocator.GetMemory(), DataLayout::COORDINATE_LIST);
+    std::iota(coordinates, coordinates + NUM_COORDINATES, 0);
+    blocks = storage::getBlockMemory(layout, allocator.GetMemory());
+    BOOST_CHECK_EQUAL(blocks[0].resident_bytes, blocks[0].bytes);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_follow_the_allocators)
+{
+    auto &metrics = engine::DataMemoryMetrics::GetInstance();
+    auto allocator = std::make_shared<TestAllocator>();
+    metrics.Register("test", 1, allocator);
+
+    auto dump = metrics.DumpPrometheus();
+    BOOST_CHECK(dump.find("osrm_data_block_bytes{dataset=\"test\",replica=\"1\","
+                          "block=\"COORDINATE_LIST\",source=\"memory\"} 1048576\n") !=
+                std::string::npos);
+    BOOST_CHECK(dump.find("osrm_data_block_resident_bytes{dataset=\"test\",replica=\"1\","
+                          "block=\"GEOMETRIES_NODE_LIST\",source=\"file\"} 4000\n") !=
+                std::string::npos);
+    BOOST_CHECK(dump.find("MLD_CELLS") == std::string::npos);
+
+    // the copy that replaces the dataset is reported instead of it
+    auto replacement = std::make_shared<TestAllocator>();
+    metrics.Register("test", 1, replacement);
+    dump = metrics.DumpPrometheus();
+    const auto bytes = dump.find("osrm_data_block_bytes{dataset=\"test\"");
+    BOOST_REQUIRE(bytes != std::string::npos);
+    BOOST_CHECK(dump.find("osrm_data_block_bytes{dataset=\"test\",replica=\"1\","
+                          "block=\"COORDINATE_LIST\"",
+                          bytes + 1) == std::string::npos);
+
+    // released datasets are not reported
+    allocator.reset();
+    replacement.reset();
+    BOOST_CHECK(metrics.DumpPrometheus().find("dataset=\"test\"") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
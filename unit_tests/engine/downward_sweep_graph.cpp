@@ -0,0 +1,84 @@
+#include "contractor/downward_sweep_graph.hpp"
+#include "contractor/query_edge.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(downward_sweep_graph)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+using QueryGraph = util::StaticGraph<QueryEdge::EdgeData>;
+using InputEdge = QueryGraph::InputEdge;
+
+InputEdge
+makeEdge(NodeID source, NodeID target, EdgeWeight weight, bool forward, bool backward)
+{
+    QueryEdge::EdgeData data;
+    data.weight = weight;
+    data.duration = weight * 10;
+    data.forward = forward;
+    data.backward = backward;
+    return InputEdge{source, target, data};
+}
+
+BOOST_AUTO_TEST_CASE(sweep_order_test)
+{
+    // Contraction order 0, 1, 2, 3. Edges are stored at the lower node pointing upwards:
+    //
+    //  3 <--- 2
+    //  ^    /   \
+    //  |  /      \
+    //  1          0 (with a loop)
+    std::vector<InputEdge> edges = {makeEdge(0, 0, 7, true, true),
+                                    makeEdge(0, 2, 1, true, true),
+                                    makeEdge(1, 2, 2, true, true),
+                                    makeEdge(1, 3, 5, false, true),
+                                    makeEdge(2, 3, 3, true, false)};
+    std::sort(edges.begin(), edges.end());
+    const QueryGraph graph(4, edges);
+
+    const DownwardSweepGraph sweep_graph(graph);
+    BOOST_REQUIRE_EQUAL(sweep_graph.GetNumberOfNodes(), 4);
+
+    for (const auto node : {0, 1, 2, 3})
+    {
+        BOOST_CHECK_EQUAL(sweep_graph.GetNode(sweep_graph.GetRank(node)), node);
+    }
+
+    // higher nodes come first
+    BOOST_CHECK_EQUAL(sweep_graph.GetNode(0), 3);
+    BOOST_CHECK_EQUAL(sweep_graph.GetNode(1), 2);
+    BOOST_CHECK_LT(sweep_graph.GetRank(2), sweep_graph.GetRank(0));
+    BOOST_CHECK_LT(sweep_graph.GetRank(2), sweep_graph.GetRank(1));
+
+    // only edges usable downwards end up in the sweep graph, without loops
+    BOOST_CHECK(sweep_graph.GetIncomingEdgeRange(sweep_graph.GetRank(3)).size() == 0);
+    BOOST_CHECK(sweep_graph.GetIncomingEdgeRange(sweep_graph.GetRank(2)).size() == 0);
+
+    const auto edges_of_0 = sweep_graph.GetIncomingEdgeRange(sweep_graph.GetRank(0));
+    BOOST_REQUIRE_EQUAL(edges_of_0.size(), 1);
+    const auto &edge_from_2 = sweep_graph.GetEdge(edges_of_0.front());
+    BOOST_CHECK_EQUAL(edge_from_2.source, sweep_graph.GetRank(2));
+    BOOST_CHECK_EQUAL(edge_from_2.weight, 1);
+    BOOST_CHECK_EQUAL(edge_from_2.duration, 10);
+
+    const auto edges_of_1 = sweep_graph.GetIncomingEdgeRange(sweep_graph.GetRank(1));
+    BOOST_REQUIRE_EQUAL(edges_of_1.size(), 2);
+    std::vector<NodeID> sources;
+    for (const auto edge : edges_of_1)
+    {
+        sources.push_back(sweep_graph.GetNode(sweep_graph.GetEdge(edge).source));
+    }
+    std::sort(sources.begin(), sources.end());
+    BOOST_CHECK_EQUAL(sources[0], 2);
+    BOOST_CHECK_EQUAL(sources[1], 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,198 @@
+#include "contractor/files.hpp"
+#include "contractor/hub_labels.hpp"
+#include "contractor/query_edge.hpp"
+#include "util/integer_range.hpp"
+#include "util/static_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include "../common/temporary_file.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(hub_labels)
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+using QueryGraph = util::StaticGraph<QueryEdge::EdgeData>;
+using InputEdge = QueryGraph::InputEdge;
+
+namespace
+{
+// Chosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 7;
+
+using Arcs = std::vector<std::map<NodeID, EdgeWeight>>;
+
+// Random graph with one-way and two-way streets between nearby nodes
+Arcs makeArcs(const NodeID number_of_nodes)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<EdgeWeight> weight(1, 50);
+    std::uniform_int_distribution<NodeID> offset(1, 6);
+    Arcs arcs(number_of_nodes);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (int count = 0; count < 2; ++count)
+        {
+            const auto other = (node + offset(generator)) % number_of_nodes;
+            arcs[node][other] = weight(generator);
+            if ((node + count) % 3 != 0)
+                arcs[other][node] = weight(generator);
+        }
+    }
+    return arcs;
+}
+
+std::vector<EdgeWeight> dijkstra(const Arcs &arcs, const NodeID source)
+{
+    std::vector<EdgeWeight> weights(arcs.size(), INVALID_EDGE_WEIGHT);
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    weights[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto weight = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (weight != weights[node])
+            continue;
+        for (const auto &arc : arcs[node])
+        {
+            if (weight + arc.second < weights[arc.first])
+            {
+                weights[arc.first] = weight + arc.second;
+                queue.emplace(weights[arc.first], arc.first);
+            }
+        }
+    }
+    return weights;
+}
+
+// Contracts the nodes in the order of their ids with a shortcut between every pair of
+// neighbours, the edges are stored at the lower node. Durations are ten times the weights.
+QueryGraph contract(Arcs arcs)
+{
+    const auto number_of_nodes = static_cast<NodeID>(arcs.size());
+    Arcs incoming(number_of_nodes);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        for (const auto &arc : arcs[node])
+            incoming[arc.first][node] = arc.second;
+
+    std::vector<InputEdge> edges;
+    const auto add_edge = [&](NodeID source, NodeID target, EdgeWeight weight, bool forward) {
+        QueryEdge::EdgeData data;
+        data.weight = weight;
+        data.duration = weight * 10;
+        data.forward = forward;
+        data.backward = !forward;
+        edges.push_back(InputEdge{source, target, data});
+    };
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (const auto &in : incoming[node])
+        {
+            for (const auto &out : arcs[node])
+            {
+                if (in.first <= node || out.first <= node || in.first == out.first)
+                    continue;
+                auto &shortcut = arcs[in.first][out.first];
+                if (shortcut == 0 || in.second + out.second < shortcut)
+                {
+                    shortcut = in.second + out.second;
+                    incoming[out.first][in.first] = shortcut;
+                }
+            }
+        }
+        for (const auto &out : arcs[node])
+            if (out.first > node)
+                add_edge(node, out.first, out.second, true);
+        for (const auto &in : incoming[node])
+            if (in.first > node)
+                add_edge(node, in.first, in.second, false);
+    }
+    std::sort(edges.begin(), edges.end());
+    return QueryGraph(number_of_nodes, edges);
+}
+
+template <typename LabelsT> void checkLabels(const Arcs &arcs, const LabelsT &labels)
+{
+    BOOST_REQUIRE_EQUAL(labels.GetNumberOfNodes(), arcs.size());
+    for (const auto source : util::irange<NodeID>(0, arcs.size()))
+    {
+        const auto weights = dijkstra(arcs, source);
+        for (const auto target : util::irange<NodeID>(0, arcs.size()))
+        {
+            const auto path = labels.GetShortestPath(source, target);
+            BOOST_CHECK_EQUAL(path.weight, weights[target]);
+            if (weights[target] != INVALID_EDGE_WEIGHT)
+                BOOST_CHECK_EQUAL(path.duration, weights[target] * 10);
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(intersect_hubs_test)
+{
+    // long enough for the vector blocks and their scalar tail
+    std::vector<NodeID> first, second;
+    for (const auto hub : util::irange<NodeID>(0, 100))
+    {
+        if (hub % 2 == 0)
+            first.push_back(hub);
+        if (hub % 3 == 0)
+            second.push_back(hub);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> common;
+    detail::intersectHubs(first.data(),
+                          first.size(),
+                          second.data(),
+                          second.size(),
+                          [&](const std::size_t first_index, const std::size_t second_index) {
+                              common.emplace_back(first_index, second_index);
+                          });
+    std::sort(common.begin(), common.end());
+
+    BOOST_REQUIRE_EQUAL(common.size(), 17);
+    for (const auto index : util::irange<std::size_t>(0, common.size()))
+    {
+        BOOST_CHECK_EQUAL(first[common[index].first], 6 * index);
+        BOOST_CHECK_EQUAL(second[common[index].second], 6 * index);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(shortest_paths_test)
+{
+    const auto arcs = makeArcs(60);
+    const HubLabels labels(contract(arcs));
+    checkLabels(arcs, labels);
+
+    // the labels of the lowest node would hold every node without the pruning
+    BOOST_CHECK_LT(labels.GetNumberOfEntries(), 60 * 60);
+}
+
+BOOST_AUTO_TEST_CASE(file_roundtrip_test)
+{
+    const auto arcs = makeArcs(20);
+
+    TemporaryFile tmp;
+    files::writeHubLabels(tmp.path, 42, HubLabels(contract(arcs)));
+
+    unsigned checksum = 0;
+    HubLabels labels;
+    files::readHubLabels(tmp.path, checksum, labels);
+    BOOST_CHECK_EQUAL(checksum, 42);
+    checkLabels(arcs, labels);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
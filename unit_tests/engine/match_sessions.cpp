@@ -0,0 +1,86 @@
+#include "engine/match_sessions.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(match_sessions)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+MatchSessions::Session makeSession(const double log_probability)
+{
+    MatchSessions::Session session;
+    session.log_probabilities = {log_probability};
+    session.coordinate = {util::FloatLongitude{7.41}, util::FloatLatitude{43.73}};
+    return session;
+}
+}
+
+BOOST_AUTO_TEST_CASE(sessions_are_taken_once)
+{
+    MatchSessions sessions(std::chrono::seconds(60));
+    const auto facade = std::make_shared<int>(0);
+    const auto epoch = sessions.GetEpoch(facade);
+    const auto now = MatchSessions::Clock::now();
+
+    sessions.Put(epoch, "a", makeSession(-1.), now);
+    sessions.Put(epoch, "b", makeSession(-2.), now);
+    sessions.Put(epoch, "a", makeSession(-3.), now);
+    BOOST_CHECK_EQUAL(sessions.Size(), 2);
+
+    const auto a = sessions.Take(epoch, "a", now);
+    BOOST_REQUIRE(a);
+    BOOST_CHECK_EQUAL(a->log_probabilities.front(), -3.);
+    BOOST_CHECK(!sessions.Take(epoch, "a", now));
+    BOOST_CHECK(!sessions.Take(epoch, "c", now));
+    BOOST_CHECK_EQUAL(sessions.Size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(sessions_expire)
+{
+    MatchSessions sessions(std::chrono::seconds(60));
+    const auto epoch = sessions.GetEpoch(std::make_shared<int>(0));
+    const auto now = MatchSessions::Clock::now();
+
+    sessions.Put(epoch, "old", makeSession(-1.), now);
+    sessions.Put(epoch, "new", makeSession(-2.), now + std::chrono::seconds(30));
+
+    // continuing a session renews it
+    const auto later = now + std::chrono::seconds(70);
+    BOOST_CHECK(!sessions.Take(epoch, "old", later));
+    const auto session = sessions.Take(epoch, "new", later);
+    BOOST_REQUIRE(session);
+    sessions.Put(epoch, "new", *session, later);
+
+    BOOST_CHECK(sessions.Take(epoch, "new", later + std::chrono::seconds(59)));
+    BOOST_CHECK_EQUAL(sessions.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(new_facade_invalidates)
+{
+    MatchSessions sessions(std::chrono::seconds(60));
+    const auto old_facade = std::make_shared<int>(0);
+    const MatchSessionsView old_view{sessions, sessions.GetEpoch(old_facade)};
+    old_view.Put("a", makeSession(-1.));
+    old_view.Put("b", makeSession(-1.));
+    BOOST_CHECK(old_view.Take("a"));
+
+    const auto new_facade = std::make_shared<int>(0);
+    const MatchSessionsView new_view{sessions, sessions.GetEpoch(new_facade)};
+    BOOST_CHECK(!new_view.Take("b"));
+    BOOST_CHECK_EQUAL(sessions.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(empty_view_has_no_sessions)
+{
+    const MatchSessionsView view;
+    BOOST_CHECK(!view);
+    view.Put("a", makeSession(-1.));
+    BOOST_CHECK(!view.Take("a"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+#include "engine/query_deadline.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(query_deadline)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(default_deadline_never_expires)
+{
+    const QueryDeadline deadline;
+    BOOST_CHECK(!deadline.IsSet());
+    BOOST_CHECK(!deadline.IsExpired());
+
+    const ScopedQueryDeadline scope(deadline);
+    BOOST_CHECK(CurrentQueryDeadline() == nullptr);
+    BOOST_CHECK_NO_THROW(CheckQueryDeadline());
+}
+
+BOOST_AUTO_TEST_CASE(expires_after_timeout)
+{
+    const auto future = QueryDeadline::In(std::chrono::hours(1));
+    BOOST_CHECK(future.IsSet());
+    BOOST_CHECK(!future.IsExpired());
+
+    const QueryDeadline past{QueryDeadline::Clock::now() - std::chrono::milliseconds(1)};
+    BOOST_CHECK(past.IsExpired());
+
+    BOOST_CHECK(future.Earliest(past).ExpiresAt() == past.ExpiresAt());
+    BOOST_CHECK(past.Earliest(future).ExpiresAt() == past.ExpiresAt());
+    BOOST_CHECK(future.Earliest(QueryDeadline{}).ExpiresAt() == future.ExpiresAt());
+}
+
+BOOST_AUTO_TEST_CASE(cancelled_by_flag)
+{
+    const auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    const QueryDeadline deadline{cancelled};
+    BOOST_CHECK(deadline.IsSet());
+    BOOST_CHECK(!deadline.IsExpired());
+
+    // the flag of the later deadline still cancels the earlier one
+    const auto earliest = QueryDeadline::In(std::chrono::hours(1)).Earliest(deadline);
+    cancelled->store(true);
+    BOOST_CHECK(deadline.IsExpired());
+    BOOST_CHECK(earliest.IsExpired());
+}
+
+BOOST_AUTO_TEST_CASE(scopes_are_per_thread)
+{
+    const QueryDeadline past{QueryDeadline::Clock::now() - std::chrono::milliseconds(1)};
+    {
+        const ScopedQueryDeadline scope(past);
+        BOOST_CHECK(CurrentQueryDeadline() == &past);
+        BOOST_CHECK_THROW(CheckQueryDeadline(), QueryTimeout);
+
+        bool other_thread_has_deadline = true;
+        std::thread([&] { other_thread_has_deadline = CurrentQueryDeadline() != nullptr; })
+            .join();
+        BOOST_CHECK(!other_thread_has_deadline);
+
+        {
+            const QueryDeadline none;
+            const ScopedQueryDeadline nested(none);
+            BOOST_CHECK_NO_THROW(CheckQueryDeadline());
+        }
+        BOOST_CHECK(CurrentQueryDeadline() == &past);
+    }
+    BOOST_CHECK(CurrentQueryDeadline() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(loop_checks_every_interval)
+{
+    const QueryDeadline past{QueryDeadline::Clock::now() - std::chrono::milliseconds(1)};
+    const ScopedQueryDeadline scope(past);
+
+    QueryDeadlineCheck check_deadline;
+    for (std::size_t step = 1; step < QueryDeadlineCheck::INTERVAL; ++step)
+    {
+        BOOST_REQUIRE_NO_THROW(check_deadline());
+    }
+    BOOST_CHECK_THROW(check_deadline(), QueryTimeout);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+#include "engine/shortcut_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(shortcut_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+ShortcutCache::UnpackedShortcut makeShortcut(const std::vector<NodeID> &targets)
+{
+    auto unpacked = std::make_shared<std::vector<ShortcutCache::UnpackedEdge>>();
+    for (const auto target : targets)
+    {
+        unpacked->push_back({target, target + 100});
+    }
+    return unpacked;
+}
+}
+
+BOOST_AUTO_TEST_CASE(levels_and_directions_are_part_of_the_key)
+{
+    ShortcutCache cache(100);
+    const auto facade = std::make_shared<int>(0);
+    const ShortcutCacheView view{cache, cache.GetEpoch(facade)};
+
+    view.Put(0, 0, 4, makeShortcut({1, 2, 3, 4}));
+    view.Put(0, 4, 0, makeShortcut({3, 2, 1, 0}));
+    view.Put(2, 0, 4, makeShortcut({5, 4}));
+
+    const auto forward = view.Get(0, 0, 4);
+    BOOST_REQUIRE(forward);
+    BOOST_REQUIRE_EQUAL((*forward)->size(), 4);
+    BOOST_CHECK_EQUAL((*forward)->front().target, 1);
+    BOOST_CHECK_EQUAL((*forward)->front().edge, 101);
+
+    const auto reverse = view.Get(0, 4, 0);
+    BOOST_REQUIRE(reverse);
+    BOOST_CHECK_EQUAL((*reverse)->front().target, 3);
+
+    const auto cell_arc = view.Get(2, 0, 4);
+    BOOST_REQUIRE(cell_arc);
+    BOOST_CHECK_EQUAL((*cell_arc)->size(), 2);
+
+    BOOST_CHECK(!view.Get(1, 0, 4));
+
+    BOOST_CHECK_EQUAL(cache.Hits(), 3);
+    BOOST_CHECK_EQUAL(cache.Misses(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(new_facade_invalidates)
+{
+    ShortcutCache cache(100);
+
+    const auto old_facade = std::make_shared<int>(0);
+    const ShortcutCacheView old_view{cache, cache.GetEpoch(old_facade)};
+    old_view.Put(0, 0, 3, makeShortcut({1, 2, 3}));
+    BOOST_CHECK(old_view.Get(0, 0, 3));
+
+    const auto new_facade = std::make_shared<int>(0);
+    const ShortcutCacheView new_view{cache, cache.GetEpoch(new_facade)};
+    BOOST_CHECK(!new_view.Get(0, 0, 3));
+}
+
+BOOST_AUTO_TEST_CASE(empty_view_caches_nothing)
+{
+    const ShortcutCacheView view;
+    BOOST_CHECK(!view);
+    view.Put(0, 0, 3, makeShortcut({1, 2, 3}));
+    BOOST_CHECK(!view.Get(0, 0, 3));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
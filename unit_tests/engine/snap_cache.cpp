@@ -0,0 +1,80 @@
+#include "engine/snap_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(snap_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+PhantomNodePair makePair(const NodeID forward_segment_id)
+{
+    PhantomNodePair pair;
+    pair.first.forward_segment_id = {forward_segment_id, true};
+    pair.second = pair.first;
+    return pair;
+}
+}
+
+BOOST_AUTO_TEST_CASE(options_are_part_of_the_key)
+{
+    SnapCache cache(100);
+    const auto facade = std::make_shared<int>(0);
+    const auto epoch = cache.GetEpoch(facade);
+    const util::Coordinate coordinate{util::FloatLongitude{7.41}, util::FloatLatitude{43.73}};
+    const Bearing bearing{90, 20};
+
+    cache.Put(epoch, coordinate, boost::none, boost::none, boost::none, makePair(1));
+    cache.Put(epoch, coordinate, 50., bearing, Approach::CURB, makePair(2));
+
+    const auto plain = cache.Get(epoch, coordinate, boost::none, boost::none, boost::none);
+    BOOST_REQUIRE(plain);
+    BOOST_CHECK_EQUAL(plain->first.forward_segment_id.id, 1);
+
+    const auto with_options = cache.Get(epoch, coordinate, 50., bearing, Approach::CURB);
+    BOOST_REQUIRE(with_options);
+    BOOST_CHECK_EQUAL(with_options->first.forward_segment_id.id, 2);
+
+    BOOST_CHECK(!cache.Get(epoch, coordinate, 60., bearing, Approach::CURB));
+    BOOST_CHECK(!cache.Get(epoch, coordinate, 50., Bearing{90, 30}, Approach::CURB));
+    BOOST_CHECK(!cache.Get(epoch, coordinate, 50., bearing, Approach::UNRESTRICTED));
+    const util::Coordinate neighbour{util::FloatLongitude{7.410001}, util::FloatLatitude{43.73}};
+    BOOST_CHECK(!cache.Get(epoch, neighbour, boost::none, boost::none, boost::none));
+
+    BOOST_CHECK_EQUAL(cache.Hits(), 2);
+    BOOST_CHECK_EQUAL(cache.Misses(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(new_facade_invalidates)
+{
+    SnapCache cache(100);
+    const util::Coordinate coordinate{util::FloatLongitude{7.41}, util::FloatLatitude{43.73}};
+
+    const auto old_facade = std::make_shared<int>(0);
+    const auto old_epoch = cache.GetEpoch(old_facade);
+    BOOST_CHECK_EQUAL(cache.GetEpoch(old_facade), old_epoch);
+    const SnapCacheView old_view{cache, old_epoch};
+    old_view.Put(coordinate, boost::none, boost::none, boost::none, makePair(1));
+    BOOST_CHECK(old_view.Get(coordinate, boost::none, boost::none, boost::none));
+
+    const auto new_facade = std::make_shared<int>(0);
+    const auto new_epoch = cache.GetEpoch(new_facade);
+    BOOST_CHECK_NE(new_epoch, old_epoch);
+    const SnapCacheView new_view{cache, new_epoch};
+    BOOST_CHECK(!new_view.Get(coordinate, boost::none, boost::none, boost::none));
+}
+
+BOOST_AUTO_TEST_CASE(empty_view_caches_nothing)
+{
+    const SnapCacheView view;
+    const util::Coordinate coordinate{util::FloatLongitude{7.41}, util::FloatLatitude{43.73}};
+    BOOST_CHECK(!view);
+    view.Put(coordinate, boost::none, boost::none, boost::none, makePair(1));
+    BOOST_CHECK(!view.Get(coordinate, boost::none, boost::none, boost::none));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,59 @@
+#include "engine/tile_cache.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(tile_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(new_facade_invalidates)
+{
+    TileCache cache(100, {});
+    const auto dataset = TileCache::DatasetName(1, "2017-01-01");
+
+    const auto old_facade = std::make_shared<int>(0);
+    const auto old_epoch = cache.GetEpoch(old_facade);
+    cache.Put(old_epoch, dataset, 8529, 5974, 14, "tile");
+
+    const auto tile = cache.Get(old_epoch, dataset, 8529, 5974, 14);
+    BOOST_REQUIRE(tile);
+    BOOST_CHECK_EQUAL(*tile, "tile");
+    BOOST_CHECK(!cache.Get(old_epoch, dataset, 8529, 5975, 14));
+
+    const auto new_facade = std::make_shared<int>(0);
+    BOOST_CHECK(!cache.Get(cache.GetEpoch(new_facade), dataset, 8529, 5974, 14));
+
+    BOOST_CHECK_EQUAL(cache.Hits(), 1);
+    BOOST_CHECK_EQUAL(cache.Misses(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(persisted_tiles_survive_the_cache)
+{
+    const auto directory =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    const auto dataset = TileCache::DatasetName(1, "2017-01-01T00:00:00Z");
+    BOOST_CHECK_EQUAL(dataset, "1-2017_01_01T00_00_00Z");
+
+    {
+        TileCache cache(0, directory);
+        const auto facade = std::make_shared<int>(0);
+        cache.Put(cache.GetEpoch(facade), dataset, 8529, 5974, 14, std::string("ti\0le", 5));
+    }
+    BOOST_CHECK(boost::filesystem::is_regular_file(directory / dataset / "14" / "8529" /
+                                                   "5974.mvt"));
+
+    TileCache cache(0, directory);
+    const auto facade = std::make_shared<int>(0);
+    const auto tile = cache.Get(cache.GetEpoch(facade), dataset, 8529, 5974, 14);
+    BOOST_REQUIRE(tile);
+    BOOST_CHECK_EQUAL(*tile, std::string("ti\0le", 5));
+    BOOST_CHECK(!cache.Get(cache.GetEpoch(facade), TileCache::DatasetName(2, ""), 8529, 5974, 14));
+
+    boost::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+#include "engine/trip/trip_brute_force.hpp"
+#include "engine/trip/trip_held_karp.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_held_karp)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+util::DistTableWrapper<EdgeWeight> makeRandomTable(const std::size_t number_of_locations,
+                                                   const unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<EdgeWeight> weights(1, 1000);
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, 0);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+        {
+            if (from != to)
+                table[from * number_of_locations + to] = weights(generator);
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+std::int64_t tripWeight(const std::vector<NodeID> &trip,
+                        const util::DistTableWrapper<EdgeWeight> &table)
+{
+    std::int64_t weight = 0;
+    for (std::size_t index = 0; index < trip.size(); ++index)
+        weight += table(trip[index], trip[(index + 1) % trip.size()]);
+    return weight;
+}
+
+bool isPermutation(std::vector<NodeID> trip)
+{
+    std::sort(trip.begin(), trip.end());
+    for (std::size_t index = 0; index < trip.size(); ++index)
+        if (trip[index] != index)
+            return false;
+    return true;
+}
+}
+
+BOOST_AUTO_TEST_CASE(matches_brute_force)
+{
+    for (std::size_t number_of_locations = 1; number_of_locations <= 8; ++number_of_locations)
+    {
+        for (unsigned seed = 0; seed < 5; ++seed)
+        {
+            const auto table = makeRandomTable(number_of_locations, seed);
+            const auto trip = trip::HeldKarpTrip(number_of_locations, table);
+            BOOST_CHECK_EQUAL(trip.size(), number_of_locations);
+            BOOST_CHECK(isPermutation(trip));
+            BOOST_CHECK_EQUAL(trip.front(), 0);
+            BOOST_CHECK_EQUAL(tripWeight(trip, table),
+                              tripWeight(trip::BruteForceTrip(number_of_locations, table), table));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(avoids_unreachable_legs)
+{
+    // only the trip through the locations in order has no unreachable legs
+    const std::size_t number_of_locations = trip::HELD_KARP_MAX_LOCATIONS;
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations, INVALID_EDGE_WEIGHT);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        table[from * number_of_locations + from] = 0;
+        table[from * number_of_locations + (from + 1) % number_of_locations] = 100;
+    }
+    const util::DistTableWrapper<EdgeWeight> dist_table(std::move(table), number_of_locations);
+
+    const auto trip = trip::HeldKarpTrip(number_of_locations, dist_table);
+    BOOST_REQUIRE_EQUAL(trip.size(), number_of_locations);
+    for (std::size_t index = 0; index < number_of_locations; ++index)
+        BOOST_CHECK_EQUAL(trip[index], index);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+#include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_local_search)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// locations on a circle, the optimal trip visits them in order
+util::DistTableWrapper<EdgeWeight> makeCircleTable(const std::size_t number_of_locations)
+{
+    const auto pi = std::acos(-1.);
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+        {
+            const auto angle = pi * (static_cast<double>(from) - static_cast<double>(to)) /
+                               number_of_locations;
+            table[from * number_of_locations + to] =
+                static_cast<EdgeWeight>(std::round(10000 * std::abs(std::sin(angle))));
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+EdgeWeight tripWeight(const std::vector<NodeID> &trip,
+                      const util::DistTableWrapper<EdgeWeight> &table)
+{
+    EdgeWeight weight = 0;
+    for (std::size_t index = 0; index < trip.size(); ++index)
+        weight += table(trip[index], trip[(index + 1) % trip.size()]);
+    return weight;
+}
+
+bool isPermutation(std::vector<NodeID> trip)
+{
+    std::sort(trip.begin(), trip.end());
+    for (std::size_t index = 0; index < trip.size(); ++index)
+        if (trip[index] != index)
+            return false;
+    return true;
+}
+}
+
+BOOST_AUTO_TEST_CASE(untangles_circle)
+{
+    const std::size_t number_of_locations = 40;
+    const auto table = makeCircleTable(number_of_locations);
+
+    // every other location first, then the others backwards
+    std::vector<NodeID> trip;
+    for (NodeID location = 0; location < number_of_locations; location += 2)
+        trip.push_back(location);
+    for (NodeID location = number_of_locations - 1; location < number_of_locations; location -= 2)
+        trip.push_back(location);
+
+    std::vector<NodeID> ordered(number_of_locations);
+    std::iota(ordered.begin(), ordered.end(), 0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    const auto improved = trip::LocalSearchTrip(trip, table, deadline);
+    BOOST_CHECK(isPermutation(improved));
+    BOOST_CHECK_EQUAL(tripWeight(improved, table), tripWeight(ordered, table));
+    BOOST_CHECK_LT(tripWeight(improved, table), tripWeight(trip, table));
+}
+
+BOOST_AUTO_TEST_CASE(keeps_unreachable_legs_out)
+{
+    const std::size_t number_of_locations = 12;
+    auto table = makeCircleTable(number_of_locations);
+    // only 1 can be reached from 0 and only 0 can reach 1, as for trips with fixed start and end
+    for (NodeID location = 2; location < number_of_locations; ++location)
+    {
+        table.SetValue(0, location, INVALID_EDGE_WEIGHT);
+        table.SetValue(location, 1, INVALID_EDGE_WEIGHT);
+    }
+
+    const auto trip = trip::FarthestInsertionTrip(number_of_locations, table);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    const auto improved = trip::LocalSearchTrip(trip, table, deadline);
+    BOOST_CHECK(isPermutation(improved));
+    BOOST_CHECK_LE(tripWeight(improved, table), tripWeight(trip, table));
+
+    const auto zero = std::find(improved.begin(), improved.end(), 0);
+    BOOST_REQUIRE(zero != improved.end());
+    const auto next = std::next(zero) == improved.end() ? improved.begin() : std::next(zero);
+    BOOST_CHECK_EQUAL(*next, 1);
+}
+
+BOOST_AUTO_TEST_CASE(stops_at_deadline)
+{
+    const auto table = makeCircleTable(20);
+    std::vector<NodeID> trip(20);
+    std::iota(trip.begin(), trip.end(), 0);
+    std::reverse(trip.begin() + 3, trip.begin() + 15);
+
+    const auto improved =
+        trip::LocalSearchTrip(trip, table, std::chrono::steady_clock::time_point::min());
+    BOOST_CHECK_EQUAL_COLLECTIONS(improved.begin(), improved.end(), trip.begin(), trip.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
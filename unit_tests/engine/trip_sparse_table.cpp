@@ -0,0 +1,98 @@
+#include "engine/trip/trip_local_search.hpp"
+#include "engine/trip/trip_nearest_neighbour.hpp"
+#include "engine/trip/trip_sparse_table.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_sparse_table)
+
+using namespace osrm;
+using namespace osrm::engine;
+using routing_algorithms::NearestTarget;
+
+namespace
+{
+// locations along a line 100m apart, each knowing the durations to its two nearest ones
+trip::SparseDistTable makeLineTable(const std::size_t number_of_locations)
+{
+    std::vector<std::vector<NearestTarget>> nearest_targets(number_of_locations);
+    std::vector<util::Coordinate> coordinates;
+    for (std::size_t location = 0; location < number_of_locations; ++location)
+    {
+        coordinates.push_back(
+            {util::FloatLongitude{7.41 + 0.001 * location}, util::FloatLatitude{43.73}});
+
+        auto &targets = nearest_targets[location];
+        if (location > 0)
+            targets.push_back({location - 1, 100});
+        if (location + 1 < number_of_locations)
+            targets.push_back({location + 1, 100});
+        if (targets.size() < 2)
+            targets.push_back({location == 0 ? 2u : location - 2, 200});
+    }
+    return trip::SparseDistTable(std::move(nearest_targets), std::move(coordinates), 2);
+}
+}
+
+BOOST_AUTO_TEST_CASE(estimates_unknown_durations)
+{
+    const auto table = makeLineTable(10);
+    BOOST_CHECK_EQUAL(table.GetNumberOfNodes(), 10);
+    BOOST_CHECK_EQUAL(table(3, 3), 0);
+    BOOST_CHECK_EQUAL(table(3, 4), 100);
+    BOOST_CHECK_EQUAL(table(0, 2), 200);
+
+    // estimated from the distance and never shorter than the durations to the nearest ones
+    BOOST_CHECK_GE(table(3, 5), 100);
+    BOOST_CHECK_GT(table(0, 9), table(0, 5));
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_if_fewer_nearest)
+{
+    std::vector<std::vector<NearestTarget>> nearest_targets = {{{1, 10}}, {{0, 10}}, {{1, 10}}};
+    std::vector<util::Coordinate> coordinates(
+        3, util::Coordinate{util::FloatLongitude{7.41}, util::FloatLatitude{43.73}});
+    const trip::SparseDistTable table(std::move(nearest_targets), std::move(coordinates), 2);
+
+    BOOST_CHECK_EQUAL(table(0, 1), 10);
+    BOOST_CHECK_EQUAL(table(0, 2), INVALID_EDGE_WEIGHT);
+}
+
+BOOST_AUTO_TEST_CASE(fixed_start_and_end)
+{
+    auto table = makeLineTable(10);
+    table.FixStartAndEnd(4, 7);
+
+    BOOST_CHECK_EQUAL(table(7, 4), 0);
+    BOOST_CHECK_EQUAL(table(7, 6), INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_EQUAL(table(3, 4), INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_EQUAL(table(4, 7), INVALID_EDGE_WEIGHT);
+    BOOST_CHECK_EQUAL(table(4, 3), 100);
+
+    const auto neighbours = table.GetNeighbours();
+    BOOST_REQUIRE_EQUAL(neighbours[7].size(), 1);
+    BOOST_CHECK_EQUAL(neighbours[7].front(), 4);
+
+    const auto route = trip::NeighbourListTrip(table, neighbours, 4, 7);
+    BOOST_REQUIRE_EQUAL(route.size(), 10);
+    BOOST_CHECK_EQUAL(route.front(), 4);
+    BOOST_CHECK_EQUAL(route.back(), 7);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto improved = trip::LocalSearchTrip(route, table, neighbours, deadline);
+    const auto destination = std::find(improved.begin(), improved.end(), 7);
+    BOOST_REQUIRE(destination != improved.end());
+    const auto next = std::next(destination) == improved.end() ? improved.begin()
+                                                                : std::next(destination);
+    BOOST_CHECK_EQUAL(*next, 4);
+
+    std::sort(improved.begin(), improved.end());
+    for (std::size_t location = 0; location < improved.size(); ++location)
+        BOOST_CHECK_EQUAL(improved[location], location);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -87,4 +87,78 @@ BOOST_AUTO_TEST_CASE(t_crossing)
     BOOST_CHECK_EQUAL(container.GetLastEdgeSourceID(2), 3);
 }
 
+BOOST_AUTO_TEST_CASE(compacted_buckets)
+{
+    //   0   1    2    3
+    // 0---1----2----3----4
+    //   4   5    6    7
+    CompressedEdgeContainer container;
+    container.CompressEdge(0, 1, 1, 2, 1, 2, 11, 12);
+    container.CompressEdge(2, 3, 3, 4, 3, 4, 13, 14);
+    container.CompressEdge(0, 2, 2, 4, 3, 7, 23, 27);
+    container.CompressEdge(7, 6, 3, 2, 4, 3, 14, 13);
+    container.CompressEdge(5, 4, 1, 0, 2, 1, 12, 11);
+    container.CompressEdge(7, 5, 2, 0, 7, 3, 27, 23);
+    container.AddUncompressedEdge(9, 3, 5, 15);
+
+    container.InitializeBothwayVector();
+    BOOST_CHECK(container.HasEntryForID(0));
+    BOOST_CHECK(!container.HasEntryForID(2));
+    BOOST_CHECK(!container.HasEntryForID(8));
+    BOOST_CHECK(container.HasEntryForID(9));
+    BOOST_CHECK(!container.HasEntryForID(10));
+    BOOST_CHECK(container.IsTrivial(9));
+    BOOST_CHECK_EQUAL(container.GetLastEdgeSourceID(0), 3);
+    BOOST_CHECK_EQUAL(container.GetLastEdgeTargetID(7), 0);
+
+    const auto forward = container.GetBucketReference(0);
+    BOOST_REQUIRE_EQUAL(forward.size(), 4);
+    for (const auto i : {0, 1, 2, 3})
+    {
+        BOOST_CHECK_EQUAL(forward[i].node_id, i + 1);
+        BOOST_CHECK_EQUAL(forward[i].weight, i + 1);
+        BOOST_CHECK_EQUAL(forward[i].duration, i + 11);
+    }
+
+    const auto zipped_id = container.ZipEdges(0, 7);
+    BOOST_CHECK(container.HasZippedEntryForForwardID(0));
+    BOOST_CHECK(container.HasZippedEntryForReverseID(7));
+    BOOST_CHECK(!container.HasZippedEntryForForwardID(7));
+    BOOST_CHECK_EQUAL(container.GetZippedPositionForForwardID(0), zipped_id);
+
+    const auto segment_data = container.ToSegmentData();
+    const auto nodes = segment_data->GetForwardGeometry(zipped_id);
+    const std::vector<NodeID> expected_nodes = {0, 1, 2, 3, 4};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        nodes.begin(), nodes.end(), expected_nodes.begin(), expected_nodes.end());
+}
+
+BOOST_AUTO_TEST_CASE(renumbered_edges)
+{
+    //   0   1
+    // 0---1----2
+    //   4   5
+    CompressedEdgeContainer container;
+    container.CompressEdge(0, 1, 1, 2, 1, 2, 11, 12);
+    container.CompressEdge(5, 4, 1, 0, 2, 1, 12, 11);
+    container.AddUncompressedEdge(9, 3, 5, 15);
+
+    // the removed edges 1 and 4 are dropped
+    const std::vector<EdgeID> new_edge_ids = {
+        2, SPECIAL_EDGEID, 4, 5, SPECIAL_EDGEID, 0, 6, 7, 8, 1};
+    container.RenumberEdges(new_edge_ids);
+
+    container.InitializeBothwayVector();
+    BOOST_CHECK(container.HasEntryForID(0));
+    BOOST_CHECK(container.HasEntryForID(1));
+    BOOST_CHECK(container.HasEntryForID(2));
+    BOOST_CHECK(!container.HasEntryForID(4));
+    BOOST_CHECK(!container.HasEntryForID(9));
+    BOOST_CHECK(container.IsTrivial(1));
+    BOOST_CHECK_EQUAL(container.GetLastEdgeTargetID(1), 3);
+    BOOST_CHECK_EQUAL(container.GetLastEdgeSourceID(2), 1);
+    BOOST_CHECK_EQUAL(container.GetLastEdgeTargetID(2), 2);
+    BOOST_CHECK_EQUAL(container.GetLastEdgeTargetID(0), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,51 @@
+#include "extractor/conditional_turn_masks.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(conditional_turn_masks)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+BOOST_AUTO_TEST_CASE(time_slots_of_turns)
+{
+    TimeSlotMask monday_morning{};
+    // Monday 08:00 to 08:30
+    setTimeSlot(monday_morning, 32);
+    setTimeSlot(monday_morning, 33);
+    TimeSlotMask sunday_night{};
+    // Sunday 23:45
+    setTimeSlot(sunday_night, TIME_SLOTS_PER_WEEK - 1);
+    BOOST_CHECK(isTimeSlotEmpty(TimeSlotMask{}));
+    BOOST_CHECK(!isTimeSlotEmpty(sunday_night));
+
+    const std::vector<ConditionalTurn> conditional_turns = {
+        {7, 3, 4, sunday_night}, {2, 0, 1, monday_morning}, {7, 3, 4, monday_morning}};
+    const ConditionalTurnMasks masks(conditional_turns);
+
+    BOOST_REQUIRE_EQUAL(masks.GetNumberOfTurns(), 2);
+    BOOST_CHECK_EQUAL(masks.GetTurnID(0), 2);
+    BOOST_CHECK_EQUAL(masks.GetTurnID(1), 7);
+    BOOST_CHECK_EQUAL(masks.GetSource(1), 3);
+    BOOST_CHECK_EQUAL(masks.GetTarget(1), 4);
+
+    BOOST_CHECK(!masks.IsRestricted(0, 8 * 60 - 1));
+    BOOST_CHECK(masks.IsRestricted(0, 8 * 60));
+    BOOST_CHECK(masks.IsRestricted(0, 8 * 60 + 29));
+    BOOST_CHECK(!masks.IsRestricted(0, 8 * 60 + 30));
+    // the restrictions of a turn are merged
+    BOOST_CHECK(masks.IsRestricted(1, 8 * 60 + 15));
+    BOOST_CHECK(masks.IsRestricted(1, MINUTES_PER_WEEK - 1));
+    BOOST_CHECK(!masks.IsRestricted(0, MINUTES_PER_WEEK - 1));
+    // minutes wrap around to the next week
+    BOOST_CHECK(masks.IsRestricted(0, MINUTES_PER_WEEK + 8 * 60));
+
+    BOOST_CHECK(masks.IsTurnRestricted(7, MINUTES_PER_WEEK - 10));
+    BOOST_CHECK(!masks.IsTurnRestricted(7, 12 * 60));
+    BOOST_CHECK(!masks.IsTurnRestricted(3, 8 * 60));
+    BOOST_CHECK(!masks.IsTurnRestricted(8, 8 * 60));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,52 @@
+#include "extractor/intersection_bearings_container.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(intersection_bearings_container)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+std::vector<util::guidance::BearingClass> makeClasses(const std::size_t num_classes)
+{
+    std::vector<util::guidance::BearingClass> classes(num_classes);
+    for (std::size_t id = 0; id < num_classes; ++id)
+    {
+        // one to three sorted bearings
+        for (std::size_t bearing = 0; bearing <= id % 3; ++bearing)
+            classes[id].add(static_cast<DiscreteBearing>(id % 120 + bearing * 120));
+    }
+    return classes;
+}
+
+void checkClasses(const std::size_t num_classes)
+{
+    const auto classes = makeClasses(num_classes);
+    std::vector<BearingClassID> node_to_class_id;
+    for (std::size_t id = 0; id < num_classes; id += 7)
+    {
+        node_to_class_id.push_back(num_classes - 1 - id);
+        node_to_class_id.push_back(id);
+    }
+
+    const IntersectionBearingsContainer container(node_to_class_id, classes);
+    for (std::size_t node = 0; node < node_to_class_id.size(); ++node)
+    {
+        BOOST_CHECK(container.GetBearingClass(node) == classes[node_to_class_id[node]]);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(one_byte_ids) { checkClasses(200); }
+
+BOOST_AUTO_TEST_CASE(two_byte_ids) { checkClasses(300); }
+
+BOOST_AUTO_TEST_CASE(three_byte_ids) { checkClasses(70000); }
+
+BOOST_AUTO_TEST_SUITE_END()
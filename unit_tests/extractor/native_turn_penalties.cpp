@@ -0,0 +1,92 @@
+#include "extractor/native_turn_penalties.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+
+BOOST_AUTO_TEST_SUITE(native_turn_penalties)
+
+using namespace osrm;
+using namespace osrm::extractor;
+using namespace osrm::extractor::guidance;
+
+namespace
+{
+// the parameters of the car profile for right hand driving
+NativeTurnPenalties makeCarPenalties(const std::string &weight_name)
+{
+    ProfileProperties properties;
+    properties.SetWeightName(weight_name);
+    return NativeTurnPenalties(7.5, 1.075, 2, 20, properties);
+}
+
+ExtractionTurn makeTurn(const double angle,
+                        const TurnType::Enum type,
+                        const DirectionModifier::Enum modifier,
+                        const bool has_traffic_light)
+{
+    const ConnectedRoad road{
+        IntersectionViewData{IntersectionShapeData{0, 0, 0}, true, angle}, {type, modifier}, 0};
+    return ExtractionTurn(road, has_traffic_light);
+}
+}
+
+BOOST_AUTO_TEST_CASE(sigmoid_turn_penalty)
+{
+    const auto penalties = makeCarPenalties("routability");
+
+    // straight on, the angle of the turn is 180 - 180 = 0
+    auto straight = makeTurn(180, TurnType::Continue, DirectionModifier::Straight, false);
+    penalties.Apply(straight);
+    BOOST_CHECK_CLOSE(straight.duration, 7.5 / (1 + std::exp(6.5 * 1.075)), 1e-9);
+    BOOST_CHECK_EQUAL(straight.weight, straight.duration);
+
+    // right turns are cheaper than left turns for right hand driving
+    auto right = makeTurn(90, TurnType::Turn, DirectionModifier::Right, false);
+    auto left = makeTurn(270, TurnType::Turn, DirectionModifier::Left, false);
+    penalties.Apply(right);
+    penalties.Apply(left);
+    BOOST_CHECK_CLOSE(right.duration, 7.5 / (1 + std::exp(-(13 / 1.075 * 90 / 180 - 6.5 * 1.075))),
+                      1e-9);
+    BOOST_CHECK_CLOSE(left.duration, 7.5 / (1 + std::exp(-(13 * 1.075 * 90 / 180 - 6.5 / 1.075))),
+                      1e-9);
+    BOOST_CHECK_LT(right.duration, left.duration);
+}
+
+BOOST_AUTO_TEST_CASE(traffic_lights_and_u_turns)
+{
+    const auto penalties = makeCarPenalties("routability");
+
+    auto no_turn = makeTurn(90, TurnType::NoTurn, DirectionModifier::Right, true);
+    penalties.Apply(no_turn);
+    BOOST_CHECK_EQUAL(no_turn.duration, 2);
+
+    auto turn = makeTurn(0, TurnType::Continue, DirectionModifier::UTurn, false);
+    auto u_turn = makeTurn(0, TurnType::Continue, DirectionModifier::UTurn, true);
+    penalties.Apply(turn);
+    penalties.Apply(u_turn);
+    BOOST_CHECK_CLOSE(u_turn.duration, turn.duration + 2, 1e-9);
+    BOOST_CHECK_GT(turn.duration, 20);
+}
+
+BOOST_AUTO_TEST_CASE(weights)
+{
+    auto restricted = makeTurn(90, TurnType::Turn, DirectionModifier::Right, false);
+    restricted.target_restricted = true;
+    const auto routability = makeCarPenalties("routability");
+    routability.Apply(restricted);
+    BOOST_CHECK_EQUAL(restricted.weight, ProfileProperties().GetMaxTurnWeight());
+
+    auto leaving = makeTurn(90, TurnType::Turn, DirectionModifier::Right, false);
+    leaving.source_restricted = true;
+    leaving.target_restricted = true;
+    routability.Apply(leaving);
+    BOOST_CHECK_EQUAL(leaving.weight, leaving.duration);
+
+    auto distance = makeTurn(90, TurnType::Turn, DirectionModifier::Right, true);
+    makeCarPenalties("distance").Apply(distance);
+    BOOST_CHECK_EQUAL(distance.weight, 0);
+    BOOST_CHECK_GT(distance.duration, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
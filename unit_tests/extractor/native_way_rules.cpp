@@ -0,0 +1,102 @@
+#include "extractor/native_way_rules.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(native_way_rules)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+// the tables of the car profile that decide access
+NativeWayRules makeCarRules()
+{
+    NativeWayRules rules;
+    rules.AddRequiredKey("highway");
+    rules.AddRequiredKey("route");
+    rules.AddBlockedTag("area", "yes");
+    rules.AddBlockedTag("oneway", "reversible");
+    rules.AddBlockedTag("highway", "steps");
+    for (const auto highway : {"motorway", "primary", "residential", "service"})
+        rules.AddSpeedTag("highway", highway);
+    rules.AddSpeedTag("route", "ferry");
+    for (const auto key : {"motorcar", "motor_vehicle", "vehicle", "access"})
+        rules.AddAccessKey(key);
+    for (const auto value : {"no", "private", "destination"})
+        rules.AddBlacklistedAccess(value);
+    for (const auto value : {"private", "destination"})
+        rules.AddRestrictedAccess(value);
+    rules.AddRestrictedHighway("residential");
+    return rules;
+}
+
+bool rejects(const NativeWayRules &rules,
+             const std::vector<std::pair<std::string, std::string>> &tags)
+{
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer(1024, osmium::memory::Buffer::auto_grow::yes);
+    osmium::builder::add_way(buffer, _id(1), _tags(tags));
+    return rules.Rejects(buffer.get<osmium::Way>(0).tags());
+}
+}
+
+BOOST_AUTO_TEST_CASE(required_and_blocked_tags)
+{
+    const auto rules = makeCarRules();
+    BOOST_CHECK(!rules.Empty());
+    BOOST_CHECK(NativeWayRules().Empty());
+
+    BOOST_CHECK(rejects(rules, {{"building", "yes"}}));
+    BOOST_CHECK(rejects(rules, {{"highway", ""}, {"name", "Main Street"}}));
+    BOOST_CHECK(!rejects(rules, {{"highway", "primary"}}));
+    BOOST_CHECK(!rejects(rules, {{"route", "ferry"}}));
+
+    BOOST_CHECK(rejects(rules, {{"highway", "primary"}, {"area", "yes"}}));
+    BOOST_CHECK(rejects(rules, {{"highway", "primary"}, {"oneway", "reversible"}}));
+    BOOST_CHECK(rejects(rules, {{"highway", "steps"}, {"access", "yes"}}));
+    BOOST_CHECK(!rejects(rules, {{"highway", "primary"}, {"area", "no"}}));
+}
+
+BOOST_AUTO_TEST_CASE(access_tags)
+{
+    const auto rules = makeCarRules();
+
+    BOOST_CHECK(rejects(rules, {{"highway", "primary"}, {"access", "no"}}));
+    BOOST_CHECK(!rejects(rules, {{"highway", "primary"}, {"access", "no"}, {"motorcar", "yes"}}));
+    // the more specific key is found first
+    BOOST_CHECK(rejects(rules, {{"highway", "primary"}, {"access", "yes"}, {"vehicle", "no"}}));
+
+    // only one direction is blocked
+    BOOST_CHECK(!rejects(rules, {{"highway", "primary"}, {"access:forward", "no"}}));
+    BOOST_CHECK(rejects(
+        rules, {{"highway", "primary"}, {"access:forward", "no"}, {"motorcar:backward", "no"}}));
+    BOOST_CHECK(!rejects(
+        rules, {{"highway", "primary"}, {"access", "no"}, {"vehicle:backward", "yes"}}));
+
+    // restricted access on a restricted highway is routed with a penalty
+    BOOST_CHECK(!rejects(rules, {{"highway", "residential"}, {"access", "private"}}));
+    BOOST_CHECK(rejects(rules, {{"highway", "primary"}, {"access", "private"}}));
+    BOOST_CHECK(rejects(rules, {{"highway", "residential"}, {"access", "no"}}));
+}
+
+BOOST_AUTO_TEST_CASE(speed_tags)
+{
+    const auto rules = makeCarRules();
+
+    BOOST_CHECK(rejects(rules, {{"highway", "footway"}}));
+    BOOST_CHECK(rejects(rules, {{"route", "bus"}}));
+    // the profile assigns a default speed to accessible ways
+    BOOST_CHECK(!rejects(rules, {{"highway", "footway"}, {"motorcar", "yes"}}));
+    BOOST_CHECK(!rejects(rules, {{"highway", "path"}, {"access:backward", "permissive"}}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
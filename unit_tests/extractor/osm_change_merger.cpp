@@ -0,0 +1,120 @@
+#include "extractor/osm_change_merger.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/way.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(osm_change_merger)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+osmium::memory::Buffer makeBuffer()
+{
+    return osmium::memory::Buffer(1024, osmium::memory::Buffer::auto_grow::yes);
+}
+
+void addNode(osmium::memory::Buffer &buffer,
+             const osmium::object_id_type id,
+             const osmium::object_version_type version,
+             const bool visible = true)
+{
+    using namespace osmium::builder::attr;
+    osmium::builder::add_node(buffer, _id(id), _version(version), _visible(visible));
+}
+
+void addWay(osmium::memory::Buffer &buffer,
+            const osmium::object_id_type id,
+            const osmium::object_version_type version,
+            const bool visible = true)
+{
+    using namespace osmium::builder::attr;
+    osmium::builder::add_way(buffer, _id(id), _version(version), _visible(visible));
+}
+
+// type, id and version of all objects of the buffer
+std::vector<std::string> describe(const osmium::memory::Buffer &buffer)
+{
+    std::vector<std::string> objects;
+    for (const auto &object : buffer.select<osmium::OSMObject>())
+    {
+        objects.push_back(std::string(osmium::item_type_to_name(object.type())) +
+                          std::to_string(object.id()) + "v" + std::to_string(object.version()));
+    }
+    return objects;
+}
+
+#define CHECK_OBJECTS(buffer, ...)                                                                 \
+    do                                                                                             \
+    {                                                                                              \
+        const auto objects = describe(buffer);                                                     \
+        const std::vector<std::string> expected = {__VA_ARGS__};                                   \
+        BOOST_CHECK_EQUAL_COLLECTIONS(                                                             \
+            objects.begin(), objects.end(), expected.begin(), expected.end());                     \
+    } while (0)
+}
+
+BOOST_AUTO_TEST_CASE(merge_changes)
+{
+    // two change files: the node 2 is modified twice, node 3 deleted, node 5 and way 2 created
+    auto changes = makeBuffer();
+    addNode(changes, 2, 2);
+    addNode(changes, 3, 2, false);
+    addNode(changes, 5, 1);
+    addWay(changes, 2, 1);
+    addNode(changes, 2, 3);
+    addWay(changes, 7, 1);
+
+    OSMChangeMerger merger(std::move(changes));
+    BOOST_CHECK_EQUAL(merger.GetNumberOfChanges(), 5);
+
+    auto first = makeBuffer();
+    addNode(first, 1, 1);
+    addNode(first, 2, 1);
+    addNode(first, 3, 1);
+    CHECK_OBJECTS(merger.Merge(std::move(first)), "node1v1", "node2v3");
+
+    auto second = makeBuffer();
+    addNode(second, 4, 1);
+    addNode(second, 6, 1);
+    addWay(second, 1, 1);
+    CHECK_OBJECTS(merger.Merge(std::move(second)), "node4v1", "node5v1", "node6v1", "way1v1");
+
+    // no changes up to way 1, the buffer is passed through
+    auto third = makeBuffer();
+    addWay(third, 1, 1);
+    CHECK_OBJECTS(merger.Merge(std::move(third)), "way1v1");
+
+    auto fourth = makeBuffer();
+    addWay(fourth, 3, 1);
+    CHECK_OBJECTS(merger.Merge(std::move(fourth)), "way2v1", "way3v1");
+
+    CHECK_OBJECTS(merger.Finish(), "way7v1");
+}
+
+BOOST_AUTO_TEST_CASE(later_change_file_wins)
+{
+    auto changes = makeBuffer();
+    addNode(changes, 1, 2);
+    addNode(changes, 1, 2, false);
+
+    OSMChangeMerger merger(std::move(changes));
+    BOOST_CHECK_EQUAL(merger.GetNumberOfChanges(), 1);
+
+    auto input = makeBuffer();
+    addNode(input, 1, 1);
+    addNode(input, 2, 1);
+    CHECK_OBJECTS(merger.Merge(std::move(input)), "node2v1");
+    CHECK_OBJECTS(merger.Finish());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
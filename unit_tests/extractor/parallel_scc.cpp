@@ -0,0 +1,142 @@
+#include "extractor/parallel_scc.hpp"
+#include "extractor/tarjan_scc.hpp"
+
+#include "util/static_graph.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(parallel_scc)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+using Graph = util::StaticGraph<void>;
+using InputEdge = util::static_graph_details::SortableEdgeWithData<void>;
+
+Graph makeGraph(const NodeID number_of_nodes, std::vector<InputEdge> edges)
+{
+    std::sort(edges.begin(), edges.end());
+    return Graph(number_of_nodes, edges);
+}
+
+// both have to put the same nodes into components of the same sizes
+void checkSameComponents(const Graph &graph)
+{
+    TarjanSCC<Graph> tarjan(graph);
+    tarjan.Run();
+    ParallelSCC<Graph> parallel(graph);
+    parallel.Run();
+
+    BOOST_REQUIRE_EQUAL(parallel.GetNumberOfComponents(), tarjan.GetNumberOfComponents());
+    BOOST_CHECK_EQUAL(parallel.GetSizeOneCount(), tarjan.GetSizeOneCount());
+
+    std::vector<unsigned> parallel_by_tarjan(tarjan.GetNumberOfComponents(), SPECIAL_NODEID);
+    for (const auto node : util::irange<NodeID>(0, graph.GetNumberOfNodes()))
+    {
+        const auto tarjan_component = tarjan.GetComponentID(node);
+        const auto parallel_component = parallel.GetComponentID(node);
+        if (parallel_by_tarjan[tarjan_component] == SPECIAL_NODEID)
+            parallel_by_tarjan[tarjan_component] = parallel_component;
+        BOOST_REQUIRE_EQUAL(parallel_by_tarjan[tarjan_component], parallel_component);
+        BOOST_REQUIRE_EQUAL(parallel.GetComponentSize(parallel_component),
+                            tarjan.GetComponentSize(tarjan_component));
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(small_graph)
+{
+    // 0 <-> 1 -> 2 <-> 3 -> 4, 5 -> 5, 6
+    std::vector<InputEdge> edges = {
+        {0, 1}, {1, 0}, {1, 2}, {2, 3}, {3, 2}, {3, 4}, {5, 5}};
+    const auto graph = makeGraph(7, edges);
+
+    ParallelSCC<Graph> scc(graph);
+    scc.Run();
+
+    BOOST_CHECK_EQUAL(scc.GetNumberOfComponents(), 5);
+    BOOST_CHECK_EQUAL(scc.GetSizeOneCount(), 3);
+    BOOST_CHECK_EQUAL(scc.GetComponentID(0), scc.GetComponentID(1));
+    BOOST_CHECK_EQUAL(scc.GetComponentID(2), scc.GetComponentID(3));
+    BOOST_CHECK_NE(scc.GetComponentID(1), scc.GetComponentID(2));
+    BOOST_CHECK_EQUAL(scc.GetComponentSize(scc.GetComponentID(0)), 2);
+    BOOST_CHECK_EQUAL(scc.GetComponentSize(scc.GetComponentID(4)), 1);
+    BOOST_CHECK_EQUAL(scc.GetComponentSize(scc.GetComponentID(5)), 1);
+
+    // numbered by the smallest node of each component
+    BOOST_CHECK_EQUAL(scc.GetComponentID(0), 0);
+    BOOST_CHECK_EQUAL(scc.GetComponentID(2), 1);
+    BOOST_CHECK_EQUAL(scc.GetComponentID(4), 2);
+    BOOST_CHECK_EQUAL(scc.GetComponentID(6), 4);
+
+    checkSameComponents(graph);
+}
+
+BOOST_AUTO_TEST_CASE(random_graphs)
+{
+    std::mt19937 generator(42);
+    for (const NodeID number_of_nodes : {10u, 100u, 1000u, 10000u})
+    {
+        for (const auto edges_per_node : {1u, 2u, 3u})
+        {
+            std::uniform_int_distribution<NodeID> node_distribution(0, number_of_nodes - 1);
+            std::vector<InputEdge> edges;
+            for (std::size_t index = 0; index < number_of_nodes * edges_per_node; ++index)
+                edges.push_back({node_distribution(generator), node_distribution(generator)});
+            checkSameComponents(makeGraph(number_of_nodes, edges));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(many_small_components)
+{
+    // enough cycles connected by one-way edges for the coloring rounds to run
+    const NodeID number_of_cycles = 100000;
+    const NodeID cycle_length = 3;
+    std::mt19937 generator(7);
+    std::vector<NodeID> permutation(number_of_cycles * cycle_length);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::shuffle(permutation.begin(), permutation.end(), generator);
+
+    std::vector<InputEdge> edges;
+    std::uniform_int_distribution<NodeID> cycle_distribution(0, number_of_cycles - 1);
+    for (const auto cycle : util::irange<NodeID>(0, number_of_cycles))
+    {
+        const auto first = cycle * cycle_length;
+        for (const auto offset : util::irange<NodeID>(0, cycle_length))
+            edges.push_back({permutation[first + offset],
+                             permutation[first + (offset + 1) % cycle_length]});
+        // only edges to cycles with larger numbers, so no two cycles are merged
+        if (cycle + 1 < number_of_cycles)
+        {
+            const auto other = std::max<NodeID>(cycle + 1, cycle_distribution(generator));
+            edges.push_back({permutation[first], permutation[other * cycle_length]});
+        }
+    }
+    checkSameComponents(makeGraph(number_of_cycles * cycle_length, edges));
+}
+
+BOOST_AUTO_TEST_CASE(chain_of_components)
+{
+    // a chain of cycles from the largest node ids to the smallest, coloring finds one component
+    // per round and hands the rest to TarjanSCC
+    const NodeID number_of_cycles = 60000;
+    std::vector<InputEdge> edges;
+    for (const auto cycle : util::irange<NodeID>(0, number_of_cycles))
+    {
+        const auto first = 2 * cycle;
+        edges.push_back({first, first + 1});
+        edges.push_back({first + 1, first});
+        if (cycle > 0)
+            edges.push_back({first, first - 1});
+    }
+    checkSameComponents(makeGraph(2 * number_of_cycles, edges));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -79,4 +79,56 @@ BOOST_AUTO_TEST_CASE(raster_test)
         util::exception);
 }
 
+BOOST_AUTO_TEST_CASE(tiled_raster_test)
+{
+    const auto tiles_path = boost::filesystem::temp_directory_path() /
+                            boost::filesystem::unique_path("raster_data_%%%%%%.tiles");
+    {
+        // tiles of 3x3 cells, so queries and interpolations cross tile borders
+        const RasterGrid grid(OSRM_FIXTURES_DIR "/raster_data.asc", 10, 10);
+        TiledRasterGrid::Write(tiles_path, grid, 3);
+    }
+
+    {
+        const RasterGrid grid(OSRM_FIXTURES_DIR "/raster_data.asc", 10, 10);
+        const TiledRasterGrid tiled_grid(tiles_path, 4);
+        BOOST_CHECK_EQUAL(tiled_grid.GetWidth(), 10);
+        BOOST_CHECK_EQUAL(tiled_grid.GetHeight(), 10);
+        // column by column, so the tiles of a column evict each other from the cache of 4 tiles
+        for (std::size_t x = 0; x < 10; ++x)
+            for (std::size_t y = 0; y < 10; ++y)
+                BOOST_CHECK_EQUAL(tiled_grid(x, y), grid(x, y));
+        BOOST_CHECK_GT(tiled_grid.GetCacheMisses(), 16);
+        BOOST_CHECK_GT(tiled_grid.GetCacheHits(), 0);
+    }
+
+    SourceContainer sources;
+    int source_id = sources.LoadTiledRasterSource(tiles_path.string(), 1, 1.09, 1, 1.09);
+    BOOST_CHECK_EQUAL(source_id, 0);
+
+    // same results as the raster_test
+    CHECK_QUERY(0, 1.00, 1.00, 10);
+    CHECK_QUERY(0, 1.09, 1.09, 100);
+    CHECK_QUERY(0, 1.09, 1.07, 140);
+    CHECK_QUERY(0, -1.1, 1.07, RasterDatum::get_invalid());
+    CHECK_QUERY(0, 1.08, 1.05, 160);
+    CHECK_QUERY(0, 1.054, 1.023, 40);
+    CHECK_QUERY(0, 1.056, 1.028, 80);
+
+    CHECK_INTERPOLATE(0, 1.00, 1.09, 10);
+    CHECK_INTERPOLATE(0, 1.09, 1.00, 40);
+    CHECK_INTERPOLATE(0, 1.3, 23.0, RasterDatum::get_invalid());
+    CHECK_INTERPOLATE(0, 1.06, 1.06, 100);
+    CHECK_INTERPOLATE(0, 1.054, 1.023, 54);
+    CHECK_INTERPOLATE(0, 1.056, 1.028, 68);
+    CHECK_INTERPOLATE(0, 1.05, 1.028, 56);
+
+    BOOST_CHECK_EQUAL(sources.LoadTiledRasterSource(tiles_path.string(), 1, 1.09, 1, 1.09), 0);
+    BOOST_CHECK_THROW(
+        sources.LoadTiledRasterSource(OSRM_FIXTURES_DIR "/nonexistent.tiles", 0, 1.1, 0, 1.1),
+        util::exception);
+
+    boost::filesystem::remove(tiles_path);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+#include "extractor/restriction_map.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(restriction_map)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+TurnRestriction makeRestriction(NodeID from, NodeID via, NodeID to, bool is_only)
+{
+    TurnRestriction restriction{is_only};
+    restriction.from.node = from;
+    restriction.via.node = via;
+    restriction.to.node = to;
+    return restriction;
+}
+
+void checkRestrictions(const RestrictionMap &restrictions)
+{
+    BOOST_CHECK_EQUAL(restrictions.size(), 4);
+
+    BOOST_CHECK(restrictions.IsViaNode(1));
+    BOOST_CHECK(restrictions.IsViaNode(7));
+    BOOST_CHECK(!restrictions.IsViaNode(0));
+    BOOST_CHECK(!restrictions.IsViaNode(100));
+    BOOST_CHECK(restrictions.IsSourceNode(0));
+    BOOST_CHECK(restrictions.IsSourceNode(6));
+    BOOST_CHECK(!restrictions.IsSourceNode(1));
+    BOOST_CHECK(!restrictions.IsSourceNode(100));
+
+    BOOST_CHECK(restrictions.CheckIfTurnIsRestricted(0, 1, 2));
+    BOOST_CHECK(restrictions.CheckIfTurnIsRestricted(0, 1, 3));
+    BOOST_CHECK(!restrictions.CheckIfTurnIsRestricted(0, 1, 4));
+    BOOST_CHECK(!restrictions.CheckIfTurnIsRestricted(1, 0, 2));
+    BOOST_CHECK(restrictions.CheckIfTurnIsRestricted(4, 1, 0));
+    BOOST_CHECK_EQUAL(restrictions.CheckForEmanatingIsOnlyTurn(0, 1), SPECIAL_NODEID);
+
+    // the only restriction replaced the no restriction of the same start edge
+    BOOST_CHECK(!restrictions.CheckIfTurnIsRestricted(6, 7, 9));
+    BOOST_CHECK(!restrictions.CheckIfTurnIsRestricted(6, 7, 8));
+    BOOST_CHECK_EQUAL(restrictions.CheckForEmanatingIsOnlyTurn(6, 7), 8);
+    BOOST_CHECK_EQUAL(restrictions.CheckForEmanatingIsOnlyTurn(7, 6), SPECIAL_NODEID);
+}
+}
+
+BOOST_AUTO_TEST_CASE(compacted_lookups)
+{
+    const std::vector<TurnRestriction> restriction_list = {makeRestriction(0, 1, 2, false),
+                                                           makeRestriction(6, 7, 9, false),
+                                                           makeRestriction(4, 1, 0, false),
+                                                           makeRestriction(6, 7, 8, true),
+                                                           makeRestriction(0, 1, 3, false),
+                                                           makeRestriction(6, 7, 5, true)};
+
+    RestrictionMap restrictions(restriction_list);
+    checkRestrictions(restrictions);
+
+    restrictions.Compact();
+    checkRestrictions(restrictions);
+}
+
+BOOST_AUTO_TEST_CASE(compacted_empty)
+{
+    RestrictionMap restrictions(std::vector<TurnRestriction>{});
+    restrictions.Compact();
+
+    BOOST_CHECK_EQUAL(restrictions.size(), 0);
+    BOOST_CHECK(!restrictions.IsViaNode(0));
+    BOOST_CHECK(!restrictions.IsSourceNode(0));
+    BOOST_CHECK(!restrictions.CheckIfTurnIsRestricted(0, 1, 2));
+    BOOST_CHECK_EQUAL(restrictions.CheckForEmanatingIsOnlyTurn(0, 1), SPECIAL_NODEID);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,59 @@
+#include "extractor/turn_cost_table.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(turn_cost_table)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+struct Turn
+{
+    NodeID from_id;
+    NodeID via_id;
+    NodeID to_id;
+};
+}
+
+BOOST_AUTO_TEST_CASE(intersection_matrices)
+{
+    //    1
+    //    |
+    // 0--2--3     5--4--6
+    const std::vector<Turn> turns = {{0, 2, 3},
+                                     {4, 5, 4},
+                                     {0, 2, 1},
+                                     {3, 2, 0},
+                                     {1, 2, 3},
+                                     {6, 4, 5},
+                                     {3, 2, 1},
+                                     {0, 2, 3},
+                                     {5, 4, 6}};
+    const std::vector<TurnPenalty> penalties = {0, 200, 50, 0, 30, 0, 20, 10, 0};
+
+    const TurnCostTable table(turns, penalties);
+    BOOST_CHECK_EQUAL(table.GetNumberOfIntersections(), 3);
+
+    // parallel edges keep the cheapest penalty
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(0, 2, 3), 0);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(0, 2, 1), 50);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(3, 2, 0), 0);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(1, 2, 3), 30);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(3, 2, 1), 20);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(4, 5, 4), 200);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(6, 4, 5), 0);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(5, 4, 6), 0);
+
+    // turns that are not in the edge-based graph, e.g. restricted ones
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(1, 2, 0), INVALID_TURN_PENALTY);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(0, 2, 0), INVALID_TURN_PENALTY);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(6, 4, 6), INVALID_TURN_PENALTY);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(0, 3, 2), INVALID_TURN_PENALTY);
+    BOOST_CHECK_EQUAL(table.GetTurnPenalty(7, 2, 3), INVALID_TURN_PENALTY);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
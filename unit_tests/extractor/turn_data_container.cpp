@@ -0,0 +1,41 @@
+#include "extractor/turn_data_container.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(turn_data_container)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+BOOST_AUTO_TEST_CASE(deduplicated_turns)
+{
+    const guidance::TurnInstruction left{guidance::TurnType::Turn,
+                                         guidance::DirectionModifier::Left};
+    const guidance::TurnInstruction straight{guidance::TurnType::NewName,
+                                             guidance::DirectionModifier::Straight};
+    const std::vector<TurnData> turns = {
+        {left, 1, 2, util::guidance::TurnBearing(90), util::guidance::TurnBearing(0)},
+        {straight, INVALID_LANE_DATAID, 3, util::guidance::TurnBearing(180), {}},
+        {left, 1, 2, util::guidance::TurnBearing(90), util::guidance::TurnBearing(0)},
+        {left, 1, 2, util::guidance::TurnBearing(90), util::guidance::TurnBearing(270)}};
+
+    TurnDataContainer container;
+    container.append(turns);
+
+    for (EdgeID id = 0; id < turns.size(); ++id)
+    {
+        BOOST_CHECK(container.GetTurnInstruction(id) == turns[id].turn_instruction);
+        BOOST_CHECK_EQUAL(container.GetLaneDataID(id), turns[id].lane_data_id);
+        BOOST_CHECK_EQUAL(container.GetEntryClassID(id), turns[id].entry_class_id);
+        BOOST_CHECK_EQUAL(container.GetPreTurnBearing(id).Get(),
+                          turns[id].pre_turn_bearing.Get());
+        BOOST_CHECK_EQUAL(container.GetPostTurnBearing(id).Get(),
+                          turns[id].post_turn_bearing.Get());
+    }
+    BOOST_CHECK(container.HasLaneData(0));
+    BOOST_CHECK(!container.HasLaneData(1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
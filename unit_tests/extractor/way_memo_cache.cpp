@@ -0,0 +1,84 @@
+#include "extractor/way_memo_cache.hpp"
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm/way.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(way_memo_cache)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+std::string fingerprint(const WayMemoCache &memo,
+                        const std::vector<std::pair<std::string, std::string>> &tags)
+{
+    using namespace osmium::builder::attr;
+    osmium::memory::Buffer buffer(1024, osmium::memory::Buffer::auto_grow::yes);
+    osmium::builder::add_way(buffer, _id(1), _tags(tags));
+    std::string result;
+    memo.Fingerprint(buffer.get<osmium::Way>(0).tags(), result);
+    return result;
+}
+}
+
+BOOST_AUTO_TEST_CASE(fingerprint_of_the_keys)
+{
+    WayMemoCache memo;
+    BOOST_CHECK(memo.Empty());
+    memo.AddKey("highway");
+    memo.AddKey("surface");
+    BOOST_CHECK(!memo.Empty());
+
+    const auto residential =
+        fingerprint(memo, {{"highway", "residential"}, {"surface", "asphalt"}});
+    // other tags and the order of the tags don't matter
+    BOOST_CHECK_EQUAL(residential,
+                      fingerprint(memo,
+                                  {{"surface", "asphalt"},
+                                   {"note", "resurfaced"},
+                                   {"highway", "residential"}}));
+    BOOST_CHECK(residential != fingerprint(memo, {{"highway", "residential"}}));
+    BOOST_CHECK(residential !=
+                fingerprint(memo, {{"highway", "residential"}, {"surface", "gravel"}}));
+
+    // missing values differ from empty ones and values don't run into the next key
+    BOOST_CHECK(fingerprint(memo, {{"highway", "service"}}) !=
+                fingerprint(memo, {{"highway", "service"}, {"surface", ""}}));
+    BOOST_CHECK(fingerprint(memo, {{"highway", ""}, {"surface", "a"}}) !=
+                fingerprint(memo, {{"highway", "a"}, {"surface", ""}}));
+}
+
+BOOST_AUTO_TEST_CASE(reuse_results)
+{
+    WayMemoCache memo;
+    memo.AddKey("highway");
+    memo.SetMaxEntries(2);
+
+    const auto primary = fingerprint(memo, {{"highway", "primary"}});
+    BOOST_CHECK(memo.Find(primary) == nullptr);
+
+    ExtractionWay result;
+    result.forward_speed = 65;
+    result.name = "Main Street";
+    memo.Insert(primary, result);
+    const auto memoized = memo.Find(primary);
+    BOOST_REQUIRE(memoized != nullptr);
+    BOOST_CHECK_EQUAL(memoized->forward_speed, 65);
+    BOOST_CHECK_EQUAL(memoized->name, "Main Street");
+
+    // a full cache starts over
+    memo.Insert(fingerprint(memo, {{"highway", "secondary"}}), result);
+    BOOST_CHECK(memo.Find(primary) != nullptr);
+    memo.Insert(fingerprint(memo, {{"highway", "tertiary"}}), result);
+    BOOST_CHECK(memo.Find(primary) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/route_parameters.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include "util/json_renderer.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(async)
+
+BOOST_AUTO_TEST_CASE(test_route_async_matches_sync)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    RouteParameters params;
+    params.coordinates = get_locations_in_big_component();
+
+    json::Object expected;
+    const auto rc = osrm.Route(params, expected);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    auto future = osrm.RouteAsync(params);
+    auto result = future.get();
+    BOOST_CHECK(result.status == Status::Ok);
+
+    std::vector<char> expected_text, result_text;
+    util::json::render(expected_text, expected);
+    util::json::render(result_text, result.result);
+    BOOST_CHECK(expected_text == result_text);
+}
+
+BOOST_AUTO_TEST_CASE(test_table_async_callbacks)
+{
+    using namespace osrm;
+
+    std::atomic<int> ok_json{0};
+    std::atomic<int> ok_string{0};
+    {
+        auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+        TableParameters params;
+        params.coordinates = get_locations_in_big_component();
+
+        for (int i = 0; i < 10; ++i)
+        {
+            osrm.TableAsync(params, [&ok_json](Status status, json::Object result) {
+                if (status == Status::Ok &&
+                    result.values.at("code").get<json::String>().value == "Ok")
+                    ++ok_json;
+            });
+            osrm.TableAsync(params, [&ok_string](Status status, std::string result) {
+                if (status == Status::Ok && !result.empty())
+                    ++ok_string;
+            });
+        }
+        // destroying the instance waits for the queued queries
+    }
+
+    BOOST_CHECK_EQUAL(ok_json, 10);
+    BOOST_CHECK_EQUAL(ok_string, 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_route_async_error)
+{
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {OSRM_TEST_DATA_DIR "/ch/monaco.osrm"};
+    config.use_shared_memory = false;
+    config.max_locations_viaroute = 2;
+
+    OSRM osrm{config};
+
+    RouteParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+
+    const auto result = osrm.RouteAsync(params).get();
+    BOOST_CHECK(result.status == Status::Error);
+    BOOST_CHECK_EQUAL(result.result.values.at("code").get<json::String>().value, "TooBig");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
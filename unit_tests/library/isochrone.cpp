@@ -0,0 +1,111 @@
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "coordinates.hpp"
+#include "fixture.hpp"
+
+#include "osrm/isochrone_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+BOOST_AUTO_TEST_SUITE(isochrone)
+
+BOOST_AUTO_TEST_CASE(test_isochrone_response)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {300, 60};
+
+    json::Object result;
+    const auto rc = osrm.Isochrone(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto &waypoints = result.values.at("waypoints").get<json::Array>().values;
+    BOOST_CHECK_EQUAL(waypoints.size(), 1);
+
+    const auto &isochrones = result.values.at("isochrones").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(isochrones.size(), 2);
+
+    for (const auto &isochrone : isochrones)
+    {
+        const auto &isochrone_object = isochrone.get<json::Object>();
+        const auto &geometry = isochrone_object.values.at("geometry").get<json::Object>();
+        BOOST_CHECK_EQUAL(geometry.values.at("type").get<json::String>().value, "Polygon");
+
+        const auto &rings = geometry.values.at("coordinates").get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(rings.size(), 1);
+        const auto &ring = rings.front().get<json::Array>().values;
+        BOOST_REQUIRE(ring.size() >= 2);
+
+        const auto &first = ring.front().get<json::Array>().values;
+        const auto &last = ring.back().get<json::Array>().values;
+        BOOST_CHECK_EQUAL(first[0].get<json::Number>().value, last[0].get<json::Number>().value);
+        BOOST_CHECK_EQUAL(first[1].get<json::Number>().value, last[1].get<json::Number>().value);
+    }
+
+    // contours are returned in the requested order
+    const auto &first_isochrone = isochrones.front().get<json::Object>();
+    BOOST_CHECK_EQUAL(first_isochrone.values.at("duration").get<json::Number>().value, 300);
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_multiple_coordinates)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {60};
+
+    json::Object result;
+    const auto rc = osrm.Isochrone(params, result);
+    BOOST_REQUIRE(rc == Status::Error);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "InvalidOptions");
+}
+
+BOOST_AUTO_TEST_CASE(test_isochrone_mld)
+{
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", osrm::EngineConfig::Algorithm::MLD);
+
+    using namespace osrm;
+
+    IsochroneParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.contours = {60, 300};
+
+    json::Object result;
+    const auto rc = osrm.Isochrone(params, result);
+    BOOST_REQUIRE(rc == Status::Ok);
+
+    const auto code = result.values.at("code").get<json::String>().value;
+    BOOST_CHECK_EQUAL(code, "Ok");
+
+    const auto &isochrones = result.values.at("isochrones").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(isochrones.size(), 2);
+
+    const auto ring_size = [&](const std::size_t index) {
+        const auto &geometry =
+            isochrones[index].get<json::Object>().values.at("geometry").get<json::Object>();
+        const auto &rings = geometry.values.at("coordinates").get<json::Array>().values;
+        return rings.front().get<json::Array>().values.size();
+    };
+    BOOST_CHECK(ring_size(0) >= 2);
+    BOOST_CHECK(ring_size(1) >= 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -13,6 +13,11 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/json_renderer.hpp"
+
+#include <string>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(table)
 
 BOOST_AUTO_TEST_CASE(test_table_three_coords_one_source_one_dest_matrix)
@@ -152,6 +157,46 @@ BOOST_AUTO_TEST_CASE(test_table_three_coordinates_matrix)
 }
 
 // See https://github.com/Project-OSRM/osrm-backend/pull/3992
+BOOST_AUTO_TEST_CASE(test_table_distances_matrix)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.sources.push_back(0);
+    params.annotations = TableParameters::AnnotationsType::Distance;
+
+    json::Object result;
+
+    const auto rc = osrm.Table(params, result);
+
+    BOOST_CHECK(rc == Status::Ok);
+    BOOST_CHECK(result.values.find("durations") == result.values.end());
+
+    // the dummy locations are all the same, the paths between them are empty
+    const auto &distances_array = result.values.at("distances").get<json::Array>().values;
+    BOOST_CHECK_EQUAL(distances_array.size(), params.sources.size());
+    for (const auto &row : distances_array)
+    {
+        const auto &distances = row.get<json::Array>().values;
+        BOOST_CHECK_EQUAL(distances.size(), params.coordinates.size());
+        for (const auto &distance : distances)
+        {
+            BOOST_CHECK_EQUAL(distance.get<json::Number>().value, 0.);
+        }
+    }
+
+    params.annotations = TableParameters::AnnotationsType::All;
+    std::string rendered_result;
+    BOOST_CHECK(osrm.Table(params, rendered_result) == Status::Ok);
+    BOOST_CHECK(rendered_result.find("\"durations\":[[") != std::string::npos);
+    BOOST_CHECK(rendered_result.find("\"distances\":[[0,0,0]]") != std::string::npos);
+}
+
 BOOST_AUTO_TEST_CASE(test_table_no_segment_for_some_coordinates)
 {
     using namespace osrm;
@@ -174,4 +219,39 @@ BOOST_AUTO_TEST_CASE(test_table_no_segment_for_some_coordinates)
     BOOST_CHECK_EQUAL(code, "NoSegment");
 }
 
+BOOST_AUTO_TEST_CASE(test_table_rendered_matches_json)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/ch/monaco.osrm");
+
+    TableParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.sources.push_back(0);
+    params.sources.push_back(2);
+
+    json::Object json_result;
+    BOOST_CHECK(osrm.Table(params, json_result) == Status::Ok);
+
+    std::string rendered_result;
+    BOOST_CHECK(osrm.Table(params, rendered_result) == Status::Ok);
+
+    // the key order of objects isn't fixed, the durations are compared as text
+    std::vector<char> rendered_durations;
+    json::Object durations;
+    durations.values["durations"] = json_result.values.at("durations");
+    util::json::render(rendered_durations, durations);
+    const std::string expected(rendered_durations.begin() + 1, rendered_durations.end() - 1);
+    BOOST_CHECK(rendered_result.find(expected) != std::string::npos);
+    BOOST_CHECK(rendered_result.find("\"code\":\"Ok\"") != std::string::npos);
+    BOOST_CHECK(rendered_result.find("\"sources\":[") != std::string::npos);
+    BOOST_CHECK(rendered_result.find("\"destinations\":[") != std::string::npos);
+
+    params.radiuses = {boost::make_optional(0.), boost::none, boost::none};
+    BOOST_CHECK(osrm.Table(params, rendered_result) == Status::Error);
+    BOOST_CHECK(rendered_result.find("\"code\":\"NoSegment\"") != std::string::npos);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -27,6 +27,8 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
 {
     using StringView = util::StringView;
 
+    util::DistanceOracleView distance_oracle;
+
   public:
     util::Coordinate GetCoordinateOfNode(const NodeID /* id */) const override
     {
@@ -50,40 +52,41 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     {
         return 0;
     }
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID /* id */) const override
+    NodeForwardRange GetUncompressedForwardGeometry(const EdgeID /* id */) const override
     {
         return {};
     }
-    std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID /* id */) const override
+    NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override
     {
-        return {};
+        return NodeReverseRange(GetUncompressedForwardGeometry(id));
     }
-    std::vector<EdgeWeight> GetUncompressedForwardWeights(const EdgeID /* id */) const override
+    WeightForwardRange GetUncompressedForwardWeights(const EdgeID /* id */) const override
     {
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(1);
-        result_weights[0] = 1;
-        return result_weights;
+        // a single segment of weight 1, packed vectors read one word past the last element
+        static std::uint64_t data[] = {1, 0};
+        static const extractor::SegmentDataView::SegmentWeightVector weights(
+            util::vector_view<std::uint64_t>(data, 2), 1);
+        return WeightForwardRange(weights.begin(), weights.end());
     }
-    std::vector<EdgeWeight> GetUncompressedReverseWeights(const EdgeID id) const override
+    WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override
     {
-        return GetUncompressedForwardWeights(id);
+        return WeightReverseRange(GetUncompressedForwardWeights(id));
     }
-    std::vector<EdgeWeight> GetUncompressedForwardDurations(const EdgeID id) const override
+    DurationForwardRange GetUncompressedForwardDurations(const EdgeID id) const override
     {
         return GetUncompressedForwardWeights(id);
     }
-    std::vector<EdgeWeight> GetUncompressedReverseDurations(const EdgeID id) const override
+    DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const override
     {
-        return GetUncompressedForwardWeights(id);
+        return GetUncompressedReverseWeights(id);
     }
-    std::vector<DatasourceID> GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
+    DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
     {
         return {};
     }
-    std::vector<DatasourceID> GetUncompressedReverseDatasources(const EdgeID /*id*/) const override
+    DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const override
     {
-        return {};
+        return DatasourceReverseRange(GetUncompressedForwardDatasources(id));
     }
 
     StringView GetDatasourceName(const DatasourceID) const override final { return {}; }
@@ -193,6 +196,17 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> & /*max_distances*/,
+        const std::vector<boost::optional<engine::Bearing>> & /*bearings*/,
+        const std::vector<boost::optional<engine::Approach>> & /*approaches*/) const override
+    {
+        return std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>(
+            input_coordinates.size());
+    }
+
     unsigned GetCheckSum() const override { return 0; }
 
     extractor::TravelMode GetTravelMode(const NodeID /* id */) const override
@@ -222,6 +236,8 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     unsigned GetWeightPrecision() const override final { return 1; }
     double GetWeightMultiplier() const override final { return 10.; }
     bool IsLeftHandDriving() const override { return false; }
+    bool HasGuidanceData() const override { return true; }
+    const util::DistanceOracleView &GetDistanceOracle() const override { return distance_oracle; }
 
     util::guidance::TurnBearing PreTurnBearing(const EdgeID /*eid*/) const override final
     {
@@ -306,6 +322,23 @@ class MockAlgorithmDataFacade<engine::datafacade::CH>
     {
         return SPECIAL_EDGEID;
     }
+
+    const contractor::DownwardSweepGraph &GetDownwardSweepGraph() const override
+    {
+        return sweep_graph;
+    }
+
+    const contractor::CompressedSearchGraphView &GetCompressedSearchGraph() const override
+    {
+        return compressed_graph;
+    }
+
+    const contractor::HubLabelsView &GetHubLabels() const override { return hub_labels; }
+
+  private:
+    contractor::DownwardSweepGraph sweep_graph;
+    contractor::CompressedSearchGraphView compressed_graph;
+    contractor::HubLabelsView hub_labels;
 };
 
 template <>
@@ -314,9 +347,12 @@ class MockAlgorithmDataFacade<engine::datafacade::CoreCH>
 {
   private:
     EdgeData foo;
+    util::LandmarksView landmarks;
 
   public:
     bool IsCoreNode(const NodeID /* id */) const override { return false; }
+
+    const util::LandmarksView &GetLandmarks() const override { return landmarks; }
 };
 
 template <typename AlgorithmT>
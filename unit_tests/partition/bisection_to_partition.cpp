@@ -387,4 +387,40 @@ BOOST_AUTO_TEST_CASE(non_factor_two_case)
     CHECK_EQUAL_RANGE(reference_l4, partitions[3]);
 }
 
+BOOST_AUTO_TEST_CASE(large_cells)
+{
+    std::vector<Partition> partitions;
+    std::vector<std::uint32_t> num_cells;
+
+    // a permutation of all ids with 18 bits, the top level cells are split block wise
+    const std::uint32_t num_nodes = 1 << 18;
+    std::vector<BisectionID> ids(num_nodes);
+    for (std::uint32_t node = 0; node < num_nodes; ++node)
+        ids[node] = (node * 2654435761u) % num_nodes;
+
+    std::tie(partitions, num_cells) = bisectionToPartition(ids, {1 << 10, 1 << 14});
+    std::vector<std::uint32_t> reference_num_cells = {1 << 8, 1 << 4};
+    CHECK_EQUAL_RANGE(reference_num_cells, num_cells);
+
+    for (std::size_t level = 0; level < partitions.size(); ++level)
+    {
+        const auto cell_bits = level == 0 ? 10 : 14;
+
+        // all nodes of a cell share the bits above the cell size
+        std::vector<std::uint32_t> cell_prefix(num_cells[level], num_nodes);
+        std::vector<std::uint32_t> cell_sizes(num_cells[level], 0);
+        for (std::uint32_t node = 0; node < num_nodes; ++node)
+        {
+            const auto cell = partitions[level][node];
+            BOOST_REQUIRE_LT(cell, num_cells[level]);
+            if (cell_prefix[cell] == num_nodes)
+                cell_prefix[cell] = ids[node] >> cell_bits;
+            BOOST_CHECK_EQUAL(cell_prefix[cell], ids[node] >> cell_bits);
+            ++cell_sizes[cell];
+        }
+        for (const auto size : cell_sizes)
+            BOOST_CHECK_EQUAL(size, 1u << cell_bits);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -326,4 +326,38 @@ BOOST_AUTO_TEST_CASE(immutable_cell_storage)
     CHECK_EQUAL_COLLECTIONS(const_cell_4_0.GetDestinationNodes(), std::vector<EdgeWeight>{});
 }
 
+BOOST_AUTO_TEST_CASE(cell_storage_metrics)
+{
+    // node:                0  1  2  3
+    std::vector<CellID> l1{{0, 0, 1, 1}};
+    std::vector<CellID> l2{{0, 0, 0, 0}};
+    MultiLevelPartition mlp{{l1, l2}, {2, 1}};
+
+    std::vector<MockEdge> edges = {{0, 1}, {1, 2}, {2, 3}, {3, 0}};
+    auto graph = makeGraph(edges);
+
+    CellStorage storage(mlp, graph);
+    BOOST_CHECK_EQUAL(storage.GetNumberOfMetrics(), 1);
+    BOOST_CHECK(storage.GetMetricNames().empty());
+
+    storage.SetMetrics({"default", "truck"});
+    BOOST_CHECK_EQUAL(storage.GetNumberOfMetrics(), 2);
+    const auto names = storage.GetMetricNames();
+    const std::vector<std::string> expected_names{"default", "truck"};
+    CHECK_EQUAL_COLLECTIONS(names, expected_names);
+
+    // node 0 is the only source of cell 0 and node 2 the one of cell 1
+    *storage.GetCell(1, 0, 0).GetOutWeight(0).begin() = 1;
+    *storage.GetCell(1, 0, 1).GetOutWeight(0).begin() = 2;
+
+    const auto &const_storage = storage;
+    CHECK_EQUAL_RANGE(const_storage.GetCell(1, 0).GetOutWeight(0), 1);
+    CHECK_EQUAL_RANGE(const_storage.GetCell(1, 0, 1).GetOutWeight(0), 2);
+    CHECK_EQUAL_RANGE(const_storage.GetCell(1, 1, 1).GetOutWeight(2), INVALID_EDGE_WEIGHT);
+
+    storage.SetMetrics({});
+    BOOST_CHECK_EQUAL(storage.GetNumberOfMetrics(), 1);
+    CHECK_EQUAL_RANGE(const_storage.GetCell(1, 0).GetOutWeight(0), INVALID_EDGE_WEIGHT);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
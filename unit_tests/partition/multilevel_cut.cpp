@@ -0,0 +1,104 @@
+#include "partition/graph_generator.hpp"
+#include "partition/graph_view.hpp"
+#include "partition/multilevel_cut.hpp"
+#include "util/integer_range.hpp"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace osrm::partition;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_SUITE(multilevel_cut)
+
+namespace
+{
+BisectionGraph makeGraph(const std::vector<Coordinate> &coordinates,
+                         std::vector<EdgeWithSomeAdditionalData> edges)
+{
+    groupEdgesBySource(edges.begin(), edges.end());
+    return makeBisectionGraph(coordinates, adaptToBisectionEdge(std::move(edges)));
+}
+
+// the number of edges of the view between the two sides
+std::size_t countCutEdges(const GraphView &view, const std::vector<bool> &flags)
+{
+    std::set<std::pair<NodeID, NodeID>> cut_edges;
+    for (const auto node : irange<NodeID>(0, view.NumberOfNodes()))
+        for (const auto &edge : view.Edges(node))
+            if (flags[node] && !flags[edge.target])
+                cut_edges.insert(std::make_pair(node, edge.target));
+    return cut_edges.size();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(two_grids_with_few_connections)
+{
+    const double step_size = 0.01;
+    const int rows = 40;
+    const int cols = 40;
+    const auto grid_size = static_cast<NodeID>(rows * cols);
+
+    // two grids next to each other, connected by three edges
+    auto coordinates = makeGridCoordinates(rows, cols, step_size, 0, 0);
+    const auto right_coordinates = makeGridCoordinates(rows, cols, step_size, cols * step_size, 0);
+    coordinates.insert(coordinates.end(), right_coordinates.begin(), right_coordinates.end());
+
+    auto edges = makeGridEdges(rows, cols, 0);
+    const auto right_edges = makeGridEdges(rows, cols, grid_size);
+    edges.insert(edges.end(), right_edges.begin(), right_edges.end());
+    for (const auto row : {5, 20, 35})
+    {
+        const auto left = static_cast<NodeID>(row * cols + cols - 1);
+        const auto right = static_cast<NodeID>(grid_size + row * cols);
+        edges.push_back({left, right, 1});
+        edges.push_back({right, left, 1});
+    }
+
+    const auto graph = makeGraph(coordinates, std::move(edges));
+    GraphView view(graph);
+
+    const auto cut = computeMultilevelCut(view, 100, 10, 1.2, 0.25);
+    BOOST_CHECK_EQUAL(cut.num_edges, 3);
+    BOOST_CHECK_EQUAL(cut.num_nodes_source, grid_size);
+    BOOST_CHECK_EQUAL(countCutEdges(view, cut.flags), cut.num_edges);
+
+    // all nodes of a grid are on the same side
+    for (const auto node : irange<NodeID>(0, grid_size))
+    {
+        BOOST_CHECK_EQUAL(cut.flags[node], cut.flags[0]);
+        BOOST_CHECK_NE(cut.flags[grid_size + node], cut.flags[0]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(balanced_cut_through_grid)
+{
+    const double step_size = 0.01;
+    const int rows = 100;
+    const int cols = 60;
+    const auto number_of_nodes = static_cast<std::size_t>(rows * cols);
+
+    const auto graph = makeGraph(makeGridCoordinates(rows, cols, step_size, 0, 0),
+                                 makeGridEdges(rows, cols, 0));
+    GraphView view(graph);
+
+    const double balance = 1.2;
+    const auto cut = computeMultilevelCut(view, 200, 10, balance, 0.25);
+
+    BOOST_CHECK_EQUAL(countCutEdges(view, cut.flags), cut.num_edges);
+    BOOST_CHECK_EQUAL(std::count(cut.flags.begin(), cut.flags.end(), true),
+                      cut.num_nodes_source);
+
+    // the best cut goes straight through the 60 columns
+    BOOST_CHECK_GE(cut.num_edges, cols);
+    BOOST_CHECK_LE(cut.num_edges, cols + cols / 4);
+
+    const auto heavier = std::max(cut.num_nodes_source, number_of_nodes - cut.num_nodes_source);
+    BOOST_CHECK_LE(heavier, balance * number_of_nodes / 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
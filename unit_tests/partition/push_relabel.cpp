@@ -0,0 +1,138 @@
+#include "partition/dinic_max_flow.hpp"
+#include "partition/graph_generator.hpp"
+#include "partition/graph_view.hpp"
+#include "partition/push_relabel_max_flow.hpp"
+#include "util/integer_range.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace osrm::partition;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_SUITE(push_relabel_algorithm)
+
+namespace
+{
+BisectionGraph makeGraph(const std::vector<Coordinate> &coordinates,
+                         std::vector<EdgeWithSomeAdditionalData> edges)
+{
+    groupEdgesBySource(edges.begin(), edges.end());
+    return makeBisectionGraph(coordinates, adaptToBisectionEdge(std::move(edges)));
+}
+
+// both algorithms find a minimum cut, the push-relabel cut contains the one of Dinic
+void checkSameCut(const GraphView &view,
+                  const DinicMaxFlow::SourceSinkNodes &sources,
+                  const DinicMaxFlow::SourceSinkNodes &sinks)
+{
+    const auto dinic_cut = DinicMaxFlow()(view, sources, sinks);
+    const auto cut = PushRelabelMaxFlow()(view, sources, sinks);
+
+    BOOST_CHECK_EQUAL(cut.num_edges, dinic_cut.num_edges);
+    BOOST_CHECK_GE(cut.num_nodes_source, dinic_cut.num_nodes_source);
+    BOOST_REQUIRE_EQUAL(cut.flags.size(), view.NumberOfNodes());
+    BOOST_CHECK_EQUAL(std::count(cut.flags.begin(), cut.flags.end(), true),
+                      cut.num_nodes_source);
+
+    for (const auto node : sources)
+        BOOST_CHECK(cut.flags[node]);
+    for (const auto node : sinks)
+        BOOST_CHECK(!cut.flags[node]);
+
+    std::set<std::pair<NodeID, NodeID>> cut_edges;
+    for (const auto node : irange<NodeID>(0, view.NumberOfNodes()))
+    {
+        if (dinic_cut.flags[node])
+            BOOST_CHECK(cut.flags[node]);
+        for (const auto &edge : view.Edges(node))
+            if (cut.flags[node] && !cut.flags[edge.target])
+                cut_edges.insert(std::make_pair(node, edge.target));
+    }
+    BOOST_CHECK_EQUAL(cut_edges.size(), cut.num_edges);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(horizontal_cut_between_two_grids)
+{
+    const double step_size = 0.01;
+    const int rows = 10;
+    const int cols = 10;
+
+    std::vector<Coordinate> coordinates = makeGridCoordinates(rows, cols, step_size, 0, 0);
+    std::vector<EdgeWithSomeAdditionalData> edges = makeGridEdges(rows, cols, 0);
+
+    const auto large_coordinates =
+        makeGridCoordinates(10 * rows, cols, step_size, 0, rows * step_size);
+    coordinates.insert(coordinates.end(), large_coordinates.begin(), large_coordinates.end());
+    const auto large_edges = makeGridEdges(10 * rows, cols, rows * cols);
+    edges.insert(edges.end(), large_edges.begin(), large_edges.end());
+
+    for (const auto pair : {std::make_pair(45, 1001),
+                            std::make_pair(55, 800),
+                            std::make_pair(65, 600),
+                            std::make_pair(75, 200)})
+    {
+        edges.push_back({static_cast<NodeID>(pair.first), static_cast<NodeID>(pair.second), 1});
+        edges.push_back({static_cast<NodeID>(pair.second), static_cast<NodeID>(pair.first), 1});
+    }
+
+    const auto graph = makeGraph(coordinates, std::move(edges));
+    GraphView view(graph);
+
+    DinicMaxFlow::SourceSinkNodes sources, sinks;
+    for (int i = 0; i < 10; ++i)
+    {
+        sources.insert(static_cast<NodeID>(i));
+        sinks.insert(static_cast<NodeID>(1000 + i));
+    }
+
+    const auto cut = PushRelabelMaxFlow()(view, sources, sinks);
+    BOOST_CHECK_EQUAL(cut.num_edges, 4);
+    // everything but the large grid, which is reached through the four connections
+    BOOST_CHECK_EQUAL(cut.num_nodes_source, rows * cols);
+
+    checkSameCut(view, sources, sinks);
+}
+
+BOOST_AUTO_TEST_CASE(random_grids)
+{
+    std::mt19937 generator(17);
+    const double step_size = 0.01;
+    for (const int size : {10, 50, 150})
+    {
+        const auto number_of_nodes = static_cast<NodeID>(size * size);
+        const auto coordinates = makeGridCoordinates(size, size, step_size, 0, 0);
+        auto edges = makeGridEdges(size, size, 0);
+
+        // random shortcuts and duplicated edges through the grid
+        std::uniform_int_distribution<NodeID> node_distribution(0, number_of_nodes - 1);
+        for (NodeID index = 0; index < number_of_nodes / 4; ++index)
+        {
+            const auto from = node_distribution(generator);
+            const auto to = node_distribution(generator);
+            edges.push_back({from, to, 1});
+            edges.push_back({to, from, 1});
+        }
+
+        const auto graph = makeGraph(coordinates, std::move(edges));
+        GraphView view(graph);
+
+        // the lowest and the highest rows of the grid
+        DinicMaxFlow::SourceSinkNodes sources, sinks;
+        for (const auto node : irange<NodeID>(0, number_of_nodes / 4))
+        {
+            sources.insert(node);
+            sinks.insert(number_of_nodes - 1 - node);
+        }
+
+        checkSameCut(view, sources, sinks);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
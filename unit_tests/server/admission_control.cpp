@@ -0,0 +1,73 @@
+#include "server/admission_control.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(admission_control)
+
+using namespace osrm;
+using namespace osrm::server;
+
+BOOST_AUTO_TEST_CASE(unlimited_services)
+{
+    AdmissionControl control({{"table", ServiceLimits{1, 0}}}, std::chrono::milliseconds(0));
+
+    const auto first = control.Admit("route");
+    const auto second = control.Admit("route");
+    BOOST_CHECK(first);
+    BOOST_CHECK(second);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_over_limit)
+{
+    AdmissionControl control({{"table", ServiceLimits{2, 0}}}, std::chrono::milliseconds(0));
+
+    {
+        const auto first = control.Admit("table");
+        const auto second = control.Admit("table");
+        BOOST_CHECK(first);
+        BOOST_CHECK(second);
+        BOOST_CHECK(!control.Admit("table"));
+        BOOST_CHECK(control.Admit("nearest"));
+    }
+
+    // the slots are released with the tickets
+    BOOST_CHECK(control.Admit("table"));
+    const auto metrics = control.DumpPrometheus();
+    BOOST_CHECK(metrics.find("osrm_rejected_requests_total{service=\"table\"} 1") !=
+                std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(queued_requests)
+{
+    AdmissionControl control({{"table", ServiceLimits{1, 1}}}, std::chrono::milliseconds(5000));
+
+    auto running = std::make_unique<AdmissionControl::Ticket>(control.Admit("table"));
+    BOOST_CHECK(*running);
+
+    auto queued =
+        std::async(std::launch::async, [&control] { return bool(control.Admit("table")); });
+    // give the request time to queue, it is admitted once the running one is finished
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    running.reset();
+    BOOST_CHECK(queued.get());
+}
+
+BOOST_AUTO_TEST_CASE(queue_timeout)
+{
+    AdmissionControl control({{"table", ServiceLimits{1, 1}}}, std::chrono::milliseconds(10));
+
+    const auto running = control.Admit("table");
+    BOOST_CHECK(running);
+
+    const auto start = std::chrono::steady_clock::now();
+    BOOST_CHECK(!control.Admit("table"));
+    BOOST_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,160 @@
+#include "server/api/body_parser.hpp"
+#include "server/api/parameters_parser.hpp"
+
+#include "engine/api/match_parameters.hpp"
+#include "engine/api/route_parameters.hpp"
+#include "engine/api/table_parameters.hpp"
+#include "engine/hint.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(body_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+const constexpr char HINT[] = "ZgYAgP___38EAAAAIAAAAD4AAAAdAAAABAAAACAAAAA-"
+                              "AAAAHQAAABQAAABqaHEAt4KbAjtocQDLgpsCBQAPAJDIe3E=";
+}
+
+BOOST_AUTO_TEST_CASE(json_body)
+{
+    api::BodyParameters body;
+    BOOST_REQUIRE(api::parseJSONBody(
+        std::string(R"({"coordinates": [[7.41,43.73], [7.42,43.74]], "sources": [0],)") +
+            R"( "destinations": [1, 0], "hints": [")" + HINT + R"(", null],)" +
+            R"( "radiuses": ["unlimited", 20.5], "bearings": [[0,20], null],)" +
+            R"( "approaches": [null, "curb"]})",
+        body));
+
+    const auto &base = body.base;
+    BOOST_REQUIRE_EQUAL(base.coordinates.size(), 2);
+    BOOST_CHECK_EQUAL(base.coordinates[0],
+                      util::Coordinate(util::FloatLongitude{7.41}, util::FloatLatitude{43.73}));
+    BOOST_CHECK_EQUAL(base.coordinates[1],
+                      util::Coordinate(util::FloatLongitude{7.42}, util::FloatLatitude{43.74}));
+    BOOST_REQUIRE_EQUAL(base.hints.size(), 2);
+    BOOST_CHECK(base.hints[0] && base.hints[0]->ToBase64() == HINT);
+    BOOST_CHECK(!base.hints[1]);
+    BOOST_REQUIRE_EQUAL(base.radiuses.size(), 2);
+    BOOST_CHECK(std::isinf(*base.radiuses[0]));
+    BOOST_CHECK_EQUAL(*base.radiuses[1], 20.5);
+    BOOST_REQUIRE_EQUAL(base.bearings.size(), 2);
+    BOOST_CHECK_EQUAL(base.bearings[0]->bearing, 0);
+    BOOST_CHECK_EQUAL(base.bearings[0]->range, 20);
+    BOOST_CHECK(!base.bearings[1]);
+    BOOST_REQUIRE_EQUAL(base.approaches.size(), 2);
+    BOOST_CHECK(!base.approaches[0]);
+    BOOST_CHECK(*base.approaches[1] == engine::Approach::CURB);
+    BOOST_CHECK_EQUAL(body.sources.size(), 1);
+    BOOST_CHECK_EQUAL(body.destinations.size(), 2);
+    BOOST_CHECK_EQUAL(body.destinations[0], 1);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_json_body)
+{
+    const auto parses = [](const std::string &text) {
+        api::BodyParameters body;
+        return api::parseJSONBody(text, body);
+    };
+    BOOST_CHECK(!parses("[[1,2]]"));
+    BOOST_CHECK(!parses(R"({"sources": [0]})"));
+    BOOST_CHECK(!parses(R"({"coordinates": []})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2]], "sources": {"a": 0}})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2]], "sources": [-1]})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2,3]]})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2]], "bearings": [[0.5,10]]})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2]], "hints": ["abc"]})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2]], "annotations": "distance"})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2]], "coordinates": [[3,4]]})"));
+    BOOST_CHECK(!parses(R"({"coordinates": [[1,2)"));
+    BOOST_CHECK(!parses(std::string(R"({"coordinates": [[1,2]]})") + '\0' + "x"));
+}
+
+BOOST_AUTO_TEST_CASE(binary_body)
+{
+    const std::int32_t values[] = {7410000, 43730000, -7420000, -43740000};
+    std::string data(reinterpret_cast<const char *>(values), sizeof(values));
+
+    api::BodyParameters body;
+    BOOST_REQUIRE(api::parseBinaryBody(data, body));
+    BOOST_REQUIRE_EQUAL(body.base.coordinates.size(), 2);
+    BOOST_CHECK_EQUAL(body.base.coordinates[1],
+                      util::Coordinate(util::FloatLongitude{-7.42}, util::FloatLatitude{-43.74}));
+
+    api::BodyParameters truncated;
+    BOOST_CHECK(!api::parseBinaryBody(data.substr(0, 12), truncated));
+    BOOST_CHECK(!api::parseBinaryBody("", truncated));
+}
+
+BOOST_AUTO_TEST_CASE(body_into_parameters)
+{
+    boost::optional<api::BodyParameters> body = api::BodyParameters{};
+    BOOST_REQUIRE(api::parseJSONBody(
+        R"({"coordinates": [[1,2], [3,4], [5,6]], "sources": [0], "radiuses": [1, null, 2]})",
+        *body));
+
+    std::string query = "?annotations=distance";
+    auto iter = query.begin();
+    const auto table =
+        api::parseParameters<engine::api::TableParameters>(body, iter, query.end());
+    BOOST_REQUIRE(table);
+    BOOST_CHECK_EQUAL(table->coordinates.size(), 3);
+    BOOST_CHECK_EQUAL(table->radiuses.size(), 3);
+    BOOST_CHECK_EQUAL(table->sources.size(), 1);
+    BOOST_CHECK(table->destinations.empty());
+    BOOST_CHECK(table->annotations == engine::api::TableParameters::AnnotationsType::Distance);
+
+    // coordinates are either in the body or in the URL
+    body = api::BodyParameters{};
+    BOOST_REQUIRE(api::parseJSONBody(R"({"coordinates": [[1,2], [3,4]]})", *body));
+    query = "1,2;3,4";
+    iter = query.begin();
+    BOOST_CHECK(!api::parseParameters<engine::api::RouteParameters>(body, iter, query.end()));
+
+    // only tables have sources
+    body = api::BodyParameters{};
+    BOOST_REQUIRE(
+        api::parseJSONBody(R"({"coordinates": [[1,2], [3,4]], "sources": [0]})", *body));
+    query = "";
+    iter = query.begin();
+    BOOST_CHECK(!api::parseParameters<engine::api::RouteParameters>(body, iter, query.end()));
+}
+
+BOOST_AUTO_TEST_CASE(body_query)
+{
+    api::BodyParameters body;
+    BOOST_REQUIRE(api::parseJSONBody(
+        std::string(R"({"coordinates": [[7.41,43.73], [7.42,43.74]], "hints": [")") + HINT +
+            R"(", null], "bearings": [[0,20], null], "sources": [0]})",
+        body));
+
+    std::string query = ".json?annotations=distance";
+    api::prependBodyQuery(body, query);
+    BOOST_CHECK_EQUAL(query,
+                      "7.410000,43.730000;7.420000,43.740000.json?hints=" + std::string(HINT) +
+                          ";&bearings=0,20;&sources=0&annotations=distance");
+
+    // the query parses to the same parameters as the body
+    auto iter = query.begin();
+    const auto table = api::parseParameters<engine::api::TableParameters>(iter, query.end());
+    BOOST_REQUIRE(table);
+    BOOST_CHECK_EQUAL(table->coordinates.size(), 2);
+    BOOST_CHECK_EQUAL(table->hints.size(), 2);
+    BOOST_CHECK_EQUAL(table->sources.size(), 1);
+
+    query.clear();
+    api::BodyParameters coordinates_only;
+    coordinates_only.base.coordinates = body.base.coordinates;
+    api::prependBodyQuery(coordinates_only, query);
+    BOOST_CHECK_EQUAL(query, "7.410000,43.730000;7.420000,43.740000");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,170 @@
+#include "server/http/compressor.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <zlib.h>
+
+#ifdef OSRM_HAVE_BROTLI
+#include <brotli/decode.h>
+#endif
+
+#ifdef OSRM_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(compressor)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+std::string toString(const util::BufferChain &chain)
+{
+    std::string data;
+    for (std::size_t index = 0; index < chain.buffer_count(); ++index)
+    {
+        data.append(chain.buffer_data(index), chain.buffer_size(index));
+    }
+    return data;
+}
+
+std::string makeData()
+{
+    std::string data;
+    for (int i = 0; i < 200000; ++i)
+    {
+        data += std::to_string(i * 7919 % 100003) + ",";
+    }
+    return data;
+}
+
+void compress(http::Compressor &compressor, const std::string &data)
+{
+    // written in pieces like the consumer of a BufferChain
+    for (std::size_t offset = 0; offset < data.size(); offset += 10000)
+    {
+        compressor.write(data.data() + offset, std::min<std::size_t>(10000, data.size() - offset));
+    }
+    compressor.finish();
+}
+
+std::string decompress(const util::BufferChain &chain, const int window_bits)
+{
+    auto compressed = toString(chain);
+
+    z_stream stream{};
+    BOOST_REQUIRE(inflateInit2(&stream, window_bits) == Z_OK);
+    stream.next_in = reinterpret_cast<Bytef *>(&compressed[0]);
+    stream.avail_in = static_cast<uInt>(compressed.size());
+
+    std::string result;
+    std::vector<char> buffer(4096);
+    int status;
+    do
+    {
+        stream.next_out = reinterpret_cast<Bytef *>(buffer.data());
+        stream.avail_out = static_cast<uInt>(buffer.size());
+        status = inflate(&stream, Z_NO_FLUSH);
+        BOOST_REQUIRE(status == Z_OK || status == Z_STREAM_END);
+        result.append(buffer.data(), buffer.size() - stream.avail_out);
+    } while (status != Z_STREAM_END);
+    inflateEnd(&stream);
+    return result;
+}
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    const auto data = makeData();
+
+    for (const auto type : {http::gzip_rfc1952, http::deflate_rfc1951})
+    {
+        util::BufferChain output;
+        http::Compressor compressor(type, http::CompressionConfig{}, output);
+        compress(compressor, data);
+
+        BOOST_CHECK_LT(output.size(), data.size());
+        const auto window_bits = type == http::gzip_rfc1952 ? MAX_WBITS + 16 : -MAX_WBITS;
+        BOOST_CHECK(decompress(output, window_bits) == data);
+    }
+}
+
+#ifdef OSRM_HAVE_BROTLI
+BOOST_AUTO_TEST_CASE(round_trip_brotli)
+{
+    const auto data = makeData();
+
+    util::BufferChain output;
+    http::Compressor compressor(http::brotli_rfc7932, http::CompressionConfig{}, output);
+    compress(compressor, data);
+    BOOST_CHECK_LT(output.size(), data.size());
+
+    const auto compressed = toString(output);
+    std::string result(data.size(), '\0');
+    std::size_t result_size = result.size();
+    BOOST_REQUIRE(BrotliDecoderDecompress(compressed.size(),
+                                          reinterpret_cast<const std::uint8_t *>(compressed.data()),
+                                          &result_size,
+                                          reinterpret_cast<std::uint8_t *>(&result[0])) ==
+                  BROTLI_DECODER_RESULT_SUCCESS);
+    result.resize(result_size);
+    BOOST_CHECK(result == data);
+}
+#endif
+
+#ifdef OSRM_HAVE_ZSTD
+BOOST_AUTO_TEST_CASE(round_trip_zstd)
+{
+    const auto data = makeData();
+
+    // twice, the second reply reuses the context of the thread
+    for (int round = 0; round < 2; ++round)
+    {
+        util::BufferChain output;
+        http::Compressor compressor(http::zstd_rfc8878, http::CompressionConfig{}, output);
+        compress(compressor, data);
+        BOOST_CHECK_LT(output.size(), data.size());
+
+        const auto compressed = toString(output);
+        std::string result(data.size() + 1, '\0');
+        auto context = ZSTD_createDCtx();
+        ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+        ZSTD_outBuffer result_buffer = {&result[0], result.size(), 0};
+        const auto remaining = ZSTD_decompressStream(context, &result_buffer, &input);
+        ZSTD_freeDCtx(context);
+        BOOST_REQUIRE(!ZSTD_isError(remaining));
+        BOOST_CHECK_EQUAL(remaining, 0);
+        result.resize(result_buffer.pos);
+        BOOST_CHECK(result == data);
+    }
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(select_compression)
+{
+    BOOST_CHECK_EQUAL(http::selectCompression(""), http::no_compression);
+    BOOST_CHECK_EQUAL(http::selectCompression("identity"), http::no_compression);
+    BOOST_CHECK_EQUAL(http::selectCompression("deflate"), http::deflate_rfc1951);
+    BOOST_CHECK_EQUAL(http::selectCompression("deflate, gzip"), http::gzip_rfc1952);
+    BOOST_CHECK_EQUAL(http::selectCompression("GZIP;q=0.5, deflate"), http::gzip_rfc1952);
+    BOOST_CHECK_EQUAL(http::selectCompression("gzip;q=0, deflate"), http::deflate_rfc1951);
+    BOOST_CHECK_EQUAL(http::selectCompression("gzip; q=0.0"), http::no_compression);
+    // not a substring match
+    BOOST_CHECK_EQUAL(http::selectCompression("x-gzipped"), http::no_compression);
+
+#ifdef OSRM_HAVE_BROTLI
+    BOOST_CHECK_EQUAL(http::selectCompression("gzip, deflate, br"), http::brotli_rfc7932);
+#else
+    BOOST_CHECK_EQUAL(http::selectCompression("gzip, deflate, br"), http::gzip_rfc1952);
+#endif
+#ifdef OSRM_HAVE_ZSTD
+    BOOST_CHECK_EQUAL(http::selectCompression("br, zstd, gzip"), http::zstd_rfc8878);
+    BOOST_CHECK_EQUAL(http::selectCompression("zstd;q=0, gzip"), http::gzip_rfc1952);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
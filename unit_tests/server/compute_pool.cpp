@@ -0,0 +1,68 @@
+#include "server/compute_pool.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(compute_pool)
+
+using namespace osrm;
+using namespace osrm::server;
+
+BOOST_AUTO_TEST_CASE(runs_all_tasks)
+{
+    ComputePool pool(2);
+
+    std::atomic<int> finished{0};
+    for (int i = 0; i < 100; ++i)
+    {
+        pool.Enqueue(i % 2 == 0 ? ComputePriority::High : ComputePriority::Low,
+                     [&finished] { ++finished; });
+    }
+    pool.Wait();
+
+    BOOST_CHECK_EQUAL(finished, 100);
+}
+
+BOOST_AUTO_TEST_CASE(high_priority_first)
+{
+    ComputePool pool(1);
+
+    std::mutex lock;
+    std::vector<int> order;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        // holds up the only slot of the pool if it starts before all other tasks are queued
+        pool.Enqueue(ComputePriority::Low, [&] { std::lock_guard<std::mutex> task_guard(lock); });
+        pool.Enqueue(ComputePriority::Low, [&] {
+            std::lock_guard<std::mutex> task_guard(lock);
+            order.push_back(1);
+        });
+        pool.Enqueue(ComputePriority::Low, [&] {
+            std::lock_guard<std::mutex> task_guard(lock);
+            order.push_back(2);
+        });
+        pool.Enqueue(ComputePriority::High, [&] {
+            std::lock_guard<std::mutex> task_guard(lock);
+            order.push_back(0);
+        });
+    }
+    pool.Wait();
+
+    const std::vector<int> expected{0, 1, 2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(priority_of_services)
+{
+    BOOST_CHECK(ComputePool::GetPriority("route") == ComputePriority::High);
+    BOOST_CHECK(ComputePool::GetPriority("nearest") == ComputePriority::High);
+    BOOST_CHECK(ComputePool::GetPriority("tile") == ComputePriority::High);
+    BOOST_CHECK(ComputePool::GetPriority("table") == ComputePriority::Low);
+    BOOST_CHECK(ComputePool::GetPriority("match") == ComputePriority::Low);
+    BOOST_CHECK(ComputePool::GetPriority("trip") == ComputePriority::Low);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+#include "server/api/coordinate_list_parser.hpp"
+#include "server/api/parameters_parser.hpp"
+
+#include "engine/api/route_parameters.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(coordinate_list_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+using namespace osrm::server::api;
+
+namespace
+{
+// returns the number of consumed characters or -1 if the list is not handled
+int parse(const std::string &input, std::vector<util::Coordinate> &coordinates)
+{
+    auto iter = input.begin();
+    if (!parseCoordinateList(iter, input.end(), coordinates))
+    {
+        BOOST_CHECK(iter == input.begin());
+        return -1;
+    }
+    return static_cast<int>(iter - input.begin());
+}
+}
+
+BOOST_AUTO_TEST_CASE(valid_lists)
+{
+    std::vector<util::Coordinate> coordinates;
+    BOOST_CHECK_EQUAL(parse("1,2;-13.388860,52.517037;+0.5,-90", coordinates), 33);
+    const std::vector<util::Coordinate> expected = {
+        {util::FloatLongitude{1}, util::FloatLatitude{2}},
+        {util::FloatLongitude{-13.388860}, util::FloatLatitude{52.517037}},
+        {util::FloatLongitude{0.5}, util::FloatLatitude{-90}}};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        coordinates.begin(), coordinates.end(), expected.begin(), expected.end());
+
+    coordinates.clear();
+    BOOST_CHECK_EQUAL(parse("1,2;3,4?steps=true", coordinates), 7);
+    BOOST_CHECK_EQUAL(coordinates.size(), 2);
+
+    coordinates.clear();
+    BOOST_CHECK_EQUAL(parse("1,2;3,4.json", coordinates), 7);
+    BOOST_CHECK_EQUAL(coordinates.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(unhandled_lists)
+{
+    const std::vector<util::Coordinate> initial = {
+        {util::FloatLongitude{1}, util::FloatLatitude{2}}};
+    for (const std::string input : {"1.1234567,2",
+                                    "1000,2",
+                                    "1.,2",
+                                    "1,2;",
+                                    "1,2;3",
+                                    "1;2",
+                                    "1,2,3",
+                                    ",2",
+                                    "1,2;3,4.xml",
+                                    "polyline(_ibE_seK_seK_seK)",
+                                    ""})
+    {
+        auto coordinates = initial;
+        BOOST_CHECK_EQUAL(parse(input, coordinates), -1);
+        BOOST_CHECK_EQUAL_COLLECTIONS(
+            coordinates.begin(), coordinates.end(), initial.begin(), initial.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(same_as_grammar)
+{
+    // the fast path is skipped for the number with seven decimals
+    for (const std::string query : {"1.123456,-2.5;179.999999,89.000001", "1.1234567,-2.5"})
+    {
+        std::vector<util::Coordinate> coordinates;
+        const auto handled = parse(query, coordinates) > 0;
+
+        const auto parameters = parseParameters<engine::api::RouteParameters>(query);
+        BOOST_REQUIRE(parameters);
+        if (handled)
+        {
+            BOOST_CHECK_EQUAL_COLLECTIONS(coordinates.begin(),
+                                          coordinates.end(),
+                                          parameters->coordinates.begin(),
+                                          parameters->coordinates.end());
+        }
+        else
+        {
+            BOOST_CHECK_EQUAL(parameters->coordinates.size(), 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
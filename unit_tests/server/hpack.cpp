@@ -0,0 +1,220 @@
+#include "server/http/hpack.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(hpack)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+std::string fromHex(const std::string &hex)
+{
+    std::string data;
+    for (std::size_t index = 0; index + 1 < hex.size(); index += 2)
+    {
+        data.push_back(static_cast<char>(std::stoi(hex.substr(index, 2), nullptr, 16)));
+    }
+    return data;
+}
+
+using Headers = std::vector<std::pair<std::string, std::string>>;
+
+Headers decode(http::HPackDecoder &decoder, const std::string &hex)
+{
+    const auto block = fromHex(hex);
+    std::vector<http::header> headers;
+    BOOST_REQUIRE(decoder.Decode(block.data(), block.data() + block.size(), headers));
+    Headers pairs;
+    for (const auto &header : headers)
+    {
+        pairs.emplace_back(header.name, header.value);
+    }
+    return pairs;
+}
+
+void checkHeaders(const Headers &headers, const Headers &expected)
+{
+    BOOST_REQUIRE_EQUAL(headers.size(), expected.size());
+    for (std::size_t index = 0; index < headers.size(); ++index)
+    {
+        BOOST_CHECK_EQUAL(headers[index].first, expected[index].first);
+        BOOST_CHECK_EQUAL(headers[index].second, expected[index].second);
+    }
+}
+}
+
+// RFC 7541 C.1
+BOOST_AUTO_TEST_CASE(integers)
+{
+    std::string encoded;
+    http::detail::EncodeInteger(10, 5, 0x00, encoded);
+    BOOST_CHECK_EQUAL(encoded, fromHex("0a"));
+    encoded.clear();
+    http::detail::EncodeInteger(1337, 5, 0x00, encoded);
+    BOOST_CHECK_EQUAL(encoded, fromHex("1f9a0a"));
+    encoded.clear();
+    http::detail::EncodeInteger(42, 8, 0x00, encoded);
+    BOOST_CHECK_EQUAL(encoded, fromHex("2a"));
+
+    const auto data = fromHex("1f9a0a");
+    const char *begin = data.data();
+    std::uint64_t value;
+    BOOST_CHECK(http::detail::DecodeInteger(begin, data.data() + data.size(), 5, value));
+    BOOST_CHECK_EQUAL(value, 1337);
+    BOOST_CHECK(begin == data.data() + data.size());
+
+    // the continuation bytes end too early or never
+    const auto truncated = fromHex("1f9a");
+    begin = truncated.data();
+    BOOST_CHECK(!http::detail::DecodeInteger(begin, truncated.data() + truncated.size(), 5, value));
+    const auto overflow = fromHex("1fffffffffffffffffff7f");
+    begin = overflow.data();
+    BOOST_CHECK(!http::detail::DecodeInteger(begin, overflow.data() + overflow.size(), 5, value));
+}
+
+BOOST_AUTO_TEST_CASE(huffman)
+{
+    std::string decoded;
+    const auto encoded = fromHex("f1e3c2e5f23a6ba0ab90f4ff");
+    BOOST_CHECK(
+        http::detail::DecodeHuffman(encoded.data(), encoded.data() + encoded.size(), decoded));
+    BOOST_CHECK_EQUAL(decoded, "www.example.com");
+
+    // padding longer than 7 bits and padding with zeros are rejected
+    decoded.clear();
+    const auto long_padding = fromHex("f1e3c2e5f23a6ba0ab90f4ffff");
+    BOOST_CHECK(!http::detail::DecodeHuffman(
+        long_padding.data(), long_padding.data() + long_padding.size(), decoded));
+    decoded.clear();
+    const auto zero_padding = fromHex("f1e3c2e5f23a6ba0ab90f4fe");
+    BOOST_CHECK(!http::detail::DecodeHuffman(
+        zero_padding.data(), zero_padding.data() + zero_padding.size(), decoded));
+}
+
+// RFC 7541 C.3
+BOOST_AUTO_TEST_CASE(requests_without_huffman)
+{
+    http::HPackDecoder decoder;
+    checkHeaders(decode(decoder, "828684410f7777772e6578616d706c652e636f6d"),
+                 {{":method", "GET"},
+                  {":scheme", "http"},
+                  {":path", "/"},
+                  {":authority", "www.example.com"}});
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 57);
+    checkHeaders(decode(decoder, "828684be58086e6f2d6361636865"),
+                 {{":method", "GET"},
+                  {":scheme", "http"},
+                  {":path", "/"},
+                  {":authority", "www.example.com"},
+                  {"cache-control", "no-cache"}});
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 110);
+    checkHeaders(decode(decoder, "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565"),
+                 {{":method", "GET"},
+                  {":scheme", "https"},
+                  {":path", "/index.html"},
+                  {":authority", "www.example.com"},
+                  {"custom-key", "custom-value"}});
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 164);
+}
+
+// RFC 7541 C.4
+BOOST_AUTO_TEST_CASE(requests_with_huffman)
+{
+    http::HPackDecoder decoder;
+    checkHeaders(decode(decoder, "828684418cf1e3c2e5f23a6ba0ab90f4ff"),
+                 {{":method", "GET"},
+                  {":scheme", "http"},
+                  {":path", "/"},
+                  {":authority", "www.example.com"}});
+    checkHeaders(decode(decoder, "828684be5886a8eb10649cbf"),
+                 {{":method", "GET"},
+                  {":scheme", "http"},
+                  {":path", "/"},
+                  {":authority", "www.example.com"},
+                  {"cache-control", "no-cache"}});
+    checkHeaders(decode(decoder, "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"),
+                 {{":method", "GET"},
+                  {":scheme", "https"},
+                  {":path", "/index.html"},
+                  {":authority", "www.example.com"},
+                  {"custom-key", "custom-value"}});
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 164);
+}
+
+// RFC 7541 C.5, the table is too small for all headers and evicts the oldest ones
+BOOST_AUTO_TEST_CASE(eviction)
+{
+    http::HPackDecoder decoder(256);
+    checkHeaders(decode(decoder,
+                        "4803333032580770726976617465611d4d6f6e2c203231204f637420323031332032303a"
+                        "31333a323120474d546e1768747470733a2f2f7777772e6578616d706c652e636f6d"),
+                 {{":status", "302"},
+                  {"cache-control", "private"},
+                  {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                  {"location", "https://www.example.com"}});
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 222);
+    checkHeaders(decode(decoder, "4803333037c1c0bf"),
+                 {{":status", "307"},
+                  {"cache-control", "private"},
+                  {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                  {"location", "https://www.example.com"}});
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 222);
+    checkHeaders(decode(decoder,
+                        "88c1611d4d6f6e2c203231204f637420323031332032303a31333a323220474d54c05a04"
+                        "677a69707738666f6f3d4153444a4b48514b425a584f5157454f50495541585157454f49"
+                        "553b206d61782d6167653d333630303b2076657273696f6e3d31"),
+                 {{":status", "200"},
+                  {"cache-control", "private"},
+                  {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+                  {"location", "https://www.example.com"},
+                  {"content-encoding", "gzip"},
+                  {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}});
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 215);
+}
+
+BOOST_AUTO_TEST_CASE(malformed_blocks)
+{
+    std::vector<http::header> headers;
+    const auto check_invalid = [&headers](const std::string &hex) {
+        http::HPackDecoder decoder;
+        const auto block = fromHex(hex);
+        BOOST_CHECK(!decoder.Decode(block.data(), block.data() + block.size(), headers));
+    };
+    // index 0 and an index beyond the empty dynamic table
+    check_invalid("80");
+    check_invalid("be");
+    // a string longer than the block
+    check_invalid("400a6375");
+    // a table size update larger than the announced size and one after a header
+    check_invalid("3fe21f");
+    check_invalid("823f01");
+}
+
+BOOST_AUTO_TEST_CASE(encoded_headers_round_trip)
+{
+    std::string block;
+    http::EncodeHeader(":status", "200", block);
+    http::EncodeHeader("content-type", "application/json; charset=UTF-8", block);
+    http::EncodeHeader("x-osrm-custom", std::string(200, 'x'), block);
+
+    http::HPackDecoder decoder;
+    std::vector<http::header> headers;
+    BOOST_REQUIRE(decoder.Decode(block.data(), block.data() + block.size(), headers));
+    BOOST_REQUIRE_EQUAL(headers.size(), 3);
+    BOOST_CHECK_EQUAL(headers[0].name, ":status");
+    BOOST_CHECK_EQUAL(headers[0].value, "200");
+    BOOST_CHECK_EQUAL(headers[1].name, "content-type");
+    BOOST_CHECK_EQUAL(headers[1].value, "application/json; charset=UTF-8");
+    BOOST_CHECK_EQUAL(headers[2].name, "x-osrm-custom");
+    BOOST_CHECK_EQUAL(headers[2].value, std::string(200, 'x'));
+    // literals without indexing are not added to the table
+    BOOST_CHECK_EQUAL(decoder.GetTableSize(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
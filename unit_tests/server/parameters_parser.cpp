@@ -3,6 +3,7 @@
 #include "parameters_io.hpp"
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/isochrone_parameters.hpp"
 #include "engine/api/match_parameters.hpp"
 #include "engine/api/nearest_parameters.hpp"
 #include "engine/api/route_parameters.hpp"
@@ -53,6 +54,7 @@ BOOST_AUTO_TEST_CASE(invalid_route_urls)
                       32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?generate_hints=notboolean"),
                       23UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?format=yaml"), 15UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?overview=false&geometries=foo"),
                       34UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?overview=false&overview=foo"),
@@ -74,6 +76,10 @@ BOOST_AUTO_TEST_CASE(invalid_route_urls)
     BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?annotations=true,false"), 24UL);
     BOOST_CHECK_EQUAL(
         testInvalidOptions<RouteParameters>("1,2;3,4?annotations=&overview=simplified"), 20UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?depart_at=8:30"), 18UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?depart_at=08:75"), 18UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>("1,2;3,4?alternatives_search=fast"),
+                      28UL);
 
     // BOOST_CHECK_EQUAL(testInvalidOptions<RouteParameters>(), );
 }
@@ -86,6 +92,7 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
         testInvalidOptions<TableParameters>("1,2;3,4?sources=1&destinations=1&bla=foo"), 32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?sources=foo"), 16UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?destinations=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?annotations=speed"), 20UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_route_hint)
@@ -471,6 +478,43 @@ BOOST_AUTO_TEST_CASE(valid_route_urls)
     CHECK_EQUAL_RANGE(reference_20.approaches, result_20->approaches);
     CHECK_EQUAL_RANGE(reference_20.coordinates, result_20->coordinates);
     CHECK_EQUAL_RANGE(reference_20.hints, result_20->hints);
+
+    auto result_21 = parseParameters<RouteParameters>("1,2;3,4?depart_at=08:15");
+    BOOST_CHECK(result_21);
+    BOOST_CHECK(result_21->depart_at);
+    BOOST_CHECK_EQUAL(*result_21->depart_at, 8 * 60 + 15);
+    BOOST_CHECK(result_21->IsValid());
+
+    auto result_22 = parseParameters<RouteParameters>("1,2;3,4?depart_at=24:00");
+    BOOST_CHECK(result_22);
+    BOOST_CHECK(!result_22->IsValid());
+
+    auto result_depart_day =
+        parseParameters<RouteParameters>("1,2;3,4?depart_day=sa&depart_at=08:15");
+    BOOST_CHECK(result_depart_day);
+    BOOST_CHECK_EQUAL(*result_depart_day->depart_day, 5u);
+    BOOST_CHECK(result_depart_day->IsValid());
+    // the day needs a time
+    auto result_day_only = parseParameters<RouteParameters>("1,2;3,4?depart_day=mo");
+    BOOST_CHECK(result_day_only);
+    BOOST_CHECK(!result_day_only->IsValid());
+    BOOST_CHECK(result_22->alternatives_search == RouteParameters::AlternativesSearchType::Exact);
+
+    auto result_23 = parseParameters<RouteParameters>(
+        "1,2;3,4?alternatives=true&alternatives_search=single_pass");
+    BOOST_CHECK(result_23);
+    BOOST_CHECK(result_23->alternatives);
+    BOOST_CHECK(result_23->alternatives_search ==
+                RouteParameters::AlternativesSearchType::SinglePass);
+    BOOST_CHECK(result_23->alternative_steps);
+    BOOST_CHECK(result_23->intersections);
+
+    auto result_24 = parseParameters<RouteParameters>(
+        "1,2;3,4?steps=true&alternatives=2&alternative_steps=false&intersections=false");
+    BOOST_CHECK(result_24);
+    BOOST_CHECK(result_24->steps);
+    BOOST_CHECK(!result_24->alternative_steps);
+    BOOST_CHECK(!result_24->intersections);
 }
 
 BOOST_AUTO_TEST_CASE(valid_table_urls)
@@ -510,6 +554,47 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.approaches, result_3->approaches);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+
+    BOOST_CHECK(result_1->format == OutputFormatType::JSON);
+    auto result_4 = parseParameters<TableParameters>("1,2;3,4?sources=1&format=binary");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(result_4->format == OutputFormatType::Binary);
+    auto result_5 = parseParameters<TableParameters>("1,2;3,4?format=json");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(result_5->format == OutputFormatType::JSON);
+
+    using AnnotationsType = TableParameters::AnnotationsType;
+    BOOST_CHECK(result_1->annotations == AnnotationsType::Duration);
+    auto result_6 = parseParameters<TableParameters>("1,2;3,4?annotations=distance");
+    BOOST_CHECK(result_6);
+    BOOST_CHECK(result_6->annotations == AnnotationsType::Distance);
+    auto result_7 = parseParameters<TableParameters>("1,2;3,4?annotations=duration,distance");
+    BOOST_CHECK(result_7);
+    BOOST_CHECK(result_7->annotations == AnnotationsType::All);
+
+    BOOST_CHECK(!result_1->max_duration && !result_1->max_weight);
+    BOOST_CHECK(!result_1->max_results_per_source);
+    auto result_8 = parseParameters<TableParameters>(
+        "1,2;3,4?max_duration=1200.5&max_weight=300&max_results_per_source=5");
+    BOOST_CHECK(result_8);
+    BOOST_CHECK_EQUAL(*result_8->max_duration, 1200.5);
+    BOOST_CHECK_EQUAL(*result_8->max_weight, 300.);
+    BOOST_CHECK_EQUAL(*result_8->max_results_per_source, 5);
+    BOOST_CHECK(result_8->IsValid());
+    auto result_9 = parseParameters<TableParameters>("1,2;3,4?max_duration=-1");
+    BOOST_CHECK(result_9);
+    BOOST_CHECK(!result_9->IsValid());
+    auto result_10 = parseParameters<TableParameters>("1,2;3,4?max_results_per_source=0");
+    BOOST_CHECK(result_10);
+    BOOST_CHECK(!result_10->IsValid());
+
+    BOOST_CHECK(!result_1->approximate);
+    auto result_11 = parseParameters<TableParameters>("1,2;3,4?approximate=true");
+    BOOST_CHECK(result_11);
+    BOOST_CHECK(result_11->approximate);
+    auto result_12 = parseParameters<TableParameters>("1,2;3,4?approximate=false");
+    BOOST_CHECK(result_12);
+    BOOST_CHECK(!result_12->approximate);
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -537,6 +622,28 @@ BOOST_AUTO_TEST_CASE(valid_match_urls)
     CHECK_EQUAL_RANGE(reference_2.radiuses, result_2->radiuses);
     CHECK_EQUAL_RANGE(reference_2.approaches, result_2->approaches);
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
+
+    // the trace of a session continues at the last point of its previous request
+    auto result_3 = parseParameters<MatchParameters>("1,2?session=car-7_a&timestamps=5");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK_EQUAL(result_3->session, "car-7_a");
+    BOOST_CHECK(result_3->IsValid());
+    const std::vector<unsigned> timestamps_3 = {5};
+    CHECK_EQUAL_RANGE(timestamps_3, result_3->timestamps);
+
+    auto result_4 = parseParameters<MatchParameters>("1,2");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(!result_4->IsValid());
+
+    auto result_5 = parseParameters<MatchParameters>("1,2;3,4;5,6;7,8;9,10?traces=2;3");
+    BOOST_CHECK(result_5);
+    const std::vector<unsigned> traces_5 = {2, 3};
+    CHECK_EQUAL_RANGE(traces_5, result_5->traces);
+    BOOST_CHECK(result_5->IsValid());
+
+    auto result_6 = parseParameters<MatchParameters>("1,2;3,4;5,6?traces=1;2");
+    BOOST_CHECK(result_6);
+    BOOST_CHECK(!result_6->IsValid());
 }
 
 BOOST_AUTO_TEST_CASE(valid_nearest_urls)
@@ -565,6 +672,30 @@ BOOST_AUTO_TEST_CASE(valid_nearest_urls)
     CHECK_EQUAL_RANGE(reference_2.coordinates, result_2->coordinates);
 }
 
+BOOST_AUTO_TEST_CASE(valid_isochrone_urls)
+{
+    std::vector<util::Coordinate> coords_1 = {{util::FloatLongitude{1}, util::FloatLatitude{2}}};
+
+    IsochroneParameters reference_1{};
+    reference_1.coordinates = coords_1;
+    reference_1.contours = {300, 600.5};
+    auto result_1 = parseParameters<IsochroneParameters>("1,2?contours=300;600.5");
+    BOOST_CHECK(result_1);
+    BOOST_CHECK(result_1->IsValid());
+    CHECK_EQUAL_RANGE(reference_1.contours, result_1->contours);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_1->coordinates);
+
+    auto result_2 = parseParameters<IsochroneParameters>("1,2");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(!result_2->IsValid());
+
+    auto result_3 = parseParameters<IsochroneParameters>("1,2?contours=0");
+    BOOST_CHECK(result_3);
+    BOOST_CHECK(!result_3->IsValid());
+
+    BOOST_CHECK_EQUAL(testInvalidOptions<IsochroneParameters>("1,2?contours=foo"), 13UL);
+}
+
 BOOST_AUTO_TEST_CASE(invalid_tile_urls)
 {
     TileParameters reference_1{1, 2, 3};
@@ -574,6 +705,8 @@ BOOST_AUTO_TEST_CASE(invalid_tile_urls)
     BOOST_CHECK_EQUAL(reference_1.x, result_1->x);
     BOOST_CHECK_EQUAL(reference_1.y, result_1->y);
     BOOST_CHECK_EQUAL(reference_1.z, result_1->z);
+
+    BOOST_CHECK_EQUAL(testInvalidOptions<TileParameters>("tile(1,2,12).mvt?layers=foo"), 24UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_tile_urls)
@@ -585,6 +718,13 @@ BOOST_AUTO_TEST_CASE(valid_tile_urls)
     BOOST_CHECK_EQUAL(reference_1.x, result_1->x);
     BOOST_CHECK_EQUAL(reference_1.y, result_1->y);
     BOOST_CHECK_EQUAL(reference_1.z, result_1->z);
+    BOOST_CHECK(result_1->layers == TileParameters::LayersType::All);
+
+    auto result_2 = parseParameters<TileParameters>("tile(1,2,12).mvt?layers=speeds,osmnodes");
+    BOOST_CHECK(result_2);
+    BOOST_CHECK(result_2->IsValid());
+    BOOST_CHECK(result_2->layers ==
+                (TileParameters::LayersType::Speeds | TileParameters::LayersType::OSMNodes));
 }
 
 BOOST_AUTO_TEST_CASE(valid_trip_urls)
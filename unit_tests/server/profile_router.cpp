@@ -0,0 +1,91 @@
+#include "server/profile_router.hpp"
+
+#include "server/api/parsed_url.hpp"
+
+#include "util/exception.hpp"
+#include "util/json_container.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(profile_router)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// Answers every query with its name
+class NamedHandler final : public ServiceHandlerInterface
+{
+  public:
+    explicit NamedHandler(std::string name) : name(std::move(name)) {}
+
+    engine::Status RunQuery(api::ParsedURL, service::BaseService::ResultT &result) override
+    {
+        result = name;
+        return engine::Status::Ok;
+    }
+
+  private:
+    std::string name;
+};
+
+api::ParsedURL makeURL(const std::string &profile)
+{
+    api::ParsedURL parsed_url;
+    parsed_url.service = "route";
+    parsed_url.version = 1;
+    parsed_url.profile = profile;
+    parsed_url.query = "13.4,52.5;13.5,52.6";
+    parsed_url.prefix_length = 0;
+    return parsed_url;
+}
+}
+
+BOOST_AUTO_TEST_CASE(parse_datasets)
+{
+    const auto dataset = ProfileDataset::FromString("truck=/data/germany.truck.osrm");
+    BOOST_CHECK_EQUAL(dataset.profile, "truck");
+    BOOST_CHECK_EQUAL(dataset.base_path.string(), "/data/germany.truck.osrm");
+
+    for (const auto invalid : {"truck", "=/data/germany.osrm", "truck=", "tr-uck=/data/a.osrm"})
+    {
+        BOOST_CHECK_THROW(ProfileDataset::FromString(invalid), util::exception);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(route_by_profile)
+{
+    ProfileRouter router;
+    router.AddProfile("car", std::make_unique<NamedHandler>("car"));
+    router.AddProfile("truck", std::make_unique<NamedHandler>("truck"));
+    BOOST_CHECK_THROW(router.AddProfile("car", std::make_unique<NamedHandler>("car")),
+                      util::exception);
+
+    service::BaseService::ResultT result;
+    BOOST_CHECK(router.RunQuery(makeURL("truck"), result) == engine::Status::Ok);
+    BOOST_CHECK_EQUAL(result.get<std::string>(), "truck");
+    BOOST_CHECK(router.RunQuery(makeURL("car"), result) == engine::Status::Ok);
+    BOOST_CHECK_EQUAL(result.get<std::string>(), "car");
+
+    BOOST_CHECK(router.RunQuery(makeURL("bike"), result) == engine::Status::Error);
+    const auto &code = result.get<util::json::Object>().values.at("code");
+    BOOST_CHECK_EQUAL(code.get<util::json::String>().value, "InvalidProfile");
+}
+
+BOOST_AUTO_TEST_CASE(route_to_default)
+{
+    ProfileRouter router(std::make_unique<NamedHandler>("driving"));
+    router.AddProfile("bike", std::make_unique<NamedHandler>("bike"));
+
+    service::BaseService::ResultT result;
+    BOOST_CHECK(router.RunQuery(makeURL("bike"), result) == engine::Status::Ok);
+    BOOST_CHECK_EQUAL(result.get<std::string>(), "bike");
+    BOOST_CHECK(router.RunQuery(makeURL("foot"), result) == engine::Status::Ok);
+    BOOST_CHECK_EQUAL(result.get<std::string>(), "driving");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
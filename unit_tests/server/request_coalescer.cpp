@@ -0,0 +1,76 @@
+#include "server/request_coalescer.hpp"
+
+#include <boost/optional.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(request_coalescer)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+std::shared_ptr<const SharedReply> makeReply(const std::string &content)
+{
+    auto chain = std::make_shared<util::BufferChain>();
+    chain->append(content.data(), content.size());
+    auto reply = std::make_shared<SharedReply>();
+    reply->headers.emplace_back("Content-Length", std::to_string(content.size()));
+    reply->content = std::move(chain);
+    return reply;
+}
+}
+
+BOOST_AUTO_TEST_CASE(followers_get_the_reply_of_the_leader)
+{
+    RequestCoalescer coalescer;
+    auto leader = coalescer.Join("/route/v1/driving/1,1;2,2");
+    BOOST_CHECK(leader.IsLeader());
+
+    auto follower = coalescer.Join("/route/v1/driving/1,1;2,2");
+    BOOST_CHECK(!follower.IsLeader());
+
+    auto other = coalescer.Join("/route/v1/driving/1,1;3,3");
+    BOOST_CHECK(other.IsLeader());
+
+    auto shared = std::async(std::launch::async, [&follower] {
+        return follower.Wait(RequestCoalescer::Clock::time_point::max());
+    });
+    const auto reply = makeReply("{}");
+    leader.Publish(reply);
+
+    BOOST_CHECK(shared.get() == reply);
+
+    // the published computation is done, the next request computes its reply again
+    const auto next = coalescer.Join("/route/v1/driving/1,1;2,2");
+    BOOST_CHECK(next.IsLeader());
+}
+
+BOOST_AUTO_TEST_CASE(followers_compute_without_published_reply)
+{
+    RequestCoalescer coalescer;
+    boost::optional<RequestCoalescer::Ticket> leader;
+    leader.emplace(coalescer.Join("/table/v1/driving/1,1;2,2"));
+    auto follower = coalescer.Join("/table/v1/driving/1,1;2,2");
+
+    leader.reset();
+    BOOST_CHECK(!follower.Wait(RequestCoalescer::Clock::time_point::max()));
+}
+
+BOOST_AUTO_TEST_CASE(followers_stop_waiting_at_deadline)
+{
+    RequestCoalescer coalescer;
+    const auto leader = coalescer.Join("/match/v1/driving/1,1;2,2");
+    auto follower = coalescer.Join("/match/v1/driving/1,1;2,2");
+
+    const auto until = RequestCoalescer::Clock::now() + std::chrono::milliseconds(10);
+    BOOST_CHECK(!follower.Wait(until));
+    BOOST_CHECK(RequestCoalescer::Clock::now() >= until);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
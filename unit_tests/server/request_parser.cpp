@@ -0,0 +1,141 @@
+#include "server/request_parser.hpp"
+#include "server/http/compression_type.hpp"
+#include "server/http/request.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <tuple>
+
+BOOST_AUTO_TEST_SUITE(request_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+// parses the first request of the data and returns the rest of it
+RequestParser::RequestStatus
+parse(RequestParser &parser, http::request &request, std::string &data)
+{
+    RequestParser::RequestStatus status;
+    http::compression_type compression;
+    char *end;
+    std::tie(status, compression, end) = parser.parse(request, &data[0], &data[0] + data.size());
+    data.erase(0, end - &data[0]);
+    return status;
+}
+}
+
+BOOST_AUTO_TEST_CASE(connection_header)
+{
+    const auto keep_alive = [](std::string data) {
+        RequestParser parser;
+        http::request request;
+        BOOST_CHECK(parse(parser, request, data) == RequestParser::RequestStatus::valid);
+        return request.keep_alive;
+    };
+
+    BOOST_CHECK(keep_alive("GET /route HTTP/1.1\r\n\r\n"));
+    BOOST_CHECK(!keep_alive("GET /route HTTP/1.0\r\n\r\n"));
+    BOOST_CHECK(!keep_alive("GET /route HTTP/1.1\r\nConnection: close\r\n\r\n"));
+    BOOST_CHECK(keep_alive("GET /route HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"));
+    BOOST_CHECK(keep_alive("GET /route HTTP/1.1\r\nUser-Agent: test\r\nHost: osrm\r\n\r\n"));
+}
+
+BOOST_AUTO_TEST_CASE(pipelined_requests)
+{
+    std::string data = "GET /first HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n"
+                       "GET /second HTTP/1.1\r\nConnection: close\r\n\r\n"
+                       "GET /thi";
+
+    RequestParser parser;
+    http::request first;
+    BOOST_CHECK(parse(parser, first, data) == RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(first.uri, "/first");
+    BOOST_CHECK(first.keep_alive);
+
+    parser.reset();
+    http::request second;
+    BOOST_CHECK(parse(parser, second, data) == RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(second.uri, "/second");
+    BOOST_CHECK(!second.keep_alive);
+
+    // the incomplete request is consumed and waits for more data
+    parser.reset();
+    http::request third;
+    BOOST_CHECK(parse(parser, third, data) == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK(data.empty());
+    data = "rd HTTP/1.1\r\n\r\n";
+    BOOST_CHECK(parse(parser, third, data) == RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(third.uri, "/third");
+}
+
+BOOST_AUTO_TEST_CASE(post_body)
+{
+    std::string data = "POST /table/v1/driving HTTP/1.1\r\nContent-Type: application/json\r\n"
+                       "Content-Length: 30\r\n\r\n{\"coordinates\": [[1,2],[3,";
+
+    RequestParser parser;
+    http::request request;
+    BOOST_CHECK(parse(parser, request, data) == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK_EQUAL(request.method, "POST");
+    BOOST_CHECK_EQUAL(request.uri, "/table/v1/driving");
+    BOOST_CHECK_EQUAL(request.content_type, "application/json");
+    BOOST_CHECK_EQUAL(request.body, "{\"coordinates\": [[1,2],[3,");
+
+    // the rest of the body is followed by the next pipelined request
+    data = "4]]}GET /route HTTP/1.1\r\n\r\n";
+    BOOST_CHECK(parse(parser, request, data) == RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(request.body, "{\"coordinates\": [[1,2],[3,4]]}");
+    BOOST_CHECK_EQUAL(data, "GET /route HTTP/1.1\r\n\r\n");
+
+    parser.reset();
+    request.clear();
+    BOOST_CHECK(parse(parser, request, data) == RequestParser::RequestStatus::valid);
+    BOOST_CHECK_EQUAL(request.method, "GET");
+    BOOST_CHECK(request.body.empty());
+}
+
+BOOST_AUTO_TEST_CASE(body_grows_as_it_arrives)
+{
+    std::string data = "POST /table/v1/driving HTTP/1.1\r\nContent-Length: 16000000\r\n\r\n";
+
+    RequestParser parser;
+    http::request request;
+    BOOST_CHECK(parse(parser, request, data) == RequestParser::RequestStatus::indeterminate);
+    // the announced size is not allocated before the body arrives
+    BOOST_CHECK(request.body.capacity() < 1024);
+
+    data = "1,2;3,4";
+    BOOST_CHECK(parse(parser, request, data) == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK_EQUAL(request.body, "1,2;3,4");
+}
+
+BOOST_AUTO_TEST_CASE(invalid_content_length)
+{
+    const auto status = [](std::string data) {
+        RequestParser parser(10);
+        http::request request;
+        return parse(parser, request, data);
+    };
+
+    BOOST_CHECK(status("POST /route HTTP/1.1\r\nContent-Length: 10\r\n\r\n0123456789") ==
+                RequestParser::RequestStatus::valid);
+    BOOST_CHECK(status("POST /route HTTP/1.1\r\nContent-Length: 11\r\n\r\n") ==
+                RequestParser::RequestStatus::invalid);
+    BOOST_CHECK(status("POST /route HTTP/1.1\r\nContent-Length: 99999999999999999999\r\n\r\n") ==
+                RequestParser::RequestStatus::invalid);
+    BOOST_CHECK(status("POST /route HTTP/1.1\r\nContent-Length: -1\r\n\r\n") ==
+                RequestParser::RequestStatus::invalid);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_request)
+{
+    RequestParser parser;
+    http::request request;
+    std::string data = "GET /route XTTP/1.1\r\n\r\n";
+    BOOST_CHECK(parse(parser, request, data) == RequestParser::RequestStatus::invalid);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
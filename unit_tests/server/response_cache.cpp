@@ -0,0 +1,80 @@
+#include "server/response_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(response_cache)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+std::shared_ptr<const CachedReply> makeReply(const std::string &content)
+{
+    auto reply = std::make_shared<CachedReply>();
+    reply->service = "nearest";
+    reply->headers.emplace_back("Content-Length", std::to_string(content.size()));
+    reply->content = content;
+    return reply;
+}
+}
+
+BOOST_AUTO_TEST_CASE(replies_of_the_dataset)
+{
+    ResponseCache cache(1024 * 1024, std::chrono::seconds(60));
+    const auto dataset = std::make_shared<int>(0);
+    const auto epoch = cache.GetEpoch(dataset);
+
+    BOOST_CHECK(!cache.Get(epoch, "0 /nearest/v1/driving/1,1"));
+    const auto reply = makeReply("{}");
+    cache.Put(epoch, "0 /nearest/v1/driving/1,1", reply);
+    BOOST_CHECK(cache.Get(epoch, "0 /nearest/v1/driving/1,1") == reply);
+    BOOST_CHECK(!cache.Get(epoch, "1 /nearest/v1/driving/1,1"));
+    BOOST_CHECK_EQUAL(cache.Hits(), 1);
+    BOOST_CHECK_EQUAL(cache.Misses(), 2);
+
+    // a new dataset flushes the cache
+    BOOST_CHECK_EQUAL(cache.GetEpoch(dataset), epoch);
+    const auto new_epoch = cache.GetEpoch(std::make_shared<int>(1));
+    BOOST_CHECK_NE(new_epoch, epoch);
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+    BOOST_CHECK(!cache.Get(new_epoch, "0 /nearest/v1/driving/1,1"));
+}
+
+BOOST_AUTO_TEST_CASE(replies_expire)
+{
+    ResponseCache cache(1024 * 1024, std::chrono::seconds(60));
+    const auto now = ResponseCache::Clock::now();
+    cache.Put(1, "0 /route/v1/driving/1,1;2,2", makeReply("{}"), now);
+
+    BOOST_CHECK(cache.Get(1, "0 /route/v1/driving/1,1;2,2", now + std::chrono::seconds(59)));
+    BOOST_CHECK(!cache.Get(1, "0 /route/v1/driving/1,1;2,2", now + std::chrono::seconds(60)));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used_by_size)
+{
+    // a single shard that holds two of the replies
+    const std::string content(1000, 'x');
+    ResponseCache cache(2500, std::chrono::seconds(60), 1);
+    cache.Put(1, "a", makeReply(content));
+    cache.Put(1, "b", makeReply(content));
+    BOOST_CHECK(cache.Get(1, "a"));
+
+    cache.Put(1, "c", makeReply(content));
+    BOOST_CHECK(cache.Get(1, "a"));
+    BOOST_CHECK(!cache.Get(1, "b"));
+    BOOST_CHECK(cache.Get(1, "c"));
+    BOOST_CHECK_LE(cache.Size(), 2500);
+
+    // replies larger than the cache are not kept
+    cache.Put(1, "d", makeReply(std::string(3000, 'x')));
+    BOOST_CHECK(!cache.Get(1, "d"));
+    BOOST_CHECK(cache.Get(1, "a"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
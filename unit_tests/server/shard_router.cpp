@@ -0,0 +1,144 @@
+#include "server/shard_router.hpp"
+
+#include "server/api/parsed_url.hpp"
+
+#include "util/exception.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(shard_router)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+util::Coordinate makeCoordinate(const double lon, const double lat)
+{
+    return {util::FloatLongitude{lon}, util::FloatLatitude{lat}};
+}
+}
+
+BOOST_AUTO_TEST_CASE(parse_shards)
+{
+    const auto shard = Shard::FromString("berlin=13.0,52.3,13.8,52.7@10.0.0.1:5000");
+    BOOST_CHECK_EQUAL(shard.name, "berlin");
+    BOOST_CHECK_EQUAL(shard.south_west, makeCoordinate(13.0, 52.3));
+    BOOST_CHECK_EQUAL(shard.north_east, makeCoordinate(13.8, 52.7));
+    BOOST_CHECK_EQUAL(shard.backend.host, "10.0.0.1");
+    BOOST_CHECK_EQUAL(shard.backend.port, "5000");
+
+    const auto backend = Backend::FromString("localhost:5001");
+    BOOST_CHECK_EQUAL(backend.host, "localhost");
+    BOOST_CHECK_EQUAL(backend.port, "5001");
+
+    for (const auto invalid : {"berlin@10.0.0.1:5000",
+                               "=13.0,52.3,13.8,52.7@10.0.0.1:5000",
+                               "berlin=13.0,52.3,13.8@10.0.0.1:5000",
+                               "berlin=13.0,52.3,13.8,52.7,1@10.0.0.1:5000",
+                               "berlin=13.0,52.3,13.8,95@10.0.0.1:5000",
+                               "berlin=13.8,52.3,13.0,52.7@10.0.0.1:5000",
+                               "berlin=13.0,52.3,13.8,52.7x@10.0.0.1:5000",
+                               "berlin=13.0,52.3,13.8,52.7@10.0.0.1",
+                               "berlin=13.0,52.3,13.8,52.7@10.0.0.1:port"})
+    {
+        BOOST_CHECK_THROW(Shard::FromString(invalid), util::exception);
+    }
+    BOOST_CHECK_THROW(Backend::FromString(":5000"), util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(select_smallest_shard)
+{
+    const ShardRouter router({Shard::FromString("germany=5.8,47.2,15.1,55.1@germany:5000"),
+                              Shard::FromString("berlin=13.0,52.3,13.8,52.7@berlin:5000")},
+                             boost::none,
+                             std::chrono::milliseconds(1000));
+
+    const auto berlin = router.SelectBackend({makeCoordinate(13.4, 52.5)});
+    BOOST_REQUIRE(berlin);
+    BOOST_CHECK_EQUAL(berlin->host, "berlin");
+
+    const auto germany =
+        router.SelectBackend({makeCoordinate(13.4, 52.5), makeCoordinate(11.6, 48.1)});
+    BOOST_REQUIRE(germany);
+    BOOST_CHECK_EQUAL(germany->host, "germany");
+
+    BOOST_CHECK(!router.SelectBackend({makeCoordinate(13.4, 52.5), makeCoordinate(2.3, 48.9)}));
+
+    const ShardRouter fallback_router({Shard::FromString("berlin=13.0,52.3,13.8,52.7@berlin:5000")},
+                                      Backend::FromString("planet:5000"),
+                                      std::chrono::milliseconds(1000));
+    const auto planet = fallback_router.SelectBackend({makeCoordinate(2.3, 48.9)});
+    BOOST_REQUIRE(planet);
+    BOOST_CHECK_EQUAL(planet->host, "planet");
+}
+
+BOOST_AUTO_TEST_CASE(forward_request)
+{
+    using boost::asio::ip::tcp;
+
+    boost::asio::io_service io_service;
+    tcp::acceptor acceptor(io_service, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    const auto port = std::to_string(acceptor.local_endpoint().port());
+
+    // answers a single request
+    std::string request;
+    std::thread backend([&] {
+        tcp::socket socket(io_service);
+        acceptor.accept(socket);
+        boost::asio::streambuf buffer;
+        boost::asio::read_until(socket, buffer, "\r\n\r\n");
+        request.assign(boost::asio::buffers_begin(buffer.data()),
+                       boost::asio::buffers_end(buffer.data()));
+        const std::string reply = "HTTP/1.0 400 Bad Request\r\n"
+                                  "Content-Type: application/json; charset=UTF-8\r\n"
+                                  "\r\n"
+                                  "{\"code\":\"InvalidOptions\"}";
+        boost::asio::write(socket, boost::asio::buffer(reply));
+    });
+
+    ShardRouter router({Shard::FromString("berlin=13.0,52.3,13.8,52.7@127.0.0.1:" + port)},
+                       boost::none,
+                       std::chrono::milliseconds(10000));
+    api::ParsedURL parsed_url{
+        "route", 1, "driving", "13.4,52.5;13.5,52.6?steps=nope&hints=;", 18};
+    ShardRouter::ResultT result;
+    const auto status = router.RunQuery(parsed_url, result);
+    backend.join();
+
+    BOOST_CHECK(status == engine::Status::Error);
+    BOOST_CHECK(request.find("GET /route/v1/driving/13.4,52.5;13.5,52.6?steps=nope&hints=; "
+                             "HTTP/1.0\r\n") == 0);
+    BOOST_REQUIRE(result.is<service::RenderedJSON>());
+    BOOST_CHECK_EQUAL(result.get<service::RenderedJSON>().value, "{\"code\":\"InvalidOptions\"}");
+
+    // a request no shard covers is answered without a backend
+    parsed_url.query = "2.3,48.9;13.5,52.6";
+    BOOST_CHECK(router.RunQuery(parsed_url, result) == engine::Status::Error);
+    BOOST_REQUIRE(result.is<util::json::Object>());
+    BOOST_CHECK_EQUAL(
+        result.get<util::json::Object>().values["code"].get<util::json::String>().value,
+        "NoShard");
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_backend)
+{
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::acceptor acceptor(
+        io_service, {boost::asio::ip::address_v4::loopback(), 0});
+    const auto port = std::to_string(acceptor.local_endpoint().port());
+    acceptor.close();
+
+    ShardRouter router({Shard::FromString("berlin=13.0,52.3,13.8,52.7@127.0.0.1:" + port)},
+                       boost::none,
+                       std::chrono::milliseconds(1000));
+    ShardRouter::ResultT result;
+    BOOST_CHECK_THROW(router.RunQuery({"route", 1, "driving", "13.4,52.5;13.5,52.6", 18}, result),
+                      util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
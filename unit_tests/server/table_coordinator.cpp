@@ -0,0 +1,283 @@
+#include "server/table_coordinator.hpp"
+
+#include "server/api/parsed_url.hpp"
+
+#include "engine/api/binary_builder.hpp"
+#include "engine/hint.hpp"
+
+#include "util/exception.hpp"
+#include "util/json_container.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(table_coordinator)
+
+using namespace osrm;
+using namespace osrm::server;
+
+namespace
+{
+const std::string QUERY = "1,1;2,2;3,3;4,4;5,5?destinations=3;4&annotations=duration,distance";
+
+std::string makeHint(const std::uint32_t checksum)
+{
+    // zeroed so the padding of the phantom node encodes the same every time
+    engine::Hint hint;
+    std::memset(&hint, 0, sizeof(hint));
+    hint.data_checksum = checksum;
+    return hint.ToBase64();
+}
+
+util::json::Array makeWaypoints(const std::vector<std::size_t> &indices,
+                                const std::uint32_t checksum)
+{
+    util::json::Array waypoints;
+    for (const auto index : indices)
+    {
+        util::json::Object waypoint;
+        waypoint.values["name"] = "waypoint " + std::to_string(index);
+        waypoint.values["hint"] = makeHint(checksum);
+        waypoints.values.push_back(std::move(waypoint));
+    }
+    return waypoints;
+}
+
+// Snaps all coordinates and answers all other queries with their query
+class LocalHandler final : public ServiceHandlerInterface
+{
+  public:
+    engine::Status RunQuery(api::ParsedURL parsed_url,
+                            service::BaseService::ResultT &result) override
+    {
+        queries.push_back(parsed_url.query);
+        if (parsed_url.query.find("max_duration=0") == std::string::npos)
+        {
+            result = parsed_url.query;
+            return engine::Status::Ok;
+        }
+
+        util::json::Object snapped;
+        snapped.values["code"] = "Ok";
+        snapped.values["sources"] = makeWaypoints({0}, 7);
+        snapped.values["destinations"] = makeWaypoints({0, 1, 2, 3, 4}, 7);
+        result = service::RenderedBinary();
+        engine::api::binary::encode(snapped, result.get<service::RenderedBinary>().value);
+        return engine::Status::Ok;
+    }
+
+    std::vector<std::string> queries;
+};
+
+// Answers a single table request with durations of 10 * source + destination and distances of
+// twice that
+class Peer
+{
+  public:
+    explicit Peer(const std::uint32_t checksum)
+        : acceptor(io_service, {boost::asio::ip::address_v4::loopback(), 0}),
+          port(std::to_string(acceptor.local_endpoint().port())),
+          thread([this, checksum] { Serve(checksum); })
+    {
+    }
+
+    ~Peer()
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+
+    Backend GetBackend() const { return Backend{"127.0.0.1", port}; }
+
+    std::string Join()
+    {
+        thread.join();
+        return request;
+    }
+
+  private:
+    void Serve(const std::uint32_t checksum)
+    {
+        boost::asio::ip::tcp::socket socket(io_service);
+        acceptor.accept(socket);
+        boost::asio::streambuf buffer;
+        const auto headers_size = boost::asio::read_until(socket, buffer, "\r\n\r\n");
+        request.assign(boost::asio::buffers_begin(buffer.data()),
+                       boost::asio::buffers_end(buffer.data()));
+        const auto length_begin = request.find("Content-Length: ") + 16;
+        const auto content_length =
+            std::stoul(request.substr(length_begin, request.find("\r\n", length_begin)));
+        if (request.size() < headers_size + content_length)
+        {
+            boost::asio::read(socket,
+                              buffer,
+                              boost::asio::transfer_exactly(headers_size + content_length -
+                                                            request.size()));
+            request.assign(boost::asio::buffers_begin(buffer.data()),
+                           boost::asio::buffers_end(buffer.data()));
+        }
+
+        std::vector<std::size_t> sources;
+        const auto sources_begin = request.find("sources=") + 8;
+        const auto sources_end = request.find('&', sources_begin);
+        for (auto begin = sources_begin; begin < sources_end;)
+        {
+            const auto end = std::min(request.find(';', begin), sources_end);
+            sources.push_back(std::stoul(request.substr(begin, end - begin)));
+            begin = end + 1;
+        }
+
+        util::json::Object table;
+        table.values["code"] = "Ok";
+        table.values["sources"] = makeWaypoints(sources, checksum);
+        table.values["destinations"] = makeWaypoints({3, 4}, checksum);
+        util::json::Array durations, distances;
+        for (const auto source : sources)
+        {
+            util::json::Array duration_row, distance_row;
+            for (const auto destination : {3, 4})
+            {
+                duration_row.values.push_back(util::json::Number(10. * source + destination));
+                distance_row.values.push_back(util::json::Number(20. * source + 2 * destination));
+            }
+            // an unreachable entry
+            if (source == 1)
+                duration_row.values[0] = util::json::Null();
+            durations.values.push_back(std::move(duration_row));
+            distances.values.push_back(std::move(distance_row));
+        }
+        table.values["durations"] = std::move(durations);
+        table.values["distances"] = std::move(distances);
+
+        std::string content;
+        engine::api::binary::encode(table, content);
+        const auto reply = "HTTP/1.0 200 OK\r\nContent-Type: application/x-osrm-binary\r\n\r\n" +
+                           content;
+        boost::asio::write(socket, boost::asio::buffer(reply));
+    }
+
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::acceptor acceptor;
+    const std::string port;
+    std::string request;
+    std::thread thread;
+};
+
+api::ParsedURL makeURL(const std::string &query)
+{
+    return api::ParsedURL{"table", 1, "driving", query, 18};
+}
+}
+
+BOOST_AUTO_TEST_CASE(small_tables_are_local)
+{
+    auto local_handler = std::make_unique<LocalHandler>();
+    const auto &local = *local_handler;
+    TableCoordinator coordinator(std::move(local_handler),
+                                 {Backend{"127.0.0.1", "1"}},
+                                 10,
+                                 0,
+                                 std::chrono::milliseconds(1000));
+
+    TableCoordinator::ResultT result;
+    BOOST_CHECK(coordinator.RunQuery(makeURL(QUERY), result) == engine::Status::Ok);
+    BOOST_REQUIRE(result.is<std::string>());
+    BOOST_CHECK_EQUAL(result.get<std::string>(), QUERY);
+    BOOST_CHECK_EQUAL(local.queries.size(), 1);
+
+    auto route_url = makeURL(QUERY);
+    route_url.service = "route";
+    BOOST_CHECK(coordinator.RunQuery(route_url, result) == engine::Status::Ok);
+    BOOST_CHECK_EQUAL(local.queries.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(split_among_peers)
+{
+    auto local_handler = std::make_unique<LocalHandler>();
+    const auto &local = *local_handler;
+    Peer first_peer(7), second_peer(7);
+    TableCoordinator coordinator(std::move(local_handler),
+                                 {first_peer.GetBackend(), second_peer.GetBackend()},
+                                 4,
+                                 0,
+                                 std::chrono::milliseconds(10000));
+
+    TableCoordinator::ResultT result;
+    BOOST_CHECK(coordinator.RunQuery(makeURL(QUERY + "&generate_hints=false"), result) ==
+                engine::Status::Ok);
+    const auto first_request = first_peer.Join();
+    const auto second_request = second_peer.Join();
+
+    BOOST_REQUIRE_EQUAL(local.queries.size(), 1);
+    BOOST_CHECK_EQUAL(local.queries.front(),
+                      "1,1;2,2;3,3;4,4;5,5?sources=0&destinations=all&annotations=duration&"
+                      "max_duration=0&generate_hints=true&format=binary");
+
+    BOOST_CHECK(boost::starts_with(first_request, "POST /table/v1/driving HTTP/1.0\r\n"));
+    const auto hints = "&hints=" + makeHint(7) + ";" + makeHint(7) + ";" + makeHint(7) + ";" +
+                       makeHint(7) + ";" + makeHint(7);
+    BOOST_CHECK(boost::ends_with(first_request,
+                                 "\r\n\r\n1,1;2,2;3,3;4,4;5,5?destinations=3;4&"
+                                 "annotations=duration,distance&sources=0;1;2" +
+                                     hints + "&generate_hints=true&format=binary"));
+    BOOST_CHECK(second_request.find("&sources=3;4&") != std::string::npos);
+
+    BOOST_REQUIRE(result.is<service::RenderedJSON>());
+    const auto &json = result.get<service::RenderedJSON>().value;
+    BOOST_CHECK(json.find("\"durations\":[[3,4],[null,14],[23,24],[33,34],[43,44]]") !=
+                std::string::npos);
+    BOOST_CHECK(json.find("\"distances\":[[6,8],[26,28],[46,48],[66,68],[86,88]]") !=
+                std::string::npos);
+    BOOST_CHECK(json.find("\"name\":\"waypoint 4\"") != std::string::npos);
+    BOOST_CHECK(json.find("hint") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(binary_blocks)
+{
+    Peer first_peer(7), second_peer(7);
+    TableCoordinator coordinator(std::make_unique<LocalHandler>(),
+                                 {first_peer.GetBackend(), second_peer.GetBackend()},
+                                 4,
+                                 2,
+                                 std::chrono::milliseconds(10000));
+
+    TableCoordinator::ResultT result;
+    BOOST_CHECK(coordinator.RunQuery(makeURL(QUERY + "&format=binary&sources=4;0;2"), result) ==
+                engine::Status::Ok);
+    // blocks of at most two rows
+    BOOST_CHECK(first_peer.Join().find("&sources=4;0&") != std::string::npos);
+    BOOST_CHECK(second_peer.Join().find("&sources=2&") != std::string::npos);
+
+    BOOST_REQUIRE(result.is<service::RenderedBinary>());
+    const auto &binary = result.get<service::RenderedBinary>().value;
+    const auto root = engine::api::binary::GetRoot(binary.data());
+    BOOST_CHECK_EQUAL(root["code"].GetString(), "Ok");
+    const auto durations = root["durations"];
+    BOOST_REQUIRE_EQUAL(durations.size(), 3);
+    BOOST_CHECK_EQUAL(durations[0].GetNumbers()[0], 43);
+    BOOST_CHECK_EQUAL(durations[1].GetNumbers()[1], 4);
+    BOOST_CHECK_EQUAL(durations[2].GetNumbers()[0], 23);
+    BOOST_CHECK_EQUAL(root["sources"][0]["hint"].GetString(), makeHint(7));
+}
+
+BOOST_AUTO_TEST_CASE(peer_with_another_dataset)
+{
+    Peer first_peer(7), second_peer(8);
+    TableCoordinator coordinator(std::make_unique<LocalHandler>(),
+                                 {first_peer.GetBackend(), second_peer.GetBackend()},
+                                 4,
+                                 0,
+                                 std::chrono::milliseconds(10000));
+
+    TableCoordinator::ResultT result;
+    BOOST_CHECK_THROW(coordinator.RunQuery(makeURL(QUERY), result), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
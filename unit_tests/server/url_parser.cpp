@@ -49,6 +49,25 @@ BOOST_AUTO_TEST_CASE(invalid_urls)
     BOOST_CHECK_EQUAL(testInvalidURL("/route/v1/profile/"), 18UL);
 }
 
+BOOST_AUTO_TEST_CASE(urls_with_body)
+{
+    std::string url = "/table/v1/profile/";
+    auto iter = url.begin();
+    const auto result = api::parseURL(iter, url.end(), true);
+    BOOST_REQUIRE(result);
+    BOOST_CHECK_EQUAL(result->service, "table");
+    BOOST_CHECK_EQUAL(result->query, "");
+    BOOST_CHECK_EQUAL(result->prefix_length, 18UL);
+
+    url = "/table/v1/profile/?annotations=distance";
+    iter = url.begin();
+    BOOST_CHECK_EQUAL(api::parseURL(iter, url.end(), true)->query, "?annotations=distance");
+
+    url = "/table/v1/profile";
+    iter = url.begin();
+    BOOST_CHECK(!api::parseURL(iter, url.end(), true));
+}
+
 BOOST_AUTO_TEST_CASE(valid_urls)
 {
     api::ParsedURL reference_1{"route", 1, "profile", "0,1;2,3;4,5?options=value&foo=bar", 18UL};
@@ -0,0 +1,52 @@
+#include "customizer/time_buckets.hpp"
+#include "updater/source.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(speed_profile)
+
+using namespace osrm;
+using namespace osrm::updater;
+
+BOOST_AUTO_TEST_CASE(interpolate_speed_profile)
+{
+    SpeedProfile profile;
+    profile.minutes[0] = 6 * 60;
+    profile.speeds[0] = 20;
+    profile.minutes[1] = 18 * 60;
+    profile.speeds[1] = 40;
+    profile.num_breakpoints = 2;
+
+    BOOST_CHECK_EQUAL(profile(6 * 60), 20.);
+    BOOST_CHECK_EQUAL(profile(12 * 60), 30.);
+    BOOST_CHECK_EQUAL(profile(18 * 60), 40.);
+    // the profile wraps around midnight
+    BOOST_CHECK_EQUAL(profile(0), 30.);
+    BOOST_CHECK_EQUAL(profile(21 * 60), 35.);
+
+    profile.num_breakpoints = 1;
+    BOOST_CHECK_EQUAL(profile(0), 20.);
+    BOOST_CHECK_EQUAL(profile(23 * 60), 20.);
+}
+
+BOOST_AUTO_TEST_CASE(select_time_bucket)
+{
+    BOOST_CHECK_EQUAL(customizer::timeBucketMetricName(8 * 60 + 15), "time_0815");
+    BOOST_CHECK_EQUAL(*customizer::timeBucketMinute("time_0815"), 8 * 60 + 15);
+    BOOST_CHECK(!customizer::timeBucketMinute("time_2400"));
+    BOOST_CHECK(!customizer::timeBucketMinute("time_815"));
+    BOOST_CHECK(!customizer::timeBucketMinute("default"));
+
+    const std::vector<std::string> names = {"default", "time_0000", "time_0600", "time_1800"};
+    BOOST_CHECK_EQUAL(customizer::timeBucketMetricName(names, 0), "time_0000");
+    BOOST_CHECK_EQUAL(customizer::timeBucketMetricName(names, 8 * 60), "time_0600");
+    BOOST_CHECK_EQUAL(customizer::timeBucketMetricName(names, 23 * 60), "time_1800");
+
+    // a departure before the first bucket falls into the last bucket of the day before
+    const std::vector<std::string> late = {"time_0600", "time_1800"};
+    BOOST_CHECK_EQUAL(customizer::timeBucketMetricName(late, 60), "time_1800");
+
+    BOOST_CHECK_EQUAL(customizer::timeBucketMetricName({"default"}, 60), "");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,3 +1,5 @@
+#include "updater/timezone_index.hpp"
+
 #include "util/exception.hpp"
 #include "util/geojson_validation.hpp"
 #include "util/timezones.hpp"
@@ -54,4 +56,37 @@ BOOST_AUTO_TEST_CASE(timezoner_test)
         "49.07206], [8.28369, 48.88277]]] }} ]}";
     BOOST_CHECK_THROW(Timezoner tz(missing_featc, now), util::exception);
 }
+
+BOOST_AUTO_TEST_CASE(timezone_index_test)
+{
+    const char json[] =
+        "{ \"type\" : \"FeatureCollection\", \"features\": ["
+        "{ \"type\" : \"Feature\","
+        "\"properties\" : { \"tzid\" : \"Europe/Berlin\"}, \"geometry\" : { \"type\": \"polygon\", "
+        "\"coordinates\": [[[8.28369,48.88277], [8.57757, "
+        "48.88277], [8.57757, 49.07206], [8.28369, "
+        "49.07206], [8.28369, 48.88277]]] }} ]}";
+    // 2017-06-01 12:00 UTC
+    const std::time_t now = 1496318400;
+    Timezoner tz(json, now);
+
+    const std::vector<util::Coordinate> coordinates = {
+        {util::FloatLongitude{8.4}, util::FloatLatitude{49.0}},
+        {util::FloatLongitude{9.4}, util::FloatLatitude{49.0}}};
+    std::vector<extractor::TurnRestriction> restrictions = {extractor::TurnRestriction{NodeID{1}},
+                                                            extractor::TurnRestriction{NodeID{0}},
+                                                            extractor::TurnRestriction{NodeID{0}}};
+
+    TimezoneIndex index(tz, restrictions, coordinates);
+    BOOST_CHECK_EQUAL(index.GetNumberOfRestrictions(), 3);
+    BOOST_CHECK_EQUAL(index.GetTimezoneID(0), INVALID_TIMEZONE_ID);
+    BOOST_CHECK_EQUAL(index.GetTimezoneID(1), 0);
+    BOOST_CHECK_EQUAL(index.GetTimezoneID(2), 0);
+    BOOST_REQUIRE_EQUAL(index.GetTimezoneNames().size(), 1);
+    BOOST_CHECK_EQUAL(index.GetTimezoneNames().front(), "Europe/Berlin");
+
+    const auto local_times = index.GetLocalTimes(now);
+    BOOST_REQUIRE_EQUAL(local_times.size(), 1);
+    BOOST_CHECK_EQUAL(local_times.front().tm_hour, (*tz(point_t{8.4, 49.0})).tm_hour);
+}
 BOOST_AUTO_TEST_SUITE_END()
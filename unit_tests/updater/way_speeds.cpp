@@ -0,0 +1,141 @@
+#include "extractor/files.hpp"
+#include "extractor/way_index.hpp"
+#include "updater/way_speed_source.hpp"
+
+#include "../common/temporary_file.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(way_speeds)
+
+using namespace osrm;
+using namespace osrm::updater;
+
+namespace
+{
+// way 7 through the nodes 1, 2, 3, 4 and way 3 through 4, 5
+extractor::WayIndex makeWayIndex()
+{
+    std::vector<extractor::WayNodes> ways = {{OSMWayID{3}, 4, 2}, {OSMWayID{7}, 0, 4}};
+    extractor::PackedOSMIDs nodes;
+    for (const auto node : {1, 2, 3, 4, 4, 5})
+        nodes.push_back(OSMNodeID{static_cast<std::uint64_t>(node)});
+    return extractor::WayIndex{std::move(ways), std::move(nodes)};
+}
+
+WaySpeedRecord makeRecord(std::uint64_t way_id,
+                          std::uint16_t first_segment,
+                          std::uint16_t last_segment,
+                          float speed,
+                          std::uint8_t directions)
+{
+    WaySpeedRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.way_id = way_id;
+    record.first_segment = first_segment;
+    record.last_segment = last_segment;
+    record.speed = speed;
+    record.rate = std::numeric_limits<float>::quiet_NaN();
+    record.directions = directions;
+    return record;
+}
+
+void writeRecords(const std::string &path, const std::vector<WaySpeedRecord> &records)
+{
+    WaySpeedHeader header;
+    std::memcpy(header.magic, WaySpeedHeader::MAGIC, sizeof(header.magic));
+    header.version = WaySpeedHeader::VERSION;
+    header.reserved = 0;
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(records.data()),
+              records.size() * sizeof(WaySpeedRecord));
+}
+}
+
+BOOST_AUTO_TEST_CASE(expand_way_speeds)
+{
+    const auto way_index = makeWayIndex();
+
+    TemporaryFile first, second;
+    writeRecords(first.path.string(),
+                 {makeRecord(7, 0, WaySpeedRecord::WAY_END, 30, WaySpeedRecord::FORWARD),
+                  makeRecord(7, 1, 2, 10, WaySpeedRecord::FORWARD | WaySpeedRecord::BACKWARD),
+                  makeRecord(42, 0, WaySpeedRecord::WAY_END, 50, WaySpeedRecord::FORWARD)});
+    writeRecords(second.path.string(), {makeRecord(3, 0, 1, 70, WaySpeedRecord::BACKWARD)});
+
+    const auto lookup =
+        readWaySpeedValues({first.path.string(), second.path.string()}, 3, way_index);
+    BOOST_CHECK_EQUAL(lookup.lookup.size(), 5);
+
+    const auto check = [&](std::uint64_t from, std::uint64_t to, unsigned speed, int source) {
+        const auto value = lookup(Segment{from, to});
+        BOOST_REQUIRE(value);
+        BOOST_CHECK_EQUAL(value->speed, speed);
+        BOOST_CHECK_EQUAL(value->source, source);
+        BOOST_CHECK(std::isnan(value->rate));
+    };
+    check(1, 2, 30, 3);
+    // the later record of the same file replaces the first one for the middle segment
+    check(2, 3, 10, 3);
+    check(3, 2, 10, 3);
+    check(3, 4, 30, 3);
+    check(5, 4, 70, 4);
+    BOOST_CHECK(!lookup(Segment{2, 1}));
+    BOOST_CHECK(!lookup(Segment{4, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(way_index_roundtrip)
+{
+    TemporaryFile tmp;
+    extractor::files::writeWayIndex(tmp.path, makeWayIndex());
+
+    extractor::WayIndex way_index;
+    extractor::files::readWayIndex(tmp.path, way_index);
+    BOOST_CHECK_EQUAL(way_index.GetNumberOfWays(), 2);
+
+    std::vector<std::uint64_t> nodes;
+    BOOST_CHECK(way_index.ForEachSegment(
+        OSMWayID{7}, [&](std::uint64_t offset, const OSMNodeID from, const OSMNodeID to) {
+            BOOST_CHECK_EQUAL(offset, nodes.size());
+            BOOST_CHECK_EQUAL(static_cast<std::uint64_t>(to), static_cast<std::uint64_t>(from) + 1);
+            nodes.push_back(static_cast<std::uint64_t>(from));
+        }));
+    BOOST_CHECK_EQUAL(nodes.size(), 3);
+    BOOST_CHECK(!way_index.ForEachSegment(OSMWayID{5}, [](auto, auto, auto) {}));
+}
+
+BOOST_AUTO_TEST_CASE(reject_invalid_files)
+{
+    TemporaryFile tmp;
+    writeRecords(tmp.path.string(), {makeRecord(7, 2, 1, 30, WaySpeedRecord::FORWARD)});
+    BOOST_CHECK_THROW(readWaySpeedRecords(tmp.path.string()), util::exception);
+
+    writeRecords(tmp.path.string(), {makeRecord(7, 0, 1, -1, WaySpeedRecord::FORWARD)});
+    BOOST_CHECK_THROW(readWaySpeedRecords(tmp.path.string()), util::exception);
+
+    writeRecords(tmp.path.string(), {makeRecord(7, 0, 1, 30, 4)});
+    BOOST_CHECK_THROW(readWaySpeedRecords(tmp.path.string()), util::exception);
+
+    {
+        std::ofstream out(tmp.path.string(), std::ios::binary);
+        out << "from,to,speed\n1,2,30\n";
+    }
+    BOOST_CHECK_THROW(readWaySpeedRecords(tmp.path.string()), util::exception);
+
+    writeRecords(tmp.path.string(), {makeRecord(7, 0, 1, 30, WaySpeedRecord::FORWARD)});
+    {
+        std::ofstream out(tmp.path.string(), std::ios::binary | std::ios::app);
+        out << "x";
+    }
+    BOOST_CHECK_THROW(readWaySpeedRecords(tmp.path.string()), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+#include "util/async_log.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(async_log_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(lines_of_threads_stay_in_order)
+{
+    std::ostringstream output, errors;
+    AsyncLogWriter writer;
+    writer.Start(output, errors);
+
+    const constexpr int NUM_THREADS = 4;
+    const constexpr int NUM_LINES = 1000;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < NUM_THREADS; ++thread)
+    {
+        threads.emplace_back([&writer, thread] {
+            for (int line = 0; line < NUM_LINES; ++line)
+            {
+                std::string text = std::to_string(thread) + " " + std::to_string(line);
+                // retries lines the writer hasn't caught up with
+                while (!writer.Push(logINFO, text))
+                {
+                    std::this_thread::yield();
+                }
+                BOOST_CHECK(text.empty());
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    std::string warning = "warning";
+    writer.Push(logWARNING, warning);
+    writer.Stop();
+
+    BOOST_CHECK_EQUAL(errors.str(), "warning\n");
+
+    std::vector<int> next_line(NUM_THREADS, 0);
+    std::istringstream lines(output.str());
+    int thread, line;
+    while (lines >> thread >> line)
+    {
+        BOOST_REQUIRE(thread >= 0 && thread < NUM_THREADS);
+        BOOST_CHECK_EQUAL(line, next_line[thread]);
+        next_line[thread] = line + 1;
+    }
+    for (const auto count : next_line)
+    {
+        BOOST_CHECK_EQUAL(count, NUM_LINES);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(full_ring_drops_lines)
+{
+    std::ostringstream output, errors;
+    AsyncLogWriter writer;
+    writer.Start(output, errors);
+
+    // pushes faster than the writer drains, lines that don't fit are dropped
+    std::size_t pushed = 0;
+    std::thread producer([&] {
+        for (std::size_t line = 0; line < 4 * AsyncLogWriter::RING_CAPACITY; ++line)
+        {
+            std::string text = "line";
+            pushed += writer.Push(logINFO, text) ? 1 : 0;
+        }
+    });
+    producer.join();
+    writer.Stop();
+
+    BOOST_CHECK_EQUAL(pushed + writer.GetDropped(), 4 * AsyncLogWriter::RING_CAPACITY);
+    std::size_t written = 0;
+    std::istringstream lines(output.str());
+    for (std::string text; std::getline(lines, text);)
+    {
+        BOOST_CHECK_EQUAL(text, "line");
+        ++written;
+    }
+    BOOST_CHECK_EQUAL(written, pushed);
+    if (writer.GetDropped() > 0)
+    {
+        BOOST_CHECK(errors.str().find("log lines were dropped") != std::string::npos);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -76,4 +76,35 @@ BOOST_AUTO_TEST_CASE(bearing_angle_test)
     BOOST_CHECK_CLOSE(bearing::angleBetween(90., 269.99), 0.01, 1e-10);
 }
 
+BOOST_AUTO_TEST_CASE(bearing_bins_test)
+{
+    BOOST_CHECK_EQUAL(bearing::BinOf(0), 1);
+    BOOST_CHECK_EQUAL(bearing::BinOf(22), 1);
+    BOOST_CHECK_EQUAL(bearing::BinOf(23), 2);
+    BOOST_CHECK_EQUAL(bearing::BinOf(359), 1 << 15);
+    BOOST_CHECK_EQUAL(bearing::BinOf(360), 1);
+    BOOST_CHECK_EQUAL(bearing::BinOf(-1), 1 << 15);
+
+    BOOST_CHECK_EQUAL(bearing::BinsInBounds(10, 5), 1);
+    BOOST_CHECK_EQUAL(bearing::BinsInBounds(0, 10), 1 | 1 << 15);
+    BOOST_CHECK_EQUAL(bearing::BinsInBounds(90, 180), bearing::ALL_BINS);
+    BOOST_CHECK_EQUAL(bearing::BinsInBounds(90, -1), 0);
+
+    // every bearing in bounds is in the bins
+    for (int B = -10; B < 370; B += 7)
+    {
+        for (int range = 0; range < 180; range += 3)
+        {
+            const auto bins = bearing::BinsInBounds(B, range);
+            for (int A = 0; A <= 360; ++A)
+            {
+                if (bearing::CheckInBounds(A, B, range))
+                {
+                    BOOST_CHECK(bins & bearing::BinOf(A));
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+#include "util/buffer_chain.hpp"
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(buffer_chain_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::string toString(const BufferChain &chain)
+{
+    std::string result;
+    for (std::size_t index = 0; index < chain.buffer_count(); ++index)
+    {
+        result.append(chain.buffer_data(index), chain.buffer_size(index));
+    }
+    return result;
+}
+}
+
+BOOST_AUTO_TEST_CASE(append_across_buffers)
+{
+    std::string reference;
+    BufferChain chain;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const auto number = std::to_string(i);
+        chain.append(number.data(), number.size());
+        chain.push_back(',');
+        reference += number + ',';
+    }
+
+    BOOST_CHECK_EQUAL(chain.size(), reference.size());
+    BOOST_CHECK_EQUAL(chain.buffer_count(),
+                      (reference.size() + BufferChain::BUFFER_SIZE - 1) / BufferChain::BUFFER_SIZE);
+    BOOST_CHECK(toString(chain) == reference);
+
+    BufferChain moved = std::move(chain);
+    BOOST_CHECK(chain.empty());
+    BOOST_CHECK(toString(moved) == reference);
+
+    moved.clear();
+    BOOST_CHECK(moved.empty());
+    BOOST_CHECK_EQUAL(moved.buffer_count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(consumer)
+{
+    std::string consumed;
+    std::size_t calls = 0;
+    BufferChain chain([&](const char *data, const std::size_t size) {
+        consumed.append(data, size);
+        ++calls;
+    });
+
+    const std::string data(BufferChain::BUFFER_SIZE * 2 + 10, 'x');
+    chain.append(data.data(), data.size());
+    BOOST_CHECK_EQUAL(calls, 2);
+    BOOST_CHECK_EQUAL(chain.buffer_count(), 1);
+    chain.flush();
+    BOOST_CHECK_EQUAL(calls, 3);
+    BOOST_CHECK(consumed == data);
+    BOOST_CHECK_EQUAL(chain.size(), data.size());
+}
+
+BOOST_AUTO_TEST_CASE(render_json)
+{
+    json::Object object;
+    json::Array array;
+    for (int i = 0; i < 20000; ++i)
+    {
+        array.values.push_back(json::Number{i + 0.5});
+    }
+    object.values["values"] = std::move(array);
+    object.values["name"] = json::String{"a \"name\""};
+    object.values["valid"] = json::True{};
+
+    std::vector<char> reference;
+    json::render(reference, object);
+
+    BufferChain chain;
+    json::render(chain, object);
+    BOOST_CHECK_GT(chain.buffer_count(), 1);
+    BOOST_CHECK(toString(chain) == std::string(reference.begin(), reference.end()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+#include "util/compressed_file.hpp"
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+#include "util/exception.hpp"
+
+#include "../common/temporary_file.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(compressed_file)
+
+using namespace osrm;
+
+namespace
+{
+std::vector<char> readFile(const boost::filesystem::path &path)
+{
+    boost::filesystem::ifstream stream(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(stream),
+                             std::istreambuf_iterator<char>());
+}
+}
+
+BOOST_AUTO_TEST_CASE(compress_decompress_roundtrip)
+{
+    std::vector<std::uint32_t> data(10000);
+    std::iota(data.begin(), data.end(), 0);
+
+    TemporaryFile original, compressed, restored;
+    {
+        boost::filesystem::ofstream stream(original.path, std::ios::binary);
+        stream.write(reinterpret_cast<const char *>(data.data()),
+                     data.size() * sizeof(std::uint32_t));
+    }
+
+    // frames that do not divide the file evenly
+    util::CompressFile(original.path, compressed.path, util::CompressionCodec::Zlib, 6, 1000);
+    BOOST_CHECK(util::IsCompressedFile(compressed.path));
+    BOOST_CHECK(!util::IsCompressedFile(original.path));
+    BOOST_CHECK_LT(boost::filesystem::file_size(compressed.path),
+                   boost::filesystem::file_size(original.path));
+
+    util::CompressedFileReader reader(compressed.path);
+    BOOST_CHECK_EQUAL(reader.GetSize(), data.size() * sizeof(std::uint32_t));
+
+    // reads within a frame, across frames and of the end of the file
+    std::uint32_t value;
+    reader.Read(1234 * sizeof(value), reinterpret_cast<char *>(&value), sizeof(value));
+    BOOST_CHECK_EQUAL(value, 1234);
+    std::vector<std::uint32_t> range(3000);
+    reader.Read(100 * sizeof(value), reinterpret_cast<char *>(range.data()), 12000);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        range.begin(), range.end(), data.begin() + 100, data.begin() + 3100);
+    reader.Read((data.size() - 1) * sizeof(value), reinterpret_cast<char *>(&value), 4);
+    BOOST_CHECK_EQUAL(value, data.back());
+
+    util::DecompressFile(compressed.path, restored.path);
+    const auto original_bytes = readFile(original.path);
+    const auto restored_bytes = readFile(restored.path);
+    BOOST_CHECK_EQUAL_COLLECTIONS(original_bytes.begin(),
+                                  original_bytes.end(),
+                                  restored_bytes.begin(),
+                                  restored_bytes.end());
+}
+
+BOOST_AUTO_TEST_CASE(file_reader_reads_compressed_files)
+{
+    std::vector<std::uint64_t> first(5000), second(300);
+    std::iota(first.begin(), first.end(), 7);
+    std::iota(second.begin(), second.end(), 70000);
+
+    TemporaryFile original, compressed;
+    {
+        storage::io::FileWriter writer(original.path,
+                                       storage::io::FileWriter::GenerateFingerprint);
+        storage::serialization::write(writer, first);
+        storage::serialization::write(writer, second);
+    }
+    util::CompressFile(original.path, compressed.path, util::CompressionCodec::Zlib, 1, 4096);
+
+    storage::io::FileReader plain_reader(original.path,
+                                         storage::io::FileReader::VerifyFingerprint);
+    storage::io::FileReader reader(compressed.path, storage::io::FileReader::VerifyFingerprint);
+    BOOST_CHECK(reader.IsCompressed());
+    BOOST_CHECK(!plain_reader.IsCompressed());
+    BOOST_CHECK_EQUAL(reader.GetSize(), plain_reader.GetSize());
+
+    // positions are the ones of the uncompressed file
+    BOOST_CHECK_EQUAL(reader.ReadVectorSize<std::uint64_t>(), first.size());
+    plain_reader.ReadVectorSize<std::uint64_t>();
+    BOOST_CHECK_EQUAL(reader.GetPosition(), plain_reader.GetPosition());
+
+    std::vector<std::uint64_t> second_out;
+    storage::serialization::read(reader, second_out);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        second_out.begin(), second_out.end(), second.begin(), second.end());
+
+    BOOST_CHECK_THROW(reader.ReadOne<std::uint64_t>(), util::RuntimeError);
+}
+
+BOOST_AUTO_TEST_CASE(unknown_codec)
+{
+    BOOST_CHECK(util::StringToCompressionCodec("zlib") == util::CompressionCodec::Zlib);
+    BOOST_CHECK_THROW(util::StringToCompressionCodec("lz4"), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,72 @@
+#include "util/concurrent_string_table.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(concurrent_string_table)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(find_or_add)
+{
+    ConcurrentStringTable<unsigned> table;
+    using Table = decltype(table);
+
+    std::string name("Main Street");
+    BOOST_CHECK(!table.Find(Table::MakeKey(name)));
+    const auto added = table.FindOrAdd(Table::MakeKey(name), 1);
+    BOOST_CHECK_EQUAL(added.first, 1);
+    BOOST_CHECK(added.second);
+
+    // the key is copied into the table
+    const std::string copy = name;
+    name.assign(name.size(), 'x');
+    BOOST_CHECK_EQUAL(*table.Find(Table::MakeKey(copy)), 1);
+    BOOST_CHECK(!table.Find(Table::MakeKey(name)));
+
+    const auto found = table.FindOrAdd(Table::MakeKey(copy), 2);
+    BOOST_CHECK_EQUAL(found.first, 1);
+    BOOST_CHECK(!found.second);
+
+    // empty keys, embedded zeros and keys larger than a block
+    const std::string empty;
+    const std::string separated("a\0b", 3);
+    const std::string large(100 * 1024, 'y');
+    BOOST_CHECK(table.FindOrAdd(Table::MakeKey(empty), 3).second);
+    BOOST_CHECK(table.FindOrAdd(Table::MakeKey(separated), 4).second);
+    BOOST_CHECK(table.FindOrAdd(Table::MakeKey(large), 5).second);
+    BOOST_CHECK(!table.Find(Table::MakeKey(std::string("a"))));
+    BOOST_CHECK_EQUAL(*table.Find(Table::MakeKey(empty)), 3);
+    BOOST_CHECK_EQUAL(*table.Find(Table::MakeKey(separated)), 4);
+    BOOST_CHECK_EQUAL(*table.Find(Table::MakeKey(large)), 5);
+    BOOST_CHECK_EQUAL(table.Size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_find_or_add)
+{
+    ConcurrentStringTable<unsigned> table;
+    using Table = decltype(table);
+
+    const unsigned count = 10000;
+    std::vector<unsigned> values(2 * count);
+    tbb::parallel_for(0u, 2 * count, [&](const unsigned index) {
+        // every key is added from two iterations, only one of them stores its value
+        const auto key = std::to_string(index % count);
+        values[index] = table.FindOrAdd(Table::MakeKey(key), index).first;
+    });
+
+    BOOST_CHECK_EQUAL(table.Size(), count);
+    for (unsigned index = 0; index < count; ++index)
+    {
+        BOOST_CHECK_EQUAL(values[index], values[index + count]);
+        BOOST_CHECK(values[index] == index || values[index] == index + count);
+        BOOST_CHECK_EQUAL(*table.Find(Table::MakeKey(std::to_string(index))), values[index]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,54 @@
+#include "util/convex_hull.hpp"
+#include "util/coordinate.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(convex_hull_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+Coordinate makeCoordinate(int lon, int lat)
+{
+    return Coordinate{FixedLongitude{lon}, FixedLatitude{lat}};
+}
+
+BOOST_AUTO_TEST_CASE(square_with_inner_points)
+{
+    const std::vector<Coordinate> coordinates = {makeCoordinate(0, 0),
+                                                 makeCoordinate(5, 5),
+                                                 makeCoordinate(10, 10),
+                                                 makeCoordinate(0, 10),
+                                                 makeCoordinate(5, 0),
+                                                 makeCoordinate(10, 0),
+                                                 makeCoordinate(3, 7),
+                                                 makeCoordinate(10, 10)};
+
+    const auto hull = convexHull(coordinates);
+
+    // counter-clockwise closed ring without the collinear point (5, 0)
+    const std::vector<Coordinate> reference = {makeCoordinate(0, 0),
+                                               makeCoordinate(10, 0),
+                                               makeCoordinate(10, 10),
+                                               makeCoordinate(0, 10),
+                                               makeCoordinate(0, 0)};
+    BOOST_CHECK_EQUAL_COLLECTIONS(hull.begin(), hull.end(), reference.begin(), reference.end());
+}
+
+BOOST_AUTO_TEST_CASE(degenerate_inputs)
+{
+    BOOST_CHECK(convexHull({}).empty());
+
+    const auto point = convexHull({makeCoordinate(1, 1), makeCoordinate(1, 1)});
+    BOOST_REQUIRE_EQUAL(point.size(), 2);
+    BOOST_CHECK_EQUAL(point.front(), point.back());
+
+    const auto line = convexHull({makeCoordinate(0, 0), makeCoordinate(2, 2)});
+    BOOST_REQUIRE_EQUAL(line.size(), 3);
+    BOOST_CHECK_EQUAL(line.front(), line.back());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,8 @@
 #include <osrm/coordinate.hpp>
 
 #include <cmath>
+#include <random>
+#include <vector>
 
 using namespace osrm;
 using namespace osrm::util;
@@ -408,4 +410,63 @@ BOOST_AUTO_TEST_CASE(regression_test_3516)
     BOOST_CHECK_EQUAL(nearest_location, v);
 }
 
+BOOST_AUTO_TEST_CASE(batched_distances)
+{
+    std::mt19937 g(42);
+    std::uniform_real_distribution<> lon_dist(-180, 180);
+    std::uniform_real_distribution<> lat_dist(-85, 85);
+    std::uniform_real_distribution<> offset_dist(-0.01, 0.01);
+
+    // short segments like the ones of roads and pairs across the world, the last batch is
+    // not full
+    std::vector<Coordinate> first, second;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto lon = lon_dist(g);
+        const auto lat = lat_dist(g);
+        first.emplace_back(FloatLongitude{lon}, FloatLatitude{lat});
+        if (i % 2 == 0)
+        {
+            const auto offset_lon = std::max(-180., std::min(180., lon + offset_dist(g)));
+            second.emplace_back(FloatLongitude{offset_lon}, FloatLatitude{lat + offset_dist(g)});
+        }
+        else
+        {
+            second.emplace_back(FloatLongitude{lon_dist(g)}, FloatLatitude{lat_dist(g)});
+        }
+    }
+    first.emplace_back(FloatLongitude{-180}, FloatLatitude{0});
+    second.emplace_back(FloatLongitude{180}, FloatLatitude{0});
+    first.emplace_back(FloatLongitude{0}, FloatLatitude{-85});
+    second.emplace_back(FloatLongitude{180}, FloatLatitude{85});
+    first.emplace_back(FloatLongitude{13.4}, FloatLatitude{52.5});
+    second.push_back(first.back());
+
+    std::vector<double> haversine(first.size()), great_circle(first.size());
+    coordinate_calculation::haversineDistances(
+        first.data(), second.data(), first.size(), haversine.data());
+    coordinate_calculation::greatCircleDistances(
+        first.data(), second.data(), first.size(), great_circle.data());
+    for (std::size_t i = 0; i < first.size(); ++i)
+    {
+        BOOST_CHECK_SMALL(haversine[i] -
+                              coordinate_calculation::haversineDistance(first[i], second[i]),
+                          1e-4);
+        BOOST_CHECK_SMALL(great_circle[i] -
+                              coordinate_calculation::greatCircleDistance(first[i], second[i]),
+                          1e-4);
+    }
+    BOOST_CHECK_EQUAL(haversine.back(), 0.);
+
+    double length = 0;
+    for (std::size_t i = 0; i + 1 < first.size(); ++i)
+    {
+        length += coordinate_calculation::haversineDistance(first[i], first[i + 1]);
+    }
+    BOOST_CHECK_CLOSE(coordinate_calculation::haversineLength(first.data(), first.size()),
+                      length,
+                      1e-9);
+    BOOST_CHECK_EQUAL(coordinate_calculation::haversineLength(first.data(), 1), 0.);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#include "util/distance_oracle.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(distance_oracle_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+// Chosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 11;
+
+std::vector<EdgeDuration> dijkstra(const std::size_t num_nodes,
+                                   const std::vector<DistanceOracleArc> &arcs,
+                                   const NodeID source)
+{
+    std::vector<EdgeDuration> durations(num_nodes, MAXIMAL_EDGE_DURATION);
+    using Entry = std::pair<EdgeDuration, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    durations[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto duration = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (duration != durations[node])
+            continue;
+        for (const auto &arc : arcs)
+        {
+            if (arc.source == node && duration + arc.duration < durations[arc.target])
+            {
+                durations[arc.target] = duration + arc.duration;
+                queue.emplace(durations[arc.target], arc.target);
+            }
+        }
+    }
+    return durations;
+}
+
+// Grid with random durations where every third street is one-way
+std::vector<DistanceOracleArc> makeGrid(const NodeID size, const EdgeDuration max_duration)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<EdgeDuration> duration(1, max_duration);
+    std::vector<DistanceOracleArc> arcs;
+    for (const auto node : irange<NodeID>(0, size * size))
+    {
+        const auto x = node % size, y = node / size;
+        for (const auto neighbour :
+             {x + 1 < size ? node + 1 : node, y + 1 < size ? node + size : node})
+        {
+            if (neighbour == node)
+                continue;
+            arcs.push_back({node, neighbour, duration(generator)});
+            if (arcs.size() % 3 != 0)
+                arcs.push_back({neighbour, node, duration(generator)});
+        }
+    }
+    return arcs;
+}
+
+// Square blocks of block_size * block_size nodes of the grid
+std::vector<CellID> makeBlocks(const NodeID size, const NodeID block_size)
+{
+    const auto blocks_per_row = (size + block_size - 1) / block_size;
+    std::vector<CellID> cells(size * size);
+    for (const auto node : irange<NodeID>(0, size * size))
+    {
+        const auto x = node % size, y = node / size;
+        cells[node] = (y / block_size) * blocks_per_row + x / block_size;
+    }
+    return cells;
+}
+}
+
+BOOST_AUTO_TEST_CASE(bounds_test)
+{
+    const NodeID size = 12;
+    const auto arcs = makeGrid(size, 20);
+    const auto cells = makeBlocks(size, 4);
+    const auto oracle = buildDistanceOracle(arcs, cells, 9);
+    BOOST_REQUIRE_EQUAL(oracle.GetNumberOfCells(), 9);
+    BOOST_CHECK_EQUAL(oracle.GetNumberOfNodes(), size * size);
+
+    for (const auto cell : irange<CellID>(0, 9))
+        BOOST_CHECK_EQUAL(cells[oracle.GetRepresentative(cell)], cell);
+
+    std::size_t bounded = 0;
+    for (const auto source : irange<NodeID>(0, size * size))
+    {
+        const auto durations = dijkstra(size * size, arcs, source);
+        for (const auto target : irange<NodeID>(0, size * size))
+        {
+            const auto bounds = oracle.GetBounds(source, target);
+            if (bounds.upper == MAXIMAL_EDGE_DURATION)
+                continue;
+            ++bounded;
+            BOOST_CHECK_LE(bounds.lower, durations[target]);
+            BOOST_CHECK_GE(bounds.upper, durations[target]);
+        }
+    }
+    // only nodes that can't reach the representative of their cell inside of it have none
+    BOOST_CHECK_GT(bounded, size * size * size * size / 2);
+
+    // the bounds between representatives are exact
+    for (const auto from : irange<CellID>(0, 9))
+    {
+        const auto representative = oracle.GetRepresentative(from);
+        const auto durations = dijkstra(size * size, arcs, representative);
+        for (const auto to : irange<CellID>(0, 9))
+        {
+            const auto bounds = oracle.GetBounds(representative, oracle.GetRepresentative(to));
+            BOOST_CHECK_EQUAL(bounds.lower, durations[oracle.GetRepresentative(to)]);
+            BOOST_CHECK_EQUAL(bounds.upper, durations[oracle.GetRepresentative(to)]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(empty_test)
+{
+    const auto oracle = buildDistanceOracle({}, {}, 4);
+    BOOST_CHECK_EQUAL(oracle.GetNumberOfCells(), 0);
+    BOOST_CHECK_EQUAL(oracle.GetNumberOfNodes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -120,4 +120,54 @@ BOOST_AUTO_TEST_CASE(renumber_test)
     BOOST_CHECK_EQUAL(simple_graph.GetEdgeData(eit).id, 2);
 }
 
+BOOST_AUTO_TEST_CASE(reserve_test)
+{
+    std::vector<TestInputEdge> input_edges = {TestInputEdge{0, 1, TestData{1}},
+                                              TestInputEdge{3, 0, TestData{2}},
+                                              TestInputEdge{3, 0, TestData{5}},
+                                              TestInputEdge{3, 4, TestData{3}},
+                                              TestInputEdge{4, 3, TestData{4}}};
+    TestDynamicGraph simple_graph(5, input_edges);
+
+    // leaves free slots behind node 0 that the empty nodes 1 and 3 point into
+    simple_graph.DeleteEdgesTo(3, 0);
+    simple_graph.DeleteEdgesTo(3, 4);
+    BOOST_CHECK_EQUAL(simple_graph.GetOutDegree(3), 0);
+
+    simple_graph.ReserveEdges({{0, 2}, {1, 1}, {3, 2}, {4, 3}});
+
+    // slots of different nodes don't overlap, so the edges can be inserted in any order
+    simple_graph.InsertEdge(4, 0, TestData{10});
+    simple_graph.InsertEdge(3, 1, TestData{11});
+    simple_graph.InsertEdge(1, 2, TestData{12});
+    simple_graph.InsertEdge(0, 2, TestData{13});
+    simple_graph.InsertEdge(4, 1, TestData{14});
+    simple_graph.InsertEdge(3, 2, TestData{15});
+    simple_graph.InsertEdge(0, 3, TestData{16});
+    simple_graph.InsertEdge(4, 2, TestData{17});
+
+    BOOST_CHECK_EQUAL(simple_graph.GetNumberOfEdges(), 10);
+    BOOST_CHECK_EQUAL(simple_graph.GetOutDegree(0), 3);
+    BOOST_CHECK_EQUAL(simple_graph.GetOutDegree(1), 1);
+    BOOST_CHECK_EQUAL(simple_graph.GetOutDegree(3), 2);
+    BOOST_CHECK_EQUAL(simple_graph.GetOutDegree(4), 4);
+
+    const std::vector<std::tuple<NodeID, NodeID, EdgeID>> expected = {{0, 1, 1},
+                                                                      {0, 2, 13},
+                                                                      {0, 3, 16},
+                                                                      {1, 2, 12},
+                                                                      {3, 1, 11},
+                                                                      {3, 2, 15},
+                                                                      {4, 3, 4},
+                                                                      {4, 0, 10},
+                                                                      {4, 1, 14},
+                                                                      {4, 2, 17}};
+    for (const auto &edge : expected)
+    {
+        const auto eit = simple_graph.FindEdge(std::get<0>(edge), std::get<1>(edge));
+        BOOST_REQUIRE(eit != SPECIAL_EDGEID);
+        BOOST_CHECK_EQUAL(simple_graph.GetEdgeData(eit).id, std::get<2>(edge));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,48 @@
+#include "util/huge_pages.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+BOOST_AUTO_TEST_SUITE(huge_pages)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(rounding)
+{
+    const auto huge_page_size = GetHugePageSize();
+    BOOST_CHECK_EQUAL(RoundToHugePages(0), 0u);
+    if (huge_page_size > 0)
+    {
+        BOOST_CHECK_EQUAL(RoundToHugePages(1), huge_page_size);
+        BOOST_CHECK_EQUAL(RoundToHugePages(huge_page_size), huge_page_size);
+        BOOST_CHECK_EQUAL(RoundToHugePages(huge_page_size + 1), 2 * huge_page_size);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(memory_is_zeroed_and_writable)
+{
+    const std::size_t size = 5 << 20;
+    for (const auto use_huge_pages : {false, true})
+    {
+        HugePageMemory memory(size, use_huge_pages);
+        BOOST_REQUIRE(memory.Get() != nullptr);
+        BOOST_CHECK(std::all_of(memory.Get(), memory.Get() + size, [](char c) { return c == 0; }));
+        std::fill(memory.Get(), memory.Get() + size, 1);
+        BOOST_CHECK_EQUAL(memory.Get()[size - 1], 1);
+
+        if (!use_huge_pages)
+        {
+            BOOST_CHECK(memory.GetHugePages() == HugePages::None);
+        }
+        else if (memory.GetHugePages() != HugePages::None)
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(memory.Get());
+            BOOST_CHECK_EQUAL(address % GetHugePageSize(), 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
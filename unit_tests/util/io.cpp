@@ -1,10 +1,13 @@
+#include "storage/dataset_image.hpp"
 #include "storage/io.hpp"
 #include "storage/serialization.hpp"
 #include "util/exception.hpp"
 #include "util/fingerprint.hpp"
+#include "util/huge_pages.hpp"
 #include "util/typedefs.hpp"
 #include "util/version.hpp"
 
+#include <boost/filesystem/operations.hpp>
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -19,6 +22,7 @@ const static std::string IO_CORRUPT_FINGERPRINT_FILE = "corrupt_fingerprint_file
 const static std::string IO_INCOMPATIBLE_FINGERPRINT_FILE =
     "incompatible_fingerprint_file_test_io.tmp";
 const static std::string IO_TEXT_FILE = "plain_text_file.tmp";
+const static std::string IO_IMAGE_FILE = "dataset_image_test_io.tmp";
 
 BOOST_AUTO_TEST_SUITE(osrm_io)
 
@@ -41,6 +45,49 @@ BOOST_AUTO_TEST_CASE(io_data)
     BOOST_CHECK_EQUAL_COLLECTIONS(data_out.begin(), data_out.end(), data_in.begin(), data_in.end());
 }
 
+BOOST_AUTO_TEST_CASE(io_large_blocks)
+{
+    // large enough to be transferred in slices, which don't start at an aligned offset
+    std::vector<std::uint32_t> data_in(osrm::util::PARALLEL_IO_THRESHOLD / 4 + 12345);
+    std::iota(begin(data_in), end(data_in), 0);
+    const std::uint16_t trailer = 4242;
+
+    {
+        osrm::storage::io::FileWriter outfile(IO_TMP_FILE,
+                                              osrm::storage::io::FileWriter::GenerateFingerprint);
+        osrm::storage::serialization::write(outfile, data_in);
+        outfile.WriteOne(trailer);
+    }
+
+    for (const auto direct_io : {false, true})
+    {
+        osrm::storage::io::FileReader::UseDirectIO(direct_io);
+        osrm::storage::io::FileReader infile(IO_TMP_FILE,
+                                             osrm::storage::io::FileReader::VerifyFingerprint);
+        std::vector<std::uint32_t> data_out;
+        osrm::storage::serialization::read(infile, data_out);
+        BOOST_CHECK_EQUAL(infile.ReadOne<std::uint16_t>(), trailer);
+
+        BOOST_REQUIRE_EQUAL(data_in.size(), data_out.size());
+        BOOST_CHECK(data_in == data_out);
+    }
+    osrm::storage::io::FileReader::UseDirectIO(false);
+
+    // reading past the end is still reported
+    osrm::storage::io::FileReader infile(IO_TMP_FILE,
+                                         osrm::storage::io::FileReader::VerifyFingerprint);
+    std::vector<std::uint32_t> too_large(data_in.size() + 1000);
+    try
+    {
+        infile.ReadInto(too_large);
+        BOOST_REQUIRE_MESSAGE(false, "Should not get here");
+    }
+    catch (const osrm::util::RuntimeError &e)
+    {
+        BOOST_REQUIRE(e.GetCode() == osrm::ErrorCode::UnexpectedEndOfFile);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(io_nonexistent_file)
 {
     try
@@ -185,4 +232,57 @@ BOOST_AUTO_TEST_CASE(io_read_lines)
     }
 }
 
+BOOST_AUTO_TEST_CASE(io_dataset_image)
+{
+    using osrm::storage::DataLayout;
+
+    DataLayout layout;
+    for (std::size_t id = 0; id < DataLayout::NUM_BLOCKS; ++id)
+    {
+        layout.SetBlockSize<char>(static_cast<DataLayout::BlockID>(id), 0);
+    }
+    layout.SetBlockSize<char>(DataLayout::NAME_CHAR_DATA, 13);
+    layout.SetBlockSize<std::uint64_t>(DataLayout::COORDINATE_LIST, 1000);
+    layout.SetBlockSize<unsigned>(DataLayout::HSGR_CHECKSUM, 1);
+
+    {
+        osrm::util::HugePageMemory memory(layout.GetSizeOfLayout(), false);
+        for (std::size_t id = 0; id < DataLayout::NUM_BLOCKS; ++id)
+        {
+            layout.GetBlockPtr<char, true>(memory.Get(), static_cast<DataLayout::BlockID>(id));
+        }
+        const auto coordinates =
+            layout.GetBlockPtr<std::uint64_t>(memory.Get(), DataLayout::COORDINATE_LIST);
+        std::iota(coordinates, coordinates + 1000, 0);
+        *layout.GetBlockPtr<unsigned>(memory.Get(), DataLayout::HSGR_CHECKSUM) = 4242;
+
+        osrm::storage::writeImage(IO_IMAGE_FILE, layout, memory.Get());
+    }
+
+    const auto image_layout = osrm::storage::readImageLayout(IO_IMAGE_FILE);
+    BOOST_CHECK(image_layout.num_entries == layout.num_entries);
+    BOOST_CHECK(image_layout.entry_size == layout.entry_size);
+    BOOST_CHECK(image_layout.entry_align == layout.entry_align);
+
+    // the blocks are found at a different address, the canaries are checked
+    osrm::util::HugePageMemory memory(image_layout.GetSizeOfLayout() + 64, false);
+    const auto image_memory = memory.Get() + 64;
+    osrm::storage::readImageMemory(IO_IMAGE_FILE, image_layout, image_memory);
+    const auto coordinates =
+        image_layout.GetBlockPtr<std::uint64_t>(image_memory, DataLayout::COORDINATE_LIST);
+    for (std::uint64_t index = 0; index < 1000; ++index)
+    {
+        BOOST_CHECK_EQUAL(coordinates[index], index);
+    }
+    BOOST_CHECK_EQUAL(*image_layout.GetBlockPtr<unsigned>(image_memory, DataLayout::HSGR_CHECKSUM),
+                      4242);
+    BOOST_CHECK_THROW(
+        osrm::storage::readImageMemory(IO_IMAGE_FILE, image_layout, image_memory + 4),
+        osrm::util::exception);
+
+    // a truncated image is rejected
+    boost::filesystem::resize_file(IO_IMAGE_FILE, boost::filesystem::file_size(IO_IMAGE_FILE) - 1);
+    BOOST_CHECK_THROW(osrm::storage::readImageLayout(IO_IMAGE_FILE), osrm::util::exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+#include "util/cast.hpp"
+#include "util/json_container.hpp"
+#include "util/json_renderer.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_renderer_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+std::string renderNumber(const double value)
+{
+    std::vector<char> out;
+    json::detail::appendNumber(out, value);
+    return std::string(out.begin(), out.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(render_numbers)
+{
+    BOOST_CHECK_EQUAL(renderNumber(0.), "0");
+    BOOST_CHECK_EQUAL(renderNumber(-0.), "-0");
+    BOOST_CHECK_EQUAL(renderNumber(42.), "42");
+    BOOST_CHECK_EQUAL(renderNumber(123.4), "123.4");
+    BOOST_CHECK_EQUAL(renderNumber(13.38886), "13.38886");
+    BOOST_CHECK_EQUAL(renderNumber(-52.517037), "-52.517037");
+    BOOST_CHECK_EQUAL(renderNumber(0.000001), "0.000001");
+    BOOST_CHECK_EQUAL(renderNumber(1e-7), "0");
+    BOOST_CHECK_EQUAL(renderNumber(-1e-7), "-0");
+    BOOST_CHECK_EQUAL(renderNumber(1e20), "100000000000000000000");
+    // exactly halfway, rounded to even
+    BOOST_CHECK_EQUAL(renderNumber(0.0078125), "0.007812");
+    BOOST_CHECK_EQUAL(renderNumber(0.0234375), "0.023438");
+}
+
+BOOST_AUTO_TEST_CASE(render_numbers_like_printf)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinates(-180, 180);
+    std::uniform_int_distribution<int> deciseconds(0, 10000000);
+    std::uniform_int_distribution<int> halves(0, 1 << 20);
+    for (int i = 0; i < 100000; ++i)
+    {
+        for (const auto value : {coordinates(generator),
+                                 std::round(coordinates(generator) * 1e6) / 1e6,
+                                 deciseconds(generator) / 10.,
+                                 halves(generator) / 128.})
+        {
+            BOOST_CHECK_EQUAL(renderNumber(value), cast::to_string_with_precision(value));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
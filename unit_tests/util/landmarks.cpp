@@ -0,0 +1,127 @@
+#include "util/landmarks.hpp"
+#include "util/integer_range.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(landmarks_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+// Chosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 7;
+
+std::vector<EdgeWeight>
+dijkstra(const std::size_t num_nodes, const std::vector<LandmarkArc> &arcs, const NodeID source)
+{
+    std::vector<EdgeWeight> weights(num_nodes, INVALID_EDGE_WEIGHT);
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    weights[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto weight = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (weight != weights[node])
+            continue;
+        for (const auto &arc : arcs)
+        {
+            if (arc.source == node && weight + arc.weight < weights[arc.target])
+            {
+                weights[arc.target] = weight + arc.weight;
+                queue.emplace(weights[arc.target], arc.target);
+            }
+        }
+    }
+    return weights;
+}
+
+// Grid with random weights where every third street is one-way
+std::vector<LandmarkArc> makeGrid(const NodeID size, const EdgeWeight max_weight)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<EdgeWeight> weight(1, max_weight);
+    std::vector<LandmarkArc> arcs;
+    for (const auto node : irange<NodeID>(0, size * size))
+    {
+        const auto x = node % size, y = node / size;
+        for (const auto neighbour :
+             {x + 1 < size ? node + 1 : node, y + 1 < size ? node + size : node})
+        {
+            if (neighbour == node)
+                continue;
+            arcs.push_back({node, neighbour, weight(generator)});
+            if (arcs.size() % 3 != 0)
+                arcs.push_back({neighbour, node, weight(generator)});
+        }
+    }
+    return arcs;
+}
+
+void checkLowerBounds(const std::size_t num_nodes,
+                      const std::vector<LandmarkArc> &arcs,
+                      const Landmarks &landmarks)
+{
+    for (const auto source : irange<NodeID>(0, num_nodes))
+    {
+        const auto weights = dijkstra(num_nodes, arcs, source);
+        for (const auto target : irange<NodeID>(0, num_nodes))
+        {
+            if (weights[target] != INVALID_EDGE_WEIGHT)
+                BOOST_CHECK_LE(landmarks.GetLowerBound(source, target), weights[target]);
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(exact_weights_test)
+{
+    const NodeID size = 8;
+    const auto arcs = makeGrid(size, 20);
+    const auto landmarks = buildLandmarks(size * size, arcs, 4);
+    BOOST_REQUIRE_EQUAL(landmarks.GetNumberOfLandmarks(), 4);
+    BOOST_CHECK_EQUAL(landmarks.GetNumberOfNodes(), size * size);
+
+    checkLowerBounds(size * size, arcs, landmarks);
+
+    // the weights fit 16 bits, so the bound between a landmark and any node is exact
+    for (const auto index : irange<std::size_t>(0, landmarks.GetNumberOfLandmarks()))
+    {
+        const auto landmark = landmarks.GetLandmark(index);
+        const auto weights = dijkstra(size * size, arcs, landmark);
+        for (const auto target : irange<NodeID>(0, size * size))
+        {
+            if (weights[target] != INVALID_EDGE_WEIGHT)
+                BOOST_CHECK_EQUAL(landmarks.GetLowerBound(landmark, target), weights[target]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quantized_weights_test)
+{
+    // weights beyond 16 bits are rounded down to multiples of a unit
+    const NodeID size = 6;
+    const auto arcs = makeGrid(size, 100000);
+    const auto landmarks = buildLandmarks(size * size, arcs, 3);
+    BOOST_REQUIRE_EQUAL(landmarks.GetNumberOfLandmarks(), 3);
+
+    checkLowerBounds(size * size, arcs, landmarks);
+}
+
+BOOST_AUTO_TEST_CASE(empty_graph_test)
+{
+    const auto landmarks = buildLandmarks(0, {}, 4);
+    BOOST_CHECK_EQUAL(landmarks.GetNumberOfLandmarks(), 0);
+    BOOST_CHECK_EQUAL(landmarks.GetNumberOfNodes(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
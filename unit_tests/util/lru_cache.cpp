@@ -0,0 +1,55 @@
+#include "util/lru_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(lru_cache_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(get_and_put)
+{
+    ShardedLRUCache<int, std::string> cache(10, 2);
+
+    BOOST_CHECK(!cache.Get(1));
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+
+    BOOST_CHECK_EQUAL(*cache.Get(1), "one");
+    BOOST_CHECK_EQUAL(*cache.Get(2), "two");
+    BOOST_CHECK(!cache.Get(3));
+
+    cache.Put(1, "uno");
+    BOOST_CHECK_EQUAL(*cache.Get(1), "uno");
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+
+    BOOST_CHECK_EQUAL(cache.Hits(), 3);
+    BOOST_CHECK_EQUAL(cache.Misses(), 2);
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+    BOOST_CHECK(!cache.Get(1));
+}
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    ShardedLRUCache<int, int> cache(3, 1);
+
+    cache.Put(1, 1);
+    cache.Put(2, 2);
+    cache.Put(3, 3);
+
+    // touch 1 so that 2 is the least recently used entry
+    BOOST_CHECK(cache.Get(1));
+    cache.Put(4, 4);
+
+    BOOST_CHECK_EQUAL(cache.Size(), 3);
+    BOOST_CHECK(cache.Get(1));
+    BOOST_CHECK(!cache.Get(2));
+    BOOST_CHECK(cache.Get(3));
+    BOOST_CHECK(cache.Get(4));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -19,7 +19,8 @@ BOOST_AUTO_TEST_SUITE(name_table)
 using namespace osrm;
 using namespace osrm::util;
 
-std::string PrapareNameTableData(std::vector<std::string> &data, bool fill_all)
+std::string
+PrapareNameTableData(std::vector<std::string> &data, bool fill_all, bool deduplicate = false)
 {
     NameTable::IndexedData indexed_data;
     std::vector<unsigned char> name_char_data;
@@ -60,6 +61,11 @@ std::string PrapareNameTableData(std::vector<std::string> &data, bool fill_all)
     }
     name_offsets.push_back(name_char_data.size());
 
+    if (deduplicate)
+    {
+        NameTable::Deduplicate(name_offsets, name_char_data);
+    }
+
     TemporaryFile file;
     {
         storage::io::FileWriter writer(file.path, storage::io::FileWriter::HasNoFingerprint);
@@ -123,6 +129,47 @@ BOOST_AUTO_TEST_CASE(check_name_table_nofill)
     // CALLGRIND_STOP_INSTRUMENTATION;
 }
 
+BOOST_AUTO_TEST_CASE(check_name_table_deduplicated)
+{
+    std::vector<std::string> expected_names = {"",
+                                               "Main Street",
+                                               "check_name",
+                                               "Main Street",
+                                               "short",
+                                               "short",
+                                               "check_name",
+                                               "Main Street"};
+
+    const auto data = PrapareNameTableData(expected_names, true);
+    auto deduplicated_data = PrapareNameTableData(expected_names, true, true);
+    BOOST_CHECK_LT(deduplicated_data.size(), data.size());
+
+    NameTable name_table;
+    name_table.reset(&deduplicated_data[0], &deduplicated_data[deduplicated_data.size()]);
+
+    for (std::size_t index = 0; index < expected_names.size(); ++index)
+    {
+        const NameID id = 5 * index;
+        BOOST_CHECK_EQUAL(name_table.GetNameForID(id), expected_names[index]);
+        BOOST_CHECK_EQUAL(name_table.GetRefForID(id), expected_names[index] + "_ref");
+        BOOST_CHECK_EQUAL(name_table.GetDestinationsForID(id), expected_names[index] + "_des");
+        BOOST_CHECK_EQUAL(name_table.GetPronunciationForID(id), expected_names[index] + "_pro");
+        BOOST_CHECK_EQUAL(name_table.GetExitsForID(id), expected_names[index] + "_ext");
+    }
+
+    // repeated names are views of their first copy, short ones are stored again
+    BOOST_CHECK(name_table.GetNameForID(35).data() == name_table.GetNameForID(5).data());
+    BOOST_CHECK(name_table.GetRefForID(30).data() == name_table.GetRefForID(10).data());
+    BOOST_CHECK(name_table.GetNameForID(25).data() != name_table.GetNameForID(20).data());
+}
+
+BOOST_AUTO_TEST_CASE(check_reference_lookalikes)
+{
+    BOOST_CHECK(NameTable::IsReference(std::string("\xff\x01\x00\x00\x00", 5)));
+    BOOST_CHECK(!NameTable::IsReference(std::string("\xff\x01\x00\x00", 4)));
+    BOOST_CHECK(!NameTable::IsReference("Hauptstrasse"));
+}
+
 BOOST_AUTO_TEST_CASE(check_invalid_ids)
 {
     NameTable name_table;
@@ -0,0 +1,84 @@
+#include "util/node_based_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(node_based_graph)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+NodeBasedDynamicGraph::InputEdge makeEdge(NodeID source, NodeID target, EdgeWeight weight)
+{
+    NodeBasedDynamicGraph::InputEdge edge;
+    edge.source = source;
+    edge.target = target;
+    edge.data.weight = weight;
+    edge.data.reversed = source > target;
+    return edge;
+}
+}
+
+BOOST_AUTO_TEST_CASE(compact_dynamic_graph)
+{
+    /*
+     *  (0) <-1-> (1) <-2-> (2)
+     *              ^
+     *              3
+     *              v
+     *             (3)
+     */
+    std::vector<NodeBasedDynamicGraph::InputEdge> input_edges = {makeEdge(0, 1, 1),
+                                                                 makeEdge(1, 0, 1),
+                                                                 makeEdge(1, 2, 2),
+                                                                 makeEdge(1, 3, 3),
+                                                                 makeEdge(2, 1, 2),
+                                                                 makeEdge(3, 1, 3)};
+    NodeBasedDynamicGraph dynamic_graph(4, input_edges);
+
+    // leaves a gap in the edges of node 1 and moves the edges of node 3
+    dynamic_graph.DeleteEdge(1, dynamic_graph.FindEdge(1, 2));
+    dynamic_graph.InsertEdge(3, 2, dynamic_graph.GetEdgeData(dynamic_graph.FindEdge(3, 1)));
+    dynamic_graph.DeleteEdge(2, dynamic_graph.FindEdge(2, 1));
+
+    std::vector<EdgeID> new_edge_ids;
+    NodeBasedStaticGraph graph(dynamic_graph, new_edge_ids);
+
+    BOOST_CHECK_EQUAL(graph.GetNumberOfNodes(), 4);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), dynamic_graph.GetNumberOfEdges());
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), 5);
+
+    for (const auto node : irange(0u, dynamic_graph.GetNumberOfNodes()))
+    {
+        BOOST_REQUIRE_EQUAL(graph.GetOutDegree(node), dynamic_graph.GetOutDegree(node));
+        BOOST_CHECK_EQUAL(graph.GetDirectedOutDegree(node),
+                          dynamic_graph.GetDirectedOutDegree(node));
+        for (const auto edge : dynamic_graph.GetAdjacentEdgeRange(node))
+        {
+            const auto new_edge = new_edge_ids[edge];
+            BOOST_REQUIRE(new_edge >= graph.BeginEdges(node));
+            BOOST_REQUIRE(new_edge < graph.EndEdges(node));
+            BOOST_CHECK_EQUAL(graph.GetTarget(new_edge), dynamic_graph.GetTarget(edge));
+            BOOST_CHECK_EQUAL(graph.GetEdgeData(new_edge).weight,
+                              dynamic_graph.GetEdgeData(edge).weight);
+        }
+    }
+
+    // edges are contiguous and keep their order
+    BOOST_CHECK_EQUAL(graph.BeginEdges(0), 0);
+    BOOST_CHECK_EQUAL(graph.EndEdges(3), 5);
+    BOOST_CHECK_EQUAL(graph.GetTarget(graph.BeginEdges(3)), 1);
+    BOOST_CHECK_EQUAL(graph.GetTarget(graph.BeginEdges(3) + 1), 2);
+
+    BOOST_CHECK_EQUAL(graph.FindEdge(1, 2), SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(graph.FindEdge(2, 1), SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(graph.FindEdge(3, 2), graph.BeginEdges(3) + 1);
+    BOOST_CHECK_EQUAL(graph.FindEdgeInEitherDirection(2, 3), graph.BeginEdges(3) + 1);
+    BOOST_CHECK_EQUAL(graph.GetOutDegree(2), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
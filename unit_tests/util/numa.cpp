@@ -0,0 +1,29 @@
+#include "util/numa.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(numa)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(current_node_is_known)
+{
+    const auto nodes = GetNUMANodes();
+    BOOST_REQUIRE(!nodes.empty());
+    BOOST_CHECK(std::is_sorted(nodes.begin(), nodes.end()));
+    BOOST_CHECK(std::find(nodes.begin(), nodes.end(), GetCurrentNUMANode()) != nodes.end());
+}
+
+BOOST_AUTO_TEST_CASE(bound_memory_is_usable)
+{
+    // binding might not be permitted, allocating has to work either way
+    ScopedNUMABinding binding(GetNUMANodes().front());
+    std::vector<char> memory(1 << 20, 1);
+    BOOST_CHECK_EQUAL(memory.back(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
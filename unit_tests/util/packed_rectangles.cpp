@@ -0,0 +1,61 @@
+#include "util/packed_rectangles.hpp"
+#include "util/rectangle.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(packed_rectangles_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(same_distances_as_rectangle)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> lon_distribution(-180 * COORDINATE_PRECISION,
+                                                        180 * COORDINATE_PRECISION);
+    std::uniform_int_distribution<int> lat_distribution(-90 * COORDINATE_PRECISION,
+                                                        90 * COORDINATE_PRECISION);
+
+    std::vector<RectangleInt2D> rectangles;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto lon_1 = lon_distribution(generator), lon_2 = lon_distribution(generator);
+        auto lat_1 = lat_distribution(generator), lat_2 = lat_distribution(generator);
+        rectangles.push_back(RectangleInt2D{FixedLongitude{std::min(lon_1, lon_2)},
+                                            FixedLongitude{std::max(lon_1, lon_2)},
+                                            FixedLatitude{std::min(lat_1, lat_2)},
+                                            FixedLatitude{std::max(lat_1, lat_2)}});
+    }
+
+    const PackedRectangles packed(
+        rectangles.begin(), rectangles.end(), [](const RectangleInt2D &rectangle) {
+            return rectangle;
+        });
+    BOOST_CHECK_EQUAL(packed.size(), rectangles.size());
+
+    // odd offsets and sizes to cover the scalar tail of the vector kernels
+    std::vector<std::uint64_t> distances(rectangles.size());
+    for (int i = 0; i < 100; ++i)
+    {
+        const Coordinate location{FixedLongitude{lon_distribution(generator)},
+                                  FixedLatitude{lat_distribution(generator)}};
+        const std::size_t first = i % 7;
+        const std::size_t count = rectangles.size() - first - i % 13;
+        packed.GetMinSquaredDists(first, count, location, distances.data());
+
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            BOOST_CHECK_EQUAL(distances[j], rectangles[first + j].GetMinSquaredDist(location));
+        }
+    }
+
+    // a location inside of a rectangle has no distance
+    packed.GetMinSquaredDists(0, 1, rectangles.front().Centroid(), distances.data());
+    BOOST_CHECK_EQUAL(distances.front(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,8 +7,10 @@
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <random>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(packed_vector_test)
 
@@ -203,4 +205,50 @@ BOOST_AUTO_TEST_CASE(packed_vector_33bit_continious)
     }
 }
 
+template <std::size_t Bits> void check_range_coding()
+{
+    const std::uint64_t max_value = (1ULL << Bits) - 1;
+    std::mt19937 g(1337);
+    std::uniform_int_distribution<std::uint64_t> values(0, max_value);
+
+    PackedVector<std::uint64_t, Bits> vector(300);
+    std::vector<std::uint64_t> expected(vector.size());
+    for (auto &value : expected)
+        value = values(g);
+
+    // unaligned ranges across block boundaries, written on top of their neighbours
+    for (const auto begin : {0, 1, 63, 130})
+    {
+        const auto end = std::min<std::size_t>(begin + 97, vector.size());
+        vector.encode_range(begin, expected.begin() + begin, expected.begin() + end);
+    }
+    vector.encode_range(227, expected.begin() + 227, expected.end());
+    for (const auto index : osrm::util::irange<std::size_t>(0, vector.size()))
+    {
+        BOOST_CHECK_EQUAL(vector[index], expected[index]);
+    }
+
+    for (const auto begin : {0, 5, 64, 250})
+    {
+        std::vector<std::uint64_t> decoded;
+        vector.decode_range(begin, vector.size(), std::back_inserter(decoded));
+        BOOST_CHECK_EQUAL_COLLECTIONS(
+            decoded.begin(), decoded.end(), expected.begin() + begin, expected.end());
+    }
+
+    std::vector<std::uint64_t> decoded;
+    vector.decode_range(10, 10, std::back_inserter(decoded));
+    BOOST_CHECK(decoded.empty());
+}
+
+BOOST_AUTO_TEST_CASE(packed_vector_range_coding)
+{
+    check_range_coding<1>();
+    check_range_coding<10>();
+    check_range_coding<22>();
+    check_range_coding<32>();
+    check_range_coding<33>();
+    check_range_coding<63>();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+#include "util/perf_report.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(perf_report_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(resource_usage)
+{
+    const auto before = ResourceUsage::GetCurrent();
+    std::vector<std::uint64_t> values(1 << 22, 1);
+    volatile std::uint64_t sum = 0;
+    for (const auto value : values)
+        sum = sum + value;
+    const auto after = ResourceUsage::GetCurrent();
+
+    BOOST_CHECK(before.time <= after.time);
+    BOOST_CHECK(before.cpu_time <= after.cpu_time);
+    BOOST_CHECK_LE(before.peak_rss, after.peak_rss);
+#ifdef __linux__
+    BOOST_CHECK_GE(after.peak_rss, values.size() * sizeof(std::uint64_t));
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(write_report)
+{
+    {
+        PerfStage stage("first");
+        stage.Stop();
+        // stopping again doesn't record the stage twice
+        stage.Stop();
+    }
+    {
+        PerfStage stage("second");
+    }
+
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("osrm-perf-report-%%%%-%%%%.json");
+    PerfReport::GetInstance().Write(path.string(), "osrm-test", 2);
+    std::ifstream file(path.string());
+    const std::string report{std::istreambuf_iterator<char>(file), {}};
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK_EQUAL(report.find("{\"tool\":\"osrm-test\",\"threads\":2,\"total\":{"), 0);
+    const auto first = report.find("{\"name\":\"first\",\"wall_time_seconds\":");
+    const auto second = report.find("{\"name\":\"second\",\"wall_time_seconds\":");
+    BOOST_CHECK(first != std::string::npos);
+    BOOST_CHECK(second != std::string::npos);
+    BOOST_CHECK_LT(first, second);
+    BOOST_CHECK_EQUAL(report.find("{\"name\":\"first\"", first + 1), std::string::npos);
+    for (const auto key : {"cpu_time_seconds", "thread_utilisation", "peak_rss_bytes",
+                           "bytes_read", "bytes_written"})
+    {
+        BOOST_CHECK(report.find(std::string("\"") + key + "\":", second) != std::string::npos);
+    }
+    BOOST_CHECK_EQUAL(report.substr(report.size() - 4), "\n]}\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,7 +25,10 @@ typedef int TestKey;
 typedef int TestWeight;
 typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
                          MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>>
+                         UnorderedMapStorage<TestNodeID, TestKey>,
+                         GenerationArrayStorage<TestNodeID, TestKey>,
+                         TwoLevelStorage<TestNodeID, TestKey>,
+                         SelectableStorage<TestNodeID, TestKey>>
     storage_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
@@ -157,4 +160,205 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(clear_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    heap.Clear();
+    BOOST_CHECK(heap.Empty());
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasInserted(id));
+    }
+
+    heap.Insert(ids[1], weights[1], data[1]);
+    BOOST_CHECK(heap.WasInserted(ids[1]));
+    BOOST_CHECK(!heap.WasInserted(ids[0]));
+    BOOST_CHECK_EQUAL(heap.Min(), ids[1]);
+}
+
+BOOST_AUTO_TEST_CASE(selectable_storage_test)
+{
+    for (auto type : {IndexStorageType::UnorderedMap,
+                      IndexStorageType::GenerationArray,
+                      IndexStorageType::TwoLevelArray})
+    {
+        QueryHeap<TestNodeID, TestKey, TestWeight, TestData, SelectableStorage<TestNodeID, TestKey>>
+            heap(100000, type);
+        BOOST_CHECK(heap.GetIndexStorage().Type() == type);
+        BOOST_CHECK_EQUAL(heap.GetIndexStorage().Capacity(), 100000);
+
+        // the generation counter of array storages is 16 bit wide, clear more often than that
+        for (unsigned round = 0; round < 70000; ++round)
+        {
+            const TestNodeID node = (round * 7919) % 100000;
+            BOOST_CHECK(!heap.WasInserted(node));
+            heap.Insert(node, round, TestData{round});
+            BOOST_CHECK(heap.WasInserted(node));
+            heap.Clear();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(storage_view_test)
+{
+    for (auto type : {IndexStorageType::UnorderedMap,
+                      IndexStorageType::GenerationArray,
+                      IndexStorageType::TwoLevelArray})
+    {
+        QueryHeap<TestNodeID, TestKey, TestWeight, TestData, SelectableStorage<TestNodeID, TestKey>>
+            heap(1000, type);
+        heap.Insert(7, 30, TestData{7});
+
+        dispatchIndexStorage(type, [&](const auto storage) {
+            auto view = heap.View<decltype(storage)::value>();
+            BOOST_CHECK(view.WasInserted(7));
+            BOOST_CHECK(!view.WasInserted(8));
+            view.Insert(8, 20, TestData{8});
+            view.DecreaseKey(7, 10);
+            BOOST_CHECK_EQUAL(view.GetKey(7), 10);
+            BOOST_CHECK_EQUAL(view.DeleteMin(), 7);
+            BOOST_CHECK(view.WasRemoved(7));
+            BOOST_CHECK_EQUAL(view.GetData(8).value, 8);
+        });
+
+        // the view shares the heap
+        BOOST_CHECK(heap.WasInserted(8));
+        BOOST_CHECK(heap.WasRemoved(7));
+        BOOST_CHECK_EQUAL(heap.Min(), 8);
+        BOOST_CHECK_EQUAL(heap.Size(), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(shrink_test)
+{
+    for (auto type : {IndexStorageType::UnorderedMap,
+                      IndexStorageType::GenerationArray,
+                      IndexStorageType::TwoLevelArray})
+    {
+        QueryHeap<TestNodeID, TestKey, TestWeight, TestData, SelectableStorage<TestNodeID, TestKey>>
+            heap(100000, type);
+        const auto initial_memory = heap.MemoryUsage();
+
+        for (unsigned node = 0; node < 100000; node += 3)
+        {
+            heap.Insert(node, node, TestData{node});
+        }
+        heap.Clear();
+        // clearing keeps the memory for the next search
+        const auto used_memory = heap.MemoryUsage();
+        BOOST_CHECK_GT(used_memory, initial_memory);
+
+        heap.Shrink();
+        BOOST_CHECK_LT(heap.MemoryUsage(), used_memory);
+        BOOST_CHECK(heap.Empty());
+        BOOST_CHECK(!heap.WasInserted(3));
+
+        // the heap is usable after shrinking
+        heap.Insert(3, 1, TestData{3});
+        BOOST_CHECK(heap.WasInserted(3));
+        BOOST_CHECK(!heap.WasInserted(6));
+        BOOST_CHECK_EQUAL(heap.Min(), 3);
+    }
+}
+
+// Dijkstra on a random graph with small weights for many ties and sources with negative weights,
+// both heaps have to settle the nodes in the same order
+BOOST_AUTO_TEST_CASE(radix_heap_order_test)
+{
+    using DAryQueryHeap = QueryHeap<TestNodeID,
+                                    TestKey,
+                                    TestWeight,
+                                    TestData,
+                                    ArrayStorage<TestNodeID, TestKey>,
+                                    DAryHeap<TestWeight, TestKey>>;
+    using RadixQueryHeap = QueryHeap<TestNodeID,
+                                     TestKey,
+                                     TestWeight,
+                                     TestData,
+                                     ArrayStorage<TestNodeID, TestKey>,
+                                     RadixHeap<TestWeight, TestKey>>;
+
+    constexpr unsigned NUM_GRAPH_NODES = 2000;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<TestNodeID> nodes(0, NUM_GRAPH_NODES - 1);
+    std::uniform_int_distribution<TestWeight> weights(0, 3);
+    std::vector<std::vector<std::pair<TestNodeID, TestWeight>>> edges(NUM_GRAPH_NODES);
+    for (unsigned edge = 0; edge < NUM_GRAPH_NODES * 4; ++edge)
+        edges[nodes(generator)].emplace_back(nodes(generator), weights(generator));
+
+    const auto search = [&](auto &heap, const unsigned round) {
+        std::vector<std::pair<TestNodeID, TestWeight>> settled;
+        heap.Clear();
+        for (unsigned source = 0; source < 3; ++source)
+        {
+            const TestNodeID node = (round * 131 + source * 977) % NUM_GRAPH_NODES;
+            if (!heap.WasInserted(node))
+                heap.Insert(node, -static_cast<TestWeight>(source * 5), TestData{node});
+        }
+        while (!heap.Empty())
+        {
+            const auto weight = heap.MinKey();
+            const auto node = heap.DeleteMin();
+            settled.emplace_back(node, weight);
+            for (const auto &edge : edges[node])
+            {
+                const auto target_weight = weight + edge.second;
+                if (!heap.WasInserted(edge.first))
+                    heap.Insert(edge.first, target_weight, TestData{node});
+                else if (!heap.WasRemoved(edge.first) && target_weight < heap.GetKey(edge.first))
+                    heap.DecreaseKey(edge.first, target_weight);
+            }
+        }
+        return settled;
+    };
+
+    DAryQueryHeap d_ary_heap(NUM_GRAPH_NODES);
+    RadixQueryHeap radix_heap(NUM_GRAPH_NODES);
+    for (unsigned round = 0; round < 20; ++round)
+    {
+        const auto expected = search(d_ary_heap, round);
+        const auto settled = search(radix_heap, round);
+        BOOST_REQUIRE_EQUAL(settled.size(), expected.size());
+        BOOST_CHECK(settled == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(radix_heap_smaller_key_test)
+{
+    QueryHeap<TestNodeID,
+              TestKey,
+              TestWeight,
+              TestData,
+              ArrayStorage<TestNodeID, TestKey>,
+              RadixHeap<TestWeight, TestKey>>
+        heap(10);
+
+    heap.Insert(0, 100, TestData{0});
+    heap.Insert(1, 200, TestData{1});
+    heap.Insert(2, 150, TestData{2});
+    BOOST_CHECK_EQUAL(heap.DeleteMin(), 0);
+    BOOST_CHECK_EQUAL(heap.MinKey(), 150);
+
+    // keys below the last minimum are still popped first
+    heap.Insert(3, 50, TestData{3});
+    heap.DecreaseKey(1, -10);
+    BOOST_CHECK_EQUAL(heap.Size(), 3);
+    BOOST_CHECK_EQUAL(heap.DeleteMin(), 1);
+    BOOST_CHECK_EQUAL(heap.DeleteMin(), 3);
+    BOOST_CHECK_EQUAL(heap.DeleteMin(), 2);
+    BOOST_CHECK(heap.Empty());
+
+    heap.Insert(4, 1, TestData{4});
+    heap.DeleteAll();
+    BOOST_CHECK(heap.Empty());
+    BOOST_CHECK(heap.WasRemoved(4));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
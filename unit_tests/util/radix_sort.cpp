@@ -0,0 +1,52 @@
+#include "util/radix_sort.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(radix_sort_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(sort_like_stable_sort)
+{
+    std::mt19937 generator(1337);
+    // large enough for several blocks, the keys differ in the lower bytes and in the highest one
+    std::uniform_int_distribution<std::uint64_t> low(0, 1 << 20);
+    std::uniform_int_distribution<std::uint64_t> high(0, 3);
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> values;
+    for (std::size_t index = 0; index < 300000; ++index)
+    {
+        values.emplace_back(low(generator) | high(generator) << 62, index);
+    }
+    auto expected = values;
+    std::stable_sort(expected.begin(), expected.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    parallelRadixSort(values, [](const auto &value) { return value.first; });
+    BOOST_CHECK(values == expected);
+}
+
+BOOST_AUTO_TEST_CASE(sort_small_and_equal_keys)
+{
+    std::vector<std::uint32_t> empty;
+    parallelRadixSort(empty, [](const std::uint32_t value) { return value; });
+    BOOST_CHECK(empty.empty());
+
+    std::vector<std::uint32_t> equal(10, 42);
+    parallelRadixSort(equal, [](const std::uint32_t value) { return value; });
+    BOOST_CHECK(equal == std::vector<std::uint32_t>(10, 42));
+
+    std::vector<std::uint32_t> values = {5, 3, 1, 4, 2};
+    parallelRadixSort(values, [](const std::uint32_t value) { return value; });
+    BOOST_CHECK(values == (std::vector<std::uint32_t>{1, 2, 3, 4, 5}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
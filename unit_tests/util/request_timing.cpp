@@ -0,0 +1,152 @@
+#include "util/perf_counters.hpp"
+#include "util/request_timing.hpp"
+#include "util/request_trace.hpp"
+#include "util/timed_histogram.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(request_timing_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(latency_histogram_bins)
+{
+    for (std::uint64_t value = 0; value < 100000; ++value)
+    {
+        const auto bin = LatencyHistogram::BinIndex(value);
+        BOOST_CHECK_LE(LatencyHistogram::GetBinLowerBound(bin), value);
+        BOOST_CHECK_GT(LatencyHistogram::GetBinLowerBound(bin + 1), value);
+    }
+
+    LatencyHistogram histogram;
+    histogram.Count(3);
+    histogram.Count(1000);
+    histogram.Count(1001);
+    BOOST_CHECK_EQUAL(histogram.GetCount(), 3);
+    BOOST_CHECK_EQUAL(histogram.GetSum(), 2004);
+    BOOST_CHECK_EQUAL(histogram.GetBinCount(3), 1);
+    BOOST_CHECK_EQUAL(histogram.GetBinCount(LatencyHistogram::BinIndex(1000)), 2);
+}
+
+BOOST_AUTO_TEST_CASE(nested_stages)
+{
+    auto &timings = RequestTimings::GetCurrent();
+    timings.Reset();
+    {
+        ScopedStageTimer route_timer(RequestStage::Route);
+        {
+            ScopedStageTimer snap_timer(RequestStage::Snap);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    BOOST_CHECK(timings.IsMeasured(RequestStage::Route));
+    BOOST_CHECK(timings.IsMeasured(RequestStage::Snap));
+    BOOST_CHECK(!timings.IsMeasured(RequestStage::Parse));
+    // the time spent snapping isn't counted as routing as well
+    BOOST_CHECK(timings.GetDuration(RequestStage::Snap) >= std::chrono::milliseconds(20));
+    BOOST_CHECK(timings.GetDuration(RequestStage::Route) < std::chrono::milliseconds(20));
+    BOOST_CHECK(timings.GetTotal() >= timings.GetDuration(RequestStage::Snap) +
+                                          timings.GetDuration(RequestStage::Route));
+
+    RequestMetrics::GetInstance().Record(timings);
+    const auto metrics = RequestMetrics::GetInstance().DumpPrometheus();
+    BOOST_CHECK(metrics.find("# TYPE osrm_request_duration_seconds summary") != std::string::npos);
+    BOOST_CHECK(metrics.find("osrm_request_duration_seconds_count{stage=\"snap\"} 1") !=
+                std::string::npos);
+    BOOST_CHECK(metrics.find("osrm_request_duration_seconds_count{stage=\"total\"} 1") !=
+                std::string::npos);
+    BOOST_CHECK(metrics.find("osrm_request_duration_seconds{stage=\"parse\",quantile=\"0.5\"} "
+                             "NaN") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(traced_stages)
+{
+    auto &timings = RequestTimings::GetCurrent();
+    timings.Reset();
+    {
+        ScopedStageTimer snap_timer(RequestStage::Snap);
+    }
+    BOOST_CHECK(timings.GetSpans().empty());
+
+    timings.StartTrace();
+    timings.CountSettledNodes(42);
+    {
+        ScopedStageTimer route_timer(RequestStage::Route);
+        {
+            ScopedStageTimer unpack_timer(RequestStage::Unpack);
+        }
+    }
+    timings.Enter(RequestStage::Render);
+    timings.Enter(RequestStage::None);
+
+    // the route stage is interrupted by unpacking
+    const auto &spans = timings.GetSpans();
+    BOOST_REQUIRE_EQUAL(spans.size(), 4);
+    BOOST_CHECK(spans[0].stage == RequestStage::Route);
+    BOOST_CHECK(spans[1].stage == RequestStage::Unpack);
+    BOOST_CHECK(spans[2].stage == RequestStage::Route);
+    BOOST_CHECK(spans[3].stage == RequestStage::Render);
+    for (const auto &span : spans)
+        BOOST_CHECK(span.begin <= span.end);
+    BOOST_CHECK(spans[0].end == spans[1].begin);
+    BOOST_CHECK(spans[1].end == spans[2].begin);
+
+    const auto path = boost::filesystem::temp_directory_path() /
+                      boost::filesystem::unique_path("osrm-trace-%%%%-%%%%.json");
+    {
+        RequestTraceWriter writer(path.string());
+        writer.Write(timings, "route", "/route/v1/driving/\"1,2;3,4", 200);
+    }
+    std::ifstream file(path.string());
+    const std::string trace{std::istreambuf_iterator<char>(file), {}};
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK_EQUAL(trace.front(), '[');
+    BOOST_CHECK(trace.find("{\"name\":\"route\",\"cat\":\"osrm\",\"ph\":\"X\"") !=
+                std::string::npos);
+    BOOST_CHECK(trace.find("\"url\":\"\\/route\\/v1\\/driving\\/\\\"1,2;3,4\","
+                           "\"status\":200,\"settled_nodes\":42}") != std::string::npos);
+    BOOST_CHECK(trace.find("{\"name\":\"unpack\"") != std::string::npos);
+    BOOST_CHECK(trace.find("{\"name\":\"render\"") != std::string::npos);
+    BOOST_CHECK_EQUAL(std::count(trace.begin(), trace.end(), '\n'), 6);
+
+    // the next request isn't traced unless it is started again
+    timings.Reset();
+    BOOST_CHECK(!timings.IsTraced());
+    BOOST_CHECK(timings.GetSpans().empty());
+    BOOST_CHECK_EQUAL(timings.GetSettledNodes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(perf_counters)
+{
+    const auto &counters = PerfCounters::GetCurrent();
+    const auto before = counters.Read();
+    volatile std::uint64_t sum = 0;
+    for (std::uint64_t value = 0; value < 1000000; ++value)
+        sum = sum + value;
+    const auto after = counters.Read();
+
+    // zeros where the machine or the permissions don't allow counting
+    if (!counters.IsAvailable())
+    {
+        BOOST_CHECK_EQUAL(after[static_cast<std::size_t>(PerfEvent::Cycles)], 0);
+        return;
+    }
+    BOOST_CHECK_GT(after[static_cast<std::size_t>(PerfEvent::Instructions)],
+                   before[static_cast<std::size_t>(PerfEvent::Instructions)] + 1000000);
+    BOOST_CHECK_GT(after[static_cast<std::size_t>(PerfEvent::Cycles)],
+                   before[static_cast<std::size_t>(PerfEvent::Cycles)]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
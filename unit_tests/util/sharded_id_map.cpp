@@ -0,0 +1,57 @@
+#include "util/sharded_id_map.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(sharded_id_map)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(find_or_add)
+{
+    ShardedIDMap<std::string, unsigned> map;
+
+    BOOST_CHECK_EQUAL(map.ConcurrentFindOrAdd("left"), 0);
+    BOOST_CHECK_EQUAL(map.ConcurrentFindOrAdd("right"), 1);
+    BOOST_CHECK_EQUAL(map.ConcurrentFindOrAdd("left"), 0);
+    BOOST_CHECK_EQUAL(map.ConcurrentFindOrAdd("straight"), 2);
+    BOOST_CHECK_EQUAL(map.Size(), 3);
+
+    const std::vector<std::string> keys = {"left", "right", "straight"};
+    BOOST_CHECK(map.GetKeysByID() == keys);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_find_or_add)
+{
+    ShardedIDMap<unsigned, unsigned> map;
+
+    const unsigned count = 10000;
+    std::vector<unsigned> ids(2 * count);
+    tbb::parallel_for(0u, 2 * count, [&](const unsigned index) {
+        // every key is added from two iterations, both have to get the same id
+        ids[index] = map.ConcurrentFindOrAdd(index % count);
+    });
+
+    BOOST_CHECK_EQUAL(map.Size(), count);
+    const auto keys = map.GetKeysByID();
+    BOOST_REQUIRE_EQUAL(keys.size(), count);
+    for (unsigned index = 0; index < count; ++index)
+    {
+        BOOST_CHECK_EQUAL(ids[index], ids[index + count]);
+        BOOST_CHECK_EQUAL(keys[ids[index]], index);
+    }
+
+    // the ids are dense
+    std::vector<unsigned> sorted_ids(ids.begin(), ids.begin() + count);
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+    for (unsigned index = 0; index < count; ++index)
+        BOOST_CHECK_EQUAL(sorted_ids[index], index);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
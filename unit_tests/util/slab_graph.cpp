@@ -0,0 +1,157 @@
+#include "util/slab_graph.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <tuple>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(slab_graph)
+
+using namespace osrm;
+using namespace osrm::util;
+
+struct TestData
+{
+    EdgeID id;
+};
+
+using TestSlabGraph = SlabGraph<TestData>;
+using TestInputEdge = TestSlabGraph::InputEdge;
+
+BOOST_AUTO_TEST_CASE(size_classes)
+{
+    const std::vector<unsigned> sizes = {
+        1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28, 32, 40};
+    for (const auto size_class : irange<std::uint8_t>(0, sizes.size()))
+    {
+        BOOST_CHECK_EQUAL(TestSlabGraph::GetBlockSize(size_class), sizes[size_class]);
+        BOOST_CHECK_EQUAL(TestSlabGraph::GetSizeClass(sizes[size_class]), size_class);
+    }
+    BOOST_CHECK_EQUAL(TestSlabGraph::GetSizeClass(9), 8);
+    BOOST_CHECK_EQUAL(TestSlabGraph::GetSizeClass(33), 16);
+    BOOST_CHECK_EQUAL(TestSlabGraph::GetBlockSize(TestSlabGraph::GetSizeClass(1u << 30)),
+                      1u << 30);
+}
+
+BOOST_AUTO_TEST_CASE(insert_and_release)
+{
+    /*
+     *  (0) -1-> (1)
+     *  ^
+     *  2
+     *  |
+     *  (3) -3-> (4)
+     *      <-4-
+     */
+    std::vector<TestInputEdge> input_edges = {TestInputEdge{0, 1, TestData{1}},
+                                              TestInputEdge{3, 0, TestData{2}},
+                                              TestInputEdge{3, 4, TestData{3}},
+                                              TestInputEdge{4, 3, TestData{4}}};
+    TestSlabGraph graph(5, input_edges);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), 4);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 4);
+    BOOST_CHECK_EQUAL(graph.GetOutDegree(1), 0);
+
+    // node 0 moves to a block of two edges at the end
+    graph.InsertEdge(0, 2, TestData{5});
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 6);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(graph.FindEdge(0, 1)).id, 1);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(graph.FindEdge(0, 2)).id, 5);
+
+    // the node without edges picks up the old block of node 0
+    graph.InsertEdge(1, 4, TestData{6});
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 6);
+    BOOST_CHECK_EQUAL(graph.BeginEdges(1), 0);
+
+    // and node 4 the block of node 3
+    graph.ReleaseEdges(3);
+    BOOST_CHECK_EQUAL(graph.GetOutDegree(3), 0);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), 4);
+    graph.InsertEdge(4, 0, TestData{7});
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 6);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(graph.FindEdge(4, 3)).id, 4);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(graph.FindEdge(4, 0)).id, 7);
+
+    BOOST_CHECK_EQUAL(graph.DeleteEdgesTo(4, 3), 1);
+    BOOST_CHECK_EQUAL(graph.FindEdge(4, 3), SPECIAL_EDGEID);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(compact)
+{
+    std::vector<TestInputEdge> input_edges = {TestInputEdge{0, 1, TestData{1}},
+                                              TestInputEdge{1, 2, TestData{2}},
+                                              TestInputEdge{1, 3, TestData{3}},
+                                              TestInputEdge{2, 0, TestData{4}},
+                                              TestInputEdge{3, 0, TestData{5}}};
+    TestSlabGraph graph(4, input_edges);
+    // node 0 moves into the block of node 1 and then to the end
+    graph.ReleaseEdges(1);
+    graph.InsertEdge(0, 2, TestData{6});
+    graph.InsertEdge(0, 3, TestData{7});
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 5 + 3);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfFreeSlots(), 1 + 2);
+
+    graph.Compact();
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 1 + 1 + 3);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfFreeSlots(), 0);
+    BOOST_CHECK_EQUAL(graph.BeginEdges(2), 0);
+    BOOST_CHECK_EQUAL(graph.BeginEdges(3), 1);
+    BOOST_CHECK_EQUAL(graph.BeginEdges(0), 2);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), 5);
+
+    const std::vector<std::tuple<NodeID, NodeID, EdgeID>> expected = {
+        {0, 1, 1}, {0, 2, 6}, {0, 3, 7}, {2, 0, 4}, {3, 0, 5}};
+    for (const auto &edge : expected)
+    {
+        const auto eit = graph.FindEdge(std::get<0>(edge), std::get<1>(edge));
+        BOOST_REQUIRE(eit != SPECIAL_EDGEID);
+        BOOST_CHECK_EQUAL(graph.GetEdgeData(eit).id, std::get<2>(edge));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reserve_edges)
+{
+    std::vector<TestInputEdge> input_edges = {TestInputEdge{0, 1, TestData{1}},
+                                              TestInputEdge{3, 0, TestData{2}},
+                                              TestInputEdge{3, 4, TestData{3}},
+                                              TestInputEdge{4, 3, TestData{4}}};
+    TestSlabGraph graph(5, input_edges);
+
+    // node 2 doesn't get the old block of node 0 while its edges may still be moving
+    graph.ReserveEdges({{0, 1}, {2, 1}, {4, 3}});
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 4 + 2 + 1 + 4);
+
+    // the blocks of different nodes don't overlap, so the edges can be inserted in any order
+    graph.InsertEdge(4, 0, TestData{10});
+    graph.InsertEdge(2, 1, TestData{11});
+    graph.InsertEdge(0, 2, TestData{12});
+    graph.InsertEdge(4, 1, TestData{13});
+    graph.InsertEdge(4, 2, TestData{14});
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 4 + 2 + 1 + 4);
+
+    // the old blocks of nodes 0 and 4 are free afterwards
+    graph.InsertEdge(1, 3, TestData{15});
+    BOOST_CHECK_EQUAL(graph.GetNumberOfSlots(), 4 + 2 + 1 + 4);
+
+    const std::vector<std::tuple<NodeID, NodeID, EdgeID>> expected = {{0, 1, 1},
+                                                                      {0, 2, 12},
+                                                                      {1, 3, 15},
+                                                                      {2, 1, 11},
+                                                                      {3, 0, 2},
+                                                                      {3, 4, 3},
+                                                                      {4, 3, 4},
+                                                                      {4, 0, 10},
+                                                                      {4, 1, 13},
+                                                                      {4, 2, 14}};
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), expected.size());
+    for (const auto &edge : expected)
+    {
+        const auto eit = graph.FindEdge(std::get<0>(edge), std::get<1>(edge));
+        BOOST_REQUIRE(eit != SPECIAL_EDGEID);
+        BOOST_CHECK_EQUAL(graph.GetEdgeData(eit).id, std::get<2>(edge));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
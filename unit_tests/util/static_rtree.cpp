@@ -242,6 +242,24 @@ void sampling_verify_rtree(RTreeT &rtree,
 
         BOOST_CHECK_CLOSE(rtree_dist, lsnn_dist, 0.0001);
     }
+
+    // the batched query shares leaves between queries but has to find the same segments
+    const auto batch_results = rtree.Nearest(
+        queries,
+        [](const std::size_t, const typename RTreeT::CandidateSegment &) {
+            return std::make_pair(true, true);
+        },
+        [](const std::size_t,
+           const std::size_t num_results,
+           const typename RTreeT::CandidateSegment &) { return num_results >= 1; });
+    BOOST_REQUIRE_EQUAL(batch_results.size(), queries.size());
+    for (const auto i : util::irange<std::size_t>(0, queries.size()))
+    {
+        const auto result_rtree = rtree.Nearest(queries[i], 1);
+        BOOST_REQUIRE_EQUAL(batch_results[i].size(), 1);
+        BOOST_CHECK_EQUAL(batch_results[i].front().u, result_rtree.front().u);
+        BOOST_CHECK_EQUAL(batch_results[i].front().v, result_rtree.front().v);
+    }
 }
 
 template <typename FixtureT, typename RTreeT = TestStaticRTree>
@@ -300,6 +318,202 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+BOOST_FIXTURE_TEST_CASE(construct_from_runs_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path = "test_runs.fileIndex";
+    std::string nodes_path = "test_runs.ramIndex";
+    {
+        // sorts and spills runs of a few objects, the input is released afterwards
+        auto edges = this->edges;
+        TestStaticRTree r(std::move(edges), nodes_path, leaves_path, coords, 7);
+        BOOST_CHECK(edges.empty());
+    }
+    BOOST_CHECK(!boost::filesystem::exists(leaves_path + ".run0"));
+
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+    LinearSearchNN<TestData> lsnn(coords, this->edges);
+    simple_verify_rtree(rtree, coords, this->edges);
+    sampling_verify_rtree(rtree, lsnn, coords, 100);
+}
+
+BOOST_FIXTURE_TEST_CASE(bearing_pruning_test, TestRandomGraphFixture_MultipleLevels)
+{
+    // a mix of one way and two way segments
+    for (const auto index : util::irange<std::size_t>(0, edges.size()))
+    {
+        edges[index].forward_segment_id = {static_cast<NodeID>(index), index % 3 != 1};
+        edges[index].reverse_segment_id = {static_cast<NodeID>(index), index % 3 != 2};
+    }
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_bearing", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    for (unsigned sample = 0; sample < 100; ++sample)
+    {
+        const Coordinate q{FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)}};
+        const int bearing = sample * 37 % 360;
+        const int range = sample % 4 * 15;
+        const auto filter = [&](const TestStaticRTree::CandidateSegment &segment) {
+            const double forward_bearing = coordinate_calculation::bearing(
+                coords[segment.data.u], coords[segment.data.v]);
+            const double backward_bearing = bearing::reverse(forward_bearing);
+            return std::make_pair(
+                segment.data.forward_segment_id.enabled &&
+                    bearing::CheckInBounds(std::round(forward_bearing), bearing, range),
+                segment.data.reverse_segment_id.enabled &&
+                    bearing::CheckInBounds(std::round(backward_bearing), bearing, range));
+        };
+        const auto terminate = [](const std::size_t num_results,
+                                  const TestStaticRTree::CandidateSegment &) {
+            return num_results >= 5;
+        };
+
+        // pruning the subtrees without a matching bearing finds the same segments, segments
+        // at the same distance may come in a different order
+        const auto segments = [](const std::vector<TestData> &results) {
+            std::vector<std::pair<NodeID, NodeID>> segments;
+            for (const auto &result : results)
+            {
+                segments.emplace_back(result.u, result.v);
+            }
+            std::sort(segments.begin(), segments.end());
+            return segments;
+        };
+        const auto results = segments(rtree.Nearest(q, filter, terminate));
+        const auto pruned_results = segments(
+            rtree.Nearest(q, bearing::BinsInBounds(bearing, range), filter, terminate));
+        BOOST_CHECK(results == pruned_results);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(big_component_pruning_test, TestRandomGraphFixture_MultipleLevels)
+{
+    // most segments belong to tiny components
+    for (const auto index : util::irange<std::size_t>(0, edges.size()))
+    {
+        edges[index].forward_segment_id = {static_cast<NodeID>(index), true};
+        edges[index].reverse_segment_id = {static_cast<NodeID>(index), true};
+    }
+    const auto is_tiny = [](const TestData &data) { return data.forward_segment_id.id % 8 != 0; };
+    std::string leaves_path = "test_components.fileIndex";
+    std::string nodes_path = "test_components.ramIndex";
+    {
+        TestStaticRTree r(edges,
+                          nodes_path,
+                          leaves_path,
+                          coords,
+                          TestStaticRTree::DEFAULT_ELEMENTS_PER_RUN,
+                          is_tiny);
+    }
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    const auto filter = [&](const TestStaticRTree::CandidateSegment &segment) {
+        const auto use_segment = !is_tiny(segment.data);
+        return std::make_pair(use_segment, use_segment);
+    };
+    const auto terminate = [](const std::size_t num_results,
+                              const TestStaticRTree::CandidateSegment &) {
+        return num_results >= 3;
+    };
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<Coordinate> queries;
+    for (unsigned sample = 0; sample < 100; ++sample)
+    {
+        queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+    }
+
+    // pruning the subtrees with tiny components only finds segments at the same distances,
+    // segments that share the nearest point may be another one
+    const auto batch_results = rtree.NearestInBigComponents(
+        queries,
+        std::vector<bearing::Bins>{},
+        [&](const std::size_t, const TestStaticRTree::CandidateSegment &segment) {
+            return filter(segment);
+        },
+        [&](const std::size_t,
+            const std::size_t num_results,
+            const TestStaticRTree::CandidateSegment &segment) {
+            return terminate(num_results, segment);
+        });
+    BOOST_REQUIRE_EQUAL(batch_results.size(), queries.size());
+    for (const auto index : util::irange<std::size_t>(0, queries.size()))
+    {
+        const auto distances = [&](const std::vector<TestData> &results) {
+            std::vector<double> distances;
+            for (const auto &result : results)
+            {
+                distances.push_back(coordinate_calculation::perpendicularDistance(
+                    coords[result.u], coords[result.v], queries[index]));
+            }
+            return distances;
+        };
+        const auto results = distances(rtree.Nearest(queries[index], filter, terminate));
+        const auto pruned_results = distances(
+            rtree.NearestInBigComponents(queries[index], bearing::ALL_BINS, filter, terminate));
+        const auto batch_pruned_results = distances(batch_results[index]);
+        BOOST_REQUIRE_EQUAL(results.size(), 3);
+        BOOST_REQUIRE_EQUAL(pruned_results.size(), 3);
+        BOOST_REQUIRE_EQUAL(batch_pruned_results.size(), 3);
+        for (const auto k : util::irange<std::size_t>(0, 3))
+        {
+            BOOST_CHECK_CLOSE(results[k], pruned_results[k], 0.0001);
+            BOOST_CHECK_CLOSE(results[k], batch_pruned_results[k], 0.0001);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(view_leaf_access_test, TestRandomGraphFixture_MultipleLevels)
+{
+    using TestViewRTree = StaticRTree<TestData,
+                                      osrm::storage::Ownership::View,
+                                      TEST_BRANCHING_FACTOR,
+                                      TEST_LEAF_NODE_SIZE>;
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_view", this, leaves_path, nodes_path);
+
+    // the blocks osrm-datastore loads into memory
+    storage::io::FileReader nodes_file(nodes_path, storage::io::FileReader::VerifyFingerprint);
+    std::vector<TestViewRTree::TreeNode> nodes(nodes_file.ReadElementCount64());
+    nodes_file.ReadInto(nodes);
+    std::vector<std::uint64_t> level_sizes(nodes_file.ReadElementCount64());
+    nodes_file.ReadInto(level_sizes);
+    storage::io::FileReader leaves_file(leaves_path, storage::io::FileReader::HasNoFingerprint);
+    std::vector<TestData> leaves(leaves_file.GetSize() / sizeof(TestData));
+    leaves_file.ReadInto(leaves);
+    const util::vector_view<Coordinate> coordinates(coords.data(), coords.size());
+
+    for (const auto access :
+         {MappedFileAccess::Default, MappedFileAccess::Random, MappedFileAccess::Prefault})
+    {
+        TestViewRTree rtree(nodes.data(),
+                            nodes.size(),
+                            level_sizes.data(),
+                            level_sizes.size(),
+                            leaves_path,
+                            coordinates,
+                            access);
+        simple_verify_rtree(rtree, coords, edges);
+    }
+
+    TestViewRTree rtree(nodes.data(),
+                        nodes.size(),
+                        level_sizes.data(),
+                        level_sizes.size(),
+                        util::vector_view<const TestData>(leaves.data(), leaves.size()),
+                        coordinates);
+    LinearSearchNN<TestData> lsnn(coords, edges);
+    simple_verify_rtree(rtree, coords, edges);
+    sampling_verify_rtree(rtree, lsnn, coords, 100);
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)
@@ -38,4 +38,16 @@ BOOST_AUTO_TEST_CASE(print_int)
     BOOST_CHECK_EQUAL(output, "-3.14158976");
 }
 
+BOOST_AUTO_TEST_CASE(uri_encoding)
+{
+    BOOST_CHECK_EQUAL(URIEncode("/route/v1/driving/1,2;3,4?hints=;"),
+                      "/route/v1/driving/1,2;3,4?hints=;");
+    BOOST_CHECK_EQUAL(URIEncode("polyline(_c`|@)% \x01"), "polyline(_c%60%7C@)%25%20%01");
+
+    const std::string input("a%b c\0\xff|", 8);
+    std::string output;
+    URIDecode(URIEncode(input), output);
+    BOOST_CHECK_EQUAL(output, input);
+}
+
 BOOST_AUTO_TEST_SUITE_END()